@@ -598,11 +598,8 @@ public abstract class UAVObject {
 			throw new Exception("Not enough bytes in ByteBuffer to pack object");
 		int numBytes = 0;
 
-		ListIterator<UAVObjectField> li = fields.listIterator();
-		while (li.hasNext()) {
-			UAVObjectField field = li.next();
-			numBytes += field.pack(dataOut);
-		}
+		for (int n = 0; n < fields.size(); ++n)
+			numBytes += fields.get(n).pack(dataOut);
 		return numBytes;
 	}
 
@@ -620,11 +617,9 @@ public abstract class UAVObject {
 
 		// QMutexLocker locker(mutex);
 		int numBytes = 0;
-		ListIterator<UAVObjectField> li = fields.listIterator();
-		while (li.hasNext()) {
-			UAVObjectField field = li.next();
-			numBytes += field.unpack(dataIn);
-		}
+		// Indexed so that no iterator is allocated for every packet
+		for (int n = 0; n < fields.size(); ++n)
+			numBytes += fields.get(n).unpack(dataIn);
 
 		// Trigger all the listeners for the unpack event
 		unpacked();
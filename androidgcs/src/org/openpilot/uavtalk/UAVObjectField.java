@@ -26,6 +26,7 @@ package org.openpilot.uavtalk;
 import java.nio.ByteBuffer;
 import java.nio.ByteOrder;
 import java.util.ArrayList;
+import java.util.Arrays;
 import java.util.List;
 
 public class UAVObjectField {
@@ -110,179 +111,101 @@ public class UAVObjectField {
 
     /**
      * This function copies this field from the internal storage of the parent object
-     * to a new ByteBuffer for UAVTalk.  It also converts from the java standard (big endian)
-     * to the arm/uavtalk standard (little endian)
+     * to a ByteBuffer for UAVTalk.  The storage already holds the arm/uavtalk
+     * (little endian) layout so this is a plain copy.
      * @param dataOut
      * @return the number of bytes added
      **/
-    @SuppressWarnings("unchecked")
 	public synchronized int pack(ByteBuffer dataOut) {
-        // Pack each element in output buffer
+    	if (type == FieldType.STRING) {
+        	// TODO: Implement strings
+        	throw new Error("Strings not yet implemented.  Field name: " + getName());
+    	}
     	dataOut.order(ByteOrder.LITTLE_ENDIAN);
-        switch (type)
-        {
-            case INT8:
-            	for (int index = 0; index < numElements; ++index) {
-            		Integer val = (Integer) getValue(index);
-            		dataOut.put(val.byteValue());
-            	}
-                break;
-            case INT16:
-                for (int index = 0; index < numElements; ++index) {
-                	Integer val = (Integer) getValue(index);
-                	dataOut.putShort(val.shortValue());
-                }
-                break;
-            case INT32:
-                for (int index = 0; index < numElements; ++index) {
-                	Integer val = (Integer) getValue(index);
-                	dataOut.putInt(val);
-                }
-                break;
-            case UINT8:
-            	// TODO: Deal properly with unsigned
-            	for (int index = 0; index < numElements; ++index) {
-            		Integer val = (Integer) getValue(index);
-            		dataOut.put(val.byteValue());
-            	}
-                break;
-            case UINT16:
-            	// TODO: Deal properly with unsigned
-                for (int index = 0; index < numElements; ++index) {
-                	Integer val = (Integer) getValue(index);
-                	dataOut.putShort(val.shortValue());
-                }
-                break;
-            case UINT32:
-            	// TODO: Deal properly with unsigned
-                for (int index = 0; index < numElements; ++index) {
-                	Integer val = (int) ( ((Long) getValue(index)).longValue() & 0xffffffffL);
-                	dataOut.putInt(val);
-                }
-                break;
-            case FLOAT32:
-                for (int index = 0; index < numElements; ++index)
-                	dataOut.putFloat((Float) getValue(index));
-                break;
-            case ENUM:
-            	List<Byte> l = (List<Byte>) data;
-                for (int index = 0; index < numElements; ++index)
-                	dataOut.put(l.get(index));
-                break;
-            case BITFIELD:
-            	for (int index = 0; index < numElements; ++index) {
-            		Integer val = (Integer) getValue(index);
-            		dataOut.put(val.byteValue());
-            	}
-            	break;
-            case STRING:
-            	// TODO: Implement strings
-            	throw new Error("Strings not yet implemented.  Field name: " + getName());
-        }
+    	dataOut.put(raw);
         // Done
         return getNumBytes();
     }
 
-    @SuppressWarnings("unchecked")
+    /**
+     * Copies the field from a UAVTalk packet into the internal storage, no
+     * conversion or allocation is done until a value is read.
+     */
 	public synchronized int unpack(ByteBuffer dataIn) {
-        // Unpack each element from input buffer
-    	dataIn.order(ByteOrder.LITTLE_ENDIAN);
-        switch (type)
-        {
-            case INT8:
-            {
-            	List<Byte> l = (List<Byte>) this.data;
-            	for (int index = 0 ; index < numElements; ++index) {
-            		Long val = bound(dataIn.get());
-            		l.set(index, val.byteValue());
-            	}
-                break;
-            }
-            case INT16:
-            {
-            	List<Short> l = (List<Short>) this.data;
-            	for (int index = 0 ; index < numElements; ++index) {
-            		Long val = bound(dataIn.getShort());
-            		l.set(index, val.shortValue());
-            	}
-                break;
-            }
-            case INT32:
-            {
-            	List<Integer> l = (List<Integer>) this.data;
-            	for (int index = 0 ; index < numElements; ++index) {
-            		Long val = bound(dataIn.getInt());
-            		l.set(index, val.intValue());
-            	}
-                break;
-            }
-            case UINT8:
-            {
-            	List<Short> l = (List<Short>) this.data;
-            	for (int index = 0 ; index < numElements; ++index) {
-            		int signedval = dataIn.get();  // this sign extends it
-            		int unsignedval = signedval & 0xff;    // drop sign extension
-            		l.set(index, (short) unsignedval);
-            	}
-                break;
-            }
-            case UINT16:
-            {
-            	List<Integer> l = (List<Integer>) this.data;
-            	for (int index = 0 ; index < numElements; ++index) {
-            		int signedval = dataIn.getShort();  // this sign extends it
-            		int unsignedval = signedval & 0xffff;    // drop sign extension
-            		l.set(index, unsignedval);
-            	}
-                break;
-            }
-            case UINT32:
-            {
-            	List<Long> l = (List<Long>) this.data;
-            	for (int index = 0 ; index < numElements; ++index) {
-            		long signedval = dataIn.getInt();  // this sign extends it
-            		long unsignedval = signedval & 0xffffffffL;    // drop sign extension
-            		l.set(index, unsignedval);
-            	}
-                break;
-            }
-            case FLOAT32:
-            {
-            	List<Float> l = (List<Float>) this.data;
-            	for (int index = 0 ; index < numElements; ++index) {
-            		Float val = dataIn.getFloat();
-            		l.set(index, val);
-            	}
-                break;
-            }
-            case BITFIELD:
-            {
-            	List<Short> l = (List<Short>) this.data;
-            	for (int index = 0 ; index < numElements; ++index) {
-            		int signedval = dataIn.get();  // this sign extends it
-            		int unsignedval = signedval & 0xff;    // drop sign extension
-            		l.set(index, (short) unsignedval);
-            	}
-                break;
-            }
-            case ENUM:
-            {
-        		List<Byte> l = (List<Byte>) this.data;
-            	for (int index = 0 ; index < numElements; ++index) {
-            		l.set(index, dataIn.get());
-            	}
-                break;
-            }
-            case STRING:
-            	// TODO: implement strings
-            	//throw new Exception("Strings not handled");
-        }
+    	if (type == FieldType.STRING) {
+        	// TODO: implement strings
+    		return getNumBytes();
+    	}
+    	dataIn.get(raw);
         // Done
         return getNumBytes();
     }
 
+    /**
+     * Reads an element of any numeric or enum field as a long, with
+     * unsigned types zero extended
+     */
+    private long readLong(int index) {
+    	switch (type)
+    	{
+    	case INT8:
+    		return view.get(index);
+    	case INT16:
+    		return view.getShort(index * 2);
+    	case INT32:
+    		return view.getInt(index * 4);
+    	case UINT8:
+    	case ENUM:
+    	case BITFIELD:
+    		return view.get(index) & 0xff;
+    	case UINT16:
+    		return view.getShort(index * 2) & 0xffff;
+    	case UINT32:
+    		return view.getInt(index * 4) & 0xffffffffL;
+    	case FLOAT32:
+    		return (long) view.getFloat(index * 4);
+    	default:
+    		return 0;
+    	}
+    }
+
+    /**
+     * Stores an already bounded value in an element
+     */
+    private void writeLong(long value, int index) {
+    	switch (type)
+    	{
+    	case INT8:
+    	case UINT8:
+    	case ENUM:
+    	case BITFIELD:
+    		view.put(index, (byte) value);
+    		break;
+    	case INT16:
+    	case UINT16:
+    		view.putShort(index * 2, (short) value);
+    		break;
+    	case INT32:
+    	case UINT32:
+    		view.putInt(index * 4, (int) value);
+    		break;
+    	case FLOAT32:
+    		view.putFloat(index * 4, value);
+    		break;
+    	default:
+    		break;
+    	}
+    }
+
+    /**
+     * Checks that the GCS may write the object
+     */
+    private boolean isWritable() {
+    	UAVObject.Metadata mdata = obj.getMetadata();
+    	return mdata.GetGcsAccess() == UAVObject.AccessMode.ACCESS_READWRITE;
+    }
+
     public Object getValue()  { return getValue(0); };
-    @SuppressWarnings("unchecked")
 	public synchronized Object getValue(int index)  {
         // Check that index is not out of bounds
         if ( index >= numElements )
@@ -293,32 +216,25 @@ public class UAVObjectField {
         switch (type)
         {
             case INT8:
-            	return ((List<Byte>) data).get(index).intValue();
             case INT16:
-            	return ((List<Short>) data).get(index).intValue();
             case INT32:
-            	return ((List<Integer>) data).get(index).intValue();
             case UINT8:
-            	return ((List<Short>) data).get(index).intValue();
             case UINT16:
-            	return ((List<Integer>) data).get(index).intValue();
+            case BITFIELD:
+            	return (int) readLong(index);
             case UINT32:
-            	return ((List<Long>) data).get(index);
+            	return readLong(index);
             case FLOAT32:
-            	return ((List<Float>) data).get(index);
+            	return view.getFloat(index * 4);
             case ENUM:
             {
-            	List<Byte> l = (List<Byte>) data;
-            	Byte val = l.get(index);
+            	int val = view.get(index);
 
                 //if(val >= options.size() || val < 0)
                 //	throw new Exception("Invalid value for" + name);
 
                 return options.get(val);
             }
-            case BITFIELD:
-            	return ((List<Short>) data).get(index).intValue();
-
             case STRING:
             {
             	//throw new Exception("Shit I should do this");
@@ -329,61 +245,19 @@ public class UAVObjectField {
     }
 
     public void setValue(Object data) { setValue(data,0); }
-    @SuppressWarnings("unchecked")
 	public synchronized void setValue(Object data, int index) {
     	// Check that index is not out of bounds
     	//if ( index >= numElements );
     		//throw new Exception("Index out of bounds");
 
-    	// Get metadata
-    	UAVObject.Metadata mdata = obj.getMetadata();
     	// Update value if the access mode permits
-    	if ( mdata.GetGcsAccess() == UAVObject.AccessMode.ACCESS_READWRITE )
+    	if ( isWritable() )
     	{
     		switch (type)
     		{
-    		case INT8:
-    		{
-    			List<Byte> l = (List<Byte>) this.data;
-    			l.set(index, bound(data).byteValue());
-    			break;
-    		}
-    		case INT16:
-    		{
-    			List<Short> l = (List<Short>) this.data;
-    			l.set(index, bound(data).shortValue());
-    			break;
-    		}
-    		case INT32:
-    		{
-    			List<Integer> l = (List<Integer>) this.data;
-    			l.set(index, bound(data).intValue());
-    			break;
-    		}
-    		case UINT8:
-    		{
-    			List<Short> l = (List<Short>) this.data;
-    			l.set(index, bound(data).shortValue());
-    			break;
-    		}
-    		case UINT16:
-    		{
-    			List<Integer> l = (List<Integer>) this.data;
-    			l.set(index, bound(data).intValue());
-    			break;
-    		}
-    		case UINT32:
-    		{
-    			List<Long> l = (List<Long>) this.data;
-    			l.set(index, bound(data));
-    			break;
-    		}
     		case FLOAT32:
-    		{
-    			List<Float> l = (List<Float>) this.data;
-    			l.set(index, ((Number) data).floatValue());
+    			view.putFloat(index * 4, ((Number) data).floatValue());
     			break;
-    		}
     		case ENUM:
     		{
     			byte val;
@@ -394,40 +268,73 @@ public class UAVObjectField {
     				val = (byte) options.indexOf(data);
     			}
     			//if(val < 0) throw new Exception("Enumerated value not found");
-    			List<Byte> l = (List<Byte>) this.data;
-    			l.set(index, val);
-    			break;
-    		}
-    		case BITFIELD:
-    		{
-    			List<Short> l = (List<Short>) this.data;
-    			l.set(index, bound(data).shortValue());
+    			view.put(index, val);
     			break;
     		}
     		case STRING:
     		{
     			//throw new Exception("Sorry I haven't implemented strings yet");
+    			break;
     		}
+    		default:
+    			writeLong(bound(data), index);
     		}
     		//obj.updated();
     	}
     }
 
+    /**
+     * Typed accessors, these neither box nor allocate. Integer and enum
+     * fields are read as long (unsigned types keep their range), enums as
+     * the option index.
+     */
+    public long getLong() { return getLong(0); };
+    public synchronized long getLong(int index) {
+    	return readLong(index);
+    }
+
+    public float getFloat() { return getFloat(0); };
+    public synchronized float getFloat(int index) {
+    	if (type == FieldType.FLOAT32)
+    		return view.getFloat(index * 4);
+    	return readLong(index);
+    }
+
     public double getDouble() { return getDouble(0); };
-    @SuppressWarnings("unchecked")
-	public double getDouble(int index) {
-    	switch (type) {
-    	case ENUM:
-    		return ((List<Byte>)data).get(index);
-    	default:
-    		break;
+	public synchronized double getDouble(int index) {
+    	if (type == FieldType.FLOAT32)
+    		return view.getFloat(index * 4);
+    	return readLong(index);
+    }
+
+    public void setLong(long value) { setLong(value, 0); };
+    public synchronized void setLong(long value, int index) {
+    	if ( isWritable() ) {
+    		if (type == FieldType.FLOAT32)
+    			view.putFloat(index * 4, value);
+    		else if (type == FieldType.ENUM)
+    			view.put(index, (byte) value);
+    		else
+    			writeLong(bound(value), index);
+    	}
+    }
+
+    public void setFloat(float value) { setFloat(value, 0); };
+    public synchronized void setFloat(float value, int index) {
+    	if ( isWritable() ) {
+    		if (type == FieldType.FLOAT32)
+    			view.putFloat(index * 4, value);
+    		else
+    			setLong((long) value, index);
     	}
-    	return ((Number) getValue(index)).doubleValue();
     }
 
     public void setDouble(double value) { setDouble(value, 0); };
-    public void setDouble(double value, int index) {
-    	setValue(value, index);
+    public synchronized void setDouble(double value, int index) {
+    	if (type == FieldType.FLOAT32)
+    		setFloat((float) value, index);
+    	else
+    		setLong((long) value, index);
     }
 
     public int getDataOffset() {
@@ -520,71 +427,8 @@ public class UAVObjectField {
 
     }
 
-    @SuppressWarnings("unchecked")
 	public synchronized void clear() {
-    	switch (type)
-        {
-            case INT8:
-            	((ArrayList<Byte>) data).clear();
-            	for(int index = 0; index < numElements; ++index) {
-            		((ArrayList<Byte>) data).add((byte) 0);
-            	}
-                break;
-            case INT16:
-            	((ArrayList<Short>) data).clear();
-            	for(int index = 0; index < numElements; ++index) {
-            		((ArrayList<Short>) data).add((short) 0);
-            	}
-                break;
-            case INT32:
-            	((ArrayList<Integer>) data).clear();
-            	for(int index = 0; index < numElements; ++index) {
-            		((ArrayList<Integer>) data).add(0);
-            	}
-                break;
-            case UINT8:
-            	((ArrayList<Short>) data).clear();
-            	for(int index = 0; index < numElements; ++index) {
-            		((ArrayList<Short>) data).add((short) 0);
-            	}
-                break;
-            case UINT16:
-            	((ArrayList<Integer>) data).clear();
-            	for(int index = 0; index < numElements; ++index) {
-            		((ArrayList<Integer>) data).add(0);
-            	}
-                break;
-            case UINT32:
-            	((ArrayList<Long>) data).clear();
-            	for(int index = 0; index < numElements; ++index) {
-            		((ArrayList<Long>) data).add((long) 0);
-            	}
-                break;
-            case FLOAT32:
-            	((ArrayList<Float>) data).clear();
-            	for(int index = 0; index < numElements; ++index) {
-            		((ArrayList<Float>) data).add((float) 0);
-            	}
-                break;
-            case BITFIELD:
-            	((ArrayList<Short>) data).clear();
-            	for(int index = 0; index < numElements; ++index) {
-            		((ArrayList<Short>) data).add((short) 0);
-            	}
-                break;
-            case ENUM:
-            	((ArrayList<Byte>) data).clear();
-            	for(int index = 0; index < numElements; ++index) {
-            		((ArrayList<Byte>) data).add((byte) 0);
-            	}
-                break;
-            case STRING:
-            	((ArrayList<Byte>) data).clear();
-            	for(int index = 0; index < numElements; ++index) {
-            		((ArrayList<Byte>) data).add((byte) 0);
-            	}
-                break;
-        }
+    	Arrays.fill(raw, (byte) 0);
     }
 
     public synchronized void constructorInitialize(String name, String units, FieldType type, List<String> elementNames, List<String> options) {
@@ -595,7 +439,6 @@ public class UAVObjectField {
         this.options = options;
         this.numElements = elementNames.size();
         this.offset = 0;
-        this.data = null;
         this.obj = null;
         this.elementNames = elementNames;
 
@@ -603,49 +446,40 @@ public class UAVObjectField {
         switch (type)
         {
             case INT8:
-            	data = new ArrayList<Byte>(this.numElements);
                 numBytesPerElement = 1;
                 break;
             case INT16:
-            	data = new ArrayList<Short>(this.numElements);
                 numBytesPerElement = 2;
                 break;
             case INT32:
-            	data = new ArrayList<Integer>(this.numElements);
                 numBytesPerElement = 4;
                 break;
             case UINT8:
-            	data = new ArrayList<Short>(this.numElements);
                 numBytesPerElement = 1;
                 break;
             case UINT16:
-            	data = new ArrayList<Integer>(this.numElements);
                 numBytesPerElement = 2;
                 break;
             case UINT32:
-            	data = new ArrayList<Long>(this.numElements);
                 numBytesPerElement = 4;
                 break;
             case FLOAT32:
-            	data = new ArrayList<Float>(this.numElements);
                 numBytesPerElement = 4;
                 break;
             case ENUM:
-            	data = new ArrayList<Byte>(this.numElements);
                 numBytesPerElement = 1;
                 break;
             case BITFIELD:
-            	data = new ArrayList<Short>(this.numElements);
                 numBytesPerElement = 1;
                 break;
             case STRING:
-            	data = new ArrayList<Byte>(this.numElements);
                 numBytesPerElement = 1;
                 break;
             default:
                 numBytesPerElement = 0;
         }
-        clear();
+        raw = new byte[numBytesPerElement * numElements];
+        view = ByteBuffer.wrap(raw).order(ByteOrder.LITTLE_ENDIAN);
     }
 
     /**
@@ -654,12 +488,15 @@ public class UAVObjectField {
      * @return long value with the right range (for float rounds)
      * @note This is mostly needed because java has no unsigned integer
      */
-    protected Long bound (Object val) {
-
-    	long num = 0;
-    	if (isNumeric())
-    		num = ((Number) val).longValue();
+    protected long bound (Object val) {
+    	if (type == FieldType.FLOAT32)
+    		return ((Number) val).longValue();
+    	if (!isNumeric())
+    		return 0L;
+    	return bound(((Number) val).longValue());
+    }
 
+    protected long bound (long num) {
     	switch(type) {
     	case INT8:
     		if(num < Byte.MIN_VALUE)
@@ -704,7 +541,7 @@ public class UAVObjectField {
     			return (long) 255;
     		return num;
     	case FLOAT32:
-    		return ((Number) val).longValue();
+    		return num;
     	case ENUM:
     	case STRING:
     		return 0L;
@@ -720,7 +557,7 @@ public class UAVObjectField {
     			new ArrayList<String>(elementNames),
     			new ArrayList<String>(options));
     	newField.initialize(obj);
-    	newField.data = data;
+    	System.arraycopy(raw, 0, newField.raw, 0, raw.length);
 		return newField;
     }
 
@@ -733,6 +570,8 @@ public class UAVObjectField {
     private int numBytesPerElement;
     private int offset;
     private UAVObject obj;
-    protected Object data;
+    // Little endian element storage, as packed for UAVTalk, and the view used for typed access
+    protected byte[] raw;
+    protected ByteBuffer view;
 
 }
@@ -300,16 +300,15 @@ public class UAVObjectManager {
 	 */
 	public synchronized UAVObject getObject(String name, long objId, long instId)
 	{
-		// Check if this object type is already in the list
-		ListIterator<List<UAVObject>> objIter = objects.listIterator();
-		while(objIter.hasNext()) {
-			List<UAVObject> instList = objIter.next();
+		// Check if this object type is already in the list, indexed so that
+		// the lookup done for every received packet allocates no iterators
+		for (int n = 0; n < objects.size(); ++n) {
+			List<UAVObject> instList = objects.get(n);
 			if (instList.size() > 0) {
 				if ( (name != null && instList.get(0).getName().compareTo(name) == 0) || (name == null && instList.get(0).getObjID() == objId) ) {
 					// Look for the requested instance ID
-					ListIterator<UAVObject> iter = instList.listIterator();
-					while(iter.hasNext()) {
-						UAVObject obj = iter.next();
+					for (int m = 0; m < instList.size(); ++m) {
+						UAVObject obj = instList.get(m);
 						if(obj.getInstID() == instId) {
 							return obj;
 						}
@@ -226,7 +226,9 @@ void processComand(uint8_t *xReceive_Buffer) {
 							Data += xReceive_Buffer[DATA + 3 + offset];
 							aux = baseOfAdressType(TransferType) + (uint32_t)(
 									Count * 14 * 4 + x * 4);
-							result = 0;
+							// Already there after the erase to 0xFF, padding and
+							// unused description bytes need no programming
+							result = (*(uint32_t *) aux == Data) ? 1 : 0;
 							for (int retry = 0; retry < MAX_WRI_RETRYS; ++retry) {
 								if (result == 0) {
 									result = (FLASH_ProgramWord(aux, Data)
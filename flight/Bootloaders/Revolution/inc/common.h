@@ -70,8 +70,12 @@ typedef enum {
 	Download_Req, //9
 	Download, //10
 	Status_Request, //11
-	Status_Rep
-//12
+	Status_Rep, //12
+	Upload_Ack, //13
+	Req_BlockCRC, //14
+	Rep_BlockCRC, //15
+	Erase_Block
+//16
 } DFUCommands;
 
 typedef enum {
@@ -48,6 +48,14 @@ typedef struct {
 #define COUNT	1
 #define DATA	5
 
+/* Extensions reported in byte 16 of a device's Rep_Capabilities */
+#define DFU_CAP_WINDOWED_UPLOAD	0x01
+#define DFU_CAP_CRC_VERIFY	0x02
+#define DFU_CAP_DELTA_UPLOAD	0x04
+
+/* Flags of an extended Upload start packet, byte DATA + 7 */
+#define DFU_UPLOAD_KEEP	0x01
+
 /* Exported functions ------------------------------------------------------- */
 void processComand(uint8_t *Receive_Buffer);
 uint32_t baseOfAdressType(uint8_t type);
@@ -53,6 +53,9 @@ uint32_t Aditionals = 0;
 uint32_t SizeOfTransfer = 0;
 uint32_t Expected_CRC = 0;
 uint8_t SizeOfLastPacket = 0;
+uint8_t UploadAckWindow = 0;
+uint32_t UploadAckCount = 0;
+uint8_t UploadKeep = 0;
 uint32_t Next_Packet = 0;
 uint8_t TransferType;
 uint32_t Count = 0;
@@ -109,6 +112,16 @@ void DataDownload(DownloadAction action) {
 		sendData(SendBuffer + 1, 63);
 	}
 }
+static void sendUploadAck(void) {
+	Buffer[0] = 0x01;
+	Buffer[1] = Upload_Ack;
+	Buffer[2] = (Next_Packet - 1) >> 24;
+	Buffer[3] = (Next_Packet - 1) >> 16;
+	Buffer[4] = (Next_Packet - 1) >> 8;
+	Buffer[5] = (Next_Packet - 1);
+	Buffer[6] = DeviceState;
+	sendData(Buffer + 1, 63);
+}
 void processComand(uint8_t *xReceive_Buffer) {
 
 	Command = xReceive_Buffer[COMMAND];
@@ -179,6 +192,14 @@ void processComand(uint8_t *xReceive_Buffer) {
 				Expected_CRC += xReceive_Buffer[DATA + 4] << 8;
 				Expected_CRC += xReceive_Buffer[DATA + 5];
 				SizeOfLastPacket = Data1;
+				// Hosts knowing DFU_CAP_WINDOWED_UPLOAD set the answer flag on
+				// the start packet to get an Upload_Ack every window of packets
+				UploadAckWindow = (EchoAnsFlag == 1) ? xReceive_Buffer[DATA + 6] : 0;
+				UploadAckCount = 0;
+				// A delta upload leaves the flash alone, the host erases the
+				// blocks that changed and only sends the packets in them
+				UploadKeep = ((EchoAnsFlag == 1) && (TransferType == FW)
+						&& (xReceive_Buffer[DATA + 7] & DFU_UPLOAD_KEEP)) ? 1 : 0;
 
 				if (isBiggerThanAvailable(TransferType, (SizeOfTransfer - 1)
 						* 14 * 4 + SizeOfLastPacket * 4) == true) {
@@ -186,7 +207,7 @@ void processComand(uint8_t *xReceive_Buffer) {
 					Aditionals = (uint32_t) Command;
 				} else {
 					uint8_t result = 1;
-					if (TransferType == FW) {
+					if ((TransferType == FW) && (UploadKeep == 0)) {
 						switch (currentProgrammingDestination) {
 						case Self_flash:
 							result = PIOS_BL_HELPER_FLASH_Start();
@@ -207,10 +228,12 @@ void processComand(uint8_t *xReceive_Buffer) {
 					}
 				}
 			} else if ((StartFlag != 1) && (Next_Packet != 0)) {
-				if (Count > SizeOfTransfer) {
+				++UploadAckCount;
+				if (Count >= SizeOfTransfer) {
 					DeviceState = too_many_packets;
 					Aditionals = Count;
-				} else if (Count == Next_Packet - 1) {
+				} else if ((Count == Next_Packet - 1) || ((UploadKeep == 1)
+						&& (Count > Next_Packet - 1))) {
 					uint8_t numberOfWords = 14;
 					if (Count == SizeOfTransfer - 1)//is this the last packet?
 					{
@@ -227,7 +250,9 @@ void processComand(uint8_t *xReceive_Buffer) {
 							Data += xReceive_Buffer[DATA + 3 + offset];
 							aux = baseOfAdressType(TransferType) + (uint32_t)(
 									Count * 14 * 4 + x * 4);
-							result = 0;
+							// Already there after an erase to 0xFF or in a part
+							// of a block a delta upload did not change
+							result = (*(uint32_t *) aux == Data) ? 1 : 0;
 							for (int retry = 0; retry < MAX_WRI_RETRYS; ++retry) {
 								if (result == 0) {
 									result = (FLASH_ProgramWord(aux, Data)
@@ -248,11 +273,18 @@ void processComand(uint8_t *xReceive_Buffer) {
 						Aditionals = (uint32_t) Command;
 					}
 
-					++Next_Packet;
+					Next_Packet = Count + 2;
 				} else {
 					DeviceState = wrong_packet_received;
 					Aditionals = Count;
 				}
+				// Acknowledge a whole window, the last packet or a failure so
+				// the host can keep streaming while this one is programmed
+				if ((UploadAckWindow != 0) && ((DeviceState != uploading)
+						|| (UploadAckCount % UploadAckWindow == 0)
+						|| (Count == SizeOfTransfer - 1))) {
+					sendUploadAck();
+				}
 			} else {
 				DeviceState = Last_operation_failed;
 				Aditionals = (uint32_t) Command;
@@ -292,6 +324,8 @@ void processComand(uint8_t *xReceive_Buffer) {
 			Buffer[13] = devicesTable[Data0 - 1].FW_Crc;
 			Buffer[14] = devicesTable[Data0 - 1].devID >> 8;
 			Buffer[15] = devicesTable[Data0 - 1].devID;
+			Buffer[16] = DFU_CAP_WINDOWED_UPLOAD | DFU_CAP_CRC_VERIFY
+					| DFU_CAP_DELTA_UPLOAD;
 		}
 		sendData(Buffer + 1, 63);
 		break;
@@ -308,8 +342,50 @@ void processComand(uint8_t *xReceive_Buffer) {
 		break;
 	case Abort_Operation:
 		Next_Packet = 0;
+		UploadAckWindow = 0;
+		UploadKeep = 0;
 		DeviceState = DFUidle;
 		break;
+	case Req_BlockCRC: {
+		uint32_t start = 0;
+		uint32_t size = 0;
+		uint32_t crc = 0;
+		if ((currentProgrammingDestination == Self_flash)
+				&& PIOS_BL_HELPER_FLASH_GetBlock(Count, &start, &size)) {
+			crc = PIOS_BL_HELPER_CRC_Block_Calc(start, size);
+		}
+		Buffer[0] = 0x01;
+		Buffer[1] = Rep_BlockCRC;
+		Buffer[2] = Count >> 24;
+		Buffer[3] = Count >> 16;
+		Buffer[4] = Count >> 8;
+		Buffer[5] = Count;
+		Buffer[6] = start >> 24;
+		Buffer[7] = start >> 16;
+		Buffer[8] = start >> 8;
+		Buffer[9] = start;
+		Buffer[10] = size >> 24;
+		Buffer[11] = size >> 16;
+		Buffer[12] = size >> 8;
+		Buffer[13] = size;
+		Buffer[14] = crc >> 24;
+		Buffer[15] = crc >> 16;
+		Buffer[16] = crc >> 8;
+		Buffer[17] = crc;
+		sendData(Buffer + 1, 63);
+		break;
+	}
+	case Erase_Block:
+		if ((DeviceState == uploading) && (UploadKeep == 1)) {
+			if (PIOS_BL_HELPER_FLASH_EraseBlock(Count) != 1) {
+				DeviceState = Last_operation_failed;
+				Aditionals = (uint32_t) Command;
+			}
+		} else {
+			DeviceState = Last_operation_failed;
+			Aditionals = (uint32_t) Command;
+		}
+		break;
 
 	case Op_END:
 		if (DeviceState == uploading) {
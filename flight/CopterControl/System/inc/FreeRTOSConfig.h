@@ -31,7 +31,7 @@
 #define configTICK_RATE_HZ		( ( portTickType ) 1000 )
 #define configMAX_PRIORITIES		( ( unsigned portBASE_TYPE ) 5 )
 #define configMINIMAL_STACK_SIZE	( ( unsigned short ) 48 )
-#define configTOTAL_HEAP_SIZE		( ( size_t ) ( 53 * 256) )
+#define configTOTAL_HEAP_SIZE		( ( size_t ) ( 39 * 256) )
 #define configMAX_TASK_NAME_LEN		( 16 )
 #define configUSE_TRACE_FACILITY	0
 #define configUSE_16_BIT_TICKS		0
@@ -91,6 +91,13 @@ do {\
 #define configCHECK_FOR_STACK_OVERFLOW	1
 #endif
 
+/* Cycle counts of each task, the task tags hold the TaskInfo index */
+#if defined(DIAG_PROFILE)
+#define configUSE_APPLICATION_TASK_TAG	1
+extern void TaskMonitorSwitchedIn(unsigned long tag);
+#define traceTASK_SWITCHED_IN() TaskMonitorSwitchedIn((unsigned long)pxCurrentTCB->pxTaskTag)
+#endif
+
 
 /**
   * @}
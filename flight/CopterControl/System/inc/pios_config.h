@@ -105,6 +105,8 @@
 
 // This can't be too high to stop eventdispatcher thread overflowing
 #define PIOS_EVENTDISAPTCHER_QUEUE      10
+// Periodic events scheduled at once, the dispatcher allocates room for them at start
+#define PIOS_EVENTDISPATCHER_MAX_PERIODIC 64
 
 /* PIOS Initcall infrastructure */
 #define PIOS_INCLUDE_INITCALL
@@ -145,6 +145,14 @@ static const struct pios_flash_jedec_cfg flash_m25p_cfg = {
 	.sector_erase = 0xD8,
 	.chip_erase = 0xC7
 };
+/*
+ * UAVObject storage pool. The object data lives here instead of the FreeRTOS
+ * heap, which was made smaller by the same amount. Objects that do not fit are
+ * taken from the heap, UAVObjGetPoolStats() reports the usage.
+ */
+#define PIOS_UAVOBJ_POOL_SIZE (14 * 256)
+static uint32_t pios_uavobj_pool[PIOS_UAVOBJ_POOL_SIZE / sizeof(uint32_t)];
+
 #include <pios_board_info.h>
 /**
  * PIOS_Board_Init()
@@ -201,6 +209,7 @@ void PIOS_Board_Init(void) {
 	/* Initialize UAVObject libraries */
 	EventDispatcherInitialize();
 	UAVObjInitialize();
+	UAVObjInitializePool(pios_uavobj_pool, sizeof(pios_uavobj_pool));
 
 #if defined(PIOS_INCLUDE_RTC)
 	/* Initialize the real-time clock and its associated tick */
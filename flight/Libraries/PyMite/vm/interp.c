@@ -28,6 +28,34 @@
 #include "pm.h"
 
 
+/*
+ * Threaded dispatch. Every opcode handler jumps straight to the handler of
+ * the next opcode through a table of label addresses, so each handler ends
+ * in its own indirect jump instead of all of them sharing the one of the
+ * switch, which the branch predictor copes with much better. The top of the
+ * interpret loop still runs when a reschedule is pending. Compilers without
+ * computed gotos use the switch alone.
+ */
+#if defined(HAVE_COMPUTED_GOTO) && defined(__GNUC__)
+#define INTERP_THREADED
+#define TARGET(op)      case op: TARGET_##op:
+#define TARGET_DEFAULT  default: TARGET_UNKNOWN:
+#define DISPATCH() \
+    { \
+        if (!gVmGlobal.reschedule) \
+        { \
+            bc = mem_getByte(PM_FP->fo_memspace, &PM_IP); \
+            goto *interp_targets[bc]; \
+        } \
+        continue; \
+    }
+#else
+#define TARGET(op)      case op:
+#define TARGET_DEFAULT  default:
+#define DISPATCH()      continue
+#endif /* HAVE_COMPUTED_GOTO */
+
+
 PmReturn_t
 interpret(const uint8_t returnOnNoThreads)
 {
@@ -40,6 +68,131 @@ interpret(const uint8_t returnOnNoThreads)
     uint8_t bc;
     uint8_t objid, objid2;
 
+#ifdef INTERP_THREADED
+    /* Handler of every opcode, the ones not listed raise a SystemError */
+    static void const * const interp_targets[256] =
+    {
+        [0 ... 255] = &&TARGET_UNKNOWN,
+        [POP_TOP] = &&TARGET_POP_TOP,
+        [ROT_TWO] = &&TARGET_ROT_TWO,
+        [ROT_THREE] = &&TARGET_ROT_THREE,
+        [DUP_TOP] = &&TARGET_DUP_TOP,
+        [ROT_FOUR] = &&TARGET_ROT_FOUR,
+        [NOP] = &&TARGET_NOP,
+        [UNARY_POSITIVE] = &&TARGET_UNARY_POSITIVE,
+        [UNARY_NEGATIVE] = &&TARGET_UNARY_NEGATIVE,
+        [UNARY_NOT] = &&TARGET_UNARY_NOT,
+#ifdef HAVE_BACKTICK
+        [UNARY_CONVERT] = &&TARGET_UNARY_CONVERT,
+#endif /* HAVE_BACKTICK */
+        [UNARY_INVERT] = &&TARGET_UNARY_INVERT,
+        [LIST_APPEND] = &&TARGET_LIST_APPEND,
+        [BINARY_POWER] = &&TARGET_BINARY_POWER,
+        [INPLACE_POWER] = &&TARGET_INPLACE_POWER,
+        [GET_ITER] = &&TARGET_GET_ITER,
+        [BINARY_MULTIPLY] = &&TARGET_BINARY_MULTIPLY,
+        [INPLACE_MULTIPLY] = &&TARGET_INPLACE_MULTIPLY,
+        [BINARY_DIVIDE] = &&TARGET_BINARY_DIVIDE,
+        [INPLACE_DIVIDE] = &&TARGET_INPLACE_DIVIDE,
+        [BINARY_FLOOR_DIVIDE] = &&TARGET_BINARY_FLOOR_DIVIDE,
+        [INPLACE_FLOOR_DIVIDE] = &&TARGET_INPLACE_FLOOR_DIVIDE,
+        [BINARY_MODULO] = &&TARGET_BINARY_MODULO,
+        [INPLACE_MODULO] = &&TARGET_INPLACE_MODULO,
+        [STORE_MAP] = &&TARGET_STORE_MAP,
+        [BINARY_ADD] = &&TARGET_BINARY_ADD,
+        [INPLACE_ADD] = &&TARGET_INPLACE_ADD,
+        [BINARY_SUBTRACT] = &&TARGET_BINARY_SUBTRACT,
+        [INPLACE_SUBTRACT] = &&TARGET_INPLACE_SUBTRACT,
+        [BINARY_SUBSCR] = &&TARGET_BINARY_SUBSCR,
+#ifdef HAVE_FLOAT
+        [BINARY_TRUE_DIVIDE] = &&TARGET_BINARY_TRUE_DIVIDE,
+        [INPLACE_TRUE_DIVIDE] = &&TARGET_INPLACE_TRUE_DIVIDE,
+#endif /* HAVE_FLOAT */
+        [SLICE_0] = &&TARGET_SLICE_0,
+        [STORE_SUBSCR] = &&TARGET_STORE_SUBSCR,
+#ifdef HAVE_DEL
+        [DELETE_SUBSCR] = &&TARGET_DELETE_SUBSCR,
+#endif /* HAVE_DEL */
+        [BINARY_LSHIFT] = &&TARGET_BINARY_LSHIFT,
+        [INPLACE_LSHIFT] = &&TARGET_INPLACE_LSHIFT,
+        [BINARY_RSHIFT] = &&TARGET_BINARY_RSHIFT,
+        [INPLACE_RSHIFT] = &&TARGET_INPLACE_RSHIFT,
+        [BINARY_AND] = &&TARGET_BINARY_AND,
+        [INPLACE_AND] = &&TARGET_INPLACE_AND,
+        [BINARY_XOR] = &&TARGET_BINARY_XOR,
+        [INPLACE_XOR] = &&TARGET_INPLACE_XOR,
+        [BINARY_OR] = &&TARGET_BINARY_OR,
+        [INPLACE_OR] = &&TARGET_INPLACE_OR,
+#ifdef HAVE_PRINT
+        [PRINT_EXPR] = &&TARGET_PRINT_EXPR,
+        [PRINT_ITEM] = &&TARGET_PRINT_ITEM,
+        [PRINT_NEWLINE] = &&TARGET_PRINT_NEWLINE,
+#endif /* HAVE_PRINT */
+        [BREAK_LOOP] = &&TARGET_BREAK_LOOP,
+        [LOAD_LOCALS] = &&TARGET_LOAD_LOCALS,
+        [RETURN_VALUE] = &&TARGET_RETURN_VALUE,
+#ifdef HAVE_IMPORTS
+        [IMPORT_STAR] = &&TARGET_IMPORT_STAR,
+#endif /* HAVE_IMPORTS */
+#ifdef HAVE_GENERATORS
+        [YIELD_VALUE] = &&TARGET_YIELD_VALUE,
+#endif /* HAVE_GENERATORS */
+        [POP_BLOCK] = &&TARGET_POP_BLOCK,
+#ifdef HAVE_CLASSES
+        [BUILD_CLASS] = &&TARGET_BUILD_CLASS,
+#endif /* HAVE_CLASSES */
+        [STORE_NAME] = &&TARGET_STORE_NAME,
+#ifdef HAVE_DEL
+        [DELETE_NAME] = &&TARGET_DELETE_NAME,
+#endif /* HAVE_DEL */
+        [UNPACK_SEQUENCE] = &&TARGET_UNPACK_SEQUENCE,
+        [FOR_ITER] = &&TARGET_FOR_ITER,
+        [STORE_ATTR] = &&TARGET_STORE_ATTR,
+#ifdef HAVE_DEL
+        [DELETE_ATTR] = &&TARGET_DELETE_ATTR,
+#endif /* HAVE_DEL */
+        [STORE_GLOBAL] = &&TARGET_STORE_GLOBAL,
+#ifdef HAVE_DEL
+        [DELETE_GLOBAL] = &&TARGET_DELETE_GLOBAL,
+#endif /* HAVE_DEL */
+        [DUP_TOPX] = &&TARGET_DUP_TOPX,
+        [LOAD_CONST] = &&TARGET_LOAD_CONST,
+        [LOAD_NAME] = &&TARGET_LOAD_NAME,
+        [BUILD_TUPLE] = &&TARGET_BUILD_TUPLE,
+        [BUILD_LIST] = &&TARGET_BUILD_LIST,
+        [BUILD_MAP] = &&TARGET_BUILD_MAP,
+        [LOAD_ATTR] = &&TARGET_LOAD_ATTR,
+        [COMPARE_OP] = &&TARGET_COMPARE_OP,
+        [IMPORT_NAME] = &&TARGET_IMPORT_NAME,
+#ifdef HAVE_IMPORTS
+        [IMPORT_FROM] = &&TARGET_IMPORT_FROM,
+#endif /* HAVE_IMPORTS */
+        [JUMP_FORWARD] = &&TARGET_JUMP_FORWARD,
+        [JUMP_IF_FALSE] = &&TARGET_JUMP_IF_FALSE,
+        [JUMP_IF_TRUE] = &&TARGET_JUMP_IF_TRUE,
+        [JUMP_ABSOLUTE] = &&TARGET_JUMP_ABSOLUTE,
+        [CONTINUE_LOOP] = &&TARGET_CONTINUE_LOOP,
+        [LOAD_GLOBAL] = &&TARGET_LOAD_GLOBAL,
+        [SETUP_LOOP] = &&TARGET_SETUP_LOOP,
+        [LOAD_FAST] = &&TARGET_LOAD_FAST,
+        [STORE_FAST] = &&TARGET_STORE_FAST,
+#ifdef HAVE_DEL
+        [DELETE_FAST] = &&TARGET_DELETE_FAST,
+#endif /* HAVE_DEL */
+#ifdef HAVE_ASSERT
+        [RAISE_VARARGS] = &&TARGET_RAISE_VARARGS,
+#endif /* HAVE_ASSERT */
+        [CALL_FUNCTION] = &&TARGET_CALL_FUNCTION,
+        [MAKE_FUNCTION] = &&TARGET_MAKE_FUNCTION,
+#ifdef HAVE_CLOSURES
+        [MAKE_CLOSURE] = &&TARGET_MAKE_CLOSURE,
+        [LOAD_CLOSURE] = &&TARGET_LOAD_CLOSURE,
+        [LOAD_DEREF] = &&TARGET_LOAD_DEREF,
+        [STORE_DEREF] = &&TARGET_STORE_DEREF,
+#endif /* HAVE_CLOSURES */
+    };
+#endif /* INTERP_THREADED */
+
     /* Activate a thread the first time */
     retval = interp_reschedule();
     PM_RETURN_IF_ERROR(retval);
@@ -75,40 +228,40 @@ interpret(const uint8_t returnOnNoThreads)
         bc = mem_getByte(PM_FP->fo_memspace, &PM_IP);
         switch (bc)
         {
-            case POP_TOP:
+            TARGET(POP_TOP)
                 pobj1 = PM_POP();
-                continue;
+                DISPATCH();
 
-            case ROT_TWO:
+            TARGET(ROT_TWO)
                 pobj1 = TOS;
                 TOS = TOS1;
                 TOS1 = pobj1;
-                continue;
+                DISPATCH();
 
-            case ROT_THREE:
+            TARGET(ROT_THREE)
                 pobj1 = TOS;
                 TOS = TOS1;
                 TOS1 = TOS2;
                 TOS2 = pobj1;
-                continue;
+                DISPATCH();
 
-            case DUP_TOP:
+            TARGET(DUP_TOP)
                 pobj1 = TOS;
                 PM_PUSH(pobj1);
-                continue;
+                DISPATCH();
 
-            case ROT_FOUR:
+            TARGET(ROT_FOUR)
                 pobj1 = TOS;
                 TOS = TOS1;
                 TOS1 = TOS2;
                 TOS2 = TOS3;
                 TOS3 = pobj1;
-                continue;
+                DISPATCH();
 
-            case NOP:
-                continue;
+            TARGET(NOP)
+                DISPATCH();
 
-            case UNARY_POSITIVE:
+            TARGET(UNARY_POSITIVE)
                 /* Raise TypeError if TOS is not an int */
                 if ((OBJ_GET_TYPE(TOS) != OBJ_TYPE_INT)
 #ifdef HAVE_FLOAT
@@ -121,9 +274,9 @@ interpret(const uint8_t returnOnNoThreads)
                 }
 
                 /* When TOS is an int, this is a no-op */
-                continue;
+                DISPATCH();
 
-            case UNARY_NEGATIVE:
+            TARGET(UNARY_NEGATIVE)
 #ifdef HAVE_FLOAT
                 if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_FLT)
                 {
@@ -136,9 +289,9 @@ interpret(const uint8_t returnOnNoThreads)
                 }
                 PM_BREAK_IF_ERROR(retval);
                 TOS = pobj2;
-                continue;
+                DISPATCH();
 
-            case UNARY_NOT:
+            TARGET(UNARY_NOT)
                 pobj1 = PM_POP();
                 if (obj_isFalse(pobj1))
                 {
@@ -148,18 +301,18 @@ interpret(const uint8_t returnOnNoThreads)
                 {
                     PM_PUSH(PM_FALSE);
                 }
-                continue;
+                DISPATCH();
 
 #ifdef HAVE_BACKTICK
             /* #244 Add support for the backtick operation (UNARY_CONVERT) */
-            case UNARY_CONVERT:
+            TARGET(UNARY_CONVERT)
                 retval = obj_repr(TOS, &pobj3);
                 PM_BREAK_IF_ERROR(retval);
                 TOS = pobj3;
-                continue;
+                DISPATCH();
 #endif /* HAVE_BACKTICK */
 
-            case UNARY_INVERT:
+            TARGET(UNARY_INVERT)
                 /* Raise TypeError if it's not an int */
                 if (OBJ_GET_TYPE(TOS) != OBJ_TYPE_INT)
                 {
@@ -171,16 +324,16 @@ interpret(const uint8_t returnOnNoThreads)
                 retval = int_bitInvert(TOS, &pobj2);
                 PM_BREAK_IF_ERROR(retval);
                 TOS = pobj2;
-                continue;
+                DISPATCH();
 
-            case LIST_APPEND:
+            TARGET(LIST_APPEND)
                 /* list_append will raise a TypeError if TOS1 is not a list */
                 retval = list_append(TOS1, TOS);
                 PM_SP -= 2;
-                continue;
+                DISPATCH();
 
-            case BINARY_POWER:
-            case INPLACE_POWER:
+            TARGET(BINARY_POWER)
+            TARGET(INPLACE_POWER)
 
 #ifdef HAVE_FLOAT
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_FLT)
@@ -191,7 +344,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 #endif /* HAVE_FLOAT */
 
@@ -202,9 +355,9 @@ interpret(const uint8_t returnOnNoThreads)
                 /* Set return value */
                 PM_SP--;
                 TOS = pobj3;
-                continue;
+                DISPATCH();
 
-            case GET_ITER:
+            TARGET(GET_ITER)
 #ifdef HAVE_GENERATORS
                 /* Raise TypeError if TOS is an instance, but not iterable */
                 if (OBJ_GET_TYPE(TOS) == OBJ_TYPE_CLI)
@@ -226,10 +379,10 @@ interpret(const uint8_t returnOnNoThreads)
                     /* Put sequence-iterator on top of stack */
                     TOS = pobj1;
                 }
-                continue;
+                DISPATCH();
 
-            case BINARY_MULTIPLY:
-            case INPLACE_MULTIPLY:
+            TARGET(BINARY_MULTIPLY)
+            TARGET(INPLACE_MULTIPLY)
                 /* If both objs are ints, perform the op */
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT)
                     && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_INT))
@@ -239,7 +392,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 
 #ifdef HAVE_FLOAT
@@ -250,7 +403,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 #endif /* HAVE_FLOAT */
 
@@ -269,7 +422,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 
                 /* If it's a tuple replication operation */
@@ -286,7 +439,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 
                 /* If it's a string replication operation */
@@ -306,7 +459,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 #endif /* HAVE_REPLICATION */
 
@@ -314,10 +467,10 @@ interpret(const uint8_t returnOnNoThreads)
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
 
-            case BINARY_DIVIDE:
-            case INPLACE_DIVIDE:
-            case BINARY_FLOOR_DIVIDE:
-            case INPLACE_FLOOR_DIVIDE:
+            TARGET(BINARY_DIVIDE)
+            TARGET(INPLACE_DIVIDE)
+            TARGET(BINARY_FLOOR_DIVIDE)
+            TARGET(INPLACE_FLOOR_DIVIDE)
 
 #ifdef HAVE_FLOAT
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_FLT)
@@ -327,7 +480,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 #endif /* HAVE_FLOAT */
 
@@ -352,10 +505,10 @@ interpret(const uint8_t returnOnNoThreads)
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
                 TOS = pobj3;
-                continue;
+                DISPATCH();
 
-            case BINARY_MODULO:
-            case INPLACE_MODULO:
+            TARGET(BINARY_MODULO)
+            TARGET(INPLACE_MODULO)
 
 #ifdef HAVE_STRING_FORMAT
                 /* If it's a string, perform string format */
@@ -365,7 +518,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 #endif /* HAVE_STRING_FORMAT */
 
@@ -377,7 +530,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 #endif /* HAVE_FLOAT */
 
@@ -402,18 +555,18 @@ interpret(const uint8_t returnOnNoThreads)
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
                 TOS = pobj3;
-                continue;
+                DISPATCH();
 
-            case STORE_MAP:
+            TARGET(STORE_MAP)
                 /* #213: Add support for Python 2.6 bytecodes */
                 C_ASSERT(OBJ_GET_TYPE(TOS2) == OBJ_TYPE_DIC);
                 retval = dict_setItem(TOS2, TOS, TOS1);
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP -= 2;
-                continue;
+                DISPATCH();
 
-            case BINARY_ADD:
-            case INPLACE_ADD:
+            TARGET(BINARY_ADD)
+            TARGET(INPLACE_ADD)
 
 #ifdef HAVE_FLOAT
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_FLT)
@@ -423,7 +576,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 #endif /* HAVE_FLOAT */
 
@@ -436,7 +589,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 
                 /* #242: If both objs are strings, perform concatenation */
@@ -449,15 +602,15 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 
                 /* Otherwise raise a TypeError */
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
 
-            case BINARY_SUBTRACT:
-            case INPLACE_SUBTRACT:
+            TARGET(BINARY_SUBTRACT)
+            TARGET(INPLACE_SUBTRACT)
 
 #ifdef HAVE_FLOAT
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_FLT)
@@ -467,7 +620,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 #endif /* HAVE_FLOAT */
 
@@ -480,14 +633,14 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 
                 /* Otherwise raise a TypeError */
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
 
-            case BINARY_SUBSCR:
+            TARGET(BINARY_SUBSCR)
                 /* Implements TOS = TOS1[TOS]. */
 
                 if (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_DIC)
@@ -526,22 +679,22 @@ interpret(const uint8_t returnOnNoThreads)
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
                 TOS = pobj3;
-                continue;
+                DISPATCH();
 
 #ifdef HAVE_FLOAT
             /* #213: Add support for Python 2.6 bytecodes */
-            case BINARY_TRUE_DIVIDE:
-            case INPLACE_TRUE_DIVIDE:
+            TARGET(BINARY_TRUE_DIVIDE)
+            TARGET(INPLACE_TRUE_DIVIDE)
 
                 /* Perform division; float_op() checks for types and zero-div */
                 retval = float_op(TOS1, TOS, &pobj3, '/');
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
                 TOS = pobj3;
-                continue;
+                DISPATCH();
 #endif /* HAVE_FLOAT */
 
-            case SLICE_0:
+            TARGET(SLICE_0)
                 /* Implements TOS = TOS[:], push a copy of the sequence */
 
                 /* Create a copy if it is a list */
@@ -562,9 +715,9 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_RAISE(retval, PM_RET_EX_TYPE);
                     break;
                 }
-                continue;
+                DISPATCH();
 
-            case STORE_SUBSCR:
+            TARGET(STORE_SUBSCR)
                 /* Implements TOS1[TOS] = TOS2 */
 
                 /* If it's a list */
@@ -584,7 +737,7 @@ interpret(const uint8_t returnOnNoThreads)
                                           TOS2);
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP -= 3;
-                    continue;
+                    DISPATCH();
                 }
 
                 /* If it's a dict */
@@ -594,7 +747,7 @@ interpret(const uint8_t returnOnNoThreads)
                     retval = dict_setItem(TOS1, TOS, TOS2);
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP -= 3;
-                    continue;
+                    DISPATCH();
                 }
 
 #ifdef HAVE_BYTEARRAY
@@ -627,7 +780,7 @@ interpret(const uint8_t returnOnNoThreads)
                                                TOS2);
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP -= 3;
-                    continue;
+                    DISPATCH();
                 }
 #endif /* HAVE_BYTEARRAY */
 
@@ -636,7 +789,7 @@ interpret(const uint8_t returnOnNoThreads)
                 break;
 
 #ifdef HAVE_DEL
-            case DELETE_SUBSCR:
+            TARGET(DELETE_SUBSCR)
 
                 if ((OBJ_GET_TYPE(TOS1) == OBJ_TYPE_LST)
                     && (OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT))
@@ -659,11 +812,11 @@ interpret(const uint8_t returnOnNoThreads)
 
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP -= 2;
-                continue;
+                DISPATCH();
 #endif /* HAVE_DEL */
 
-            case BINARY_LSHIFT:
-            case INPLACE_LSHIFT:
+            TARGET(BINARY_LSHIFT)
+            TARGET(INPLACE_LSHIFT)
                 /* If both objs are ints, perform the op */
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT)
                     && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_INT))
@@ -673,15 +826,15 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 
                 /* Otherwise raise a TypeError */
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
 
-            case BINARY_RSHIFT:
-            case INPLACE_RSHIFT:
+            TARGET(BINARY_RSHIFT)
+            TARGET(INPLACE_RSHIFT)
                 /* If both objs are ints, perform the op */
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT)
                     && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_INT))
@@ -691,15 +844,15 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 
                 /* Otherwise raise a TypeError */
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
 
-            case BINARY_AND:
-            case INPLACE_AND:
+            TARGET(BINARY_AND)
+            TARGET(INPLACE_AND)
                 /* If both objs are ints, perform the op */
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT)
                     && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_INT))
@@ -709,15 +862,15 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 
                 /* Otherwise raise a TypeError */
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
 
-            case BINARY_XOR:
-            case INPLACE_XOR:
+            TARGET(BINARY_XOR)
+            TARGET(INPLACE_XOR)
                 /* If both objs are ints, perform the op */
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT)
                     && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_INT))
@@ -727,15 +880,15 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 
                 /* Otherwise raise a TypeError */
                 PM_RAISE(retval, PM_RET_EX_TYPE);
                 break;
 
-            case BINARY_OR:
-            case INPLACE_OR:
+            TARGET(BINARY_OR)
+            TARGET(INPLACE_OR)
                 /* If both objs are ints, perform the op */
                 if ((OBJ_GET_TYPE(TOS) == OBJ_TYPE_INT)
                     && (OBJ_GET_TYPE(TOS1) == OBJ_TYPE_INT))
@@ -745,7 +898,7 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_BREAK_IF_ERROR(retval);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 
                 /* Otherwise raise a TypeError */
@@ -753,11 +906,11 @@ interpret(const uint8_t returnOnNoThreads)
                 break;
 
 #ifdef HAVE_PRINT
-            case PRINT_EXPR:
+            TARGET(PRINT_EXPR)
                 /* Print interactive expression */
                 /* Fallthrough */
 
-            case PRINT_ITEM:
+            TARGET(PRINT_ITEM)
                 if (gVmGlobal.needSoftSpace && (bc == PRINT_ITEM))
                 {
                     retval = plat_putByte(' ');
@@ -771,11 +924,11 @@ interpret(const uint8_t returnOnNoThreads)
                 PM_SP--;
                 if (bc != PRINT_EXPR)
                 {
-                    continue;
+                    DISPATCH();
                 }
                 /* If PRINT_EXPR, Fallthrough to print a newline */
 
-            case PRINT_NEWLINE:
+            TARGET(PRINT_NEWLINE)
                 gVmGlobal.needSoftSpace = C_FALSE;
                 if (gVmGlobal.somethingPrinted)
                 {
@@ -783,10 +936,10 @@ interpret(const uint8_t returnOnNoThreads)
                     gVmGlobal.somethingPrinted = C_FALSE;
                 }
                 PM_BREAK_IF_ERROR(retval);
-                continue;
+                DISPATCH();
 #endif /* HAVE_PRINT */
 
-            case BREAK_LOOP:
+            TARGET(BREAK_LOOP)
             {
                 pPmBlock_t pb1 = PM_FP->fo_blockstack;
 
@@ -816,15 +969,15 @@ interpret(const uint8_t returnOnNoThreads)
                 retval = heap_freeChunk((pPmObj_t)pb1);
                 PM_BREAK_IF_ERROR(retval);
             }
-                continue;
+                DISPATCH();
 
-            case LOAD_LOCALS:
+            TARGET(LOAD_LOCALS)
                 /* Pushes local attrs dict of current frame */
                 /* WARNING: does not copy fo_locals to attrs */
                 PM_PUSH((pPmObj_t)PM_FP->fo_attrs);
-                continue;
+                DISPATCH();
 
-            case RETURN_VALUE:
+            TARGET(RETURN_VALUE)
                 /* Get expiring frame's TOS */
                 pobj2 = PM_POP();
 
@@ -894,10 +1047,10 @@ interpret(const uint8_t returnOnNoThreads)
 
                 /* Deallocate expired frame */
                 PM_BREAK_IF_ERROR(heap_freeChunk(pobj1));
-                continue;
+                DISPATCH();
 
 #ifdef HAVE_IMPORTS
-            case IMPORT_STAR:
+            TARGET(IMPORT_STAR)
                 /* #102: Implement the remaining IMPORT_ bytecodes */
                 /* Expect a module on the top of the stack */
                 C_ASSERT(OBJ_GET_TYPE(TOS) == OBJ_TYPE_MOD);
@@ -907,11 +1060,11 @@ interpret(const uint8_t returnOnNoThreads)
                                      (pPmObj_t)((pPmFunc_t)TOS)->f_attrs);
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
-                continue;
+                DISPATCH();
 #endif /* HAVE_IMPORTS */
 
 #ifdef HAVE_GENERATORS
-            case YIELD_VALUE:
+            TARGET(YIELD_VALUE)
                 /* #207: Add support for the yield keyword */
                 /* Get expiring frame's TOS */
                 pobj1 = PM_POP();
@@ -929,10 +1082,10 @@ interpret(const uint8_t returnOnNoThreads)
 
                 /* Push yield value onto caller's TOS */
                 PM_PUSH(pobj1);
-                continue;
+                DISPATCH();
 #endif /* HAVE_GENERATORS */
 
-            case POP_BLOCK:
+            TARGET(POP_BLOCK)
                 /* Get ptr to top block */
                 pobj1 = (pPmObj_t)PM_FP->fo_blockstack;
 
@@ -947,16 +1100,16 @@ interpret(const uint8_t returnOnNoThreads)
                 PM_IP = ((pPmBlock_t)pobj1)->b_handler;
 
                 PM_BREAK_IF_ERROR(heap_freeChunk(pobj1));
-                continue;
+                DISPATCH();
 
 #ifdef HAVE_CLASSES
-            case BUILD_CLASS:
+            TARGET(BUILD_CLASS)
                 /* Create and push new class */
                 retval = class_new(TOS, TOS1, TOS2, &pobj2);
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP -= 2;
                 TOS = pobj2;
-                continue;
+                DISPATCH();
 #endif /* HAVE_CLASSES */
 
 
@@ -965,7 +1118,7 @@ interpret(const uint8_t returnOnNoThreads)
              * that needs to be swallowed using GET_ARG().
              **************************************************/
 
-            case STORE_NAME:
+            TARGET(STORE_NAME)
                 /* Get name index */
                 t16 = GET_ARG();
 
@@ -976,10 +1129,10 @@ interpret(const uint8_t returnOnNoThreads)
                 retval = dict_setItem((pPmObj_t)PM_FP->fo_attrs, pobj2, TOS);
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
-                continue;
+                DISPATCH();
 
 #ifdef HAVE_DEL
-            case DELETE_NAME:
+            TARGET(DELETE_NAME)
                 /* Get name index */
                 t16 = GET_ARG();
 
@@ -989,10 +1142,10 @@ interpret(const uint8_t returnOnNoThreads)
                 /* Remove key,val pair from current frame's attrs dict */
                 retval = dict_delItem((pPmObj_t)PM_FP->fo_attrs, pobj2);
                 PM_BREAK_IF_ERROR(retval);
-                continue;
+                DISPATCH();
 #endif /* HAVE_DEL */
 
-            case UNPACK_SEQUENCE:
+            TARGET(UNPACK_SEQUENCE)
                 /* Get ptr to sequence */
                 pobj1 = PM_POP();
 
@@ -1038,9 +1191,9 @@ interpret(const uint8_t returnOnNoThreads)
 
                 /* Test again outside the for loop */
                 PM_BREAK_IF_ERROR(retval);
-                continue;
+                DISPATCH();
 
-            case FOR_ITER:
+            TARGET(FOR_ITER)
                 t16 = GET_ARG();
 
 #ifdef HAVE_GENERATORS
@@ -1073,15 +1226,15 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_SP--;
                     retval = PM_RET_OK;
                     PM_IP += t16;
-                    continue;
+                    DISPATCH();
                 }
                 PM_BREAK_IF_ERROR(retval);
 
                 /* Push the next item onto the stack */
                 PM_PUSH(pobj2);
-                continue;
+                DISPATCH();
 
-            case STORE_ATTR:
+            TARGET(STORE_ATTR)
                 /* TOS.name = TOS1 */
                 /* Get names index */
                 t16 = GET_ARG();
@@ -1129,10 +1282,10 @@ interpret(const uint8_t returnOnNoThreads)
                 retval = dict_setItem(pobj2, pobj3, TOS1);
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP -= 2;
-                continue;
+                DISPATCH();
 
 #ifdef HAVE_DEL
-            case DELETE_ATTR:
+            TARGET(DELETE_ATTR)
                 /* del TOS.name */
                 /* Get names index */
                 t16 = GET_ARG();
@@ -1187,10 +1340,10 @@ interpret(const uint8_t returnOnNoThreads)
 
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
-                continue;
+                DISPATCH();
 #endif /* HAVE_DEL */
 
-            case STORE_GLOBAL:
+            TARGET(STORE_GLOBAL)
                 /* Get name index */
                 t16 = GET_ARG();
 
@@ -1201,10 +1354,10 @@ interpret(const uint8_t returnOnNoThreads)
                 retval = dict_setItem((pPmObj_t)PM_FP->fo_globals, pobj2, TOS);
                 PM_BREAK_IF_ERROR(retval);
                 PM_SP--;
-                continue;
+                DISPATCH();
 
 #ifdef HAVE_DEL
-            case DELETE_GLOBAL:
+            TARGET(DELETE_GLOBAL)
                 /* Get name index */
                 t16 = GET_ARG();
 
@@ -1214,10 +1367,10 @@ interpret(const uint8_t returnOnNoThreads)
                 /* Remove key,val from globals */
                 retval = dict_delItem((pPmObj_t)PM_FP->fo_globals, pobj2);
                 PM_BREAK_IF_ERROR(retval);
-                continue;
+                DISPATCH();
 #endif /* HAVE_DEL */
 
-            case DUP_TOPX:
+            TARGET(DUP_TOPX)
                 t16 = GET_ARG();
                 C_ASSERT(t16 <= 3);
 
@@ -1230,17 +1383,17 @@ interpret(const uint8_t returnOnNoThreads)
                     PM_PUSH(pobj2);
                 if (t16 >= 1)
                     PM_PUSH(pobj1);
-                continue;
+                DISPATCH();
 
-            case LOAD_CONST:
+            TARGET(LOAD_CONST)
                 /* Get const's index in CO */
                 t16 = GET_ARG();
 
                 /* Push const on stack */
                 PM_PUSH(PM_FP->fo_func->f_co->co_consts->val[t16]);
-                continue;
+                DISPATCH();
 
-            case LOAD_NAME:
+            TARGET(LOAD_NAME)
                 /* Get name index */
                 t16 = GET_ARG();
 
@@ -1270,9 +1423,9 @@ interpret(const uint8_t returnOnNoThreads)
                 }
                 PM_BREAK_IF_ERROR(retval);
                 PM_PUSH(pobj2);
-                continue;
+                DISPATCH();
 
-            case BUILD_TUPLE:
+            TARGET(BUILD_TUPLE)
                 /* Get num items */
                 t16 = GET_ARG();
                 retval = tuple_new(t16, &pobj1);
@@ -1284,9 +1437,9 @@ interpret(const uint8_t returnOnNoThreads)
                     ((pPmTuple_t)pobj1)->val[t16] = PM_POP();
                 }
                 PM_PUSH(pobj1);
-                continue;
+                DISPATCH();
 
-            case BUILD_LIST:
+            TARGET(BUILD_LIST)
                 t16 = GET_ARG();
                 retval = list_new(&pobj1);
                 PM_BREAK_IF_ERROR(retval);
@@ -1304,17 +1457,17 @@ interpret(const uint8_t returnOnNoThreads)
 
                 /* push list onto stack */
                 PM_PUSH(pobj1);
-                continue;
+                DISPATCH();
 
-            case BUILD_MAP:
+            TARGET(BUILD_MAP)
                 /* Argument is ignored */
                 t16 = GET_ARG();
                 retval = dict_new(&pobj1);
                 PM_BREAK_IF_ERROR(retval);
                 PM_PUSH(pobj1);
-                continue;
+                DISPATCH();
 
-            case LOAD_ATTR:
+            TARGET(LOAD_ATTR)
                 /* Implements TOS.attr */
                 t16 = GET_ARG();
 
@@ -1393,9 +1546,9 @@ interpret(const uint8_t returnOnNoThreads)
 
                 /* Put attr on the stack */
                 TOS = pobj3;
-                continue;
+                DISPATCH();
 
-            case COMPARE_OP:
+            TARGET(COMPARE_OP)
                 retval = PM_RET_OK;
                 t16 = GET_ARG();
 
@@ -1406,7 +1559,7 @@ interpret(const uint8_t returnOnNoThreads)
                     retval = float_compare(TOS1, TOS, &pobj3, (PmCompare_t)t16);
                     PM_SP--;
                     TOS = pobj3;
-                    continue;
+                    DISPATCH();
                 }
 #endif /* HAVE_FLOAT */
 
@@ -1494,9 +1647,9 @@ interpret(const uint8_t returnOnNoThreads)
                 }
                 PM_SP--;
                 TOS = pobj3;
-                continue;
+                DISPATCH();
 
-            case IMPORT_NAME:
+            TARGET(IMPORT_NAME)
                 /* Get name index */
                 t16 = GET_ARG();
 
@@ -1517,7 +1670,7 @@ interpret(const uint8_t returnOnNoThreads)
                     && (OBJ_GET_TYPE(pobj2) == OBJ_TYPE_MOD))
                 {
                     TOS = pobj2;
-                    continue;
+                    DISPATCH();
                 }
 
                 /* Load module from image */
@@ -1544,10 +1697,10 @@ interpret(const uint8_t returnOnNoThreads)
 
                 /* Set new frame */
                 PM_FP = (pPmFrame_t)pobj3;
-                continue;
+                DISPATCH();
 
 #ifdef HAVE_IMPORTS
-            case IMPORT_FROM:
+            TARGET(IMPORT_FROM)
                 /* #102: Implement the remaining IMPORT_ bytecodes */
                 /* Expect the module on the top of the stack */
                 C_ASSERT(OBJ_GET_TYPE(TOS) == OBJ_TYPE_MOD);
@@ -1564,40 +1717,40 @@ interpret(const uint8_t returnOnNoThreads)
 
                 /* Push the object onto the top of the stack */
                 PM_PUSH(pobj3);
-                continue;
+                DISPATCH();
 #endif /* HAVE_IMPORTS */
 
-            case JUMP_FORWARD:
+            TARGET(JUMP_FORWARD)
                 t16 = GET_ARG();
                 PM_IP += t16;
-                continue;
+                DISPATCH();
 
-            case JUMP_IF_FALSE:
+            TARGET(JUMP_IF_FALSE)
                 t16 = GET_ARG();
                 if (obj_isFalse(TOS))
                 {
                     PM_IP += t16;
                 }
-                continue;
+                DISPATCH();
 
-            case JUMP_IF_TRUE:
+            TARGET(JUMP_IF_TRUE)
                 t16 = GET_ARG();
                 if (!obj_isFalse(TOS))
                 {
                     PM_IP += t16;
                 }
-                continue;
+                DISPATCH();
 
-            case JUMP_ABSOLUTE:
-            case CONTINUE_LOOP:
+            TARGET(JUMP_ABSOLUTE)
+            TARGET(CONTINUE_LOOP)
                 /* Get target offset (bytes) */
                 t16 = GET_ARG();
 
                 /* Jump to base_ip + arg */
                 PM_IP = PM_FP->fo_func->f_co->co_codeaddr + t16;
-                continue;
+                DISPATCH();
 
-            case LOAD_GLOBAL:
+            TARGET(LOAD_GLOBAL)
                 /* Get name */
                 t16 = GET_ARG();
                 pobj1 = PM_FP->fo_func->f_co->co_names->val[t16];
@@ -1620,9 +1773,9 @@ interpret(const uint8_t returnOnNoThreads)
                 }
                 PM_BREAK_IF_ERROR(retval);
                 PM_PUSH(pobj2);
-                continue;
+                DISPATCH();
 
-            case SETUP_LOOP:
+            TARGET(SETUP_LOOP)
             {
                 uint8_t *pchunk;
 
@@ -1645,28 +1798,28 @@ interpret(const uint8_t returnOnNoThreads)
                 /* Insert block into blockstack */
                 ((pPmBlock_t)pobj1)->next = PM_FP->fo_blockstack;
                 PM_FP->fo_blockstack = (pPmBlock_t)pobj1;
-                continue;
+                DISPATCH();
             }
 
-            case LOAD_FAST:
+            TARGET(LOAD_FAST)
                 t16 = GET_ARG();
                 PM_PUSH(PM_FP->fo_locals[t16]);
-                continue;
+                DISPATCH();
 
-            case STORE_FAST:
+            TARGET(STORE_FAST)
                 t16 = GET_ARG();
                 PM_FP->fo_locals[t16] = PM_POP();
-                continue;
+                DISPATCH();
 
 #ifdef HAVE_DEL
-            case DELETE_FAST:
+            TARGET(DELETE_FAST)
                 t16 = GET_ARG();
                 PM_FP->fo_locals[t16] = PM_NONE;
-                continue;
+                DISPATCH();
 #endif /* HAVE_DEL */
 
 #ifdef HAVE_ASSERT
-            case RAISE_VARARGS:
+            TARGET(RAISE_VARARGS)
                 t16 = GET_ARG();
 
                 /* Only supports taking 1 arg for now */
@@ -1708,7 +1861,7 @@ interpret(const uint8_t returnOnNoThreads)
                 break;
 #endif /* HAVE_ASSERT */
 
-            case CALL_FUNCTION:
+            TARGET(CALL_FUNCTION)
                 /* Get num args */
                 t16 = GET_ARG();
 
@@ -1807,7 +1960,7 @@ interpret(const uint8_t returnOnNoThreads)
 
                         /* Otherwise, continue with instance */
                         heap_gcPopTempRoot(objid);
-                        continue;
+                        DISPATCH();
                     }
                     else if (retval != PM_RET_OK)
                     {
@@ -2065,9 +2218,9 @@ CALL_FUNC_FOR_ITER:
 CALL_FUNC_CLEANUP:
                 heap_gcPopTempRoot(objid);
                 PM_BREAK_IF_ERROR(retval);
-                continue;
+                DISPATCH();
 
-            case MAKE_FUNCTION:
+            TARGET(MAKE_FUNCTION)
                 /* Get num default args to fxn */
                 t16 = GET_ARG();
 
@@ -2110,10 +2263,10 @@ CALL_FUNC_CLEANUP:
 
                 /* Push func obj */
                 PM_PUSH(pobj2);
-                continue;
+                DISPATCH();
 
 #ifdef HAVE_CLOSURES
-            case MAKE_CLOSURE:
+            TARGET(MAKE_CLOSURE)
                 /* Get number of default args */
                 t16 = GET_ARG();
                 retval = func_new(TOS, (pPmObj_t)PM_FP->fo_globals, &pobj2);
@@ -2140,10 +2293,10 @@ CALL_FUNC_CLEANUP:
 
                 /* Push new func with closure */
                 PM_PUSH(pobj2);
-                continue;
+                DISPATCH();
 
-            case LOAD_CLOSURE:
-            case LOAD_DEREF:
+            TARGET(LOAD_CLOSURE)
+            TARGET(LOAD_DEREF)
                 /* Loads the i'th cell of free variable storage onto TOS */
                 t16 = GET_ARG();
                 pobj1 = PM_FP->fo_locals[PM_FP->fo_func->f_co->co_nlocals + t16];
@@ -2153,17 +2306,17 @@ CALL_FUNC_CLEANUP:
                     break;
                 }
                 PM_PUSH(pobj1);
-                continue;
+                DISPATCH();
 
-            case STORE_DEREF:
+            TARGET(STORE_DEREF)
                 /* Stores TOS into the i'th cell of free variable storage */
                 t16 = GET_ARG();
                 PM_FP->fo_locals[PM_FP->fo_func->f_co->co_nlocals + t16] = PM_POP();
-                continue;
+                DISPATCH();
 #endif /* HAVE_CLOSURES */
 
 
-            default:
+            TARGET_DEFAULT
                 /* SystemError, unknown or unimplemented opcode */
                 PM_RAISE(retval, PM_RET_EX_SYS);
                 break;
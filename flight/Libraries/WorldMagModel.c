@@ -155,6 +155,32 @@ static WMMtype_Ellipsoid        *Ellip = NULL;
 static WMMtype_MagneticModel    *MagneticModel = NULL;
 static float                    decimal_date;
 
+// Main field coefficients adjusted for secular variation to timed_date.
+// They only change with the date, so are worked out once per day instead
+// of on every lookup in the summation.
+static float                    TimedCoeffG[NUMTERMS];
+static float                    TimedCoeffH[NUMTERMS];
+static float                    timed_date = 0;
+
+// Field linearised around the last position WMM_GetMagVectorLocal() refreshed at
+#define WMM_LOCAL_REFRESH_KM    20.0f   // distance moved before the model is re-evaluated
+#define WMM_LOCAL_REFRESH_ALT   2000.0f // altitude change (m) before the model is re-evaluated
+#define WMM_LOCAL_STEP_DEG      0.1f    // finite difference step for the horizontal gradient
+#define WMM_LOCAL_STEP_ALT      1000.0f // finite difference step for the vertical gradient (m)
+#define WMM_KM_PER_DEG          111.32f
+
+static struct {
+	bool valid;
+	float date;
+	float Lat, Lon, Alt;
+	float B[3];
+	float dB_dLat[3];
+	float dB_dLon[3];
+	float dB_dAlt[3];
+} LocalField;
+
+static void WMM_TimelyModifyCoeffs(void);
+
 /**************************************************************************************
 *   Example use - very simple - only two exposed functions
 *
@@ -164,6 +190,9 @@ static float                    decimal_date;
 *	e.g. Iceland in may of 2012 = WMM_GetMagVector(65.0, -20.0, 0.0, 5, 5, 2012, B);
 *	Alt is above the WGS-84 Ellipsoid
 *	B is the NED (XYZ) magnetic vector in nTesla
+*
+*	WMM_GetMagVectorLocal() takes the same arguments and is cheap enough to call
+*	continuously, it only evaluates the full model after moving WMM_LOCAL_REFRESH_KM
 **************************************************************************************/
 
 int WMM_Initialize()
@@ -254,6 +283,8 @@ int WMM_GetMagVector(float Lat, float Lon, float AltEllipsoid, uint16_t Month, u
     {
         if (WMM_DateToYear(Month, Day, Year) < 0)
             returned = -8;  // error
+        else
+            WMM_TimelyModifyCoeffs();
     }
 
     if (returned >= 0)
@@ -263,9 +294,9 @@ int WMM_GetMagVector(float Lat, float Lon, float AltEllipsoid, uint16_t Month, u
             returned = -9;  // error
         else
         {   // set the returned values
-            B[0] = GeoMagneticElements->X;
-            B[1] = GeoMagneticElements->Y;
-            B[2] = GeoMagneticElements->Z;
+            B[0] = GeoMagneticElements->X * 1e-2;
+            B[1] = GeoMagneticElements->Y * 1e-2;
+            B[2] = GeoMagneticElements->Z * 1e-2;
         }
     }
 
@@ -293,13 +324,78 @@ int WMM_GetMagVector(float Lat, float Lon, float AltEllipsoid, uint16_t Month, u
         Ellip = NULL;
     }
 
-	B[0] = GeoMagneticElements->X * 1e-2;
-	B[1] = GeoMagneticElements->Y * 1e-2;
-	B[2] = GeoMagneticElements->Z * 1e-2;
-
     return returned;
 }
 
+int WMM_GetMagVectorLocal(float Lat, float Lon, float AltEllipsoid, uint16_t Month, uint16_t Day, uint16_t Year, float B[3])
+{
+    // return '0' if all appears to be OK
+    // return < 0 if error, as WMM_GetMagVector()
+
+    if (Lat <  -90) return -1;  // error
+    if (Lat >   90) return -2;  // error
+
+    if (Lon < -180) return -3;  // error
+    if (Lon >  180) return -4;  // error
+
+    if (WMM_DateToYear(Month, Day, Year) < 0)
+        return -8;  // error
+
+    float dLon = Lon - LocalField.Lon;
+    if (dLon > 180)
+        dLon -= 360;
+    else if (dLon < -180)
+        dLon += 360;
+    float dLat = Lat - LocalField.Lat;
+    float dAlt = AltEllipsoid - LocalField.Alt;
+
+    float north_km = dLat * WMM_KM_PER_DEG;
+    float east_km = dLon * WMM_KM_PER_DEG * cos(DEG2RAD(LocalField.Lat));
+
+    if (!LocalField.valid || LocalField.date != decimal_date ||
+        north_km * north_km + east_km * east_km > WMM_LOCAL_REFRESH_KM * WMM_LOCAL_REFRESH_KM ||
+        fabs(dAlt) > WMM_LOCAL_REFRESH_ALT)
+    {
+        // Evaluate the model here and a step north, east and up of here. The steps
+        // point back towards the equator and dateline so they stay in range.
+        float stepLat = (Lat > 0) ? -WMM_LOCAL_STEP_DEG : WMM_LOCAL_STEP_DEG;
+        float stepLon = (Lon > 0) ? -WMM_LOCAL_STEP_DEG : WMM_LOCAL_STEP_DEG;
+        float B_lat[3], B_lon[3], B_alt[3];
+        int returned;
+
+        LocalField.valid = false;
+
+        if ((returned = WMM_GetMagVector(Lat, Lon, AltEllipsoid, Month, Day, Year, LocalField.B)) < 0)
+            return returned;
+        if ((returned = WMM_GetMagVector(Lat + stepLat, Lon, AltEllipsoid, Month, Day, Year, B_lat)) < 0)
+            return returned;
+        if ((returned = WMM_GetMagVector(Lat, Lon + stepLon, AltEllipsoid, Month, Day, Year, B_lon)) < 0)
+            return returned;
+        if ((returned = WMM_GetMagVector(Lat, Lon, AltEllipsoid + WMM_LOCAL_STEP_ALT, Month, Day, Year, B_alt)) < 0)
+            return returned;
+
+        for (uint8_t i = 0; i < 3; i++)
+        {
+            LocalField.dB_dLat[i] = (B_lat[i] - LocalField.B[i]) / stepLat;
+            LocalField.dB_dLon[i] = (B_lon[i] - LocalField.B[i]) / stepLon;
+            LocalField.dB_dAlt[i] = (B_alt[i] - LocalField.B[i]) / WMM_LOCAL_STEP_ALT;
+        }
+
+        LocalField.Lat = Lat;
+        LocalField.Lon = Lon;
+        LocalField.Alt = AltEllipsoid;
+        LocalField.date = decimal_date;
+        LocalField.valid = true;
+
+        dLat = dLon = dAlt = 0;
+    }
+
+    for (uint8_t i = 0; i < 3; i++)
+        B[i] = LocalField.B[i] + LocalField.dB_dLat[i] * dLat + LocalField.dB_dLon[i] * dLon + LocalField.dB_dAlt[i] * dAlt;
+
+    return 0;   // OK
+}
+
 int WMM_Geomag(WMMtype_CoordSpherical * CoordSpherical, WMMtype_CoordGeodetic * CoordGeodetic, WMMtype_GeoMagneticElements * GeoMagneticElements)
    /*
       The main subroutine that calls a sequence of WMM sub-functions to calculate the magnetic field elements for a single point.
@@ -1188,66 +1284,55 @@ int WMM_SecVarSummationSpecial(WMMtype_SphericalHarmonicVariables *
 }
 
 /**
- * @brief Comput the MainFieldCoeffH accounting for the date
+ * @brief Adjust the main field coefficients for secular variation to the
+ * current decimal_date, skipped when they are already for that date
  */
-float WMM_get_main_field_coeff_g(uint16_t index) 
-{	
-	if (index >= NUMTERMS)
-		return 0;
+static void WMM_TimelyModifyCoeffs(void)
+{
+	if (timed_date == decimal_date)
+		return;
 
-    uint16_t n, m, sum_index, a, b;
+	uint16_t a = MagneticModel->nMaxSecVar;
+	uint16_t b = (a * (a + 1) / 2 + a);
+	float dt = decimal_date - MagneticModel->epoch;
 
-    float coeff = CoeffFile[index][2];
-	
-	a = MagneticModel->nMaxSecVar;
-	b = (a * (a + 1) / 2 + a);
-	for (n = 1; n <= MagneticModel->nMax; n++)
+	// Index 0 is not a model term and keeps its value
+	TimedCoeffG[0] = CoeffFile[0][2];
+	TimedCoeffH[0] = CoeffFile[0][3];
+	for (uint16_t index = 1; index < NUMTERMS; index++)
 	{
-		for (m = 0; m <= n; m++)
+		TimedCoeffG[index] = CoeffFile[index][2];
+		TimedCoeffH[index] = CoeffFile[index][3];
+		if (index <= b)
 		{
-			
-			sum_index = (n * (n + 1) / 2 + m);
-			
-			/* Hacky for now, will solve for which conditions need summing analytically */
-			if (sum_index != index)
-				continue;
-			
-			if (index <= b) 
-				coeff += (decimal_date - MagneticModel->epoch) * WMM_get_secular_var_coeff_g(sum_index);
-			
+			TimedCoeffG[index] += dt * WMM_get_secular_var_coeff_g(index);
+			TimedCoeffH[index] += dt * WMM_get_secular_var_coeff_h(index);
 		}
 	}
-	
-	return coeff;
+
+	timed_date = decimal_date;
+}
+
+/**
+ * @brief Comput the MainFieldCoeffG accounting for the date
+ */
+float WMM_get_main_field_coeff_g(uint16_t index) 
+{	
+	if (index >= NUMTERMS)
+		return 0;
+
+	return TimedCoeffG[index];
 }
 
+/**
+ * @brief Comput the MainFieldCoeffH accounting for the date
+ */
 float WMM_get_main_field_coeff_h(uint16_t index) 
 {	
 	if (index >= NUMTERMS)
 		return 0;
 	
-    uint16_t n, m, sum_index, a, b;
-	float coeff = CoeffFile[index][3];
-	
-	a = MagneticModel->nMaxSecVar;
-	b = (a * (a + 1) / 2 + a);
-	for (n = 1; n <= MagneticModel->nMax; n++)
-	{
-		for (m = 0; m <= n; m++)
-		{
-			
-			sum_index = (n * (n + 1) / 2 + m);
-			
-			/* Hacky for now, will solve for which conditions need summing analytically */
-			if (sum_index != index)
-				continue;
-			
-			if (index <= b) 
-				coeff += (decimal_date - MagneticModel->epoch) * WMM_get_secular_var_coeff_h(sum_index);
-		}
-	}
-	
-	return coeff;	
+	return TimedCoeffH[index];
 }
 
 float WMM_get_secular_var_coeff_g(uint16_t index) 
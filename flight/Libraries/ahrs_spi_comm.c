@@ -51,22 +51,26 @@ CRC8 does not always catch noise from cross-coupling between data lines.
 //packet types
 typedef enum { COMMS_NULL, COMMS_OBJECT } COMMSCOMMAND;
 
-//The maximum number of objects that can be updated in one cycle.
-//Currently the link is capable of sending 3 packets per cycle but 2 is enough
-#define MAX_UPDATE_OBJECTS 2
+//Space for object data in one frame. Objects are packed back to back, so
+//this carries at least two of the largest object or many of the small ones
+#define OBJECT_BATCH_SIZE (2 * (sizeof(AhrsSharedData) + 1))
 
 //Number of transmissions + 1 before we expect to see the data acknowledge
 //This is controlled by the SPI hardware.
 #define ACK_LATENCY 4
 
-/** All data for one object
+/** A batch of objects, each is its index followed by its data
 */
 typedef struct {
-	uint8_t done;
-	uint8_t index;
-	AhrsSharedData object;
+	uint16_t done;		//bit per object index received from the other end in its last frame
+	uint16_t length;	//bytes used in data
+	uint8_t data[OBJECT_BATCH_SIZE];
 } ObjectPacketData;
 
+#if MAX_AHRS_OBJECTS > 16
+#error ObjectPacketData.done holds one bit per object
+#endif
+
 /** One complete packet.
 Other packet types are allowed for. The frame size will be the size of this
 structure.
@@ -76,7 +80,7 @@ typedef struct {
 	COMMSCOMMAND command;
 	AhrsEndStatus status;
 	union {			//allow for expansion to other packet types.
-		ObjectPacketData objects[MAX_UPDATE_OBJECTS];
+		ObjectPacketData objects;
 	};
 	uint8_t dummy; //For some reason comms trashes the last byte
 } CommsDataPacket;
@@ -116,6 +120,10 @@ static AhrsEventCallback objCallbacks[MAX_AHRS_OBJECTS];
 */
 static bool callbackPending[MAX_AHRS_OBJECTS];
 
+/** True when any entry of callbackPending is set, saves the scan when nothing arrived
+*/
+static volatile bool eventsPending;
+
 //More than this number of errors in a row will indicate the link is down
 #define MAX_CRC_ERRORS 50
 //At least this number of good frames are needed to indicate the link is up.
@@ -138,6 +146,7 @@ void AhrsInitComms(void)
 	memset(&txPacket, 0, sizeof(txPacket));
 	memset(&rxPacket, 0, sizeof(rxPacket));
 	memset(&readyObjects, 0, sizeof(bool) * MAX_AHRS_OBJECTS);
+	eventsPending = false;
 	txPacket.command = COMMS_NULL;
 	rxPacket.command = COMMS_NULL;
 }
@@ -191,37 +200,28 @@ void SetObjectDirty(const int idx)
 	dirtyObjects[idx] = ACK_LATENCY;
 }
 /** Work out what data needs to be sent.
-	If an object was not sent it will be retried 4 frames later
+	Changed objects are packed in priority order for as long as they fit,
+	the rest wait for the next frame. If an object was not acknowledged it
+	will be retried 4 frames later
 */
 static void FillObjectPacket()
 {
 	txPacket.command = COMMS_OBJECT;
 	txPacket.magicNumber = TXMAGIC;
-	int idx = 0;
-	for (int ct = 0; ct < MAX_UPDATE_OBJECTS; ct++) {
-		txPacket.objects[ct].index = AHRS_NO_OBJECT;
-		for (; idx < MAX_AHRS_OBJECTS; idx++) {
-			if (dirtyObjects[idx] > 0) {
-				if (dirtyObjects[idx] == ACK_LATENCY) {
-					dirtyObjects[idx]--;
-					txPacket.objects[ct].index = idx;
-					AhrsObjHandle hdl = AhrsFromIndex(idx);
-					if (hdl) {
-						memcpy(&txPacket.objects[ct].object, hdl->data, hdl->size);
-						break;
-					}
-				} else {
-					dirtyObjects[idx]--;
-					if (dirtyObjects[idx] == 0) {	//timed out
-						dirtyObjects[idx] = ACK_LATENCY;
-						txPacket.status.retries++;
-					}
-				}
-			}
+	txPacket.objects.length = 0;
+	for (int idx = 0; idx < MAX_AHRS_OBJECTS; idx++) {
+		if (dirtyObjects[idx] == 0) {
+			continue;
 		}
-	}
-	for (; idx < MAX_AHRS_OBJECTS; idx++) {
-		if (dirtyObjects[idx] > 0 && dirtyObjects[idx] != ACK_LATENCY) {
+		if (dirtyObjects[idx] == ACK_LATENCY) {
+			AhrsObjHandle hdl = AhrsFromIndex(idx);
+			if (hdl && txPacket.objects.length + 1 + hdl->size <= OBJECT_BATCH_SIZE) {
+				dirtyObjects[idx]--;
+				txPacket.objects.data[txPacket.objects.length++] = idx;
+				memcpy(&txPacket.objects.data[txPacket.objects.length], hdl->data, hdl->size);
+				txPacket.objects.length += hdl->size;
+			}
+		} else {
 			dirtyObjects[idx]--;
 			if (dirtyObjects[idx] == 0) {	//timed out
 				dirtyObjects[idx] = ACK_LATENCY;
@@ -253,36 +253,38 @@ static void HandleRxPacket()
 */
 static void HandleObjectPacket()
 {
-	for (int ct = 0; ct < MAX_UPDATE_OBJECTS; ct++) {
-	    uint8_t idx;
-
-		// Flag objects that have been successfully received at the other end
-		idx = rxPacket.objects[ct].done;
-        txPacket.objects[ct].done = AHRS_NO_OBJECT;
-		if (idx < MAX_AHRS_OBJECTS) {
-
-			if (dirtyObjects[idx] == 1) {	//this ack is the correct one for the last send
-				dirtyObjects[idx] = 0;
-			}
+	// Flag objects that have been successfully received at the other end
+	for (int idx = 0; idx < MAX_AHRS_OBJECTS; idx++) {
+		if ((rxPacket.objects.done & (1 << idx)) && dirtyObjects[idx] == 1) {	//this ack is the correct one for the last send
+			dirtyObjects[idx] = 0;
 		}
+	}
 
-		// Handle received object if there is one in this packet
-		idx = rxPacket.objects[ct].index;
-		if (idx == AHRS_NO_OBJECT) {
-			if (emptyCount > 0) {
-				emptyCount--;
-			}
-			continue;
-		}
+	// Handle the objects in this packet
+	txPacket.objects.done = 0;
+	if (rxPacket.objects.length == 0 && emptyCount > 0) {
+		emptyCount--;
+	}
+	uint16_t length = rxPacket.objects.length;
+	if (length > OBJECT_BATCH_SIZE) {
+		txPacket.status.invalidPacket++;
+		length = 0;
+	}
+	uint16_t pos = 0;
+	while (pos < length) {
+		uint8_t idx = rxPacket.objects.data[pos++];
 		AhrsObjHandle obj = AhrsFromIndex(idx);
-		if (obj) {
-			memcpy(obj->data, &rxPacket.objects[ct].object, obj->size);
-			txPacket.objects[ct].done = idx;
-			callbackPending[idx] = true;    // New data available, call callback
-			readyObjects[idx] = true;
-		} else {
+		if (!obj || pos + obj->size > length) {
+			// The rest of the batch can not be parsed without the object size
 			txPacket.status.invalidPacket++;
+			break;
 		}
+		memcpy(obj->data, &rxPacket.objects.data[pos], obj->size);
+		pos += obj->size;
+		txPacket.objects.done |= 1 << idx;
+		callbackPending[idx] = true;    // New data available, call callback
+		readyObjects[idx] = true;
+		eventsPending = true;
 	}
 #ifdef IN_AHRS
 	FillObjectPacket();	//ready for the next frame
@@ -365,6 +367,10 @@ static void CommsCallback(uint8_t crc_ok, uint8_t crc_val)
  */
 static void PollEvents(void)
 {
+	if (!eventsPending) {
+		return;
+	}
+	eventsPending = false;
 	for (int idx = 0; idx < MAX_AHRS_OBJECTS; idx++) {
 		if (objCallbacks[idx]) {
 			PIOS_IRQ_Disable();
@@ -0,0 +1,164 @@
+/**
+ ******************************************************************************
+ * @addtogroup OpenPilotSystem OpenPilot System
+ * @{
+ * @addtogroup OpenPilotLibraries OpenPilot System Libraries
+ * @{
+ * @file       eventtrace.c
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Ring of time stamped events for tracing the flight code. The
+ *             trace points write without a lock so they can be used from
+ *             tasks and interrupts, and Telemetry drains the ring when the
+ *             link has spare time.
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "openpilot.h"
+#include "eventtrace.h"
+
+// Private constants
+#ifndef EVENTTRACE_BUFFER_SIZE
+#define EVENTTRACE_BUFFER_SIZE 64	// must be a power of two
+#endif
+#define EVENTTRACE_BUFFER_MASK (EVENTTRACE_BUFFER_SIZE - 1)
+
+// Private types
+struct eventtrace_slot {
+	// Sequence number + 1 once the record is complete, 0 while it is written
+	uint32_t sequence;
+	uint32_t raw_time;
+	uint16_t event;
+	uint16_t arg;
+};
+
+// Private variables
+static volatile struct eventtrace_slot ring[EVENTTRACE_BUFFER_SIZE];
+static volatile uint32_t head;	// sequence number of the next record written
+static uint32_t tail;		// sequence number of the next record read
+
+// The raw time wraps within seconds, the reader keeps a us clock
+static uint32_t clock_raw;
+static uint32_t clock_us;
+
+/**
+ * Initialize library, drops all records
+ */
+int32_t EventTraceInitialize(void)
+{
+	for (uint32_t n = 0; n < EVENTTRACE_BUFFER_SIZE; n++)
+		ring[n].sequence = 0;
+	tail = head;
+	clock_raw = PIOS_DELAY_GetRaw();
+	clock_us = 0;
+
+	return 0;
+}
+
+/**
+ * Add a record to the ring, overwriting the oldest one when it is full
+ * \param[in] event the trace point
+ * \param[in] arg value stored with it
+ */
+void EventTraceRecord(EventTraceId event, uint16_t arg)
+{
+	uint32_t timestamp = PIOS_DELAY_GetRaw();
+
+	// Taking the slot is the only shared update, a writer preempting this
+	// one takes the next slot
+	uint32_t sequence = __sync_fetch_and_add(&head, 1);
+	volatile struct eventtrace_slot * slot = &ring[sequence & EVENTTRACE_BUFFER_MASK];
+
+	slot->sequence = 0;
+	slot->raw_time = timestamp;
+	slot->event = event;
+	slot->arg = arg;
+	slot->sequence = sequence + 1;
+}
+
+/**
+ * Take the oldest records from the ring, only one reader is supported. The
+ * time stamps stay continuous as long as the ring is read at least once per
+ * wrap of the raw time.
+ * \param[out] records where to copy the records to
+ * \param[in] max_records size of records
+ * \param[out] sequence sequence number of the first record
+ * \param[out] lost records overwritten before they were read
+ * \return number of records copied
+ */
+uint16_t EventTraceRead(struct eventtrace_record * records, uint16_t max_records, uint32_t * sequence, uint32_t * lost)
+{
+	uint32_t end = head;
+	uint16_t count = 0;
+
+	*lost = 0;
+	if (end - tail > EVENTTRACE_BUFFER_SIZE) {
+		*lost = end - tail - EVENTTRACE_BUFFER_SIZE;
+		tail = end - EVENTTRACE_BUFFER_SIZE;
+	}
+	*sequence = tail;
+
+	while (tail != end && count < max_records) {
+		volatile struct eventtrace_slot * slot = &ring[tail & EVENTTRACE_BUFFER_MASK];
+		uint32_t expected = tail + 1;
+		uint32_t written = slot->sequence;
+
+		// Still being written, this and the later records are read next time
+		if (written == 0 || (int32_t)(written - expected) < 0)
+			break;
+
+		if (written == expected) {
+			uint32_t raw_time = slot->raw_time;
+			records[count].event = slot->event;
+			records[count].arg = slot->arg;
+
+			// Keep it only if it was not overwritten while copying
+			if (slot->sequence == expected) {
+				// Writers that preempt each other may store slightly out of order
+				if ((int32_t)(raw_time - clock_raw) >= 0)
+					clock_us += PIOS_DELAY_DiffuS2(clock_raw, raw_time);
+				else
+					clock_us -= PIOS_DELAY_DiffuS2(raw_time, clock_raw);
+				clock_raw = raw_time;
+				records[count].timestamp = clock_us;
+				count++;
+			} else {
+				(*lost)++;
+			}
+		} else {
+			(*lost)++;
+		}
+		tail++;
+	}
+
+	return count;
+}
+
+/**
+ * Number of records waiting to be read
+ */
+uint16_t EventTracePending(void)
+{
+	uint32_t pending = head - tail;
+
+	return (pending > EVENTTRACE_BUFFER_SIZE) ? EVENTTRACE_BUFFER_SIZE : pending;
+}
+
+/**
+ * @}
+ * @}
+ */
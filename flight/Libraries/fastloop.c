@@ -0,0 +1,218 @@
+/**
+ ******************************************************************************
+ * @addtogroup OpenPilotSystem OpenPilot System
+ * @{
+ * @addtogroup OpenPilotLibraries OpenPilot System Libraries
+ * @{
+ * @file       fastloop.c
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Synchronous gyro to actuator loop. The task that reads the gyro
+ *             runs the attitude, stabilization and actuator stages back to
+ *             back for every sample instead of passing the data through
+ *             UAVObject queues, and the latency and jitter are published in
+ *             FastLoopStatus.
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "openpilot.h"
+#include "fastloop.h"
+#include "fastloopstatus.h"
+
+// Private constants
+#define STATUS_PERIOD_US 1000000
+#define DEFAULT_DT 0.002f
+
+// Private types
+struct fastloop_window {
+	uint32_t start;
+	uint32_t cycles;
+	uint32_t latency_min;
+	uint32_t latency_max;
+	float latency_sum;
+	uint32_t period_min;
+	uint32_t period_max;
+	uint32_t periods;
+	float period_sum;
+	// Deviations from period_ref, keeps the variance from cancelling out
+	float period_ref;
+	float deviation_sum;
+	float deviation_sq_sum;
+	float stage_sum[FASTLOOP_STAGE_NUMELEM];
+};
+
+// Private variables
+static FastLoopStageFunction stages[FASTLOOP_STAGE_NUMELEM];
+static struct fastloop_window window;
+static uint32_t total_cycles;
+static uint32_t last_sample_time;
+static uint32_t last_start;
+static bool have_last;
+
+// Private functions
+static void resetWindow(uint32_t now);
+static void publishWindow(void);
+
+/**
+ * Initialize library. The stages may already be registered.
+ */
+int32_t FastLoopInitialize(void)
+{
+	FastLoopStatusInitialize();
+
+	total_cycles = 0;
+	have_last = false;
+	window.period_ref = 0;
+	resetWindow(PIOS_DELAY_GetRaw());
+
+	return 0;
+}
+
+/**
+ * Register the function that runs a stage, replacing any earlier one
+ */
+int32_t FastLoopRegister(FastLoopStage stage, FastLoopStageFunction function)
+{
+	if (stage >= FASTLOOP_STAGE_NUMELEM)
+		return -1;
+
+	stages[stage] = function;
+	return 0;
+}
+
+/**
+ * Run all registered stages for a new gyro sample
+ * \param[in] sample_time PIOS_DELAY_GetRaw() time the sample was taken at
+ */
+void FastLoopRun(uint32_t sample_time)
+{
+	uint32_t start = PIOS_DELAY_GetRaw();
+
+	// Every stage integrates over the same interval, the one between the sample timestamps
+	float dT = DEFAULT_DT;
+	if (have_last) {
+		uint32_t diff_us = PIOS_DELAY_DiffuS2(last_sample_time, sample_time);
+		if (diff_us > 0)
+			dT = diff_us * 1.0e-6f;
+	}
+	last_sample_time = sample_time;
+
+	uint32_t stage_start = start;
+	for (uint8_t n = 0; n < FASTLOOP_STAGE_NUMELEM; n++) {
+		if (stages[n] == NULL)
+			continue;
+
+		stages[n](dT);
+
+		uint32_t stage_end = PIOS_DELAY_GetRaw();
+		window.stage_sum[n] += PIOS_DELAY_DiffuS2(stage_start, stage_end);
+		stage_start = stage_end;
+	}
+
+	// Sample to output latency
+	uint32_t latency = PIOS_DELAY_DiffuS2(sample_time, stage_start);
+	if (latency < window.latency_min)
+		window.latency_min = latency;
+	if (latency > window.latency_max)
+		window.latency_max = latency;
+	window.latency_sum += latency;
+	window.cycles++;
+	total_cycles++;
+
+	// Period between the runs, this is the jitter seen by the actuators
+	if (have_last) {
+		uint32_t period = PIOS_DELAY_DiffuS2(last_start, start);
+		if (period < window.period_min)
+			window.period_min = period;
+		if (period > window.period_max)
+			window.period_max = period;
+		window.period_sum += period;
+		window.periods++;
+
+		if (window.period_ref == 0)
+			window.period_ref = period;
+		float deviation = period - window.period_ref;
+		window.deviation_sum += deviation;
+		window.deviation_sq_sum += deviation * deviation;
+	}
+	last_start = start;
+	have_last = true;
+
+	// Publishing last keeps it out of the sample to output path
+	if (PIOS_DELAY_DiffuS2(window.start, stage_start) >= STATUS_PERIOD_US) {
+		publishWindow();
+		resetWindow(stage_start);
+	}
+}
+
+/**
+ * Restart the statistics
+ */
+static void resetWindow(uint32_t now)
+{
+	float period_ref = window.period_ref;
+
+	memset(&window, 0, sizeof(window));
+	window.start = now;
+	window.latency_min = UINT32_MAX;
+	window.period_min = UINT32_MAX;
+
+	// Centre the next window on the average period of this one
+	window.period_ref = period_ref;
+}
+
+/**
+ * Update FastLoopStatus from the statistics of the last window
+ */
+static void publishWindow(void)
+{
+	FastLoopStatusData status;
+
+	// Only called after at least one cycle
+	status.Latency[FASTLOOPSTATUS_LATENCY_MINIMUM] = window.latency_min;
+	status.Latency[FASTLOOPSTATUS_LATENCY_AVERAGE] = window.latency_sum / window.cycles;
+	status.Latency[FASTLOOPSTATUS_LATENCY_MAXIMUM] = window.latency_max;
+
+	if (window.periods > 0) {
+		float mean = window.deviation_sum / window.periods;
+		float variance = window.deviation_sq_sum / window.periods - mean * mean;
+
+		status.Period[FASTLOOPSTATUS_PERIOD_MINIMUM] = window.period_min;
+		status.Period[FASTLOOPSTATUS_PERIOD_AVERAGE] = window.period_sum / window.periods;
+		status.Period[FASTLOOPSTATUS_PERIOD_MAXIMUM] = window.period_max;
+		status.Jitter = (variance > 0) ? sqrtf(variance) : 0;
+
+		window.period_ref = status.Period[FASTLOOPSTATUS_PERIOD_AVERAGE];
+	} else {
+		status.Period[FASTLOOPSTATUS_PERIOD_MINIMUM] = 0;
+		status.Period[FASTLOOPSTATUS_PERIOD_AVERAGE] = 0;
+		status.Period[FASTLOOPSTATUS_PERIOD_MAXIMUM] = 0;
+		status.Jitter = 0;
+	}
+
+	for (uint8_t n = 0; n < FASTLOOP_STAGE_NUMELEM; n++)
+		status.StageTime[n] = window.stage_sum[n] / window.cycles;
+
+	status.Cycles = total_cycles;
+
+	FastLoopStatusSet(&status);
+}
+
+/**
+ * @}
+ * @}
+ */
@@ -255,6 +255,47 @@ uint16_t fifoBuf_putData(t_fifo_buffer *buf, const void *data, uint16_t len)
     return i;                   // return number of bytes copied
 }
 
+uint8_t *fifoBuf_reserve(t_fifo_buffer *buf, uint16_t len)
+{       // get len contiguous free bytes at the write position, they are added with fifoBuf_commit()
+        // the reader must not run while an empty buffer is rewound, call with interrupts off
+
+    uint16_t rd = buf->rd;
+    uint16_t wr = buf->wr;
+    uint16_t buf_size = buf->buf_size;
+
+    if (rd == wr && buf_size - wr < len)
+    {   // empty, start again at the beginning to get the whole buffer in one piece
+        rd = wr = 0;
+        buf->rd = 0;
+        buf->wr = 0;
+    }
+
+    uint16_t num_bytes;
+    if (wr >= rd)
+    {
+        num_bytes = buf_size - wr;
+        if (rd == 0)
+            num_bytes--;                // keep the full/empty gap
+    }
+    else
+        num_bytes = rd - wr - 1;
+
+    if (num_bytes < len)
+        return NULL;
+
+    return buf->buf_ptr + wr;
+}
+
+void fifoBuf_commit(t_fifo_buffer *buf, uint16_t len)
+{       // add bytes written into the region returned by fifoBuf_reserve()
+
+    uint16_t wr = buf->wr + len;
+    if (wr >= buf->buf_size)
+        wr -= buf->buf_size;
+
+    buf->wr = wr;
+}
+
 void fifoBuf_init(t_fifo_buffer *buf, const void *buffer, const uint16_t buffer_size)
 {
     buf->buf_ptr = (uint8_t *)buffer;
@@ -8,6 +8,13 @@
 #define N_COL			4
 #define N_BLOCK			(N_ROW * N_COL)
 
+#define AES_128_ROUND_KEY_WORDS	44
+
+// Expanded key of the T-table implementation
+struct aes_128_context {
+	uint32_t round_keys[AES_128_ROUND_KEY_WORDS];
+};
+
 void aes_encrypt_cbc_128(void *data, void *key, void *chain_block);
 void aes_decrypt_cbc_128(void *data, void *key, void *chain_block);
 void aes_decrypt_key_128_create(void *enc_key, void *dec_key);
@@ -16,4 +23,12 @@ void aes_encrypt_cbc_256(void *data, void *key, void *chain_block);
 void aes_decrypt_cbc_256(void *data, void *key, void *chain_block);
 void aes_decrypt_key_256_create(void *enc_key, void *dec_key);
 
+void aes_128_key_expand(struct aes_128_context *ctx, const uint8_t *key);
+void aes_128_encrypt_block(const struct aes_128_context *ctx, const uint8_t *in, uint8_t *out);
+// CTR mode, encrypts or decrypts in place and advances counter by one per block.
+// A stream may be split over several calls, but every call except the last must
+// pass a length that is a multiple of N_BLOCK: the key stream left over from a
+// partial block is dropped, so the next call would reuse the wrong one.
+void aes_128_ctr(const struct aes_128_context *ctx, uint8_t *counter, uint8_t *data, uint32_t length);
+
 #endif
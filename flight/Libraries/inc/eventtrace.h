@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ * @addtogroup OpenPilotSystem OpenPilot System
+ * @{
+ * @addtogroup OpenPilotLibraries OpenPilot System Libraries
+ * @{
+ * @file       eventtrace.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Include file of the event trace library
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef EVENTTRACE_H
+#define EVENTTRACE_H
+
+/**
+ * Trace points, in the order of the options of TraceRecords.Event
+ */
+typedef enum {
+	EVENTTRACE_NONE = 0,
+	EVENTTRACE_SENSORS_START,		// arg: none
+	EVENTTRACE_SENSORS_END,			// arg: gyro samples read
+	EVENTTRACE_ATTITUDE_START,		// arg: none
+	EVENTTRACE_ATTITUDE_END,		// arg: none
+	EVENTTRACE_STABILIZATION_START,		// arg: none
+	EVENTTRACE_STABILIZATION_END,		// arg: none
+	EVENTTRACE_ACTUATOR_START,		// arg: none
+	EVENTTRACE_ACTUATOR_OUTPUT,		// arg: first channel value
+	EVENTTRACE_TELEMETRY_TX_START,		// arg: low half of the object ID
+	EVENTTRACE_TELEMETRY_TX_END,		// arg: low half of the object ID
+	EVENTTRACE_TELEMETRY_RX,		// arg: bytes received
+	EVENTTRACE_NUMELEM
+} EventTraceId;
+
+struct eventtrace_record {
+	uint32_t timestamp;	// us on the trace clock, which starts at EventTraceInitialize()
+	uint16_t event;
+	uint16_t arg;
+};
+
+int32_t EventTraceInitialize(void);
+void EventTraceRecord(EventTraceId event, uint16_t arg);
+uint16_t EventTraceRead(struct eventtrace_record * records, uint16_t max_records, uint32_t * sequence, uint32_t * lost);
+uint16_t EventTracePending(void);
+
+/**
+ * Trace points compile to nothing unless the firmware is built with DIAG_TRACE
+ */
+#if defined(DIAG_TRACE)
+#define EVENT_TRACE(event, arg) EventTraceRecord((event), (arg))
+#else
+#define EVENT_TRACE(event, arg)
+#endif
+
+#endif // EVENTTRACE_H
+
+/**
+ * @}
+ * @}
+ */
@@ -0,0 +1,57 @@
+/**
+ ******************************************************************************
+ * @addtogroup OpenPilotSystem OpenPilot System
+ * @{
+ * @addtogroup OpenPilotLibraries OpenPilot System Libraries
+ * @{
+ * @file       fastloop.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Include file of the synchronous gyro to actuator loop library
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef FASTLOOP_H
+#define FASTLOOP_H
+
+/**
+ * Stages of the loop, run in this order for every gyro sample
+ */
+typedef enum {
+	FASTLOOP_STAGE_ATTITUDE = 0,
+	FASTLOOP_STAGE_STABILIZATION,
+	FASTLOOP_STAGE_CAMERASTAB,
+	FASTLOOP_STAGE_ACTUATOR,
+	FASTLOOP_STAGE_NUMELEM
+} FastLoopStage;
+
+/**
+ * Stage function, dT is the time in seconds between the gyro samples of
+ * this and the previous run
+ */
+typedef void (*FastLoopStageFunction)(float dT);
+
+int32_t FastLoopInitialize(void);
+int32_t FastLoopRegister(FastLoopStage stage, FastLoopStageFunction function);
+void FastLoopRun(uint32_t sample_time);
+
+#endif // FASTLOOP_H
+
+/**
+ * @}
+ * @}
+ */
@@ -86,9 +86,14 @@ typedef struct {
 	uint8_t ecc[RS_ECC_NPARITY];
 } PHStatusPacket, *PHStatusPacketHandle;
 
+// Reliable packets are sent with a selective repeat window of up to PH_MAX_WIN_SIZE packets
+#define PH_MAX_WIN_SIZE 32
+
 typedef struct {
 	uint8_t winSize;
 	uint16_t maxConnections;
+	uint16_t retransmitTimeout;	// ms before an unacknowledged packet is resent
+	uint16_t ackDelay;	// ms to wait before ACKing, so one ACK covers the packets received meanwhile
 } PacketHandlerConfig;
 
 typedef int32_t (*PHOutputStream)(PHPacketHandle packet);
@@ -110,6 +115,7 @@ void PHReleaseRXPacket(PHInstHandle h, PHPacketHandle p);
 PHPacketHandle PHGetTXPacket(PHInstHandle h);
 void PHReleaseTXPacket(PHInstHandle h, PHPacketHandle p);
 uint8_t PHTransmitPacket(PHInstHandle h, PHPacketHandle p);
+void PHTransmitPending(PHInstHandle h);
 int32_t PHVerifyPacket(PHInstHandle h, PHPacketHandle p, uint16_t received_len);
 uint8_t PHReceivePacket(PHInstHandle h, PHPacketHandle p, bool rx_error);
 
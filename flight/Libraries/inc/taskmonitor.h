@@ -34,6 +34,8 @@ int32_t TaskMonitorInitialize(void);
 int32_t TaskMonitorAdd(TaskInfoRunningElem task, xTaskHandle handle);
 int32_t TaskMonitorRemove(TaskInfoRunningElem task);
 void TaskMonitorUpdateAll(void);
+void TaskMonitorIdleHook(void);
+void TaskMonitorSwitchedIn(unsigned long tag);
 
 #endif // TASKMONITOR_H
 
@@ -66,6 +66,11 @@ float P[NUMX][NUMX], X[NUMX];	// covariance matrix and state vector
 float Q[NUMW], R[NUMV];		// input noise and measurement noise variances
 float K[NUMX][NUMV];		// feedback gain matrix
 
+// Columns of H that LinearizeH() can set for each measurement, the
+// rest of every row is zero and is skipped by SerialUpdate()
+static const uint8_t HColStart[NUMV] = { 0, 1, 2, 3, 4, 5, 6, 6, 6, 2 };
+static const uint8_t HColEnd[NUMV] = { 1, 2, 3, 4, 5, 6, 10, 10, 10, 3 };
+
 //  *************  Exposed Functions ****************
 //  *************************************************
 
@@ -559,40 +564,44 @@ void CovariancePrediction(float F[NUMX][NUMX], float G[NUMX][NUMW],
 //            - or see Simon, "Optimal State Estimation," 1st Ed, p.150
 //  The SensorsUsed variable is a bitwise mask indicating which sensors
 //     should be used in the update.
+//  Only the columns HColStart[m]..HColEnd[m]-1 of each row of H are used,
+//     keep those tables in sync with LinearizeH().
 //  ************************************************
 
 void SerialUpdate(float H[NUMV][NUMX], float R[NUMV], float Z[NUMV],
 		  float Y[NUMV], float P[NUMX][NUMX], float X[NUMX],
 		  uint16_t SensorsUsed)
 {
-	float HP[NUMX], HPHR, Error;
-	uint8_t i, j, k, m;
+	float HP[NUMX], HPHR, HPHRinv, Error, Ki;
+	uint8_t i, j, k, m, k0, k1;
 
 	for (m = 0; m < NUMV; m++) {
 
 		if (SensorsUsed & (0x01 << m)) {	// use this sensor for update
 
+			k0 = HColStart[m];
+			k1 = HColEnd[m];
+
 			for (j = 0; j < NUMX; j++) {	// Find Hp = H*P
 				HP[j] = 0;
-				for (k = 0; k < NUMX; k++)
+				for (k = k0; k < k1; k++)
 					HP[j] += H[m][k] * P[k][j];
 			}
 			HPHR = R[m];	// Find  HPHR = H*P*H' + R
-			for (k = 0; k < NUMX; k++)
+			for (k = k0; k < k1; k++)
 				HPHR += HP[k] * H[m][k];
 
-			for (k = 0; k < NUMX; k++)
-				K[k][m] = HP[k] / HPHR;	// find K = HP/HPHR
-
-			for (i = 0; i < NUMX; i++) {	// Find P(m)= P(m-1) + K*HP
-				for (j = i; j < NUMX; j++)
-					P[i][j] = P[j][i] =
-					    P[i][j] - K[i][m] * HP[j];
-			}
-
+			// P may alias K as far as the compiler knows, so the gain is
+			// kept in a register for the row rather than reloaded from K
+			HPHRinv = 1.0f / HPHR;
 			Error = Z[m] - Y[m];
-			for (i = 0; i < NUMX; i++)	// Find X(m)= X(m-1) + K*Error
-				X[i] = X[i] + K[i][m] * Error;
+			for (i = 0; i < NUMX; i++) {
+				Ki = HP[i] * HPHRinv;	// find K = HP/HPHR
+				K[i][m] = Ki;
+				for (j = i; j < NUMX; j++)	// Find P(m)= P(m-1) + K*HP
+					P[i][j] = P[j][i] = P[i][j] - Ki * HP[j];
+				X[i] = X[i] + Ki * Error;	// Find X(m)= X(m-1) + K*Error
+			}
 
 		}
 	}
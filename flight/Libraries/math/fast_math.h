@@ -0,0 +1,202 @@
+/**
+ ******************************************************************************
+ * @addtogroup OpenPilot Math Utilities
+ * @{
+ * @addtogroup Fast approximations of the math library functions
+ * @{
+ *
+ * @file       fast_math.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Polynomial approximations of the trig functions, inverse square
+ *             root and quaternion conversions used in the control loops.
+ *
+ *             Maximum errors (checked on a host against double precision libm):
+ *               fast_sinf/cosf   4e-6 for angles within +-20 rad
+ *               fast_atan2f      2e-6 rad
+ *               fast_asinf       4.1e-6 rad
+ *               fast_invsqrtf    5e-6 relative
+ *
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <math.h>
+#include <stdint.h>
+
+#define FAST_MATH_PI       3.14159265358979f
+#define FAST_MATH_PI_2     1.57079632679490f
+#define FAST_MATH_2PI      6.28318530717959f
+#define FAST_MATH_INV_2PI  0.159154943091895f
+#define FAST_MATH_RAD2DEG  57.2957795130823f
+
+/**
+ * Sine of an angle in radians. The angle is reduced to [-pi/2, pi/2] and
+ * an odd polynomial is used there, so large angles lose precision.
+ */
+static inline float fast_sinf(float x)
+{
+	// Reduce to [-pi, pi]
+	float k = x * FAST_MATH_INV_2PI;
+	k = (float)(int32_t)(k + ((k >= 0) ? 0.5f : -0.5f));
+	x -= k * FAST_MATH_2PI;
+
+	// Fold into [-pi/2, pi/2] using sin(pi - x) = sin(x)
+	if (x > FAST_MATH_PI_2)
+		x = FAST_MATH_PI - x;
+	else if (x < -FAST_MATH_PI_2)
+		x = -FAST_MATH_PI - x;
+
+	float x2 = x * x;
+	return x * (1.0f + x2 * (-1.66666667e-1f + x2 * (8.33333333e-3f + x2 * (-1.98412698e-4f + x2 * 2.75573192e-6f))));
+}
+
+/**
+ * Cosine of an angle in radians
+ */
+static inline float fast_cosf(float x)
+{
+	return fast_sinf(x + FAST_MATH_PI_2);
+}
+
+/**
+ * Arc tangent of y/x in radians, in the range [-pi, pi]
+ */
+static inline float fast_atan2f(float y, float x)
+{
+	float ax = fabsf(x);
+	float ay = fabsf(y);
+
+	if (ax == 0 && ay == 0)
+		return 0;
+
+	// atan of a ratio in [0, 1], the octant is restored below
+	float z = (ay > ax) ? ax / ay : ay / ax;
+	float z2 = z * z;
+	float a = z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f + z2 * (0.05265332f + z2 * -0.01172120f)))));
+
+	if (ay > ax)
+		a = FAST_MATH_PI_2 - a;
+	if (x < 0)
+		a = FAST_MATH_PI - a;
+	if (y < 0)
+		a = -a;
+
+	return a;
+}
+
+/**
+ * Arc sine in radians, the argument is clamped to [-1, 1]
+ */
+static inline float fast_asinf(float x)
+{
+	if (x >= 1.0f)
+		return FAST_MATH_PI_2;
+	if (x <= -1.0f)
+		return -FAST_MATH_PI_2;
+
+	return fast_atan2f(x, sqrtf(1.0f - x * x));
+}
+
+/**
+ * 1 / sqrt(x) from the bit level estimate and two Newton steps
+ */
+static inline float fast_invsqrtf(float x)
+{
+	union {
+		float f;
+		uint32_t i;
+	} u;
+
+	u.f = x;
+	u.i = 0x5f3759df - (u.i >> 1);
+	u.f = u.f * (1.5f - 0.5f * x * u.f * u.f);
+	u.f = u.f * (1.5f - 0.5f * x * u.f * u.f);
+
+	return u.f;
+}
+
+/**
+ * Scale a quaternion to unit length
+ * @returns the length before scaling
+ */
+static inline float fast_quat_normalize(float q[4])
+{
+	float qmag2 = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+	float inv = fast_invsqrtf(qmag2);
+
+	q[0] *= inv;
+	q[1] *= inv;
+	q[2] *= inv;
+	q[3] *= inv;
+
+	return qmag2 * inv;
+}
+
+/**
+ * Roll, pitch and yaw in degrees from a quaternion, as Quaternion2RPY()
+ */
+static inline void fast_Quaternion2RPY(const float q[4], float rpy[3])
+{
+	float q0s = q[0] * q[0];
+	float q1s = q[1] * q[1];
+	float q2s = q[2] * q[2];
+	float q3s = q[3] * q[3];
+
+	float R13 = 2.0f * (q[1] * q[3] - q[0] * q[2]);
+	float R11 = q0s + q1s - q2s - q3s;
+	float R12 = 2.0f * (q[1] * q[2] + q[0] * q[3]);
+	float R23 = 2.0f * (q[2] * q[3] + q[0] * q[1]);
+	float R33 = q0s - q1s - q2s + q3s;
+
+	rpy[1] = FAST_MATH_RAD2DEG * fast_asinf(-R13);	// pitch always between -pi/2 to pi/2
+	rpy[2] = FAST_MATH_RAD2DEG * fast_atan2f(R12, R11);
+	rpy[0] = FAST_MATH_RAD2DEG * fast_atan2f(R23, R33);
+}
+
+/**
+ * Rotation matrix Rbe and roll, pitch, yaw in degrees from one quaternion,
+ * sharing the products between the two conversions
+ */
+static inline void fast_Quaternion2R_RPY(const float q[4], float Rbe[3][3], float rpy[3])
+{
+	float q0s = q[0] * q[0], q1s = q[1] * q[1], q2s = q[2] * q[2], q3s = q[3] * q[3];
+
+	Rbe[0][0] = q0s + q1s - q2s - q3s;
+	Rbe[0][1] = 2 * (q[1] * q[2] + q[0] * q[3]);
+	Rbe[0][2] = 2 * (q[1] * q[3] - q[0] * q[2]);
+	Rbe[1][0] = 2 * (q[1] * q[2] - q[0] * q[3]);
+	Rbe[1][1] = q0s - q1s + q2s - q3s;
+	Rbe[1][2] = 2 * (q[2] * q[3] + q[0] * q[1]);
+	Rbe[2][0] = 2 * (q[1] * q[3] + q[0] * q[2]);
+	Rbe[2][1] = 2 * (q[2] * q[3] - q[0] * q[1]);
+	Rbe[2][2] = q0s - q1s - q2s + q3s;
+
+	rpy[1] = FAST_MATH_RAD2DEG * fast_asinf(-Rbe[0][2]);
+	rpy[2] = FAST_MATH_RAD2DEG * fast_atan2f(Rbe[0][1], Rbe[0][0]);
+	rpy[0] = FAST_MATH_RAD2DEG * fast_atan2f(Rbe[1][2], Rbe[2][2]);
+}
+
+#endif /* FAST_MATH_H */
+
+/**
+ * @}
+ * @}
+ */
@@ -35,15 +35,46 @@
 extern char *debug_msg;
 
 // Private types and constants
+#define PH_MAX_RETRANSMITS 8
+#define PH_ACK_DATA_SIZE 5
+
+// State of a transmit window slot
+typedef enum {
+	PH_SLOT_FREE = 0,
+	PH_SLOT_QUEUED,             // waiting for room in the window
+	PH_SLOT_SENT                // sent, waiting for the ACK
+} PHSlotState;
+
+typedef struct {
+	uint8_t state;
+	uint8_t retries;
+	portTickType sent;
+} PHTxSlot;
+
+// ACK / NACK packet. As with the older protocol, rx_seq is the packet being ACKed, or the
+// one to resend for a NACK. The data adds the next sequence number expected and a bitmap
+// of the packets received after it, which peers without selective repeat ignore.
+typedef struct {
+	PHPacketHeader header;
+	uint8_t next_seq;
+	uint8_t sack[4];
+	uint8_t ecc[RS_ECC_NPARITY];
+} PHAckPacket;
+
 typedef struct {
 	PacketHandlerConfig cfg;
 	PHPacket *tx_packets;
-	uint8_t tx_win_start;
-	uint8_t tx_win_end;
+	PHTxSlot *tx_slots;
+	uint8_t tx_seq_id;
 	PHPacket *rx_packets;
-	uint8_t rx_win_start;
-	uint8_t rx_win_end;
-	uint16_t tx_seq_id;
+	bool *rx_held;
+	uint8_t rx_seq_id;
+	bool ack_pending;
+	portTickType ack_time;
+	uint32_t ack_destination;
+	uint32_t ack_source;
+	portTickType retransmit_timeout;
+	portTickType ack_delay;
 	PHOutputStream stream;
 	xSemaphoreHandle lock;
 	PHOutputStream output_stream;
@@ -53,9 +84,15 @@ typedef struct {
 } PHPacketData, *PHPacketDataHandle;
 
 // Private functions
-static uint8_t PHLSendAck(PHPacketDataHandle data, PHPacketHandle p);
-static uint8_t PHLSendNAck(PHPacketDataHandle data, PHPacketHandle p);
+static uint8_t PHLSendAck(PHPacketDataHandle data, uint8_t type, uint8_t seq);
 static uint8_t PHLTransmitPacket(PHPacketDataHandle data, PHPacketHandle p);
+static void PHLProcessAck(PHPacketDataHandle data, PHPacketHandle p);
+static bool PHLReceiveAckedData(PHPacketDataHandle data, PHPacketHandle p);
+static void PHLDeliverData(PHPacketDataHandle data, PHPacketHandle p);
+static uint32_t PHLSackBits(PHPacketDataHandle data);
+static uint8_t PHLWindowBase(PHPacketDataHandle data);
+static int8_t PHLFindTX(PHPacketDataHandle data, uint8_t seq);
+static int8_t PHLFindHeld(PHPacketDataHandle data, uint8_t seq);
 
 /**
  * Initialize the Packet Handler library
@@ -72,19 +109,29 @@ PHInstHandle PHInitialize(PacketHandlerConfig *cfg)
 	if (!data)
 		return 0;
 	data->cfg = *cfg;
+	if (data->cfg.winSize > PH_MAX_WIN_SIZE)
+		data->cfg.winSize = PH_MAX_WIN_SIZE;
 	data->tx_seq_id = 0;
+	data->rx_seq_id = 0;
+	data->ack_pending = false;
+	data->ack_destination = 0;
+	data->ack_source = 0;
+	data->retransmit_timeout = data->cfg.retransmitTimeout / portTICK_RATE_MS;
+	data->ack_delay = data->cfg.ackDelay / portTICK_RATE_MS;
 
 	// Allocate the packet windows
 	data->tx_packets = pvPortMalloc(sizeof(PHPacket) * data->cfg.winSize);
+	data->tx_slots = pvPortMalloc(sizeof(PHTxSlot) * data->cfg.winSize);
 	data->rx_packets = pvPortMalloc(sizeof(PHPacket) * data->cfg.winSize);
+	data->rx_held = pvPortMalloc(sizeof(bool) * data->cfg.winSize);
 
 	// Initialize the windows
-	data->tx_win_start = data->tx_win_end = 0;
-	data->rx_win_start = data->rx_win_end = 0;
 	for (uint8_t i = 0; i < data->cfg.winSize; ++i)
 	{
 		data->tx_packets[i].header.type = PACKET_TYPE_NONE;
+		data->tx_slots[i].state = PH_SLOT_FREE;
 		data->rx_packets[i].header.type = PACKET_TYPE_NONE;
+		data->rx_held[i] = false;
 	}
 
 	// Create the lock
@@ -202,10 +249,9 @@ void PHReleaseTXPacket(PHInstHandle h, PHPacketHandle p)
 	// Change the packet type so we know this packet is unused.
 	p->header.type = PACKET_TYPE_NONE;
 
-	// If this packet is at the start of the window, increment the start index.
-	while ((data->tx_win_start != data->tx_win_end) &&
-	       (data->tx_packets[data->tx_win_start].header.type == PACKET_TYPE_NONE))
-		data->tx_win_start = (data->tx_win_start + 1) % data->cfg.winSize;
+	// Remove it from the transmit window.
+	if ((p >= data->tx_packets) && (p < data->tx_packets + data->cfg.winSize))
+		data->tx_slots[p - data->tx_packets].state = PH_SLOT_FREE;
 
 	// Release lock
 	xSemaphoreGiveRecursive(data->lock);
@@ -256,17 +302,15 @@ void PHReleaseRXPacket(PHInstHandle h, PHPacketHandle p)
 	// Change the packet type so we know this packet is unused.
 	p->header.type = PACKET_TYPE_NONE;
 
-	// If this packet is at the start of the window, increment the start index.
-	while ((data->rx_win_start != data->rx_win_end) &&
-				 (data->rx_packets[data->rx_win_start].header.type == PACKET_TYPE_NONE))
-		data->rx_win_start = (data->rx_win_start + 1) % data->cfg.winSize;
-
 	// Release lock
 	xSemaphoreGiveRecursive(data->lock);
 }
 
 /**
  * Transmit a packet from the transmit packet buffer window.
+ * PACKET_TYPE_ACKED_DATA packets get the next sequence number and stay in the window
+ * until they are ACKed, they are sent as soon as the receive window of the other side
+ * has room for them.
  * \param[in] h The packet handler instance data pointer.
  * \param[in] p A pointer to the packet buffer.
  * \return 1 Success
@@ -276,6 +320,21 @@ uint8_t PHTransmitPacket(PHInstHandle h, PHPacketHandle p)
 {
 	PHPacketDataHandle data = (PHPacketDataHandle)h;
 
+	// Queue reliable packets in the transmit window.
+	if ((p->header.type == PACKET_TYPE_ACKED_DATA) &&
+	    (p >= data->tx_packets) && (p < data->tx_packets + data->cfg.winSize))
+	{
+		xSemaphoreTakeRecursive(data->lock, portMAX_DELAY);
+		PHTxSlot *slot = data->tx_slots + (p - data->tx_packets);
+		p->header.tx_seq = data->tx_seq_id++;
+		slot->state = PH_SLOT_QUEUED;
+		slot->retries = 0;
+		xSemaphoreGiveRecursive(data->lock);
+
+		PHTransmitPending(h);
+		return 1;
+	}
+
 	// Try to transmit the packet.
 	if (!PHLTransmitPacket(data, p))
 		return 0;
@@ -293,6 +352,59 @@ uint8_t PHTransmitPacket(PHInstHandle h, PHPacketHandle p)
 	return 1;
 }
 
+/**
+ * Send what is due in the transmit window: queued packets that now fit in the window,
+ * retransmissions of packets that were not ACKed in time, and the ACK for the packets
+ * received within the ACK delay.
+ * This should be called at least every ackDelay ms.
+ * \param[in] h The packet handler instance data pointer.
+ */
+void PHTransmitPending(PHInstHandle h)
+{
+	PHPacketDataHandle data = (PHPacketDataHandle)h;
+	portTickType now = xTaskGetTickCount();
+
+	// Lock
+	xSemaphoreTakeRecursive(data->lock, portMAX_DELAY);
+
+	// Retransmit the packets that have timed out, or give up on them.
+	for (uint8_t i = 0; i < data->cfg.winSize; ++i)
+	{
+		PHTxSlot *slot = data->tx_slots + i;
+		if ((slot->state != PH_SLOT_SENT) || ((portTickType)(now - slot->sent) < data->retransmit_timeout))
+			continue;
+		if (slot->retries >= PH_MAX_RETRANSMITS)
+		{
+			DEBUG_PRINTF(1, "Dropping packet %d, no ACK\n\r", data->tx_packets[i].header.tx_seq);
+			PHReleaseTXPacket(h, data->tx_packets + i);
+			continue;
+		}
+		slot->retries++;
+		slot->sent = now;
+		PHLTransmitPacket(data, data->tx_packets + i);
+	}
+
+	// Send the queued packets, in sequence, that fit in the window.
+	uint8_t base = PHLWindowBase(data);
+	for (uint8_t offset = 0; offset < data->cfg.winSize; ++offset)
+	{
+		int8_t i = PHLFindTX(data, base + offset);
+		if ((i >= 0) && (data->tx_slots[i].state == PH_SLOT_QUEUED))
+		{
+			data->tx_slots[i].state = PH_SLOT_SENT;
+			data->tx_slots[i].sent = now;
+			PHLTransmitPacket(data, data->tx_packets + i);
+		}
+	}
+
+	// ACK the last packet received in sequence.
+	if (data->ack_pending && ((portTickType)(now - data->ack_time) >= data->ack_delay))
+		PHLSendAck(data, PACKET_TYPE_ACK, data->rx_seq_id - 1);
+
+	// Release lock
+	xSemaphoreGiveRecursive(data->lock);
+}
+
 /**
  * Verify that a buffer contains a valid packet.
  * \param[in] h The packet handler instance data pointer.
@@ -339,6 +451,7 @@ uint8_t PHReceivePacket(PHInstHandle h, PHPacketHandle p, bool rx_error)
 {
 	PHPacketDataHandle data = (PHPacketDataHandle)h;
 	uint16_t len = PHPacketSizeECC(p);
+	bool held = false;
 
 	// Extract the RSSI and AFC.
 	int8_t rssi = *(((int8_t*)p) + len);
@@ -346,6 +459,14 @@ uint8_t PHReceivePacket(PHInstHandle h, PHPacketHandle p, bool rx_error)
 
 	switch (p->header.type) {
 
+	case PACKET_TYPE_ACK:
+	case PACKET_TYPE_NACK:
+
+		if (!rx_error)
+			PHLProcessAck(data, p);
+
+		break;
+
 	case PACKET_TYPE_STATUS:
 
 		if (!rx_error)
@@ -358,53 +479,24 @@ uint8_t PHReceivePacket(PHInstHandle h, PHPacketHandle p, bool rx_error)
 
 	case PACKET_TYPE_ACKED_DATA:
 
-		// Send the ACK / NACK
 		if (rx_error)
 		{
-			DEBUG_PRINTF(1, "Sending NACK\n\r");
-			PHLSendNAck(data, p);
+			// The header can't be trusted, so just ask for the first missing packet again.
+			if (data->ack_destination)
+			{
+				DEBUG_PRINTF(1, "Sending NACK\n\r");
+				PHLSendAck(data, PACKET_TYPE_NACK, data->rx_seq_id);
+			}
 		}
 		else
 		{
-
-			PHLSendAck(data, p);
-
-			// Pass on the data.
-			if(data->data_handler)
-				data->data_handler(p->data, p->header.data_size, rssi, afc);
+			data->ack_destination = p->header.source_id;
+			data->ack_source = p->header.destination_id;
+			held = PHLReceiveAckedData(data, p);
 		}
 
 		break;
 
-	case PACKET_TYPE_ACK:
-	{
-		// Find the packet ID in the TX buffer, and free it.
-		unsigned int i = 0;
-		for (unsigned int i = 0; i < data->cfg.winSize; ++i)
-			if (data->tx_packets[i].header.tx_seq == p->header.rx_seq)
-				PHReleaseTXPacket(h, data->tx_packets + i);
-#ifdef DEBUG_LEVEL
-		if (i == data->cfg.winSize)
-			DEBUG_PRINTF(1, "Error finding acked packet to release\n\r");
-#endif
-	}
-	break;
-
-	case PACKET_TYPE_NACK:
-	{
-		// Resend the packet.
-		unsigned int i = 0;
-		for ( ; i < data->cfg.winSize; ++i)
-			if (data->tx_packets[i].header.tx_seq == p->header.rx_seq)
-				PHLTransmitPacket(data, data->tx_packets + i);
-#ifdef DEBUG_LEVEL
-		if (i == data->cfg.winSize)
-			DEBUG_PRINTF(1, "Error finding acked packet to NACK\n\r");
-		DEBUG_PRINTF(1, "Resending after NACK\n\r");
-#endif
-	}
-	break;
-
 	case PACKET_TYPE_PPM:
 
 		if (!rx_error)
@@ -429,8 +521,9 @@ uint8_t PHReceivePacket(PHInstHandle h, PHPacketHandle p, bool rx_error)
 		break;
 	}
 
-	// Release the packet.
-	PHReleaseRXPacket(h, p);
+	// Release the packet, unless it's waiting for the packets before it.
+	if (!held)
+		PHReleaseRXPacket(h, p);
 	
 	return 1;
 }
@@ -448,57 +541,256 @@ static uint8_t PHLTransmitPacket(PHPacketDataHandle data, PHPacketHandle p)
 	if(!data->output_stream)
 		return 0;
 
-	// Set the sequence ID to the current ID.
-	p->header.tx_seq = data->tx_seq_id++;
+	// Lock, the stream is shared by the tasks sending and ACKing packets.
+	xSemaphoreTakeRecursive(data->lock, portMAX_DELAY);
 
 	// Add the error correcting code.
 	encode_data((unsigned char*)p, PHPacketSize(p), (unsigned char*)p);
 
 	// Transmit the packet using the output stream.
-	if(data->output_stream(p) == -1)
-		return 0;
+	int32_t ret = data->output_stream(p);
 
-	return 1;
+	// Release lock
+	xSemaphoreGiveRecursive(data->lock);
+
+	return (ret == -1) ? 0 : 1;
 }
 
 /**
- * Send an ACK packet.
+ * Send an ACK or NACK packet. Besides the packet it names, it carries the next sequence
+ * number we expect, and a bitmap of the packets after it that we have already received.
  * \param[in] data The packet handler instance data pointer.
- * \param[in] p A pointer to the packet buffer of the packet to be ACKed.
+ * \param[in] type PACKET_TYPE_ACK or PACKET_TYPE_NACK
+ * \param[in] seq The packet to ACK, or to resend for a NACK
  * \return 1 Success
  * \return 0 Failure
  */
-static uint8_t PHLSendAck(PHPacketDataHandle data, PHPacketHandle p)
+static uint8_t PHLSendAck(PHPacketDataHandle data, uint8_t type, uint8_t seq)
 {
+	uint32_t sack = PHLSackBits(data);
 
 	// Create the ACK message
-	PHPacketHeader ack;
-	ack.destination_id = p->header.source_id;
-	ack.type = PACKET_TYPE_ACK;
-	ack.rx_seq = p->header.tx_seq;
-	ack.data_size = 0;
+	PHAckPacket ack;
+	ack.header.destination_id = data->ack_destination;
+	ack.header.source_id = data->ack_source;
+	ack.header.type = type;
+	ack.header.tx_seq = 0;
+	ack.header.rx_seq = seq;
+	ack.header.data_size = PH_ACK_DATA_SIZE;
+	ack.next_seq = data->rx_seq_id;
+	ack.sack[0] = sack;
+	ack.sack[1] = sack >> 8;
+	ack.sack[2] = sack >> 16;
+	ack.sack[3] = sack >> 24;
+	data->ack_pending = false;
 
 	// Send the packet.
 	return PHLTransmitPacket(data, (PHPacketHandle)&ack);
 }
 
 /**
- * Send an NAck packet.
+ * Process an ACK or NACK sent by the other side. The packet named in rx_seq is released,
+ * or resent for a NACK. If the other side does selective repeat, the packets it has
+ * received in sequence or out of order are released too.
  * \param[in] data The packet handler instance data pointer.
- * \param[in] p A pointer to the packet buffer of the packet to be ACKed.
- * \return 1 Success
- * \return 0 Failure
+ * \param[in] p A pointer to the ACK or NACK packet.
  */
-static uint8_t PHLSendNAck(PHPacketDataHandle data, PHPacketHandle p)
+static void PHLProcessAck(PHPacketDataHandle data, PHPacketHandle p)
 {
+	int8_t last_sacked = -1;
+	uint8_t last_offset = 0;
+	bool nack = (p->header.type == PACKET_TYPE_NACK);
+	bool selective = (p->header.data_size >= PH_ACK_DATA_SIZE);
+	uint8_t ack = 0;
+	uint32_t sack = 0;
+	if (selective)
+	{
+		ack = p->data[0];
+		sack = p->data[1] | (p->data[2] << 8) | (p->data[3] << 16) | ((uint32_t)p->data[4] << 24);
+	}
+
+	// Lock
+	xSemaphoreTakeRecursive(data->lock, portMAX_DELAY);
 
-	// Create the NAck message
-	PHPacketHeader ack;
-	ack.destination_id = p->header.source_id;
-	ack.type = PACKET_TYPE_NACK;
-	ack.rx_seq = p->header.tx_seq;
-	ack.data_size = 0;
+	// Release the packets that have been received.
+	for (uint8_t i = 0; i < data->cfg.winSize; ++i)
+	{
+		if (data->tx_slots[i].state != PH_SLOT_SENT)
+			continue;
+		uint8_t seq = data->tx_packets[i].header.tx_seq;
+		uint8_t offset = seq - ack;
+		if ((!nack && (seq == p->header.rx_seq)) || (selective && (offset >= (uint8_t)(0 - data->cfg.winSize))))
+			PHReleaseTXPacket((PHInstHandle)data, data->tx_packets + i);
+		else if (selective && (offset > 0) && (offset <= 32) && (sack & (1UL << (offset - 1))))
+		{
+			if (offset > last_offset)
+			{
+				last_offset = offset;
+				last_sacked = i;
+			}
+			PHReleaseTXPacket((PHInstHandle)data, data->tx_packets + i);
+		}
+	}
 
-	// Set the packet.
-	return PHLTransmitPacket(data, (PHPacketHandle)&ack);
+	// Resend the packets that were sent before one that got through, but are still missing.
+	for (uint8_t i = 0; i < data->cfg.winSize; ++i)
+	{
+		PHTxSlot *slot = data->tx_slots + i;
+		if (slot->state != PH_SLOT_SENT)
+			continue;
+		uint8_t seq = data->tx_packets[i].header.tx_seq;
+		uint8_t offset = seq - ack;
+		bool lost = (last_sacked >= 0) && (offset < last_offset) &&
+			((int32_t)(slot->sent - data->tx_slots[last_sacked].sent) <= 0);
+		if (lost || (nack && (seq == p->header.rx_seq)))
+		{
+			slot->retries++;
+			slot->sent = xTaskGetTickCount();
+			PHLTransmitPacket(data, data->tx_packets + i);
+		}
+	}
+
+	// Release lock
+	xSemaphoreGiveRecursive(data->lock);
+}
+
+/**
+ * Receive a reliable data packet, and pass on the data in sequence.
+ * Packets that arrive ahead of a missing packet are held in the receive window.
+ * \param[in] data The packet handler instance data pointer.
+ * \param[in] p A pointer to the packet buffer.
+ * \return true The packet is held in the receive window
+ * \return false The packet can be released
+ */
+static bool PHLReceiveAckedData(PHPacketDataHandle data, PHPacketHandle p)
+{
+	uint8_t offset = p->header.tx_seq - data->rx_seq_id;
+
+	// Already received, our ACK must have been lost. Retransmissions can be up to
+	// two windows behind by the time they arrive.
+	if (offset >= (uint8_t)(0 - 2 * data->cfg.winSize))
+	{
+		PHLSendAck(data, PACKET_TYPE_ACK, p->header.tx_seq);
+		return false;
+	}
+
+	// Too far ahead to be in the window of the other side, it must have restarted.
+	// Pass on what we have and start over from this packet.
+	if (offset >= data->cfg.winSize)
+	{
+		DEBUG_PRINTF(1, "Resynchronizing to packet %d\n\r", p->header.tx_seq);
+		for (offset = 1; offset < data->cfg.winSize; ++offset)
+		{
+			int8_t i = PHLFindHeld(data, data->rx_seq_id + offset);
+			if (i >= 0)
+				PHLDeliverData(data, data->rx_packets + i);
+		}
+		data->rx_seq_id = p->header.tx_seq;
+		offset = 0;
+	}
+
+	// Out of order, hold it until the packets before it arrive, and tell the other side
+	// right away what is missing.
+	if (offset > 0)
+	{
+		if (PHLFindHeld(data, p->header.tx_seq) >= 0)
+			return false;
+		data->rx_held[p - data->rx_packets] = true;
+		PHLSendAck(data, PACKET_TYPE_ACK, p->header.tx_seq);
+		return true;
+	}
+
+	// Pass on this packet and the held packets that follow it.
+	PHLDeliverData(data, p);
+	int8_t i;
+	for (data->rx_seq_id++; (i = PHLFindHeld(data, data->rx_seq_id)) >= 0; data->rx_seq_id++)
+		PHLDeliverData(data, data->rx_packets + i);
+
+	// ACK it after the ACK delay, together with the packets that arrive meanwhile.
+	if (!data->ack_pending)
+	{
+		data->ack_time = xTaskGetTickCount();
+		data->ack_pending = true;
+	}
+
+	return false;
+}
+
+/**
+ * Pass on the data of a reliable packet, and release it if it was held.
+ * \param[in] data The packet handler instance data pointer.
+ * \param[in] p A pointer to the packet buffer.
+ */
+static void PHLDeliverData(PHPacketDataHandle data, PHPacketHandle p)
+{
+	uint16_t len = PHPacketSizeECC(p);
+
+	// Pass on the data.
+	if(data->data_handler)
+		data->data_handler(p->data, p->header.data_size, *(((int8_t*)p) + len), *(((int8_t*)p) + len + 1));
+
+	if (data->rx_held[p - data->rx_packets])
+	{
+		data->rx_held[p - data->rx_packets] = false;
+		PHReleaseRXPacket((PHInstHandle)data, p);
+	}
+}
+
+/**
+ * Build the bitmap of the packets held in the receive window, bit 0 is the packet
+ * after the next one expected.
+ * \param[in] data The packet handler instance data pointer.
+ */
+static uint32_t PHLSackBits(PHPacketDataHandle data)
+{
+	uint32_t sack = 0;
+	for (uint8_t i = 0; i < data->cfg.winSize; ++i)
+		if (data->rx_held[i])
+			sack |= 1UL << (uint8_t)(data->rx_packets[i].header.tx_seq - data->rx_seq_id - 1);
+	return sack;
+}
+
+/**
+ * Find the oldest sequence number in the transmit window.
+ * \param[in] data The packet handler instance data pointer.
+ */
+static uint8_t PHLWindowBase(PHPacketDataHandle data)
+{
+	uint8_t oldest = 0;
+	for (uint8_t i = 0; i < data->cfg.winSize; ++i)
+		if (data->tx_slots[i].state != PH_SLOT_FREE)
+		{
+			uint8_t age = data->tx_seq_id - data->tx_packets[i].header.tx_seq;
+			if (age > oldest)
+				oldest = age;
+		}
+	return data->tx_seq_id - oldest;
+}
+
+/**
+ * Find a packet in the transmit window.
+ * \param[in] data The packet handler instance data pointer.
+ * \param[in] seq The sequence number of the packet.
+ * \return The index of the packet, -1 if it isn't in the window
+ */
+static int8_t PHLFindTX(PHPacketDataHandle data, uint8_t seq)
+{
+	for (uint8_t i = 0; i < data->cfg.winSize; ++i)
+		if ((data->tx_slots[i].state != PH_SLOT_FREE) && (data->tx_packets[i].header.tx_seq == seq))
+			return i;
+	return -1;
+}
+
+/**
+ * Find a packet held in the receive window.
+ * \param[in] data The packet handler instance data pointer.
+ * \param[in] seq The sequence number of the packet.
+ * \return The index of the packet, -1 if it isn't held
+ */
+static int8_t PHLFindHeld(PHPacketDataHandle data, uint8_t seq)
+{
+	for (uint8_t i = 0; i < data->cfg.winSize; ++i)
+		if (data->rx_held[i] && (data->rx_packets[i].header.tx_seq == seq))
+			return i;
+	return -1;
 }
@@ -0,0 +1,143 @@
+/* Reed Solomon throughput benchmark
+ *
+ * Times encode_data() and decode_data() on packets the size the PipX
+ * packet handler sends, clean and with a damaged byte. The results are
+ * checked against the plain gmult() encoder and syndromes the library
+ * started out with, and timed against them too.
+ *
+ * Build on the host with
+ *   make benchmark RS_ECC_NPARITY=4
+ * and run ./benchmark [packet size]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ecc.h"
+
+#define PACKETS 256
+#define RUNS 20
+
+extern int genPoly[];
+
+static unsigned char packets[PACKETS][256];
+static int refSyn[RS_ECC_NPARITY];
+
+/* The encoder before the table driven shift register */
+static void
+ref_encode (unsigned char msg[], int nbytes, unsigned char dst[])
+{
+  int i, LFSR[RS_ECC_NPARITY+1], dbyte, j;
+
+  for (i = 0; i < RS_ECC_NPARITY+1; i++) LFSR[i] = 0;
+
+  for (i = 0; i < nbytes; i++) {
+    dbyte = msg[i] ^ LFSR[RS_ECC_NPARITY-1];
+    for (j = RS_ECC_NPARITY-1; j > 0; j--) {
+      LFSR[j] = LFSR[j-1] ^ gmult(genPoly[j], dbyte);
+    }
+    LFSR[0] = gmult(genPoly[0], dbyte);
+  }
+
+  if (dst != msg) memcpy(dst, msg, nbytes);
+  for (i = 0; i < RS_ECC_NPARITY; i++) dst[i+nbytes] = LFSR[RS_ECC_NPARITY-1-i];
+}
+
+/* The syndromes before the early exit */
+static void
+ref_decode (unsigned char data[], int nbytes)
+{
+  int i, j, sum;
+  for (j = 0; j < RS_ECC_NPARITY; j++) {
+    sum = 0;
+    for (i = 0; i < nbytes; i++) {
+      sum = data[i] ^ gmult(gexp[j+1], sum);
+    }
+    refSyn[j] = sum;
+  }
+}
+
+static double
+now (void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double
+rate (double seconds)
+{
+  return (double)PACKETS * RUNS / seconds;
+}
+
+int
+main (int argc, char *argv[])
+{
+  int size = (argc > 1) ? atoi(argv[1]) : 255 - RS_ECC_NPARITY;
+  unsigned char ref[256];
+  int n, r, j, bad = 0;
+  double t;
+
+  if (size < 1 || size + RS_ECC_NPARITY > 255) {
+    fprintf(stderr, "packet size must be 1 to %d\n", 255 - RS_ECC_NPARITY);
+    return 1;
+  }
+
+  initialize_ecc();
+  srand(1);
+  for (n = 0; n < PACKETS; n++) {
+    for (j = 0; j < size; j++) packets[n][j] = rand();
+  }
+
+  /* Check against the reference */
+  for (n = 0; n < PACKETS; n++) {
+    ref_encode(packets[n], size, ref);
+    encode_data(packets[n], size, packets[n]);
+    if (memcmp(ref, packets[n], size + RS_ECC_NPARITY) != 0) bad++;
+
+    decode_data(packets[n], size + RS_ECC_NPARITY);
+    if (check_syndrome() != 0) bad++;
+
+    packets[n][n % size] ^= 1 + n % 255;
+    ref_decode(packets[n], size + RS_ECC_NPARITY);
+    decode_data(packets[n], size + RS_ECC_NPARITY);
+    for (j = 0; j < RS_ECC_NPARITY; j++) {
+      if (synBytes[j] != refSyn[j]) bad++;
+    }
+    if (check_syndrome() == 0) bad++;
+    packets[n][n % size] ^= 1 + n % 255;
+  }
+  printf("%d parity bytes, %d byte packets, %d mismatches\n", RS_ECC_NPARITY, size, bad);
+
+  t = now();
+  for (r = 0; r < RUNS; r++)
+    for (n = 0; n < PACKETS; n++) ref_encode(packets[n], size, packets[n]);
+  printf("encode        reference %10.0f packets/s", rate(now() - t));
+  t = now();
+  for (r = 0; r < RUNS; r++)
+    for (n = 0; n < PACKETS; n++) encode_data(packets[n], size, packets[n]);
+  printf("   optimized %10.0f packets/s\n", rate(now() - t));
+
+  t = now();
+  for (r = 0; r < RUNS; r++)
+    for (n = 0; n < PACKETS; n++) ref_decode(packets[n], size + RS_ECC_NPARITY);
+  printf("decode clean  reference %10.0f packets/s", rate(now() - t));
+  t = now();
+  for (r = 0; r < RUNS; r++)
+    for (n = 0; n < PACKETS; n++) decode_data(packets[n], size + RS_ECC_NPARITY);
+  printf("   optimized %10.0f packets/s\n", rate(now() - t));
+
+  for (n = 0; n < PACKETS; n++) packets[n][0] ^= 0x5A;
+  t = now();
+  for (r = 0; r < RUNS; r++)
+    for (n = 0; n < PACKETS; n++) ref_decode(packets[n], size + RS_ECC_NPARITY);
+  printf("decode damaged reference %9.0f packets/s", rate(now() - t));
+  t = now();
+  for (r = 0; r < RUNS; r++)
+    for (n = 0; n < PACKETS; n++) decode_data(packets[n], size + RS_ECC_NPARITY);
+  printf("   optimized %10.0f packets/s\n", rate(now() - t));
+
+  return bad != 0;
+}
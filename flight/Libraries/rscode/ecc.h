@@ -45,7 +45,9 @@
 /****************************************************************/
 
 
+#if !defined(RS_ECC_NPARITY)
 #include <openpilot.h>
+#endif
 
 #define TRUE 1
 #define FALSE 0
@@ -78,8 +80,8 @@ void encode_data (unsigned char msg[], int nbytes, unsigned char dst[]);
 BIT16 crc_ccitt(unsigned char *msg, int len);
 
 /* galois arithmetic tables */
-extern const int gexp[];
-extern const int glog[];
+extern const unsigned char gexp[];
+extern const unsigned char glog[];
 
 void init_galois_tables (void);
 int ginv(int elt); 
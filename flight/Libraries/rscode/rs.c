@@ -27,6 +27,7 @@
 
 #include <stdio.h>
 #include <ctype.h>
+#include <stdint.h>
 #include "ecc.h"
 
 /* Encoder parity bytes */
@@ -38,10 +39,24 @@ int synBytes[MAXDEG];
 /* generator polynomial */
 int genPoly[MAXDEG*2];
 
+#if RS_ECC_NPARITY <= 4
+/* The encoder shift register fits in a word. For every feedback byte the
+ * products with all generator coefficients are tabulated, so each input
+ * byte costs one lookup instead of RS_ECC_NPARITY gmult() calls. */
+#define RS_WORD_LFSR
+static uint32_t lfsrTable[256];
+#else
+/* Logarithms of the generator coefficients, multiplying by them is a
+ * single gexp[] lookup */
+static int genLog[RS_ECC_NPARITY];
+#endif
+
 int DEBUG = FALSE;
 
 static void
 compute_genpoly (int nbytes, int genpoly[]);
+static void
+compute_remainder (unsigned char msg[], int nbytes, unsigned char rem[]);
 
 /* Initialize lookup tables, polynomials, etc. */
 void
@@ -52,6 +67,26 @@ initialize_ecc ()
 
     /* Compute the encoder generator polynomial */
     compute_genpoly(RS_ECC_NPARITY, genPoly);
+
+#ifdef RS_WORD_LFSR
+  {
+    int d, j;
+    for (d = 0; d < 256; d++) {
+      uint32_t word = 0;
+      for (j = 0; j < RS_ECC_NPARITY; j++) {
+	word |= (uint32_t)gmult(genPoly[j], d) << (8*j);
+      }
+      lfsrTable[d] = word;
+    }
+  }
+#else
+  {
+    int j;
+    for (j = 0; j < RS_ECC_NPARITY; j++) {
+      genLog[j] = (genPoly[j] == 0) ? -1 : glog[genPoly[j]];
+    }
+  }
+#endif
 }
 
 void
@@ -105,16 +140,38 @@ build_codeword (unsigned char msg[], int nbytes, unsigned char dst[])
  *
  * Computes the syndrome of a codeword. Puts the results
  * into the synBytes[] array.
+ *
+ * The encoder's shift register leaves the remainder of codeword * x^NPAR
+ * divided by the generator polynomial. Both only differ by a multiple of
+ * the generator at its roots, so the syndromes come from evaluating the
+ * few remainder bytes there and dividing by a^((j+1)*NPAR). Valid
+ * codewords leave no remainder.
  */
  
 void
 decode_data(unsigned char data[], int nbytes)
 {
   int i, j, sum;
+  unsigned char rem[RS_ECC_NPARITY];
+
+  compute_remainder(data, nbytes, rem);
+  for (j = 0; j < RS_ECC_NPARITY; j++) {
+    if (rem[j] != 0) break;
+  }
+  if (j == RS_ECC_NPARITY) {
+    for (j = 0; j < RS_ECC_NPARITY; j++) synBytes[j] = 0;
+    return;
+  }
+
+  /* rem[i] is the coefficient of x^i */
   for (j = 0; j < RS_ECC_NPARITY;  j++) {
     sum	= 0;
-    for (i = 0; i < nbytes; i++) {
-      sum = data[i] ^ gmult(gexp[j+1], sum);
+    for (i = RS_ECC_NPARITY-1; i >= 0; i--) {
+      /* sum * a^(j+1) in the log domain */
+      sum = rem[i] ^ ((sum == 0) ? 0 : gexp[glog[sum] + j + 1]);
+    }
+    if (sum != 0) {
+      sum = gexp[glog[sum] + 255 - ((j + 1) * RS_ECC_NPARITY) % 255];
     }
     synBytes[j]  = sum;
   }
@@ -187,21 +244,60 @@ compute_genpoly (int nbytes, int genpoly[])
 void
 encode_data (unsigned char msg[], int nbytes, unsigned char dst[])
 {
-  int i, LFSR[RS_ECC_NPARITY+1],dbyte, j;
+  int i;
+  unsigned char rem[RS_ECC_NPARITY];
+
+  compute_remainder(msg, nbytes, rem);
+
+  for (i = 0; i < RS_ECC_NPARITY; i++) 
+    pBytes[i] = rem[i];
 	
-  for(i=0; i < RS_ECC_NPARITY+1; i++) LFSR[i]=0;
+  build_codeword(msg, nbytes, dst);
+}
+
+/* Run the LFSR over nbytes of msg, rem[] receives the register
+ * contents, which are the parity bytes of a message or all zero
+ * for a valid codeword.
+ */
+static void
+compute_remainder (unsigned char msg[], int nbytes, unsigned char rem[])
+{
+  int i, j;
+#ifdef RS_WORD_LFSR
+  uint32_t LFSR = 0;
+
+  for (i = 0; i < nbytes; i++) {
+    int dbyte = msg[i] ^ (LFSR >> (8*(RS_ECC_NPARITY-1)));
+#if RS_ECC_NPARITY < 4
+    LFSR = ((LFSR << 8) & ((1UL << (8*RS_ECC_NPARITY)) - 1)) ^ lfsrTable[dbyte];
+#else
+    LFSR = (LFSR << 8) ^ lfsrTable[dbyte];
+#endif
+  }
+
+  for (j = 0; j < RS_ECC_NPARITY; j++)
+    rem[j] = (LFSR >> (8*j)) & 0xFF;
+#else
+  int LFSR[RS_ECC_NPARITY], dbyte;
+
+  for (j = 0; j < RS_ECC_NPARITY; j++) LFSR[j] = 0;
 
   for (i = 0; i < nbytes; i++) {
     dbyte = msg[i] ^ LFSR[RS_ECC_NPARITY-1];
-    for (j = RS_ECC_NPARITY-1; j > 0; j--) {
-      LFSR[j] = LFSR[j-1] ^ gmult(genPoly[j], dbyte);
+    if (dbyte == 0) {
+      for (j = RS_ECC_NPARITY-1; j > 0; j--) LFSR[j] = LFSR[j-1];
+      LFSR[0] = 0;
+    } else {
+      int lg = glog[dbyte];
+      for (j = RS_ECC_NPARITY-1; j > 0; j--) {
+	LFSR[j] = LFSR[j-1] ^ ((genLog[j] < 0) ? 0 : gexp[lg + genLog[j]]);
+      }
+      LFSR[0] = (genLog[0] < 0) ? 0 : gexp[lg + genLog[0]];
     }
-    LFSR[0] = gmult(genPoly[0], dbyte);
   }
 
-  for (i = 0; i < RS_ECC_NPARITY; i++) 
-    pBytes[i] = LFSR[i];
-	
-  build_codeword(msg, nbytes, dst);
+  for (j = 0; j < RS_ECC_NPARITY; j++)
+    rem[j] = LFSR[j];
+#endif
 }
 
@@ -27,8 +27,16 @@
  */
 #include "openpilot.h"
 //#include "taskmonitor.h"
+#if defined(DIAG_PROFILE)
+#include "cpuprofile.h"
+#endif
 
 // Private constants
+#if defined(DIAG_PROFILE)
+// Task tags, zero for the tasks that were never registered
+#define PROFILE_TAG_IDLE (CPUPROFILE_TASKLOAD_IDLE + 1)
+#define CYCLES_PER_US (configCPU_CLOCK_HZ / 1000000)
+#endif
 
 // Private types
 
@@ -36,8 +44,30 @@
 static xSemaphoreHandle lock;
 static xTaskHandle handles[TASKINFO_RUNNING_NUMELEM];
 static uint32_t lastMonitorTime;
+#if defined(DIAG_PROFILE)
+// Updated by the scheduler on every context switch
+static uint32_t taskCycles[CPUPROFILE_TASKLOAD_NUMELEM];
+static uint32_t taskSwitches[CPUPROFILE_TASKLOAD_NUMELEM];
+static uint32_t taskMaxSlice[CPUPROFILE_TASKLOAD_NUMELEM];
+static uint32_t contextSwitches;
+static uint8_t currentTask;
+static uint32_t currentSlice;
+static uint32_t lastSwitchTime;
+static uint32_t lastSwitchIrq;
+
+// Counters at the previous update, the object holds the difference
+static uint32_t lastTaskCycles[CPUPROFILE_TASKLOAD_NUMELEM];
+static uint32_t lastTaskSwitches[CPUPROFILE_TASKLOAD_NUMELEM];
+static uint32_t lastContextSwitches;
+static uint32_t lastIrqCycles[CPUPROFILE_IRQLOAD_NUMELEM];
+static uint32_t lastIrqCount[CPUPROFILE_IRQLOAD_NUMELEM];
+static uint32_t lastProfileTime;
+#endif
 
 // Private functions
+#if defined(DIAG_PROFILE)
+static void updateProfile(void);
+#endif
 
 /**
  * Initialize library
@@ -49,6 +79,12 @@ int32_t TaskMonitorInitialize(void)
 	lastMonitorTime = 0;
 #if defined(DIAG_TASKS)
 	lastMonitorTime = portGET_RUN_TIME_COUNTER_VALUE();
+#endif
+#if defined(DIAG_PROFILE)
+	currentTask = CPUPROFILE_TASKLOAD_OTHER;
+	lastSwitchTime = PIOS_DELAY_GetRaw();
+	lastSwitchIrq = PIOS_IRQ_ProfileTotal();
+	lastProfileTime = lastSwitchTime;
 #endif
 	return 0;
 }
@@ -62,6 +98,11 @@ int32_t TaskMonitorAdd(TaskInfoRunningElem task, xTaskHandle handle)
 	{
 	    xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 		handles[task] = handle;
+#if defined(DIAG_PROFILE)
+		// A NULL handle would tag the calling task
+		if (handle != 0)
+			vTaskSetApplicationTaskTag(handle, (pdTASK_HOOK_CODE)(task + 1));
+#endif
 		xSemaphoreGiveRecursive(lock);
 		return 0;
 	}
@@ -143,7 +184,115 @@ void TaskMonitorUpdateAll(void)
 	// Update object
 	TaskInfoSet(&data);
 
+#if defined(DIAG_PROFILE)
+	updateProfile();
+#endif
+
 	// Done
 	xSemaphoreGiveRecursive(lock);
 #endif
 }
+
+#if defined(DIAG_PROFILE)
+/**
+ * Account the idle task separately, called from the idle hook
+ */
+void TaskMonitorIdleHook(void)
+{
+	static bool tagged = false;
+
+	if (!tagged) {
+		vTaskSetApplicationTaskTag(NULL, (pdTASK_HOOK_CODE)PROFILE_TAG_IDLE);
+		tagged = true;
+	}
+}
+
+/**
+ * Account the cycles since the previous context switch to the task that was
+ * running. Called by the scheduler with the tag of the task switched in.
+ */
+void TaskMonitorSwitchedIn(unsigned long tag)
+{
+	uint32_t irq = PIOS_IRQ_ProfileTotal();
+	uint32_t now = PIOS_DELAY_GetRaw();
+
+	// The interrupt handlers are accounted separately
+	uint32_t elapsed = now - lastSwitchTime;
+	uint32_t irq_cycles = irq - lastSwitchIrq;
+	uint32_t cycles = (elapsed > irq_cycles) ? elapsed - irq_cycles : 0;
+	lastSwitchTime = now;
+	lastSwitchIrq = irq;
+
+	taskCycles[currentTask] += cycles;
+	currentSlice += cycles;
+
+	// The same task is switched in again when nothing else is ready
+	uint8_t task = (tag > 0 && tag <= CPUPROFILE_TASKLOAD_NUMELEM) ? tag - 1 : CPUPROFILE_TASKLOAD_OTHER;
+	if (task != currentTask) {
+		if (currentSlice > taskMaxSlice[currentTask])
+			taskMaxSlice[currentTask] = currentSlice;
+		currentSlice = 0;
+		currentTask = task;
+		taskSwitches[task]++;
+		contextSwitches++;
+	}
+}
+
+/**
+ * Update the CPUProfile object with the counts since the last update
+ */
+static void updateProfile(void)
+{
+	CPUProfileData data;
+	uint32_t maxSlice[CPUPROFILE_TASKLOAD_NUMELEM];
+	uint32_t now;
+	float scale;
+	int n;
+
+	// Take the maximums without a context switch in between
+	portENTER_CRITICAL();
+	memcpy(maxSlice, taskMaxSlice, sizeof(maxSlice));
+	memset(taskMaxSlice, 0, sizeof(taskMaxSlice));
+	portEXIT_CRITICAL();
+
+	now = PIOS_DELAY_GetRaw();
+	scale = 100.0f / ((now - lastProfileTime) ? : 1);
+	lastProfileTime = now;
+
+	for (n = 0; n < CPUPROFILE_TASKLOAD_NUMELEM; ++n)
+	{
+		uint32_t cycles = taskCycles[n];
+		uint32_t switches = taskSwitches[n];
+		uint32_t slice = maxSlice[n] / CYCLES_PER_US;
+
+		data.TaskLoad[n] = (cycles - lastTaskCycles[n]) * scale;
+		data.TaskSwitches[n] = (switches - lastTaskSwitches[n] < UINT16_MAX) ? switches - lastTaskSwitches[n] : UINT16_MAX;
+		data.TaskMaxSlice[n] = (slice < UINT16_MAX) ? slice : UINT16_MAX;
+
+		lastTaskCycles[n] = cycles;
+		lastTaskSwitches[n] = switches;
+	}
+
+	uint32_t switches = contextSwitches;
+	data.ContextSwitches = switches - lastContextSwitches;
+	lastContextSwitches = switches;
+
+	// The IRQ fields are in the order of enum pios_irq_class
+	for (n = 0; n < CPUPROFILE_IRQLOAD_NUMELEM; ++n)
+	{
+		struct pios_irq_profile irq;
+		PIOS_IRQ_ProfileGet((enum pios_irq_class)n, &irq);
+
+		uint32_t max_time = irq.max_cycles / CYCLES_PER_US;
+
+		data.IRQLoad[n] = (irq.cycles - lastIrqCycles[n]) * scale;
+		data.IRQCount[n] = (irq.count - lastIrqCount[n] < UINT16_MAX) ? irq.count - lastIrqCount[n] : UINT16_MAX;
+		data.IRQMaxTime[n] = (max_time < UINT16_MAX) ? max_time : UINT16_MAX;
+
+		lastIrqCycles[n] = irq.cycles;
+		lastIrqCount[n] = irq.count;
+	}
+
+	CPUProfileSet(&data);
+}
+#endif
@@ -107,6 +107,7 @@ static void ahrscommsTask(void *parameters)
 	AlarmsSet(SYSTEMALARMS_ALARM_AHRSCOMMS, SYSTEMALARMS_ALARM_CRITICAL);
 
 	// Main task loop
+	lastSysTime = xTaskGetTickCount();
 	while (1) {
 		PIOS_WDG_UpdateFlag(PIOS_WDG_AHRS);
 		AhrsCommStatus stat;
@@ -121,16 +122,26 @@ static void ahrscommsTask(void *parameters)
 		InsStatusData sData;
 		InsStatusGet(&sData);
 
-		sData.LinkRunning = stat.linkOk;
-		sData.AhrsKickstarts = stat.remote.kickStarts;
-		sData.AhrsCrcErrors = stat.remote.crcErrors;
-		sData.AhrsRetries = stat.remote.retries;
-		sData.AhrsInvalidPackets = stat.remote.invalidPacket;
-		sData.OpCrcErrors = stat.local.crcErrors;
-		sData.OpRetries = stat.local.retries;
-		sData.OpInvalidPackets = stat.local.invalidPacket;
-
-		InsStatusSet(&sData);
+		// Only publish when the link statistics changed, this runs every 2ms
+		if (sData.LinkRunning != stat.linkOk ||
+		    sData.AhrsKickstarts != stat.remote.kickStarts ||
+		    sData.AhrsCrcErrors != stat.remote.crcErrors ||
+		    sData.AhrsRetries != stat.remote.retries ||
+		    sData.AhrsInvalidPackets != stat.remote.invalidPacket ||
+		    sData.OpCrcErrors != stat.local.crcErrors ||
+		    sData.OpRetries != stat.local.retries ||
+		    sData.OpInvalidPackets != stat.local.invalidPacket) {
+			sData.LinkRunning = stat.linkOk;
+			sData.AhrsKickstarts = stat.remote.kickStarts;
+			sData.AhrsCrcErrors = stat.remote.crcErrors;
+			sData.AhrsRetries = stat.remote.retries;
+			sData.AhrsInvalidPackets = stat.remote.invalidPacket;
+			sData.OpCrcErrors = stat.local.crcErrors;
+			sData.OpRetries = stat.local.retries;
+			sData.OpInvalidPackets = stat.local.invalidPacket;
+
+			InsStatusSet(&sData);
+		}
 		/* Wait for the next update interval */
 		vTaskDelayUntil(&lastSysTime, 2 / portTICK_RATE_MS);
 
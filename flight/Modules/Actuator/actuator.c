@@ -43,6 +43,11 @@
 #include "mixerstatus.h"
 #include "cameradesired.h"
 #include "manualcontrolcommand.h"
+#include "eventtrace.h"
+
+#if defined(PIOS_FASTLOOP)
+#include "fastloop.h"
+#endif
 
 // Private constants
 #define MAX_QUEUE_SIZE 2
@@ -62,7 +67,12 @@
 
 // Private variables
 static xQueueHandle queue;
+#if !defined(PIOS_FASTLOOP)
 static xTaskHandle taskHandle;
+#endif
+
+static ActuatorSettingsData actuatorSettings;
+static MixerSettingsData mixerSettings;
 
 static float lastResult[MAX_MIX_ACTUATORS]={0,0,0,0,0,0,0,0};
 static float filterAccumulator[MAX_MIX_ACTUATORS]={0,0,0,0,0,0,0,0};
@@ -72,7 +82,14 @@ static volatile bool actuator_settings_updated;
 static volatile bool mixer_settings_updated;
 
 // Private functions
+#if defined(PIOS_FASTLOOP)
+static void actuatorFastLoop(float dT);
+#else
 static void actuatorTask(void* parameters);
+#endif
+static void actuatorLoadSettings(void);
+static void actuatorCheckSettings(void);
+static void actuatorUpdate(float dT);
 static int16_t scaleChannel(float value, int16_t max, int16_t min, int16_t neutral);
 static void setFailsafe(const ActuatorSettingsData * actuatorSettings, const MixerSettingsData * mixerSettings);
 static float MixerCurve(const float throttle, const float* curve, uint8_t elements);
@@ -96,9 +113,15 @@ typedef struct {
  */
 int32_t ActuatorStart()
 {
+#if defined(PIOS_FASTLOOP)
+	// Run from the sensor task for every gyro sample, no task of our own
+	actuatorLoadSettings();
+	FastLoopRegister(FASTLOOP_STAGE_ACTUATOR, actuatorFastLoop);
+#else
 	// Start main task
 	xTaskCreate(actuatorTask, (signed char*)"Actuator", STACK_SIZE_BYTES/4, NULL, TASK_PRIORITY, &taskHandle);
 	TaskMonitorAdd(TASKINFO_RUNNING_ACTUATOR, taskHandle);
+#endif
 	PIOS_WDG_RegisterFlag(PIOS_WDG_ACTUATOR);
 
 	return 0;
@@ -135,6 +158,36 @@ int32_t ActuatorInitialize()
 }
 MODULE_INITCALL(ActuatorInitialize, ActuatorStart)
 
+#if defined(PIOS_FASTLOOP)
+/**
+ * Fast loop stage, runs after stabilization for the same gyro sample.
+ * ActuatorDesired still goes through the queue so that a stalled
+ * Stabilization or ManualControl puts the outputs into failsafe.
+ */
+static void actuatorFastLoop(float dT)
+{
+	static bool have_desired = false;
+	static portTickType lastDesiredTime;
+	UAVObjEvent ev;
+
+	PIOS_WDG_UpdateFlag(PIOS_WDG_ACTUATOR);
+
+	while (xQueueReceive(queue, &ev, 0) == pdTRUE) {
+		have_desired = true;
+		lastDesiredTime = xTaskGetTickCount();
+	}
+
+	actuatorCheckSettings();
+
+	if (!have_desired || (xTaskGetTickCount() - lastDesiredTime) > FAILSAFE_TIMEOUT_MS / portTICK_RATE_MS) {
+		/* Update of ActuatorDesired timed out.  Go to failsafe */
+		setFailsafe(&actuatorSettings, &mixerSettings);
+		return;
+	}
+
+	actuatorUpdate(dT);
+}
+#else
 /**
  * @brief Main Actuator module task
  *
@@ -155,26 +208,7 @@ static void actuatorTask(void* parameters)
 	portTickType thisSysTime;
 	float dT = 0.0f;
 
-	ActuatorCommandData command;
-	ActuatorDesiredData desired;
-	MixerStatusData mixerStatus;
-	FlightStatusData flightStatus;
-
-	/* Read initial values of ActuatorSettings */
-	ActuatorSettingsData actuatorSettings;
-	actuator_settings_updated = false;
-	ActuatorSettingsGet(&actuatorSettings);
-
-	/* Read initial values of MixerSettings */
-	MixerSettingsData mixerSettings;
-	mixer_settings_updated = false;
-	MixerSettingsGet(&mixerSettings);
-
-	/* Force an initial configuration of the actuator update rates */
-	actuator_update_rate_if_changed(&actuatorSettings, true);
-
-	// Go to the neutral (failsafe) values until an ActuatorDesired update is received
-	setFailsafe(&actuatorSettings, &mixerSettings);
+	actuatorLoadSettings();
 
 	// Main task loop
 	lastSysTime = xTaskGetTickCount();
@@ -186,15 +220,7 @@ static void actuatorTask(void* parameters)
 		uint8_t rc = xQueueReceive(queue, &ev, FAILSAFE_TIMEOUT_MS / portTICK_RATE_MS);
 
 		/* Process settings updated events even in timeout case so we always act on the latest settings */
-		if (actuator_settings_updated) {
-			actuator_settings_updated = false;
-			ActuatorSettingsGet (&actuatorSettings);
-			actuator_update_rate_if_changed (&actuatorSettings, false);
-		}
-		if (mixer_settings_updated) {
-			mixer_settings_updated = false;
-			MixerSettingsGet (&mixerSettings);
-		}
+		actuatorCheckSettings();
 
 		if (rc != pdTRUE) {
 			/* Update of ActuatorDesired timed out.  Go to failsafe */
@@ -208,180 +234,235 @@ static void actuatorTask(void* parameters)
 			dT = (thisSysTime - lastSysTime) / portTICK_RATE_MS / 1000.0f;
 		lastSysTime = thisSysTime;
 
-		FlightStatusGet(&flightStatus);
-		ActuatorDesiredGet(&desired);
-		ActuatorCommandGet(&command);
+		actuatorUpdate(dT);
+	}
+}
+#endif /* PIOS_FASTLOOP */
+
+/**
+ * Read the initial settings and go to the failsafe values until an
+ * ActuatorDesired update is received
+ */
+static void actuatorLoadSettings(void)
+{
+	/* Read initial values of ActuatorSettings */
+	actuator_settings_updated = false;
+	ActuatorSettingsGet(&actuatorSettings);
+
+	/* Read initial values of MixerSettings */
+	mixer_settings_updated = false;
+	MixerSettingsGet(&mixerSettings);
+
+	/* Force an initial configuration of the actuator update rates */
+	actuator_update_rate_if_changed(&actuatorSettings, true);
+
+	// Go to the neutral (failsafe) values until an ActuatorDesired update is received
+	setFailsafe(&actuatorSettings, &mixerSettings);
+}
+
+/**
+ * Reload the settings flagged by the callbacks
+ */
+static void actuatorCheckSettings(void)
+{
+	if (actuator_settings_updated) {
+		actuator_settings_updated = false;
+		ActuatorSettingsGet (&actuatorSettings);
+		actuator_update_rate_if_changed (&actuatorSettings, false);
+	}
+	if (mixer_settings_updated) {
+		mixer_settings_updated = false;
+		MixerSettingsGet (&mixerSettings);
+	}
+}
+
+/**
+ * Mix the latest ActuatorDesired and update the outputs
+ */
+static void actuatorUpdate(float dT)
+{
+	ActuatorCommandData command;
+	ActuatorDesiredData desired;
+	MixerStatusData mixerStatus;
+	FlightStatusData flightStatus;
+
+	EVENT_TRACE(EVENTTRACE_ACTUATOR_START, 0);
+
+	FlightStatusGet(&flightStatus);
+	ActuatorDesiredGet(&desired);
+	ActuatorCommandGet(&command);
 
 #if defined(MIXERSTATUS_DIAGNOSTICS)
-		MixerStatusGet(&mixerStatus);
+	MixerStatusGet(&mixerStatus);
 #endif
-		int nMixers = 0;
-		Mixer_t * mixers = (Mixer_t *)&mixerSettings.Mixer1Type;
-		for(int ct=0; ct < MAX_MIX_ACTUATORS; ct++)
-		{
-			if(mixers[ct].type != MIXERSETTINGS_MIXER1TYPE_DISABLED)
-			{
-				nMixers ++;
-			}
-		}
-		if((nMixers < 2) && !ActuatorCommandReadOnly()) //Nothing can fly with less than two mixers.
+	int nMixers = 0;
+	Mixer_t * mixers = (Mixer_t *)&mixerSettings.Mixer1Type;
+	for(int ct=0; ct < MAX_MIX_ACTUATORS; ct++)
+	{
+		if(mixers[ct].type != MIXERSETTINGS_MIXER1TYPE_DISABLED)
 		{
-			setFailsafe(&actuatorSettings, &mixerSettings); // So that channels like PWM buzzer keep working
-			continue;
+			nMixers ++;
 		}
+	}
+	if((nMixers < 2) && !ActuatorCommandReadOnly()) //Nothing can fly with less than two mixers.
+	{
+		setFailsafe(&actuatorSettings, &mixerSettings); // So that channels like PWM buzzer keep working
+		return;
+	}
 
-		AlarmsClear(SYSTEMALARMS_ALARM_ACTUATOR);
-
-		bool armed = flightStatus.Armed == FLIGHTSTATUS_ARMED_ARMED;
-		bool positiveThrottle = desired.Throttle >= 0.00f;
-		bool spinWhileArmed = actuatorSettings.MotorsSpinWhileArmed == ACTUATORSETTINGS_MOTORSSPINWHILEARMED_TRUE;
+	AlarmsClear(SYSTEMALARMS_ALARM_ACTUATOR);
 
-		float curve1 = MixerCurve(desired.Throttle,mixerSettings.ThrottleCurve1,MIXERSETTINGS_THROTTLECURVE1_NUMELEM);
-		
-		//The source for the secondary curve is selectable
-		float curve2 = 0;
-		AccessoryDesiredData accessory;
-		switch(mixerSettings.Curve2Source) {
-			case MIXERSETTINGS_CURVE2SOURCE_THROTTLE:
-				curve2 = MixerCurve(desired.Throttle,mixerSettings.ThrottleCurve2,MIXERSETTINGS_THROTTLECURVE2_NUMELEM);
-				break;
-			case MIXERSETTINGS_CURVE2SOURCE_ROLL:
-				curve2 = MixerCurve(desired.Roll,mixerSettings.ThrottleCurve2,MIXERSETTINGS_THROTTLECURVE2_NUMELEM);
-				break;
-			case MIXERSETTINGS_CURVE2SOURCE_PITCH:
-				curve2 = MixerCurve(desired.Pitch,mixerSettings.ThrottleCurve2,
-				MIXERSETTINGS_THROTTLECURVE2_NUMELEM);
-				break;
-			case MIXERSETTINGS_CURVE2SOURCE_YAW:
-				curve2 = MixerCurve(desired.Yaw,mixerSettings.ThrottleCurve2,MIXERSETTINGS_THROTTLECURVE2_NUMELEM);
-				break;
-			case MIXERSETTINGS_CURVE2SOURCE_COLLECTIVE:
-				ManualControlCommandCollectiveGet(&curve2);
-				curve2 = MixerCurve(curve2,mixerSettings.ThrottleCurve2,
-				MIXERSETTINGS_THROTTLECURVE2_NUMELEM);
-				break;
-			case MIXERSETTINGS_CURVE2SOURCE_ACCESSORY0:
-			case MIXERSETTINGS_CURVE2SOURCE_ACCESSORY1:
-			case MIXERSETTINGS_CURVE2SOURCE_ACCESSORY2:
-			case MIXERSETTINGS_CURVE2SOURCE_ACCESSORY3:
-			case MIXERSETTINGS_CURVE2SOURCE_ACCESSORY4:
-			case MIXERSETTINGS_CURVE2SOURCE_ACCESSORY5:
-				if(AccessoryDesiredInstGet(mixerSettings.Curve2Source - MIXERSETTINGS_CURVE2SOURCE_ACCESSORY0,&accessory) == 0)
-					curve2 = MixerCurve(accessory.AccessoryVal,mixerSettings.ThrottleCurve2,MIXERSETTINGS_THROTTLECURVE2_NUMELEM);
-				else
-					curve2 = 0;
-				break;
-		}
+	bool armed = flightStatus.Armed == FLIGHTSTATUS_ARMED_ARMED;
+	bool positiveThrottle = desired.Throttle >= 0.00f;
+	bool spinWhileArmed = actuatorSettings.MotorsSpinWhileArmed == ACTUATORSETTINGS_MOTORSSPINWHILEARMED_TRUE;
 
-		float * status = (float *)&mixerStatus; //access status objects as an array of floats
+	float curve1 = MixerCurve(desired.Throttle,mixerSettings.ThrottleCurve1,MIXERSETTINGS_THROTTLECURVE1_NUMELEM);
+	
+	//The source for the secondary curve is selectable
+	float curve2 = 0;
+	AccessoryDesiredData accessory;
+	switch(mixerSettings.Curve2Source) {
+		case MIXERSETTINGS_CURVE2SOURCE_THROTTLE:
+			curve2 = MixerCurve(desired.Throttle,mixerSettings.ThrottleCurve2,MIXERSETTINGS_THROTTLECURVE2_NUMELEM);
+			break;
+		case MIXERSETTINGS_CURVE2SOURCE_ROLL:
+			curve2 = MixerCurve(desired.Roll,mixerSettings.ThrottleCurve2,MIXERSETTINGS_THROTTLECURVE2_NUMELEM);
+			break;
+		case MIXERSETTINGS_CURVE2SOURCE_PITCH:
+			curve2 = MixerCurve(desired.Pitch,mixerSettings.ThrottleCurve2,
+			MIXERSETTINGS_THROTTLECURVE2_NUMELEM);
+			break;
+		case MIXERSETTINGS_CURVE2SOURCE_YAW:
+			curve2 = MixerCurve(desired.Yaw,mixerSettings.ThrottleCurve2,MIXERSETTINGS_THROTTLECURVE2_NUMELEM);
+			break;
+		case MIXERSETTINGS_CURVE2SOURCE_COLLECTIVE:
+			ManualControlCommandCollectiveGet(&curve2);
+			curve2 = MixerCurve(curve2,mixerSettings.ThrottleCurve2,
+			MIXERSETTINGS_THROTTLECURVE2_NUMELEM);
+			break;
+		case MIXERSETTINGS_CURVE2SOURCE_ACCESSORY0:
+		case MIXERSETTINGS_CURVE2SOURCE_ACCESSORY1:
+		case MIXERSETTINGS_CURVE2SOURCE_ACCESSORY2:
+		case MIXERSETTINGS_CURVE2SOURCE_ACCESSORY3:
+		case MIXERSETTINGS_CURVE2SOURCE_ACCESSORY4:
+		case MIXERSETTINGS_CURVE2SOURCE_ACCESSORY5:
+			if(AccessoryDesiredInstGet(mixerSettings.Curve2Source - MIXERSETTINGS_CURVE2SOURCE_ACCESSORY0,&accessory) == 0)
+				curve2 = MixerCurve(accessory.AccessoryVal,mixerSettings.ThrottleCurve2,MIXERSETTINGS_THROTTLECURVE2_NUMELEM);
+			else
+				curve2 = 0;
+			break;
+	}
 
-		for(int ct=0; ct < MAX_MIX_ACTUATORS; ct++)
-		{
-			if(mixers[ct].type == MIXERSETTINGS_MIXER1TYPE_DISABLED) {
-				// Set to minimum if disabled.  This is not the same as saying PWM pulse = 0 us
-				status[ct] = -1;
-				command.Channel[ct] = 0;
-				continue;
-			}
+	float * status = (float *)&mixerStatus; //access status objects as an array of floats
 
-			if((mixers[ct].type == MIXERSETTINGS_MIXER1TYPE_MOTOR) || (mixers[ct].type == MIXERSETTINGS_MIXER1TYPE_SERVO))
-				status[ct] = ProcessMixer(ct, curve1, curve2, &mixerSettings, &desired, dT);
-			else
-				status[ct] = -1;
+	for(int ct=0; ct < MAX_MIX_ACTUATORS; ct++)
+	{
+		if(mixers[ct].type == MIXERSETTINGS_MIXER1TYPE_DISABLED) {
+			// Set to minimum if disabled.  This is not the same as saying PWM pulse = 0 us
+			status[ct] = -1;
+			command.Channel[ct] = 0;
+			continue;
+		}
 
+		if((mixers[ct].type == MIXERSETTINGS_MIXER1TYPE_MOTOR) || (mixers[ct].type == MIXERSETTINGS_MIXER1TYPE_SERVO))
+			status[ct] = ProcessMixer(ct, curve1, curve2, &mixerSettings, &desired, dT);
+		else
+			status[ct] = -1;
 
 
-			// Motors have additional protection for when to be on
-			if(mixers[ct].type == MIXERSETTINGS_MIXER1TYPE_MOTOR) {
 
-				// If not armed or motors aren't meant to spin all the time
-				if( !armed ||
-				   (!spinWhileArmed && !positiveThrottle))
-				{
-					filterAccumulator[ct] = 0;
-					lastResult[ct] = 0;
-					status[ct] = -1;  //force min throttle
-				}
-				// If armed meant to keep spinning,
-				else if ((spinWhileArmed && !positiveThrottle) ||
-					 (status[ct] < 0) )
-					status[ct] = 0;
-			}
+		// Motors have additional protection for when to be on
+		if(mixers[ct].type == MIXERSETTINGS_MIXER1TYPE_MOTOR) {
 
-			// If an accessory channel is selected for direct bypass mode
-			// In this configuration the accessory channel is scaled and mapped
-			// directly to output.  Note: THERE IS NO SAFETY CHECK HERE FOR ARMING
-			// these also will not be updated in failsafe mode.  I'm not sure what
-			// the correct behavior is since it seems domain specific.  I don't love
-			// this code
-			if( (mixers[ct].type >= MIXERSETTINGS_MIXER1TYPE_ACCESSORY0) &&
-			   (mixers[ct].type <= MIXERSETTINGS_MIXER1TYPE_ACCESSORY5))
+			// If not armed or motors aren't meant to spin all the time
+			if( !armed ||
+			   (!spinWhileArmed && !positiveThrottle))
 			{
-				if(AccessoryDesiredInstGet(mixers[ct].type - MIXERSETTINGS_MIXER1TYPE_ACCESSORY0,&accessory) == 0)
-					status[ct] = accessory.AccessoryVal;
-				else
-					status[ct] = -1;
+				filterAccumulator[ct] = 0;
+				lastResult[ct] = 0;
+				status[ct] = -1;  //force min throttle
 			}
-			if( (mixers[ct].type >= MIXERSETTINGS_MIXER1TYPE_CAMERAROLL) &&
-			   (mixers[ct].type <= MIXERSETTINGS_MIXER1TYPE_CAMERAYAW))
-			{
-				CameraDesiredData cameraDesired;
-				if( CameraDesiredGet(&cameraDesired) == 0 ) {
-					switch(mixers[ct].type) {
-						case MIXERSETTINGS_MIXER1TYPE_CAMERAROLL:
-							status[ct] = cameraDesired.Roll;
-							break;
-						case MIXERSETTINGS_MIXER1TYPE_CAMERAPITCH:
-							status[ct] = cameraDesired.Pitch;
-							break;
-						case MIXERSETTINGS_MIXER1TYPE_CAMERAYAW:
-							status[ct] = cameraDesired.Yaw;
-							break;
-						default:
-							break;
-					}
+			// If armed meant to keep spinning,
+			else if ((spinWhileArmed && !positiveThrottle) ||
+				 (status[ct] < 0) )
+				status[ct] = 0;
+		}
+
+		// If an accessory channel is selected for direct bypass mode
+		// In this configuration the accessory channel is scaled and mapped
+		// directly to output.  Note: THERE IS NO SAFETY CHECK HERE FOR ARMING
+		// these also will not be updated in failsafe mode.  I'm not sure what
+		// the correct behavior is since it seems domain specific.  I don't love
+		// this code
+		if( (mixers[ct].type >= MIXERSETTINGS_MIXER1TYPE_ACCESSORY0) &&
+		   (mixers[ct].type <= MIXERSETTINGS_MIXER1TYPE_ACCESSORY5))
+		{
+			if(AccessoryDesiredInstGet(mixers[ct].type - MIXERSETTINGS_MIXER1TYPE_ACCESSORY0,&accessory) == 0)
+				status[ct] = accessory.AccessoryVal;
+			else
+				status[ct] = -1;
+		}
+		if( (mixers[ct].type >= MIXERSETTINGS_MIXER1TYPE_CAMERAROLL) &&
+		   (mixers[ct].type <= MIXERSETTINGS_MIXER1TYPE_CAMERAYAW))
+		{
+			CameraDesiredData cameraDesired;
+			if( CameraDesiredGet(&cameraDesired) == 0 ) {
+				switch(mixers[ct].type) {
+					case MIXERSETTINGS_MIXER1TYPE_CAMERAROLL:
+						status[ct] = cameraDesired.Roll;
+						break;
+					case MIXERSETTINGS_MIXER1TYPE_CAMERAPITCH:
+						status[ct] = cameraDesired.Pitch;
+						break;
+					case MIXERSETTINGS_MIXER1TYPE_CAMERAYAW:
+						status[ct] = cameraDesired.Yaw;
+						break;
+					default:
+						break;
 				}
-				else
-					status[ct] = -1;
 			}
+			else
+				status[ct] = -1;
 		}
+	}
+	
+	for(int i = 0; i < MAX_MIX_ACTUATORS; i++) 
+		command.Channel[i] = scaleChannel(status[i],
+						   actuatorSettings.ChannelMax[i],
+						   actuatorSettings.ChannelMin[i],
+						   actuatorSettings.ChannelNeutral[i]);
 		
-		for(int i = 0; i < MAX_MIX_ACTUATORS; i++) 
-			command.Channel[i] = scaleChannel(status[i],
-							   actuatorSettings.ChannelMax[i],
-							   actuatorSettings.ChannelMin[i],
-							   actuatorSettings.ChannelNeutral[i]);
-			
-		// Store update time
-		command.UpdateTime = 1000.0f*dT;
-		if(1000.0f*dT > command.MaxUpdateTime)
-			command.MaxUpdateTime = 1000.0f*dT;
-		
-		// Update output object
-		ActuatorCommandSet(&command);
-		// Update in case read only (eg. during servo configuration)
-		ActuatorCommandGet(&command);
+	// Store update time
+	command.UpdateTime = 1000.0f*dT;
+	if(1000.0f*dT > command.MaxUpdateTime)
+		command.MaxUpdateTime = 1000.0f*dT;
+	
+	// Update output object
+	ActuatorCommandSet(&command);
+	// Update in case read only (eg. during servo configuration)
+	ActuatorCommandGet(&command);
 
 #if defined(MIXERSTATUS_DIAGNOSTICS)
-		MixerStatusSet(&mixerStatus);
+	MixerStatusSet(&mixerStatus);
 #endif
-		
-
-		// Update servo outputs
-		bool success = true;
+	
 
-		for (int n = 0; n < ACTUATORCOMMAND_CHANNEL_NUMELEM; ++n)
-		{
-			success &= set_channel(n, command.Channel[n], &actuatorSettings);
-		}
+	// Update servo outputs
+	bool success = true;
 
-		if(!success) {
-			command.NumFailedUpdates++;
-			ActuatorCommandSet(&command);
-			AlarmsSet(SYSTEMALARMS_ALARM_ACTUATOR, SYSTEMALARMS_ALARM_CRITICAL);
-		}
+	for (int n = 0; n < ACTUATORCOMMAND_CHANNEL_NUMELEM; ++n)
+	{
+		success &= set_channel(n, command.Channel[n], &actuatorSettings);
+	}
+	PIOS_Servo_Update();
+	EVENT_TRACE(EVENTTRACE_ACTUATOR_OUTPUT, command.Channel[0]);
 
+	if(!success) {
+		command.NumFailedUpdates++;
+		ActuatorCommandSet(&command);
+		AlarmsSet(SYSTEMALARMS_ALARM_ACTUATOR, SYSTEMALARMS_ALARM_CRITICAL);
 	}
+
 }
 
 
@@ -551,6 +632,7 @@ static void setFailsafe(const ActuatorSettingsData * actuatorSettings, const Mix
 	{
 		set_channel(n, Channel[n], actuatorSettings);
 	}
+	PIOS_Servo_Update();
 
 	// Update output object's parts that we changed
 	ActuatorCommandChannelSet(Channel);
@@ -631,22 +713,45 @@ static bool set_channel(uint8_t mixer_channel, uint16_t value, const ActuatorSet
 #endif
 
 /**
- * @brief Update the servo update rate
+ * @brief Update the servo update rate and output mode
  */
 static void actuator_update_rate_if_changed(const ActuatorSettingsData * actuatorSettings, bool force_update)
 {
 	static uint16_t prevChannelUpdateFreq[ACTUATORSETTINGS_CHANNELUPDATEFREQ_NUMELEM];
+	static uint8_t prevChannelUpdateMode[ACTUATORSETTINGS_CHANNELUPDATEMODE_NUMELEM];
 
 	// check if the any rate setting is changed
 	if (force_update ||
 		memcmp (prevChannelUpdateFreq,
 			actuatorSettings->ChannelUpdateFreq,
-			sizeof(prevChannelUpdateFreq)) != 0) {
+			sizeof(prevChannelUpdateFreq)) != 0 ||
+		memcmp (prevChannelUpdateMode,
+			actuatorSettings->ChannelUpdateMode,
+			sizeof(prevChannelUpdateMode)) != 0) {
 		/* Something has changed, apply the settings to HW */
 		memcpy (prevChannelUpdateFreq,
 			actuatorSettings->ChannelUpdateFreq,
 			sizeof(prevChannelUpdateFreq));
+		memcpy (prevChannelUpdateMode,
+			actuatorSettings->ChannelUpdateMode,
+			sizeof(prevChannelUpdateMode));
 		PIOS_Servo_SetHz(actuatorSettings->ChannelUpdateFreq, ACTUATORSETTINGS_CHANNELUPDATEFREQ_NUMELEM);
+
+		enum pios_servo_mode modes[ACTUATORSETTINGS_CHANNELUPDATEMODE_NUMELEM];
+		for (int i = 0; i < ACTUATORSETTINGS_CHANNELUPDATEMODE_NUMELEM; i++) {
+			switch (actuatorSettings->ChannelUpdateMode[i]) {
+				case ACTUATORSETTINGS_CHANNELUPDATEMODE_SYNCHRONIZED:
+					modes[i] = PIOS_SERVO_MODE_SYNC;
+					break;
+				case ACTUATORSETTINGS_CHANNELUPDATEMODE_ONESHOT:
+					modes[i] = PIOS_SERVO_MODE_ONESHOT;
+					break;
+				default:
+					modes[i] = PIOS_SERVO_MODE_PWM;
+					break;
+			}
+		}
+		PIOS_Servo_SetMode(modes, ACTUATORSETTINGS_CHANNELUPDATEMODE_NUMELEM);
 	}
 }
 
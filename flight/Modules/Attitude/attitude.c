@@ -57,6 +57,8 @@
 #include "flightstatus.h"
 #include "manualcontrolcommand.h"
 #include "CoordinateConversions.h"
+#include "fast_math.h"
+#include "eventtrace.h"
 #include <pios_board_info.h>
  
 // Private constants
@@ -94,6 +96,7 @@ static float R[3][3];
 static int8_t rotate = 0;
 static bool zero_during_arming = false;
 static bool bias_correct_gyro = true;
+static uint32_t sensor_time;		// Timestamp of the newest sample in the last update
 
 // For running trim flights
 static volatile bool trim_requested = false;
@@ -218,7 +221,7 @@ int32_t AttitudeInitialize(void)
 	
 	trim_requested = false;
 	
-	AttitudeSettingsConnectCallback(&settingsUpdatedCb);
+	AttitudeSettingsConnectCallbackPriority(&settingsUpdatedCb, EVENT_PRIORITY_HIGH);
 	
 	return 0;
 }
@@ -288,8 +291,11 @@ static void AttitudeTask(void *parameters)
 			AlarmsSet(SYSTEMALARMS_ALARM_ATTITUDE, SYSTEMALARMS_ALARM_ERROR);
 		else {
 			// Do not update attitude data in simulation mode
-			if (!AttitudeActualReadOnly())
+			if (!AttitudeActualReadOnly()) {
+				EVENT_TRACE(EVENTTRACE_ATTITUDE_START, 0);
 				updateAttitude(&accels, &gyros);
+				EVENT_TRACE(EVENTTRACE_ATTITUDE_END, 0);
+			}
 
 			AlarmsClear(SYSTEMALARMS_ALARM_ATTITUDE);
 		}
@@ -314,13 +320,31 @@ static int32_t updateSensorsCC3D(AccelsData * accelsData, GyrosData * gyrosData)
 		return -1;	// Error, no data
 	}
 
-	gyros[0] =  mpu6050_data.gyro_x * PIOS_MPU6050_GetScale();
-	gyros[1] = -mpu6050_data.gyro_y * PIOS_MPU6050_GetScale();
-	gyros[2] = -mpu6050_data.gyro_z * PIOS_MPU6050_GetScale();
+	// The driver queues every sample of a FIFO burst, average whatever is waiting
+	int32_t gyro_accum[3] = {mpu6050_data.gyro_x, mpu6050_data.gyro_y, mpu6050_data.gyro_z};
+	int32_t accel_accum[3] = {mpu6050_data.accel_x, mpu6050_data.accel_y, mpu6050_data.accel_z};
+	int32_t samples = 1;
+	while(xQueueReceive(queue, (void *) &mpu6050_data, 0) != errQUEUE_EMPTY) {
+		gyro_accum[0] += mpu6050_data.gyro_x;
+		gyro_accum[1] += mpu6050_data.gyro_y;
+		gyro_accum[2] += mpu6050_data.gyro_z;
+		accel_accum[0] += mpu6050_data.accel_x;
+		accel_accum[1] += mpu6050_data.accel_y;
+		accel_accum[2] += mpu6050_data.accel_z;
+		samples++;
+	}
+	sensor_time = mpu6050_data.time;
+
+	float gyro_scale = PIOS_MPU6050_GetScale() / samples;
+	float accel_scale = PIOS_MPU6050_GetAccelScale() / samples;
+
+	gyros[0] =  gyro_accum[0] * gyro_scale;
+	gyros[1] = -gyro_accum[1] * gyro_scale;
+	gyros[2] = -gyro_accum[2] * gyro_scale;
 
-	accels[0] =  mpu6050_data.accel_x * PIOS_MPU6050_GetAccelScale();
-	accels[1] = -mpu6050_data.accel_y * PIOS_MPU6050_GetAccelScale();
-	accels[2] = -mpu6050_data.accel_z * PIOS_MPU6050_GetAccelScale();
+	accels[0] =  accel_accum[0] * accel_scale;
+	accels[1] = -accel_accum[1] * accel_scale;
+	accels[2] = -accel_accum[2] * accel_scale;
 
 	gyrosData->temperature  = 35.0f + ((float) mpu6050_data.temperature + 512.0f) / 340.0f;
 	accelsData->temperature = 35.0f + ((float) mpu6050_data.temperature + 512.0f) / 340.0f;
@@ -396,11 +420,22 @@ static inline void apply_accel_filter(const float *raw, float *filtered)
 static void updateAttitude(AccelsData * accelsData, GyrosData * gyrosData)
 {
 	float dT;
+#if defined(PIOS_INCLUDE_MPU6050)
+	// Time between the sample timestamps so task jitter does not enter the filter
+	static uint32_t last_sensor_time;
+	static bool have_sensor_time = false;
+
+	uint32_t diff_us = PIOS_DELAY_DiffuS2(last_sensor_time, sensor_time);
+	dT = (!have_sensor_time || diff_us == 0) ? 0.001f : diff_us / 1.0e6f;
+	last_sensor_time = sensor_time;
+	have_sensor_time = true;
+#else
 	portTickType thisSysTime = xTaskGetTickCount();
 	static portTickType lastSysTime = 0;
 
 	dT = (thisSysTime == lastSysTime) ? 0.001 : (portMAX_DELAY & (thisSysTime - lastSysTime)) / portTICK_RATE_MS / 1000.0f;
 	lastSysTime = thisSysTime;
+#endif
 
 	// Bad practice to assume structure order, but saves memory
 	float * gyros = &gyrosData->x;
@@ -484,11 +519,7 @@ static void updateAttitude(AccelsData * accelsData, GyrosData * gyrosData)
 	}
 	
 	// Renomalize
-	float qmag = sqrtf(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
-	q[0] = q[0] / qmag;
-	q[1] = q[1] / qmag;
-	q[2] = q[2] / qmag;
-	q[3] = q[3] / qmag;
+	float qmag = fast_quat_normalize(q);
 	
 	// If quaternion has become inappropriately short or is nan reinit.
 	// THIS SHOULD NEVER ACTUALLY HAPPEN
@@ -505,7 +536,7 @@ static void updateAttitude(AccelsData * accelsData, GyrosData * gyrosData)
 	quat_copy(q, &attitudeActual.q1);
 	
 	// Convert into eueler degrees (makes assumptions about RPY order)
-	Quaternion2RPY(&attitudeActual.q1,&attitudeActual.Roll);
+	fast_Quaternion2RPY(&attitudeActual.q1,&attitudeActual.Roll);
 	
 	AttitudeActualSet(&attitudeActual);
 }
@@ -50,6 +50,7 @@
 
 #include "pios.h"
 #include "attitude.h"
+#include "sensors.h"
 #include "magnetometer.h"
 #include "accels.h"
 #include "gyros.h"
@@ -59,36 +60,74 @@
 #include "positionactual.h"
 #include "velocityactual.h"
 #include "gpsposition.h"
+#include "gpstime.h"
 #include "baroaltitude.h"
 #include "flightstatus.h"
 #include "homelocation.h"
+#include "revocalibration.h"
 #include "CoordinateConversions.h"
+#include "fast_math.h"
+#include "eventtrace.h"
+#include "WorldMagModel.h"
+
+#if defined(PIOS_FASTLOOP)
+#include "fastloop.h"
+#endif
 
 // Private constants
 #define STACK_SIZE_BYTES 5540
 #define TASK_PRIORITY (tskIDLE_PRIORITY+3)
 #define FAILSAFE_TIMEOUT_MS 10
+// The history keeps one entry every INS_HISTORY_PERIOD_MS whatever the sample
+// rate, enough to cover a GPS delay of up to INS_GPS_DELAY_MAX_MS
+#define INS_GPS_DELAY_MAX_MS 500
+#define INS_HISTORY_PERIOD_MS 10
+#define INS_HISTORY_LENGTH (INS_GPS_DELAY_MAX_MS / INS_HISTORY_PERIOD_MS + 2)
+#define IMU_BATCH_LENGTH 8
+
+// In the fast loop the sample has been pushed just before the update runs
+#if defined(PIOS_FASTLOOP)
+#define IMU_TIMEOUT_MS 0
+#else
+#define IMU_TIMEOUT_MS FAILSAFE_TIMEOUT_MS
+#endif
 
 #define F_PI 3.14159265358979323846f
 #define PI_MOD(x) (fmodf(x + F_PI, F_PI * 2) - F_PI)
+
+// Build with -DINS_CYCLE_COUNT to record the cycles spent in each INS
+// step of the last update, for reading out with the debugger
+#if defined(INS_CYCLE_COUNT)
+#define INS_TIMED(cycles, call) do { uint32_t t0 = PIOS_DELAY_GetRaw(); call; cycles = PIOS_DELAY_GetRaw() - t0; } while (0)
+#else
+#define INS_TIMED(cycles, call) call
+#endif
 // Private types
 
 // Private variables
+#if !defined(PIOS_FASTLOOP)
 static xTaskHandle attitudeTaskHandle;
+#endif
 
-static xQueueHandle gyroQueue;
-static xQueueHandle accelQueue;
 static xQueueHandle magQueue;
 static xQueueHandle baroQueue;
 static xQueueHandle gpsQueue;
 const uint32_t SENSOR_QUEUE_SIZE = 10;
 
 // Private functions
+#if defined(PIOS_FASTLOOP)
+static void AttitudeFastLoop(float dT);
+#else
 static void AttitudeTask(void *parameters);
+#endif
 
 static int32_t updateAttitudeComplimentary(bool first_run);
 static int32_t updateAttitudeINSGPS(bool first_run);
 static void settingsUpdatedCb(UAVObjEvent * objEv);
+static bool getIMUSamples(GyrosData * gyros, AccelsData * accels, float * dT, uint32_t timeout_ms);
+static void insHistoryStore(uint32_t time);
+static bool insHistoryShift(uint32_t time, float Pos[3], float Vel[3]);
+static void insUpdateMagNorth(GPSPositionData * gpsPosition, HomeLocationData * home);
 
 static float accelKi = 0;
 static float accelKp = 0;
@@ -99,6 +138,26 @@ static float R[3][3];
 static int8_t rotate = 0;
 static bool zero_during_arming = false;
 
+// The INS covariance prediction and corrections run every
+// ins_update_decimation gyro samples, the state every sample
+static uint8_t ins_update_decimation = 1;
+static uint16_t ins_gps_delay_ms = 0;
+
+// Recent INS position and velocity, for fusing delayed measurements
+static struct {
+	uint32_t time;
+	float Pos[3];
+	float Vel[3];
+} ins_history[INS_HISTORY_LENGTH];
+static uint8_t ins_history_head;
+static uint8_t ins_history_count;
+
+#if defined(INS_CYCLE_COUNT)
+static volatile uint32_t ins_prediction_cycles;
+static volatile uint32_t ins_covariance_cycles;
+static volatile uint32_t ins_correction_cycles;
+#endif
+
 
 /**
  * API for sensor fusion algorithms:
@@ -117,11 +176,13 @@ int32_t AttitudeInitialize(void)
 {
 	AttitudeActualInitialize();
 	AttitudeSettingsInitialize();
+	RevoCalibrationInitialize();
 	PositionActualInitialize();
 	VelocityActualInitialize();
 	
 	// Initialize this here while we aren't setting the homelocation in GPS
 	HomeLocationInitialize();
+	GPSTimeInitialize();
 
 	// Initialize quaternion
 	AttitudeActualData attitude;
@@ -144,7 +205,8 @@ int32_t AttitudeInitialize(void)
 		for(uint8_t j = 0; j < 3; j++)
 			R[i][j] = 0;
 	
-	AttitudeSettingsConnectCallback(&settingsUpdatedCb);
+	AttitudeSettingsConnectCallbackPriority(&settingsUpdatedCb, EVENT_PRIORITY_HIGH);
+	RevoCalibrationConnectCallbackPriority(&settingsUpdatedCb, EVENT_PRIORITY_HIGH);
 	
 	return 0;
 }
@@ -156,19 +218,22 @@ int32_t AttitudeInitialize(void)
 int32_t AttitudeStart(void)
 {
 	// Create the queues for the sensors
-	gyroQueue = xQueueCreate(1, sizeof(UAVObjEvent));
-	accelQueue = xQueueCreate(1, sizeof(UAVObjEvent));
 	magQueue = xQueueCreate(1, sizeof(UAVObjEvent));
 	baroQueue = xQueueCreate(1, sizeof(UAVObjEvent));
 	gpsQueue = xQueueCreate(1, sizeof(UAVObjEvent));
 			
+#if defined(PIOS_FASTLOOP)
+	// Run from the sensor task for every gyro sample, no task of our own
+	AlarmsClear(SYSTEMALARMS_ALARM_ATTITUDE);
+	settingsUpdatedCb(AttitudeSettingsHandle());
+	FastLoopRegister(FASTLOOP_STAGE_ATTITUDE, AttitudeFastLoop);
+#else
 	// Start main task
 	xTaskCreate(AttitudeTask, (signed char *)"Attitude", STACK_SIZE_BYTES/4, NULL, TASK_PRIORITY, &attitudeTaskHandle);
 	TaskMonitorAdd(TASKINFO_RUNNING_ATTITUDE, attitudeTaskHandle);
+#endif
 	PIOS_WDG_RegisterFlag(PIOS_WDG_ATTITUDE);
 	
-	GyrosConnectQueue(gyroQueue);
-	AccelsConnectQueue(accelQueue);
 	MagnetometerConnectQueue(magQueue);
 	BaroAltitudeConnectQueue(baroQueue);
 	GPSPositionConnectQueue(gpsQueue);
@@ -178,6 +243,24 @@ int32_t AttitudeStart(void)
 
 MODULE_INITCALL(AttitudeInitialize, AttitudeStart)
 
+#if defined(PIOS_FASTLOOP)
+/**
+ * Fast loop stage, runs for every gyro sample before stabilization
+ */
+static void AttitudeFastLoop(float dT)
+{
+	static bool first_run = true;
+
+	if(1)
+		updateAttitudeComplimentary(first_run);
+	else
+		updateAttitudeINSGPS(first_run);
+
+	first_run = false;
+
+	PIOS_WDG_UpdateFlag(PIOS_WDG_ATTITUDE);
+}
+#else
 /**
  * Module thread, should not return.
  */
@@ -208,6 +291,7 @@ static void AttitudeTask(void *parameters)
 		PIOS_WDG_UpdateFlag(PIOS_WDG_ATTITUDE);
 	}
 }
+#endif /* PIOS_FASTLOOP */
 
 float accel_mag;
 float qmag;
@@ -221,22 +305,17 @@ static int32_t updateAttitudeComplimentary(bool first_run)
 	UAVObjEvent ev;
 	GyrosData gyrosData;
 	AccelsData accelsData;
-	static int32_t timeval;
 	float dT;
 	static uint8_t init = 0;
 
-	// Wait until the AttitudeRaw object is updated, if a timeout then go to failsafe
-	if ( xQueueReceive(gyroQueue, &ev, FAILSAFE_TIMEOUT_MS / portTICK_RATE_MS) != pdTRUE )
-	{
-		AlarmsSet(SYSTEMALARMS_ALARM_ATTITUDE,SYSTEMALARMS_ALARM_WARNING);
-		return -1;
-	}
-	if ( xQueueReceive(accelQueue, &ev, 0) != pdTRUE )
+	// Wait until the IMU samples arrive, if a timeout then go to failsafe
+	if (!getIMUSamples(&gyrosData, &accelsData, &dT, IMU_TIMEOUT_MS))
 	{
-		// When one of these is updated so should the other
 		AlarmsSet(SYSTEMALARMS_ALARM_ATTITUDE,SYSTEMALARMS_ALARM_WARNING);
 		return -1;
 	}
+
+	EVENT_TRACE(EVENTTRACE_ATTITUDE_START, 0);
 	
 	// During initialization and 
 	FlightStatusData flightStatus;
@@ -262,13 +341,6 @@ static int32_t updateAttitudeComplimentary(bool first_run)
 		init = 1;
 	}	
 	
-	GyrosGet(&gyrosData);
-	AccelsGet(&accelsData);
-
-	// Compute the dT using the cpu clock
-	dT = PIOS_DELAY_DiffuS(timeval) / 1000000.0f;
-	timeval = PIOS_DELAY_GetRaw();
-	
 	float q[4];
 	
 	AttitudeActualData attitudeActual;
@@ -360,11 +432,7 @@ static int32_t updateAttitudeComplimentary(bool first_run)
 	}
 	
 	// Renomalize
-	qmag = sqrtf(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
-	q[0] = q[0] / qmag;
-	q[1] = q[1] / qmag;
-	q[2] = q[2] / qmag;
-	q[3] = q[3] / qmag;
+	qmag = fast_quat_normalize(q);
 
 	// If quaternion has become inappropriately short or is nan reinit.
 	// THIS SHOULD NEVER ACTUALLY HAPPEN
@@ -378,9 +446,10 @@ static int32_t updateAttitudeComplimentary(bool first_run)
 	quat_copy(q, &attitudeActual.q1);
 
 	// Convert into eueler degrees (makes assumptions about RPY order)
-	Quaternion2RPY(&attitudeActual.q1,&attitudeActual.Roll);
+	fast_Quaternion2RPY(&attitudeActual.q1,&attitudeActual.Roll);
 
 	AttitudeActualSet(&attitudeActual);
+	EVENT_TRACE(EVENTTRACE_ATTITUDE_END, 0);
 	
 	// Flush these queues for avoid errors
 	if ( xQueueReceive(baroQueue, &ev, 0) != pdTRUE )
@@ -406,39 +475,44 @@ static int32_t updateAttitudeINSGPS(bool first_run)
 	MagnetometerData magData;
 	BaroAltitudeData baroData;
 	
-	static uint32_t ins_last_time = 0;
+	static float covariance_dT = 0;
+	static uint8_t covariance_count = 0;
+
+	// Sensor updates are held until the next correction
+	static bool mag_updated;
+	static bool baro_updated;
+	static bool gps_updated;
+	static uint32_t gps_time;
 
 	static bool inited;
-	if (first_run)
+	if (first_run) {
 		inited = false;
+		mag_updated = false;
+		baro_updated = false;
+		gps_updated = false;
+	}
 	
-	// Wait until the gyro and accel object is updated, if a timeout then go to failsafe
-	if ( (xQueueReceive(gyroQueue, &ev, 10 / portTICK_RATE_MS) != pdTRUE) ||
-		(xQueueReceive(accelQueue, &ev, 10 / portTICK_RATE_MS) != pdTRUE) )
+	float dT;
+
+	// Wait until the IMU samples arrive, if a timeout then go to failsafe
+	if (!getIMUSamples(&gyrosData, &accelsData, &dT, IMU_TIMEOUT_MS))
 	{
 		AlarmsSet(SYSTEMALARMS_ALARM_ATTITUDE,SYSTEMALARMS_ALARM_WARNING);
 		return -1;
 	}
 	
 	// Get most recent data
-	// TODO: Acquire all data in a queue
-	GyrosGet(&gyrosData);
-	AccelsGet(&accelsData);
 	MagnetometerGet(&magData);
 	BaroAltitudeGet(&baroData);
 	
-	bool mag_updated;
-	bool baro_updated;
-	bool gps_updated;
-	
-	if (inited) {
-		mag_updated = 0;
-		baro_updated = 0;
-	}
-	
+	uint32_t now = xTaskGetTickCount() * portTICK_RATE_MS;
+
 	mag_updated |= xQueueReceive(magQueue, &ev, 0 / portTICK_RATE_MS) == pdTRUE;
 	baro_updated |= xQueueReceive(baroQueue, &ev, 0 / portTICK_RATE_MS) == pdTRUE;
-	gps_updated |= xQueueReceive(gpsQueue, &ev, 0 / portTICK_RATE_MS) == pdTRUE;
+	if (xQueueReceive(gpsQueue, &ev, 0 / portTICK_RATE_MS) == pdTRUE) {
+		gps_updated = true;
+		gps_time = now;
+	}
 	
 	if (!inited && (!mag_updated || !baro_updated || !gps_updated)) {
 		// Don't initialize until all sensors are read
@@ -473,20 +547,20 @@ static int32_t updateAttitudeINSGPS(bool first_run)
 		RotFrom2Vectors(&accelsData.x, ge, &magData.x, home.Be, Rbe);
 		R2Quaternion(Rbe,q);
 		INSSetState(NED, vel, q, &gyrosData.x, zeros);
+		insUpdateMagNorth(&gpsPosition, &home);
 		INSSetGyroBias(&gyrosData.x);
 		INSResetP(Pdiag);
 		
-		ins_last_time = PIOS_DELAY_GetRaw();	
+		covariance_dT = 0;
+		covariance_count = 0;
+		ins_history_count = 0;
+		mag_updated = false;
+		baro_updated = false;
+		gps_updated = false;
 		return 0;
 	}
 	
 	// Perform the update	
-	uint16_t sensors = 0;
-	float dT;
-	
-	dT = PIOS_DELAY_DiffuS(ins_last_time) / 1.0e6f;
-	ins_last_time = PIOS_DELAY_GetRaw();
-	
 	// This should only happen at start up or at mode switches
 	if(dT > 0.01f)
 		dT = 0.01f;
@@ -502,7 +576,7 @@ static int32_t updateAttitudeINSGPS(bool first_run)
 		(gyrosData.z + gyrosBias.z) * F_PI / 180.0f};
 	
 	// Advance the state estimate
-	INSStatePrediction(gyros, &accelsData.x, dT);
+	INS_TIMED(ins_prediction_cycles, INSStatePrediction(gyros, &accelsData.x, dT));
 	
 	// Copy the attitude into the UAVO
 	AttitudeActualData attitude;
@@ -511,7 +585,7 @@ static int32_t updateAttitudeINSGPS(bool first_run)
 	attitude.q2 = Nav.q[1];
 	attitude.q3 = Nav.q[2];
 	attitude.q4 = Nav.q[3];
-	Quaternion2RPY(&attitude.q1,&attitude.Roll);
+	fast_Quaternion2RPY(&attitude.q1,&attitude.Roll);
 	AttitudeActualSet(&attitude);
 	
 	// Copy the gyro bias into the UAVO
@@ -520,43 +594,65 @@ static int32_t updateAttitudeINSGPS(bool first_run)
 	gyrosBias.z = Nav.gyro_bias[2];
 	GyrosBiasSet(&gyrosBias);
 	
-	// Advance the covariance estimate
-	INSCovariancePrediction(dT);
-	
-	if(mag_updated)
-		sensors |= MAG_SENSORS;
-	if(baro_updated)
-		sensors |= BARO_SENSOR;
+	insHistoryStore(now);
 
-	float NED[3] = {0,0,0};
-	float vel[3] = {0,0,0};
-	
-	if(gps_updated)
-	{
-		sensors = HORIZ_SENSORS | VERT_SENSORS;
-		GPSPositionData gpsPosition;
-		GPSPositionGet(&gpsPosition);
-		
-		vel[0] = gpsPosition.Groundspeed * cosf(gpsPosition.Heading * F_PI / 180.0f);
-		vel[1] = gpsPosition.Groundspeed * sinf(gpsPosition.Heading * F_PI / 180.0f);
-		vel[2] = 0;
+	// The covariance and the corrections only run every ins_update_decimation samples
+	covariance_dT += dT;
+	if (++covariance_count >= ins_update_decimation) {
+		// Advance the covariance estimate over the samples since the last one
+		INS_TIMED(ins_covariance_cycles, INSCovariancePrediction(covariance_dT));
+		covariance_dT = 0;
+		covariance_count = 0;
 
-		HomeLocationData home;
-		HomeLocationGet(&home);
+		uint16_t sensors = 0;
+		if(mag_updated)
+			sensors |= MAG_SENSORS;
+		if(baro_updated)
+			sensors |= BARO_SENSOR;
 
-		// convert from cm back to meters
-		float LLA[3] = {(float) gpsPosition.Latitude / 1e7f, (float) gpsPosition.Longitude / 1e7f, (float) (gpsPosition.GeoidSeparation + gpsPosition.Altitude)};
-		// put in local NED frame
-		float ECEF[3] = {(float) (home.ECEF[0] / 100.0f), (float) (home.ECEF[1] / 100.0f), (float) (home.ECEF[2] / 100.0f)};
-		LLA2Base(LLA, ECEF, (float (*)[3]) home.RNE, NED);
+		float NED[3] = {0,0,0};
+		float vel[3] = {0,0,0};
+		
+		if(gps_updated)
+		{
+			sensors = HORIZ_SENSORS | VERT_SENSORS;
+			GPSPositionData gpsPosition;
+			GPSPositionGet(&gpsPosition);
+			
+			vel[0] = gpsPosition.Groundspeed * cosf(gpsPosition.Heading * F_PI / 180.0f);
+			vel[1] = gpsPosition.Groundspeed * sinf(gpsPosition.Heading * F_PI / 180.0f);
+			vel[2] = 0;
+
+			HomeLocationData home;
+			HomeLocationGet(&home);
+
+			// convert from cm back to meters
+			float LLA[3] = {(float) gpsPosition.Latitude / 1e7f, (float) gpsPosition.Longitude / 1e7f, (float) (gpsPosition.GeoidSeparation + gpsPosition.Altitude)};
+			// put in local NED frame
+			float ECEF[3] = {(float) (home.ECEF[0] / 100.0f), (float) (home.ECEF[1] / 100.0f), (float) (home.ECEF[2] / 100.0f)};
+			LLA2Base(LLA, ECEF, (float (*)[3]) home.RNE, NED);
+			insUpdateMagNorth(&gpsPosition, &home);
+
+			// The fix describes the vehicle ins_gps_delay_ms before it arrived,
+			// move it forward by how far the INS has travelled since then. Warn
+			// when the history does not reach back that far.
+			if (insHistoryShift(gps_time - ins_gps_delay_ms, NED, vel))
+				AlarmsClear(SYSTEMALARMS_ALARM_ATTITUDE);
+			else
+				AlarmsSet(SYSTEMALARMS_ALARM_ATTITUDE, SYSTEMALARMS_ALARM_WARNING);
+		}
+		
+		/*
+		 * TODO: Need to add a general sanity check for all the inputs to make sure their kosher
+		 * although probably should occur within INS itself
+		 */
+		INS_TIMED(ins_correction_cycles, INSCorrection(&magData.x, NED, vel, baroData.Altitude, sensors));
+
+		mag_updated = false;
+		baro_updated = false;
+		gps_updated = false;
 	}
 	
-	/*
-	 * TODO: Need to add a general sanity check for all the inputs to make sure their kosher
-	 * although probably should occur within INS itself
-	 */
-	INSCorrection(&magData.x, NED, vel, baroData.Altitude, sensors);
-	
 	// Copy the position and velocity into the UAVO
 	PositionActualData positionActual;
 	PositionActualGet(&positionActual);
@@ -581,6 +677,128 @@ static int32_t updateAttitudeINSGPS(bool first_run)
 	return 0;
 }
 
+/**
+ * Wait for the IMU samples Sensors has queued since the last call and
+ * combine them into their mean
+ * \param[out] dT the time in seconds the samples advance the estimate by
+ * \returns false if no samples arrived within timeout_ms
+ */
+static bool getIMUSamples(GyrosData * gyros, AccelsData * accels, float * dT, uint32_t timeout_ms)
+{
+	static uint32_t last_time;
+	static bool have_last = false;
+	struct sensors_imu_sample samples[IMU_BATCH_LENGTH];
+
+	uint32_t count = SensorsReadIMUSamples(samples, IMU_BATCH_LENGTH, timeout_ms);
+	if (count == 0)
+		return false;
+
+	float gyro_sum[3] = {0, 0, 0};
+	float accel_sum[3] = {0, 0, 0};
+	for (uint32_t n = 0; n < count; n++) {
+		for (uint8_t i = 0; i < 3; i++) {
+			gyro_sum[i] += samples[n].gyros[i];
+			accel_sum[i] += samples[n].accels[i];
+		}
+	}
+	gyros->x = gyro_sum[0] / count;
+	gyros->y = gyro_sum[1] / count;
+	gyros->z = gyro_sum[2] / count;
+	accels->x = accel_sum[0] / count;
+	accels->y = accel_sum[1] / count;
+	accels->z = accel_sum[2] / count;
+
+	// Time between the sample timestamps, not when this task got to run.
+	// Before the first batch assume the nominal 500 Hz sensor rate.
+	uint32_t newest = samples[count - 1].time;
+	if (have_last)
+		*dT = PIOS_DELAY_DiffuS2(last_time, newest) / 1.0e6f;
+	else
+		*dT = 0.002f * count;
+	last_time = newest;
+	have_last = true;
+
+	return true;
+}
+
+/**
+ * Record the current INS position and velocity in the history, at most once
+ * every INS_HISTORY_PERIOD_MS
+ */
+static void insHistoryStore(uint32_t time)
+{
+	if (ins_history_count > 0 && time - ins_history[ins_history_head].time < INS_HISTORY_PERIOD_MS)
+		return;
+
+	ins_history_head = (ins_history_head + 1) % INS_HISTORY_LENGTH;
+	ins_history[ins_history_head].time = time;
+	for (uint8_t i = 0; i < 3; i++) {
+		ins_history[ins_history_head].Pos[i] = Nav.Pos[i];
+		ins_history[ins_history_head].Vel[i] = Nav.Vel[i];
+	}
+	if (ins_history_count < INS_HISTORY_LENGTH)
+		ins_history_count++;
+}
+
+/**
+ * Bring a measurement taken at time up to the current INS time, by adding
+ * the change in position and velocity since the history entry at or just
+ * before time. Measurements older than the history are clamped to the
+ * oldest entry.
+ * \returns false if the measurement was clamped
+ */
+static bool insHistoryShift(uint32_t time, float Pos[3], float Vel[3])
+{
+	if (ins_history_count == 0)
+		return false;
+
+	uint8_t n = ins_history_head;
+	for (uint8_t i = 1; i < ins_history_count && (int32_t)(ins_history[n].time - time) > 0; i++)
+		n = (n + INS_HISTORY_LENGTH - 1) % INS_HISTORY_LENGTH;
+
+	for (uint8_t i = 0; i < 3; i++) {
+		Pos[i] += Nav.Pos[i] - ins_history[n].Pos[i];
+		Vel[i] += Nav.Vel[i] - ins_history[n].Vel[i];
+	}
+
+	return (int32_t)(ins_history[n].time - time) <= 0;
+}
+
+/**
+ * Point the INS magnetometer reference at the field where the vehicle is
+ * now, so long range flights are not corrected against the field at home.
+ * WMM_GetMagVectorLocal() only evaluates the full model after moving some
+ * distance, other calls are a few multiply-adds. Falls back to the home
+ * field until the GPS reports a date. The model is only used once the home
+ * location is set, as the GPS task runs it while setting home.
+ */
+static void insUpdateMagNorth(GPSPositionData * gpsPosition, HomeLocationData * home)
+{
+	float Be[3] = {home->Be[0], home->Be[1], home->Be[2]};
+	GPSTimeData gpsTime;
+	GPSTimeGet(&gpsTime);
+
+	if (home->Set == HOMELOCATION_SET_TRUE && gpsTime.Year >= 2000) {
+		float local[3];
+		if (WMM_GetMagVectorLocal((float) gpsPosition->Latitude / 1e7f, (float) gpsPosition->Longitude / 1e7f,
+				gpsPosition->Altitude + gpsPosition->GeoidSeparation,
+				gpsTime.Month, gpsTime.Day, gpsTime.Year, local) >= 0) {
+			Be[0] = local[0];
+			Be[1] = local[1];
+			Be[2] = local[2];
+		}
+	}
+
+	// The INS compares against the normalised magnetometer reading
+	float len = sqrtf(Be[0] * Be[0] + Be[1] * Be[1] + Be[2] * Be[2]);
+	if (len <= 0)
+		return;
+	Be[0] /= len;
+	Be[1] /= len;
+	Be[2] /= len;
+	INSSetMagNorth(Be);
+}
+
 static void settingsUpdatedCb(UAVObjEvent * objEv) 
 {
 	AttitudeSettingsData attitudeSettings;
@@ -594,6 +812,12 @@ static void settingsUpdatedCb(UAVObjEvent * objEv)
 
 	zero_during_arming = attitudeSettings.ZeroDuringArming == ATTITUDESETTINGS_ZERODURINGARMING_TRUE;
 
+	RevoCalibrationData revoCalibration;
+	RevoCalibrationGet(&revoCalibration);
+
+	ins_update_decimation = revoCalibration.UpdateDecimation > 0 ? revoCalibration.UpdateDecimation : 1;
+	ins_gps_delay_ms = revoCalibration.GPSDelay;
+
 	accelbias[0] = attitudeSettings.AccelBias[ATTITUDESETTINGS_ACCELBIAS_X];
 	accelbias[1] = attitudeSettings.AccelBias[ATTITUDESETTINGS_ACCELBIAS_Y];
 	accelbias[2] = attitudeSettings.AccelBias[ATTITUDESETTINGS_ACCELBIAS_Z];
@@ -49,30 +49,56 @@
  */
 
 #include "pios.h"
+#include "actuatordesired.h"
 #include "flightstatus.h"
+#include "gyros.h"
 #include "hwsettings.h"
 #include "manualcontrolcommand.h"
 #include "manualcontrolsettings.h"
 #include "relaytuning.h"
+#include "relaytuningsegment.h"
 #include "relaytuningsettings.h"
 #include "stabilizationdesired.h"
 #include "stabilizationsettings.h"
 #include <pios_board_info.h>
  
 // Private constants
-#define STACK_SIZE_BYTES 1024
+#define STACK_SIZE_BYTES 1200
 #define TASK_PRIORITY (tskIDLE_PRIORITY+2)
+#define SAMPLE_PERIOD_MS 10
+
+// Recorded segment: the last SEGMENT_SAMPLES of relay output and gyro
+// response of each axis, uploaded in chunks once landed
+#define SEGMENT_AXES 2
+#define SEGMENT_SAMPLES 128
+#define SEGMENT_CHUNK RELAYTUNINGSEGMENT_INPUT_NUMELEM
+#define SEGMENT_CHUNKS (SEGMENT_SAMPLES / SEGMENT_CHUNK)
+#define UPLOAD_PERIOD_MS 50
+#define INPUT_SCALE 10000.0f
+#define OUTPUT_SCALE 10.0f
 
 // Private types
-enum AUTOTUNE_STATE {AT_INIT, AT_START, AT_ROLL, AT_PITCH, AT_FINISHED, AT_SET};
+enum AUTOTUNE_STATE {AT_INIT, AT_START, AT_ROLL, AT_PITCH, AT_ANALYSE, AT_FINISHED, AT_SET, AT_UPLOAD};
+
+struct segment {
+	int16_t input[SEGMENT_SAMPLES];
+	int16_t output[SEGMENT_SAMPLES];
+	uint16_t next;
+	uint16_t count;
+};
 
 // Private variables
 static xTaskHandle taskHandle;
 static bool autotuneEnabled;
+static struct segment *segments;
 
 // Private functions
 static void AutotuneTask(void *parameters);
 static void update_stabilization_settings();
+static void record_sample(uint8_t axis);
+static void analyse_segment(uint8_t axis);
+static uint8_t upload_chunk(uint8_t chunk);
+static float bound(float val, float range);
 
 /**
  * Initialise the module, called on startup
@@ -106,6 +132,12 @@ int32_t AutotuneStart(void)
 {
 	// Start main task if it is enabled
 	if(autotuneEnabled) {
+		RelayTuningSegmentInitialize();
+		segments = (struct segment *) pvPortMalloc(sizeof(struct segment) * SEGMENT_AXES);
+		if (segments == NULL)
+			return -1;
+		memset(segments, 0, sizeof(struct segment) * SEGMENT_AXES);
+
 		xTaskCreate(AutotuneTask, (signed char *)"Autotune", STACK_SIZE_BYTES/4, NULL, TASK_PRIORITY, &taskHandle);
 
 		TaskMonitorAdd(TASKINFO_RUNNING_AUTOTUNE, taskHandle);
@@ -126,6 +158,8 @@ static void AutotuneTask(void *parameters)
 	enum AUTOTUNE_STATE state = AT_INIT;
 
 	portTickType lastUpdateTime = xTaskGetTickCount();
+	portTickType lastSampleTime = lastUpdateTime;
+	uint8_t uploadChunk = 0;
 
 	while(1) {
 
@@ -146,6 +180,7 @@ static void AutotuneTask(void *parameters)
 		if (flightStatus.FlightMode != FLIGHTSTATUS_FLIGHTMODE_AUTOTUNE) {
 			state = AT_INIT;
 			vTaskDelay(50);
+			lastSampleTime = xTaskGetTickCount();
 			continue;
 		}
 
@@ -202,6 +237,7 @@ static void AutotuneTask(void *parameters)
 				if (diffTime > PREPARE_TIME) {
 					state = AT_ROLL;
 					lastUpdateTime = xTaskGetTickCount();
+					memset(segments, 0, sizeof(struct segment) * SEGMENT_AXES);
 				}
 				break;
 
@@ -212,6 +248,7 @@ static void AutotuneTask(void *parameters)
 				// Run relay mode on the roll axis for the measurement time
 				stabDesired.StabilizationMode[STABILIZATIONDESIRED_STABILIZATIONMODE_ROLL] = rate ? STABILIZATIONDESIRED_STABILIZATIONMODE_RELAYRATE :
 					STABILIZATIONDESIRED_STABILIZATIONMODE_RELAYATTITUDE;
+				record_sample(0);
 				if (diffTime > MEAURE_TIME) { // Move on to next state
 					state = AT_PITCH;
 					lastUpdateTime = xTaskGetTickCount();
@@ -222,13 +259,26 @@ static void AutotuneTask(void *parameters)
 
 				diffTime = xTaskGetTickCount() - lastUpdateTime;
 
-				// Run relay mode on the pitch axis for the measurement time
-				stabDesired.StabilizationMode[STABILIZATIONDESIRED_STABILIZATIONMODE_PITCH] = rate ? STABILIZATIONDESIRED_STABILIZATIONMODE_RELAYRATE :
-					STABILIZATIONDESIRED_STABILIZATIONMODE_RELAYATTITUDE;
 				if (diffTime > MEAURE_TIME) { // Move on to next state
-					state = AT_FINISHED;
+					// Leave relay mode now, the results are analysed next period
+					state = AT_ANALYSE;
 					lastUpdateTime = xTaskGetTickCount();
+					break;
 				}
+
+				// Run relay mode on the pitch axis for the measurement time
+				stabDesired.StabilizationMode[STABILIZATIONDESIRED_STABILIZATIONMODE_PITCH] = rate ? STABILIZATIONDESIRED_STABILIZATIONMODE_RELAYRATE :
+					STABILIZATIONDESIRED_STABILIZATIONMODE_RELAYATTITUDE;
+				record_sample(1);
+				break;
+
+			case AT_ANALYSE:
+
+				// Stabilization has run with the relay off since the last period,
+				// so it no longer writes RelayTuning
+				analyse_segment(0);
+				analyse_segment(1);
+				state = AT_FINISHED;
 				break;
 
 			case AT_FINISHED:
@@ -241,7 +291,21 @@ static void AutotuneTask(void *parameters)
 
 			case AT_SET:
 				update_stabilization_settings();
-				state = AT_INIT;
+				state = AT_UPLOAD;
+				uploadChunk = 0;
+				lastUpdateTime = xTaskGetTickCount();
+				break;
+
+			case AT_UPLOAD:
+
+				// Paced so the segment does not crowd out the other telemetry
+				diffTime = xTaskGetTickCount() - lastUpdateTime;
+				if (diffTime >= UPLOAD_PERIOD_MS / portTICK_RATE_MS) {
+					lastUpdateTime = xTaskGetTickCount();
+					uploadChunk = upload_chunk(uploadChunk);
+					if (uploadChunk >= SEGMENT_AXES * SEGMENT_CHUNKS)
+						state = AT_INIT;
+				}
 				break;
 
 			default:
@@ -251,8 +315,137 @@ static void AutotuneTask(void *parameters)
 
 		StabilizationDesiredSet(&stabDesired);
 
-		vTaskDelay(10);
+		// Fixed rate so the recorded segment has a known sample period
+		vTaskDelayUntil(&lastSampleTime, SAMPLE_PERIOD_MS / portTICK_RATE_MS);
+	}
+}
+
+/**
+ * Appends the relay output and the gyro response of an axis to its segment,
+ * overwriting the oldest sample once full
+ */
+static void record_sample(uint8_t axis)
+{
+	ActuatorDesiredData actuatorDesired;
+	ActuatorDesiredGet(&actuatorDesired);
+
+	GyrosData gyros;
+	GyrosGet(&gyros);
+
+	float input = (axis == 0) ? actuatorDesired.Roll : actuatorDesired.Pitch;
+	float output = (axis == 0) ? gyros.x : gyros.y;
+
+	input = bound(input * INPUT_SCALE, 32767);
+	output = bound(output * OUTPUT_SCALE, 32767);
+
+	struct segment *segment = &segments[axis];
+	segment->input[segment->next] = (int16_t) input;
+	segment->output[segment->next] = (int16_t) output;
+	segment->next = (segment->next + 1) % SEGMENT_SAMPLES;
+	if (segment->count < SEGMENT_SAMPLES)
+		segment->count++;
+}
+
+/**
+ * Bound input value between limits
+ */
+static float bound(float val, float range)
+{
+	if(val < -range) {
+		val = -range;
+	} else if(val > range) {
+		val = range;
+	}
+	return val;
+}
+
+/**
+ * Index of the i-th oldest sample of a segment
+ */
+static uint16_t segment_index(const struct segment *segment, uint16_t i)
+{
+	if (segment->count < SEGMENT_SAMPLES)
+		return i;
+	return (segment->next + i) % SEGMENT_SAMPLES;
+}
+
+/**
+ * Estimates the plant frequency response at the relay oscillation frequency
+ * from the recorded segment, one DFT bin of input and output over whole
+ * periods, and stores it in @ref RelayTuning
+ */
+static void analyse_segment(uint8_t axis)
+{
+	RelayTuningData relayTuning;
+	RelayTuningGet(&relayTuning);
+
+	const struct segment *segment = &segments[axis];
+	float period = relayTuning.Period[axis] / SAMPLE_PERIOD_MS; // samples
+	if (period < 2 || segment->count < period)
+		return;
+
+	// Whole periods only, the relay harmonics leak into the bin otherwise
+	uint16_t used = (uint16_t) (floorf(segment->count / period) * period + 0.5f);
+	if (used > segment->count)
+		used = segment->count;
+
+	float w = 2 * M_PI / period;
+	float in_re = 0, in_im = 0, out_re = 0, out_im = 0;
+	for (uint16_t i = 0; i < used; i++) {
+		uint16_t index = segment_index(segment, i);
+		float c = cosf(w * i);
+		float s = sinf(w * i);
+		in_re += segment->input[index] * c;
+		in_im -= segment->input[index] * s;
+		out_re += segment->output[index] * c;
+		out_im -= segment->output[index] * s;
+	}
+
+	float in_power = in_re * in_re + in_im * in_im;
+	if (in_power <= 0)
+		return;
+
+	// G = Y / U = Y * conj(U) / |U|^2
+	float re = (out_re * in_re + out_im * in_im) / in_power;
+	float im = (out_im * in_re - out_re * in_im) / in_power;
+
+	relayTuning.ResponseGain[axis] = sqrtf(re * re + im * im) * INPUT_SCALE / OUTPUT_SCALE;
+	relayTuning.ResponsePhase[axis] = atan2f(im, re) * 180.0f / M_PI;
+	RelayTuningSet(&relayTuning);
+}
+
+/**
+ * Sends the first recorded chunk of the segments in @ref RelayTuningSegment
+ * from the given one on
+ * \returns the chunk to send next, SEGMENT_AXES * SEGMENT_CHUNKS once all
+ * the chunks have been sent
+ */
+static uint8_t upload_chunk(uint8_t chunk)
+{
+	for (; chunk < SEGMENT_AXES * SEGMENT_CHUNKS; chunk++) {
+		uint8_t axis = chunk / SEGMENT_CHUNKS;
+		uint16_t first = (chunk % SEGMENT_CHUNKS) * SEGMENT_CHUNK;
+		const struct segment *segment = &segments[axis];
+
+		// Skip the part of a segment that was never recorded
+		if (first >= segment->count)
+			continue;
+
+		RelayTuningSegmentData data;
+		memset(&data, 0, sizeof(data));
+		data.Axis = (axis == 0) ? RELAYTUNINGSEGMENT_AXIS_ROLL : RELAYTUNINGSEGMENT_AXIS_PITCH;
+		data.Chunk = chunk % SEGMENT_CHUNKS;
+		data.Chunks = (segment->count + SEGMENT_CHUNK - 1) / SEGMENT_CHUNK;
+		data.SamplePeriod = SAMPLE_PERIOD_MS;
+		for (uint16_t i = 0; i < SEGMENT_CHUNK && first + i < segment->count; i++) {
+			uint16_t index = segment_index(segment, first + i);
+			data.Input[i] = segment->input[index];
+			data.Output[i] = segment->output[index];
+		}
+		RelayTuningSegmentSet(&data);
+		return chunk + 1;
 	}
+	return chunk;
 }
 
 /**
@@ -79,8 +79,8 @@ MODULE_INITCALL(BatteryInitialize, 0)
 
 int32_t BatteryInitialize(void)
 {
-	BatteryStateInitialze();
-	BatterySettingsInitialize();
+	FlightBatteryStateInitialize();
+	FlightBatterySettingsInitialize();
 	
 	static UAVObjEvent ev;
 
@@ -113,8 +113,7 @@ static void onTimer(UAVObjEvent* ev)
 
 	portTickType thisSysTime;
 	FlightBatterySettingsData batterySettings;
-	static float dT = SAMPLE_PERIOD_MS / 1000;
-	float Bob;
+	static float dT = SAMPLE_PERIOD_MS / 1000.0f;
 	float energyRemaining;
 
 
@@ -126,11 +125,11 @@ static void onTimer(UAVObjEvent* ev)
 
 	FlightBatterySettingsGet(&batterySettings);
 
-	//calculate the battery parameters
-	flightBatteryData.Voltage = ((float)PIOS_ADC_PinGet(2)) * batterySettings.SensorCalibrations[FLIGHTBATTERYSETTINGS_SENSORCALIBRATIONS_VOLTAGEFACTOR]; //in Volts
-	flightBatteryData.Current = ((float)PIOS_ADC_PinGet(1)) * batterySettings.SensorCalibrations[FLIGHTBATTERYSETTINGS_SENSORCALIBRATIONS_CURRENTFACTOR]; //in Amps
-Bob =dT; // FIXME: something funky happens if I don't do this... Andrew
-	flightBatteryData.ConsumedEnergy += (flightBatteryData.Current * 1000.0 * dT / 3600.0) ;//in mAh
+	//calculate the battery parameters, the ADC averages every sample since the last
+	//run so the current times dT integrates the whole interval and not one sample
+	flightBatteryData.Voltage = PIOS_ADC_PinGetAverage(2) * batterySettings.SensorCalibrations[FLIGHTBATTERYSETTINGS_SENSORCALIBRATIONS_VOLTAGEFACTOR]; //in Volts
+	flightBatteryData.Current = PIOS_ADC_PinGetAverage(1) * batterySettings.SensorCalibrations[FLIGHTBATTERYSETTINGS_SENSORCALIBRATIONS_CURRENTFACTOR]; //in Amps
+	flightBatteryData.ConsumedEnergy += (flightBatteryData.Current * 1000.0f * dT / 3600.0f) ;//in mAh
 
 	if (flightBatteryData.Current > flightBatteryData.PeakCurrent)flightBatteryData.PeakCurrent = flightBatteryData.Current; //in Amps
 	flightBatteryData.AvgCurrent=(flightBatteryData.AvgCurrent*0.8)+(flightBatteryData.Current*0.2); //in Amps
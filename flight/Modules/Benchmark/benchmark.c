@@ -0,0 +1,280 @@
+/**
+ ******************************************************************************
+ * @addtogroup OpenPilotModules OpenPilot Modules
+ * @{
+ * @addtogroup BenchmarkModule Benchmark Module
+ * @brief Times a fixed set of kernels with the cycle counter
+ * @{
+ *
+ * @file       benchmark.c
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Benchmark module, only built with BENCHMARK=YES
+ *
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ ******************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/**
+ * Output object: BenchmarkResults
+ *
+ * Every round runs each kernel ITERATIONS times, timing every call with
+ * PIOS_DELAY_GetRaw(), which is the DWT cycle counter on the F1 and F4.
+ * The min, mean and max cycles of each kernel are published once per round.
+ *
+ * The task runs at low priority and does not lock the scheduler, the kernels
+ * take mutexes. The min is the cost of the kernel itself, the mean and max
+ * also show what preempted it.
+ *
+ * On boards with the INS the INS kernels work on the same filter state as the
+ * Attitude module, a benchmark build is for the bench only.
+ */
+
+#include "openpilot.h"
+#include "benchmark.h"
+#include "benchmarkresults.h"
+#include "uavtalk.h"
+#if defined(BENCHMARK_INS)
+#include "insgps.h"
+#endif
+
+// Private constants
+#define STACK_SIZE_BYTES 1024
+#define TASK_PRIORITY (tskIDLE_PRIORITY+1)
+#define ROUND_PERIOD_MS 2000
+#define ITERATIONS 64
+#define CRC_BLOCK_LENGTH 256
+#define INS_DT 0.002f
+
+#define KERNELS BENCHMARKRESULTS_MINCYCLES_NUMELEM
+
+// Private types
+typedef void (*kernel_t)(void);
+
+// Private variables
+static xTaskHandle taskHandle;
+static xQueueHandle eventQueue;
+static UAVTalkConnection talkConnection;
+static BenchmarkResultsData scratch;
+static uint8_t crcBlock[CRC_BLOCK_LENGTH];
+static volatile uint32_t crcResult;
+#if defined(BENCHMARK_INS)
+static float gyro[3] = {0.01f, -0.02f, 0.005f};
+static float accel[3] = {0.1f, -0.05f, -9.81f};
+#endif
+
+// Private functions
+static void benchmarkTask(void *parameters);
+static void runKernel(kernel_t kernel, uint32_t overhead, uint32_t *min, uint32_t *mean, uint32_t *max);
+static int32_t nullOutput(uint8_t *data, int32_t length);
+static void kernelEmpty(void);
+#if defined(BENCHMARK_INS)
+static void kernelINSStatePrediction(void);
+static void kernelINSCovariancePrediction(void);
+#endif
+static void kernelSetData(void);
+static void kernelSetDataEvent(void);
+static void kernelSendObject(void);
+static void kernelCRC8(void);
+static void kernelCRC16(void);
+static void kernelCRC32(void);
+
+// Indexed by the BenchmarkResults element, missing kernels stay at zero
+static const kernel_t kernels[KERNELS] = {
+	[BENCHMARKRESULTS_MINCYCLES_OVERHEAD] = kernelEmpty,
+#if defined(BENCHMARK_INS)
+	[BENCHMARKRESULTS_MINCYCLES_INSSTATEPREDICTION] = kernelINSStatePrediction,
+	[BENCHMARKRESULTS_MINCYCLES_INSCOVARIANCEPREDICTION] = kernelINSCovariancePrediction,
+#endif
+	[BENCHMARKRESULTS_MINCYCLES_UAVOBJSETDATA] = kernelSetData,
+	[BENCHMARKRESULTS_MINCYCLES_UAVOBJSETDATAEVENT] = kernelSetDataEvent,
+	[BENCHMARKRESULTS_MINCYCLES_UAVTALKSENDOBJECT] = kernelSendObject,
+	[BENCHMARKRESULTS_MINCYCLES_CRC8] = kernelCRC8,
+	[BENCHMARKRESULTS_MINCYCLES_CRC16] = kernelCRC16,
+	[BENCHMARKRESULTS_MINCYCLES_CRC32] = kernelCRC32,
+};
+
+/**
+ * Initialise the module, called on startup
+ * \returns 0 on success or -1 if initialisation failed
+ */
+int32_t BenchmarkInitialize(void)
+{
+	BenchmarkResultsInitialize();
+
+	eventQueue = xQueueCreate(1, sizeof(UAVObjEvent));
+	talkConnection = UAVTalkInitialize(nullOutput);
+	if (eventQueue == NULL || talkConnection == 0)
+		return -1;
+
+	for (uint32_t i = 0; i < CRC_BLOCK_LENGTH; i++)
+		crcBlock[i] = (uint8_t)(i * 7 + 3);
+
+#if defined(BENCHMARK_INS)
+	INSGPSInit();
+#endif
+
+	return 0;
+}
+
+/**
+ * Start the module, called on startup
+ * \returns 0 on success or -1 if initialisation failed
+ */
+int32_t BenchmarkStart(void)
+{
+	xTaskCreate(benchmarkTask, (signed char *)"Benchmark", STACK_SIZE_BYTES/4, NULL, TASK_PRIORITY, &taskHandle);
+	return 0;
+}
+
+MODULE_INITCALL(BenchmarkInitialize, BenchmarkStart)
+
+/**
+ * Module thread, should not return.
+ */
+static void benchmarkTask(void *parameters)
+{
+	BenchmarkResultsData results;
+	RCC_ClocksTypeDef clocks;
+	portTickType lastSysTime;
+
+	BenchmarkResultsGet(&results);
+	RCC_GetClocksFreq(&clocks);
+	results.CPUClock = clocks.SYSCLK_Frequency / 1000000;
+	results.Iterations = ITERATIONS;
+
+	lastSysTime = xTaskGetTickCount();
+	while (1) {
+		vTaskDelayUntil(&lastSysTime, ROUND_PERIOD_MS / portTICK_RATE_MS);
+
+		// The data set by the UAVObjSetData kernels is the last published round
+		scratch = results;
+
+		// The timing itself, taken off all the other kernels
+		runKernel(kernelEmpty, 0, &results.MinCycles[BENCHMARKRESULTS_MINCYCLES_OVERHEAD],
+			&results.MeanCycles[BENCHMARKRESULTS_MINCYCLES_OVERHEAD],
+			&results.MaxCycles[BENCHMARKRESULTS_MINCYCLES_OVERHEAD]);
+		uint32_t overhead = results.MinCycles[BENCHMARKRESULTS_MINCYCLES_OVERHEAD];
+
+		for (uint32_t n = 0; n < KERNELS; n++) {
+			if (n == BENCHMARKRESULTS_MINCYCLES_OVERHEAD || kernels[n] == NULL)
+				continue;
+			if (n == BENCHMARKRESULTS_MINCYCLES_UAVOBJSETDATAEVENT)
+				UAVObjConnectQueue(BenchmarkResultsHandle(), eventQueue, EV_UPDATED);
+			runKernel(kernels[n], overhead, &results.MinCycles[n], &results.MeanCycles[n], &results.MaxCycles[n]);
+			if (n == BENCHMARKRESULTS_MINCYCLES_UAVOBJSETDATAEVENT)
+				UAVObjDisconnectQueue(BenchmarkResultsHandle(), eventQueue);
+		}
+
+		results.Rounds++;
+		BenchmarkResultsSet(&results);
+		BenchmarkResultsUpdated();
+	}
+}
+
+/**
+ * Time ITERATIONS calls of a kernel, less the timing overhead
+ */
+static void runKernel(kernel_t kernel, uint32_t overhead, uint32_t *min, uint32_t *mean, uint32_t *max)
+{
+	uint64_t sum = 0;
+	*min = UINT32_MAX;
+	*max = 0;
+
+	for (uint32_t i = 0; i < ITERATIONS; i++) {
+		uint32_t start = PIOS_DELAY_GetRaw();
+		kernel();
+		uint32_t cycles = PIOS_DELAY_GetRaw() - start;
+		cycles = cycles > overhead ? cycles - overhead : 0;
+
+		sum += cycles;
+		if (cycles < *min)
+			*min = cycles;
+		if (cycles > *max)
+			*max = cycles;
+	}
+	*mean = sum / ITERATIONS;
+}
+
+/**
+ * UAVTalk output of the benchmark connection, the frames go nowhere
+ */
+static int32_t nullOutput(uint8_t *data, int32_t length)
+{
+	return length;
+}
+
+static void kernelEmpty(void)
+{
+}
+
+#if defined(BENCHMARK_INS)
+static void kernelINSStatePrediction(void)
+{
+	INSStatePrediction(gyro, accel, INS_DT);
+}
+
+static void kernelINSCovariancePrediction(void)
+{
+	INSCovariancePrediction(INS_DT);
+}
+#endif
+
+/**
+ * Nobody listens to EV_UPDATED of BenchmarkResults, the telemetry only
+ * sends it on BenchmarkResultsUpdated()
+ */
+static void kernelSetData(void)
+{
+	BenchmarkResultsSet(&scratch);
+}
+
+/**
+ * As kernelSetData with a queue listening, includes taking the event back
+ */
+static void kernelSetDataEvent(void)
+{
+	UAVObjEvent ev;
+
+	BenchmarkResultsSet(&scratch);
+	xQueueReceive(eventQueue, &ev, 0);
+}
+
+static void kernelSendObject(void)
+{
+	UAVTalkSendObject(talkConnection, BenchmarkResultsHandle(), 0, 0, 0);
+}
+
+static void kernelCRC8(void)
+{
+	crcResult = PIOS_CRC_updateCRC(0, crcBlock, CRC_BLOCK_LENGTH);
+}
+
+static void kernelCRC16(void)
+{
+	crcResult = PIOS_CRC16_updateCRC(0, crcBlock, CRC_BLOCK_LENGTH);
+}
+
+static void kernelCRC32(void)
+{
+	crcResult = PIOS_CRC32_updateCRC(0, crcBlock, CRC_BLOCK_LENGTH);
+}
+
+/**
+  * @}
+  * @}
+  */
@@ -35,6 +35,16 @@
  *
  * This module will periodically calculate the output values for stabilizing the camera
  *
+ * With PIOS_FASTLOOP it runs as a fast loop stage instead, between Stabilization
+ * and Actuator, so the actuator outputs the camera channels computed from the
+ * same attitude sample in the same cycle. It still only updates CameraDesired
+ * every SAMPLE_PERIOD_MS, as the periodic callback does.
+ *
+ * The attitude can be led by FeedForwardTime times the gyro rate of the axis,
+ * which makes up for the lag of the gimbal servos. Adding that field changed
+ * the CameraStabSettings object ID, so settings saved by older firmware are not
+ * loaded and the defaults apply until they are set again.
+ *
  * UAVObjects are automatically generated by the UAVObjectGenerator from
  * the object definition XML file.
  *
@@ -51,8 +61,13 @@
 #include "attitudeactual.h"
 #include "camerastabsettings.h"
 #include "cameradesired.h"
+#include "gyros.h"
 #include "hwsettings.h"
 
+#if defined(PIOS_FASTLOOP)
+#include "fastloop.h"
+#endif
+
 //
 // Configuration
 //
@@ -62,13 +77,21 @@
 
 // Private variables
 static struct CameraStab_data {
+	CameraStabSettingsData settings;
 	portTickType lastSysTime;
+	float fastLoopElapsed;	// ms since the last update from the fast loop
 	float inputs[CAMERASTABSETTINGS_INPUT_NUMELEM];
 	float inputs_filtered[CAMERASTABSETTINGS_INPUT_NUMELEM];
 } *csd;
 
 // Private functions
+#if defined(PIOS_FASTLOOP)
+static void cameraStabFastLoop(float dT);
+#else
 static void attitudeUpdated(UAVObjEvent* ev);
+#endif
+static void cameraStabUpdate(float dT);
+static void settingsUpdated(UAVObjEvent* ev);
 static float bound(float val, float limit);
 
 /**
@@ -107,13 +130,10 @@ int32_t CameraStabInitialize(void)
 		AttitudeActualInitialize();
 		CameraStabSettingsInitialize();
 		CameraDesiredInitialize();
+		GyrosInitialize();
 
-		UAVObjEvent ev = {
-			.obj = AttitudeActualHandle(),
-			.instId = 0,
-			.event = 0,
-		};
-		EventPeriodicCallbackCreate(&ev, attitudeUpdated, SAMPLE_PERIOD_MS / portTICK_RATE_MS);
+		CameraStabSettingsConnectCallback(settingsUpdated);
+		settingsUpdated(NULL);
 
 		return 0;
 	}
@@ -124,48 +144,86 @@ int32_t CameraStabInitialize(void)
 /* stub: module has no module thread */
 int32_t CameraStabStart(void)
 {
+	if (!csd)
+		return 0;
+
+#if defined(PIOS_FASTLOOP)
+	// Run from the sensor task for every gyro sample, no callback of our own
+	FastLoopRegister(FASTLOOP_STAGE_CAMERASTAB, cameraStabFastLoop);
+#else
+	UAVObjEvent ev = {
+		.obj = AttitudeActualHandle(),
+		.instId = 0,
+		.event = 0,
+	};
+	EventPeriodicCallbackCreate(&ev, attitudeUpdated, SAMPLE_PERIOD_MS / portTICK_RATE_MS);
+#endif
+
 	return 0;
 }
 
 MODULE_INITCALL(CameraStabInitialize, CameraStabStart)
 
+#if defined(PIOS_FASTLOOP)
+/**
+ * Fast loop stage, runs after the attitude update for the same gyro sample.
+ * Updates CameraDesired every SAMPLE_PERIOD_MS like the periodic callback.
+ */
+static void cameraStabFastLoop(float dT)
+{
+	csd->fastLoopElapsed += dT * 1000.0f;
+	if (csd->fastLoopElapsed < SAMPLE_PERIOD_MS)
+		return;
+
+	cameraStabUpdate(csd->fastLoopElapsed);
+	csd->fastLoopElapsed = 0;
+}
+#else
 static void attitudeUpdated(UAVObjEvent* ev)
 {
 	if (ev->obj != AttitudeActualHandle())
 		return;
 
-	AccessoryDesiredData accessory;
-
-	CameraStabSettingsData cameraStab;
-	CameraStabSettingsGet(&cameraStab);
-
 	// Check how long since last update, time delta between calls in ms
 	portTickType thisSysTime = xTaskGetTickCount();
 	float dT = (thisSysTime > csd->lastSysTime) ?
 			(thisSysTime - csd->lastSysTime) / portTICK_RATE_MS :
-			(float)SAMPLE_PERIOD_MS / 1000.0f;
+			(float)SAMPLE_PERIOD_MS;
 	csd->lastSysTime = thisSysTime;
 
+	cameraStabUpdate(dT);
+}
+#endif
+
+/**
+ * Update CameraDesired from the attitude and the inputs
+ * \param[in] dT time since the last update in ms
+ */
+static void cameraStabUpdate(float dT)
+{
+	AccessoryDesiredData accessory;
+	const CameraStabSettingsData *cameraStab = &csd->settings;
+
 	// Read any input channels and apply LPF
 	for (uint8_t i = 0; i < CAMERASTABSETTINGS_INPUT_NUMELEM; i++) {
-		if (cameraStab.Input[i] != CAMERASTABSETTINGS_INPUT_NONE) {
-			if (AccessoryDesiredInstGet(cameraStab.Input[i] - CAMERASTABSETTINGS_INPUT_ACCESSORY0, &accessory) == 0) {
+		if (cameraStab->Input[i] != CAMERASTABSETTINGS_INPUT_NONE) {
+			if (AccessoryDesiredInstGet(cameraStab->Input[i] - CAMERASTABSETTINGS_INPUT_ACCESSORY0, &accessory) == 0) {
 				float input_rate;
-				switch (cameraStab.StabilizationMode[i]) {
+				switch (cameraStab->StabilizationMode[i]) {
 				case CAMERASTABSETTINGS_STABILIZATIONMODE_ATTITUDE:
-					csd->inputs[i] = accessory.AccessoryVal * cameraStab.InputRange[i];
+					csd->inputs[i] = accessory.AccessoryVal * cameraStab->InputRange[i];
 					break;
 				case CAMERASTABSETTINGS_STABILIZATIONMODE_AXISLOCK:
-					input_rate = accessory.AccessoryVal * cameraStab.InputRate[i];
-					if (fabs(input_rate) > cameraStab.MaxAxisLockRate)
-						csd->inputs[i] = bound(csd->inputs[i] + input_rate * dT / 1000.0f, cameraStab.InputRange[i]);
+					input_rate = accessory.AccessoryVal * cameraStab->InputRate[i];
+					if (fabs(input_rate) > cameraStab->MaxAxisLockRate)
+						csd->inputs[i] = bound(csd->inputs[i] + input_rate * dT / 1000.0f, cameraStab->InputRange[i]);
 					break;
 				default:
 					PIOS_Assert(0);
 				}
 
 				// bypass LPF calculation if ResponseTime is zero
-				float rt = (float)cameraStab.ResponseTime[i];
+				float rt = (float)cameraStab->ResponseTime[i];
 				if (rt)
 					csd->inputs_filtered[i] = (rt / (rt + dT)) * csd->inputs_filtered[i]
 								+ (dT / (rt + dT)) * csd->inputs[i];
@@ -175,21 +233,32 @@ static void attitudeUpdated(UAVObjEvent* ev)
 		}
 	}
 
-	// Set output channels
-	float attitude;
+	// Set output channels, the body rates are close enough to the
+	// Euler angle rates for the small angles a gimbal works over
+	AttitudeActualData attitude;
+	GyrosData gyros;
+	CameraDesiredData cameraDesired;
+
+	AttitudeActualGet(&attitude);
+	GyrosGet(&gyros);
+
 	float output;
 
-	AttitudeActualRollGet(&attitude);
-	output = bound((attitude + csd->inputs_filtered[CAMERASTABSETTINGS_INPUT_ROLL]) / cameraStab.OutputRange[CAMERASTABSETTINGS_OUTPUTRANGE_ROLL], 1.0f);
-	CameraDesiredRollSet(&output);
+	output = attitude.Roll + gyros.x * cameraStab->FeedForwardTime[CAMERASTABSETTINGS_FEEDFORWARDTIME_ROLL] / 1000.0f;
+	cameraDesired.Roll = bound((output + csd->inputs_filtered[CAMERASTABSETTINGS_INPUT_ROLL]) / cameraStab->OutputRange[CAMERASTABSETTINGS_OUTPUTRANGE_ROLL], 1.0f);
 
-	AttitudeActualPitchGet(&attitude);
-	output = bound((attitude + csd->inputs_filtered[CAMERASTABSETTINGS_INPUT_PITCH]) / cameraStab.OutputRange[CAMERASTABSETTINGS_OUTPUTRANGE_PITCH], 1.0f);
-	CameraDesiredPitchSet(&output);
+	output = attitude.Pitch + gyros.y * cameraStab->FeedForwardTime[CAMERASTABSETTINGS_FEEDFORWARDTIME_PITCH] / 1000.0f;
+	cameraDesired.Pitch = bound((output + csd->inputs_filtered[CAMERASTABSETTINGS_INPUT_PITCH]) / cameraStab->OutputRange[CAMERASTABSETTINGS_OUTPUTRANGE_PITCH], 1.0f);
 
-	AttitudeActualYawGet(&attitude);
-	output = bound((attitude + csd->inputs_filtered[CAMERASTABSETTINGS_INPUT_YAW]) / cameraStab.OutputRange[CAMERASTABSETTINGS_OUTPUTRANGE_YAW], 1.0f);
-	CameraDesiredYawSet(&output);
+	output = attitude.Yaw + gyros.z * cameraStab->FeedForwardTime[CAMERASTABSETTINGS_FEEDFORWARDTIME_YAW] / 1000.0f;
+	cameraDesired.Yaw = bound((output + csd->inputs_filtered[CAMERASTABSETTINGS_INPUT_YAW]) / cameraStab->OutputRange[CAMERASTABSETTINGS_OUTPUTRANGE_YAW], 1.0f);
+
+	CameraDesiredSet(&cameraDesired);
+}
+
+static void settingsUpdated(UAVObjEvent* ev)
+{
+	CameraStabSettingsGet(&csd->settings);
 }
 
 float bound(float val, float limit)
@@ -35,23 +35,35 @@
 #include "flightplanstatus.h"
 #include "flightplancontrol.h"
 #include "flightplansettings.h"
+#include "flightplanimage.h"
 
 // Private constants
 #define STACK_SIZE_BYTES 1500
 #define TASK_PRIORITY (tskIDLE_PRIORITY+1)
 #define MAX_QUEUE_SIZE 2
+#ifndef FLIGHTPLAN_IMAGE_SIZE
+#define FLIGHTPLAN_IMAGE_SIZE 4096
+#endif
+#define MODULE_NAME_LEN 32
+#define IMAGE_CRC_INIT 0xFFFFFFFF
 
 // Private types
 
 // Private variables
 static xTaskHandle taskHandle;
 static xQueueHandle queue;
+// Precompiled image sent by the GCS, made by pmImgCreator.py -b
+static uint8_t image[FLIGHTPLAN_IMAGE_SIZE];
+static uint16_t imageSize;
+static uint8_t imageModule[MODULE_NAME_LEN];
 
 // Private functions
 static void flightPlanTask(void *parameters);
 static void objectUpdatedCb(UAVObjEvent * ev);
+static void imageUpdated(void);
+static bool getModuleName(const uint8_t * img, uint16_t size, uint8_t * name, uint16_t maxlen);
 
-// External variables (temporary, TODO: this will be loaded from the SD card)
+// External variables, the built in script used until the GCS sends an image
 extern unsigned char usrlib_img[];
 
 /**
@@ -78,9 +90,12 @@ int32_t FlightPlanInitialize()
 	FlightPlanStatusInitialize();
 	FlightPlanControlInitialize();
 	FlightPlanSettingsInitialize();
+	FlightPlanImageInitialize();
+	imageSize = 0;
 	
 	// Listen for object updates
 	FlightPlanControlConnectCallback(&objectUpdatedCb);
+	FlightPlanImageConnectCallback(&objectUpdatedCb);
 
 	// Create object queue
 	queue = xQueueCreate(MAX_QUEUE_SIZE, sizeof(UAVObjEvent));
@@ -101,7 +116,8 @@ static void flightPlanTask(void *parameters)
 	FlightPlanStatusData status;
 	FlightPlanControlData control;
 
-	// Setup status object
+	// Setup status object, a loaded image survives a kill
+	FlightPlanStatusGet(&status);
 	status.Status = FLIGHTPLANSTATUS_STATUS_STOPPED;
 	status.ErrorFileID = 0;
 	status.ErrorLineNum = 0;
@@ -120,16 +136,22 @@ static void flightPlanTask(void *parameters)
 		FlightPlanControlGet(&control);
 		if ( control.Command == FLIGHTPLANCONTROL_COMMAND_START )
 		{
-			// Init PyMite
-			retval = pm_init(MEMSPACE_PROG, usrlib_img);
+			// Init PyMite, a complete image from the GCS replaces the built in test script
+			FlightPlanStatusGet(&status);
+			if (status.ImageStatus == FLIGHTPLANSTATUS_IMAGESTATUS_READY)
+				retval = pm_init(MEMSPACE_RAM, image);
+			else
+				retval = pm_init(MEMSPACE_PROG, usrlib_img);
 			if (retval == PM_RET_OK)
 			{
 				// Update status
-				FlightPlanStatusGet(&status);
 				status.Status = FLIGHTPLANSTATUS_STATUS_RUNNING;
 				FlightPlanStatusSet(&status);
-				// Run the test script (TODO: load from SD card)
-				retval = pm_run((uint8_t *)"test");
+				// Run the script
+				if (status.ImageStatus == FLIGHTPLANSTATUS_IMAGESTATUS_READY)
+					retval = pm_run(imageModule);
+				else
+					retval = pm_run((uint8_t *)"test");
 				// Check if an error or exception was thrown
 				if (retval == PM_RET_OK || retval == PM_RET_EX_EXIT)
 				{
@@ -272,6 +294,7 @@ static void objectUpdatedCb(UAVObjEvent * ev)
 				vTaskDelete(taskHandle);
 				taskHandle = NULL;
 				// Update status object
+				FlightPlanStatusGet(&statusData);
 				statusData.Status = FLIGHTPLANSTATUS_STATUS_STOPPED;
 				statusData.ErrorFileID = 0;
 				statusData.ErrorLineNum = 0;
@@ -282,6 +305,134 @@ static void objectUpdatedCb(UAVObjEvent * ev)
 			}
 		}
 	}
+	else if ( ev->obj == FlightPlanImageHandle() )
+	{
+		imageUpdated();
+	}
+}
+
+/**
+ * Store a block of the image sent by the GCS. The blocks are expected in
+ * order, the first one restarts the upload and the last one checks the CRC.
+ */
+static void imageUpdated(void)
+{
+	FlightPlanImageData block;
+	FlightPlanStatusData statusData;
+
+	FlightPlanImageGet(&block);
+	FlightPlanStatusGet(&statusData);
+
+	// The image can not change under a running script
+	if ( statusData.Status == FLIGHTPLANSTATUS_STATUS_RUNNING )
+	{
+		return;
+	}
+
+	// Repeat of the last block, its ack got lost
+	if ( block.Offset > 0 && block.Offset < imageSize && block.Offset + block.Length == imageSize )
+	{
+		return;
+	}
+
+	if ( block.Offset == 0 )
+	{
+		imageSize = 0;
+		if ( block.Size == 0 )
+		{
+			// Back to the built in script
+			statusData.ImageStatus = FLIGHTPLANSTATUS_IMAGESTATUS_BUILTIN;
+			FlightPlanStatusSet(&statusData);
+			return;
+		}
+		statusData.ImageStatus = FLIGHTPLANSTATUS_IMAGESTATUS_LOADING;
+	}
+	else if ( statusData.ImageStatus != FLIGHTPLANSTATUS_IMAGESTATUS_LOADING || block.Offset != imageSize )
+	{
+		// Missed a block, the GCS has to start over
+		statusData.ImageStatus = FLIGHTPLANSTATUS_IMAGESTATUS_INVALID;
+		FlightPlanStatusSet(&statusData);
+		return;
+	}
+
+	if ( block.Size > sizeof(image) || block.Length > FLIGHTPLANIMAGE_DATA_NUMELEM ||
+			block.Offset + block.Length > block.Size )
+	{
+		statusData.ImageStatus = FLIGHTPLANSTATUS_IMAGESTATUS_INVALID;
+		FlightPlanStatusSet(&statusData);
+		return;
+	}
+
+	memcpy(&image[block.Offset], block.Data, block.Length);
+	imageSize = block.Offset + block.Length;
+
+	// Last block, only use the image if it arrived intact
+	if ( imageSize == block.Size )
+	{
+		if ( PIOS_CRC32_updateCRC(IMAGE_CRC_INIT, image, imageSize) == block.Crc &&
+				getModuleName(image, imageSize, imageModule, sizeof(imageModule)) )
+		{
+			statusData.ImageStatus = FLIGHTPLANSTATUS_IMAGESTATUS_READY;
+		}
+		else
+		{
+			imageSize = 0;
+			statusData.ImageStatus = FLIGHTPLANSTATUS_IMAGESTATUS_INVALID;
+		}
+	}
+
+	FlightPlanStatusSet(&statusData);
+}
+
+/**
+ * Get the name of the module of the first code image, it is the last entry
+ * of the names tuple (see img_findInPath())
+ * \return true if the image starts with a valid code image
+ */
+static bool getModuleName(const uint8_t * img, uint16_t size, uint8_t * name, uint16_t maxlen)
+{
+	uint16_t idx = CI_NAMES_FIELD;
+	uint16_t len = 0;
+	uint8_t count;
+
+	if ( size < CI_NAMES_FIELD + 2 || img[CI_TYPE_FIELD] != OBJ_TYPE_CIM || img[idx] != OBJ_TYPE_TUP )
+	{
+		return false;
+	}
+	count = img[idx + 1];
+	idx += 2;
+	if ( count == 0 )
+	{
+		return false;
+	}
+
+	// Skip to the last name
+	for ( uint8_t n = 0; n < count; ++n )
+	{
+		if ( n > 0 )
+		{
+			idx += len;
+		}
+		if ( idx + 3 > size || img[idx] != OBJ_TYPE_STR )
+		{
+			return false;
+		}
+		len = img[idx + 1] | (img[idx + 2] << 8);
+		idx += 3;
+		if ( idx + len > size )
+		{
+			return false;
+		}
+	}
+
+	if ( len >= maxlen )
+	{
+		return false;
+	}
+	memcpy(name, &img[idx], len);
+	name[len] = 0;
+
+	return true;
 }
 
 /**
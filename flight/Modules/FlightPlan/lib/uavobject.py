@@ -36,6 +36,41 @@
 #define TYPE_FLOAT32 6
 #define TYPE_ENUM 7
 
+#define NAME_OBJID 0
+#define NAME_INSTID 1
+#define NAME_FIELDS 2
+#define NAME_FTYPE 3
+#define NAME_NUMELEMENTS 4
+#define NAME_VALUE 5
+#define NAME_NUMELEM 6
+
+// Attribute names looked up by read() and write(). The strings are interned
+// in the string cache and referenced by the code of this module, so they only
+// have to be created on the first access instead of for every lookup.
+// resetNames() runs on import, every run of the VM starts with a new heap.
+static pPmObj_t names[NAME_NUMELEM];
+static uint8_t namesValid = 0;
+
+static PmReturn_t getNames(void)
+{
+	static const char * const strs[NAME_NUMELEM] = { "objId", "instId", "fields", "ftype", "numElements", "value" };
+	uint8_t const *tmpStr;
+	PmReturn_t retval;
+	uint8_t n;
+
+	if (namesValid)
+		return PM_RET_OK;
+
+	for (n = 0; n < NAME_NUMELEM; ++n)
+	{
+		tmpStr = (uint8_t const *)strs[n];
+		retval = string_new(&tmpStr, &names[n]); PM_RETURN_IF_ERROR(retval);
+	}
+	namesValid = 1;
+
+	return PM_RET_OK;
+}
+
 """
 
 from list import append
@@ -100,6 +135,16 @@ class UAVObjectField:
 				for n in range(0, numElements):
 					append(self.value, 0)
 		  
+def resetNames():
+	"""__NATIVE__
+	namesValid = 0;
+	NATIVE_SET_TOS(PM_NONE);
+	return PM_RET_OK;
+	"""
+	pass
+
+resetNames()
+
 class UAVObject:
 	def __init__(self, objId):
 		self.metadata = UAVObjectMetadata(objId)
@@ -158,7 +203,6 @@ class UAVObject:
 		pPmObj_t attrs;
 		pPmObj_t field;
 		pPmObj_t fields;
-		pPmObj_t fieldName;
 		pPmObj_t value;
 		PmReturn_t retval;
 		uint32_t numFields;
@@ -167,7 +211,6 @@ class UAVObject:
 		uint32_t valueIdx;
 		uint32_t type;  
 		uint32_t numElements;   
-		uint8_t const *tmpStr;
 		int16_t *tmpInt16;
 		int32_t *tmpInt32;
 		float *tmpFloat;
@@ -175,17 +218,14 @@ class UAVObject:
 		// Get dictionary of class attributes                
 		self = NATIVE_GET_LOCAL(0);
 		attrs = (pPmObj_t)((pPmInstance_t)self)->cli_attrs;
+		retval = getNames(); PM_RETURN_IF_ERROR(retval);
 
 		// Get object ID
-		tmpStr = (uint8_t const *)"objId";
-		retval = string_new(&tmpStr, &fieldName); PM_RETURN_IF_ERROR(retval);  
-		retval = dict_getItem(attrs, fieldName, &field); PM_RETURN_IF_ERROR(retval);       
+		retval = dict_getItem(attrs, names[NAME_OBJID], &field); PM_RETURN_IF_ERROR(retval);       
 		objId = ((pPmInt_t) field)->val; 
 
 		// Get the instance ID
-		tmpStr = (uint8_t const *)"instId";
-		retval = string_new(&tmpStr, &fieldName); PM_RETURN_IF_ERROR(retval);
-		retval = dict_getItem(attrs, fieldName, &field); PM_RETURN_IF_ERROR(retval);      
+		retval = dict_getItem(attrs, names[NAME_INSTID], &field); PM_RETURN_IF_ERROR(retval);      
 		instId = ((pPmInt_t) field)->val;    
 		
 		// Get handle and number of bytes in the object
@@ -197,9 +237,7 @@ class UAVObject:
 		UAVObjGetInstanceData(objHandle, instId, data);
 		
 		// Get dictionary of fields
-		tmpStr = (uint8_t const *)"fields";
-		retval = string_new(&tmpStr, &fieldName); PM_RETURN_IF_ERROR(retval);     
-		retval = dict_getItem(attrs, fieldName, &fields); PM_RETURN_IF_ERROR(retval);
+		retval = dict_getItem(attrs, names[NAME_FIELDS], &fields); PM_RETURN_IF_ERROR(retval);
 		numFields = ((pPmList_t) fields)->length;    
 
 		// Process each field
@@ -210,19 +248,13 @@ class UAVObject:
 			retval = list_getItem(fields, fieldIdx, &field); PM_RETURN_IF_ERROR(retval);
 			attrs = (pPmObj_t)((pPmInstance_t)field)->cli_attrs;
 			// Get type
-			tmpStr = (uint8_t const *)"ftype";
-			retval = string_new(&tmpStr, &fieldName); PM_RETURN_IF_ERROR(retval); 
-			retval = dict_getItem(attrs, fieldName, &field); PM_RETURN_IF_ERROR(retval);
+			retval = dict_getItem(attrs, names[NAME_FTYPE], &field); PM_RETURN_IF_ERROR(retval);
 			type = ((pPmInt_t) field)->val;   
 			// Get number of elements
-			tmpStr = (uint8_t const *)"numElements";
-			retval = string_new(&tmpStr, &fieldName); PM_RETURN_IF_ERROR(retval); 
-			retval = dict_getItem(attrs, fieldName, &field); PM_RETURN_IF_ERROR(retval);
+			retval = dict_getItem(attrs, names[NAME_NUMELEMENTS], &field); PM_RETURN_IF_ERROR(retval);
 			numElements = ((pPmInt_t) field)->val;
 			// Get value
-			tmpStr = (uint8_t const *)"value";
-			retval = string_new(&tmpStr, &fieldName); PM_RETURN_IF_ERROR(retval); 
-			retval = dict_getItem(attrs, fieldName, &field); PM_RETURN_IF_ERROR(retval); 
+			retval = dict_getItem(attrs, names[NAME_VALUE], &field); PM_RETURN_IF_ERROR(retval); 
 			// Set value for each element
 			for (valueIdx = 0; valueIdx < numElements; ++valueIdx)
 			{		
@@ -260,9 +292,7 @@ class UAVObject:
 				}
 				else
 				{
-					tmpStr = (uint8_t const *)"value";
-					retval = string_new(&tmpStr, &fieldName); PM_RETURN_IF_ERROR(retval); 
-					retval = dict_setItem(attrs, fieldName, value); PM_RETURN_IF_ERROR(retval); 
+					retval = dict_setItem(attrs, names[NAME_VALUE], value); PM_RETURN_IF_ERROR(retval); 
 				}
 			}
 		}
@@ -282,7 +312,6 @@ class UAVObject:
 		pPmObj_t attrs;
 		pPmObj_t field;
 		pPmObj_t fields;
-		pPmObj_t fieldName;
 		pPmObj_t value;
 		PmReturn_t retval;
 		uint32_t numFields;
@@ -291,7 +320,6 @@ class UAVObject:
 		uint32_t valueIdx;
 		uint32_t type;  
 		uint32_t numElements;  
-		uint8_t const *tmpStr;
 		int8_t tmpInt8 = 0;
 		int16_t tmpInt16;
 		int32_t tmpInt32;
@@ -300,17 +328,14 @@ class UAVObject:
 		// Get dictionary of class attributes                
 		self = NATIVE_GET_LOCAL(0);
 		attrs = (pPmObj_t)((pPmInstance_t)self)->cli_attrs;
+		retval = getNames(); PM_RETURN_IF_ERROR(retval);
 
 		// Get object ID
-		tmpStr = (uint8_t const *)"objId";
-		retval = string_new(&tmpStr, &fieldName); PM_RETURN_IF_ERROR(retval);  
-		retval = dict_getItem(attrs, fieldName, &field); PM_RETURN_IF_ERROR(retval);       
+		retval = dict_getItem(attrs, names[NAME_OBJID], &field); PM_RETURN_IF_ERROR(retval);       
 		objId = ((pPmInt_t) field)->val; 
 
 		// Get the instance ID
-		tmpStr = (uint8_t const *)"instId";
-		retval = string_new(&tmpStr, &fieldName); PM_RETURN_IF_ERROR(retval);
-		retval = dict_getItem(attrs, fieldName, &field); PM_RETURN_IF_ERROR(retval);      
+		retval = dict_getItem(attrs, names[NAME_INSTID], &field); PM_RETURN_IF_ERROR(retval);      
 		instId = ((pPmInt_t) field)->val;    
 		
 		// Get handle and number of bytes in the object
@@ -319,9 +344,7 @@ class UAVObject:
 		uint8_t data[numBytes];
 			
 		// Get dictionary of fields
-		tmpStr = (uint8_t const *)"fields";
-		retval = string_new(&tmpStr, &fieldName); PM_RETURN_IF_ERROR(retval);     
-		retval = dict_getItem(attrs, fieldName, &fields); PM_RETURN_IF_ERROR(retval);
+		retval = dict_getItem(attrs, names[NAME_FIELDS], &fields); PM_RETURN_IF_ERROR(retval);
 		numFields = ((pPmList_t) fields)->length;    
 
 		// Process each field
@@ -332,19 +355,13 @@ class UAVObject:
 			retval = list_getItem(fields, fieldIdx, &field); PM_RETURN_IF_ERROR(retval);
 			attrs = (pPmObj_t)((pPmInstance_t)field)->cli_attrs;
 			// Get type
-			tmpStr = (uint8_t const *)"ftype";
-			retval = string_new(&tmpStr, &fieldName); PM_RETURN_IF_ERROR(retval); 
-			retval = dict_getItem(attrs, fieldName, &field); PM_RETURN_IF_ERROR(retval);
+			retval = dict_getItem(attrs, names[NAME_FTYPE], &field); PM_RETURN_IF_ERROR(retval);
 			type = ((pPmInt_t) field)->val;   
 			// Get number of elements
-			tmpStr = (uint8_t const *)"numElements";
-			retval = string_new(&tmpStr, &fieldName); PM_RETURN_IF_ERROR(retval); 
-			retval = dict_getItem(attrs, fieldName, &field); PM_RETURN_IF_ERROR(retval);
+			retval = dict_getItem(attrs, names[NAME_NUMELEMENTS], &field); PM_RETURN_IF_ERROR(retval);
 			numElements = ((pPmInt_t) field)->val;
 			// Get value
-			tmpStr = (uint8_t const *)"value";
-			retval = string_new(&tmpStr, &fieldName); PM_RETURN_IF_ERROR(retval); 
-			retval = dict_getItem(attrs, fieldName, &field); PM_RETURN_IF_ERROR(retval); 
+			retval = dict_getItem(attrs, names[NAME_VALUE], &field); PM_RETURN_IF_ERROR(retval); 
 			// Set value for each element
 			for (valueIdx = 0; valueIdx < numElements; ++valueIdx)
 			{
@@ -62,6 +62,14 @@ static float GravityAccel(float latitude, float longitude, float altitude);
 // Private constants
 
 #define GPS_TIMEOUT_MS                  500
+#define GPS_CONFIG_DELAY_MS             1000 // give the receiver time to boot
+#define GPS_CONFIG_RETRY_MS             2000
+
+#if defined(PIOS_GPS_MINIMAL)
+	#define GPS_READ_BUFFER_SIZE        16
+#else
+	#define GPS_READ_BUFFER_SIZE        32
+#endif
 
 
 #ifdef PIOS_GPS_SETS_HOMELOCATION
@@ -86,6 +94,8 @@ static bool gpsEnabled = false;
 static xTaskHandle gpsTaskHandle;
 
 static char* gps_rx_buffer;
+static uint8_t gps_read_buffer[GPS_READ_BUFFER_SIZE];
+static uint32_t gpsBaud;
 
 static uint32_t timeOfLastCommandMs;
 static uint32_t timeOfLastUpdateMs;
@@ -189,28 +199,37 @@ static void gpsTask(void *parameters)
 
 	GPSSettingsDataProtocolGet(&gpsProtocol);
 
+#if defined(PIOS_INCLUDE_GPS_UBX_PARSER) && !defined(PIOS_GPS_MINIMAL)
+	uint8_t ubxAutoConfig;
+	uint8_t ubxRate;
+	GPSSettingsUbxAutoConfigGet(&ubxAutoConfig);
+	GPSSettingsUbxRateGet(&ubxRate);
+#endif
+
 	timeOfLastUpdateMs = timeNowMs;
-	timeOfLastCommandMs = timeNowMs;
+	// Makes the first configuration go out GPS_CONFIG_DELAY_MS after start
+	timeOfLastCommandMs = timeNowMs - GPS_CONFIG_RETRY_MS + GPS_CONFIG_DELAY_MS;
 
 	GPSPositionGet(&gpsposition);
 	// Loop forever
 	while (1)
 	{
-		uint8_t c;
+		uint16_t len;
 
-		// This blocks the task until there is something on the buffer
-		while (PIOS_COM_ReceiveBuffer(gpsPort, &c, 1, xDelay) > 0)
+		// This blocks the task until there is something on the buffer,
+		// then takes whatever has arrived in one go
+		while ((len = PIOS_COM_ReceiveBuffer(gpsPort, gps_read_buffer, sizeof(gps_read_buffer), xDelay)) > 0)
 		{
 			int res;
 			switch (gpsProtocol) {
 #if defined(PIOS_INCLUDE_GPS_NMEA_PARSER)
 				case GPSSETTINGS_DATAPROTOCOL_NMEA:
-					res = parse_nmea_stream (c,gps_rx_buffer, &gpsposition, &gpsRxStats);
+					res = parse_nmea_stream (gps_read_buffer, len, gps_rx_buffer, &gpsposition, &gpsRxStats);
 					break;
 #endif
 #if defined(PIOS_INCLUDE_GPS_UBX_PARSER)
 				case GPSSETTINGS_DATAPROTOCOL_UBX:
-					res = parse_ubx_stream (c,gps_rx_buffer, &gpsposition, &gpsRxStats);
+					res = parse_ubx_stream (gps_read_buffer, len, gps_rx_buffer, &gpsposition, &gpsRxStats);
 					break;
 #endif
 				default:
@@ -233,6 +252,16 @@ static void gpsTask(void *parameters)
 			uint8_t status = GPSPOSITION_STATUS_NOGPS;
 			GPSPositionStatusSet(&status);
 			AlarmsSet(SYSTEMALARMS_ALARM_GPS, SYSTEMALARMS_ALARM_ERROR);
+
+#if defined(PIOS_INCLUDE_GPS_UBX_PARSER) && !defined(PIOS_GPS_MINIMAL)
+			// A receiver that was just powered or reset lost its configuration
+			if (gpsProtocol == GPSSETTINGS_DATAPROTOCOL_UBX &&
+					ubxAutoConfig == GPSSETTINGS_UBXAUTOCONFIG_CONFIGURE &&
+					(timeNowMs - timeOfLastCommandMs) >= GPS_CONFIG_RETRY_MS) {
+				ubx_autoconfig(gpsPort, gpsBaud, ubxRate);
+				timeOfLastCommandMs = timeNowMs;
+			}
+#endif
 		} else {
 			// we appear to be receiving GPS sentences OK, we've had an update
 			//criteria for GPS-OK taken from this post...
@@ -324,27 +353,33 @@ static void updateSettings()
 		// Set port speed
 		switch (speed) {
 		case HWSETTINGS_GPSSPEED_2400:
-			PIOS_COM_ChangeBaud(gpsPort, 2400);
+			gpsBaud = 2400;
 			break;
 		case HWSETTINGS_GPSSPEED_4800:
-			PIOS_COM_ChangeBaud(gpsPort, 4800);
+			gpsBaud = 4800;
 			break;
 		case HWSETTINGS_GPSSPEED_9600:
-			PIOS_COM_ChangeBaud(gpsPort, 9600);
+			gpsBaud = 9600;
 			break;
 		case HWSETTINGS_GPSSPEED_19200:
-			PIOS_COM_ChangeBaud(gpsPort, 19200);
+			gpsBaud = 19200;
 			break;
 		case HWSETTINGS_GPSSPEED_38400:
-			PIOS_COM_ChangeBaud(gpsPort, 38400);
+			gpsBaud = 38400;
 			break;
 		case HWSETTINGS_GPSSPEED_57600:
-			PIOS_COM_ChangeBaud(gpsPort, 57600);
+			gpsBaud = 57600;
 			break;
 		case HWSETTINGS_GPSSPEED_115200:
-			PIOS_COM_ChangeBaud(gpsPort, 115200);
+			gpsBaud = 115200;
+			break;
+		default:
+			gpsBaud = 0;
 			break;
 		}
+
+		if (gpsBaud)
+			PIOS_COM_ChangeBaud(gpsPort, gpsBaud);
 	}
 }
 
@@ -78,6 +78,8 @@ static bool nmeaProcessGPGSA(GPSPositionData * GpsData, bool* gpsDataUpdated, ch
 	static bool nmeaProcessGPGSV(GPSPositionData * GpsData, bool* gpsDataUpdated, char* param[], uint8_t nbParam);
 #endif //PIOS_GPS_MINIMAL
 
+static bool NMEA_update_position(char* params[], uint8_t nbParams, GPSPositionData *GpsData);
+
 const static struct nmea_parser nmea_parsers[] = {
 	{
 		.prefix = "GPGGA",
@@ -107,85 +109,130 @@ const static struct nmea_parser nmea_parsers[] = {
 #endif //PIOS_GPS_MINIMAL
 };
 
-int parse_nmea_stream (uint8_t c, char *gps_rx_buffer, GPSPositionData *GpsData, struct GPS_RX_STATS *gpsRxStats)
+/**
+ * Parse a block of the incoming stream for NMEA sentences. The sentence is
+ * split into its parameters and the checksum is computed while the characters
+ * arrive, so the handlers get the parameters without another pass over it.
+ */
+int parse_nmea_stream (const uint8_t *rx, uint16_t len, char *gps_rx_buffer, GPSPositionData *GpsData, struct GPS_RX_STATS *gpsRxStats)
 {
+	enum proto_states {
+		START,
+		NMEA_BODY,
+		NMEA_CHK1,
+		NMEA_CHK2,
+		NMEA_CR,
+		NMEA_LF
+	};
+
+	static enum proto_states proto_state = START;
 	static uint8_t rx_count = 0;
-	static bool start_flag = false;
-	static bool found_cr = false;
-
-	// detect start while acquiring stream
-	if (!start_flag && (c == '$')) // NMEA identifier found
-	{
-		start_flag = true;
-		found_cr = false;
-		rx_count = 0;
-	}
-	else
-	if (!start_flag)
-		return PARSER_ERROR;
-
-	if (rx_count >= NMEA_MAX_PACKET_LENGTH)
-	{
-		// The buffer is already full and we haven't found a valid NMEA sentence.
-		// Flush the buffer and note the overflow event.
-		gpsRxStats->gpsRxOverflow++;
-		start_flag = false;
-		found_cr = false;
-		rx_count = 0;
-		return PARSER_OVERRUN;
-	}
-	else
-	{
-		gps_rx_buffer[rx_count] = c;
-		rx_count++;
-	}
-
-	// look for ending '\r\n' sequence
-	if (!found_cr && (c == '\r') )
-		found_cr = true;
-	else
-	if (found_cr && (c != '\n') )
-		found_cr = false;  // false end flag
-	else
-	if (found_cr && (c == '\n') )
-	{
-		// The NMEA functions require a zero-terminated string
-		// As we detected \r\n, the string as for sure 2 bytes long, we will also strip the \r\n
-		gps_rx_buffer[rx_count-2] = 0;
-
-		// prepare to parse next sentence
-		start_flag = false;
-		found_cr = false;
-		rx_count = 0;
-		// Our rxBuffer must look like this now:
-		//   [0]           = '$'
-		//   ...           = zero or more bytes of sentence payload
-		//   [end_pos - 1] = '\r'
-		//   [end_pos]     = '\n'
-		//
-		// Prepare to consume the sentence from the buffer
-
-		// Validate the checksum over the sentence
-		if (!NMEA_checksum(&gps_rx_buffer[1]))
-		{	// Invalid checksum.  May indicate dropped characters on Rx.
-			//PIOS_DEBUG_PinHigh(2);
-			gpsRxStats->gpsRxChkSumError++;
-			//PIOS_DEBUG_PinLow(2);
-			return PARSER_ERROR;
+	static uint8_t checksum_computed;
+	static uint8_t checksum_received;
+	static uint8_t nb_params;
+	static uint8_t param_start[MAX_NB_PARAMS];
+	int res = PARSER_INCOMPLETE;
+	bool complete = false;
+
+	for (uint16_t i = 0; i < len; i++) {
+		uint8_t c = rx[i];
+		int8_t digit;
+
+		// A '$' always starts a new sentence, a broken one before it is dropped
+		if (c == '$') {
+			proto_state = NMEA_BODY;
+			rx_count = 0;
+			checksum_computed = 0;
+			nb_params = 1;
+			param_start[0] = 0;
+			continue;
 		}
-		else
-		{	// Valid checksum, use this packet to update the GPS position
-			if (!NMEA_update_position(&gps_rx_buffer[1], GpsData)) {
-				//PIOS_DEBUG_PinHigh(2);
-				gpsRxStats->gpsRxParserError++;
-				//PIOS_DEBUG_PinLow(2);
-			}
-			else
-				gpsRxStats->gpsRxReceived++;;
 
-			return PARSER_COMPLETE;
+		switch (proto_state) {
+			case START:
+				break;
+			case NMEA_BODY:
+				if (rx_count >= NMEA_MAX_PACKET_LENGTH) {
+					// The buffer is already full and we haven't found a valid NMEA sentence.
+					// Flush the buffer and note the overflow event.
+					gpsRxStats->gpsRxOverflow++;
+					proto_state = START;
+					res = PARSER_OVERRUN;
+				} else if (c == '*') {
+					// After the * comes the checksum, zero-terminate the last parameter
+					gps_rx_buffer[rx_count++] = 0;
+					checksum_received = 0;
+					proto_state = NMEA_CHK1;
+				} else if (c == '\r' || c == '\n') {
+					// Sentence without a checksum
+					gpsRxStats->gpsRxChkSumError++;
+					proto_state = START;
+				} else {
+					checksum_computed ^= c;
+					if (c == ',' && nb_params < MAX_NB_PARAMS) {
+						// Zero-terminate this parameter and start the next one
+						gps_rx_buffer[rx_count++] = 0;
+						param_start[nb_params++] = rx_count;
+					} else {
+						gps_rx_buffer[rx_count++] = c;
+					}
+				}
+				break;
+			case NMEA_CHK1:
+			case NMEA_CHK2:
+				if (c >= '0' && c <= '9')
+					digit = c - '0';
+				else if (c >= 'A' && c <= 'F')
+					digit = c - 'A' + 10;
+				else if (c >= 'a' && c <= 'f')
+					digit = c - 'a' + 10;
+				else
+					digit = -1;
+
+				if (digit < 0) {
+					gpsRxStats->gpsRxChkSumError++;
+					proto_state = START;
+				} else {
+					checksum_received = (checksum_received << 4) | digit;
+					proto_state = (proto_state == NMEA_CHK1) ? NMEA_CHK2 : NMEA_CR;
+				}
+				break;
+			case NMEA_CR:
+				proto_state = (c == '\r') ? NMEA_LF : START;
+				break;
+			case NMEA_LF:
+				proto_state = START;
+				if (c != '\n')
+					break;
+
+				if (checksum_computed != checksum_received) {
+					// Invalid checksum.  May indicate dropped characters on Rx.
+					gpsRxStats->gpsRxChkSumError++;
+					res = PARSER_ERROR;
+				} else {
+					// Valid checksum, use this packet to update the GPS position
+					char* params[MAX_NB_PARAMS];
+					for (uint8_t n = 0; n < nb_params; n++)
+						params[n] = &gps_rx_buffer[param_start[n]];
+
+					if (!NMEA_update_position(params, nb_params, GpsData))
+						gpsRxStats->gpsRxParserError++;
+					else
+						gpsRxStats->gpsRxReceived++;
+
+					complete = true;
+				}
+				break;
 		}
 	}
+
+	if (complete)
+		return PARSER_COMPLETE;
+	else if (res != PARSER_INCOMPLETE)
+		return res;
+	else if (proto_state == START)
+		return PARSER_ERROR;
+
 	return PARSER_INCOMPLETE;
 }
 
@@ -209,92 +256,78 @@ const static struct nmea_parser *NMEA_find_parser_by_prefix(const char *prefix)
 	return (NULL);
 }
 
-/**
- * Computes NMEA sentence checksum
- * \param[in] Buffer for parsed nmea sentence
- * \return false checksum not valid
- * \return true checksum valid
+/* Parse a number encoded in a string of the format:
+ *   [-]NN.nnnnn
+ * in one pass into its whole part and a fractional part with a fixed number of
+ * digits, 1 whole = 10^fract_digits fract. Extra fractional digits are dropped
+ * and missing ones are taken as zero. This avoids strtof(), which depends on
+ * the _sbrk() syscall, as well as any float math.
+ * \return false if the field is empty or not a number
  */
-bool NMEA_checksum(char *nmea_sentence)
+static bool NMEA_parse_decimal(const char *field, bool *negative, uint32_t *whole, uint32_t *fract, uint8_t fract_digits)
 {
-	uint8_t checksum_computed = 0;
-	uint8_t checksum_received;
-
-	while (*nmea_sentence != '\0' && *nmea_sentence != '*') {
-		checksum_computed ^= *nmea_sentence;
-		nmea_sentence++;
-	}
-
-	/* Make sure we're now pointing at the checksum */
-	if (*nmea_sentence == '\0') {
-		/* Buffer ran out before we found a checksum marker */
-		return false;
+	bool in_fract = false;
+	bool digits = false;
+	uint8_t fract_count = 0;
+
+	PIOS_DEBUG_Assert(field);
+
+	*negative = (*field == '-');
+	if (*negative)
+		field++;
+
+	*whole = 0;
+	*fract = 0;
+	for (; *field != 0; field++) {
+		if (*field == '.' && !in_fract) {
+			in_fract = true;
+		} else if (*field >= '0' && *field <= '9') {
+			if (!in_fract) {
+				*whole = *whole * 10 + (*field - '0');
+			} else if (fract_count < fract_digits) {
+				*fract = *fract * 10 + (*field - '0');
+				fract_count++;
+			}
+			digits = true;
+		} else {
+			return false;
+		}
 	}
 
-	/* Load the checksum from the buffer */
-	checksum_received = strtol(nmea_sentence + 1, NULL, 16);
+	for (; fract_count < fract_digits; fract_count++)
+		*fract *= 10;
 
-	//PIOS_COM_SendFormattedStringNonBlocking(COM_DEBUG_USART,"$%d=%d\r\n",checksum_received,checksum_computed);
-
-	return (checksum_computed == checksum_received);
+	return digits;
 }
 
-/*
- * This function only exists to deal with a linking
- * failure in the stdlib function strtof().  This
- * implementation does not rely on the _sbrk() syscall
- * like strtof() does.
- */
-
-/* Parse a number encoded in a string of the format:
- *   [-]NN.nnnnn
- * into a signed whole part and an unsigned fractional part.
- * The fract_units field indicates the units of the fractional part as
- *   1 whole = 10^fract_units fract
- */
-static bool NMEA_parse_real(int32_t * whole, uint32_t * fract, uint8_t * fract_units, char *field)
+/* Parse a real number, an empty field is zero */
+#define NMEA_REAL_DIGITS 4
+static float NMEA_real_to_float(const char *nmea_real)
 {
-	char *s = field;
-	char *field_w;
-	char *field_f;
-
-	PIOS_DEBUG_Assert(whole);
-	PIOS_DEBUG_Assert(fract);
-	PIOS_DEBUG_Assert(fract_units);
-
-	field_w = strsep(&s, ".");
-	field_f = s;
-
-	*whole = strtol(field_w, NULL, 10);
+	bool negative;
+	uint32_t whole;
+	uint32_t fract;
 
-	if (field_w) {
-		/* decimal was found so we may have a fractional part */
-		*fract = strtoul(field_f, NULL, 10);
-		*fract_units = strlen(field_f);
-	} else {
-		/* no decimal was found, fractional part is zero */
-		*fract = 0;
-		*fract_units = 0;
+	if (!NMEA_parse_decimal(nmea_real, &negative, &whole, &fract, NMEA_REAL_DIGITS)) {
+		return 0.0f;
 	}
 
-	return true;
+	float value = whole + fract * 1.0e-4f;
+	return negative ? -value : value;
 }
 
-static float NMEA_real_to_float(char *nmea_real)
+/* Parse the whole part of a field such as hhmmss.sss or ddmmyy, an empty field is zero */
+static uint32_t NMEA_real_to_whole(const char *nmea_real)
 {
-	int32_t whole;
+	bool negative;
+	uint32_t whole;
 	uint32_t fract;
-	uint8_t fract_units;
 
-	/* Sanity checks */
-	PIOS_DEBUG_Assert(nmea_real);
-
-	if (!NMEA_parse_real(&whole, &fract, &fract_units, nmea_real)) {
-		return false;
+	if (!NMEA_parse_decimal(nmea_real, &negative, &whole, &fract, 0)) {
+		return 0;
 	}
 
-	/* Convert to float */
-	return (((float)whole) + fract * powf(10.0f, -fract_units));
+	return whole;
 }
 
 /*
@@ -302,54 +335,21 @@ static float NMEA_real_to_float(char *nmea_real)
  *    DD[D]MM.mmmm[mm]
  * into a fixed-point representation in units of (degrees * 1e-7)
  */
-static bool NMEA_latlon_to_fixed_point(int32_t * latlon, char *nmea_latlon, bool negative)
+static bool NMEA_latlon_to_fixed_point(int32_t * latlon, const char *nmea_latlon, bool negative)
 {
-	int32_t num_DDDMM;
+	bool negative_field;
+	uint32_t num_DDDMM;
 	uint32_t num_m;
-	uint8_t units;
 
 	/* Sanity checks */
 	PIOS_DEBUG_Assert(nmea_latlon);
 	PIOS_DEBUG_Assert(latlon);
 
-	if (*nmea_latlon == '\0') { /* empty lat/lon field */
+	/* the fractional minutes come out scaled to mmmmmmm directly */
+	if (!NMEA_parse_decimal(nmea_latlon, &negative_field, &num_DDDMM, &num_m, 7)) {
 		return false;
 	}
 
-	if (!NMEA_parse_real(&num_DDDMM, &num_m, &units, nmea_latlon)) {
-		return false;
-	}
-
-	/* scale up the mmmm[mm] field apropriately depending on # of digits */
-	/* not using 1eN notation because that forces fixed point and lost precision */
-	switch (units) {
-	case 0:
-		/* no digits, value is zero so no scaling */
-		break;
-	case 1:		/* m       */
-		num_m *= 1000000;	/* m000000 */
-		break;
-	case 2:		/* mm      */
-		num_m *= 100000;	/* mm00000 */
-		break;
-	case 3:		/* mmm     */
-		num_m *= 10000;	/* mmm0000 */
-		break;
-	case 4:		/* mmmm    */
-		num_m *= 1000;	/* mmmm000 */
-		break;
-	case 5:		/* mmmmm   */
-		num_m *= 100;	/* mmmmm00 */
-		break;
-	case 6:		/* mmmmmm  */
-		num_m *= 10;	/* mmmmmm0 */
-		break;
-	default:
-		/* unhandled format */
-		num_m = 0.0f;
-		break;
-	}
-
 	*latlon = (num_DDDMM / 100) * 10000000;        /* scale the whole degrees */
 	*latlon += (num_DDDMM % 100) * 10000000 / 60;  /* add in the scaled decimal whole minutes */
 	*latlon += num_m / 60;	                  /* add in the scaled decimal fractional minutes */
@@ -363,44 +363,14 @@ static bool NMEA_latlon_to_fixed_point(int32_t * latlon, char *nmea_latlon, bool
 
 /**
  * Parses a complete NMEA sentence and updates the GPSPosition UAVObject
- * \param[in] An NMEA sentence with a valid checksum
+ * \param[in] The parameters of an NMEA sentence with a valid checksum, the
+ *            first one is the message name
+ * \param[in] The number of parameters
  * \return true if the sentence was successfully parsed
  * \return false if any errors were encountered with the parsing
  */
-bool NMEA_update_position(char *nmea_sentence, GPSPositionData *GpsData)
+static bool NMEA_update_position(char* params[], uint8_t nbParams, GPSPositionData *GpsData)
 {
-	char* p = nmea_sentence;
-	char* params[MAX_NB_PARAMS];
-	uint8_t nbParams;
-
-#ifdef DEBUG_MSG_IN
-	DEBUG_MSG("\"%s\"\n", nmea_sentence);
-#endif
-
-	// Split the nmea sentence it its parameters, separated by ","
-	// Sample NMEA message: "GPRMC,000131.736,V,,,,,0.00,0.00,060180,,,N*43"
-
-	// The first parameter starts at the beginning of the message
-	params[0] = p;
-	nbParams = 1;
-	while (*p != 0) {
-		if (*p == '*') {
-			// After the * comes the "CRC", we are done,
-			*p = 0;		// Zero-terminate this parameter
-			break;
-		} else if (*p == ',') {
-			// This is the end of this parameter
-			*p = 0;		// Zero-terminate this parameter
-			// Start new parameter
-			if (nbParams==MAX_NB_PARAMS)
-				break;
-			params[nbParams] = p+1;	// For sure there is something at p+1 because at p there is ","
-			nbParams++;
-		}
-		p++;
-	}
-
-
 #ifdef DEBUG_PARAMS
 	int i;
 	for (i=0;i<nbParams; i++) {
@@ -531,10 +501,10 @@ static bool nmeaProcessGPRMC(GPSPositionData * GpsData, bool* gpsDataUpdated, ch
 	GPSTimeGet(&gpst);
 
 	// get UTC time [hhmmss.sss]
-	float hms = NMEA_real_to_float(param[1]);
-	gpst.Second = (int)hms % 100;
-	gpst.Minute = (((int)hms - gpst.Second) / 100) % 100;
-	gpst.Hour = (int)hms / 10000;
+	uint32_t hms = NMEA_real_to_whole(param[1]);
+	gpst.Second = hms % 100;
+	gpst.Minute = (hms / 100) % 100;
+	gpst.Hour = hms / 10000;
 #endif //PIOS_GPS_MINIMAL
 
 	// don't process void sentences
@@ -559,12 +529,11 @@ static bool nmeaProcessGPRMC(GPSPositionData * GpsData, bool* gpsDataUpdated, ch
 	GpsData->Heading = NMEA_real_to_float(param[8]);
 
 #if !defined(PIOS_GPS_MINIMAL)
-	// get Date of fix
-	// TODO: Should really not use a float here to be safe
-	float date = NMEA_real_to_float(param[9]);
-	gpst.Year = (int)date % 100;
-	gpst.Month = (((int)date - gpst.Year) / 100) % 100;
-	gpst.Day = (int)(date / 10000);
+	// get Date of fix [ddmmyy]
+	uint32_t date = NMEA_real_to_whole(param[9]);
+	gpst.Year = date % 100;
+	gpst.Month = (date / 100) % 100;
+	gpst.Day = date / 10000;
 	gpst.Year += 2000;
 	GPSTimeSet(&gpst);
 #endif //PIOS_GPS_MINIMAL
@@ -618,10 +587,10 @@ static bool nmeaProcessGPZDA(GPSPositionData * GpsData, bool* gpsDataUpdated, ch
 	GPSTimeGet(&gpst);
 
 	// get UTC time [hhmmss.sss]
-	float hms = NMEA_real_to_float(param[1]);
-	gpst.Second = (int)hms % 100;
-	gpst.Minute = (((int)hms - gpst.Second) / 100) % 100;
-	gpst.Hour = (int)hms / 10000;
+	uint32_t hms = NMEA_real_to_whole(param[1]);
+	gpst.Second = hms % 100;
+	gpst.Minute = (hms / 100) % 100;
+	gpst.Hour = hms / 10000;
 
 	// Get Date
 	gpst.Day = atoi(param[2]);
@@ -36,9 +36,9 @@
 #include "UBX.h"
 #include "GPS.h"
 
-// parse incoming character stream for messages in UBX binary format
+// parse a block of the incoming stream for messages in UBX binary format
 
-int parse_ubx_stream (uint8_t c, char *gps_rx_buffer, GPSPositionData *GpsData, struct GPS_RX_STATS *gpsRxStats)
+int parse_ubx_stream (const uint8_t *rx, uint16_t len, char *gps_rx_buffer, GPSPositionData *GpsData, struct GPS_RX_STATS *gpsRxStats)
 {
 	enum proto_states {
 		START,
@@ -49,81 +49,104 @@ int parse_ubx_stream (uint8_t c, char *gps_rx_buffer, GPSPositionData *GpsData,
 		UBX_LEN2,
 		UBX_PAYLOAD,
 		UBX_CHK1,
-		UBX_CHK2,
-		FINISHED
+		UBX_CHK2
 	};
 
 	static enum proto_states proto_state = START;
-	static uint8_t rx_count = 0;
+	static uint16_t rx_count = 0;
+	static uint8_t ck_a, ck_b;
 	struct UBXPacket *ubx = (struct UBXPacket *)gps_rx_buffer;
-
-	switch (proto_state) {
-		case START: // detect protocol
-			if (c ==  UBX_SYNC1) // first UBX sync char found
-				proto_state = UBX_SY2;
-			break;
-		case UBX_SY2:
-			if (c == UBX_SYNC2) // second UBX sync char found
-				proto_state = UBX_CLASS;
-			else
-				proto_state = START; // reset state
-			break;
-		case UBX_CLASS:
-			ubx->header.class = c;
-			proto_state = UBX_ID;
-			break;
-		case UBX_ID:
-			ubx->header.id = c;
-			proto_state = UBX_LEN1;
-			break;
-		case UBX_LEN1:
-			ubx->header.len = c;
-			proto_state = UBX_LEN2;
-			break;
-		case UBX_LEN2:
-			ubx->header.len += (c << 8);
-			if (ubx->header.len > sizeof(UBXPayload)) {
-				gpsRxStats->gpsRxOverflow++;
-				proto_state = START;
-			} else {
-				rx_count = 0;
-				proto_state = UBX_PAYLOAD;
-			}
-			break;
-		case UBX_PAYLOAD:
-			if (rx_count < ubx->header.len) {
-				ubx->payload.payload[rx_count] = c;
-				if (++rx_count == ubx->header.len)
+	bool complete = false;
+	uint16_t i = 0;
+
+	while (i < len) {
+		uint8_t c = rx[i];
+
+		switch (proto_state) {
+			case START: // detect protocol
+				if (c ==  UBX_SYNC1) // first UBX sync char found
+					proto_state = UBX_SY2;
+				break;
+			case UBX_SY2:
+				if (c == UBX_SYNC2) // second UBX sync char found
+					proto_state = UBX_CLASS;
+				else
+					proto_state = START; // reset state
+				break;
+			case UBX_CLASS:
+				ubx->header.class = c;
+				ck_a = c;
+				ck_b = c;
+				proto_state = UBX_ID;
+				break;
+			case UBX_ID:
+				ubx->header.id = c;
+				ck_a += c;
+				ck_b += ck_a;
+				proto_state = UBX_LEN1;
+				break;
+			case UBX_LEN1:
+				ubx->header.len = c;
+				ck_a += c;
+				ck_b += ck_a;
+				proto_state = UBX_LEN2;
+				break;
+			case UBX_LEN2:
+				ubx->header.len += (c << 8);
+				ck_a += c;
+				ck_b += ck_a;
+				if (ubx->header.len > sizeof(UBXPayload)) {
+					gpsRxStats->gpsRxOverflow++;
+					proto_state = START;
+				} else {
+					rx_count = 0;
+					proto_state = (ubx->header.len > 0) ? UBX_PAYLOAD : UBX_CHK1;
+				}
+				break;
+			case UBX_PAYLOAD:
+			{
+				// Take the part of the payload that is in this block in one go,
+				// the checksum is updated while copying so the payload is only read once
+				uint16_t n = ubx->header.len - rx_count;
+				if (n > len - i)
+					n = len - i;
+
+				uint8_t *dst = &ubx->payload.payload[rx_count];
+				for (uint16_t k = 0; k < n; k++) {
+					dst[k] = rx[i + k];
+					ck_a += dst[k];
+					ck_b += ck_a;
+				}
+				rx_count += n;
+				i += n;
+
+				if (rx_count == ubx->header.len)
 					proto_state = UBX_CHK1;
-			} else {
-				gpsRxStats->gpsRxOverflow++;
-				proto_state = START;
+				continue;
 			}
-			break;
-		case UBX_CHK1:
-			ubx->header.ck_a = c;
-			proto_state = UBX_CHK2;
-			break;
-		case UBX_CHK2:
-			ubx->header.ck_b = c;
-			if (checksum_ubx_message(ubx)) { // message complete and valid
-				parse_ubx_message(ubx, GpsData);
-				proto_state = FINISHED;
-			} else {
-				gpsRxStats->gpsRxChkSumError++;
+			case UBX_CHK1:
+				ubx->header.ck_a = c;
+				proto_state = UBX_CHK2;
+				break;
+			case UBX_CHK2:
+				ubx->header.ck_b = c;
+				if (ubx->header.ck_a == ck_a && ubx->header.ck_b == ck_b) { // message complete and valid
+					parse_ubx_message(ubx, GpsData);
+					gpsRxStats->gpsRxReceived++;
+					complete = true;
+				} else {
+					gpsRxStats->gpsRxChkSumError++;
+				}
 				proto_state = START;
-			}
-			break;
-		default: break;
+				break;
+		}
+		i++;
 	}
 
-	if (proto_state == START)
-		return PARSER_ERROR;	// parser couldn't use this byte
-	else if (proto_state == FINISHED) {
-		gpsRxStats->gpsRxReceived++;
-		proto_state = START;
-		return PARSER_COMPLETE;	// message complete & processed
-	}
+	if (complete)
+		return PARSER_COMPLETE;	// at least one message complete & processed
+	else if (proto_state == START)
+		return PARSER_ERROR;	// parser couldn't use the last bytes
 
 	return PARSER_INCOMPLETE; // message not (yet) complete
 }
@@ -137,6 +160,8 @@ int parse_ubx_stream (uint8_t c, char *gps_rx_buffer, GPSPositionData *GpsData,
 #define DOP_RECEIVED	(1 << 2)
 #define VELNED_RECEIVED	(1 << 3)
 #define SOL_RECEIVED	(1 << 4)
+#define PVT_RECEIVED	(1 << 5) // NAV-PVT alone has all that is published
+#define SET_PUBLISHED	(1 << 7) // GPSPosition has been updated for this set
 #define	ALL_RECEIVED	(SOL_RECEIVED | VELNED_RECEIVED | DOP_RECEIVED | POSLLH_RECEIVED)
 #define NONE_RECEIVED	0
 
@@ -160,36 +185,6 @@ bool check_msgtracker (uint32_t tow, uint8_t msg_flag)
 	return true;
 }
 
-bool checksum_ubx_message (struct UBXPacket *ubx)
-{
-	int i;
-	uint8_t ck_a, ck_b;
-
-	ck_a = ubx->header.class;
-	ck_b = ck_a;
-
-	ck_a += ubx->header.id;
-	ck_b += ck_a;
-
-	ck_a += ubx->header.len & 0xff;
-	ck_b += ck_a;
-
-	ck_a += ubx->header.len >> 8;
-	ck_b += ck_a;
-
-	for (i = 0; i < ubx->header.len; i++) {
-		ck_a += ubx->payload.payload[i];
-		ck_b += ck_a;
-	}
-
-	if (ubx->header.ck_a == ck_a &&
-			ubx->header.ck_b == ck_b)
-		return true;
-	else
-		return false;
-
-}
-
 void parse_ubx_nav_posllh (struct UBX_NAV_POSLLH *posllh, GPSPositionData *GpsPosition)
 {
 	if (check_msgtracker(posllh->iTOW, POSLLH_RECEIVED)) {
@@ -248,6 +243,59 @@ void parse_ubx_nav_velned (struct UBX_NAV_VELNED *velned, GPSPositionData *GpsPo
 	}
 }
 
+void parse_ubx_nav_pvt (struct UBX_NAV_PVT *pvt, GPSPositionData *GpsPosition)
+{
+	GPSVelocityData GpsVelocity;
+
+	if (check_msgtracker(pvt->iTOW, PVT_RECEIVED)) {
+		GpsPosition->Satellites = pvt->numSV;
+
+		if (pvt->flags & PVT_FLAGS_GNSSFIX_OK) {
+			switch (pvt->fixType) {
+				case PVT_FIXTYPE_2DFIX:
+					GpsPosition->Status = GPSPOSITION_STATUS_FIX2D;
+					break;
+				case PVT_FIXTYPE_3DFIX:
+					GpsPosition->Status = GPSPOSITION_STATUS_FIX3D;
+					break;
+				default: GpsPosition->Status = GPSPOSITION_STATUS_NOFIX;
+			}
+		}
+		else // fix is not valid so we make sure to treat is as NOFIX
+			GpsPosition->Status = GPSPOSITION_STATUS_NOFIX;
+
+		if (GpsPosition->Status != GPSPOSITION_STATUS_NOFIX) {
+			GpsPosition->Altitude = (float)pvt->hMSL*0.001f;
+			GpsPosition->GeoidSeparation = (float)(pvt->height - pvt->hMSL)*0.001f;
+			GpsPosition->Latitude = pvt->lat;
+			GpsPosition->Longitude = pvt->lon;
+			GpsPosition->Groundspeed = (float)pvt->gSpeed * 0.001f;
+			GpsPosition->Heading = (float)pvt->headMot * 1.0e-5f;
+			GpsPosition->PDOP = (float)pvt->pDOP * 0.01f;
+
+			GpsVelocity.North	= (float)pvt->velN * 0.001f;
+			GpsVelocity.East	= (float)pvt->velE * 0.001f;
+			GpsVelocity.Down	= (float)pvt->velD * 0.001f;
+			GPSVelocitySet(&GpsVelocity);
+		}
+
+#if !defined(PIOS_GPS_MINIMAL)
+		if ((pvt->valid & (PVT_VALID_VALIDDATE | PVT_VALID_VALIDTIME)) == (PVT_VALID_VALIDDATE | PVT_VALID_VALIDTIME)) {
+			GPSTimeData GpsTime;
+
+			GpsTime.Year = pvt->year;
+			GpsTime.Month = pvt->month;
+			GpsTime.Day = pvt->day;
+			GpsTime.Hour = pvt->hour;
+			GpsTime.Minute = pvt->min;
+			GpsTime.Second = pvt->sec;
+
+			GPSTimeSet(&GpsTime);
+		}
+#endif
+	}
+}
+
 #if !defined(PIOS_GPS_MINIMAL)
 void parse_ubx_nav_timeutc (struct UBX_NAV_TIMEUTC *timeutc)
 {
@@ -318,6 +366,10 @@ uint32_t parse_ubx_message (struct UBXPacket *ubx, GPSPositionData *GpsPosition)
 				case UBX_ID_VELNED:
 					parse_ubx_nav_velned (&ubx->payload.nav_velned, GpsPosition);
 					break;
+				case UBX_ID_PVT:
+					if (ubx->header.len >= UBX_NAV_PVT_MIN_LEN)
+						parse_ubx_nav_pvt (&ubx->payload.nav_pvt, GpsPosition);
+					break;
 #if !defined(PIOS_GPS_MINIMAL)
 				case UBX_ID_TIMEUTC:
 					parse_ubx_nav_timeutc (&ubx->payload.nav_timeutc);
@@ -329,13 +381,84 @@ uint32_t parse_ubx_message (struct UBXPacket *ubx, GPSPositionData *GpsPosition)
 			}
 			break;
 	}
-	if (msgtracker.msg_received == ALL_RECEIVED) {
+	if (msgtracker.msg_received == ALL_RECEIVED ||
+			(msgtracker.msg_received & (PVT_RECEIVED | SET_PUBLISHED)) == PVT_RECEIVED) {
 		GPSPositionSet(GpsPosition);
-		msgtracker.msg_received = NONE_RECEIVED;
+		msgtracker.msg_received |= SET_PUBLISHED;
 		id = GPSPOSITION_OBJID;
 	}
 	return id;
 }
 
+#if !defined(PIOS_GPS_MINIMAL)
+// Send a UBX message, the checksum is added here
+
+static void ubx_send_message (uint32_t gpsPort, uint8_t class, uint8_t id, const void *payload, uint16_t len)
+{
+	uint8_t header[6] = { UBX_SYNC1, UBX_SYNC2, class, id, len & 0xff, len >> 8 };
+	uint8_t checksum[2] = { 0, 0 };
+	const uint8_t *data = payload;
+
+	for (uint8_t i = 2; i < sizeof(header); i++) {
+		checksum[0] += header[i];
+		checksum[1] += checksum[0];
+	}
+	for (uint16_t i = 0; i < len; i++) {
+		checksum[0] += data[i];
+		checksum[1] += checksum[0];
+	}
+
+	PIOS_COM_SendBuffer(gpsPort, header, sizeof(header));
+	PIOS_COM_SendBuffer(gpsPort, data, len);
+	PIOS_COM_SendBuffer(gpsPort, checksum, sizeof(checksum));
+}
+
+static void ubx_set_message_rate (uint32_t gpsPort, uint8_t class, uint8_t id, uint8_t rate)
+{
+	struct UBX_CFG_MSG msg = {
+		.msgClass = class,
+		.msgID = id,
+		.rate = rate,
+	};
+
+	ubx_send_message(gpsPort, UBX_CLASS_CFG, UBX_ID_CFG_MSG, &msg, sizeof(msg));
+}
+
+// Configure a u-blox receiver on its UART1 for binary only output of the messages
+// parsed above. The configuration is not saved in the receiver, so this is sent
+// again whenever the receiver stops sending updates.
+
+void ubx_autoconfig (uint32_t gpsPort, uint32_t baud, uint8_t rate)
+{
+	if (rate < 1)
+		rate = 1;
+
+	// Keep the baud rate, accept both protocols but only send UBX
+	struct UBX_CFG_PRT prt = {
+		.portID = CFG_PRT_PORTID_UART1,
+		.mode = CFG_PRT_MODE_8N1,
+		.baudRate = baud,
+		.inProtoMask = CFG_PRT_PROTO_UBX | CFG_PRT_PROTO_NMEA,
+		.outProtoMask = CFG_PRT_PROTO_UBX,
+	};
+	ubx_send_message(gpsPort, UBX_CLASS_CFG, UBX_ID_CFG_PRT, &prt, sizeof(prt));
+
+	struct UBX_CFG_RATE navrate = {
+		.measRate = 1000 / rate,
+		.navRate = 1,
+		.timeRef = CFG_RATE_TIMEREF_GPS,
+	};
+	ubx_send_message(gpsPort, UBX_CLASS_CFG, UBX_ID_CFG_RATE, &navrate, sizeof(navrate));
+
+	// The set every u-blox receiver has at the solution rate, the rest once a second
+	ubx_set_message_rate(gpsPort, UBX_CLASS_NAV, UBX_ID_POSLLH, 1);
+	ubx_set_message_rate(gpsPort, UBX_CLASS_NAV, UBX_ID_DOP, 1);
+	ubx_set_message_rate(gpsPort, UBX_CLASS_NAV, UBX_ID_SOL, 1);
+	ubx_set_message_rate(gpsPort, UBX_CLASS_NAV, UBX_ID_VELNED, 1);
+	ubx_set_message_rate(gpsPort, UBX_CLASS_NAV, UBX_ID_TIMEUTC, rate);
+	ubx_set_message_rate(gpsPort, UBX_CLASS_NAV, UBX_ID_SVINFO, rate);
+}
+#endif
+
 #endif // PIOS_INCLUDE_GPS_UBX_PARSER
 
@@ -42,16 +42,22 @@
 
 // Messages classes
 #define UBX_CLASS_NAV	0x01
+#define UBX_CLASS_CFG	0x06
 
 // Message IDs
 #define UBX_ID_POSLLH	0x02
 #define UBX_ID_STATUS	0x03
 #define UBX_ID_DOP		0x04
 #define UBX_ID_SOL		0x06
+#define UBX_ID_PVT		0x07
 #define	UBX_ID_VELNED	0x12
 #define UBX_ID_TIMEUTC	0x21
 #define UBX_ID_SVINFO	0x30
 
+#define UBX_ID_CFG_PRT	0x00
+#define UBX_ID_CFG_MSG	0x01
+#define UBX_ID_CFG_RATE	0x08
+
 // private structures
 
 // Geodetic Position Solution
@@ -101,6 +107,53 @@ struct UBX_NAV_DOP {
 	uint16_t	eDOP;  // Easting DOP
 };
 
+// Position, velocity and time solution (u-blox 7 and later)
+
+#define PVT_VALID_VALIDDATE		(1 << 0)
+#define PVT_VALID_VALIDTIME		(1 << 1)
+
+#define PVT_FLAGS_GNSSFIX_OK	(1 << 0)
+
+#define PVT_FIXTYPE_2DFIX		0x02
+#define PVT_FIXTYPE_3DFIX		0x03
+
+struct UBX_NAV_PVT {
+	uint32_t	iTOW;       // GPS Millisecond Time of Week (ms)
+	uint16_t	year;       // UTC date and time
+	uint8_t		month;
+	uint8_t		day;
+	uint8_t		hour;
+	uint8_t		min;
+	uint8_t		sec;
+	uint8_t		valid;      // Validity Flags
+	uint32_t	tAcc;       // Time Accuracy Estimate (ns)
+	int32_t		nano;       // Nanoseconds of second
+	uint8_t		fixType;    // GNSS fix type
+	uint8_t		flags;      // Fix status flags
+	uint8_t		reserved1;  // Reserved
+	uint8_t		numSV;      // Number of SVs used in Nav Solution
+	int32_t		lon;        // Longitude (deg*1e-7)
+	int32_t		lat;        // Latitude (deg*1e-7)
+	int32_t		height;     // Height above Ellipsoid (mm)
+	int32_t		hMSL;       // Height above mean sea level (mm)
+	uint32_t	hAcc;       // Horizontal Accuracy Estimate (mm)
+	uint32_t	vAcc;       // Vertical Accuracy Estimate (mm)
+	int32_t		velN;       // mm/s NED north velocity
+	int32_t		velE;       // mm/s NED east velocity
+	int32_t		velD;       // mm/s NED down velocity
+	int32_t		gSpeed;     // mm/s Ground Speed (2-D)
+	int32_t		headMot;    // 1e-5 *deg Heading of motion 2-D
+	uint32_t	sAcc;       // mm/s Speed Accuracy Estimate
+	uint32_t	headAcc;    // 1e-5 *deg Heading Accuracy Estimate
+	uint16_t	pDOP;       // Position DOP
+	uint8_t		reserved2[6]; // Reserved, the u-blox 7 message ends here
+	int32_t		headVeh;    // 1e-5 *deg Heading of vehicle (u-blox 8)
+	int16_t		magDec;     // 1e-2 *deg Magnetic declination (u-blox 8)
+	uint16_t	magAcc;     // 1e-2 *deg Magnetic declination accuracy (u-blox 8)
+};
+
+#define UBX_NAV_PVT_MIN_LEN	84
+
 // Navigation solution
 
 struct UBX_NAV_SOL {
@@ -191,12 +244,50 @@ struct UBX_NAV_SVINFO {
 	struct UBX_NAV_SVINFO_SV	sv[MAX_SVS]; // Repeated 'numCh' times
 };
 
+// Port configuration
+
+#define CFG_PRT_PORTID_UART1	1
+#define CFG_PRT_MODE_8N1		0x000008D0
+#define CFG_PRT_PROTO_UBX		(1 << 0)
+#define CFG_PRT_PROTO_NMEA		(1 << 1)
+
+struct UBX_CFG_PRT {
+	uint8_t		portID;       // Port number
+	uint8_t		reserved0;    // Reserved
+	uint16_t	txReady;      // TX ready pin configuration
+	uint32_t	mode;         // UART character framing
+	uint32_t	baudRate;     // Baudrate (bits/s)
+	uint16_t	inProtoMask;  // Protocols accepted on the port
+	uint16_t	outProtoMask; // Protocols sent on the port
+	uint16_t	flags;        // Reserved
+	uint16_t	reserved5;    // Reserved
+};
+
+// Navigation and measurement rate
+
+#define CFG_RATE_TIMEREF_GPS	1
+
+struct UBX_CFG_RATE {
+	uint16_t	measRate;     // Measurement period (ms)
+	uint16_t	navRate;      // Measurements per navigation solution
+	uint16_t	timeRef;      // Time the measurements are aligned to
+};
+
+// Message rate on the current port
+
+struct UBX_CFG_MSG {
+	uint8_t		msgClass;     // Class of the message
+	uint8_t		msgID;        // ID of the message
+	uint8_t		rate;         // Sent once every rate navigation solutions, 0 disables it
+};
+
 typedef union {
 	uint8_t		payload[0];
 	struct UBX_NAV_POSLLH	nav_posllh;
 	struct UBX_NAV_STATUS	nav_status;
 	struct UBX_NAV_DOP		nav_dop;
 	struct UBX_NAV_SOL		nav_sol;
+	struct UBX_NAV_PVT		nav_pvt;
 	struct UBX_NAV_VELNED	nav_velned;
 #if !defined(PIOS_GPS_MINIMAL)
 	struct UBX_NAV_TIMEUTC	nav_timeutc;
@@ -217,8 +308,10 @@ struct UBXPacket {
 	UBXPayload	payload;
 };
 
-bool checksum_ubx_message(struct UBXPacket *);
 uint32_t parse_ubx_message(struct UBXPacket *, GPSPositionData *);
-int  parse_ubx_stream(uint8_t, char *, GPSPositionData *, struct GPS_RX_STATS *);
+int  parse_ubx_stream(const uint8_t *, uint16_t, char *, GPSPositionData *, struct GPS_RX_STATS *);
+#if !defined(PIOS_GPS_MINIMAL)
+void ubx_autoconfig(uint32_t gpsPort, uint32_t baud, uint8_t rate);
+#endif
 
 #endif /* UBX_H */
@@ -59,6 +59,7 @@
 #include "velocitydesired.h"
 #include "velocityactual.h"
 #include "CoordinateConversions.h"
+#include "fast_math.h"
 
 // Private constants
 #define MAX_QUEUE_SIZE 1
@@ -392,11 +393,13 @@ static void updateVtolDesiredAttitude()
 	
 	// Project the north and east command signals into the pitch and roll based on yaw.  For this to behave well the
 	// craft should move similarly for 5 deg roll versus 5 deg pitch
-	stabDesired.Pitch = bound(-northCommand * cosf(attitudeActual.Yaw * M_PI / 180) + 
-				      -eastCommand * sinf(attitudeActual.Yaw * M_PI / 180),
+	float cosYaw = fast_cosf(attitudeActual.Yaw * M_PI / 180);
+	float sinYaw = fast_sinf(attitudeActual.Yaw * M_PI / 180);
+	stabDesired.Pitch = bound(-northCommand * cosYaw + 
+				      -eastCommand * sinYaw,
 				      -guidanceSettings.MaxRollPitch, guidanceSettings.MaxRollPitch);
-	stabDesired.Roll = bound(-northCommand * sinf(attitudeActual.Yaw * M_PI / 180) + 
-				     eastCommand * cosf(attitudeActual.Yaw * M_PI / 180),
+	stabDesired.Roll = bound(-northCommand * sinYaw + 
+				     eastCommand * cosYaw,
 				     -guidanceSettings.MaxRollPitch, guidanceSettings.MaxRollPitch);
 	
 	if(guidanceSettings.ThrottleControl == GUIDANCESETTINGS_THROTTLECONTROL_FALSE) {
@@ -0,0 +1,453 @@
+/**
+ ******************************************************************************
+ * @addtogroup OpenPilotModules OpenPilot Modules
+ * @{
+ * @addtogroup LoggingModule Logging Module
+ * @brief Records updates of selected objects to the SD card
+ * @{
+ *
+ * @file       logging.c
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Black box logging of object updates at full rate
+ *
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/**
+ * Input objects: LoggingSettings, FlightStatus and the objects listed in LoggingSettings.ObjectIDs
+ * Output object: LoggingStats
+ *
+ * Every update of a selected object is framed as a UAVTalk packet and stored as
+ * a record of the compact log format (shared/oplog/oplog.h), which the GCS
+ * replays like its own logs. A sync frame starts about every block, so a bad
+ * sector costs little more than its own records. There is no trailing index,
+ * the files may end at any point. Records are appended to a buffer of fixed
+ * size split into blocks. A low priority task writes full blocks to the card,
+ * many sectors per write, while the next block fills. Records that do not fit while the card is busy are dropped and counted.
+ *
+ * Boards without PIOS_INCLUDE_SDCARD build the module too, it only reports NoCard.
+ */
+
+#include "openpilot.h"
+#include "logging.h"
+#include "loggingsettings.h"
+#include "loggingstats.h"
+#include "flightstatus.h"
+#include "uavtalk.h"
+#include "uavobjectsinit.h"
+#include "oplog.h"
+
+// Private constants
+#define STACK_SIZE_BYTES 1024
+#define TASK_PRIORITY (tskIDLE_PRIORITY + 1)
+#ifndef PIOS_LOGGING_BUFFER_SIZE
+#define PIOS_LOGGING_BUFFER_SIZE 8192
+#endif
+#define BLOCK_SIZE 2048	// 4 sectors per write
+#define NUM_BLOCKS (PIOS_LOGGING_BUFFER_SIZE / BLOCK_SIZE)
+#define PACKET_MAX_LENGTH (UAVOBJECTS_LARGEST + 11)
+// A partly filled block is written after this long, bounds what a crash loses
+#define FLUSH_PERIOD_MS 500
+#define STATS_PERIOD_MS 1000
+#define MAX_FILES 1000
+
+// Private variables
+static xTaskHandle taskHandle;
+static xSemaphoreHandle lock;
+static xSemaphoreHandle drainSem;
+static uint8_t * buffer;
+static uint16_t blockUsed[NUM_BLOCKS];
+static volatile uint8_t readyCount;	// full blocks waiting for the card, from drainBlock on
+static uint8_t fillBlock;
+static uint8_t drainBlock;
+static uint8_t recordHeader[OPLOG_RECORD_MAX_OVERHEAD];
+static uint8_t packet[PACKET_MAX_LENGTH];
+static struct oplog_writer writer;
+static UAVObjHandle connected[LOGGINGSETTINGS_OBJECTIDS_NUMELEM];
+static volatile bool logging;
+static portTickType startTime;
+static LoggingStatsData stats;	// written with the lock held
+#if defined(PIOS_INCLUDE_SDCARD)
+static FILEINFO file;
+#endif
+
+// Private functions
+static void loggingTask(void *parameters);
+static void settingsUpdated(UAVObjEvent * ev);
+static void objectUpdated(UAVObjEvent * ev);
+static bool shouldLog(void);
+static void setStatus(uint8_t status);
+static bool openFile(void);
+static void closeFile(void);
+static uint32_t bufferRoom(void);
+static void append(const uint8_t * data, uint32_t length);
+static void handOver(void);
+static void flushPartial(void);
+static void drain(void);
+
+/**
+ * Initialise the module, called on startup
+ * \returns 0 on success or -1 if initialisation failed
+ */
+int32_t LoggingInitialize(void)
+{
+	uint8_t mode;
+
+	LoggingSettingsInitialize();
+	LoggingStatsInitialize();
+	FlightStatusInitialize();
+
+	memset(&stats, 0, sizeof(stats));
+
+#if !defined(PIOS_INCLUDE_SDCARD)
+	// Nothing to log to on this board
+	stats.Status = LOGGINGSTATS_STATUS_NOCARD;
+	LoggingStatsSet(&stats);
+	return 0;
+#endif
+
+	// The buffer is only taken when logging is enabled at boot
+	LoggingSettingsModeGet(&mode);
+	if (mode == LOGGINGSETTINGS_MODE_DISABLED) {
+		stats.Status = LOGGINGSTATS_STATUS_DISABLED;
+		LoggingStatsSet(&stats);
+		return 0;
+	}
+
+	buffer = (uint8_t *) pvPortMalloc(NUM_BLOCKS * BLOCK_SIZE);
+	lock = xSemaphoreCreateMutex();
+	vSemaphoreCreateBinary(drainSem);
+	if (buffer == NULL || lock == NULL || drainSem == NULL) {
+		return -1;
+	}
+
+	memset(blockUsed, 0, sizeof(blockUsed));
+	readyCount = 0;
+	fillBlock = 0;
+	drainBlock = 0;
+	logging = false;
+
+	stats.Status = LOGGINGSTATS_STATUS_IDLE;
+	LoggingStatsSet(&stats);
+
+	LoggingSettingsConnectCallback(settingsUpdated);
+	settingsUpdated(NULL);
+
+	return 0;
+}
+
+/**
+ * Start the module, called on startup
+ * \returns 0 on success or -1 if initialisation failed
+ */
+int32_t LoggingStart(void)
+{
+	if (buffer == NULL) {
+		return 0;
+	}
+
+	xTaskCreate(loggingTask, (signed char *)"Logging", STACK_SIZE_BYTES/4, NULL, TASK_PRIORITY, &taskHandle);
+	TaskMonitorAdd(TASKINFO_RUNNING_LOGGING, taskHandle);
+
+	return 0;
+}
+
+MODULE_INITCALL(LoggingInitialize, LoggingStart)
+
+/**
+ * Module thread, writes the filled blocks and opens and closes the log
+ */
+static void loggingTask(void *parameters)
+{
+	portTickType lastStats = xTaskGetTickCount();
+
+	while (1) {
+		bool timeout = xSemaphoreTake(drainSem, FLUSH_PERIOD_MS / portTICK_RATE_MS) != pdTRUE;
+
+		if (shouldLog()) {
+			if (!logging && openFile()) {
+				xSemaphoreTake(lock, portMAX_DELAY);
+				OPLogWriterInit(&writer, BLOCK_SIZE);
+				append(recordHeader, OPLogWriteHeader(&writer, recordHeader, OPLOG_SOURCE_FLIGHT, 0));
+				xSemaphoreGive(lock);
+				startTime = xTaskGetTickCount();
+				logging = true;
+			}
+		} else if (logging) {
+			logging = false;
+			flushPartial();
+			drain();
+			closeFile();
+			setStatus(LOGGINGSTATS_STATUS_IDLE);
+		}
+
+		if (logging) {
+			if (timeout && readyCount == 0) {
+				flushPartial();
+			}
+			drain();
+		}
+
+		if (xTaskGetTickCount() - lastStats >= STATS_PERIOD_MS / portTICK_RATE_MS) {
+			lastStats = xTaskGetTickCount();
+			xSemaphoreTake(lock, portMAX_DELAY);
+			LoggingStatsSet(&stats);
+			xSemaphoreGive(lock);
+		}
+	}
+}
+
+/**
+ * Connect to the objects selected in the settings
+ */
+static void settingsUpdated(UAVObjEvent * ev)
+{
+	uint32_t ids[LOGGINGSETTINGS_OBJECTIDS_NUMELEM];
+
+	LoggingSettingsObjectIDsGet(ids);
+
+	for (uint32_t n = 0; n < LOGGINGSETTINGS_OBJECTIDS_NUMELEM; ++n) {
+		if (connected[n] != NULL) {
+			UAVObjDisconnectCallback(connected[n], objectUpdated);
+			connected[n] = NULL;
+		}
+	}
+
+	for (uint32_t n = 0; n < LOGGINGSETTINGS_OBJECTIDS_NUMELEM; ++n) {
+		if (ids[n] != 0) {
+			connected[n] = UAVObjGetByID(ids[n]);
+			if (connected[n] != NULL) {
+				// Logged objects may update at high rates, keep them out of the way of other callbacks
+				UAVObjConnectCallbackPriority(connected[n], objectUpdated, EV_MASK_ALL_UPDATES, EVENT_PRIORITY_LOW);
+			}
+		}
+	}
+}
+
+/**
+ * Record an update of a selected object
+ */
+static void objectUpdated(UAVObjEvent * ev)
+{
+	if (!logging) {
+		return;
+	}
+
+	xSemaphoreTake(lock, portMAX_DELAY);
+
+	uint32_t length = UAVTalkPacketLength(ev->obj);
+	if (length > sizeof(packet) || OPLOG_RECORD_MAX_OVERHEAD + length > bufferRoom()) {
+		++stats.Dropped;
+		xSemaphoreGive(lock);
+		return;
+	}
+
+	if (UAVTalkPackObject(ev->obj, ev->instId, packet) < 0) {
+		++stats.Dropped;
+	} else {
+		uint32_t timestamp = (xTaskGetTickCount() - startTime) * portTICK_RATE_MS;
+		append(recordHeader, OPLogWriteRecordHeader(&writer, recordHeader, timestamp, length));
+		append(packet, length);
+		++stats.Records;
+	}
+
+	xSemaphoreGive(lock);
+}
+
+/**
+ * Whether the settings and arming state ask for a log
+ */
+static bool shouldLog(void)
+{
+	uint8_t mode;
+	uint8_t armed;
+
+	LoggingSettingsModeGet(&mode);
+	FlightStatusArmedGet(&armed);
+
+	return mode == LOGGINGSETTINGS_MODE_ALWAYS ||
+		(mode == LOGGINGSETTINGS_MODE_WHILEARMED && armed == FLIGHTSTATUS_ARMED_ARMED);
+}
+
+/**
+ * Set the status reported in LoggingStats
+ */
+static void setStatus(uint8_t status)
+{
+	xSemaphoreTake(lock, portMAX_DELAY);
+	stats.Status = status;
+	xSemaphoreGive(lock);
+}
+
+/**
+ * Create the next free LOGnnnnn.OPC, the extension of compact logs on 8.3 names
+ * \return true when the file is open
+ */
+static bool openFile(void)
+{
+#if defined(PIOS_INCLUDE_SDCARD)
+	char filename[13];
+
+	if (!PIOS_SDCARD_IsMounted()) {
+		setStatus(LOGGINGSTATS_STATUS_NOCARD);
+		return false;
+	}
+
+	for (uint16_t n = stats.FileIndex; n < MAX_FILES; ++n) {
+		snprintf(filename, sizeof(filename), "LOG%05u.OPC", n);
+		if (PIOS_FOPEN_READ(filename, file)) {
+			// Does not exist yet
+			if (PIOS_FOPEN_WRITE(filename, file)) {
+				break;
+			}
+			xSemaphoreTake(lock, portMAX_DELAY);
+			stats.FileIndex = n;
+			stats.Status = LOGGINGSTATS_STATUS_LOGGING;
+			xSemaphoreGive(lock);
+			return true;
+		}
+		PIOS_FCLOSE(file);
+	}
+#endif /* PIOS_INCLUDE_SDCARD */
+
+	setStatus(LOGGINGSTATS_STATUS_ERROR);
+	return false;
+}
+
+/**
+ * Close the log, the next one gets a new name
+ */
+static void closeFile(void)
+{
+#if defined(PIOS_INCLUDE_SDCARD)
+	PIOS_FCLOSE(file);
+#endif
+	xSemaphoreTake(lock, portMAX_DELAY);
+	++stats.FileIndex;
+	xSemaphoreGive(lock);
+}
+
+/**
+ * Free bytes in the buffer, call with the lock held
+ */
+static uint32_t bufferRoom(void)
+{
+	uint32_t ready;
+	uint32_t used;
+
+	portENTER_CRITICAL();
+	ready = readyCount;
+	used = blockUsed[fillBlock];
+	portEXIT_CRITICAL();
+
+	if (ready >= NUM_BLOCKS) {
+		return 0;
+	}
+
+	uint32_t room = (BLOCK_SIZE - used) + BLOCK_SIZE * (NUM_BLOCKS - 1 - ready);
+
+	uint8_t fill = 100 - room * 100 / (NUM_BLOCKS * BLOCK_SIZE);
+	if (fill > stats.BufferHighWater) {
+		stats.BufferHighWater = fill;
+	}
+
+	return room;
+}
+
+/**
+ * Hand the block being filled to the task and move on to the next one
+ */
+static void handOver(void)
+{
+	portENTER_CRITICAL();
+	++readyCount;
+	portEXIT_CRITICAL();
+
+	fillBlock = (fillBlock + 1) % NUM_BLOCKS;
+	xSemaphoreGive(drainSem);
+}
+
+/**
+ * Append to the buffer, records may span blocks. Call with the lock held
+ * after checking bufferRoom().
+ */
+static void append(const uint8_t * data, uint32_t length)
+{
+	while (length > 0) {
+		uint32_t n = BLOCK_SIZE - blockUsed[fillBlock];
+		if (n > length) {
+			n = length;
+		}
+		memcpy(&buffer[fillBlock * BLOCK_SIZE + blockUsed[fillBlock]], data, n);
+		blockUsed[fillBlock] += n;
+		data += n;
+		length -= n;
+
+		if (blockUsed[fillBlock] == BLOCK_SIZE) {
+			handOver();
+		}
+	}
+}
+
+/**
+ * Hand over a partly filled block so it gets written
+ */
+static void flushPartial(void)
+{
+	xSemaphoreTake(lock, portMAX_DELAY);
+	if (blockUsed[fillBlock] > 0 && readyCount < NUM_BLOCKS) {
+		handOver();
+	}
+	xSemaphoreGive(lock);
+}
+
+/**
+ * Write all blocks handed over, each with a single file write
+ */
+static void drain(void)
+{
+	while (readyCount > 0) {
+		uint32_t written = 0;
+		uint32_t length = blockUsed[drainBlock];
+
+#if defined(PIOS_INCLUDE_SDCARD)
+		PIOS_FWRITE(&file, &buffer[drainBlock * BLOCK_SIZE], length, &written);
+#endif
+
+		xSemaphoreTake(lock, portMAX_DELAY);
+		if (written != length) {
+			++stats.WriteErrors;
+			stats.Status = LOGGINGSTATS_STATUS_ERROR;
+		}
+		stats.BytesLogged += written;
+		xSemaphoreGive(lock);
+
+		blockUsed[drainBlock] = 0;
+		drainBlock = (drainBlock + 1) % NUM_BLOCKS;
+
+		portENTER_CRITICAL();
+		--readyCount;
+		portEXIT_CRITICAL();
+	}
+}
+
+/**
+ * @}
+ * @}
+ */
@@ -174,12 +174,25 @@ static void manualControlTask(void *parameters)
 	resetRcvrActivity(&activity_fsm);
 
 	// Main task loop
+	ManualControlSettingsGet(&settings);
 	lastSysTime = xTaskGetTickCount();
 	while (1) {
 		float scaledChannel[MANUALCONTROLSETTINGS_CHANNELGROUPS_NUMELEM];
 
-		// Wait until next update
-		vTaskDelayUntil(&lastSysTime, UPDATE_PERIOD_MS / portTICK_RATE_MS);
+		// Wait for the next frame when the throttle receiver signals them, otherwise
+		// poll. The timeout keeps the failsafe checks running when frames stop.
+		xSemaphoreHandle frameSem = NULL;
+		if (settings.ChannelGroups[MANUALCONTROLSETTINGS_CHANNELGROUPS_THROTTLE] < MANUALCONTROLSETTINGS_CHANNELGROUPS_NONE) {
+			extern uint32_t pios_rcvr_group_map[];
+			frameSem = PIOS_RCVR_GetSemaphore(pios_rcvr_group_map[settings.ChannelGroups[MANUALCONTROLSETTINGS_CHANNELGROUPS_THROTTLE]],
+							  settings.ChannelNumber[MANUALCONTROLSETTINGS_CHANNELGROUPS_THROTTLE]);
+		}
+		if (frameSem) {
+			xSemaphoreTake(frameSem, UPDATE_PERIOD_MS / portTICK_RATE_MS);
+			lastSysTime = xTaskGetTickCount();
+		} else {
+			vTaskDelayUntil(&lastSysTime, UPDATE_PERIOD_MS / portTICK_RATE_MS);
+		}
 		PIOS_WDG_UpdateFlag(PIOS_WDG_MANUAL);
 
 		// Read settings
@@ -33,12 +33,30 @@
  * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
 
-#ifndef TELEMETRY_H
-#define TELEMETRY_H
+#ifndef OVEROSYNC_H
+#define OVEROSYNC_H
 
-int32_t TelemetryInitialize(void);
+int32_t OveroSyncInitialize(void);
 
-#endif // TELEMETRY_H
+/*
+ * Every SPI frame in either direction starts with this header. From the
+ * F4 the payload is a batch of records (uint32 tick time, UAVTalk packet),
+ * from the companion it is a plain UAVTalk stream. The companion sets
+ * OVEROSYNC_FLAG_HOLD while it cannot take more data, the F4 then keeps
+ * collecting and answers with empty frames until the flag clears.
+ */
+#define OVEROSYNC_MAGIC     0x4F53
+#define OVEROSYNC_FLAG_HOLD 0x01
+
+struct overosync_header {
+	uint16_t magic;
+	uint8_t sequence;
+	uint8_t flags;
+	uint16_t length;	// payload bytes following the header
+	uint16_t dropped;	// records that did not fit since the previous frame
+} __attribute__((packed));
+
+#endif // OVEROSYNC_H
 
 /**
   * @}
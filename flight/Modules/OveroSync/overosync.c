@@ -34,12 +34,15 @@
 #include "overosync.h"
 #include "overosyncstats.h"
 #include "systemstats.h"
+#include "uavobjectsinit.h"
 
 // Private constants
 #define OVEROSYNC_PACKET_SIZE 1024
-#define MAX_QUEUE_SIZE   10
+#define OVEROSYNC_PAYLOAD_SIZE (OVEROSYNC_PACKET_SIZE - sizeof(struct overosync_header))
+#define MAX_QUEUE_SIZE   64
 #define STACK_SIZE_BYTES 4096
 #define TASK_PRIORITY (tskIDLE_PRIORITY + 0)
+#define RECORD_MAX_LENGTH (UAVOBJECTS_LARGEST + 11)
 
 // Private types
 
@@ -47,13 +50,12 @@
 static xQueueHandle queue;
 static UAVTalkConnection uavTalkCon;
 static xTaskHandle overoSyncTaskHandle;
-volatile bool buffer_swap_failed;
-volatile uint32_t buffer_swap_timeval;
+static uint8_t record[RECORD_MAX_LENGTH];
 
 // Private functions
 static void overoSyncTask(void *parameters);
 static int32_t packData(uint8_t * data, int32_t length);
-static int32_t transmitData();
+static void startTransaction(void);
 static void transmitDataDone(bool crc_ok, uint8_t crc_val);
 static void registerObject(UAVObjHandle obj);
 
@@ -67,17 +69,20 @@ struct dma_transaction {
 
 struct overosync {
 	struct dma_transaction transactions[2];
+	uint8_t rx_payload[OVEROSYNC_PAYLOAD_SIZE];
+	volatile uint16_t rx_length;	// bytes in rx_payload the task has not parsed yet
 	uint32_t active_transaction_id;
 	uint32_t loading_transaction_id;
-	xSemaphoreHandle transaction_lock;
-	xSemaphoreHandle buffer_lock;
-	volatile bool transaction_done;
+	volatile bool transaction_active;
+	volatile bool hold;
+	uint8_t sequence;
+	uint16_t write_pointer;
+	uint16_t dropped_records;
 	uint32_t sent_bytes;
-	uint32_t write_pointer;
-	uint32_t sent_objects;
+	uint32_t received_bytes;
 	uint32_t failed_objects;
-	uint32_t received_objects;
 	uint32_t framesync_error;
+	uint32_t held_frames;
 };
 
 struct overosync *overosync;
@@ -123,12 +128,13 @@ static const struct pios_exti_cfg pios_exti_overo_cfg __exti_config = {
  */
 void PIOS_OVERO_IRQHandler()
 {
-	// transmitData must not block to get semaphore for when we get out of
-	// frame and transaction is still running here.  -1 indicates the transaction
-	// semaphore is blocked and we are still in a transaction, thus a framesync
-	// error occurred.  This shouldn't happen.  Race condition?
-	if(transmitData() == -1)
+	// The Overo ended a frame before our DMA finished, we lost frame sync
+	if (overosync->transaction_active) {
 		overosync->framesync_error++;
+		return;
+	}
+
+	startTransaction();
 }
 
 /**
@@ -147,7 +153,7 @@ int32_t OveroSyncInitialize(void)
 	// Create object queues
 	queue = xQueueCreate(MAX_QUEUE_SIZE, sizeof(UAVObjEvent));
 
-	// Initialise UAVTalk
+	// Initialise UAVTalk, only its replies to the companion go through packData
 	uavTalkCon = UAVTalkInitialize(&packData);
 
 	return 0;
@@ -167,19 +173,7 @@ int32_t OveroSyncStart(void)
 	if(overosync == NULL)
 		return -1;
 
-	overosync->transaction_lock = xSemaphoreCreateMutex();
-	if(overosync->transaction_lock == NULL)
-		return -1;
-
-	overosync->buffer_lock = xSemaphoreCreateMutex();
-	if(overosync->buffer_lock == NULL)
-		return -1;
-
-	overosync->active_transaction_id = 0;
-	overosync->loading_transaction_id = 0;
-	overosync->write_pointer = 0;
-	overosync->sent_bytes = 0;
-	overosync->framesync_error = 0;
+	memset(overosync, 0, sizeof(*overosync));
 
 	// Process all registered objects and connect queue for updates
 	UAVObjIterate(&registerObject);
@@ -212,22 +206,18 @@ static void registerObject(UAVObjHandle obj)
 /**
  * Telemetry transmit task, regular priority
  *
- * Logic: We need to double buffer the DMA transfers.  Pack the buffer until either
- * 1) it is full (and then we should record the number of missed events then)
- * 2) the current transaction is done (we should immediately schedule since we are slave)
- * when done packing the buffer we should call PIOS_SPI_TransferBlock, change the active buffer
- * and then take the semaphrore
+ * Logic: The transfers are double buffered. Object updates are framed and
+ * appended as records to the loading buffer while the other one is clocked
+ * out by the DMA. Each NSS edge from the Overo seals the loading buffer and
+ * swaps, so a frame carries everything that happened during the previous
+ * one. Updates that do not fit are dropped and reported in the next header.
+ * An event without object is posted by the DMA completion when the Overo
+ * sent us data to parse.
  */
 static void overoSyncTask(void *parameters)
 {
 	UAVObjEvent ev;
 
-	// Kick off SPI transfers (once one is completed another will automatically transmit)
-	overosync->transaction_done = true;
-	overosync->sent_objects = 0;
-	overosync->failed_objects = 0;
-	overosync->received_objects = 0;
-	
 	portTickType lastUpdateTime = xTaskGetTickCount();
 	portTickType updateTime;
 	
@@ -235,134 +225,156 @@ static void overoSyncTask(void *parameters)
 	while (1) {
 		// Wait for queue message
 		if (xQueueReceive(queue, &ev, portMAX_DELAY) == pdTRUE) {
-			// Process event.  This calls transmitData
-			UAVTalkSendObject(uavTalkCon, ev.obj, ev.instId, false, 0);
+			if (ev.obj == NULL) {
+				for (uint16_t i = 0; i < overosync->rx_length; i++)
+					UAVTalkProcessInputStream(uavTalkCon, overosync->rx_payload[i]);
+				overosync->rx_length = 0;
+			} else {
+				// Frame the object straight away instead of going through the
+				// connection, one copy into the frame follows
+				int32_t length = UAVTalkPackObject(ev.obj, ev.instId, record);
+				if (length > 0)
+					packData(record, length);
+				else
+					overosync->failed_objects++;
+			}
 
 			updateTime = xTaskGetTickCount();
 			if(((portTickType) (updateTime - lastUpdateTime)) > 1000) {
 				// Update stats.  This will trigger a local send event too
 				OveroSyncStatsData syncStats;
 				syncStats.Send = overosync->sent_bytes;
-				syncStats.Received = 0;
+				syncStats.Received = overosync->received_bytes;
 				syncStats.Connected = syncStats.Send > 500 ? OVEROSYNCSTATS_CONNECTED_TRUE : OVEROSYNCSTATS_CONNECTED_FALSE;
 				syncStats.DroppedUpdates = overosync->failed_objects;
+				syncStats.FramesyncErrors = overosync->framesync_error;
+				syncStats.HeldFrames = overosync->held_frames;
 				OveroSyncStatsSet(&syncStats);
 				overosync->failed_objects = 0;
 				overosync->sent_bytes = 0;
+				overosync->received_bytes = 0;
 				lastUpdateTime = updateTime;
 			}
 		}
 	}
 }
 
+/**
+ * DMA complete, runs in the ISR. Takes the flow control flag from the
+ * Overo's header and hands its payload to the task.
+ */
 static void transmitDataDone(bool crc_ok, uint8_t crc_val)
 {
-	uint8_t *rx_buffer;
-	static signed portBASE_TYPE xHigherPriorityTaskWoken;
+	struct overosync_header *header;
+	signed portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
 
-	rx_buffer = overosync->transactions[overosync->active_transaction_id].rx_buffer;
+	header = (struct overosync_header *) overosync->transactions[overosync->active_transaction_id].rx_buffer;
 
-	// Release the semaphore and start another transaction (which grabs semaphore again but then
-	// returns instantly).  Because this is called by the DMA ISR we need to be aware of context
-	// switches.
-	xSemaphoreGiveFromISR(overosync->transaction_lock, &xHigherPriorityTaskWoken);
-	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
+	overosync->transaction_active = false;
 
-	overosync->transaction_done = true;
-	
-	// Parse the data from overo
-	for (uint32_t i = 0; rx_buffer[0] != 0 && i < sizeof(rx_buffer) ; i++)
-		UAVTalkProcessInputStream(uavTalkCon, rx_buffer[i]);
+	// A companion that does not frame its data never holds us
+	if (header->magic != OVEROSYNC_MAGIC) {
+		overosync->hold = false;
+		return;
+	}
+
+	overosync->hold = (header->flags & OVEROSYNC_FLAG_HOLD) != 0;
+
+	if (header->length == 0 || header->length > OVEROSYNC_PAYLOAD_SIZE)
+		return;
+
+	// The task did not get to the previous payload yet
+	if (overosync->rx_length != 0) {
+		overosync->framesync_error++;
+		return;
+	}
+
+	memcpy(overosync->rx_payload, header + 1, header->length);
+	overosync->rx_length = header->length;
+	overosync->received_bytes += header->length;
+
+	UAVObjEvent ev = {
+		.obj = NULL,
+	};
+	xQueueSendFromISR(queue, &ev, &xHigherPriorityTaskWoken);
+	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
 }
 
 /**
- * Transmit data buffer to the modem or USB port.
- * \param[in] data Data buffer to send
- * \param[in] length Length of buffer
+ * Append a record to the frame being loaded
+ * \param[in] data UAVTalk packet
+ * \param[in] length Length of the packet
  * \return -1 on failure
- * \return number of bytes transmitted on success
+ * \return number of bytes added on success
  */
-uint32_t too_long = 0;
 static int32_t packData(uint8_t * data, int32_t length)
 {
 	uint8_t *tx_buffer;
-	
-	portTickType tickTime = xTaskGetTickCount();
+	int32_t ret = length;
 
-	// Get the lock for manipulating the buffer
-	xSemaphoreTake(overosync->buffer_lock, portMAX_DELAY);
+	portTickType tickTime = xTaskGetTickCount();
 
-	// Check this packet will fit
-	if ((overosync->write_pointer + length + sizeof(tickTime)) >
-		sizeof(overosync->transactions[overosync->loading_transaction_id].tx_buffer)) {
-		overosync->failed_objects ++;
-		xSemaphoreGive(overosync->buffer_lock);
-		return -1;
+	// The NSS interrupt swaps the buffers, keep it out while the record goes in
+	taskENTER_CRITICAL();
+
+	if (overosync->write_pointer + sizeof(tickTime) + length > OVEROSYNC_PAYLOAD_SIZE) {
+		overosync->dropped_records++;
+		overosync->failed_objects++;
+		ret = -1;
+	} else {
+		tx_buffer = overosync->transactions[overosync->loading_transaction_id].tx_buffer +
+			sizeof(struct overosync_header) + overosync->write_pointer;
+		memcpy(tx_buffer, &tickTime, sizeof(tickTime));
+		memcpy(tx_buffer + sizeof(tickTime), data, length);
+		overosync->write_pointer += sizeof(tickTime) + length;
 	}
 
-	// Get offset into buffer and copy contents
-	tx_buffer = overosync->transactions[overosync->loading_transaction_id].tx_buffer +
-		overosync->write_pointer;
-	memcpy(tx_buffer, &tickTime, sizeof(tickTime));
-	memcpy(tx_buffer + sizeof(tickTime),data,length);
-	overosync->write_pointer += length + sizeof(tickTime);
-	overosync->sent_bytes += length;
-	overosync->sent_objects++;
-
-	xSemaphoreGive(overosync->buffer_lock);
-	
-	// When the NSS line rises while we are packing data then a transaction doesn't start
-	// because that means we will be here very shortly afterwards (priority of task making that
-	// not always perfectly true) schedule the transaction here.
-	if (buffer_swap_failed && (PIOS_DELAY_DiffuS(buffer_swap_timeval) < 50)) {
-		buffer_swap_failed = false;
-		transmitData();
-	} else if (buffer_swap_failed) {
-		buffer_swap_failed = false;
-		too_long++;
-	}
+	taskEXIT_CRITICAL();
 
-	return length;
+	return ret;
 }
 
-static int32_t transmitData()
+/**
+ * Seal the loading frame and give it to the DMA, called from the NSS
+ * interrupt. While the Overo holds, the loaded data stays where it is and
+ * the last frame goes out again with an empty payload.
+ */
+static void startTransaction(void)
 {
+	struct overosync_header *header;
 	uint8_t *tx_buffer, *rx_buffer;
-	static signed portBASE_TYPE xHigherPriorityTaskWoken;
 
-	// Get this lock first so we don't swap buffers and then fail
-	// to start
-	if (xSemaphoreTake(overosync->transaction_lock, 0) == pdFALSE)
-		return -1;
-
-	// Get lock to manipulate buffers
-	if(xSemaphoreTake(overosync->buffer_lock, 0) == pdFALSE) {
-		xSemaphoreGiveFromISR(overosync->transaction_lock, &xHigherPriorityTaskWoken);
-		portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
-		buffer_swap_failed = true;
-		buffer_swap_timeval = PIOS_DELAY_GetRaw();
-		return -2;
+	if (!overosync->hold) {
+		header = (struct overosync_header *) overosync->transactions[overosync->loading_transaction_id].tx_buffer;
+		header->length = overosync->write_pointer;
+		header->dropped = overosync->dropped_records;
+		overosync->sent_bytes += overosync->write_pointer;
+
+		// Swap buffers
+		overosync->active_transaction_id = overosync->loading_transaction_id;
+		overosync->loading_transaction_id = (overosync->loading_transaction_id + 1) %
+			NELEMENTS(overosync->transactions);
+		overosync->write_pointer = 0;
+		overosync->dropped_records = 0;
+	} else {
+		header = (struct overosync_header *) overosync->transactions[overosync->active_transaction_id].tx_buffer;
+		header->length = 0;
+		header->dropped = 0;
+		overosync->held_frames++;
 	}
 
-	overosync->transaction_done = false;
+	header->magic = OVEROSYNC_MAGIC;
+	header->sequence = overosync->sequence++;
+	header->flags = 0;
 
-	// Swap buffers
-	overosync->active_transaction_id = overosync->loading_transaction_id;
-	overosync->loading_transaction_id = (overosync->loading_transaction_id + 1) % 
-		NELEMENTS(overosync->transactions);
-		
 	tx_buffer = overosync->transactions[overosync->active_transaction_id].tx_buffer;
 	rx_buffer = overosync->transactions[overosync->active_transaction_id].rx_buffer;
-	
-	// Prepare the new loading buffer
-	memset(overosync->transactions[overosync->loading_transaction_id].tx_buffer, 0xff, 
-		   sizeof(overosync->transactions[overosync->loading_transaction_id].tx_buffer));
-	overosync->write_pointer = 0;
 
-	xSemaphoreGiveFromISR(overosync->buffer_lock, &xHigherPriorityTaskWoken);
-	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
-
-	return PIOS_SPI_TransferBlock(pios_spi_overo_id, (uint8_t *) tx_buffer, (uint8_t *) rx_buffer, sizeof(overosync->transactions[overosync->active_transaction_id].tx_buffer), &transmitDataDone) == 0 ? 0 : -3;
+	overosync->transaction_active = true;
+	if (PIOS_SPI_TransferBlock(pios_spi_overo_id, tx_buffer, rx_buffer, OVEROSYNC_PACKET_SIZE, &transmitDataDone) != 0) {
+		overosync->transaction_active = false;
+		overosync->framesync_error++;
+	}
 }
 
 /**
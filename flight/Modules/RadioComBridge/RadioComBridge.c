@@ -49,7 +49,6 @@
 // ****************
 // Private constants
 
-#define TEMP_BUFFER_SIZE 25
 #define STACK_SIZE_BYTES 150
 #define TASK_PRIORITY (tskIDLE_PRIORITY + 1)
 #define BRIDGE_BUF_LEN 512
@@ -60,6 +59,8 @@
 #define MAX_LOST_CONTACT_TIME 4
 #define PACKET_QUEUE_SIZE 10
 #define MAX_PORT_DELAY 200
+#define ARQ_POLL_PERIOD_MS 5
+#define MAX_FORWARD_FRAME (UAVTALK_MAX_HEADER_LENGTH + 256)
 #define EV_PACKET_RECEIVED 0x20
 #define EV_TRANSMIT_PACKET 0x30
 #define EV_SEND_ACK 0x40
@@ -143,18 +144,13 @@ typedef struct {
 
 } RadioComBridgeData;
 
-typedef struct {
-	uint32_t com_port;
-	uint8_t *buffer;
-	uint16_t length;
-	uint16_t index;
-	uint16_t data_length;
-} ReadBuffer, *BufferedReadHandle;
-
 // ****************
 // Private functions
 
 static void UAVTalkRecvTask(void *parameters);
+static bool receiveLocalFrame(UAVTalkComTaskParams *params, uint8_t *frame, uint16_t length);
+static PHPacketHandle getForwardPacket();
+static PHPacketHandle forwardPacket(UAVTalkComTaskParams *params, PHPacketHandle p, uint16_t length);
 static void radioReceiveTask(void *parameters);
 static void sendPacketTask(void *parameters);
 static void UAVTalkSendTask(void *parameters);
@@ -168,9 +164,6 @@ static void receiveData(uint8_t *buf, uint8_t len, int8_t rssi, int8_t afc);
 static void transmitData(uint32_t outputPort, uint8_t *buf, uint8_t len, bool checkHid);
 static void StatusHandler(PHStatusPacketHandle p, int8_t rssi, int8_t afc);
 static void PPMHandler(uint16_t *channels);
-static BufferedReadHandle BufferedReadInit(uint32_t com_port, uint16_t buffer_length);
-static bool BufferedRead(BufferedReadHandle h, uint8_t *value, uint32_t timeout_ms);
-static void BufferedReadSetCom(BufferedReadHandle h, uint32_t com_port);
 static void queueEvent(xQueueHandle queue, void *obj, uint16_t instId, UAVObjEventType type);
 static void updateSettings();
 
@@ -326,14 +319,17 @@ MODULE_INITCALL(RadioComBridgeInitialize, RadioComBridgeStart)
 
 /**
  * Reads UAVTalk messages froma com port and creates packets out of them.
+ * The com data is read straight into the radio packet. Frames for objects we don't
+ * have are only delimited by their header and passed on as they are, just the frames
+ * for our own objects go through the UAVTalk parser.
  */
 static void UAVTalkRecvTask(void *parameters)
 {
 	UAVTalkComTaskParams *params = (UAVTalkComTaskParams *)parameters;
 	PHPacketHandle p = NULL;
-
-	// Create the buffered reader.
-	BufferedReadHandle f = BufferedReadInit(params->comPort, TEMP_BUFFER_SIZE);
+	uint16_t scan = 0;
+	uint16_t frame_length = 0;
+	bool frame_local = false;
 
 	while (1) {
 
@@ -344,207 +340,312 @@ static void UAVTalkRecvTask(void *parameters)
 #endif /* PIOS_INCLUDE_WDG */
 
 		// Receive from USB HID if available, otherwise UAVTalk com if it's available.
+		uint32_t inputPort = params->comPort;
 #if defined(PIOS_INCLUDE_USB)
 		// Determine input port (USB takes priority over telemetry port)
 		if (params->checkHID && PIOS_USB_CheckAvailable(0))
-			BufferedReadSetCom(f, PIOS_COM_USB_HID);
-		else
+			inputPort = PIOS_COM_USB_HID;
 #endif /* PIOS_INCLUDE_USB */
+		if (!inputPort)
 		{
-			if (params->comPort)
-				BufferedReadSetCom(f, params->comPort);
-			else
-			{
-				vTaskDelay(5);
-				continue;
-			}
-		}
-
-		// Read the next byte
-		uint8_t rx_byte;
-		if(!BufferedRead(f, &rx_byte, MAX_PORT_DELAY))
+			vTaskDelay(5);
 			continue;
+		}
 
 		// Get a TX packet from the packet handler if required.
 		if (p == NULL)
 		{
-
-			// Wait until we receive a sync.
-			UAVTalkRxState state = UAVTalkProcessInputStreamQuiet(params->UAVTalkCon, rx_byte);
-			if (state != UAVTALK_STATE_TYPE)
-				continue;
-
-			// Get a packet when we see the sync
-			p = PHGetTXPacket(pios_packet_handler);
+			p = getForwardPacket();
 
 			// No packets available?
 			if (p == NULL)
 			{
 				data->droppedPackets++;
+				// Wait a bit for a packet to come available.
+				vTaskDelay(5);
 				continue;
 			}
-
-			// Initialize the packet.
-			p->header.destination_id = data->destination_id;
-			p->header.source_id = PIOS_RFM22B_DeviceID(pios_rfm22b_id);
-			p->header.type = PACKET_TYPE_DATA;
-			p->data[0] = rx_byte;
-			p->header.data_size = 1;
-			continue;
+			scan = 0;
 		}
 
-		// Insert this byte.
-		p->data[p->header.data_size++] = rx_byte;
+		// Read the com data straight into the packet.
+		uint16_t rx_bytes = PIOS_COM_ReceiveBuffer(inputPort, p->data + p->header.data_size,
+							   PH_MAX_DATA - p->header.data_size, MAX_PORT_DELAY);
+		p->header.data_size += rx_bytes;
 
-		// Keep reading until we receive a completed packet.
-		UAVTalkRxState state = UAVTalkProcessInputStreamQuiet(params->UAVTalkCon, rx_byte);
-		UAVTalkConnectionData *connection = (UAVTalkConnectionData*)(params->UAVTalkCon);
-		UAVTalkInputProcessor *iproc = &(connection->iproc);
-
-		if (state == UAVTALK_STATE_COMPLETE)
+		// Delimit the frames that have arrived.
+		while (scan < p->header.data_size)
 		{
-			xQueueHandle sendQueue = params->sendQueue;
-#if defined(PIOS_INCLUDE_USB)
-			if (params->gcsQueue)
-				if (PIOS_USB_CheckAvailable(0) && PIOS_COM_USB_HID)
-					sendQueue = params->gcsQueue;
-#endif /* PIOS_INCLUDE_USB */
+			uint8_t *frame = p->data + scan;
+			uint16_t length = p->header.data_size - scan;
 
-			// Is this a local UAVObject?
-			// We only generate GcsReceiver ojects, we don't consume them.
-			if ((iproc->obj != NULL) && (iproc->objId != GCSRECEIVER_OBJID))
+			if (frame_length == 0)
 			{
-				// We treat the ObjectPersistence object differently
-				if(iproc->objId == OBJECTPERSISTENCE_OBJID)
+				// Anything that isn't the start of a frame is passed on as it is.
+				if (frame[0] != UAVTALK_SYNC_VAL)
 				{
-					// Unpack object, if the instance does not exist it will be created!
-					UAVObjUnpack(iproc->obj, iproc->instId, connection->rxBuffer);
-
-					// Get the ObjectPersistence object.
-					ObjectPersistenceData obj_per;
-					ObjectPersistenceGet(&obj_per);
-
-					// Is this concerning or setting object?
-					if (obj_per.ObjectID == PIPXSETTINGS_OBJID)
-					{
-						// Queue up the ACK.
-						queueEvent(params->recvQueue, (void*)iproc->obj, iproc->instId, EV_SEND_ACK);
-
-						// Is this a save, load, or delete?
-						bool success = true;
-						switch (obj_per.Operation)
-						{
-						case OBJECTPERSISTENCE_OPERATION_LOAD:
-						{
-#if defined(PIOS_INCLUDE_FLASH_EEPROM)
-							// Load the settings.
-							PipXSettingsData pipxSettings;
-							if (PIOS_EEPROM_Load((uint8_t*)&pipxSettings, sizeof(PipXSettingsData)) == 0)
-								PipXSettingsSet(&pipxSettings);
-							else
-								success = false;
-#endif
-							break;
-						}
-						case OBJECTPERSISTENCE_OPERATION_SAVE:
-						{
-#if defined(PIOS_INCLUDE_FLASH_EEPROM)
-							// Save the settings.
-							PipXSettingsData pipxSettings;
-							PipXSettingsGet(&pipxSettings);
-							int32_t ret = PIOS_EEPROM_Save((uint8_t*)&pipxSettings, sizeof(PipXSettingsData));
-							if (ret != 0)
-								success = false;
-#endif
-							break;
-						}
-						case OBJECTPERSISTENCE_OPERATION_DELETE:
-						{
-#if defined(PIOS_INCLUDE_FLASH_EEPROM)
-							// Erase the settings.
-							PipXSettingsData pipxSettings;
-							uint8_t *ptr = (uint8_t*)&pipxSettings;
-							memset(ptr, 0, sizeof(PipXSettingsData));
-							int32_t ret = PIOS_EEPROM_Save(ptr, sizeof(PipXSettingsData));
-							if (ret != 0)
-								success = false;
-#endif
-							break;
-						}
-						default:
-							break;
-						}
-						if (success == true)
-						{
-							obj_per.Operation = OBJECTPERSISTENCE_OPERATION_COMPLETED;
-							ObjectPersistenceSet(&obj_per);
-						}
-
-						// Release the packet, since we don't need it.
-						PHReleaseTXPacket(pios_packet_handler, p);
-					}
-					else
-					{
-						// Otherwise, queue the packet for transmission.
-						queueEvent(sendQueue, (void*)p, 0, EV_TRANSMIT_PACKET);
-					}
+					scan++;
+					continue;
 				}
-				else
+				if (length < UAVTALK_MIN_HEADER_LENGTH)
+					break;
+				uint16_t size = frame[2] | (frame[3] << 8);
+				if (((frame[1] & UAVTALK_TYPE_MASK) != UAVTALK_TYPE_VER) ||
+				    (size < UAVTALK_MIN_HEADER_LENGTH) || (size > MAX_FORWARD_FRAME))
+				{
+					data->UAVTalkErrors++;
+					scan++;
+					continue;
+				}
+				frame_length = size + UAVTALK_CHECKSUM_LENGTH;
+
+				// Is this a local UAVObject?
+				// We only generate GcsReceiver ojects, we don't consume them.
+				uint32_t objId = frame[4] | (frame[5] << 8) | (frame[6] << 16) | ((uint32_t)frame[7] << 24);
+				frame_local = (frame[1] != UAVTALK_TYPE_OBJ_MULTI) && (objId != GCSRECEIVER_OBJID) &&
+					(frame_length <= PH_MAX_DATA) && (UAVObjGetByID(objId) != NULL);
+
+				// Local frames are taken out of the packet, so they have to be in one piece.
+				if (frame_local && (scan + frame_length > PH_MAX_DATA))
 				{
-					switch (iproc->type)
-					{
-					case UAVTALK_TYPE_OBJ:
-						// Unpack object, if the instance does not exist it will be created!
-						UAVObjUnpack(iproc->obj, iproc->instId, connection->rxBuffer);
-						break;
-					case UAVTALK_TYPE_OBJ_REQ:
-						// Queue up an object send request.
-						queueEvent(params->recvQueue, (void*)iproc->obj, iproc->instId, EV_UPDATE_REQ);
-						break;
-					case UAVTALK_TYPE_OBJ_ACK:
-						if (UAVObjUnpack(iproc->obj, iproc->instId, connection->rxBuffer) == 0)
-							// Queue up an ACK
-							queueEvent(params->recvQueue, (void*)iproc->obj, iproc->instId, EV_SEND_ACK);
-						break;
-					}
-
-					// Release the packet, since we don't need it.
-					PHReleaseTXPacket(pios_packet_handler, p);
+					p = forwardPacket(params, p, scan);
+					scan = 0;
+					continue;
 				}
 			}
+
+			// Frames for other objects are passed on as they arrive.
+			if (!frame_local)
+			{
+				uint16_t n = (length < frame_length) ? length : frame_length;
+				scan += n;
+				frame_length -= n;
+				continue;
+			}
+
+			// Wait for the rest of a local frame, then handle it.
+			if (length < frame_length)
+				break;
+			if (receiveLocalFrame(params, frame, frame_length))
+				scan += frame_length;
 			else
 			{
-				// Queue the packet for transmission.
-				queueEvent(sendQueue, (void*)p, 0, EV_TRANSMIT_PACKET);
+				memmove(frame, frame + frame_length, length - frame_length);
+				p->header.data_size -= frame_length;
 			}
-			p = NULL;
+			frame_length = 0;
+		}
 
-		} else if(state == UAVTALK_STATE_ERROR) {
-			xQueueHandle sendQueue = params->sendQueue;
-#if defined(PIOS_INCLUDE_USB)
-			if (params->gcsQueue)
-				if (PIOS_USB_CheckAvailable(0) && PIOS_COM_USB_HID)
-					sendQueue = params->gcsQueue;
-#endif /* PIOS_INCLUDE_USB */
+		// The rest of the frame never arrived, pass on what we have.
+		if ((rx_bytes == 0) && (scan < p->header.data_size))
+		{
 			data->UAVTalkErrors++;
+			scan = p->header.data_size;
+			frame_length = 0;
+		}
 
-			// Send a NACK if required.
-			if((iproc->obj) && (iproc->type == UAVTALK_TYPE_OBJ_ACK))
+		// Send the packet once the frames in it are complete, or when it fills up
+		// or the com port goes quiet in the middle of a large frame.
+		if (p->header.data_size == 0)
+			continue;
+		if (scan == p->header.data_size)
+		{
+			if ((frame_length == 0) || (rx_bytes == 0) || (p->header.data_size == PH_MAX_DATA))
 			{
-				// Queue up a NACK
-				queueEvent(params->recvQueue, iproc->obj, iproc->instId, EV_SEND_NACK);
-
-				// Release the packet and start over again.
-				PHReleaseTXPacket(pios_packet_handler, p);
+				p = forwardPacket(params, p, scan);
+				scan = 0;
 			}
+		}
+		else if (p->header.data_size == PH_MAX_DATA)
+		{
+			// Only the start of a header is left at the end.
+			p = forwardPacket(params, p, scan);
+			scan = 0;
+		}
+	}
+}
+
+/**
+ * Handle a UAVTalk frame for one of our own objects.
+ * \param[in] params The comm parameters.
+ * \param[in] frame The frame
+ * \param[in] length The length of the frame
+ * \return true The frame should be passed on to the other side
+ * \return false The frame has been consumed
+ */
+static bool receiveLocalFrame(UAVTalkComTaskParams *params, uint8_t *frame, uint16_t length)
+{
+	UAVTalkConnectionData *connection = (UAVTalkConnectionData*)(params->UAVTalkCon);
+	UAVTalkInputProcessor *iproc = &(connection->iproc);
+	UAVTalkRxState state = UAVTALK_STATE_SYNC;
+
+	// Parse the frame from a clean state.
+	iproc->state = UAVTALK_STATE_SYNC;
+	for (uint16_t i = 0; (i < length) && (state != UAVTALK_STATE_COMPLETE) && (state != UAVTALK_STATE_ERROR); ++i)
+		state = UAVTalkProcessInputStreamQuiet(params->UAVTalkCon, frame[i]);
+
+	if (state != UAVTALK_STATE_COMPLETE)
+	{
+		data->UAVTalkErrors++;
+
+		// Send a NACK if required.
+		if((iproc->obj) && (iproc->type == UAVTALK_TYPE_OBJ_ACK))
+		{
+			// Queue up a NACK
+			queueEvent(params->recvQueue, iproc->obj, iproc->instId, EV_SEND_NACK);
+			return false;
+		}
+
+		// Transmit the frame anyway...
+		return true;
+	}
+
+	if (iproc->obj == NULL)
+		return true;
+
+	// We treat the ObjectPersistence object differently
+	if(iproc->objId == OBJECTPERSISTENCE_OBJID)
+	{
+		// Unpack object, if the instance does not exist it will be created!
+		UAVObjUnpack(iproc->obj, iproc->instId, connection->rxBuffer);
+
+		// Get the ObjectPersistence object.
+		ObjectPersistenceData obj_per;
+		ObjectPersistenceGet(&obj_per);
+
+		// Is this concerning or setting object?
+		if (obj_per.ObjectID != PIPXSETTINGS_OBJID)
+			// Otherwise, pass the frame on.
+			return true;
+
+		// Queue up the ACK.
+		queueEvent(params->recvQueue, (void*)iproc->obj, iproc->instId, EV_SEND_ACK);
+
+		// Is this a save, load, or delete?
+		bool success = true;
+		switch (obj_per.Operation)
+		{
+		case OBJECTPERSISTENCE_OPERATION_LOAD:
+		{
+#if defined(PIOS_INCLUDE_FLASH_EEPROM)
+			// Load the settings.
+			PipXSettingsData pipxSettings;
+			if (PIOS_EEPROM_Load((uint8_t*)&pipxSettings, sizeof(PipXSettingsData)) == 0)
+				PipXSettingsSet(&pipxSettings);
 			else
-			{
-				// Transmit the packet anyway...
-				queueEvent(sendQueue, (void*)p, 0, EV_TRANSMIT_PACKET);
-			}
-			p = NULL;
+				success = false;
+#endif
+			break;
 		}
+		case OBJECTPERSISTENCE_OPERATION_SAVE:
+		{
+#if defined(PIOS_INCLUDE_FLASH_EEPROM)
+			// Save the settings.
+			PipXSettingsData pipxSettings;
+			PipXSettingsGet(&pipxSettings);
+			int32_t ret = PIOS_EEPROM_Save((uint8_t*)&pipxSettings, sizeof(PipXSettingsData));
+			if (ret != 0)
+				success = false;
+#endif
+			break;
+		}
+		case OBJECTPERSISTENCE_OPERATION_DELETE:
+		{
+#if defined(PIOS_INCLUDE_FLASH_EEPROM)
+			// Erase the settings.
+			PipXSettingsData pipxSettings;
+			uint8_t *ptr = (uint8_t*)&pipxSettings;
+			memset(ptr, 0, sizeof(PipXSettingsData));
+			int32_t ret = PIOS_EEPROM_Save(ptr, sizeof(PipXSettingsData));
+			if (ret != 0)
+				success = false;
+#endif
+			break;
+		}
+		default:
+			break;
+		}
+		if (success == true)
+		{
+			obj_per.Operation = OBJECTPERSISTENCE_OPERATION_COMPLETED;
+			ObjectPersistenceSet(&obj_per);
+		}
+		return false;
+	}
+
+	switch (iproc->type)
+	{
+	case UAVTALK_TYPE_OBJ:
+		// Unpack object, if the instance does not exist it will be created!
+		UAVObjUnpack(iproc->obj, iproc->instId, connection->rxBuffer);
+		break;
+	case UAVTALK_TYPE_OBJ_REQ:
+		// Queue up an object send request.
+		queueEvent(params->recvQueue, (void*)iproc->obj, iproc->instId, EV_UPDATE_REQ);
+		break;
+	case UAVTALK_TYPE_OBJ_ACK:
+		if (UAVObjUnpack(iproc->obj, iproc->instId, connection->rxBuffer) == 0)
+			// Queue up an ACK
+			queueEvent(params->recvQueue, (void*)iproc->obj, iproc->instId, EV_SEND_ACK);
+		break;
 	}
+	return false;
+}
+
+/**
+ * Get a packet to forward com data in.
+ * \return The packet, NULL if none are available
+ */
+static PHPacketHandle getForwardPacket()
+{
+	PHPacketHandle p = PHGetTXPacket(pios_packet_handler);
+	if (p == NULL)
+		return NULL;
+
+	// Initialize the packet.
+	p->header.destination_id = data->destination_id;
+	p->header.source_id = PIOS_RFM22B_DeviceID(pios_rfm22b_id);
+	p->header.type = PACKET_TYPE_ACKED_DATA;
+	p->header.data_size = 0;
+	return p;
+}
+
+/**
+ * Queue the start of a packet for transmission and move the rest into a new packet.
+ * The packet itself is handed over, only a partial frame at the end gets copied.
+ * \param[in] params The comm parameters.
+ * \param[in] p The packet
+ * \param[in] length The number of bytes to send
+ * \return The packet holding the rest of the data, NULL if there was nothing left
+ */
+static PHPacketHandle forwardPacket(UAVTalkComTaskParams *params, PHPacketHandle p, uint16_t length)
+{
+	PHPacketHandle next = NULL;
+	uint16_t rest = p->header.data_size - length;
+
+	if (length == 0)
+		return p;
+
+	if (rest > 0)
+	{
+		while ((next = getForwardPacket()) == NULL)
+			vTaskDelay(5);
+		memcpy(next->data, p->data + length, rest);
+		next->header.data_size = rest;
+	}
+
+	xQueueHandle sendQueue = params->sendQueue;
+#if defined(PIOS_INCLUDE_USB)
+	if (params->gcsQueue)
+		if (PIOS_USB_CheckAvailable(0) && PIOS_COM_USB_HID)
+			sendQueue = params->gcsQueue;
+#endif /* PIOS_INCLUDE_USB */
+
+	// Queue the packet for transmission.
+	p->header.data_size = length;
+	queueEvent(sendQueue, (void*)p, 0, EV_TRANSMIT_PACKET);
+
+	return next;
 }
 
 /**
@@ -609,12 +710,15 @@ static void sendPacketTask(void *parameters)
 		//PIOS_WDG_UpdateFlag(PIOS_WDG_SENDPACKET);
 #endif /* PIOS_INCLUDE_WDG */
 		// Wait for a packet on the queue.
-		if (xQueueReceive(data->radioPacketQueue, &ev, MAX_PORT_DELAY) == pdTRUE) {
+		if (xQueueReceive(data->radioPacketQueue, &ev, ARQ_POLL_PERIOD_MS / portTICK_RATE_MS) == pdTRUE) {
 			PHPacketHandle p = (PHPacketHandle)ev.obj;
 			// Send the packet.
 			if(!PHTransmitPacket(pios_packet_handler, p))
-				PHReleaseRXPacket(pios_packet_handler, p);
+				PHReleaseTXPacket(pios_packet_handler, p);
 		}
+
+		// Send retransmissions and ACKs that are due.
+		PHTransmitPending(pios_packet_handler);
 	}
 }
 
@@ -722,8 +826,7 @@ static void transparentCommTask(void * parameters)
 			// Initialize the packet.
 			p->header.destination_id = data->destination_id;
 			p->header.source_id = PIOS_RFM22B_DeviceID(pios_rfm22b_id);
-			//p->header.type = PACKET_TYPE_ACKED_DATA;
-			p->header.type = PACKET_TYPE_DATA;
+			p->header.type = PACKET_TYPE_ACKED_DATA;
 			p->header.data_size = 0;
 		}
 
@@ -799,6 +902,11 @@ static void radioStatusTask(void *parameters)
 		data->rxBytes = 0;
 		pipxStatus.LinkState = PIPXSTATUS_LINKSTATE_DISCONNECTED;
 		pipxStatus.RSSI = data->RSSI;
+		struct pios_rfm22b_stats radioStats;
+		PIOS_RFM22B_GetStats(pios_rfm22b_id, &radioStats);
+		pipxStatus.TXPacketTime = radioStats.tx_time_us;
+		pipxStatus.RXPacketTime = radioStats.rx_time_us;
+		pipxStatus.IRQTime = radioStats.irq_time_us;
 		LINK_LED_OFF;
 
 		// Update the potential pairing contacts
@@ -1074,46 +1182,6 @@ static void PPMHandler(uint16_t *channels)
 	GCSReceiverSet(&rcvr);
 }
 
-static BufferedReadHandle BufferedReadInit(uint32_t com_port, uint16_t buffer_length)
-{
-	BufferedReadHandle h = (BufferedReadHandle)pvPortMalloc(sizeof(ReadBuffer));
-	if (!h)
-		return NULL;
-
-	h->com_port = com_port;
-	h->buffer = (uint8_t*)pvPortMalloc(buffer_length);
-	h->length = buffer_length;
-	h->index = 0;
-	h->data_length = 0;
-
-	if (h->buffer == NULL)
-		return NULL;
-
-	return h;
-}
-
-static bool BufferedRead(BufferedReadHandle h, uint8_t *value, uint32_t timeout_ms)
-{
-	// Read some data if required.
-	if(h->index == h->data_length)
-	{
-		uint32_t rx_bytes = PIOS_COM_ReceiveBuffer(h->com_port, h->buffer, h->length, timeout_ms);
-		if (rx_bytes == 0)
-			return false;
-		h->index = 0;
-		h->data_length = rx_bytes;
-	}
-
-	// Return the next byte.
-	*value = h->buffer[h->index++];
-	return true;
-}
-
-static void BufferedReadSetCom(BufferedReadHandle h, uint32_t com_port)
-{
-	h->com_port = com_port;
-}
-
 /**
  * Queue and event into an event queue.
  * \param[in] queue  The event queue
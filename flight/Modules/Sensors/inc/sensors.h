@@ -32,6 +32,17 @@
 
 #include "openpilot.h"
 
+/**
+ * IMU sample passed directly from Sensors to Attitude, with the same
+ * scaling, rotation and bias correction as the Gyros and Accels objects
+ */
+struct sensors_imu_sample {
+	uint32_t time;		// PIOS_DELAY_GetRaw() when the sample was read
+	float gyros[3];		// deg/s
+	float accels[3];	// m/s^2
+};
+
 int32_t SensorsInitialize(void);
+uint32_t SensorsReadIMUSamples(struct sensors_imu_sample * samples, uint32_t max, uint32_t timeout_ms);
 
 #endif // SENSORS_H
@@ -48,6 +48,7 @@
 
 #include "pios.h"
 #include "attitude.h"
+#include "sensors.h"
 #include "magnetometer.h"
 #include "accels.h"
 #include "gyros.h"
@@ -61,11 +62,23 @@
 #include "CoordinateConversions.h"
 
 #include <pios_board_info.h>
+#include "eventtrace.h"
+
+#if defined(PIOS_FASTLOOP)
+#include "fastloop.h"
+#endif
 
 // Private constants
+#if defined(PIOS_FASTLOOP)
+// Also runs attitude, stabilization and actuator, with the stacks they had as tasks
+#define STACK_SIZE_BYTES (1540 + 5540 + 724 + 1312)
+#define TASK_PRIORITY (tskIDLE_PRIORITY+4)
+#else
 #define STACK_SIZE_BYTES 1540
 #define TASK_PRIORITY (tskIDLE_PRIORITY+3)
+#endif
 #define SENSOR_PERIOD 2
+#define IMU_RING_LENGTH 16
 
 #define F_PI 3.14159265358979323846f
 #define PI_MOD(x) (fmodf(x + F_PI, F_PI * 2) - F_PI)
@@ -76,10 +89,20 @@ static xTaskHandle sensorsTaskHandle;
 static bool gps_updated = false;
 static bool baro_updated = false;
 
+// Single producer, single consumer ring of IMU samples for the attitude
+// estimator. Only SensorsTask writes imu_ring_head and only the reader
+// writes imu_ring_tail, so no lock is needed.
+static struct sensors_imu_sample imu_ring[IMU_RING_LENGTH];
+static volatile uint8_t imu_ring_head;
+static volatile uint8_t imu_ring_tail;
+static xSemaphoreHandle imu_ring_sem;
+static uint32_t imu_ring_overruns;
+
 // Private functions
 static void SensorsTask(void *parameters);
 static void settingsUpdatedCb(UAVObjEvent * objEv);
 static void sensorsUpdatedCb(UAVObjEvent * objEv);
+static void imuRingPush(const GyrosData * gyros, const AccelsData * accels, uint32_t time);
 
 // These values are initialized by settings but can be updated by the attitude algorithm
 static bool bias_correct_gyro = true;
@@ -113,11 +136,20 @@ int32_t SensorsInitialize(void)
 	MagnetometerInitialize();
 	RevoCalibrationInitialize();
 	AttitudeSettingsInitialize();
+#if defined(PIOS_FASTLOOP)
+	FastLoopInitialize();
+#endif
 
 	rotate = 0;
 
-	RevoCalibrationConnectCallback(&settingsUpdatedCb);
-	AttitudeSettingsConnectCallback(&settingsUpdatedCb);
+	imu_ring_head = 0;
+	imu_ring_tail = 0;
+	vSemaphoreCreateBinary(imu_ring_sem);
+	xSemaphoreTake(imu_ring_sem, 0);
+
+	// Calibration changes must reach the sensor loop without waiting behind slow callbacks
+	RevoCalibrationConnectCallbackPriority(&settingsUpdatedCb, EVENT_PRIORITY_HIGH);
+	AttitudeSettingsConnectCallbackPriority(&settingsUpdatedCb, EVENT_PRIORITY_HIGH);
 
 	return 0;
 }
@@ -241,6 +273,9 @@ static void SensorsTask(void *parameters)
 
 		AccelsData accelsData;
 		GyrosData gyrosData;
+		uint32_t sample_time = timeval;
+
+		EVENT_TRACE(EVENTTRACE_SENSORS_START, 0);
 
 		switch(bdinfo->board_rev) {
 			case 0x01:  // L3GD20 + BMA180 board
@@ -287,6 +322,7 @@ static void SensorsTask(void *parameters)
 				}
 				
 				gyro_samples = 1;
+				sample_time = gyro.time;
 				gyro_accum[0] += gyro.gyro_x;
 				gyro_accum[1] += gyro.gyro_y;
 				gyro_accum[2] += gyro.gyro_z;
@@ -316,6 +352,7 @@ static void SensorsTask(void *parameters)
 
 					gyro_samples ++;
 					accel_samples ++;
+					sample_time = mpu6000_data.time;
 				}
 				
 				if (gyro_samples == 0) {
@@ -382,15 +419,22 @@ static void SensorsTask(void *parameters)
 			gyrosData.z += gyrosBias.z;
 		}
 		GyrosSet(&gyrosData);
+		imuRingPush(&gyrosData, &accelsData, sample_time);
+		EVENT_TRACE(EVENTTRACE_SENSORS_END, gyro_samples);
+#if defined(PIOS_FASTLOOP)
+		// Attitude, stabilization and actuator for this sample before anything else
+		FastLoopRun(sample_time);
+#endif
 		
 		// Because most crafts wont get enough information from gravity to zero yaw gyro, we try
 		// and make it average zero (weakly)
 
 #if defined(PIOS_INCLUDE_HMC5883)
+		// The mag is read on the I2C bus while the loop goes on, the values
+		// of the read queued on an earlier pass are collected here
 		MagnetometerData mag;
-		if (PIOS_HMC5883_NewDataAvailable() || PIOS_DELAY_DiffuS(mag_update_time) > 150000) {
-			int16_t values[3];
-			PIOS_HMC5883_ReadMag(values);
+		int16_t values[3];
+		if (PIOS_HMC5883_FinishReadMag(values) == 0) {
 			float mags[3] = {(float) values[1] * mag_scale[0] - mag_bias[0],
 			                (float) values[0] * mag_scale[1] - mag_bias[1],
 			                -(float) values[2] * mag_scale[2] - mag_bias[2]};
@@ -408,6 +452,8 @@ static void SensorsTask(void *parameters)
 			MagnetometerSet(&mag);
 			mag_update_time = PIOS_DELAY_GetRaw();
 		}
+		if (PIOS_HMC5883_NewDataAvailable() || PIOS_DELAY_DiffuS(mag_update_time) > 150000)
+			PIOS_HMC5883_StartReadMag();
 #endif
 
 		PIOS_WDG_UpdateFlag(PIOS_WDG_SENSORS);
@@ -425,6 +471,64 @@ static void SensorsTask(void *parameters)
 	}
 }
 
+/**
+ * Queue an IMU sample for the attitude estimator. When the reader has
+ * fallen a whole ring behind the new sample is dropped and counted.
+ */
+static void imuRingPush(const GyrosData * gyros, const AccelsData * accels, uint32_t time)
+{
+	uint8_t head = imu_ring_head;
+	uint8_t next = (head + 1) % IMU_RING_LENGTH;
+
+	if (next == imu_ring_tail) {
+		imu_ring_overruns++;
+		return;
+	}
+
+	imu_ring[head].time = time;
+	imu_ring[head].gyros[0] = gyros->x;
+	imu_ring[head].gyros[1] = gyros->y;
+	imu_ring[head].gyros[2] = gyros->z;
+	imu_ring[head].accels[0] = accels->x;
+	imu_ring[head].accels[1] = accels->y;
+	imu_ring[head].accels[2] = accels->z;
+
+	// The sample must be complete before the reader can see it
+	__asm__ volatile ("" ::: "memory");
+	imu_ring_head = next;
+
+	xSemaphoreGive(imu_ring_sem);
+}
+
+/**
+ * Copy out the IMU samples queued since the last call, oldest first
+ * \param[out] samples buffer for at least max samples
+ * \param[in] max maximum number of samples to copy
+ * \param[in] timeout_ms how long to wait when none are queued
+ * \returns the number of samples copied, 0 on timeout
+ */
+uint32_t SensorsReadIMUSamples(struct sensors_imu_sample * samples, uint32_t max, uint32_t timeout_ms)
+{
+	while (imu_ring_head == imu_ring_tail) {
+		if (xSemaphoreTake(imu_ring_sem, timeout_ms / portTICK_RATE_MS) != pdTRUE)
+			return 0;
+	}
+
+	uint8_t tail = imu_ring_tail;
+	uint8_t head = imu_ring_head;
+	uint32_t count = 0;
+	while (tail != head && count < max) {
+		samples[count++] = imu_ring[tail];
+		tail = (tail + 1) % IMU_RING_LENGTH;
+	}
+
+	// Done with the slots before handing them back to the writer
+	__asm__ volatile ("" ::: "memory");
+	imu_ring_tail = tail;
+
+	return count;
+}
+
 /**
  * Indicate that these sensors have been updated
  */
@@ -33,6 +33,7 @@
 #include "openpilot.h"
 #include "stabilization.h"
 #include "stabilizationsettings.h"
+#include "fast_math.h"
 
 //! Private variables
 static float vbar_integral[MAX_AXES];
@@ -93,8 +94,8 @@ int stabilization_virtual_flybar(float gyro, float command, float *output, float
 int stabilization_virtual_flybar_pirocomp(float z_gyro, float dT)
 {
 	const float F_PI = (float) M_PI;
-	float cy = cosf(z_gyro / 180.0f * F_PI * dT);
-	float sy = sinf(z_gyro / 180.0f * F_PI * dT);
+	float cy = fast_cosf(z_gyro / 180.0f * F_PI * dT);
+	float sy = fast_sinf(z_gyro / 180.0f * F_PI * dT);
 
 	float vbar_pitch = cy * vbar_integral[1] - sy * vbar_integral[0];
 	float vbar_roll = sy * vbar_integral[1] + cy * vbar_integral[0];
@@ -46,7 +46,9 @@
 #include "systemsettings.h"
 #include "i2cstats.h"
 #include "taskinfo.h"
+#include "cpuprofile.h"
 #include "watchdogstatus.h"
+#include "uavobjectstats.h"
 #include "taskmonitor.h"
 
 // Private constants
@@ -76,6 +78,12 @@ static xTaskHandle systemTaskHandle;
 static xQueueHandle objectPersistenceQueue;
 static bool stackOverflow;
 static bool mallocFailed;
+#if defined(UAVOBJ_DIAGNOSTICS)
+static UAVObjectStatsData objectStats;
+static uint32_t objectStatsUpdates[UAVOBJECTSTATS_OBJECTID_NUMELEM];
+static uint32_t objectStatsTotal;
+static portTickType objectStatsTime;
+#endif
 
 // Private functions
 static void objectUpdatedCb(UAVObjEvent * ev);
@@ -86,6 +94,10 @@ static void systemTask(void *parameters);
 static void updateI2Cstats();
 static void updateWDGstats();
 #endif
+#if defined(UAVOBJ_DIAGNOSTICS)
+static void updateObjectStats();
+static void collectObjectStats(UAVObjHandle obj);
+#endif
 /**
  * Create the module task.
  * \returns 0 on success or -1 if initialization failed
@@ -118,10 +130,16 @@ int32_t SystemModInitialize(void)
 #if defined(DIAG_TASKS)
 	TaskInfoInitialize();
 #endif
+#if defined(DIAG_PROFILE)
+	CPUProfileInitialize();
+#endif
 #if defined(I2C_WDG_STATS_DIAGNOSTICS)
 	I2CStatsInitialize();
 	WatchdogStatusInitialize();
 #endif
+#if defined(UAVOBJ_DIAGNOSTICS)
+	UAVObjectStatsInitialize();
+#endif
 
 	objectPersistenceQueue = xQueueCreate(1, sizeof(UAVObjEvent));
 	if (objectPersistenceQueue == NULL)
@@ -172,6 +190,9 @@ static void systemTask(void *parameters)
 		updateI2Cstats();
 		updateWDGstats();
 #endif
+#if defined(UAVOBJ_DIAGNOSTICS)
+		updateObjectStats();
+#endif
 
 #if defined(DIAG_TASKS)
 		// Update the task status object
@@ -195,6 +216,15 @@ static void systemTask(void *parameters)
 		FlightStatusData flightStatus;
 		FlightStatusGet(&flightStatus);
 
+#if defined(PIOS_INCLUDE_FLASH_LOGFS_SETTINGS)
+		// Reclaim settings flash while a sector erase can not hold up flying
+		if (flightStatus.Armed == FLIGHTSTATUS_ARMED_DISARMED)
+			PIOS_FLASHFS_GarbageCollect();
+#elif defined(PIOS_INCLUDE_FLASH_COMPACT_SETTINGS)
+		if (flightStatus.Armed == FLIGHTSTATUS_ARMED_DISARMED)
+			PIOS_FLASHFS_Compact_GarbageCollect();
+#endif
+
 		UAVObjEvent ev;
 		int delayTime = flightStatus.Armed == FLIGHTSTATUS_ARMED_ARMED ?
 			SYSTEM_UPDATE_PERIOD_MS / portTICK_RATE_MS / (LED_BLINK_RATE_HZ * 2) :
@@ -279,7 +309,7 @@ static void objectUpdatedCb(UAVObjEvent * ev)
 			}
 		} else if (objper.Operation == OBJECTPERSISTENCE_OPERATION_FULLERASE) {
 			retval = -1;
-#if defined(PIOS_INCLUDE_FLASH_SECTOR_SETTINGS)
+#if defined(PIOS_INCLUDE_FLASH_SECTOR_SETTINGS) || defined(PIOS_INCLUDE_FLASH_LOGFS_SETTINGS)
 			retval = PIOS_FLASHFS_Format();
 #elif defined(PIOS_INCLUDE_FLASH_COMPACT_SETTINGS)
 			retval = PIOS_FLASHFS_Compact_Format();
@@ -333,6 +363,63 @@ static void updateWDGstats()
 }
 #endif
 
+#if defined(UAVOBJ_DIAGNOSTICS)
+/**
+ * Called periodically to publish the busiest objects since the last call
+ */
+static void updateObjectStats()
+{
+	portTickType now = xTaskGetTickCount();
+	uint32_t elapsedMs = (now - objectStatsTime) * portTICK_RATE_MS;
+	objectStatsTime = now;
+
+	memset(&objectStats, 0, sizeof(objectStats));
+	memset(objectStatsUpdates, 0, sizeof(objectStatsUpdates));
+	objectStatsTotal = 0;
+	UAVObjIterate(&collectObjectStats);
+
+	if (elapsedMs == 0) {
+		return;
+	}
+	for (uint8_t n = 0; n < UAVOBJECTSTATS_OBJECTID_NUMELEM; ++n) {
+		objectStats.UpdateRate[n] = (objectStatsUpdates[n] * 1000) / elapsedMs;
+	}
+	objectStats.TotalUpdateRate = (objectStatsTotal * 1000) / elapsedMs;
+	UAVObjectStatsSet(&objectStats);
+}
+
+/**
+ * Read and restart the statistics of an object, keeping the busiest ones sorted by update count
+ */
+static void collectObjectStats(UAVObjHandle obj)
+{
+	UAVObjDiagnostics diag;
+	UAVObjGetDiagnostics(obj, &diag, true);
+	objectStatsTotal += diag.updates;
+
+	// Find the slot of the object, nothing to do if it is not among the busiest
+	uint8_t slot = UAVOBJECTSTATS_OBJECTID_NUMELEM;
+	while (slot > 0 && diag.updates > objectStatsUpdates[slot - 1]) {
+		--slot;
+	}
+	if (slot == UAVOBJECTSTATS_OBJECTID_NUMELEM) {
+		return;
+	}
+
+	// Move the less busy objects down
+	for (uint8_t n = UAVOBJECTSTATS_OBJECTID_NUMELEM - 1; n > slot; --n) {
+		objectStatsUpdates[n] = objectStatsUpdates[n - 1];
+		objectStats.ObjectID[n] = objectStats.ObjectID[n - 1];
+		objectStats.CallbackTimeMax[n] = objectStats.CallbackTimeMax[n - 1];
+		objectStats.QueueHighWater[n] = objectStats.QueueHighWater[n - 1];
+	}
+	objectStatsUpdates[slot] = diag.updates;
+	objectStats.ObjectID[slot] = UAVObjGetID(obj);
+	objectStats.CallbackTimeMax[slot] = (diag.callbackTimeMax > 0xFFFF) ? 0xFFFF : diag.callbackTimeMax;
+	objectStats.QueueHighWater[slot] = diag.queueHighWater;
+}
+#endif
+
 
 /**
  * Called periodically to update the system stats
@@ -470,7 +557,10 @@ static void updateSystemAlarms()
 	EventGetStats(&evStats);
 	UAVObjClearStats();
 	EventClearStats();
-	if (objStats.eventCallbackErrors > 0 || objStats.eventQueueErrors > 0  || evStats.eventErrors > 0) {
+	if (evStats.periodicOverflows > 0) {
+		// Some periodic updates were never scheduled
+		AlarmsSet(SYSTEMALARMS_ALARM_EVENTSYSTEM, SYSTEMALARMS_ALARM_ERROR);
+	} else if (objStats.eventCallbackErrors > 0 || objStats.eventQueueErrors > 0  || evStats.eventErrors > 0) {
 		AlarmsSet(SYSTEMALARMS_ALARM_EVENTSYSTEM, SYSTEMALARMS_ALARM_WARNING);
 	} else {
 		AlarmsClear(SYSTEMALARMS_ALARM_EVENTSYSTEM);
@@ -499,6 +589,9 @@ void vApplicationIdleHook(void)
 		idleCounter = 0;
 		idleCounterClear = 0;
 	}
+#if defined(DIAG_PROFILE)
+	TaskMonitorIdleHook();
+#endif
 }
 
 /**
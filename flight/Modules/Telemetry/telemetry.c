@@ -34,7 +34,15 @@
 #include "telemetry.h"
 #include "flighttelemetrystats.h"
 #include "gcstelemetrystats.h"
+#include "flighttelemetrycapabilities.h"
+#include "gcstelemetrycapabilities.h"
+#include "flighttelemetrybudget.h"
+#include "telemetryping.h"
 #include "hwsettings.h"
+#include "eventtrace.h"
+#if defined(DIAG_TRACE)
+#include "tracerecords.h"
+#endif
 
 // Private constants
 #define MAX_QUEUE_SIZE   TELEM_QUEUE_SIZE
@@ -46,15 +54,51 @@
 #define MAX_RETRIES 2
 #define STATS_UPDATE_PERIOD_MS 4000
 #define CONNECTION_TIMEOUT_MS 8000
+#define RX_BUFFER_SIZE 32
+// Link budget, the bucket holds this much link time and this percentage of it is
+// kept for acked, settings and on change updates
+#define TX_BUDGET_BURST_MS 250
+#define TX_BUDGET_RESERVE_PERCENT 25
+// Periodic updates only carry their changed fields, with the full object about
+// once in this period so the GCS recovers from lost packets
+#define DELTA_KEYFRAME_MS 2000
+#if defined(DIAG_TRACE)
+// The event trace is sent when nothing else is waiting, a partly filled
+// packet goes out after this long
+#define TRACE_DRAIN_PERIOD_MS 20
+// Sending the trace records must not trace records of its own, they would
+// keep the trace busy with nothing but itself
+#define TELEMETRY_TX_TRACE(event, obj) do { if ((obj) != TraceRecordsHandle()) EVENT_TRACE((event), UAVObjGetID(obj)); } while (0)
+#else
+#define TELEMETRY_TX_TRACE(event, obj)
+#endif
 
 // Private types
 
+// Send slot, at most one pending entry per object instance and event. The tasks
+// drain their queue into the slots and send the most urgent entry first.
+typedef struct {
+	UAVObjHandle obj;
+	uint16_t instId;
+	uint8_t event;
+	uint8_t priority;	// EventPriority, see slotPriority()
+	uint32_t deadline;
+} TelemetrySlot;
+
+typedef struct {
+	TelemetrySlot slot[MAX_QUEUE_SIZE];
+	uint8_t count;
+} TelemetrySlots;
+
 // Private variables
 static uint32_t telemetryPort;
+static uint32_t reservedPort;
 static xQueueHandle queue;
+static TelemetrySlots slots;
 
 #if defined(PIOS_TELEM_PRIORITY_QUEUE)
 static xQueueHandle priorityQueue;
+static TelemetrySlots prioritySlots;
 static xTaskHandle telemetryTxPriTaskHandle;
 static void telemetryTxPriTask(void *parameters);
 #else
@@ -67,18 +111,41 @@ static uint32_t txErrors;
 static uint32_t txRetries;
 static uint32_t timeOfLastObjectUpdate;
 static UAVTalkConnection uavTalkCon;
+static xQueueHandle pingQueue;
+static uint8_t aggregateUpdates;
+static uint8_t deltaUpdates;
+static uint32_t txBudgetRate;	// link capacity in bytes/s, 0 if not limited
+static int32_t txBudgetTokens;	// in 1/1000 bytes
+static uint32_t txBudgetTime;
+static uint32_t txSkipped;
 
 // Private functions
 static void telemetryTxTask(void *parameters);
 static void telemetryRxTask(void *parameters);
+static uint32_t getOutputPort(void);
 static int32_t transmitData(uint8_t * data, int32_t length);
+static int32_t reserveData(uint8_t ** data, int32_t length);
+static int32_t commitData(int32_t length);
 static void registerObject(UAVObjHandle obj);
 static void updateObject(UAVObjHandle obj, int32_t eventType);
 static int32_t addObject(UAVObjHandle obj);
 static int32_t setUpdatePeriod(UAVObjHandle obj, int32_t updatePeriodMs);
+static bool txBudgetAccept(UAVObjEvent * ev, UAVObjMetadata * metadata);
+static void txBudgetRefill(void);
+static int32_t txBudgetSize(UAVObjEvent * ev);
+#if defined(DIAG_TRACE)
+static bool txBudgetSpare(UAVObjEvent * ev);
+static void traceDrain(bool timeout);
+#endif
+static bool deltaKeyframe(UAVObjMetadata * metadata);
+static bool slotsReceive(TelemetrySlots * slots, xQueueHandle queue, UAVObjEvent * ev);
+static void slotsInsert(TelemetrySlots * slots, UAVObjEvent * ev);
+static uint8_t slotPriority(UAVObjEvent * ev, uint32_t * periodMs);
+static bool slotBefore(uint8_t priority, uint32_t deadline, TelemetrySlot * slot);
 static void processObjEvent(UAVObjEvent * ev);
 static void updateTelemetryStats();
 static void gcsTelemetryStatsUpdated();
+static void pingReceived(uint32_t rxTime);
 static void updateSettings();
 
 /**
@@ -117,6 +184,19 @@ int32_t TelemetryInitialize(void)
 {
 	FlightTelemetryStatsInitialize();
 	GCSTelemetryStatsInitialize();
+	FlightTelemetryCapabilitiesInitialize();
+	GCSTelemetryCapabilitiesInitialize();
+	FlightTelemetryBudgetInitialize();
+	TelemetryPingInitialize();
+
+	// Advertise the UAVTalk extensions we decode
+	FlightTelemetryCapabilitiesData flightCaps;
+	flightCaps.Capabilities = UAVTALK_CAPABILITIES;
+	FlightTelemetryCapabilitiesSet(&flightCaps);
+
+	// Pings from the GCS are sent back by the receive task
+	pingQueue = xQueueCreate(1, sizeof(UAVObjEvent));
+	UAVObjConnectQueue(TelemetryPingHandle(), pingQueue, EV_UNPACKED);
 
 	// Initialize vars
 	timeOfLastObjectUpdate = 0;
@@ -133,7 +213,7 @@ int32_t TelemetryInitialize(void)
 	updateSettings();
     
 	// Initialise UAVTalk
-	uavTalkCon = UAVTalkInitialize(&transmitData);
+	uavTalkCon = UAVTalkInitializeReserve(&transmitData, &reserveData, &commitData);
     
 	// Create periodic event that will be used to update the telemetry stats
 	txErrors = 0;
@@ -142,6 +222,11 @@ int32_t TelemetryInitialize(void)
 	memset(&ev, 0, sizeof(UAVObjEvent));
 	EventPeriodicQueueCreate(&ev, priorityQueue, STATS_UPDATE_PERIOD_MS);
 
+#if defined(DIAG_TRACE)
+	TraceRecordsInitialize();
+	EventTraceInitialize();
+#endif
+
 	return 0;
 }
 
@@ -184,7 +269,7 @@ static void updateObject(UAVObjHandle obj, int32_t eventType)
 		if (UAVObjIsMetaobject(obj)) {
 			eventMask |= EV_UNPACKED;	// we also need to act on remote updates (unpack events)
 		}
-		UAVObjConnectQueue(obj, priorityQueue, eventMask);
+		UAVObjConnectQueueCoalesced(obj, priorityQueue, eventMask);
 	} else if (updateMode == UPDATEMODE_ONCHANGE) {
 		// Set update period
 		setUpdatePeriod(obj, 0);
@@ -193,7 +278,7 @@ static void updateObject(UAVObjHandle obj, int32_t eventType)
 		if (UAVObjIsMetaobject(obj)) {
 			eventMask |= EV_UNPACKED;	// we also need to act on remote updates (unpack events)
 		}
-		UAVObjConnectQueue(obj, priorityQueue, eventMask);
+		UAVObjConnectQueueCoalesced(obj, priorityQueue, eventMask);
 	} else if (updateMode == UPDATEMODE_THROTTLED) {
 		if ((eventType == EV_UPDATED_PERIODIC) || (eventType == EV_NONE)) {
 			// If we received a periodic update, we can change back to update on change
@@ -208,7 +293,7 @@ static void updateObject(UAVObjHandle obj, int32_t eventType)
 		if (UAVObjIsMetaobject(obj)) {
 			eventMask |= EV_UNPACKED;	// we also need to act on remote updates (unpack events)
 		}
-		UAVObjConnectQueue(obj, priorityQueue, eventMask);
+		UAVObjConnectQueueCoalesced(obj, priorityQueue, eventMask);
 	} else if (updateMode == UPDATEMODE_MANUAL) {
 		// Set update period
 		setUpdatePeriod(obj, 0);
@@ -217,7 +302,7 @@ static void updateObject(UAVObjHandle obj, int32_t eventType)
 		if (UAVObjIsMetaobject(obj)) {
 			eventMask |= EV_UNPACKED;	// we also need to act on remote updates (unpack events)
 		}
-		UAVObjConnectQueue(obj, priorityQueue, eventMask);
+		UAVObjConnectQueueCoalesced(obj, priorityQueue, eventMask);
 	}
 }
 
@@ -237,27 +322,41 @@ static void processObjEvent(UAVObjEvent * ev)
 	} else if (ev->obj == GCSTelemetryStatsHandle()) {
 		gcsTelemetryStatsUpdated();
 	} else {
-		// Only process event if connected to GCS or if object FlightTelemetryStats is updated
+		// Only process event if connected to GCS or if the handshake objects are updated
 		FlightTelemetryStatsGet(&flightStats);
 		// Get object metadata
 		UAVObjGetMetadata(ev->obj, &metadata);
 		updateMode = UAVObjGetTelemetryUpdateMode(&metadata);
-		if (flightStats.Status == FLIGHTTELEMETRYSTATS_STATUS_CONNECTED || ev->obj == FlightTelemetryStatsHandle()) {
+		if (flightStats.Status == FLIGHTTELEMETRYSTATS_STATUS_CONNECTED || ev->obj == FlightTelemetryStatsHandle() ||
+				ev->obj == FlightTelemetryCapabilitiesHandle()) {
 			// Act on event
 			retries = 0;
 			success = -1;
-			if (ev->event == EV_UPDATED || ev->event == EV_UPDATED_MANUAL || ((ev->event == EV_UPDATED_PERIODIC) && (updateMode != UPDATEMODE_THROTTLED))) {
+			if ((ev->event == EV_UPDATED || ev->event == EV_UPDATED_MANUAL || ((ev->event == EV_UPDATED_PERIODIC) && (updateMode != UPDATEMODE_THROTTLED))) &&
+					txBudgetAccept(ev, &metadata)) {
+				TELEMETRY_TX_TRACE(EVENTTRACE_TELEMETRY_TX_START, ev->obj);
+				// Unacked periodic updates only send the changed fields if the GCS supports it
+				if (deltaUpdates && ev->event == EV_UPDATED_PERIODIC && !UAVObjGetTelemetryAcked(&metadata)) {
+					success = UAVTalkSendObjectDelta(uavTalkCon, ev->obj, ev->instId, deltaKeyframe(&metadata), aggregateUpdates);
+					++retries;
+				}
+				// Unacked updates are batched into multi-object frames if the GCS supports them
+				else if (aggregateUpdates && !UAVObjGetTelemetryAcked(&metadata)) {
+					success = UAVTalkSendObjectAggregated(uavTalkCon, ev->obj, ev->instId);
+					++retries;
+				}
 				// Send update to GCS (with retries)
 				while (retries < MAX_RETRIES && success == -1) {
 					success = UAVTalkSendObject(uavTalkCon, ev->obj, ev->instId, UAVObjGetTelemetryAcked(&metadata), REQ_TIMEOUT_MS);	// call blocks until ack is received or timeout
 					++retries;
 				}
+				TELEMETRY_TX_TRACE(EVENTTRACE_TELEMETRY_TX_END, ev->obj);
 				// Update stats
 				txRetries += (retries - 1);
 				if (success == -1) {
 					++txErrors;
 				}
-			} else if (ev->event == EV_UPDATE_REQ) {
+			} else if (ev->event == EV_UPDATE_REQ && txBudgetAccept(ev, &metadata)) {
 				// Request object update from GCS (with retries)
 				while (retries < MAX_RETRIES && success == -1) {
 					success = UAVTalkSendObjectRequest(uavTalkCon, ev->obj, ev->instId, REQ_TIMEOUT_MS);	// call blocks until update is received or timeout
@@ -281,6 +380,154 @@ static void processObjEvent(UAVObjEvent * ev)
 	}
 }
 
+/**
+ * Charge the packets of an event against the link budget (a token bucket
+ * refilled at the link rate). Periodic updates of unacked data objects are
+ * low priority and are skipped while the bucket is down to the reserve, the
+ * next period sends fresh data anyway. This lowers their effective rate, the
+ * fastest ones the most, until the link keeps up. Everything else is always
+ * sent and may overdraw the bucket.
+ * \param[in] ev The event to be sent
+ * \param[in] metadata Metadata of the event's object
+ * \return true if the event should be sent
+ */
+static bool txBudgetAccept(UAVObjEvent * ev, UAVObjMetadata * metadata)
+{
+	// USB is not limited by the serial link
+	if (txBudgetRate == 0 || getOutputPort() != telemetryPort) {
+		return true;
+	}
+
+	int32_t burst = txBudgetRate * TX_BUDGET_BURST_MS;
+	int32_t size = txBudgetSize(ev);
+	txBudgetRefill();
+
+	if (ev->event == EV_UPDATED_PERIODIC && !UAVObjGetTelemetryAcked(metadata) &&
+			!UAVObjIsSettings(ev->obj) && !UAVObjIsMetaobject(ev->obj) && ev->obj != FlightTelemetryStatsHandle()) {
+		if (txBudgetTokens - size < burst / 100 * TX_BUDGET_RESERVE_PERCENT) {
+			++txSkipped;
+			return false;
+		}
+	}
+
+	txBudgetTokens -= size;
+	if (txBudgetTokens < -burst) {
+		txBudgetTokens = -burst;
+	}
+	return true;
+}
+
+/**
+ * Refill the link budget for the time since the last packet
+ */
+static void txBudgetRefill(void)
+{
+	int32_t burst = txBudgetRate * TX_BUDGET_BURST_MS;
+	uint32_t timeNow = xTaskGetTickCount() * portTICK_RATE_MS;
+	uint32_t elapsed = timeNow - txBudgetTime;
+	txBudgetTime = timeNow;
+	if (elapsed > TX_BUDGET_BURST_MS) {
+		elapsed = TX_BUDGET_BURST_MS;
+	}
+	txBudgetTokens += elapsed * txBudgetRate;
+	if (txBudgetTokens > burst) {
+		txBudgetTokens = burst;
+	}
+}
+
+/**
+ * Size of the packets of an event, header and checksum included
+ * \return the size in 1/1000 bytes
+ */
+static int32_t txBudgetSize(UAVObjEvent * ev)
+{
+	int32_t size = UAVObjIsSingleInstance(ev->obj) ? 9 : 11;
+	if (ev->event != EV_UPDATE_REQ) {
+		size += UAVObjGetNumBytes(ev->obj);
+		if (ev->instId == UAVOBJ_ALL_INSTANCES) {
+			size *= UAVObjGetNumInstances(ev->obj);
+		}
+	}
+	return size * 1000;
+}
+
+#if defined(DIAG_TRACE)
+/**
+ * Check if an event fits in the link time left above the reserve, without
+ * charging it. The event is charged when it is sent.
+ * \param[in] ev The event to be sent
+ * \return true if there is time for it
+ */
+static bool txBudgetSpare(UAVObjEvent * ev)
+{
+	// USB is not limited by the serial link
+	if (txBudgetRate == 0 || getOutputPort() != telemetryPort) {
+		return true;
+	}
+
+	int32_t burst = txBudgetRate * TX_BUDGET_BURST_MS;
+	txBudgetRefill();
+	return txBudgetTokens - txBudgetSize(ev) >= burst / 100 * TX_BUDGET_RESERVE_PERCENT;
+}
+
+/**
+ * Send the next event trace records if the link has spare time. Waits for a
+ * full packet unless the transmit queue timed out.
+ * \param[in] timeout true if nothing was sent for TRACE_DRAIN_PERIOD_MS
+ */
+static void traceDrain(bool timeout)
+{
+	struct eventtrace_record records[TRACERECORDS_TIMESTAMP_NUMELEM];
+	TraceRecordsData data;
+	UAVObjEvent ev;
+	uint32_t sequence;
+	uint32_t lost;
+	uint16_t pending = EventTracePending();
+
+	if (pending == 0 || (pending < TRACERECORDS_TIMESTAMP_NUMELEM && !timeout)) {
+		return;
+	}
+
+	ev.obj = TraceRecordsHandle();
+	ev.instId = 0;
+	ev.event = EV_UPDATED;
+	if (!txBudgetSpare(&ev)) {
+		return;
+	}
+
+	memset(&data, 0, sizeof(data));
+	data.Count = EventTraceRead(records, TRACERECORDS_TIMESTAMP_NUMELEM, &sequence, &lost);
+	data.Sequence = sequence;
+	data.Lost = (lost < UINT16_MAX) ? lost : UINT16_MAX;
+	for (uint8_t n = 0; n < data.Count; ++n) {
+		data.Timestamp[n] = records[n].timestamp;
+		data.Event[n] = records[n].event;
+		data.Arg[n] = records[n].arg;
+	}
+
+	// Sent as an on change update, the event lands in the queue
+	if (data.Count > 0 || data.Lost > 0) {
+		TraceRecordsSet(&data);
+	}
+}
+#endif
+
+/**
+ * Decide if a periodic update sends the full object. That is the one update
+ * of each object which crosses into a new keyframe period, so no per object
+ * state is needed.
+ * \param[in] metadata Metadata of the object to be sent
+ * \return true for a keyframe
+ */
+static bool deltaKeyframe(UAVObjMetadata * metadata)
+{
+	uint32_t period = metadata->telemetryUpdatePeriod;
+	uint32_t timeNow = xTaskGetTickCount() * portTICK_RATE_MS;
+
+	return period >= DELTA_KEYFRAME_MS ||
+		(timeNow / DELTA_KEYFRAME_MS) != ((timeNow - period) / DELTA_KEYFRAME_MS);
+}
+
 /**
  * Telemetry transmit task, regular priority
  */
@@ -290,11 +537,22 @@ static void telemetryTxTask(void *parameters)
 
 	// Loop forever
 	while (1) {
-		// Wait for queue message
-		if (xQueueReceive(queue, &ev, portMAX_DELAY) == pdTRUE) {
+		// Wait for the next update to send
+		bool received = slotsReceive(&slots, queue, &ev);
+		if (received) {
 			// Process event
 			processObjEvent(&ev);
+			// Send any batched updates once everything pending is out
+			if (slots.count == 0 && uxQueueMessagesWaiting(queue) == 0) {
+				UAVTalkFlushAggregated(uavTalkCon);
+			}
+		}
+#if defined(DIAG_TRACE)
+		// Spare link time goes to the event trace
+		if (slots.count == 0 && uxQueueMessagesWaiting(queue) == 0) {
+			traceDrain(!received);
 		}
+#endif
 	}
 }
 
@@ -308,21 +566,152 @@ static void telemetryTxPriTask(void *parameters)
 
 	// Loop forever
 	while (1) {
-		// Wait for queue message
-		if (xQueueReceive(priorityQueue, &ev, portMAX_DELAY) == pdTRUE) {
+		// Wait for the next update to send
+		if (slotsReceive(&prioritySlots, priorityQueue, &ev)) {
 			// Process event
 			processObjEvent(&ev);
+			// Send any batched updates once everything pending is out
+			if (prioritySlots.count == 0 && uxQueueMessagesWaiting(priorityQueue) == 0) {
+				UAVTalkFlushAggregated(uavTalkCon);
+			}
 		}
 	}
 }
 #endif
 
+/**
+ * Take everything waiting in a queue into the send slots, then hand out the
+ * most urgent slot. Only blocks on the queue while no slot is pending.
+ * \param[in] slots Send slots of the calling task
+ * \param[in] queue Event queue of the calling task
+ * \param[out] ev The event to send
+ * \return true if an event was returned
+ */
+static bool slotsReceive(TelemetrySlots * slots, xQueueHandle queue, UAVObjEvent * ev)
+{
+#if defined(DIAG_TRACE)
+	// Wake up now and then to send the event trace
+	portTickType timeout = (slots->count == 0) ? TRACE_DRAIN_PERIOD_MS / portTICK_RATE_MS : 0;
+#else
+	portTickType timeout = (slots->count == 0) ? portMAX_DELAY : 0;
+#endif
+	uint8_t best;
+	uint8_t n;
+
+	while (UAVObjQueueReceive(queue, ev, timeout) == pdTRUE) {
+		slotsInsert(slots, ev);
+		timeout = 0;
+	}
+	if (slots->count == 0) {
+		return false;
+	}
+
+	best = 0;
+	for (n = 1; n < slots->count; ++n) {
+		if (slotBefore(slots->slot[n].priority, slots->slot[n].deadline, &slots->slot[best])) {
+			best = n;
+		}
+	}
+
+	ev->obj = slots->slot[best].obj;
+	ev->instId = slots->slot[best].instId;
+	ev->event = slots->slot[best].event;
+	slots->slot[best] = slots->slot[--slots->count];
+	return true;
+}
+
+/**
+ * Add an event to the send slots. An event already pending for the same
+ * instance is not added again, its data is read when it is sent anyway. When
+ * all slots are taken the least urgent entry is dropped.
+ * \param[in] slots Send slots
+ * \param[in] ev The event
+ */
+static void slotsInsert(TelemetrySlots * slots, UAVObjEvent * ev)
+{
+	uint8_t n;
+
+	for (n = 0; n < slots->count; ++n) {
+		if (slots->slot[n].obj == ev->obj && slots->slot[n].instId == ev->instId && slots->slot[n].event == ev->event) {
+			return;
+		}
+	}
+
+	uint32_t periodMs;
+	uint8_t priority = slotPriority(ev, &periodMs);
+	uint32_t deadline = xTaskGetTickCount() * portTICK_RATE_MS + periodMs;
+
+	if (slots->count < MAX_QUEUE_SIZE) {
+		n = slots->count++;
+	} else {
+		uint8_t worst = 0;
+		for (n = 1; n < slots->count; ++n) {
+			if (slotBefore(slots->slot[worst].priority, slots->slot[worst].deadline, &slots->slot[n])) {
+				worst = n;
+			}
+		}
+		++txSkipped;
+		if (!slotBefore(priority, deadline, &slots->slot[worst])) {
+			return;
+		}
+		n = worst;
+	}
+
+	slots->slot[n].obj = ev->obj;
+	slots->slot[n].instId = ev->instId;
+	slots->slot[n].event = ev->event;
+	slots->slot[n].priority = priority;
+	slots->slot[n].deadline = deadline;
+}
+
+/**
+ * Urgency of an event. The connection handshake, metadata, settings, acked
+ * objects and requests come first, then on change updates and last periodic
+ * updates which are due within their period.
+ * \param[in] ev The event
+ * \param[out] periodMs Time until the event is due
+ * \return The EventPriority of the event
+ */
+static uint8_t slotPriority(UAVObjEvent * ev, uint32_t * periodMs)
+{
+	UAVObjMetadata metadata;
+
+	*periodMs = 0;
+	if (ev->obj == 0 || ev->obj == GCSTelemetryStatsHandle() || ev->obj == FlightTelemetryStatsHandle() ||
+			ev->obj == FlightTelemetryCapabilitiesHandle() || UAVObjIsMetaobject(ev->obj) || UAVObjIsSettings(ev->obj) || ev->event == EV_UPDATE_REQ) {
+		return EVENT_PRIORITY_HIGH;
+	}
+
+	UAVObjGetMetadata(ev->obj, &metadata);
+	if (UAVObjGetTelemetryAcked(&metadata)) {
+		return EVENT_PRIORITY_HIGH;
+	}
+	if (ev->event == EV_UPDATED_PERIODIC) {
+		*periodMs = metadata.telemetryUpdatePeriod;
+		return EVENT_PRIORITY_LOW;
+	}
+	return EVENT_PRIORITY_NORMAL;
+}
+
+/**
+ * Compare a send slot with another one, priority first then deadline
+ * \return true if the first is more urgent than slot
+ */
+static bool slotBefore(uint8_t priority, uint32_t deadline, TelemetrySlot * slot)
+{
+	if (priority != slot->priority) {
+		return priority < slot->priority;
+	}
+	return (int32_t)(deadline - slot->deadline) < 0;
+}
+
 /**
  * Telemetry transmit task. Processes queue events and periodic updates.
  */
 static void telemetryRxTask(void *parameters)
 {
 	uint32_t inputPort;
+	UAVObjEvent ev;
 
 	// Task loop
 	while (1) {
@@ -337,14 +726,17 @@ static void telemetryRxTask(void *parameters)
 		}
 
 		if (inputPort) {
-			// Block until data are available
-			uint8_t serial_data[1];
+			// Block until data are available, then take as much of the FIFO as fits
+			uint8_t serial_data[RX_BUFFER_SIZE];
 			uint16_t bytes_to_process;
 
 			bytes_to_process = PIOS_COM_ReceiveBuffer(inputPort, serial_data, sizeof(serial_data), 500);
 			if (bytes_to_process > 0) {
-				for (uint8_t i = 0; i < bytes_to_process; i++) {
-					UAVTalkProcessInputStream(uavTalkCon,serial_data[i]);
+				uint32_t rxTime = xTaskGetTickCount() * portTICK_RATE_MS;
+				EVENT_TRACE(EVENTTRACE_TELEMETRY_RX, bytes_to_process);
+				UAVTalkProcessInputBuffer(uavTalkCon, serial_data, bytes_to_process);
+				if (xQueueReceive(pingQueue, &ev, 0) == pdTRUE) {
+					pingReceived(rxTime);
 				}
 			}
 		} else {
@@ -362,17 +754,7 @@ static void telemetryRxTask(void *parameters)
  */
 static int32_t transmitData(uint8_t * data, int32_t length)
 {
-	uint32_t outputPort;
-
-	// Determine input port (USB takes priority over telemetry port)
-#if defined(PIOS_INCLUDE_USB)
-	if (PIOS_USB_CheckAvailable(0) && PIOS_COM_TELEM_USB) {
-		outputPort = PIOS_COM_TELEM_USB;
-	} else
-#endif /* PIOS_INCLUDE_USB */
-	{
-		outputPort = telemetryPort;
-	}
+	uint32_t outputPort = getOutputPort();
 
 	if (outputPort) {
 		return PIOS_COM_SendBuffer(outputPort, data, length);
@@ -381,6 +763,51 @@ static int32_t transmitData(uint8_t * data, int32_t length)
 	}
 }
 
+/**
+ * Reserve room for a packet in the transmit buffer of the modem or USB port,
+ * UAVTalk serializes the packet straight into it.
+ * \param[out] data Where to write the packet
+ * \param[in] length Length of the packet
+ * \return -1 on failure
+ * \return -2 if the packet does not fit, transmitData() is used instead
+ * \return length on success
+ */
+static int32_t reserveData(uint8_t ** data, int32_t length)
+{
+	// The packet goes out on the port it was reserved on even if USB shows up meanwhile
+	reservedPort = getOutputPort();
+
+	if (reservedPort) {
+		return PIOS_COM_SendReserve(reservedPort, data, length);
+	} else {
+		return -1;
+	}
+}
+
+/**
+ * Transmit a packet written after reserveData()
+ * \param[in] length Length of the packet
+ * \return -1 on failure
+ * \return number of bytes transmitted on success
+ */
+static int32_t commitData(int32_t length)
+{
+	return PIOS_COM_SendCommit(reservedPort, length);
+}
+
+/**
+ * Determine output port (USB takes priority over telemetry port)
+ */
+static uint32_t getOutputPort(void)
+{
+#if defined(PIOS_INCLUDE_USB)
+	if (PIOS_USB_CheckAvailable(0) && PIOS_COM_TELEM_USB) {
+		return PIOS_COM_TELEM_USB;
+	}
+#endif /* PIOS_INCLUDE_USB */
+	return telemetryPort;
+}
+
 /**
  * Setup object for periodic updates.
  * \param[in] obj The object to update
@@ -432,6 +859,33 @@ static void gcsTelemetryStatsUpdated()
 	}
 }
 
+/**
+ * Send a ping from the GCS back, with the time its bytes were read off the
+ * link and the time it went out. It is sent straight from the receive task,
+ * not batched with other updates, the GCS takes the time it arrives and works
+ * out the latency of both directions.
+ * \param[in] rxTime Time the buffer holding the ping was received
+ */
+static void pingReceived(uint32_t rxTime)
+{
+	FlightTelemetryStatsData flightStats;
+	TelemetryPingData ping;
+
+	FlightTelemetryStatsGet(&flightStats);
+	if (flightStats.Status != FLIGHTTELEMETRYSTATS_STATUS_CONNECTED) {
+		return;
+	}
+
+	// Set does not queue an event, the object is sent on manual updates only
+	TelemetryPingGet(&ping);
+	ping.FlightRxTime = rxTime;
+	ping.FlightTxTime = xTaskGetTickCount() * portTICK_RATE_MS;
+	TelemetryPingSet(&ping);
+	if (UAVTalkSendObject(uavTalkCon, TelemetryPingHandle(), 0, 0, 0) == -1) {
+		++txErrors;
+	}
+}
+
 /**
  * Update telemetry statistics and handle connection handshake
  */
@@ -440,6 +894,9 @@ static void updateTelemetryStats()
 	UAVTalkStats utalkStats;
 	FlightTelemetryStatsData flightStats;
 	GCSTelemetryStatsData gcsStats;
+	GCSTelemetryCapabilitiesData gcsCaps;
+	FlightTelemetryBudgetData budget;
+	uint8_t oldStatus;
 	uint8_t forceUpdate;
 	uint8_t connectionTimeout;
 	uint32_t timeNow;
@@ -451,6 +908,8 @@ static void updateTelemetryStats()
 	// Get object data
 	FlightTelemetryStatsGet(&flightStats);
 	GCSTelemetryStatsGet(&gcsStats);
+	GCSTelemetryCapabilitiesGet(&gcsCaps);
+	FlightTelemetryBudgetGet(&budget);
 
 	// Update stats object
 	if (flightStats.Status == FLIGHTTELEMETRYSTATS_STATUS_CONNECTED) {
@@ -459,16 +918,28 @@ static void updateTelemetryStats()
 		flightStats.RxFailures += utalkStats.rxErrors;
 		flightStats.TxFailures += txErrors;
 		flightStats.TxRetries += txRetries;
+		budget.TxSkipped += txSkipped;
+		// Share of the serial link capacity in use
+		if (txBudgetRate && getOutputPort() == telemetryPort) {
+			float utilization = flightStats.TxDataRate * 100 / txBudgetRate;
+			budget.TxUtilization = (utilization < 100) ? (uint8_t)utilization : 100;
+		} else {
+			budget.TxUtilization = 0;
+		}
 		txErrors = 0;
 		txRetries = 0;
+		txSkipped = 0;
 	} else {
 		flightStats.RxDataRate = 0;
 		flightStats.TxDataRate = 0;
 		flightStats.RxFailures = 0;
 		flightStats.TxFailures = 0;
 		flightStats.TxRetries = 0;
+		budget.TxSkipped = 0;
+		budget.TxUtilization = 0;
 		txErrors = 0;
 		txRetries = 0;
+		txSkipped = 0;
 	}
 
 	// Check for connection timeout
@@ -483,6 +954,7 @@ static void updateTelemetryStats()
 	}
 
 	// Update connection state
+	oldStatus = flightStats.Status;
 	forceUpdate = 1;
 	if (flightStats.Status == FLIGHTTELEMETRYSTATS_STATUS_DISCONNECTED) {
 		// Wait for connection request
@@ -506,6 +978,18 @@ static void updateTelemetryStats()
 		flightStats.Status = FLIGHTTELEMETRYSTATS_STATUS_DISCONNECTED;
 	}
 
+	// Forget the extensions of a GCS that has gone, the next one may be older and never send them
+	if (flightStats.Status == FLIGHTTELEMETRYSTATS_STATUS_DISCONNECTED && oldStatus != FLIGHTTELEMETRYSTATS_STATUS_DISCONNECTED) {
+		gcsCaps.Capabilities = 0;
+		GCSTelemetryCapabilitiesSet(&gcsCaps);
+	}
+
+	// Only batch updates once connected to a GCS which can decode them
+	aggregateUpdates = (flightStats.Status == FLIGHTTELEMETRYSTATS_STATUS_CONNECTED) &&
+		(gcsCaps.Capabilities & UAVTALK_CAPABILITY_MULTIOBJECT);
+	deltaUpdates = (flightStats.Status == FLIGHTTELEMETRYSTATS_STATUS_CONNECTED) &&
+		(gcsCaps.Capabilities & UAVTALK_CAPABILITY_DELTA);
+
 	// Update the telemetry alarm
 	if (flightStats.Status == FLIGHTTELEMETRYSTATS_STATUS_CONNECTED) {
 		AlarmsClear(SYSTEMALARMS_ALARM_TELEMETRY);
@@ -515,9 +999,11 @@ static void updateTelemetryStats()
 
 	// Update object
 	FlightTelemetryStatsSet(&flightStats);
+	FlightTelemetryBudgetSet(&budget);
 
 	// Force telemetry update if not connected
 	if (forceUpdate) {
+		FlightTelemetryCapabilitiesUpdated();
 		FlightTelemetryStatsUpdated();
 	}
 }
@@ -532,35 +1018,45 @@ static void updateTelemetryStats()
 static void updateSettings()
 {
 	
+	txBudgetRate = 0;
+
 	if (telemetryPort) {
 		// Retrieve settings
 		uint8_t speed;
+		uint32_t baud = 0;
 		HwSettingsTelemetrySpeedGet(&speed);
 
 		// Set port speed
 		switch (speed) {
 		case HWSETTINGS_TELEMETRYSPEED_2400:
-			PIOS_COM_ChangeBaud(telemetryPort, 2400);
+			baud = 2400;
 			break;
 		case HWSETTINGS_TELEMETRYSPEED_4800:
-			PIOS_COM_ChangeBaud(telemetryPort, 4800);
+			baud = 4800;
 			break;
 		case HWSETTINGS_TELEMETRYSPEED_9600:
-			PIOS_COM_ChangeBaud(telemetryPort, 9600);
+			baud = 9600;
 			break;
 		case HWSETTINGS_TELEMETRYSPEED_19200:
-			PIOS_COM_ChangeBaud(telemetryPort, 19200);
+			baud = 19200;
 			break;
 		case HWSETTINGS_TELEMETRYSPEED_38400:
-			PIOS_COM_ChangeBaud(telemetryPort, 38400);
+			baud = 38400;
 			break;
 		case HWSETTINGS_TELEMETRYSPEED_57600:
-			PIOS_COM_ChangeBaud(telemetryPort, 57600);
+			baud = 57600;
 			break;
 		case HWSETTINGS_TELEMETRYSPEED_115200:
-			PIOS_COM_ChangeBaud(telemetryPort, 115200);
+			baud = 115200;
 			break;
 		}
+		if (baud) {
+			PIOS_COM_ChangeBaud(telemetryPort, baud);
+			// 8N1, ten bits on the wire per byte
+			txBudgetRate = baud / 10;
+			txBudgetTokens = txBudgetRate * TX_BUDGET_BURST_MS;
+			txBudgetTime = xTaskGetTickCount() * portTICK_RATE_MS;
+		}
 	}
 }
 
@@ -31,7 +31,7 @@
 #define configTICK_RATE_HZ		( ( portTickType ) 1000 )
 #define configMAX_PRIORITIES		( ( unsigned portBASE_TYPE ) 5 )
 #define configMINIMAL_STACK_SIZE	( ( unsigned short ) 48 )
-#define configTOTAL_HEAP_SIZE		( ( size_t ) ( 53 * 256) )
+#define configTOTAL_HEAP_SIZE		( ( size_t ) ( 39 * 256) )
 #define configMAX_TASK_NAME_LEN		( 16 )
 #define configUSE_TRACE_FACILITY	0
 #define configUSE_16_BIT_TICKS		0
@@ -102,6 +102,8 @@
 
 // This can't be too high to stop eventdispatcher thread overflowing
 #define PIOS_EVENTDISAPTCHER_QUEUE      10
+// Periodic events scheduled at once, the dispatcher allocates room for them at start
+#define PIOS_EVENTDISPATCHER_MAX_PERIODIC 56
 
 /* PIOS Initcall infrastructure */
 #define PIOS_INCLUDE_INITCALL
@@ -122,6 +122,14 @@ static const struct pios_flash_internal_cfg flash_cfg = {
 };
 #endif
 
+/*
+ * UAVObject storage pool. The object data lives here instead of the FreeRTOS
+ * heap, which was made smaller by the same amount. Objects that do not fit are
+ * taken from the heap, UAVObjGetPoolStats() reports the usage.
+ */
+#define PIOS_UAVOBJ_POOL_SIZE (14 * 256)
+static uint32_t pios_uavobj_pool[PIOS_UAVOBJ_POOL_SIZE / sizeof(uint32_t)];
+
 #include <pios_board_info.h>
 /**
  * PIOS_Board_Init()
@@ -156,6 +164,7 @@ void PIOS_Board_Init(void) {
 	/* Initialize UAVObject libraries */
 	EventDispatcherInitialize();
 	UAVObjInitialize();
+	UAVObjInitializePool(pios_uavobj_pool, sizeof(pios_uavobj_pool));
 
 #if defined(PIOS_INCLUDE_RTC)
 	/* Initialize the real-time clock and its associated tick */
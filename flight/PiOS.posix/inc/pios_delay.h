@@ -39,6 +39,7 @@ extern uint32_t PIOS_DELAY_GetuS();
 extern uint32_t PIOS_DELAY_GetuSSince(uint32_t t);
 extern uint32_t PIOS_DELAY_GetRaw();
 extern uint32_t PIOS_DELAY_DiffuS(uint32_t raw);
+extern uint32_t PIOS_DELAY_DiffuS2(uint32_t raw, uint32_t later);
 
 #endif /* PIOS_DELAY_H */
 
@@ -34,10 +34,17 @@
 struct pios_rcvr_driver {
 	void    (*init)(uint32_t id);
 	int32_t (*read)(uint32_t id, uint8_t channel);
+#if defined(PIOS_INCLUDE_FREERTOS)
+	/* Optional, given from the driver each time a complete frame is decoded */
+	xSemaphoreHandle (*get_semaphore)(uint32_t id, uint8_t channel);
+#endif
 };
 
 /* Public Functions */
 extern int32_t PIOS_RCVR_Read(uint32_t rcvr_id, uint8_t channel);
+#if defined(PIOS_INCLUDE_FREERTOS)
+extern xSemaphoreHandle PIOS_RCVR_GetSemaphore(uint32_t rcvr_id, uint8_t channel);
+#endif
 
 /*! Define error codes for PIOS_RCVR_Get */
 enum PIOS_RCVR_errors {
@@ -30,10 +30,19 @@
 #ifndef PIOS_SERVO_H
 #define PIOS_SERVO_H
 
+/* Global types */
+enum pios_servo_mode {
+	PIOS_SERVO_MODE_PWM,
+	PIOS_SERVO_MODE_SYNC,
+	PIOS_SERVO_MODE_ONESHOT,
+};
+
 /* Public Functions */
 extern void PIOS_Servo_Init(void);
 extern void PIOS_Servo_SetHz(const uint16_t * speeds, uint8_t num_banks);
+extern void PIOS_Servo_SetMode(const enum pios_servo_mode * modes, uint8_t num_banks);
 extern void PIOS_Servo_Set(uint8_t Servo, uint16_t Position);
+extern void PIOS_Servo_Update(void);
 
 #endif /* PIOS_SERVO_H */
 
@@ -38,6 +38,22 @@
 #include <fcntl.h>
 #include <netinet/in.h>
 
+/* datagrams taken from the socket per recvmmsg() call */
+#ifndef PIOS_UDP_RX_BATCH
+#define PIOS_UDP_RX_BATCH 8
+#endif
+
+/* datagrams sent per batch, and how long writers get to fill one */
+#ifndef PIOS_UDP_TX_BATCH
+#define PIOS_UDP_TX_BATCH 4
+#endif
+#ifndef PIOS_UDP_TX_BATCH_MS
+#define PIOS_UDP_TX_BATCH_MS 1
+#endif
+#ifndef PIOS_UDP_TX_BUFFER_SIZE
+#define PIOS_UDP_TX_BUFFER_SIZE PIOS_UDP_RX_BUFFER_SIZE
+#endif
+
 struct pios_udp_cfg {
   const char * ip;
   uint16_t port;
@@ -47,8 +63,12 @@ typedef struct {
   const struct pios_udp_cfg * cfg;
 #if defined(PIOS_INCLUDE_FREERTOS)
   xTaskHandle rxThread;
+  xTaskHandle txThread;
+  xSemaphoreHandle txSem;
 #else
   pthread_t rxThread;
+  pthread_t txThread;
+  bool tx_pending;
 #endif
 
   int socket;
@@ -64,8 +84,8 @@ typedef struct {
   pios_com_callback rx_in_cb;
   uint32_t rx_in_context;
 
-  uint8_t rx_buffer[PIOS_UDP_RX_BUFFER_SIZE];
-  uint8_t tx_buffer[PIOS_UDP_RX_BUFFER_SIZE];
+  uint8_t rx_buffer[PIOS_UDP_RX_BATCH][PIOS_UDP_RX_BUFFER_SIZE];
+  uint8_t tx_buffer[PIOS_UDP_TX_BATCH][PIOS_UDP_TX_BUFFER_SIZE];
 } pios_udp_dev;
 
 extern int32_t PIOS_UDP_Init(uint32_t * udp_id, const struct pios_udp_cfg * cfg);
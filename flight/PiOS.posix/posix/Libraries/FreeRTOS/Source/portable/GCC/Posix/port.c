@@ -85,6 +85,16 @@ Preemption is done by the main scheduler thread which attempts to run a tick
 handler at accurate intervals using nanosleep and gettimeofday, which allows
 more accurate high frequency ticks than a timer signal handler.
 
+Alternatively the supervisor can run on a simulated clock (vPortSetTimeMode).
+Each tick then advances the simulated time by portTICK_RATE_MICROSECONDS as
+soon as the running task is the idle task (or any other task at idle
+priority) or is busy waiting in vPortBusyWaitUS, which lets the firmware run
+as fast as the CPU allows. A task that keeps the CPU for longer than one real
+tick is preempted anyway, so the simulation never runs slower than real time.
+In lockstep mode the ticks are additionally granted one batch at a time by
+xPortStepTicks, which returns once the firmware went idle after the last of
+them.
+
 All public functions in this port are protected by a safeguard mutex which
 assures priority access on all data objects
 
@@ -137,6 +147,7 @@ typedef struct THREAD_SUSPENSIONS
 	pthread_mutex_t threadSleepMutex;
 	pthread_cond_t threadSleepCond;
     volatile enum {THREAD_SLEEPING,THREAD_RUNNING,THREAD_STARTING,THREAD_YIELDING,THREAD_PREEMPTING,THREAD_WAKING} threadStatus;
+	volatile portBASE_TYPE xBusyWaiting;
 } xThreadState;
 /*-----------------------------------------------------------*/
 
@@ -160,6 +171,18 @@ static volatile portBASE_TYPE xPendYield = pdFALSE;
 static volatile portLONG lIndexOfLastAddedTask = 0;
 /*-----------------------------------------------------------*/
 
+/* Simulated time, only used when xTimeMode is not portTIME_REALTIME */
+static volatile portBASE_TYPE xTimeMode = portTIME_REALTIME;
+static volatile unsigned long long ullSimTimeUS = 0;
+static volatile unsigned long ulSimBusyUS = 0;
+static volatile unsigned portBASE_TYPE uxRunningPriority = tskIDLE_PRIORITY;
+static volatile unsigned long ulTicksHandled = 0;
+static unsigned long ulStepTicks = 0;
+static portBASE_TYPE xStepDone = pdTRUE;
+static pthread_mutex_t xStepMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xStepCond = PTHREAD_COND_INITIALIZER;
+/*-----------------------------------------------------------*/
+
 /*
  * Setup the timer to generate the tick interrupts.
  */
@@ -172,6 +195,8 @@ static xThreadState* prvGetThreadHandleByThread( pthread_t hThread );
 static portLONG prvGetFreeThreadState( void );
 static void prvDeleteThread( void *xThreadId );
 static void prvPortYield();
+static void prvSimulatedTimeLoop( void );
+static void prvSimulatedTimeWaitForIdle( void );
 /*-----------------------------------------------------------*/
 
 /*
@@ -235,6 +260,7 @@ portSTACK_TYPE *pxPortInitialiseStack( portSTACK_TYPE *pxTopOfStack, pdTASK_CODE
 
 	pxThreads[ lIndexOfLastAddedTask ].threadStatus = THREAD_STARTING;
 	pxThreads[ lIndexOfLastAddedTask ].uxCriticalNesting = 0;
+	pxThreads[ lIndexOfLastAddedTask ].xBusyWaiting = pdFALSE;
 
 	/* create the thead */
 	PORT_ASSERT( 0 == pthread_create( &( pxThreads[ lIndexOfLastAddedTask ].hThread ), &xThreadAttributes, prvWaitForStart, (void *)pxThisThreadParams ) );
@@ -291,6 +317,11 @@ portBASE_TYPE xPortStartScheduler( void )
 	/* Start the first task. This gives up the RunningThreadMutex*/
 	vPortStartFirstTask();
 
+	if ( xTimeMode != portTIME_REALTIME )
+	{
+		prvSimulatedTimeLoop();
+	}
+
 	/**
 	 * Main scheduling loop. Call the tick handler every
 	 * portTICK_RATE_MICROSECONDS
@@ -362,7 +393,10 @@ portBASE_TYPE xNumberOfThreads;
 	}
 
 	/* Signal the scheduler to exit its loop. */
+	pthread_mutex_lock( &xStepMutex );
 	xSchedulerEnd = pdTRUE;
+	pthread_cond_broadcast( &xStepCond );
+	pthread_mutex_unlock( &xStepMutex );
 }
 /*-----------------------------------------------------------*/
 
@@ -647,6 +681,7 @@ void vPortSystemTickHandler()
 	 * call tick handler
 	 */
 	vTaskIncrementTick();
+	ulTicksHandled++;
 
 	
 #if ( configUSE_PREEMPTION == 1 )
@@ -922,6 +957,7 @@ portLONG lIndex;
 		pxThreads[ lIndex ].hThread = ( pthread_t )NULL;
 		pxThreads[ lIndex ].hTask = ( xTaskHandle )NULL;
 		pxThreads[ lIndex ].uxCriticalNesting = 0;
+		pxThreads[ lIndex ].xBusyWaiting = pdFALSE;
 		pxThreads[ lIndex ].threadSleepMutex = minit;
 		pxThreads[ lIndex ].threadSleepCond = cinit;
 	}
@@ -1087,3 +1123,178 @@ struct tms xTimes;
 }
 /*-----------------------------------------------------------*/
 
+
+/**
+ * select the clock of the supervisor, must be called before the scheduler is started
+ */
+void vPortSetTimeMode( portBASE_TYPE xMode )
+{
+	PORT_ASSERT( xSchedulerStarted == pdFALSE );
+	xTimeMode = xMode;
+}
+/*-----------------------------------------------------------*/
+
+portBASE_TYPE xPortGetTimeMode( void )
+{
+	return xTimeMode;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * simulated time in microseconds, the ticks plus what busy waits used up of the current one
+ */
+unsigned long long ullPortGetTimeUS( void )
+{
+	return ullSimTimeUS + ulSimBusyUS;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * busy wait on the simulated clock. Waits within the current tick only move
+ * the clock, longer ones let the supervisor tick as if the task was idle
+ */
+void vPortBusyWaitUS( unsigned long ulTimeUS )
+{
+	unsigned long long ullTarget = ullPortGetTimeUS() + ulTimeUS;
+
+	if ( xSchedulerStarted != pdTRUE )
+	{
+		/* nothing else can run yet, just move the clock */
+		ullSimTimeUS = ullTarget;
+		return;
+	}
+
+	xThreadState *xThread = prvGetThreadHandleByThread( pthread_self() );
+
+	if ( ullTarget >= ullSimTimeUS + portTICK_RATE_MICROSECONDS )
+	{
+		xThread->xBusyWaiting = pdTRUE;
+		while ( ullTarget >= ullSimTimeUS + portTICK_RATE_MICROSECONDS && pdTRUE != xSchedulerEnd )
+		{
+			sched_yield();
+		}
+		xThread->xBusyWaiting = pdFALSE;
+	}
+
+	if ( ullTarget > ullSimTimeUS )
+	{
+		ulSimBusyUS = ( unsigned long )( ullTarget - ullSimTimeUS );
+	}
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * lockstep mode: let the firmware run for ulTicks more ticks and wait until
+ * it went idle after the last of them
+ * returns the simulated time in microseconds
+ */
+unsigned long long ullPortStepTicks( unsigned long ulTicks )
+{
+	PORT_ASSERT( xTimeMode == portTIME_LOCKSTEP );
+
+	pthread_mutex_lock( &xStepMutex );
+	if ( ulTicks > 0 )
+	{
+		ulStepTicks += ulTicks;
+		xStepDone = pdFALSE;
+		pthread_cond_broadcast( &xStepCond );
+	}
+	while ( xStepDone != pdTRUE && pdTRUE != xSchedulerEnd )
+	{
+		pthread_cond_wait( &xStepCond, &xStepMutex );
+	}
+	pthread_mutex_unlock( &xStepMutex );
+
+	return ullPortGetTimeUS();
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * called by vTaskSwitchContext() whenever a task has been selected to run
+ */
+void vPortTaskSwitchedIn( unsigned portBASE_TYPE uxPriority )
+{
+	uxRunningPriority = uxPriority;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * supervisor loop on the simulated clock, replaces the nanosleep loop
+ */
+void prvSimulatedTimeLoop( void )
+{
+	while ( pdTRUE != xSchedulerEnd )
+	{
+		/* let the tasks finish the work of the last tick */
+		prvSimulatedTimeWaitForIdle();
+
+		if ( xTimeMode == portTIME_LOCKSTEP )
+		{
+			pthread_mutex_lock( &xStepMutex );
+			if ( ulStepTicks == 0 )
+			{
+				xStepDone = pdTRUE;
+				pthread_cond_broadcast( &xStepCond );
+				while ( ulStepTicks == 0 && pdTRUE != xSchedulerEnd )
+				{
+					pthread_cond_wait( &xStepCond, &xStepMutex );
+				}
+			}
+			if ( ulStepTicks > 0 )
+			{
+				ulStepTicks--;
+			}
+			pthread_mutex_unlock( &xStepMutex );
+
+			if ( pdTRUE == xSchedulerEnd )
+			{
+				break;
+			}
+		}
+
+		/* advance the clock, then retry the tick until it was not deferred */
+		ullSimTimeUS += portTICK_RATE_MICROSECONDS;
+		ulSimBusyUS = 0;
+
+		unsigned long ulTicks = ulTicksHandled;
+		vPortSystemTickHandler();
+		while ( ulTicks == ulTicksHandled && pdTRUE != xSchedulerEnd )
+		{
+			sched_yield();
+			vPortSystemTickHandler();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * wait until the running task is at idle priority or busy waiting, or at
+ * most one real tick
+ */
+void prvSimulatedTimeWaitForIdle( void )
+{
+	struct timespec xStart, xNow;
+	clock_gettime( CLOCK_MONOTONIC, &xStart );
+
+	while ( pdTRUE != xSchedulerEnd )
+	{
+		PORT_LOCK( xGuardMutex );
+		xThreadState *xThread = prvGetThreadHandle( xTaskGetCurrentTaskHandle() );
+		portBASE_TYPE xIdle = ( uxRunningPriority == tskIDLE_PRIORITY || ( xThread && xThread->xBusyWaiting == pdTRUE ) );
+		PORT_UNLOCK( xGuardMutex );
+
+		if ( xIdle )
+		{
+			return;
+		}
+
+		clock_gettime( CLOCK_MONOTONIC, &xNow );
+		if ( 1000000LL * ( xNow.tv_sec - xStart.tv_sec ) + ( xNow.tv_nsec - xStart.tv_nsec ) / 1000 >= ( long long )portTICK_RATE_MICROSECONDS )
+		{
+			return;
+		}
+
+		sched_yield();
+	}
+}
+/*-----------------------------------------------------------*/
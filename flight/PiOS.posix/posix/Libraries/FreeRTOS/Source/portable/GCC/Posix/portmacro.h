@@ -140,6 +140,20 @@ extern void vPortForciblyEndThread( void *pxTaskToDelete );
 extern void vPortAddTaskHandle( void *pxTaskHandle );
 #define traceTASK_CREATE( pxNewTCB )			vPortAddTaskHandle( pxNewTCB )
 
+extern void vPortTaskSwitchedIn( unsigned portBASE_TYPE uxPriority );
+#define traceTASK_SWITCHED_IN()					vPortTaskSwitchedIn( pxCurrentTCB->uxPriority )
+
+/* Clock of the supervisor thread, see vPortSetTimeMode() */
+#define portTIME_REALTIME			0	/* ticks follow the wall clock */
+#define portTIME_FAST				1	/* simulated clock, as fast as the tasks allow */
+#define portTIME_LOCKSTEP			2	/* simulated clock, ticks granted by ullPortStepTicks() */
+
+extern void vPortSetTimeMode( portBASE_TYPE xMode );
+extern portBASE_TYPE xPortGetTimeMode( void );
+extern unsigned long long ullPortGetTimeUS( void );
+extern void vPortBusyWaitUS( unsigned long ulTimeUS );
+extern unsigned long long ullPortStepTicks( unsigned long ulTicks );
+
 /* Posix Signal definitions that can be changed or read as appropriate. */
 #define SIG_SUSPEND					SIGUSR1
 
@@ -354,6 +354,84 @@ int32_t PIOS_COM_SendBuffer(uint32_t com_id, const uint8_t *buffer, uint16_t len
 	return rc;
 }
 
+/**
+* Reserves room for a package directly in the transmit buffer of a port
+* (blocking function), see PIOS_COM_SendCommit()
+* \param[in] port COM port
+* \param[out] buffer where to write the package
+* \param[in] len package length
+* \return -1 if port not available
+* \return -2 if the package does not fit in the transmit buffer at all
+* \return -3 if the transmit buffer did not drain
+* \return len on success
+*/
+int32_t PIOS_COM_SendReserve(uint32_t com_id, uint8_t **buffer, uint16_t len)
+{
+	struct pios_com_dev * com_dev = PIOS_COM_find_dev(com_id);
+
+	if (!PIOS_COM_validate(com_dev)) {
+		/* Undefined COM port for this board (see pios_board.c) */
+		return -1;
+	}
+
+	PIOS_Assert(com_dev->has_tx);
+
+	if (len > fifoBuf_getSize(&com_dev->tx)) {
+		return -2;
+	}
+
+	while (1) {
+		PIOS_IRQ_Disable();
+		*buffer = fifoBuf_reserve(&com_dev->tx, len);
+		PIOS_IRQ_Enable();
+
+		if (*buffer) {
+			return len;
+		}
+
+#if defined(PIOS_INCLUDE_FREERTOS)
+		/* Make sure the transmitter is running while we wait */
+		if (com_dev->driver->tx_start) {
+			(com_dev->driver->tx_start)(com_dev->lower_id,
+						    fifoBuf_getUsed(&com_dev->tx));
+		}
+		if (xSemaphoreTake(com_dev->tx_sem, portMAX_DELAY) != pdTRUE) {
+			return -3;
+		}
+#endif
+	}
+}
+
+/**
+* Sends a package written in place after PIOS_COM_SendReserve()
+* \param[in] port COM port
+* \param[in] len package length, at most the reserved length
+* \return -1 if port not available
+* \return number of bytes transmitted on success
+*/
+int32_t PIOS_COM_SendCommit(uint32_t com_id, uint16_t len)
+{
+	struct pios_com_dev * com_dev = PIOS_COM_find_dev(com_id);
+
+	if (!PIOS_COM_validate(com_dev)) {
+		/* Undefined COM port for this board (see pios_board.c) */
+		return -1;
+	}
+
+	PIOS_Assert(com_dev->has_tx);
+
+	PIOS_IRQ_Disable();
+	fifoBuf_commit(&com_dev->tx, len);
+	PIOS_IRQ_Enable();
+
+	if (len > 0 && com_dev->driver->tx_start) {
+		com_dev->driver->tx_start(com_dev->lower_id,
+					  fifoBuf_getUsed(&com_dev->tx));
+	}
+
+	return len;
+}
+
 /**
 * Sends a single character over given port
 * \param[in] port COM port
@@ -61,6 +61,14 @@ int32_t PIOS_DELAY_Init(void)
 */
 int32_t PIOS_DELAY_WaituS(uint32_t uS)
 {
+#if defined(PIOS_INCLUDE_FREERTOS)
+	// On the simulated clock the wait only moves the time forward
+	if (xPortGetTimeMode() != portTIME_REALTIME) {
+		vPortBusyWaitUS(uS);
+		return 0;
+	}
+#endif
+
 	static struct timespec wait,rest;
 	wait.tv_sec=0;
 	wait.tv_nsec=1000*uS;
@@ -85,6 +93,13 @@ int32_t PIOS_DELAY_WaituS(uint32_t uS)
 */
 int32_t PIOS_DELAY_WaitmS(uint32_t mS)
 {
+#if defined(PIOS_INCLUDE_FREERTOS)
+	if (xPortGetTimeMode() != portTIME_REALTIME) {
+		vPortBusyWaitUS(mS * 1000);
+		return 0;
+	}
+#endif
+
 	//for(int i = 0; i < mS; i++) {
 	//	PIOS_DELAY_WaituS(1000);
 	static struct timespec wait,rest;
@@ -105,6 +120,11 @@ int32_t PIOS_DELAY_WaitmS(uint32_t mS)
  */
 uint32_t PIOS_DELAY_GetuS()
 {
+#if defined(PIOS_INCLUDE_FREERTOS)
+	if (xPortGetTimeMode() != portTIME_REALTIME)
+		return (uint32_t) ullPortGetTimeUS();
+#endif
+
 	static struct timespec current;
 	clock_gettime(CLOCK_REALTIME, &current);
 	return ((current.tv_sec * 1000000) + (current.tv_nsec / 1000));
@@ -138,5 +158,14 @@ uint32_t PIOS_DELAY_DiffuS(uint32_t raw)
 	return ( PIOS_DELAY_GetuS() - raw );
 }
 
+/**
+ * @brief Difference between two raw times in us
+ * @return The microseconds from raw to later
+ */
+uint32_t PIOS_DELAY_DiffuS2(uint32_t raw, uint32_t later)
+{
+	return ( later - raw );
+}
+
 
 #endif
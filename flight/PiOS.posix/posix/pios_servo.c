@@ -54,6 +54,13 @@ void PIOS_Servo_SetHz(const uint16_t * banks, uint8_t num_banks)
 {
 }
 
+/**
+* Set the output mode of the banks
+*/
+void PIOS_Servo_SetMode(const enum pios_servo_mode * modes, uint8_t num_banks)
+{
+}
+
 /**
 * Set servo position
 * \param[in] Servo Servo number (0-7)
@@ -71,4 +78,11 @@ void PIOS_Servo_Set(uint8_t Servo, uint16_t Position)
 #endif // PIOS_ENABLE_DEBUG_PINS
 }
 
+/**
+* Output the positions set since the last call
+*/
+void PIOS_Servo_Update(void)
+{
+}
+
 #endif
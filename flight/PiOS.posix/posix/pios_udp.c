@@ -27,6 +27,11 @@
  */
 
 
+/* recvmmsg() and sendmmsg() */
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 /* Project Includes */
 #include "pios.h"
 
@@ -72,6 +77,26 @@ static pios_udp_dev * find_udp_dev_by_id (uint8_t udp)
   return &(pios_udp_devices[udp]);
 }
 
+/**
+ * Pass received data on to the com layer
+ */
+static void PIOS_UDP_Receive(pios_udp_dev * udp_dev, uint8_t * buf, uint16_t len)
+{
+	/* copy received data to buffer if possible */
+	/* we do NOT buffer data locally. If the com buffer can't receive, data is discarded! */
+	/* (thats what the USART driver does too!) */
+	bool rx_need_yield = false;
+	if (udp_dev->rx_in_cb) {
+	  (void) (udp_dev->rx_in_cb)(udp_dev->rx_in_context, buf, len, NULL, &rx_need_yield);
+	}
+
+#if defined(PIOS_INCLUDE_FREERTOS)
+	if (rx_need_yield) {
+		vPortYieldFromISR();
+	}
+#endif	/* PIOS_INCLUDE_FREERTOS */
+}
+
 /**
  * RxThread
  */
@@ -80,42 +105,143 @@ void * PIOS_UDP_RxThread(void * udp_dev_n)
 
 	pios_udp_dev * udp_dev = (pios_udp_dev*) udp_dev_n;
 
+#if defined(__linux__)
+	struct mmsghdr msgs[PIOS_UDP_RX_BATCH];
+	struct iovec iovecs[PIOS_UDP_RX_BATCH];
+	struct sockaddr_in clients[PIOS_UDP_RX_BATCH];
+	memset(msgs, 0, sizeof(msgs));
+	for (int i = 0; i < PIOS_UDP_RX_BATCH; i++) {
+		iovecs[i].iov_base = udp_dev->rx_buffer[i];
+		iovecs[i].iov_len = PIOS_UDP_RX_BUFFER_SIZE;
+		msgs[i].msg_hdr.msg_iov = &iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &clients[i];
+	}
+#endif
+
    /**
 	* com devices never get closed except by application "reboot"
 	* we also never give up our mutex except for waiting
 	*/
    while(1) {
 
+#if defined(__linux__)
+		/**
+		 * block until at least one datagram arrives, then take all that are queued
+		 */
+		for (int i = 0; i < PIOS_UDP_RX_BATCH; i++) {
+			msgs[i].msg_hdr.msg_namelen = sizeof(clients[i]);
+		}
+		int received = recvmmsg(udp_dev->socket, msgs, PIOS_UDP_RX_BATCH, MSG_WAITFORONE, NULL);
+		for (int i = 0; i < received; i++) {
+			udp_dev->client = clients[i];
+			PIOS_UDP_Receive(udp_dev, udp_dev->rx_buffer[i], msgs[i].msg_len);
+		}
+#else
 		/**
 		 * receive 
 		 */
 		int received;
 		udp_dev->clientLength=sizeof(udp_dev->client);
 		if ((received = recvfrom(udp_dev->socket,
-				&udp_dev->rx_buffer,
+				udp_dev->rx_buffer[0],
 				PIOS_UDP_RX_BUFFER_SIZE,
 				0,
 				(struct sockaddr *) &udp_dev->client,
 				(socklen_t*)&udp_dev->clientLength)) >= 0)
 		{
+			PIOS_UDP_Receive(udp_dev, udp_dev->rx_buffer[0], received);
+		}
+#endif
 
-			/* copy received data to buffer if possible */
-			/* we do NOT buffer data locally. If the com buffer can't receive, data is discarded! */
-			/* (thats what the USART driver does too!) */
-			bool rx_need_yield = false;
-			if (udp_dev->rx_in_cb) {
-			  (void) (udp_dev->rx_in_cb)(udp_dev->rx_in_context, udp_dev->rx_buffer, received, NULL, &rx_need_yield);
-			}
+	}
+}
 
+/**
+ * Send a batch of datagrams from the tx buffers to the client
+ */
+static void PIOS_UDP_SendBatch(pios_udp_dev * udp_dev, uint16_t * lengths, int count)
+{
+#if defined(__linux__)
+	struct mmsghdr msgs[PIOS_UDP_TX_BATCH];
+	struct iovec iovecs[PIOS_UDP_TX_BATCH];
+	struct sockaddr_in client = udp_dev->client;
+	memset(msgs, 0, sizeof(msgs));
+	for (int i = 0; i < count; i++) {
+		iovecs[i].iov_base = udp_dev->tx_buffer[i];
+		iovecs[i].iov_len = lengths[i];
+		msgs[i].msg_hdr.msg_iov = &iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &client;
+		msgs[i].msg_hdr.msg_namelen = sizeof(client);
+	}
+
+	int sent = 0;
+	while (sent < count) {
+		int res = sendmmsg(udp_dev->socket, msgs + sent, count - sent, 0);
+		if (res <= 0) {
+			break;
+		}
+		sent += res;
+	}
+#else
+	for (int i = 0; i < count; i++) {
+		sendto(udp_dev->socket, udp_dev->tx_buffer[i], lengths[i], 0,
+			 (struct sockaddr *) &udp_dev->client,
+			 sizeof(udp_dev->client));
+	}
+#endif
+}
+
+/**
+ * TxThread
+ */
+void * PIOS_UDP_TxThread(void * udp_dev_n)
+{
+
+	pios_udp_dev * udp_dev = (pios_udp_dev*) udp_dev_n;
+	bool more = false;
+
+	while(1) {
+
+		/**
+		 * sleep until there is data to send, then give the tasks the rest of the
+		 * batch interval to queue more so it all goes out together
+		 */
+		if (!more) {
 #if defined(PIOS_INCLUDE_FREERTOS)
-			if (rx_need_yield) {
-				vPortYieldFromISR();
+			xSemaphoreTake(udp_dev->txSem, portMAX_DELAY);
+			vTaskDelay(PIOS_UDP_TX_BATCH_MS / portTICK_RATE_MS);
+#else
+			pthread_mutex_lock(&udp_dev->mutex);
+			while (!udp_dev->tx_pending) {
+				pthread_cond_wait(&udp_dev->cond, &udp_dev->mutex);
 			}
-#endif	/* PIOS_INCLUDE_FREERTOS */
-
+			udp_dev->tx_pending = false;
+			pthread_mutex_unlock(&udp_dev->mutex);
+			usleep(PIOS_UDP_TX_BATCH_MS * 1000);
+#endif
 		}
 
+		/**
+		 * drain the com buffer into datagrams
+		 */
+		uint16_t lengths[PIOS_UDP_TX_BATCH];
+		int count = 0;
+		while (count < PIOS_UDP_TX_BATCH && udp_dev->tx_out_cb) {
+			bool tx_need_yield = false;
+			lengths[count] = (udp_dev->tx_out_cb)(udp_dev->tx_out_context, udp_dev->tx_buffer[count], PIOS_UDP_TX_BUFFER_SIZE, NULL, &tx_need_yield);
+			if (lengths[count] == 0) {
+				break;
+			}
+			count++;
+		}
+		if (count > 0) {
+			PIOS_UDP_SendBatch(udp_dev, lengths, count);
+		}
 
+		/* the batch was full, there may be more waiting */
+		more = (count == PIOS_UDP_TX_BATCH);
 	}
 }
 
@@ -135,6 +261,14 @@ int32_t PIOS_UDP_Init(uint32_t * udp_id, const struct pios_udp_cfg * cfg)
   udp_dev->rx_in_cb = NULL;
   udp_dev->tx_out_cb = NULL;
   udp_dev->cfg=cfg;
+#if defined(PIOS_INCLUDE_FREERTOS)
+  vSemaphoreCreateBinary(udp_dev->txSem);
+  xSemaphoreTake(udp_dev->txSem, 0);
+#else
+  pthread_mutex_init(&udp_dev->mutex, NULL);
+  pthread_cond_init(&udp_dev->cond, NULL);
+  udp_dev->tx_pending = false;
+#endif
 
   /* assign socket */
   udp_dev->socket = socket(PF_INET, SOCK_DGRAM, IPPROTO_UDP);
@@ -149,8 +283,10 @@ int32_t PIOS_UDP_Init(uint32_t * udp_id, const struct pios_udp_cfg * cfg)
 #if defined(PIOS_INCLUDE_FREERTOS)
 //( pdTASK_CODE pvTaskCode, const portCHAR * const pcName, unsigned portSHORT usStackDepth, void *pvParameters, unsigned portBASE_TYPE uxPriority, xTaskHandle *pvCreatedTask );
   xTaskCreate((pdTASK_CODE)PIOS_UDP_RxThread, (const signed char *)"UDP_Rx_Thread",1024,(void*)udp_dev,(tskIDLE_PRIORITY + 1),&udp_dev->rxThread);
+  xTaskCreate((pdTASK_CODE)PIOS_UDP_TxThread, (const signed char *)"UDP_Tx_Thread",1024,(void*)udp_dev,(tskIDLE_PRIORITY + 1),&udp_dev->txThread);
 #else
   pthread_create(&udp_dev->rxThread, NULL, PIOS_UDP_RxThread, (void*)udp_dev);
+  pthread_create(&udp_dev->txThread, NULL, PIOS_UDP_TxThread, (void*)udp_dev);
 #endif
 
 
@@ -184,30 +320,17 @@ static void PIOS_UDP_TxStart(uint32_t udp_id, uint16_t tx_bytes_avail)
 
 	PIOS_Assert(udp_dev);
 
-	int32_t length,len,rem;
-
 	/**
-	 * we send everything directly whenever notified of data to send (lazy!)
+	 * the tx thread sends everything queued in this batch interval at once
 	 */
-	if (udp_dev->tx_out_cb) {
-		while (tx_bytes_avail>0) {
-			bool tx_need_yield = false;
-			length = (udp_dev->tx_out_cb)(udp_dev->tx_out_context, udp_dev->tx_buffer, PIOS_UDP_RX_BUFFER_SIZE, NULL, &tx_need_yield);
-			rem = length;
-			while (rem>0) {
-				len = sendto(udp_dev->socket, udp_dev->tx_buffer+length-rem, rem, 0,
-						 (struct sockaddr *) &udp_dev->client,
-						 sizeof(udp_dev->client));
-				if (len<=0) {
-					rem=0;
-				} else {
-					rem -= len;
-				}
-			}
-			tx_bytes_avail -= length;
-		}
-	}
-
+#if defined(PIOS_INCLUDE_FREERTOS)
+	xSemaphoreGive(udp_dev->txSem);
+#else
+	pthread_mutex_lock(&udp_dev->mutex);
+	udp_dev->tx_pending = true;
+	pthread_cond_signal(&udp_dev->cond);
+	pthread_mutex_unlock(&udp_dev->mutex);
+#endif
 }
 
 static void PIOS_UDP_RegisterRxCallback(uint32_t udp_id, pios_com_callback rx_in_cb, uint32_t context)
@@ -292,8 +292,10 @@ extern uint32_t pios_rfm22b_id;
 uint32_t pios_packet_handler;
 #define PIOS_INCLUDE_PACKET_HANDLER
 #define PIOS_PH_MAX_PACKET 255
-#define PIOS_PH_WIN_SIZE 3
+#define PIOS_PH_WIN_SIZE 5
 #define PIOS_PH_MAX_CONNECTIONS 1
+#define PIOS_PH_RETRANSMIT_TIMEOUT_MS 250
+#define PIOS_PH_ACK_DELAY_MS 20
 
 //-------------------------
 // Reed-Solomon ECC
@@ -114,7 +114,8 @@ uint32_t DFS_ReadSector(uint8_t unit, uint8_t *buffer, uint32_t sector, uint32_t
 }
 
 /**
-* Write sector to SD Card
+* Write sectors to SD Card, DFS_WriteFile() passes count > 1 for whole
+* sectors of a cluster which go out as one multiple block write
 * Returns 0 OK, nonzero for any error
 */
 uint32_t DFS_WriteSector(uint8_t unit, uint8_t *buffer, uint32_t sector, uint32_t count)
@@ -124,8 +125,7 @@ uint32_t DFS_WriteSector(uint8_t unit, uint8_t *buffer, uint32_t sector, uint32_
 		return 1;
 	}
 
-	/* According to README.txt, count is always 1 - check this! */
-	if(count != 1) {
+	if(count == 0) {
 		return 2;
 	}
 
@@ -134,7 +134,7 @@ uint32_t DFS_WriteSector(uint8_t unit, uint8_t *buffer, uint32_t sector, uint32_
 
 	/* Forward to PIOS */
 	int32_t status;
-	if((status = PIOS_SDCARD_SectorWrite(sector, buffer)) < 0) {
+	if((status = PIOS_SDCARD_SectorWriteMulti(sector, buffer, count)) < 0) {
 		/* Cannot access SD Card */
 		return 3;
 	}
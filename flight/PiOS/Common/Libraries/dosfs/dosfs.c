@@ -1225,18 +1225,22 @@ uint32_t DFS_WriteFile(PFILEINFO fileinfo, uint8_t *scratch, uint8_t *buffer, ui
                 // Case 2 - File pointer is on sector boundary
                 else {
                         // Case 2A - We have at least one more full sector to write and don't have
-                        // to go through the scratch buffer. You could insert optimizations here to
-                        // write multiple sectors at a time, if you were thus inclined. Refer to
-                        // similar notes in DFS_ReadFile.
+                        // to go through the scratch buffer. All whole sectors up to the end of
+                        // the current cluster are contiguous and go out in one write, the
+                        // cluster boundary check below then moves on to the next cluster.
                         if (remain >= SECTOR_SIZE) {
-                                result = DFS_WriteSector(fileinfo->volinfo->unit, buffer, sector, 1);
-                                remain -= SECTOR_SIZE;
-                                buffer += SECTOR_SIZE;
-                                fileinfo->pointer += SECTOR_SIZE;
+                                uint32_t count = fileinfo->volinfo->secperclus -
+                                  div(div(fileinfo->pointer,fileinfo->volinfo->secperclus * SECTOR_SIZE).rem, SECTOR_SIZE).quot;
+                                if (count > remain / SECTOR_SIZE)
+                                        count = remain / SECTOR_SIZE;
+                                result = DFS_WriteSector(fileinfo->volinfo->unit, buffer, sector, count);
+                                remain -= count * SECTOR_SIZE;
+                                buffer += count * SECTOR_SIZE;
+                                fileinfo->pointer += count * SECTOR_SIZE;
                                 if (fileinfo->filelen < fileinfo->pointer) {
                                         fileinfo->filelen = fileinfo->pointer;
                                 }
-                                byteswritten = SECTOR_SIZE;
+                                byteswritten = count * SECTOR_SIZE;
                         }
                         // Case 2B - We are only writing a partial sector and potentially need to
                         // go through the scratch buffer.
@@ -340,6 +340,7 @@ int32_t PIOS_BMA180_ReadAccels(struct pios_bma180_data * data)
 	PIOS_BMA180_ReleaseBus();	
 	
 	//        |    MSB        |   LSB       | 0 | new_data |
+	data->time = PIOS_DELAY_GetRaw();
 	data->x = ((rec[2] << 8) | rec[1]);
 	data->y = ((rec[4] << 8) | rec[3]);
 	data->z = ((rec[6] << 8) | rec[5]);
@@ -437,6 +438,7 @@ int32_t bma180_irqs = 0;
 bool PIOS_BMA180_IRQHandler(void)
 {
 	bma180_irqs++;
+	uint32_t time = PIOS_DELAY_GetRaw();
 	
 	const static uint8_t pios_bma180_req_buf[7] = {BMA_X_LSB_ADDR | 0x80,0,0,0,0,0};
 	uint8_t pios_bma180_dmabuf[8];
@@ -468,6 +470,7 @@ bool PIOS_BMA180_IRQHandler(void)
 	data.y /= 4;
 	data.z /= 4;
 	data.temperature = pios_bma180_dmabuf[7];
+	data.time = time;
 	
 	fifoBuf_putData(&dev->fifo, (uint8_t *) &data, sizeof(data));
 	
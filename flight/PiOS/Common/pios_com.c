@@ -366,6 +366,91 @@ int32_t PIOS_COM_SendBuffer(uint32_t com_id, const uint8_t *buffer, uint16_t len
 	return len;
 }
 
+/**
+* Reserves room for a package directly in the transmit buffer of a port
+* (blocking function). The caller writes the package in place and hands it
+* over with PIOS_COM_SendCommit(), nothing else may be sent on the port in
+* between.
+* \param[in] port COM port
+* \param[out] buffer where to write the package
+* \param[in] len package length
+* \return -1 if port not available
+* \return -2 if the package does not fit in the transmit buffer at all,
+*            use PIOS_COM_SendBuffer() instead
+* \return -3 if the transmit buffer did not drain in time
+* \return len on success
+*/
+int32_t PIOS_COM_SendReserve(uint32_t com_id, uint8_t **buffer, uint16_t len)
+{
+	struct pios_com_dev * com_dev = (struct pios_com_dev *)com_id;
+
+	if (!PIOS_COM_validate(com_dev)) {
+		/* Undefined COM port for this board (see pios_board.c) */
+		return -1;
+	}
+
+	PIOS_Assert(com_dev->has_tx);
+
+	if (len > fifoBuf_getSize(&com_dev->tx)) {
+		/* Can never be contiguous in this buffer */
+		return -2;
+	}
+
+	while (1) {
+		PIOS_IRQ_Disable();
+		*buffer = fifoBuf_reserve(&com_dev->tx, len);
+		PIOS_IRQ_Enable();
+
+		if (*buffer) {
+			return len;
+		}
+
+		/* Not enough room before the end of the buffer, wait for the transmitter to drain it */
+		if (com_dev->driver->tx_start) {
+			(com_dev->driver->tx_start)(com_dev->lower_id,
+						fifoBuf_getUsed(&com_dev->tx));
+		}
+#if defined(PIOS_INCLUDE_FREERTOS)
+		if (xSemaphoreTake(com_dev->tx_sem, 5000) != pdTRUE) {
+			return -3;
+		}
+#endif
+	}
+}
+
+/**
+* Sends a package written in place after PIOS_COM_SendReserve()
+* \param[in] port COM port
+* \param[in] len package length, at most the reserved length
+* \return -1 if port not available
+* \return number of bytes transmitted on success
+*/
+int32_t PIOS_COM_SendCommit(uint32_t com_id, uint16_t len)
+{
+	struct pios_com_dev * com_dev = (struct pios_com_dev *)com_id;
+
+	if (!PIOS_COM_validate(com_dev)) {
+		/* Undefined COM port for this board (see pios_board.c) */
+		return -1;
+	}
+
+	PIOS_Assert(com_dev->has_tx);
+
+	PIOS_IRQ_Disable();
+	fifoBuf_commit(&com_dev->tx, len);
+	PIOS_IRQ_Enable();
+
+	if (len > 0) {
+		/* More data has been put in the tx buffer, make sure the tx is started */
+		if (com_dev->driver->tx_start) {
+			com_dev->driver->tx_start(com_dev->lower_id,
+						  fifoBuf_getUsed(&com_dev->tx));
+		}
+	}
+
+	return (len);
+}
+
 /**
 * Sends a single character over given port
 * \param[in] port COM port
@@ -60,6 +60,7 @@ struct jedec_flash_dev {
 	bool claimed;
 	uint32_t device_type;
 	uint32_t capacity;
+	bool write_pending;
 	const struct pios_flash_jedec_cfg * cfg;
 #if defined(FLASH_FREERTOS)
 	xSemaphoreHandle transaction_lock;
@@ -77,6 +78,7 @@ static int32_t PIOS_Flash_Jedec_ClaimBus();
 static int32_t PIOS_Flash_Jedec_ReleaseBus();
 static int32_t PIOS_Flash_Jedec_WriteEnable();
 static int32_t PIOS_Flash_Jedec_Busy() ;
+static int32_t PIOS_Flash_Jedec_WaitReady();
 
 
 /**
@@ -90,6 +92,7 @@ static struct jedec_flash_dev * PIOS_Flash_Jedec_alloc(void)
 	if (!jedec_dev) return (NULL);
 	
 	jedec_dev->claimed = false;
+	jedec_dev->write_pending = false;
 	jedec_dev->magic = PIOS_JEDEC_DEV_MAGIC;
 #if defined(FLASH_FREERTOS)
 	jedec_dev->transaction_lock = xSemaphoreCreateMutex();
@@ -153,6 +156,38 @@ static int32_t PIOS_Flash_Jedec_Busy()
 	return status & JEDEC_STATUS_BUSY;
 }
 
+/**
+ * @brief Wait for the end of a page program started by an earlier write.
+ * The writes return as soon as the page is clocked out, so the caller can
+ * prepare the next page while the chip programs this one.
+ * @returns 0 if the flash is ready, -1 if the status could not be read
+ */
+static int32_t PIOS_Flash_Jedec_WaitReady()
+{
+	if(!flash_dev->write_pending)
+		return 0;
+
+#if defined(FLASH_FREERTOS)
+	int32_t busy;
+	while((busy = PIOS_Flash_Jedec_Busy()) > 0)
+		vTaskDelay(1);
+	if(busy < 0)
+		return -1;
+#else
+	// Query status this way to prevent accel chip locking us out
+	if(PIOS_Flash_Jedec_ClaimBus() < 0)
+		return -1;
+
+	PIOS_SPI_TransferByte(flash_dev->spi_id, JEDEC_READ_STATUS);
+	while(PIOS_SPI_TransferByte(flash_dev->spi_id, JEDEC_READ_STATUS) & JEDEC_STATUS_BUSY);
+
+	PIOS_Flash_Jedec_ReleaseBus();
+#endif
+
+	flash_dev->write_pending = false;
+	return 0;
+}
+
 /**
  * @brief Execute the write enable instruction and returns the status
  * @returns 0 if successful, -1 if unable to claim bus
@@ -162,6 +197,9 @@ static int32_t PIOS_Flash_Jedec_WriteEnable()
 	if(PIOS_Flash_Jedec_Validate(flash_dev) != 0)
 		return -1;
 
+	if(PIOS_Flash_Jedec_WaitReady() != 0)
+		return -1;
+
 	uint8_t out[] = {JEDEC_WRITE_ENABLE};
 	if(PIOS_Flash_Jedec_ClaimBus() != 0)
 		return -1;
@@ -251,6 +289,8 @@ int32_t PIOS_Flash_Jedec_ReadID()
 {
 	uint8_t out[] = {JEDEC_DEVICE_ID, 0, 0, 0};
 	uint8_t in[4];
+	if (PIOS_Flash_Jedec_WaitReady() != 0)
+		return -1;
 	if (PIOS_Flash_Jedec_ClaimBus() < 0) 
 		return -1;
 	
@@ -389,23 +429,9 @@ int32_t PIOS_Flash_Jedec_WriteData(uint32_t addr, uint8_t * data, uint16_t len)
 
 	PIOS_Flash_Jedec_ReleaseBus();
 
-	// Keep polling when bus is busy too
-#if defined(FLASH_FREERTOS)
-	while(PIOS_Flash_Jedec_Busy() != 0) {
-		vTaskDelay(1);
-	}
-#else
+	// The next command waits for the program to finish
+	flash_dev->write_pending = true;
 
-	// Query status this way to prevent accel chip locking us out
-	if(PIOS_Flash_Jedec_ClaimBus() < 0)
-		return -1;
-
-	PIOS_SPI_TransferByte(flash_dev->spi_id, JEDEC_READ_STATUS);
-	while(PIOS_SPI_TransferByte(flash_dev->spi_id, JEDEC_READ_STATUS) & JEDEC_STATUS_BUSY);
-	
-	PIOS_Flash_Jedec_ReleaseBus();
-
-#endif
 	return 0;
 }
 
@@ -463,16 +489,19 @@ int32_t PIOS_Flash_Jedec_WriteChunks(uint32_t addr, struct pios_flash_chunk * p_
 	}
 	PIOS_Flash_Jedec_ReleaseBus();
 
-	// Skip checking for busy with this to get OS running again fast
+	// Skip checking for busy with this to get OS running again fast, the
+	// next command waits for the program to finish
+	flash_dev->write_pending = true;
 
 	return 0;
 }
 
 /**
- * @brief Read data from a location in flash memory
+ * @brief Read data from a location in flash memory. Uses the fast read
+ * command, which every JEDEC part supports up to its highest SPI clock.
  * @param[in] addr Address in flash to write to
  * @param[in] data Pointer to data to write from flash
- * @param[in] len Length of data to write (max 256 bytes)
+ * @param[in] len Length of data to write, not limited to a page
  * @return Zero if success or error code
  * @retval -1 Unable to claim SPI bus
  */
@@ -481,11 +510,14 @@ int32_t PIOS_Flash_Jedec_ReadData(uint32_t addr, uint8_t * data, uint16_t len)
 	if(PIOS_Flash_Jedec_Validate(flash_dev) != 0)
 		return -1;
 
+	if(PIOS_Flash_Jedec_WaitReady() != 0)
+		return -1;
+
 	if(PIOS_Flash_Jedec_ClaimBus() == -1)
 		return -1;
 
-	/* Execute read command and clock in address.  Keep CS asserted */
-	uint8_t out[] = {JEDEC_READ_DATA, (addr >> 16) & 0xff, (addr >> 8) & 0xff , addr & 0xff};
+	/* Execute fast read command, clock in address and the dummy byte.  Keep CS asserted */
+	uint8_t out[] = {JEDEC_FAST_READ, (addr >> 16) & 0xff, (addr >> 8) & 0xff , addr & 0xff, 0};
 	
 	if(PIOS_SPI_TransferBlock(flash_dev->spi_id,out,NULL,sizeof(out),NULL) < 0) {
 		PIOS_Flash_Jedec_ReleaseBus();
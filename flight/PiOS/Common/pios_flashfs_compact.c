@@ -38,10 +38,26 @@
 static int32_t PIOS_FLASHFS_Compact_ClearObjectTableHeader();
 static int32_t PIOS_FLASHFS_Compact_GetObjAddress(uint32_t objId, uint16_t instId);
 static int32_t PIOS_FLASHFS_Compact_GetNewAddress(uint32_t objId, uint16_t instId);
+static void PIOS_FLASHFS_Compact_MarkStored(uint32_t objId, uint16_t instId);
+static bool PIOS_FLASHFS_Compact_MaybeStored(uint32_t objId, uint16_t instId);
+static bool PIOS_FLASHFS_Compact_IsErased(uint32_t addr, uint32_t len);
 
 // Private variables
 static int32_t numObjects = -1;
 
+// Objects in the table, one bit per hash of the ID. Loading an object that was never
+// saved, like most metaobjects at boot, then needs no table search at all.
+#define STORED_MAP_BITS 512
+static uint8_t storedMap[STORED_MAP_BITS / 8];
+
+// Table entry after the last one found. Objects are looked up in the order they were
+// first saved, so the next entry is usually the one searched for.
+static int32_t tableCursor;
+
+// The scratchpad is erased ahead of the save that needs it by
+// PIOS_FLASHFS_Compact_GarbageCollect(), so a save only erases the sector it rewrites
+static bool scratchpadErased;
+
 // Private structures
 // Header for objects in the file system table
 struct objectHeader {
@@ -112,6 +128,8 @@ int32_t PIOS_FLASHFS_Compact_Init(const struct flashfs_compact_cfg * new_cfg)
 	int32_t addr = cfg->addr_obj_table_start;
 	struct objectHeader header;
 	numObjects = 0;
+	tableCursor = 0;
+	memset(storedMap, 0, sizeof(storedMap));
 
 	// Loop through header area while objects detect to count how many saved
 	while (addr < cfg->addr_obj_table_end) {
@@ -125,10 +143,13 @@ int32_t PIOS_FLASHFS_Compact_Init(const struct flashfs_compact_cfg * new_cfg)
 		if (header.objMagic != cfg->obj_magic)
 			break;
 
+		PIOS_FLASHFS_Compact_MarkStored(header.objId, header.instId);
 		numObjects++;
 		addr += sizeof(header);
 	}
 
+	scratchpadErased = PIOS_FLASHFS_Compact_IsErased(cfg->addr_scratchpad, cfg->sector_size);
+
 	if (PIOS_Flash_Internal_EndTransaction() != 0) {
 		return -1;
 	}
@@ -156,6 +177,8 @@ int32_t PIOS_FLASHFS_Compact_Format()
 		return -1;
 	}
 
+	scratchpadErased = PIOS_FLASHFS_Compact_IsErased(cfg->addr_scratchpad, cfg->sector_size);
+
 	if (PIOS_Flash_Internal_EndTransaction() != 0) {
 		return -1;
 	}
@@ -163,6 +186,37 @@ int32_t PIOS_FLASHFS_Compact_Format()
 	return 0;
 }
 
+/**
+ * @brief Erase the scratchpad if the last save used it. Call this periodically
+ * from a low priority task at a time when an erase can not delay anything
+ * important, a save then only erases the sector it rewrites.
+ * @return 1 if the scratchpad was erased, 0 if there was nothing to do, -1 on failure
+ */
+int32_t PIOS_FLASHFS_Compact_GarbageCollect()
+{
+	int32_t ret = 0;
+
+	if (numObjects < 0)
+		return -1;
+
+	if (PIOS_Flash_Internal_StartTransaction() != 0)
+		return -1;
+
+	if (!scratchpadErased) {
+		if (PIOS_Flash_Internal_EraseSector(cfg->addr_scratchpad) == 0) {
+			scratchpadErased = true;
+			ret = 1;
+		} else {
+			ret = -1;
+		}
+	}
+
+	if (PIOS_Flash_Internal_EndTransaction() != 0)
+		return -1;
+
+	return ret;
+}
+
 /**
  * @brief Erase the headers for all objects in the flash chip
  * @return 0 if successful, -1 if not
@@ -192,27 +246,76 @@ static int32_t PIOS_FLASHFS_Compact_ClearObjectTableHeader()
  */
 static int32_t PIOS_FLASHFS_Compact_GetObjAddress(uint32_t objId, uint16_t instId)
 {
-	int32_t addr = cfg->addr_obj_table_start;
 	struct objectHeader header;
 
-	// Loop through header area while objects detect to count how many saved
-	while (addr < cfg->addr_obj_table_end) {
+	if (!PIOS_FLASHFS_Compact_MaybeStored(objId, instId))
+		return -1;
+
+	// Search the table starting at the cursor and wrap around
+	for (int32_t n = 0; n < numObjects; n++) {
+		int32_t entry = (tableCursor + n) % numObjects;
+		int32_t addr = cfg->addr_obj_table_start + sizeof(header) * entry;
+
 		// Read the instance data
 		if (PIOS_Flash_Internal_ReadData(addr, (uint8_t *) &header, sizeof(header)) != 0)
 			return -1;
 		if (header.objMagic != cfg->obj_magic)
-			break; // stop searching once hit first non-object header
-		else if (header.objId == objId && header.instId == instId)
-			break;
-		addr += sizeof(header);
+			return -1;
+		if (header.objId == objId && header.instId == instId) {
+			tableCursor = entry + 1;
+			return header.address;
+		}
 	}
 
-	if (header.objId == objId && header.instId == instId)
-		return header.address;
-
 	return -1;
 }
 
+/**
+ * @brief Position of an object in the map of stored objects
+ */
+static inline uint32_t PIOS_FLASHFS_Compact_StoredBit(uint32_t objId, uint16_t instId)
+{
+	return (objId ^ (objId >> 16) ^ instId) % STORED_MAP_BITS;
+}
+
+/**
+ * @brief Remember that an object has an entry in the table
+ */
+static void PIOS_FLASHFS_Compact_MarkStored(uint32_t objId, uint16_t instId)
+{
+	uint32_t bit = PIOS_FLASHFS_Compact_StoredBit(objId, instId);
+	storedMap[bit / 8] |= 1 << (bit % 8);
+}
+
+/**
+ * @brief Check if an object can have an entry in the table
+ * @return false if the object was never saved, true if it may have been
+ */
+static bool PIOS_FLASHFS_Compact_MaybeStored(uint32_t objId, uint16_t instId)
+{
+	uint32_t bit = PIOS_FLASHFS_Compact_StoredBit(objId, instId);
+	return (storedMap[bit / 8] & (1 << (bit % 8))) != 0;
+}
+
+/**
+ * @brief Check if a range of flash has not been written since it was erased
+ */
+static bool PIOS_FLASHFS_Compact_IsErased(uint32_t addr, uint32_t len)
+{
+	uint8_t buffer[8];
+
+	for (uint32_t i = 0; i < len; i += sizeof(buffer)) {
+		uint32_t chunk = (len - i < sizeof(buffer)) ? len - i : sizeof(buffer);
+		if (PIOS_Flash_Internal_ReadData(addr + i, buffer, chunk) != 0)
+			return false;
+		for (uint32_t j = 0; j < chunk; j++)
+			if (buffer[j] != 0xFF)
+				return false;
+	}
+
+	return true;
+}
+
 static uint32_t PIOS_FLASHFS_Compact_GetFileSize(UAVObjHandle objId)
 {
 	uint32_t objsize = 0;
@@ -298,9 +401,44 @@ int32_t PIOS_FLASHFS_Compact_GetNewAddress(uint32_t objId, uint16_t instId)
 	// This numObejcts value must stay consistent or there will be a break in the table
 	// and later the table will have bad values in it
 	numObjects++;
+	PIOS_FLASHFS_Compact_MarkStored(objId, instId);
 	return new_header.address;
 }
 
+/**
+ * @brief Compare a saved object with the data about to be written, the parts
+ * of the file are aligned to 16 bit as done by PIOS_Flash_Internal_WriteChunks()
+ * @return true if the file already holds exactly this header, data and CRC
+ */
+static bool PIOS_FLASHFS_Compact_ObjUnchanged(int32_t addr, const struct fileHeader * header, const uint8_t * data, uint16_t size, uint8_t crc)
+{
+	struct fileHeader flashHeader;
+	uint8_t buffer[8];
+	uint8_t crcFlash;
+
+	if (PIOS_Flash_Internal_ReadData(addr, (uint8_t *) &flashHeader, sizeof(flashHeader)) != 0)
+		return false;
+	if (memcmp(&flashHeader, header, sizeof(flashHeader)) != 0)
+		return false;
+
+	uint32_t temp_addr = addr + sizeof(flashHeader);
+	if (temp_addr & 1)
+		++temp_addr;
+	for (uint32_t i = 0; i < size; i += sizeof(buffer)) {
+		uint32_t len = (size - i < sizeof(buffer)) ? size - i : sizeof(buffer);
+		if (PIOS_Flash_Internal_ReadData(temp_addr + i, buffer, len) != 0)
+			return false;
+		if (memcmp(buffer, data + i, len) != 0)
+			return false;
+	}
+
+	temp_addr += size;
+	if (temp_addr & 1)
+		++temp_addr;
+	if (PIOS_Flash_Internal_ReadData(temp_addr, &crcFlash, sizeof(crcFlash)) != 0)
+		return false;
+	return crcFlash == crc;
+}
 
 /**
  * @brief Saves one object instance per sector
@@ -319,6 +457,7 @@ int32_t PIOS_FLASHFS_Compact_ObjSave(UAVObjHandle obj, uint16_t instId, uint8_t
 		return -1;
 
 	int32_t addr = PIOS_FLASHFS_Compact_GetObjAddress(objId, instId);
+	bool saved = (addr >= 0);
 
 	// Object currently not saved
 	if (addr < 0)
@@ -340,13 +479,47 @@ int32_t PIOS_FLASHFS_Compact_ObjSave(UAVObjHandle obj, uint16_t instId, uint8_t
 	crc = PIOS_CRC_updateCRC(0, (uint8_t *) &header, sizeof(header));
 	crc = PIOS_CRC_updateCRC(crc, (uint8_t *) data, UAVObjGetNumBytes(obj));
 
+	// Saving all settings mostly rewrites unchanged objects, skip the sector copy for those
+	if (saved && PIOS_FLASHFS_Compact_ObjUnchanged(addr, &header, data, UAVObjGetNumBytes(obj), crc)) {
+		if (PIOS_Flash_Internal_EndTransaction() != 0)
+			return -1;
+		return 0;
+	}
+
+	struct pios_flash_chunk chunks[3] = {
+		{
+			.addr = (uint8_t *) &header,
+			.len = sizeof(header),
+		},
+		{
+			.addr = (uint8_t *) data,
+			.len = UAVObjGetNumBytes(obj),
+		},
+		{
+			.addr = (uint8_t *) &crc,
+			.len = sizeof(crc),
+		}
+	};
+
+	// A new file in space that is still erased is written as it is, without any erase
+	if (!saved && PIOS_FLASHFS_Compact_IsErased(addr, header.size)) {
+		if (PIOS_Flash_Internal_WriteChunks(addr, chunks, NELEMENTS(chunks)) != 0) {
+			PIOS_Flash_Internal_EndTransaction();
+			return -1;
+		}
+		if (PIOS_Flash_Internal_EndTransaction() != 0)
+			return -1;
+		return 0;
+	}
+
 	//now this is ugly but necessary
 
-	//erase scratchpad
-	if (PIOS_Flash_Internal_EraseSector(cfg->addr_scratchpad) != 0) {
+	//erase scratchpad, unless PIOS_FLASHFS_Compact_GarbageCollect() already did
+	if (!scratchpadErased && PIOS_Flash_Internal_EraseSector(cfg->addr_scratchpad) != 0) {
 		PIOS_Flash_Internal_EndTransaction();
 		return -2;
 	}
+	scratchpadErased = false;
 
 	//copy current sector into scratchpad
 	uint32_t current_sector = addr - (addr % cfg->sector_size);
@@ -384,21 +557,6 @@ int32_t PIOS_FLASHFS_Compact_ObjSave(UAVObjHandle obj, uint16_t instId, uint8_t
 	}
 
 	//next write the new data to the current sector
-	struct pios_flash_chunk chunks[3] = {
-		{
-			.addr = (uint8_t *) &header,
-			.len = sizeof(header),
-		},
-		{
-			.addr = (uint8_t *) data,
-			.len = UAVObjGetNumBytes(obj),
-		},
-		{
-			.addr = (uint8_t *) &crc,
-			.len = sizeof(crc),
-		}
-	};
-
 	//write chunks will round len up to an even value for each chunk and fill with zeros
 	if (PIOS_Flash_Internal_WriteChunks(addr, chunks, NELEMENTS(chunks)) != 0) {
 		PIOS_Flash_Internal_EndTransaction();
@@ -0,0 +1,966 @@
+/**
+ ******************************************************************************
+ *
+ * @addtogroup PIOS PIOS Core hardware abstraction layer
+ * @{
+ * @addtogroup PIOS_FLASHFS_LOGFS Log structured flash filesystem
+ * @{
+ *
+ * @file       pios_flashfs_logfs.c
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      A log structured file system for storing UAVObject in flash chip
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "openpilot.h"
+#include "uavobjectmanager.h"
+
+#if defined(PIOS_INCLUDE_FLASH_LOGFS_SETTINGS)
+
+/*
+ * Objects are never rewritten in place. A save appends a new record at the head
+ * of the log and marks the previous record of that object obsolete, and as the
+ * record states only ever clear bits neither step needs an erase. Sectors are
+ * erased by PIOS_FLASHFS_GarbageCollect(), which moves the live records of the
+ * sector with the most obsolete data to the head of the log first. Saves hold
+ * erased sectors back so that the collection can make progress, also after a
+ * reset cut one short. flight/tests/logfs checks this on a simulated flash.
+ *
+ * Sector: sectorHeader, record, record, ..., erased space
+ * Record: slotHeader, object data, CRC
+ */
+
+#if !defined(PIOS_FLASHFS_LOGFS_MAX_SECTORS)
+#define PIOS_FLASHFS_LOGFS_MAX_SECTORS 32
+#endif
+
+#if !defined(PIOS_FLASHFS_LOGFS_MAX_OBJECTS)
+#define PIOS_FLASHFS_LOGFS_MAX_OBJECTS 128
+#endif
+
+// Record states, each one only clears bits of the one before
+#define SLOT_STATE_EMPTY     0xFFFFFFFF
+#define SLOT_STATE_RESERVED  0xFFFFFF00	/* Header written, data may be incomplete */
+#define SLOT_STATE_ACTIVE    0xFFFF0000	/* Live copy of the object */
+#define SLOT_STATE_OBSOLETE  0x00000000
+
+#define SECTOR_ERASED        0xFFFFFFFF
+
+// Erased sectors kept back from saves. A collection may use them, and one cut
+// short by a reset leaves one used until the next mount gets it back.
+#define MIN_ERASED_SECTORS   3
+
+#define FLASH_PAGE_SIZE      0x100
+#define COPY_BUFFER_SIZE     32
+
+// Private structures
+// Header at the start of every sector in use, the sequence orders the sectors in the log.
+// The magic comes last so that a complete magic also means a complete sequence.
+struct sectorHeader {
+	uint32_t sequence;
+	uint32_t magic;
+} __attribute__((packed));
+
+// Header of every record, the state must come first
+struct slotHeader {
+	uint32_t state;
+	uint32_t objId;
+	uint16_t instId;
+	uint16_t size;
+} __attribute__((packed));
+
+struct indexEntry {
+	uint32_t objId;
+	uint32_t addr;
+	uint16_t instId;
+};
+
+// Private functions
+static int32_t PIOS_FLASHFS_Mount();
+static int32_t PIOS_FLASHFS_MountSector(uint8_t sector);
+static int32_t PIOS_FLASHFS_ReadRecord(uint32_t addr, uint32_t end, struct slotHeader * header);
+static int32_t PIOS_FLASHFS_GetRecordAddress(uint32_t objId, uint16_t instId);
+static int32_t PIOS_FLASHFS_ScanRecordAddress(uint32_t objId, uint16_t instId);
+static int32_t PIOS_FLASHFS_AppendRecord(uint32_t objId, uint16_t instId, uint16_t size, const uint8_t * data, uint32_t src, int32_t previous, bool collecting);
+static int32_t PIOS_FLASHFS_ObsoleteRecord(uint32_t addr);
+static int32_t PIOS_FLASHFS_Reserve(uint32_t len, bool collecting);
+static int32_t PIOS_FLASHFS_OpenSector(bool useReserve);
+static void PIOS_FLASHFS_CloseSector();
+static int32_t PIOS_FLASHFS_CollectSector(bool useReserve);
+static int32_t PIOS_FLASHFS_WriteBytes(uint32_t addr, const uint8_t * data, uint32_t len);
+static int32_t PIOS_FLASHFS_CopyBytes(uint32_t src, uint32_t dst, uint32_t len);
+static int32_t PIOS_FLASHFS_IndexFind(uint32_t objId, uint16_t instId);
+static void PIOS_FLASHFS_IndexSet(uint32_t objId, uint16_t instId, uint32_t addr);
+static void PIOS_FLASHFS_IndexRemove(uint32_t objId, uint16_t instId);
+static void PIOS_FLASHFS_IndexClear();
+
+// Private variables
+static const struct flashfs_logfs_cfg * cfg;
+static bool initialized = false;
+static bool legacyErased;
+static uint8_t numSectors;
+
+// Sequence number of every sector, 0 if the sector is erased
+static uint32_t sectorSequence[PIOS_FLASHFS_LOGFS_MAX_SECTORS];
+// Bytes of every sector not holding live records, used to pick what to collect
+static uint32_t sectorObsolete[PIOS_FLASHFS_LOGFS_MAX_SECTORS];
+static uint32_t lastSequence;
+
+// Head of the log
+static int8_t activeSector;
+static uint32_t writeAddr;
+
+// Address of the live record of every object. Objects that do not fit are
+// found by scanning the log instead.
+static struct indexEntry objIndex[PIOS_FLASHFS_LOGFS_MAX_OBJECTS];
+static uint16_t objIndexUsed;
+static bool objIndexComplete;
+
+static inline uint32_t PIOS_FLASHFS_SectorAddr(uint8_t sector)
+{
+	return cfg->arena_start + sector * cfg->sector_size;
+}
+
+static inline uint8_t PIOS_FLASHFS_SectorOf(uint32_t addr)
+{
+	return (addr - cfg->arena_start) / cfg->sector_size;
+}
+
+static inline uint32_t PIOS_FLASHFS_RecordSize(uint16_t size)
+{
+	return sizeof(struct slotHeader) + size + sizeof(uint8_t);
+}
+
+static inline uint8_t PIOS_FLASHFS_HeaderCRC(const struct slotHeader * header)
+{
+	return PIOS_CRC_updateCRC(0, (uint8_t *) &header->objId, sizeof(*header) - sizeof(header->state));
+}
+
+static inline bool PIOS_FLASHFS_HeaderBlank(const struct slotHeader * header)
+{
+	return header->state == SLOT_STATE_EMPTY && header->objId == 0xFFFFFFFF &&
+		header->instId == 0xFFFF && header->size == 0xFFFF;
+}
+
+static inline uint32_t PIOS_FLASHFS_HeadFree()
+{
+	if (activeSector < 0)
+		return 0;
+	return PIOS_FLASHFS_SectorAddr(activeSector) + cfg->sector_size - writeAddr;
+}
+
+static uint8_t PIOS_FLASHFS_ErasedSectors()
+{
+	uint8_t erased = 0;
+	for (uint8_t sector = 0; sector < numSectors; sector++)
+		if (sectorSequence[sector] == 0)
+			erased++;
+	return erased;
+}
+
+/**
+ * @brief Initialize the log structured flash FS and recover the latest records
+ * @return 0 if success, -1 if failure
+ * @retval 1 The settings table of pios_flashfs_objlist was found and erased, the
+ * settings saved with it are lost
+ */
+int32_t PIOS_FLASHFS_Init(const struct flashfs_logfs_cfg * new_cfg)
+{
+	cfg = new_cfg;
+	initialized = false;
+	legacyErased = false;
+
+	numSectors = cfg->arena_size / cfg->sector_size;
+	if (numSectors > PIOS_FLASHFS_LOGFS_MAX_SECTORS)
+		numSectors = PIOS_FLASHFS_LOGFS_MAX_SECTORS;
+
+	// The head of the log, the erased sectors and one sector to collect
+	if (numSectors < MIN_ERASED_SECTORS + 2)
+		return -1;
+
+	if (PIOS_Flash_Jedec_StartTransaction() != 0)
+		return -1;
+
+	if (PIOS_FLASHFS_Mount() != 0) {
+		PIOS_Flash_Jedec_EndTransaction();
+		return -1;
+	}
+
+	if (PIOS_Flash_Jedec_EndTransaction() != 0)
+		return -1;
+
+	initialized = true;
+	return legacyErased ? 1 : 0;
+}
+
+/**
+ * @brief Erase the whole arena, this removes all objects
+ * @return 0 if successful, -1 if not
+ */
+int32_t PIOS_FLASHFS_Format()
+{
+	if (cfg == NULL)
+		return -1;
+
+	if (PIOS_Flash_Jedec_StartTransaction() != 0)
+		return -1;
+
+	for (uint8_t sector = 0; sector < numSectors; sector++) {
+		if (PIOS_Flash_Jedec_EraseSector(PIOS_FLASHFS_SectorAddr(sector)) != 0) {
+			PIOS_Flash_Jedec_EndTransaction();
+			return -1;
+		}
+		sectorSequence[sector] = 0;
+		sectorObsolete[sector] = 0;
+	}
+
+	lastSequence = 0;
+	activeSector = -1;
+	PIOS_FLASHFS_IndexClear();
+	initialized = true;
+
+	if (PIOS_Flash_Jedec_EndTransaction() != 0)
+		return -1;
+
+	return 0;
+}
+
+/**
+ * @brief Rebuild the sector state and the index from the flash contents
+ * @return 0 if successful, -1 if not
+ */
+static int32_t PIOS_FLASHFS_Mount()
+{
+	struct sectorHeader header;
+
+	lastSequence = 0;
+	activeSector = -1;
+	PIOS_FLASHFS_IndexClear();
+
+	for (uint8_t sector = 0; sector < numSectors; sector++) {
+		uint32_t addr = PIOS_FLASHFS_SectorAddr(sector);
+		if (PIOS_Flash_Jedec_ReadData(addr, (uint8_t *) &header, sizeof(header)) != 0)
+			return -1;
+
+		sectorSequence[sector] = 0;
+		sectorObsolete[sector] = 0;
+		if (header.magic == cfg->fs_magic && header.sequence != 0 && header.sequence != SECTOR_ERASED) {
+			sectorSequence[sector] = header.sequence;
+			if (header.sequence > lastSequence)
+				lastSequence = header.sequence;
+		} else if (header.magic != SECTOR_ERASED || header.sequence != SECTOR_ERASED) {
+			// Left by an erase cut short by a reset, or by another file system
+			if (sector == 0 && cfg->legacy_magic != 0 && header.sequence == cfg->legacy_magic)
+				legacyErased = true;
+			if (PIOS_Flash_Jedec_EraseSector(addr) != 0)
+				return -1;
+		}
+	}
+
+	// Replay the sectors oldest first so newer records of an object replace older ones
+	uint32_t sequence = 0;
+	while (true) {
+		int8_t next = -1;
+		for (uint8_t sector = 0; sector < numSectors; sector++)
+			if (sectorSequence[sector] > sequence && (next < 0 || sectorSequence[sector] < sectorSequence[next]))
+				next = sector;
+		if (next < 0)
+			break;
+
+		sequence = sectorSequence[next];
+		if (PIOS_FLASHFS_MountSector(next) != 0)
+			return -1;
+	}
+
+	// A collection cut short by a reset leaves its victim in place with an
+	// erased sector already taken. Get it back from sectors whose live records
+	// fit in the head of the log.
+	while (PIOS_FLASHFS_ErasedSectors() < MIN_ERASED_SECTORS - 1) {
+		int32_t ret = PIOS_FLASHFS_CollectSector(false);
+		if (ret < 0)
+			return -1;
+		if (ret == 0)
+			break;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Index the live records of a sector and make it the head of the log
+ * @return 0 if successful, -1 if not
+ */
+static int32_t PIOS_FLASHFS_MountSector(uint8_t sector)
+{
+	uint32_t addr = PIOS_FLASHFS_SectorAddr(sector) + sizeof(struct sectorHeader);
+	uint32_t end = PIOS_FLASHFS_SectorAddr(sector) + cfg->sector_size;
+	struct slotHeader header;
+	int32_t ret;
+
+	while ((ret = PIOS_FLASHFS_ReadRecord(addr, end, &header)) == 0) {
+		if (header.state == SLOT_STATE_ACTIVE) {
+			// A reset between writing a record and obsoleting the one it replaced
+			int32_t previous = PIOS_FLASHFS_IndexFind(header.objId, header.instId);
+			if (previous >= 0 && PIOS_FLASHFS_ObsoleteRecord(objIndex[previous].addr) != 0)
+				return -1;
+			PIOS_FLASHFS_IndexSet(header.objId, header.instId, addr);
+		} else {
+			sectorObsolete[sector] += PIOS_FLASHFS_RecordSize(header.size);
+		}
+		addr += PIOS_FLASHFS_RecordSize(header.size);
+	}
+	if (ret < 0)
+		return -1;
+
+	// Space after the last record is only usable if it is still erased
+	if (addr + sizeof(header) > end || !PIOS_FLASHFS_HeaderBlank(&header)) {
+		sectorObsolete[sector] += end - addr;
+		addr = end;
+	}
+
+	PIOS_FLASHFS_CloseSector();
+	activeSector = sector;
+	writeAddr = addr;
+
+	return 0;
+}
+
+/**
+ * @brief Read the header of the record at addr
+ * @param[in] end End of the sector
+ * @return 0 if a record was read, 1 if there are no more records, -1 on read errors
+ */
+static int32_t PIOS_FLASHFS_ReadRecord(uint32_t addr, uint32_t end, struct slotHeader * header)
+{
+	if (addr + sizeof(*header) > end)
+		return 1;
+
+	if (PIOS_Flash_Jedec_ReadData(addr, (uint8_t *) header, sizeof(*header)) != 0)
+		return -1;
+
+	// A state write cut short by a reset leaves some bits in between. Only a
+	// complete ACTIVE counts as live, and any start of OBSOLETE as obsolete
+	// since the record replacing it was finished first.
+	if (header->state != SLOT_STATE_EMPTY) {
+		if ((header->state & 0xFFFF0000) != 0xFFFF0000)
+			header->state = SLOT_STATE_OBSOLETE;
+		else if ((header->state & 0x0000FF00) == 0)
+			header->state = SLOT_STATE_ACTIVE;
+		else
+			header->state = SLOT_STATE_RESERVED;
+	}
+
+	switch (header->state) {
+	case SLOT_STATE_RESERVED:
+	case SLOT_STATE_ACTIVE:
+	case SLOT_STATE_OBSOLETE:
+		// A size running past the sector means the header itself is damaged
+		if (addr + PIOS_FLASHFS_RecordSize(header->size) > end)
+			return 1;
+		return 0;
+	default:
+		// Erased space, or a header write cut short by a reset
+		return 1;
+	}
+}
+
+/**
+ * @brief Get the address of the live record of an object
+ * @return address if successful, -1 if not found
+ */
+static int32_t PIOS_FLASHFS_GetRecordAddress(uint32_t objId, uint16_t instId)
+{
+	int32_t entry = PIOS_FLASHFS_IndexFind(objId, instId);
+	if (entry >= 0)
+		return objIndex[entry].addr;
+
+	if (!objIndexComplete)
+		return PIOS_FLASHFS_ScanRecordAddress(objId, instId);
+
+	return -1;
+}
+
+/**
+ * @brief Get the address of the live record of an object by reading the whole
+ * log, used for the objects that did not fit in the index
+ * @return address if successful, -1 if not found
+ */
+static int32_t PIOS_FLASHFS_ScanRecordAddress(uint32_t objId, uint16_t instId)
+{
+	int32_t found = -1;
+	uint32_t foundSequence = 0;
+	struct slotHeader header;
+
+	for (uint8_t sector = 0; sector < numSectors; sector++) {
+		if (sectorSequence[sector] == 0 || sectorSequence[sector] < foundSequence)
+			continue;
+
+		uint32_t addr = PIOS_FLASHFS_SectorAddr(sector) + sizeof(struct sectorHeader);
+		uint32_t end = PIOS_FLASHFS_SectorAddr(sector) + cfg->sector_size;
+		while (PIOS_FLASHFS_ReadRecord(addr, end, &header) == 0) {
+			if (header.state == SLOT_STATE_ACTIVE && header.objId == objId && header.instId == instId) {
+				found = addr;
+				foundSequence = sectorSequence[sector];
+			}
+			addr += PIOS_FLASHFS_RecordSize(header.size);
+		}
+	}
+
+	return found;
+}
+
+/**
+ * @brief Append a record to the log and make it the live copy of the object
+ * @param[in] data Object data, or NULL to copy data and CRC from the record at src
+ * @param[in] previous Record replaced by this one, made obsolete once this one is complete
+ * @param[in] collecting Called by the garbage collection, which may use the reserve
+ * @return address of the record if successful
+ * @retval -1 No room in the arena
+ * @retval -2 Flash access failed
+ */
+static int32_t PIOS_FLASHFS_AppendRecord(uint32_t objId, uint16_t instId, uint16_t size, const uint8_t * data, uint32_t src, int32_t previous, bool collecting)
+{
+	uint32_t len = PIOS_FLASHFS_RecordSize(size);
+
+	int32_t ret = PIOS_FLASHFS_Reserve(len, collecting);
+	if (ret != 0)
+		return ret;
+
+	// Making room may have collected the sector of the record being replaced
+	if (previous >= 0)
+		previous = PIOS_FLASHFS_GetRecordAddress(objId, instId);
+
+	struct slotHeader header = {
+		.state = SLOT_STATE_RESERVED,
+		.objId = objId,
+		.instId = instId,
+		.size = size,
+	};
+	uint32_t addr = writeAddr;
+
+	// With the header down the scans can step over the record whatever happens next
+	if (PIOS_FLASHFS_WriteBytes(addr, (uint8_t *) &header, sizeof(header)) != 0) {
+		sectorObsolete[activeSector] += cfg->sector_size - (addr - PIOS_FLASHFS_SectorAddr(activeSector));
+		writeAddr = PIOS_FLASHFS_SectorAddr(activeSector) + cfg->sector_size;
+		return -2;
+	}
+	writeAddr += len;
+
+	if (data) {
+		uint8_t crc = PIOS_FLASHFS_HeaderCRC(&header);
+		crc = PIOS_CRC_updateCRC(crc, data, size);
+		ret = PIOS_FLASHFS_WriteBytes(addr + sizeof(header), data, size);
+		if (ret == 0)
+			ret = PIOS_FLASHFS_WriteBytes(addr + sizeof(header) + size, &crc, sizeof(crc));
+	} else {
+		ret = PIOS_FLASHFS_CopyBytes(src + sizeof(header), addr + sizeof(header), size + sizeof(uint8_t));
+	}
+
+	uint32_t state = SLOT_STATE_ACTIVE;
+	if (ret == 0)
+		ret = PIOS_FLASHFS_WriteBytes(addr, (uint8_t *) &state, sizeof(state));
+	if (ret != 0) {
+		sectorObsolete[activeSector] += len;
+		return -2;
+	}
+
+	if (previous >= 0 && PIOS_FLASHFS_ObsoleteRecord(previous) != 0)
+		return -2;
+
+	PIOS_FLASHFS_IndexSet(objId, instId, addr);
+	return addr;
+}
+
+/**
+ * @brief Mark a record obsolete
+ * @return 0 if successful, -1 if not
+ */
+static int32_t PIOS_FLASHFS_ObsoleteRecord(uint32_t addr)
+{
+	struct slotHeader header;
+	uint32_t state = SLOT_STATE_OBSOLETE;
+
+	if (PIOS_Flash_Jedec_ReadData(addr, (uint8_t *) &header, sizeof(header)) != 0)
+		return -1;
+	if (PIOS_FLASHFS_WriteBytes(addr, (uint8_t *) &state, sizeof(state)) != 0)
+		return -1;
+
+	sectorObsolete[PIOS_FLASHFS_SectorOf(addr)] += PIOS_FLASHFS_RecordSize(header.size);
+	return 0;
+}
+
+/**
+ * @brief Make room for a record of len bytes at the head of the log
+ * @param[in] collecting Called by the garbage collection, which may use the reserve
+ * @return 0 if successful
+ * @retval -1 No room in the arena
+ * @retval -2 Flash access failed
+ */
+static int32_t PIOS_FLASHFS_Reserve(uint32_t len, bool collecting)
+{
+	if (len > cfg->sector_size - sizeof(struct sectorHeader))
+		return -1;
+
+	while (activeSector < 0 || writeAddr + len > PIOS_FLASHFS_SectorAddr(activeSector) + cfg->sector_size) {
+		if (collecting || PIOS_FLASHFS_ErasedSectors() >= MIN_ERASED_SECTORS)
+			return PIOS_FLASHFS_OpenSector(collecting);
+
+		// Only erase on the save path when PIOS_FLASHFS_GarbageCollect() has not kept up
+		int32_t ret = PIOS_FLASHFS_CollectSector(true);
+		if (ret <= 0)
+			return (ret < 0) ? ret : -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Check that a sector is completely erased
+ */
+static bool PIOS_FLASHFS_SectorBlank(uint32_t addr)
+{
+	uint8_t buffer[COPY_BUFFER_SIZE];
+
+	for (uint32_t offset = 0; offset < cfg->sector_size; offset += sizeof(buffer)) {
+		if (PIOS_Flash_Jedec_ReadData(addr + offset, buffer, sizeof(buffer)) != 0)
+			return false;
+		for (uint32_t i = 0; i < sizeof(buffer); i++)
+			if (buffer[i] != 0xFF)
+				return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Move the head of the log to the next erased sector
+ * @param[in] useReserve Allow taking the last erased sector
+ * @return 0 if successful
+ * @retval -1 No erased sector
+ * @retval -2 Flash access failed
+ */
+static int32_t PIOS_FLASHFS_OpenSector(bool useReserve)
+{
+	if (PIOS_FLASHFS_ErasedSectors() < (useReserve ? 1 : MIN_ERASED_SECTORS))
+		return -1;
+
+	// Take the erased sectors in turn, this spreads the erases over the whole arena
+	uint8_t start = (activeSector < 0) ? 0 : activeSector + 1;
+	for (uint8_t n = 0; n < numSectors; n++) {
+		uint8_t sector = (start + n) % numSectors;
+		if (sectorSequence[sector] != 0)
+			continue;
+
+		// The header alone does not show an erase cut short by a reset
+		uint32_t addr = PIOS_FLASHFS_SectorAddr(sector);
+		if (!PIOS_FLASHFS_SectorBlank(addr) && PIOS_Flash_Jedec_EraseSector(addr) != 0)
+			return -2;
+
+		struct sectorHeader header = {
+			.sequence = lastSequence + 1,
+			.magic = cfg->fs_magic,
+		};
+		if (PIOS_FLASHFS_WriteBytes(addr, (uint8_t *) &header, sizeof(header)) != 0)
+			return -2;
+
+		PIOS_FLASHFS_CloseSector();
+		lastSequence = header.sequence;
+		sectorSequence[sector] = header.sequence;
+		sectorObsolete[sector] = 0;
+		activeSector = sector;
+		writeAddr = addr + sizeof(header);
+		return 0;
+	}
+
+	return -1;
+}
+
+/**
+ * @brief Account the unused end of the head of the log before moving on
+ */
+static void PIOS_FLASHFS_CloseSector()
+{
+	if (activeSector < 0)
+		return;
+
+	sectorObsolete[activeSector] += PIOS_FLASHFS_SectorAddr(activeSector) + cfg->sector_size - writeAddr;
+	writeAddr = PIOS_FLASHFS_SectorAddr(activeSector) + cfg->sector_size;
+}
+
+/**
+ * @brief Move the live records out of the sector with the most obsolete data and erase it.
+ * Without an erased sector to fall back on only a sector whose live records fit in
+ * the head of the log is taken. The head itself is only taken once it is full.
+ * @param[in] useReserve Allow the live records to go to an erased sector
+ * @return 1 if a sector was erased, 0 if there is nothing to reclaim, -2 on flash errors
+ */
+static int32_t PIOS_FLASHFS_CollectSector(bool useReserve)
+{
+	int8_t victim = -1;
+	bool reserve = useReserve && PIOS_FLASHFS_ErasedSectors() > 0;
+	uint32_t headFree = PIOS_FLASHFS_HeadFree();
+
+	// Ties go to the oldest sector
+	for (uint8_t sector = 0; sector < numSectors; sector++) {
+		if (sectorSequence[sector] == 0 || sectorObsolete[sector] == 0)
+			continue;
+		if (sector == activeSector && headFree > 0)
+			continue;
+		if (!reserve && cfg->sector_size - sizeof(struct sectorHeader) - sectorObsolete[sector] > headFree)
+			continue;
+		if (victim < 0 || sectorObsolete[sector] > sectorObsolete[victim] ||
+				(sectorObsolete[sector] == sectorObsolete[victim] && sectorSequence[sector] < sectorSequence[victim]))
+			victim = sector;
+	}
+
+	if (victim < 0)
+		return 0;
+
+	uint32_t addr = PIOS_FLASHFS_SectorAddr(victim) + sizeof(struct sectorHeader);
+	uint32_t end = PIOS_FLASHFS_SectorAddr(victim) + cfg->sector_size;
+	struct slotHeader header;
+	int32_t ret;
+
+	// The copies are newer than the originals, so the sector need not be
+	// touched again before the erase
+	while ((ret = PIOS_FLASHFS_ReadRecord(addr, end, &header)) == 0) {
+		if (header.state == SLOT_STATE_ACTIVE &&
+				PIOS_FLASHFS_AppendRecord(header.objId, header.instId, header.size, NULL, addr, -1, true) < 0)
+			return -2;
+		addr += PIOS_FLASHFS_RecordSize(header.size);
+	}
+	if (ret < 0)
+		return -2;
+
+	if (PIOS_Flash_Jedec_EraseSector(PIOS_FLASHFS_SectorAddr(victim)) != 0)
+		return -2;
+
+	sectorSequence[victim] = 0;
+	sectorObsolete[victim] = 0;
+	if (victim == activeSector)
+		activeSector = -1;
+	return 1;
+}
+
+/**
+ * @brief Reclaim a sector when the log is running out of erased ones. Call this
+ * periodically from a low priority task at a time when an erase can not delay
+ * anything important.
+ * @return 1 if a sector was erased, 0 if there was nothing to do, -1 on failure
+ */
+int32_t PIOS_FLASHFS_GarbageCollect()
+{
+	int32_t ret = 0;
+
+	if (!initialized)
+		return -1;
+
+	if (PIOS_Flash_Jedec_StartTransaction() != 0)
+		return -1;
+
+	// Only take an erased sector while a reset can not leave the log short of them
+	uint8_t erased = PIOS_FLASHFS_ErasedSectors();
+	if (erased < MIN_ERASED_SECTORS + 1)
+		ret = PIOS_FLASHFS_CollectSector(erased >= MIN_ERASED_SECTORS);
+
+	if (PIOS_Flash_Jedec_EndTransaction() != 0)
+		return -1;
+
+	return (ret < 0) ? -1 : ret;
+}
+
+/**
+ * @brief Write data of any length, split at the flash page boundaries
+ * @return 0 if successful, -1 if not
+ */
+static int32_t PIOS_FLASHFS_WriteBytes(uint32_t addr, const uint8_t * data, uint32_t len)
+{
+	while (len > 0) {
+		uint32_t chunk = FLASH_PAGE_SIZE - (addr % FLASH_PAGE_SIZE);
+		if (chunk > len)
+			chunk = len;
+		if (PIOS_Flash_Jedec_WriteData(addr, (uint8_t *) data, chunk) != 0)
+			return -1;
+		addr += chunk;
+		data += chunk;
+		len -= chunk;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Copy data from one flash address to another
+ * @return 0 if successful, -1 if not
+ */
+static int32_t PIOS_FLASHFS_CopyBytes(uint32_t src, uint32_t dst, uint32_t len)
+{
+	uint8_t buffer[COPY_BUFFER_SIZE];
+
+	while (len > 0) {
+		uint32_t chunk = (len < sizeof(buffer)) ? len : sizeof(buffer);
+		if (PIOS_Flash_Jedec_ReadData(src, buffer, chunk) != 0)
+			return -1;
+		if (PIOS_FLASHFS_WriteBytes(dst, buffer, chunk) != 0)
+			return -1;
+		src += chunk;
+		dst += chunk;
+		len -= chunk;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Position of an object in the index
+ * @return entry if found, -1 if not
+ */
+static int32_t PIOS_FLASHFS_IndexFind(uint32_t objId, uint16_t instId)
+{
+	for (uint16_t n = 0; n < objIndexUsed; n++)
+		if (objIndex[n].objId == objId && objIndex[n].instId == instId)
+			return n;
+
+	return -1;
+}
+
+/**
+ * @brief Record the address of the live record of an object
+ */
+static void PIOS_FLASHFS_IndexSet(uint32_t objId, uint16_t instId, uint32_t addr)
+{
+	int32_t entry = PIOS_FLASHFS_IndexFind(objId, instId);
+
+	if (entry < 0) {
+		if (objIndexUsed >= PIOS_FLASHFS_LOGFS_MAX_OBJECTS) {
+			objIndexComplete = false;
+			return;
+		}
+		entry = objIndexUsed++;
+		objIndex[entry].objId = objId;
+		objIndex[entry].instId = instId;
+	}
+
+	objIndex[entry].addr = addr;
+}
+
+/**
+ * @brief Drop an object from the index
+ */
+static void PIOS_FLASHFS_IndexRemove(uint32_t objId, uint16_t instId)
+{
+	int32_t entry = PIOS_FLASHFS_IndexFind(objId, instId);
+
+	if (entry >= 0)
+		objIndex[entry] = objIndex[--objIndexUsed];
+}
+
+/**
+ * @brief Empty the index, it describes an empty log again
+ */
+static void PIOS_FLASHFS_IndexClear()
+{
+	objIndexUsed = 0;
+	objIndexComplete = true;
+}
+
+/**
+ * @brief Compare the live record of an object with the data about to be saved
+ * @return true if the record holds exactly this data with a valid CRC
+ */
+static bool PIOS_FLASHFS_RecordUnchanged(int32_t addr, uint32_t objId, uint16_t instId, const uint8_t * data, uint16_t size)
+{
+	struct slotHeader header;
+	uint8_t buffer[COPY_BUFFER_SIZE];
+	uint8_t crcFlash;
+
+	if (PIOS_Flash_Jedec_ReadData(addr, (uint8_t *) &header, sizeof(header)) != 0)
+		return false;
+	if (header.objId != objId || header.instId != instId || header.size != size)
+		return false;
+
+	addr += sizeof(header);
+	for (uint32_t i = 0; i < size; i += sizeof(buffer)) {
+		uint32_t len = (size - i < sizeof(buffer)) ? size - i : sizeof(buffer);
+		if (PIOS_Flash_Jedec_ReadData(addr + i, buffer, len) != 0)
+			return false;
+		if (memcmp(buffer, data + i, len) != 0)
+			return false;
+	}
+
+	if (PIOS_Flash_Jedec_ReadData(addr + size, &crcFlash, sizeof(crcFlash)) != 0)
+		return false;
+
+	return crcFlash == PIOS_CRC_updateCRC(PIOS_FLASHFS_HeaderCRC(&header), data, size);
+}
+
+/**
+ * @brief Save an object instance by appending it to the log
+ * @param[in] obj UAVObjHandle the object to save
+ * @param[in] instId The instance of the object to save
+ * @return 0 if success or error code
+ * @retval -1 if no room in the arena
+ * @retval -2 if unable to write the record
+ */
+int32_t PIOS_FLASHFS_ObjSave(UAVObjHandle obj, uint16_t instId, uint8_t * data)
+{
+	uint32_t objId = UAVObjGetID(obj);
+	uint16_t objSize = UAVObjGetNumBytes(obj);
+
+	if (!initialized)
+		return -1;
+
+	if (PIOS_Flash_Jedec_StartTransaction() != 0)
+		return -1;
+
+	int32_t addr = PIOS_FLASHFS_GetRecordAddress(objId, instId);
+
+	// Saving all settings mostly rewrites unchanged objects, they need no new record
+	if (addr >= 0 && PIOS_FLASHFS_RecordUnchanged(addr, objId, instId, data, objSize)) {
+		if (PIOS_Flash_Jedec_EndTransaction() != 0)
+			return -1;
+		return 0;
+	}
+
+	int32_t ret = PIOS_FLASHFS_AppendRecord(objId, instId, objSize, data, 0, addr, false);
+
+	if (PIOS_Flash_Jedec_EndTransaction() != 0)
+		return -1;
+
+	return (ret < 0) ? ret : 0;
+}
+
+/**
+ * @brief Load the live record of an object instance
+ * @param[in] obj UAVObjHandle the object to load
+ * @param[in] instId The instance of the object to load
+ * @return 0 if success or error code
+ * @retval -1 if object not in the log
+ * @retval -2 if unable to retrieve the record header
+ * @retval -3 if the record objId, instId or size don't match
+ * @retval -4 if unable to retrieve instance data
+ * @retval -5 if unable to read CRC
+ * @retval -6 if CRC doesn't match
+ */
+int32_t PIOS_FLASHFS_ObjLoad(UAVObjHandle obj, uint16_t instId, uint8_t * data)
+{
+	uint32_t objId = UAVObjGetID(obj);
+	uint16_t objSize = UAVObjGetNumBytes(obj);
+	uint8_t buffer[COPY_BUFFER_SIZE];
+	uint8_t crcFlash;
+
+	if (!initialized)
+		return -1;
+
+	if (PIOS_Flash_Jedec_StartTransaction() != 0)
+		return -1;
+
+	int32_t addr = PIOS_FLASHFS_GetRecordAddress(objId, instId);
+
+	// Object currently not saved
+	if (addr < 0) {
+		PIOS_Flash_Jedec_EndTransaction();
+		return -1;
+	}
+
+	struct slotHeader header;
+	if (PIOS_Flash_Jedec_ReadData(addr, (uint8_t *) &header, sizeof(header)) != 0) {
+		PIOS_Flash_Jedec_EndTransaction();
+		return -2;
+	}
+
+	if (header.objId != objId || header.instId != instId || header.size != objSize) {
+		PIOS_Flash_Jedec_EndTransaction();
+		return -3;
+	}
+
+	// Check the CRC before touching the object data
+	uint8_t crc = PIOS_FLASHFS_HeaderCRC(&header);
+	for (uint32_t i = 0; i < objSize; i += sizeof(buffer)) {
+		uint32_t len = (objSize - i < sizeof(buffer)) ? objSize - i : sizeof(buffer);
+		if (PIOS_Flash_Jedec_ReadData(addr + sizeof(header) + i, buffer, len) != 0) {
+			PIOS_Flash_Jedec_EndTransaction();
+			return -4;
+		}
+		crc = PIOS_CRC_updateCRC(crc, buffer, len);
+	}
+
+	if (PIOS_Flash_Jedec_ReadData(addr + sizeof(header) + objSize, &crcFlash, sizeof(crcFlash)) != 0) {
+		PIOS_Flash_Jedec_EndTransaction();
+		return -5;
+	}
+
+	if (crc != crcFlash) {
+		PIOS_Flash_Jedec_EndTransaction();
+		return -6;
+	}
+
+	if (PIOS_Flash_Jedec_ReadData(addr + sizeof(header), data, objSize) != 0) {
+		PIOS_Flash_Jedec_EndTransaction();
+		return -4;
+	}
+
+	if (PIOS_Flash_Jedec_EndTransaction() != 0)
+		return -1;
+
+	return 0;
+}
+
+/**
+ * @brief Delete an object instance, its record is made obsolete and the space
+ * is reclaimed by the garbage collection
+ * @param[in] obj UAVObjHandle the object to delete
+ * @param[in] instId The instance of the object to delete
+ * @return 0 if success or error code
+ * @retval -1 if object not in the log
+ * @retval -2 if unable to mark the record obsolete
+ */
+int32_t PIOS_FLASHFS_ObjDelete(UAVObjHandle obj, uint16_t instId)
+{
+	uint32_t objId = UAVObjGetID(obj);
+
+	if (!initialized)
+		return -1;
+
+	if (PIOS_Flash_Jedec_StartTransaction() != 0)
+		return -1;
+
+	int32_t addr = PIOS_FLASHFS_GetRecordAddress(objId, instId);
+
+	// Object currently not saved
+	if (addr < 0) {
+		PIOS_Flash_Jedec_EndTransaction();
+		return -1;
+	}
+
+	if (PIOS_FLASHFS_ObsoleteRecord(addr) != 0) {
+		PIOS_Flash_Jedec_EndTransaction();
+		return -2;
+	}
+
+	PIOS_FLASHFS_IndexRemove(objId, instId);
+
+	if (PIOS_Flash_Jedec_EndTransaction() != 0)
+		return -1;
+
+	return 0;
+}
+
+#endif
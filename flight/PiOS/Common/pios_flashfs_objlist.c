@@ -36,10 +36,25 @@
 static int32_t PIOS_FLASHFS_ClearObjectTableHeader();
 static int32_t PIOS_FLASHFS_GetObjAddress(uint32_t objId, uint16_t instId);
 static int32_t PIOS_FLASHFS_GetNewAddress(uint32_t objId, uint16_t instId);
+static int32_t PIOS_FLASHFS_ScanObjAddress(uint32_t objId, uint16_t instId);
+static inline uint32_t PIOS_FLASHFS_ObjHash(uint32_t objId, uint16_t instId);
+static void PIOS_FLASHFS_IndexClear();
+static void PIOS_FLASHFS_IndexInsert(uint32_t objId, uint16_t instId, int32_t entry);
 
 // Private variables
 static int32_t numObjects = -1;
 
+// RAM index of the object table, built by PIOS_FLASHFS_Init() and kept current by
+// PIOS_FLASHFS_GetNewAddress(). Open addressing on a hash of (objId, instId), each
+// slot holds the table entry + 1 in the low byte and 8 more bits of the hash in the
+// high byte, so most probes that do not match need no flash read. Once the index
+// is full the entries that did not fit are found by scanning the table.
+#define OBJ_INDEX_SLOTS    128
+#define OBJ_INDEX_ENTRIES  96
+static uint16_t objIndex[OBJ_INDEX_SLOTS];
+static uint16_t objIndexUsed;
+static bool objIndexComplete;
+
 // Private structures
 // Header for objects in the file system table
 struct objectHeader {
@@ -97,6 +112,7 @@ int32_t PIOS_FLASHFS_Init(const struct flashfs_cfg * new_cfg)
 	int32_t addr = cfg->obj_table_start;
 	struct objectHeader header;
 	numObjects = 0;
+	PIOS_FLASHFS_IndexClear();
 
 	// Loop through header area while objects detect to count how many saved
 	while(addr < cfg->obj_table_end) {
@@ -108,6 +124,7 @@ int32_t PIOS_FLASHFS_Init(const struct flashfs_cfg * new_cfg)
 		if(header.objMagic != cfg->obj_magic)
 			break;
 
+		PIOS_FLASHFS_IndexInsert(header.objId, header.instId, numObjects);
 		numObjects++;
 		addr += sizeof(header);
 	}
@@ -145,6 +162,10 @@ static int32_t PIOS_FLASHFS_ClearObjectTableHeader()
 	if(object_table_magic != cfg->table_magic)
 		return -1;
 
+	// The table is empty now
+	numObjects = 0;
+	PIOS_FLASHFS_IndexClear();
+
 	return 0;
 }
 
@@ -155,6 +176,37 @@ static int32_t PIOS_FLASHFS_ClearObjectTableHeader()
  * @return address if successful, -1 if not found
  */
 static int32_t PIOS_FLASHFS_GetObjAddress(uint32_t objId, uint16_t instId)
+{
+	uint32_t hash = PIOS_FLASHFS_ObjHash(objId, instId);
+	struct objectHeader header;
+
+	for (uint32_t n = 0; n < OBJ_INDEX_SLOTS; n++) {
+		uint16_t slot = objIndex[((hash >> 16) + n) % OBJ_INDEX_SLOTS];
+		if (slot == 0)
+			break;
+		if ((slot >> 8) != (hash >> 24))
+			continue;
+
+		// Check the candidate, the hash bits are not unique
+		int32_t addr = cfg->obj_table_start + sizeof(header) * ((slot & 0xFF) - 1);
+		if (PIOS_Flash_Jedec_ReadData(addr, (uint8_t *) &header, sizeof(header)) != 0)
+			return -1;
+		if (header.objMagic == cfg->obj_magic && header.objId == objId && header.instId == instId)
+			return header.address;
+	}
+
+	if (!objIndexComplete)
+		return PIOS_FLASHFS_ScanObjAddress(objId, instId);
+
+	return -1;
+}
+
+/**
+ * @brief Get the address of an object by reading the whole table, used for
+ * the objects that did not fit in the index
+ * @return address if successful, -1 if not found
+ */
+static int32_t PIOS_FLASHFS_ScanObjAddress(uint32_t objId, uint16_t instId)
 {
 	int32_t addr = cfg->obj_table_start;
 	struct objectHeader header;
@@ -177,6 +229,48 @@ static int32_t PIOS_FLASHFS_GetObjAddress(uint32_t objId, uint16_t instId)
 	return -1;
 }
 
+/**
+ * @brief Hash of an object for the index, bits 16-22 pick the slot and the top byte is kept in it
+ */
+static inline uint32_t PIOS_FLASHFS_ObjHash(uint32_t objId, uint16_t instId)
+{
+	return (objId ^ ((uint32_t) instId << 16)) * 2654435761UL;
+}
+
+/**
+ * @brief Empty the index, it describes an empty table again
+ */
+static void PIOS_FLASHFS_IndexClear()
+{
+	memset(objIndex, 0, sizeof(objIndex));
+	objIndexUsed = 0;
+	objIndexComplete = true;
+}
+
+/**
+ * @brief Add a table entry to the index
+ * @param[in] entry The position of the entry in the object table
+ */
+static void PIOS_FLASHFS_IndexInsert(uint32_t objId, uint16_t instId, int32_t entry)
+{
+	uint32_t hash = PIOS_FLASHFS_ObjHash(objId, instId);
+
+	// Keep the index sparse enough for short probes, the rest is found by scanning
+	if (objIndexUsed >= OBJ_INDEX_ENTRIES || entry >= 0xFF) {
+		objIndexComplete = false;
+		return;
+	}
+
+	for (uint32_t n = 0; n < OBJ_INDEX_SLOTS; n++) {
+		uint16_t * slot = &objIndex[((hash >> 16) + n) % OBJ_INDEX_SLOTS];
+		if (*slot == 0) {
+			*slot = ((hash >> 24) << 8) | (entry + 1);
+			objIndexUsed++;
+			return;
+		}
+	}
+}
+
 /**
  * @brief Returns an address for a new object and creates entry into object table
  * @param[in] obj Object handle for object to be saved
@@ -216,10 +310,39 @@ int32_t PIOS_FLASHFS_GetNewAddress(uint32_t objId, uint16_t instId)
 
 	// This numObejcts value must stay consistent or there will be a break in the table
 	// and later the table will have bad values in it
+	PIOS_FLASHFS_IndexInsert(objId, instId, numObjects);
 	numObjects++;
 	return header.address;
 }
 
+/**
+ * @brief Compare a saved object with the data about to be written
+ * @return true if the sector already holds exactly this header, data and CRC
+ */
+static bool PIOS_FLASHFS_ObjUnchanged(int32_t addr, const struct fileHeader * header, const uint8_t * data, uint8_t crc)
+{
+	struct fileHeader flashHeader;
+	uint8_t buffer[8];
+	uint8_t crcFlash;
+
+	if (PIOS_Flash_Jedec_ReadData(addr, (uint8_t *) &flashHeader, sizeof(flashHeader)) != 0)
+		return false;
+	if (memcmp(&flashHeader, header, sizeof(flashHeader)) != 0)
+		return false;
+
+	addr += sizeof(flashHeader);
+	for (uint32_t i = 0; i < header->size; i += sizeof(buffer)) {
+		uint32_t len = (header->size - i < sizeof(buffer)) ? header->size - i : sizeof(buffer);
+		if (PIOS_Flash_Jedec_ReadData(addr + i, buffer, len) != 0)
+			return false;
+		if (memcmp(buffer, data + i, len) != 0)
+			return false;
+	}
+
+	if (PIOS_Flash_Jedec_ReadData(addr + header->size, &crcFlash, sizeof(crcFlash)) != 0)
+		return false;
+	return crcFlash == crc;
+}
 
 /**
  * @brief Saves one object instance per sector
@@ -238,6 +361,7 @@ int32_t PIOS_FLASHFS_ObjSave(UAVObjHandle obj, uint16_t instId, uint8_t * data)
 		return -1;
 
 	int32_t addr = PIOS_FLASHFS_GetObjAddress(objId, instId);
+	bool saved = (addr >= 0);
 
 	// Object currently not saved
 	if(addr < 0)
@@ -259,6 +383,13 @@ int32_t PIOS_FLASHFS_ObjSave(UAVObjHandle obj, uint16_t instId, uint8_t * data)
 	crc = PIOS_CRC_updateCRC(0, (uint8_t *) &header, sizeof(header));
 	crc = PIOS_CRC_updateCRC(crc, (uint8_t *) data, UAVObjGetNumBytes(obj));
 
+	// Saving all settings mostly rewrites unchanged objects, skip the erase and write for those
+	if(saved && PIOS_FLASHFS_ObjUnchanged(addr, &header, data, crc)) {
+		if(PIOS_Flash_Jedec_EndTransaction() != 0)
+			return -1;
+		return 0;
+	}
+
 	if(PIOS_Flash_Jedec_EraseSector(addr) != 0) {
 		PIOS_Flash_Jedec_EndTransaction();
 		return -2;
@@ -312,7 +443,7 @@ int32_t PIOS_FLASHFS_ObjLoad(UAVObjHandle obj, uint16_t instId, uint8_t * data)
 	uint16_t objSize = UAVObjGetNumBytes(obj);
 	uint8_t crc = 0;
 	uint8_t crcFlash = 0;
-	const uint8_t crc_read_step = 8;
+	const uint8_t crc_read_step = 32;
 	uint8_t crc_read_buffer[crc_read_step];
 
 	if(PIOS_Flash_Jedec_StartTransaction() != 0)
@@ -43,9 +43,52 @@ volatile bool pios_hmc5883_data_ready;
 static int32_t PIOS_HMC5883_Config(const struct pios_hmc5883_cfg * cfg);
 static int32_t PIOS_HMC5883_Read(uint8_t address, uint8_t * buffer, uint8_t len);
 static int32_t PIOS_HMC5883_Write(uint8_t address, uint8_t buffer);
+static void PIOS_HMC5883_Convert(const uint8_t buffer[6], int16_t out[3]);
 
 static const struct pios_hmc5883_cfg * dev_cfg;
 
+/* Queued reads, see PIOS_HMC5883_StartReadMag() */
+static uint8_t read_address = PIOS_HMC5883_DATAOUT_XMSB_REG;
+static uint8_t read_buffer[6];
+static uint8_t mode_command[] = {
+	PIOS_HMC5883_MODE_REG,
+	PIOS_HMC5883_MODE_CONTINUOUS,
+};
+static const struct pios_i2c_txn read_txn_list[] = {
+	{
+		.info = "PIOS_HMC5883_StartReadMag",
+		.addr = PIOS_HMC5883_I2C_ADDR,
+		.rw = PIOS_I2C_TXN_WRITE,
+		.len = sizeof(read_address),
+		.buf = &read_address,
+	},
+	{
+		.info = "PIOS_HMC5883_StartReadMag",
+		.addr = PIOS_HMC5883_I2C_ADDR,
+		.rw = PIOS_I2C_TXN_READ,
+		.len = sizeof(read_buffer),
+		.buf = read_buffer,
+	},
+};
+static const struct pios_i2c_txn mode_txn_list[] = {
+	{
+		.info = "PIOS_HMC5883_StartReadMag",
+		.addr = PIOS_HMC5883_I2C_ADDR,
+		.rw = PIOS_I2C_TXN_WRITE,
+		.len = sizeof(mode_command),
+		.buf = mode_command,
+	},
+};
+static struct pios_i2c_request read_request = {
+	.txn_list = read_txn_list,
+	.num_txns = NELEMENTS(read_txn_list),
+};
+static struct pios_i2c_request mode_request = {
+	.txn_list = mode_txn_list,
+	.num_txns = NELEMENTS(mode_txn_list),
+};
+static bool read_started;
+
 /**
  * @brief Initialize the HMC5883 magnetometer sensor.
  * @return none
@@ -157,13 +200,73 @@ int32_t PIOS_HMC5883_ReadMag(int16_t out[3])
 {
 	pios_hmc5883_data_ready = false;
 	uint8_t buffer[6];
-	int32_t temp;
-	int32_t sensitivity;
 	
 	if (PIOS_HMC5883_Read(PIOS_HMC5883_DATAOUT_XMSB_REG, buffer, 6) != 0) {
 		return -1;
 	}
-		
+	PIOS_HMC5883_Convert(buffer, out);
+	
+	// This should not be necessary but for some reason it is coming out of continuous conversion mode
+	PIOS_HMC5883_Write(PIOS_HMC5883_MODE_REG, PIOS_HMC5883_MODE_CONTINUOUS);
+	
+	return 0;
+}
+
+/**
+ * @brief Queue a read of the X, Z, Y values and return at once, the values
+ * are collected with PIOS_HMC5883_FinishReadMag(). The mode register is
+ * rewritten right after the read as in PIOS_HMC5883_ReadMag().
+ * \return 0 if queued, -1 if the previous read was not collected yet or is
+ * given up because it did not finish
+ */
+int32_t PIOS_HMC5883_StartReadMag(void)
+{
+	/* A read still running when the next one is due is stuck on the bus */
+	if (read_request.result == PIOS_I2C_PENDING || mode_request.result == PIOS_I2C_PENDING) {
+		PIOS_I2C_Cancel(PIOS_I2C_MAIN_ADAPTER, &read_request);
+		PIOS_I2C_Cancel(PIOS_I2C_MAIN_ADAPTER, &mode_request);
+		return -1;
+	}
+	if (read_started)
+		return -1;
+	
+	pios_hmc5883_data_ready = false;
+	read_started = true;
+	PIOS_I2C_Queue(PIOS_I2C_MAIN_ADAPTER, &read_request);
+	PIOS_I2C_Queue(PIOS_I2C_MAIN_ADAPTER, &mode_request);
+	return 0;
+}
+
+/**
+ * @brief Collect the values of the read queued by PIOS_HMC5883_StartReadMag()
+ * \param[out] int16_t array of size 3 to store X, Z, and Y magnetometer readings
+ * \return 0 for success, 1 while the read is in progress or -1 for failure or if no read was started
+ */
+int32_t PIOS_HMC5883_FinishReadMag(int16_t out[3])
+{
+	if (!read_started)
+		return -1;
+
+	/* Move the bus on, also to the mode write queued after the read */
+	PIOS_I2C_Poll(PIOS_I2C_MAIN_ADAPTER);
+	if (read_request.result == PIOS_I2C_PENDING)
+		return 1;
+	
+	read_started = false;
+	if (read_request.result != 0)
+		return -1;
+	PIOS_HMC5883_Convert(read_buffer, out);
+	return 0;
+}
+
+/**
+ * @brief Scale the raw X, Z, Y registers to the configured gain
+ */
+static void PIOS_HMC5883_Convert(const uint8_t buffer[6], int16_t out[3])
+{
+	int32_t temp;
+	int32_t sensitivity;
+	
 	switch (CTRLB & 0xE0) {
 		case 0x00:
 			sensitivity =  PIOS_HMC5883_Sensitivity_0_88Ga;
@@ -202,11 +305,6 @@ int32_t PIOS_HMC5883_ReadMag(int16_t out[3])
 	temp = out[2];
 	out[2] = out[1];
 	out[1] = temp;
-	
-	// This should not be necessary but for some reason it is coming out of continuous conversion mode
-	PIOS_HMC5883_Write(PIOS_HMC5883_MODE_REG, PIOS_HMC5883_MODE_CONTINUOUS);
-	
-	return 0;
 }
 
 
@@ -286,6 +286,7 @@ int32_t PIOS_L3GD20_ReadGyros(struct pios_l3gd20_data * data)
 		
 	PIOS_L3GD20_ReleaseBus();
 	
+	data->time = PIOS_DELAY_GetRaw();
 	memcpy((uint8_t *) &(data->gyro_x), &rec[1], 6);
 	data->temperature = PIOS_L3GD20_GetReg(PIOS_L3GD20_OUT_TEMP);
 	
@@ -358,6 +359,7 @@ bool PIOS_L3GD20_IRQHandler(void)
 	l3gd20_irq++;
 
 	struct pios_l3gd20_data data;
+	data.time = PIOS_DELAY_GetRaw();
 	uint8_t buf[7] = {PIOS_L3GD20_GYRO_X_OUT_LSB | 0x80 | 0x40, 0, 0, 0, 0, 0, 0};
 	uint8_t rec[7];
 
@@ -34,6 +34,10 @@
 
 #if defined(PIOS_INCLUDE_MPU6000)
 
+/* Private constants */
+#define MPU6000_TASK_PRIORITY	(tskIDLE_PRIORITY + 3)
+#define MPU6000_TASK_STACK		(384 / 4)
+
 #include "fifo_buffer.h"
 
 /* Global Variables */
@@ -42,11 +46,14 @@ enum pios_mpu6000_dev_magic {
 	PIOS_MPU6000_DEV_MAGIC = 0x9da9b3ed,
 };
 
-#define PIOS_MPU6000_MAX_DOWNSAMPLE 2
+#define PIOS_MPU6000_MAX_DOWNSAMPLE (2 * PIOS_MPU6000_MAX_BURST)
 struct mpu6000_dev {
 	uint32_t spi_id;
 	uint32_t slave_num;
 	xQueueHandle queue;
+	xTaskHandle TaskHandle;
+	xSemaphoreHandle data_ready_sema;
+	volatile uint32_t irq_time;
 	const struct pios_mpu6000_cfg * cfg;
 	enum pios_mpu6000_dev_magic magic;
 };
@@ -61,6 +68,7 @@ static int32_t PIOS_MPU6000_Validate(struct mpu6000_dev * dev);
 static void PIOS_MPU6000_Config(struct pios_mpu6000_cfg const * cfg);
 static int32_t PIOS_MPU6000_SetReg(uint8_t address, uint8_t buffer);
 static int32_t PIOS_MPU6000_GetReg(uint8_t address);
+static void PIOS_MPU6000_Task(void *parameters);
 
 #define DEG_TO_RAD (M_PI / 180.0)
 
@@ -84,6 +92,13 @@ static struct mpu6000_dev * PIOS_MPU6000_alloc(void)
 		return NULL;
 	}
 	
+	vSemaphoreCreateBinary(mpu6000_dev->data_ready_sema);
+	if(mpu6000_dev->data_ready_sema == NULL) {
+		vPortFree(mpu6000_dev);
+		return NULL;
+	}
+	xSemaphoreTake(mpu6000_dev->data_ready_sema, 0);
+
 	return(mpu6000_dev);
 }
 
@@ -121,6 +136,16 @@ int32_t PIOS_MPU6000_Init(uint32_t spi_id, uint32_t slave_num, const struct pios
 	PIOS_MPU6000_Config(cfg);
 	PIOS_SPI_SetClockSpeed(dev->spi_id, PIOS_SPI_PRESCALER_16);
 
+	int result = xTaskCreate(
+		PIOS_MPU6000_Task,
+		(const signed char *)"PIOS_MPU6000_Task",
+		MPU6000_TASK_STACK,
+		NULL,
+		MPU6000_TASK_PRIORITY,
+		&dev->TaskHandle
+	);
+	PIOS_Assert(result == pdPASS);
+
 	/* Set up EXTI line */
 	PIOS_EXTI_Init(cfg->exti_cfg);
 	return 0;
@@ -283,6 +308,7 @@ int32_t PIOS_MPU6000_ReadGyros(struct pios_mpu6000_data * data)
 		
 	PIOS_MPU6000_ReleaseBus();
 	
+	data->time = PIOS_DELAY_GetRaw();
 	data->gyro_x = rec[1] << 8 | rec[2];
 	data->gyro_y = rec[3] << 8 | rec[4];
 	data->gyro_z = rec[5] << 8 | rec[6];
@@ -364,30 +390,27 @@ uint8_t PIOS_MPU6000_Test(void)
 }
 
 /**
- * @brief Run self-test operation.
- * \return 0 if test succeeded
- * \return non-zero value if test succeeded
+ * @brief Read the number of bytes waiting in the FIFO. The bus must already
+ * be claimed, the chip select is cycled afterwards so the next transfer starts
+ * a new register access.
+ * \return FIFO depth in bytes or -1 if the transfer failed
  */
 static int32_t PIOS_MPU6000_FifoDepth(void)
 {
 	uint8_t mpu6000_send_buf[3] = {PIOS_MPU6000_FIFO_CNT_MSB | 0x80, 0, 0};
 	uint8_t mpu6000_rec_buf[3];
 
-	if(PIOS_MPU6000_ClaimBus() != 0)
+	if(PIOS_SPI_TransferBlock(dev->spi_id, &mpu6000_send_buf[0], &mpu6000_rec_buf[0], sizeof(mpu6000_send_buf), NULL) < 0)
 		return -1;
 
-	if(PIOS_SPI_TransferBlock(dev->spi_id, &mpu6000_send_buf[0], &mpu6000_rec_buf[0], sizeof(mpu6000_send_buf), NULL) < 0) {
-		PIOS_MPU6000_ReleaseBus();
-		return -1;
-	}
+	PIOS_SPI_RC_PinSet(dev->spi_id,dev->slave_num,1);
+	PIOS_SPI_RC_PinSet(dev->spi_id,dev->slave_num,0);
 
-	PIOS_MPU6000_ReleaseBus();
-	
 	return (mpu6000_rec_buf[1] << 8) | mpu6000_rec_buf[2];
 }
 
 /**
-* @brief IRQ Handler.  Read all the data from onboard buffer
+* @brief IRQ Handler.  Wakes the task that reads the onboard buffer
 */
 uint32_t mpu6000_irq = 0;
 int32_t mpu6000_count;
@@ -400,73 +423,125 @@ uint32_t mpu6000_interval_us;
 uint32_t mpu6000_time_us;
 uint32_t mpu6000_transfer_size;
 
+// Burst read in flight. The task drains the FIFO with one DMA transfer of
+// whole samples and the completion callback queues them, so nothing spins on
+// the SPI for every sample. mpu6000_burst_count is zero when idle.
+static uint8_t mpu6000_burst_send_buf[1 + PIOS_MPU6000_MAX_BURST * PIOS_MPU6000_SAMPLE_SIZE] = {PIOS_MPU6000_FIFO_REG | 0x80};
+static uint8_t mpu6000_burst_rec_buf[1 + PIOS_MPU6000_MAX_BURST * PIOS_MPU6000_SAMPLE_SIZE];
+static volatile uint8_t mpu6000_burst_count = 0;
+static uint32_t mpu6000_burst_time;
+
+static void PIOS_MPU6000_BurstComplete(uint8_t crc_ok, uint8_t crc_val);
+
 bool PIOS_MPU6000_IRQHandler(void)
 {
+	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
 	static uint32_t timeval;
 	mpu6000_interval_us = PIOS_DELAY_DiffuS(timeval);
 	timeval = PIOS_DELAY_GetRaw();
 
-	if(!mpu6000_configured)
+	if(PIOS_MPU6000_Validate(dev) != 0)
 		return false;
 
-	mpu6000_count = PIOS_MPU6000_FifoDepth();
-	if(mpu6000_count < sizeof(struct pios_mpu6000_data))
-		return false;
-		
-	if(PIOS_MPU6000_ClaimBus() != 0)
-		return false;
-		
-	uint8_t mpu6000_send_buf[1+sizeof(struct pios_mpu6000_data)] = {PIOS_MPU6000_FIFO_REG | 0x80, 0, 0, 0, 0, 0, 0, 0, 0};
-	uint8_t mpu6000_rec_buf[1+sizeof(struct pios_mpu6000_data)];
-	
-	if(PIOS_SPI_TransferBlock(dev->spi_id, &mpu6000_send_buf[0], &mpu6000_rec_buf[0], sizeof(mpu6000_send_buf), NULL) < 0) {
-		PIOS_MPU6000_ReleaseBus();
-		mpu6000_fails++;
-		return false;
-	}
+	dev->irq_time = timeval;
+	xSemaphoreGiveFromISR(dev->data_ready_sema, &xHigherPriorityTaskWoken);
 
-	PIOS_MPU6000_ReleaseBus();
+	return (xHigherPriorityTaskWoken == pdTRUE);
+}
 
-	struct pios_mpu6000_data data;
+/**
+ * @brief Reads the FIFO depth with the bus claimed from the task, then starts
+ * the DMA burst. PIOS_MPU6000_BurstComplete releases the bus again.
+ */
+static void PIOS_MPU6000_Task(void *parameters)
+{
+	while (1)
+	{
+		//Wait for data ready interrupt
+		if (xSemaphoreTake(dev->data_ready_sema, portMAX_DELAY) != pdTRUE)
+			continue;
+
+		if(!mpu6000_configured)
+			continue;
+
+		// Samples arriving during a burst are picked up by the next one
+		if(mpu6000_burst_count != 0)
+			continue;
 
-	// In the case where extras samples backed up grabbed an extra
-	if (mpu6000_count >= (sizeof(data) * 2)) {
-		mpu6000_fifo_backup++;
 		if(PIOS_MPU6000_ClaimBus() != 0)
-			return false;		
-		
-		if(PIOS_SPI_TransferBlock(dev->spi_id, &mpu6000_send_buf[0], &mpu6000_rec_buf[0], sizeof(mpu6000_send_buf), NULL) < 0) {
+			continue;
+
+		mpu6000_count = PIOS_MPU6000_FifoDepth();
+		if(mpu6000_count < PIOS_MPU6000_SAMPLE_SIZE) {
+			PIOS_MPU6000_ReleaseBus();
+			continue;
+		}
+
+		uint32_t samples = mpu6000_count / PIOS_MPU6000_SAMPLE_SIZE;
+		if(samples > PIOS_MPU6000_MAX_BURST) {
+			samples = PIOS_MPU6000_MAX_BURST;
+			mpu6000_fifo_backup++;
+		}
+
+		mpu6000_burst_count = samples;
+		mpu6000_burst_time = dev->irq_time;
+		mpu6000_transfer_size = 1 + samples * PIOS_MPU6000_SAMPLE_SIZE;
+
+		if(PIOS_SPI_TransferBlock(dev->spi_id, &mpu6000_burst_send_buf[0], &mpu6000_burst_rec_buf[0], mpu6000_transfer_size, PIOS_MPU6000_BurstComplete) < 0) {
+			mpu6000_burst_count = 0;
 			PIOS_MPU6000_ReleaseBus();
 			mpu6000_fails++;
-			return false;
+			continue;
 		}
-		
-		PIOS_MPU6000_ReleaseBus();
+
+		mpu6000_irq++;
 	}
-	
+}
+
+/**
+ * @brief DMA completion of a burst read, runs from the SPI DMA interrupt.
+ * Releases the bus and queues every sample of the burst, oldest first.
+ */
+static void PIOS_MPU6000_BurstComplete(uint8_t crc_ok, uint8_t crc_val)
+{
+	bool woken = false;
+	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+
+	PIOS_SPI_RC_PinSet(dev->spi_id,dev->slave_num,1);
+	PIOS_SPI_ReleaseBusISR(dev->spi_id, &woken);
+
+	mpu6000_last_read_count = mpu6000_burst_count;
+
+	struct pios_mpu6000_data data;
+	data.time = mpu6000_burst_time;
+
+	for(uint32_t i = 0; i < mpu6000_burst_count; i++) {
+		const uint8_t * mpu6000_rec_buf = &mpu6000_burst_rec_buf[i * PIOS_MPU6000_SAMPLE_SIZE];
+
 #if defined(PIOS_MPU6000_ACCEL)
-	data.accel_x = mpu6000_rec_buf[1] << 8 | mpu6000_rec_buf[2];
-	data.accel_y = mpu6000_rec_buf[3] << 8 | mpu6000_rec_buf[4];
-	data.accel_z = mpu6000_rec_buf[5] << 8 | mpu6000_rec_buf[6];
-	data.temperature = mpu6000_rec_buf[7] << 8 | mpu6000_rec_buf[8];
-	data.gyro_x  = mpu6000_rec_buf[9] << 8  | mpu6000_rec_buf[10];
-	data.gyro_y  = mpu6000_rec_buf[11] << 8 | mpu6000_rec_buf[12];
-	data.gyro_z  = mpu6000_rec_buf[13] << 8 | mpu6000_rec_buf[14];
+		data.accel_x = mpu6000_rec_buf[1] << 8 | mpu6000_rec_buf[2];
+		data.accel_y = mpu6000_rec_buf[3] << 8 | mpu6000_rec_buf[4];
+		data.accel_z = mpu6000_rec_buf[5] << 8 | mpu6000_rec_buf[6];
+		data.temperature = mpu6000_rec_buf[7] << 8 | mpu6000_rec_buf[8];
+		data.gyro_x  = mpu6000_rec_buf[9] << 8  | mpu6000_rec_buf[10];
+		data.gyro_y  = mpu6000_rec_buf[11] << 8 | mpu6000_rec_buf[12];
+		data.gyro_z  = mpu6000_rec_buf[13] << 8 | mpu6000_rec_buf[14];
 #else
-	data.temperature = mpu6000_rec_buf[1] << 8 | mpu6000_rec_buf[2];
-	data.gyro_x = mpu6000_rec_buf[3] << 8 | mpu6000_rec_buf[4];
-	data.gyro_y = mpu6000_rec_buf[5] << 8 | mpu6000_rec_buf[6];
-	data.gyro_z = mpu6000_rec_buf[7] << 8 | mpu6000_rec_buf[8];
+		data.temperature = mpu6000_rec_buf[1] << 8 | mpu6000_rec_buf[2];
+		data.gyro_x = mpu6000_rec_buf[3] << 8 | mpu6000_rec_buf[4];
+		data.gyro_y = mpu6000_rec_buf[5] << 8 | mpu6000_rec_buf[6];
+		data.gyro_z = mpu6000_rec_buf[7] << 8 | mpu6000_rec_buf[8];
 #endif
-	
-	portBASE_TYPE xHigherPriorityTaskWoken;
-	xQueueSendToBackFromISR(dev->queue, (void *) &data, &xHigherPriorityTaskWoken);
-	
-	mpu6000_irq++;
-	
-	mpu6000_time_us = PIOS_DELAY_DiffuS(timeval);
-	
-	return xHigherPriorityTaskWoken == pdTRUE;	
+
+		if(xQueueSendToBackFromISR(dev->queue, (void *) &data, &xHigherPriorityTaskWoken) != pdTRUE)
+			mpu6000_fails++;
+	}
+
+	mpu6000_burst_count = 0;
+
+	mpu6000_time_us = PIOS_DELAY_DiffuS(mpu6000_burst_time);
+
+	portEND_SWITCHING_ISR(woken || xHigherPriorityTaskWoken == pdTRUE);
 }
 
 #endif
@@ -46,13 +46,14 @@ enum pios_mpu6050_dev_magic {
 	PIOS_MPU6050_DEV_MAGIC = 0xf21d26a2,
 };
 
-#define PIOS_MPU6050_MAX_DOWNSAMPLE 2
+#define PIOS_MPU6050_MAX_DOWNSAMPLE (2 * PIOS_MPU6050_MAX_BURST)
 struct mpu6050_dev {
 	uint32_t i2c_id;
 	uint8_t i2c_addr;
 	xQueueHandle queue;
 	xTaskHandle TaskHandle;
 	xSemaphoreHandle data_ready_sema;
+	volatile uint32_t irq_time;
 	const struct pios_mpu6050_cfg * cfg;
 	enum pios_mpu6050_dev_magic magic;
 };
@@ -318,6 +319,7 @@ int32_t PIOS_MPU6050_ReadGyros(struct pios_mpu6050_data * data)
 		return -2;
 	}
 	
+	data->time = PIOS_DELAY_GetRaw();
 	data->gyro_x = mpu6050_rec_buf[0] << 8 | mpu6050_rec_buf[1];
 	data->gyro_y = mpu6050_rec_buf[2] << 8 | mpu6050_rec_buf[3];
 	data->gyro_z = mpu6050_rec_buf[4] << 8 | mpu6050_rec_buf[5];
@@ -432,6 +434,7 @@ bool PIOS_MPU6050_IRQHandler(void)
 {
 	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
 
+	dev->irq_time = PIOS_DELAY_GetRaw();
 	xSemaphoreGiveFromISR(dev->data_ready_sema, &xHigherPriorityTaskWoken);
 	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
 
@@ -458,45 +461,46 @@ void PIOS_MPU6050_Task(void *parameters)
 			continue;
 
 		mpu6050_count = PIOS_MPU6050_FifoDepth();
-		if(mpu6050_count < sizeof(struct pios_mpu6050_data))
+		if(mpu6050_count < PIOS_MPU6050_SAMPLE_SIZE)
 			continue;
-	
-		static uint8_t mpu6050_rec_buf[sizeof(struct pios_mpu6050_data)];
-		
-		if (PIOS_MPU6050_Read(PIOS_MPU6050_FIFO_REG, mpu6050_rec_buf, sizeof(mpu6050_rec_buf)) < 0) {
-			//mpu6050_fails++;
-			continue;
-		}
 
-		// In the case where extras samples backed up grabbed an extra
-		if (mpu6050_count >= (sizeof(mpu6050_rec_buf) * 2)) {
+		// Drain every whole sample in one transfer instead of dropping the backlog
+		uint32_t samples = mpu6050_count / PIOS_MPU6050_SAMPLE_SIZE;
+		if (samples > PIOS_MPU6050_MAX_BURST) {
 			//mpu6050_fifo_backup++;
+			samples = PIOS_MPU6050_MAX_BURST;
+		}
 
-			//overwrite until the newest entry is present in mpu6050_rec_buf
-			if (PIOS_MPU6050_Read(PIOS_MPU6050_FIFO_REG, mpu6050_rec_buf, sizeof(mpu6050_rec_buf)) < 0) {
-				//mpu6050_fails++;
-				continue;
-			}
+		static uint8_t mpu6050_burst_buf[PIOS_MPU6050_MAX_BURST * PIOS_MPU6050_SAMPLE_SIZE];
+		
+		if (PIOS_MPU6050_Read(PIOS_MPU6050_FIFO_REG, mpu6050_burst_buf, samples * PIOS_MPU6050_SAMPLE_SIZE) < 0) {
+			//mpu6050_fails++;
+			continue;
 		}
 
 		static struct pios_mpu6050_data data;
+		data.time = dev->irq_time;
+
+		for (uint32_t i = 0; i < samples; i++) {
+			const uint8_t * mpu6050_rec_buf = &mpu6050_burst_buf[i * PIOS_MPU6050_SAMPLE_SIZE];
 
 #if defined(PIOS_MPU6050_ACCEL)
-		data.accel_x = mpu6050_rec_buf[0] << 8 | mpu6050_rec_buf[1];
-		data.accel_y = mpu6050_rec_buf[2] << 8 | mpu6050_rec_buf[3];
-		data.accel_z = mpu6050_rec_buf[4] << 8 | mpu6050_rec_buf[5];
-		data.temperature = mpu6050_rec_buf[6] << 8 | mpu6050_rec_buf[7];
-		data.gyro_x  = mpu6050_rec_buf[8] << 8  | mpu6050_rec_buf[9];
-		data.gyro_y  = mpu6050_rec_buf[10] << 8 | mpu6050_rec_buf[11];
-		data.gyro_z  = mpu6050_rec_buf[12] << 8 | mpu6050_rec_buf[13];
+			data.accel_x = mpu6050_rec_buf[0] << 8 | mpu6050_rec_buf[1];
+			data.accel_y = mpu6050_rec_buf[2] << 8 | mpu6050_rec_buf[3];
+			data.accel_z = mpu6050_rec_buf[4] << 8 | mpu6050_rec_buf[5];
+			data.temperature = mpu6050_rec_buf[6] << 8 | mpu6050_rec_buf[7];
+			data.gyro_x  = mpu6050_rec_buf[8] << 8  | mpu6050_rec_buf[9];
+			data.gyro_y  = mpu6050_rec_buf[10] << 8 | mpu6050_rec_buf[11];
+			data.gyro_z  = mpu6050_rec_buf[12] << 8 | mpu6050_rec_buf[13];
 #else
-		data.temperature = mpu6050_rec_buf[0] << 8 | mpu6050_rec_buf[1];
-		data.gyro_x = mpu6050_rec_buf[2] << 8 | mpu6050_rec_buf[3];
-		data.gyro_y = mpu6050_rec_buf[4] << 8 | mpu6050_rec_buf[5];
-		data.gyro_z = mpu6050_rec_buf[6] << 8 | mpu6050_rec_buf[7];
+			data.temperature = mpu6050_rec_buf[0] << 8 | mpu6050_rec_buf[1];
+			data.gyro_x = mpu6050_rec_buf[2] << 8 | mpu6050_rec_buf[3];
+			data.gyro_y = mpu6050_rec_buf[4] << 8 | mpu6050_rec_buf[5];
+			data.gyro_z = mpu6050_rec_buf[6] << 8 | mpu6050_rec_buf[7];
 #endif
 	
-		xQueueSend(dev->queue, (void *) &data, 0);
+			xQueueSend(dev->queue, (void *) &data, 0);
+		}
 
 		//mpu6050_irq++;
 
@@ -108,6 +108,32 @@ int32_t PIOS_RCVR_Read(uint32_t rcvr_id, uint8_t channel)
   return rcvr_dev->driver->read(rcvr_dev->lower_id, channel);
 }
 
+#if defined(PIOS_INCLUDE_FREERTOS)
+/**
+ * @brief Get the semaphore a driver gives on every new frame
+ * @param[in] rcvr_id driver to query
+ * @param[in] channel channel the caller is going to read
+ * @returns the semaphore or NULL when the driver can only be polled
+ */
+xSemaphoreHandle PIOS_RCVR_GetSemaphore(uint32_t rcvr_id, uint8_t channel)
+{
+  if (channel == 0 || rcvr_id == 0)
+    return NULL;
+
+  struct pios_rcvr_dev * rcvr_dev = (struct pios_rcvr_dev *)rcvr_id;
+
+  if (!PIOS_RCVR_validate(rcvr_dev)) {
+    /* Undefined RCVR port for this board (see pios_board.c) */
+    PIOS_Assert(0);
+  }
+
+  if (!rcvr_dev->driver->get_semaphore)
+    return NULL;
+
+  return rcvr_dev->driver->get_semaphore(rcvr_dev->lower_id, channel - 1);
+}
+#endif
+
 #endif
 
 /**
@@ -165,6 +165,11 @@ struct pios_rfm22b_dev {
 	// The supervisor countdown timer.
 	uint16_t supv_timer;
 	uint16_t resets;
+
+	// Packet timing
+	struct pios_rfm22b_stats stats;
+	uint32_t tx_start_raw;
+	uint32_t rx_sync_raw;
 };
 
 uint32_t random32 = 0x459ab8d8;
@@ -191,6 +196,7 @@ inline uint8_t rfm22_burstRead(void)
 void rfm22_endBurstRead(void);
 uint8_t rfm22_read(uint8_t addr);
 uint8_t rfm22_txStart();
+static void rfm22_stageTxPacket(void);
 
 /* Provide a COM driver */
 static void PIOS_RFM22B_ChangeBaud(uint32_t rfm22b_id, uint32_t baud);
@@ -300,6 +306,8 @@ const uint8_t ss_reg_71[] = {  0x2B, 0x23}; // rfm22_modulation_mode_control2
 
 volatile bool		initialized = false;
 
+static bool			int_need_yield;					// a COM callback woke a task during the interrupt
+
 #if defined(RFM22_EXT_INT_USE)
 volatile bool		exec_using_spi;					// set this if you want to access the SPI bus outside of the interrupt
 #endif
@@ -358,10 +366,12 @@ uint8_t				tx_power;
 // the tx power register read back
 volatile uint8_t	tx_pwr;
 
-// The transmit buffer. Holds data that is being transmitted.
-uint8_t tx_buffer[TX_BUFFER_SIZE] __attribute__ ((aligned(4)));
-// The transmit buffer.  Hosts data that is wating to be transmitted.
-uint8_t tx_pre_buffer[TX_BUFFER_SIZE] __attribute__ ((aligned(4)));
+// The transmit buffers, swapped when a packet is started.
+static uint8_t tx_buffers[2][TX_BUFFER_SIZE] __attribute__ ((aligned(4)));
+// Holds data that is being transmitted.
+uint8_t *tx_buffer = tx_buffers[0];
+// Holds the next packet, staged while tx_buffer is on air.
+uint8_t *tx_pre_buffer = tx_buffers[1];
 // The tx pre-buffer write index.
 uint16_t tx_pre_buffer_size;
 // the tx data read index
@@ -450,6 +460,10 @@ int32_t PIOS_RFM22B_Init(uint32_t *rfm22b_id, const struct pios_rfm22b_cfg *cfg)
   
 	*rfm22b_id = (uint32_t)rfm22b_dev;
 
+	rfm22b_dev->rx_in_cb = NULL;
+	rfm22b_dev->tx_out_cb = NULL;
+	memset(&rfm22b_dev->stats, 0, sizeof(rfm22b_dev->stats));
+
 	// Initialize the TX pre-buffer pointer.
 	tx_pre_buffer_size = 0;
 
@@ -540,6 +554,20 @@ int16_t PIOS_RFM22B_Resets(uint32_t rfm22b_id)
 	return rfm22b_dev->resets;
 }
 
+/**
+ * Get the packet counts and timing of the radio, the longest interrupt
+ * service time is restarted.
+ */
+void PIOS_RFM22B_GetStats(uint32_t rfm22b_id, struct pios_rfm22b_stats *stats)
+{
+	struct pios_rfm22b_dev *rfm22b_dev = (struct pios_rfm22b_dev *)rfm22b_id;
+
+	PIOS_IRQ_Disable();
+	*stats = rfm22b_dev->stats;
+	rfm22b_dev->stats.irq_time_us = 0;
+	PIOS_IRQ_Enable();
+}
+
 static void PIOS_RFM22B_RxStart(uint32_t rfm22b_id, uint16_t rx_bytes_avail)
 {
 	struct pios_rfm22b_dev * rfm22b_dev = (struct pios_rfm22b_dev *)rfm22b_id;
@@ -555,11 +583,10 @@ static void PIOS_RFM22B_TxStart(uint32_t rfm22b_id, uint16_t tx_bytes_avail)
 	bool valid = PIOS_RFM22B_validate(rfm22b_dev);
 	PIOS_Assert(valid);
 
-	// Get some data to send
-	bool need_yield = false;
-	if(tx_pre_buffer_size == 0)
-		tx_pre_buffer_size = (rfm22b_dev->tx_out_cb)(rfm22b_dev->tx_out_context, tx_pre_buffer,
-							     TX_BUFFER_SIZE, NULL, &need_yield);
+	// Get some data to send, the interrupt stages packets too
+	PIOS_IRQ_Disable();
+	rfm22_stageTxPacket();
+	PIOS_IRQ_Enable();
 
 	if(tx_pre_buffer_size > 0)
 	{
@@ -747,6 +774,30 @@ uint8_t rfm22_read(uint8_t addr)
 	return rdata;
 }
 
+// ************************************
+// FIFO access, the data is moved as one SPI DMA burst
+
+static void rfm22_writeFifo(const uint8_t *data, uint16_t len)
+{
+	if (len == 0)
+		return;
+
+	rfm22_startBurstWrite(RFM22_fifo_access);
+	PIOS_SPI_TransferBlock(RFM22_PIOS_SPI, data, NULL, len, NULL);
+	rfm22_endBurstWrite();
+}
+
+// data can be NULL to discard the bytes
+static void rfm22_readFifo(uint8_t *data, uint16_t len)
+{
+	if (len == 0)
+		return;
+
+	rfm22_startBurstRead(RFM22_fifo_access);
+	PIOS_SPI_TransferBlock(RFM22_PIOS_SPI, NULL, data, len, NULL);
+	rfm22_endBurstRead();
+}
+
 // ************************************
 // external interrupt
 
@@ -754,10 +805,19 @@ uint8_t rfm22_read(uint8_t addr)
 static bool PIOS_RFM22_EXT_Int(void)
 {
 	rfm22_setDebug("Ext Int");
+	int_need_yield = false;
 	if (!exec_using_spi)
+	{
+		uint32_t start = PIOS_DELAY_GetRaw();
 		rfm22_processInt();
+		uint32_t time_us = PIOS_DELAY_DiffuS(start);
+		if (rfm22b_dev_g && time_us > rfm22b_dev_g->stats.irq_time_us)
+			rfm22b_dev_g->stats.irq_time_us = time_us;
+	}
 	rfm22_setDebug("Ext Done");
-	return false;
+
+	// The EXTI handler switches to the woken task on the way out
+	return int_need_yield;
 }
 
 void rfm22_disableExtInt(void)
@@ -1198,8 +1258,10 @@ uint8_t rfm22_txStart()
 	// TUNE mode
 	rfm22_write(RFM22_op_and_func_ctrl1, RFM22_opfc1_pllon);
 
-	// Queue the data up for sending
-	memcpy(tx_buffer, tx_pre_buffer, tx_pre_buffer_size);
+	// Swap the staged packet in
+	uint8_t *staged = tx_pre_buffer;
+	tx_pre_buffer = tx_buffer;
+	tx_buffer = staged;
 	tx_data_rd = 0;
 	tx_data_wr = tx_pre_buffer_size;
 	tx_pre_buffer_size = 0;
@@ -1233,10 +1295,8 @@ uint8_t rfm22_txStart()
 	rfm22_write(RFM22_transmit_packet_length, tx_data_wr);
 
 	// add some data
-	rfm22_startBurstWrite(RFM22_fifo_access);
-	for (uint16_t i = 0; (tx_data_rd < tx_data_wr) && (i < FIFO_SIZE); ++tx_data_rd, ++i)
-		rfm22_burstWrite(tx_buffer[tx_data_rd]);
-	rfm22_endBurstWrite();
+	tx_data_rd = (tx_data_wr < FIFO_SIZE) ? tx_data_wr : FIFO_SIZE;
+	rfm22_writeFifo(tx_buffer, tx_data_rd);
 
 	// *******************
 
@@ -1250,6 +1310,10 @@ uint8_t rfm22_txStart()
 
 	// enable the transmitter
 	rfm22_write(RFM22_op_and_func_ctrl1, RFM22_opfc1_pllon | RFM22_opfc1_txon);
+	rfm22b_dev_g->tx_start_raw = PIOS_DELAY_GetRaw();
+
+	// Stage the next packet while this one is on air
+	rfm22_stageTxPacket();
 
 	// Re-ensable interrrupts.
 	PIOS_IRQ_Enable();
@@ -1260,6 +1324,22 @@ uint8_t rfm22_txStart()
 	return 1;
 }
 
+/**
+ * Fetch the next packet into the pre-buffer if it is empty, so the packet
+ * sent interrupt can start it without waiting for the COM layer.
+ */
+static void rfm22_stageTxPacket(void)
+{
+	if (tx_pre_buffer_size > 0 || !rfm22b_dev_g->tx_out_cb)
+		return;
+
+	bool need_yield = false;
+	tx_pre_buffer_size = (rfm22b_dev_g->tx_out_cb)(rfm22b_dev_g->tx_out_context, tx_pre_buffer,
+						       TX_BUFFER_SIZE, NULL, &need_yield);
+	if (need_yield)
+		int_need_yield = true;
+}
+
 
 static void rfm22_setTxMode(uint8_t mode)
 {
@@ -1407,6 +1487,7 @@ void rfm22_processRxInt(void)
 		rx_packet_start_rssi_dBm = rssi_dBm;
 		// remember the afc value for this packet
 		rx_packet_start_afc_Hz = afc_correction_Hz;
+		rfm22b_dev_g->rx_sync_raw = PIOS_DELAY_GetRaw();
 	}
 
 	// RX FIFO almost full, it needs emptying
@@ -1435,17 +1516,12 @@ void rfm22_processRxInt(void)
 			}
 
 			// Fetch the data from the RX FIFO
-			rfm22_startBurstRead(RFM22_fifo_access);
-			for (uint8_t i = 0; i < RX_FIFO_HI_WATERMARK; ++i)
-				rx_buffer[rx_buffer_wr++] = rfm22_burstRead();
-			rfm22_endBurstRead();
+			rfm22_readFifo((uint8_t *)rx_buffer + rx_buffer_wr, RX_FIFO_HI_WATERMARK);
+			rx_buffer_wr += RX_FIFO_HI_WATERMARK;
 		}
 		else
 		{	// just clear the RX FIFO
-			rfm22_startBurstRead(RFM22_fifo_access);
-			for (register uint16_t i = RX_FIFO_HI_WATERMARK; i > 0; i--)
-				rfm22_burstRead();	// read a byte from the rf modules RX FIFO buffer
-			rfm22_endBurstRead();
+			rfm22_readFifo(NULL, RX_FIFO_HI_WATERMARK);
 		}
 	}
 
@@ -1469,10 +1545,8 @@ void rfm22_processRxInt(void)
 		if (rx_buffer_wr < len)
 		{
 			// Fetch the data from the RX FIFO
-			rfm22_startBurstRead(RFM22_fifo_access);
-			while (rx_buffer_wr < len)
-				rx_buffer[rx_buffer_wr++] = rfm22_burstRead();
-			rfm22_endBurstRead();
+			rfm22_readFifo((uint8_t *)rx_buffer + rx_buffer_wr, len - rx_buffer_wr);
+			rx_buffer_wr = len;
 		}
 
 		if (rx_buffer_wr != len)
@@ -1489,6 +1563,9 @@ void rfm22_processRxInt(void)
 
 		if (rx_buffer_wr > 0)
 		{
+			rfm22b_dev_g->stats.rx_time_us = PIOS_DELAY_DiffuS(rfm22b_dev_g->rx_sync_raw);
+			rfm22b_dev_g->stats.rx_packets++;
+
 			// remember the rssi for this packet
 			rx_packet_rssi_dBm = rx_packet_start_rssi_dBm;
 			// remember the afc offset for this packet
@@ -1501,6 +1578,8 @@ void rfm22_processRxInt(void)
 			if (rfm22b_dev_g->rx_in_cb)
 				(rfm22b_dev_g->rx_in_cb)(rfm22b_dev_g->rx_in_context, (uint8_t*)rx_buffer,
 							 rx_buffer_wr, NULL, &need_yield);
+			if (need_yield)
+				int_need_yield = true;
 			rx_buffer_wr = 0;
 		}
 
@@ -1555,17 +1634,19 @@ void rfm22_processTxInt(void)
 	if (int_stat1 & RFM22_is1_ixtffaem)
 	{
 		// top-up the rf chips TX FIFO buffer
-		uint16_t max_bytes = FIFO_SIZE - TX_FIFO_LO_WATERMARK - 1;
-		rfm22_startBurstWrite(RFM22_fifo_access);
-		for (uint16_t i = 0; (tx_data_rd < tx_data_wr) && (i < max_bytes); ++i, ++tx_data_rd)
-			rfm22_burstWrite(tx_buffer[tx_data_rd]);
-		rfm22_endBurstWrite();
+		uint16_t len = tx_data_wr - tx_data_rd;
+		if (len > FIFO_SIZE - TX_FIFO_LO_WATERMARK - 1)
+			len = FIFO_SIZE - TX_FIFO_LO_WATERMARK - 1;
+		rfm22_writeFifo(tx_buffer + tx_data_rd, len);
+		tx_data_rd += len;
 	}
 
 	// Packet has been sent
 	if (int_stat1 & RFM22_is1_ipksent)
 	{
 		rfm22_setDebug(" T_Sent");
+		rfm22b_dev_g->stats.tx_time_us = PIOS_DELAY_DiffuS(rfm22b_dev_g->tx_start_raw);
+		rfm22b_dev_g->stats.tx_packets++;
 
 		// Send another packet if it's available.
 		if(!rfm22_txStart())
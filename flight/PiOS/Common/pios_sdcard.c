@@ -81,6 +81,13 @@ uint8_t PIOS_SDCARD_Sector[SECTOR_SIZE];
 #define SDCMD_WRITE_SINGLE_BLOCK		(0x40+24)
 #define SDCMD_WRITE_SINGLE_BLOCK_CRC	0xff
 
+#define SDCMD_WRITE_MULTIPLE_BLOCK		(0x40+25)
+#define SDCMD_WRITE_MULTIPLE_BLOCK_CRC	0xff
+
+/* Data tokens of a multiple block write */
+#define SDCARD_TOKEN_MULTI_START		0xfc
+#define SDCARD_TOKEN_MULTI_STOP			0xfd
+
 /* Card type flags (CardType) */
 #define CT_MMC                          0x01
 #define CT_SD1                          0x02
@@ -549,6 +556,100 @@ error:
 	return status;
 }
 
+/**
+* Writes consecutive sectors with a single multiple block write command. This
+* saves the command and its response for every sector but the first, and lets
+* the card program the run as a whole. The call blocks until the card has taken
+* the last sector: each sector goes out with a blocking PIOS_SPI_TransferBlock()
+* and the card's busy state is polled after it.
+* \param[in] sector 32bit first sector
+* \param[in] *buffer pointer to count * 512 bytes
+* \param[in] count number of sectors
+* \return 0 if all sectors have been successfully written
+* \return -error flags if the command was rejected (see PIOS_SDCARD_SectorWrite)
+* \return -256 if timeout during command has been sent
+* \return -257 if write operation not accepted
+* \return -258 if timeout during write operation
+*/
+int32_t PIOS_SDCARD_SectorWriteMulti(uint32_t sector, uint8_t * buffer, uint32_t count)
+{
+	int32_t status;
+	uint32_t block;
+	int i;
+
+	if (count == 1) {
+		return PIOS_SDCARD_SectorWrite(sector, buffer);
+	}
+
+	SDCARD_MUTEX_TAKE;
+
+	if (!(CardType & CT_BLOCK)) {
+		sector *= 512;
+	}
+
+	/* Init SPI port for fast frequency access (ca. 18 MBit/s) */
+	PIOS_SPI_SetClockSpeed(PIOS_SDCARD_SPI, PIOS_SPI_PRESCALER_4);
+
+	if ((status = PIOS_SDCARD_SendSDCCmd(SDCMD_WRITE_MULTIPLE_BLOCK, sector, SDCMD_WRITE_MULTIPLE_BLOCK_CRC))) {
+		status = (status < 0) ? -256 : status;	/* Return timeout indicator or error flags */
+		goto error;
+	}
+
+	for (block = 0; block < count; ++block) {
+		/* Send start token and 512 bytes of data, waits for the transfer to finish */
+		PIOS_SPI_TransferByte(PIOS_SDCARD_SPI, SDCARD_TOKEN_MULTI_START);
+		PIOS_SPI_TransferBlock(PIOS_SDCARD_SPI, buffer + 512 * block, NULL, 512, NULL);
+
+		/* Send CRC */
+		PIOS_SPI_TransferByte(PIOS_SDCARD_SPI, 0xff);
+		PIOS_SPI_TransferByte(PIOS_SDCARD_SPI, 0xff);
+
+		/* Read response */
+		uint8_t response = PIOS_SPI_TransferByte(PIOS_SDCARD_SPI, 0xff);
+		if ((response & 0x0f) != 0x5) {
+			status = -257;
+			break;
+		}
+
+		/* Wait until the card took the block */
+		for (i = 0; i < 32 * 65536; ++i) {
+			if (PIOS_SPI_TransferByte(PIOS_SDCARD_SPI, 0xff) != 0x00) {
+				break;
+			}
+		}
+		if (i == 32 * 65536) {
+			status = -258;
+			goto error;
+		}
+	}
+
+	/* Stop the transfer, also after a rejected block, and wait for programming */
+	PIOS_SPI_TransferByte(PIOS_SDCARD_SPI, SDCARD_TOKEN_MULTI_STOP);
+	PIOS_SPI_TransferByte(PIOS_SDCARD_SPI, 0xff);
+	for (i = 0; i < 32 * 65536; ++i) {
+		if (PIOS_SPI_TransferByte(PIOS_SDCARD_SPI, 0xff) != 0x00) {
+			break;
+		}
+	}
+	if (i == 32 * 65536) {
+		status = -258;
+		goto error;
+	}
+
+	/* Required for clocking (see spec) */
+	PIOS_SPI_TransferByte(PIOS_SDCARD_SPI, 0xff);
+
+error:
+	/* Deactivate chip select */
+	PIOS_SPI_RC_PinSet(PIOS_SDCARD_SPI, 1);	/* spi, pin_value */
+	/* Send dummy byte once deactivated to drop cards DO */
+	PIOS_SPI_TransferByte(PIOS_SDCARD_SPI, 0xff);
+
+	SDCARD_MUTEX_GIVE;
+
+	return status;
+}
+
 /**
 * Reads the CID informations from SD Card
 * \param[in] *cid pointer to buffer which holds the CID informations
@@ -50,6 +50,9 @@ struct pios_adc_dev {
 	int16_t fir_coeffs[PIOS_ADC_MAX_SAMPLES+1]  __attribute__ ((aligned(4)));
 	volatile int16_t raw_data_buffer[PIOS_ADC_MAX_SAMPLES]  __attribute__ ((aligned(4)));	// Double buffer that DMA just used
 	float downsampled_buffer[PIOS_ADC_NUM_CHANNELS]  __attribute__ ((aligned(4)));
+	// Sum and number of the raw samples of each channel since PIOS_ADC_PinGetAverage()
+	uint32_t accumulator[PIOS_ADC_NUM_CHANNELS];
+	uint32_t accumulator_count[PIOS_ADC_NUM_CHANNELS];
 #endif
 	enum pios_adc_dev_magic magic;
 };
@@ -105,6 +108,8 @@ int32_t PIOS_ADC_Init(const struct pios_adc_cfg * cfg)
 
 	pios_adc_dev->cfg = cfg;
 	pios_adc_dev->callback_function = NULL;
+	memset(pios_adc_dev->accumulator, 0, sizeof(pios_adc_dev->accumulator));
+	memset(pios_adc_dev->accumulator_count, 0, sizeof(pios_adc_dev->accumulator_count));
 	
 #if defined(PIOS_INCLUDE_FREERTOS)
 	pios_adc_dev->data_queue = NULL;
@@ -245,6 +250,30 @@ int32_t PIOS_ADC_PinGet(uint32_t pin)
 	return pios_adc_dev->downsampled_buffer[pin];
 }
 
+/**
+ * Returns the mean of all the samples of an ADC Pin since the last call for that pin
+ * \param[in] pin number
+ * \return mean raw ADC value, 0 if no sample was taken yet
+ * \return -1 if pin doesn't exist
+ */
+float PIOS_ADC_PinGetAverage(uint32_t pin)
+{
+	/* Check if pin exists */
+	if (pin >= PIOS_ADC_NUM_CHANNELS) {
+		return -1;
+	}
+
+	/* The accumulator is updated from the DMA interrupt */
+	PIOS_IRQ_Disable();
+	uint32_t sum = pios_adc_dev->accumulator[pin];
+	uint32_t count = pios_adc_dev->accumulator_count[pin];
+	pios_adc_dev->accumulator[pin] = 0;
+	pios_adc_dev->accumulator_count[pin] = 0;
+	PIOS_IRQ_Enable();
+
+	return count ? (float) sum / count : 0;
+}
+
 /**
  * @brief Set a callback function that is executed whenever
  * the ADC double buffer swaps 
@@ -314,10 +343,21 @@ void PIOS_ADC_downsample_data()
 	
 	for (chan = 0; chan < PIOS_ADC_NUM_CHANNELS; chan++) {
 		int32_t sum = 0;
+		uint32_t raw_sum = 0;
 		for (sample = 0; sample < pios_adc_dev->adc_oversample; sample++) {
-			sum += pios_adc_dev->valid_data_buffer[chan + sample * pios_adc_dev->dma_block_size] * pios_adc_dev->fir_coeffs[sample];
+			int16_t value = pios_adc_dev->valid_data_buffer[chan + sample * pios_adc_dev->dma_block_size];
+			sum += value * pios_adc_dev->fir_coeffs[sample];
+			raw_sum += value;
 		}
 		downsampled_buffer[chan] = (float) sum / pios_adc_dev->fir_coeffs[pios_adc_dev->adc_oversample];
+
+		/* Halve the running sum before it can overflow, this keeps the mean */
+		if (pios_adc_dev->accumulator[chan] >= (1u << 31)) {
+			pios_adc_dev->accumulator[chan] /= 2;
+			pios_adc_dev->accumulator_count[chan] /= 2;
+		}
+		pios_adc_dev->accumulator[chan] += raw_sum;
+		pios_adc_dev->accumulator_count[chan] += pios_adc_dev->adc_oversample;
 	}
 	
 #if defined(PIOS_INCLUDE_FREERTOS)
@@ -42,10 +42,16 @@ static uint16_t PIOS_DSM_RxInCallback(uint32_t context,
 				      uint16_t *headroom,
 				      bool *need_yield);
 static void PIOS_DSM_Supervisor(uint32_t dsm_id);
+#if defined(PIOS_INCLUDE_FREERTOS)
+static xSemaphoreHandle PIOS_DSM_GetSemaphore(uint32_t rcvr_id, uint8_t channel);
+#endif
 
 /* Local Variables */
 const struct pios_rcvr_driver pios_dsm_rcvr_driver = {
 	.read = PIOS_DSM_Get,
+#if defined(PIOS_INCLUDE_FREERTOS)
+	.get_semaphore = PIOS_DSM_GetSemaphore,
+#endif
 };
 
 enum pios_dsm_dev_magic {
@@ -70,6 +76,9 @@ struct pios_dsm_dev {
 	const struct pios_dsm_cfg *cfg;
 	enum pios_dsm_proto proto;
 	struct pios_dsm_state state;
+#if defined(PIOS_INCLUDE_FREERTOS)
+	xSemaphoreHandle new_frame;
+#endif
 };
 
 /* Allocate DSM device descriptor */
@@ -251,10 +260,14 @@ stream_error:
 	return -1;
 }
 
-/* Update decoder state processing input byte from the DSMx stream */
-static void PIOS_DSM_UpdateState(struct pios_dsm_dev *dsm_dev, uint8_t byte)
+/*
+ * Update decoder state processing input byte from the DSMx stream
+ * \output true when the byte completed a frame that updated the channels
+ */
+static bool PIOS_DSM_UpdateState(struct pios_dsm_dev *dsm_dev, uint8_t byte)
 {
 	struct pios_dsm_state *state = &(dsm_dev->state);
+	bool decoded = false;
 	if (state->frame_found) {
 		/* receiving the data frame */
 		if (state->byte_count < DSM_FRAME_LENGTH) {
@@ -262,15 +275,19 @@ static void PIOS_DSM_UpdateState(struct pios_dsm_dev *dsm_dev, uint8_t byte)
 			state->received_data[state->byte_count++] = byte;
 			if (state->byte_count == DSM_FRAME_LENGTH) {
 				/* full frame received - process and wait for new one */
-				if (!PIOS_DSM_UnrollChannels(dsm_dev))
+				if (!PIOS_DSM_UnrollChannels(dsm_dev)) {
 					/* data looking good */
 					state->failsafe_timer = 0;
+					decoded = true;
+				}
 
 				/* prepare for the next frame */
 				state->frame_found = 0;
 			}
 		}
 	}
+
+	return decoded;
 }
 
 /* Initialise DSM receiver interface */
@@ -301,6 +318,10 @@ int32_t PIOS_DSM_Init(uint32_t *dsm_id,
 
 	PIOS_DSM_ResetState(dsm_dev);
 
+#if defined(PIOS_INCLUDE_FREERTOS)
+	vSemaphoreCreateBinary(dsm_dev->new_frame);
+#endif
+
 	*dsm_id = (uint32_t)dsm_dev;
 
 	/* Set comm driver callback */
@@ -325,9 +346,20 @@ static uint16_t PIOS_DSM_RxInCallback(uint32_t context,
 	bool valid = PIOS_DSM_Validate(dsm_dev);
 	PIOS_Assert(valid);
 
+	bool decoded = false;
+
+	/*
+	 * With rx DMA the USART hands over what arrived when the line went
+	 * idle, a run of exactly one frame length is a whole frame to sync on.
+	 */
+	if (buf_len == DSM_FRAME_LENGTH) {
+		dsm_dev->state.frame_found = 1;
+		dsm_dev->state.byte_count = 0;
+	}
+
 	/* process byte(s) and clear receive timer */
 	for (uint8_t i = 0; i < buf_len; i++) {
-		PIOS_DSM_UpdateState(dsm_dev, buf[i]);
+		decoded |= PIOS_DSM_UpdateState(dsm_dev, buf[i]);
 		dsm_dev->state.receive_timer = 0;
 	}
 
@@ -335,8 +367,15 @@ static uint16_t PIOS_DSM_RxInCallback(uint32_t context,
 	if (headroom)
 		*headroom = DSM_FRAME_LENGTH;
 
-	/* We never need a yield */
+	/* Wake whoever waits for fresh channels */
 	*need_yield = false;
+#if defined(PIOS_INCLUDE_FREERTOS)
+	if (decoded) {
+		portBASE_TYPE woken = pdFALSE;
+		xSemaphoreGiveFromISR(dsm_dev->new_frame, &woken);
+		*need_yield = (woken == pdTRUE);
+	}
+#endif
 
 	/* Always indicate that all bytes were consumed */
 	return buf_len;
@@ -364,6 +403,21 @@ static int32_t PIOS_DSM_Get(uint32_t rcvr_id, uint8_t channel)
 	return dsm_dev->state.channel_data[channel];
 }
 
+#if defined(PIOS_INCLUDE_FREERTOS)
+/**
+ * Get the semaphore given on every decoded frame, all channels share it
+ */
+static xSemaphoreHandle PIOS_DSM_GetSemaphore(uint32_t rcvr_id, uint8_t channel)
+{
+	struct pios_dsm_dev *dsm_dev = (struct pios_dsm_dev *)rcvr_id;
+
+	if (!PIOS_DSM_Validate(dsm_dev))
+		return NULL;
+
+	return dsm_dev->new_frame;
+}
+#endif
+
 /**
  * Input data supervisor is called periodically and provides
  * two functions: frame syncing and failsafe triggering.
@@ -188,7 +188,9 @@ static void PIOS_EXTI_0_irq_handler (void)
 #else
 	bool xHigherPriorityTaskWoken;  // dummy variable
 #endif
+	PIOS_IRQ_Prologue();
 	PIOS_EXTI_HANDLE_LINE(0, xHigherPriorityTaskWoken);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_EXTI);
 #ifdef PIOS_INCLUDE_FREERTOS
 	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
 #endif
@@ -202,7 +204,9 @@ static void PIOS_EXTI_1_irq_handler (void)
 #else
 	bool xHigherPriorityTaskWoken;  // dummy variable
 #endif
+	PIOS_IRQ_Prologue();
 	PIOS_EXTI_HANDLE_LINE(1, xHigherPriorityTaskWoken);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_EXTI);
 #ifdef PIOS_INCLUDE_FREERTOS
 	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
 #endif
@@ -216,7 +220,9 @@ static void PIOS_EXTI_2_irq_handler (void)
 #else
 	bool xHigherPriorityTaskWoken;  // dummy variable
 #endif
+	PIOS_IRQ_Prologue();
 	PIOS_EXTI_HANDLE_LINE(2, xHigherPriorityTaskWoken);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_EXTI);
 #ifdef PIOS_INCLUDE_FREERTOS
 	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
 #endif
@@ -230,7 +236,9 @@ static void PIOS_EXTI_3_irq_handler (void)
 #else
 	bool xHigherPriorityTaskWoken;  // dummy variable
 #endif
+	PIOS_IRQ_Prologue();
 	PIOS_EXTI_HANDLE_LINE(3, xHigherPriorityTaskWoken);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_EXTI);
 #ifdef PIOS_INCLUDE_FREERTOS
 	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
 #endif
@@ -244,7 +252,9 @@ static void PIOS_EXTI_4_irq_handler (void)
 #else
 	bool xHigherPriorityTaskWoken;  // dummy variable
 #endif
+	PIOS_IRQ_Prologue();
 	PIOS_EXTI_HANDLE_LINE(4, xHigherPriorityTaskWoken);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_EXTI);
 #ifdef PIOS_INCLUDE_FREERTOS
 	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
 #endif
@@ -258,11 +268,13 @@ static void PIOS_EXTI_9_5_irq_handler (void)
 #else
 	bool xHigherPriorityTaskWoken;  // dummy variable
 #endif
+	PIOS_IRQ_Prologue();
 	PIOS_EXTI_HANDLE_LINE(5, xHigherPriorityTaskWoken);
 	PIOS_EXTI_HANDLE_LINE(6, xHigherPriorityTaskWoken);
 	PIOS_EXTI_HANDLE_LINE(7, xHigherPriorityTaskWoken);
 	PIOS_EXTI_HANDLE_LINE(8, xHigherPriorityTaskWoken);
 	PIOS_EXTI_HANDLE_LINE(9, xHigherPriorityTaskWoken);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_EXTI);
 #ifdef PIOS_INCLUDE_FREERTOS
 	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
 #endif
@@ -276,12 +288,14 @@ static void PIOS_EXTI_15_10_irq_handler (void)
 #else
 	bool xHigherPriorityTaskWoken;  // dummy variable
 #endif
+	PIOS_IRQ_Prologue();
 	PIOS_EXTI_HANDLE_LINE(10, xHigherPriorityTaskWoken);
 	PIOS_EXTI_HANDLE_LINE(11, xHigherPriorityTaskWoken);
 	PIOS_EXTI_HANDLE_LINE(12, xHigherPriorityTaskWoken);
 	PIOS_EXTI_HANDLE_LINE(13, xHigherPriorityTaskWoken);
 	PIOS_EXTI_HANDLE_LINE(14, xHigherPriorityTaskWoken);
 	PIOS_EXTI_HANDLE_LINE(15, xHigherPriorityTaskWoken);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_EXTI);
 #ifdef PIOS_INCLUDE_FREERTOS
 	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
 #endif
@@ -401,6 +401,34 @@ int32_t PIOS_I2C_Transfer(uint32_t i2c_id, const struct pios_i2c_txn txn_list[],
 		0;
 }
 
+/**
+ * @brief Queue a series of I2C transactions, this driver runs them at once
+ * and calls the callback before returning
+ * @returns 0
+ */
+int32_t PIOS_I2C_Queue(uint32_t i2c_id, struct pios_i2c_request *request)
+{
+	request->next = NULL;
+	request->result = PIOS_I2C_Transfer(i2c_id, request->txn_list, request->num_txns);
+	if (request->callback)
+		request->callback(request);
+	return 0;
+}
+
+/**
+ * @brief Nothing to do, queued requests complete in PIOS_I2C_Queue()
+ */
+void PIOS_I2C_Poll(uint32_t i2c_id)
+{
+}
+
+/**
+ * @brief Nothing to do, queued requests complete in PIOS_I2C_Queue()
+ */
+void PIOS_I2C_Cancel(uint32_t i2c_id, struct pios_i2c_request *request)
+{
+}
+
 /*
  *
  *
@@ -43,6 +43,21 @@ static uint32_t nested_ctr;
 /* Stored priority level before IRQ has been disabled (important for co-existence with vPortEnterCritical) */
 static uint32_t prev_primask;
 
+#if defined(DIAG_PROFILE)
+/* Deepest handler nesting that is timed, deeper handlers are counted in their parent */
+#define PIOS_IRQ_PROFILE_MAX_NESTING 8
+
+struct pios_irq_profile_frame {
+	uint32_t start;
+	uint32_t nested_cycles;
+};
+
+static struct pios_irq_profile_frame profile_stack[PIOS_IRQ_PROFILE_MAX_NESTING];
+static uint32_t profile_depth;
+static uint32_t profile_total_cycles;
+static struct pios_irq_profile profile[PIOS_IRQ_CLASS_NUMELEM];
+#endif
+
 /**
 * Disables all interrupts (nested)
 * \return < 0 On errors
@@ -90,6 +105,87 @@ int32_t PIOS_IRQ_Enable(void)
 	return 0;
 }
 
+#if defined(DIAG_PROFILE)
+/**
+* Start timing an interrupt handler, called first thing in the handler
+*/
+void PIOS_IRQ_ProfileEnter(void)
+{
+	uint32_t primask;
+
+	/* A handler preempting this one would otherwise take the same frame */
+	__asm volatile ("   mrs %0, primask\n" "   cpsid i\n":"=r" (primask));
+
+	if (profile_depth < PIOS_IRQ_PROFILE_MAX_NESTING) {
+		profile_stack[profile_depth].start = PIOS_DELAY_GetRaw();
+		profile_stack[profile_depth].nested_cycles = 0;
+	}
+	++profile_depth;
+
+	__asm volatile ("   msr primask, %0\n"::"r" (primask));
+}
+
+/**
+* Stop timing an interrupt handler, called last thing in the handler
+* \param[in] irq_class group to account the handler to
+*/
+void PIOS_IRQ_ProfileExit(enum pios_irq_class irq_class)
+{
+	uint32_t primask;
+
+	__asm volatile ("   mrs %0, primask\n" "   cpsid i\n":"=r" (primask));
+
+	if (profile_depth > 0 && --profile_depth < PIOS_IRQ_PROFILE_MAX_NESTING) {
+		struct pios_irq_profile_frame * frame = &profile_stack[profile_depth];
+		uint32_t elapsed = PIOS_DELAY_GetRaw() - frame->start;
+		uint32_t cycles = elapsed - frame->nested_cycles;
+
+		if (irq_class < PIOS_IRQ_CLASS_NUMELEM) {
+			profile[irq_class].cycles += cycles;
+			profile[irq_class].count++;
+			if (cycles > profile[irq_class].max_cycles)
+				profile[irq_class].max_cycles = cycles;
+		}
+
+		/* The preempted handler or task did not run for this long */
+		if (profile_depth > 0)
+			profile_stack[profile_depth - 1].nested_cycles += elapsed;
+		else
+			profile_total_cycles += elapsed;
+	}
+
+	__asm volatile ("   msr primask, %0\n"::"r" (primask));
+}
+
+/**
+* Cumulative cycles spent in all profiled handlers
+*/
+uint32_t PIOS_IRQ_ProfileTotal(void)
+{
+	return profile_total_cycles;
+}
+
+/**
+* Get the profile of a group of handlers and restart its maximum
+* \param[in] irq_class group of handlers
+* \param[out] irq_profile cumulative cycles and calls, longest call
+*/
+void PIOS_IRQ_ProfileGet(enum pios_irq_class irq_class, struct pios_irq_profile * irq_profile)
+{
+	uint32_t primask;
+
+	if (irq_class >= PIOS_IRQ_CLASS_NUMELEM)
+		return;
+
+	__asm volatile ("   mrs %0, primask\n" "   cpsid i\n":"=r" (primask));
+
+	*irq_profile = profile[irq_class];
+	profile[irq_class].max_cycles = 0;
+
+	__asm volatile ("   msr primask, %0\n"::"r" (primask));
+}
+#endif
+
 #endif
 
 /**
@@ -42,11 +42,17 @@ static uint16_t PIOS_SBus_RxInCallback(uint32_t context,
 				       uint16_t *headroom,
 				       bool *need_yield);
 static void PIOS_SBus_Supervisor(uint32_t sbus_id);
+#if defined(PIOS_INCLUDE_FREERTOS)
+static xSemaphoreHandle PIOS_SBus_GetSemaphore(uint32_t rcvr_id, uint8_t channel);
+#endif
 
 
 /* Local Variables */
 const struct pios_rcvr_driver pios_sbus_rcvr_driver = {
 	.read = PIOS_SBus_Get,
+#if defined(PIOS_INCLUDE_FREERTOS)
+	.get_semaphore = PIOS_SBus_GetSemaphore,
+#endif
 };
 
 enum pios_sbus_dev_magic {
@@ -66,6 +72,9 @@ struct pios_sbus_dev {
 	enum pios_sbus_dev_magic magic;
 	const struct pios_sbus_cfg *cfg;
 	struct pios_sbus_state state;
+#if defined(PIOS_INCLUDE_FREERTOS)
+	xSemaphoreHandle new_frame;
+#endif
 };
 
 /* Allocate S.Bus device descriptor */
@@ -141,6 +150,10 @@ int32_t PIOS_SBus_Init(uint32_t *sbus_id,
 
 	PIOS_SBus_ResetState(&(sbus_dev->state));
 
+#if defined(PIOS_INCLUDE_FREERTOS)
+	vSemaphoreCreateBinary(sbus_dev->new_frame);
+#endif
+
 	*sbus_id = (uint32_t)sbus_dev;
 
 	/* Enable inverter clock and enable the inverter */
@@ -183,6 +196,21 @@ static int32_t PIOS_SBus_Get(uint32_t rcvr_id, uint8_t channel)
 	return sbus_dev->state.channel_data[channel];
 }
 
+#if defined(PIOS_INCLUDE_FREERTOS)
+/**
+ * Get the semaphore given on every decoded frame, all channels share it
+ */
+static xSemaphoreHandle PIOS_SBus_GetSemaphore(uint32_t rcvr_id, uint8_t channel)
+{
+	struct pios_sbus_dev *sbus_dev = (struct pios_sbus_dev *)rcvr_id;
+
+	if (!PIOS_SBus_Validate(sbus_dev))
+		return NULL;
+
+	return sbus_dev->new_frame;
+}
+#endif
+
 /**
  * Compute channel_data[] from received_data[].
  * For efficiency it unrolls first 8 channels without loops and does the
@@ -220,12 +248,17 @@ static void PIOS_SBus_UnrollChannels(struct pios_sbus_state *state)
 	*d++ = (s[22] & SBUS_FLAG_DC2) ? SBUS_VALUE_MAX : SBUS_VALUE_MIN;
 }
 
-/* Update decoder state processing input byte from the S.Bus stream */
-static void PIOS_SBus_UpdateState(struct pios_sbus_state *state, uint8_t b)
+/*
+ * Update decoder state processing input byte from the S.Bus stream
+ * \output true when the byte completed a frame that updated the channels
+ */
+static bool PIOS_SBus_UpdateState(struct pios_sbus_state *state, uint8_t b)
 {
+	bool decoded = false;
+
 	/* should not process any data until new frame is found */
 	if (!state->frame_found)
-		return;
+		return false;
 
 	if (state->byte_count == 0) {
 		if (b != SBUS_SOF_BYTE) {
@@ -235,7 +268,7 @@ static void PIOS_SBus_UpdateState(struct pios_sbus_state *state, uint8_t b)
 			/* do not store the SOF byte */
 			state->byte_count++;
 		}
-		return;
+		return false;
 	}
 
 	/* do not store last frame byte as well */
@@ -252,10 +285,12 @@ static void PIOS_SBus_UpdateState(struct pios_sbus_state *state, uint8_t b)
 			} else if (flags & SBUS_FLAG_FS) {
 				/* failsafe flag active */
 				PIOS_SBus_ResetChannels(state);
+				decoded = true;
 			} else {
 				/* data looking good */
 				PIOS_SBus_UnrollChannels(state);
 				state->failsafe_timer = 0;
+				decoded = true;
 			}
 		} else {
 			/* discard whole frame */
@@ -264,6 +299,8 @@ static void PIOS_SBus_UpdateState(struct pios_sbus_state *state, uint8_t b)
 		/* prepare for the next frame */
 		state->frame_found = 0;
 	}
+
+	return decoded;
 }
 
 /* Comm byte received callback */
@@ -279,10 +316,21 @@ static uint16_t PIOS_SBus_RxInCallback(uint32_t context,
 	PIOS_Assert(valid);
 
 	struct pios_sbus_state *state = &(sbus_dev->state);
+	bool decoded = false;
+
+	/*
+	 * With rx DMA the USART hands over what arrived when the line went
+	 * idle, so a run of exactly one frame is a frame and the decoder can
+	 * sync on it without waiting for the supervisor to see the gap.
+	 */
+	if (buf_len == SBUS_FRAME_LENGTH && buf[0] == SBUS_SOF_BYTE && buf[SBUS_FRAME_LENGTH - 1] == SBUS_EOF_BYTE) {
+		state->frame_found = 1;
+		state->byte_count = 0;
+	}
 
 	/* process byte(s) and clear receive timer */
 	for (uint8_t i = 0; i < buf_len; i++) {
-		PIOS_SBus_UpdateState(state, buf[i]);
+		decoded |= PIOS_SBus_UpdateState(state, buf[i]);
 		state->receive_timer = 0;
 	}
 
@@ -290,8 +338,15 @@ static uint16_t PIOS_SBus_RxInCallback(uint32_t context,
 	if (headroom)
 		*headroom = SBUS_FRAME_LENGTH;
 
-	/* We never need a yield */
+	/* Wake whoever waits for fresh channels */
 	*need_yield = false;
+#if defined(PIOS_INCLUDE_FREERTOS)
+	if (decoded) {
+		portBASE_TYPE woken = pdFALSE;
+		xSemaphoreGiveFromISR(sbus_dev->new_frame, &woken);
+		*need_yield = (woken == pdTRUE);
+	}
+#endif
 
 	/* Always indicate that all bytes were consumed */
 	return buf_len;
@@ -306,6 +306,31 @@ int32_t PIOS_SPI_ReleaseBus(uint32_t spi_id)
 	return 0;
 }
 
+/**
+ * Release the SPI bus semaphore from an ISR.
+ * \param[in] spi SPI number (0 or 1)
+ * \param[in,out] woken set true if a higher priority task was woken
+ * \return 0 if no error
+ */
+int32_t PIOS_SPI_ReleaseBusISR(uint32_t spi_id, bool * woken)
+{
+	struct pios_spi_dev * spi_dev = (struct pios_spi_dev *)spi_id;
+
+	bool valid = PIOS_SPI_validate(spi_dev);
+	PIOS_Assert(valid)
+
+#if defined(PIOS_INCLUDE_FREERTOS)
+	signed portBASE_TYPE higherPriorityTaskWoken = pdFALSE;
+
+	xSemaphoreGiveFromISR(spi_dev->busy, &higherPriorityTaskWoken);
+	if (higherPriorityTaskWoken == pdTRUE)
+		*woken = true;
+#else
+	spi_dev->busy = 0;
+#endif
+	return 0;
+}
+
 /**
  * Controls the RC (Register Clock alias Chip Select) pin of a SPI port
  * \param[in] spi SPI number (0 or 1)
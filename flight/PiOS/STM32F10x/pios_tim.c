@@ -154,6 +154,30 @@ out_fail:
 	return(-1);
 }
 
+/**
+ * Check whether a client registered callbacks for a channel of a timer, such
+ * as a receiver capturing on it. The period and update events of such a timer
+ * must be left alone.
+ */
+bool PIOS_TIM_HasCallbacks(const TIM_TypeDef * timer)
+{
+	for (uint8_t i = 0; i < pios_tim_num_devs; i++) {
+		const struct pios_tim_dev * tim_dev = &pios_tim_devs[i];
+
+		if (!tim_dev->callbacks) {
+			continue;
+		}
+
+		for (uint8_t j = 0; j < tim_dev->num_channels; j++) {
+			if (tim_dev->channels[j].timer == timer) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 static void PIOS_TIM_generic_irq_handler(TIM_TypeDef * timer)
 {
 	/* Iterate over all registered clients of the TIM layer to find channels on this timer */
@@ -368,60 +392,80 @@ static void PIOS_TIM_generic_irq_handler(TIM_TypeDef * timer)
 void TIM1_UP_IRQHandler(void) __attribute__ ((alias ("PIOS_TIM_1_UP_irq_handler")));
 static void PIOS_TIM_1_UP_irq_handler (void)
 {
+	PIOS_IRQ_Prologue();
 	PIOS_TIM_generic_irq_handler (TIM1);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_TIM);
 }
 
 void TIM1_CC_IRQHandler(void) __attribute__ ((alias ("PIOS_TIM_1_CC_irq_handler")));
 static void PIOS_TIM_1_CC_irq_handler (void)
 {
+	PIOS_IRQ_Prologue();
 	PIOS_TIM_generic_irq_handler (TIM1);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_TIM);
 }
 
 void TIM2_IRQHandler(void) __attribute__ ((alias ("PIOS_TIM_2_irq_handler")));
 static void PIOS_TIM_2_irq_handler (void)
 {
+	PIOS_IRQ_Prologue();
 	PIOS_TIM_generic_irq_handler (TIM2);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_TIM);
 }
 
 void TIM3_IRQHandler(void) __attribute__ ((alias ("PIOS_TIM_3_irq_handler")));
 static void PIOS_TIM_3_irq_handler (void)
 {
+	PIOS_IRQ_Prologue();
 	PIOS_TIM_generic_irq_handler (TIM3);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_TIM);
 }
 
 void TIM4_IRQHandler(void) __attribute__ ((alias ("PIOS_TIM_4_irq_handler")));
 static void PIOS_TIM_4_irq_handler (void)
 {
+	PIOS_IRQ_Prologue();
 	PIOS_TIM_generic_irq_handler (TIM4);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_TIM);
 }
 
 void TIM5_IRQHandler(void) __attribute__ ((alias ("PIOS_TIM_5_irq_handler")));
 static void PIOS_TIM_5_irq_handler (void)
 {
+	PIOS_IRQ_Prologue();
 	PIOS_TIM_generic_irq_handler (TIM5);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_TIM);
 }
 
 void TIM6_IRQHandler(void) __attribute__ ((alias ("PIOS_TIM_6_irq_handler")));
 static void PIOS_TIM_6_irq_handler (void)
 {
+	PIOS_IRQ_Prologue();
 	PIOS_TIM_generic_irq_handler (TIM6);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_TIM);
 }
 
 void TIM7_IRQHandler(void) __attribute__ ((alias ("PIOS_TIM_7_irq_handler")));
 static void PIOS_TIM_7_irq_handler (void)
 {
+	PIOS_IRQ_Prologue();
 	PIOS_TIM_generic_irq_handler (TIM7);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_TIM);
 }
 
 void TIM8_UP_IRQHandler(void) __attribute__ ((alias ("PIOS_TIM_8_UP_irq_handler")));
 static void PIOS_TIM_8_UP_irq_handler (void)
 {
+	PIOS_IRQ_Prologue();
 	PIOS_TIM_generic_irq_handler (TIM8);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_TIM);
 }
 
 void TIM8_CC_IRQHandler(void) __attribute__ ((alias ("PIOS_TIM_8_CC_irq_handler")));
 static void PIOS_TIM_8_CC_irq_handler (void)
 {
+	PIOS_IRQ_Prologue();
 	PIOS_TIM_generic_irq_handler (TIM8);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_TIM);
 }
 
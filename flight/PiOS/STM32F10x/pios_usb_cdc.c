@@ -70,6 +70,8 @@ struct pios_usb_cdc_dev {
 
 	uint8_t rx_packet_buffer[PIOS_USB_BOARD_CDC_DATA_LENGTH];
 	uint8_t tx_packet_buffer[PIOS_USB_BOARD_CDC_DATA_LENGTH];
+	/* Bytes of tx_packet_buffer already taken from the COM layer, not sent yet */
+	uint16_t tx_packet_length;
 
 	uint32_t rx_dropped;
 	uint32_t rx_oversize;
@@ -132,6 +134,7 @@ int32_t PIOS_USB_CDC_Init(uint32_t * usbcdc_id, const struct pios_usb_cdc_cfg *
 	/* Bind the configuration to the device instance */
 	usb_cdc_dev->cfg = cfg;
 	usb_cdc_dev->lower_id = lower_id;
+	usb_cdc_dev->tx_packet_length = 0;
 
 	pios_usb_cdc_id = (uint32_t) usb_cdc_dev;
 
@@ -199,30 +202,50 @@ static void PIOS_USB_CDC_RxStart(uint32_t usbcdc_id, uint16_t rx_bytes_avail) {
 	PIOS_IRQ_Enable();
 }
 
-static void PIOS_USB_CDC_SendData(struct pios_usb_cdc_dev * usb_cdc_dev)
+/**
+ * Fill tx_packet_buffer from the COM layer if it is empty
+ * \return true if the COM layer asked for a yield
+ */
+static bool PIOS_USB_CDC_StageData(struct pios_usb_cdc_dev * usb_cdc_dev)
 {
-	uint16_t bytes_to_tx;
+	bool need_yield = false;
+
+	if (usb_cdc_dev->tx_packet_length == 0) {
+		usb_cdc_dev->tx_packet_length = (usb_cdc_dev->tx_out_cb)(usb_cdc_dev->tx_out_context,
+								usb_cdc_dev->tx_packet_buffer,
+								sizeof(usb_cdc_dev->tx_packet_buffer),
+								NULL,
+								&need_yield);
+	}
+
+	return need_yield;
+}
 
+/**
+ * Hand the staged packet to the endpoint and stage the next one while the
+ * host reads it, so the endpoint is only NAK'd for the copy into the PMA
+ * when the host comes back for more.
+ */
+static void PIOS_USB_CDC_SendData(struct pios_usb_cdc_dev * usb_cdc_dev)
+{
 	if (!usb_cdc_dev->tx_out_cb) {
 		return;
 	}
 
-	bool need_yield = false;
-	bytes_to_tx = (usb_cdc_dev->tx_out_cb)(usb_cdc_dev->tx_out_context,
-					       usb_cdc_dev->tx_packet_buffer,
-					       sizeof(usb_cdc_dev->tx_packet_buffer),
-					       NULL,
-					       &need_yield);
-	if (bytes_to_tx == 0) {
+	bool need_yield = PIOS_USB_CDC_StageData(usb_cdc_dev);
+	if (usb_cdc_dev->tx_packet_length == 0) {
 		return;
 	}
 
 	UserToPMABufferCopy(usb_cdc_dev->tx_packet_buffer,
 			GetEPTxAddr(usb_cdc_dev->cfg->data_tx_ep),
-			bytes_to_tx);
-	SetEPTxCount(usb_cdc_dev->cfg->data_tx_ep, bytes_to_tx);
+			usb_cdc_dev->tx_packet_length);
+	SetEPTxCount(usb_cdc_dev->cfg->data_tx_ep, usb_cdc_dev->tx_packet_length);
 	SetEPTxValid(usb_cdc_dev->cfg->data_tx_ep);
 
+	usb_cdc_dev->tx_packet_length = 0;
+	need_yield |= PIOS_USB_CDC_StageData(usb_cdc_dev);
+
 #if defined(PIOS_INCLUDE_FREERTOS)
 	if (need_yield) {
 		vPortYieldFromISR();
@@ -241,12 +264,13 @@ static void PIOS_USB_CDC_TxStart(uint32_t usbcdc_id, uint16_t tx_bytes_avail)
 		return;
 	}
 
-	if (GetEPTxStatus(usb_cdc_dev->cfg->data_tx_ep) == EP_TX_VALID) {
-		/* Endpoint is already transmitting */
-		return;
+	/* The staged packet is shared with the endpoint interrupt */
+	PIOS_IRQ_Disable();
+	if (GetEPTxStatus(usb_cdc_dev->cfg->data_tx_ep) != EP_TX_VALID) {
+		PIOS_USB_CDC_SendData(usb_cdc_dev);
 	}
-
-	PIOS_USB_CDC_SendData(usb_cdc_dev);
+	/* else: endpoint is already transmitting, the interrupt sends the rest */
+	PIOS_IRQ_Enable();
 }
 
 static void PIOS_USB_CDC_DATA_EP_IN_Callback(void)
@@ -236,20 +236,32 @@ void PIOS_ADC_Config(uint32_t oversampling)
  */
 int32_t PIOS_ADC_PinGet(uint32_t pin)
 {
-#if defined(PIOS_INCLUDE_ADC)
-	int32_t	result;
+	return PIOS_ADC_PinGetAverage(pin);
+}
 
+/**
+ * Returns the mean of all the samples of an ADC Pin since the last call for that pin
+ * @param[in] pin number
+ * @return mean raw ADC value, 0 if no sample was taken yet
+ * @return -1 if pin doesn't exist
+ */
+float PIOS_ADC_PinGetAverage(uint32_t pin)
+{
+#if defined(PIOS_INCLUDE_ADC)
 	/* Check if pin exists */
 	if (pin >= PIOS_ADC_NUM_PINS) {
 		return -1;
 	}
 
-	/* return accumulated result and clear accumulator */
-	result = accumulator[pin].accumulator / (accumulator[pin].count ?: 1);
+	/* return accumulated result and clear accumulator, it is updated from the DMA interrupt */
+	PIOS_IRQ_Disable();
+	uint32_t sum = accumulator[pin].accumulator;
+	uint32_t count = accumulator[pin].count;
 	accumulator[pin].accumulator = 0;
 	accumulator[pin].count = 0;
+	PIOS_IRQ_Enable();
 
-	return result;
+	return count ? (float)sum / count : 0;
 #endif
 	return -1;
 }
@@ -334,7 +346,7 @@ void accumulate(uint16_t *buffer, uint32_t count)
 			 * If the accumulator reaches half-full, rescale in order to
 			 * make more space.
 			 */
-			if (accumulator[i].accumulator >= (1 << 31)) {
+			if (accumulator[i].accumulator >= (1u << 31)) {
 				accumulator[i].accumulator /= 2;
 				accumulator[i].count /= 2;
 			}
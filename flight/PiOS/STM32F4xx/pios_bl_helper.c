@@ -166,6 +166,67 @@ uint8_t PIOS_BL_HELPER_FLASH_Start()
 
 	return (fail == true) ? 0 : 1;
 }
+
+/**
+ * Finds a block of the firmware and description partition, the part of
+ * it in one flash sector as that is what can be erased on its own
+ * \param[in] block index of the block from the start of the partition
+ * \param[out] start offset of the block in the partition
+ * \param[out] size size of the block
+ * \return 0 past the end of the partition
+ */
+uint8_t PIOS_BL_HELPER_FLASH_GetBlock(uint32_t block, uint32_t *start, uint32_t *size)
+{
+	const struct pios_board_info * bdinfo = &pios_board_info_blob;
+	uint32_t end = bdinfo->fw_base + bdinfo->fw_size + bdinfo->desc_size;
+	uint32_t pageAddress = bdinfo->fw_base;
+	while (pageAddress < end) {
+		uint8_t sector_number;
+		uint32_t sector_start;
+		uint32_t sector_size;
+		if (!PIOS_BL_HELPER_FLASH_GetSectorInfo(pageAddress,
+								&sector_number,
+								&sector_start,
+								&sector_size)) {
+			return 0;
+		}
+		uint32_t sector_end = sector_start + sector_size;
+		if (block == 0) {
+			*start = pageAddress - bdinfo->fw_base;
+			*size = ((sector_end < end) ? sector_end : end) - pageAddress;
+			return 1;
+		}
+		--block;
+		pageAddress = sector_end;
+	}
+	return 0;
+}
+
+/**
+ * Erases one block of the partition, see PIOS_BL_HELPER_FLASH_GetBlock
+ */
+uint8_t PIOS_BL_HELPER_FLASH_EraseBlock(uint32_t block)
+{
+	const struct pios_board_info * bdinfo = &pios_board_info_blob;
+	uint32_t start;
+	uint32_t size;
+	uint8_t sector_number;
+	uint32_t sector_start;
+	uint32_t sector_size;
+	if (!PIOS_BL_HELPER_FLASH_GetBlock(block, &start, &size) ||
+		!PIOS_BL_HELPER_FLASH_GetSectorInfo(bdinfo->fw_base + start,
+								&sector_number,
+								&sector_start,
+								&sector_size)) {
+		return 0;
+	}
+	for (int retry = 0; retry < MAX_DEL_RETRYS; ++retry) {
+		if (FLASH_EraseSector(sector_number, VoltageRange_3) == FLASH_COMPLETE) {
+			return 1;
+		}
+	}
+	return 0;
+}
 #endif
 
 uint32_t PIOS_BL_HELPER_CRC_Memory_Calc()
@@ -178,6 +239,16 @@ uint32_t PIOS_BL_HELPER_CRC_Memory_Calc()
 	return CRC_GetCRC();
 }
 
+uint32_t PIOS_BL_HELPER_CRC_Block_Calc(uint32_t start, uint32_t size)
+{
+	const struct pios_board_info * bdinfo = &pios_board_info_blob;
+
+	PIOS_BL_HELPER_CRC_Ini();
+	CRC_ResetDR();
+	CRC_CalcBlockCRC((uint32_t *) (bdinfo->fw_base + start), size >> 2);
+	return CRC_GetCRC();
+}
+
 void PIOS_BL_HELPER_FLASH_Read_Description(uint8_t * array, uint8_t size)
 {
 	const struct pios_board_info * bdinfo = &pios_board_info_blob;
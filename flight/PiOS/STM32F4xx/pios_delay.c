@@ -167,6 +167,17 @@ uint32_t PIOS_DELAY_DiffuS(uint32_t raw)
 	return diff / us_ticks;
 }
 
+/**
+ * @brief Difference between two raw times in us, for timestamps captured
+ * when a sample was taken rather than when it is looked at
+ * @return The microseconds from raw to later
+ */
+uint32_t PIOS_DELAY_DiffuS2(uint32_t raw, uint32_t later)
+{
+	uint32_t diff = later - raw;
+	return diff / us_ticks;
+}
+
 #endif
 
 /**
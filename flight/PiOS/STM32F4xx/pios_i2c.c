@@ -131,7 +131,7 @@ static bool i2c_adapter_wait_for_stopped(struct pios_i2c_adapter *i2c_adapter);
 static void i2c_adapter_reset_bus(struct pios_i2c_adapter *i2c_adapter);
 
 static void i2c_adapter_log_fault(enum pios_i2c_error_type type);
-static bool i2c_adapter_callback_handler(struct pios_i2c_adapter *i2c_adapter);
+static void i2c_adapter_process_queue(struct pios_i2c_adapter *i2c_adapter);
 
 const static struct i2c_adapter_transition i2c_adapter_transitions[I2C_STATE_NUM_STATES] = {
 	[I2C_STATE_FSM_FAULT] = {
@@ -370,8 +370,8 @@ static void go_fsm_fault(struct pios_i2c_adapter *i2c_adapter)
 	/* Note that this transfer has hit a bus error */
 	i2c_adapter->bus_error = true;
 
-	i2c_adapter_reset_bus(i2c_adapter);
-	
+	/* The bus is reset in task context by i2c_adapter_process_queue() */
+	i2c_adapter->reset_needed = true;
 }
 
 static void go_bus_error(struct pios_i2c_adapter *i2c_adapter)
@@ -379,28 +379,14 @@ static void go_bus_error(struct pios_i2c_adapter *i2c_adapter)
 	/* Note that this transfer has hit a bus error */
 	i2c_adapter->bus_error = true;
 
-	i2c_adapter_reset_bus(i2c_adapter);
+	/* The bus is reset in task context by i2c_adapter_process_queue() */
+	i2c_adapter->reset_needed = true;
 }
 
 static void go_stopping(struct pios_i2c_adapter *i2c_adapter)
 {
-#ifdef USE_FREERTOS
-	signed portBASE_TYPE pxHigherPriorityTaskWoken = pdFALSE;
-#endif
-
+	/* The request is completed by i2c_adapter_irq_done() */
 	I2C_ITConfig(i2c_adapter->cfg->regs, I2C_IT_EVT | I2C_IT_BUF | I2C_IT_ERR, DISABLE);
-
-#ifdef USE_FREERTOS
-	if (xSemaphoreGiveFromISR(i2c_adapter->sem_ready, &pxHigherPriorityTaskWoken) != pdTRUE) {
-#if defined(I2C_HALT_ON_ERRORS)
-		PIOS_DEBUG_Assert(0);
-#endif
-	}
-	portEND_SWITCHING_ISR(pxHigherPriorityTaskWoken);	/* FIXME: is this the right place for this? */
-#endif /* USE_FREERTOS */
-
-	if(i2c_adapter->callback)
-		i2c_adapter_callback_handler(i2c_adapter);
 }
 
 static void go_stopped(struct pios_i2c_adapter *i2c_adapter)
@@ -762,57 +748,155 @@ static void i2c_adapter_reset_bus(struct pios_i2c_adapter *i2c_adapter)
 
 #include <pios_i2c_priv.h>
 
-/* Return true if the FSM is in a terminal state */
-static bool i2c_adapter_fsm_terminated(struct pios_i2c_adapter *i2c_adapter)
+/**
+ * Put the request at the head of the queue on the bus, the FSM must be stopped.
+ * Called with interrupts disabled.
+ */
+static void i2c_adapter_start_request(struct pios_i2c_adapter *i2c_adapter)
 {
-	switch (i2c_adapter->curr_state) {
-	case I2C_STATE_STOPPING:
-	case I2C_STATE_STOPPED:
-		return (true);
-	default:
-		return (false);
+	const struct pios_i2c_request *request = i2c_adapter->active_request;
+
+	PIOS_DEBUG_Assert(i2c_adapter->curr_state == I2C_STATE_STOPPED);
+
+	i2c_adapter->first_txn = &request->txn_list[0];
+	i2c_adapter->last_txn = &request->txn_list[request->num_txns - 1];
+	i2c_adapter->active_txn = i2c_adapter->first_txn;
+	i2c_adapter->bus_error = false;
+	i2c_adapter->nack = false;
+	i2c_adapter->request_on_bus = true;
+	i2c_adapter_inject_event(i2c_adapter, I2C_EVENT_START);
+}
+
+/**
+ * Take a request off the queue with its result and run its callback.
+ * Called with interrupts disabled.
+ */
+static void i2c_adapter_finish_request(struct pios_i2c_adapter *i2c_adapter, struct pios_i2c_request *request, int32_t result)
+{
+	struct pios_i2c_request *prev = NULL;
+	struct pios_i2c_request **link = &i2c_adapter->active_request;
+
+	while (*link != request) {
+		prev = *link;
+		link = &prev->next;
 	}
+	*link = request->next;
+	if (i2c_adapter->last_request == request)
+		i2c_adapter->last_request = prev;
+
+	request->result = result;
+	if (request->callback)
+		request->callback(request);
 }
 
-uint32_t i2c_cb_count = 0;
-static bool i2c_adapter_callback_handler(struct pios_i2c_adapter * i2c_adapter) 
+/**
+ * Hand the result to the request on the bus once the FSM reached the
+ * stopping state. The stop condition itself is finished by
+ * i2c_adapter_process_queue(). Called with interrupts disabled.
+ * @returns true if a request completed
+ */
+static bool i2c_adapter_complete_request(struct pios_i2c_adapter *i2c_adapter)
 {
-	bool semaphore_success = true;
-	/* Wait for the transfer to complete */
+	if (!i2c_adapter->request_on_bus || i2c_adapter->curr_state != I2C_STATE_STOPPING)
+		return false;
+
+	i2c_adapter->request_on_bus = false;
+	i2c_adapter_finish_request(i2c_adapter, i2c_adapter->active_request,
+		i2c_adapter->bus_error ? -1 :
+		i2c_adapter->nack ? -3 :
+		0);
+	return true;
+}
+
+/**
+ * Run at the end of the interrupt handlers. A completed request wakes the
+ * blocking transfer, if any, which then finishes the stop condition and
+ * starts the next request.
+ */
+static void i2c_adapter_irq_done(struct pios_i2c_adapter *i2c_adapter)
+{
+	PIOS_IRQ_Disable();
+	bool completed = i2c_adapter_complete_request(i2c_adapter);
+	PIOS_IRQ_Enable();
+
 #ifdef USE_FREERTOS
-	portTickType timeout;
-	timeout = i2c_adapter->cfg->transfer_timeout_ms / portTICK_RATE_MS;
-	semaphore_success &= (xSemaphoreTake(i2c_adapter->sem_ready, timeout) == pdTRUE);
-	xSemaphoreGive(i2c_adapter->sem_ready);
+	if (completed) {
+		signed portBASE_TYPE pxHigherPriorityTaskWoken = pdFALSE;
+		xSemaphoreGiveFromISR(i2c_adapter->sem_ready, &pxHigherPriorityTaskWoken);
+		portEND_SWITCHING_ISR(pxHigherPriorityTaskWoken);
+	}
+#else
+	(void) completed;
 #endif /* USE_FREERTOS */
-	
-	/* Spin waiting for the transfer to finish */
-	while (!i2c_adapter_fsm_terminated(i2c_adapter)) ;
-	
-	if (i2c_adapter_wait_for_stopped(i2c_adapter)) {
-		i2c_adapter_inject_event(i2c_adapter, I2C_EVENT_STOPPED);
-	} else {
-		i2c_adapter_fsm_init(i2c_adapter);
+}
+
+/**
+ * Finish the stop condition of the last request, reset the bus after an
+ * error and start the next request. Waiting for the stop bit and resetting
+ * the bus take a while, so this only runs in task context.
+ */
+static void i2c_adapter_process_queue(struct pios_i2c_adapter *i2c_adapter)
+{
+	for (;;) {
+		PIOS_IRQ_Disable();
+
+		/* The FSM stops right away on some bus errors */
+		i2c_adapter_complete_request(i2c_adapter);
+
+		if (i2c_adapter->bus_claimed || i2c_adapter->request_on_bus) {
+			/* Another task or the interrupt handlers carry on */
+			PIOS_IRQ_Enable();
+			return;
+		}
+
+		if (i2c_adapter->curr_state == I2C_STATE_STOPPED && !i2c_adapter->reset_needed) {
+			if (!i2c_adapter->active_request) {
+				PIOS_IRQ_Enable();
+				return;
+			}
+			i2c_adapter_start_request(i2c_adapter);
+			PIOS_IRQ_Enable();
+			continue;
+		}
+
+		/* Keep the other tasks off the bus, the I2C interrupts are disabled from the stopping state on */
+		i2c_adapter->bus_claimed = true;
+		PIOS_IRQ_Enable();
+
+		if (!i2c_adapter->reset_needed &&
+		    i2c_adapter->curr_state == I2C_STATE_STOPPING &&
+		    i2c_adapter_wait_for_stopped(i2c_adapter)) {
+			i2c_adapter_inject_event(i2c_adapter, I2C_EVENT_STOPPED);
+		} else {
+			i2c_adapter_fsm_init(i2c_adapter);
+		}
+
+		PIOS_IRQ_Disable();
+		i2c_adapter->reset_needed = false;
+		i2c_adapter->bus_claimed = false;
+		PIOS_IRQ_Enable();
 	}
-	
-	// Execute user supplied function
-	i2c_adapter->callback();
-	
-	i2c_cb_count++;
+}
 
-#ifdef USE_FREERTOS
-	/* Unlock the bus */
-	xSemaphoreGive(i2c_adapter->sem_busy);
-	if(!semaphore_success)
-		i2c_timeout_counter++;
-#else
+/**
+ * Give up on a request of the caller, it fails with -2. A request still in the
+ * queue is only taken out of it, the bus is reset if the request is on it.
+ * The requests of others are not affected.
+ */
+static void i2c_adapter_abort_request(struct pios_i2c_adapter *i2c_adapter, struct pios_i2c_request *request)
+{
 	PIOS_IRQ_Disable();
-	i2c_adapter->busy = 0;
+	if (request->result == PIOS_I2C_PENDING) {
+		if (request == i2c_adapter->active_request && i2c_adapter->request_on_bus) {
+			I2C_ITConfig(i2c_adapter->cfg->regs, I2C_IT_EVT | I2C_IT_BUF | I2C_IT_ERR, DISABLE);
+			i2c_adapter->request_on_bus = false;
+			i2c_adapter->reset_needed = true;
+		}
+		i2c_adapter_finish_request(i2c_adapter, request, -2);
+	}
 	PIOS_IRQ_Enable();
-#endif /* USE_FREERTOS */
-	
 
-	return (!i2c_adapter->bus_error) && semaphore_success;
+	i2c_adapter_process_queue(i2c_adapter);
 }
 
 /**
@@ -934,9 +1018,12 @@ int32_t PIOS_I2C_Init(uint32_t * i2c_id, const struct pios_i2c_adapter_cfg * cfg
 	 */
 	vSemaphoreCreateBinary(i2c_adapter->sem_ready);
 	i2c_adapter->sem_busy = xSemaphoreCreateMutex();
-#else
-	i2c_adapter->busy = 0;
 #endif // USE_FREERTOS
+	i2c_adapter->active_request = NULL;
+	i2c_adapter->last_request = NULL;
+	i2c_adapter->request_on_bus = false;
+	i2c_adapter->bus_claimed = false;
+	i2c_adapter->reset_needed = false;
 
 	/* Initialize the state machine */
 	i2c_adapter_fsm_init(i2c_adapter);
@@ -954,6 +1041,14 @@ out_fail:
 	return(-1);
 }
 
+/**
+ * @brief Perform a series of I2C transactions, queued behind the requests
+ * already waiting for the bus
+ * @returns 0 if success or error code
+ * @retval -1 for failed transaction 
+ * @retval -2 for a timeout
+ * @retval -3 if the device did not acknowledge
+ */
 int32_t PIOS_I2C_Transfer(uint32_t i2c_id, const struct pios_i2c_txn txn_list[], uint32_t num_txns)
 {
 	struct pios_i2c_adapter * i2c_adapter = (struct pios_i2c_adapter *)i2c_id;
@@ -961,115 +1056,116 @@ int32_t PIOS_I2C_Transfer(uint32_t i2c_id, const struct pios_i2c_txn txn_list[],
 	bool valid = PIOS_I2C_validate(i2c_adapter);
 	PIOS_Assert(valid)
 
-	PIOS_DEBUG_Assert(txn_list);
-	PIOS_DEBUG_Assert(num_txns);
-
-	bool semaphore_success = true;
+	struct pios_i2c_request request = {
+		.txn_list = txn_list,
+		.num_txns = num_txns,
+	};
 
 #ifdef USE_FREERTOS
-	/* Lock the bus */
+	/* One blocking transfer at a time, they share sem_ready */
 	portTickType timeout;
 	timeout = i2c_adapter->cfg->transfer_timeout_ms / portTICK_RATE_MS;
-	semaphore_success &= (xSemaphoreTake(i2c_adapter->sem_busy, timeout) == pdTRUE);
-#else	
-	PIOS_IRQ_Disable();
-	if(i2c_adapter->busy) {
-		PIOS_IRQ_Enable();
+	if (xSemaphoreTake(i2c_adapter->sem_busy, timeout) != pdTRUE) {
+		i2c_timeout_counter++;
 		return -2;
 	}
-	i2c_adapter->busy = 1;
-	PIOS_IRQ_Enable();
-#endif /* USE_FREERTOS */
 
-	PIOS_DEBUG_Assert(i2c_adapter->curr_state == I2C_STATE_STOPPED);
-
-	i2c_adapter->first_txn = &txn_list[0];
-	i2c_adapter->last_txn = &txn_list[num_txns - 1];
-	i2c_adapter->active_txn = i2c_adapter->first_txn;
-
-#ifdef USE_FREERTOS
 	/* Make sure the done/ready semaphore is consumed before we start */
-	semaphore_success &= (xSemaphoreTake(i2c_adapter->sem_ready, timeout) == pdTRUE);
-#endif
+	xSemaphoreTake(i2c_adapter->sem_ready, 0);
 
-	i2c_adapter->callback = NULL;
-	i2c_adapter->bus_error = false;
-	i2c_adapter->nack = false;
-	i2c_adapter_inject_event(i2c_adapter, I2C_EVENT_START);
+	PIOS_I2C_Queue(i2c_id, &request);
 
-	/* Wait for the transfer to complete */
-#ifdef USE_FREERTOS
-	semaphore_success &= (xSemaphoreTake(i2c_adapter->sem_ready, timeout) == pdTRUE);
-	xSemaphoreGive(i2c_adapter->sem_ready);
-#endif /* USE_FREERTOS */
-
-	/* Spin waiting for the transfer to finish */
-	while (!i2c_adapter_fsm_terminated(i2c_adapter)) ;
-
-	if (i2c_adapter_wait_for_stopped(i2c_adapter)) {
-		i2c_adapter_inject_event(i2c_adapter, I2C_EVENT_STOPPED);
-	} else {
-		i2c_adapter_fsm_init(i2c_adapter);
+	/*
+	 * sem_ready is given whenever a request completes, this request or one
+	 * ahead of it. The bus is then stopped and the next request started here.
+	 * On a timeout only this request is given up.
+	 */
+	portTickType start = xTaskGetTickCount();
+	while (request.result == PIOS_I2C_PENDING) {
+		portTickType elapsed = xTaskGetTickCount() - start;
+		if (elapsed >= timeout ||
+		    xSemaphoreTake(i2c_adapter->sem_ready, timeout - elapsed) != pdTRUE) {
+			i2c_timeout_counter++;
+			i2c_adapter_abort_request(i2c_adapter, &request);
+			break;
+		}
+		i2c_adapter_process_queue(i2c_adapter);
 	}
+	i2c_adapter_process_queue(i2c_adapter);
 
-#ifdef USE_FREERTOS
 	/* Unlock the bus */
 	xSemaphoreGive(i2c_adapter->sem_busy);
-	if(!semaphore_success)
-		i2c_timeout_counter++;
 #else
+	PIOS_I2C_Queue(i2c_id, &request);
+	while (request.result == PIOS_I2C_PENDING)
+		i2c_adapter_process_queue(i2c_adapter);
+	i2c_adapter_process_queue(i2c_adapter);
+#endif /* USE_FREERTOS */
+
+	return request.result;
+}
+
+/**
+ * @brief Queue a series of I2C transactions and return at once, see
+ * struct pios_i2c_request. Requests run in the order they were queued.
+ * The bus is moved on to the next request from task context, by a blocking
+ * transfer waiting in the queue or by PIOS_I2C_Queue() and PIOS_I2C_Poll().
+ * Must not be called from a request callback.
+ * @returns 0 if queued
+ */
+int32_t PIOS_I2C_Queue(uint32_t i2c_id, struct pios_i2c_request *request)
+{
+	struct pios_i2c_adapter * i2c_adapter = (struct pios_i2c_adapter *)i2c_id;
+
+	bool valid = PIOS_I2C_validate(i2c_adapter);
+	PIOS_Assert(valid)
+
+	PIOS_DEBUG_Assert(request);
+	PIOS_DEBUG_Assert(request->txn_list);
+	PIOS_DEBUG_Assert(request->num_txns);
+
+	request->result = PIOS_I2C_PENDING;
+	request->next = NULL;
+
 	PIOS_IRQ_Disable();
-	i2c_adapter->busy = 0;
+	if (i2c_adapter->active_request)
+		i2c_adapter->last_request->next = request;
+	else
+		i2c_adapter->active_request = request;
+	i2c_adapter->last_request = request;
 	PIOS_IRQ_Enable();
-#endif /* USE_FREERTOS */
 
-	return !semaphore_success ? -2 :
-	i2c_adapter->bus_error ? -1 :
-	i2c_adapter->nack ? -3 :
-	0;
+	i2c_adapter_process_queue(i2c_adapter);
+	return 0;
 }
 
-int32_t PIOS_I2C_Transfer_Callback(uint32_t i2c_id, const struct pios_i2c_txn txn_list[], uint32_t num_txns, void *callback)
+/**
+ * @brief Finish the last request on the bus and start the next queued one.
+ * Users of PIOS_I2C_Queue() call this from their task while they wait for
+ * a request to complete.
+ */
+void PIOS_I2C_Poll(uint32_t i2c_id)
 {
 	struct pios_i2c_adapter * i2c_adapter = (struct pios_i2c_adapter *)i2c_id;
-	
+
 	bool valid = PIOS_I2C_validate(i2c_adapter);
 	PIOS_Assert(valid)
-	PIOS_Assert(callback);
-	
-	PIOS_DEBUG_Assert(txn_list);
-	PIOS_DEBUG_Assert(num_txns);
-	
-	bool semaphore_success = true;
-	
-#ifdef USE_FREERTOS
-	/* Lock the bus */
-	portTickType timeout;
-	timeout = i2c_adapter->cfg->transfer_timeout_ms / portTICK_RATE_MS;
-	semaphore_success &= (xSemaphoreTake(i2c_adapter->sem_busy, timeout) == pdTRUE);
-#else
-	if(i2c_adapter->busy) {
-		PIOS_IRQ_Enable();
-		return -2;
-	}
-#endif /* USE_FREERTOS */
-	
-	PIOS_DEBUG_Assert(i2c_adapter->curr_state == I2C_STATE_STOPPED);
-	
-	i2c_adapter->first_txn = &txn_list[0];
-	i2c_adapter->last_txn = &txn_list[num_txns - 1];
-	i2c_adapter->active_txn = i2c_adapter->first_txn;
-	
-#ifdef USE_FREERTOS
-	/* Make sure the done/ready semaphore is consumed before we start */
-	semaphore_success &= (xSemaphoreTake(i2c_adapter->sem_ready, timeout) == pdTRUE);
-#endif
-	
-	i2c_adapter->callback = callback;
-	i2c_adapter->bus_error = false;
-	i2c_adapter_inject_event(i2c_adapter, I2C_EVENT_START);
-	
-	return !semaphore_success ? -2 : 0;
+
+	i2c_adapter_process_queue(i2c_adapter);
+}
+
+/**
+ * @brief Give up on a queued request that did not complete in time, it fails
+ * with -2. Nothing happens if it already completed.
+ */
+void PIOS_I2C_Cancel(uint32_t i2c_id, struct pios_i2c_request *request)
+{
+	struct pios_i2c_adapter * i2c_adapter = (struct pios_i2c_adapter *)i2c_id;
+
+	bool valid = PIOS_I2C_validate(i2c_adapter);
+	PIOS_Assert(valid)
+
+	i2c_adapter_abort_request(i2c_adapter, request);
 }
 
 void PIOS_I2C_EV_IRQ_Handler(uint32_t i2c_id)
@@ -1079,6 +1175,10 @@ void PIOS_I2C_EV_IRQ_Handler(uint32_t i2c_id)
 	bool valid = PIOS_I2C_validate(i2c_adapter);
 	PIOS_Assert(valid)
 
+	/* A task is stopping or resetting the bus, this interrupt was left pending */
+	if (i2c_adapter->bus_claimed)
+		return;
+
 	uint32_t event = I2C_GetLastEvent(i2c_adapter->cfg->regs);
 
 #if defined(PIOS_I2C_DIAGNOSTICS)	
@@ -1197,7 +1297,7 @@ void PIOS_I2C_EV_IRQ_Handler(uint32_t i2c_id)
 	}
 
 skip_event:
-	;
+	i2c_adapter_irq_done(i2c_adapter);
 }
 
 
@@ -1208,6 +1308,10 @@ void PIOS_I2C_ER_IRQ_Handler(uint32_t i2c_id)
 	bool valid = PIOS_I2C_validate(i2c_adapter);
 	PIOS_Assert(valid)
 
+	/* A task is stopping or resetting the bus, this interrupt was left pending */
+	if (i2c_adapter->bus_claimed)
+		return;
+
 #if defined(PIOS_I2C_DIAGNOSTICS)
 	uint32_t event = I2C_GetLastEvent(i2c_adapter->cfg->regs);
 
@@ -1228,6 +1332,8 @@ void PIOS_I2C_ER_IRQ_Handler(uint32_t i2c_id)
 		/* Fail hard on any errors for now */
 		i2c_adapter_inject_event(i2c_adapter, I2C_EVENT_BUS_ERROR);
 	}	
+
+	i2c_adapter_irq_done(i2c_adapter);
 }
 
 #endif
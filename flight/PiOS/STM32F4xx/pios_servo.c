@@ -33,16 +33,40 @@
 #include "pios_servo_priv.h"
 #include "pios_tim_priv.h"
 
+/* Private constants */
+#define PIOS_SERVO_MAX_CHANNELS 16
+
+/* Private types */
+struct pios_servo_bank {
+	TIM_TypeDef * timer;
+	enum pios_servo_mode mode;
+	bool pending;			// Positions set since the last PIOS_Servo_Update()
+	uint16_t pulse_max;		// Longest pulse of the batch being output
+	uint16_t pending_max;		// Longest pulse of the pending batch
+};
+
 /* Private Function Prototypes */
+static void PIOS_Servo_SetCompare(const struct pios_tim_channel * chan, uint16_t value);
+static void PIOS_Servo_SetOCMode(const struct pios_tim_channel * chan, uint16_t oc_mode);
 
 static const struct pios_servo_cfg * servo_cfg;
 
+/* Channels on the same timer form a bank, numbered by their first channel */
+static struct pios_servo_bank servo_banks[PIOS_SERVO_MAX_CHANNELS];
+static uint8_t servo_bank_of[PIOS_SERVO_MAX_CHANNELS];
+static uint16_t servo_compare[PIOS_SERVO_MAX_CHANNELS];
+static uint8_t servo_num_banks;
+
 /**
 * Initialise Servos
 */
 int32_t PIOS_Servo_Init(const struct pios_servo_cfg * cfg)
 {
 	uint32_t tim_id;
+	if (cfg->num_channels > PIOS_SERVO_MAX_CHANNELS) {
+		return -1;
+	}
+
 	if (PIOS_TIM_InitChannels(&tim_id, cfg->channels, cfg->num_channels, NULL, 0)) {
 		return -1;
 	}
@@ -50,6 +74,25 @@ int32_t PIOS_Servo_Init(const struct pios_servo_cfg * cfg)
 	/* Store away the requested configuration */
 	servo_cfg = cfg;
 
+	/* Group the channels into banks */
+	servo_num_banks = 0;
+	for (uint8_t i = 0; i < cfg->num_channels; i++) {
+		uint8_t bank;
+		for (bank = 0; bank < servo_num_banks; bank++) {
+			if (servo_banks[bank].timer == cfg->channels[i].timer)
+				break;
+		}
+		if (bank == servo_num_banks) {
+			servo_banks[bank].timer = cfg->channels[i].timer;
+			servo_banks[bank].mode = PIOS_SERVO_MODE_PWM;
+			servo_banks[bank].pending = false;
+			servo_banks[bank].pulse_max = 0;
+			servo_banks[bank].pending_max = 0;
+			servo_num_banks++;
+		}
+		servo_bank_of[i] = bank;
+	}
+
 	/* Configure the channels to be in output compare mode */
 	for (uint8_t i = 0; i < cfg->num_channels; i++) {
 		const struct pios_tim_channel * chan = &cfg->channels[i];
@@ -125,7 +168,62 @@ void PIOS_Servo_SetHz(const uint16_t * speeds, uint8_t banks)
 }
 
 /**
-* Set servo position
+* Set the output mode of the banks
+* \param[in] modes array of modes, one for each bank in the order of PIOS_Servo_SetHz()
+* \param[in] banks maximum number of banks
+*
+* In PIOS_SERVO_MODE_ONESHOT the pulses end together at the end of the
+* bank period, so set the rate of the bank to just cover the longest pulse.
+* Banks on a timer that also captures receiver input stay in
+* PIOS_SERVO_MODE_PWM, as the other modes restart or stop its period.
+*/
+void PIOS_Servo_SetMode(const enum pios_servo_mode * modes, uint8_t banks)
+{
+	if (!servo_cfg) {
+		return;
+	}
+
+	for (uint8_t bank = 0; (bank < servo_num_banks) && (bank < banks); bank++) {
+		struct pios_servo_bank * servo_bank = &servo_banks[bank];
+		TIM_TypeDef * timer = servo_bank->timer;
+
+		enum pios_servo_mode mode = modes[bank];
+		if (mode != PIOS_SERVO_MODE_PWM && PIOS_TIM_HasCallbacks(timer))
+			mode = PIOS_SERVO_MODE_PWM;
+
+		if (mode == servo_bank->mode)
+			continue;
+		servo_bank->mode = mode;
+
+		/* Stop the outputs while switching, the new mode starts with no pulse */
+		TIM_Cmd(timer, DISABLE);
+
+		bool oneshot = servo_bank->mode == PIOS_SERVO_MODE_ONESHOT;
+		uint16_t idle = oneshot ? (timer->ARR + 1) : 0;
+		for (uint8_t i = 0; i < servo_cfg->num_channels; i++) {
+			if (servo_bank_of[i] != bank)
+				continue;
+
+			/* One-shot pulses run from the compare value to the end of the period */
+			PIOS_Servo_SetOCMode(&servo_cfg->channels[i], oneshot ? TIM_OCMode_PWM2 : TIM_OCMode_PWM1);
+			servo_compare[i] = idle;
+			PIOS_Servo_SetCompare(&servo_cfg->channels[i], idle);
+		}
+
+		TIM_SelectOnePulseMode(timer, oneshot ? TIM_OPMode_Single : TIM_OPMode_Repetitive);
+		TIM_GenerateEvent(timer, TIM_EventSource_Update);
+		servo_bank->pending = false;
+		servo_bank->pulse_max = 0;
+		servo_bank->pending_max = 0;
+
+		/* One-shot banks stay stopped until the next PIOS_Servo_Update() */
+		if (!oneshot)
+			TIM_Cmd(timer, ENABLE);
+	}
+}
+
+/**
+* Set servo position, it is output by the next PIOS_Servo_Update()
 * \param[in] Servo Servo number (0-7)
 * \param[in] Position Servo position in microseconds
 */
@@ -136,20 +234,99 @@ void PIOS_Servo_Set(uint8_t servo, uint16_t position)
 		return;
 	}
 
-	/* Update the position */
-	const struct pios_tim_channel * chan = &servo_cfg->channels[servo];
+	/* Hold the position back so all channels of the bank change on the same period */
+	struct pios_servo_bank * bank = &servo_banks[servo_bank_of[servo]];
+	if (!bank->pending) {
+		bank->pending = true;
+		bank->pending_max = 0;
+	}
+	if (position > bank->pending_max)
+		bank->pending_max = position;
+
+	if (bank->mode == PIOS_SERVO_MODE_ONESHOT) {
+		uint16_t period = bank->timer->ARR + 1;
+		position = (position < period) ? (period - position) : 0;
+	}
+
+	servo_compare[servo] = position;
+}
+
+/**
+* Output the positions set since the last call on all banks at once.
+* PWM banks change at the end of their current period, synchronized and
+* one-shot banks start the new pulses now unless the last ones are still
+* being output.
+*/
+void PIOS_Servo_Update(void)
+{
+	if (!servo_cfg) {
+		return;
+	}
+
+	/* Write the compare registers back to back, an update event can then
+	 * only split a bank if it falls within these few cycles */
+	PIOS_IRQ_Disable();
+	for (uint8_t i = 0; i < servo_cfg->num_channels; i++) {
+		if (servo_banks[servo_bank_of[i]].pending)
+			PIOS_Servo_SetCompare(&servo_cfg->channels[i], servo_compare[i]);
+	}
+	PIOS_IRQ_Enable();
+
+	for (uint8_t bank = 0; bank < servo_num_banks; bank++) {
+		struct pios_servo_bank * servo_bank = &servo_banks[bank];
+		TIM_TypeDef * timer = servo_bank->timer;
+
+		if (!servo_bank->pending)
+			continue;
+		servo_bank->pending = false;
+
+		switch (servo_bank->mode) {
+			case PIOS_SERVO_MODE_PWM:
+				break;
+			case PIOS_SERVO_MODE_SYNC:
+				/* Restart the period, but do not cut the current pulses short */
+				if (TIM_GetCounter(timer) >= servo_bank->pulse_max)
+					TIM_GenerateEvent(timer, TIM_EventSource_Update);
+				break;
+			case PIOS_SERVO_MODE_ONESHOT:
+				/* The counter stops at the end of each pulse */
+				if ((timer->CR1 & TIM_CR1_CEN) == 0) {
+					TIM_GenerateEvent(timer, TIM_EventSource_Update);
+					TIM_Cmd(timer, ENABLE);
+				}
+				break;
+		}
+
+		servo_bank->pulse_max = servo_bank->pending_max;
+	}
+}
+
+/**
+* Write the compare register of a channel
+*/
+static void PIOS_Servo_SetCompare(const struct pios_tim_channel * chan, uint16_t value)
+{
 	switch(chan->timer_chan) {
 		case TIM_Channel_1:
-			TIM_SetCompare1(chan->timer, position);
+			TIM_SetCompare1(chan->timer, value);
 			break;
 		case TIM_Channel_2:
-			TIM_SetCompare2(chan->timer, position);
+			TIM_SetCompare2(chan->timer, value);
 			break;
 		case TIM_Channel_3:
-			TIM_SetCompare3(chan->timer, position);
+			TIM_SetCompare3(chan->timer, value);
 			break;
 		case TIM_Channel_4:
-			TIM_SetCompare4(chan->timer, position);
+			TIM_SetCompare4(chan->timer, value);
 			break;
 	}
 }
+
+/**
+* Change the output compare mode of a channel and enable it again
+*/
+static void PIOS_Servo_SetOCMode(const struct pios_tim_channel * chan, uint16_t oc_mode)
+{
+	TIM_SelectOCxM(chan->timer, chan->timer_chan, oc_mode);
+	TIM_CCxCmd(chan->timer, chan->timer_chan, TIM_CCx_Enable);
+}
@@ -196,6 +196,30 @@ out_fail:
 	return(-1);
 }
 
+/**
+ * Check whether a client registered callbacks for a channel of a timer, such
+ * as a receiver capturing on it. The period and update events of such a timer
+ * must be left alone.
+ */
+bool PIOS_TIM_HasCallbacks(const TIM_TypeDef * timer)
+{
+	for (uint8_t i = 0; i < pios_tim_num_devs; i++) {
+		const struct pios_tim_dev * tim_dev = &pios_tim_devs[i];
+
+		if (!tim_dev->callbacks) {
+			continue;
+		}
+
+		for (uint8_t j = 0; j < tim_dev->num_channels; j++) {
+			if (tim_dev->channels[j].timer == timer) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 static void PIOS_TIM_generic_irq_handler(TIM_TypeDef * timer)
 {
 	/* Iterate over all registered clients of the TIM layer to find channels on this timer */
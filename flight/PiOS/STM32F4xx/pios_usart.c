@@ -66,6 +66,13 @@ struct pios_usart_dev {
 	uint32_t rx_in_context;
 	pios_com_callback tx_out_cb;
 	uint32_t tx_out_context;
+
+	/* Only allocated when the board provides the DMA channels */
+	uint8_t * rx_dma_buf;
+	uint16_t rx_dma_pos;
+	uint8_t * tx_dma_buf;
+
+	uint32_t rx_dropped;
 };
 
 static bool PIOS_USART_validate(struct pios_usart_dev * usart_dev)
@@ -85,6 +92,10 @@ static struct pios_usart_dev * PIOS_USART_alloc(void)
 	usart_dev->rx_in_context = 0;
 	usart_dev->tx_out_cb = 0;
 	usart_dev->tx_out_context = 0;
+	usart_dev->rx_dma_buf = NULL;
+	usart_dev->rx_dma_pos = 0;
+	usart_dev->tx_dma_buf = NULL;
+	usart_dev->rx_dropped = 0;
 	usart_dev->magic = PIOS_USART_DEV_MAGIC;
 	return(usart_dev);
 }
@@ -106,6 +117,17 @@ static struct pios_usart_dev * PIOS_USART_alloc(void)
 }
 #endif
 
+#if !defined(PIOS_USART_RX_DMA_SIZE)
+#define PIOS_USART_RX_DMA_SIZE 64
+#endif
+#if !defined(PIOS_USART_TX_DMA_SIZE)
+#define PIOS_USART_TX_DMA_SIZE 64
+#endif
+
+static void PIOS_USART_DMA_Init(struct pios_usart_dev * usart_dev);
+static bool PIOS_USART_DMA_RxDrain(struct pios_usart_dev * usart_dev);
+static bool PIOS_USART_DMA_TxNext(struct pios_usart_dev * usart_dev);
+
 /* Bind Interrupt Handlers
  *
  * Map all valid USART IRQs to the common interrupt handler
@@ -214,8 +236,21 @@ int32_t PIOS_USART_Init(uint32_t * usart_id, const struct pios_usart_cfg * cfg)
 		break;
 	}
 	NVIC_Init((NVIC_InitTypeDef *)&(usart_dev->cfg->irq.init));
-	USART_ITConfig(usart_dev->cfg->regs, USART_IT_RXNE, ENABLE);
-	USART_ITConfig(usart_dev->cfg->regs, USART_IT_TXE,  ENABLE);
+
+	if (usart_dev->cfg->dma) {
+		PIOS_USART_DMA_Init(usart_dev);
+	}
+
+	if (usart_dev->rx_dma_buf) {
+		/* The DMA stores the bytes, the interrupt only marks the end of a frame */
+		USART_ITConfig(usart_dev->cfg->regs, USART_IT_IDLE, ENABLE);
+	} else {
+		USART_ITConfig(usart_dev->cfg->regs, USART_IT_RXNE, ENABLE);
+	}
+	if (!usart_dev->tx_dma_buf) {
+		/* With DMA TC is set out of reset, enabling it in TxStart loads the first block */
+		USART_ITConfig(usart_dev->cfg->regs, USART_IT_TXE,  ENABLE);
+	}
 
 	// FIXME XXX Clear / reset uart here - sends NUL char else
 
@@ -235,6 +270,11 @@ static void PIOS_USART_RxStart(uint32_t usart_id, uint16_t rx_bytes_avail)
 	bool valid = PIOS_USART_validate(usart_dev);
 	PIOS_Assert(valid);
 	
+	if (usart_dev->rx_dma_buf) {
+		/* Circular DMA never stops receiving */
+		return;
+	}
+
 	USART_ITConfig(usart_dev->cfg->regs, USART_IT_RXNE, ENABLE);
 }
 static void PIOS_USART_TxStart(uint32_t usart_id, uint16_t tx_bytes_avail)
@@ -244,6 +284,12 @@ static void PIOS_USART_TxStart(uint32_t usart_id, uint16_t tx_bytes_avail)
 	bool valid = PIOS_USART_validate(usart_dev);
 	PIOS_Assert(valid);
 	
+	if (usart_dev->tx_dma_buf) {
+		/* Fires now if the line is idle, otherwise when the running block completes */
+		USART_ITConfig(usart_dev->cfg->regs, USART_IT_TC, ENABLE);
+		return;
+	}
+
 	USART_ITConfig(usart_dev->cfg->regs, USART_IT_TXE, ENABLE);
 }
 
@@ -308,21 +354,43 @@ static void PIOS_USART_generic_irq_handler(uint32_t usart_id)
 	bool valid = PIOS_USART_validate(usart_dev);
 	PIOS_Assert(valid);
 	
-	/* Force read of dr after sr to make sure to clear error flags */
 	volatile uint16_t sr = usart_dev->cfg->regs->SR;
-	volatile uint8_t dr = usart_dev->cfg->regs->DR;
+
+	bool rx_need_yield = false;
+	bool tx_need_yield = false;
+
+	if (usart_dev->rx_dma_buf) {
+		if (sr & USART_SR_IDLE) {
+			/* SR then DR clears IDLE and the error flags, the byte itself went to memory */
+			(void) usart_dev->cfg->regs->DR;
+			rx_need_yield = PIOS_USART_DMA_RxDrain(usart_dev);
+		}
+		sr &= ~USART_SR_RXNE;
+	}
+	if (usart_dev->tx_dma_buf) {
+		if ((sr & USART_SR_TC) && (usart_dev->cfg->regs->CR1 & USART_CR1_TCIE)) {
+			tx_need_yield = PIOS_USART_DMA_TxNext(usart_dev);
+		}
+		sr &= ~USART_SR_TXE;
+	}
+
+	/* Force read of dr after sr to make sure to clear error flags */
+	volatile uint8_t dr = usart_dev->rx_dma_buf ? 0 : usart_dev->cfg->regs->DR;
 	
 	/* Check if RXNE flag is set */
-	bool rx_need_yield = false;
 	if (sr & USART_SR_RXNE) {
 		uint8_t byte = dr;
 		if (usart_dev->rx_in_cb) {
-			(void) (usart_dev->rx_in_cb)(usart_dev->rx_in_context, &byte, 1, NULL, &rx_need_yield);
+			uint16_t rc;
+			rc = (usart_dev->rx_in_cb)(usart_dev->rx_in_context, &byte, 1, NULL, &rx_need_yield);
+			if (rc < 1) {
+				/* Lost bytes on rx */
+				usart_dev->rx_dropped += 1;
+			}
 		}
 	}
 	
 	/* Check if TXE flag is set */
-	bool tx_need_yield = false;
 	if (sr & USART_SR_TXE) {
 		if (usart_dev->tx_out_cb) {
 			uint8_t b;
@@ -350,6 +418,157 @@ static void PIOS_USART_generic_irq_handler(uint32_t usart_id)
 #endif	/* PIOS_INCLUDE_FREERTOS */
 }
 
+/**
+ * Hook the USART up to its DMA channels. Rx runs circular into a small
+ * buffer and is drained on half/full transfer and on an idle line, tx is
+ * loaded a block at a time from the transmit callback.
+ */
+static void PIOS_USART_DMA_Init(struct pios_usart_dev * usart_dev)
+{
+#if defined(PIOS_INCLUDE_FREERTOS)
+	const struct pios_usart_dma_cfg * dma = usart_dev->cfg->dma;
+	DMA_InitTypeDef dma_init;
+
+	if (dma->rx.channel) {
+		usart_dev->rx_dma_buf = (uint8_t *)pvPortMalloc(PIOS_USART_RX_DMA_SIZE);
+	}
+	if (usart_dev->rx_dma_buf) {
+		usart_dev->rx_dma_pos = 0;
+
+		DMA_DeInit(dma->rx.channel);
+		dma_init = dma->rx.init;
+		dma_init.DMA_Memory0BaseAddr = (uint32_t)usart_dev->rx_dma_buf;
+		dma_init.DMA_BufferSize = PIOS_USART_RX_DMA_SIZE;
+		DMA_Init(dma->rx.channel, &dma_init);
+
+		DMA_ITConfig(dma->rx.channel, DMA_IT_HT | DMA_IT_TC, ENABLE);
+		NVIC_Init((NVIC_InitTypeDef *)&dma->irq.init);
+
+		USART_DMACmd(usart_dev->cfg->regs, USART_DMAReq_Rx, ENABLE);
+		DMA_Cmd(dma->rx.channel, ENABLE);
+	}
+
+	if (dma->tx.channel) {
+		usart_dev->tx_dma_buf = (uint8_t *)pvPortMalloc(PIOS_USART_TX_DMA_SIZE);
+	}
+	if (usart_dev->tx_dma_buf) {
+		DMA_DeInit(dma->tx.channel);
+		dma_init = dma->tx.init;
+		dma_init.DMA_Memory0BaseAddr = (uint32_t)usart_dev->tx_dma_buf;
+		dma_init.DMA_BufferSize = PIOS_USART_TX_DMA_SIZE;
+		DMA_Init(dma->tx.channel, &dma_init);
+
+		USART_DMACmd(usart_dev->cfg->regs, USART_DMAReq_Tx, ENABLE);
+	}
+#endif	/* PIOS_INCLUDE_FREERTOS */
+}
+
+/**
+ * Pass everything the rx DMA has written since the last call up to the
+ * receive callback, in at most two runs when the buffer has wrapped.
+ */
+static bool PIOS_USART_DMA_RxDrain(struct pios_usart_dev * usart_dev)
+{
+	bool need_yield = false;
+
+	uint16_t head = PIOS_USART_RX_DMA_SIZE - DMA_GetCurrDataCounter(usart_dev->cfg->dma->rx.channel);
+	if (head >= PIOS_USART_RX_DMA_SIZE) {
+		head = 0;
+	}
+
+	while (usart_dev->rx_dma_pos != head) {
+		uint16_t end = (head > usart_dev->rx_dma_pos) ? head : PIOS_USART_RX_DMA_SIZE;
+		uint16_t len = end - usart_dev->rx_dma_pos;
+
+		if (usart_dev->rx_in_cb) {
+			uint16_t rc = (usart_dev->rx_in_cb)(usart_dev->rx_in_context, &usart_dev->rx_dma_buf[usart_dev->rx_dma_pos], len, NULL, &need_yield);
+			if (rc < len) {
+				usart_dev->rx_dropped += len - rc;
+			}
+		}
+		usart_dev->rx_dma_pos = (end == PIOS_USART_RX_DMA_SIZE) ? 0 : end;
+	}
+
+	return need_yield;
+}
+
+/**
+ * Called on transmission complete, start the next block or stop once the
+ * transmit callback has nothing left.
+ */
+static bool PIOS_USART_DMA_TxNext(struct pios_usart_dev * usart_dev)
+{
+	const struct pios_usart_dma_cfg * dma = usart_dev->cfg->dma;
+	bool need_yield = false;
+	uint16_t bytes_to_send = 0;
+
+	DMA_Cmd(dma->tx.channel, DISABLE);
+
+	if (usart_dev->tx_out_cb) {
+		bytes_to_send = (usart_dev->tx_out_cb)(usart_dev->tx_out_context, usart_dev->tx_dma_buf, PIOS_USART_TX_DMA_SIZE, NULL, &need_yield);
+	}
+
+	if (bytes_to_send == 0) {
+		/* Nothing left, the next PIOS_USART_TxStart() picks up from here */
+		USART_ITConfig(usart_dev->cfg->regs, USART_IT_TC, DISABLE);
+		return need_yield;
+	}
+
+	DMA_ClearFlag(dma->tx.channel, dma->tx_flags);
+	DMA_SetCurrDataCounter(dma->tx.channel, bytes_to_send);
+	USART_ClearFlag(usart_dev->cfg->regs, USART_FLAG_TC);
+	DMA_Cmd(dma->tx.channel, ENABLE);
+
+	return need_yield;
+}
+
+/**
+ * Rx DMA half/full transfer interrupt, called by the board from the DMA
+ * channel vector with the same cfg it passed to PIOS_USART_Init()
+ */
+void PIOS_USART_DMA_IRQ_Handler(const struct pios_usart_cfg * cfg)
+{
+	struct pios_usart_dev * usart_dev = NULL;
+
+	DMA_ClearFlag(cfg->dma->rx.channel, cfg->dma->irq.flags);
+
+	switch ((uint32_t)cfg->regs) {
+	case (uint32_t)USART1:
+		usart_dev = (struct pios_usart_dev *)PIOS_USART_1_id;
+		break;
+	case (uint32_t)USART2:
+		usart_dev = (struct pios_usart_dev *)PIOS_USART_2_id;
+		break;
+	case (uint32_t)USART3:
+		usart_dev = (struct pios_usart_dev *)PIOS_USART_3_id;
+		break;
+	case (uint32_t)UART4:
+		usart_dev = (struct pios_usart_dev *)PIOS_USART_4_id;
+		break;
+	case (uint32_t)UART5:
+		usart_dev = (struct pios_usart_dev *)PIOS_USART_5_id;
+		break;
+	case (uint32_t)USART6:
+		usart_dev = (struct pios_usart_dev *)PIOS_USART_6_id;
+		break;
+	}
+
+	if (!usart_dev || !usart_dev->rx_dma_buf) {
+		return;
+	}
+
+	bool valid = PIOS_USART_validate(usart_dev);
+	PIOS_Assert(valid);
+
+	bool need_yield = PIOS_USART_DMA_RxDrain(usart_dev);
+
+#if defined(PIOS_INCLUDE_FREERTOS)
+	if (need_yield) {
+		vPortYieldFromISR();
+	}
+#endif	/* PIOS_INCLUDE_FREERTOS */
+}
+
 #endif
 
 /**
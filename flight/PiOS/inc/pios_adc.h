@@ -39,6 +39,7 @@ typedef void (*ADCCallback) (float * data);
 /* Public Functions */
 void PIOS_ADC_Config(uint32_t oversampling);
 int32_t PIOS_ADC_PinGet(uint32_t pin);
+float PIOS_ADC_PinGetAverage(uint32_t pin);
 int16_t * PIOS_ADC_GetRawBuffer(void);
 uint8_t PIOS_ADC_GetOverSampling(void);
 void PIOS_ADC_SetCallback(ADCCallback new_function);
@@ -37,10 +37,16 @@ extern uint8_t PIOS_BL_HELPER_FLASH_Ini();
 
 extern uint32_t PIOS_BL_HELPER_CRC_Memory_Calc();
 
+extern uint32_t PIOS_BL_HELPER_CRC_Block_Calc(uint32_t start, uint32_t size);
+
 extern void PIOS_BL_HELPER_FLASH_Read_Description(uint8_t * array, uint8_t size);
 
 extern uint8_t PIOS_BL_HELPER_FLASH_Start();
 
+extern uint8_t PIOS_BL_HELPER_FLASH_GetBlock(uint32_t block, uint32_t *start, uint32_t *size);
+
+extern uint8_t PIOS_BL_HELPER_FLASH_EraseBlock(uint32_t block);
+
 extern void PIOS_BL_HELPER_CRC_Ini();
 
 #endif /* PIOS_BL_HELPER_H_ */
@@ -83,6 +83,7 @@ enum bma180_bandwidth { BMA_BW_10HZ = 0x00,
 #define BMA_NEW_DAT_INT   0x02
 
 struct pios_bma180_data {
+	uint32_t time;		/* PIOS_DELAY_GetRaw() at the data ready interrupt */
 	int16_t x;
 	int16_t y;
 	int16_t z;
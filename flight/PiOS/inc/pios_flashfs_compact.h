@@ -46,6 +46,7 @@ struct flashfs_compact_cfg {
 
 int32_t PIOS_FLASHFS_Compact_Init(const struct flashfs_compact_cfg * cfg);
 int32_t PIOS_FLASHFS_Compact_Format();
+int32_t PIOS_FLASHFS_Compact_GarbageCollect();
 int32_t PIOS_FLASHFS_Compact_ObjSave(UAVObjHandle obj, uint16_t instId, uint8_t * data);
 int32_t PIOS_FLASHFS_Compact_ObjLoad(UAVObjHandle obj, uint16_t instId, uint8_t * data);
 int32_t PIOS_FLASHFS_Compact_ObjDelete(UAVObjHandle obj, uint16_t instId);
@@ -0,0 +1,47 @@
+/**
+ ******************************************************************************
+ *
+ * @addtogroup PIOS PIOS Core hardware abstraction layer
+ * @{
+ * @addtogroup PIOS_FLASHFS_LOGFS Log structured flash filesystem
+ * @{
+ *
+ * @file       pios_flashfs_logfs.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      A log structured file system for storing UAVObject in flash chip
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/* 
+ * This program is free software; you can redistribute it and/or modify 
+ * it under the terms of the GNU General Public License as published by 
+ * the Free Software Foundation; either version 3 of the License, or 
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License 
+ * for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along 
+ * with this program; if not, write to the Free Software Foundation, Inc., 
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "openpilot.h"
+#include "uavobjectmanager.h"
+
+struct flashfs_logfs_cfg {
+	uint32_t fs_magic;
+	uint32_t arena_start;	/* First sector of the log */
+	uint32_t arena_size;	/* Size of the log, a multiple of sector_size */
+	uint32_t sector_size;
+	uint32_t legacy_magic;	/* Table magic of the pios_flashfs_objlist file system replaced, 0 if none */
+};
+
+int32_t PIOS_FLASHFS_Init(const struct flashfs_logfs_cfg * cfg);
+int32_t PIOS_FLASHFS_Format();
+int32_t PIOS_FLASHFS_ObjSave(UAVObjHandle obj, uint16_t instId, uint8_t * data);
+int32_t PIOS_FLASHFS_ObjLoad(UAVObjHandle obj, uint16_t instId, uint8_t * data);
+int32_t PIOS_FLASHFS_ObjDelete(UAVObjHandle obj, uint16_t instId);
+int32_t PIOS_FLASHFS_GarbageCollect();
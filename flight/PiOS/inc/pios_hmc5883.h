@@ -105,6 +105,8 @@ struct pios_hmc5883_cfg {
 extern void PIOS_HMC5883_Init(const struct pios_hmc5883_cfg * cfg);
 extern bool PIOS_HMC5883_NewDataAvailable(void);
 extern int32_t PIOS_HMC5883_ReadMag(int16_t out[3]);
+extern int32_t PIOS_HMC5883_StartReadMag(void);
+extern int32_t PIOS_HMC5883_FinishReadMag(int16_t out[3]);
 extern uint8_t PIOS_HMC5883_ReadID(uint8_t out[4]);
 extern int32_t PIOS_HMC5883_Test(void);
 bool void PIOS_HMC5883_IRQHandler();
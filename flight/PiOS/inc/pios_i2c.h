@@ -56,6 +56,25 @@ struct pios_i2c_txn {
 	uint8_t *buf;
 };
 
+#define PIOS_I2C_PENDING 1
+
+/*
+ * A list of transactions queued with PIOS_I2C_Queue(). The request, the
+ * transactions and their buffers must stay valid until it completes.
+ * result is PIOS_I2C_PENDING until then and afterwards holds what
+ * PIOS_I2C_Transfer() would have returned. The callback (may be NULL) runs
+ * from the I2C interrupt or with interrupts disabled and must not block or
+ * queue further requests.
+ */
+struct pios_i2c_request {
+	const struct pios_i2c_txn *txn_list;
+	uint32_t num_txns;
+	void (*callback)(struct pios_i2c_request *request);
+	void *context;
+	volatile int32_t result;
+	struct pios_i2c_request *next;	/* private to the driver */
+};
+
 #define I2C_LOG_DEPTH 20
 enum pios_i2c_error_type {
 	PIOS_I2C_ERROR_EVENT, 
@@ -73,7 +92,9 @@ struct pios_i2c_fault_history {
 
 /* Public Functions */
 extern int32_t PIOS_I2C_Transfer(uint32_t i2c_id, const struct pios_i2c_txn txn_list[], uint32_t num_txns);
-extern int32_t PIOS_I2C_Transfer_Callback(uint32_t i2c_id, const struct pios_i2c_txn txn_list[], uint32_t num_txns, void *callback);
+extern int32_t PIOS_I2C_Queue(uint32_t i2c_id, struct pios_i2c_request *request);
+extern void PIOS_I2C_Poll(uint32_t i2c_id);
+extern void PIOS_I2C_Cancel(uint32_t i2c_id, struct pios_i2c_request *request);
 extern void PIOS_I2C_EV_IRQ_Handler(uint32_t i2c_id);
 extern void PIOS_I2C_ER_IRQ_Handler(uint32_t i2c_id);
 extern void PIOS_I2C_GetDiagnostics(struct pios_i2c_fault_history * data, uint8_t * error_counts);
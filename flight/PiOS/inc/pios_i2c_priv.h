@@ -86,10 +86,8 @@ struct pios_i2c_adapter {
 	enum pios_i2c_adapter_magic         magic;
 	const struct pios_i2c_adapter_cfg * cfg;
 #ifdef PIOS_INCLUDE_FREERTOS
-	xSemaphoreHandle sem_busy;
-	xSemaphoreHandle sem_ready;
-#else
-	uint8_t busy;
+	xSemaphoreHandle sem_busy;	/* held by the blocking transfer in progress */
+	xSemaphoreHandle sem_ready;	/* given when it completes */
 #endif
 
 	bool bus_error;
@@ -100,8 +98,13 @@ struct pios_i2c_adapter {
 	const struct pios_i2c_txn *active_txn;
 	const struct pios_i2c_txn *last_txn;
 
-	void (*callback) ();
-	
+	/* Queued requests, the first one is on the bus while request_on_bus is set */
+	struct pios_i2c_request *active_request;
+	struct pios_i2c_request *last_request;
+	bool request_on_bus;
+	volatile bool bus_claimed;	/* a task is stopping or resetting the bus */
+	bool reset_needed;		/* set by the FSM on errors, the bus is reset in task context */
+
 	uint8_t *active_byte;
 	uint8_t *last_byte;
 };
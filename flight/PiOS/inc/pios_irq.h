@@ -31,8 +31,43 @@
 #ifndef PIOS_IRQ_H
 #define PIOS_IRQ_H
 
+/* Global Types */
+
+/* Groups of interrupt handlers the IRQ profiler accumulates into.
+ * Keep in the order of the IRQ fields of the CPUProfile object. */
+enum pios_irq_class {
+	PIOS_IRQ_CLASS_TIM,
+	PIOS_IRQ_CLASS_USART,
+	PIOS_IRQ_CLASS_EXTI,
+	PIOS_IRQ_CLASS_USB,
+	PIOS_IRQ_CLASS_DMA,
+	PIOS_IRQ_CLASS_I2C,
+	PIOS_IRQ_CLASS_RTC,
+	PIOS_IRQ_CLASS_NUMELEM
+};
+
+struct pios_irq_profile {
+	uint32_t cycles;	/* Cumulative, excluding nested handlers */
+	uint32_t count;		/* Cumulative number of calls */
+	uint32_t max_cycles;	/* Longest call since the last PIOS_IRQ_ProfileGet() */
+};
+
 /* Public Functions */
 extern int32_t PIOS_IRQ_Disable(void);
 extern int32_t PIOS_IRQ_Enable(void);
 
+#if defined(DIAG_PROFILE)
+extern void PIOS_IRQ_ProfileEnter(void);
+extern void PIOS_IRQ_ProfileExit(enum pios_irq_class irq_class);
+extern uint32_t PIOS_IRQ_ProfileTotal(void);
+extern void PIOS_IRQ_ProfileGet(enum pios_irq_class irq_class, struct pios_irq_profile * profile);
+
+/* Bracket the body of an interrupt handler with these to profile it */
+#define PIOS_IRQ_Prologue() PIOS_IRQ_ProfileEnter()
+#define PIOS_IRQ_Epilogue(irq_class) PIOS_IRQ_ProfileExit(irq_class)
+#else
+#define PIOS_IRQ_Prologue()
+#define PIOS_IRQ_Epilogue(irq_class)
+#endif
+
 #endif /* PIOS_IRQ_H */
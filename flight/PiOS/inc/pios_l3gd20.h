@@ -121,6 +121,7 @@ enum pios_l3gd20_filter {
 };
 
 struct pios_l3gd20_data {
+	uint32_t time;		/* PIOS_DELAY_GetRaw() at the data ready interrupt */
 	int16_t gyro_x;
 	int16_t gyro_y;
 	int16_t gyro_z;
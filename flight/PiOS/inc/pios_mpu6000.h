@@ -122,7 +122,18 @@ enum pios_mpu6000_accel_range {
 	PIOS_MPU6000_ACCEL_16G = 0x18
 };
 
+/* Most samples drained from the FIFO in one burst read */
+#define PIOS_MPU6000_MAX_BURST 8
+
+/* Bytes per sample in the FIFO */
+#if defined(PIOS_MPU6000_ACCEL)
+#define PIOS_MPU6000_SAMPLE_SIZE 14
+#else
+#define PIOS_MPU6000_SAMPLE_SIZE 8
+#endif
+
 struct pios_mpu6000_data {
+	uint32_t time;		/* PIOS_DELAY_GetRaw() at the interrupt that started the read */
 	int16_t gyro_x;
 	int16_t gyro_y;
 	int16_t gyro_z;
@@ -41,11 +41,20 @@ struct pios_rfm22b_cfg {
 	uint8_t maxTxPower;
 };
 
+struct pios_rfm22b_stats {
+	uint32_t tx_packets;	// packets sent
+	uint32_t rx_packets;	// valid packets received
+	uint32_t tx_time_us;	// last packet sent, transmitter on to packet sent
+	uint32_t rx_time_us;	// last packet received, sync word to packet valid
+	uint32_t irq_time_us;	// longest nIRQ service time since the last PIOS_RFM22B_GetStats()
+};
+
 /* Public Functions */
 extern int32_t PIOS_RFM22B_Init(uint32_t *rfb22b_id, const struct pios_rfm22b_cfg *cfg);
 extern uint32_t PIOS_RFM22B_DeviceID(uint32_t rfb22b_id);
 extern int8_t PIOS_RFM22B_RSSI(uint32_t rfm22b_id);
 extern int16_t PIOS_RFM22B_Resets(uint32_t rfm22b_id);
+extern void PIOS_RFM22B_GetStats(uint32_t rfm22b_id, struct pios_rfm22b_stats *stats);
 
 #endif /* PIOS_RFM22B_H */
 
@@ -99,6 +99,7 @@ extern int32_t PIOS_SDCARD_CheckAvailable(uint8_t was_available);
 extern int32_t PIOS_SDCARD_SendSDCCmd(uint8_t cmd, uint32_t addr, uint8_t crc);
 extern int32_t PIOS_SDCARD_SectorRead(uint32_t sector, uint8_t * buffer);
 extern int32_t PIOS_SDCARD_SectorWrite(uint32_t sector, uint8_t * buffer);
+extern int32_t PIOS_SDCARD_SectorWriteMulti(uint32_t sector, uint8_t * buffer, uint32_t count);
 extern int32_t PIOS_SDCARD_CIDRead(SDCARDCidTypeDef * cid);
 extern int32_t PIOS_SDCARD_CSDRead(SDCARDCsdTypeDef * csd);
 
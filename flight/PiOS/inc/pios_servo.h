@@ -30,9 +30,18 @@
 #ifndef PIOS_SERVO_H
 #define PIOS_SERVO_H
 
+/* Global types */
+enum pios_servo_mode {
+	PIOS_SERVO_MODE_PWM,		/* Free running, new positions start with the next period */
+	PIOS_SERVO_MODE_SYNC,		/* Free running, each update restarts the period */
+	PIOS_SERVO_MODE_ONESHOT,	/* One pulse for each update */
+};
+
 /* Public Functions */
 extern void PIOS_Servo_SetHz(const uint16_t * update_rates, uint8_t banks);
+extern void PIOS_Servo_SetMode(const enum pios_servo_mode * modes, uint8_t banks);
 extern void PIOS_Servo_Set(uint8_t Servo, uint16_t Position);
+extern void PIOS_Servo_Update(void);
 
 #endif /* PIOS_SERVO_H */
 
@@ -24,5 +24,6 @@ struct pios_tim_callbacks {
 
 extern int32_t PIOS_TIM_InitClock(const struct pios_tim_clock_cfg * cfg);
 extern int32_t PIOS_TIM_InitChannels(uint32_t * tim_id, const struct pios_tim_channel * channels, uint8_t num_channels, const struct pios_tim_callbacks * callbacks, uint32_t context);
+extern bool PIOS_TIM_HasCallbacks(const TIM_TypeDef * timer);
 
 #endif	/* PIOS_TIM_PRIV_H */
@@ -38,6 +38,20 @@
 
 extern const struct pios_com_driver pios_usart_com_driver;
 
+/*
+ * Receive runs the rx channel in circular mode and is drained on the half and
+ * full transfer interrupts and on the USART idle line interrupt, transmit sends
+ * whole blocks and loads the next one on the USART transmission complete
+ * interrupt. A direction with a NULL channel stays on the interrupt per byte.
+ */
+struct pios_usart_dma_cfg {
+	uint32_t ahb_clk;	/* unused on STM32F4XX, PIOS_SYS enables both DMA clocks */
+	struct stm32_irq irq;	/* rx channel, same priority as the USART irq */
+	struct stm32_dma_chan rx;
+	struct stm32_dma_chan tx;
+	uint32_t tx_flags;	/* tx channel flags, cleared before every block */
+};
+
 struct pios_usart_cfg {
 	USART_TypeDef *regs;
 	uint32_t remap;		/* GPIO_Remap_* */
@@ -45,10 +59,12 @@ struct pios_usart_cfg {
 	struct stm32_gpio rx;
 	struct stm32_gpio tx;
 	struct stm32_irq irq;
+	const struct pios_usart_dma_cfg * dma;	/* NULL for an interrupt per byte */
 };
 
 extern int32_t PIOS_USART_Init(uint32_t * usart_id, const struct pios_usart_cfg * cfg);
 extern const struct pios_usart_cfg * PIOS_USART_GetConfig(uint32_t usart_id);
+extern void PIOS_USART_DMA_IRQ_Handler(const struct pios_usart_cfg * cfg);
 
 #endif /* PIOS_USART_PRIV_H */
 
@@ -142,8 +142,12 @@
 
 #if defined(PIOS_INCLUDE_FLASH)
 #include <pios_flash_jedec.h>
+#if defined(PIOS_INCLUDE_FLASH_LOGFS_SETTINGS)
+#include <pios_flashfs_logfs.h>
+#else
 #include <pios_flashfs_objlist.h>
 #endif
+#endif
 
 #if defined(PIOS_INCLUDE_FLASH_INTERNAL)
 #include <pios_flash_internal.h>
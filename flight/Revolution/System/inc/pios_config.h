@@ -85,8 +85,8 @@
 
 #define PIOS_INCLUDE_SETTINGS
 #define PIOS_INCLUDE_FLASH
-/* A really shitty setting saving implementation */
-#define PIOS_INCLUDE_FLASH_SECTOR_SETTINGS
+/* Settings appended to a log in the flash chip */
+#define PIOS_INCLUDE_FLASH_LOGFS_SETTINGS
 
 /* Other Interfaces */
 //#define PIOS_INCLUDE_I2C_ESC
@@ -95,10 +95,14 @@
 #define PIOS_INCLUDE_INITCALL           /* Include init call structures */
 #define PIOS_TELEM_PRIORITY_QUEUE       /* Enable a priority queue in telemetry */
 #define PIOS_QUATERNION_STABILIZATION   /* Stabilization options */
+//#define PIOS_FASTLOOP                 /* Run attitude, stabilization and actuator in the sensor task for every gyro sample */
 #define PIOS_GPS_SETS_HOMELOCATION      /* GPS options */
 #define PIOS_INCLUDE_GPS_NMEA_PARSER /* Include the NMEA protocol parser */
 #define PIOS_INCLUDE_GPS_UBX_PARSER  /* Include the UBX protocol parser */
 
+// Periodic events scheduled at once, the dispatcher allocates room for them at start
+#define PIOS_EVENTDISPATCHER_MAX_PERIODIC 96
+
 /* Alarm Thresholds */
 #define HEAP_LIMIT_WARNING		4000
 #define HEAP_LIMIT_CRITICAL		1000
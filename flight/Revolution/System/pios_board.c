@@ -228,13 +228,12 @@ static const struct pios_l3gd20_cfg pios_l3gd20_cfg = {
 #endif /* PIOS_INCLUDE_L3GD20 */
 
 
-static const struct flashfs_cfg flashfs_m25p_cfg = {
-	.table_magic = 0x85FB3D35,
-	.obj_magic = 0x3015A371,
-	.obj_table_start = 0x00000010,
-	.obj_table_end = 0x00010000,
+static const struct flashfs_logfs_cfg flashfs_m25p_cfg = {
+	.fs_magic = 0x99ABCEEF,
+	.arena_start = 0x00000000,
+	.arena_size = 0x00100000,	/* 16 sectors of the chip */
 	.sector_size = 0x00010000,
-	.chip_size = 0x00200000,
+	.legacy_magic = 0x85FB3D35,	/* Table magic of the objlist settings before */
 };
 
 static const struct pios_flash_jedec_cfg flash_m25p_cfg = {
@@ -251,7 +250,8 @@ uint32_t pios_rcvr_group_map[MANUALCONTROLSETTINGS_CHANNELGROUPS_NONE];
 #define PIOS_COM_TELEM_RF_RX_BUF_LEN 512
 #define PIOS_COM_TELEM_RF_TX_BUF_LEN 512
 
-#define PIOS_COM_GPS_RX_BUF_LEN 32
+#define PIOS_COM_GPS_RX_BUF_LEN 128
+#define PIOS_COM_GPS_TX_BUF_LEN 32
 
 #define PIOS_COM_TELEM_USB_RX_BUF_LEN 65
 #define PIOS_COM_TELEM_USB_TX_BUF_LEN 65
@@ -357,7 +357,7 @@ void PIOS_Board_Init(void) {
 #else
 	PIOS_Flash_Jedec_Init(pios_spi_accel_id, 1, &flash_m25p_cfg);
 #endif
-	PIOS_FLASHFS_Init(&flashfs_m25p_cfg);
+	int32_t flashfs_status = PIOS_FLASHFS_Init(&flashfs_m25p_cfg);
 	
 #if defined(PIOS_OVERO_SPI)
 	/* Set up the SPI interface to the gyro */
@@ -396,7 +396,12 @@ void PIOS_Board_Init(void) {
 	uint16_t boot_count = PIOS_IAP_ReadBootCount();
 	if (boot_count < 3) {
 		PIOS_IAP_WriteBootCount(++boot_count);
-		AlarmsClear(SYSTEMALARMS_ALARM_BOOTFAULT);
+		if (flashfs_status == 1) {
+			/* Settings saved by older firmware were erased, flag it until the next boot */
+			AlarmsSet(SYSTEMALARMS_ALARM_BOOTFAULT, SYSTEMALARMS_ALARM_WARNING);
+		} else {
+			AlarmsClear(SYSTEMALARMS_ALARM_BOOTFAULT);
+		}
 	} else {
 		/* Too many failed boot attempts, force hwsettings to defaults */
 		HwSettingsSetDefaults(HwSettingsHandle(), 0);
@@ -543,7 +548,7 @@ void PIOS_Board_Init(void) {
 			break;
 			
 		case HWSETTINGS_RV_GPSPORT_GPS:
-			PIOS_Board_configure_com(&pios_usart_gps_cfg, PIOS_COM_GPS_RX_BUF_LEN, -1,  &pios_usart_com_driver, &pios_com_gps_id);
+			PIOS_Board_configure_com(&pios_usart_gps_cfg, PIOS_COM_GPS_RX_BUF_LEN, PIOS_COM_GPS_TX_BUF_LEN,  &pios_usart_com_driver, &pios_com_gps_id);
 			break;
 		
 		case HWSETTINGS_RV_GPSPORT_COMAUX:
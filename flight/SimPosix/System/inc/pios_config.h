@@ -99,6 +99,9 @@
 #define PIOS_QUATERNION_STABILIZATION   /* Stabilization options */
 //#define PIOS_GPS_SETS_HOMELOCATION      /* GPS options */
 
+// Periodic events scheduled at once, the dispatcher allocates room for them at start
+#define PIOS_EVENTDISPATCHER_MAX_PERIODIC 96
+
 /* Alarm Thresholds */
 #define HEAP_LIMIT_WARNING		4000
 #define HEAP_LIMIT_CRITICAL		1000
@@ -36,6 +36,7 @@
 #include "openpilot.h"
 #include "uavobjectsinit.h"
 #include "systemmod.h"
+#include <pthread.h>
 
 /* Task Priorities */
 #define PRIORITY_TASK_HOOKS             (tskIDLE_PRIORITY + 3)
@@ -74,6 +75,7 @@ static xTaskHandle initTaskHandle;
 
 /* Function Prototypes */
 static void initTask(void *parameters);
+static void *lockstepThread(void *parameters);
 
 /* Prototype of generated InitModules() function */
 extern void InitModules(void);
@@ -86,10 +88,30 @@ extern void InitModules(void);
 * Start FreeRTOS Scheduler (vTaskStartScheduler)<BR>
 * If something goes wrong, blink LED1 and LED2 every 100ms
 *
+* Options:
+*   -f  run on a simulated clock as fast as the CPU allows
+*   -l  run on a simulated clock in lockstep, stdin grants ticks (see lockstepThread)
+*
 */
-int main()
+int main(int argc, char *argv[])
 {
 	int	result;
+	int	opt;
+	pthread_t lockstep;
+
+	while ((opt = getopt(argc, argv, "fl")) != -1) {
+		switch (opt) {
+		case 'f':
+			vPortSetTimeMode(portTIME_FAST);
+			break;
+		case 'l':
+			vPortSetTimeMode(portTIME_LOCKSTEP);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-f | -l]\n", argv[0]);
+			return 1;
+		}
+	}
 
 	/* NOTE: Do NOT modify the following start-up sequence */
 	/* Any new initialization functions should be added in OpenPilotInit() */
@@ -103,6 +125,11 @@ int main()
 						 INIT_TASK_STACK, NULL, INIT_TASK_PRIORITY,
 						 &initTaskHandle);
 	PIOS_Assert(result == pdPASS);
+
+	if (xPortGetTimeMode() == portTIME_LOCKSTEP) {
+		result = pthread_create(&lockstep, NULL, lockstepThread, NULL);
+		PIOS_Assert(result == 0);
+	}
 	
 	/* Start the FreeRTOS scheduler */
 	vTaskStartScheduler();
@@ -135,6 +162,27 @@ initTask(void *parameters)
 	vTaskDelete(NULL);
 }
 
+/**
+ * Lockstep driver.
+ *
+ * Reads a number of ticks per line from stdin, lets the firmware run for
+ * them and answers with the simulated time in microseconds once it went idle.
+ * An empty line or 0 only reports the time. Exits the simulation on EOF.
+ */
+static void *lockstepThread(void *parameters)
+{
+	char line[32];
+
+	while (fgets(line, sizeof(line), stdin) != NULL) {
+		unsigned long ticks = strtoul(line, NULL, 10);
+		printf("%llu\n", ullPortStepTicks(ticks));
+		fflush(stdout);
+	}
+
+	exit(0);
+	return NULL;
+}
+
 /**
  * @}
  * @}
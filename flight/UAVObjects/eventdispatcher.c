@@ -33,6 +33,26 @@
 #define MAX_QUEUE_SIZE 20
 #endif
 
+#if defined(PIOS_EVENTDISPATCHER_HIGH_QUEUE)
+#define MAX_HIGH_QUEUE_SIZE PIOS_EVENTDISPATCHER_HIGH_QUEUE
+#else
+#define MAX_HIGH_QUEUE_SIZE 8
+#endif
+
+#if defined(PIOS_EVENTDISPATCHER_LOW_QUEUE)
+#define MAX_LOW_QUEUE_SIZE PIOS_EVENTDISPATCHER_LOW_QUEUE
+#else
+#define MAX_LOW_QUEUE_SIZE 10
+#endif
+
+// Most periodic events that can be scheduled at once. The heap is allocated at
+// this size once, growing it would leak the old storage with heap_1.
+#if defined(PIOS_EVENTDISPATCHER_MAX_PERIODIC)
+#define MAX_PERIODIC_EVENTS PIOS_EVENTDISPATCHER_MAX_PERIODIC
+#else
+#define MAX_PERIODIC_EVENTS 128
+#endif
+
 #if defined(PIOS_EVENTDISPATCHER_STACK_SIZE)
 #define STACK_SIZE PIOS_EVENTDISPATCHER_STACK_SIZE
 #else
@@ -61,23 +81,33 @@ struct PeriodicObjectListStruct {
 	EventCallbackInfo evInfo; /** Event callback information */
     uint16_t updatePeriodMs; /** Update period in ms or 0 if no periodic updates are needed */
     int32_t timeToNextUpdateMs; /** Time delay to the next update */
+    int16_t heapIndex; /** Position in the deadline heap or -1 if not scheduled */
     struct PeriodicObjectListStruct* next; /** Needed by linked list library (utlist.h) */
 };
 typedef struct PeriodicObjectListStruct PeriodicObjectList;
 
 // Private variables
 static PeriodicObjectList* objList;
-static xQueueHandle queue;
+static PeriodicObjectList** heap; /** Scheduled entries, binary min-heap on timeToNextUpdateMs */
+static int16_t heapSize;
+static xQueueHandle lanes[EVENT_PRIORITY_NUM]; /** Callback queues, served in order of priority */
+static xSemaphoreHandle wakeup; /** Given whenever a callback is queued in any lane */
 static xTaskHandle eventTaskHandle;
 static xSemaphoreHandle mutex;
 static EventStats stats;
 
 // Private functions
 static int32_t processPeriodicUpdates();
+static void invokeCallback(EventCallbackInfo* evInfo);
 static void eventTask();
 static int32_t eventPeriodicCreate(UAVObjEvent* ev, UAVObjEventCallback cb, xQueueHandle queue, uint16_t periodMs);
 static int32_t eventPeriodicUpdate(UAVObjEvent* ev, UAVObjEventCallback cb, xQueueHandle queue, uint16_t periodMs);
 static uint16_t randomizePeriod(uint16_t periodMs);
+static void heapSiftUp(int16_t index);
+static void heapSiftDown(int16_t index);
+static int32_t heapInsert(PeriodicObjectList* objEntry);
+static void heapRemove(PeriodicObjectList* objEntry);
+static void heapReschedule(PeriodicObjectList* objEntry);
 
 
 /**
@@ -88,15 +118,26 @@ int32_t EventDispatcherInitialize()
 {
 	// Initialize variables
 	objList = NULL;
+	heapSize = 0;
 	memset(&stats, 0, sizeof(EventStats));
 
+	// Allocate the heap at its largest size
+	heap = (PeriodicObjectList**)pvPortMalloc(MAX_PERIODIC_EVENTS * sizeof(PeriodicObjectList*));
+	if (heap == NULL)
+		return -1;
+
 	// Create mutex
 	mutex = xSemaphoreCreateRecursiveMutex();
 	if (mutex == NULL)
 		return -1;
 
-	// Create event queue
-	queue = xQueueCreate(MAX_QUEUE_SIZE, sizeof(EventCallbackInfo));
+	// Create event queues
+	lanes[EVENT_PRIORITY_HIGH] = xQueueCreate(MAX_HIGH_QUEUE_SIZE, sizeof(EventCallbackInfo));
+	lanes[EVENT_PRIORITY_NORMAL] = xQueueCreate(MAX_QUEUE_SIZE, sizeof(EventCallbackInfo));
+	lanes[EVENT_PRIORITY_LOW] = xQueueCreate(MAX_LOW_QUEUE_SIZE, sizeof(EventCallbackInfo));
+	vSemaphoreCreateBinary(wakeup);
+	if (wakeup == NULL)
+		return -1;
 
 	// Create task
 	xTaskCreate( eventTask, (signed char*)"Event", STACK_SIZE, NULL, TASK_PRIORITY, &eventTaskHandle );
@@ -117,12 +158,15 @@ void EventGetStats(EventStats* statsOut)
 }
 
 /**
- * Clear the statistics counters
+ * Clear the statistics counters, the periodic overflows stay set as the
+ * refused events are never scheduled
  */
 void EventClearStats()
 {
 	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	uint32_t periodicOverflows = stats.periodicOverflows;
 	memset(&stats, 0, sizeof(EventStats));
+	stats.periodicOverflows = periodicOverflows;
 	xSemaphoreGiveRecursive(mutex);
 }
 
@@ -134,14 +178,33 @@ void EventClearStats()
  * \return Success (0), failure (-1)
  */
 int32_t EventCallbackDispatch(UAVObjEvent* ev, UAVObjEventCallback cb)
+{
+	return EventCallbackDispatchPriority(ev, cb, EVENT_PRIORITY_NORMAL);
+}
+
+/**
+ * Dispatch an event by invoking the supplied callback from the lane of the given priority.
+ * Queued callbacks of a higher priority lane are always invoked first, so slow callbacks
+ * of lower lanes delay them by at most the one callback already running.
+ * \param[in] ev The event to be dispatched
+ * \param[in] cb The callback function
+ * \param[in] priority The lane, one of EventPriority
+ * \return Success (0), failure (-1)
+ */
+int32_t EventCallbackDispatchPriority(UAVObjEvent* ev, UAVObjEventCallback cb, uint8_t priority)
 {
 	EventCallbackInfo evInfo;
+	if (priority >= EVENT_PRIORITY_NUM)
+		priority = EVENT_PRIORITY_NORMAL;
 	// Initialize event callback information
 	memcpy(&evInfo.ev, ev, sizeof(UAVObjEvent));
 	evInfo.cb = cb;
 	evInfo.queue = 0;
 	// Push to queue
-	return xQueueSend(queue, &evInfo, 0); // will not block if queue is full
+	if (xQueueSend(lanes[priority], &evInfo, 0) != pdTRUE) // will not block if queue is full
+		return pdFALSE;
+	xSemaphoreGive(wakeup);
+	return pdTRUE;
 }
 
 /**
@@ -229,6 +292,14 @@ static int32_t eventPeriodicCreate(UAVObjEvent* ev, UAVObjEventCallback cb, xQue
 	objEntry->evInfo.queue = queue;
     objEntry->updatePeriodMs = periodMs;
     objEntry->timeToNextUpdateMs = randomizePeriod(periodMs); // avoid bunching of updates
+    objEntry->heapIndex = -1;
+    // Schedule, entries without a period stay off the heap
+    if (periodMs > 0 && heapInsert(objEntry) != 0)
+    {
+    	vPortFree(objEntry);
+    	xSemaphoreGiveRecursive(mutex);
+    	return -1;
+    }
     // Add to list
     LL_APPEND(objList, objEntry);
 	// Release lock
@@ -261,6 +332,20 @@ static int32_t eventPeriodicUpdate(UAVObjEvent* ev, UAVObjEventCallback cb, xQue
 			// Object found, update period
 			objEntry->updatePeriodMs = periodMs;
 			objEntry->timeToNextUpdateMs = randomizePeriod(periodMs); // avoid bunching of updates
+			// Move to its new place in the heap
+			if (periodMs == 0)
+			{
+				heapRemove(objEntry);
+			}
+			else if (objEntry->heapIndex >= 0)
+			{
+				heapReschedule(objEntry);
+			}
+			else if (heapInsert(objEntry) != 0)
+			{
+				xSemaphoreGiveRecursive(mutex);
+				return -1;
+			}
 			// Release lock
 			xSemaphoreGiveRecursive(mutex);
 			return 0;
@@ -279,6 +364,7 @@ static void eventTask()
 	int32_t timeToNextUpdateMs;
 	int32_t delayMs;
 	EventCallbackInfo evInfo;
+	uint8_t lane;
 
 	/* Must do this in task context to ensure that TaskMonitor has already finished its init */
 	TaskMonitorAdd(TASKINFO_RUNNING_EVENTDISPATCHER, eventTaskHandle);
@@ -296,15 +382,26 @@ static void eventTask()
 			delayMs = 0;
 		}
 
-		// Wait for queue message
-		if ( xQueueReceive(queue, &evInfo, delayMs/portTICK_RATE_MS) == pdTRUE )
+		// Take the next callback from the highest priority lane that has one
+		for (lane = 0; lane < EVENT_PRIORITY_NUM; ++lane)
+		{
+			if ( xQueueReceive(lanes[lane], &evInfo, 0) == pdTRUE )
+				break;
+		}
+
+		if (lane < EVENT_PRIORITY_NUM)
 		{
 			// Invoke callback, if one
 			if ( evInfo.cb != 0)
 			{
-				evInfo.cb(&evInfo.ev); // the function is expected to copy the event information
+				invokeCallback(&evInfo);
 			}
 		}
+		else
+		{
+			// All lanes are empty, wait until a callback is queued or the next periodic update is due
+			xSemaphoreTake(wakeup, delayMs/portTICK_RATE_MS);
+		}
 
 		// Process periodic updates
 		if ((xTaskGetTickCount()*portTICK_RATE_MS) >= timeToNextUpdateMs )
@@ -315,61 +412,160 @@ static void eventTask()
 }
 
 /**
- * Handle periodic updates for all objects.
+ * Invoke the callback of an event, with UAVOBJ_DIAGNOSTICS the execution
+ * time is recorded against the object.
+ */
+static void invokeCallback(EventCallbackInfo* evInfo)
+{
+#if defined(UAVOBJ_DIAGNOSTICS)
+	uint32_t start = PIOS_DELAY_GetRaw();
+#endif
+	evInfo->cb(&evInfo->ev); // the function is expected to copy the event information
+#if defined(UAVOBJ_DIAGNOSTICS)
+	if (evInfo->ev.obj != NULL)
+	{
+		UAVObjRecordCallbackTime(evInfo->ev.obj, PIOS_DELAY_DiffuS(start));
+	}
+#endif
+}
+
+/**
+ * Handle periodic updates for all objects. Only the entries that are due are
+ * visited, they are taken from the top of the deadline heap.
  * \return The system time until the next update (in ms) or -1 if failed
  */
 static int32_t processPeriodicUpdates()
 {
 	PeriodicObjectList* objEntry;
 	int32_t timeNow;
-    int32_t timeToNextUpdate;
-    int32_t offset;
+	int32_t timeToNextUpdate;
+	int32_t offset;
 
 	// Get lock
 	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
 
-    // Iterate through each object and update its timer, if zero then transmit object.
-    // Also calculate smallest delay to next update.
-    timeToNextUpdate = xTaskGetTickCount()*portTICK_RATE_MS + MAX_UPDATE_PERIOD_MS;
-    LL_FOREACH(objList, objEntry)
-    {
-        // If object is configured for periodic updates
-        if (objEntry->updatePeriodMs > 0)
-        {
-            // Check if time for the next update
-        	timeNow = xTaskGetTickCount()*portTICK_RATE_MS;
-            if (objEntry->timeToNextUpdateMs <= timeNow)
-            {
-                // Reset timer
-            	offset = ( timeNow - objEntry->timeToNextUpdateMs ) % objEntry->updatePeriodMs;
-            	objEntry->timeToNextUpdateMs = timeNow + objEntry->updatePeriodMs - offset;
-    			// Invoke callback, if one
-    			if ( objEntry->evInfo.cb != 0)
-    			{
-    				objEntry->evInfo.cb(&objEntry->evInfo.ev); // the function is expected to copy the event information
-    			}
-    			// Push event to queue, if one
-    			if ( objEntry->evInfo.queue != 0)
-    			{
-    				if ( xQueueSend(objEntry->evInfo.queue, &objEntry->evInfo.ev, 0) != pdTRUE ) // do not block if queue is full
-    				{
-						if (objEntry->evInfo.ev.obj != NULL)
-							stats.lastErrorID = UAVObjGetID(objEntry->evInfo.ev.obj);
-    					++stats.eventErrors;
-    				}
-    			}
-            }
-            // Update minimum delay
-            if (objEntry->timeToNextUpdateMs < timeToNextUpdate)
-            {
-            	timeToNextUpdate = objEntry->timeToNextUpdateMs;
-            }
-        }
-    }
+	// Update every object that is due, the earliest deadline is always at the top
+	timeNow = xTaskGetTickCount()*portTICK_RATE_MS;
+	while (heapSize > 0 && heap[0]->timeToNextUpdateMs <= timeNow)
+	{
+		objEntry = heap[0];
+		// Reset timer
+		offset = ( timeNow - objEntry->timeToNextUpdateMs ) % objEntry->updatePeriodMs;
+		objEntry->timeToNextUpdateMs = timeNow + objEntry->updatePeriodMs - offset;
+		heapSiftDown(0);
+		// Invoke callback, if one
+		if ( objEntry->evInfo.cb != 0)
+		{
+			invokeCallback(&objEntry->evInfo);
+		}
+		// Push event to queue, if one
+		if ( objEntry->evInfo.queue != 0)
+		{
+			if ( xQueueSend(objEntry->evInfo.queue, &objEntry->evInfo.ev, 0) != pdTRUE ) // do not block if queue is full
+			{
+				if (objEntry->evInfo.ev.obj != NULL)
+					stats.lastErrorID = UAVObjGetID(objEntry->evInfo.ev.obj);
+				++stats.eventErrors;
+			}
+		}
+	}
 
-    // Done
-    xSemaphoreGiveRecursive(mutex);
-    return timeToNextUpdate;
+	// Calculate delay to next update
+	timeToNextUpdate = timeNow + MAX_UPDATE_PERIOD_MS;
+	if (heapSize > 0 && heap[0]->timeToNextUpdateMs < timeToNextUpdate)
+	{
+		timeToNextUpdate = heap[0]->timeToNextUpdateMs;
+	}
+
+	// Done
+	xSemaphoreGiveRecursive(mutex);
+	return timeToNextUpdate;
+}
+
+/**
+ * Move a heap entry up until its parent is due earlier
+ */
+static void heapSiftUp(int16_t index)
+{
+	PeriodicObjectList* objEntry = heap[index];
+	while (index > 0)
+	{
+		int16_t parent = (index - 1) / 2;
+		if (heap[parent]->timeToNextUpdateMs <= objEntry->timeToNextUpdateMs)
+			break;
+		heap[index] = heap[parent];
+		heap[index]->heapIndex = index;
+		index = parent;
+	}
+	heap[index] = objEntry;
+	objEntry->heapIndex = index;
+}
+
+/**
+ * Move a heap entry down until both children are due later
+ */
+static void heapSiftDown(int16_t index)
+{
+	PeriodicObjectList* objEntry = heap[index];
+	while (1)
+	{
+		int16_t child = 2 * index + 1;
+		if (child >= heapSize)
+			break;
+		if (child + 1 < heapSize && heap[child + 1]->timeToNextUpdateMs < heap[child]->timeToNextUpdateMs)
+			++child;
+		if (objEntry->timeToNextUpdateMs <= heap[child]->timeToNextUpdateMs)
+			break;
+		heap[index] = heap[child];
+		heap[index]->heapIndex = index;
+		index = child;
+	}
+	heap[index] = objEntry;
+	objEntry->heapIndex = index;
+}
+
+/**
+ * Add an entry to the heap
+ * \return Success (0), failure (-1) if MAX_PERIODIC_EVENTS are already scheduled
+ */
+static int32_t heapInsert(PeriodicObjectList* objEntry)
+{
+	if (heapSize >= MAX_PERIODIC_EVENTS)
+	{
+		// Reported by the System module, raise PIOS_EVENTDISPATCHER_MAX_PERIODIC
+		if (objEntry->evInfo.ev.obj != NULL)
+			stats.lastErrorID = UAVObjGetID(objEntry->evInfo.ev.obj);
+		++stats.periodicOverflows;
+		return -1;
+	}
+	heap[heapSize] = objEntry;
+	heapSiftUp(heapSize++);
+	return 0;
+}
+
+/**
+ * Take an entry off the heap, nothing is done if it is not scheduled
+ */
+static void heapRemove(PeriodicObjectList* objEntry)
+{
+	int16_t index = objEntry->heapIndex;
+	if (index < 0)
+		return;
+	objEntry->heapIndex = -1;
+	if (--heapSize == index)
+		return;
+	heap[index] = heap[heapSize];
+	heap[index]->heapIndex = index;
+	heapReschedule(heap[index]);
+}
+
+/**
+ * Restore the heap order after the deadline of a scheduled entry changed
+ */
+static void heapReschedule(PeriodicObjectList* objEntry)
+{
+	heapSiftUp(objEntry->heapIndex);
+	heapSiftDown(objEntry->heapIndex);
 }
 
 /**
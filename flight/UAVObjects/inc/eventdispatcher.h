@@ -27,12 +27,23 @@
 #define EVENTDISPATCHER_H
 
 // Public types
+/**
+ * Callback lanes of the event task, higher priority lanes are served first
+ */
+typedef enum {
+	EVENT_PRIORITY_HIGH = 0,
+	EVENT_PRIORITY_NORMAL,
+	EVENT_PRIORITY_LOW,
+	EVENT_PRIORITY_NUM
+} EventPriority;
+
 /**
  * Event dispatcher statistics
  */
 typedef struct {
 	uint32_t lastErrorID;
 	uint32_t eventErrors;
+	uint32_t periodicOverflows;	/** Periodic events refused because the deadline heap was full, never cleared */
 } EventStats;
 
 // Public functions
@@ -40,6 +51,7 @@ int32_t EventDispatcherInitialize();
 void EventGetStats(EventStats* statsOut);
 void EventClearStats();
 int32_t EventCallbackDispatch(UAVObjEvent* ev, UAVObjEventCallback cb);
+int32_t EventCallbackDispatchPriority(UAVObjEvent* ev, UAVObjEventCallback cb, uint8_t priority);
 int32_t EventPeriodicCallbackCreate(UAVObjEvent* ev, UAVObjEventCallback cb, uint16_t periodMs);
 int32_t EventPeriodicCallbackUpdate(UAVObjEvent* ev, UAVObjEventCallback cb, uint16_t periodMs);
 int32_t EventPeriodicQueueCreate(UAVObjEvent* ev, xQueueHandle queue, uint16_t periodMs);
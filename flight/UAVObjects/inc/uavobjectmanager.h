@@ -34,6 +34,7 @@
 
 #define UAVOBJ_ALL_INSTANCES 0xFFFF
 #define UAVOBJ_MAX_INSTANCES 1000
+#define UAVOBJ_ALL_FIELDS 0xFFFFFFFF
 
 /*
  * Shifts and masks used to read/write metadata flags.
@@ -81,6 +82,21 @@ typedef struct {
 	uint16_t loggingUpdatePeriod; /** Update period used by the logging module (only if logging mode is PERIODIC) */
 } __attribute__((packed)) UAVObjMetadata;
 
+/**
+ * Immutable description of a data object. The generator emits one for every object
+ * in UAVOBJECTS_DESCRIPTORS, a table kept in flash, so only the mutable state of an
+ * object takes RAM.
+ */
+typedef struct {
+	uint32_t id; /** Object ID, the metaobject ID is id + 1 */
+	uint16_t numBytes; /** Number of bytes of object data (for one instance) */
+	uint8_t flags; /** UAVOBJ_DESC_* flags */
+	UAVObjMetadata defaultMetadata; /** Metadata the object is registered with */
+} __attribute__((packed)) UAVObjDescriptor;
+
+#define UAVOBJ_DESC_SINGLE 0x01
+#define UAVOBJ_DESC_SETTINGS 0x02
+
 /**
  * Event types generated by the objects.
  */
@@ -136,16 +152,40 @@ typedef struct {
 	uint32_t eventCallbackErrors;
 	uint32_t lastCallbackErrorID;
 	uint32_t lastQueueErrorID;
+	uint32_t eventsCoalesced;
 } UAVObjStats;
 
+/**
+ * Object storage pool usage
+ */
+typedef struct {
+	uint32_t poolSize;	/** Size of the pool set up by the board */
+	uint32_t poolUsed;	/** Bytes taken from the pool, storage is never returned so this is the high-water mark */
+	uint32_t heapUsed;	/** Bytes taken from the heap because the pool was used up or missing */
+	uint32_t eventsFree;	/** Released event entries waiting for reuse */
+} UAVObjPoolStats;
+
+/**
+ * Per object statistics, only collected when built with UAVOBJ_DIAGNOSTICS.
+ * The struct is padded to 12 bytes and every object and metaobject holds one.
+ */
+typedef struct {
+	uint32_t updates;		/** Events sent, except update requests */
+	uint32_t callbackTimeMax;	/** Longest callback execution time in us */
+	uint8_t queueHighWater;		/** Most events seen waiting in a listener queue */
+} UAVObjDiagnostics;
+
 int32_t UAVObjInitialize();
 void UAVObjGetStats(UAVObjStats* statsOut);
 void UAVObjClearStats();
+void UAVObjGetPoolStats(UAVObjPoolStats * statsOut);
+int32_t UAVObjInitializePool(void * buffer, uint32_t size);
 UAVObjHandle UAVObjRegister(uint32_t id,
 		int32_t isSingleInstance, int32_t isSettings, uint32_t numBytes, UAVObjInitializeCallback initCb);
 UAVObjHandle UAVObjGetByID(uint32_t id);
 uint32_t UAVObjGetID(UAVObjHandle obj);
 uint32_t UAVObjGetNumBytes(UAVObjHandle obj);
+uint16_t UAVObjGetFieldSizes(UAVObjHandle obj, const uint16_t ** sizes);
 uint16_t UAVObjGetNumInstances(UAVObjHandle obj);
 UAVObjHandle UAVObjGetLinkedObj(UAVObjHandle obj);
 uint16_t UAVObjCreateInstance(UAVObjHandle obj_handle, UAVObjInitializeCallback initCb);
@@ -169,10 +209,12 @@ int32_t UAVObjLoadMetaobjects();
 int32_t UAVObjDeleteMetaobjects();
 int32_t UAVObjSetData(UAVObjHandle obj_handle, const void* dataIn);
 int32_t UAVObjSetDataField(UAVObjHandle obj_handle, const void* dataIn, uint32_t offset, uint32_t size);
+int32_t UAVObjSetDataFieldMask(UAVObjHandle obj_handle, const void* dataIn, uint32_t offset, uint32_t size, uint32_t fieldMask);
 int32_t UAVObjGetData(UAVObjHandle obj_handle, void* dataOut);
 int32_t UAVObjGetDataField(UAVObjHandle obj_handle, void* dataOut, uint32_t offset, uint32_t size);
 int32_t UAVObjSetInstanceData(UAVObjHandle obj_handle, uint16_t instId, const void* dataIn);
 int32_t UAVObjSetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, const void* dataIn, uint32_t offset, uint32_t size);
+int32_t UAVObjSetInstanceDataFieldMask(UAVObjHandle obj_handle, uint16_t instId, const void* dataIn, uint32_t offset, uint32_t size, uint32_t fieldMask);
 int32_t UAVObjGetInstanceData(UAVObjHandle obj_handle, uint16_t instId, void* dataOut);
 int32_t UAVObjGetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, void* dataOut, uint32_t offset, uint32_t size);
 int32_t UAVObjSetMetadata(UAVObjHandle obj_handle, const UAVObjMetadata* dataIn);
@@ -192,14 +234,23 @@ UAVObjUpdateMode UAVObjGetGcsTelemetryUpdateMode(const UAVObjMetadata* dataOut);
 void UAVObjSetTelemetryGcsUpdateMode(UAVObjMetadata* dataOut, UAVObjUpdateMode val);
 int8_t UAVObjReadOnly(UAVObjHandle obj);
 int32_t UAVObjConnectQueue(UAVObjHandle obj_handle, xQueueHandle queue, uint8_t eventMask);
+int32_t UAVObjConnectQueueCoalesced(UAVObjHandle obj_handle, xQueueHandle queue, uint8_t eventMask);
 int32_t UAVObjDisconnectQueue(UAVObjHandle obj_handle, xQueueHandle queue);
+portBASE_TYPE UAVObjQueueReceive(xQueueHandle queue, UAVObjEvent * ev, portTickType timeout);
 int32_t UAVObjConnectCallback(UAVObjHandle obj_handle, UAVObjEventCallback cb, uint8_t eventMask);
+int32_t UAVObjConnectCallbackPriority(UAVObjHandle obj_handle, UAVObjEventCallback cb, uint8_t eventMask, uint8_t priority);
 int32_t UAVObjDisconnectCallback(UAVObjHandle obj_handle, UAVObjEventCallback cb);
 void UAVObjRequestUpdate(UAVObjHandle obj);
 void UAVObjRequestInstanceUpdate(UAVObjHandle obj_handle, uint16_t instId);
 void UAVObjUpdated(UAVObjHandle obj);
 void UAVObjInstanceUpdated(UAVObjHandle obj_handle, uint16_t instId);
+uint32_t UAVObjGetDirtyFields(UAVObjHandle obj_handle, uint16_t instId);
+uint32_t UAVObjClearDirtyFields(UAVObjHandle obj_handle, uint16_t instId);
 void UAVObjIterate(void (*iterator)(UAVObjHandle obj));
+#if defined(UAVOBJ_DIAGNOSTICS)
+void UAVObjGetDiagnostics(UAVObjHandle obj_handle, UAVObjDiagnostics * diagOut, bool clear);
+void UAVObjRecordCallbackTime(UAVObjHandle obj_handle, uint32_t timeUs);
+#endif
 
 #endif // UAVOBJECTMANAGER_H
 
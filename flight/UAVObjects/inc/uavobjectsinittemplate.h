@@ -31,4 +31,23 @@ void UAVObjectsInitializeAll();
 
 #define UAVOBJECTS_LARGEST $(SIZECALCULATION)
 
+/* IDs of all data objects in ascending order, used by UAVObjGetByID() */
+#define UAVOBJECTS_NUM $(NUMOBJECTS)
+#define UAVOBJECTS_IDS { \
+$(OBJIDS)}
+
+/* Immutable descriptors (UAVObjDescriptor) of all data objects in the order of
+ * UAVOBJECTS_IDS, kept in flash by the object manager. The RAM every object
+ * takes is listed in uavobjectsram.txt next to this file. */
+#define UAVOBJECTS_DESCRIPTORS { \
+$(OBJDESCRIPTORS)}
+
+/* Size in bytes of every data field in packing order, object by object in the
+ * order of UAVOBJECTS_IDS. The fields of the object at index n start at entry
+ * UAVOBJECTS_FIELDINDEX[n] and end before UAVOBJECTS_FIELDINDEX[n + 1]. */
+#define UAVOBJECTS_FIELDSIZES { \
+$(OBJFIELDSIZES)}
+#define UAVOBJECTS_FIELDINDEX { \
+$(OBJFIELDINDEX)}
+
 #endif // UAVOBJECTSINIT_H
@@ -58,6 +58,7 @@
 #define $(NAME)InstSet(instId, dataIn) UAVObjSetInstanceData($(NAME)Handle(), instId, dataIn)
 #define $(NAME)ConnectQueue(queue) UAVObjConnectQueue($(NAME)Handle(), queue, EV_MASK_ALL_UPDATES)
 #define $(NAME)ConnectCallback(cb) UAVObjConnectCallback($(NAME)Handle(), cb, EV_MASK_ALL_UPDATES)
+#define $(NAME)ConnectCallbackPriority(cb, priority) UAVObjConnectCallbackPriority($(NAME)Handle(), cb, EV_MASK_ALL_UPDATES, priority)
 #define $(NAME)CreateInstance() UAVObjCreateInstance($(NAME)Handle(),&$(NAME)SetDefaults)
 #define $(NAME)RequestUpdate() UAVObjRequestUpdate($(NAME)Handle())
 #define $(NAME)RequestInstUpdate(instId) UAVObjRequestInstanceUpdate($(NAME)Handle(), instId)
@@ -66,6 +67,10 @@
 #define $(NAME)GetMetadata(dataOut) UAVObjGetMetadata($(NAME)Handle(), dataOut)
 #define $(NAME)SetMetadata(dataIn) UAVObjSetMetadata($(NAME)Handle(), dataIn)
 #define $(NAME)ReadOnly() UAVObjReadOnly($(NAME)Handle())
+#define $(NAME)DirtyFields() UAVObjGetDirtyFields($(NAME)Handle(), 0)
+#define $(NAME)InstDirtyFields(instId) UAVObjGetDirtyFields($(NAME)Handle(), instId)
+#define $(NAME)ClearDirtyFields() UAVObjClearDirtyFields($(NAME)Handle(), 0)
+#define $(NAME)InstClearDirtyFields(instId) UAVObjClearDirtyFields($(NAME)Handle(), instId)
 
 // Object data
 typedef struct {
@@ -33,6 +33,7 @@
 
 #include "openpilot.h"
 #include "pios_struct_helper.h"
+#include "uavobjectsinit.h"
 
 // Constants
 
@@ -40,6 +41,7 @@
 
 // Macros
 #define SET_BITS(var, shift, value, mask) var = (var & ~(mask << shift)) | (value << shift);
+#define UAVO_FOREACH(obj) for (obj = nextObject(NULL); obj != NULL; obj = nextObject(obj))
 
 /**
  * List of event queues and the eventmask associated with the queue.
@@ -52,9 +54,17 @@ struct ObjectEventEntry {
 	xQueueHandle              queue;
 	UAVObjEventCallback       cb;
 	uint8_t                   eventMask;
+	uint8_t                   flags;
+	uint16_t                  pendingInstId;
+	uint8_t                   pendingEvent;
+	uint8_t                   priority;	/* EventPriority lane of the callback */
 	struct ObjectEventEntry * next;
 };
 
+/* Event entry flags */
+#define EVENT_FLAG_COALESCE 0x01	/* merge events with one already queued for the same instance */
+#define EVENT_FLAG_PENDING  0x02	/* pendingEvent/pendingInstId is in the queue */
+
 /*
   MetaInstance   == [UAVOBase [UAVObjMetadata]]
   SingleInstance == [UAVOBase [UAVOData [InstanceData]]]
@@ -81,6 +91,10 @@ struct UAVOBase {
 		bool isSettings    : 1;
 	} flags;
 
+#if defined(UAVOBJ_DIAGNOSTICS)
+	/* Update and listener statistics, see UAVObjGetDiagnostics() */
+	UAVObjDiagnostics diag;
+#endif
 } __attribute__((packed));
 
 /* Augmented type for Meta UAVO */
@@ -89,23 +103,47 @@ struct UAVOMeta {
 	UAVObjMetadata    instance0;
 } __attribute__((packed));
 
-/* Shared data structure for all data-carrying UAVObjects (UAVOSingle and UAVOMulti) */
+/*
+ * Shared data structure for all data-carrying UAVObjects (UAVOSingle and UAVOMulti)
+ *   - desc: the immutable part of the object (ID, size, default metadata), an
+ *     entry of the generated table in flash for all objects known at build time
+ */
 struct UAVOData {
 	struct UAVOBase   base;
-	uint32_t          id;
+	const UAVObjDescriptor * desc;
 	/*
 	 * Embed the Meta object as another complete UAVO
 	 * inside the payload for this UAVO.
 	 */
 	struct UAVOMeta   metaObj;
-	struct UAVOData * next;
-	uint16_t          instance_size;
+} __attribute__((packed));
+
+/*
+ * Objects registered with an ID missing from the generated table carry their
+ * descriptor in RAM and are chained in a list of their own
+ */
+struct UAVOExtra {
+	UAVObjDescriptor   desc;
+	struct UAVOData  * obj;
+	struct UAVOExtra * next;
+};
+
+/*
+ * State kept right before the data of every data object instance
+ *   - dirty: fields changed since the consumer last cleared them, one bit per
+ *     field as generated in <object>_<field>_FIELDMASK
+ *   - seq: odd while the data is being written, see readUnlocked()
+ */
+struct UAVOInstState {
+	uint32_t          dirty;
+	volatile uint32_t seq;
 } __attribute__((packed));
 
 /* Augmented type for Single Instance Data UAVO */
 struct UAVOSingle {
 	struct UAVOData   uavo;
 
+	struct UAVOInstState state;
 	uint8_t           instance0[];
 	/* 
 	 * Additional space will be malloc'd here to hold the
@@ -116,6 +154,7 @@ struct UAVOSingle {
 /* Part of a linked list of instances chained off of a multi instance UAVO. */
 struct UAVOMultiInst {
 	struct UAVOMultiInst * next;
+	struct UAVOInstState   state;
 	uint8_t                instance[];
 	/* 
 	 * Additional space will be malloc'd here to hold the
@@ -147,14 +186,19 @@ struct UAVOMulti {
 #define ObjSingleInstanceDataOffset(obj) ((void*)(&(( (struct UAVOSingle*)obj )->instance0)))
 #define InstanceDataOffset(inst) ((void*)&(( (struct UAVOMultiInst*)inst )->instance))
 #define InstanceData(instance) (void*)instance
+#define InstanceState(instance) (((struct UAVOInstState *)(instance)) - 1)
 
 // Private functions
 static int32_t sendEvent(struct UAVOBase * obj, uint16_t instId,
 			UAVObjEventType event);
 static InstanceHandle createInstance(struct UAVOData * obj, uint16_t instId);
+static struct UAVOData * nextObject(struct UAVOData * obj);
 static InstanceHandle getInstance(struct UAVOData * obj, uint16_t instId);
+static void beginWrite(UAVObjHandle obj_handle, InstanceHandle instEntry);
+static void endWrite(UAVObjHandle obj_handle, InstanceHandle instEntry, uint32_t fieldMask);
+static bool readUnlocked(UAVObjHandle obj_handle, uint16_t instId, void * dataOut, uint32_t offset, uint32_t size);
 static int32_t connectObj(UAVObjHandle obj_handle, xQueueHandle queue,
-			UAVObjEventCallback cb, uint8_t eventMask);
+			UAVObjEventCallback cb, uint8_t eventMask, uint8_t flags, uint8_t priority);
 static int32_t disconnectObj(UAVObjHandle obj_handle, xQueueHandle queue,
 			UAVObjEventCallback cb);
 
@@ -164,8 +208,27 @@ static void customSPrintf(uint8_t * buffer, uint8_t * format, ...);
 #endif
 
 // Private variables
-static struct UAVOData * uavo_list;
+static const UAVObjDescriptor uavo_descriptors[UAVOBJECTS_NUM] = UAVOBJECTS_DESCRIPTORS;
+static struct UAVOData * uavo_by_id[UAVOBJECTS_NUM];
+static struct UAVOExtra * uavo_extra_list;
+static const uint16_t uavo_field_sizes[] = UAVOBJECTS_FIELDSIZES;
+static const uint16_t uavo_field_index[UAVOBJECTS_NUM + 1] = UAVOBJECTS_FIELDINDEX;
 static xSemaphoreHandle mutex;
+
+/*
+ * Object data, instance lists and event lists are protected by one of a few lock
+ * stripes picked from the object ID, so tasks using unrelated objects do not wait
+ * on each other. A data object and its metaobject share a stripe. The global mutex
+ * only protects the object list, the statistics and the file system. A stripe may
+ * be taken while holding the global mutex but never the other way around.
+ */
+#ifndef UAVOBJ_LOCK_STRIPES
+#define UAVOBJ_LOCK_STRIPES 4
+#endif
+static xSemaphoreHandle stripes[UAVOBJ_LOCK_STRIPES];
+
+/* A read of a single instance object overlapped by writes this often takes the lock */
+#define UAVOBJ_UNLOCKED_READ_ATTEMPTS 2
 static const UAVObjMetadata defMetadata = {
 	.flags = (ACCESS_READWRITE << UAVOBJ_ACCESS_SHIFT |
 		ACCESS_READWRITE << UAVOBJ_GCS_ACCESS_SHIFT |
@@ -180,6 +243,18 @@ static const UAVObjMetadata defMetadata = {
 
 static UAVObjStats stats;
 
+/*
+ * Object storage is taken from a pool set up by the board with UAVObjInitializePool().
+ * Objects and instances are never freed so they are carved from the pool in order,
+ * only event entries are released again and those are recycled through a free list
+ * of their own size. Once the pool is used up, or when the board has none, storage
+ * comes from the FreeRTOS heap.
+ */
+#define UAVOBJ_POOL_ALIGN sizeof(void *)
+static uint8_t * poolBuffer;
+static UAVObjPoolStats poolStats;
+static struct ObjectEventEntry * freeEvents;
+
 /**
  * Initialize the object manager
  * \return 0 Success
@@ -188,13 +263,22 @@ static UAVObjStats stats;
 int32_t UAVObjInitialize()
 {
 	// Initialize variables
-	uavo_list = NULL;
+	uavo_extra_list = NULL;
+	memset(uavo_by_id, 0, sizeof(uavo_by_id));
 	memset(&stats, 0, sizeof(UAVObjStats));
+	poolBuffer = NULL;
+	memset(&poolStats, 0, sizeof(UAVObjPoolStats));
+	freeEvents = NULL;
 
 	// Create mutex
 	mutex = xSemaphoreCreateRecursiveMutex();
 	if (mutex == NULL)
 		return -1;
+	for (uint32_t n = 0; n < UAVOBJ_LOCK_STRIPES; ++n) {
+		stripes[n] = xSemaphoreCreateRecursiveMutex();
+		if (stripes[n] == NULL)
+			return -1;
+	}
 
 	// Done
 	return 0;
@@ -210,9 +294,9 @@ int32_t UAVObjInitialize()
  */
 void UAVObjGetStats(UAVObjStats * statsOut)
 {
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	portENTER_CRITICAL();
 	memcpy(statsOut, &stats, sizeof(UAVObjStats));
-	xSemaphoreGiveRecursive(mutex);
+	portEXIT_CRITICAL();
 }
 
 /**
@@ -220,9 +304,116 @@ void UAVObjGetStats(UAVObjStats * statsOut)
  */
 void UAVObjClearStats()
 {
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	portENTER_CRITICAL();
 	memset(&stats, 0, sizeof(UAVObjStats));
-	xSemaphoreGiveRecursive(mutex);
+	portEXIT_CRITICAL();
+}
+
+/**
+ * Get the storage pool usage, available whether or not the board set up a pool
+ * @param[out] statsOut The pool counters will be copied there
+ */
+void UAVObjGetPoolStats(UAVObjPoolStats * statsOut)
+{
+	portENTER_CRITICAL();
+	memcpy(statsOut, &poolStats, sizeof(UAVObjPoolStats));
+	portEXIT_CRITICAL();
+}
+
+/*****************
+ * Storage
+ ****************/
+
+/**
+ * Set up the pool object storage is allocated from, must be called after
+ * UAVObjInitialize() and before the first object is registered.
+ * \param[in] buffer The pool memory, aligned to a pointer
+ * \param[in] size The pool size in bytes
+ * \return 0 Success
+ * \return -1 Failure, objects are already registered
+ */
+int32_t UAVObjInitializePool(void * buffer, uint32_t size)
+{
+	PIOS_Assert(buffer);
+	PIOS_Assert(((uintptr_t) buffer % UAVOBJ_POOL_ALIGN) == 0);
+	if (nextObject(NULL) != NULL) {
+		return -1;
+	}
+	poolBuffer = (uint8_t *) buffer;
+	poolStats.poolSize = size;
+	poolStats.poolUsed = 0;
+	return 0;
+}
+
+/**
+ * Allocate object storage, from the pool while it lasts and from the heap after that.
+ * Storage is never given back.
+ */
+static void * poolAlloc(uint32_t size)
+{
+	void * ptr = NULL;
+
+	size = (size + UAVOBJ_POOL_ALIGN - 1) & ~(UAVOBJ_POOL_ALIGN - 1);
+
+	// Objects of different stripes may be created concurrently
+	portENTER_CRITICAL();
+	if (poolBuffer != NULL && poolStats.poolSize - poolStats.poolUsed >= size) {
+		ptr = poolBuffer + poolStats.poolUsed;
+		poolStats.poolUsed += size;
+	}
+	portEXIT_CRITICAL();
+
+	if (ptr == NULL) {
+		ptr = pvPortMalloc(size);
+		if (ptr != NULL) {
+			portENTER_CRITICAL();
+			poolStats.heapUsed += size;
+			portEXIT_CRITICAL();
+		}
+	}
+	return ptr;
+}
+
+/**
+ * Allocate an event entry, released entries are reused first
+ */
+static struct ObjectEventEntry * allocEventEntry()
+{
+	struct ObjectEventEntry * event;
+
+	portENTER_CRITICAL();
+	event = freeEvents;
+	if (event != NULL) {
+		freeEvents = event->next;
+		--poolStats.eventsFree;
+	}
+	portEXIT_CRITICAL();
+
+	if (event == NULL) {
+		event = (struct ObjectEventEntry *) poolAlloc(sizeof(struct ObjectEventEntry));
+	}
+	return event;
+}
+
+/**
+ * Release an event entry for reuse by allocEventEntry()
+ */
+static void freeEventEntry(struct ObjectEventEntry * event)
+{
+	portENTER_CRITICAL();
+	event->next = freeEvents;
+	freeEvents = event;
+	++poolStats.eventsFree;
+	portEXIT_CRITICAL();
+}
+
+/**
+ * Get the lock stripe protecting an object, data IDs are even and the
+ * metaobject ID is the data ID + 1 so both map to the same stripe
+ */
+static inline xSemaphoreHandle objectLock(UAVObjHandle obj_handle)
+{
+	return stripes[(UAVObjGetID(obj_handle) >> 1) % UAVOBJ_LOCK_STRIPES];
 }
 
 /************************
@@ -247,8 +438,8 @@ static struct UAVOData * UAVObjAllocSingle(uint32_t num_bytes)
 	/* Compute the complete size of the object, including the data for a single embedded instance */
 	uint32_t object_size = sizeof(struct UAVOSingle) + num_bytes;
 
-	/* Allocate the object from the heap */
-	struct UAVOSingle * uavo_single = (struct UAVOSingle *) pvPortMalloc(object_size);
+	/* Allocate the object from the storage pool */
+	struct UAVOSingle * uavo_single = (struct UAVOSingle *) poolAlloc(object_size);
 	if (!uavo_single)
 		return (NULL);
 
@@ -260,6 +451,8 @@ static struct UAVOData * UAVObjAllocSingle(uint32_t num_bytes)
 
 	/* Clear the instance data carried in the UAVO */
 	memset(&(uavo_single->instance0), 0, num_bytes);
+	uavo_single->state.dirty = UAVOBJ_ALL_FIELDS;
+	uavo_single->state.seq   = 0;
 
 	/* Give back the generic UAVO part */
 	return (&(uavo_single->uavo));
@@ -270,8 +463,8 @@ static struct UAVOData * UAVObjAllocMulti(uint32_t num_bytes)
 	/* Compute the complete size of the object, including the data for a single embedded instance */
 	uint32_t object_size = sizeof(struct UAVOMulti) + num_bytes;
 
-	/* Allocate the object from the heap */
-	struct UAVOMulti * uavo_multi = (struct UAVOMulti *) pvPortMalloc(object_size);
+	/* Allocate the object from the storage pool */
+	struct UAVOMulti * uavo_multi = (struct UAVOMulti *) poolAlloc(object_size);
 	if (!uavo_multi)
 		return (NULL);
 
@@ -286,11 +479,61 @@ static struct UAVOData * UAVObjAllocMulti(uint32_t num_bytes)
 
 	/* Clear the instance data carried in the UAVO */
 	memset (&(uavo_multi->instance0), 0, num_bytes);
+	uavo_multi->instance0.state.dirty = UAVOBJ_ALL_FIELDS;
+	uavo_multi->instance0.state.seq   = 0;
 
 	/* Give back the generic UAVO part */
 	return (&(uavo_multi->uavo));
 }
 
+/**
+ * Find the position of a data object ID in the generated descriptor table
+ * \param[in] id The data object ID
+ * \return Index into uavo_descriptors, or -1 if the ID was unknown when the objects were generated
+ */
+static int32_t UAVObjIdIndex(uint32_t id)
+{
+	int32_t low = 0;
+	int32_t high = UAVOBJECTS_NUM - 1;
+
+	while (low <= high) {
+		int32_t mid = (low + high) / 2;
+		if (uavo_descriptors[mid].id < id) {
+			low = mid + 1;
+		} else if (uavo_descriptors[mid].id > id) {
+			high = mid - 1;
+		} else {
+			return mid;
+		}
+	}
+	return -1;
+}
+
+/**
+ * Walk the registered data objects, those of the generated table in ID order
+ * followed by the ones registered with an unknown ID
+ * \param[in] obj The current object or NULL to start
+ * \return The next object or NULL at the end
+ */
+static struct UAVOData * nextObject(struct UAVOData * obj)
+{
+	int32_t n = 0;
+
+	if (obj != NULL) {
+		if (obj->desc < uavo_descriptors || obj->desc >= uavo_descriptors + UAVOBJECTS_NUM) {
+			struct UAVOExtra * extra = container_of(obj->desc, struct UAVOExtra, desc);
+			return extra->next ? extra->next->obj : NULL;
+		}
+		n = obj->desc - uavo_descriptors + 1;
+	}
+
+	for (; n < UAVOBJECTS_NUM; ++n) {
+		if (uavo_by_id[n] != NULL)
+			return uavo_by_id[n];
+	}
+	return uavo_extra_list ? uavo_extra_list->obj : NULL;
+}
+
 /**************************
  * UAVObject Database APIs
  *************************/
@@ -311,6 +554,9 @@ UAVObjHandle UAVObjRegister(uint32_t id,
 			UAVObjInitializeCallback initCb)
 {
 	struct UAVOData * uavo_data = NULL;
+	struct UAVOExtra * extra = NULL;
+	const UAVObjDescriptor * desc;
+	int32_t id_index;
 
 	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
 
@@ -318,6 +564,23 @@ UAVObjHandle UAVObjRegister(uint32_t id,
 	if (UAVObjGetByID(id))
 		goto unlock_exit;
 
+	/* Objects known at generation time use the descriptor in flash */
+	id_index = UAVObjIdIndex(id);
+	if (id_index >= 0) {
+		desc = &uavo_descriptors[id_index];
+		PIOS_Assert(desc->numBytes == num_bytes);
+	} else {
+		extra = (struct UAVOExtra *) poolAlloc(sizeof(struct UAVOExtra));
+		if (!extra)
+			goto unlock_exit;
+		extra->desc.id       = id;
+		extra->desc.numBytes = num_bytes;
+		extra->desc.flags    = (isSingleInstance ? UAVOBJ_DESC_SINGLE : 0) |
+			(isSettings ? UAVOBJ_DESC_SETTINGS : 0);
+		extra->desc.defaultMetadata = defMetadata;
+		desc = &extra->desc;
+	}
+
 	/* Map the various flags to one of the UAVO types we understand */
 	if (isSingleInstance) {
 		uavo_data = UAVObjAllocSingle (num_bytes);
@@ -329,19 +592,24 @@ UAVObjHandle UAVObjRegister(uint32_t id,
 		goto unlock_exit;
 
 	/* Fill in the details about this UAVO */
-	uavo_data->id            = id;
-	uavo_data->instance_size = num_bytes;
+	uavo_data->desc = desc;
 	if (isSettings) {
 		uavo_data->base.flags.isSettings = true;
 	}
 
 	/* Initialize the embedded meta UAVO */
 	UAVObjInitMetaData (&uavo_data->metaObj);
+	memcpy(&uavo_data->metaObj.instance0, &desc->defaultMetadata, sizeof(UAVObjMetadata));
 
-	/* Add the newly created object to the global list of objects */
-	LL_APPEND(uavo_list, uavo_data);
+	/* Remember it in the ID table used by UAVObjGetByID(), or in the list of unknown IDs */
+	if (id_index >= 0) {
+		uavo_by_id[id_index] = uavo_data;
+	} else {
+		extra->obj = uavo_data;
+		LL_APPEND(uavo_extra_list, extra);
+	}
 
-	/* Initialize object fields and metadata to default values */
+	/* Initialize object fields to default values */
 	if (initCb)
 		initCb((UAVObjHandle) uavo_data, 0);
 
@@ -370,18 +638,30 @@ UAVObjHandle UAVObjGetByID(uint32_t id)
 {
 	UAVObjHandle * found_obj = (UAVObjHandle *) NULL;
 
+	// Objects known at generation time are found through the sorted ID table,
+	// data object IDs are even and the meta object ID is the data ID + 1
+	int32_t id_index = UAVObjIdIndex(id & ~1);
+	if (id_index >= 0) {
+		struct UAVOData * uavo_data = uavo_by_id[id_index];
+		if (!uavo_data)
+			return NULL;
+		if (id & 1)
+			return (UAVObjHandle) &(uavo_data->metaObj);
+		return (UAVObjHandle) uavo_data;
+	}
+
 	// Get lock
 	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
 
-	// Look for object
-	struct UAVOData * tmp_obj;
-	LL_FOREACH(uavo_list, tmp_obj) {
-		if (tmp_obj->id == id) {
-			found_obj = (UAVObjHandle *)tmp_obj;
+	// Look for object among the ones registered with an unknown ID
+	struct UAVOExtra * extra;
+	LL_FOREACH(uavo_extra_list, extra) {
+		if (extra->desc.id == id) {
+			found_obj = (UAVObjHandle *)extra->obj;
 			goto unlock_exit;
 		}
-		if (MetaObjectId(tmp_obj->id) == id) {
-			found_obj = (UAVObjHandle *)&(tmp_obj->metaObj);
+		if (MetaObjectId(extra->desc.id) == id) {
+			found_obj = (UAVObjHandle *)&(extra->obj->metaObj);
 			goto unlock_exit;
 		}
 	}
@@ -407,12 +687,12 @@ uint32_t UAVObjGetID(UAVObjHandle obj_handle)
 		/* We have a meta object, find our containing UAVO */
 		struct UAVOData * uavo_data = container_of ((struct UAVOMeta *)uavo_base, struct UAVOData, metaObj);
 
-		return MetaObjectId (uavo_data->id);
+		return MetaObjectId (uavo_data->desc->id);
 	} else {
 		/* We have a data object, augment our pointer */
 		struct UAVOData * uavo_data = (struct UAVOData *) uavo_base;
 
-		return (uavo_data->id);
+		return (uavo_data->desc->id);
 	}
 }
 
@@ -436,12 +716,38 @@ uint32_t UAVObjGetNumBytes(UAVObjHandle obj)
 		/* We have a data object, augment our pointer */
 		struct UAVOData * uavo = (struct UAVOData *) uavo_base;
 
-		instance_size = uavo->instance_size;
+		instance_size = uavo->desc->numBytes;
 	}
 
 	return (instance_size);
 }
 
+/**
+ * Get the size of every data field of an object, in the order the fields are
+ * packed and numbered by <object>_<field>_FIELDMASK. The table is generated
+ * with the objects and lives in flash.
+ * \param[in] obj The object handle
+ * \param[out] sizes Set to the first field size
+ * \return The number of fields, 0 for metaobjects or objects missing from the table
+ */
+uint16_t UAVObjGetFieldSizes(UAVObjHandle obj_handle, const uint16_t ** sizes)
+{
+	PIOS_Assert(obj_handle);
+	PIOS_Assert(sizes);
+
+	if (UAVObjIsMetaobject(obj_handle)) {
+		return 0;
+	}
+
+	int32_t id_index = UAVObjIdIndex(UAVObjGetID(obj_handle));
+	if (id_index < 0) {
+		return 0;
+	}
+
+	*sizes = &uavo_field_sizes[uavo_field_index[id_index]];
+	return uavo_field_index[id_index + 1] - uavo_field_index[id_index];
+}
+
 /**
  * Get the object this object is linked to. For regular objects, the linked object
  * is the metaobject. For metaobjects the linked object is the parent object.
@@ -504,7 +810,8 @@ uint16_t UAVObjCreateInstance(UAVObjHandle obj_handle,
 	}
 
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 
 	InstanceHandle instEntry;
 	uint16_t instId = 0;
@@ -522,7 +829,7 @@ uint16_t UAVObjCreateInstance(UAVObjHandle obj_handle,
 	}
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreGiveRecursive(lock);
 
 	return instId;
 }
@@ -585,7 +892,8 @@ int32_t UAVObjUnpack(UAVObjHandle obj_handle, uint16_t instId,
 	PIOS_Assert(obj_handle);
 
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 
 	int32_t rc = -1;
 
@@ -612,7 +920,9 @@ int32_t UAVObjUnpack(UAVObjHandle obj_handle, uint16_t instId,
 			}
 		}
 		// Set the data
-		memcpy(InstanceData(instEntry), dataIn, obj->instance_size);
+		beginWrite(obj_handle, instEntry);
+		memcpy(InstanceData(instEntry), dataIn, obj->desc->numBytes);
+		endWrite(obj_handle, instEntry, UAVOBJ_ALL_FIELDS);
 	}
 
 	// Fire event
@@ -620,7 +930,7 @@ int32_t UAVObjUnpack(UAVObjHandle obj_handle, uint16_t instId,
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreGiveRecursive(lock);
 	return rc;
 }
 
@@ -636,7 +946,8 @@ int32_t UAVObjPack(UAVObjHandle obj_handle, uint16_t instId, uint8_t * dataOut)
 	PIOS_Assert(obj_handle);
 
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 
 	int32_t rc = -1;
 
@@ -658,13 +969,13 @@ int32_t UAVObjPack(UAVObjHandle obj_handle, uint16_t instId, uint8_t * dataOut)
 			goto unlock_exit;
 		}
 		// Pack data
-		memcpy(dataOut, InstanceData(instEntry), obj->instance_size);
+		memcpy(dataOut, InstanceData(instEntry), obj->desc->numBytes);
 	}
 
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreGiveRecursive(lock);
 	return rc;
 }
 
@@ -688,12 +999,15 @@ int32_t UAVObjSaveToFile(UAVObjHandle obj_handle, uint16_t instId,
 	if (PIOS_SDCARD_IsMounted() == 0) {
 		return -1;
 	}
-	// Lock
+	// Lock, the file system and the object
 	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 
 	if (UAVObjIsMetaobject(obj_handle)) {
 		// Get the instance information
 		if (instId != 0) {
+			xSemaphoreGiveRecursive(lock);
 			xSemaphoreGiveRecursive(mutex);
 			return -1;
 		}
@@ -706,6 +1020,7 @@ int32_t UAVObjSaveToFile(UAVObjHandle obj_handle, uint16_t instId,
 		PIOS_FWRITE(file, MetaDataPtr((struct UAVOMeta *)obj_handle), MetaNumBytes,
 			&bytesWritten);
 		if (bytesWritten != MetaNumBytes) {
+			xSemaphoreGiveRecursive(lock);
 			xSemaphoreGiveRecursive(mutex);
 			return -1;
 		}
@@ -719,11 +1034,12 @@ int32_t UAVObjSaveToFile(UAVObjHandle obj_handle, uint16_t instId,
 		// Get the instance information
 		instEntry = getInstance(uavo, instId);
 		if (instEntry == NULL) {
+			xSemaphoreGiveRecursive(lock);
 			xSemaphoreGiveRecursive(mutex);
 			return -1;
 		}
 		// Write the object ID
-		PIOS_FWRITE(file, &uavo->id, sizeof(uavo->id),
+		PIOS_FWRITE(file, &uavo->desc->id, sizeof(uavo->desc->id),
 			&bytesWritten);
 
 		// Write the instance ID
@@ -732,14 +1048,16 @@ int32_t UAVObjSaveToFile(UAVObjHandle obj_handle, uint16_t instId,
 				sizeof(instId), &bytesWritten);
 		}
 		// Write the data and check that the write was successful
-		PIOS_FWRITE(file, InstanceData(instEntry), uavo->instance_size,
+		PIOS_FWRITE(file, InstanceData(instEntry), uavo->desc->numBytes,
 			&bytesWritten);
-		if (bytesWritten != uavo->instance_size) {
+		if (bytesWritten != uavo->desc->numBytes) {
+			xSemaphoreGiveRecursive(lock);
 			xSemaphoreGiveRecursive(mutex);
 			return -1;
 		}
 	}
 	// Done
+	xSemaphoreGiveRecursive(lock);
 	xSemaphoreGiveRecursive(mutex);
 	return 0;
 }
@@ -759,7 +1077,7 @@ int32_t UAVObjSave(UAVObjHandle obj_handle, uint16_t instId)
 {
 	PIOS_Assert(obj_handle);
 
-#if defined(PIOS_INCLUDE_FLASH_SECTOR_SETTINGS)
+#if defined(PIOS_INCLUDE_FLASH_SECTOR_SETTINGS) || defined(PIOS_INCLUDE_FLASH_LOGFS_SETTINGS)
 	if (UAVObjIsMetaobject(obj_handle)) {
 		if (instId != 0)
 			return -1;
@@ -865,11 +1183,16 @@ UAVObjHandle UAVObjLoadFromFile(FILEINFO * file)
 	}
 	objEntry = (struct UAVOBase *) obj_handle;
 
+	// Lock the object as well
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
+
 	// Get the instance ID
 	instId = 0;
 	if (!UAVObjIsSingleInstance(obj_handle)) {
 		if (PIOS_FREAD
 			(file, &instId, sizeof(instId), &bytesRead)) {
+			xSemaphoreGiveRecursive(lock);
 			xSemaphoreGiveRecursive(mutex);
 			return NULL;
 		}
@@ -879,12 +1202,14 @@ UAVObjHandle UAVObjLoadFromFile(FILEINFO * file)
 		// If the instance does not exist create it and any other instances before it
 		if (instId != 0) {
 			// Error, unlock and return
+			xSemaphoreGiveRecursive(lock);
 			xSemaphoreGiveRecursive(mutex);
 			return NULL;
 		}
 		// Read the instance data
 		if (PIOS_FREAD
 			(file, MetaDataPtr((struct UAVOMeta *)obj_handle), MetaNumBytes, &bytesRead)) {
+			xSemaphoreGiveRecursive(lock);
 			xSemaphoreGiveRecursive(mutex);
 			return NULL;
 		}
@@ -898,13 +1223,18 @@ UAVObjHandle UAVObjLoadFromFile(FILEINFO * file)
 			instEntry = createInstance((struct UAVOData *)objEntry, instId);
 			if (instEntry == NULL) {
 				// Error, unlock and return
+				xSemaphoreGiveRecursive(lock);
 				xSemaphoreGiveRecursive(mutex);
 				return NULL;
 			}
 		}
 		// Read the instance data
-		if (PIOS_FREAD
-			(file, InstanceData(instEntry), ((struct UAVOData *)objEntry)->instance_size, &bytesRead)) {
+		beginWrite(obj_handle, instEntry);
+		int32_t readError = PIOS_FREAD
+			(file, InstanceData(instEntry), ((struct UAVOData *)objEntry)->desc->numBytes, &bytesRead);
+		endWrite(obj_handle, instEntry, UAVOBJ_ALL_FIELDS);
+		if (readError) {
+			xSemaphoreGiveRecursive(lock);
 			xSemaphoreGiveRecursive(mutex);
 			return NULL;
 		}
@@ -915,6 +1245,7 @@ UAVObjHandle UAVObjLoadFromFile(FILEINFO * file)
 	sendEvent(objEntry, instId, EV_UNPACKED);
 
 	// Unlock
+	xSemaphoreGiveRecursive(lock);
 	xSemaphoreGiveRecursive(mutex);
 	return obj_handle;
 }
@@ -932,7 +1263,7 @@ int32_t UAVObjLoad(UAVObjHandle obj_handle, uint16_t instId)
 {
 	PIOS_Assert(obj_handle);
 
-#if defined(PIOS_INCLUDE_FLASH_SECTOR_SETTINGS)
+#if defined(PIOS_INCLUDE_FLASH_SECTOR_SETTINGS) || defined(PIOS_INCLUDE_FLASH_LOGFS_SETTINGS)
 	if (UAVObjIsMetaobject(obj_handle)) {
 		if (instId != 0)
 			return -1;
@@ -949,10 +1280,18 @@ int32_t UAVObjLoad(UAVObjHandle obj_handle, uint16_t instId)
 		if (instEntry == NULL)
 			return -1;
 
+		// Load with the object locked so readers see a consistent copy
+		xSemaphoreHandle lock = objectLock(obj_handle);
+		xSemaphoreTakeRecursive(lock, portMAX_DELAY);
+		beginWrite(obj_handle, instEntry);
+		int32_t loadError = PIOS_FLASHFS_ObjLoad(obj_handle, instId, InstanceData(instEntry));
+		endWrite(obj_handle, instEntry, UAVOBJ_ALL_FIELDS);
+
 		// Fire event on success
-		if (PIOS_FLASHFS_ObjLoad(obj_handle, instId, InstanceData(instEntry)) == 0)
+		if (loadError == 0)
 			sendEvent((struct UAVOBase*)obj_handle, instId, EV_UNPACKED);
-		else
+		xSemaphoreGiveRecursive(lock);
+		if (loadError != 0)
 			return -1;
 	}
 #elif defined(PIOS_INCLUDE_FLASH_COMPACT_SETTINGS)
@@ -972,10 +1311,18 @@ int32_t UAVObjLoad(UAVObjHandle obj_handle, uint16_t instId)
 		if (instEntry == NULL)
 			return -1;
 
+		// Load with the object locked so readers see a consistent copy
+		xSemaphoreHandle lock = objectLock(obj_handle);
+		xSemaphoreTakeRecursive(lock, portMAX_DELAY);
+		beginWrite(obj_handle, instEntry);
+		int32_t loadError = PIOS_FLASHFS_Compact_ObjLoad(obj_handle, instId, InstanceData(instEntry));
+		endWrite(obj_handle, instEntry, UAVOBJ_ALL_FIELDS);
+
 		// Fire event on success
-		if (PIOS_FLASHFS_Compact_ObjLoad(obj_handle, instId, InstanceData(instEntry)) == 0)
+		if (loadError == 0)
 			sendEvent((struct UAVOBase*)obj_handle, instId, EV_UNPACKED);
-		else
+		xSemaphoreGiveRecursive(lock);
+		if (loadError != 0)
 			return -1;
 	}
 #endif
@@ -1029,7 +1376,7 @@ int32_t UAVObjLoad(UAVObjHandle obj_handle, uint16_t instId)
 int32_t UAVObjDelete(UAVObjHandle obj_handle, uint16_t instId)
 {
 	PIOS_Assert(obj_handle);
-#if defined(PIOS_INCLUDE_FLASH_SECTOR_SETTINGS)
+#if defined(PIOS_INCLUDE_FLASH_SECTOR_SETTINGS) || defined(PIOS_INCLUDE_FLASH_LOGFS_SETTINGS)
 	PIOS_FLASHFS_ObjDelete(obj_handle, instId);
 #elif defined(PIOS_INCLUDE_FLASH_COMPACT_SETTINGS)
 	PIOS_FLASHFS_Compact_ObjDelete(obj_handle, instId);
@@ -1057,7 +1404,10 @@ int32_t UAVObjDelete(UAVObjHandle obj_handle, uint16_t instId)
 }
 
 /**
- * Save all settings objects to the SD card.
+ * Save all settings objects to the file system.
+ * This is not a batched transaction, every object is saved on its own with
+ * UAVObjSave(). The flash file systems skip objects whose stored copy is
+ * unchanged, so only the changed ones are erased and written.
  * @return 0 if success or -1 if failure
  */
 int32_t UAVObjSaveSettings()
@@ -1067,29 +1417,30 @@ int32_t UAVObjSaveSettings()
 	// Get lock
 	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
 
-	int32_t rc = -1;
+	int32_t rc = 0;
 
-	// Save all settings objects
-	LL_FOREACH(uavo_list, obj) {
+	// Save all settings objects, one that fails does not stop the others
+	// from being saved
+	UAVO_FOREACH(obj) {
 		// Check if this is a settings object
 		if (UAVObjIsSettings(obj)) {
 			// Save object
 			if (UAVObjSave((UAVObjHandle) obj, 0) ==
 				-1) {
-				goto unlock_exit;
+				rc = -1;
 			}
 		}
 	}
 
-	rc = 0;
-
-unlock_exit:
 	xSemaphoreGiveRecursive(mutex);
 	return rc;
 }
 
 /**
- * Load all settings objects from the SD card.
+ * Load all settings objects from the file system.
+ * Every object is looked up and loaded on its own with UAVObjLoad(), this is
+ * not a single pass over the stored data. The table based file systems answer
+ * the lookup of an object that was never saved without reading the flash.
  * @return 0 if success or -1 if failure
  */
 int32_t UAVObjLoadSettings()
@@ -1102,7 +1453,7 @@ int32_t UAVObjLoadSettings()
 	int32_t rc = -1;
 
 	// Load all settings objects
-	LL_FOREACH(uavo_list, obj) {
+	UAVO_FOREACH(obj) {
 		// Check if this is a settings object
 		if (UAVObjIsSettings(obj)) {
 			// Load object
@@ -1134,7 +1485,7 @@ int32_t UAVObjDeleteSettings()
 	int32_t rc = -1;
 
 	// Save all settings objects
-	LL_FOREACH(uavo_list, obj) {
+	UAVO_FOREACH(obj) {
 		// Check if this is a settings object
 		if (UAVObjIsSettings(obj)) {
 			// Save object
@@ -1166,7 +1517,7 @@ int32_t UAVObjSaveMetaobjects()
 	int32_t rc = -1;
 
 	// Save all settings objects
-	LL_FOREACH(uavo_list, obj) {
+	UAVO_FOREACH(obj) {
 		// Save object
 		if (UAVObjSave( (UAVObjHandle) MetaObjectPtr(obj), 0) ==
 			-1) {
@@ -1195,7 +1546,7 @@ int32_t UAVObjLoadMetaobjects()
 	int32_t rc = -1;
 
 	// Load all settings objects
-	LL_FOREACH(uavo_list, obj) {
+	UAVO_FOREACH(obj) {
 		// Load object
 		if (UAVObjLoad((UAVObjHandle) MetaObjectPtr(obj), 0) ==
 			-1) {
@@ -1224,7 +1575,7 @@ int32_t UAVObjDeleteMetaobjects()
 	int32_t rc = -1;
 
 	// Load all settings objects
-	LL_FOREACH(uavo_list, obj) {
+	UAVO_FOREACH(obj) {
 		// Load object
 		if (UAVObjDelete((UAVObjHandle) MetaObjectPtr(obj), 0)
 			== -1) {
@@ -1258,7 +1609,21 @@ int32_t UAVObjSetData(UAVObjHandle obj_handle, const void *dataIn)
  */
 int32_t UAVObjSetDataField(UAVObjHandle obj_handle, const void* dataIn, uint32_t offset, uint32_t size)
 {
-	return UAVObjSetInstanceDataField(obj_handle, 0, dataIn, offset, size);
+	return UAVObjSetInstanceDataFieldMask(obj_handle, 0, dataIn, offset, size, UAVOBJ_ALL_FIELDS);
+}
+
+/**
+ * Set a field of the object data and mark only that field as changed
+ * \param[in] obj The object handle
+ * \param[in] dataIn The field data
+ * \param[in] offset Offset of the field in the object data
+ * \param[in] size Size of the field
+ * \param[in] fieldMask The generated <object>_<field>_FIELDMASK of the field
+ * \return 0 if success or -1 if failure
+ */
+int32_t UAVObjSetDataFieldMask(UAVObjHandle obj_handle, const void* dataIn, uint32_t offset, uint32_t size, uint32_t fieldMask)
+{
+	return UAVObjSetInstanceDataFieldMask(obj_handle, 0, dataIn, offset, size, fieldMask);
 }
 
 /**
@@ -1296,7 +1661,8 @@ int32_t UAVObjSetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
 	PIOS_Assert(obj_handle);
 
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 
 	int32_t rc = -1;
 
@@ -1322,7 +1688,9 @@ int32_t UAVObjSetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
 			goto unlock_exit;
 		}
 		// Set data
-		memcpy(InstanceData(instEntry), dataIn, obj->instance_size);
+		beginWrite(obj_handle, instEntry);
+		memcpy(InstanceData(instEntry), dataIn, obj->desc->numBytes);
+		endWrite(obj_handle, instEntry, UAVOBJ_ALL_FIELDS);
 	}
 
 	// Fire event
@@ -1330,7 +1698,7 @@ int32_t UAVObjSetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreGiveRecursive(lock);
 	return rc;
 }
 
@@ -1342,11 +1710,27 @@ unlock_exit:
  * \return 0 if success or -1 if failure
  */
 int32_t UAVObjSetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, const void* dataIn, uint32_t offset, uint32_t size)
+{
+	return UAVObjSetInstanceDataFieldMask(obj_handle, instId, dataIn, offset, size, UAVOBJ_ALL_FIELDS);
+}
+
+/**
+ * Set a field of a specific object instance and mark only that field as changed
+ * \param[in] obj The object handle
+ * \param[in] instId The object instance ID
+ * \param[in] dataIn The field data
+ * \param[in] offset Offset of the field in the object data
+ * \param[in] size Size of the field
+ * \param[in] fieldMask The generated <object>_<field>_FIELDMASK of the field
+ * \return 0 if success or -1 if failure
+ */
+int32_t UAVObjSetInstanceDataFieldMask(UAVObjHandle obj_handle, uint16_t instId, const void* dataIn, uint32_t offset, uint32_t size, uint32_t fieldMask)
 {
 	PIOS_Assert(obj_handle);
 
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 
 	int32_t rc = -1;
 
@@ -1382,12 +1766,14 @@ int32_t UAVObjSetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, con
 		}
 
 		// Check for overrun
-		if ((size + offset) > obj->instance_size) {
+		if ((size + offset) > obj->desc->numBytes) {
 			goto unlock_exit;
 		}
 
 		// Set data
+		beginWrite(obj_handle, instEntry);
 		memcpy(InstanceData(instEntry) + offset, dataIn, size);
+		endWrite(obj_handle, instEntry, fieldMask);
 	}
 
 
@@ -1396,7 +1782,7 @@ int32_t UAVObjSetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, con
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreGiveRecursive(lock);
 	return rc;
 }
 
@@ -1412,8 +1798,15 @@ int32_t UAVObjGetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
 {
 	PIOS_Assert(obj_handle);
 
+	// Single instance objects are usually read without waiting for a writer
+	if (!UAVObjIsMetaobject(obj_handle) &&
+		readUnlocked(obj_handle, instId, dataOut, 0, ((struct UAVOData *)obj_handle)->desc->numBytes)) {
+		return 0;
+	}
+
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 
 	int32_t rc = -1;
 
@@ -1437,13 +1830,13 @@ int32_t UAVObjGetInstanceData(UAVObjHandle obj_handle, uint16_t instId,
 			goto unlock_exit;
 		}
 		// Set data
-		memcpy(dataOut, InstanceData(instEntry), obj->instance_size);
+		memcpy(dataOut, InstanceData(instEntry), obj->desc->numBytes);
 	}
 
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreGiveRecursive(lock);
 	return rc;
 }
 
@@ -1458,8 +1851,14 @@ int32_t UAVObjGetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, voi
 {
 	PIOS_Assert(obj_handle);
 
+	// Single instance objects are usually read without waiting for a writer
+	if (readUnlocked(obj_handle, instId, dataOut, offset, size)) {
+		return 0;
+	}
+
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 
 	int32_t rc = -1;
 
@@ -1490,7 +1889,7 @@ int32_t UAVObjGetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, voi
 		}
 
 		// Check for overrun
-		if ((size + offset) > obj->instance_size) {
+		if ((size + offset) > obj->desc->numBytes) {
 			goto unlock_exit;
 		}
 		
@@ -1501,7 +1900,7 @@ int32_t UAVObjGetInstanceDataField(UAVObjHandle obj_handle, uint16_t instId, voi
 	rc = 0;
 
 unlock_exit:
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreGiveRecursive(lock);
 	return rc;
 }
 
@@ -1520,11 +1919,12 @@ int32_t UAVObjSetMetadata(UAVObjHandle obj_handle, const UAVObjMetadata * dataIn
 		return -1;
 	}
 
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 
 	UAVObjSetData((UAVObjHandle) MetaObjectPtr((struct UAVOData *)obj_handle), dataIn);
 
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreGiveRecursive(lock);
 	return 0;
 }
 
@@ -1539,7 +1939,8 @@ int32_t UAVObjGetMetadata(UAVObjHandle obj_handle, UAVObjMetadata * dataOut)
 	PIOS_Assert(obj_handle);
 
 	// Lock
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 
 	// Get metadata
 	if (UAVObjIsMetaobject(obj_handle)) {
@@ -1550,7 +1951,7 @@ int32_t UAVObjGetMetadata(UAVObjHandle obj_handle, UAVObjMetadata * dataOut)
 	}
 
 	// Unlock
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreGiveRecursive(lock);
 	return 0;
 }
 
@@ -1713,12 +2114,74 @@ int32_t UAVObjConnectQueue(UAVObjHandle obj_handle, xQueueHandle queue,
 	PIOS_Assert(obj_handle);
 	PIOS_Assert(queue);
 	int32_t res;
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
-	res = connectObj(obj_handle, queue, 0, eventMask);
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
+	res = connectObj(obj_handle, queue, 0, eventMask, 0, EVENT_PRIORITY_NORMAL);
+	xSemaphoreGiveRecursive(lock);
+	return res;
+}
+
+/**
+ * Connect an event queue to the object in coalescing mode, if the queue is already connected then the
+ * event mask is only updated. While an event of the object is waiting in the queue further events of the
+ * same type and instance are dropped instead of queued, the receiver reads the latest data anyway. This
+ * keeps high rate objects from filling the queue with redundant updates.
+ * Coalesced queues have to be read with UAVObjQueueReceive() so the pending event is released.
+ * \param[in] obj The object handle
+ * \param[in] queue The event queue
+ * \param[in] eventMask The event mask, if EV_MASK_ALL then all events are enabled (e.g. EV_UPDATED | EV_UPDATED_MANUAL)
+ * \return 0 if success or -1 if failure
+ */
+int32_t UAVObjConnectQueueCoalesced(UAVObjHandle obj_handle, xQueueHandle queue,
+			uint8_t eventMask)
+{
+	PIOS_Assert(obj_handle);
+	PIOS_Assert(queue);
+	int32_t res;
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
+	res = connectObj(obj_handle, queue, 0, eventMask, EVENT_FLAG_COALESCE, EVENT_PRIORITY_NORMAL);
+	xSemaphoreGiveRecursive(lock);
 	return res;
 }
 
+/**
+ * Receive an event from a queue, releases the pending event of coalesced connections
+ * so the next event of the object is queued again. Can be used on any event queue.
+ * \param[in] queue The event queue
+ * \param[out] ev The received event
+ * \param[in] timeout Ticks to wait for an event
+ * \return pdTRUE if an event was received, pdFALSE on timeout
+ */
+portBASE_TYPE UAVObjQueueReceive(xQueueHandle queue, UAVObjEvent * ev, portTickType timeout)
+{
+	PIOS_Assert(queue);
+	PIOS_Assert(ev);
+	if (xQueueReceive(queue, ev, timeout) != pdTRUE) {
+		return pdFALSE;
+	}
+	// Events pushed by other sources, e.g. the periodic event dispatcher, do not belong to any connection
+	if (ev->obj == NULL) {
+		return pdTRUE;
+	}
+
+	xSemaphoreHandle lock = objectLock(ev->obj);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
+	struct ObjectEventEntry *event;
+	LL_FOREACH(((struct UAVOBase *) ev->obj)->next_event, event) {
+		if (event->queue == queue && event->cb == 0) {
+			if ((event->flags & EVENT_FLAG_PENDING) != 0
+				&& event->pendingInstId == ev->instId
+				&& event->pendingEvent == ev->event) {
+				event->flags &= ~EVENT_FLAG_PENDING;
+			}
+			break;
+		}
+	}
+	xSemaphoreGiveRecursive(lock);
+	return pdTRUE;
+}
+
 /**
  * Disconnect an event queue from the object.
  * \param[in] obj The object handle
@@ -1730,9 +2193,10 @@ int32_t UAVObjDisconnectQueue(UAVObjHandle obj_handle, xQueueHandle queue)
 	PIOS_Assert(obj_handle);
 	PIOS_Assert(queue);
 	int32_t res;
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 	res = disconnectObj(obj_handle, queue, 0);
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreGiveRecursive(lock);
 	return res;
 }
 
@@ -1749,9 +2213,33 @@ int32_t UAVObjConnectCallback(UAVObjHandle obj_handle, UAVObjEventCallback cb,
 {
 	PIOS_Assert(obj_handle);
 	int32_t res;
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
-	res = connectObj(obj_handle, 0, cb, eventMask);
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
+	res = connectObj(obj_handle, 0, cb, eventMask, 0, EVENT_PRIORITY_NORMAL);
+	xSemaphoreGiveRecursive(lock);
+	return res;
+}
+
+/**
+ * Connect an event callback to the object like UAVObjConnectCallback(), the callback is invoked
+ * from the event dispatcher lane of the given priority. Time critical callbacks should use
+ * EVENT_PRIORITY_HIGH so they are not held up by slow ones, e.g. settings updates.
+ * \param[in] obj The object handle
+ * \param[in] cb The event callback
+ * \param[in] eventMask The event mask, if EV_MASK_ALL then all events are enabled (e.g. EV_UPDATED | EV_UPDATED_MANUAL)
+ * \param[in] priority The dispatcher lane, one of EventPriority
+ * \return 0 if success or -1 if failure
+ */
+int32_t UAVObjConnectCallbackPriority(UAVObjHandle obj_handle, UAVObjEventCallback cb,
+			uint8_t eventMask, uint8_t priority)
+{
+	PIOS_Assert(obj_handle);
+	PIOS_Assert(priority < EVENT_PRIORITY_NUM);
+	int32_t res;
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
+	res = connectObj(obj_handle, 0, cb, eventMask, 0, priority);
+	xSemaphoreGiveRecursive(lock);
 	return res;
 }
 
@@ -1765,9 +2253,10 @@ int32_t UAVObjDisconnectCallback(UAVObjHandle obj_handle, UAVObjEventCallback cb
 {
 	PIOS_Assert(obj_handle);
 	int32_t res;
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 	res = disconnectObj(obj_handle, 0, cb);
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreGiveRecursive(lock);
 	return res;
 }
 
@@ -1790,9 +2279,10 @@ void UAVObjRequestUpdate(UAVObjHandle obj_handle)
 void UAVObjRequestInstanceUpdate(UAVObjHandle obj_handle, uint16_t instId)
 {
 	PIOS_Assert(obj_handle);
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 	sendEvent((struct UAVOBase *) obj_handle, instId, EV_UPDATE_REQ);
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreGiveRecursive(lock);
 }
 
 /**
@@ -1812,9 +2302,62 @@ void UAVObjUpdated(UAVObjHandle obj_handle)
 void UAVObjInstanceUpdated(UAVObjHandle obj_handle, uint16_t instId)
 {
 	PIOS_Assert(obj_handle);
-	xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
 	sendEvent((struct UAVOBase *) obj_handle, instId, EV_UPDATED_MANUAL);
-	xSemaphoreGiveRecursive(mutex);
+	xSemaphoreGiveRecursive(lock);
+}
+
+/**
+ * Get the fields of an instance changed since they were last cleared. Every field
+ * is reported after a full update, unpack or load, only setters generated with
+ * a field mask narrow it down. Metaobjects always report all fields.
+ * \param[in] obj The object handle
+ * \param[in] instId The object instance ID
+ * \return Bit mask of the changed fields, see <object>_<field>_FIELDMASK
+ */
+uint32_t UAVObjGetDirtyFields(UAVObjHandle obj_handle, uint16_t instId)
+{
+	PIOS_Assert(obj_handle);
+
+	uint32_t fields = UAVOBJ_ALL_FIELDS;
+
+	if (!UAVObjIsMetaobject(obj_handle)) {
+		xSemaphoreHandle lock = objectLock(obj_handle);
+		xSemaphoreTakeRecursive(lock, portMAX_DELAY);
+		InstanceHandle instEntry = getInstance((struct UAVOData *)obj_handle, instId);
+		if (instEntry != NULL) {
+			fields = InstanceState(instEntry)->dirty;
+		}
+		xSemaphoreGiveRecursive(lock);
+	}
+	return fields;
+}
+
+/**
+ * Get and clear the changed fields of an instance in one step. The mask is
+ * shared, it is meant to be consumed by a single module such as the telemetry.
+ * \param[in] obj The object handle
+ * \param[in] instId The object instance ID
+ * \return Bit mask of the fields changed before the call
+ */
+uint32_t UAVObjClearDirtyFields(UAVObjHandle obj_handle, uint16_t instId)
+{
+	PIOS_Assert(obj_handle);
+
+	uint32_t fields = UAVOBJ_ALL_FIELDS;
+
+	if (!UAVObjIsMetaobject(obj_handle)) {
+		xSemaphoreHandle lock = objectLock(obj_handle);
+		xSemaphoreTakeRecursive(lock, portMAX_DELAY);
+		InstanceHandle instEntry = getInstance((struct UAVOData *)obj_handle, instId);
+		if (instEntry != NULL) {
+			fields = InstanceState(instEntry)->dirty;
+			InstanceState(instEntry)->dirty = 0;
+		}
+		xSemaphoreGiveRecursive(lock);
+	}
+	return fields;
 }
 
 /**
@@ -1831,7 +2374,7 @@ void UAVObjIterate(void (*iterator) (UAVObjHandle obj))
 
 	// Iterate through the list and invoke iterator for each object
 	struct UAVOData *obj;
-	LL_FOREACH(uavo_list, obj) {
+	UAVO_FOREACH(obj) {
 		(*iterator) ((UAVObjHandle) obj);
 		(*iterator) ((UAVObjHandle) &obj->metaObj);
 	}
@@ -1840,6 +2383,46 @@ void UAVObjIterate(void (*iterator) (UAVObjHandle obj))
 	xSemaphoreGiveRecursive(mutex);
 }
 
+#if defined(UAVOBJ_DIAGNOSTICS)
+/**
+ * Get the update and listener statistics of an object
+ * \param[in] obj The object handle
+ * \param[out] diagOut The statistics collected since the last clear
+ * \param[in] clear Restart the statistics
+ */
+void UAVObjGetDiagnostics(UAVObjHandle obj_handle, UAVObjDiagnostics * diagOut, bool clear)
+{
+	PIOS_Assert(obj_handle);
+	PIOS_Assert(diagOut);
+	struct UAVOBase * obj = (struct UAVOBase *) obj_handle;
+	xSemaphoreHandle lock = objectLock(obj_handle);
+	xSemaphoreTakeRecursive(lock, portMAX_DELAY);
+	// The callback time is recorded by the event task without the lock
+	portENTER_CRITICAL();
+	memcpy(diagOut, &obj->diag, sizeof(UAVObjDiagnostics));
+	if (clear) {
+		memset(&obj->diag, 0, sizeof(UAVObjDiagnostics));
+	}
+	portEXIT_CRITICAL();
+	xSemaphoreGiveRecursive(lock);
+}
+
+/**
+ * Record how long a callback on an object event ran, called by the event dispatcher
+ * \param[in] obj The object handle
+ * \param[in] timeUs The callback execution time
+ */
+void UAVObjRecordCallbackTime(UAVObjHandle obj_handle, uint32_t timeUs)
+{
+	struct UAVOBase * obj = (struct UAVOBase *) obj_handle;
+	portENTER_CRITICAL();
+	if (timeUs > obj->diag.callbackTimeMax) {
+		obj->diag.callbackTimeMax = timeUs;
+	}
+	portEXIT_CRITICAL();
+}
+#endif /* UAVOBJ_DIAGNOSTICS */
+
 /**
  * Send a triggered event to all event queues registered on the object.
  */
@@ -1853,6 +2436,12 @@ static int32_t sendEvent(struct UAVOBase * obj, uint16_t instId,
 		.instId = instId,
 	};
 
+#if defined(UAVOBJ_DIAGNOSTICS)
+	if (triggered_event != EV_UPDATE_REQ) {
+		++obj->diag.updates;
+	}
+#endif
+
 	// Go through each object and push the event message in the queue (if event is activated for the queue)
 	struct ObjectEventEntry *event;
 	LL_FOREACH(obj->next_event, event) {
@@ -1860,19 +2449,45 @@ static int32_t sendEvent(struct UAVOBase * obj, uint16_t instId,
 			|| (event->eventMask & triggered_event) != 0) {
 			// Send to queue if a valid queue is registered
 			if (event->queue) {
+				// Merge with the event still waiting in a coalesced queue
+				if ((event->flags & (EVENT_FLAG_COALESCE | EVENT_FLAG_PENDING)) == (EVENT_FLAG_COALESCE | EVENT_FLAG_PENDING)
+					&& event->pendingInstId == instId
+					&& event->pendingEvent == triggered_event) {
+					portENTER_CRITICAL();
+					++stats.eventsCoalesced;
+					portEXIT_CRITICAL();
 				// will not block
-				if (xQueueSend(event->queue, &msg, 0) != pdTRUE) {
+				} else if (xQueueSend(event->queue, &msg, 0) != pdTRUE) {
+					// Events of different stripes may be sent concurrently
+					portENTER_CRITICAL();
 					stats.lastQueueErrorID = UAVObjGetID(obj);
 					++stats.eventQueueErrors;
+					portEXIT_CRITICAL();
+				} else {
+#if defined(UAVOBJ_DIAGNOSTICS)
+					unsigned portBASE_TYPE waiting = uxQueueMessagesWaiting(event->queue);
+					if (waiting > obj->diag.queueHighWater) {
+						obj->diag.queueHighWater = (waiting > 0xFF) ? 0xFF : waiting;
+					}
+#endif
+					if ((event->flags & EVENT_FLAG_COALESCE) != 0
+						&& (event->flags & EVENT_FLAG_PENDING) == 0) {
+						// Only one event per connection is tracked, others are queued as usual
+						event->flags |= EVENT_FLAG_PENDING;
+						event->pendingInstId = instId;
+						event->pendingEvent = triggered_event;
+					}
 				}
 			}
 
 			// Invoke callback (from event task) if a valid one is registered
 			if (event->cb) {
 				// invoke callback from the event task, will not block
-				if (EventCallbackDispatch(&msg, event->cb) != pdTRUE) {
+				if (EventCallbackDispatchPriority(&msg, event->cb, event->priority) != pdTRUE) {
+					portENTER_CRITICAL();
 					++stats.eventCallbackErrors;
 					stats.lastCallbackErrorID = UAVObjGetID(obj);
+					portEXIT_CRITICAL();
 				}
 			}
 		}
@@ -1912,10 +2527,12 @@ static InstanceHandle createInstance(struct UAVOData * obj, uint16_t instId)
 	}
 
 	/* Create the actual instance */
-	instEntry = (struct UAVOMultiInst *) pvPortMalloc(sizeof(struct UAVOMultiInst)+obj->instance_size);
+	instEntry = (struct UAVOMultiInst *) poolAlloc(sizeof(struct UAVOMultiInst)+obj->desc->numBytes);
 	if (!instEntry)
 		return NULL;
-	memset(InstanceDataOffset(instEntry), 0, obj->instance_size);
+	memset(InstanceDataOffset(instEntry), 0, obj->desc->numBytes);
+	instEntry->state.dirty = UAVOBJ_ALL_FIELDS;
+	instEntry->state.seq   = 0;
 	LL_APPEND(( (struct UAVOMulti*)obj )->instance0.next, instEntry);
 
 	( (struct UAVOMulti*)obj )->num_instances++;
@@ -1927,6 +2544,66 @@ static InstanceHandle createInstance(struct UAVOData * obj, uint16_t instId)
 	return InstanceDataOffset(instEntry);
 }
 
+/**
+ * Mark the start of a change to the data of an instance, must be called with the
+ * object locked. The sequence is odd until endWrite().
+ */
+static void beginWrite(UAVObjHandle obj_handle, InstanceHandle instEntry)
+{
+	if (!UAVObjIsMetaobject(obj_handle)) {
+		InstanceState(instEntry)->seq++;
+		__sync_synchronize();
+	}
+}
+
+/**
+ * Mark the end of a change to the data of an instance and record the changed fields
+ */
+static void endWrite(UAVObjHandle obj_handle, InstanceHandle instEntry, uint32_t fieldMask)
+{
+	if (!UAVObjIsMetaobject(obj_handle)) {
+		__sync_synchronize();
+		InstanceState(instEntry)->seq++;
+		InstanceState(instEntry)->dirty |= fieldMask;
+	}
+}
+
+/**
+ * Copy the data of a single instance object without taking the lock. The copy is
+ * only kept if no write overlapped it. A reader never waits for a writer: if a
+ * lower priority task was preempted in the middle of a write the caller falls
+ * back to the locked copy, which lets priority inheritance finish the write.
+ * \return true if dataOut holds a consistent copy
+ */
+static bool readUnlocked(UAVObjHandle obj_handle, uint16_t instId, void * dataOut, uint32_t offset, uint32_t size)
+{
+	struct UAVOBase * uavo_base = (struct UAVOBase *) obj_handle;
+
+	// Instances of multi instance objects are found by walking a list, leave them to the locked path
+	if (uavo_base->flags.isMeta || !uavo_base->flags.isSingle || instId != 0) {
+		return false;
+	}
+
+	struct UAVOSingle * uavo_single = (struct UAVOSingle *) obj_handle;
+	if ((size + offset) > uavo_single->uavo.desc->numBytes) {
+		return false;
+	}
+
+	for (uint8_t attempt = 0; attempt < UAVOBJ_UNLOCKED_READ_ATTEMPTS; ++attempt) {
+		uint32_t seq = uavo_single->state.seq;
+		if (seq & 1) {
+			return false;
+		}
+		__sync_synchronize();
+		memcpy(dataOut, (uint8_t *) uavo_single->instance0 + offset, size);
+		__sync_synchronize();
+		if (uavo_single->state.seq == seq) {
+			return true;
+		}
+	}
+	return false;
+}
+
 /**
  * Get the instance information or NULL if the instance does not exist
  */
@@ -1978,10 +2655,12 @@ static InstanceHandle getInstance(struct UAVOData * obj, uint16_t instId)
  * \param[in] queue The event queue
  * \param[in] cb The event callback
  * \param[in] eventMask The event mask, if EV_MASK_ALL then all events are enabled (e.g. EV_UPDATED | EV_UPDATED_MANUAL)
+ * \param[in] flags The EVENT_FLAG_COALESCE flag for coalesced queues, 0 otherwise
+ * \param[in] priority The dispatcher lane of callbacks
  * \return 0 if success or -1 if failure
  */
 static int32_t connectObj(UAVObjHandle obj_handle, xQueueHandle queue,
-			UAVObjEventCallback cb, uint8_t eventMask)
+			UAVObjEventCallback cb, uint8_t eventMask, uint8_t flags, uint8_t priority)
 {
 	struct ObjectEventEntry *event;
 	struct UAVOBase *obj;
@@ -1992,18 +2671,27 @@ static int32_t connectObj(UAVObjHandle obj_handle, xQueueHandle queue,
 		if (event->queue == queue && event->cb == cb) {
 			// Already connected, update event mask and return
 			event->eventMask = eventMask;
+			event->priority = priority;
+			if ((flags & EVENT_FLAG_COALESCE) != 0) {
+				flags |= (event->flags & EVENT_FLAG_PENDING);
+			}
+			event->flags = flags;
 			return 0;
 		}
 	}
 
 	// Add queue to list
-	event =	(struct ObjectEventEntry *) pvPortMalloc(sizeof(struct ObjectEventEntry));
+	event = allocEventEntry();
 	if (event == NULL) {
 		return -1;
 	}
 	event->queue = queue;
 	event->cb = cb;
 	event->eventMask = eventMask;
+	event->flags = flags;
+	event->pendingInstId = 0;
+	event->pendingEvent = 0;
+	event->priority = priority;
 	LL_APPEND(obj->next_event, event);
 
 	// Done
@@ -2029,7 +2717,7 @@ static int32_t disconnectObj(UAVObjHandle obj_handle, xQueueHandle queue,
 		if ((event->queue == queue
 				&& event->cb == cb)) {
 			LL_DELETE(obj->next_event, event);
-			vPortFree(event);
+			freeEventEntry(event);
 			return 0;
 		}
 	}
@@ -69,33 +69,20 @@ int32_t $(NAME)Initialize(void)
 }
 
 /**
- * Initialize object fields and metadata with the default values.
+ * Initialize object fields with the default values.
  * If a default value is not specified the object fields
- * will be initialized to zero.
+ * will be initialized to zero. The default metadata is part of
+ * the object descriptor in flash and set by UAVObjRegister().
  */
 void $(NAME)SetDefaults(UAVObjHandle obj, uint16_t instId)
 {
 	$(NAME)Data data;
-	UAVObjMetadata metadata;
 
 	// Initialize object fields to their default values
 	UAVObjGetInstanceData(obj, instId, &data);
 	memset(&data, 0, sizeof($(NAME)Data));
 $(INITFIELDS)
 	UAVObjSetInstanceData(obj, instId, &data);
-
-	// Initialize object metadata to their default values
-	metadata.flags =
-		$(FLIGHTACCESS) << UAVOBJ_ACCESS_SHIFT |
-		$(GCSACCESS) << UAVOBJ_GCS_ACCESS_SHIFT |
-		$(FLIGHTTELEM_ACKED) << UAVOBJ_TELEMETRY_ACKED_SHIFT |
-		$(GCSTELEM_ACKED) << UAVOBJ_GCS_TELEMETRY_ACKED_SHIFT |
-		$(FLIGHTTELEM_UPDATEMODE) << UAVOBJ_TELEMETRY_UPDATE_MODE_SHIFT |
-		$(GCSTELEM_UPDATEMODE) << UAVOBJ_GCS_TELEMETRY_UPDATE_MODE_SHIFT;
-	metadata.telemetryUpdatePeriod = $(FLIGHTTELEM_UPDATEPERIOD);
-	metadata.gcsTelemetryUpdatePeriod = $(GCSTELEM_UPDATEPERIOD);
-	metadata.loggingUpdatePeriod = $(LOGGING_UPDATEPERIOD);
-	UAVObjSetMetadata(obj, &metadata);
 }
 
 /**
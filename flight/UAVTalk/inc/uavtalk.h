@@ -31,6 +31,10 @@
 
 // Public types
 typedef int32_t (*UAVTalkOutputStream)(uint8_t* data, int32_t length);
+// Packets are written straight into the output stream's buffer: reserve returns length
+// or -2 when the packet can never fit (it is sent through the UAVTalkOutputStream instead)
+typedef int32_t (*UAVTalkOutputReserve)(uint8_t** data, int32_t length);
+typedef int32_t (*UAVTalkOutputCommit)(int32_t length);
 
 typedef struct {
     uint32_t txBytes;
@@ -45,18 +49,31 @@ typedef struct {
 
 typedef void* UAVTalkConnection;
 
+// Capability bits advertised in FlightTelemetryCapabilities/GCSTelemetryCapabilities
+#define UAVTALK_CAPABILITY_MULTIOBJECT 0x01
+#define UAVTALK_CAPABILITY_DELTA       0x02
+#define UAVTALK_CAPABILITY_PING        0x04
+#define UAVTALK_CAPABILITIES           (UAVTALK_CAPABILITY_MULTIOBJECT | UAVTALK_CAPABILITY_DELTA | UAVTALK_CAPABILITY_PING)
+
 typedef enum {UAVTALK_STATE_ERROR=0, UAVTALK_STATE_SYNC, UAVTALK_STATE_TYPE, UAVTALK_STATE_SIZE, UAVTALK_STATE_OBJID, UAVTALK_STATE_INSTID, UAVTALK_STATE_DATA, UAVTALK_STATE_CS, UAVTALK_STATE_COMPLETE} UAVTalkRxState;
 
 // Public functions
 UAVTalkConnection UAVTalkInitialize(UAVTalkOutputStream outputStream);
+UAVTalkConnection UAVTalkInitializeReserve(UAVTalkOutputStream outputStream, UAVTalkOutputReserve outputReserve, UAVTalkOutputCommit outputCommit);
 int32_t UAVTalkSetOutputStream(UAVTalkConnection connection, UAVTalkOutputStream outputStream);
 UAVTalkOutputStream UAVTalkGetOutputStream(UAVTalkConnection connection);
 int32_t UAVTalkSendObject(UAVTalkConnection connection, UAVObjHandle obj, uint16_t instId, uint8_t acked, int32_t timeoutMs);
+int32_t UAVTalkSendObjectAggregated(UAVTalkConnection connection, UAVObjHandle obj, uint16_t instId);
+int32_t UAVTalkFlushAggregated(UAVTalkConnection connection);
+int32_t UAVTalkSendObjectDelta(UAVTalkConnection connection, UAVObjHandle obj, uint16_t instId, uint8_t keyframe, uint8_t aggregated);
 int32_t UAVTalkSendObjectRequest(UAVTalkConnection connection, UAVObjHandle obj, uint16_t instId, int32_t timeoutMs);
 int32_t UAVTalkSendAck(UAVTalkConnection connectionHandle, UAVObjHandle obj, uint16_t instId);
 int32_t UAVTalkSendNack(UAVTalkConnection connectionHandle, uint32_t objId);
+uint16_t UAVTalkPacketLength(UAVObjHandle obj);
+int32_t UAVTalkPackObject(UAVObjHandle obj, uint16_t instId, uint8_t *buf);
 UAVTalkRxState UAVTalkProcessInputStream(UAVTalkConnection connection, uint8_t rxbyte);
 UAVTalkRxState UAVTalkProcessInputStreamQuiet(UAVTalkConnection connection, uint8_t rxbyte);
+UAVTalkRxState UAVTalkProcessInputBuffer(UAVTalkConnection connection, const uint8_t *buf, uint16_t len);
 void UAVTalkGetStats(UAVTalkConnection connection, UAVTalkStats *stats);
 void UAVTalkResetStats(UAVTalkConnection connection);
 
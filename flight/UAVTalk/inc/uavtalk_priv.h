@@ -54,6 +54,7 @@ typedef uint8_t uavtalk_checksum;
 #define UAVTALK_MAX_PAYLOAD_LENGTH      (UAVOBJECTS_LARGEST + 1)
 #define UAVTALK_MIN_PACKET_LENGTH	UAVTALK_MAX_HEADER_LENGTH + UAVTALK_CHECKSUM_LENGTH
 #define UAVTALK_MAX_PACKET_LENGTH       UAVTALK_MIN_PACKET_LENGTH + UAVTALK_MAX_PAYLOAD_LENGTH
+#define UAVTALK_MAX_MULTI_SIZE          (UAVTALK_MAX_HEADER_LENGTH + UAVTALK_MAX_PAYLOAD_LENGTH)
 
 typedef struct {
     UAVObjHandle obj;
@@ -72,6 +73,8 @@ typedef struct {
 typedef struct {
     uint8_t canari;
     UAVTalkOutputStream outStream;
+    UAVTalkOutputReserve outReserve;
+    UAVTalkOutputCommit outCommit;
     xSemaphoreHandle lock;
     xSemaphoreHandle transLock;
     xSemaphoreHandle respSema;
@@ -82,6 +85,10 @@ typedef struct {
     uint8_t *rxBuffer;
     uint32_t txSize;
     uint8_t *txBuffer;
+    uint8_t *txMultiBuffer;
+    uint16_t txMultiLength;
+    uint16_t txMultiObjects;
+    uint16_t txMultiObjectBytes;
 } UAVTalkConnectionData;
 
 #define UAVTALK_CANARI         0xCA
@@ -95,6 +102,9 @@ typedef struct {
 #define UAVTALK_TYPE_OBJ_ACK   (UAVTALK_TYPE_VER | 0x02)
 #define UAVTALK_TYPE_ACK       (UAVTALK_TYPE_VER | 0x03)
 #define UAVTALK_TYPE_NACK      (UAVTALK_TYPE_VER | 0x04)
+#define UAVTALK_TYPE_OBJ_MULTI (UAVTALK_TYPE_VER | 0x05)
+#define UAVTALK_TYPE_OBJ_DELTA (UAVTALK_TYPE_VER | 0x06)
+#define UAVTALK_DELTA_MASK_LENGTH 4
 
 //macros
 #define CHECKCONHANDLE(handle,variable,failcommand) \
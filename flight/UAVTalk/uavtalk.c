@@ -38,7 +38,14 @@ static int32_t objectTransaction(UAVTalkConnectionData *connection, UAVObjHandle
 static int32_t sendObject(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId, uint8_t type);
 static int32_t sendSingleObject(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId, uint8_t type);
 static int32_t sendNack(UAVTalkConnectionData *connection, uint32_t objId);
+static int32_t packObject(UAVObjHandle obj, uint16_t instId, uint8_t type, uint8_t *buf, int32_t length);
+static int32_t appendMultiObject(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId);
+static int32_t flushMultiObject(UAVTalkConnectionData *connection);
+static int32_t sendDeltaObject(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId, uint8_t keyframe, uint8_t aggregated);
+static uint8_t * txReserve(UAVTalkConnectionData *connection, uint16_t length);
+static int32_t txCommit(UAVTalkConnectionData *connection, uint8_t *buf, uint16_t length);
 static int32_t receiveObject(UAVTalkConnectionData *connection, uint8_t type, uint32_t objId, uint16_t instId, uint8_t* data, int32_t length);
+static int32_t receiveMultiObject(UAVTalkConnectionData *connection, uint8_t* data, int32_t length);
 static void updateAck(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId);
 
 /**
@@ -49,6 +56,21 @@ static void updateAck(UAVTalkConnectionData *connection, UAVObjHandle obj, uint1
  * \return -1 Failure
  */
 UAVTalkConnection UAVTalkInitialize(UAVTalkOutputStream outputStream)
+{
+	return UAVTalkInitializeReserve(outputStream, NULL, NULL);
+}
+
+/**
+ * Initialize the UAVTalk library for an output stream that can take
+ * packets in place. Packets are then serialized straight into its buffer,
+ * the packet buffer is only allocated if a packet does not fit there.
+ * \param[in] outputStream Function pointer that is called to send a data buffer
+ * \param[in] outputReserve Function pointer that is called to get room for a packet
+ * \param[in] outputCommit Function pointer that is called to send the packet written to that room
+ * \return The new connection
+ * \return 0 Failure
+ */
+UAVTalkConnection UAVTalkInitializeReserve(UAVTalkOutputStream outputStream, UAVTalkOutputReserve outputReserve, UAVTalkOutputCommit outputCommit)
 {
 	// allocate object
 	UAVTalkConnectionData * connection = pvPortMalloc(sizeof(UAVTalkConnectionData));
@@ -57,13 +79,22 @@ UAVTalkConnection UAVTalkInitialize(UAVTalkOutputStream outputStream)
 	connection->iproc.rxPacketLength = 0;
 	connection->iproc.state = UAVTALK_STATE_SYNC;
 	connection->outStream = outputStream;
+	connection->outReserve = outputReserve;
+	connection->outCommit = outputCommit;
 	connection->lock = xSemaphoreCreateRecursiveMutex();
 	connection->transLock = xSemaphoreCreateRecursiveMutex();
 	// allocate buffers
 	connection->rxBuffer = pvPortMalloc(UAVTALK_MAX_PACKET_LENGTH);
 	if (!connection->rxBuffer) return 0;
-	connection->txBuffer = pvPortMalloc(UAVTALK_MAX_PACKET_LENGTH);
-	if (!connection->txBuffer) return 0;
+	connection->txBuffer = NULL;
+	if (!outputReserve) {
+		connection->txBuffer = pvPortMalloc(UAVTALK_MAX_PACKET_LENGTH);
+		if (!connection->txBuffer) return 0;
+	}
+	connection->txMultiBuffer = NULL;
+	connection->txMultiLength = 0;
+	connection->txMultiObjects = 0;
+	connection->txMultiObjectBytes = 0;
 	vSemaphoreCreateBinary(connection->respSema);
 	xSemaphoreTake(connection->respSema, 0); // reset to zero
 	UAVTalkResetStats( (UAVTalkConnection) connection );
@@ -189,6 +220,119 @@ int32_t UAVTalkSendObject(UAVTalkConnection connectionHandle, UAVObjHandle obj,
 	}
 }
 
+/**
+ * Queue an unacked object update into a multi-object frame.
+ * The frame is sent once it is full, when any other packet has to go out or
+ * when UAVTalkFlushAggregated() is called. Only use this if the other end
+ * advertised UAVTALK_CAPABILITY_MULTIOBJECT.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] obj Object to send
+ * \param[in] instId The instance ID or UAVOBJ_ALL_INSTANCES for all instances.
+ * \return 0 Success
+ * \return -1 Failure
+ */
+int32_t UAVTalkSendObjectAggregated(UAVTalkConnection connectionHandle, UAVObjHandle obj, uint16_t instId)
+{
+	UAVTalkConnectionData *connection;
+	uint32_t numInst;
+	uint32_t n;
+	int32_t ret = 0;
+	CHECKCONHANDLE(connectionHandle,connection,return -1);
+
+	// If all instances are requested and this is a single instance object, force instance ID to zero
+	if (instId == UAVOBJ_ALL_INSTANCES && UAVObjIsSingleInstance(obj))
+	{
+		instId = 0;
+	}
+
+	xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
+	if (instId == UAVOBJ_ALL_INSTANCES)
+	{
+		numInst = UAVObjGetNumInstances(obj);
+		for (n = 0; n < numInst; ++n)
+		{
+			if (appendMultiObject(connection, obj, n) < 0)
+			{
+				ret = -1;
+			}
+		}
+	}
+	else
+	{
+		ret = appendMultiObject(connection, obj, instId);
+	}
+	xSemaphoreGiveRecursive(connection->lock);
+
+	return ret;
+}
+
+/**
+ * Send the pending multi-object frame, if any.
+ * \param[in] connection UAVTalkConnection to be used
+ * \return 0 Success
+ * \return -1 Failure
+ */
+int32_t UAVTalkFlushAggregated(UAVTalkConnection connectionHandle)
+{
+	UAVTalkConnectionData *connection;
+	int32_t ret;
+	CHECKCONHANDLE(connectionHandle,connection,return -1);
+
+	xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
+	ret = flushMultiObject(connection);
+	xSemaphoreGiveRecursive(connection->lock);
+
+	return ret;
+}
+
+/**
+ * Send an unacked object update holding only the fields changed since the last
+ * delta or keyframe of the object, as told by UAVObjClearDirtyFields(). The full
+ * object goes out instead for keyframes and whenever the delta would not be
+ * smaller. Only use this if the other end advertised UAVTALK_CAPABILITY_DELTA.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] obj Object to send
+ * \param[in] instId The instance ID or UAVOBJ_ALL_INSTANCES for all instances.
+ * \param[in] keyframe Send the full object, the receiver resyncs on these
+ * \param[in] aggregated Full objects are queued into multi-object frames
+ * \return 0 Success
+ * \return -1 Failure
+ */
+int32_t UAVTalkSendObjectDelta(UAVTalkConnection connectionHandle, UAVObjHandle obj, uint16_t instId, uint8_t keyframe, uint8_t aggregated)
+{
+	UAVTalkConnectionData *connection;
+	uint32_t numInst;
+	uint32_t n;
+	int32_t ret = 0;
+	CHECKCONHANDLE(connectionHandle,connection,return -1);
+
+	// If all instances are requested and this is a single instance object, force instance ID to zero
+	if (instId == UAVOBJ_ALL_INSTANCES && UAVObjIsSingleInstance(obj))
+	{
+		instId = 0;
+	}
+
+	xSemaphoreTakeRecursive(connection->lock, portMAX_DELAY);
+	if (instId == UAVOBJ_ALL_INSTANCES)
+	{
+		numInst = UAVObjGetNumInstances(obj);
+		for (n = 0; n < numInst; ++n)
+		{
+			if (sendDeltaObject(connection, obj, n, keyframe, aggregated) < 0)
+			{
+				ret = -1;
+			}
+		}
+	}
+	else
+	{
+		ret = sendDeltaObject(connection, obj, instId, keyframe, aggregated);
+	}
+	xSemaphoreGiveRecursive(connection->lock);
+
+	return ret;
+}
+
 /**
  * Execute the requested transaction on an object.
  * \param[in] connection UAVTalkConnection to be used
@@ -324,6 +468,17 @@ UAVTalkRxState UAVTalkProcessInputStreamQuiet(UAVTalkConnection connectionHandle
 			
 			iproc->rxCount = 0;
 			iproc->objId = 0;
+
+			// Multi-object frames carry their object IDs inside the payload
+			if (iproc->type == UAVTALK_TYPE_OBJ_MULTI)
+			{
+				iproc->obj = 0;
+				iproc->instId = 0;
+				iproc->length = iproc->packet_size - iproc->rxPacketLength;
+				iproc->state = UAVTALK_STATE_DATA;
+				break;
+			}
+
 			iproc->state = UAVTALK_STATE_OBJID;
 			break;
 			
@@ -489,6 +644,50 @@ UAVTalkRxState UAVTalkProcessInputStream(UAVTalkConnection connectionHandle, uin
 	return state;
 }
 
+/**
+ * Process a block of bytes from the telemetry stream, completed objects are
+ * received like with UAVTalkProcessInputStream(). Payload bytes are copied
+ * and added to the CRC in runs instead of one at a time.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] buf Received bytes
+ * \param[in] len Number of bytes in buf
+ * \return UAVTalkRxState after the last byte
+ */
+UAVTalkRxState UAVTalkProcessInputBuffer(UAVTalkConnection connectionHandle, const uint8_t *buf, uint16_t len)
+{
+	UAVTalkConnectionData *connection;
+	CHECKCONHANDLE(connectionHandle,connection,return -1);
+
+	UAVTalkInputProcessor *iproc = &connection->iproc;
+	UAVTalkRxState state = iproc->state;
+
+	while (len > 0)
+	{
+		// The last payload byte goes through the state machine to move on to the checksum
+		if (iproc->state == UAVTALK_STATE_DATA && (uint32_t)iproc->rxCount + 1 < iproc->length)
+		{
+			uint32_t run = iproc->length - iproc->rxCount - 1;
+			if (run > len)
+				run = len;
+
+			memcpy(&connection->rxBuffer[iproc->rxCount], buf, run);
+			iproc->cs = PIOS_CRC_updateCRC(iproc->cs, buf, run);
+			iproc->rxCount += run;
+			iproc->rxPacketLength += run;
+			connection->stats.rxBytes += run;
+
+			buf += run;
+			len -= run;
+			continue;
+		}
+
+		state = UAVTalkProcessInputStream(connectionHandle, *buf++);
+		len--;
+	}
+
+	return state;
+}
+
 /**
  * Send a ACK through the telemetry link.
  * \param[in] connectionHandle UAVTalkConnection to be used
@@ -504,6 +703,85 @@ int32_t UAVTalkSendAck(UAVTalkConnection connectionHandle, UAVObjHandle obj, uin
 	return sendObject(connection, obj, instId, UAVTALK_TYPE_ACK);
 }
 
+/**
+ * Frame an object into a packet
+ * \param[in] obj Object handle to pack
+ * \param[in] instId The instance ID
+ * \param[in] type Transaction type
+ * \param[out] buf Packet buffer, UAVTalkPacketLength() bytes for the object
+ * \param[in] length Number of data bytes, 0 for requests and acks
+ * \return 0 Success
+ * \return -1 Failure
+ */
+static int32_t packObject(UAVObjHandle obj, uint16_t instId, uint8_t type, uint8_t *buf, int32_t length)
+{
+	int32_t dataOffset = UAVObjIsSingleInstance(obj) ? 8 : 10;
+	uint32_t objId;
+
+	// Setup type and object id fields
+	objId = UAVObjGetID(obj);
+	buf[0] = UAVTALK_SYNC_VAL;  // sync byte
+	buf[1] = type;
+	// data length inserted here below
+	buf[4] = (uint8_t)(objId & 0xFF);
+	buf[5] = (uint8_t)((objId >> 8) & 0xFF);
+	buf[6] = (uint8_t)((objId >> 16) & 0xFF);
+	buf[7] = (uint8_t)((objId >> 24) & 0xFF);
+	
+	// Setup instance ID if one is required
+	if (!UAVObjIsSingleInstance(obj))
+	{
+		buf[8] = (uint8_t)(instId & 0xFF);
+		buf[9] = (uint8_t)((instId >> 8) & 0xFF);
+	}
+	
+	// Copy data (if any)
+	if (length > 0)
+	{
+		if ( UAVObjPack(obj, instId, &buf[dataOffset]) < 0 )
+		{
+			return -1;
+		}
+	}
+	
+	// Store the packet length
+	buf[2] = (uint8_t)((dataOffset+length) & 0xFF);
+	buf[3] = (uint8_t)(((dataOffset+length) >> 8) & 0xFF);
+	
+	// Calculate checksum
+	buf[dataOffset+length] = PIOS_CRC_updateCRC(0, buf, dataOffset+length);
+
+	return 0;
+}
+
+/**
+ * Length of the packet carrying an object instance
+ * \param[in] obj Object handle
+ * \return Packet length including the checksum
+ */
+uint16_t UAVTalkPacketLength(UAVObjHandle obj)
+{
+	return (UAVObjIsSingleInstance(obj) ? 8 : 10) + UAVObjGetNumBytes(obj) + UAVTALK_CHECKSUM_LENGTH;
+}
+
+/**
+ * Frame an object instance into a packet without sending it, e.g. to
+ * record it in a log
+ * \param[in] obj Object handle to pack
+ * \param[in] instId The instance ID
+ * \param[out] buf Packet buffer of UAVTalkPacketLength() bytes
+ * \return Packet length
+ * \return -1 Failure
+ */
+int32_t UAVTalkPackObject(UAVObjHandle obj, uint16_t instId, uint8_t *buf)
+{
+	if (packObject(obj, instId, UAVTALK_TYPE_OBJ, buf, UAVObjGetNumBytes(obj)) < 0)
+	{
+		return -1;
+	}
+	return UAVTalkPacketLength(obj);
+}
+
 /**
  * Send a NACK through the telemetry link.
  * \param[in] connectionHandle UAVTalkConnection to be used
@@ -522,7 +800,7 @@ int32_t UAVTalkSendNack(UAVTalkConnection connectionHandle, uint32_t objId)
 /**
  * Receive an object. This function process objects received through the telemetry stream.
  * \param[in] connection UAVTalkConnection to be used
- * \param[in] type Type of received message (UAVTALK_TYPE_OBJ, UAVTALK_TYPE_OBJ_REQ, UAVTALK_TYPE_OBJ_ACK, UAVTALK_TYPE_ACK, UAVTALK_TYPE_NACK)
+ * \param[in] type Type of received message (UAVTALK_TYPE_OBJ, UAVTALK_TYPE_OBJ_REQ, UAVTALK_TYPE_OBJ_ACK, UAVTALK_TYPE_ACK, UAVTALK_TYPE_NACK, UAVTALK_TYPE_OBJ_MULTI)
  * \param[in] objId ID of the object to work on
  * \param[in] instId The instance ID of UAVOBJ_ALL_INSTANCES for all instances.
  * \param[in] data Data buffer
@@ -597,6 +875,9 @@ static int32_t receiveObject(UAVTalkConnectionData *connection, uint8_t type, ui
 				ret = -1;
 			}
 			break;
+		case UAVTALK_TYPE_OBJ_MULTI:
+			ret = receiveMultiObject(connection, data, length);
+			break;
 		default:
 			ret = -1;
 	}
@@ -604,6 +885,63 @@ static int32_t receiveObject(UAVTalkConnectionData *connection, uint8_t type, ui
 	return ret;
 }
 
+/**
+ * Receive a multi-object frame. The payload is a sequence of records, each one
+ * an object ID, an instance ID (multi instance objects only) and the object data.
+ * Parsing stops at the first unknown object since its length is not known.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] data Frame payload
+ * \param[in] length Payload length
+ * \return 0 Success
+ * \return -1 Failure
+ */
+static int32_t receiveMultiObject(UAVTalkConnectionData *connection, uint8_t* data, int32_t length)
+{
+	UAVObjHandle obj;
+	uint32_t objId;
+	uint16_t instId;
+	int32_t instLength;
+	int32_t dataLength;
+	int32_t offset = 0;
+
+	while (offset < length)
+	{
+		if (length - offset < 4)
+		{
+			connection->stats.rxErrors++;
+			return -1;
+		}
+		objId = (uint32_t)data[offset] | ((uint32_t)data[offset+1] << 8) | ((uint32_t)data[offset+2] << 16) | ((uint32_t)data[offset+3] << 24);
+		obj = UAVObjGetByID(objId);
+		if (obj == 0)
+		{
+			connection->stats.rxErrors++;
+			return -1;
+		}
+		instLength = (UAVObjIsSingleInstance(obj) ? 0 : 2);
+		dataLength = UAVObjGetNumBytes(obj);
+		if (length - offset - 4 < instLength + dataLength)
+		{
+			connection->stats.rxErrors++;
+			return -1;
+		}
+		offset += 4;
+		instId = 0;
+		if (instLength > 0)
+		{
+			instId = (uint16_t)data[offset] | ((uint16_t)data[offset+1] << 8);
+			offset += instLength;
+		}
+
+		// Unpack object, if the instance does not exist it will be created!
+		UAVObjUnpack(obj, instId, &data[offset]);
+		updateAck(connection, obj, instId);
+		offset += dataLength;
+	}
+
+	return 0;
+}
+
 /**
  * Check if an ack is pending on an object and give response semaphore
  * \param[in] connection UAVTalkConnection to be used
@@ -692,33 +1030,15 @@ static int32_t sendSingleObject(UAVTalkConnectionData *connection, UAVObjHandle
 {
 	int32_t length;
 	int32_t dataOffset;
-	uint32_t objId;
+	uint8_t *buf;
 
 	if (!connection->outStream) return -1;
 
-	// Setup type and object id fields
-	objId = UAVObjGetID(obj);
-	connection->txBuffer[0] = UAVTALK_SYNC_VAL;  // sync byte
-	connection->txBuffer[1] = type;
-	// data length inserted here below
-	connection->txBuffer[4] = (uint8_t)(objId & 0xFF);
-	connection->txBuffer[5] = (uint8_t)((objId >> 8) & 0xFF);
-	connection->txBuffer[6] = (uint8_t)((objId >> 16) & 0xFF);
-	connection->txBuffer[7] = (uint8_t)((objId >> 24) & 0xFF);
-	
-	// Setup instance ID if one is required
-	if (UAVObjIsSingleInstance(obj))
-	{
-		dataOffset = 8;
-	}
-	else
-	{
-		connection->txBuffer[8] = (uint8_t)(instId & 0xFF);
-		connection->txBuffer[9] = (uint8_t)((instId >> 8) & 0xFF);
-		dataOffset = 10;
-	}
-	
-	// Determine data length
+	// Pending multi-object frame shares the transmit buffer, send it first
+	flushMultiObject(connection);
+
+	// Determine header and data length
+	dataOffset = UAVObjIsSingleInstance(obj) ? 8 : 10;
 	if (type == UAVTALK_TYPE_OBJ_REQ || type == UAVTALK_TYPE_ACK)
 	{
 		length = 0;
@@ -733,79 +1053,400 @@ static int32_t sendSingleObject(UAVTalkConnectionData *connection, UAVObjHandle
 	{
 		return -1;
 	}
+
+	uint16_t tx_msg_len = dataOffset+length+UAVTALK_CHECKSUM_LENGTH;
+	buf = txReserve(connection, tx_msg_len);
+	if (!buf)
+	{
+		return -1;
+	}
+
+	if (packObject(obj, instId, type, buf, length) < 0)
+	{
+		// Give back the reserved room
+		txCommit(connection, buf, 0);
+		return -1;
+	}
+
+	int32_t rc = txCommit(connection, buf, tx_msg_len);
+
+	if (rc == tx_msg_len) {
+		// Update stats
+		++connection->stats.txObjects;
+		connection->stats.txBytes += tx_msg_len;
+		connection->stats.txObjectBytes += length;
+	}
 	
-	// Copy data (if any)
+	// Done
+	return 0;
+}
+
+/**
+ * Send a NACK through the telemetry link.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] objId Object ID to send a NACK for
+ * \return 0 Success
+ * \return -1 Failure
+ */
+static int32_t sendNack(UAVTalkConnectionData *connection, uint32_t objId)
+{
+	int32_t dataOffset;
+	uint8_t *buf;
+
+	if (!connection->outStream) return -1;
+
+	// Pending multi-object frame shares the transmit buffer, send it first
+	flushMultiObject(connection);
+
+	dataOffset = 8;
+
+	uint16_t tx_msg_len = dataOffset+UAVTALK_CHECKSUM_LENGTH;
+	buf = txReserve(connection, tx_msg_len);
+	if (!buf)
+	{
+		return -1;
+	}
+
+	buf[0] = UAVTALK_SYNC_VAL;  // sync byte
+	buf[1] = UAVTALK_TYPE_NACK;
+	// data length inserted here below
+	buf[4] = (uint8_t)(objId & 0xFF);
+	buf[5] = (uint8_t)((objId >> 8) & 0xFF);
+	buf[6] = (uint8_t)((objId >> 16) & 0xFF);
+	buf[7] = (uint8_t)((objId >> 24) & 0xFF);
+
+	// Store the packet length
+	buf[2] = (uint8_t)((dataOffset) & 0xFF);
+	buf[3] = (uint8_t)(((dataOffset) >> 8) & 0xFF);
+
+	// Calculate checksum
+	buf[dataOffset] = PIOS_CRC_updateCRC(0, buf, dataOffset);
+
+	int32_t rc = txCommit(connection, buf, tx_msg_len);
+
+	if (rc == tx_msg_len) {
+		// Update stats
+		connection->stats.txBytes += tx_msg_len;
+	}
+
+	// Done
+	return 0;
+}
+
+/**
+ * Append an object to the pending multi-object frame, sending the frame
+ * first if the object does not fit anymore.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] obj Object handle to send
+ * \param[in] instId The instance ID (can NOT be UAVOBJ_ALL_INSTANCES)
+ * \return 0 Success
+ * \return -1 Failure
+ */
+static int32_t appendMultiObject(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId)
+{
+	int32_t length;
+	int32_t recordLength;
+	int32_t dataOffset;
+	uint32_t objId;
+
+	if (!connection->outStream) return -1;
+
+	length = UAVObjGetNumBytes(obj);
+	recordLength = (UAVObjIsSingleInstance(obj) ? 4 : 6) + length;
+
+	// Objects that would not fit in a frame on their own go out as normal packets
+	if (4 + recordLength > UAVTALK_MAX_MULTI_SIZE)
+	{
+		return sendSingleObject(connection, obj, instId, UAVTALK_TYPE_OBJ);
+	}
+
+	if (connection->txMultiLength + recordLength > UAVTALK_MAX_MULTI_SIZE)
+	{
+		flushMultiObject(connection);
+	}
+
+	// Start a new frame, size is filled in when it is sent
+	if (connection->txMultiLength == 0)
+	{
+		// Room for a full frame is held until it is sent
+		connection->txMultiBuffer = txReserve(connection, UAVTALK_MAX_MULTI_SIZE + UAVTALK_CHECKSUM_LENGTH);
+		if (!connection->txMultiBuffer)
+		{
+			return -1;
+		}
+		connection->txMultiBuffer[0] = UAVTALK_SYNC_VAL;  // sync byte
+		connection->txMultiBuffer[1] = UAVTALK_TYPE_OBJ_MULTI;
+		connection->txMultiLength = 4;
+		connection->txMultiObjects = 0;
+		connection->txMultiObjectBytes = 0;
+	}
+
+	dataOffset = connection->txMultiLength;
+	objId = UAVObjGetID(obj);
+	connection->txMultiBuffer[dataOffset++] = (uint8_t)(objId & 0xFF);
+	connection->txMultiBuffer[dataOffset++] = (uint8_t)((objId >> 8) & 0xFF);
+	connection->txMultiBuffer[dataOffset++] = (uint8_t)((objId >> 16) & 0xFF);
+	connection->txMultiBuffer[dataOffset++] = (uint8_t)((objId >> 24) & 0xFF);
+	if (!UAVObjIsSingleInstance(obj))
+	{
+		connection->txMultiBuffer[dataOffset++] = (uint8_t)(instId & 0xFF);
+		connection->txMultiBuffer[dataOffset++] = (uint8_t)((instId >> 8) & 0xFF);
+	}
+
 	if (length > 0)
 	{
-		if ( UAVObjPack(obj, instId, &connection->txBuffer[dataOffset]) < 0 )
+		if ( UAVObjPack(obj, instId, &connection->txMultiBuffer[dataOffset]) < 0 )
 		{
 			return -1;
 		}
 	}
-	
+
+	connection->txMultiLength += recordLength;
+	++connection->txMultiObjects;
+	connection->txMultiObjectBytes += length;
+
+	return 0;
+}
+
+/**
+ * Send the pending multi-object frame through the telemetry link.
+ * \param[in] connection UAVTalkConnection to be used
+ * \return 0 Success
+ * \return -1 Failure
+ */
+static int32_t flushMultiObject(UAVTalkConnectionData *connection)
+{
+	uint16_t length = connection->txMultiLength;
+	uint8_t *buf = connection->txMultiBuffer;
+
+	connection->txMultiLength = 0;
+	connection->txMultiBuffer = NULL;
+
+	if (connection->txMultiObjects == 0)
+	{
+		// Nothing was added, give back the reserved room
+		if (buf)
+		{
+			txCommit(connection, buf, 0);
+		}
+		return 0;
+	}
+
 	// Store the packet length
-	connection->txBuffer[2] = (uint8_t)((dataOffset+length) & 0xFF);
-	connection->txBuffer[3] = (uint8_t)(((dataOffset+length) >> 8) & 0xFF);
-	
+	buf[2] = (uint8_t)(length & 0xFF);
+	buf[3] = (uint8_t)((length >> 8) & 0xFF);
+
 	// Calculate checksum
-	connection->txBuffer[dataOffset+length] = PIOS_CRC_updateCRC(0, connection->txBuffer, dataOffset+length);
+	buf[length] = PIOS_CRC_updateCRC(0, buf, length);
 
-	uint16_t tx_msg_len = dataOffset+length+UAVTALK_CHECKSUM_LENGTH;
-	int32_t rc = (*connection->outStream)(connection->txBuffer, tx_msg_len);
+	uint16_t tx_msg_len = length+UAVTALK_CHECKSUM_LENGTH;
+	int32_t rc = txCommit(connection, buf, tx_msg_len);
 
 	if (rc == tx_msg_len) {
 		// Update stats
-		++connection->stats.txObjects;
+		connection->stats.txObjects += connection->txMultiObjects;
 		connection->stats.txBytes += tx_msg_len;
-		connection->stats.txObjectBytes += length;
+		connection->stats.txObjectBytes += connection->txMultiObjectBytes;
 	}
-	
+
+	connection->txMultiObjects = 0;
+	connection->txMultiObjectBytes = 0;
+
 	// Done
 	return 0;
 }
 
 /**
- * Send a NACK through the telemetry link.
+ * Send the changed fields of an object instance. The payload is the data of the
+ * changed fields in packing order followed by the 32 bit field mask, the last
+ * bit of the mask covers all fields from the 32nd on.
  * \param[in] connection UAVTalkConnection to be used
- * \param[in] objId Object ID to send a NACK for
+ * \param[in] obj Object handle to send
+ * \param[in] instId The instance ID (can NOT be UAVOBJ_ALL_INSTANCES)
+ * \param[in] keyframe Send the full object
+ * \param[in] aggregated Send the full object in a multi-object frame
  * \return 0 Success
  * \return -1 Failure
  */
-static int32_t sendNack(UAVTalkConnectionData *connection, uint32_t objId)
+static int32_t sendDeltaObject(UAVTalkConnectionData *connection, UAVObjHandle obj, uint16_t instId, uint8_t keyframe, uint8_t aggregated)
 {
+	const uint16_t *sizes;
+	uint16_t numFields;
+	uint16_t n;
+	uint32_t fields;
+	int32_t length;
+	int32_t deltaLength;
+	int32_t fullLength;
 	int32_t dataOffset;
+	int32_t offset;
+	uint32_t objId;
+	uint8_t *buf;
 
 	if (!connection->outStream) return -1;
 
-	connection->txBuffer[0] = UAVTALK_SYNC_VAL;  // sync byte
-	connection->txBuffer[1] = UAVTALK_TYPE_NACK;
+	fields = UAVObjClearDirtyFields(obj, instId);
+	numFields = UAVObjGetFieldSizes(obj, &sizes);
+	length = UAVObjGetNumBytes(obj);
+	dataOffset = UAVObjIsSingleInstance(obj) ? 8 : 10;
+
+	// Compare against what the full object would take on the link
+	deltaLength = 0;
+	for (n = 0; n < numFields; ++n)
+	{
+		if (fields & (1UL << (n < 31 ? n : 31)))
+		{
+			deltaLength += sizes[n];
+		}
+	}
+	if (aggregated)
+	{
+		fullLength = dataOffset - 4 + length;
+	}
+	else
+	{
+		fullLength = dataOffset + length + UAVTALK_CHECKSUM_LENGTH;
+	}
+	if (keyframe || numFields == 0 || length >= UAVTALK_MAX_PAYLOAD_LENGTH ||
+		dataOffset + deltaLength + UAVTALK_DELTA_MASK_LENGTH + UAVTALK_CHECKSUM_LENGTH >= fullLength)
+	{
+		if (aggregated)
+		{
+			return appendMultiObject(connection, obj, instId);
+		}
+		return sendSingleObject(connection, obj, instId, UAVTALK_TYPE_OBJ);
+	}
+
+	// Pending multi-object frame shares the transmit buffer, send it first
+	flushMultiObject(connection);
+
+	// Room for the full object, it is packed and then cut down in place
+	buf = txReserve(connection, dataOffset + length + UAVTALK_CHECKSUM_LENGTH);
+	if (!buf)
+	{
+		return -1;
+	}
+
+	// Setup type and object id fields
+	objId = UAVObjGetID(obj);
+	buf[0] = UAVTALK_SYNC_VAL;  // sync byte
+	buf[1] = UAVTALK_TYPE_OBJ_DELTA;
 	// data length inserted here below
-	connection->txBuffer[4] = (uint8_t)(objId & 0xFF);
-	connection->txBuffer[5] = (uint8_t)((objId >> 8) & 0xFF);
-	connection->txBuffer[6] = (uint8_t)((objId >> 16) & 0xFF);
-	connection->txBuffer[7] = (uint8_t)((objId >> 24) & 0xFF);
+	buf[4] = (uint8_t)(objId & 0xFF);
+	buf[5] = (uint8_t)((objId >> 8) & 0xFF);
+	buf[6] = (uint8_t)((objId >> 16) & 0xFF);
+	buf[7] = (uint8_t)((objId >> 24) & 0xFF);
 
-	dataOffset = 8;
+	// Setup instance ID if one is required
+	if (!UAVObjIsSingleInstance(obj))
+	{
+		buf[8] = (uint8_t)(instId & 0xFF);
+		buf[9] = (uint8_t)((instId >> 8) & 0xFF);
+	}
+
+	if ( UAVObjPack(obj, instId, &buf[dataOffset]) < 0 )
+	{
+		// Give back the reserved room
+		txCommit(connection, buf, 0);
+		return -1;
+	}
+
+	// Keep the changed fields only, they never move up so this is safe in place
+	offset = 0;
+	deltaLength = 0;
+	for (n = 0; n < numFields; ++n)
+	{
+		if (fields & (1UL << (n < 31 ? n : 31)))
+		{
+			memmove(&buf[dataOffset+deltaLength], &buf[dataOffset+offset], sizes[n]);
+			deltaLength += sizes[n];
+		}
+		offset += sizes[n];
+	}
+	buf[dataOffset+deltaLength] = (uint8_t)(fields & 0xFF);
+	buf[dataOffset+deltaLength+1] = (uint8_t)((fields >> 8) & 0xFF);
+	buf[dataOffset+deltaLength+2] = (uint8_t)((fields >> 16) & 0xFF);
+	buf[dataOffset+deltaLength+3] = (uint8_t)((fields >> 24) & 0xFF);
+	length = deltaLength + UAVTALK_DELTA_MASK_LENGTH;
 
 	// Store the packet length
-	connection->txBuffer[2] = (uint8_t)((dataOffset) & 0xFF);
-	connection->txBuffer[3] = (uint8_t)(((dataOffset) >> 8) & 0xFF);
+	buf[2] = (uint8_t)((dataOffset+length) & 0xFF);
+	buf[3] = (uint8_t)(((dataOffset+length) >> 8) & 0xFF);
 
 	// Calculate checksum
-	connection->txBuffer[dataOffset] = PIOS_CRC_updateCRC(0, connection->txBuffer, dataOffset);
+	buf[dataOffset+length] = PIOS_CRC_updateCRC(0, buf, dataOffset+length);
 
-	uint16_t tx_msg_len = dataOffset+UAVTALK_CHECKSUM_LENGTH;
-	int32_t rc = (*connection->outStream)(connection->txBuffer, tx_msg_len);
+	uint16_t tx_msg_len = dataOffset+length+UAVTALK_CHECKSUM_LENGTH;
+	int32_t rc = txCommit(connection, buf, tx_msg_len);
 
 	if (rc == tx_msg_len) {
 		// Update stats
+		++connection->stats.txObjects;
 		connection->stats.txBytes += tx_msg_len;
+		connection->stats.txObjectBytes += length;
 	}
 
 	// Done
 	return 0;
 }
 
+/**
+ * Get room for an outgoing packet. It is written straight into the output
+ * stream's buffer when the stream supports that, else into txBuffer.
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] length Packet length, including the checksum
+ * \return Where to write the packet, hand it to txCommit() when done
+ * \return NULL Failure
+ */
+static uint8_t * txReserve(UAVTalkConnectionData *connection, uint16_t length)
+{
+	uint8_t *buf;
+
+	if (connection->outReserve)
+	{
+		int32_t rc = (*connection->outReserve)(&buf, length);
+		if (rc == length)
+		{
+			return buf;
+		}
+		else if (rc != -2)
+		{
+			return NULL;
+		}
+	}
+
+	// Too large for the output stream's buffer, build it here and copy
+	if (!connection->txBuffer)
+	{
+		connection->txBuffer = pvPortMalloc(UAVTALK_MAX_PACKET_LENGTH);
+	}
+	return connection->txBuffer;
+}
+
+/**
+ * Send a packet written to the room returned by txReserve()
+ * \param[in] connection UAVTalkConnection to be used
+ * \param[in] buf Buffer returned by txReserve()
+ * \param[in] length Packet length, 0 to give the room back unused
+ * \return Number of bytes sent
+ * \return -1 Failure
+ */
+static int32_t txCommit(UAVTalkConnectionData *connection, uint8_t *buf, uint16_t length)
+{
+	if (buf != connection->txBuffer)
+	{
+		return (*connection->outCommit)(length);
+	}
+	if (length == 0)
+	{
+		return 0;
+	}
+	if (!connection->outStream)
+	{
+		return -1;
+	}
+	return (*connection->outStream)(buf, length);
+}
+
 /**
  * @}
  * @}
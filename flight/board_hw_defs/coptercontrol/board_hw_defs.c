@@ -185,8 +185,10 @@ static const struct pios_spi_cfg pios_spi_gyro_cfg = {
 static uint32_t pios_spi_gyro_id;
 void PIOS_SPI_gyro_irq_handler(void)
 {
+	PIOS_IRQ_Prologue();
 	/* Call into the generic code to handle the IRQ for this specific device */
 	PIOS_SPI_IRQ_Handler(pios_spi_gyro_id);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_DMA);
 }
 
 
@@ -395,8 +397,10 @@ static const struct pios_spi_cfg pios_spi_flash_accel_cfg_cc = {
 static uint32_t pios_spi_flash_accel_id;
 void PIOS_SPI_flash_accel_irq_handler(void)
 {
+	PIOS_IRQ_Prologue();
 	/* Call into the generic code to handle the IRQ for this specific device */
 	PIOS_SPI_IRQ_Handler(pios_spi_flash_accel_id);
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_DMA);
 }
 
 #endif	/* PIOS_INCLUDE_SPI */
@@ -441,7 +445,9 @@ static const struct pios_adc_cfg pios_adc_cfg = {
 };
 
 void PIOS_ADC_handler() {
+	PIOS_IRQ_Prologue();
 	PIOS_ADC_DMA_Handler();
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_DMA);
 }
 #endif
 
@@ -1055,7 +1061,9 @@ static const struct pios_rtc_cfg pios_rtc_main_cfg = {
 
 void PIOS_RTC_IRQ_Handler (void)
 {
+	PIOS_IRQ_Prologue();
 	PIOS_RTC_irq_handler ();
+	PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_RTC);
 }
 
 #endif
@@ -1212,14 +1220,18 @@ static const struct pios_i2c_adapter_cfg pios_i2c_flexi_adapter_cfg = {
 uint32_t pios_i2c_flexi_adapter_id;
 void PIOS_I2C_flexi_adapter_ev_irq_handler(void)
 {
+  PIOS_IRQ_Prologue();
   /* Call into the generic code to handle the IRQ for this specific device */
   PIOS_I2C_EV_IRQ_Handler(pios_i2c_flexi_adapter_id);
+  PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_I2C);
 }
 
 void PIOS_I2C_flexi_adapter_er_irq_handler(void)
 {
+  PIOS_IRQ_Prologue();
   /* Call into the generic code to handle the IRQ for this specific device */
   PIOS_I2C_ER_IRQ_Handler(pios_i2c_flexi_adapter_id);
+  PIOS_IRQ_Epilogue(PIOS_IRQ_CLASS_I2C);
 }
 
 #endif /* PIOS_INCLUDE_I2C */
@@ -1319,4 +1331,3 @@ const struct pios_usb_cdc_cfg pios_usb_cdc_cfg = {
 	.data_tx_ep = 3,
 };
 #endif	/* PIOS_INCLUDE_USB_CDC */
-
@@ -545,6 +545,8 @@ const struct pios_eeprom_cfg pios_eeprom_cfg = {
 PacketHandlerConfig pios_ph_cfg = {
 	.winSize = PIOS_PH_WIN_SIZE,
 	.maxConnections = PIOS_PH_MAX_CONNECTIONS,
+	.retransmitTimeout = PIOS_PH_RETRANSMIT_TIMEOUT_MS,
+	.ackDelay = PIOS_PH_ACK_DELAY_MS,
 };
 
 #endif /* PIOS_INCLUDE_PACKET_HANDLER */
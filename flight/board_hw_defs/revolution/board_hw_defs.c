@@ -573,12 +573,37 @@ uint32_t pios_spi_overo_id = 0;
 #include <pios_usart_priv.h>
 
 #ifdef PIOS_INCLUDE_COM_TELEM
+/*
+ * Telemetry tx by DMA, the rx stream (DMA1 Stream5) is taken by the flash SPI
+ */
+static const struct pios_usart_dma_cfg pios_usart_telem_dma_cfg = {
+	.tx = {
+		.channel = DMA1_Stream6,
+		.init = {
+			.DMA_Channel            = DMA_Channel_4,
+			.DMA_PeripheralBaseAddr = (uint32_t)&(USART2->DR),
+			.DMA_DIR                = DMA_DIR_MemoryToPeripheral,
+			.DMA_PeripheralInc      = DMA_PeripheralInc_Disable,
+			.DMA_MemoryInc          = DMA_MemoryInc_Enable,
+			.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte,
+			.DMA_MemoryDataSize     = DMA_MemoryDataSize_Byte,
+			.DMA_Mode               = DMA_Mode_Normal,
+			.DMA_Priority           = DMA_Priority_Low,
+			.DMA_FIFOMode           = DMA_FIFOMode_Disable,
+			.DMA_MemoryBurst        = DMA_MemoryBurst_Single,
+			.DMA_PeripheralBurst    = DMA_PeripheralBurst_Single,
+		},
+	},
+	.tx_flags = (DMA_FLAG_TCIF6 | DMA_FLAG_HTIF6 | DMA_FLAG_TEIF6 | DMA_FLAG_FEIF6),
+};
+
 /*
  * Telemetry on main USART
  */
 static const struct pios_usart_cfg pios_usart_telem_cfg = {
 	.regs = USART2,
 	.remap = GPIO_AF_USART2,
+	.dma = &pios_usart_telem_dma_cfg,
 	.init = {
 		.USART_BaudRate = 57600,
 		.USART_WordLength = USART_WordLength_8b,
@@ -621,12 +646,65 @@ static const struct pios_usart_cfg pios_usart_telem_cfg = {
 #endif /* PIOS_COM_TELEM */
 
 #ifdef PIOS_INCLUDE_GPS
+/*
+ * GPS rx and tx by DMA
+ */
+void PIOS_USART_gps_dma_irq_handler(void);
+void DMA2_Stream2_IRQHandler(void) __attribute__((alias("PIOS_USART_gps_dma_irq_handler")));
+static const struct pios_usart_dma_cfg pios_usart_gps_dma_cfg = {
+	.irq = {
+		.flags = (DMA_FLAG_TCIF2 | DMA_FLAG_HTIF2 | DMA_FLAG_TEIF2 | DMA_FLAG_FEIF2),
+		.init = {
+			.NVIC_IRQChannel = DMA2_Stream2_IRQn,
+			.NVIC_IRQChannelPreemptionPriority = PIOS_IRQ_PRIO_MID,
+			.NVIC_IRQChannelSubPriority = 0,
+			.NVIC_IRQChannelCmd = ENABLE,
+		},
+	},
+	.rx = {
+		.channel = DMA2_Stream2,
+		.init = {
+			.DMA_Channel            = DMA_Channel_4,
+			.DMA_PeripheralBaseAddr = (uint32_t)&(USART1->DR),
+			.DMA_DIR                = DMA_DIR_PeripheralToMemory,
+			.DMA_PeripheralInc      = DMA_PeripheralInc_Disable,
+			.DMA_MemoryInc          = DMA_MemoryInc_Enable,
+			.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte,
+			.DMA_MemoryDataSize     = DMA_MemoryDataSize_Byte,
+			.DMA_Mode               = DMA_Mode_Circular,
+			.DMA_Priority           = DMA_Priority_Medium,
+			.DMA_FIFOMode           = DMA_FIFOMode_Disable,
+			.DMA_MemoryBurst        = DMA_MemoryBurst_Single,
+			.DMA_PeripheralBurst    = DMA_PeripheralBurst_Single,
+		},
+	},
+	.tx = {
+		.channel = DMA2_Stream7,
+		.init = {
+			.DMA_Channel            = DMA_Channel_4,
+			.DMA_PeripheralBaseAddr = (uint32_t)&(USART1->DR),
+			.DMA_DIR                = DMA_DIR_MemoryToPeripheral,
+			.DMA_PeripheralInc      = DMA_PeripheralInc_Disable,
+			.DMA_MemoryInc          = DMA_MemoryInc_Enable,
+			.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte,
+			.DMA_MemoryDataSize     = DMA_MemoryDataSize_Byte,
+			.DMA_Mode               = DMA_Mode_Normal,
+			.DMA_Priority           = DMA_Priority_Low,
+			.DMA_FIFOMode           = DMA_FIFOMode_Disable,
+			.DMA_MemoryBurst        = DMA_MemoryBurst_Single,
+			.DMA_PeripheralBurst    = DMA_PeripheralBurst_Single,
+		},
+	},
+	.tx_flags = (DMA_FLAG_TCIF7 | DMA_FLAG_HTIF7 | DMA_FLAG_TEIF7 | DMA_FLAG_FEIF7),
+};
+
 /*
  * GPS USART
  */
 static const struct pios_usart_cfg pios_usart_gps_cfg = {
 	.regs = USART1,
 	.remap = GPIO_AF_USART1,
+	.dma = &pios_usart_gps_dma_cfg,
 	.init = {
 		.USART_BaudRate = 57600,
 		.USART_WordLength = USART_WordLength_8b,
@@ -666,6 +744,11 @@ static const struct pios_usart_cfg pios_usart_gps_cfg = {
 	},
 };
 
+void PIOS_USART_gps_dma_irq_handler(void)
+{
+	PIOS_USART_DMA_IRQ_Handler(&pios_usart_gps_cfg);
+}
+
 #endif /* PIOS_INCLUDE_GPS */
 
 #ifdef PIOS_INCLUDE_COM_AUX
@@ -988,8 +1071,43 @@ static const struct pios_dsm_cfg pios_dsm_flexi_cfg = {
  */
 #include <pios_sbus_priv.h>
 
+/*
+ * S.Bus frames end in an idle line, receive them by DMA
+ */
+void PIOS_USART_sbus_dma_irq_handler(void);
+void DMA1_Stream2_IRQHandler(void) __attribute__((alias("PIOS_USART_sbus_dma_irq_handler")));
+static const struct pios_usart_dma_cfg pios_usart_sbus_auxsbus_dma_cfg = {
+	.irq = {
+		.flags = (DMA_FLAG_TCIF2 | DMA_FLAG_HTIF2 | DMA_FLAG_TEIF2 | DMA_FLAG_FEIF2),
+		.init = {
+			.NVIC_IRQChannel = DMA1_Stream2_IRQn,
+			.NVIC_IRQChannelPreemptionPriority = PIOS_IRQ_PRIO_HIGH,
+			.NVIC_IRQChannelSubPriority = 0,
+			.NVIC_IRQChannelCmd = ENABLE,
+		},
+	},
+	.rx = {
+		.channel = DMA1_Stream2,
+		.init = {
+			.DMA_Channel            = DMA_Channel_4,
+			.DMA_PeripheralBaseAddr = (uint32_t)&(UART4->DR),
+			.DMA_DIR                = DMA_DIR_PeripheralToMemory,
+			.DMA_PeripheralInc      = DMA_PeripheralInc_Disable,
+			.DMA_MemoryInc          = DMA_MemoryInc_Enable,
+			.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte,
+			.DMA_MemoryDataSize     = DMA_MemoryDataSize_Byte,
+			.DMA_Mode               = DMA_Mode_Circular,
+			.DMA_Priority           = DMA_Priority_High,
+			.DMA_FIFOMode           = DMA_FIFOMode_Disable,
+			.DMA_MemoryBurst        = DMA_MemoryBurst_Single,
+			.DMA_PeripheralBurst    = DMA_PeripheralBurst_Single,
+		},
+	},
+};
+
 static const struct pios_usart_cfg pios_usart_sbus_auxsbus_cfg = {
 	.regs = UART4,
+	.dma = &pios_usart_sbus_auxsbus_dma_cfg,
 	.init = {
 		.USART_BaudRate            = 100000,
 		.USART_WordLength          = USART_WordLength_8b,
@@ -1044,6 +1162,11 @@ static const struct pios_sbus_cfg pios_sbus_cfg = {
 	.gpio_inv_enable = Bit_SET,
 };
 
+void PIOS_USART_sbus_dma_irq_handler(void)
+{
+	PIOS_USART_DMA_IRQ_Handler(&pios_usart_sbus_auxsbus_cfg);
+}
+
 #endif	/* PIOS_INCLUDE_SBUS */
 
 #if defined(PIOS_INCLUDE_COM)
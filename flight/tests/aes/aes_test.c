@@ -0,0 +1,171 @@
+/**
+ ******************************************************************************
+ *
+ * @file       aes_test.c
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Host test of the AES-128 block and CTR mode code against the
+ *             FIPS-197 and NIST SP 800-38A test vectors
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * Both the byte wise code (aes_encrypt_cbc_128() without a chain block is a
+ * plain ECB block) and the T-table code are checked against FIPS-197 C.1.
+ * aes_128_ctr() is checked against SP 800-38A F.5.1 in one call, block by
+ * block, and with a short last block, which is the only place a length that
+ * is not a multiple of N_BLOCK may appear.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "aes.h"
+
+// FIPS-197 C.1 AES-128
+static const uint8_t fips_key[N_BLOCK] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+};
+static const uint8_t fips_plain[N_BLOCK] = {
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+	0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+};
+static const uint8_t fips_cipher[N_BLOCK] = {
+	0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+	0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a,
+};
+
+// SP 800-38A F.5.1 CTR-AES128.Encrypt
+static const uint8_t ctr_key[N_BLOCK] = {
+	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+	0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c,
+};
+static const uint8_t ctr_init[N_BLOCK] = {
+	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+	0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff,
+};
+static const uint8_t ctr_plain[4 * N_BLOCK] = {
+	0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+	0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+	0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+	0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+	0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+	0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+	0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+	0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10,
+};
+static const uint8_t ctr_cipher[4 * N_BLOCK] = {
+	0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26,
+	0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+	0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff,
+	0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+	0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e,
+	0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+	0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1,
+	0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee,
+};
+
+static int failures;
+
+static void check(const char *name, const uint8_t *got, const uint8_t *expected, uint32_t length)
+{
+	if (memcmp(got, expected, length) == 0) {
+		printf("ok    %s\n", name);
+		return;
+	}
+
+	printf("FAIL  %s\n      got     ", name);
+	for (uint32_t i = 0; i < length; i++)
+		printf("%02x", got[i]);
+	printf("\n      expected ");
+	for (uint32_t i = 0; i < length; i++)
+		printf("%02x", expected[i]);
+	printf("\n");
+	++failures;
+}
+
+static void test_block(void)
+{
+	uint8_t key[N_BLOCK];
+	uint8_t dec_key[N_BLOCK];
+	uint8_t data[N_BLOCK];
+	struct aes_128_context ctx;
+
+	// The byte wise code updates the key in place, work on a copy
+	memcpy(key, fips_key, N_BLOCK);
+	memcpy(data, fips_plain, N_BLOCK);
+	aes_encrypt_cbc_128(data, key, NULL);
+	check("FIPS-197 C.1 encrypt, byte wise", data, fips_cipher, N_BLOCK);
+
+	memcpy(key, fips_key, N_BLOCK);
+	aes_decrypt_key_128_create(key, dec_key);
+	aes_decrypt_cbc_128(data, dec_key, NULL);
+	check("FIPS-197 C.1 decrypt, byte wise", data, fips_plain, N_BLOCK);
+
+	aes_128_key_expand(&ctx, fips_key);
+	aes_128_encrypt_block(&ctx, fips_plain, data);
+	check("FIPS-197 C.1 encrypt, T-table", data, fips_cipher, N_BLOCK);
+}
+
+static void test_ctr(void)
+{
+	uint8_t counter[N_BLOCK];
+	uint8_t data[sizeof(ctr_plain)];
+	struct aes_128_context ctx;
+
+	aes_128_key_expand(&ctx, ctr_key);
+
+	memcpy(counter, ctr_init, N_BLOCK);
+	memcpy(data, ctr_plain, sizeof(data));
+	aes_128_ctr(&ctx, counter, data, sizeof(data));
+	check("SP 800-38A F.5.1 encrypt", data, ctr_cipher, sizeof(data));
+
+	// Decryption is the same operation
+	memcpy(counter, ctr_init, N_BLOCK);
+	aes_128_ctr(&ctx, counter, data, sizeof(data));
+	check("SP 800-38A F.5.2 decrypt", data, ctr_plain, sizeof(data));
+
+	// A stream split on block boundaries continues from the stored counter
+	memcpy(counter, ctr_init, N_BLOCK);
+	memcpy(data, ctr_plain, sizeof(data));
+	for (uint32_t offset = 0; offset < sizeof(data); offset += N_BLOCK)
+		aes_128_ctr(&ctx, counter, data + offset, N_BLOCK);
+	check("SP 800-38A F.5.1 encrypt, block by block", data, ctr_cipher, sizeof(data));
+
+	// Only the last call of a stream may end in a partial block
+	memcpy(counter, ctr_init, N_BLOCK);
+	memcpy(data, ctr_plain, sizeof(data));
+	aes_128_ctr(&ctx, counter, data, 2 * N_BLOCK);
+	aes_128_ctr(&ctx, counter, data + 2 * N_BLOCK, N_BLOCK + 5);
+	check("SP 800-38A F.5.1 encrypt, short last block", data, ctr_cipher, 3 * N_BLOCK + 5);
+	check("SP 800-38A F.5.1 encrypt, bytes past the end untouched", data + 3 * N_BLOCK + 5,
+		ctr_plain + 3 * N_BLOCK + 5, N_BLOCK - 5);
+}
+
+int main(void)
+{
+	test_block();
+	test_ctr();
+
+	if (failures) {
+		printf("%d check(s) failed\n", failures);
+		return 1;
+	}
+	printf("All checks passed\n");
+	return 0;
+}
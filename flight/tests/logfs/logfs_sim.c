@@ -0,0 +1,332 @@
+/**
+ ******************************************************************************
+ *
+ * @file       logfs_sim.c
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Host test of pios_flashfs_logfs against a simulated NOR flash
+ *             that loses power at random points
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * The simulated part behaves like the M25P: a write only clears bits, a page
+ * program must not cross a 256 byte page and an erase sets a whole sector to
+ * 0xFF. A reset can be scheduled after any number of writes and erases. The
+ * write or erase it hits is left partly done, then the test mounts the file
+ * system again and checks that every object holds the data of its last
+ * completed save, or that of the save cut short.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include "openpilot.h"
+#include "uavobjectmanager.h"
+
+#define SECTOR_SIZE   4096
+#define NUM_SECTORS   8
+#define FLASH_SIZE    (SECTOR_SIZE * NUM_SECTORS)
+#define PAGE_SIZE     256
+
+#define FS_MAGIC      0x99ABCEEF
+#define LEGACY_MAGIC  0x85FB3D35
+
+#define NUM_OBJECTS   12
+#define NUM_INSTANCES 3
+#define MAX_OBJ_SIZE  700
+
+// Flash operations a save or collection may take before the reset hits
+#define MAX_CUT_OPS   48
+
+struct simObject {
+	uint32_t id;
+	uint16_t size;
+	uint16_t instances;
+};
+
+// What the flash should hold for an object instance
+struct expected {
+	bool saved;
+	uint8_t data[MAX_OBJ_SIZE];
+};
+
+static const struct flashfs_logfs_cfg cfg = {
+	.fs_magic = FS_MAGIC,
+	.arena_start = 0,
+	.arena_size = FLASH_SIZE,
+	.sector_size = SECTOR_SIZE,
+	.legacy_magic = LEGACY_MAGIC,
+};
+
+static uint8_t flash[FLASH_SIZE];
+static int32_t opsLeft = -1;
+static int32_t transactionDepth;
+static jmp_buf resetPoint;
+
+static struct simObject objects[NUM_OBJECTS];
+static struct expected model[NUM_OBJECTS][NUM_INSTANCES];
+
+static void fail(const char * what, uint32_t obj, uint16_t instId)
+{
+	fprintf(stderr, "FAIL: %s (object %u instance %u)\n", what, obj, instId);
+	exit(1);
+}
+
+/**
+ * Count one flash operation, true if the reset hits this one
+ */
+static bool resetNow()
+{
+	if (opsLeft < 0)
+		return false;
+	return opsLeft-- == 0;
+}
+
+static void reset()
+{
+	opsLeft = -1;
+	transactionDepth = 0;
+	longjmp(resetPoint, 1);
+}
+
+int32_t PIOS_Flash_Jedec_StartTransaction()
+{
+	transactionDepth++;
+	return 0;
+}
+
+int32_t PIOS_Flash_Jedec_EndTransaction()
+{
+	if (--transactionDepth < 0)
+		fail("transaction ended twice", 0, 0);
+	return 0;
+}
+
+int32_t PIOS_Flash_Jedec_EraseSector(uint32_t addr)
+{
+	if (addr % SECTOR_SIZE != 0 || addr >= FLASH_SIZE)
+		fail("erase of a bad address", addr, 0);
+	if (transactionDepth == 0)
+		fail("erase outside a transaction", addr, 0);
+
+	if (resetNow()) {
+		// Part of the sector erased, the rest somewhere in between
+		uint32_t done = rand() % SECTOR_SIZE;
+		for (uint32_t i = 0; i < SECTOR_SIZE; i++)
+			if (i < done || rand() % 4 == 0)
+				flash[addr + i] = 0xFF;
+			else
+				flash[addr + i] |= rand();
+		reset();
+	}
+
+	memset(&flash[addr], 0xFF, SECTOR_SIZE);
+	return 0;
+}
+
+int32_t PIOS_Flash_Jedec_WriteData(uint32_t addr, uint8_t * data, uint16_t len)
+{
+	if (addr + len > FLASH_SIZE)
+		fail("write past the end of the flash", addr, len);
+	if ((addr % PAGE_SIZE) + len > PAGE_SIZE)
+		fail("write crossing a page", addr, len);
+	if (transactionDepth == 0)
+		fail("write outside a transaction", addr, 0);
+
+	if (resetNow()) {
+		// The first bytes written, the next one only partly
+		uint16_t done = rand() % (len + 1);
+		for (uint16_t i = 0; i < done; i++)
+			flash[addr + i] &= data[i];
+		if (done < len)
+			flash[addr + done] &= data[done] | rand();
+		reset();
+	}
+
+	for (uint16_t i = 0; i < len; i++)
+		flash[addr + i] &= data[i];
+	return 0;
+}
+
+int32_t PIOS_Flash_Jedec_ReadData(uint32_t addr, uint8_t * data, uint16_t len)
+{
+	if (addr + len > FLASH_SIZE)
+		fail("read past the end of the flash", addr, len);
+
+	memcpy(data, &flash[addr], len);
+	return 0;
+}
+
+uint32_t UAVObjGetID(UAVObjHandle obj)
+{
+	return obj->id;
+}
+
+uint32_t UAVObjGetNumBytes(UAVObjHandle obj)
+{
+	return obj->size;
+}
+
+/**
+ * Mount the file system, resets during the mount are retried
+ */
+static int32_t mount(bool allowReset)
+{
+	volatile int32_t ret;
+
+	if (setjmp(resetPoint) != 0) {
+		if (!allowReset)
+			fail("reset while not expected", 0, 0);
+	}
+	opsLeft = allowReset && rand() % 4 == 0 ? rand() % 8 : -1;
+	ret = PIOS_FLASHFS_Init(&cfg);
+	opsLeft = -1;
+
+	if (ret < 0)
+		fail("mount failed", 0, 0);
+	if (transactionDepth != 0)
+		fail("mount left a transaction open", 0, 0);
+	return ret;
+}
+
+/**
+ * Check every object against the model. The object whose save or delete was
+ * cut short may hold either the old or the new state, the model follows it.
+ */
+static void verify(int32_t pendingObj, uint16_t pendingInst, const uint8_t * pendingData)
+{
+	uint8_t data[MAX_OBJ_SIZE];
+
+	for (int32_t n = 0; n < NUM_OBJECTS; n++) {
+		for (uint16_t inst = 0; inst < objects[n].instances; inst++) {
+			struct expected * expect = &model[n][inst];
+			bool pending = (n == pendingObj && inst == pendingInst);
+
+			int32_t ret = PIOS_FLASHFS_ObjLoad(&objects[n], inst, data);
+			if (ret == 0) {
+				if (expect->saved && memcmp(data, expect->data, objects[n].size) == 0)
+					continue;
+				if (pending && pendingData && memcmp(data, pendingData, objects[n].size) == 0) {
+					expect->saved = true;
+					memcpy(expect->data, pendingData, objects[n].size);
+					continue;
+				}
+				fail("object holds data never saved", objects[n].id, inst);
+			} else if (ret == -1) {
+				if (!expect->saved)
+					continue;
+				if (pending && !pendingData) {
+					expect->saved = false;
+					continue;
+				}
+				fail("saved object lost", objects[n].id, inst);
+			} else {
+				fail("object does not load", objects[n].id, inst);
+			}
+		}
+	}
+}
+
+/**
+ * A table of the old object list file system is detected and erased once
+ */
+static void testLegacyTable()
+{
+	uint32_t magic = LEGACY_MAGIC;
+
+	memset(flash, 0xFF, sizeof(flash));
+	memcpy(flash, &magic, sizeof(magic));
+	memset(&flash[SECTOR_SIZE], 0x5A, 64);
+
+	if (mount(false) != 1)
+		fail("old object table not reported", 0, 0);
+	if (mount(false) != 0)
+		fail("old object table reported twice", 0, 0);
+}
+
+int main(int argc, char * argv[])
+{
+	int32_t resetsWanted = (argc > 1) ? atoi(argv[1]) : 1000;
+	uint32_t seed = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+	uint8_t newData[MAX_OBJ_SIZE];
+	volatile int32_t resets = 0;
+	volatile uint32_t saves = 0;
+	volatile uint32_t collections = 0;
+
+	srand(seed);
+
+	testLegacyTable();
+
+	for (int32_t n = 0; n < NUM_OBJECTS; n++) {
+		objects[n].id = 0x10000000 + n * 0x01234567;
+		objects[n].size = 4 + rand() % (MAX_OBJ_SIZE - 4);
+		objects[n].instances = (n % 4 == 0) ? NUM_INSTANCES : 1;
+	}
+
+	memset(flash, 0xFF, sizeof(flash));
+	memset(model, 0, sizeof(model));
+	mount(false);
+
+	while (resets < resetsWanted) {
+		int32_t obj = rand() % NUM_OBJECTS;
+		uint16_t inst = rand() % objects[obj].instances;
+		int32_t op = rand() % 10;
+		volatile int32_t ret = 0;
+
+		for (uint16_t i = 0; i < objects[obj].size; i++)
+			newData[i] = rand();
+
+		if (setjmp(resetPoint) != 0) {
+			resets++;
+			mount(true);
+			verify(obj, inst, (op == 0) ? NULL : newData);
+			continue;
+		}
+
+		opsLeft = (rand() % 3 == 0) ? rand() % MAX_CUT_OPS : -1;
+		if (op == 0) {
+			ret = PIOS_FLASHFS_ObjDelete(&objects[obj], inst);
+			if (ret == 0 || (ret == -1 && !model[obj][inst].saved))
+				model[obj][inst].saved = false;
+			else
+				fail("delete failed", objects[obj].id, inst);
+		} else if (op == 1) {
+			ret = PIOS_FLASHFS_GarbageCollect();
+			if (ret < 0)
+				fail("garbage collection failed", 0, 0);
+			collections += ret;
+		} else {
+			ret = PIOS_FLASHFS_ObjSave(&objects[obj], inst, newData);
+			if (ret != 0)
+				fail("save failed", objects[obj].id, inst);
+			model[obj][inst].saved = true;
+			memcpy(model[obj][inst].data, newData, objects[obj].size);
+			saves++;
+		}
+		opsLeft = -1;
+
+		if (transactionDepth != 0)
+			fail("transaction left open", objects[obj].id, inst);
+		verify(-1, 0, NULL);
+	}
+
+	printf("logfs: %u saves, %u sectors collected, %d resets, no object lost\n",
+			(unsigned) saves, (unsigned) collections, (int) resets);
+	return 0;
+}
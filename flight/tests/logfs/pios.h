@@ -0,0 +1,46 @@
+/**
+ ******************************************************************************
+ *
+ * @file       pios.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Stand-in for the PiOS main header, only what the log structured
+ *             flash file system needs on the host
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef PIOS_H
+#define PIOS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define PIOS_INCLUDE_FLASH_LOGFS_SETTINGS
+
+/* Implemented by the simulated flash in logfs_sim.c */
+int32_t PIOS_Flash_Jedec_StartTransaction();
+int32_t PIOS_Flash_Jedec_EndTransaction();
+int32_t PIOS_Flash_Jedec_EraseSector(uint32_t add);
+int32_t PIOS_Flash_Jedec_WriteData(uint32_t addr, uint8_t * data, uint16_t len);
+int32_t PIOS_Flash_Jedec_ReadData(uint32_t addr, uint8_t * data, uint16_t len);
+
+#include <pios_crc.h>
+#include <pios_flashfs_logfs.h>
+
+#endif /* PIOS_H */
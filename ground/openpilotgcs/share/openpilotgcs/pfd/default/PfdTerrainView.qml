@@ -7,6 +7,10 @@ OsgEarth {
     sceneFile: qmlWidget.earthFile
     fieldOfView: 90
 
+    lodScale: qmlWidget.terrainLodScale
+    maxPagedTiles: qmlWidget.terrainTileBudget
+    pagerThreads: qmlWidget.terrainPagerThreads
+
     yaw: AttitudeActual.Yaw
     pitch: AttitudeActual.Pitch
     roll: AttitudeActual.Roll
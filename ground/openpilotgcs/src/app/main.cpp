@@ -60,6 +60,7 @@ static const char *fixedOptionsC =
 "    -clean-config       Delete all existing configuration settings\n"
 "    -exit-after-config  Exit GCS after manipulating configuration settings\n"
 "    -D key=value        Override configuration settings e.g: -D General/OverrideLanguage=de\n"
+"    -profile-plugins    Print the time each plugin took to start\n"
 "    -configfile=value       Default configuration file to load if settings file is empty\n";
 static const char *HELP_OPTION1 = "-h";
 static const char *HELP_OPTION2 = "-help";
@@ -70,6 +71,7 @@ static const char *CLIENT_OPTION = "-client";
 static const char *CONFIG_OPTION = "-D";
 static const char *CLEAN_CONFIG_OPTION = "-clean-config";
 static const char *EXIT_AFTER_CONFIG_OPTION = "-exit-after-config";
+static const char *PROFILE_PLUGINS_OPTION = "-profile-plugins";
 
 typedef QList<ExtensionSystem::PluginSpec *> PluginSpecSet;
 
@@ -300,6 +302,7 @@ int main(int argc, char **argv)
         appOptions.insert(QLatin1String(CONFIG_OPTION), true);
         appOptions.insert(QLatin1String(CLEAN_CONFIG_OPTION), false);
         appOptions.insert(QLatin1String(EXIT_AFTER_CONFIG_OPTION), false);
+        appOptions.insert(QLatin1String(PROFILE_PLUGINS_OPTION), false);
         QString errorMessage;
         if (!pluginManager.parseOptions(arguments,
                                         appOptions,
@@ -352,6 +355,12 @@ int main(int argc, char **argv)
         displayError(msgCoreLoadFailure(coreplugin->errorString()));
         return 1;
     }
+    if (foundAppOptions.contains(QLatin1String(PROFILE_PLUGINS_OPTION))) {
+        QString times;
+        QTextStream str(&times);
+        pluginManager.formatPluginTimes(str);
+        qDebug("Plugin start-up times:\n%s", qPrintable(times));
+    }
     {
         QStringList errors;
         foreach (ExtensionSystem::PluginSpec *p, pluginManager.plugins())
@@ -0,0 +1,31 @@
+#-------------------------------------------------
+#
+# Converts .opl logs to per field binary columns.
+# Build it from a GCS build tree after the plugins are built, e.g.
+#   qmake ../../src/experimental/OplToColumns GCS_BUILD_TREE=<build>/ground/openpilotgcs
+#
+#-------------------------------------------------
+
+QT       += core network
+
+TARGET = opltocolumns
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+include(../../../openpilotgcs.pri)
+
+DESTDIR = $$GCS_APP_PATH
+LIBS += -L$$GCS_PLUGIN_PATH/OpenPilot
+INCLUDEPATH += $$GCS_SOURCE_TREE/src/plugins
+
+include(../../plugins/logging/logging.pri)
+
+linux-* {
+    QMAKE_LFLAGS += \'-Wl,-rpath,$$GCS_PLUGIN_PATH/OpenPilot:$$GCS_PLUGIN_PATH/OpenPilot/..:$$GCS_LIBRARY_PATH\'
+}
+
+HEADERS += columnwriter.h
+SOURCES += columnwriter.cpp \
+           main.cpp
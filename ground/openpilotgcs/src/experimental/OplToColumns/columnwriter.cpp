@@ -0,0 +1,219 @@
+/**
+ ******************************************************************************
+ *
+ * @file       columnwriter.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Writes decoded log updates as one binary column per field
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "columnwriter.h"
+#include "uavobject.h"
+#include "uavobjectfield.h"
+#include <QFile>
+#include <QTextStream>
+#include <QtEndian>
+#include <QDebug>
+
+/**
+ * numpy style type of the raw values of a field
+ */
+static QString fieldDType(UAVObjectField* field)
+{
+    switch (field->getType()) {
+    case UAVObjectField::INT8:
+        return "i1";
+    case UAVObjectField::INT16:
+        return "<i2";
+    case UAVObjectField::INT32:
+        return "<i4";
+    case UAVObjectField::UINT16:
+        return "<u2";
+    case UAVObjectField::UINT32:
+        return "<u4";
+    case UAVObjectField::FLOAT32:
+        return "<f4";
+    default:
+        // UINT8, ENUM, and BITFIELD/STRING as raw bytes
+        return "u1";
+    }
+}
+
+static QString jsonString(const QString& str)
+{
+    QString escaped = str;
+    escaped.replace("\\", "\\\\").replace("\"", "\\\"");
+    return "\"" + escaped + "\"";
+}
+
+static QString jsonStringList(const QStringList& list)
+{
+    QStringList quoted;
+    foreach (QString str, list)
+        quoted << jsonString(str);
+    return "[" + quoted.join(", ") + "]";
+}
+
+ColumnWriter::ColumnWriter(const QString& outputDir) :
+    dir(outputDir),
+    error(false)
+{
+}
+
+ColumnWriter::~ColumnWriter()
+{
+    qDeleteAll(objects);
+}
+
+void ColumnWriter::logStarted(const QString& fileName, UAVObjectManager* objMngr)
+{
+    Q_UNUSED(objMngr);
+    logName = fileName;
+    if (!dir.mkpath(".")) {
+        qDebug() << "Unable to create" << dir.path();
+        error = true;
+    }
+}
+
+void ColumnWriter::objectUpdated(quint32 timeStamp, UAVObject* obj)
+{
+    if (error)
+        return;
+    ObjectColumns* columns = objectIndex.value(obj, NULL);
+    if (columns == NULL)
+        columns = addObject(obj);
+
+    uchar stamp[sizeof(timeStamp)];
+    qToLittleEndian<quint32>(timeStamp, stamp);
+    columns->timeStamps.buffer.append((const char*)stamp, sizeof(stamp));
+    flush(columns->timeStamps, false);
+
+    // Packed object data is little endian, so fields are plain slices of it
+    obj->pack((quint8*)packed.data());
+    for (int n = 0; n < columns->fields.size(); ++n) {
+        Column& column = columns->fields[n];
+        column.buffer.append(packed.constData() + column.offset, column.numBytes);
+        flush(column, false);
+    }
+    ++columns->rows;
+}
+
+void ColumnWriter::logFinished(const QString& fileName, bool success)
+{
+    Q_UNUSED(fileName);
+    Q_UNUSED(success);
+    if (error)
+        return;
+    foreach (ObjectColumns* columns, objects) {
+        flush(columns->timeStamps, true);
+        for (int n = 0; n < columns->fields.size(); ++n)
+            flush(columns->fields[n], true);
+    }
+    if (!writeManifest())
+        error = true;
+}
+
+ColumnWriter::ObjectColumns* ColumnWriter::addObject(UAVObject* obj)
+{
+    ObjectColumns* columns = new ObjectColumns;
+    columns->obj = obj;
+    columns->name = obj->getName();
+    if (!obj->isSingleInstance())
+        columns->name += QString("_%1").arg(obj->getInstID());
+    columns->rows = 0;
+    columns->timeStamps.fileName = columns->name + ".timestamp.bin";
+    columns->timeStamps.field = NULL;
+    columns->timeStamps.offset = 0;
+    columns->timeStamps.numBytes = sizeof(quint32);
+    columns->timeStamps.created = false;
+    foreach (UAVObjectField* field, obj->getFields()) {
+        Column column;
+        column.fileName = columns->name + "." + field->getName() + ".bin";
+        column.field = field;
+        column.offset = field->getDataOffset();
+        column.numBytes = field->getNumBytes();
+        column.created = false;
+        columns->fields.append(column);
+    }
+    if ((quint32)packed.size() < obj->getNumBytes())
+        packed.resize(obj->getNumBytes());
+    objects.append(columns);
+    objectIndex.insert(obj, columns);
+    return columns;
+}
+
+/**
+ * Write the buffered values once FLUSH_SIZE is reached, or always if forced
+ */
+void ColumnWriter::flush(Column& column, bool force)
+{
+    if (column.buffer.size() < (force ? 1 : FLUSH_SIZE) && column.created)
+        return;
+    QFile file(dir.filePath(column.fileName));
+    if (!file.open(column.created ? QIODevice::WriteOnly | QIODevice::Append : QIODevice::WriteOnly | QIODevice::Truncate)
+            || file.write(column.buffer) != column.buffer.size()) {
+        qDebug() << "Unable to write" << file.fileName();
+        error = true;
+    }
+    column.created = true;
+    column.buffer.clear();
+}
+
+/**
+ * Describe the columns in columns.json
+ */
+bool ColumnWriter::writeManifest()
+{
+    QFile file(dir.filePath("columns.json"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+    QTextStream out(&file);
+    out << "{\n  \"log\": " << jsonString(logName) << ",\n  \"objects\": [";
+    for (int n = 0; n < objects.size(); ++n) {
+        ObjectColumns* columns = objects[n];
+        out << (n ? "," : "") << "\n    {\n";
+        out << "      \"name\": " << jsonString(columns->obj->getName()) << ",\n";
+        out << "      \"instance\": " << columns->obj->getInstID() << ",\n";
+        out << "      \"rows\": " << columns->rows << ",\n";
+        out << "      \"timestamp\": { \"file\": " << jsonString(columns->timeStamps.fileName)
+            << ", \"dtype\": \"<u4\", \"units\": \"ms\" },\n";
+        out << "      \"fields\": [";
+        for (int f = 0; f < columns->fields.size(); ++f) {
+            UAVObjectField* field = columns->fields[f].field;
+            quint32 elements = field->getNumElements();
+            QString dtype = fieldDType(field);
+            // Bitfields and strings are kept as their raw bytes
+            if (dtype == "u1" && field->getNumBytes() != elements)
+                elements = field->getNumBytes();
+            out << (f ? "," : "") << "\n        { \"name\": " << jsonString(field->getName())
+                << ", \"type\": " << jsonString(field->getTypeAsString())
+                << ", \"dtype\": " << jsonString(dtype)
+                << ", \"elements\": " << elements
+                << ", \"units\": " << jsonString(field->getUnits())
+                << ", \"file\": " << jsonString(columns->fields[f].fileName);
+            if (field->getElementNames().size() > 1)
+                out << ", \"elementNames\": " << jsonStringList(field->getElementNames());
+            if (field->getType() == UAVObjectField::ENUM)
+                out << ", \"options\": " << jsonStringList(field->getOptions());
+            out << " }";
+        }
+        out << "\n      ]\n    }";
+    }
+    out << "\n  ]\n}\n";
+    out.flush();
+    return file.error() == QFile::NoError;
+}
@@ -0,0 +1,85 @@
+/**
+ ******************************************************************************
+ *
+ * @file       columnwriter.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Writes decoded log updates as one binary column per field
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef COLUMNWRITER_H
+#define COLUMNWRITER_H
+
+#include <QDir>
+#include <QHash>
+#include <QList>
+#include <QByteArray>
+#include "logging/logdecoder.h"
+
+class UAVObjectField;
+
+/**
+ * Log sink writing every object instance as a set of columns: one file of
+ * quint32 timestamps and one file per field holding the raw little endian
+ * values of every update, rows of getNumElements() values each.
+ * columns.json in the output directory describes the files and their types.
+ */
+class ColumnWriter : public LogDecoderSink
+{
+public:
+    ColumnWriter(const QString& outputDir);
+    ~ColumnWriter();
+
+    void logStarted(const QString& fileName, UAVObjectManager* objMngr);
+    void objectUpdated(quint32 timeStamp, UAVObject* obj);
+    void logFinished(const QString& fileName, bool success);
+
+    bool hasError() const { return error; }
+
+private:
+    static const int FLUSH_SIZE = 64 * 1024;
+
+    typedef struct {
+        QString fileName;
+        QByteArray buffer;
+        UAVObjectField* field;
+        quint32 offset;
+        quint32 numBytes;
+        bool created;
+    } Column;
+
+    typedef struct {
+        UAVObject* obj;
+        QString name;
+        quint32 rows;
+        Column timeStamps;
+        QList<Column> fields;
+    } ObjectColumns;
+
+    QDir dir;
+    QString logName;
+    QList<ObjectColumns*> objects;
+    QHash<UAVObject*, ObjectColumns*> objectIndex;
+    QByteArray packed;
+    bool error;
+
+    ObjectColumns* addObject(UAVObject* obj);
+    void flush(Column& column, bool force);
+    bool writeManifest();
+};
+
+#endif // COLUMNWRITER_H
@@ -0,0 +1,95 @@
+/**
+ ******************************************************************************
+ *
+ * @file       main.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Converts .opl logs to per field binary columns in one pass.
+ *             Every log gets a <log>.columns directory with one file per
+ *             field and columns.json describing them, ready for e.g.
+ *             numpy.memmap or MATLAB memmapfile.
+ *
+ *             Usage: opltocolumns [-j jobs] [-o outdir] log.opl [...]
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <QtCore/QCoreApplication>
+#include <QStringList>
+#include <QFileInfo>
+#include <QDir>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+#include "logging/logdecoder.h"
+#include "columnwriter.h"
+
+static QString outputRoot;
+
+static QString outputDir(const QString& fileName)
+{
+    QFileInfo info(fileName);
+    QDir dir = outputRoot.isEmpty() ? info.absoluteDir() : QDir(outputRoot);
+    return dir.filePath(info.completeBaseName() + ".columns");
+}
+
+/**
+ * Convert one log, runs on the thread pool
+ */
+static bool convertLog(const QString& fileName)
+{
+    LogDecoder decoder;
+    ColumnWriter writer(outputDir(fileName));
+    bool success = decoder.decode(fileName, &writer);
+    return success && !writer.hasError();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    int jobs = QThread::idealThreadCount();
+    QStringList files;
+    QStringList args = app.arguments();
+    for (int n = 1; n < args.size(); ++n)
+    {
+        if (args[n] == "-j" && n + 1 < args.size())
+            jobs = qMax(1, args[++n].toInt());
+        else if (args[n] == "-o" && n + 1 < args.size())
+            outputRoot = args[++n];
+        else
+            files << args[n];
+    }
+    if (files.isEmpty())
+    {
+        out << "Usage: opltocolumns [-j jobs] [-o outdir] log.opl [...]" << endl;
+        out << "  -j jobs    logs converted in parallel (default: one per core)" << endl;
+        out << "  -o outdir  where to put the <log>.columns directories (default: next to the log)" << endl;
+        return 1;
+    }
+
+    QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+    QList<bool> results = QtConcurrent::blockingMapped<QList<bool> >(files, convertLog);
+
+    int failed = 0;
+    for (int n = 0; n < files.size(); ++n)
+    {
+        out << (results[n] ? "converted " : "FAILED    ") << files[n] << " -> " << outputDir(files[n]) << endl;
+        if (!results[n])
+            ++failed;
+    }
+    return failed > 0 ? 1 : 0;
+}
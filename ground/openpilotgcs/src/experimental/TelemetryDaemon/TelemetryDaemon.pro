@@ -0,0 +1,39 @@
+#-------------------------------------------------
+#
+# Headless telemetry daemon: link, logging and relay without the GUI.
+# Build it from a GCS build tree after the plugins are built, e.g.
+#   qmake ../../src/experimental/TelemetryDaemon GCS_BUILD_TREE=<build>/ground/openpilotgcs
+#
+#-------------------------------------------------
+
+QT       += core network
+QT       -= gui
+
+TARGET = optelemetryd
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+include(../../../openpilotgcs.pri)
+
+DESTDIR = $$GCS_APP_PATH
+LIBS += -L$$GCS_PLUGIN_PATH/OpenPilot
+INCLUDEPATH += $$GCS_SOURCE_TREE/src/plugins
+
+include(../../plugins/uavtalk/uavtalk.pri)
+
+linux-* {
+    QMAKE_LFLAGS += \'-Wl,-rpath,$$GCS_PLUGIN_PATH/OpenPilot:$$GCS_PLUGIN_PATH/OpenPilot/..:$$GCS_LIBRARY_PATH\'
+}
+
+# The log writer is not exported by the logging plugin, it is built in
+LOGGING = $$GCS_SOURCE_TREE/src/plugins/logging
+INCLUDEPATH += $$LOGGING
+HEADERS += telemetrydaemon.h \
+           $$LOGGING/logfile.h \
+           $$LOGGING/logprefetcher.h
+SOURCES += main.cpp \
+           telemetrydaemon.cpp \
+           $$LOGGING/logfile.cpp \
+           $$LOGGING/logprefetcher.cpp
@@ -0,0 +1,165 @@
+/**
+ ******************************************************************************
+ *
+ * @file       main.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Headless telemetry link with logging and relaying
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <QtCore/QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+#include <QtNetwork/QTcpSocket>
+#include <qextserialport.h>
+#include "telemetrydaemon.h"
+
+#ifdef Q_OS_UNIX
+#include <QSocketNotifier>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <string.h>
+
+// SIGINT/SIGTERM only write to a socket, the event loop does the quitting
+static int signalFd[2];
+
+static void signalHandler(int)
+{
+    char c = 1;
+    ::write(signalFd[0], &c, sizeof(c));
+}
+
+static void watchSignals(QCoreApplication *app)
+{
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, signalFd) != 0)
+        return;
+    QSocketNotifier *notifier = new QSocketNotifier(signalFd[1], QSocketNotifier::Read, app);
+    QObject::connect(notifier, SIGNAL(activated(int)), app, SLOT(quit()));
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = signalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGINT, &action, 0);
+    sigaction(SIGTERM, &action, 0);
+}
+#else
+static void watchSignals(QCoreApplication *)
+{
+}
+#endif
+
+static BaudRateType toBaud(int speed)
+{
+    switch (speed)
+    {
+    case 9600: return BAUD9600;
+    case 19200: return BAUD19200;
+    case 38400: return BAUD38400;
+    case 115200: return BAUD115200;
+    case 230400: return BAUD230400;
+    case 460800: return BAUD460800;
+    case 921600: return BAUD921600;
+    default: return BAUD57600;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QString serialPort;
+    int speed = 57600;
+    QString tcpHost;
+    quint16 tcpPort = 0;
+    quint16 relayPort = 0;
+    QString logName;
+    bool usage = false;
+    QStringList args = app.arguments();
+    for (int n = 1; n < args.size(); ++n)
+    {
+        if (args[n] == "-s" && n + 1 < args.size())
+            serialPort = args[++n];
+        else if (args[n] == "-b" && n + 1 < args.size())
+            speed = args[++n].toInt();
+        else if (args[n] == "-t" && n + 1 < args.size())
+        {
+            QStringList hostPort = args[++n].split(':');
+            tcpHost = hostPort[0];
+            tcpPort = hostPort.value(1).toUShort();
+        }
+        else if (args[n] == "-r" && n + 1 < args.size())
+            relayPort = args[++n].toUShort();
+        else if (args[n] == "-l" && n + 1 < args.size())
+            logName = args[++n];
+        else
+            usage = true;
+    }
+    if (usage || serialPort.isEmpty() == tcpHost.isEmpty() || (!tcpHost.isEmpty() && tcpPort == 0))
+    {
+        out << "Usage: optelemetryd (-s port [-b speed] | -t host:port) [-r relayport] [-l log.opl]" << endl;
+        out << "  -s port       serial port of the telemetry link" << endl;
+        out << "  -b speed      serial speed (default 57600)" << endl;
+        out << "  -t host:port  TCP telemetry link" << endl;
+        out << "  -r relayport  share the link with other programs, see TelemetryRelay" << endl;
+        out << "  -l log        write a log, .oplz logs are compressed" << endl;
+        return 1;
+    }
+
+    QIODevice *link;
+    if (!serialPort.isEmpty())
+    {
+        PortSettings set;
+        set.BaudRate = toBaud(speed);
+        set.DataBits = DATA_8;
+        set.Parity = PAR_NONE;
+        set.StopBits = STOP_1;
+        set.FlowControl = FLOW_OFF;
+        set.Timeout_Millisec = 500;
+        link = new QextSerialPort(serialPort, set, QextSerialPort::EventDriven);
+        if (!link->open(QIODevice::ReadWrite))
+        {
+            out << "Cannot open " << serialPort << endl;
+            return 1;
+        }
+    }
+    else
+    {
+        QTcpSocket *socket = new QTcpSocket();
+        socket->connectToHost(tcpHost, tcpPort);
+        if (!socket->waitForConnected())
+        {
+            out << "Cannot connect to " << tcpHost << ":" << tcpPort << endl;
+            return 1;
+        }
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        link = socket;
+    }
+
+    TelemetryDaemon daemon;
+    if (!daemon.start(link, relayPort, logName))
+        return 1;
+    watchSignals(&app);
+    int ret = app.exec();
+    // Closes the log cleanly on SIGINT/SIGTERM too
+    daemon.stop();
+    link->close();
+    delete link;
+    return ret;
+}
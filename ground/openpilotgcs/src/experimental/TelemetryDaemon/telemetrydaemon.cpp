@@ -0,0 +1,139 @@
+/**
+ ******************************************************************************
+ *
+ * @file       telemetrydaemon.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Headless telemetry link with logging and relaying
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "telemetrydaemon.h"
+#include "uavobjectmanager.h"
+#include "uavobjectsinit.h"
+#include "uavtalk/uavtalk.h"
+#include "uavtalk/telemetry.h"
+#include "uavtalk/telemetrymonitor.h"
+#include "logfile.h"
+#include <QDebug>
+
+TelemetryDaemon::TelemetryDaemon(QObject *parent) : QObject(parent),
+    link(0), utalk(0), telemetry(0), telemetryMon(0), logFile(0), logTalk(0)
+{
+    objMngr = new UAVObjectManager();
+    UAVObjectsInitialize(objMngr);
+    connect(&statsTimer, SIGNAL(timeout()), this, SLOT(reportStats()));
+}
+
+TelemetryDaemon::~TelemetryDaemon()
+{
+    stop();
+    delete objMngr;
+}
+
+/**
+ * Start the telemetry on an open link
+ * \param[in] relayPort port the link is shared on, 0 for none
+ * \param[in] logName log file, empty for none, .oplz logs are compressed
+ */
+bool TelemetryDaemon::start(QIODevice *link, quint16 relayPort, const QString &logName)
+{
+    this->link = link;
+    if (!logName.isEmpty())
+    {
+        logFile = new LogFile(this);
+        logFile->setFileName(logName);
+        logFile->setObjectManager(objMngr);
+        logFile->setCompressed(logName.endsWith(".oplz", Qt::CaseInsensitive));
+        if (!logFile->open(QIODevice::WriteOnly))
+        {
+            qWarning() << "Cannot write log" << logName;
+            delete logFile;
+            logFile = 0;
+            return false;
+        }
+        logTalk = new UAVTalk(logFile, objMngr);
+        QList< QList<UAVObject*> > objs = objMngr->getObjects();
+        for (int n = 0; n < objs.length(); ++n)
+        {
+            for (int i = 0; i < objs[n].length(); ++i)
+            {
+                connectObject(objs[n][i]);
+            }
+        }
+        connect(objMngr, SIGNAL(newInstance(UAVObject*)), this, SLOT(connectObject(UAVObject*)));
+    }
+
+    utalk = new UAVTalk(link, objMngr);
+    if (relayPort)
+        utalk->startRelay(relayPort);
+    telemetry = new Telemetry(utalk, objMngr);
+    telemetryMon = new TelemetryMonitor(objMngr, telemetry);
+    connect(telemetryMon, SIGNAL(connected()), this, SLOT(onConnected()));
+    connect(telemetryMon, SIGNAL(disconnected()), this, SLOT(onDisconnected()));
+    statsTimer.start(STATS_PERIOD_MS);
+    return true;
+}
+
+void TelemetryDaemon::stop()
+{
+    statsTimer.stop();
+    delete telemetryMon;
+    telemetryMon = 0;
+    delete telemetry;
+    telemetry = 0;
+    delete utalk;
+    utalk = 0;
+    if (logFile)
+    {
+        objMngr->disconnect(this);
+        delete logTalk;
+        logTalk = 0;
+        // Flushes the writer thread and writes the index
+        logFile->close();
+        delete logFile;
+        logFile = 0;
+    }
+}
+
+void TelemetryDaemon::connectObject(UAVObject *obj)
+{
+    connect(obj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(logObject(UAVObject*)));
+}
+
+void TelemetryDaemon::logObject(UAVObject *obj)
+{
+    if (logTalk)
+        logTalk->sendObject(obj, false, false);
+}
+
+void TelemetryDaemon::onConnected()
+{
+    qDebug() << "Autopilot connected";
+}
+
+void TelemetryDaemon::onDisconnected()
+{
+    qDebug() << "Autopilot disconnected";
+}
+
+void TelemetryDaemon::reportStats()
+{
+    UAVTalk::ComStats stats = utalk->getStats();
+    qDebug() << "rx" << stats.rxBytes << "bytes" << stats.rxObjects << "objects" << stats.rxErrors << "errors,"
+             << "tx" << stats.txBytes << "bytes" << stats.txErrors << "errors";
+    if (logFile && logFile->getDroppedPackets())
+        qDebug() << "log dropped" << logFile->getDroppedPackets() << "packets";
+}
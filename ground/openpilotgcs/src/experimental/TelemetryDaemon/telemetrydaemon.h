@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ *
+ * @file       telemetrydaemon.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Headless telemetry link with logging and relaying
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef TELEMETRYDAEMON_H
+#define TELEMETRYDAEMON_H
+
+#include <QObject>
+#include <QIODevice>
+#include <QString>
+#include <QTimer>
+
+class UAVObject;
+class UAVObjectManager;
+class UAVTalk;
+class Telemetry;
+class TelemetryMonitor;
+class LogFile;
+
+/**
+ * The telemetry stack of the GCS without the plugin manager or any widget:
+ * one link, the object manager, UAVTalk with its relay and an optional log.
+ * Everything runs on the thread of the event loop, which is idle between
+ * link reads, so it can be left running on small boards.
+ */
+class TelemetryDaemon : public QObject
+{
+    Q_OBJECT
+
+public:
+    TelemetryDaemon(QObject *parent = 0);
+    ~TelemetryDaemon();
+
+    bool start(QIODevice *link, quint16 relayPort, const QString &logName);
+    void stop();
+
+private slots:
+    void connectObject(UAVObject *obj);
+    void logObject(UAVObject *obj);
+    void onConnected();
+    void onDisconnected();
+    void reportStats();
+
+private:
+    static const int STATS_PERIOD_MS = 60000;
+
+    UAVObjectManager *objMngr;
+    QIODevice *link;
+    UAVTalk *utalk;
+    Telemetry *telemetry;
+    TelemetryMonitor *telemetryMon;
+    LogFile *logFile;
+    UAVTalk *logTalk;
+    QTimer statsTimer;
+};
+
+#endif // TELEMETRYDAEMON_H
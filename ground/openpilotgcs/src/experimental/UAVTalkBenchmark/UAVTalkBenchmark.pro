@@ -0,0 +1,31 @@
+#-------------------------------------------------
+#
+# Headless UAVTalk/UAVObject decode benchmark.
+# Build it from a GCS build tree after the plugins are built, e.g.
+#   qmake ../../src/experimental/UAVTalkBenchmark GCS_BUILD_TREE=<build>/ground/openpilotgcs
+#
+#-------------------------------------------------
+
+QT       += core network
+
+TARGET = uavtalkbenchmark
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+include(../../../openpilotgcs.pri)
+
+DESTDIR = $$GCS_APP_PATH
+LIBS += -L$$GCS_PLUGIN_PATH/OpenPilot
+INCLUDEPATH += $$GCS_SOURCE_TREE/src/plugins
+
+include(../../plugins/uavtalk/uavtalk.pri)
+
+linux-* {
+    QMAKE_LFLAGS += \'-Wl,-rpath,$$GCS_PLUGIN_PATH/OpenPilot:$$GCS_PLUGIN_PATH/OpenPilot/..:$$GCS_LIBRARY_PATH\'
+}
+
+HEADERS += decodecounter.h \
+           replaydevice.h
+SOURCES += main.cpp
@@ -0,0 +1,66 @@
+/**
+ ******************************************************************************
+ *
+ * @file       decodecounter.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Counts object updates decoded by the UAVTalk benchmark
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef DECODECOUNTER_H
+#define DECODECOUNTER_H
+
+#include <QObject>
+#include <QHash>
+#include "uavobjectmanager.h"
+
+/**
+ * Keeps the number of unpacked updates per object ID. Only connected for the
+ * profiling pass so the throughput runs are not slowed down by the slot calls.
+ */
+class DecodeCounter : public QObject
+{
+    Q_OBJECT
+
+public:
+    DecodeCounter(UAVObjectManager* objMngr)
+    {
+        QList< QList<UAVObject*> > objs = objMngr->getObjects();
+        for (int n = 0; n < objs.length(); ++n)
+        {
+            for (int i = 0; i < objs[n].length(); ++i)
+            {
+                connectObject(objs[n][i]);
+            }
+        }
+        connect(objMngr, SIGNAL(newInstance(UAVObject*)), this, SLOT(connectObject(UAVObject*)));
+    }
+
+    QHash<quint32, quint32> counts;
+
+private slots:
+    void connectObject(UAVObject* obj)
+    {
+        connect(obj, SIGNAL(objectUnpacked(UAVObject*)), this, SLOT(objectUnpacked(UAVObject*)));
+    }
+
+    void objectUnpacked(UAVObject* obj)
+    {
+        ++counts[obj->getObjID()];
+    }
+};
+
+#endif // DECODECOUNTER_H
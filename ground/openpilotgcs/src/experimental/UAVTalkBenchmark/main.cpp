@@ -0,0 +1,330 @@
+/**
+ ******************************************************************************
+ *
+ * @file       main.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Headless benchmark of the GCS telemetry decode path. Recorded
+ *             .opl logs are pushed through UAVTalk into a UAVObjectManager as
+ *             fast as possible.
+ *
+ *             Usage: uavtalkbenchmark [-n runs] [-b blocksize] log.opl [...]
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <QtCore/QCoreApplication>
+#include <QStringList>
+#include <QFile>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QtEndian>
+#include <extensionsystem/pluginmanager.h>
+#include "uavobjectmanager.h"
+#include "uavobjectsinit.h"
+#include "uavtalk/uavtalk.h"
+#include "replaydevice.h"
+#include "decodecounter.h"
+
+#include <stdlib.h>
+#include <new>
+#include <algorithm>
+
+// Heap allocation counter. With glibc malloc itself is wrapped so Qt's
+// containers are counted too, elsewhere only operator new is seen.
+static quint64 allocationCount = 0;
+
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size)
+{
+    ++allocationCount;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size)
+{
+    ++allocationCount;
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    ++allocationCount;
+    return __libc_realloc(ptr, size);
+}
+}
+#else
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+    ++allocationCount;
+    void* ptr = malloc(size);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size) throw(std::bad_alloc)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) throw()
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) throw()
+{
+    free(ptr);
+}
+#endif
+
+/**
+ * Recorded log, the raw link data and the size of each recorded read
+ */
+typedef struct {
+    QByteArray data;
+    QVector<int> chunks;
+    quint32 durationMs;
+} LogData;
+
+typedef struct {
+    UAVObject* obj;
+    quint32 updates;
+    double nsPerUnpack;
+} ObjectCost;
+
+static bool objectCostHigher(const ObjectCost& a, const ObjectCost& b)
+{
+    return a.updates * a.nsPerUnpack > b.updates * b.nsPerUnpack;
+}
+
+/**
+ * Read a log in the format written by LogFile: a sequence of
+ * quint32 timestamp, qint64 size and that many bytes of link data.
+ * Version 2 logs wrap the records in a header and a trailing index.
+ */
+static bool loadLog(const QString& fileName, LogData& log, QTextStream& out)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        out << "Unable to open " << fileName << endl;
+        return false;
+    }
+    QByteArray raw = file.readAll();
+    const char* p = raw.constData();
+    const char* end = p + raw.size();
+    const qint64 headerSize = sizeof(quint32) + sizeof(qint64);
+
+    if (raw.size() >= 16 && memcmp(p, "OPLOGHDR", 8) == 0)
+    {
+        if (qFromLittleEndian<quint32>((const uchar*)p + 8) != 2)
+        {
+            out << fileName << ": compressed or unknown log version, not supported" << endl;
+            return false;
+        }
+        quint32 length = qFromLittleEndian<quint32>((const uchar*)p + 12);
+        p = qMin(end, p + 16 + length);
+        if (end - p >= 16 && memcmp(end - 8, "OPLOGIDX", 8) == 0)
+        {
+            qint64 indexOffset = qFromLittleEndian<qint64>((const uchar*)end - 16);
+            if (indexOffset >= p - raw.constData() && indexOffset <= raw.size() - 16)
+                end = raw.constData() + indexOffset;
+        }
+    }
+
+    while (end - p >= headerSize)
+    {
+        quint32 timeStamp;
+        qint64 dataSize;
+        memcpy(&timeStamp, p, sizeof(timeStamp));
+        memcpy(&dataSize, p + sizeof(timeStamp), sizeof(dataSize));
+        p += headerSize;
+        if (dataSize < 1 || dataSize > end - p)
+        {
+            out << fileName << ": stopping at corrupted or truncated record" << endl;
+            break;
+        }
+        log.data.append(p, dataSize);
+        log.chunks.append(dataSize);
+        log.durationMs = timeStamp;
+        p += dataSize;
+    }
+    return true;
+}
+
+/**
+ * Push the whole log through UAVTalk once
+ */
+static void decodeLog(ReplayDevice& device, const LogData& log, int blockSize)
+{
+    const char* data = log.data.constData();
+    if (blockSize > 0)
+    {
+        for (int offset = 0; offset < log.data.size(); offset += blockSize)
+        {
+            device.feed(data + offset, qMin(blockSize, log.data.size() - offset));
+        }
+    }
+    else
+    {
+        for (int n = 0; n < log.chunks.size(); ++n)
+        {
+            device.feed(data, log.chunks[n]);
+            data += log.chunks[n];
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    int runs = 5;
+    int blockSize = 0;
+    QStringList files;
+    QStringList args = app.arguments();
+    for (int n = 1; n < args.size(); ++n)
+    {
+        if (args[n] == "-n" && n + 1 < args.size())
+            runs = qMax(1, args[++n].toInt());
+        else if (args[n] == "-b" && n + 1 < args.size())
+            blockSize = qMax(0, args[++n].toInt());
+        else
+            files << args[n];
+    }
+    if (files.isEmpty())
+    {
+        out << "Usage: uavtalkbenchmark [-n runs] [-b blocksize] log.opl [...]" << endl;
+        out << "  -n runs       timed runs over all logs (default 5)" << endl;
+        out << "  -b blocksize  feed fixed size blocks instead of the recorded reads" << endl;
+        return 1;
+    }
+
+    LogData log;
+    log.durationMs = 0;
+    quint32 totalDurationMs = 0;
+    foreach (QString fileName, files)
+    {
+        if (!loadLog(fileName, log, out))
+            return 1;
+        totalDurationMs += log.durationMs;
+    }
+    out << "Loaded " << files.size() << " log(s): " << log.data.size() << " bytes in "
+        << log.chunks.size() << " reads, " << totalDurationMs / 1000.0 << " s of flight" << endl;
+
+    // UAVTalk looks up the general settings through the plugin manager
+    ExtensionSystem::PluginManager pluginManager;
+    UAVObjectManager* objMngr = new UAVObjectManager();
+    UAVObjectsInitialize(objMngr);
+    ReplayDevice device;
+    UAVTalk* utalk = new UAVTalk(&device, objMngr);
+
+    // Warm up, this also creates the multi instance objects found in the logs
+    decodeLog(device, log, blockSize);
+
+    // Timed runs
+    qint64 bestNs = 0;
+    qint64 totalNs = 0;
+    quint64 objects = 0;
+    quint64 bytes = 0;
+    quint64 errors = 0;
+    quint64 allocations = 0;
+    for (int run = 0; run < runs; ++run)
+    {
+        utalk->resetStats();
+        quint64 allocationsBefore = allocationCount;
+        QElapsedTimer timer;
+        timer.start();
+        decodeLog(device, log, blockSize);
+        qint64 ns = timer.nsecsElapsed();
+        allocations += allocationCount - allocationsBefore;
+        UAVTalk::ComStats stats = utalk->getStats();
+        objects += stats.rxObjects;
+        bytes += stats.rxBytes;
+        errors += stats.rxErrors;
+        totalNs += ns;
+        if (run == 0 || ns < bestNs)
+            bestNs = ns;
+    }
+
+    double runObjects = (double)objects / runs;
+    double runBytes = (double)bytes / runs;
+    out << endl << "Throughput over " << runs << " run(s)" << endl;
+    out << "  objects/run:      " << runObjects << " (" << (double)errors / runs << " rx errors)" << endl;
+    out << "  best:             " << runObjects / (bestNs / 1e9) << " objects/s, "
+        << runBytes / (bestNs / 1e9) / (1024 * 1024) << " MB/s" << endl;
+    out << "  average:          " << objects / (totalNs / 1e9) << " objects/s, "
+        << bytes / (totalNs / 1e9) / (1024 * 1024) << " MB/s" << endl;
+    out << "  allocations/obj:  " << (objects > 0 ? (double)allocations / objects : 0.0) << endl;
+    if (totalDurationMs > 0)
+        out << "  vs. real time:    " << (totalDurationMs / 1000.0) / (bestNs / 1e9) << "x" << endl;
+
+    // Per object decode cost, count the updates then time unpack() on their own
+    DecodeCounter* counter = new DecodeCounter(objMngr);
+    decodeLog(device, log, blockSize);
+    QHash<quint32, quint32> counts = counter->counts;
+    delete counter;
+
+    QVector<ObjectCost> costs;
+    for (QHash<quint32, quint32>::const_iterator itr = counts.constBegin(); itr != counts.constEnd(); ++itr)
+    {
+        UAVObject* obj = objMngr->getObject(itr.key());
+        if (obj == NULL)
+            continue;
+        QByteArray buffer(obj->getNumBytes(), 0);
+        obj->pack((quint8*)buffer.data());
+        const int iterations = 10000;
+        QElapsedTimer timer;
+        timer.start();
+        for (int n = 0; n < iterations; ++n)
+        {
+            obj->unpack((const quint8*)buffer.constData());
+        }
+        ObjectCost cost;
+        cost.obj = obj;
+        cost.updates = itr.value();
+        cost.nsPerUnpack = (double)timer.nsecsElapsed() / iterations;
+        costs.append(cost);
+    }
+    std::sort(costs.begin(), costs.end(), objectCostHigher);
+
+    double totalCost = 0;
+    foreach (ObjectCost cost, costs)
+        totalCost += cost.updates * cost.nsPerUnpack;
+
+    out << endl << "Decode cost per object (unpack only)" << endl;
+    out << qSetFieldWidth(28) << left << "  object" << qSetFieldWidth(10) << right
+        << "updates" << "bytes" << "ns/obj" << "share" << qSetFieldWidth(0) << endl;
+    foreach (ObjectCost cost, costs)
+    {
+        out << qSetFieldWidth(28) << left << QString("  ") + cost.obj->getName() << qSetFieldWidth(10) << right
+            << cost.updates << cost.obj->getNumBytes() << QString::number(cost.nsPerUnpack, 'f', 0)
+            << QString::number(100.0 * cost.updates * cost.nsPerUnpack / totalCost, 'f', 1) + "%"
+            << qSetFieldWidth(0) << endl;
+    }
+
+    delete utalk;
+    delete objMngr;
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ ******************************************************************************
+ *
+ * @file       replaydevice.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      In-memory device feeding recorded data to UAVTalk
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef REPLAYDEVICE_H
+#define REPLAYDEVICE_H
+
+#include <QIODevice>
+#include <string.h>
+
+/**
+ * Unbuffered sequential device, feed() hands a block to UAVTalk synchronously
+ * through readyRead() so no event loop is involved. Anything UAVTalk sends
+ * back (ACKs, NACKs) is dropped.
+ */
+class ReplayDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    ReplayDevice() : chunk(0), chunkSize(0), pos(0)
+    {
+        open(QIODevice::ReadWrite | QIODevice::Unbuffered);
+    }
+
+    void feed(const char* data, qint64 size)
+    {
+        chunk = data;
+        chunkSize = size;
+        pos = 0;
+        emit readyRead();
+    }
+
+    bool isSequential() const { return true; }
+    qint64 bytesAvailable() const { return chunkSize - pos; }
+
+protected:
+    qint64 readData(char* data, qint64 maxlen)
+    {
+        qint64 count = qMin(maxlen, chunkSize - pos);
+        memcpy(data, chunk + pos, count);
+        pos += count;
+        return count;
+    }
+
+    qint64 writeData(const char* data, qint64 len)
+    {
+        Q_UNUSED(data);
+        return len;
+    }
+
+private:
+    const char* chunk;
+    qint64 chunkSize;
+    qint64 pos;
+};
+
+#endif // REPLAYDEVICE_H
@@ -35,6 +35,7 @@
 
 #include <QtCore/QMetaProperty>
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QTextStream>
 #include <QtCore/QWriteLocker>
 #include <QtDebug>
@@ -245,6 +246,36 @@ void PluginManager::loadPlugins()
     return d->loadPlugins();
 }
 
+/*!
+    \fn PluginSpec *PluginManager::pluginProviding(const QString &itemId) const
+    The lazy plugin that lists \a itemId among its provided items, or 0.
+
+    \sa PluginSpec::providedItems()
+*/
+PluginSpec *PluginManager::pluginProviding(const QString &itemId) const
+{
+    foreach (PluginSpec *spec, d->pluginSpecs) {
+        foreach (const PluginProvidedItem &item, spec->providedItems()) {
+            if (item.id == itemId)
+                return spec;
+        }
+    }
+    return 0;
+}
+
+/*!
+    \fn bool PluginManager::loadLazyPlugin(PluginSpec *spec)
+    Loads a lazy plugin and the dependencies not loaded yet, taking each of them
+    through all the steps loadPlugins() does. Returns true if \a spec is running,
+    which it already is if it was loaded before.
+
+    \sa lazyPluginLoaded()
+*/
+bool PluginManager::loadLazyPlugin(PluginSpec *spec)
+{
+    return d->loadLazyPlugin(spec);
+}
+
 /*!
     \fn QStringList PluginManager::pluginPaths() const
     The list of paths were the plugin manager searches for plugins.
@@ -418,6 +449,32 @@ void PluginManager::formatPluginVersions(QTextStream &str) const
     }
 }
 
+/*!
+    \fn PluginManager::formatPluginTimes(QTextStream &str) const
+
+    Format the time each plugin took to load, initialize and initialize its
+    extensions, in ms. Lazy plugins not loaded yet are listed as such.
+*/
+
+void PluginManager::formatPluginTimes(QTextStream &str) const
+{
+    int total = 0;
+    foreach (const PluginSpec *ps, d->pluginSpecs) {
+        str << "  " << ps->name().leftJustified(24);
+        if (ps->loadTime() < 0) {
+            str << (ps->isLazy() ? "lazy, not loaded" : "not loaded") << '\n';
+            continue;
+        }
+        int initializeTime = qMax(0, ps->initializeTime());
+        int extensionsTime = qMax(0, ps->extensionsTime());
+        int sum = ps->loadTime() + initializeTime + extensionsTime;
+        total += sum;
+        str << "load " << ps->loadTime() << "  initialize " << initializeTime
+            << "  extensions " << extensionsTime << "  total " << sum << " ms\n";
+    }
+    str << "  " << QString("All plugins").leftJustified(24) << total << " ms\n";
+}
+
 void PluginManager::startTests()
 {
 #ifdef WITH_TESTS
@@ -507,7 +564,12 @@ PluginManagerPrivate::~PluginManagerPrivate()
 
 void PluginManagerPrivate::stopAll()
 {
-    QList<PluginSpec *> queue = loadQueue();
+    // Lazy plugins that were never loaded have nothing to stop
+    QList<PluginSpec *> queue;
+    foreach (PluginSpec *spec, loadQueue()) {
+        if (spec->plugin())
+            queue.append(spec);
+    }
     foreach (PluginSpec *spec, queue) {
         loadPlugin(spec, PluginSpec::Stopped);
     }
@@ -573,7 +635,14 @@ void PluginManagerPrivate::removeObject(QObject *obj)
 */
 void PluginManagerPrivate::loadPlugins()
 {
-    QList<PluginSpec *> queue = loadQueue();
+    // Lazy plugins are left out unless another plugin depends on them
+    QList<PluginSpec *> queue;
+    foreach (PluginSpec *spec, pluginSpecs) {
+        if (spec->isLazy())
+            continue;
+        QList<PluginSpec *> circularityCheckQueue;
+        loadQueue(spec, queue, circularityCheckQueue);
+    }
     foreach (PluginSpec *spec, queue) {
         loadPlugin(spec, PluginSpec::Loaded);
     }
@@ -590,6 +659,45 @@ void PluginManagerPrivate::loadPlugins()
     emit q->pluginsLoadEnded();
 }
 
+/*!
+    \fn bool PluginManagerPrivate::loadLazyPlugin(PluginSpec *spec)
+    \internal
+*/
+bool PluginManagerPrivate::loadLazyPlugin(PluginSpec *spec)
+{
+    if (!spec || spec->hasError())
+        return false;
+    if (spec->state() == PluginSpec::Running)
+        return true;
+    QList<PluginSpec *> queue;
+    QList<PluginSpec *> circularityCheckQueue;
+    if (!loadQueue(spec, queue, circularityCheckQueue))
+        return false;
+    // Only what is not running yet, the dependencies loaded at startup stay as they are
+    QList<PluginSpec *> pending;
+    foreach (PluginSpec *queued, queue) {
+        if (queued->state() != PluginSpec::Running)
+            pending.append(queued);
+    }
+    foreach (PluginSpec *queued, pending) {
+        loadPlugin(queued, PluginSpec::Loaded);
+    }
+    foreach (PluginSpec *queued, pending) {
+        loadPlugin(queued, PluginSpec::Initialized);
+    }
+    QListIterator<PluginSpec *> it(pending);
+    it.toBack();
+    while (it.hasPrevious()) {
+        loadPlugin(it.previous(), PluginSpec::Running);
+    }
+    emit q->pluginsChanged();
+    foreach (PluginSpec *queued, pending) {
+        if (queued->state() == PluginSpec::Running)
+            emit q->lazyPluginLoaded(queued);
+    }
+    return spec->state() == PluginSpec::Running;
+}
+
 /*!
     \fn void PluginManagerPrivate::loadQueue()
     \internal
@@ -656,15 +764,20 @@ void PluginManagerPrivate::loadPlugin(PluginSpec *spec, PluginSpec::State destSt
 {
     if (spec->hasError())
         return;
+    QElapsedTimer timer;
+    timer.start();
     if (destState == PluginSpec::Running) {
         spec->d->initializeExtensions();
+        spec->d->extensionsTime = timer.elapsed();
         return;
     } else if (destState == PluginSpec::Deleted) {
         spec->d->kill();
         return;
     }
     foreach (PluginSpec *depSpec, spec->dependencySpecs()) {
-        if (depSpec->state() != destState) {
+        // Dependencies loaded before, at startup or for another lazy plugin, are further along
+        if (depSpec->state() != destState && !(depSpec->state() == PluginSpec::Running
+                                               && destState != PluginSpec::Stopped)) {
             spec->d->hasError = true;
             spec->d->errorString =
                 PluginManager::tr("Cannot load plugin because dependency failed to load: %1(%2)\nReason: %3")
@@ -672,11 +785,13 @@ void PluginManagerPrivate::loadPlugin(PluginSpec *spec, PluginSpec::State destSt
             return;
         }
     }
-    if (destState == PluginSpec::Loaded)
+    if (destState == PluginSpec::Loaded) {
         spec->d->loadLibrary();
-    else if (destState == PluginSpec::Initialized)
+        spec->d->loadTime = timer.elapsed();
+    } else if (destState == PluginSpec::Initialized) {
         spec->d->initializePlugin();
-    else if (destState == PluginSpec::Stopped)
+        spec->d->initializeTime = timer.elapsed();
+    } else if (destState == PluginSpec::Stopped)
         spec->d->stop();
 }
 
@@ -91,6 +91,8 @@ public:
 
     // Plugin operations
     void loadPlugins();
+    PluginSpec *pluginProviding(const QString &itemId) const;
+    bool loadLazyPlugin(PluginSpec *spec);
     QStringList pluginPaths() const;
     void setPluginPaths(const QStringList &paths);
     QList<PluginSpec *> plugins() const;
@@ -106,6 +108,7 @@ public:
     static void formatOptions(QTextStream &str, int optionIndentation, int descriptionIndentation);
     void formatPluginOptions(QTextStream &str, int optionIndentation, int descriptionIndentation) const;
     void formatPluginVersions(QTextStream &str) const;
+    void formatPluginTimes(QTextStream &str) const;
 
     bool runningTests() const;
     QString testDataDirectory() const;
@@ -116,6 +119,7 @@ signals:
 
     void pluginsChanged();
     void pluginsLoadEnded();
+    void lazyPluginLoaded(ExtensionSystem::PluginSpec *spec);
 private slots:
     void startTests();
 
@@ -56,6 +56,7 @@ public:
 
     // Plugin operations
     void loadPlugins();
+    bool loadLazyPlugin(PluginSpec *spec);
     void setPluginPaths(const QStringList &paths);
     QList<PluginSpec *> loadQueue();
     void loadPlugin(PluginSpec *spec, PluginSpec::State destState);
@@ -121,6 +121,12 @@
     \value Deleted
             The plugin instance has been deleted.
 */
+
+/*!
+    \class ExtensionSystem::PluginProvidedItem
+    \brief Struct that contains an item a lazy plugin provides, e.g. the class id and
+    name of a gadget, so it can be listed without loading the plugin.
+*/
 using namespace ExtensionSystem;
 using namespace ExtensionSystem::Internal;
 
@@ -243,6 +249,25 @@ PluginSpec::PluginArgumentDescriptions PluginSpec::argumentDescriptions() const
     return d->argumentDescriptions;
 }
 
+/*!
+    \fn bool PluginSpec::isLazy() const
+    Lazy plugins are not loaded by PluginManager::loadPlugins(), only once something
+    asks for one of their providedItems() or a plugin depending on them is loaded.
+*/
+bool PluginSpec::isLazy() const
+{
+    return d->lazy;
+}
+
+/*!
+    \fn PluginSpec::PluginProvidedItems PluginSpec::providedItems() const
+    The items a lazy plugin provides, as listed in its xml description file.
+*/
+PluginSpec::PluginProvidedItems PluginSpec::providedItems() const
+{
+    return d->providedItems;
+}
+
 /*!
     \fn QString PluginSpec::location() const
     The absolute path to the directory containing the plugin xml description file
@@ -322,6 +347,33 @@ QString PluginSpec::errorString() const
     return d->errorString;
 }
 
+/*!
+    \fn int PluginSpec::loadTime() const
+    Milliseconds it took to load the plugin library, -1 if it was not loaded.
+*/
+int PluginSpec::loadTime() const
+{
+    return d->loadTime;
+}
+
+/*!
+    \fn int PluginSpec::initializeTime() const
+    Milliseconds spent in IPlugin::initialize(), -1 if it was not called.
+*/
+int PluginSpec::initializeTime() const
+{
+    return d->initializeTime;
+}
+
+/*!
+    \fn int PluginSpec::extensionsTime() const
+    Milliseconds spent in IPlugin::extensionsInitialized(), -1 if it was not called.
+*/
+int PluginSpec::extensionsTime() const
+{
+    return d->extensionsTime;
+}
+
 /*!
     \fn bool PluginSpec::provides(const QString &pluginName, const QString &version) const
     Returns if this plugin can be used to fill in a dependency of the given
@@ -376,15 +428,24 @@ namespace {
     const char * const ARGUMENT = "argument";
     const char * const ARGUMENT_NAME = "name";
     const char * const ARGUMENT_PARAMETER = "parameter";
+    const char * const PLUGIN_LAZY = "lazy";
+    const char * const PROVIDES = "provides";
+    const char * const PROVIDED_ITEM = "item";
+    const char * const PROVIDED_ITEM_ID = "id";
+    const char * const PROVIDED_ITEM_NAME = "name";
 }
 /*!
     \fn PluginSpecPrivate::PluginSpecPrivate(PluginSpec *spec)
     \internal
 */
 PluginSpecPrivate::PluginSpecPrivate(PluginSpec *spec)
-    : plugin(0),
+    : lazy(false),
+    plugin(0),
     state(PluginSpec::Invalid),
     hasError(false),
+    loadTime(-1),
+    initializeTime(-1),
+    extensionsTime(-1),
     q(spec)
 {
 }
@@ -506,6 +567,7 @@ void PluginSpecPrivate::readPluginSpec(QXmlStreamReader &reader)
     } else if (compatVersion.isEmpty()) {
         compatVersion = version;
     }
+    lazy = (reader.attributes().value(PLUGIN_LAZY) == QLatin1String("true"));
     while (!reader.atEnd()) {
         reader.readNext();
         switch (reader.tokenType()) {
@@ -525,6 +587,8 @@ void PluginSpecPrivate::readPluginSpec(QXmlStreamReader &reader)
                 readDependencies(reader);
             else if (element == ARGUMENTLIST)
                 readArgumentDescriptions(reader);
+            else if (element == PROVIDES)
+                readProvidedItems(reader);
             else
                 reader.raiseError(msgInvalidElement(name));
             break;
@@ -594,6 +658,50 @@ void PluginSpecPrivate::readArgumentDescription(QXmlStreamReader &reader)
     argumentDescriptions.push_back(arg);
 }
 
+/*!
+    \fn void PluginSpecPrivate::readProvidedItems(QXmlStreamReader &reader)
+    \internal
+*/
+void PluginSpecPrivate::readProvidedItems(QXmlStreamReader &reader)
+{
+    QString element;
+    while (!reader.atEnd()) {
+        reader.readNext();
+        switch (reader.tokenType()) {
+        case QXmlStreamReader::StartElement:
+            element = reader.name().toString();
+            if (element == PROVIDED_ITEM) {
+                PluginProvidedItem item;
+                item.id = reader.attributes().value(PROVIDED_ITEM_ID).toString();
+                if (item.id.isEmpty()) {
+                    reader.raiseError(msgAttributeMissing(PROVIDED_ITEM, PROVIDED_ITEM_ID));
+                    return;
+                }
+                item.name = reader.attributes().value(PROVIDED_ITEM_NAME).toString();
+                providedItems.append(item);
+                reader.readNext();
+                if (reader.tokenType() != QXmlStreamReader::EndElement)
+                    reader.raiseError(msgUnexpectedToken());
+            } else {
+                reader.raiseError(msgInvalidElement(name));
+            }
+            break;
+        case QXmlStreamReader::Comment:
+        case QXmlStreamReader::Characters:
+            break;
+        case QXmlStreamReader::EndElement:
+            element = reader.name().toString();
+            if (element == PROVIDES)
+                return;
+            reader.raiseError(msgUnexpectedClosing(element));
+            break;
+        default:
+            reader.raiseError(msgUnexpectedToken());
+            break;
+        }
+    }
+}
+
 /*!
     \fn void PluginSpecPrivate::readDependencies(QXmlStreamReader &reader)
     \internal
@@ -61,6 +61,12 @@ struct EXTENSIONSYSTEM_EXPORT PluginArgumentDescription
     QString description;
 };
 
+struct EXTENSIONSYSTEM_EXPORT PluginProvidedItem
+{
+    QString id;
+    QString name;
+};
+
 class EXTENSIONSYSTEM_EXPORT PluginSpec
 {
 public:
@@ -82,6 +88,11 @@ public:
     typedef QList<PluginArgumentDescription> PluginArgumentDescriptions;
     PluginArgumentDescriptions argumentDescriptions() const;
 
+    // lazy plugins are only loaded when one of the items they provide is needed
+    bool isLazy() const;
+    typedef QList<PluginProvidedItem> PluginProvidedItems;
+    PluginProvidedItems providedItems() const;
+
     // other information, valid after 'Read' state is reached
     QString location() const;
     QString filePath() const;
@@ -103,6 +114,11 @@ public:
     bool hasError() const;
     QString errorString() const;
 
+    // time spent in each loading step in ms, -1 if the step did not run
+    int loadTime() const;
+    int initializeTime() const;
+    int extensionsTime() const;
+
 private:
     PluginSpec();
 
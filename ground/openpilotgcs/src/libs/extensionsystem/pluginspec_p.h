@@ -74,12 +74,18 @@ public:
 
     QList<PluginSpec *> dependencySpecs;
     PluginSpec::PluginArgumentDescriptions argumentDescriptions;
+    bool lazy;
+    PluginSpec::PluginProvidedItems providedItems;
     IPlugin *plugin;
 
     PluginSpec::State state;
     bool hasError;
     QString errorString;
 
+    int loadTime;
+    int initializeTime;
+    int extensionsTime;
+
     static bool isValidVersion(const QString &version);
     static int versionCompare(const QString &version1, const QString &version2);
 
@@ -92,6 +98,7 @@ private:
     void readDependencyEntry(QXmlStreamReader &reader);
     void readArgumentDescriptions(QXmlStreamReader &reader);
     void readArgumentDescription(QXmlStreamReader &reader);
+    void readProvidedItems(QXmlStreamReader &reader);
 
     static QRegExp &versionRegExp();
 };
@@ -84,6 +84,7 @@ HEADERS_GLC_IO +=		io/glc_objmtlloader.h \
 						io/glc_worldto3dxml.h \
 						io/glc_bsreptoworld.h \
 						io/glc_xmlutil.h \
+						io/glc_textutil.h \
 						io/glc_fileloader.h \
 						io/glc_worldreaderplugin.h \
 						io/glc_worldreaderhandler.h
@@ -33,6 +33,7 @@
 #include "../sceneGraph/glc_structreference.h"
 #include "../sceneGraph/glc_structinstance.h"
 #include "../sceneGraph/glc_structoccurence.h"
+#include "glc_textutil.h"
 #include <QTextStream>
 #include <QFileInfo>
 #include <QGLContext>
@@ -53,6 +54,9 @@ GLC_ObjToWorld::GLC_ObjToWorld()
 , m_Positions()
 , m_Normals()
 , m_Texels()
+, m_pCursor(NULL)
+, m_pEnd(NULL)
+, m_MergedLine()
 {
 }
 
@@ -89,40 +93,41 @@ GLC_World* GLC_ObjToWorld::CreateWorldFromObj(QFile &file)
 	// Create Working variables
 	int currentQuantumValue= 0;
 	int previousQuantumValue= 0;
-	int numberOfLine= 0;
 
-	// Create the input file stream
-	QTextStream objStream(&file);
-
-	// QString buffer
-	QString lineBuff;
+	// The whole file is parsed in place, mapped when possible
+	QByteArray fallback;
+	qint64 size= 0;
+	const char* pData= glcTextUtil::mapFile(file, &fallback, &size);
+	m_pEnd= pData + size;
 
 	QString mtlLibLine;
 
 	//////////////////////////////////////////////////////////////////
-	// Searching mtllib attribute
-	//////////////////////////////////////////////////////////////////
-	while (!objStream.atEnd() && !lineBuff.contains("mtllib"))
-	{
-		++numberOfLine;
-		lineBuff= objStream.readLine();
-		if (lineBuff.contains("mtllib")) mtlLibLine= lineBuff;
-	}
-
-	//////////////////////////////////////////////////////////////////
-	// Count the number of lines of the OBJ file
+	// Searching mtllib attribute and counting the bulk data to reserve it
 	//////////////////////////////////////////////////////////////////
-	while (!objStream.atEnd())
+	int positionCount= 0;
+	int normalCount= 0;
+	int texelCount= 0;
+	const char* pLine= pData;
+	while (pLine < m_pEnd)
 	{
-		++numberOfLine;
-		objStream.readLine();
+		pLine= glcTextUtil::skipBlanks(pLine, m_pEnd);
+		const char* pLineEnd= glcTextUtil::endOfLine(pLine, m_pEnd);
+		if ((pLineEnd - pLine) > 1 && (*pLine == 'v'))
+		{
+			if ((pLine[1] == ' ') || (pLine[1] == '\t')) ++positionCount;
+			else if (pLine[1] == 'n') ++normalCount;
+			else if (pLine[1] == 't') ++texelCount;
+		}
+		else if (mtlLibLine.isEmpty() && glcTextUtil::isKeyword(pLine, pLineEnd, "mtllib"))
+		{
+			mtlLibLine= QString::fromLocal8Bit(pLine, pLineEnd - pLine).trimmed();
+		}
+		pLine= pLineEnd + 1;
 	}
-
-	//////////////////////////////////////////////////////////////////
-	// Reset the stream
-	//////////////////////////////////////////////////////////////////
-	objStream.resetStatus();
-	objStream.seek(0);
+	m_Positions.reserve(positionCount * 3);
+	m_Normals.reserve(normalCount * 3);
+	m_Texels.reserve(texelCount * 2);
 
 	//////////////////////////////////////////////////////////////////
 	// if mtl file found, load it
@@ -159,15 +164,14 @@ GLC_World* GLC_ObjToWorld::CreateWorldFromObj(QFile &file)
 	//////////////////////////////////////////////////////////////////
 	emit currentQuantum(currentQuantumValue);
 	m_CurrentLineNumber= 0;
-	while (!objStream.atEnd())
+	m_pCursor= pData;
+	while (m_pCursor < m_pEnd)
 	{
-		++m_CurrentLineNumber;
-		lineBuff= objStream.readLine();
-
-		mergeLines(&lineBuff, &objStream);
+		const char* pLineEnd= NULL;
+		pLine= nextLine(&pLineEnd);
 
-		scanLigne(lineBuff);
-		currentQuantumValue = static_cast<int>((static_cast<double>(m_CurrentLineNumber) / numberOfLine) * 100);
+		scanLigne(pLine, pLineEnd);
+		currentQuantumValue = static_cast<int>((static_cast<double>(m_pCursor - pData) / size) * 100);
 		if (currentQuantumValue > previousQuantumValue)
 		{
 			emit currentQuantum(currentQuantumValue);
@@ -175,6 +179,11 @@ GLC_World* GLC_ObjToWorld::CreateWorldFromObj(QFile &file)
 		previousQuantumValue= currentQuantumValue;
 
 	}
+	m_pCursor= m_pEnd= NULL;
+	m_MergedLine.clear();
+	m_Positions.clear();
+	m_Normals.clear();
+	m_Texels.clear();
 	file.close();
 
 	addCurrentObjMeshToWorld();
@@ -227,36 +236,67 @@ QString GLC_ObjToWorld::getMtlLibFileName(QString line)
 	return mtlFileName;
 }
 
+// Return the next line of the OBJ file
+const char* GLC_ObjToWorld::nextLine(const char** pLineEnd)
+{
+	++m_CurrentLineNumber;
+	const char* pLine= glcTextUtil::skipBlanks(m_pCursor, m_pEnd);
+	const char* pEnd= glcTextUtil::endOfLine(pLine, m_pEnd);
+	m_pCursor= (pEnd < m_pEnd) ? pEnd + 1 : m_pEnd;
+	while ((pEnd > pLine) && ((pEnd[-1] == ' ') || (pEnd[-1] == '\t') || (pEnd[-1] == '\r'))) --pEnd;
+	if ((pEnd == pLine) || (pEnd[-1] != '\\'))
+	{
+		*pLineEnd= pEnd;
+		return pLine;
+	}
+	// Merge Mutli line in one
+	m_MergedLine.clear();
+	while ((pEnd > pLine) && (pEnd[-1] == '\\'))
+	{
+		m_MergedLine.append(pLine, pEnd - pLine - 1);
+		m_MergedLine.append(' ');
+		if (m_pCursor == m_pEnd) break;
+		++m_CurrentLineNumber;
+		pLine= m_pCursor;
+		pEnd= glcTextUtil::endOfLine(pLine, m_pEnd);
+		m_pCursor= (pEnd < m_pEnd) ? pEnd + 1 : m_pEnd;
+		while ((pEnd > pLine) && ((pEnd[-1] == ' ') || (pEnd[-1] == '\t') || (pEnd[-1] == '\r'))) --pEnd;
+		if ((pEnd == pLine) || (pEnd[-1] != '\\'))
+		{
+			m_MergedLine.append(pLine, pEnd - pLine);
+		}
+	}
+	*pLineEnd= m_MergedLine.constData() + m_MergedLine.size();
+	return m_MergedLine.constData();
+}
+
 // Scan a line previously extracted from OBJ file
-void GLC_ObjToWorld::scanLigne(QString &line)
+void GLC_ObjToWorld::scanLigne(const char* pLine, const char* pLineEnd)
 {
-	line= line.trimmed();
+	if (pLine == pLineEnd) return;
 	// Search Vertexs vectors
-	if (line.startsWith("v ")|| line.startsWith(QString("v") + QString(QChar(9))))
+	if (glcTextUtil::isKeyword(pLine, pLineEnd, "v"))
 	{
-		line.remove(0,2); // Remove first 2 char
-		m_Positions.append(extract3dVect(line));
+		extract3dVect(pLine + 1, pLineEnd, &m_Positions);
 		m_FaceType = notSet;
 	}
 
 	// Search texture coordinate vectors
-	else if (line.startsWith("vt ")|| line.startsWith(QString("vt") + QString(QChar(9))))
+	else if (glcTextUtil::isKeyword(pLine, pLineEnd, "vt"))
 	{
-		line.remove(0,3); // Remove first 3 char
-		m_Texels.append(extract2dVect(line));
+		extract2dVect(pLine + 2, pLineEnd, &m_Texels);
 		m_FaceType = notSet;
 	}
 
 	// Search normals vectors
-	else if (line.startsWith("vn ") || line.startsWith(QString("vn") + QString(QChar(9))))
+	else if (glcTextUtil::isKeyword(pLine, pLineEnd, "vn"))
 	{
-		line.remove(0,3); // Remove first 3 char
-		m_Normals.append(extract3dVect(line));
+		extract3dVect(pLine + 2, pLineEnd, &m_Normals);
 		m_FaceType = notSet;
 	}
 
 	// Search faces to update index
-	else if (line.startsWith("f ") || line.startsWith(QString("f") + QString(QChar(9))))
+	else if (glcTextUtil::isKeyword(pLine, pLineEnd, "f"))
 	{
 		// If there is no group or object in the OBJ file
 		if (NULL == m_pCurrentObjMesh)
@@ -264,25 +304,22 @@ void GLC_ObjToWorld::scanLigne(QString &line)
 				changeGroup("GLC_Default");
 				//qDebug() << "Default group " << line;
 			}
-		line.remove(0,2); // Remove first 2 char
-		extractFaceIndex(line);
+		extractFaceIndex(pLine + 1, pLineEnd);
 	}
 
 	// Search Material
-	else if (line.startsWith("usemtl ") || line.startsWith(QString("usemtl") + QString(QChar(9))))
+	else if (glcTextUtil::isKeyword(pLine, pLineEnd, "usemtl"))
 	{
-		line.remove(0,7); // Remove first 7 char
+		QString line(QString::fromLocal8Bit(pLine + 6, pLineEnd - pLine - 6));
 		setCurrentMaterial(line);
 		m_FaceType = notSet;
 	}
 
 	// Search Group
-	else if (line.startsWith("g ") || line.startsWith("o ") || line.startsWith(QString("g") + QString(QChar(9)))
-			|| line.startsWith(QString("o") + QString(QChar(9))))
+	else if (glcTextUtil::isKeyword(pLine, pLineEnd, "g") || glcTextUtil::isKeyword(pLine, pLineEnd, "o"))
 	{
 		m_FaceType = notSet;
-		line.remove(0,2); // Remove first 2 char
-		changeGroup(line);
+		changeGroup(QString::fromLocal8Bit(pLine + 1, pLineEnd - pLine - 1));
 	}
 
 }
@@ -327,82 +364,56 @@ void GLC_ObjToWorld::changeGroup(QString line)
 
 }
 
-// Extract a Vector from a string
-QList<float> GLC_ObjToWorld::extract3dVect(QString &line)
+// Extract a Vector from a line
+void GLC_ObjToWorld::extract3dVect(const char* pLine, const char* pLineEnd, GLfloatVector* pBulk)
 {
 	float x=0.0f;
 	float y=0.0f;
 	float z=0.0f;
 
-	QList<float> vectResult;
-	QTextStream stringVecteur(&line);
-
-	QString xString, yString, zString;
-
-	if (((stringVecteur >> xString >> yString >> zString).status() == QTextStream::Ok))
+	if (glcTextUtil::parseFloat(pLine, pLineEnd, &x) && glcTextUtil::parseFloat(pLine, pLineEnd, &y)
+			&& glcTextUtil::parseFloat(pLine, pLineEnd, &z))
 	{
-		bool xOk, yOk, zOk;
-		x= xString.toFloat(&xOk);
-		y= yString.toFloat(&yOk);
-		z= zString.toFloat(&zOk);
-		if (!(xOk && yOk && zOk))
-		{
-			QString message= "GLC_ObjToWorld::extract3dVect " + m_FileName + " failed to convert vector component to float";
-			message.append("\nAt ligne : ");
-			message.append(QString::number(m_CurrentLineNumber));
-			QStringList stringList(m_FileName);
-			stringList.append(message);
-			GLC_ErrorLog::addError(stringList);
-
-			//GLC_FileFormatException fileFormatException(message, m_FileName);
-			//clear();
-			//throw(fileFormatException);
-		}
-		else
-		{
-			vectResult << x << y << z;
-		}
+		pBulk->append(x);
+		pBulk->append(y);
+		pBulk->append(z);
+	}
+	else if (glcTextUtil::skipBlanks(pLine, pLineEnd) != pLineEnd)
+	{
+		QString message= "GLC_ObjToWorld::extract3dVect " + m_FileName + " failed to convert vector component to float";
+		message.append("\nAt ligne : ");
+		message.append(QString::number(m_CurrentLineNumber));
+		QStringList stringList(m_FileName);
+		stringList.append(message);
+		GLC_ErrorLog::addError(stringList);
 	}
-
-	return vectResult;
-
 }
 
-// Extract a Vector from a string
-QList<float> GLC_ObjToWorld::extract2dVect(QString &line)
+// Extract a Vector from a line
+void GLC_ObjToWorld::extract2dVect(const char* pLine, const char* pLineEnd, GLfloatVector* pBulk)
 {
 	float x=0.0f;
 	float y=0.0f;
-	QList<float> vectResult;
-	QTextStream stringVecteur(&line);
-
-	QString xString, yString;
 
-	if (((stringVecteur >> xString >> yString).status() == QTextStream::Ok))
+	if (glcTextUtil::parseFloat(pLine, pLineEnd, &x) && glcTextUtil::parseFloat(pLine, pLineEnd, &y))
 	{
-		bool xOk, yOk;
-		x= xString.toFloat(&xOk);
-		y= yString.toFloat(&yOk);
-		if (!(xOk && yOk))
-		{
-			QString message= "GLC_ObjToWorld::extract2dVect " + m_FileName + " failed to convert vector component to double";
-			message.append("\nAt ligne : ");
-			message.append(QString::number(m_CurrentLineNumber));
-			GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-			clear();
-			throw(fileFormatException);
-		}
-		vectResult << x << y;
+		pBulk->append(x);
+		pBulk->append(y);
+	}
+	else if (glcTextUtil::skipBlanks(pLine, pLineEnd) != pLineEnd)
+	{
+		QString message= "GLC_ObjToWorld::extract2dVect " + m_FileName + " failed to convert vector component to double";
+		message.append("\nAt ligne : ");
+		message.append(QString::number(m_CurrentLineNumber));
+		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
+		clear();
+		throw(fileFormatException);
 	}
-
-	return vectResult;
 }
 
-// Extract a face from a string
-void GLC_ObjToWorld::extractFaceIndex(QString &line)
+// Extract a face from a line
+void GLC_ObjToWorld::extractFaceIndex(const char* pLine, const char* pLineEnd)
 {
-	QString buff;
-
 	int coordinateIndex;
 	int normalIndex;
 	int textureCoordinateIndex;
@@ -411,11 +422,14 @@ void GLC_ObjToWorld::extractFaceIndex(QString &line)
 	//////////////////////////////////////////////////////////////////
 	// Parse the line containing face index
 	//////////////////////////////////////////////////////////////////
-	QTextStream streamFace(&line);
-	while ((!streamFace.atEnd()))
+	const int positionsSize= m_Positions.size();
+	const int normalsSize= m_Normals.size();
+	const int texelsSize= m_Texels.size();
+	pLine= glcTextUtil::skipBlanks(pLine, pLineEnd);
+	while (pLine < pLineEnd)
 	{
-		streamFace >> buff;
-		extractVertexIndex(buff, coordinateIndex, normalIndex, textureCoordinateIndex);
+		extractVertexIndex(pLine, pLineEnd, coordinateIndex, normalIndex, textureCoordinateIndex);
+		pLine= glcTextUtil::skipBlanks(pLine, pLineEnd);
 
 		ObjVertice currentVertice(coordinateIndex, normalIndex, textureCoordinateIndex);
 		if (m_pCurrentObjMesh->m_ObjVerticeIndexMap.contains(currentVertice))
@@ -424,16 +438,18 @@ void GLC_ObjToWorld::extractFaceIndex(QString &line)
 		}
 		else
 		{
-			// Add Vertex to the mesh bulk data
-			m_pCurrentObjMesh->m_Positions.append(m_Positions.value(coordinateIndex * 3));
-			m_pCurrentObjMesh->m_Positions.append(m_Positions.value(coordinateIndex * 3 + 1));
-			m_pCurrentObjMesh->m_Positions.append(m_Positions.value(coordinateIndex * 3 + 2));
+			// Add Vertex to the mesh bulk data, an index out of the file bulk data gives a null vertex
+			const bool validPosition= (coordinateIndex >= 0) && ((coordinateIndex * 3 + 2) < positionsSize);
+			m_pCurrentObjMesh->m_Positions.append(validPosition ? m_Positions.at(coordinateIndex * 3) : 0.0f);
+			m_pCurrentObjMesh->m_Positions.append(validPosition ? m_Positions.at(coordinateIndex * 3 + 1) : 0.0f);
+			m_pCurrentObjMesh->m_Positions.append(validPosition ? m_Positions.at(coordinateIndex * 3 + 2) : 0.0f);
 			if (-1 != normalIndex)
 			{
 				// Add Normal to the mesh bulk data
-				m_pCurrentObjMesh->m_Normals.append(m_Normals.value(normalIndex * 3));
-				m_pCurrentObjMesh->m_Normals.append(m_Normals.value(normalIndex * 3 + 1));
-				m_pCurrentObjMesh->m_Normals.append(m_Normals.value(normalIndex * 3 + 2));
+				const bool validNormal= (normalIndex >= 0) && ((normalIndex * 3 + 2) < normalsSize);
+				m_pCurrentObjMesh->m_Normals.append(validNormal ? m_Normals.at(normalIndex * 3) : 0.0f);
+				m_pCurrentObjMesh->m_Normals.append(validNormal ? m_Normals.at(normalIndex * 3 + 1) : 0.0f);
+				m_pCurrentObjMesh->m_Normals.append(validNormal ? m_Normals.at(normalIndex * 3 + 2) : 0.0f);
 			}
 			else
 			{
@@ -445,8 +461,9 @@ void GLC_ObjToWorld::extractFaceIndex(QString &line)
 			if (-1 != textureCoordinateIndex)
 			{
 				// Add texture coordinate to the mesh bulk data
-				m_pCurrentObjMesh->m_Texels.append(m_Texels.value(textureCoordinateIndex * 2));
-				m_pCurrentObjMesh->m_Texels.append(m_Texels.value(textureCoordinateIndex * 2 + 1));
+				const bool validTexel= (textureCoordinateIndex >= 0) && ((textureCoordinateIndex * 2 + 1) < texelsSize);
+				m_pCurrentObjMesh->m_Texels.append(validTexel ? m_Texels.at(textureCoordinateIndex * 2) : 0.0f);
+				m_pCurrentObjMesh->m_Texels.append(validTexel ? m_Texels.at(textureCoordinateIndex * 2 + 1) : 0.0f);
 			}
 			else if (!m_pCurrentObjMesh->m_Texels.isEmpty())
 			{
@@ -475,36 +492,50 @@ void GLC_ObjToWorld::extractFaceIndex(QString &line)
 		return;
 	}
 	//////////////////////////////////////////////////////////////////
-	// Add the face to the current mesh
+	// Triangulate the polygon on its own vertice only
 	//////////////////////////////////////////////////////////////////
-	if ((m_FaceType == coordinateAndNormal) || (m_FaceType == coordinateAndTextureAndNormal))
+	if ((size > 3) && (m_FaceType != notSet))
 	{
-		if (size > 3)
+		const GLfloat* pPositions= m_pCurrentObjMesh->m_Positions.constData();
+		QList<float> polygon;
+		QList<GLuint> polygonIndex;
+		for (int i= 0; i < size; ++i)
 		{
-			glc::triangulatePolygon(&currentFaceIndex, m_pCurrentObjMesh->m_Positions);
+			const GLuint index= currentFaceIndex.at(i);
+			polygon << pPositions[index * 3] << pPositions[index * 3 + 1] << pPositions[index * 3 + 2];
+			polygonIndex.append(i);
 		}
+		glc::triangulatePolygon(&polygonIndex, polygon);
+		QList<GLuint> triangles;
+		const int count= polygonIndex.size();
+		for (int i= 0; i < count; ++i)
+		{
+			triangles.append(currentFaceIndex.at(polygonIndex.at(i)));
+		}
+		currentFaceIndex= triangles;
+	}
+	//////////////////////////////////////////////////////////////////
+	// Add the face to the current mesh
+	//////////////////////////////////////////////////////////////////
+	if ((m_FaceType == coordinateAndNormal) || (m_FaceType == coordinateAndTextureAndNormal))
+	{
 		m_pCurrentObjMesh->m_Index.append(currentFaceIndex);
 	}
 	else if (m_FaceType != notSet)
 	{
-		if (size > 3)
-		{
-			glc::triangulatePolygon(&currentFaceIndex, m_pCurrentObjMesh->m_Positions);
-		}
 		// Comput the face normal
 		if (currentFaceIndex.size() < 3) return;
 		GLC_Vector3df normal= computeNormal(currentFaceIndex.at(0), currentFaceIndex.at(1), currentFaceIndex.at(2));
 
 		// Add Face normal to bulk data
-		QSet<GLuint> indexSet= currentFaceIndex.toSet();
-		QSet<GLuint>::iterator iIndexSet= indexSet.begin();
-		while (indexSet.constEnd() != iIndexSet)
+		GLfloat* pNormals= m_pCurrentObjMesh->m_Normals.data();
+		const int count= currentFaceIndex.size();
+		for (int i= 0; i < count; ++i)
 		{
-			m_pCurrentObjMesh->m_Normals[*iIndexSet * 3]= normal.x();
-			m_pCurrentObjMesh->m_Normals[*iIndexSet * 3 + 1]= normal.y();
-			m_pCurrentObjMesh->m_Normals[*iIndexSet * 3 + 2]= normal.z();
-
-			++iIndexSet;
+			const GLuint index= currentFaceIndex.at(i);
+			pNormals[index * 3]= normal.x();
+			pNormals[index * 3 + 1]= normal.y();
+			pNormals[index * 3 + 2]= normal.z();
 		}
 
 		m_pCurrentObjMesh->m_Index.append(currentFaceIndex);
@@ -577,181 +608,81 @@ void GLC_ObjToWorld::setCurrentMaterial(QString &line)
 	}
 
 }
-// Extract a vertex from a string
-void GLC_ObjToWorld::extractVertexIndex(QString line, int &Coordinate, int &Normal, int &TextureCoordinate)
+// Extract a vertex from a face line
+void GLC_ObjToWorld::extractVertexIndex(const char*& p, const char* pLineEnd, int &Coordinate, int &Normal, int &TextureCoordinate)
 {
  	if (m_FaceType == notSet)
  	{
- 		setObjType(line);
+ 		setObjType(p, pLineEnd);
  	}
 
- 	if (m_FaceType == coordinateAndTextureAndNormal)
- 	{
-		// Replace "/" with " "
-		line.replace('/', ' ');
-		QTextStream streamVertex(&line);
-		QString coordinateString, textureCoordinateString, normalString;
-	 	if ((streamVertex >> coordinateString >> textureCoordinateString >> normalString).status() == QTextStream::Ok)
-		{
-			bool coordinateOk, textureCoordinateOk, normalOk;
-			Coordinate= coordinateString.toInt(&coordinateOk);
-			--Coordinate;
-			TextureCoordinate= textureCoordinateString.toInt(&textureCoordinateOk);
-			--TextureCoordinate;
-			Normal= normalString.toInt(&normalOk);
-			--Normal;
-			if (!(coordinateOk && textureCoordinateOk && normalOk))
-			{
-				QString message= "GLC_ObjToWorld::extractVertexIndex " + m_FileName + " failed to convert String to int";
-				message.append("\nAt line : ");
-				message.append(QString::number(m_CurrentLineNumber));
-				GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-				clear();
-				throw(fileFormatException);
-			}
-		}
-		else
-		{
-			QString message= "GLC_ObjToWorld::extractVertexIndex Obj file " + m_FileName + " type is not supported";
-			message.append("\nAt line : ");
-			message.append(QString::number(m_CurrentLineNumber));
-			GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotSupported);
-			clear();
-			throw(fileFormatException);
-		}
-
- 	}
- 	else if (m_FaceType == coordinateAndTexture)
- 	{
-		// Replace "/" with " "
-		line.replace('/', ' ');
-		QTextStream streamVertex(&line);
-		QString coordinateString, textureCoordinateString;
-	 	if ((streamVertex >> coordinateString >> textureCoordinateString).status() == QTextStream::Ok)
-		{
-			bool coordinateOk, textureCoordinateOk;
-			Coordinate= coordinateString.toInt(&coordinateOk);
-			--Coordinate;
-			TextureCoordinate= textureCoordinateString.toInt(&textureCoordinateOk);
-			--TextureCoordinate;
-			Normal= -1;
-			if (!(coordinateOk && textureCoordinateOk))
-			{
-				QString message= "GLC_ObjToWorld::extractVertexIndex " + m_FileName +  "failed to convert String to int";
-				message.append("\nAt line : ");
-				message.append(QString::number(m_CurrentLineNumber));
-				GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-				clear();
-				throw(fileFormatException);
-			}
-		}
-		else
-		{
-			QString message= "GLC_ObjToWorld::extractVertexIndex " + m_FileName + " this Obj file type is not supported";
-			message.append("\nAt line : ");
-			message.append(QString::number(m_CurrentLineNumber));
-			GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotSupported);
-			clear();
-			throw(fileFormatException);
-		}
- 	}
- 	else if (m_FaceType == coordinateAndNormal)
- 	{
-		// Replace "/" with " "
-		line.replace('/', ' ');
-		QTextStream streamVertex(&line);
-		QString coordinateString, normalString;
-	 	if ((streamVertex >> coordinateString >> normalString).status() == QTextStream::Ok)
-		{
-			bool coordinateOk, normalOk;
-			Coordinate= coordinateString.toInt(&coordinateOk);
-			--Coordinate;
-			TextureCoordinate= -1;
-			Normal= normalString.toInt(&normalOk);
-			--Normal;
-			if (!(coordinateOk && normalOk))
-			{
-				QString message= "GLC_ObjToWorld::extractVertexIndex " + m_FileName + " failed to convert String to int";
-				message.append("\nAt line : ");
-				message.append(QString::number(m_CurrentLineNumber));
-				GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-				clear();
-				throw(fileFormatException);
-			}
-		}
-		else
-		{
-			QString message= "GLC_ObjToWorld::extractVertexIndex " + m_FileName + " this Obj file type is not supported";
-			message.append("\nAt line : ");
-			message.append(QString::number(m_CurrentLineNumber));
-			GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotSupported);
-			clear();
-			throw(fileFormatException);
-		}
- 	}
-  	else if (m_FaceType == coordinate)
- 	{
- 		QTextStream streamVertex(&line);
- 		QString coordinateString;
-	 	if ((streamVertex >> coordinateString).status() == QTextStream::Ok)
-		{
-			bool coordinateOk;
-			Coordinate= coordinateString.toInt(&coordinateOk);
-			--Coordinate;
-			TextureCoordinate= -1;
-			Normal= -1;
-			if (!coordinateOk)
-			{
-				QString message= "GLC_ObjToWorld::extractVertexIndex "  + m_FileName + " failed to convert String to int";
-				message.append("\nAt line : ");
-				message.append(QString::number(m_CurrentLineNumber));
-				GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-				clear();
-				throw(fileFormatException);
-			}
-		}
-		else
+	const bool hasTexture= (m_FaceType == coordinateAndTexture) || (m_FaceType == coordinateAndTextureAndNormal);
+	const bool hasNormal= (m_FaceType == coordinateAndNormal) || (m_FaceType == coordinateAndTextureAndNormal);
+	TextureCoordinate= 0;
+	Normal= 0;
+	bool ok= glcTextUtil::parseInt(p, pLineEnd, &Coordinate);
+	if (ok && hasTexture)
+	{
+		ok= (p < pLineEnd) && (*p == '/');
+		if (ok) ++p;
+		ok= ok && glcTextUtil::parseInt(p, pLineEnd, &TextureCoordinate);
+	}
+	if (ok && hasNormal)
+	{
+		ok= (p < pLineEnd) && (*p == '/');
+		if (ok) ++p;
+		if (ok && !hasTexture)
 		{
-			QString message= "GLC_ObjToWorld::extractVertexIndex Obj " + m_FileName + " file type is not supported";
-			message.append("\nAt line : ");
-			message.append(QString::number(m_CurrentLineNumber));
-			GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotSupported);
-			clear();
-			throw(fileFormatException);
+			ok= (p < pLineEnd) && (*p == '/');
+			if (ok) ++p;
 		}
- 	}
- 	else
- 	{
-		QString message= "GLC_ObjToWorld::extractVertexIndex OBJ file " + m_FileName + " not reconize";
+		ok= ok && glcTextUtil::parseInt(p, pLineEnd, &Normal);
+	}
+	// The vertex ends with a blank
+	ok= ok && ((p == pLineEnd) || (*p == ' ') || (*p == '\t') || (*p == '\r'));
+	if (!ok)
+	{
+		QString message= "GLC_ObjToWorld::extractVertexIndex " + m_FileName + " failed to convert String to int";
 		message.append("\nAt line : ");
 		message.append(QString::number(m_CurrentLineNumber));
-		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotSupported);
+		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
 		clear();
 		throw(fileFormatException);
- 	}
+	}
+	--Coordinate;
+	TextureCoordinate= hasTexture ? TextureCoordinate - 1 : -1;
+	Normal= hasNormal ? Normal - 1 : -1;
 }
 
 // set the OBJ File type
-void GLC_ObjToWorld::setObjType(QString& ligne)
+void GLC_ObjToWorld::setObjType(const char* p, const char* pLineEnd)
 {
-	const QRegExp coordinateOnlyRegExp("^\\d{1,}$"); // ex. 10
- 	const QRegExp coordinateTextureNormalRegExp("^\\d{1,}/\\d{1,}/\\d{1,}$"); // ex. 10/30/54
- 	const QRegExp coordinateNormalRegExp("^\\d{1,}//\\d{1,}$"); // ex. 10//54
- 	const QRegExp coordinateTextureRegExp("^\\d{1,}/\\d{1,}$"); // ex. 10/56
+	// Count the digits between the slashes of the vertex, ex. 10/30/54, 10//54, 10/56 or 10
+	int digits[3]= {0, 0, 0};
+	int slashCount= 0;
+	bool valid= true;
+	while (valid && (p < pLineEnd) && (*p != ' ') && (*p != '\t') && (*p != '\r'))
+	{
+		if ((*p >= '0') && (*p <= '9')) ++digits[slashCount];
+		else if ((*p == '/') && (slashCount < 2)) ++slashCount;
+		else valid= false;
+		++p;
+	}
+	valid= valid && (digits[0] > 0) && (digits[slashCount] > 0);
 
- 	if (coordinateTextureNormalRegExp.exactMatch(ligne))
+ 	if (valid && (slashCount == 2) && (digits[1] > 0))
  	{
  		m_FaceType= coordinateAndTextureAndNormal;
  	}
- 	else if (coordinateTextureRegExp.exactMatch(ligne))
+ 	else if (valid && (slashCount == 1))
  	{
  		m_FaceType= coordinateAndTexture;
  	}
- 	else if (coordinateNormalRegExp.exactMatch(ligne))
+ 	else if (valid && (slashCount == 2))
  	{
  		m_FaceType= coordinateAndNormal;
  	}
-  	else if (coordinateOnlyRegExp.exactMatch(ligne))
+  	else if (valid && (slashCount == 0))
  	{
  		m_FaceType= coordinate;
  	}
@@ -816,18 +747,6 @@ void GLC_ObjToWorld::clear()
 	}
 
 }
-// Merge Mutli line in one
-void GLC_ObjToWorld::mergeLines(QString* pLineBuff, QTextStream* p0bjStream)
-{
-	if (pLineBuff->endsWith(QChar('\\')))
-	{
-		pLineBuff->replace(QChar('\\'), QChar(' '));
-		pLineBuff->append(p0bjStream->readLine());
-		++m_CurrentLineNumber;
-		mergeLines(pLineBuff, p0bjStream);
-	}
-}
-
 // Add the current Obj mesh to the world
 void GLC_ObjToWorld::addCurrentObjMeshToWorld()
 {
@@ -835,13 +754,13 @@ void GLC_ObjToWorld::addCurrentObjMeshToWorld()
 	{
 		if (!m_pCurrentObjMesh->m_Positions.isEmpty())
 		{
-			m_pCurrentObjMesh->m_pMesh->addVertice(m_pCurrentObjMesh->m_Positions.toVector());
+			m_pCurrentObjMesh->m_pMesh->addVertice(m_pCurrentObjMesh->m_Positions);
 			m_pCurrentObjMesh->m_Positions.clear();
-			m_pCurrentObjMesh->m_pMesh->addNormals(m_pCurrentObjMesh->m_Normals.toVector());
+			m_pCurrentObjMesh->m_pMesh->addNormals(m_pCurrentObjMesh->m_Normals);
 			m_pCurrentObjMesh->m_Normals.clear();
 			if (!m_pCurrentObjMesh->m_Texels.isEmpty())
 			{
-				m_pCurrentObjMesh->m_pMesh->addTexels(m_pCurrentObjMesh->m_Texels.toVector());
+				m_pCurrentObjMesh->m_pMesh->addTexels(m_pCurrentObjMesh->m_Texels);
 				m_pCurrentObjMesh->m_Texels.clear();
 			}
 			QHash<QString, MatOffsetSize*>::iterator iMat= m_pCurrentObjMesh->m_Materials.begin();
@@ -860,11 +779,7 @@ void GLC_ObjToWorld::addCurrentObjMeshToWorld()
 					size= m_pCurrentObjMesh->m_Index.size() - offset;
 				}
 				//qDebug() << "Offset : " << offset << " size : " << size;
-				QList<GLuint> triangles;
-				for (int i= offset; i < (offset + size); ++i)
-				{
-					triangles.append(m_pCurrentObjMesh->m_Index.at(i));
-				}
+				const IndexList triangles(m_pCurrentObjMesh->m_Index.mid(offset, size));
 				// Add the list of triangle to the mesh
 				if (!triangles.isEmpty())
 				{
@@ -33,6 +33,7 @@
 #include <QHash>
 #include <QVector>
 #include <QStringList>
+#include <QByteArray>
 
 #include "../maths/glc_vector3d.h"
 #include "../maths/glc_vector2df.h"
@@ -75,21 +76,19 @@ public:
 	struct ObjVertice
 	{
 		ObjVertice()
-		: m_Values(3)
 		{
 			m_Values[0]= 0;
 			m_Values[1]= 0;
 			m_Values[2]= 0;
 		}
 		ObjVertice(int v1, int v2, int v3)
-		: m_Values(3)
 		{
 			m_Values[0]= v1;
 			m_Values[1]= v2;
 			m_Values[2]= v3;
 		}
 
-		QVector<int> m_Values;
+		int m_Values[3];
 	};
 
 	// Material assignement
@@ -129,9 +128,9 @@ public:
 			}
 		}
 		GLC_Mesh* m_pMesh;
-		QList<float> m_Positions;
-		QList<float> m_Normals;
-		QList<float> m_Texels;
+		GLfloatVector m_Positions;
+		GLfloatVector m_Normals;
+		GLfloatVector m_Texels;
 		//! The index of the current Mesh
 		IndexList m_Index;
 		// Pointer to the last matOffsetSize
@@ -173,29 +172,32 @@ private:
 	//! Return the name of the mtl file
 	QString getMtlLibFileName(QString);
 
+	//! Return the next line of the OBJ file, continuation lines merged, pLineEnd is set to its end
+	const char* nextLine(const char** pLineEnd);
+
 	//! Scan a line previously extracted from OBJ file
-	void scanLigne(QString &);
+	void scanLigne(const char* pLine, const char* pLineEnd);
 
 	//! Change current group
 	void changeGroup(QString);
 
-	//! Extract a 3D Vector from a string
-	QList<float> extract3dVect(QString &);
+	//! Extract a 3D Vector from a line and append it to the given bulk data
+	void extract3dVect(const char* pLine, const char* pLineEnd, GLfloatVector* pBulk);
 
-	//! Extract a 2D Vector from a string
-	QList<float> extract2dVect(QString &);
+	//! Extract a 2D Vector from a line and append it to the given bulk data
+	void extract2dVect(const char* pLine, const char* pLineEnd, GLfloatVector* pBulk);
 
-	//! Extract a face from a string
-	void extractFaceIndex(QString &);
+	//! Extract a face from a line
+	void extractFaceIndex(const char* pLine, const char* pLineEnd);
 
 	//! Set Current material index
 	void setCurrentMaterial(QString &line);
 
-	//! Extract a vertex from a string
-	void extractVertexIndex(QString ligne, int &Coordinate, int &Normal, int &TextureCoordinate);
+	//! Extract a vertex from a face line, p is moved after the vertex
+	void extractVertexIndex(const char*& p, const char* pLineEnd, int &Coordinate, int &Normal, int &TextureCoordinate);
 
-	//! set the OBJ File type
-	void setObjType(QString &);
+	//! set the OBJ File type from the first vertex of a face
+	void setObjType(const char* p, const char* pLineEnd);
 
 	//! compute face normal
 	GLC_Vector3df computeNormal(GLuint, GLuint, GLuint);
@@ -203,9 +205,6 @@ private:
 	//! clear objToWorld allocate memmory
 	void clear();
 
-	//! Merge Mutli line in one
-	void mergeLines(QString*, QTextStream*);
-
 	//! Add the current Obj mesh to the world
 	void addCurrentObjMeshToWorld();
 
@@ -249,21 +248,30 @@ private:
 	QStringList m_ListOfAttachedFileName;
 
 	//! The position bulk data
-	QList<float> m_Positions;
+	GLfloatVector m_Positions;
 
 	//! The normal bulk data
-	QList<float> m_Normals;
+	GLfloatVector m_Normals;
 
 	//! The texture coordinate bulk data
-	QList<float> m_Texels;
+	GLfloatVector m_Texels;
+
+	//! Read position in the file content and end of the content
+	const char* m_pCursor;
+	const char* m_pEnd;
+
+	//! Buffer of a line continued on the next ones
+	QByteArray m_MergedLine;
 };
 
 // To use ObjVertice as a QHash key
 inline bool operator==(const GLC_ObjToWorld::ObjVertice& vertice1, const GLC_ObjToWorld::ObjVertice& vertice2)
-{ return (vertice1.m_Values == vertice2.m_Values);}
+{ return (vertice1.m_Values[0] == vertice2.m_Values[0]) && (vertice1.m_Values[1] == vertice2.m_Values[1])
+		&& (vertice1.m_Values[2] == vertice2.m_Values[2]);}
 
 inline uint qHash(const GLC_ObjToWorld::ObjVertice& vertice)
-{ return qHash(QString::number(vertice.m_Values.at(0)) + QString::number(vertice.m_Values.at(1)) + QString::number(vertice.m_Values.at(2)));}
+{ return (static_cast<uint>(vertice.m_Values[0]) * 73856093u) ^ (static_cast<uint>(vertice.m_Values[1]) * 19349663u)
+		^ (static_cast<uint>(vertice.m_Values[2]) * 83492791u);}
 
 
 #endif /*GLC_OBJTOWORLD_H_*/
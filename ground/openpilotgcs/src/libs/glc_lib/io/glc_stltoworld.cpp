@@ -23,23 +23,29 @@
 //! \file glc_stltoworld.cpp implementation of the GLC_StlToWorld class.
 
 #include "glc_stltoworld.h"
+#include "glc_textutil.h"
 #include "../sceneGraph/glc_world.h"
 #include "../glc_fileformatexception.h"
 #include "../sceneGraph/glc_structreference.h"
 #include "../sceneGraph/glc_structinstance.h"
 #include "../sceneGraph/glc_structoccurence.h"
 
-#include <QTextStream>
 #include <QFileInfo>
 #include <QGLContext>
-#include <QDataStream>
+#include <QtEndian>
+#include <string.h>
+
+// Binary STL : 80 bytes header, facet count, 50 bytes per facet
+#define STL_BINARY_HEADER 84
+#define STL_BINARY_FACET 50
 
 GLC_StlToWorld::GLC_StlToWorld()
 : QObject()
 , m_pWorld(NULL)
 , m_FileName()
 , m_CurrentLineNumber(0)
-, m_StlStream()
+, m_pCursor(NULL)
+, m_pEnd(NULL)
 , m_pCurrentMesh(NULL)
 , m_CurrentFace()
 , m_VertexBulk()
@@ -77,54 +83,40 @@ GLC_World* GLC_StlToWorld::CreateWorldFromStl(QFile &file)
 	//////////////////////////////////////////////////////////////////
 	m_pWorld= new GLC_World;
 
+	// The whole file is parsed in place, mapped when possible
+	QByteArray fallback;
+	qint64 size= 0;
+	const char* pData= glcTextUtil::mapFile(file, &fallback, &size);
+	m_pCursor= pData;
+	m_pEnd= pData + size;
+
 	// Create Working variables
 	int currentQuantumValue= 0;
 	int previousQuantumValue= 0;
-	int numberOfLine= 0;
-
-	// Attach the stream to the file
-	m_StlStream.setDevice(&file);
-
-	// QString buffer
-	QString lineBuff;
-
-	//////////////////////////////////////////////////////////////////
-	// Count the number of lines of the STL file
-	//////////////////////////////////////////////////////////////////
-	while (!m_StlStream.atEnd())
-	{
-		++numberOfLine;
-		m_StlStream.readLine();
-	}
-
-	//////////////////////////////////////////////////////////////////
-	// Reset the stream
-	//////////////////////////////////////////////////////////////////
-	m_StlStream.resetStatus();
-	m_StlStream.seek(0);
-	//////////////////////////////////////////////////////////////////
-	// Read Buffer and create the world
-	//////////////////////////////////////////////////////////////////
 
 	emit currentQuantum(currentQuantumValue);
 	m_CurrentLineNumber= 0;
-	// Search Object section in the STL
 
-	// Test if the STL File is ASCII or Binary
-	++m_CurrentLineNumber;
-	lineBuff= m_StlStream.readLine();
-	lineBuff= lineBuff.trimmed().toLower();
-	if (!lineBuff.startsWith("solid"))
+	// Test if the STL File is ASCII or Binary. Binary files may start with "solid"
+	// too, their size gives them away
+	quint32 binaryFacets= 0;
+	if (size >= STL_BINARY_HEADER)
+	{
+		binaryFacets= qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(pData) + 80);
+	}
+	const bool binarySize= (size >= STL_BINARY_HEADER) && (STL_BINARY_HEADER + static_cast<qint64>(binaryFacets) * STL_BINARY_FACET == size);
+	const char* pLineEnd= NULL;
+	const char* pLine= binarySize ? NULL : nextLine(&pLineEnd);
+	if ((NULL == pLine) || !glcTextUtil::isKeyword(pLine, pLineEnd, "solid"))
 	{
 		// The STL File is not ASCII trying to load Binary STL File
 		m_pCurrentMesh= new GLC_Mesh();
-		file.reset();
-		LoadBinariStl(file);
+		LoadBinariStl(pData, size);
 		m_pCurrentMesh->addTriangles(NULL, m_CurrentFace);
 		m_CurrentFace.clear();
-		m_pCurrentMesh->addVertice(m_VertexBulk.toVector());
+		m_pCurrentMesh->addVertice(m_VertexBulk);
 		m_VertexBulk.clear();
-		m_pCurrentMesh->addNormals(m_NormalBulk.toVector());
+		m_pCurrentMesh->addNormals(m_NormalBulk);
 		m_NormalBulk.clear();
 		m_pCurrentMesh->finish();
 		GLC_3DRep* pRep= new GLC_3DRep(m_pCurrentMesh);
@@ -133,24 +125,31 @@ GLC_World* GLC_StlToWorld::CreateWorldFromStl(QFile &file)
 	}
 	else
 	{
-		// The STL File is ASCII
-		lineBuff.remove(0, 5);
-		lineBuff= lineBuff.trimmed();
+		// The STL File is ASCII, about 250 bytes per facet
+		const int facetEstimate= static_cast<int>(qMin<qint64>(size / 250, 10000000));
+		m_VertexBulk.reserve(facetEstimate * 9);
+		m_NormalBulk.reserve(facetEstimate * 9);
 		m_pCurrentMesh= new GLC_Mesh();
-		m_pCurrentMesh->setName(lineBuff);
+		m_pCurrentMesh->setName(QString::fromLatin1(pLine + 5, pLineEnd - pLine - 5).trimmed());
 		// Read the mesh facet
-		while (!m_StlStream.atEnd())
+		while (m_pCursor < m_pEnd)
 		{
 			scanFacet();
 
-			currentQuantumValue = static_cast<int>((static_cast<double>(m_CurrentLineNumber) / numberOfLine) * 100);
+			currentQuantumValue = static_cast<int>((static_cast<double>(m_pCursor - pData) / size) * 100);
 			if (currentQuantumValue > previousQuantumValue)
 			{
 				emit currentQuantum(currentQuantumValue);
 			}
 			previousQuantumValue= currentQuantumValue;
 		}
+		// A truncated file without "endsolid"
+		if (NULL != m_pCurrentMesh && !m_CurrentFace.isEmpty())
+		{
+			addCurrentMesh();
+		}
 	}
+	m_pCursor= m_pEnd= NULL;
 	file.close();
 
 	return m_pWorld;
@@ -173,56 +172,98 @@ void GLC_StlToWorld::clear()
 	m_CurrentLineNumber= 0;
 	m_pCurrentMesh= NULL;
 	m_CurrentFace.clear();
+	m_VertexBulk.clear();
+	m_NormalBulk.clear();
+	m_CurrentIndex= 0;
 }
 
-// Scan a line previously extracted from STL file
+// Return the next non empty line
+const char* GLC_StlToWorld::nextLine(const char** pLineEnd)
+{
+	while (m_pCursor < m_pEnd)
+	{
+		++m_CurrentLineNumber;
+		const char* pLine= glcTextUtil::skipBlanks(m_pCursor, m_pEnd);
+		const char* pEnd= glcTextUtil::endOfLine(pLine, m_pEnd);
+		m_pCursor= (pEnd < m_pEnd) ? pEnd + 1 : m_pEnd;
+		// Trailing blanks
+		while ((pEnd > pLine) && ((pEnd[-1] == ' ') || (pEnd[-1] == '\t') || (pEnd[-1] == '\r'))) --pEnd;
+		if (pEnd > pLine)
+		{
+			*pLineEnd= pEnd;
+			return pLine;
+		}
+	}
+	return NULL;
+}
+
+void GLC_StlToWorld::throwFormatError(const QString& what)
+{
+	QString message= "GLC_StlToWorld::scanFacet : " + what;
+	message.append("\nAt line : ");
+	message.append(QString::number(m_CurrentLineNumber));
+	GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
+	clear();
+	throw(fileFormatException);
+}
+
+// Add the current ASCII solid to the world
+void GLC_StlToWorld::addCurrentMesh()
+{
+	m_pCurrentMesh->addTriangles(NULL, m_CurrentFace);
+	m_CurrentFace.clear();
+	m_pCurrentMesh->addVertice(m_VertexBulk);
+	m_VertexBulk.resize(0);
+	m_pCurrentMesh->addNormals(m_NormalBulk);
+	m_NormalBulk.resize(0);
+	m_CurrentIndex= 0;
+
+	m_pCurrentMesh->finish();
+	GLC_3DRep* pRep= new GLC_3DRep(m_pCurrentMesh);
+	m_pCurrentMesh= NULL;
+	m_pWorld->rootOccurence()->addChild(new GLC_StructOccurence(pRep));
+}
+
+// Scan the next facet
 void GLC_StlToWorld::scanFacet()
 {
+	const char* pLineEnd= NULL;
+	const char* pLine= nextLine(&pLineEnd);
+	if (NULL == pLine) return;
 ////////////////////////////////////////////// Test end of solid section////////////////////
-	++m_CurrentLineNumber;
-	QString lineBuff(m_StlStream.readLine());
-	lineBuff= lineBuff.trimmed().toLower();
 	// Test if this is the end of current solid
-	if (lineBuff.startsWith("endsolid") || lineBuff.startsWith("end solid"))
+	if (glcTextUtil::isKeyword(pLine, pLineEnd, "endsolid") || glcTextUtil::isKeyword(pLine, pLineEnd, "end"))
 	{
-		m_pCurrentMesh->addTriangles(NULL, m_CurrentFace);
-		m_CurrentFace.clear();
-		m_pCurrentMesh->addVertice(m_VertexBulk.toVector());
-		m_VertexBulk.clear();
-		m_pCurrentMesh->addNormals(m_NormalBulk.toVector());
-		m_NormalBulk.clear();
-
-		m_pCurrentMesh->finish();
-		GLC_3DRep* pRep= new GLC_3DRep(m_pCurrentMesh);
-		m_pCurrentMesh= NULL;
-		m_pWorld->rootOccurence()->addChild(new GLC_StructOccurence(pRep));
+		if (NULL != m_pCurrentMesh)
+		{
+			addCurrentMesh();
+		}
 		return;
 	}
 	// Test if this is the start of new solid
-	if (lineBuff.startsWith("solid"))
+	if (glcTextUtil::isKeyword(pLine, pLineEnd, "solid"))
 	{
-		// The STL File is ASCII
-		lineBuff.remove(0, 5);
-		lineBuff= lineBuff.trimmed();
+		if (NULL != m_pCurrentMesh)
+		{
+			addCurrentMesh();
+		}
 		m_pCurrentMesh= new GLC_Mesh();
-		m_pCurrentMesh->setName(lineBuff);
+		m_pCurrentMesh->setName(QString::fromLatin1(pLine + 5, pLineEnd - pLine - 5).trimmed());
 		return;
 	}
+	if (NULL == m_pCurrentMesh)
+	{
+		throwFormatError("\"solid\" not found!");
+	}
 
 ////////////////////////////////////////////// Facet Normal////////////////////////////////
-	// lineBuff Must begin with "facet normal"
-	if (!lineBuff.startsWith("facet normal"))
+	// Line Must begin with "facet normal"
+	const char* pNormal= glcTextUtil::skipBlanks(pLine + 5, pLineEnd);
+	if (!glcTextUtil::isKeyword(pLine, pLineEnd, "facet") || !glcTextUtil::isKeyword(pNormal, pLineEnd, "normal"))
 	{
-		QString message= "GLC_StlToWorld::scanFacet : \"facet normal\" not found!";
-		message.append("\nAt line : ");
-		message.append(QString::number(m_CurrentLineNumber));
-		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-		clear();
-		throw(fileFormatException);
+		throwFormatError("\"facet normal\" not found!");
 	}
-	lineBuff.remove(0,12); // Remove first 12 chars
-	lineBuff= lineBuff.trimmed().toLower();
-	GLC_Vector3df cur3dVect= extract3dVect(lineBuff);
+	GLC_Vector3df cur3dVect= extract3dVect(pNormal + 6, pLineEnd);
 	for (int i= 0; i < 3; ++i)
 	{
 		m_NormalBulk.append(cur3dVect.x());
@@ -231,41 +272,24 @@ void GLC_StlToWorld::scanFacet()
 	}
 
 ////////////////////////////////////////////// Outer Loop////////////////////////////////
-	++m_CurrentLineNumber;
-	lineBuff= m_StlStream.readLine();
-	lineBuff= lineBuff.trimmed().toLower();
-	// lineBuff Must begin with "outer loop"
-	if (!lineBuff.startsWith("outer loop"))
+	pLine= nextLine(&pLineEnd);
+	// Line Must begin with "outer loop"
+	if ((NULL == pLine) || !glcTextUtil::isKeyword(pLine, pLineEnd, "outer"))
 	{
-		QString message= "GLC_StlToWorld::scanFacet : \"outer loop\" not found!";
-		message.append("\nAt line : ");
-		message.append(QString::number(m_CurrentLineNumber));
-		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-		clear();
-		throw(fileFormatException);
+		throwFormatError("\"outer loop\" not found!");
 	}
 
 ////////////////////////////////////////////// Vertex ////////////////////////////////
 
 	for (int i= 0; i < 3; ++i)
 	{
-		++m_CurrentLineNumber;
-		lineBuff= m_StlStream.readLine();
-		lineBuff= lineBuff.trimmed().toLower();
-		// lineBuff Must begin with "vertex"
-		if (!lineBuff.startsWith("vertex"))
+		pLine= nextLine(&pLineEnd);
+		// Line Must begin with "vertex"
+		if ((NULL == pLine) || !glcTextUtil::isKeyword(pLine, pLineEnd, "vertex"))
 		{
-			QString message= "GLC_StlToWorld::scanFacet : \"vertex\" not found!";
-			message.append("\nAt line : ");
-			message.append(QString::number(m_CurrentLineNumber));
-			GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-			clear();
-			throw(fileFormatException);
+			throwFormatError("\"vertex\" not found!");
 		}
-		lineBuff.remove(0,6); // Remove first 6 chars
-		lineBuff= lineBuff.trimmed();
-
-		cur3dVect= extract3dVect(lineBuff);
+		cur3dVect= extract3dVect(pLine + 6, pLineEnd);
 		m_VertexBulk.append(cur3dVect.x());
 		m_VertexBulk.append(cur3dVect.y());
 		m_VertexBulk.append(cur3dVect.z());
@@ -275,141 +299,90 @@ void GLC_StlToWorld::scanFacet()
 	}
 
 ////////////////////////////////////////////// End Loop////////////////////////////////
-	++m_CurrentLineNumber;
-	lineBuff= m_StlStream.readLine();
-	lineBuff= lineBuff.trimmed().toLower();
-	// lineBuff Must begin with "endloop"
-	if (!lineBuff.startsWith("endloop"))
+	pLine= nextLine(&pLineEnd);
+	// Line Must begin with "endloop"
+	if ((NULL == pLine) || !glcTextUtil::isKeyword(pLine, pLineEnd, "endloop"))
 	{
-		QString message= "GLC_StlToWorld::scanFacet : \"endloop\" not found!";
-		message.append("\nAt line : ");
-		message.append(QString::number(m_CurrentLineNumber));
-		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-		clear();
-		throw(fileFormatException);
+		throwFormatError("\"endloop\" not found!");
 	}
 
 ////////////////////////////////////////////// End Facet////////////////////////////////
-	++m_CurrentLineNumber;
-	lineBuff= m_StlStream.readLine();
-	lineBuff= lineBuff.trimmed().toLower();
-	// lineBuff Must begin with "endfacet"
-	if (!lineBuff.startsWith("endfacet"))
+	pLine= nextLine(&pLineEnd);
+	// Line Must begin with "endfacet"
+	if ((NULL == pLine) || !glcTextUtil::isKeyword(pLine, pLineEnd, "endfacet"))
 	{
-		QString message= "GLC_StlToWorld::scanFacet : \"endfacet\" not found!";
-		message.append("\nAt line : ");
-		message.append(QString::number(m_CurrentLineNumber));
-		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-		clear();
-		throw(fileFormatException);
+		throwFormatError("\"endfacet\" not found!");
 	}
 
 }
 
-// Extract a Vector from a string
-GLC_Vector3df GLC_StlToWorld::extract3dVect(QString &line)
+// Extract a Vector from a line
+GLC_Vector3df GLC_StlToWorld::extract3dVect(const char* pLine, const char* pLineEnd)
 {
 	float x=0.0f;
 	float y=0.0f;
 	float z=0.0f;
 
-	GLC_Vector3df vectResult;
-	QTextStream stringVecteur(&line);
-
-	QString xString, yString, zString;
-
-	if (((stringVecteur >> xString >> yString >> zString).status() == QTextStream::Ok))
+	if (!(glcTextUtil::parseFloat(pLine, pLineEnd, &x) && glcTextUtil::parseFloat(pLine, pLineEnd, &y)
+			&& glcTextUtil::parseFloat(pLine, pLineEnd, &z)))
 	{
-		bool xOk, yOk, zOk;
-		x= xString.toFloat(&xOk);
-		y= yString.toFloat(&yOk);
-		z= zString.toFloat(&zOk);
-		if (!(xOk && yOk && zOk))
-		{
-			QString message= "GLC_StlToWorld::extract3dVect : failed to convert vector component to float";
-			message.append("\nAt ligne : ");
-			message.append(QString::number(m_CurrentLineNumber));
-			GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-			clear();
-			throw(fileFormatException);
-		}
-		else
-		{
-			vectResult.setVect(x, y, z);
-		}
+		QString message= "GLC_StlToWorld::extract3dVect : failed to convert vector component to float";
+		message.append("\nAt ligne : ");
+		message.append(QString::number(m_CurrentLineNumber));
+		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
+		clear();
+		throw(fileFormatException);
 	}
-
-	return vectResult;
-
+	return GLC_Vector3df(x, y, z);
 }
+
 // Load Binarie STL File
-void GLC_StlToWorld::LoadBinariStl(QFile &file)
+void GLC_StlToWorld::LoadBinariStl(const char* pData, qint64 size)
 {
 	// Create Working variables
 	int currentQuantumValue= 0;
 	int previousQuantumValue= 0;
 
-	QDataStream stlBinFile(&file);
-	stlBinFile.setVersion(QDataStream::Qt_4_6);
-	stlBinFile.setFloatingPointPrecision(QDataStream::SinglePrecision);
-	stlBinFile.setByteOrder(QDataStream::LittleEndian);
-
-	// Skip 80 Bytes STL header
-	int SkipedData= stlBinFile.skipRawData(80);
-	// Check if an error occur
-	if (-1 == SkipedData)
+	// Check the 80 Bytes STL header and the number of facet
+	if (size < STL_BINARY_HEADER)
 	{
-		QString message= "GLC_StlToWorld::LoadBinariStl : Failed to skip Header of binary STL";
+		QString message= "GLC_StlToWorld::LoadBinariStl : Failed to read the number of facets of binary STL";
 		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
 		clear();
 		throw(fileFormatException);
 	}
-	// Read the number of facet
-	quint32 numberOfFacet= 0;
-	stlBinFile >> numberOfFacet;
-	// Check if an error occur
-	if (QDataStream::Ok != stlBinFile.status())
+	const uchar* pFacet= reinterpret_cast<const uchar*>(pData) + STL_BINARY_HEADER;
+	const quint32 numberOfFacet= qFromLittleEndian<quint32>(pFacet - 4);
+	// Check if the file holds all the facets
+	if (STL_BINARY_HEADER + static_cast<qint64>(numberOfFacet) * STL_BINARY_FACET > size)
 	{
-		QString message= "GLC_StlToWorld::LoadBinariStl : Failed to read the number of facets of binary STL";
+		QString message= "GLC_StlToWorld::LoadBinariStl : Failed to read the Vertex of binary STL";
 		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
 		clear();
 		throw(fileFormatException);
 	}
-	for (quint32 i= 0; i < numberOfFacet; ++i)
+
+	// The facets go straight into the mesh arrays
+	m_VertexBulk.resize(numberOfFacet * 9);
+	m_NormalBulk.resize(numberOfFacet * 9);
+	m_CurrentFace.reserve(numberOfFacet * 3);
+	GLfloat* pVertex= m_VertexBulk.data();
+	GLfloat* pNormal= m_NormalBulk.data();
+	for (quint32 i= 0; i < numberOfFacet; ++i, pFacet+= STL_BINARY_FACET)
 	{
-		// Extract the facet normal
-		float nx, ny, nz;
-		stlBinFile >> nx >> ny >> nz;
-		// Check if an error occur
-		if (QDataStream::Ok != stlBinFile.status())
+		// The facet normal then the 3 Vertexs, little endian floats
+		float values[12];
+		for (int j= 0; j < 12; ++j)
 		{
-			QString message= "GLC_StlToWorld::LoadBinariStl : Failed to read the Normal of binary STL";
-			GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-			clear();
-			throw(fileFormatException);
+			const quint32 bits= qFromLittleEndian<quint32>(pFacet + j * 4);
+			memcpy(&values[j], &bits, sizeof(float));
 		}
-
-		// Extract the 3 Vertexs
 		for (int j= 0; j < 3; ++j)
 		{
-			float x, y, z;
-			stlBinFile >> x >> y >> z;
-			// Check if an error occur
-			if (QDataStream::Ok != stlBinFile.status())
-			{
-				QString message= "GLC_StlToWorld::LoadBinariStl : Failed to read the Vertex of binary STL";
-				GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-				clear();
-				throw(fileFormatException);
-			}
-			m_VertexBulk.append(x);
-			m_VertexBulk.append(y);
-			m_VertexBulk.append(z);
-
-			m_NormalBulk.append(nx);
-			m_NormalBulk.append(ny);
-			m_NormalBulk.append(nz);
-
+			memcpy(pVertex, &values[3 + j * 3], 3 * sizeof(float));
+			memcpy(pNormal, &values[0], 3 * sizeof(float));
+			pVertex+= 3;
+			pNormal+= 3;
 			m_CurrentFace.append(m_CurrentIndex);
 			++m_CurrentIndex;
 		}
@@ -419,10 +392,5 @@ void GLC_StlToWorld::LoadBinariStl(QFile &file)
 			emit currentQuantum(currentQuantumValue);
 		}
 		previousQuantumValue= currentQuantumValue;
-
-		// Skip 2 fill-bytes not needed !!!!
-		stlBinFile.skipRawData(2);
-
 	}
 }
-
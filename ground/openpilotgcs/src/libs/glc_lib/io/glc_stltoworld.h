@@ -28,7 +28,6 @@
 #include <QString>
 #include <QObject>
 #include <QFile>
-#include <QTextStream>
 
 #include "../geometry/glc_mesh.h"
 #include "../maths/glc_vector3df.h"
@@ -77,12 +76,18 @@ public:
 private:
 	//! clear stlToWorld allocate memmory
 	void clear();
-	//! Scan a line previously extracted from STL file
+	//! Scan the next facet of an ASCII STL
 	void scanFacet();
-	//! Extract a 3D Vector from a string
-	GLC_Vector3df extract3dVect(QString &);
+	//! Return the next non empty line of an ASCII STL, pLineEnd is set to its end
+	const char* nextLine(const char** pLineEnd);
+	//! Throw a file format exception for the current line
+	void throwFormatError(const QString& what);
+	//! Extract a 3D Vector from a line
+	GLC_Vector3df extract3dVect(const char* pLine, const char* pLineEnd);
+	//! Add the current ASCII solid to the world
+	void addCurrentMesh();
 	//! Load Binarie STL File
-	void LoadBinariStl(QFile &);
+	void LoadBinariStl(const char* pData, qint64 size);
 
 
 
@@ -107,8 +112,9 @@ private:
 	//! The current line number
 	int m_CurrentLineNumber;
 
-	//! The Text Stream
-	QTextStream m_StlStream;
+	//! Read position in the file content and end of the content
+	const char* m_pCursor;
+	const char* m_pEnd;
 
 	//! The current mesh
 	GLC_Mesh* m_pCurrentMesh;
@@ -117,10 +123,10 @@ private:
 	IndexList m_CurrentFace;
 
 	//! Vertex Bulk data
-	QList<float> m_VertexBulk;
+	GLfloatVector m_VertexBulk;
 
 	//! Normal Bulk data
-	QList<float> m_NormalBulk;
+	GLfloatVector m_NormalBulk;
 
 	//! The current index
 	GLuint m_CurrentIndex;
@@ -0,0 +1,180 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_textutil.h interface for in place text tokenizing utilities.
+
+#ifndef GLC_TEXTUTIL_H_
+#define GLC_TEXTUTIL_H_
+#include <QFile>
+#include <QByteArray>
+#include <math.h>
+
+/*! Helpers used by the mesh readers to parse a file in memory without QString
+ * conversions: a cursor walks the mapped bytes and numbers are converted in place.
+ * Every function takes the current position and the end of the data and never
+ * reads past the end.*/
+namespace glcTextUtil
+{
+//! Return the content of the given open file, memory mapped when possible
+/*! pFallback holds the content when the file can't be mapped*/
+inline const char* mapFile(QFile& file, QByteArray* pFallback, qint64* pSize);
+
+//! Return the first position after blanks (space, tab, \\r)
+inline const char* skipBlanks(const char* p, const char* pEnd);
+
+//! Return the end of the line starting at p (the '\\n' or pEnd)
+inline const char* endOfLine(const char* p, const char* pEnd);
+
+//! Return true if the word at p is the given keyword, case insensitive
+/*! The keyword must be followed by a blank or the end of the line*/
+inline bool isKeyword(const char* p, const char* pEnd, const char* keyword);
+
+//! Parse a float at p, skipping leading blanks, advance p on success
+inline bool parseFloat(const char*& p, const char* pEnd, float* pValue);
+
+//! Parse an integer at p, advance p on success
+inline bool parseInt(const char*& p, const char* pEnd, int* pValue);
+};
+
+
+const char* glcTextUtil::mapFile(QFile& file, QByteArray* pFallback, qint64* pSize)
+{
+	*pSize= file.size();
+	if (*pSize == 0) return "";
+	const char* pData= reinterpret_cast<const char*>(file.map(0, *pSize));
+	if (NULL == pData)
+	{
+		*pFallback= file.readAll();
+		*pSize= pFallback->size();
+		pData= pFallback->constData();
+	}
+	return pData;
+}
+
+const char* glcTextUtil::skipBlanks(const char* p, const char* pEnd)
+{
+	while ((p < pEnd) && ((*p == ' ') || (*p == '\t') || (*p == '\r'))) ++p;
+	return p;
+}
+
+const char* glcTextUtil::endOfLine(const char* p, const char* pEnd)
+{
+	while ((p < pEnd) && (*p != '\n')) ++p;
+	return p;
+}
+
+bool glcTextUtil::isKeyword(const char* p, const char* pEnd, const char* keyword)
+{
+	while (*keyword != '\0')
+	{
+		if ((p == pEnd) || ((*p | 0x20) != *keyword)) return false;
+		++p;
+		++keyword;
+	}
+	return (p == pEnd) || (*p == ' ') || (*p == '\t') || (*p == '\r') || (*p == '\n');
+}
+
+bool glcTextUtil::parseFloat(const char*& p, const char* pEnd, float* pValue)
+{
+	const char* pCursor= skipBlanks(p, pEnd);
+	bool negative= false;
+	if ((pCursor < pEnd) && ((*pCursor == '-') || (*pCursor == '+')))
+	{
+		negative= (*pCursor == '-');
+		++pCursor;
+	}
+	double mantissa= 0.0;
+	int exponent= 0;
+	bool hasDigits= false;
+	while ((pCursor < pEnd) && (*pCursor >= '0') && (*pCursor <= '9'))
+	{
+		mantissa= mantissa * 10.0 + (*pCursor - '0');
+		hasDigits= true;
+		++pCursor;
+	}
+	if ((pCursor < pEnd) && (*pCursor == '.'))
+	{
+		++pCursor;
+		while ((pCursor < pEnd) && (*pCursor >= '0') && (*pCursor <= '9'))
+		{
+			mantissa= mantissa * 10.0 + (*pCursor - '0');
+			--exponent;
+			hasDigits= true;
+			++pCursor;
+		}
+	}
+	if (!hasDigits) return false;
+	if ((pCursor < pEnd) && ((*pCursor == 'e') || (*pCursor == 'E')))
+	{
+		const char* pExponent= pCursor + 1;
+		bool negativeExponent= false;
+		if ((pExponent < pEnd) && ((*pExponent == '-') || (*pExponent == '+')))
+		{
+			negativeExponent= (*pExponent == '-');
+			++pExponent;
+		}
+		if ((pExponent < pEnd) && (*pExponent >= '0') && (*pExponent <= '9'))
+		{
+			int value= 0;
+			while ((pExponent < pEnd) && (*pExponent >= '0') && (*pExponent <= '9'))
+			{
+				if (value < 1000) value= value * 10 + (*pExponent - '0');
+				++pExponent;
+			}
+			exponent+= negativeExponent ? -value : value;
+			pCursor= pExponent;
+		}
+	}
+	// Exact for the usual short decimals, pow only for the rest
+	static const double powersOf10[]= {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+			1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+	if ((exponent >= 0) && (exponent <= 22)) mantissa*= powersOf10[exponent];
+	else if ((exponent < 0) && (exponent >= -22)) mantissa/= powersOf10[-exponent];
+	else mantissa*= pow(10.0, exponent);
+
+	*pValue= static_cast<float>(negative ? -mantissa : mantissa);
+	p= pCursor;
+	return true;
+}
+
+bool glcTextUtil::parseInt(const char*& p, const char* pEnd, int* pValue)
+{
+	const char* pCursor= p;
+	bool negative= false;
+	if ((pCursor < pEnd) && ((*pCursor == '-') || (*pCursor == '+')))
+	{
+		negative= (*pCursor == '-');
+		++pCursor;
+	}
+	if ((pCursor == pEnd) || (*pCursor < '0') || (*pCursor > '9')) return false;
+	int value= 0;
+	while ((pCursor < pEnd) && (*pCursor >= '0') && (*pCursor <= '9'))
+	{
+		value= value * 10 + (*pCursor - '0');
+		++pCursor;
+	}
+	*pValue= negative ? -value : value;
+	p= pCursor;
+	return true;
+}
+
+#endif /*GLC_TEXTUTIL_H_*/
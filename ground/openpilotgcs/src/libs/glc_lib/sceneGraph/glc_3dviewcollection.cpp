@@ -49,6 +49,7 @@ GLC_3DViewCollection::GLC_3DViewCollection()
 , m_pViewport(NULL)
 , m_pSpacePartitioning(NULL)
 , m_UseSpacePartitioning(false)
+, m_SpacePartitioningIsDirty(false)
 , m_IsViewable(true)
 {
 }
@@ -57,6 +58,7 @@ GLC_3DViewCollection::~GLC_3DViewCollection()
 {
 	// Delete all collection's elements and the collection bounding box
 	clear();
+	delete m_pSpacePartitioning;
 }
 //////////////////////////////////////////////////////////////////////
 // Set Functions
@@ -137,6 +139,7 @@ bool GLC_3DViewCollection::add(const GLC_3DViewInstance& node, GLC_uint shaderID
 	}
 
 	m_3DViewInstanceHash.insert(key, node);
+	invalidateSpacePartitioning();
 	// Create an GLC_3DViewInstance pointer of the inserted instance
 	ViewInstancesHash::iterator iNode= m_3DViewInstanceHash.find(key);
 	GLC_3DViewInstance* pInstance= &(iNode.value());
@@ -244,6 +247,7 @@ bool GLC_3DViewCollection::remove(GLC_uint Key)
 		m_MainInstances.remove(Key);
 
 		m_3DViewInstanceHash.remove(Key);		// Delete the conteneur
+		invalidateSpacePartitioning();
 
 		//qDebug("GLC_3DViewCollection::removeNode : Element succesfuly deleted");
 		return true;
@@ -277,8 +281,8 @@ void GLC_3DViewCollection::clear(void)
 	// Clear main Hash table
     m_3DViewInstanceHash.clear();
 
-	// delete the space partitioning
-	delete m_pSpacePartitioning;
+	// The space partitioning stays bound, only its content is dropped
+	invalidateSpacePartitioning();
 }
 
 bool GLC_3DViewCollection::select(GLC_uint key, bool primitive)
@@ -450,6 +454,17 @@ void GLC_3DViewCollection::bindSpacePartitioning(GLC_SpacePartitioning* pSpacePa
 
 	delete m_pSpacePartitioning;
 	m_pSpacePartitioning= pSpacePartitioning;
+	m_SpacePartitioningIsDirty= true;
+}
+
+void GLC_3DViewCollection::invalidateSpacePartitioning()
+{
+	if (NULL != m_pSpacePartitioning)
+	{
+		// The partitioning holds instance pointers, it is refilled lazily
+		m_pSpacePartitioning->clear();
+		m_SpacePartitioningIsDirty= true;
+	}
 }
 
 void GLC_3DViewCollection::unbindSpacePartitioning()
@@ -472,8 +487,12 @@ void GLC_3DViewCollection::updateInstanceViewableState(GLC_Matrix4x4* pMatrix)
 {
 	if ((NULL != m_pViewport) && m_UseSpacePartitioning && (NULL != m_pSpacePartitioning))
 	{
-		if (m_pViewport->updateFrustum(pMatrix))
+		const bool frustumChanged= m_pViewport->updateFrustum(pMatrix);
+		if (frustumChanged || m_SpacePartitioningIsDirty)
+		{
 			m_pSpacePartitioning->updateViewableInstances(m_pViewport->frustum());
+			m_SpacePartitioningIsDirty= false;
+		}
 	}
 }
 
@@ -245,6 +245,11 @@ public:
 	inline void setSpacePartitionningUsage(bool use)
 	{m_UseSpacePartitioning= use;}
 
+	//! Mark the space partitioning out of date
+	/*! It is rebuilt on the next viewable state update. Adding or removing
+	 * an instance does it, moving instances must call it*/
+	void invalidateSpacePartitioning();
+
 	//! Update the instance viewable state
 	/*! Update the frustrum culling from the viewport
 	 * If the specified matrix pointer is not null*/
@@ -331,6 +336,9 @@ private:
 	//! The space partition usage
 	bool m_UseSpacePartitioning;
 
+	//! True if the viewable state must be updated even if the frustum is the same
+	bool m_SpacePartitioningIsDirty;
+
 	//! Viewable state
 	bool m_IsViewable;
 
@@ -98,6 +98,12 @@ $(FIELDSINIT)
 $(INITFIELDS)
 	}
 
+	/**
+	 * Typed field accessors, index is the element of array fields (0 otherwise).
+	 * Integer and enum fields are read as long, enums as the option index.
+	 */
+$(FIELDACCESSORS)
+
 	/**
 	 * Create a clone of this object, a new instance ID must be specified.
 	 * Do not use this function directly to create new instances, the
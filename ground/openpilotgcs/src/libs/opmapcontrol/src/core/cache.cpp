@@ -27,8 +27,97 @@
 #include "cache.h"
 #include "utils/pathutils.h"
 #include <QSettings>
+#include <QDirIterator>
+#include <QMutexLocker>
 
 namespace core {
+    namespace {
+        const char * const suffixes[]={".geo",".plc",".rt"};
+
+        /**
+        * @brief Writes one cache entry to disk off the calling thread
+        */
+        class CacheWriteTask:public QRunnable
+        {
+        public:
+            CacheWriteTask(QString const& filename,QString const& content):filename(filename),content(content){}
+            void run()
+            {
+                QFileInfo File(filename);
+                QDir dir=File.absoluteDir();
+                if(!dir.exists()&&!dir.mkpath(dir.absolutePath()))
+                {
+#ifdef DEBUG_CACHE
+                    qDebug()<<"Cache: Could not create path"<<dir.absolutePath();
+#endif //DEBUG_CACHE
+                    return;
+                }
+                QFile file(filename);
+                if (file.open(QIODevice::WriteOnly))
+                {
+                    QTextStream stream(&file);
+                    stream.setCodec("UTF-8");
+                    stream<<content;
+                }
+#ifdef DEBUG_CACHE
+                else
+                    qDebug()<<"Cache: Could not write"<<filename;
+#endif //DEBUG_CACHE
+            }
+        private:
+            QString filename;
+            QString content;
+        };
+    }
+
+    /**
+    * @brief Reads the entries cached on disk into the in memory index
+    */
+    class CacheLoadTask:public QRunnable
+    {
+    public:
+        CacheLoadTask(Cache * cache,int generation):cache(cache),generation(generation)
+        {
+            for(int kind=0;kind<Cache::KINDS;++kind)
+                paths[kind]=cache->KindPath((Cache::Kind)kind);
+        }
+        void run()
+        {
+            for(int kind=0;kind<Cache::KINDS;++kind)
+            {
+                QString suffix=suffixes[kind];
+                QHash<QString,QString> loaded;
+                QDirIterator it(paths[kind],QStringList()<<"*"+suffix,QDir::Files);
+                while(it.hasNext())
+                {
+                    QFile file(it.next());
+                    if (!file.open(QIODevice::ReadOnly))
+                        continue;
+                    QTextStream stream(&file);
+                    stream.setCodec("UTF-8");
+                    QString name=it.fileName();
+                    loaded.insert(name.left(name.length()-suffix.length()),stream.readAll());
+                }
+#ifdef DEBUG_CACHE
+                qDebug()<<"CacheLoadTask: loaded"<<loaded.count()<<"entries from"<<paths[kind];
+#endif //DEBUG_CACHE
+                QMutexLocker locker(&cache->entriesMutex);
+                if(generation!=cache->generation)
+                    return;
+                // Entries stored while loading are newer than the files
+                for(QHash<QString,QString>::const_iterator i=loaded.constBegin();i!=loaded.constEnd();++i)
+                {
+                    if(!cache->entries[kind].contains(i.key()))
+                        cache->entries[kind].insert(i.key(),i.value());
+                }
+            }
+        }
+    private:
+        Cache * cache;
+        int generation;
+        QString paths[Cache::KINDS];
+    };
+
     Cache* Cache::m_pInstance=0;
 
     Cache* Cache::Instance()
@@ -45,43 +134,59 @@ namespace core {
         geoCache = cache + "GeocoderCache"+ QDir::separator();
         placemarkCache = cache + "PlacemarkCache" + QDir::separator();
         ImageCache.setGtileCache(value);
+        {
+            QMutexLocker locker(&entriesMutex);
+            ++generation;
+            for(int kind=0;kind<KINDS;++kind)
+                entries[kind].clear();
+        }
+        // Runs before any write queued from now on, the pool has one thread
+        persistence.start(new CacheLoadTask(this,generation));
     }
     QString Cache::CacheLocation()
     {
         return cache;
     }
-    Cache::Cache()
+    Cache::Cache():generation(0)
     {
+        persistence.setMaxThreadCount(1);
         if(cache.isNull()|cache.isEmpty())
         {
             cache= Utils::PathUtils().GetStoragePath()+"mapscache"+QDir::separator();
             setCacheLocation(cache);
         }
     }
-    QString Cache::GetGeocoderFromCache(const QString &urlEnd)
+    QString Cache::KindPath(Kind kind)
     {
-#ifdef DEBUG_GetGeocoderFromCache
-        qDebug()<<"Entered GetGeocoderFromCache";
-#endif
-        QString ret=QString::null;
-        QString filename=geoCache+QString(urlEnd)+".geo";
-#ifdef DEBUG_GetGeocoderFromCache
-        qDebug()<<"GetGeocoderFromCache: Does file exist?:"<<filename;
-#endif
-        QFileInfo File(filename);
-        if (File .exists())
+        switch(kind)
         {
-#ifdef DEBUG_GetGeocoderFromCache
-            qDebug()<<"GetGeocoderFromCache:File exists!!";
-#endif
-            QFile file(filename);
-            if (file.open(QIODevice::ReadOnly))
-            {
-                QTextStream stream(&file);
-                stream.setCodec("UTF-8");
-                stream>>ret;
-            }
+        case Geocoder:
+            return geoCache;
+        case Placemark:
+            return placemarkCache;
+        default:
+            return routeCache;
         }
+    }
+    QString Cache::Lookup(Kind kind,const QString &urlEnd)
+    {
+        QMutexLocker locker(&entriesMutex);
+        return entries[kind].value(urlEnd,QString::null);
+    }
+    void Cache::Store(Kind kind,const QString &urlEnd,const QString &content)
+    {
+        {
+            QMutexLocker locker(&entriesMutex);
+            entries[kind].insert(urlEnd,content);
+        }
+#ifdef DEBUG_CACHE
+        qDebug()<<"Cache: queue write"<<KindPath(kind)+urlEnd+suffixes[kind];
+#endif //DEBUG_CACHE
+        persistence.start(new CacheWriteTask(KindPath(kind)+urlEnd+suffixes[kind],content));
+    }
+    QString Cache::GetGeocoderFromCache(const QString &urlEnd)
+    {
+        QString ret=Lookup(Geocoder,urlEnd);
 #ifdef DEBUG_GetGeocoderFromCache
         qDebug()<<"GetGeocoderFromCache:Returning:"<<ret;
 #endif
@@ -89,67 +194,11 @@ namespace core {
     }
     void Cache::CacheGeocoder(const QString &urlEnd, const QString &content)
     {
-        QString ret=QString::null;
-        QString filename=geoCache+QString(urlEnd)+".geo";
-#ifdef DEBUG_CACHE
-        qDebug()<<"CacheGeocoder: Filename:"<<filename;
-#endif //DEBUG_CACHE
-        QFileInfo File(filename);;
-        QDir dir=File.absoluteDir();
-        QString path=dir.absolutePath();
-#ifdef DEBUG_CACHE
-        qDebug()<<"CacheGeocoder: Path:"<<path;
-#endif //DEBUG_CACHE
-        if(!dir.exists())
-        {
-#ifdef DEBUG_CACHE
-            qDebug()<<"CacheGeocoder: Cache path doesn't exist, try to create";
-#endif //DEBUG_CACHE
-            if(!dir.mkpath(path))
-            {
-#ifdef DEBUG_CACHE
-                qDebug()<<"GetGeocoderFromCache: Could not create path";
-#endif //DEBUG_CACHE
-            }
-        }
-#ifdef DEBUG_CACHE
-        qDebug()<<"CacheGeocoder: OpenFile:"<<filename;
-#endif //DEBUG_CACHE
-        QFile file(filename);
-        if (file.open(QIODevice::WriteOnly))
-        {
-#ifdef DEBUG_CACHE
-            qDebug()<<"CacheGeocoder: File Opened!!!:"<<filename;
-#endif //DEBUG_CACHE
-            QTextStream stream(&file);
-            stream.setCodec("UTF-8");
-            stream<<content;
-        }
+        Store(Geocoder,urlEnd,content);
     }
     QString Cache::GetPlacemarkFromCache(const QString &urlEnd)
     {
-#ifdef DEBUG_CACHE
-        qDebug()<<"Entered GetPlacemarkFromCache";
-#endif //DEBUG_CACHE
-        QString ret=QString::null;
-        QString filename=placemarkCache+QString(urlEnd)+".plc";
-#ifdef DEBUG_CACHE
-        qDebug()<<"GetPlacemarkFromCache: Does file exist?:"<<filename;
-#endif //DEBUG_CACHE
-        QFileInfo File(filename);
-        if (File .exists())
-        {
-#ifdef DEBUG_CACHE
-            qDebug()<<"GetPlacemarkFromCache:File exists!!";
-#endif //DEBUG_CACHE
-            QFile file(filename);
-            if (file.open(QIODevice::ReadOnly))
-            {
-                QTextStream stream(&file);
-                stream.setCodec("UTF-8");
-                stream>>ret;
-            }
-        }
+        QString ret=Lookup(Placemark,urlEnd);
 #ifdef DEBUG_CACHE
         qDebug()<<"GetPlacemarkFromCache:Returning:"<<ret;
 #endif //DEBUG_CACHE
@@ -157,41 +206,14 @@ namespace core {
     }
     void Cache::CachePlacemark(const QString &urlEnd, const QString &content)
     {
-        QString ret=QString::null;
-        QString filename=placemarkCache+QString(urlEnd)+".plc";
-#ifdef DEBUG_CACHE
-        qDebug()<<"CachePlacemark: Filename:"<<filename;
-#endif //DEBUG_CACHE
-        QFileInfo File(filename);;
-        QDir dir=File.absoluteDir();
-        QString path=dir.absolutePath();
-#ifdef DEBUG_CACHE
-        qDebug()<<"CachePlacemark: Path:"<<path;
-#endif //DEBUG_CACHE
-        if(!dir.exists())
-        {
-#ifdef DEBUG_CACHE
-            qDebug()<<"CachePlacemark: Cache path doesn't exist, try to create";
-#endif //DEBUG_CACHE
-            if(!dir.mkpath(path))
-            {
-#ifdef DEBUG_CACHE
-                qDebug()<<"CachePlacemark: Could not create path";
-#endif //DEBUG_CACHE
-            }
-        }
-#ifdef DEBUG_CACHE
-        qDebug()<<"CachePlacemark: OpenFile:"<<filename;
-#endif //DEBUG_CACHE
-        QFile file(filename);
-        if (file.open(QIODevice::WriteOnly))
-        {
-#ifdef DEBUG_CACHE
-            qDebug()<<"CachePlacemark: File Opened!!!:"<<filename;
-#endif //DEBUG_CACHE
-            QTextStream stream(&file);
-            stream.setCodec("UTF-8");
-            stream<<content;
-        }
+        Store(Placemark,urlEnd,content);
+    }
+    QString Cache::GetRouteFromCache(const QString &urlEnd)
+    {
+        return Lookup(Route,urlEnd);
+    }
+    void Cache::CacheRoute(const QString &urlEnd, const QString &content)
+    {
+        Store(Route,urlEnd,content);
     }
 }
@@ -29,10 +29,20 @@
 
 #include "pureimagecache.h"
 #include "debugheader.h"
+#include <QHash>
+#include <QMutex>
+#include <QThreadPool>
 
 namespace core {
+    /**
+    * @brief Geocoder, placemark and route answers are kept in memory and written
+    *       to their files on a background thread, lookups never touch the disk.
+    *       The files of a cache location are read back in the background when it
+    *       is set; until then lookups miss and the answer is fetched again.
+    */
     class Cache
     {
+        friend class CacheLoadTask;
     public:
         static Cache* Instance();
 
@@ -48,6 +58,10 @@ namespace core {
         QString GetRouteFromCache(const QString &urlEnd);
 
     private:
+        enum Kind {Geocoder,Placemark,Route,KINDS};
+        QString KindPath(Kind kind);
+        QString Lookup(Kind kind,const QString &urlEnd);
+        void Store(Kind kind,const QString &urlEnd,const QString &content);
         Cache();
         Cache(Cache const&){}
         Cache& operator=(Cache const&){ return *this; }
@@ -56,6 +70,11 @@ namespace core {
         QString routeCache;
         QString geoCache;
         QString placemarkCache;
+        QHash<QString,QString> entries[KINDS];
+        QMutex entriesMutex;
+        int generation;
+        // One thread, so the files are written in the order they were stored
+        QThreadPool persistence;
     };
 
 }
@@ -16,7 +16,8 @@ SOURCES += opmaps.cpp \
     point.cpp \
     size.cpp \
     kibertilecache.cpp \
-    diagnostics.cpp
+    diagnostics.cpp \
+    tilearchive.cpp
 HEADERS += opmaps.h \
     size.h \
     maptype.h \
@@ -37,4 +38,5 @@ HEADERS += opmaps.h \
     point.h \
     kibertilecache.h \
     debugheader.h \
-    diagnostics.h
+    diagnostics.h \
+    tilearchive.h
@@ -31,10 +31,15 @@
 namespace core {
     KiberTileCache::KiberTileCache()
     {
-        memoryCacheSize = 0;
-        _MemoryCacheCapacity = 22;
+        _MemoryCacheCapacity = 64;
+        cache.setMaxCost(_MemoryCacheCapacity*1048576);
+        hits = 0;
+        misses = 0;
     }
 
+    /**
+    * @brief Sets the capacity in MB, applied on the next insertion or cleanup
+    */
     void KiberTileCache::setMemoryCacheCapacity(const int &value)
     {
         kiberCacheLock.lockForWrite();
@@ -44,26 +49,42 @@ namespace core {
     int KiberTileCache::MemoryCacheCapacity()
     {
         kiberCacheLock.lockForRead();
-        return _MemoryCacheCapacity;
+        int ret=_MemoryCacheCapacity;
         kiberCacheLock.unlock();
+        return ret;
     }
 
-    void KiberTileCache::RemoveMemoryOverload()
+    QByteArray KiberTileCache::Get(const RawTile &tile)
     {
-        while(MemoryCacheSize()>MemoryCacheCapacity())
+        QByteArray *pic=cache.object(tile);
+        if(pic==0)
         {
-            if(cachequeue.count()>0 && list.count()>0)
-            {
+            ++misses;
+            return QByteArray();
+        }
+        ++hits;
+        return *pic;
+    }
+
+    void KiberTileCache::Add(const RawTile &tile, const QByteArray &pic)
+    {
+        RemoveMemoryOverload();
+        cache.insert(tile,new QByteArray(pic),pic.size());
 #ifdef DEBUG_MEMORY_CACHE
-                qDebug()<<"Cleaning Memory cache="<<" started with "<<cachequeue.count()<<" tile "<<"ocupying "<<memoryCacheSize<<" bytes";
+        qDebug()<<"Current memory="<<cache.totalCost()<<" in "<<cache.count()<<" tiles";
 #endif
-                RawTile first=list.dequeue();
-                memoryCacheSize-=cachequeue.value(first).size();
-                cachequeue.remove(first);
-            }
+    }
+
+    void KiberTileCache::RemoveMemoryOverload()
+    {
+        // QCache drops the least recently used tiles down to the new limit
+        int capacity=MemoryCacheCapacity()*1048576;
+        if(cache.maxCost()!=capacity)
+        {
+            cache.setMaxCost(capacity);
         }
 #ifdef DEBUG_MEMORY_CACHE
-        qDebug()<<"Cleaning Memory cache="<<" ended with "<<cachequeue.count()<<" tile "<<"ocupying "<<memoryCacheSize<<" bytes";
+        qDebug()<<"Memory cache holds "<<cache.count()<<" tiles "<<"ocupying "<<cache.totalCost()<<" bytes, "<<hits<<" hits "<<misses<<" misses";
 #endif
     }
 }
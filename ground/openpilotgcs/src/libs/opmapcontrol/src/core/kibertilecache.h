@@ -30,10 +30,15 @@
 #include "rawtile.h"
 #include <QMutex>
 #include <QReadWriteLock>
-#include <QQueue>
+#include <QCache>
 #include <QDebug>
 #include "debugheader.h"
 namespace core {
+    /**
+    * @brief Tiles kept in memory, least recently used ones are evicted first once
+    *        the bytes held exceed the capacity. Callers serialize access with
+    *        MemoryCache::kiberCacheLock, a lookup reorders so it needs the write lock.
+    */
     class KiberTileCache
     {
     public:
@@ -41,14 +46,20 @@ namespace core {
 
         void setMemoryCacheCapacity(const int &value);
         int MemoryCacheCapacity();
-        double MemoryCacheSize(){return memoryCacheSize/1048576.0;}
+        double MemoryCacheSize(){return cache.totalCost()/1048576.0;}
+        qint64 MemoryCacheBytes(){QReadLocker locker(&kiberCacheLock);return cache.totalCost();}
+        int TilesCount(){QReadLocker locker(&kiberCacheLock);return cache.count();}
         void RemoveMemoryOverload();
+        QByteArray Get(const RawTile &tile);
+        void Add(const RawTile &tile, const QByteArray &pic);
+        quint64 Hits()const{return hits;}
+        quint64 Misses()const{return misses;}
         QReadWriteLock kiberCacheLock;
-        QHash <RawTile,QByteArray> cachequeue;
-        QQueue <RawTile> list;
-        long memoryCacheSize;
     private:
+        QCache <RawTile,QByteArray> cache;
         int _MemoryCacheCapacity;
+        quint64 hits;
+        quint64 misses;
 
     };
 
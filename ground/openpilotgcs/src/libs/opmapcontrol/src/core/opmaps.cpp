@@ -83,6 +83,14 @@ namespace core {
 #ifdef DEBUG_GMAPS
             qDebug()<<"Tile not in memory";
 #endif //DEBUG_GMAPS
+            ret=Archive.GetTile(type,pos,zoom);
+            if(!ret.isEmpty())
+            {
+                errorvars.lock();
+                ++diag.tilesFromDB;
+                errorvars.unlock();
+                return ret;
+            }
             if(accessmode != (AccessMode::ServerOnly))
             {
 #ifdef DEBUG_GMAPS
@@ -40,6 +40,7 @@
 #include "alllayersoftype.h"
 #include "urlfactory.h"
 #include "diagnostics.h"
+#include "tilearchive.h"
 
 //#include "point.h"
 
@@ -70,6 +71,10 @@ namespace core {
         void setAccessMode(const AccessMode::Types& mode){accessmode=mode;}
         int RetryLoadTile;
         diagnostics GetDiagnostics();
+        /**
+        * @brief Offline tiles looked up after the memory cache, before the database
+        */
+        TileArchive Archive;
 
     private:
         bool useMemoryCache;
@@ -36,6 +36,64 @@ namespace core {
 
     }
 
+    PureImageCache::ThreadConnection::ThreadConnection(const QString &file, qlonglong id)
+        : file(file), name(QString("PureImageCache%1").arg(id)), getTile(0), putTile(0), putTileData(0), ok(false)
+    {
+        QSqlDatabase cn;
+        cn = QSqlDatabase::addDatabase("QSQLITE",name);
+        cn.setDatabaseName(file);
+        if(!cn.open())
+        {
+#ifdef DEBUG_PUREIMAGECACHE
+            qDebug()<<"ThreadConnection: Unable to open "<<file;
+#endif //DEBUG_PUREIMAGECACHE
+            return;
+        }
+        {
+            QSqlQuery query(cn);
+            // Readers do not block the cache writer and commits need fewer syncs
+            query.exec("PRAGMA journal_mode=WAL");
+            query.exec("PRAGMA synchronous=NORMAL");
+            // Caches created before the index existed get it here
+            query.exec("CREATE INDEX IF NOT EXISTS IndexOfTiles ON Tiles (X, Y, Zoom, Type)");
+        }
+        getTile=new QSqlQuery(cn);
+        putTile=new QSqlQuery(cn);
+        putTileData=new QSqlQuery(cn);
+        ok=getTile->prepare("SELECT Tile FROM TilesData WHERE id = (SELECT id FROM Tiles WHERE X=? AND Y=? AND Zoom=? AND Type=?)");
+        ok&=putTile->prepare("INSERT INTO Tiles(X, Y, Zoom, Type, Date) VALUES(?, ?, ?, ?, ?)");
+        ok&=putTileData->prepare("INSERT INTO TilesData(id, Tile) VALUES(?, ?)");
+#ifdef DEBUG_PUREIMAGECACHE
+        if(!ok)
+            qDebug()<<"ThreadConnection: "<<cn.lastError().driverText();
+#endif //DEBUG_PUREIMAGECACHE
+    }
+
+    PureImageCache::ThreadConnection::~ThreadConnection()
+    {
+        delete getTile;
+        delete putTile;
+        delete putTileData;
+        {
+            QSqlDatabase cn=QSqlDatabase::database(name,false);
+            cn.close();
+        }
+        QSqlDatabase::removeDatabase(name);
+    }
+
+    PureImageCache::ThreadConnection *PureImageCache::connection()
+    {
+        QString db=gtilecache+"Data.qmdb";
+        if(connections.hasLocalData() && connections.localData()->file==db)
+            return connections.localData();
+        Mcounter.lock();
+        qlonglong id=++ConnCounter;
+        Mcounter.unlock();
+        // Replaces, and so closes, a connection to a previous cache directory
+        connections.setLocalData(new ThreadConnection(db,id));
+        return connections.localData();
+    }
+
     void PureImageCache::setGtileCache(const QString &value)
     {
         lock.lockForWrite();
@@ -108,6 +166,15 @@ namespace core {
         {
 #ifdef DEBUG_PUREIMAGECACHE
             qDebug()<<"CreateEmptyDB: "<<query.lastError().driverText();
+#endif //DEBUG_PUREIMAGECACHE
+            db.close();
+            return false;
+        }
+        query.exec("CREATE INDEX IF NOT EXISTS IndexOfTiles ON Tiles (X, Y, Zoom, Type)");
+        if(query.numRowsAffected()==-1)
+        {
+#ifdef DEBUG_PUREIMAGECACHE
+            qDebug()<<"CreateEmptyDB: "<<query.lastError().driverText();
 #endif //DEBUG_PUREIMAGECACHE
             db.close();
             return false;
@@ -177,123 +244,106 @@ namespace core {
 #ifdef DEBUG_PUREIMAGECACHE
         qDebug()<<"PutImageToCache Start:";//<<pos;
 #endif //DEBUG_PUREIMAGECACHE
-        Mcounter.lock();
-        qlonglong id=++ConnCounter;
-        Mcounter.unlock();
+        ThreadConnection *cn=connection();
+        bool ret=cn->ok;
+        if(ret)
         {
-            QSqlDatabase cn;
-            cn = QSqlDatabase::addDatabase("QSQLITE",QString::number(id));
-            QString db=gtilecache+"Data.qmdb";
-            cn.setDatabaseName(db);
-            cn.setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
-            if(cn.open())
+            cn->putTile->bindValue(0,pos.X());
+            cn->putTile->bindValue(1,pos.Y());
+            cn->putTile->bindValue(2,zoom);
+            cn->putTile->bindValue(3,(int)type);
+            cn->putTile->bindValue(4,QDateTime::currentDateTime().toString());
+            ret=cn->putTile->exec();
+            if(ret)
             {
-                {
-                    QSqlQuery query(cn);
-                    query.prepare("INSERT INTO Tiles(X, Y, Zoom, Type,Date) VALUES(?, ?, ?, ?,?)");
-                    query.addBindValue(pos.X());
-                    query.addBindValue(pos.Y());
-                    query.addBindValue(zoom);
-
-                    query.addBindValue((int)type);
-                    query.addBindValue(QDateTime::currentDateTime().toString());
-                    query.exec();
-                }
-                {
-                    QSqlQuery query(cn);
-                    query.prepare("INSERT INTO TilesData(id, Tile) VALUES((SELECT last_insert_rowid()), ?)");
-                    query.addBindValue(tile);
-                    query.exec();
-                }
-                cn.close();
+                cn->putTileData->bindValue(0,cn->putTile->lastInsertId());
+                cn->putTileData->bindValue(1,tile);
+                ret=cn->putTileData->exec();
             }
         }
-        QSqlDatabase::removeDatabase(QString::number(id));
         lock.unlock();
-        return true;
+        return ret;
     }
     QByteArray PureImageCache::GetImageFromCache(MapType::Types type, Point pos, int zoom)
     {
-        lock.lockForRead();
         QByteArray ar;
         if(gtilecache.isEmpty()|gtilecache.isNull())
             return ar;
-        QString dir=gtilecache;
-        Mcounter.lock();
-        qlonglong id=++ConnCounter;
-        Mcounter.unlock();
+        lock.lockForRead();
 #ifdef DEBUG_PUREIMAGECACHE
-        qDebug()<<"Cache dir="<<dir<<" Try to GET:"<<pos.X()+","+pos.Y();
+        qDebug()<<"Cache dir="<<gtilecache<<" Try to GET:"<<pos.X()+","+pos.Y();
 #endif //DEBUG_PUREIMAGECACHE
-
+        ThreadConnection *cn=connection();
+        if(cn->ok)
         {
-            QString db=dir+"Data.qmdb";
+            cn->getTile->bindValue(0,pos.X());
+            cn->getTile->bindValue(1,pos.Y());
+            cn->getTile->bindValue(2,zoom);
+            cn->getTile->bindValue(3,(int) type);
+            if(cn->getTile->exec() && cn->getTile->next())
             {
-                QSqlDatabase cn;
-
-                cn = QSqlDatabase::addDatabase("QSQLITE",QString::number(id));
-
-                cn.setDatabaseName(db);
-                cn.setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
-                if(cn.open())
-                {
-                    {
-                        QSqlQuery query(cn);
-                        query.exec(QString("SELECT Tile FROM TilesData WHERE id = (SELECT id FROM Tiles WHERE X=%1 AND Y=%2 AND Zoom=%3 AND Type=%4)").arg(pos.X()).arg(pos.Y()).arg(zoom).arg((int) type));
-                        query.next();
-                        if(query.isValid())
-                        {
-                            ar=query.value(0).toByteArray();
-                        }
-                    }
-                    cn.close();
-                }
+                ar=cn->getTile->value(0).toByteArray();
             }
+            // Let go of the read snapshot so the writer can checkpoint
+            cn->getTile->finish();
         }
-        QSqlDatabase::removeDatabase(QString::number(id));
         lock.unlock();
         return ar;
     }
+    /**
+    * @brief Group the following puts of this thread in one transaction, they are
+    *        written with a single commit by CommitTransaction()
+    */
+    bool PureImageCache::BeginTransaction()
+    {
+        if(gtilecache.isEmpty()|gtilecache.isNull())
+            return false;
+        lock.lockForRead();
+        ThreadConnection *cn=connection();
+        bool ret=cn->ok && QSqlDatabase::database(cn->name,false).transaction();
+        lock.unlock();
+        return ret;
+    }
+    bool PureImageCache::CommitTransaction()
+    {
+        if(!connections.hasLocalData())
+            return false;
+        return QSqlDatabase::database(connections.localData()->name,false).commit();
+    }
     void PureImageCache::deleteOlderTiles(int const& days)
     {
         if(gtilecache.isEmpty()|gtilecache.isNull())
             return;
-        QList<long> add;
-        bool ret=true;
-        QString dir=gtilecache;
+        if(!QFileInfo(gtilecache+"Data.qmdb").exists())
+            return;
+        lock.lockForRead();
+        ThreadConnection *cn=connection();
+        if(cn->ok)
         {
-            QString db=dir+"Data.qmdb";
-            ret=QFileInfo(db).exists();
-            if(ret)
+            QList<qlonglong> add;
+            QSqlDatabase db=QSqlDatabase::database(cn->name,false);
             {
-                QSqlDatabase cn;
-                Mcounter.lock();
-                qlonglong id=++ConnCounter;
-                Mcounter.unlock();
-                cn = QSqlDatabase::addDatabase("QSQLITE",QString::number(id));
-                cn.setDatabaseName(db);
-                cn.setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
-                if(cn.open())
+                QSqlQuery query(db);
+                query.exec(QString("SELECT id, Date FROM Tiles"));
+                while(query.next())
                 {
-                    {
-                        QSqlQuery query(cn);
-                        query.exec(QString("SELECT id, X, Y, Zoom, Type, Date FROM Tiles"));
-                        while(query.next())
-                        {
-                            if(QDateTime::fromString(query.value(5).toString()).daysTo(QDateTime::currentDateTime())>days)
-                                add.append(query.value(0).toLongLong());
-                        }
-                        foreach(long i,add)
-                        {
-                            query.exec(QString("DELETE FROM Tiles WHERE id = %1;").arg(i));
-                        }
-                    }
-
-                    cn.close();
+                    if(QDateTime::fromString(query.value(1).toString()).daysTo(QDateTime::currentDateTime())>days)
+                        add.append(query.value(0).toLongLong());
                 }
-                QSqlDatabase::removeDatabase(QString::number(id));
             }
+            db.transaction();
+            {
+                QSqlQuery query(db);
+                query.prepare("DELETE FROM Tiles WHERE id = ?");
+                foreach(qlonglong i,add)
+                {
+                    query.bindValue(0,i);
+                    query.exec();
+                }
+            }
+            db.commit();
         }
+        lock.unlock();
     }
     // PureImageCache::ExportMapDataToDB("C:/Users/Xapo/Documents/mapcontrol/debug/mapscache/data.qmdb","C:/Users/Xapo/Documents/mapcontrol/debug/mapscache/data2.qmdb");
     bool PureImageCache::ExportMapDataToDB(QString sourceFile, QString destFile)
@@ -42,6 +42,7 @@
 #include <QList>
 #include <QMutex>
 #include <QReadWriteLock>
+#include <QThreadStorage>
 namespace core {
     class PureImageCache
     {
@@ -55,11 +56,32 @@ namespace core {
         void setGtileCache(const QString &value);
         static bool ExportMapDataToDB(QString sourceFile, QString destFile);
         void deleteOlderTiles(int const& days);
+        bool BeginTransaction();
+        bool CommitTransaction();
     private:
+        /**
+        * @brief The calling thread's connection to the cache. Qt connections can not
+        *        be shared between threads, so each thread keeps one open with its
+        *        statements prepared for as long as it lives.
+        */
+        class ThreadConnection
+        {
+        public:
+            ThreadConnection(const QString &file, qlonglong id);
+            ~ThreadConnection();
+            QString file;
+            QString name;
+            QSqlQuery *getTile;
+            QSqlQuery *putTile;
+            QSqlQuery *putTileData;
+            bool ok;
+        };
+        ThreadConnection *connection();
         QString gtilecache;
         QMutex Mcounter;
         QReadWriteLock lock;
         static qlonglong ConnCounter;
+        QThreadStorage<ThreadConnection*> connections;
 
     };
 
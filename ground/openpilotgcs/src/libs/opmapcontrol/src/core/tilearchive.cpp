@@ -0,0 +1,230 @@
+/**
+******************************************************************************
+*
+* @file       tilearchive.cpp
+* @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+* @brief      Read only, memory mapped offline tile archive
+* @see        The GNU Public License (GPL) Version 3
+* @defgroup   OPMapWidget
+* @{
+*
+*****************************************************************************/
+/*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+* or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#include "tilearchive.h"
+#include <QtEndian>
+#include <QDataStream>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QVariant>
+#include <QDebug>
+#include <QtAlgorithms>
+//#define DEBUG_TILEARCHIVE
+
+#define ARCHIVE_MAGIC 0x4154504F // "OPTA"
+#define ARCHIVE_VERSION 1
+#define ARCHIVE_FLAG_ANYTYPE 0x01
+#define HEADER_SIZE 16
+#define ENTRY_SIZE 24
+
+namespace core {
+    namespace {
+        struct ArchiveRow
+        {
+            ArchiveRow(TileArchive::Key const& key):key(key){}
+            TileArchive::Key key;
+            QVariantList source;
+            bool operator<(ArchiveRow const& other)const{return key<other.key;}
+        };
+    }
+
+    TileArchive::TileArchive():data(0),size(0),count(0),flags(0)
+    {
+
+    }
+    TileArchive::~TileArchive()
+    {
+        Close();
+    }
+    bool TileArchive::Key::operator<(const Key &other)const
+    {
+        if(type!=other.type)
+            return type<other.type;
+        if(zoom!=other.zoom)
+            return zoom<other.zoom;
+        if(x!=other.x)
+            return x<other.x;
+        return y<other.y;
+    }
+    bool TileArchive::Key::operator==(const Key &other)const
+    {
+        return type==other.type&&zoom==other.zoom&&x==other.x&&y==other.y;
+    }
+    TileArchive::Key TileArchive::EntryKey(const uchar *entry)
+    {
+        return Key(qFromLittleEndian<quint16>(entry),qFromLittleEndian<quint16>(entry+2),
+                   qFromLittleEndian<quint32>(entry+4),qFromLittleEndian<quint32>(entry+8));
+    }
+    bool TileArchive::Open(const QString &name)
+    {
+        Close();
+        QWriteLocker locker(&lock);
+        file.setFileName(name);
+        if(!file.open(QIODevice::ReadOnly))
+            return false;
+        size=file.size();
+        data=(size>=HEADER_SIZE)?file.map(0,size):0;
+        if(data==0||qFromLittleEndian<quint32>(data)!=ARCHIVE_MAGIC||qFromLittleEndian<quint32>(data+4)!=ARCHIVE_VERSION)
+        {
+#ifdef DEBUG_TILEARCHIVE
+            qDebug()<<"TileArchive: not an archive"<<name;
+#endif //DEBUG_TILEARCHIVE
+            locker.unlock();
+            Close();
+            return false;
+        }
+        flags=qFromLittleEndian<quint32>(data+8);
+        count=qFromLittleEndian<quint32>(data+12);
+        if(HEADER_SIZE+(qint64)count*ENTRY_SIZE>size)
+        {
+            locker.unlock();
+            Close();
+            return false;
+        }
+#ifdef DEBUG_TILEARCHIVE
+        qDebug()<<"TileArchive: opened"<<name<<count<<"tiles";
+#endif //DEBUG_TILEARCHIVE
+        return true;
+    }
+    void TileArchive::Close()
+    {
+        QWriteLocker locker(&lock);
+        if(data)
+            file.unmap(data);
+        data=0;
+        size=0;
+        count=0;
+        flags=0;
+        file.close();
+    }
+    bool TileArchive::IsOpen()
+    {
+        QReadLocker locker(&lock);
+        return data!=0;
+    }
+    QByteArray TileArchive::GetTile(const MapType::Types &type, const core::Point &pos, const int &zoom)
+    {
+        QReadLocker locker(&lock);
+        if(data==0)
+            return QByteArray();
+        Key key((flags&ARCHIVE_FLAG_ANYTYPE)?0:(quint16)type,zoom,pos.X(),pos.Y());
+        const uchar * index=data+HEADER_SIZE;
+        quint32 low=0;
+        quint32 high=count;
+        while(low<high)
+        {
+            quint32 mid=low+(high-low)/2;
+            if(EntryKey(index+(qint64)mid*ENTRY_SIZE)<key)
+                low=mid+1;
+            else
+                high=mid;
+        }
+        if(low==count)
+            return QByteArray();
+        const uchar * entry=index+(qint64)low*ENTRY_SIZE;
+        if(!(EntryKey(entry)==key))
+            return QByteArray();
+        quint32 length=qFromLittleEndian<quint32>(entry+12);
+        quint64 offset=qFromLittleEndian<quint64>(entry+16);
+        if(offset+length>(quint64)size)
+            return QByteArray();
+        // The caller may outlive the mapping, so the slice is copied
+        return QByteArray((const char*)data+offset,length);
+    }
+    bool TileArchive::ExportFromDB(const QString &sourceDB, const QString &archive)
+    {
+        return Write(sourceDB,"SELECT Type, Zoom, X, Y, id FROM Tiles",
+                     "SELECT Tile FROM TilesData WHERE id=?",false,archive);
+    }
+    bool TileArchive::ImportMBTiles(const QString &mbtiles, const QString &archive)
+    {
+        return Write(mbtiles,"SELECT 0, zoom_level, tile_column, tile_row FROM tiles",
+                     "SELECT tile_data FROM tiles WHERE zoom_level=? AND tile_column=? AND tile_row=?",true,archive);
+    }
+    bool TileArchive::Write(const QString &sourceDB, const QString &keysQuery, const QString &tileQuery,
+                            bool mbtiles, const QString &archive)
+    {
+        bool ret=false;
+        QString name=QString("TileArchive%1").arg((quintptr)&archive);
+        {
+            QSqlDatabase db=QSqlDatabase::addDatabase("QSQLITE",name);
+            db.setDatabaseName(sourceDB);
+            QFile out(archive);
+            if(db.open()&&out.open(QIODevice::WriteOnly|QIODevice::Truncate))
+            {
+                QList<ArchiveRow> rows;
+                QSqlQuery keys(db);
+                keys.setForwardOnly(true);
+                keys.exec(keysQuery);
+                while(keys.next())
+                {
+                    quint32 zoom=keys.value(1).toUInt();
+                    quint32 y=keys.value(3).toUInt();
+                    // MBTiles rows count from the south
+                    ArchiveRow row(Key(keys.value(0).toUInt(),zoom,keys.value(2).toUInt(),mbtiles?(1u<<zoom)-1-y:y));
+                    if(mbtiles)
+                        row.source<<zoom<<keys.value(2)<<y;
+                    else
+                        row.source<<keys.value(4);
+                    rows.append(row);
+                }
+                qSort(rows);
+
+                QDataStream stream(&out);
+                stream.setByteOrder(QDataStream::LittleEndian);
+                stream<<(quint32)ARCHIVE_MAGIC<<(quint32)ARCHIVE_VERSION<<(quint32)(mbtiles?ARCHIVE_FLAG_ANYTYPE:0)<<(quint32)rows.count();
+                // Index is written once the offsets are known
+                out.seek(HEADER_SIZE+(qint64)rows.count()*ENTRY_SIZE);
+                QList<quint64> offsets;
+                QList<quint32> lengths;
+                QSqlQuery tile(db);
+                tile.prepare(tileQuery);
+                foreach(ArchiveRow const& row,rows)
+                {
+                    for(int i=0;i<row.source.count();++i)
+                        tile.bindValue(i,row.source[i]);
+                    QByteArray img;
+                    if(tile.exec()&&tile.next())
+                        img=tile.value(0).toByteArray();
+                    offsets.append(out.pos());
+                    lengths.append(img.size());
+                    out.write(img);
+                }
+                out.seek(HEADER_SIZE);
+                for(int i=0;i<rows.count();++i)
+                    stream<<rows[i].key.type<<rows[i].key.zoom<<rows[i].key.x<<rows[i].key.y<<lengths[i]<<offsets[i];
+                ret=(out.error()==QFile::NoError);
+                out.close();
+            }
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(name);
+#ifdef DEBUG_TILEARCHIVE
+        qDebug()<<"TileArchive: wrote"<<archive<<ret;
+#endif //DEBUG_TILEARCHIVE
+        return ret;
+    }
+}
@@ -0,0 +1,96 @@
+/**
+******************************************************************************
+*
+* @file       tilearchive.h
+* @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+* @brief      Read only, memory mapped offline tile archive
+* @see        The GNU Public License (GPL) Version 3
+* @defgroup   OPMapWidget
+* @{
+*
+*****************************************************************************/
+/*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+* or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef TILEARCHIVE_H
+#define TILEARCHIVE_H
+
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+#include <QReadWriteLock>
+#include "maptype.h"
+#include "point.h"
+#include "debugheader.h"
+namespace core {
+    /**
+    * @brief Offline tiles packed in one file that is memory mapped and never written.
+    *       The file is a header, an index sorted by tile and the tile images, so a
+    *       lookup is a binary search of the index and a slice of the mapping.
+    *
+    *       Layout, little endian:
+    *       header  "OPTA", version, flags, count (4 x 32 bit)
+    *       index   count x {type 16 bit, zoom 16 bit, x 32 bit, y 32 bit, length 32 bit,
+    *               offset 64 bit}, sorted by type, zoom, x then y
+    *       data    the images
+    *
+    *       Archives are written from a tile cache database by ExportFromDB, or from
+    *       an MBTiles file by ImportMBTiles. MBTiles hold one imagery set, those
+    *       archives answer for any map type.
+    */
+    class TileArchive
+    {
+    public:
+        /**
+        * @brief Sort key of a tile, the index order
+        */
+        struct Key
+        {
+            Key(quint16 type,quint16 zoom,quint32 x,quint32 y):type(type),zoom(zoom),x(x),y(y){}
+            bool operator<(Key const& other)const;
+            bool operator==(Key const& other)const;
+            quint16 type;
+            quint16 zoom;
+            quint32 x;
+            quint32 y;
+        };
+        TileArchive();
+        ~TileArchive();
+        /**
+        * @brief Maps an archive file, replacing the one open before
+        *
+        * @param file the archive
+        * @return false if the file is missing or is not an archive
+        */
+        bool Open(QString const& file);
+        void Close();
+        bool IsOpen();
+        QByteArray GetTile(MapType::Types const& type,core::Point const& pos,int const& zoom);
+        static bool ExportFromDB(QString const& sourceDB,QString const& archive);
+        static bool ImportMBTiles(QString const& mbtiles,QString const& archive);
+    private:
+        static bool Write(QString const& sourceDB,QString const& keysQuery,QString const& tileQuery,
+                          bool mbtiles,QString const& archive);
+        static Key EntryKey(uchar const* entry);
+        QFile file;
+        uchar * data;
+        qint64 size;
+        quint32 count;
+        quint32 flags;
+        QReadWriteLock lock;
+    };
+
+}
+#endif // TILEARCHIVE_H
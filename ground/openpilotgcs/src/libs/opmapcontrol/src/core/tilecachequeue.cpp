@@ -28,6 +28,9 @@
 
 
 //#define DEBUG_TILECACHEQUEUE
+
+// Most tiles stored per transaction
+#define MAX_BATCH 64
  
 namespace core {
 TileCacheQueue::TileCacheQueue()
@@ -85,15 +88,25 @@ void TileCacheQueue::run()
 #endif //DEBUG_TILECACHEQUEUE
         if(tileCacheQueue.count()>0)
         {
-            mutex.lock();
-            task=tileCacheQueue.dequeue();
-            mutex.unlock();
+            // Write what has queued up in one transaction, a commit per tile is what costs
+            Cache::Instance()->ImageCache.BeginTransaction();
+            for(int n=0;n<MAX_BATCH;++n)
+            {
+                mutex.lock();
+                if(tileCacheQueue.isEmpty())
+                {
+                    mutex.unlock();
+                    break;
+                }
+                task=tileCacheQueue.dequeue();
+                mutex.unlock();
 #ifdef DEBUG_TILECACHEQUEUE
-            qDebug()<<"Cache engine Put:"<<task->GetPosition().X()<<","<<task->GetPosition().Y();
+                qDebug()<<"Cache engine Put:"<<task->GetPosition().X()<<","<<task->GetPosition().Y();
 #endif //DEBUG_TILECACHEQUEUE
-            Cache::Instance()->ImageCache.PutImageToCache(task->GetImg(),task->GetMapType(),task->GetPosition(),task->GetZoom());
-            usleep(44);
-            delete task;
+                Cache::Instance()->ImageCache.PutImageToCache(task->GetImg(),task->GetMapType(),task->GetPosition(),task->GetZoom());
+                delete task;
+            }
+            Cache::Instance()->ImageCache.CommitTransaction();
         }
 
         else
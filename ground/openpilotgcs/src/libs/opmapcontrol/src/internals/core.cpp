@@ -32,9 +32,28 @@ qlonglong internals::Core::debugcounter=0;
 
 using namespace projections;
 
+namespace {
+    // Orders load tasks by distance to the view centre, the middle of the map loads first
+    struct CloserToCentre
+    {
+        CloserToCentre(core::Point const& centre):centre(centre){}
+        bool operator()(internals::LoadTask const& a, internals::LoadTask const& b) const
+        {
+            return distance(a.Pos) < distance(b.Pos);
+        }
+        int distance(core::Point const& p) const
+        {
+            int dx=p.X()-centre.X();
+            int dy=p.Y()-centre.Y();
+            return dx*dx+dy*dy;
+        }
+        core::Point centre;
+    };
+}
+
 namespace internals {
     Core::Core():MouseWheelZooming(false),currentPosition(0,0),currentPositionPixel(0,0),LastLocationInBounds(-1,-1),sizeOfMapArea(0,0)
-            ,minOfTiles(0,0),maxOfTiles(0,0),zoom(0),isDragging(false),TooltipTextPadding(10,10),loaderLimit(5),maxzoom(21),started(false),runningThreads(0)
+            ,minOfTiles(0,0),maxOfTiles(0,0),zoom(0),isDragging(false),TooltipTextPadding(10,10),loadGeneration(0),loaderLimit(5),maxzoom(21),started(false),runningThreads(0)
     {
         mousewheelzoomtype=MouseWheelZoomType::MousePositionAndCenter;
         SetProjection(new MercatorProjection());
@@ -67,6 +86,10 @@ namespace internals {
 
         LoadTask task;
 
+        // Take a connection first and the task after, so the task is the most
+        // central one at the time a connection frees up
+        loaderLimit.acquire();
+
         MtileLoadQueue.lock();
         {
             if(tileLoadQueue.count() > 0)
@@ -83,8 +106,7 @@ namespace internals {
         }
         MtileLoadQueue.unlock();
 
-        if(task.HasValue())
-            if(loaderLimit.tryAcquire(1,OPMaps::Instance()->Timeout))
+        if(task.HasValue() && !IsStale(task))
             {
             MtileToload.lock();
             --tilesToload;
@@ -112,6 +134,9 @@ namespace internals {
 
                         foreach(MapType::Types tl,layers)
                         {
+                            // Zoomed or reloaded meanwhile, the rest is not needed
+                            if(IsStale(task))
+                                break;
                             int retry = 0;
                             do
                             {
@@ -163,7 +188,7 @@ namespace internals {
                             while(++retry < OPMaps::Instance()->RetryLoadTile);
                         }
 
-                        if(t->Overlays.count() > 0)
+                        if(t->Overlays.count() > 0 && !IsStale(task))
                         {
                             Matrix.SetTileAt(task.Pos,t);
                             emit OnNeedInvalidation();
@@ -217,8 +242,8 @@ namespace internals {
             qDebug()<<"loaderLimit release:"+loaderLimit.available()<<" ID="<<debug;
 #endif
             emit OnTilesStillToLoad(tilesToload<0? 0:tilesToload);
-            loaderLimit.release();
         }
+        loaderLimit.release();
         MrunningThreads.lock();
         --runningThreads;
         MrunningThreads.unlock();
@@ -244,6 +269,7 @@ namespace internals {
             {
                 MtileLoadQueue.lock();
                 tileLoadQueue.clear();
+                ++loadGeneration;
                 MtileLoadQueue.unlock();
                 MtileToload.lock();
                 tilesToload=0;
@@ -494,6 +520,7 @@ namespace internals {
             MtileLoadQueue.lock();
             {
                 tileLoadQueue.clear();
+                ++loadGeneration;
             }
             MtileLoadQueue.unlock();
             MtileToload.lock();
@@ -598,13 +625,14 @@ namespace internals {
     {
         if(started)
         {
-            ProcessLoadTaskCallback.waitForDone();
             MtileLoadQueue.lock();
             {
                 tileLoadQueue.clear();
+                ++loadGeneration;
                 //tilesToload=0;
             }
             MtileLoadQueue.unlock();
+            ProcessLoadTaskCallback.waitForDone();
             MtileToload.lock();
             tilesToload=0;
             MtileToload.unlock();
@@ -623,33 +651,51 @@ namespace internals {
 
             emit OnTileLoadStart();
 
-
-            foreach(Point p,tileDrawingList)
+            MtileLoadQueue.lock();
             {
-                LoadTask task = LoadTask(p, Zoom());
+                // Tiles panned out of view are not worth loading any more
+                for(int i = tileLoadQueue.count() - 1; i >= 0; --i)
                 {
-                    MtileLoadQueue.lock();
+                    if(!tileDrawingList.contains(tileLoadQueue.at(i).Pos))
                     {
-                        if(!tileLoadQueue.contains(task))
-                        {
-                            MtileToload.lock();
-                            ++tilesToload;
-                            MtileToload.unlock();
-                            tileLoadQueue.enqueue(task);
+                        tileLoadQueue.removeAt(i);
+                        MtileToload.lock();
+                        --tilesToload;
+                        MtileToload.unlock();
+                    }
+                }
+
+                foreach(Point p,tileDrawingList)
+                {
+                    LoadTask task = LoadTask(p, Zoom(), loadGeneration);
+                    if(!tileLoadQueue.contains(task))
+                    {
+                        MtileToload.lock();
+                        ++tilesToload;
+                        MtileToload.unlock();
+                        tileLoadQueue.enqueue(task);
 #ifdef DEBUG_CORE
-                            qDebug()<<"Core::UpdateBounds new Task"<<task.Pos.ToString();
+                        qDebug()<<"Core::UpdateBounds new Task"<<task.Pos.ToString();
 #endif //DEBUG_CORE
-                            ProcessLoadTaskCallback.start(this);
-                        }
+                        ProcessLoadTaskCallback.start(this);
                     }
-                    MtileLoadQueue.unlock();
                 }
 
+                // Centre of the view first, then outwards
+                qStableSort(tileLoadQueue.begin(), tileLoadQueue.end(), CloserToCentre(centerTileXYLocation));
             }
+            MtileLoadQueue.unlock();
         }
         MtileDrawingList.unlock();
         UpdateGroundResolution();
     }
+    bool Core::IsStale(LoadTask const& task)
+    {
+        MtileLoadQueue.lock();
+        bool stale = (task.Generation != loadGeneration);
+        MtileLoadQueue.unlock();
+        return stale;
+    }
     void Core::FindTilesAround(QList<Point> &list)
     {
         list.clear();;
@@ -233,6 +233,14 @@ namespace internals {
         Rectangle CurrentRegion;
 
         QQueue<LoadTask> tileLoadQueue;
+        /**
+        * @brief Bumped under MtileLoadQueue whenever queued and running loads become
+        *       useless (zoom, reload, cancel), loaders drop tasks of older generations
+        *
+        * @var loadGeneration
+        */
+        int loadGeneration;
+        bool IsStale(LoadTask const& task);
 
         int zoom;
 
@@ -39,17 +39,21 @@ struct LoadTask
   public:
     core::Point Pos;
     int Zoom;
+    // Core's load generation when queued, a zoom or reload makes the task stale
+    int Generation;
 
 
-    LoadTask(Point pos, int zoom)
+    LoadTask(Point pos, int zoom, int generation = 0)
      {
         Pos = pos;
         Zoom = zoom;
+        Generation = generation;
     }
     LoadTask()
     {
         Pos=core::Point(-1,-1);
         Zoom=-1;
+        Generation=0;
     }
     bool HasValue()
     {
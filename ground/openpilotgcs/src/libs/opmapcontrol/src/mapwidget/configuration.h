@@ -138,6 +138,34 @@ public:
     */
     double TileMemoryUsed()const{return core::OPMaps::Instance()->TilesInMemory.MemoryCacheSize();}
 
+    /**
+    * @brief  Returns the bytes of the tiles in the memory cache
+    *
+    * @return
+    */
+    qint64 TileMemoryBytes()const{return core::OPMaps::Instance()->TilesInMemory.MemoryCacheBytes();}
+
+    /**
+    * @brief  Returns the number of tiles in the memory cache
+    *
+    * @return
+    */
+    int TilesInMemory()const{return core::OPMaps::Instance()->TilesInMemory.TilesCount();}
+
+    /**
+    * @brief  Returns how many tile requests the memory cache answered
+    *
+    * @return
+    */
+    quint64 TileMemoryHits()const{return core::OPMaps::Instance()->TilesInMemory.Hits();}
+
+    /**
+    * @brief  Returns how many tile requests missed the memory cache
+    *
+    * @return
+    */
+    quint64 TileMemoryMisses()const{return core::OPMaps::Instance()->TilesInMemory.Misses();}
+
     /**
     * @brief  Sets the size of the memory for tiles
     *
@@ -174,6 +202,37 @@ public:
     */
     void ExportMapDataToDB(QString const& sourceDB, QString const& destDB)const{core::PureImageCache::ExportMapDataToDB(sourceDB,destDB);}
     /**
+    * @brief  Packs the tiles of a DB into a read only archive for offline use
+    *
+    * @param sourceDB the source DB
+    * @param archive the archive file, overwritten
+    * @return
+    */
+    bool ExportMapDataToArchive(QString const& sourceDB, QString const& archive)const{return core::TileArchive::ExportFromDB(sourceDB,archive);}
+    /**
+    * @brief  Packs the tiles of an MBTiles file into a read only archive for offline use
+    *
+    * @param mbtiles the MBTiles file
+    * @param archive the archive file, overwritten
+    * @return
+    */
+    bool ImportMBTilesToArchive(QString const& mbtiles, QString const& archive)const{return core::TileArchive::ImportMBTiles(mbtiles,archive);}
+    /**
+    * @brief  Memory maps an offline tile archive, its tiles are used before the DB and the internet
+    *
+    * @param archive the archive file, an empty string closes the current one
+    * @return false if the archive could not be opened
+    */
+    bool SetTileArchive(QString const& archive)
+    {
+        if(archive.isEmpty())
+        {
+            core::OPMaps::Instance()->Archive.Close();
+            return true;
+        }
+        return core::OPMaps::Instance()->Archive.Open(archive);
+    }
+    /**
     * @brief Returns the location for the SQLite Database used for caching and the geocoding cache files
     *
     * @return
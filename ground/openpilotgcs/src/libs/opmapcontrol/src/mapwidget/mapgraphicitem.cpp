@@ -34,8 +34,10 @@ namespace mapcontrol
     MapGraphicItem::MapGraphicItem(internals::Core *core, Configuration *configuration):core(core),config(configuration),MapRenderTransform(1), maxZoom(17),minZoom(2),zoomReal(0),isSelected(false),rotation(0),zoomDigi(0)
     {
         dragons.load(QString::fromUtf8(":/markers/images/dragons1.jpg"));
+        lastpixmapkey=0;
         showTileGridLines=false;
         isMouseOverMarker=false;
+        decodedTiles.setMaxCost(32*1048576);
         maprect=QRectF(0,0,1022,680);
         core->SetCurrentRegion(internals::Rectangle(0, 0, maprect.width(), maprect.height()));
         core->SetMapType(MapType::GoogleHybrid);
@@ -332,11 +334,29 @@ namespace mapcontrol
             core->MouseWheelZooming = false;
         }
     }
+    QPixmap MapGraphicItem::DecodedTile(internals::Tile *tile,int const& layer,QByteArray const& img)
+    {
+        // The size guards against tiles still holding images of the previous map type
+        QString key=QString("%1/%2/%3/%4/%5/%6").arg(core->GetMapType()).arg(tile->GetZoom()).arg(tile->GetPos().X()).arg(tile->GetPos().Y()).arg(layer).arg(img.size());
+        QPixmap *cached=decodedTiles.object(key);
+        if(cached!=0)
+            return *cached;
+        QPixmap pic=PureImageProxy::FromStream(img);
+        decodedTiles.insert(key,new QPixmap(pic),pic.width()*pic.height()*pic.depth()/8);
+        return pic;
+    }
     void MapGraphicItem::DrawMap2D(QPainter *painter)
     {
-        painter->drawImage(this->boundingRect(),dragons.toImage());
+        painter->drawPixmap(this->boundingRect(),dragons,dragons.rect());
          if(!lastimage.isNull())
-            painter->drawImage(core->GetrenderOffset().X()-lastimagepoint.X(),core->GetrenderOffset().Y()-lastimagepoint.Y(),lastimage);
+         {
+            if(lastpixmapkey!=lastimage.cacheKey())
+            {
+                lastpixmap=QPixmap::fromImage(lastimage);
+                lastpixmapkey=lastimage.cacheKey();
+            }
+            painter->drawPixmap(core->GetrenderOffset().X()-lastimagepoint.X(),core->GetrenderOffset().Y()-lastimagepoint.Y(),lastpixmap);
+         }
 
         for(int i = -core->GetsizeOfMapArea().Width(); i <= core->GetsizeOfMapArea().Width(); i++)
         {
@@ -359,6 +379,7 @@ namespace mapcontrol
                             //lock(t.Overlays)
                             if(t!=0)
                             {
+                                int layer=0;
                                 foreach(QByteArray img,t->Overlays)
                                 {
                                     if(img.count()!=0)
@@ -366,9 +387,10 @@ namespace mapcontrol
                                         if(!found)
                                             found = true;
                                         {
-                                            painter->drawPixmap(core->tileRect.X(),core->tileRect.Y(), core->tileRect.Width(), core->tileRect.Height(),PureImageProxy::FromStream(img));
+                                            painter->drawPixmap(core->tileRect.X(),core->tileRect.Y(), core->tileRect.Width(), core->tileRect.Height(),DecodedTile(t,layer,img));
                                         }
                                     }
+                                    ++layer;
                                 }
                             }
 
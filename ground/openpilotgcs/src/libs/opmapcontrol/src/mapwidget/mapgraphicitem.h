@@ -95,6 +95,11 @@ namespace mapcontrol
 
         QImage lastimage;
         core::Point lastimagepoint;
+        /**
+        * @brief lastimage as a pixmap, converted once instead of on every paint
+        */
+        QPixmap lastpixmap;
+        qint64 lastpixmapkey;
         void paintImage(QPainter* painter);
         void ConstructLastImage(int const& zoomdiff);
         internals::PureProjection* Projection()const{return core->Projection();}
@@ -139,6 +144,15 @@ namespace mapcontrol
         qreal MapRenderTransform;
         void DrawMap2D(QPainter *painter);
         /**
+        * @brief Decoded tile images by map type, zoom, position and layer, so panning
+        *       and repainting do not decode the same PNG/JPEG again. Only used from
+        *       the GUI thread, pixmaps can not live anywhere else.
+        *
+        * @var decodedTiles
+        */
+        QCache<QString,QPixmap> decodedTiles;
+        QPixmap DecodedTile(internals::Tile *tile,int const& layer,QByteArray const& img);
+        /**
         * @brief Maximum possible zoom
         *
         * @var maxZoom
@@ -52,3 +52,11 @@ void MapRipForm::SetNumberOfTiles(const int &total, const int &actual)
 {
     ui->statuslabel->setText(QString("Downloading tile %1 of %2").arg(actual).arg(total));
 }
+void MapRipForm::SetThroughput(const double &tilesPerSecond, const int &etaSeconds)
+{
+    if(etaSeconds<0)
+        ui->ratelabel->setText(QString("%1 tiles/s").arg(tilesPerSecond,0,'f',1));
+    else
+        ui->ratelabel->setText(QString("%1 tiles/s, %2:%3:%4 remaining").arg(tilesPerSecond,0,'f',1)
+                               .arg(etaSeconds/3600).arg(etaSeconds/60%60,2,10,QChar('0')).arg(etaSeconds%60,2,10,QChar('0')));
+}
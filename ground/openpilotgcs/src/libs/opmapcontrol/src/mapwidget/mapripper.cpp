@@ -25,11 +25,20 @@
 * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 */
 #include "mapripper.h"
+#include <QSettings>
+
+// Concurrent tile requests, and the ones queued behind them
+#define MAX_PARALLEL 4
+#define MAX_QUEUED (2*MAX_PARALLEL)
+// Progress is saved every this many tiles
+#define CHECKPOINT_TILES 50
+
 namespace mapcontrol
 {
 
-MapRipper::MapRipper(internals::Core * core, const internals::RectLatLng & rect):sleep(100),cancel(false),progressForm(0),core(core),yesToAll(false)
+MapRipper::MapRipper(internals::Core * core, const internals::RectLatLng & rect):firstPending(0),completed(0),resumed(0),sleep(100),cancel(false),progressForm(0),core(core),yesToAll(false),inFlight(MAX_QUEUED)
     {
+        pool.setMaxThreadCount(MAX_PARALLEL);
         if(!rect.IsEmpty())
         {
             type=core->GetMapType();
@@ -45,6 +54,7 @@ MapRipper::MapRipper(internals::Core * core, const internals::RectLatLng & rect)
             connect(this,SIGNAL(percentageChanged(int)),progressForm,SLOT(SetPercentage(int)));
             connect(this,SIGNAL(numberOfTilesChanged(int,int)),progressForm,SLOT(SetNumberOfTiles(int,int)));
             connect(this,SIGNAL(providerChanged(QString,int)),progressForm,SLOT(SetProvider(QString,int)));
+            connect(this,SIGNAL(throughputChanged(double,int)),progressForm,SLOT(SetThroughput(double,int)));
             connect(this,SIGNAL(finished()),this,SLOT(finish()));
             emit numberOfTilesChanged(0,0);
         }
@@ -104,50 +114,113 @@ void MapRipper::finish()
 
     void MapRipper::run()
     {
-        int countOk = 0;
-        bool goodtile=false;
-        //  Stuff.Shuffle<Point>(ref list);
-        QVector<core::MapType::Types> types = OPMaps::Instance()->GetAllLayersOfType(type);
         int all=points.count();
-        for(int i = 0; i < all; i++)
+        done.fill(false,all);
+        firstPending=LoadCheckpoint();
+        completed=resumed=firstPending;
+        nextRequest.clear();
+        clock.start();
+        emit providerChanged(core::MapType::StrByType(type),zoom);
+        emit numberOfTilesChanged(all,completed);
+        for(int i=firstPending;i<all;i++)
         {
-            emit numberOfTilesChanged(all,i+1);
             if(cancel)
                 break;
+            // Bounded queue, so a cancel does not wait for the whole area
+            inFlight.acquire();
+            pool.start(new RipTask(this,i));
+        }
+        pool.waitForDone();
+        if(!cancel)
+            ClearCheckpoint();
+    }
 
-            core::Point p = points[i];
+    void MapRipper::RipTile(int index)
+    {
+        QVector<core::MapType::Types> types = OPMaps::Instance()->GetAllLayersOfType(type);
+        core::Point p = points[index];
+        foreach(core::MapType::Types layer,types)
+        {
+            while(!cancel)
             {
-                //qDebug()<<"offline fetching:"<<p.ToString();
-                foreach(core::MapType::Types type,types)
-                {
-                    emit providerChanged(core::MapType::StrByType(type),zoom);
-                    QByteArray img = OPMaps::Instance()->GetImageFrom(type, p, zoom);
-                    if(img.length()!=0)
-                    {
-                        goodtile=true;
-                        img=NULL;
-                    }
-                    else
-                        goodtile=false;
-                }
-                if(goodtile)
-                {
-                    countOk++;
-                }
-                else
-                {
-                    i--;
-                    QThread::msleep(1000);
-                    continue;
-                }
+                // Already cached tiles cost no request
+                if(!Cache::Instance()->ImageCache.GetImageFromCache(layer,p,zoom).isEmpty())
+                    break;
+                WaitForProvider(layer);
+                if(!OPMaps::Instance()->GetImageFrom(layer,p,zoom).isEmpty())
+                    break;
+                QThread::msleep(1000);
             }
-            emit percentageChanged((int) ((i+1)*100/all));//, i+1);
-            // worker.ReportProgress((int) ((i+1)*100/all), i+1);
+        }
 
-            QThread::msleep(sleep);
+        QMutexLocker locker(&mutex);
+        if(!cancel)
+        {
+            done.setBit(index);
+            ++completed;
+            int previous=firstPending;
+            while(firstPending<done.size()&&done.testBit(firstPending))
+                ++firstPending;
+            if(firstPending/CHECKPOINT_TILES!=previous/CHECKPOINT_TILES)
+                SaveCheckpoint(firstPending);
+            int all=points.count();
+            double rate=(completed-resumed)*1000.0/qMax(1,clock.elapsed());
+            emit numberOfTilesChanged(all,completed);
+            emit percentageChanged((int)(completed*100/all));
+            emit throughputChanged(rate,rate>0?(int)((all-completed)/rate):-1);
+        }
+        inFlight.release();
+    }
+
+    void MapRipper::WaitForProvider(const core::MapType::Types &type)
+    {
+        // Requests to one provider are spaced by "sleep" ms, however many run in parallel
+        forever
+        {
+            mutex.lock();
+            int now=clock.elapsed();
+            int wait=nextRequest.value(type,0)-now;
+            if(wait<=0)
+            {
+                nextRequest.insert(type,now+sleep);
+                mutex.unlock();
+                return;
+            }
+            mutex.unlock();
+            QThread::msleep(wait);
         }
     }
 
+    QString MapRipper::CheckpointFile()
+    {
+        return Cache::Instance()->CacheLocation()+"mapripper.ini";
+    }
+
+    int MapRipper::LoadCheckpoint()
+    {
+        QSettings settings(CheckpointFile(),QSettings::IniFormat);
+        if(settings.value("type").toInt()!=(int)type||settings.value("zoom").toInt()!=zoom||
+           settings.value("count").toInt()!=points.count()||settings.value("area").toString()!=area.ToString())
+            return 0;
+        return qBound(0,settings.value("next").toInt(),points.count());
+    }
+
+    void MapRipper::SaveCheckpoint(int next)
+    {
+        QSettings settings(CheckpointFile(),QSettings::IniFormat);
+        settings.setValue("type",(int)type);
+        settings.setValue("zoom",zoom);
+        settings.setValue("count",points.count());
+        settings.setValue("area",area.ToString());
+        settings.setValue("next",next);
+    }
+
+    void MapRipper::ClearCheckpoint()
+    {
+        QSettings settings(CheckpointFile(),QSettings::IniFormat);
+        settings.clear();
+    }
+
     void MapRipper::stopFetching()
     {
         QMutexLocker locker(&mutex);
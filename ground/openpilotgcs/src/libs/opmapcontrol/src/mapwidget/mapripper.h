@@ -32,6 +32,11 @@
 #include "mapripform.h"
 #include <QObject>
 #include <QMessageBox>
+#include <QRunnable>
+#include <QBitArray>
+#include <QTime>
+#include <QThreadPool>
+#include <QSemaphore>
 namespace mapcontrol
 {
     class MapRipper:public QThread
@@ -41,7 +46,33 @@ namespace mapcontrol
         MapRipper(internals::Core *,internals::RectLatLng const&);
         void run();
     private:
+        /**
+        * @brief Fetches one tile of the area on the ripper's pool
+        */
+        class RipTask:public QRunnable
+        {
+        public:
+            RipTask(MapRipper * ripper,int index):ripper(ripper),index(index){}
+            void run(){ripper->RipTile(index);}
+        private:
+            MapRipper * ripper;
+            int index;
+        };
+        void RipTile(int index);
+        void WaitForProvider(core::MapType::Types const& type);
+        int LoadCheckpoint();
+        void SaveCheckpoint(int next);
+        void ClearCheckpoint();
+        QString CheckpointFile();
         QList<core::Point> points;
+        QBitArray done;
+        int firstPending;
+        int completed;
+        int resumed;
+        QTime clock;
+        QHash<int,int> nextRequest;
+        QThreadPool pool;
+        QSemaphore inFlight;
         int zoom;
         core::MapType::Types type;
         int sleep;
@@ -57,6 +88,7 @@ namespace mapcontrol
         void percentageChanged(int const& perc);
         void numberOfTilesChanged(int const& total,int const& actual);
         void providerChanged(QString const& prov,int const& zoom);
+        void throughputChanged(double const& tilesPerSecond,int const& etaSeconds);
 
 
     public slots:
@@ -14,7 +14,9 @@ SOURCES += mapgraphicitem.cpp \
     homeitem.cpp \
     mapripform.cpp \
     mapripper.cpp \
+    tileprefetcher.cpp \
     traillineitem.cpp \
+    trailpathitem.cpp \
     waypointline.cpp \
     waypointcircle.cpp
 
@@ -41,7 +43,9 @@ HEADERS += mapgraphicitem.h \
     homeitem.h \
     mapripform.h \
     mapripper.h \
+    tileprefetcher.h \
     traillineitem.h \
+    trailpathitem.h \
     waypointline.h \
     waypointcircle.h
 QT += opengl
@@ -39,6 +39,7 @@ namespace mapcontrol
         setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
         core=new internals::Core;
         map=new MapGraphicItem(core,config);
+        prefetcher=new TilePrefetcher(core);
         mscene.addItem(map);
         this->setScene(&mscene);
         Home=new HomeItem(map,this);
@@ -55,6 +56,7 @@ namespace mapcontrol
         connect(map->core,SIGNAL(OnTileLoadComplete()),this,SIGNAL(OnTileLoadComplete()));
         connect(map->core,SIGNAL(OnTileLoadStart()),this,SIGNAL(OnTileLoadStart()));
         connect(map->core,SIGNAL(OnTilesStillToLoad(int)),this,SIGNAL(OnTilesStillToLoad(int)));
+        connect(map->core,SIGNAL(OnTilesStillToLoad(int)),prefetcher,SLOT(SetInteractiveTiles(int)));
         connect(map,SIGNAL(wpdoubleclicked(WayPointItem*)),this,SIGNAL(OnWayPointDoubleClicked(WayPointItem*)));
         connect(&mscene,SIGNAL(selectionChanged()),this,SLOT(OnSelectionChanged()));
         SetShowDiagnostics(showDiag);
@@ -186,6 +188,7 @@ namespace mapcontrol
     }
     OPMapWidget::~OPMapWidget()
     {
+        delete prefetcher;
         if(UAV)
             delete UAV;
         if(Home)
@@ -211,9 +214,22 @@ namespace mapcontrol
     {
         useOpenGL=value;
         if (useOpenGL)
-            setViewport(new QGLWidget(QGLFormat(QGL::SampleBuffers)));
+        {
+            QGLFormat format(QGL::SampleBuffers|QGL::DoubleBuffer);
+            format.setSwapInterval(1);
+            setViewport(new QGLWidget(format));
+            // A GL frame is redrawn whole anyway, tracking dirty regions only costs time
+            setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+            // Tiles are drawn straight from the decoded pixmaps, which the GL engine keeps
+            // as textures; an item cache would add a raster pass on every pan
+            map->setCacheMode(QGraphicsItem::NoCache);
+        }
         else
-            setupViewport(new QWidget());
+        {
+            setViewport(new QWidget());
+            setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+            map->setCacheMode(QGraphicsItem::ItemCoordinateCache);
+        }
         update();
     }
     internals::PointLatLng OPMapWidget::currentMousePosition()
@@ -447,6 +463,17 @@ namespace mapcontrol
         }
         return list;
     }
+    QHash<int,WayPointItem*> OPMapWidget::WPAll()
+    {
+        QHash<int,WayPointItem*> all;
+        foreach(QGraphicsItem* i,map->childItems())
+        {
+            WayPointItem* w=qgraphicsitem_cast<WayPointItem*>(i);
+            if(w)
+                all.insert(w->Number(),w);
+        }
+        return all;
+    }
     void OPMapWidget::WPRenumber(WayPointItem *item, const int &newnumber)
     {
         item->SetNumber(newnumber);
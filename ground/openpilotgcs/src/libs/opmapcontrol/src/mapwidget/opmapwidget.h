@@ -34,6 +34,7 @@
 #include "../core/diagnostics.h"
 #include "configuration.h"
 #include <QObject>
+#include <QHash>
 #include <QtOpenGL/QGLWidget>
 #include "waypointitem.h"
 #include "QtSvg/QGraphicsSvgItem"
@@ -41,6 +42,7 @@
 #include "gpsitem.h"
 #include "homeitem.h"
 #include "mapripper.h"
+#include "tileprefetcher.h"
 #include "waypointline.h"
 #include "waypointcircle.h"
 #include "waypointitem.h"
@@ -342,6 +344,13 @@ namespace mapcontrol
         * @return @return QList<WayPointItem *>
         */
         QList<WayPointItem*> WPSelected();
+        /**
+        * @brief Returns all WayPoints indexed by their number, one pass over the
+        *       scene instead of a WPFind per number
+        *
+        * @return QHash<int, WayPointItem *>
+        */
+        QHash<int,WayPointItem*> WPAll();
 
         /**
         * @brief Renumbers the WayPoint and all others as needed
@@ -375,6 +384,13 @@ namespace mapcontrol
         void WPDelete(int number);
         WayPointItem *WPFind(int number);
         void setSelectedWP(QList<WayPointItem *> list);
+        /**
+        * @brief Sets the planned path whose tiles are fetched in the background
+        *
+        * @param route waypoint coordinates in flight order
+        */
+        void SetPrefetchRoute(QList<internals::PointLatLng> const& route){prefetcher->SetRoute(route);}
+        TilePrefetcher* Prefetcher(){return prefetcher;}
       private:
         internals::Core *core;
         MapGraphicItem *map;
@@ -393,6 +409,7 @@ namespace mapcontrol
         QGraphicsTextItem * diagGraphItem;
         bool showDiag;
         qreal overlayOpacity;
+        TilePrefetcher * prefetcher;
     private slots:
         void diagRefresh();
         //   WayPointItem* item;//apagar
@@ -0,0 +1,190 @@
+/**
+******************************************************************************
+*
+* @file       tileprefetcher.cpp
+* @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+* @brief      Background fetching of the tiles ahead of the UAV and along the mission
+* @see        The GNU Public License (GPL) Version 3
+* @defgroup   OPMapWidget
+* @{
+*
+*****************************************************************************/
+/*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+* or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#include "tileprefetcher.h"
+#include <math.h>
+
+// Seconds of flight ahead of the UAV that are prefetched
+#define LOOKAHEAD_S 120
+// Below this speed only the tiles around the UAV are prefetched
+#define MIN_SPEED_MPS 1.0
+// Pause between two fetches and while the map is loading tiles itself
+#define FETCH_INTERVAL_MS 50
+#define IDLE_POLL_MS 200
+// Bound on the remembered tiles, the caches answer repeated requests anyway
+#define MAX_FETCHED 8192
+
+namespace mapcontrol
+{
+    TilePrefetcher::TilePrefetcher(internals::Core * core):core(core),vNorth(0),vEast(0),dirty(false),stop(false),interactiveTiles(0)
+    {
+        start(QThread::LowestPriority);
+    }
+    TilePrefetcher::~TilePrefetcher()
+    {
+        mutex.lock();
+        stop=true;
+        wake.wakeAll();
+        mutex.unlock();
+        wait();
+    }
+    void TilePrefetcher::SetTrack(const internals::PointLatLng &position, const double &vNorth, const double &vEast)
+    {
+        QMutexLocker locker(&mutex);
+        this->position=position;
+        this->vNorth=vNorth;
+        this->vEast=vEast;
+        dirty=true;
+        wake.wakeAll();
+    }
+    void TilePrefetcher::SetRoute(const QList<internals::PointLatLng> &route)
+    {
+        QMutexLocker locker(&mutex);
+        this->route=route;
+        dirty=true;
+        wake.wakeAll();
+    }
+    void TilePrefetcher::SetInteractiveTiles(int number)
+    {
+        QMutexLocker locker(&mutex);
+        interactiveTiles=number;
+    }
+    bool TilePrefetcher::Interrupted()
+    {
+        QMutexLocker locker(&mutex);
+        return stop||dirty;
+    }
+    QList<core::Point> TilePrefetcher::TilesAlong(const QList<internals::PointLatLng> &path, const int &zoom)
+    {
+        QList<core::Point> tiles;
+        internals::PureProjection * projection=core->Projection();
+        core::Size min=projection->GetTileMatrixMinXY(zoom);
+        core::Size max=projection->GetTileMatrixMaxXY(zoom);
+        int step=qMax(1,projection->TileSize().Width()/2);
+        for(int i=0;i<path.count();++i)
+        {
+            core::Point from=projection->FromLatLngToPixel(path[i],zoom);
+            core::Point to=(i+1<path.count())?projection->FromLatLngToPixel(path[i+1],zoom):from;
+            int dx=to.X()-from.X();
+            int dy=to.Y()-from.Y();
+            int steps=qMax(1,(int)(sqrt((double)dx*dx+(double)dy*dy)/step));
+            for(int s=0;s<=steps;++s)
+            {
+                core::Point tile=projection->FromPixelToTileXY(core::Point(from.X()+dx*s/steps,from.Y()+dy*s/steps));
+                // The tile on the path and its neighbours, to cover the view around it
+                for(int x=tile.X()-1;x<=tile.X()+1;++x)
+                {
+                    for(int y=tile.Y()-1;y<=tile.Y()+1;++y)
+                    {
+                        if(x<min.Width()||x>max.Width()||y<min.Height()||y>max.Height())
+                            continue;
+                        core::Point p(x,y);
+                        if(!tiles.contains(p))
+                            tiles.append(p);
+                    }
+                }
+            }
+        }
+        return tiles;
+    }
+    void TilePrefetcher::run()
+    {
+        forever
+        {
+            QList<internals::PointLatLng> track;
+            QList<internals::PointLatLng> legs;
+            mutex.lock();
+            while(!dirty&&!stop)
+                wake.wait(&mutex);
+            if(stop)
+            {
+                mutex.unlock();
+                return;
+            }
+            dirty=false;
+            if(!position.IsEmpty())
+            {
+                track.append(position);
+                double speed=sqrt(vNorth*vNorth+vEast*vEast);
+                if(speed>MIN_SPEED_MPS)
+                {
+                    const double earthRadius=6378137.0;
+                    double lat=position.Lat()+vNorth*LOOKAHEAD_S/earthRadius*180.0/M_PI;
+                    double lng=position.Lng()+vEast*LOOKAHEAD_S/(earthRadius*cos(position.Lat()*M_PI/180.0))*180.0/M_PI;
+                    track.append(internals::PointLatLng(lat,lng));
+                }
+            }
+            legs=route;
+            mutex.unlock();
+
+            int zoom=core->Zoom();
+            QVector<core::MapType::Types> layers=OPMaps::Instance()->GetAllLayersOfType(core->GetMapType());
+            QList<int> zooms;
+            zooms<<zoom;
+            if(zoom<core->MaxZoom())
+                zooms<<zoom+1;
+            if(zoom>0)
+                zooms<<zoom-1;
+            if(fetched.count()>MAX_FETCHED)
+                fetched.clear();
+            bool interrupted=false;
+            foreach(int z,zooms)
+            {
+                QList<core::Point> tiles=TilesAlong(track,z)+TilesAlong(legs,z);
+                foreach(core::Point p,tiles)
+                {
+                    // Never compete with the tiles the map is waiting for
+                    forever
+                    {
+                        mutex.lock();
+                        bool busy=interactiveTiles>0&&!stop;
+                        mutex.unlock();
+                        if(!busy)
+                            break;
+                        QThread::msleep(IDLE_POLL_MS);
+                    }
+                    // New track or route, start over from the UAV
+                    if(Interrupted())
+                    {
+                        interrupted=true;
+                        break;
+                    }
+                    foreach(core::MapType::Types type,layers)
+                    {
+                        QString key=QString("%1/%2/%3/%4").arg((int)type).arg(z).arg(p.X()).arg(p.Y());
+                        if(fetched.contains(key))
+                            continue;
+                        if(!OPMaps::Instance()->GetImageFrom(type,p,z).isEmpty())
+                            fetched.insert(key);
+                        QThread::msleep(FETCH_INTERVAL_MS);
+                    }
+                }
+                if(interrupted)
+                    break;
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/**
+******************************************************************************
+*
+* @file       tileprefetcher.h
+* @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+* @brief      Background fetching of the tiles ahead of the UAV and along the mission
+* @see        The GNU Public License (GPL) Version 3
+* @defgroup   OPMapWidget
+* @{
+*
+*****************************************************************************/
+/*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+* or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef TILEPREFETCHER_H
+#define TILEPREFETCHER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QSet>
+#include "../internals/core.h"
+
+namespace mapcontrol
+{
+    /**
+    * @brief Fetches tiles into the cache before the map needs them, so the map keeps
+    *       up with the UAV where the link to the tile server is poor.
+    *       Tiles ahead of the UAV go first, then the tiles along the mission, for the
+    *       current zoom and the levels next to it. Runs at the lowest priority and
+    *       pauses while the map itself is loading tiles.
+    *
+    * @class TilePrefetcher tileprefetcher.h "mapwidget/tileprefetcher.h"
+    */
+    class TilePrefetcher:public QThread
+    {
+        Q_OBJECT
+    public:
+        TilePrefetcher(internals::Core * core);
+        ~TilePrefetcher();
+        /**
+        * @brief Sets the UAV position and velocity, the track ahead is prefetched
+        *
+        * @param position UAV position
+        * @param vNorth north velocity in m/s
+        * @param vEast east velocity in m/s
+        */
+        void SetTrack(internals::PointLatLng const& position,double const& vNorth,double const& vEast);
+        /**
+        * @brief Sets the planned path, the legs between its points are prefetched
+        *
+        * @param route waypoint coordinates in flight order
+        */
+        void SetRoute(QList<internals::PointLatLng> const& route);
+        void run();
+    private:
+        QList<core::Point> TilesAlong(QList<internals::PointLatLng> const& path,int const& zoom);
+        bool Interrupted();
+        internals::Core * core;
+        QMutex mutex;
+        QWaitCondition wake;
+        internals::PointLatLng position;
+        double vNorth;
+        double vEast;
+        QList<internals::PointLatLng> route;
+        bool dirty;
+        bool stop;
+        int interactiveTiles;
+        QSet<QString> fetched;
+    public slots:
+        /**
+        * @brief Number of tiles the map is still loading, prefetching waits for zero
+        */
+        void SetInteractiveTiles(int number);
+    };
+}
+#endif // TILEPREFETCHER_H
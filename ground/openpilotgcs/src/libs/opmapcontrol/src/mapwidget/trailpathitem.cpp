@@ -0,0 +1,235 @@
+/**
+******************************************************************************
+*
+* @file       trailpathitem.cpp
+* @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+* @brief      A graphicsItem representing a whole UAV or GPS trail
+* @see        The GNU Public License (GPL) Version 3
+* @defgroup   OPMapWidget
+* @{
+*
+*****************************************************************************/
+/*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+* or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#include "trailpathitem.h"
+#include <QStyleOptionGraphicsItem>
+#include <QStack>
+#include <QPair>
+#include <math.h>
+
+// Points closer than this to the simplified line are not drawn
+#define TOLERANCE_PX 1.0
+// Points added since the last simplification before simplifying again
+#define RESIMPLIFY_POINTS 500
+#define DEFAULT_MAX_POINTS 20000
+#define DOT_RADIUS 2
+
+namespace mapcontrol
+{
+    TrailPathItem::TrailPathItem(MapGraphicItem *map):QGraphicsItem(map),m_map(map),builtZoom(-1),showdots(true),showline(true),
+        maxpoints(DEFAULT_MAX_POINTS),appended(0)
+    {
+        setFlag(QGraphicsItem::ItemUsesExtendedStyleOption,true);
+        connect(map,SIGNAL(childRefreshPosition()),this,SLOT(RefreshPos()));
+    }
+
+    void TrailPathItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+    {
+        Q_UNUSED(widget);
+
+        if(showline)
+        {
+            QPen pen(Qt::red);
+            pen.setWidth(1);
+            painter->setPen(pen);
+            painter->setBrush(Qt::NoBrush);
+            painter->drawPath(path);
+        }
+        if(showdots)
+        {
+            QRectF exposed=option->exposedRect.adjusted(-DOT_RADIUS,-DOT_RADIUS,DOT_RADIUS,DOT_RADIUS);
+            painter->setPen(QPen());
+            painter->setBrush(Qt::green);
+            foreach(QPointF const& v,vertices)
+            {
+                if(exposed.contains(v))
+                    painter->drawEllipse(v,DOT_RADIUS,DOT_RADIUS);
+            }
+        }
+    }
+    QRectF TrailPathItem::boundingRect()const
+    {
+        return bounds;
+    }
+    int TrailPathItem::type()const
+    {
+        return Type;
+    }
+
+    void TrailPathItem::AddPoint(const internals::PointLatLng &coord)
+    {
+        points.append(coord);
+        if(points.count()>maxpoints)
+        {
+            // Drop a block at a time so the rebuild is not paid on every point
+            points.remove(0,qMin(points.count(),qMax(1,maxpoints/10)));
+            Rebuild();
+            return;
+        }
+        if(builtZoom!=m_map->ZoomTotal()||++appended>RESIMPLIFY_POINTS)
+        {
+            Rebuild();
+            return;
+        }
+        core::Point local=m_map->FromLatLngToLocal(coord);
+        QPointF v=QPointF(local.X(),local.Y())-pos();
+        prepareGeometryChange();
+        if(vertices.isEmpty())
+        {
+            anchor=coord;
+            anchorLocal=v;
+            path.moveTo(v);
+            bounds=QRectF(v,v);
+        }
+        else
+            path.lineTo(v);
+        vertices.append(v);
+        bounds|=QRectF(v.x()-DOT_RADIUS-1,v.y()-DOT_RADIUS-1,2*DOT_RADIUS+2,2*DOT_RADIUS+2);
+    }
+    qint64 TrailPathItem::MemoryBytes()const
+    {
+        return points.capacity()*sizeof(internals::PointLatLng)+vertices.capacity()*sizeof(QPointF)
+                +path.elementCount()*sizeof(QPainterPath::Element);
+    }
+    void TrailPathItem::Clear()
+    {
+        points.clear();
+        Rebuild();
+    }
+    void TrailPathItem::SetShowDots(const bool &value)
+    {
+        showdots=value;
+        setVisible(showdots||showline);
+        update();
+    }
+    void TrailPathItem::SetShowLine(const bool &value)
+    {
+        showline=value;
+        setVisible(showdots||showline);
+        update();
+    }
+    void TrailPathItem::SetMaxPoints(const int &value)
+    {
+        maxpoints=qMax(2,value);
+        if(points.count()>maxpoints)
+        {
+            points.remove(0,points.count()-maxpoints);
+            Rebuild();
+        }
+    }
+
+    void TrailPathItem::RefreshPos()
+    {
+        if(builtZoom!=m_map->ZoomTotal())
+        {
+            Rebuild();
+            return;
+        }
+        if(vertices.isEmpty())
+            return;
+        // Within one zoom a pan only translates the trail
+        core::Point local=m_map->FromLatLngToLocal(anchor);
+        setPos(QPointF(local.X(),local.Y())-anchorLocal);
+    }
+
+    void TrailPathItem::Rebuild()
+    {
+        prepareGeometryChange();
+        builtZoom=m_map->ZoomTotal();
+        appended=0;
+        setPos(0,0);
+        QVector<QPointF> local;
+        local.reserve(points.count());
+        foreach(internals::PointLatLng const& p,points)
+        {
+            core::Point l=m_map->FromLatLngToLocal(p);
+            local.append(QPointF(l.X(),l.Y()));
+        }
+        Simplify(local,vertices);
+        path=QPainterPath();
+        bounds=QRectF();
+        if(!vertices.isEmpty())
+        {
+            anchor=points.first();
+            anchorLocal=local.first();
+            path.moveTo(vertices.first());
+            for(int i=1;i<vertices.count();++i)
+                path.lineTo(vertices[i]);
+            bounds=path.boundingRect().adjusted(-DOT_RADIUS-1,-DOT_RADIUS-1,DOT_RADIUS+1,DOT_RADIUS+1);
+        }
+        update();
+    }
+
+    void TrailPathItem::Simplify(const QVector<QPointF> &in, QVector<QPointF> &out)
+    {
+        out.clear();
+        if(in.count()<3)
+        {
+            out=in;
+            return;
+        }
+        QVector<bool> keep(in.count(),false);
+        keep[0]=keep[in.count()-1]=true;
+        QStack<QPair<int,int> > spans;
+        spans.push(qMakePair(0,in.count()-1));
+        while(!spans.isEmpty())
+        {
+            QPair<int,int> span=spans.pop();
+            QPointF a=in[span.first];
+            QPointF b=in[span.second];
+            double dx=b.x()-a.x();
+            double dy=b.y()-a.y();
+            double length=sqrt(dx*dx+dy*dy);
+            double worst=0;
+            int index=-1;
+            for(int i=span.first+1;i<span.second;++i)
+            {
+                QPointF p=in[i];
+                double d;
+                if(length>0)
+                    d=qAbs(dy*(p.x()-a.x())-dx*(p.y()-a.y()))/length;
+                else
+                    d=sqrt((p.x()-a.x())*(p.x()-a.x())+(p.y()-a.y())*(p.y()-a.y()));
+                if(d>worst)
+                {
+                    worst=d;
+                    index=i;
+                }
+            }
+            if(index>=0&&worst>TOLERANCE_PX)
+            {
+                keep[index]=true;
+                spans.push(qMakePair(span.first,index));
+                spans.push(qMakePair(index,span.second));
+            }
+        }
+        for(int i=0;i<in.count();++i)
+        {
+            if(keep[i])
+                out.append(in[i]);
+        }
+    }
+}
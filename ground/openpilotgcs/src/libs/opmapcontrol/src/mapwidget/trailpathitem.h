@@ -0,0 +1,97 @@
+/**
+******************************************************************************
+*
+* @file       trailpathitem.h
+* @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+* @brief      A graphicsItem representing a whole UAV or GPS trail
+* @see        The GNU Public License (GPL) Version 3
+* @defgroup   OPMapWidget
+* @{
+*
+*****************************************************************************/
+/*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+* or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef TRAILPATHITEM_H
+#define TRAILPATHITEM_H
+
+#include <QGraphicsItem>
+#include <QPainter>
+#include <QVector>
+#include "../internals/pointlatlng.h"
+#include <QObject>
+#include "mapgraphicitem.h"
+
+namespace mapcontrol
+{
+    /**
+    * @brief The trail as one item over a buffer of coordinates, instead of an item
+    *       per trail point. The drawn polyline is simplified (Douglas-Peucker) for
+    *       the zoom it is shown at and only rebuilt when the zoom changes, a pan
+    *       just moves the item. The oldest points are dropped past MaxPoints().
+    *
+    * @class TrailPathItem trailpathitem.h "mapwidget/trailpathitem.h"
+    */
+    class TrailPathItem:public QObject,public QGraphicsItem
+    {
+        Q_OBJECT
+        Q_INTERFACES(QGraphicsItem)
+    public:
+                enum { Type = UserType + 10 };
+        TrailPathItem(MapGraphicItem * map);
+        void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+                    QWidget *widget);
+        QRectF boundingRect() const;
+        int type() const;
+        /**
+        * @brief Appends a point to the trail
+        */
+        void AddPoint(internals::PointLatLng const& coord);
+        void Clear();
+        /**
+        * @brief Shows the dots at the trail points and the line between them
+        */
+        void SetShowDots(bool const& value);
+        void SetShowLine(bool const& value);
+        /**
+        * @brief Sets the number of trail points kept, older ones are dropped
+        */
+        void SetMaxPoints(int const& value);
+        int MaxPoints()const{return maxpoints;}
+        int PointsCount()const{return points.size();}
+        /**
+        * @brief Bytes held by the trail points and the path drawn from them
+        */
+        qint64 MemoryBytes()const;
+    private:
+        void Rebuild();
+        void Simplify(QVector<QPointF> const& in, QVector<QPointF> &out);
+        MapGraphicItem * m_map;
+        QVector<internals::PointLatLng> points;
+        QVector<QPointF> vertices;
+        QPainterPath path;
+        QRectF bounds;
+        internals::PointLatLng anchor;
+        QPointF anchorLocal;
+        double builtZoom;
+        bool showdots;
+        bool showline;
+        int maxpoints;
+        int appended;
+    public slots:
+        void RefreshPos();
+    };
+}
+#endif // TRAILPATHITEM_H
@@ -38,8 +38,7 @@
 #include "uavtrailtype.h"
 #include <QtSvg/QSvgRenderer>
 #include "opmapwidget.h"
-#include "trailitem.h"
-#include "traillineitem.h"
+#include "trailpathitem.h"
 namespace mapcontrol
 {
     class WayPointItem;
@@ -162,6 +161,23 @@ namespace mapcontrol
         */
         int TrailDistance()const{return traildistance;}
         /**
+        * @brief Sets the number of trail points kept, the oldest ones are dropped first
+        *
+        * @param value maximum number of trail points
+        */
+        void SetTrailMaxPoints(int const& value){trail->SetMaxPoints(value);}
+        /**
+        * @brief Returns the number of trail points kept
+        *
+        * @return int
+        */
+        int TrailMaxPoints()const{return trail->MaxPoints();}
+        /**
+        * @brief Returns the number of trail points and the bytes they take
+        */
+        int TrailPoints()const{return trail->PointsCount();}
+        qint64 TrailMemoryBytes()const{return trail->MemoryBytes();}
+        /**
         * @brief Returns true if UAV trail is shown
         *
         * @return bool
@@ -243,9 +259,7 @@ namespace mapcontrol
         double ringTime;
         QPixmap pic;
         core::Point localposition;
-        QGraphicsItemGroup* trail;
-        QGraphicsItemGroup * trailLine;
-        internals::PointLatLng lasttrailline;
+        TrailPathItem* trail;
         QTime timer;
         bool showtrail;
         bool showtrailline;
@@ -24,7 +24,9 @@
 
 #include "cachedsvgitem.h"
 #include <QGLContext>
+#include <QPainter>
 #include <QDebug>
+#include <qmath.h>
 
 #ifndef GL_CLAMP_TO_EDGE
 #define GL_CLAMP_TO_EDGE 0x812F
@@ -34,7 +36,8 @@ CachedSvgItem::CachedSvgItem(QGraphicsItem * parent) :
     QGraphicsSvgItem(parent),
     m_context(0),
     m_texture(0),
-    m_scale(1.0)
+    m_scale(1.0),
+    m_pixmapScale(0.0)
 {
     setCacheMode(NoCache);
 }
@@ -43,7 +46,8 @@ CachedSvgItem::CachedSvgItem(const QString & fileName, QGraphicsItem * parent):
     QGraphicsSvgItem(fileName, parent),
     m_context(0),
     m_texture(0),
-    m_scale(1.0)
+    m_scale(1.0),
+    m_pixmapScale(0.0)
 {
     setCacheMode(NoCache);
 }
@@ -59,17 +63,32 @@ CachedSvgItem::~CachedSvgItem()
 void CachedSvgItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
 
+    QRectF br = boundingRect();
+    QTransform transform = painter->worldTransform();
+    qreal sceneScale = transform.map(QLineF(0,0,1,0)).length();
+
     if (painter->paintEngine()->type() != QPaintEngine::OpenGL &&
             painter->paintEngine()->type() != QPaintEngine::OpenGL2) {
-        //Fallback to direct painting
-        QGraphicsSvgItem::paint(painter, option, widget);
+        //Rasterize once per scale, moving the item only blits the pixmap
+        if (m_pixmap.isNull() || !qFuzzyCompare(sceneScale, m_pixmapScale) || m_pixmapElementId != elementId()) {
+            m_pixmapScale = sceneScale;
+            m_pixmapElementId = elementId();
+            m_pixmap = QPixmap(qMax(1, qCeil(br.width()*m_pixmapScale)), qMax(1, qCeil(br.height()*m_pixmapScale)));
+            m_pixmap.fill(Qt::transparent);
+            QPainter p(&m_pixmap);
+            p.setRenderHints(painter->renderHints());
+            p.scale(m_pixmapScale, m_pixmapScale);
+            p.translate(-br.topLeft());
+            QGraphicsSvgItem::paint(&p, option, 0);
+        }
+        //Filtered so the edges stay clean when the item is rotated
+        bool smooth = painter->testRenderHint(QPainter::SmoothPixmapTransform);
+        painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+        painter->drawPixmap(br, m_pixmap, QRectF(m_pixmap.rect()));
+        painter->setRenderHint(QPainter::SmoothPixmapTransform, smooth);
         return;
     }
 
-    QRectF br = boundingRect();
-    QTransform transform = painter->worldTransform();
-    qreal sceneScale = transform.map(QLineF(0,0,1,0)).length();
-
     bool stencilTestEnabled = glIsEnabled(GL_STENCIL_TEST);
     bool scissorTestEnabled = glIsEnabled(GL_SCISSOR_TEST);
 
@@ -93,6 +112,11 @@ void CachedSvgItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *opt
         dirty = true;
     }
 
+    if (m_textureElementId != elementId()) {
+        m_textureElementId = elementId();
+        dirty = true;
+    }
+
     int textureWidth = (int(br.width()*m_scale) + 3) & ~3;
     int textureHeight = (int(br.height()*m_scale) + 3) & ~3;
 
@@ -27,14 +27,15 @@
 
 #include <QGraphicsSvgItem>
 #include <QGLContext>
+#include <QPixmap>
 
 #include "utils_global.h"
 
 class QGLContext;
 
-//Cache Svg item as GL Texture.
-//Texture is regenerated each time item is scaled
-//but it's reused during rotation, unlike DeviceCoordinateCache mode
+//Cache Svg item as GL Texture, or as a pixmap with other paint engines.
+//The cache is regenerated each time item is scaled or its element changes
+//but it's reused during rotation and translation, unlike DeviceCoordinateCache mode
 class QTCREATOR_UTILS_EXPORT CachedSvgItem: public QGraphicsSvgItem
 {
     Q_OBJECT
@@ -49,6 +50,10 @@ private:
     QGLContext *m_context;
     GLuint m_texture;
     qreal m_scale;
+    QString m_textureElementId;
+    QPixmap m_pixmap;
+    qreal m_pixmapScale;
+    QString m_pixmapElementId;
 };
 
 #endif
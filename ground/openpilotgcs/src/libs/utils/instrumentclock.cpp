@@ -0,0 +1,112 @@
+/**
+ ******************************************************************************
+ *
+ * @file       instrumentclock.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Frame clock shared by the animated instruments
+ * @see        The GNU Public License (GPL) Version 3
+ * @defgroup
+ * @{
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "instrumentclock.h"
+#include <QTimer>
+#include <QList>
+
+// About 30 frames per second, the rate the instruments used to animate at
+#define FRAME_PERIOD_MS 30
+
+namespace Utils {
+
+class InstrumentClock : public QObject
+{
+    Q_OBJECT
+public:
+    static InstrumentClock *instance()
+    {
+        static InstrumentClock clock;
+        return &clock;
+    }
+
+    void add(InstrumentTimer *timer)
+    {
+        if (!timers.contains(timer))
+            timers.append(timer);
+        if (!clock.isActive())
+            clock.start();
+    }
+    void remove(InstrumentTimer *timer)
+    {
+        timers.removeAll(timer);
+        if (timers.isEmpty())
+            clock.stop();
+    }
+
+private slots:
+    void tick()
+    {
+        // Instruments stop (or start others) from their slots
+        QList<InstrumentTimer *> frame = timers;
+        foreach(InstrumentTimer *timer, frame) {
+            if (timer->active && timers.contains(timer))
+                emit timer->timeout();
+        }
+    }
+
+private:
+    InstrumentClock()
+    {
+        clock.setInterval(FRAME_PERIOD_MS);
+        connect(&clock, SIGNAL(timeout()), this, SLOT(tick()));
+    }
+    QTimer clock;
+    QList<InstrumentTimer *> timers;
+};
+
+InstrumentTimer::InstrumentTimer(QObject *parent) : QObject(parent), active(false)
+{
+}
+
+InstrumentTimer::~InstrumentTimer()
+{
+    stop();
+}
+
+int InstrumentTimer::interval()
+{
+    return FRAME_PERIOD_MS;
+}
+
+void InstrumentTimer::start()
+{
+    active = true;
+    InstrumentClock::instance()->add(this);
+}
+
+void InstrumentTimer::stop()
+{
+    if (!active)
+        return;
+    active = false;
+    InstrumentClock::instance()->remove(this);
+}
+
+}
+
+#include "instrumentclock.moc"
@@ -0,0 +1,69 @@
+/**
+ ******************************************************************************
+ *
+ * @file       instrumentclock.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Frame clock shared by the animated instruments
+ * @see        The GNU Public License (GPL) Version 3
+ * @defgroup
+ * @{
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef INSTRUMENTCLOCK_H
+#define INSTRUMENTCLOCK_H
+
+#include "utils_global.h"
+#include <QObject>
+
+namespace Utils {
+
+/**
+ * Drop-in for the QTimer that animates an instrument's needles. All the
+ * instruments of the GCS (dials, linear dials, PFD) step on the ticks of one
+ * shared frame clock instead of running a timer each, so the scene updates of
+ * a whole dashboard are posted together and painted in the same event loop
+ * pass. The clock only runs while at least one instrument is animating.
+ */
+class QTCREATOR_UTILS_EXPORT InstrumentTimer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit InstrumentTimer(QObject *parent = 0);
+    ~InstrumentTimer();
+
+    bool isActive() const { return active; }
+    //! Frame period of the shared clock, in ms
+    static int interval();
+
+public slots:
+    void start();
+    void stop();
+
+signals:
+    //! Emitted once per frame of the shared clock while active
+    void timeout();
+
+private:
+    friend class InstrumentClock;
+    bool active;
+};
+
+}
+
+#endif /* INSTRUMENTCLOCK_H */
@@ -53,7 +53,8 @@ SOURCES += reloadpromptutils.cpp \
     mytabwidget.cpp \
     mylistwidget.cpp \
     cachedsvgitem.cpp \
-    svgimageprovider.cpp
+    svgimageprovider.cpp \
+    instrumentclock.cpp
 
 SOURCES += xmlconfig.cpp
 
@@ -110,7 +111,8 @@ HEADERS += utils_global.h \
     mytabwidget.h \
     mylistwidget.h \
     cachedsvgitem.h \
-    svgimageprovider.h
+    svgimageprovider.h \
+    instrumentclock.h
 
 
 HEADERS += xmlconfig.h
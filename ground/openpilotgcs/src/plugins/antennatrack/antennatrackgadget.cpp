@@ -99,6 +99,7 @@ void AntennaTrackGadget::loadConfiguration(IUAVGadgetConfiguration* config)
     qDebug() << "Using Telemetry parser";
     parser = new TelemetryParser();
 
+    connect(parser, SIGNAL(speedheading(double,double)), m_widget,SLOT(setSpeedHeading(double,double)));
     connect(parser, SIGNAL(position(double,double,double)), m_widget,SLOT(setPosition(double,double,double)));
     connect(parser, SIGNAL(home(double,double,double)), m_widget,SLOT(setHomePosition(double,double,double)));
     connect(parser, SIGNAL(packet(QString)), m_widget, SLOT(dumpPacket(QString)));
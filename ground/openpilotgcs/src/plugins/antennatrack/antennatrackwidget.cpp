@@ -34,6 +34,15 @@
 #include <QtGui>
 #include <QDebug>
 
+// Control rate of the tracker
+#define TRACK_PERIOD_MS 100
+// Positions older than this are not extrapolated further (lost link)
+#define MAX_EXTRAPOLATION_S 3.0
+// Slew rate limits in deg/s
+#define MAX_AZIMUTH_RATE 90.0
+#define MAX_ELEVATION_RATE 45.0
+#define EARTH_RADIUS 6371000.0
+
 /*
  * Initialize the widget
  */
@@ -41,8 +50,18 @@ AntennaTrackWidget::AntennaTrackWidget(QWidget *parent) : QWidget(parent)
 {
     setupUi(this);
 
-    azimuth_old=0;
-    elevation_old=0;
+    TrackData.Groundspeed=0;
+    TrackData.Heading=0;
+    haveFix=false;
+    haveHome=false;
+    // The antenna is expected to start pointing north
+    azimuth_cmd=0;
+    elevation_cmd=0;
+    stepper_pos=0;
+    servo_old=-1;
+
+    connect(&trackTimer, SIGNAL(timeout()), this, SLOT(track()));
+    trackTimer.start(TRACK_PERIOD_MS);
 }
 
 AntennaTrackWidget::~AntennaTrackWidget()
@@ -93,7 +112,14 @@ void AntennaTrackWidget::setPosition(double lat, double lon, double alt)
     TrackData.Latitude=lat;
     TrackData.Longitude=lon;
     TrackData.Altitude=alt;
-    calcAntennaPosition();
+    fixTime.start();
+    haveFix=true;
+}
+
+void AntennaTrackWidget::setSpeedHeading(double speed, double heading)
+{
+    TrackData.Groundspeed=speed;
+    TrackData.Heading=heading;
 }
 
 void AntennaTrackWidget::setHomePosition(double lat, double lon, double alt)
@@ -124,23 +150,73 @@ void AntennaTrackWidget::setHomePosition(double lat, double lon, double alt)
     TrackData.HomeLatitude=lat;
     TrackData.HomeLongitude=lon;
     TrackData.HomeAltitude=alt;
-    calcAntennaPosition();
+    haveHome=true;
 }
 
-void AntennaTrackWidget::calcAntennaPosition(void)
+/**
+ * Runs at the control rate. The UAV position is extrapolated along its ground
+ * track from the last fix, so the antenna leads the aircraft instead of lagging
+ * a GPS period behind. The command sent to the tracker is slew rate limited and
+ * at most one is written per period, however often positions arrive.
+ */
+void AntennaTrackWidget::track(void)
+{
+    if(!haveFix || !haveHome)
+        return;
+
+    double dt = qMin(fixTime.elapsed()/1000.0, MAX_EXTRAPOLATION_S);
+    double dist = TrackData.Groundspeed*dt;
+    double heading = TrackData.Heading*(M_PI/180);
+    double lat = TrackData.Latitude + dist*cos(heading)/EARTH_RADIUS*(180/M_PI);
+    double lon = TrackData.Longitude + dist*sin(heading)/(EARTH_RADIUS*cos(TrackData.Latitude*(M_PI/180)))*(180/M_PI);
+
+    double azimuth, elevation;
+    calcAntennaPosition(lat, lon, TrackData.Altitude, azimuth, elevation);
+
+    QString str3;
+    str3.sprintf("%.0f deg", azimuth);
+    azimuth_value->setText(str3);
+
+    str3.sprintf("%.0f deg", elevation);
+    elevation_value->setText(str3);
+
+    if(!port || !port->isOpen())
+        return;
+
+    // Slew limit, the azimuth the short way round
+    double period = TRACK_PERIOD_MS/1000.0;
+    double dAzimuth = azimuth - azimuth_cmd;
+    dAzimuth -= 360*floor((dAzimuth+180)/360);
+    azimuth_cmd += qBound(-MAX_AZIMUTH_RATE*period, dAzimuth, MAX_AZIMUTH_RATE*period);
+    elevation_cmd += qBound(-MAX_ELEVATION_RATE*period, elevation-elevation_cmd, MAX_ELEVATION_RATE*period);
+
+    //servo value 2000-4000
+    int servo = (int)(2000.0/180*elevation_cmd+2000);
+    int stepper = qRound(400.0/360*azimuth_cmd);
+
+    // send azimuth and elevation to tracker hardware
+    if(stepper!=stepper_pos || servo!=servo_old)
+    {
+        str3.sprintf("move %d 2000 2000 2000 %d\r", stepper-stepper_pos,servo);
+        port->write(str3.toAscii());
+        stepper_pos = stepper;
+        servo_old = servo;
+    }
+}
+
+void AntennaTrackWidget::calcAntennaPosition(double lat, double lon, double alt, double &azimuth, double &elevation)
 {
     /** http://www.movable-type.co.uk/scripts/latlong.html **/
     double lat1, lat2, lon1, lon2, a, c, d, x, y, brng;
-    double azimuth, elevation;
     double gcsAlt=TrackData.HomeAltitude; // Home MSL altitude
-    double uavAlt=TrackData.Altitude; // UAV MSL altitude
+    double uavAlt=alt; // UAV MSL altitude
     double dAlt=uavAlt-gcsAlt; // Altitude difference
 
     // Convert to radians
     lat1 = TrackData.HomeLatitude*(M_PI/180); // Home lat
     lon1 = TrackData.HomeLongitude*(M_PI/180); // Home lon
-    lat2 = TrackData.Latitude*(M_PI/180); // UAV lat
-    lon2 = TrackData.Longitude*(M_PI/180); // UAV lon
+    lat2 = lat*(M_PI/180); // UAV lat
+    lon2 = lon*(M_PI/180); // UAV lon
 
     // Bearing
     /**
@@ -181,26 +257,4 @@ void AntennaTrackWidget::calcAntennaPosition(void)
     else
         elevation = 0;
     //! TODO: sanity check
-
-    QString str3;
-    str3.sprintf("%.0f deg", azimuth);
-    azimuth_value->setText(str3);
-
-    str3.sprintf("%.0f deg", elevation);
-    elevation_value->setText(str3);
-
-    //servo value 2000-4000
-    int servo = (int)(2000.0/180*elevation+2000);
-    int stepper = (int)(400.0/360*(azimuth-azimuth_old));
-
-    // send azimuth and elevation to tracker hardware
-    str3.sprintf("move %d 2000 2000 2000 %d\r", stepper,servo);
-    if(port->isOpen())
-    {
-        if(azimuth_old!=azimuth || elevation!=elevation_old)
-            port->write(str3.toAscii());
-        azimuth_old = azimuth;
-        elevation_old = elevation;
-    }
-
 }
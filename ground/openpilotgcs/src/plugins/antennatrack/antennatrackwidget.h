@@ -36,6 +36,8 @@
 #include <QtSvg/QGraphicsSvgItem>
 #include <qextserialport/src/qextserialport.h>
 #include <QPointer>
+#include <QTimer>
+#include <QTime>
 
 class Ui_AntennaTrackWidget;
 
@@ -47,6 +49,8 @@ typedef struct struct_TrackData
         double HomeLatitude;
         double HomeLongitude;
         double HomeAltitude;
+        double Groundspeed; // m/s
+        double Heading; // deg
 
 }TrackData_t;
 
@@ -62,14 +66,24 @@ public:
 
 private slots:
    void setPosition(double, double, double);
+   void setSpeedHeading(double, double);
    void setHomePosition(double, double, double);
    void dumpPacket(const QString &packet);
+   void track(void);
 
 private:
-   void calcAntennaPosition(void);
+   void calcAntennaPosition(double lat, double lon, double alt, double &azimuth, double &elevation);
    QGraphicsSvgItem * marker;
    QPointer<QextSerialPort> port;
-   double azimuth_old;
-   double elevation_old;
+   QTimer trackTimer;
+   QTime fixTime; // arrival of the last position
+   bool haveFix;
+   bool haveHome;
+   // Commanded antenna position, the azimuth is not wrapped so the stepper
+   // position follows it without drift
+   double azimuth_cmd;
+   double elevation_cmd;
+   int stepper_pos;
+   int servo_old;
 };
 #endif /* ANTENNATRACKWIDGET_H_ */
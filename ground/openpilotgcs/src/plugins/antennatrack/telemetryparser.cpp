@@ -42,6 +42,8 @@ TelemetryParser::TelemetryParser(QObject *parent) : GPSParser(parent)
     UAVDataObject *gpsObj = dynamic_cast<UAVDataObject*>(objManager->getObject("GPSPosition"));
     if (gpsObj != NULL) {
         connect(gpsObj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateGPS(UAVObject*)));
+        gpsObj->addInterest();
+        shownObjects.append(gpsObj);
     } else {
         qDebug() << "Error: Object is unknown (GPSPosition).";
     }
@@ -49,6 +51,8 @@ TelemetryParser::TelemetryParser(QObject *parent) : GPSParser(parent)
     gpsObj = dynamic_cast<UAVDataObject*>(objManager->getObject("HomeLocation"));
     if (gpsObj != NULL) {
     connect(gpsObj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateHome(UAVObject*)));
+        gpsObj->addInterest();
+        shownObjects.append(gpsObj);
     } else {
         qDebug() << "Error: Object is unknown (HomeLocation).";
     }
@@ -57,7 +61,8 @@ TelemetryParser::TelemetryParser(QObject *parent) : GPSParser(parent)
 
 TelemetryParser::~TelemetryParser()
 {
-
+    foreach (UAVObject* obj, shownObjects)
+        obj->removeInterest();
 }
 
 void TelemetryParser::updateHome( UAVObject* object1) {
@@ -74,8 +79,12 @@ void TelemetryParser::updateGPS( UAVObject* object1) {
     double lat = object1->getField(QString("Latitude"))->getDouble();
     double lon = object1->getField(QString("Longitude"))->getDouble();
     double alt = object1->getField(QString("Altitude"))->getDouble();
+    double speed = object1->getField(QString("Groundspeed"))->getDouble();
+    double heading = object1->getField(QString("Heading"))->getDouble();
     lat *= 1E-7;
     lon *= 1E-7;
+    // Velocity first, the position is extrapolated with it
+    emit speedheading(speed,heading);
     emit position(lat,lon,alt);
 }
 
@@ -47,6 +47,11 @@ public:
 public slots:
    void updateGPS(UAVObject* object1);
    void updateHome(UAVObject* object1);
+
+private:
+   // Held as shown while the parser runs, the antenna follows the vehicle
+   // even when the gadget is hidden
+   QList<UAVObject*> shownObjects;
 };
 
 #endif // TELEMETRYPARSER_H
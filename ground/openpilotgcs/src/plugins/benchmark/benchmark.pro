@@ -0,0 +1,19 @@
+TEMPLATE = lib
+TARGET = BenchmarkGadget
+
+include(../../openpilotgcsplugin.pri)
+include(../../plugins/coreplugin/coreplugin.pri)
+include(../../plugins/uavobjects/uavobjects.pri)
+include(../../plugins/uavobjectutil/uavobjectutil.pri)
+
+HEADERS += benchmarkgadget.h
+HEADERS += benchmarkgadgetwidget.h
+HEADERS += benchmarkgadgetfactory.h
+HEADERS += benchmarkplugin.h
+
+SOURCES += benchmarkgadget.cpp
+SOURCES += benchmarkgadgetwidget.cpp
+SOURCES += benchmarkgadgetfactory.cpp
+SOURCES += benchmarkplugin.cpp
+
+OTHER_FILES += BenchmarkGadget.pluginspec
@@ -0,0 +1,211 @@
+/**
+ ******************************************************************************
+ *
+ * @file       benchmarkgadgetwidget.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup BenchmarkGadgetPlugin Benchmark Gadget Plugin
+ * @{
+ * @brief Firmware benchmark results, compared against a saved run
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "benchmarkgadgetwidget.h"
+
+#include <QtGui/QLabel>
+#include <QtGui/QPushButton>
+#include <QtGui/QTableWidget>
+#include <QtGui/QHeaderView>
+#include <QtGui/QVBoxLayout>
+#include <QtGui/QHBoxLayout>
+#include <QtGui/QFileDialog>
+#include <QtGui/QMessageBox>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include "uavobjectmanager.h"
+#include "uavobjectutilmanager.h"
+#include "extensionsystem/pluginmanager.h"
+
+BenchmarkGadgetWidget::BenchmarkGadgetWidget(QWidget *parent) : QWidget(parent)
+{
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
+    m_results = BenchmarkResults::GetInstance(objManager);
+    m_kernels = m_results->getField("MeanCycles")->getElementNames();
+    connect(m_results, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(resultsUpdated(UAVObject*)));
+
+    m_status = new QLabel(tr("No results, the firmware must be built with BENCHMARK=YES"), this);
+    m_status->setWordWrap(true);
+
+    m_table = new QTableWidget(m_kernels.count(), COLUMN_NUMELEM, this);
+    m_table->setHorizontalHeaderLabels(QStringList() << tr("Kernel") << tr("Min") << tr("Mean")
+                                       << tr("Max") << tr("Mean (us)") << tr("Baseline") << tr("Change"));
+    m_table->verticalHeader()->hide();
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    for (int row = 0; row < m_kernels.count(); ++row) {
+        for (int column = 0; column < COLUMN_NUMELEM; ++column) {
+            QTableWidgetItem *item = new QTableWidgetItem();
+            if (column != COLUMN_KERNEL)
+                item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            m_table->setItem(row, column, item);
+        }
+        m_table->item(row, COLUMN_KERNEL)->setText(m_kernels[row]);
+    }
+
+    QPushButton *saveButton = new QPushButton(tr("Save run..."), this);
+    QPushButton *loadButton = new QPushButton(tr("Load baseline..."), this);
+    connect(saveButton, SIGNAL(clicked()), this, SLOT(saveRun()));
+    connect(loadButton, SIGNAL(clicked()), this, SLOT(loadBaseline()));
+
+    QHBoxLayout *buttons = new QHBoxLayout();
+    buttons->addWidget(saveButton);
+    buttons->addWidget(loadButton);
+    buttons->addStretch();
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(m_status);
+    layout->addWidget(m_table);
+    layout->addLayout(buttons);
+}
+
+BenchmarkGadgetWidget::~BenchmarkGadgetWidget()
+{
+   // Do nothing
+}
+
+/**
+  * The firmware build on the board, saved with a run to tell them apart
+  */
+QString BenchmarkGadgetWidget::currentBuild()
+{
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    UAVObjectUtilManager *utilMngr = pm->getObject<UAVObjectUtilManager>();
+    deviceDescriptorStruct board = utilMngr->getBoardDescriptionStruct();
+    if (board.gitHash.isEmpty())
+        return tr("unknown build");
+    return QString("%1 %2 %3").arg(deviceDescriptorStruct::idToBoardName(board.boardType << 8 | board.boardRevision),
+                                   board.gitTag, board.gitHash);
+}
+
+void BenchmarkGadgetWidget::resultsUpdated(UAVObject *obj)
+{
+    Q_UNUSED(obj);
+    if (m_build.isEmpty())
+        m_build = currentBuild();
+    updateTable();
+}
+
+void BenchmarkGadgetWidget::updateTable()
+{
+    BenchmarkResults::DataFields data = m_results->getData();
+    if (data.Rounds == 0)
+        return;
+
+    QString status = tr("%1, %2 MHz, round %3 of %4 iterations").arg(m_build).arg(data.CPUClock)
+                     .arg(data.Rounds).arg(data.Iterations);
+    if (!m_baseline.isEmpty())
+        status += "\n" + tr("Baseline: %1").arg(m_baselineBuild);
+    m_status->setText(status);
+
+    for (int row = 0; row < m_kernels.count(); ++row) {
+        // Kernels this board does not have are all zero
+        bool present = data.MaxCycles[row] > 0;
+        m_table->item(row, COLUMN_MIN)->setText(present ? QString::number(data.MinCycles[row]) : QString());
+        m_table->item(row, COLUMN_MEAN)->setText(present ? QString::number(data.MeanCycles[row]) : QString());
+        m_table->item(row, COLUMN_MAX)->setText(present ? QString::number(data.MaxCycles[row]) : QString());
+        m_table->item(row, COLUMN_MEAN_US)->setText(present && data.CPUClock > 0 ?
+                QString::number((double)data.MeanCycles[row] / data.CPUClock, 'f', 2) : QString());
+
+        QTableWidgetItem *baselineItem = m_table->item(row, COLUMN_BASELINE);
+        QTableWidgetItem *changeItem = m_table->item(row, COLUMN_CHANGE);
+        quint32 baseline = m_baseline.value(m_kernels[row]);
+        if (!present || baseline == 0) {
+            baselineItem->setText(baseline > 0 ? QString::number(baseline) : QString());
+            changeItem->setText(QString());
+            continue;
+        }
+        double change = 100.0 * ((double)data.MeanCycles[row] - baseline) / baseline;
+        baselineItem->setText(QString::number(baseline));
+        changeItem->setText(QString("%1%2%").arg(change > 0 ? "+" : "").arg(change, 0, 'f', 1));
+        changeItem->setForeground(change > 5 ? Qt::red : (change < -5 ? Qt::darkGreen : Qt::black));
+    }
+    m_table->resizeColumnsToContents();
+}
+
+/**
+  * Writes the last round as CSV, a comment line with the build and clock
+  * then one line of min, mean and max cycles per kernel
+  */
+void BenchmarkGadgetWidget::saveRun()
+{
+    BenchmarkResults::DataFields data = m_results->getData();
+    if (data.Rounds == 0)
+        return;
+
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Save benchmark run"), QString(), tr("CSV files (*.csv)"));
+    if (fileName.isEmpty())
+        return;
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, tr("Save benchmark run"), tr("Unable to open %1").arg(fileName));
+        return;
+    }
+
+    QTextStream out(&file);
+    out << "# " << m_build << ", " << data.CPUClock << " MHz\n";
+    out << "kernel,min,mean,max\n";
+    for (int row = 0; row < m_kernels.count(); ++row) {
+        out << m_kernels[row] << "," << data.MinCycles[row] << "," << data.MeanCycles[row]
+            << "," << data.MaxCycles[row] << "\n";
+    }
+}
+
+void BenchmarkGadgetWidget::loadBaseline()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Load benchmark baseline"), QString(), tr("CSV files (*.csv)"));
+    if (fileName.isEmpty())
+        return;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, tr("Load benchmark baseline"), tr("Unable to open %1").arg(fileName));
+        return;
+    }
+
+    m_baseline.clear();
+    m_baselineBuild = QFileInfo(fileName).fileName();
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.startsWith("#")) {
+            m_baselineBuild = line.mid(1).trimmed();
+            continue;
+        }
+        QStringList values = line.split(",");
+        bool ok;
+        quint32 mean = values.value(2).toUInt(&ok);
+        if (values.count() >= 4 && ok)
+            m_baseline.insert(values[0], mean);
+    }
+    updateTable();
+}
+
+/**
+  * @}
+  * @}
+  */
@@ -0,0 +1,74 @@
+/**
+ ******************************************************************************
+ *
+ * @file       benchmarkgadgetwidget.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup BenchmarkGadgetPlugin Benchmark Gadget Plugin
+ * @{
+ * @brief Firmware benchmark results, compared against a saved run
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef BENCHMARKGADGETWIDGET_H_
+#define BENCHMARKGADGETWIDGET_H_
+
+#include <QtGui/QWidget>
+#include <QMap>
+#include "benchmarkresults.h"
+
+class QLabel;
+class QTableWidget;
+
+/**
+ * Table of the cycle counts the benchmark firmware sends in BenchmarkResults.
+ * A run can be saved as CSV and loaded back as the baseline, the mean of each
+ * kernel is then compared with it, so builds can be compared on one board.
+ */
+class BenchmarkGadgetWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    BenchmarkGadgetWidget(QWidget *parent = 0);
+    ~BenchmarkGadgetWidget();
+
+private slots:
+    void resultsUpdated(UAVObject *obj);
+    void saveRun();
+    void loadBaseline();
+
+private:
+    typedef enum { COLUMN_KERNEL, COLUMN_MIN, COLUMN_MEAN, COLUMN_MAX, COLUMN_MEAN_US,
+                   COLUMN_BASELINE, COLUMN_CHANGE, COLUMN_NUMELEM } Column;
+
+    BenchmarkResults *m_results;
+    QStringList m_kernels;
+    QString m_build;
+    // Mean cycles of the baseline run by kernel name
+    QMap<QString, quint32> m_baseline;
+    QString m_baselineBuild;
+
+    QLabel *m_status;
+    QTableWidget *m_table;
+
+    QString currentBuild();
+    void updateTable();
+};
+
+#endif /* BENCHMARKGADGETWIDGET_H_ */
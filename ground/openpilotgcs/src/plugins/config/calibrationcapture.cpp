@@ -0,0 +1,171 @@
+/**
+ ******************************************************************************
+ *
+ * @file       calibrationcapture.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ConfigPlugin Config Plugin
+ * @{
+ * @brief High rate sensor capture for the calibration routines
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "calibrationcapture.h"
+#include <QMutexLocker>
+
+CalibrationCapture::CalibrationCapture(QObject *parent) :
+    QObject(parent),
+    running(false),
+    wanted(0),
+    lastPercent(0)
+{
+    timer.setSingleShot(true);
+    connect(&timer, SIGNAL(timeout()), this, SLOT(timeout()));
+}
+
+CalibrationCapture::~CalibrationCapture()
+{
+    stop();
+}
+
+void CalibrationCapture::addObject(UAVObject *obj)
+{
+    Q_ASSERT(obj);
+    Channel channel;
+    channel.field[0] = obj->getField("x");
+    channel.field[1] = obj->getField("y");
+    channel.field[2] = obj->getField("z");
+    Q_ASSERT(channel.field[0] && channel.field[1] && channel.field[2]);
+
+    QMutexLocker locker(&mutex);
+    channels.insert(obj, channel);
+}
+
+void CalibrationCapture::start(int samplesPerObject, int updatePeriodMs, int timeoutMs)
+{
+    stop();
+
+    {
+        QMutexLocker locker(&mutex);
+        wanted = samplesPerObject;
+        lastPercent = 0;
+        QMap<UAVObject *, Channel>::iterator it;
+        for (it = channels.begin(); it != channels.end(); ++it) {
+            it->samples.clear();
+            it->samples.reserve(samplesPerObject);
+        }
+    }
+
+    // The object mutexes are not taken under ours, sampleReceived does it the other way round
+    QMap<UAVObject *, Channel>::iterator it;
+    for (it = channels.begin(); it != channels.end(); ++it) {
+        UAVObject *obj = it.key();
+        it->initialMdata = obj->getMetadata();
+
+        UAVObject::Metadata mdata = it->initialMdata;
+        UAVObject::SetFlightTelemetryUpdateMode(mdata, UAVObject::UPDATEMODE_PERIODIC);
+        mdata.flightTelemetryUpdatePeriod = updatePeriodMs;
+        obj->setMetadata(mdata);
+
+        // Unpacked on the telemetry thread, sampled there too
+        connect(obj, SIGNAL(objectUnpacked(UAVObject*)), this, SLOT(sampleReceived(UAVObject*)), Qt::DirectConnection);
+    }
+    running = true;
+    timer.start(timeoutMs);
+}
+
+void CalibrationCapture::stop()
+{
+    timer.stop();
+    {
+        QMutexLocker locker(&mutex);
+        if (!running)
+            return;
+        running = false;
+    }
+    foreach (UAVObject *obj, channels.keys())
+        disconnect(obj, SIGNAL(objectUnpacked(UAVObject*)), this, SLOT(sampleReceived(UAVObject*)));
+    restoreMetadata();
+}
+
+QVector<Eigen::Vector3f> CalibrationCapture::samples(UAVObject *obj)
+{
+    QMutexLocker locker(&mutex);
+    return channels.value(obj).samples;
+}
+
+Eigen::Vector3f CalibrationCapture::mean(UAVObject *obj)
+{
+    QMutexLocker locker(&mutex);
+    const QVector<Eigen::Vector3f> data = channels.value(obj).samples;
+    Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+    foreach (const Eigen::Vector3f &sample, data)
+        sum += sample.cast<double>();
+    if (data.isEmpty())
+        return Eigen::Vector3f::Zero();
+    return (sum / data.size()).cast<float>();
+}
+
+void CalibrationCapture::sampleReceived(UAVObject *obj)
+{
+    QMutexLocker locker(&mutex);
+    if (!running)
+        return;
+
+    Channel &channel = channels[obj];
+    if (channel.samples.size() >= wanted)
+        return;
+    channel.samples.append(Eigen::Vector3f(channel.field[0]->getDouble(),
+                                           channel.field[1]->getDouble(),
+                                           channel.field[2]->getDouble()));
+
+    int least = wanted;
+    foreach (const Channel &other, channels)
+        least = qMin(least, other.samples.size());
+
+    int percent = (wanted > 0) ? (least * 100 / wanted) : 100;
+    if (percent != lastPercent) {
+        lastPercent = percent;
+        // Queued to the receivers, the emitting thread is not theirs
+        emit progress(percent);
+    }
+    if (least >= wanted)
+        QMetaObject::invokeMethod(this, "complete", Qt::QueuedConnection);
+}
+
+void CalibrationCapture::complete()
+{
+    if (!running)
+        return;
+    stop();
+    emit finished(true);
+}
+
+void CalibrationCapture::timeout()
+{
+    if (!running)
+        return;
+    stop();
+    emit finished(false);
+}
+
+void CalibrationCapture::restoreMetadata()
+{
+    QMap<UAVObject *, Channel>::iterator it;
+    for (it = channels.begin(); it != channels.end(); ++it)
+        it.key()->setMetadata(it->initialMdata);
+}
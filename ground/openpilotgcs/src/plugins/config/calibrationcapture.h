@@ -0,0 +1,93 @@
+/**
+ ******************************************************************************
+ *
+ * @file       calibrationcapture.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ConfigPlugin Config Plugin
+ * @{
+ * @brief High rate sensor capture for the calibration routines
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef CALIBRATIONCAPTURE_H
+#define CALIBRATIONCAPTURE_H
+
+#include "uavobject.h"
+#include "uavobjectfield.h"
+#include <Eigen/Core>
+#include <QObject>
+#include <QMap>
+#include <QVector>
+#include <QMutex>
+#include <QTimer>
+
+/**
+ * Captures a fixed number of samples of sensor objects with x, y and z
+ * fields for a calibration step.
+ *
+ * The objects are switched to a high periodic update rate for the capture
+ * and restored afterwards. Samples are buffered straight from the telemetry
+ * thread instead of the GUI thread, so a busy GUI does not drop any.
+ */
+class CalibrationCapture : public QObject
+{
+    Q_OBJECT
+
+public:
+    CalibrationCapture(QObject *parent = 0);
+    ~CalibrationCapture();
+
+    void addObject(UAVObject *obj);
+    /**
+     * Starts capturing, finished() is emitted once every object got
+     * samplesPerObject updates or after timeoutMs.
+     */
+    void start(int samplesPerObject, int updatePeriodMs, int timeoutMs);
+    void stop();
+    bool isRunning() const { return running; }
+
+    QVector<Eigen::Vector3f> samples(UAVObject *obj);
+    Eigen::Vector3f mean(UAVObject *obj);
+
+signals:
+    void progress(int percent);
+    void finished(bool success);
+
+private slots:
+    void sampleReceived(UAVObject *obj);
+    void complete();
+    void timeout();
+
+private:
+    struct Channel {
+        UAVObjectField *field[3];
+        UAVObject::Metadata initialMdata;
+        QVector<Eigen::Vector3f> samples;
+    };
+
+    void restoreMetadata();
+
+    QMap<UAVObject *, Channel> channels;
+    QMutex mutex;
+    QTimer timer;
+    volatile bool running;
+    int wanted;
+    int lastPercent;
+};
+
+#endif // CALIBRATIONCAPTURE_H
@@ -25,6 +25,7 @@ HEADERS += configplugin.h \
     configstabilizationwidget.h \
     assertions.h \
     calibration.h \
+    calibrationcapture.h \
     defaultattitudewidget.h \
     defaulthwsettingswidget.h \
     inputchannelform.h \
@@ -58,6 +59,7 @@ SOURCES += configplugin.cpp \
     legacy-calibration.cpp \
     gyro-calibration.cpp \
     alignment-calibration.cpp \
+    calibrationcapture.cpp \
     defaultattitudewidget.cpp \
     defaulthwsettingswidget.cpp \
     inputchannelform.cpp \
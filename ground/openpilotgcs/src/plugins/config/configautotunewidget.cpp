@@ -10,6 +10,10 @@
 #include <QDesktopServices>
 #include <QUrl>
 #include <QList>
+#include <QFile>
+#include <QFileDialog>
+#include <QTextStream>
+#include <QMessageBox>
 #include "relaytuningsettings.h"
 #include "relaytuning.h"
 #include "stabilizationsettings.h"
@@ -39,6 +43,83 @@ ConfigAutotuneWidget::ConfigAutotuneWidget(QWidget *parent) :
 
     // Connect the apply button for the stabilization settings
     connect(m_autotune->useComputedValues, SIGNAL(pressed()), this, SLOT(saveStabilization()));
+
+    RelayTuningSegment *relayTuningSegment = RelayTuningSegment::GetInstance(getObjectManager());
+    Q_ASSERT(relayTuningSegment);
+    if(relayTuningSegment)
+        connect(relayTuningSegment, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(segmentReceived(UAVObject*)));
+    connect(m_autotune->saveSegments, SIGNAL(clicked()), this, SLOT(saveSegments()));
+}
+
+/**
+  * Collects the chunks of the response recorded by the autotune module
+  */
+void ConfigAutotuneWidget::segmentReceived(UAVObject *obj)
+{
+    RelayTuningSegment *relayTuningSegment = dynamic_cast<RelayTuningSegment*>(obj);
+    if (!relayTuningSegment)
+        return;
+
+    RelayTuningSegment::DataFields data = relayTuningSegment->getData();
+    if (data.Axis > 1 || data.Chunks == 0 || data.Chunk >= data.Chunks)
+        return;
+
+    Segment &segment = segments[data.Axis];
+    const int chunkSize = RelayTuningSegment::INPUT_NUMELEM;
+    // A new flight starts over, chunks are sent in order
+    if (data.Chunk == 0 || segment.received.size() != data.Chunks) {
+        segment.input.fill(0, data.Chunks * chunkSize);
+        segment.output.fill(0, data.Chunks * chunkSize);
+        segment.received.fill(false, data.Chunks);
+    }
+    segment.samplePeriod = data.SamplePeriod;
+    for (int i = 0; i < chunkSize; i++) {
+        segment.input[data.Chunk * chunkSize + i] = data.Input[i];
+        segment.output[data.Chunk * chunkSize + i] = data.Output[i];
+    }
+    segment.received[data.Chunk] = true;
+
+    QStringList status;
+    const char *names[2] = { "roll", "pitch" };
+    bool any = false;
+    for (int axis = 0; axis < 2; axis++) {
+        int count = segments[axis].received.count(true);
+        if (segments[axis].received.isEmpty())
+            continue;
+        any = true;
+        status << tr("%1 %2/%3").arg(names[axis]).arg(count).arg(segments[axis].received.size());
+    }
+    m_autotune->segmentStatus->setText(tr("Recorded response received: %1").arg(status.join(", ")));
+    m_autotune->saveSegments->setEnabled(any);
+}
+
+/**
+  * Writes the recorded response as CSV for analysis with other tools
+  */
+void ConfigAutotuneWidget::saveSegments()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Save recorded response"), "autotune.csv", tr("CSV files (*.csv)"));
+    if (fileName.isEmpty())
+        return;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        QMessageBox::warning(this, tr("Save recorded response"), tr("Could not write %1").arg(fileName));
+        return;
+    }
+
+    QTextStream out(&file);
+    out << "axis,time_ms,output,gyro_deg_s\n";
+    const char *names[2] = { "roll", "pitch" };
+    for (int axis = 0; axis < 2; axis++) {
+        const Segment &segment = segments[axis];
+        for (int i = 0; i < segment.input.size(); i++) {
+            if (!segment.received.at(i / RelayTuningSegment::INPUT_NUMELEM))
+                continue;
+            out << names[axis] << "," << i * segment.samplePeriod << ","
+                << segment.input.at(i) / 10000.0 << "," << segment.output.at(i) / 10.0 << "\n";
+        }
+    }
 }
 
 /**
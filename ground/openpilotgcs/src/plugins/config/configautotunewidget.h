@@ -35,8 +35,10 @@
 #include "stabilizationsettings.h"
 #include "relaytuningsettings.h"
 #include "relaytuning.h"
+#include "relaytuningsegment.h"
 #include <QtGui/QWidget>
 #include <QTimer>
+#include <QVector>
 
 class ConfigAutotuneWidget : public ConfigTaskWidget
 {
@@ -48,6 +50,15 @@ private:
     Ui_AutotuneWidget *m_autotune;
     StabilizationSettings::DataFields stabSettings;
 
+    // Recorded relay output and gyro response per axis, in chunks
+    struct Segment {
+        QVector<qint16> input;
+        QVector<qint16> output;
+        QVector<bool> received;
+        quint8 samplePeriod;
+    };
+    Segment segments[2];
+
 signals:
 
 public slots:
@@ -56,6 +67,8 @@ public slots:
 private slots:
     void recomputeStabilization();
     void saveStabilization();
+    void segmentReceived(UAVObject *obj);
+    void saveSegments();
 };
 
 #endif // CONFIGAUTOTUNE_H
@@ -124,6 +124,11 @@ ConfigInputWidget::ConfigInputWidget(QWidget *parent) :
     addUAVObjectToWidgetRelation("ManualControlSettings","ArmedTimeout",m_config->armTimeout,0,1000);
     connect( ManualControlCommand::GetInstance(getObjectManager()),SIGNAL(objectUpdated(UAVObject*)),this,SLOT(moveFMSlider()));
     connect( ManualControlSettings::GetInstance(getObjectManager()),SIGNAL(objectUpdated(UAVObject*)),this,SLOT(updatePositionSlider()));
+    interest = new UAVObjectInterest(this);
+    interest->addObject(manualCommandObj);
+    interest->addObject(flightStatusObj);
+    interest->addObject(receiverActivityObj);
+    interest->addObject(AccessoryDesired::GetInstance(getObjectManager(),0));
     enableControls(false);
 
     populateWidgets();
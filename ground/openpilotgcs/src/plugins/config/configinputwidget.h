@@ -45,6 +45,7 @@
 #include <QtSvg/QGraphicsSvgItem>
 #include "flightstatus.h"
 #include "accessorydesired.h"
+#include "uavobjectinterest.h"
 #include <QPointer>
 
 class Ui_InputWidget;
@@ -109,6 +110,8 @@ private:
         ManualControlSettings::DataFields previousManualSettingsData;
         ReceiverActivity * receiverActivityObj;
         ReceiverActivity::DataFields receiverActivityData;
+        // The objects the sliders and the wizard follow, shown while the page is visible
+        UAVObjectInterest * interest;
 
         QSvgRenderer *m_renderer;
 
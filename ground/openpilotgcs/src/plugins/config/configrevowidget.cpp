@@ -39,6 +39,7 @@
 #include <iostream>
 #include <QDesktopServices>
 #include <QUrl>
+#include <QtConcurrentRun>
 #include <revocalibration.h>
 #include <accels.h>
 #include <gyros.h>
@@ -48,7 +49,10 @@
 #include "assertions.h"
 #include "calibration.h"
 
-#define sign(x) ((x < 0) ? -1 : 1)
+// Update period of the sensors while capturing, and samples taken per capture
+#define CAPTURE_PERIOD_MS 10
+#define ACCEL_BIAS_SAMPLES 500
+#define SIX_POINT_SAMPLES 200
 
 const double ConfigRevoWidget::maxVarValue = 0.1;
 
@@ -67,8 +71,9 @@ public:
 
 ConfigRevoWidget::ConfigRevoWidget(QWidget *parent) :
     ConfigTaskWidget(parent),
-    collectingData(false),
     m_ui(new Ui_RevoSensorsWidget()),
+    accel_data(6),
+    mag_data(6),
     position(-1)
 {
     m_ui->setupUi(this);
@@ -203,6 +208,19 @@ ConfigRevoWidget::ConfigRevoWidget(QWidget *parent) :
     mag_z->setPos(startX,startY);
     mag_z->setTransform(QTransform::fromScale(1,0),true);
 
+    // Sensor captures for the calibrations
+    Accels * accels = Accels::GetInstance(getObjectManager());
+    Q_ASSERT(accels);
+    Magnetometer * mag = Magnetometer::GetInstance(getObjectManager());
+    Q_ASSERT(mag);
+    accelBiasCapture.addObject(accels);
+    sixPointCapture.addObject(accels);
+    sixPointCapture.addObject(mag);
+    connect(&accelBiasCapture, SIGNAL(progress(int)), m_ui->accelBiasProgress, SLOT(setValue(int)));
+    connect(&accelBiasCapture, SIGNAL(finished(bool)), this, SLOT(accelBiasCaptured(bool)));
+    connect(&sixPointCapture, SIGNAL(finished(bool)), this, SLOT(positionCaptured(bool)));
+    connect(&scaleBiasWatcher, SIGNAL(finished()), this, SLOT(scaleBiasComputed()));
+
     // Connect the signals
     connect(m_ui->accelBiasStart, SIGNAL(clicked()), this, SLOT(launchAccelBiasCalibration()));
 
@@ -232,7 +250,8 @@ ConfigRevoWidget::ConfigRevoWidget(QWidget *parent) :
 
 ConfigRevoWidget::~ConfigRevoWidget()
 {
-    // Do nothing
+    // The fit works on copies, only wait for it not to signal a deleted widget
+    scaleBiasWatcher.waitForFinished();
 }
 
 
@@ -275,62 +294,37 @@ void ConfigRevoWidget::launchAccelBiasCalibration()
     revoCalibration->setData(revoCalibrationData);
     revoCalibration->updated();
 
-    accel_accum_x.clear();
-    accel_accum_y.clear();
-    accel_accum_z.clear();
-
-    /* Need to get as many AttitudeRaw updates as possible */
-    Accels * accels = Accels::GetInstance(getObjectManager());
-    Q_ASSERT(accels);
-    initialMdata = accels->getMetadata();
-    UAVObject::Metadata mdata = initialMdata;
-    UAVObject::SetFlightTelemetryUpdateMode(mdata, UAVObject::UPDATEMODE_PERIODIC);
-    mdata.flightTelemetryUpdatePeriod = 100;
-    accels->setMetadata(mdata);
-
-    // Now connect to the accels and mag updates, gather for 100 samples
-    collectingData = true;
-    connect(accels, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(accelBiasattitudeRawUpdated(UAVObject*)));
+    accelBiasCapture.start(ACCEL_BIAS_SAMPLES, CAPTURE_PERIOD_MS,
+                           ACCEL_BIAS_SAMPLES * CAPTURE_PERIOD_MS * 3 + 2000);
 }
 
 /**
-  Updates the accel bias raw values
+  Computes the accel bias from the captured samples
   */
-void ConfigRevoWidget::accelBiasattitudeRawUpdated(UAVObject *obj)
+void ConfigRevoWidget::accelBiasCaptured(bool success)
 {
-    Q_UNUSED(obj);
+    m_ui->accelBiasStart->setEnabled(true);
 
-    Accels * accels = Accels::GetInstance(getObjectManager());
-    Q_ASSERT(accels);
-    Accels::DataFields accelsData = accels->getData();
+    RevoCalibration * revoCalibration = RevoCalibration::GetInstance(getObjectManager());
+    Q_ASSERT(revoCalibration);
+    RevoCalibration::DataFields revoCalibrationData = revoCalibration->getData();
+    revoCalibrationData.BiasCorrectedRaw = RevoCalibration::BIASCORRECTEDRAW_TRUE;
 
-    // This is necessary to prevent a race condition on disconnect signal and another update
-    if (collectingData == true) {
-        accel_accum_x.append(accelsData.x);
-        accel_accum_y.append(accelsData.y);
-        accel_accum_z.append(accelsData.z);
+    if (success) {
+        Vector3f mean = accelBiasCapture.mean(Accels::GetInstance(getObjectManager()));
+        revoCalibrationData.accel_bias[RevoCalibration::ACCEL_BIAS_X] -= mean.x();
+        revoCalibrationData.accel_bias[RevoCalibration::ACCEL_BIAS_Y] -= mean.y();
+        revoCalibrationData.accel_bias[RevoCalibration::ACCEL_BIAS_Z] -= GRAVITY + mean.z();
     }
 
-    m_ui->accelBiasProgress->setValue(m_ui->accelBiasProgress->value()+1);
-
-    if(accel_accum_x.size() >= 100 && collectingData == true) {
-        collectingData = false;
-        disconnect(accels,SIGNAL(objectUpdated(UAVObject*)),this,SLOT(accelBiasattitudeRawUpdated(UAVObject*)));
-        m_ui->accelBiasStart->setEnabled(true);
-
-        RevoCalibration * revoCalibration = RevoCalibration::GetInstance(getObjectManager());
-        Q_ASSERT(revoCalibration);
-        RevoCalibration::DataFields revoCalibrationData = revoCalibration->getData();
-        revoCalibrationData.BiasCorrectedRaw = RevoCalibration::BIASCORRECTEDRAW_TRUE;
-
-        revoCalibrationData.accel_bias[RevoCalibration::ACCEL_BIAS_X] -= listMean(accel_accum_x);
-        revoCalibrationData.accel_bias[RevoCalibration::ACCEL_BIAS_Y] -= listMean(accel_accum_y);
-        revoCalibrationData.accel_bias[RevoCalibration::ACCEL_BIAS_Z] -= GRAVITY + listMean(accel_accum_z);
-
-        revoCalibration->setData(revoCalibrationData);
-        revoCalibration->updated();
+    revoCalibration->setData(revoCalibrationData);
+    revoCalibration->updated();
 
-        accels->setMetadata(initialMdata);
+    if (!success) {
+        m_ui->accelBiasProgress->setValue(0);
+        QErrorMessage err(this);
+        err.showMessage("Accelerometer bias calibration timed out before receiving enough updates.");
+        err.exec();
     }
 }
 
@@ -346,7 +340,6 @@ void ConfigRevoWidget::incrementProgress()
         RevoCalibration * revoCalibration = RevoCalibration::GetInstance(getObjectManager());
         Q_ASSERT(revoCalibration);
         disconnect(revoCalibration, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(noiseMeasured()));
-        collectingData = false;
 
         QErrorMessage err(this);
         err.showMessage("Noise measurement timed out.  State undetermined.  Please power cycle.");
@@ -354,84 +347,46 @@ void ConfigRevoWidget::incrementProgress()
     }
 }
 
-void ConfigRevoWidget::sensorsUpdated(UAVObject * obj)
+/**
+  * Stores the captured position and moves on to the next one
+  */
+void ConfigRevoWidget::positionCaptured(bool success)
 {
-    QMutexLocker lock(&attitudeRawUpdateLock);
-
-       qDebug() << "Data";
-    // This is necessary to prevent a race condition on disconnect signal and another update
-    if (collectingData == true) {
-        qDebug() << "Collecting";
-        if( obj->getObjID() == Accels::OBJID ) {
-            qDebug() << "Accels";
-            Accels * accels = Accels::GetInstance(getObjectManager());
-            Q_ASSERT(accels);
-            Accels::DataFields accelsData = accels->getData();
-            accel_accum_x.append(accelsData.x);
-            accel_accum_y.append(accelsData.y);
-            accel_accum_z.append(accelsData.z);
-        } else if( obj->getObjID() == Magnetometer::OBJID ) {
-            qDebug() << "Mag";
-            Magnetometer * mag = Magnetometer::GetInstance(getObjectManager());
-            Q_ASSERT(mag);
-            Magnetometer::DataFields magData = mag->getData();
-            mag_accum_x.append(magData.x);
-            mag_accum_y.append(magData.y);
-            mag_accum_z.append(magData.z);
-        } else {
-            Q_ASSERT(0);
-        }
+    if (!success) {
+        m_ui->sixPointsSave->setEnabled(true);
+        m_ui->sixPointCalibInstructions->append("Timed out before receiving enough updates, click save position to retry...");
+        return;
     }
 
-    if(accel_accum_x.size() >= 20 && mag_accum_x.size() >= 20 && collectingData == true) {
-        collectingData = false;
+    m_ui->sixPointsSave->setEnabled(true);
 
-        Accels * accels = Accels::GetInstance(getObjectManager());
-        Q_ASSERT(accels);
-        Magnetometer * mag = Magnetometer::GetInstance(getObjectManager());
-        Q_ASSERT(mag);
-        disconnect(accels,SIGNAL(objectUpdated(UAVObject*)),this,SLOT(sensorsUpdated(UAVObject*)));
-        disconnect(mag,SIGNAL(objectUpdated(UAVObject*)),this,SLOT(sensorsUpdated(UAVObject*)));
-
-        m_ui->sixPointsSave->setEnabled(true);
+    accel_data[position] = sixPointCapture.mean(Accels::GetInstance(getObjectManager()));
+    mag_data[position] = sixPointCapture.mean(Magnetometer::GetInstance(getObjectManager()));
 
-        accel_data_x[position] = listMean(accel_accum_x);
-        accel_data_y[position] = listMean(accel_accum_y);
-        accel_data_z[position] = listMean(accel_accum_z);
-        mag_data_x[position] = listMean(mag_accum_x);
-        mag_data_y[position] = listMean(mag_accum_y);
-        mag_data_z[position] = listMean(mag_accum_z);
-
-        position = (position + 1) % 6;
-        if(position == 1) {
-            m_ui->sixPointCalibInstructions->append("Place with left side down and click save position...");
-            displayPlane("plane-left");
-        }
-        if(position == 2) {
-            m_ui->sixPointCalibInstructions->append("Place upside down and click save position...");
-            displayPlane("plane-flip");
-        }
-        if(position == 3) {
-            m_ui->sixPointCalibInstructions->append("Place with right side down and click save position...");
-            displayPlane("plane-right");
-        }
-        if(position == 4) {
-            m_ui->sixPointCalibInstructions->append("Place with nose up and click save position...");
-            displayPlane("plane-up");
-        }
-        if(position == 5) {
-            m_ui->sixPointCalibInstructions->append("Place with nose down and click save position...");
-            displayPlane("plane-down");
-        }
-        if(position == 0) {
-            computeScaleBias();
-            m_ui->sixPointsStart->setEnabled(true);
-            m_ui->sixPointsSave->setEnabled(false);
-
-            /* Cleanup original settings */
-            accels->setMetadata(initialMdata);
-            mag->setMetadata(initialMdata);
-        }
+    position = (position + 1) % 6;
+    if(position == 1) {
+        m_ui->sixPointCalibInstructions->append("Place with left side down and click save position...");
+        displayPlane("plane-left");
+    }
+    if(position == 2) {
+        m_ui->sixPointCalibInstructions->append("Place upside down and click save position...");
+        displayPlane("plane-flip");
+    }
+    if(position == 3) {
+        m_ui->sixPointCalibInstructions->append("Place with right side down and click save position...");
+        displayPlane("plane-right");
+    }
+    if(position == 4) {
+        m_ui->sixPointCalibInstructions->append("Place with nose up and click save position...");
+        displayPlane("plane-up");
+    }
+    if(position == 5) {
+        m_ui->sixPointCalibInstructions->append("Place with nose down and click save position...");
+        displayPlane("plane-down");
+    }
+    if(position == 0) {
+        m_ui->sixPointsSave->setEnabled(false);
+        computeScaleBias();
     }
 }
 
@@ -440,163 +395,68 @@ void ConfigRevoWidget::sensorsUpdated(UAVObject * obj)
   */
 void ConfigRevoWidget::savePositionData()
 {    
-    QMutexLocker lock(&attitudeRawUpdateLock);
     m_ui->sixPointsSave->setEnabled(false);
 
-    accel_accum_x.clear();
-    accel_accum_y.clear();
-    accel_accum_z.clear();
-    mag_accum_x.clear();
-    mag_accum_y.clear();
-    mag_accum_z.clear();
-    gyro_accum_x.clear();
-    gyro_accum_y.clear();
-    gyro_accum_z.clear();
-
-    collectingData = true;
-
-    Accels * accels = Accels::GetInstance(getObjectManager());
-    Q_ASSERT(accels);
-    Magnetometer * mag = Magnetometer::GetInstance(getObjectManager());
-    Q_ASSERT(mag);
-
-    connect(accels, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(sensorsUpdated(UAVObject*)));
-    connect(mag, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(sensorsUpdated(UAVObject*)));
+    sixPointCapture.start(SIX_POINT_SAMPLES, CAPTURE_PERIOD_MS,
+                          SIX_POINT_SAMPLES * CAPTURE_PERIOD_MS * 3 + 2000);
 
     m_ui->sixPointCalibInstructions->append("Hold...");
 }
 
-int LinearEquationsSolving(int nDim, double* pfMatr, double* pfVect, double* pfSolution)
+/**
+  * Fits accel and mag scale and bias to the six positions, run on a worker thread
+  */
+ConfigRevoWidget::ScaleBias ConfigRevoWidget::fitScaleBias(QVector<Vector3f> accelPoints, QVector<Vector3f> magPoints)
 {
- double fMaxElem;
- double fAcc;
-
- int i , j, k, m;
-
- for(k=0; k<(nDim-1); k++) // base row of matrix
- {
-   // search of line with max element
-   fMaxElem = fabs( pfMatr[k*nDim + k] );
-   m = k;
-   for(i=k+1; i<nDim; i++)
-   {
-     if(fMaxElem < fabs(pfMatr[i*nDim + k]) )
-     {
-       fMaxElem = pfMatr[i*nDim + k];
-       m = i;
-     }
-   }
-
-   // permutation of base line (index k) and max element line(index m)
-   if(m != k)
-   {
-     for(i=k; i<nDim; i++)
-     {
-       fAcc               = pfMatr[k*nDim + i];
-       pfMatr[k*nDim + i] = pfMatr[m*nDim + i];
-       pfMatr[m*nDim + i] = fAcc;
-     }
-     fAcc = pfVect[k];
-     pfVect[k] = pfVect[m];
-     pfVect[m] = fAcc;
-   }
-
-   if( pfMatr[k*nDim + k] == 0.) return 0; // needs improvement !!!
-
-   // triangulation of matrix with coefficients
-   for(j=(k+1); j<nDim; j++) // current row of matrix
-   {
-     fAcc = - pfMatr[j*nDim + k] / pfMatr[k*nDim + k];
-     for(i=k; i<nDim; i++)
-     {
-       pfMatr[j*nDim + i] = pfMatr[j*nDim + i] + fAcc*pfMatr[k*nDim + i];
-     }
-     pfVect[j] = pfVect[j] + fAcc*pfVect[k]; // free member recalculation
-   }
- }
-
- for(k=(nDim-1); k>=0; k--)
- {
-   pfSolution[k] = pfVect[k];
-   for(i=(k+1); i<nDim; i++)
-   {
-     pfSolution[k] -= (pfMatr[k*nDim + i]*pfSolution[i]);
-   }
-   pfSolution[k] = pfSolution[k] / pfMatr[k*nDim + k];
- }
-
- return 1;
-}
+    ScaleBias result;
+    Vector3f bias;
 
+    // openpilot_bias_scale returns the bias in scaled units, RevoCalibration
+    // wants it in raw units
+    openpilot_bias_scale(bias, result.accelScale, accelPoints.constData(), accelPoints.size(), Vector3f(0, 0, GRAVITY));
+    result.accelBias = bias.cwise() * result.accelScale;
 
-int SixPointInConstFieldCal( double ConstMag, double x[6], double y[6], double z[6], double S[3], double b[3] )
-{
- int i;
- double A[5][5];
- double f[5], c[5];
- double xp, yp, zp, Sx;
-
- // Fill in matrix A -
- // write six difference-in-magnitude equations of the form
- // Sx^2(x2^2-x1^2) + 2*Sx*bx*(x2-x1) + Sy^2(y2^2-y1^2) + 2*Sy*by*(y2-y1) + Sz^2(z2^2-z1^2) + 2*Sz*bz*(z2-z1) = 0
- // or in other words
- // 2*Sx*bx*(x2-x1)/Sx^2  + Sy^2(y2^2-y1^2)/Sx^2  + 2*Sy*by*(y2-y1)/Sx^2  + Sz^2(z2^2-z1^2)/Sx^2  + 2*Sz*bz*(z2-z1)/Sx^2  = (x1^2-x2^2)
- for (i=0;i<5;i++){
-     A[i][0] = 2.0 * (x[i+1] - x[i]);
-     A[i][1] = y[i+1]*y[i+1] - y[i]*y[i];
-     A[i][2] = 2.0 * (y[i+1] - y[i]);
-     A[i][3] = z[i+1]*z[i+1] - z[i]*z[i];
-     A[i][4] = 2.0 * (z[i+1] - z[i]);
-     f[i]    = x[i]*x[i] - x[i+1]*x[i+1];
- }
-
- // solve for c0=bx/Sx, c1=Sy^2/Sx^2; c2=Sy*by/Sx^2, c3=Sz^2/Sx^2, c4=Sz*bz/Sx^2
- if (  !LinearEquationsSolving( 5, (double *)A, f, c) ) return 0;
-
- // use one magnitude equation and c's to find Sx - doesn't matter which - all give the same answer
- xp = x[0]; yp = y[0]; zp = z[0];
- Sx = sqrt(ConstMag*ConstMag / (xp*xp + 2*c[0]*xp + c[0]*c[0] + c[1]*yp*yp + 2*c[2]*yp + c[2]*c[2]/c[1] + c[3]*zp*zp + 2*c[4]*zp + c[4]*c[4]/c[3]));
-
- S[0] = Sx;
- b[0] = Sx*c[0];
- S[1] = sqrt(c[1]*Sx*Sx);
- b[1] = c[2]*Sx*Sx/S[1];
- S[2] = sqrt(c[3]*Sx*Sx);
- b[2] = c[4]*Sx*Sx/S[2];
-
- return 1;
+    openpilot_bias_scale(bias, result.magScale, magPoints.constData(), magPoints.size(), Vector3f(0, 0, 1000));
+    result.magBias = bias.cwise() * result.magScale;
+
+    return result;
 }
 
 void ConfigRevoWidget::computeScaleBias()
 {
-   double S[3], b[3];
+    m_ui->sixPointCalibInstructions->append("Computing scale and bias...");
+    scaleBiasWatcher.setFuture(QtConcurrent::run(&ConfigRevoWidget::fitScaleBias, accel_data, mag_data));
+}
+
+void ConfigRevoWidget::scaleBiasComputed()
+{
+   ScaleBias fit = scaleBiasWatcher.result();
    RevoCalibration * revoCalibration = RevoCalibration::GetInstance(getObjectManager());
    Q_ASSERT(revoCalibration);
    RevoCalibration::DataFields revoCalibrationData = revoCalibration->getData();
 
    // Calibration accel
-   SixPointInConstFieldCal( GRAVITY, accel_data_x, accel_data_y, accel_data_z, S, b);
-   revoCalibrationData.accel_scale[RevoCalibration::ACCEL_SCALE_X] = fabs(S[0]);
-   revoCalibrationData.accel_scale[RevoCalibration::ACCEL_SCALE_Y] = fabs(S[1]);
-   revoCalibrationData.accel_scale[RevoCalibration::ACCEL_SCALE_Z] = fabs(S[2]);
+   revoCalibrationData.accel_scale[RevoCalibration::ACCEL_SCALE_X] = fit.accelScale.x();
+   revoCalibrationData.accel_scale[RevoCalibration::ACCEL_SCALE_Y] = fit.accelScale.y();
+   revoCalibrationData.accel_scale[RevoCalibration::ACCEL_SCALE_Z] = fit.accelScale.z();
 
-   revoCalibrationData.accel_bias[RevoCalibration::ACCEL_BIAS_X] = -sign(S[0]) * b[0];
-   revoCalibrationData.accel_bias[RevoCalibration::ACCEL_BIAS_Y] = -sign(S[1]) * b[1];
-   revoCalibrationData.accel_bias[RevoCalibration::ACCEL_BIAS_Z] = -sign(S[2]) * b[2];
+   revoCalibrationData.accel_bias[RevoCalibration::ACCEL_BIAS_X] = fit.accelBias.x();
+   revoCalibrationData.accel_bias[RevoCalibration::ACCEL_BIAS_Y] = fit.accelBias.y();
+   revoCalibrationData.accel_bias[RevoCalibration::ACCEL_BIAS_Z] = fit.accelBias.z();
 
    // Calibration mag
-   SixPointInConstFieldCal( 1000, mag_data_x, mag_data_y, mag_data_z, S, b);
-   revoCalibrationData.mag_scale[RevoCalibration::MAG_SCALE_X] = fabs(S[0]);
-   revoCalibrationData.mag_scale[RevoCalibration::MAG_SCALE_Y] = fabs(S[1]);
-   revoCalibrationData.mag_scale[RevoCalibration::MAG_SCALE_Z] = fabs(S[2]);
+   revoCalibrationData.mag_scale[RevoCalibration::MAG_SCALE_X] = fit.magScale.x();
+   revoCalibrationData.mag_scale[RevoCalibration::MAG_SCALE_Y] = fit.magScale.y();
+   revoCalibrationData.mag_scale[RevoCalibration::MAG_SCALE_Z] = fit.magScale.z();
 
-   revoCalibrationData.mag_bias[RevoCalibration::MAG_BIAS_X] = -sign(S[0]) * b[0];
-   revoCalibrationData.mag_bias[RevoCalibration::MAG_BIAS_Y] = -sign(S[1]) * b[1];
-   revoCalibrationData.mag_bias[RevoCalibration::MAG_BIAS_Z] = -sign(S[2]) * b[2];
+   revoCalibrationData.mag_bias[RevoCalibration::MAG_BIAS_X] = fit.magBias.x();
+   revoCalibrationData.mag_bias[RevoCalibration::MAG_BIAS_Y] = fit.magBias.y();
+   revoCalibrationData.mag_bias[RevoCalibration::MAG_BIAS_Z] = fit.magBias.z();
 
    revoCalibration->setData(revoCalibrationData);
 
    position = -1; //set to run again
+   m_ui->sixPointsStart->setEnabled(true);
    m_ui->sixPointCalibInstructions->append("Computed accel and mag scale and bias...");
 
 }
@@ -630,33 +490,6 @@ void ConfigRevoWidget::sixPointCalibrationMode()
 
    Thread::usleep(100000);
 
-   gyro_accum_x.clear();
-   gyro_accum_y.clear();
-   gyro_accum_z.clear();
-   accel_accum_x.clear();
-   accel_accum_y.clear();
-   accel_accum_z.clear();
-   mag_accum_x.clear();
-   mag_accum_y.clear();
-   mag_accum_z.clear();
-
-   /* Need to get as many accel and mag updates as possible */
-   Accels * accels = Accels::GetInstance(getObjectManager());
-   Q_ASSERT(accels);
-   Magnetometer * mag = Magnetometer::GetInstance(getObjectManager());
-   Q_ASSERT(mag);
-
-   initialMdata = accels->getMetadata();
-   UAVObject::Metadata mdata = initialMdata;
-   UAVObject::SetFlightTelemetryUpdateMode(mdata, UAVObject::UPDATEMODE_PERIODIC);
-   mdata.flightTelemetryUpdatePeriod = 100;
-   accels->setMetadata(mdata);
-
-   mdata = mag->getMetadata();
-   UAVObject::SetFlightTelemetryUpdateMode(mdata, UAVObject::UPDATEMODE_PERIODIC);
-   mdata.flightTelemetryUpdatePeriod = 100;
-   mag->setMetadata(mdata);
-
    /* Show instructions and enable controls */
    m_ui->sixPointCalibInstructions->clear();
    m_ui->sixPointCalibInstructions->append("Place horizontally and click save position...");
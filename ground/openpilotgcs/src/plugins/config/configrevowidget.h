@@ -34,12 +34,13 @@
 #include "extensionsystem/pluginmanager.h"
 #include "uavobjectmanager.h"
 #include "uavobject.h"
+#include "calibrationcapture.h"
 #include <QtGui/QWidget>
 #include <QtSvg/QSvgRenderer>
 #include <QtSvg/QGraphicsSvgItem>
 #include <QList>
 #include <QTimer>
-#include <QMutex>
+#include <QFutureWatcher>
 
 class Ui_Widget;
 
@@ -52,6 +53,14 @@ public:
     ~ConfigRevoWidget();
     
 private:
+    struct ScaleBias {
+        Eigen::Vector3f accelScale;
+        Eigen::Vector3f accelBias;
+        Eigen::Vector3f magScale;
+        Eigen::Vector3f magBias;
+    };
+
+    static ScaleBias fitScaleBias(QVector<Eigen::Vector3f> accelPoints, QVector<Eigen::Vector3f> magPoints);
     void drawVariancesGraph();
     void displayPlane(QString elementID);
     virtual void enableControls(bool enable);
@@ -68,7 +77,6 @@ private:
     QGraphicsSvgItem *mag_x;
     QGraphicsSvgItem *mag_y;
     QGraphicsSvgItem *mag_z;
-    QMutex attitudeRawUpdateLock;
     double maxBarHeight;
     int phaseCounter;
     int progressBarIndex;
@@ -76,22 +84,13 @@ private:
     const static double maxVarValue;
     const static int calibrationDelay = 10;
 
-    bool collectingData;
-
-    QList<double> gyro_accum_x;
-    QList<double> gyro_accum_y;
-    QList<double> gyro_accum_z;
-    QList<double> accel_accum_x;
-    QList<double> accel_accum_y;
-    QList<double> accel_accum_z;
-    QList<double> mag_accum_x;
-    QList<double> mag_accum_y;
-    QList<double> mag_accum_z;
+    CalibrationCapture accelBiasCapture;
+    CalibrationCapture sixPointCapture;
+    QFutureWatcher<ScaleBias> scaleBiasWatcher;
 
-    double accel_data_x[6], accel_data_y[6], accel_data_z[6];
-    double mag_data_x[6], mag_data_y[6], mag_data_z[6];
+    QVector<Eigen::Vector3f> accel_data;
+    QVector<Eigen::Vector3f> mag_data;
 
-    UAVObject::Metadata initialMdata;
     int position;
 
 private slots:
@@ -105,9 +104,10 @@ private slots:
     void SettingsToFlash();
     void savePositionData();
     void computeScaleBias();
+    void scaleBiasComputed();
     void sixPointCalibrationMode();
-    void sensorsUpdated(UAVObject * obj);
-    void accelBiasattitudeRawUpdated(UAVObject*);
+    void positionCaptured(bool success);
+    void accelBiasCaptured(bool success);
 
 protected:
     void showEvent(QShowEvent *event);
@@ -26,6 +26,7 @@
  */
 #include <calibration.h>
 #include <Eigen/LU>
+#include <Eigen/Cholesky>
 
 /**
  * The basic calibration algorithm initially used in OpenPilot. This is a basic
@@ -44,8 +45,10 @@
  *
  * @param bias[out] The computed bias of the sensor
  * @param scale[out] The computed scale factor of the sensor
- * @param samples An array of sample data points.  Only the first 6 are
- * 	used.
+ * @param samples An array of sample data points, typically the mean of the
+ * 	captured samples in each of the six orientations.  Every pair of points
+ * 	gives one equation, more than 6 points are fitted in the least squares
+ * 	sense.
  * @param n_samples The number of sample data points.  Must be at least 6.
  * @param referenceField The field being measured by the sensor.
  */
@@ -75,18 +78,34 @@ openpilot_bias_scale(Vector3f& bias,
 	// 2*Sx*bx*(x2-x1)/Sx^2  + Sy^2(y2^2-y1^2)/Sx^2  +
 	// 2*Sy*by*(y2-y1)/Sx^2  + Sz^2(z2^2-z1^2)/Sx^2  + 2*Sz*bz*(z2-z1)/Sx^2  =
 	// 	 (x1^2-x2^2)
-	Matrix<float, 5, 5> A;
-	Matrix<float, 5, 1> f;
-	for (unsigned i=0; i<5; i++){
-		A.row(i)[0] = 2.0 * (samples[i+1].x() - samples[i].x());
-		A.row(i)[1] = samples[i+1].y()* samples[i+1].y() - samples[i].y()*samples[i].y();
-		A.row(i)[2] = 2.0 * (samples[i+1].y() - samples[i].y());
-		A.row(i)[3] = samples[i+1].z()*samples[i+1].z() - samples[i].z()*samples[i].z();
-		A.row(i)[4] = 2.0 * (samples[i+1].z() - samples[i].z());
-		f[i]    = samples[i].x()*samples[i].x() - samples[i+1].x()*samples[i+1].x();
+	//
+	// Using every pair instead of only consecutive points averages the
+	// noise of all orientations into the fit.  The normal equations are
+	// accumulated in double, so the size of the system stays 5x5.
+	Matrix<double, 5, 5> AtA = Matrix<double, 5, 5>::Zero();
+	Matrix<double, 5, 1> Atf = Matrix<double, 5, 1>::Zero();
+	for (size_t i = 0; i < n_samples; i++) {
+		Vector3d p = samples[i].cast<double>();
+		for (size_t j = i + 1; j < n_samples; j++) {
+			Vector3d q = samples[j].cast<double>();
+			Matrix<double, 5, 1> row;
+			row << 2.0 * (q.x() - p.x()),
+				q.y()*q.y() - p.y()*p.y(),
+				2.0 * (q.y() - p.y()),
+				q.z()*q.z() - p.z()*p.z(),
+				2.0 * (q.z() - p.z());
+			double f = p.x()*p.x() - q.x()*q.x();
+			AtA += row * row.transpose();
+			Atf += row * f;
+		}
+	}
+	Matrix<double, 5, 1> solution;
+	if (!AtA.ldlt().solve(Atf, &solution)) {
+		bias = Vector3f::Zero();
+		scale = Vector3f::Zero();
+		return;
 	}
-	Matrix<float, 5, 1> c;
-	A.lu().solve(f, &c);
+	Matrix<float, 5, 1> c = solution.cast<float>();
 
 
 	// use one magnitude equation and c's to find Sx - doesn't matter which - all give the same answer
@@ -48,7 +48,8 @@ ConnectionManager::ConnectionManager(Internal::MainWindow *mainWindow, QTabWidge
     m_connectBtn(0),
     m_ioDev(NULL),
     polling(true),
-    m_mainWindow(mainWindow)
+    m_mainWindow(mainWindow),
+    reconnectPending(false)
 {
     QHBoxLayout *layout = new QHBoxLayout;
     layout->setSpacing(5);
@@ -74,12 +75,6 @@ ConnectionManager::ConnectionManager(Internal::MainWindow *mainWindow, QTabWidge
     modeStack->setCornerWidget(this, Qt::TopRightCorner);
 
     QObject::connect(m_connectBtn, SIGNAL(clicked()), this, SLOT(onConnectClicked()));
-
-    // setup our reconnect timers
-    reconnect = new QTimer(this);
-    reconnectCheck = new QTimer(this);
-    connect(reconnect,SIGNAL(timeout()),this,SLOT(reconnectSlot()));
-    connect(reconnectCheck,SIGNAL(timeout()),this,SLOT(reconnectCheckSlot()));
 }
 
 ConnectionManager::~ConnectionManager()
@@ -154,11 +149,7 @@ bool ConnectionManager::disconnectDevice()
 
     // We are connected - disconnect from the device
 
-    // stop our timers
-    if(reconnect->isActive())
-        reconnect->stop();
-    if(reconnectCheck->isActive())
-        reconnectCheck->stop();
+    reconnectPending = false;
 
     // signal interested plugins that user is disconnecting his device
     emit deviceAboutToDisconnect();
@@ -250,8 +241,7 @@ void ConnectionManager::telemetryConnected()
 {
     qDebug() << "TelemetryMonitor: connected";
 
-    if(reconnectCheck->isActive())
-        reconnectCheck->stop();
+    reconnectPending = false;
 
     //tell the monitor we're connected
     m_monitorWidget->connect();
@@ -266,8 +256,9 @@ void ConnectionManager::telemetryDisconnected()
 
     if (m_ioDev){
         if(m_connectionDevice.connection->shortName()=="Serial") {
-            if(!reconnect->isActive())
-                reconnect->start(1000);
+            // try once now, then again whenever the serial ports change
+            reconnectPending = true;
+            reconnectSlot();
         }
     }
 
@@ -283,27 +274,26 @@ void ConnectionManager::telemetryUpdated(double txRate, double rxRate)
     m_monitorWidget->updateTelemetry(txRate, rxRate);
 }
 
+/**
+*   Slot called when the telemetry round trip times are updated
+*/
+void ConnectionManager::telemetryLatencyUpdated(int medianMs, int p95Ms, int maxMs)
+{
+    m_monitorWidget->updateLatency(medianMs, p95Ms, maxMs);
+}
+
 void ConnectionManager::reconnectSlot()
 {
     qDebug()<<"reconnect";
     if(m_ioDev->isOpen())
         m_ioDev->close();
 
-    if(m_ioDev->open(QIODevice::ReadWrite)) {
+    if(m_ioDev->open(QIODevice::ReadWrite))
         qDebug()<<"reconnect successfull";
-        reconnect->stop();
-        reconnectCheck->start(20000);
-    }
     else
         qDebug()<<"reconnect NOT successfull";
 }
 
-void ConnectionManager::reconnectCheckSlot()
-{
-    reconnectCheck->stop();
-    reconnect->start(1000);
-}
-
 /**
 *   Find a device by its displayed (visible on screen) name
 */
@@ -429,6 +419,10 @@ void ConnectionManager::devChanged(IConnection *connection)
     //remove registered devices of this IConnection from the list
     updateConnectionList(connection);
 
+    //the port we lost telemetry on may be back
+    if (reconnectPending && m_ioDev && m_connectionDevice.connection == connection)
+        reconnectSlot();
+
     updateConnectionDropdown();
 
     qDebug() << "# devices " << m_devList.count();
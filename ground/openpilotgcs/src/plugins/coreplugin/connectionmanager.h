@@ -119,6 +119,7 @@ public slots:
     void telemetryConnected();
     void telemetryDisconnected();
     void telemetryUpdated(double txRate, double rxRate);
+    void telemetryLatencyUpdated(int medianMs, int p95Ms, int maxMs);
 
 private slots:
     void objectAdded(QObject *obj);
@@ -130,7 +131,6 @@ private slots:
     void onConnectionDestroyed(QObject *obj);
     void connectionsCallBack(); //used to call devChange after all the plugins are loaded
     void reconnectSlot();
-    void reconnectCheckSlot();
 
 protected:
     QComboBox *m_availableDevList;
@@ -152,8 +152,8 @@ private:
     bool polling;
     Internal::MainWindow *m_mainWindow;
     QList <IConnection *> connectionBackup;
-    QTimer *reconnect;
-    QTimer *reconnectCheck;
+    // the serial link is reopened when its connection reports a device change
+    bool reconnectPending;
 
 };
 
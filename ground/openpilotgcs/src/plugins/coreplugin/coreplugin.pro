@@ -61,6 +61,7 @@ SOURCES += mainwindow.cpp \
     uavgadgetoptionspagedecorator.cpp \
     uavgadgetdecorator.cpp \
     workspacesettings.cpp \
+    memoryusagepage.cpp \
     uavconfiginfo.cpp \
     authorsdialog.cpp \
     telemetrymonitorwidget.cpp \
@@ -97,6 +98,7 @@ HEADERS += mainwindow.h \
     iversioncontrol.h \
     iview.h \
     icorelistener.h \
+    imemoryreporter.h \
     versiondialog.h \
     core_global.h \
     basemode.h \
@@ -122,6 +124,7 @@ HEADERS += mainwindow.h \
     uavgadgetoptionspagedecorator.h \
     uavgadgetdecorator.h \
     workspacesettings.h \
+    memoryusagepage.h \
     uavconfiginfo.h \
     authorsdialog.h \
     iconfigurableplugin.h \
@@ -49,6 +49,8 @@ GeneralSettings::GeneralSettings():
     m_autoConnect(true),
     m_autoSelect(true),
     m_useUDPMirror(false),
+    m_useTelemetryThread(true),
+    m_adaptTelemetryRates(false),
     m_useExpertMode(false)
 {
 }
@@ -120,6 +122,8 @@ QWidget *GeneralSettings::createPage(QWidget *parent)
     m_page->checkAutoConnect->setChecked(m_autoConnect);
     m_page->checkAutoSelect->setChecked(m_autoSelect);
     m_page->cbUseUDPMirror->setChecked(m_useUDPMirror);
+    m_page->cbTelemetryThread->setChecked(m_useTelemetryThread);
+    m_page->cbAdaptTelemetryRates->setChecked(m_adaptTelemetryRates);
     m_page->cbExpertMode->setChecked(m_useExpertMode);
     m_page->colorButton->setColor(StyleHelper::baseColor());
 
@@ -138,6 +142,8 @@ void GeneralSettings::apply()
 
     m_saveSettingsOnExit = m_page->checkBoxSaveOnExit->isChecked();
     m_useUDPMirror=m_page->cbUseUDPMirror->isChecked();
+    m_useTelemetryThread=m_page->cbTelemetryThread->isChecked();
+    m_adaptTelemetryRates=m_page->cbAdaptTelemetryRates->isChecked();
     m_useExpertMode=m_page->cbExpertMode->isChecked();
     m_autoConnect = m_page->checkAutoConnect->isChecked();
     m_autoSelect = m_page->checkAutoSelect->isChecked();
@@ -156,6 +162,8 @@ void GeneralSettings::readSettings(QSettings* qs)
     m_autoConnect = qs->value(QLatin1String("AutoConnect"),m_autoConnect).toBool();
     m_autoSelect = qs->value(QLatin1String("AutoSelect"),m_autoSelect).toBool();
     m_useUDPMirror = qs->value(QLatin1String("UDPMirror"),m_useUDPMirror).toBool();
+    m_useTelemetryThread = qs->value(QLatin1String("TelemetryThread"),m_useTelemetryThread).toBool();
+    m_adaptTelemetryRates = qs->value(QLatin1String("AdaptTelemetryRates"),m_adaptTelemetryRates).toBool();
     m_useExpertMode = qs->value(QLatin1String("ExpertMode"),m_useExpertMode).toBool();
     qs->endGroup();
 }
@@ -173,6 +181,8 @@ void GeneralSettings::saveSettings(QSettings* qs)
     qs->setValue(QLatin1String("AutoConnect"), m_autoConnect);
     qs->setValue(QLatin1String("AutoSelect"), m_autoSelect);
     qs->setValue(QLatin1String("UDPMirror"), m_useUDPMirror);
+    qs->setValue(QLatin1String("TelemetryThread"), m_useTelemetryThread);
+    qs->setValue(QLatin1String("AdaptTelemetryRates"), m_adaptTelemetryRates);
     qs->setValue(QLatin1String("ExpertMode"), m_useExpertMode);
     qs->endGroup();
 }
@@ -244,6 +254,16 @@ bool GeneralSettings::useUDPMirror() const
     return m_useUDPMirror;
 }
 
+bool GeneralSettings::useTelemetryThread() const
+{
+    return m_useTelemetryThread;
+}
+
+bool GeneralSettings::adaptTelemetryRates() const
+{
+    return m_adaptTelemetryRates;
+}
+
 bool GeneralSettings::useExpertMode() const
 {
     return m_useExpertMode;
@@ -0,0 +1,77 @@
+/**
+ ******************************************************************************
+ *
+ * @file       imemoryreporter.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup CorePlugin Core Plugin
+ * @{
+ * @brief The Core GCS plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify 
+ * it under the terms of the GNU General Public License as published by 
+ * the Free Software Foundation; either version 3 of the License, or 
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License 
+ * for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along 
+ * with this program; if not, write to the Free Software Foundation, Inc., 
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef IMEMORYREPORTER_H
+#define IMEMORYREPORTER_H
+
+#include "core_global.h"
+#include <QtCore/QObject>
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+namespace Core {
+/*!
+  \class Core::IMemoryReporter
+
+  \brief Reports how much memory the large containers of a plugin hold, the
+totals are shown on the Memory Usage options page.
+
+  Guidelines for implementing:
+  \list
+  \o Return one Usage per kind of container. The page adds up the usages with
+     the same group and name, so every instance of a gadget can register its
+     own reporter.
+  \o The bytes are an estimate of the heap held by the container, counted from
+     its sizes and capacities. Do not walk memory another thread changes
+     without taking its lock, memoryUsage() is called in the GUI thread.
+  \o You need to add your implementing object to the plugin managers objects:
+     ExtensionSystem::PluginManager::instance()->addObject(yourImplementingObject);
+  \o Don't forget to remove the object again at deconstruction.
+*/
+class CORE_EXPORT IMemoryReporter : public QObject
+{
+    Q_OBJECT
+public:
+    struct Usage {
+        Usage(const QString &name = QString(), qint64 items = 0, qint64 bytes = 0) :
+            name(name), items(items), bytes(bytes) {}
+        QString name;
+        qint64 items;
+        qint64 bytes;
+    };
+
+    IMemoryReporter(QObject *parent = 0) : QObject(parent) {}
+    virtual ~IMemoryReporter() {}
+
+    // Plugin the usages are listed under
+    virtual QString memoryGroup() const = 0;
+    virtual QList<Usage> memoryUsage() const = 0;
+};
+
+} // namespace Core
+
+#endif // IMEMORYREPORTER_H
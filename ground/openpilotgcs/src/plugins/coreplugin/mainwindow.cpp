@@ -46,6 +46,7 @@
 #include "uavgadgetmanager.h"
 #include "uavgadgetinstancemanager.h"
 #include "workspacesettings.h"
+#include "memoryusagepage.h"
 
 #include "authorsdialog.h"
 #include "baseview.h"
@@ -121,6 +122,7 @@ MainWindow::MainWindow() :
     m_generalSettings(new GeneralSettings),
     m_shortcutSettings(new ShortcutSettings),
     m_workspaceSettings(new WorkspaceSettings),
+    m_memoryUsagePage(new MemoryUsagePage),
     m_focusToEditor(0),
     m_newAction(0),
     m_openAction(0),
@@ -220,6 +222,7 @@ MainWindow::~MainWindow()
     pm->removeObject(m_shortcutSettings);
     pm->removeObject(m_generalSettings);
     pm->removeObject(m_workspaceSettings);
+    pm->removeObject(m_memoryUsagePage);
     delete m_messageManager;
     m_messageManager = 0;
     delete m_shortcutSettings;
@@ -228,6 +231,8 @@ MainWindow::~MainWindow()
     m_generalSettings = 0;
     delete m_workspaceSettings;
     m_workspaceSettings = 0;
+    delete m_memoryUsagePage;
+    m_memoryUsagePage = 0;
     delete m_settings;
     m_settings = 0;
     delete m_uniqueIDManager;
@@ -255,6 +260,7 @@ bool MainWindow::init(QString *errorMessage)
     pm->addObject(m_generalSettings);
     pm->addObject(m_shortcutSettings);
     pm->addObject(m_workspaceSettings);
+    pm->addObject(m_memoryUsagePage);
 
     return true;
 }
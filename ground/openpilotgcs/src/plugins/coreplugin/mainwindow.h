@@ -74,6 +74,7 @@ class FancyTabWidget;
 class GeneralSettings;
 class ShortcutSettings;
 class WorkspaceSettings;
+class MemoryUsagePage;
 class VersionDialog;
 class AuthorsDialog;
 
@@ -201,6 +202,7 @@ private:
     GeneralSettings *m_generalSettings;
     ShortcutSettings *m_shortcutSettings;
     WorkspaceSettings *m_workspaceSettings;
+    MemoryUsagePage *m_memoryUsagePage;
 
     // actions
     QShortcut *m_focusToEditor;
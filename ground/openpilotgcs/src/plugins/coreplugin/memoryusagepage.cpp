@@ -0,0 +1,196 @@
+/**
+ ******************************************************************************
+ *
+ * @file       memoryusagepage.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup CorePlugin Core Plugin
+ * @{
+ * @brief The Core GCS plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify 
+ * it under the terms of the GNU General Public License as published by 
+ * the Free Software Foundation; either version 3 of the License, or 
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License 
+ * for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along 
+ * with this program; if not, write to the Free Software Foundation, Inc., 
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "memoryusagepage.h"
+#include "imemoryreporter.h"
+#include <extensionsystem/pluginmanager.h>
+#include <QtCore/QFile>
+#include <QtCore/QMap>
+#include <QtGui/QHeaderView>
+#include <QtGui/QLabel>
+#include <QtGui/QPushButton>
+#include <QtGui/QTreeWidget>
+#include <QtGui/QVBoxLayout>
+#include <QtGui/QHBoxLayout>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+using namespace Core;
+using namespace Core::Internal;
+
+MemoryUsagePage::MemoryUsagePage(QObject *parent) :
+        IOptionsPage(parent),
+        m_tree(0),
+        m_totalLabel(0)
+{
+}
+
+MemoryUsagePage::~MemoryUsagePage()
+{
+}
+
+// IOptionsPage
+
+QString MemoryUsagePage::id() const
+{
+    return QLatin1String("MemoryUsage");
+}
+
+QString MemoryUsagePage::trName() const
+{
+    return tr("Memory Usage");
+}
+
+QString MemoryUsagePage::category() const
+{
+    return QLatin1String("GCS");
+}
+
+QString MemoryUsagePage::trCategory() const
+{
+    return tr("GCS");
+}
+
+QWidget *MemoryUsagePage::createPage(QWidget *parent)
+{
+    QWidget *w = new QWidget(parent);
+    QVBoxLayout *layout = new QVBoxLayout(w);
+
+    m_tree = new QTreeWidget(w);
+    m_tree->setColumnCount(3);
+    m_tree->setHeaderLabels(QStringList() << tr("Container") << tr("Items") << tr("Size"));
+    m_tree->setRootIsDecorated(true);
+    m_tree->setAlternatingRowColors(true);
+    m_tree->header()->setResizeMode(0, QHeaderView::Stretch);
+    m_tree->header()->setStretchLastSection(false);
+    layout->addWidget(m_tree);
+
+    QHBoxLayout *bottom = new QHBoxLayout();
+    m_totalLabel = new QLabel(w);
+    bottom->addWidget(m_totalLabel, 1);
+    QPushButton *refreshButton = new QPushButton(tr("Refresh"), w);
+    connect(refreshButton, SIGNAL(clicked()), this, SLOT(refresh()));
+    bottom->addWidget(refreshButton);
+    layout->addLayout(bottom);
+
+    refresh();
+    return w;
+}
+
+void MemoryUsagePage::apply()
+{
+}
+
+void MemoryUsagePage::finish()
+{
+    m_tree = 0;
+    m_totalLabel = 0;
+}
+
+/**
+ * Asks every reporter again, usages with the same group and name are
+ * added up so the instances of a gadget show as one line.
+ */
+void MemoryUsagePage::refresh()
+{
+    if (!m_tree)
+        return;
+
+    typedef QMap<QString, IMemoryReporter::Usage> UsageMap;
+    QMap<QString, UsageMap> groups;
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    foreach (IMemoryReporter *reporter, pm->getObjects<IMemoryReporter>()) {
+        UsageMap &group = groups[reporter->memoryGroup()];
+        foreach (const IMemoryReporter::Usage &usage, reporter->memoryUsage()) {
+            IMemoryReporter::Usage &sum = group[usage.name];
+            sum.name = usage.name;
+            sum.items += usage.items;
+            sum.bytes += usage.bytes;
+        }
+    }
+
+    m_tree->clear();
+    qint64 total = 0;
+    QMapIterator<QString, UsageMap> g(groups);
+    while (g.hasNext()) {
+        g.next();
+        QTreeWidgetItem *groupItem = new QTreeWidgetItem(m_tree);
+        groupItem->setText(0, g.key());
+        qint64 groupBytes = 0;
+        foreach (const IMemoryReporter::Usage &usage, g.value()) {
+            QTreeWidgetItem *item = new QTreeWidgetItem(groupItem);
+            item->setText(0, usage.name);
+            item->setText(1, QString::number(usage.items));
+            item->setText(2, formatBytes(usage.bytes));
+            item->setTextAlignment(1, Qt::AlignRight | Qt::AlignVCenter);
+            item->setTextAlignment(2, Qt::AlignRight | Qt::AlignVCenter);
+            groupBytes += usage.bytes;
+        }
+        groupItem->setText(2, formatBytes(groupBytes));
+        groupItem->setTextAlignment(2, Qt::AlignRight | Qt::AlignVCenter);
+        total += groupBytes;
+    }
+    m_tree->expandAll();
+    m_tree->resizeColumnToContents(1);
+    m_tree->resizeColumnToContents(2);
+
+    QString text = tr("Reported: %1").arg(formatBytes(total));
+    qint64 resident = residentBytes();
+    if (resident > 0)
+        text += tr(", process resident: %1").arg(formatBytes(resident));
+    m_totalLabel->setText(text);
+}
+
+QString MemoryUsagePage::formatBytes(qint64 bytes)
+{
+    if (bytes >= 10 * 1024 * 1024)
+        return tr("%1 MB").arg(bytes / (1024 * 1024));
+    if (bytes >= 10 * 1024)
+        return tr("%1 kB").arg(bytes / 1024);
+    return tr("%1 B").arg(bytes);
+}
+
+/**
+ * Resident set of the whole process, to see how much the reporters miss.
+ * Only known on Linux, 0 elsewhere.
+ */
+qint64 MemoryUsagePage::residentBytes()
+{
+#if defined(Q_OS_LINUX)
+    QFile statm(QLatin1String("/proc/self/statm"));
+    if (!statm.open(QIODevice::ReadOnly))
+        return 0;
+    QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2)
+        return 0;
+    return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,77 @@
+/**
+ ******************************************************************************
+ *
+ * @file       memoryusagepage.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup CorePlugin Core Plugin
+ * @{
+ * @brief The Core GCS plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify 
+ * it under the terms of the GNU General Public License as published by 
+ * the Free Software Foundation; either version 3 of the License, or 
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License 
+ * for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along 
+ * with this program; if not, write to the Free Software Foundation, Inc., 
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef MEMORYUSAGEPAGE_H
+#define MEMORYUSAGEPAGE_H
+
+#include <coreplugin/dialogs/ioptionspage.h>
+#include <QtCore/QObject>
+
+QT_BEGIN_NAMESPACE
+class QTreeWidget;
+class QLabel;
+QT_END_NAMESPACE
+
+namespace Core {
+namespace Internal {
+
+/**
+ * Read only page listing the memory reported by the IMemoryReporter objects
+ * in the plugin manager pool, grouped by plugin.
+ */
+class MemoryUsagePage : public IOptionsPage
+{
+Q_OBJECT
+public:
+    MemoryUsagePage(QObject *parent = 0);
+    ~MemoryUsagePage();
+
+    // IOptionsPage
+    QString id() const;
+    QString trName() const;
+    QString category() const;
+    QString trCategory() const;
+
+    QWidget *createPage(QWidget *parent);
+    void apply();
+    void finish();
+
+private slots:
+    void refresh();
+
+private:
+    static QString formatBytes(qint64 bytes);
+    static qint64 residentBytes();
+
+    QTreeWidget *m_tree;
+    QLabel *m_totalLabel;
+};
+
+} // namespace Internal
+} // namespace Core
+
+#endif // MEMORYUSAGEPAGE_H
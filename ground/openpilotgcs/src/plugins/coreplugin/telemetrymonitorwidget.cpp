@@ -70,6 +70,9 @@ TelemetryMonitorWidget::TelemetryMonitorWidget(QWidget *parent) : QGraphicsView(
     connected = false;
     txValue = 0.0;
     rxValue = 0.0;
+    latencyMedian = 0;
+    latencyP95 = 0;
+    latencyMax = 0;
 
     setMin(0.0);
     setMax(1200.0);
@@ -115,6 +118,20 @@ void TelemetryMonitorWidget::updateTelemetry(double txRate, double rxRate)
     showTelemetry();
 }
 
+/*!
+  \brief Called with the round trip times of the telemetry pings
+
+  Shown in the tooltip, only firmware which sends the pings back has them.
+  */
+void TelemetryMonitorWidget::updateLatency(int medianMs, int p95Ms, int maxMs)
+{
+    latencyMedian = medianMs;
+    latencyP95 = p95Ms;
+    latencyMax = maxMs;
+
+    showTelemetry();
+}
+
 // Converts the value into an percentage:
 // this enables smooth movement in moveIndex below
 void TelemetryMonitorWidget::showTelemetry()
@@ -122,7 +139,10 @@ void TelemetryMonitorWidget::showTelemetry()
     txIndex = (txValue-minValue)/(maxValue-minValue) * NODE_NUMELEM;
     rxIndex = (rxValue-minValue)/(maxValue-minValue) * NODE_NUMELEM;
 
-    if (connected)
+    if (connected && latencyMax > 0)
+        this->setToolTip(QString("Tx: %0 bytes/sec\nRx: %1 bytes/sec\nRound trip: %2 ms median, %3 ms 95%, %4 ms max")
+                         .arg(txValue).arg(rxValue).arg(latencyMedian).arg(latencyP95).arg(latencyMax));
+    else if (connected)
         this->setToolTip(QString("Tx: %0 bytes/sec\nRx: %1 bytes/sec").arg(txValue).arg(rxValue));
     else
         this->setToolTip(QString("Disconnected"));
@@ -30,6 +30,7 @@ public slots:
     void disconnect();
 
     void updateTelemetry(double txRate, double rxRate);
+    void updateLatency(int medianMs, int p95Ms, int maxMs);
     void showTelemetry();
 
 protected:
@@ -48,6 +49,10 @@ private:
    double txValue;
    double rxIndex;
    double rxValue;
+   // Round trip time percentiles, all zero without latency pings
+   int latencyMedian;
+   int latencyP95;
+   int latencyMax;
    double minValue;
    double maxValue;
 };
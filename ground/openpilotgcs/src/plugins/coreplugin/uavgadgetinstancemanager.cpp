@@ -36,6 +36,7 @@
 #include "icore.h"
 
 #include <extensionsystem/pluginmanager.h>
+#include <extensionsystem/pluginspec.h>
 #include <QtCore/QStringList>
 #include <QtCore/QSettings>
 #include <QtCore/QDebug>
@@ -50,6 +51,25 @@ UAVGadgetInstanceManager::UAVGadgetInstanceManager(QObject *parent) :
     QObject(parent)
 {
     m_pm = ExtensionSystem::PluginManager::instance();
+    addFactories();
+    // Gadgets of lazy plugins are listed from the plugin spec until they are needed
+    foreach (ExtensionSystem::PluginSpec *spec, m_pm->plugins()) {
+        if (!spec->isLazy() || spec->state() == ExtensionSystem::PluginSpec::Running)
+            continue;
+        foreach (const ExtensionSystem::PluginProvidedItem &item, spec->providedItems()) {
+            if (m_classIdNameMap.contains(item.id))
+                continue;
+            m_lazyClassIds.insert(item.id);
+            m_classIdNameMap.insert(item.id, item.name.isEmpty() ? item.id : item.name);
+            m_classIdIconMap.insert(item.id, QIcon());
+        }
+    }
+    connect(m_pm, SIGNAL(lazyPluginLoaded(ExtensionSystem::PluginSpec*)),
+            this, SLOT(lazyPluginLoaded(ExtensionSystem::PluginSpec*)));
+}
+
+void UAVGadgetInstanceManager::addFactories()
+{
     QList<IUAVGadgetFactory*> factories = m_pm->getObjects<IUAVGadgetFactory>();
     foreach (IUAVGadgetFactory *f, factories) {
         if (!m_factories.contains(f)) {
@@ -63,6 +83,50 @@ UAVGadgetInstanceManager::UAVGadgetInstanceManager(QObject *parent) :
     }
 }
 
+/**
+  * The configurations of a lazy plugin's gadgets are kept, unread, in the GCS
+  * settings until the plugin is loaded. They are read from there then.
+  */
+void UAVGadgetInstanceManager::lazyPluginLoaded(ExtensionSystem::PluginSpec *spec)
+{
+    addFactories();
+    foreach (const ExtensionSystem::PluginProvidedItem &item, spec->providedItems()) {
+        if (!m_lazyClassIds.remove(item.id) || !factory(item.id))
+            continue;
+        int first = m_configurations.count();
+        QSettings *qs = Core::ICore::instance()->settings();
+        qs->beginGroup("UAVGadgetConfigurations");
+        readClassConfigs(qs, item.id);
+        qs->endGroup();
+        for (int i = first; i < m_configurations.count(); ++i)
+            createOptionsPage(m_configurations.at(i));
+    }
+}
+
+IUAVGadgetFactory *UAVGadgetInstanceManager::loadFactory(QString classId)
+{
+    IUAVGadgetFactory *f = factory(classId);
+    if (!f && m_lazyClassIds.contains(classId)) {
+        m_pm->loadLazyPlugin(m_pm->pluginProviding(classId));
+        f = factory(classId);
+    }
+    return f;
+}
+
+/**
+  * Copy the settings of a group, replacing what \a to had in it
+  */
+void UAVGadgetInstanceManager::copyGroup(QSettings *from, QSettings *to, QString group)
+{
+    to->remove(group);
+    from->beginGroup(group);
+    to->beginGroup(group);
+    foreach (QString key, from->allKeys())
+        to->setValue(key, from->value(key));
+    to->endGroup();
+    from->endGroup();
+}
+
 UAVGadgetInstanceManager::~UAVGadgetInstanceManager()
 {
     foreach (IOptionsPage *page, m_optionsPages) {
@@ -108,62 +172,84 @@ void UAVGadgetInstanceManager::readSettings(QSettings *qs)
 
 void UAVGadgetInstanceManager::readConfigs_1_2_0(QSettings *qs)
 {
-    UAVConfigInfo configInfo;
-
+    QSettings *stored = Core::ICore::instance()->settings();
     foreach (QString classId, m_classIdNameMap.keys())
     {
-        IUAVGadgetFactory *f = factory(classId);
-        qs->beginGroup(classId);
-
-        QStringList configs = QStringList();
-
-        configs = qs->childGroups();
-        foreach (QString configName, configs) {
-            qDebug() << "Loading config: " << classId << "," <<  configName;
-            qs->beginGroup(configName);
-            configInfo.read(qs);
-            configInfo.setNameOfConfigurable(classId+"-"+configName);
-            qs->beginGroup("data");
-            IUAVGadgetConfiguration *config = f->createConfiguration(qs, &configInfo);
-            if (config){
-                config->setName(configName);
-                config->setProvisionalName(configName);
-                config->setLocked(configInfo.locked());
-                int idx = indexForConfig(m_configurations, classId, configName);
-                if ( idx >= 0 ){
-                    // We should replace the config, but it might be used, so just
-                    // throw it out of the list. The GCS should be reinitialised soon.
-                    m_configurations[idx] = config;
-                }
-                else{
-                    m_configurations.append(config);
-                }
+        if (m_lazyClassIds.contains(classId)) {
+            // Read once the plugin is loaded, from the GCS settings
+            if (qs != stored && qs->childGroups().contains(classId)) {
+                stored->beginGroup("UAVGadgetConfigurations");
+                copyGroup(qs, stored, classId);
+                stored->endGroup();
             }
-            qs->endGroup();
-            qs->endGroup();
+            continue;
         }
+        readClassConfigs(qs, classId);
+    }
+}
 
-        if (configs.count() == 0) {
-            IUAVGadgetConfiguration *config = f->createConfiguration(0, 0);
-            // it is not mandatory for uavgadgets to have any configurations (settings)
-            // and therefore we have to check for that
-            if (config) {
-                config->setName(tr("default"));
-                config->setProvisionalName(tr("default"));
+void UAVGadgetInstanceManager::readClassConfigs(QSettings *qs, QString classId)
+{
+    UAVConfigInfo configInfo;
+
+    IUAVGadgetFactory *f = factory(classId);
+    qs->beginGroup(classId);
+
+    QStringList configs = QStringList();
+
+    configs = qs->childGroups();
+    foreach (QString configName, configs) {
+        qDebug() << "Loading config: " << classId << "," <<  configName;
+        qs->beginGroup(configName);
+        configInfo.read(qs);
+        configInfo.setNameOfConfigurable(classId+"-"+configName);
+        qs->beginGroup("data");
+        IUAVGadgetConfiguration *config = f->createConfiguration(qs, &configInfo);
+        if (config){
+            config->setName(configName);
+            config->setProvisionalName(configName);
+            config->setLocked(configInfo.locked());
+            int idx = indexForConfig(m_configurations, classId, configName);
+            if ( idx >= 0 ){
+                // We should replace the config, but it might be used, so just
+                // throw it out of the list. The GCS should be reinitialised soon.
+                m_configurations[idx] = config;
+            }
+            else{
                 m_configurations.append(config);
             }
         }
         qs->endGroup();
+        qs->endGroup();
+    }
+
+    if (configs.count() == 0) {
+        IUAVGadgetConfiguration *config = f->createConfiguration(0, 0);
+        // it is not mandatory for uavgadgets to have any configurations (settings)
+        // and therefore we have to check for that
+        if (config) {
+            config->setName(tr("default"));
+            config->setProvisionalName(tr("default"));
+            m_configurations.append(config);
+        }
     }
+    qs->endGroup();
 }
 
 void UAVGadgetInstanceManager::readConfigs_1_1_0(QSettings *qs)
 {
     UAVConfigInfo configInfo;
 
+    // Old configurations are migrated in one go, lazy plugins included
+    foreach (QString classId, m_lazyClassIds.toList()) {
+        m_lazyClassIds.remove(classId);
+        m_pm->loadLazyPlugin(m_pm->pluginProviding(classId));
+    }
     foreach (QString classId, m_classIdNameMap.keys())
     {
         IUAVGadgetFactory *f = factory(classId);
+        if (!f)
+            continue;
         qs->beginGroup(classId);
 
         QStringList configs = QStringList();
@@ -210,7 +296,22 @@ void UAVGadgetInstanceManager::saveSettings(QSettings *qs)
 {
     UAVConfigInfo *configInfo;
     qs->beginGroup("UAVGadgetConfigurations");
-    qs->remove(""); // Remove existing configurations
+    // Remove existing configurations, but those of lazy plugins not loaded yet
+    foreach (QString group, qs->childGroups()) {
+        if (!m_lazyClassIds.contains(group))
+            qs->remove(group);
+    }
+    foreach (QString key, qs->childKeys())
+        qs->remove(key);
+    QSettings *stored = Core::ICore::instance()->settings();
+    if (qs != stored) {
+        stored->beginGroup("UAVGadgetConfigurations");
+        foreach (QString classId, m_lazyClassIds) {
+            if (stored->childGroups().contains(classId))
+                copyGroup(stored, qs, classId);
+        }
+        stored->endGroup();
+    }
     configInfo = new UAVConfigInfo(m_versionUAVGadgetConfigurations, "UAVGadgetConfigurations");
     configInfo->save(qs);
     delete configInfo;
@@ -240,22 +341,25 @@ void UAVGadgetInstanceManager::createOptionsPages()
     }
 
     foreach (IUAVGadgetConfiguration *config, m_configurations)
-    {
-        IUAVGadgetFactory *f = factory(config->classId());
-        IOptionsPage *p = f->createOptionsPage(config);
-        if (p) {
-            IOptionsPage *page = new UAVGadgetOptionsPageDecorator(p, config, f->isSingleConfigurationGadget());
-            page->setIcon(f->icon());
-            m_optionsPages.append(page);
-            m_pm->addObject(page);
-        }
+        createOptionsPage(config);
+}
+
+void UAVGadgetInstanceManager::createOptionsPage(IUAVGadgetConfiguration *config)
+{
+    IUAVGadgetFactory *f = factory(config->classId());
+    IOptionsPage *p = f->createOptionsPage(config);
+    if (p) {
+        IOptionsPage *page = new UAVGadgetOptionsPageDecorator(p, config, f->isSingleConfigurationGadget());
+        page->setIcon(f->icon());
+        m_optionsPages.append(page);
+        m_pm->addObject(page);
     }
 }
 
 
 IUAVGadget *UAVGadgetInstanceManager::createGadget(QString classId, QWidget *parent)
 {
-    IUAVGadgetFactory *f = factory(classId);
+    IUAVGadgetFactory *f = loadFactory(classId);
     if (f) {
         QList<IUAVGadgetConfiguration*> *configs = configurations(classId);
         IUAVGadget *g = f->createGadget(parent);
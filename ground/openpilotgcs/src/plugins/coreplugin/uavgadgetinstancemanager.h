@@ -31,6 +31,7 @@
 #include <QObject>
 #include <QSettings>
 #include <QtCore/QMap>
+#include <QtCore/QSet>
 #include <QtCore/QStringList>
 #include <QtGui/QIcon>
 #include "core_global.h"
@@ -38,6 +39,7 @@
 
 namespace ExtensionSystem {
     class PluginManager;
+    class PluginSpec;
 }
 
 namespace Core
@@ -84,9 +86,15 @@ public slots:
     void settingsDialogShown(Core::Internal::SettingsDialog* settingsDialog);
     void settingsDialogRemoved();
 
+private slots:
+    void lazyPluginLoaded(ExtensionSystem::PluginSpec *spec);
+
 private:
     IUAVGadgetFactory *factory(QString classId) const;
+    IUAVGadgetFactory *loadFactory(QString classId);
+    void addFactories();
     void createOptionsPages();
+    void createOptionsPage(IUAVGadgetConfiguration *config);
     QList<IUAVGadgetConfiguration*> *configurations(QString classId) const;
     QString suggestName(QString classId, QString name);
     QList<IUAVGadget*> m_gadgetInstances;
@@ -95,6 +103,7 @@ private:
     QList<IOptionsPage*> m_optionsPages;
     QMap<QString, QString> m_classIdNameMap;
     QMap<QString, QIcon> m_classIdIconMap;
+    QSet<QString> m_lazyClassIds; // gadgets of lazy plugins not loaded yet
     QMap<QString, QStringList> m_takenNames;
     QList<IUAVGadgetConfiguration*> m_provisionalConfigs;
     QList<IUAVGadgetConfiguration*> m_provisionalDeletes;
@@ -105,6 +114,8 @@ private:
                        QString classId, QString configName);
     void readConfigs_1_1_0(QSettings *qs);
     void readConfigs_1_2_0(QSettings *qs);
+    void readClassConfigs(QSettings *qs, QString classId);
+    void copyGroup(QSettings *from, QSettings *to, QString group);
 };
 
 } // namespace Core
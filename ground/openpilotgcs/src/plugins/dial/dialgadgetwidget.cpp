@@ -47,6 +47,7 @@ DialGadgetWidget::DialGadgetWidget(QWidget *parent) : QGraphicsView(parent)
     obj1 = NULL;
     obj2 = NULL;
     obj3 = NULL;
+    interest = new UAVObjectInterest(this);
     m_text1 = NULL;
     m_text2 = NULL;
     m_text3 = NULL; // Should be initialized to NULL otherwise the setFont method
@@ -59,7 +60,8 @@ DialGadgetWidget::DialGadgetWidget(QWidget *parent) : QGraphicsView(parent)
 //	beSmooth = true;
 	beSmooth = false;
 
-    // This timer mechanism makes needles rotate smoothly
+    // This timer mechanism makes needles rotate smoothly,
+    // it ticks on the frame clock shared by all instruments
     connect(&dialTimer, SIGNAL(timeout()), this, SLOT(rotateNeedles()));
 }
 
@@ -91,6 +93,7 @@ void DialGadgetWidget::connectNeedles(QString object1, QString nfield1,
         disconnect(obj2,SIGNAL(objectUpdated(UAVObject*)),this,SLOT(updateNeedle2(UAVObject*)));
     if (obj3 != NULL)
         disconnect(obj3,SIGNAL(objectUpdated(UAVObject*)),this,SLOT(updateNeedle3(UAVObject*)));
+    interest->clear();
 
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
     UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
@@ -101,6 +104,7 @@ void DialGadgetWidget::connectNeedles(QString object1, QString nfield1,
         if (obj1 != NULL ) {
             // qDebug() << "Connected Object 1 (" << object1 << ").";
             connect(obj1, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateNeedle1(UAVObject*)));
+            interest->addObject(obj1);
             if(nfield1.contains("-"))
             {
                 QStringList fieldSubfield = nfield1.split("-", QString::SkipEmptyParts);
@@ -124,6 +128,7 @@ void DialGadgetWidget::connectNeedles(QString object1, QString nfield1,
         if (obj2 != NULL ) {
             // qDebug() << "Connected Object 2 (" << object2 << ").";
             connect(obj2, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateNeedle2(UAVObject*)));
+            interest->addObject(obj2);
             if(nfield2.contains("-"))
             {
                 QStringList fieldSubfield = nfield2.split("-", QString::SkipEmptyParts);
@@ -147,6 +152,7 @@ void DialGadgetWidget::connectNeedles(QString object1, QString nfield1,
         if (obj3 != NULL ) {
             // qDebug() << "Connected Object 3 (" << object3 << ").";
             connect(obj3, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateNeedle3(UAVObject*)));
+            interest->addObject(obj3);
             if(nfield3.contains("-"))
             {
                 QStringList fieldSubfield = nfield3.split("-", QString::SkipEmptyParts);
@@ -486,12 +492,13 @@ void DialGadgetWidget::setNeedle1(double value) {
     if (vertN1) {
         needle1Target = (value*n1Factor)/(n1MaxValue-n1MinValue);
     }
-    if (!dialTimer.isActive())
+    if (needle1Target != needle1Value && !dialTimer.isActive())
         dialTimer.start();
     if (m_text1) {
         QString s;
         s.sprintf("%.2f",value*n1Factor);
-        m_text1->setPlainText(s);
+        if (m_text1->toPlainText() != s)
+            m_text1->setPlainText(s);
     }
 }
 
@@ -505,12 +512,13 @@ void DialGadgetWidget::setNeedle2(double value) {
     if (vertN2) {
         needle2Target = (value*n2Factor)/(n2MaxValue-n2MinValue);
     }
-    if (!dialTimer.isActive())
+    if (needle2Target != needle2Value && !dialTimer.isActive())
         dialTimer.start();
     if (m_text2) {
         QString s;
         s.sprintf("%.2f",value*n2Factor);
-        m_text2->setPlainText(s);
+        if (m_text2->toPlainText() != s)
+            m_text2->setPlainText(s);
     }
 
 }
@@ -525,12 +533,13 @@ void DialGadgetWidget::setNeedle3(double value) {
     if (vertN3) {
         needle3Target = (value*n3Factor)/(n3MaxValue-n3MinValue);
     }
-    if (!dialTimer.isActive())
+    if (needle3Target != needle3Value && !dialTimer.isActive())
         dialTimer.start();
     if (m_text3) {
         QString s;
         s.sprintf("%.2f",value*n3Factor);
-        m_text3->setPlainText(s);
+        if (m_text3->toPlainText() != s)
+            m_text3->setPlainText(s);
     }
 }
 
@@ -33,12 +33,13 @@
 #include "extensionsystem/pluginmanager.h"
 #include "uavobjectmanager.h"
 #include "uavobject.h"
+#include "uavobjectinterest.h"
 #include <QGraphicsView>
 #include <QtSvg/QSvgRenderer>
 #include <QtSvg/QGraphicsSvgItem>
 
 #include <QFile>
-#include <QTimer>
+#include <utils/instrumentclock.h>
 
 class DialGadgetWidget : public QGraphicsView
 {
@@ -135,6 +136,8 @@ private:
    UAVDataObject* obj1;
    UAVDataObject* obj2;
    UAVDataObject* obj3;
+   // The objects above, shown while the dial is visible
+   UAVObjectInterest* interest;
    QString field1;
    QString subfield1;
    bool haveSubField1;
@@ -146,7 +149,7 @@ private:
    bool haveSubField3;
 
    // Rotation timer
-   QTimer dialTimer;
+   Utils::InstrumentTimer dialTimer;
 
    bool beSmooth;
 };
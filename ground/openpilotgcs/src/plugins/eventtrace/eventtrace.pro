@@ -0,0 +1,18 @@
+TEMPLATE = lib
+TARGET = EventTraceGadget
+
+include(../../openpilotgcsplugin.pri)
+include(../../plugins/coreplugin/coreplugin.pri)
+include(../../plugins/uavobjects/uavobjects.pri)
+
+HEADERS += eventtracegadget.h
+HEADERS += eventtracegadgetwidget.h
+HEADERS += eventtracegadgetfactory.h
+HEADERS += eventtraceplugin.h
+
+SOURCES += eventtracegadget.cpp
+SOURCES += eventtracegadgetwidget.cpp
+SOURCES += eventtracegadgetfactory.cpp
+SOURCES += eventtraceplugin.cpp
+
+OTHER_FILES += EventTraceGadget.pluginspec
@@ -0,0 +1,44 @@
+/**
+ ******************************************************************************
+ *
+ * @file       eventtracegadget.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup EventTraceGadgetPlugin Event Trace Gadget Plugin
+ * @{
+ * @brief A timeline of the flight event trace sent in TraceRecords
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "eventtracegadget.h"
+#include "eventtracegadgetwidget.h"
+
+EventTraceGadget::EventTraceGadget(QString classId, EventTraceGadgetWidget *widget, QWidget *parent) :
+        IUAVGadget(classId, parent),
+        m_widget(widget)
+{
+}
+
+EventTraceGadget::~EventTraceGadget()
+{
+    delete m_widget;
+}
+
+void EventTraceGadget::loadConfiguration(IUAVGadgetConfiguration* config)
+{
+    Q_UNUSED(config);
+}
@@ -0,0 +1,242 @@
+/**
+ ******************************************************************************
+ *
+ * @file       eventtracegadgetwidget.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup EventTraceGadgetPlugin Event Trace Gadget Plugin
+ * @{
+ * @brief A timeline of the flight event trace sent in TraceRecords
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "eventtracegadgetwidget.h"
+
+#include <QtGui/QPainter>
+#include <QtGui/QWheelEvent>
+#include <QtGui/QMouseEvent>
+
+#include "uavobjectmanager.h"
+#include "extensionsystem/pluginmanager.h"
+
+EventTraceGadgetWidget::EventTraceGadgetWidget(QWidget *parent) : QWidget(parent),
+    m_window(DEFAULT_WINDOW_US),
+    m_paused(false)
+{
+    reset();
+
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
+    m_records = TraceRecords::GetInstance(objManager);
+    connect(m_records, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(recordsUpdated(UAVObject*)));
+
+    setMinimumHeight(LANE_NUMELEM * 20 + 30);
+}
+
+EventTraceGadgetWidget::~EventTraceGadgetWidget()
+{
+   // Do nothing
+}
+
+/**
+  * Forget the history, used at start and when the board restarted
+  */
+void EventTraceGadgetWidget::reset()
+{
+    for (int n = 0; n < LANE_NUMELEM; ++n) {
+        m_spans[n].clear();
+        m_open[n] = -1;
+    }
+    m_lastRaw = 0;
+    m_wrap = 0;
+    m_latest = 0;
+    m_viewEnd = 0;
+    m_received = 0;
+    m_lost = 0;
+    m_haveTime = false;
+}
+
+/**
+  * Add the records of a TraceRecords update to the history
+  */
+void EventTraceGadgetWidget::recordsUpdated(UAVObject *obj)
+{
+    Q_UNUSED(obj);
+    TraceRecords::DataFields data = m_records->getData();
+
+    m_lost += data.Lost;
+    for (int n = 0; n < data.Count && n < (int)TraceRecords::TIMESTAMP_NUMELEM; ++n) {
+        quint32 raw = data.Timestamp[n];
+
+        // The trace clock is 32 bit microseconds and wraps after about 71 minutes,
+        // a large step back without a wrap means the board restarted
+        if (m_haveTime && raw < m_lastRaw) {
+            if (m_lastRaw - raw > 0x80000000u)
+                m_wrap += Q_INT64_C(0x100000000);
+            else if (m_lastRaw - raw > 1000000u)
+                reset();
+        }
+        m_lastRaw = raw;
+        m_haveTime = true;
+
+        addRecord(m_wrap + raw, data.Event[n], data.Arg[n]);
+        m_received++;
+    }
+
+    // Drop what scrolled out of the history
+    for (int n = 0; n < LANE_NUMELEM; ++n) {
+        while (!m_spans[n].isEmpty() && m_spans[n].first().end < m_latest - HISTORY_US)
+            m_spans[n].removeFirst();
+    }
+
+    if (!m_paused) {
+        m_viewEnd = m_latest;
+        update();
+    }
+}
+
+/**
+  * Pair the start and end events of a module into spans
+  */
+void EventTraceGadgetWidget::addRecord(qint64 time, quint8 event, quint16 arg)
+{
+    Lane lane;
+    bool start = false;
+
+    switch (event) {
+    case TraceRecords::EVENT_SENSORSSTART:
+        start = true;
+    case TraceRecords::EVENT_SENSORSEND:
+        lane = LANE_SENSORS;
+        break;
+    case TraceRecords::EVENT_ATTITUDESTART:
+        start = true;
+    case TraceRecords::EVENT_ATTITUDEEND:
+        lane = LANE_ATTITUDE;
+        break;
+    case TraceRecords::EVENT_STABILIZATIONSTART:
+        start = true;
+    case TraceRecords::EVENT_STABILIZATIONEND:
+        lane = LANE_STABILIZATION;
+        break;
+    case TraceRecords::EVENT_ACTUATORSTART:
+        start = true;
+    case TraceRecords::EVENT_ACTUATOROUTPUT:
+        lane = LANE_ACTUATOR;
+        break;
+    case TraceRecords::EVENT_TELEMETRYTXSTART:
+        start = true;
+    case TraceRecords::EVENT_TELEMETRYTXEND:
+        lane = LANE_TELEMETRYTX;
+        break;
+    case TraceRecords::EVENT_TELEMETRYRX:
+        lane = LANE_TELEMETRYRX;
+        break;
+    default:
+        return;
+    }
+
+    if (time > m_latest)
+        m_latest = time;
+
+    if (start) {
+        m_open[lane] = time;
+        return;
+    }
+
+    Span span;
+    span.start = (m_open[lane] >= 0 && m_open[lane] <= time) ? m_open[lane] : time;
+    span.end = time;
+    span.arg = arg;
+    m_spans[lane].append(span);
+    m_open[lane] = -1;
+}
+
+void EventTraceGadgetWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    static const char * const laneNames[LANE_NUMELEM] = { "Sensors", "Attitude", "Stabilization", "Actuator", "Telemetry Tx", "Telemetry Rx" };
+    static const QColor laneColors[LANE_NUMELEM] = { QColor(80, 160, 220), QColor(90, 190, 90), QColor(230, 160, 40),
+                                                     QColor(210, 70, 70), QColor(150, 110, 200), QColor(120, 120, 120) };
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+
+    const int labelWidth = 100;
+    const int statusHeight = 20;
+    const int plotWidth = qMax(1, width() - labelWidth);
+    const int laneHeight = qMax(8, (height() - statusHeight) / LANE_NUMELEM);
+    const qint64 left = m_viewEnd - m_window;
+
+    for (int n = 0; n < LANE_NUMELEM; ++n) {
+        int top = n * laneHeight;
+        painter.setPen(palette().text().color());
+        painter.drawText(QRect(4, top, labelWidth - 8, laneHeight), Qt::AlignVCenter | Qt::AlignLeft, tr(laneNames[n]));
+        painter.setPen(palette().mid().color());
+        painter.drawLine(labelWidth, top + laneHeight - 1, width(), top + laneHeight - 1);
+
+        foreach (const Span &span, m_spans[n]) {
+            if (span.end < left || span.start > m_viewEnd)
+                continue;
+            int x0 = labelWidth + (int)((span.start - left) * plotWidth / m_window);
+            int x1 = labelWidth + (int)((span.end - left) * plotWidth / m_window);
+            x0 = qMax(x0, labelWidth);
+            if (x1 - x0 < 1) {
+                // Point events and spans shorter than a pixel
+                painter.setPen(laneColors[n]);
+                painter.drawLine(x1, top + 2, x1, top + laneHeight - 3);
+            } else {
+                painter.fillRect(x0, top + 3, x1 - x0, laneHeight - 6, laneColors[n]);
+            }
+        }
+    }
+
+    QString status = tr("%1 ms shown, %2 records, %3 lost").arg(m_window / 1000.0, 0, 'f', 1).arg(m_received).arg(m_lost);
+    if (m_paused)
+        status += tr(" (paused, click to resume)");
+    painter.setPen(palette().text().color());
+    painter.drawText(QRect(4, height() - statusHeight, width() - 8, statusHeight), Qt::AlignVCenter | Qt::AlignLeft, status);
+}
+
+/**
+  * The wheel zooms the time axis between a millisecond and the whole history
+  */
+void EventTraceGadgetWidget::wheelEvent(QWheelEvent *event)
+{
+    if (event->delta() > 0)
+        m_window = qMax(MIN_WINDOW_US, m_window / 2);
+    else
+        m_window = qMin(HISTORY_US, m_window * 2);
+    update();
+}
+
+/**
+  * A click freezes the display so a slow cycle can be looked at
+  */
+void EventTraceGadgetWidget::mousePressEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+    m_paused = !m_paused;
+    if (!m_paused)
+        m_viewEnd = m_latest;
+    update();
+}
+
+/**
+  * @}
+  * @}
+  */
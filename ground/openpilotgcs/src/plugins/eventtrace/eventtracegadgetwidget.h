@@ -0,0 +1,83 @@
+/**
+ ******************************************************************************
+ *
+ * @file       eventtracegadgetwidget.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup EventTraceGadgetPlugin Event Trace Gadget Plugin
+ * @{
+ * @brief A timeline of the flight event trace sent in TraceRecords
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef EVENTTRACEGADGETWIDGET_H_
+#define EVENTTRACEGADGETWIDGET_H_
+
+#include <QtGui/QWidget>
+#include <QList>
+#include "tracerecords.h"
+
+class EventTraceGadgetWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    EventTraceGadgetWidget(QWidget *parent = 0);
+    ~EventTraceGadgetWidget();
+
+protected:
+    void paintEvent(QPaintEvent *event);
+    void wheelEvent(QWheelEvent *event);
+    void mousePressEvent(QMouseEvent *event);
+
+private slots:
+    void recordsUpdated(UAVObject *obj);
+
+private:
+    // Rows of the timeline, one per module
+    typedef enum { LANE_SENSORS, LANE_ATTITUDE, LANE_STABILIZATION, LANE_ACTUATOR, LANE_TELEMETRYTX, LANE_TELEMETRYRX, LANE_NUMELEM } Lane;
+
+    // A start/end pair is a span, events without an end are shown as ticks
+    typedef struct {
+        qint64 start;
+        qint64 end;
+        quint16 arg;
+    } Span;
+
+    static const qint64 HISTORY_US = 5000000;
+    static const qint64 MIN_WINDOW_US = 1000;
+    static const qint64 DEFAULT_WINDOW_US = 20000;
+
+    TraceRecords *m_records;
+    QList<Span> m_spans[LANE_NUMELEM];
+    qint64 m_open[LANE_NUMELEM];
+    quint32 m_lastRaw;
+    qint64 m_wrap;
+    qint64 m_latest;
+    qint64 m_viewEnd; // right edge of the display, held while paused
+    qint64 m_window;
+    quint32 m_received;
+    quint32 m_lost;
+    bool m_haveTime;
+    bool m_paused;
+
+    void addRecord(qint64 time, quint8 event, quint16 arg);
+    void reset();
+};
+
+#endif /* EVENTTRACEGADGETWIDGET_H_ */
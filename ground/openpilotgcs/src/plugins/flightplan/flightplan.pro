@@ -0,0 +1,20 @@
+TEMPLATE = lib
+TARGET = FlightPlanGadget
+
+include(../../openpilotgcsplugin.pri)
+include(../../plugins/coreplugin/coreplugin.pri)
+include(../../plugins/uavobjects/uavobjects.pri)
+
+HEADERS += flightplangadget.h
+HEADERS += flightplangadgetwidget.h
+HEADERS += flightplangadgetfactory.h
+HEADERS += flightplanplugin.h
+
+SOURCES += flightplangadget.cpp
+SOURCES += flightplangadgetwidget.cpp
+SOURCES += flightplangadgetfactory.cpp
+SOURCES += flightplanplugin.cpp
+
+FORMS += flightplan.ui
+
+OTHER_FILES += FlightPlanGadget.pluginspec
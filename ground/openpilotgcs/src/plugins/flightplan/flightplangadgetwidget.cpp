@@ -0,0 +1,228 @@
+/**
+ ******************************************************************************
+ *
+ * @file       flightplangadgetwidget.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup FlightPlanGadgetPlugin Flight Plan Gadget Plugin
+ * @{
+ * @brief Uploads precompiled flight plan images and runs the script
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "flightplangadgetwidget.h"
+#include "ui_flightplan.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QtGui/QFileDialog>
+
+#include "uavobjectmanager.h"
+#include "extensionsystem/pluginmanager.h"
+
+FlightPlanGadgetWidget::FlightPlanGadgetWidget(QWidget *parent) : QWidget(parent),
+    m_crc(0),
+    m_offset(0),
+    m_length(0),
+    m_retries(0),
+    m_uploading(false)
+{
+    m_flightplan = new Ui_FlightPlan();
+    m_flightplan->setupUi(this);
+
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
+    m_control = FlightPlanControl::GetInstance(objManager);
+    m_image = FlightPlanImage::GetInstance(objManager);
+    m_status = FlightPlanStatus::GetInstance(objManager);
+
+    connect(m_image, SIGNAL(transactionCompleted(UAVObject*,bool)), this, SLOT(imageTransactionCompleted(UAVObject*,bool)));
+    connect(m_status, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(statusUpdated(UAVObject*)));
+
+    connect(m_flightplan->browseButton, SIGNAL(clicked()), this, SLOT(browse()));
+    connect(m_flightplan->uploadButton, SIGNAL(clicked()), this, SLOT(upload()));
+    connect(m_flightplan->builtInButton, SIGNAL(clicked()), this, SLOT(useBuiltIn()));
+    connect(m_flightplan->startButton, SIGNAL(clicked()), this, SLOT(start()));
+    connect(m_flightplan->stopButton, SIGNAL(clicked()), this, SLOT(stop()));
+    connect(m_flightplan->killButton, SIGNAL(clicked()), this, SLOT(kill()));
+
+    statusUpdated(m_status);
+}
+
+FlightPlanGadgetWidget::~FlightPlanGadgetWidget()
+{
+    delete m_flightplan;
+}
+
+void FlightPlanGadgetWidget::browse()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Open Flight Plan Image"),
+                                                    QFileInfo(m_flightplan->imageFile->text()).path(),
+                                                    tr("Flight plan images (*.bin)"));
+    if (!fileName.isEmpty())
+        m_flightplan->imageFile->setText(fileName);
+}
+
+/**
+  * Read the image and send its first block, the rest follow as the blocks are acked
+  */
+void FlightPlanGadgetWidget::upload()
+{
+    if (m_uploading)
+        return;
+
+    QFile file(m_flightplan->imageFile->text());
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_flightplan->statusLabel->setText(tr("Can not open %1").arg(file.fileName()));
+        return;
+    }
+    m_data = file.readAll();
+    if (m_data.isEmpty() || m_data.size() > 0xFFFF) {
+        m_flightplan->statusLabel->setText(tr("%1 is not a flight plan image").arg(file.fileName()));
+        return;
+    }
+
+    m_crc = crc32(m_data);
+    m_offset = 0;
+    m_retries = 0;
+    m_uploading = true;
+    m_flightplan->progressBar->setMaximum(m_data.size());
+    m_flightplan->progressBar->setValue(0);
+    m_flightplan->uploadButton->setEnabled(false);
+    sendBlock();
+}
+
+void FlightPlanGadgetWidget::useBuiltIn()
+{
+    if (m_uploading)
+        return;
+
+    m_data.clear();
+    m_crc = 0;
+    m_offset = 0;
+    m_retries = 0;
+    sendBlock();
+}
+
+void FlightPlanGadgetWidget::sendBlock()
+{
+    FlightPlanImage::DataFields data = m_image->getData();
+
+    m_length = qMin(m_data.size() - m_offset, (int)FlightPlanImage::DATA_NUMELEM);
+
+    data.Crc = m_crc;
+    data.Size = m_data.size();
+    data.Offset = m_offset;
+    data.Length = m_length;
+    memset(data.Data, 0, sizeof(data.Data));
+    memcpy(data.Data, m_data.constData() + m_offset, m_length);
+
+    m_image->setData(data);
+    m_image->updated();
+}
+
+void FlightPlanGadgetWidget::imageTransactionCompleted(UAVObject *obj, bool success)
+{
+    Q_UNUSED(obj);
+
+    if (!m_uploading)
+        return;
+
+    if (!success) {
+        // The board keeps the blocks it has, so the same one can be sent again
+        if (++m_retries > MAX_RETRIES)
+            finishUpload(tr("Upload failed, the board did not acknowledge the image"));
+        else
+            sendBlock();
+        return;
+    }
+
+    m_retries = 0;
+    m_offset += m_length;
+    m_flightplan->progressBar->setValue(m_offset);
+    if (m_offset >= m_data.size())
+        finishUpload(tr("Image sent, waiting for the board to check it"));
+    else
+        sendBlock();
+}
+
+void FlightPlanGadgetWidget::finishUpload(const QString &message)
+{
+    m_uploading = false;
+    m_flightplan->uploadButton->setEnabled(true);
+    m_flightplan->statusLabel->setText(message);
+    m_status->requestUpdate();
+}
+
+void FlightPlanGadgetWidget::start()
+{
+    sendCommand(FlightPlanControl::COMMAND_START);
+}
+
+void FlightPlanGadgetWidget::stop()
+{
+    sendCommand(FlightPlanControl::COMMAND_STOP);
+}
+
+void FlightPlanGadgetWidget::kill()
+{
+    sendCommand(FlightPlanControl::COMMAND_KILL);
+}
+
+void FlightPlanGadgetWidget::sendCommand(quint8 command)
+{
+    FlightPlanControl::DataFields data = m_control->getData();
+    data.Command = command;
+    m_control->setData(data);
+    m_control->updated();
+}
+
+void FlightPlanGadgetWidget::statusUpdated(UAVObject *obj)
+{
+    Q_UNUSED(obj);
+
+    if (m_uploading)
+        return;
+
+    FlightPlanStatus::DataFields status = m_status->getData();
+    QString text = tr("Script: %1, image: %2")
+                   .arg(m_status->getField("Status")->getValue().toString())
+                   .arg(m_status->getField("ImageStatus")->getValue().toString());
+    if (status.Status == FlightPlanStatus::STATUS_ERROR)
+        text += tr(", %1 in file %2 line %3")
+                .arg(m_status->getField("ErrorType")->getValue().toString())
+                .arg(status.ErrorFileID)
+                .arg(status.ErrorLineNum);
+    m_flightplan->statusLabel->setText(text);
+}
+
+/**
+  * CRC-32 of the image as PIOS_CRC32_updateCRC() computes it on the board,
+  * polynomial 0x04C11DB7 most significant bit first and no final inversion
+  */
+quint32 FlightPlanGadgetWidget::crc32(const QByteArray &data)
+{
+    quint32 crc = 0xFFFFFFFF;
+
+    for (int i = 0; i < data.size(); ++i) {
+        crc ^= (quint32)(quint8)data[i] << 24;
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : (crc << 1);
+    }
+
+    return crc;
+}
@@ -0,0 +1,79 @@
+/**
+ ******************************************************************************
+ *
+ * @file       flightplangadgetwidget.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup FlightPlanGadgetPlugin Flight Plan Gadget Plugin
+ * @{
+ * @brief Uploads precompiled flight plan images and runs the script
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef FLIGHTPLANGADGETWIDGET_H_
+#define FLIGHTPLANGADGETWIDGET_H_
+
+#include <QtGui/QWidget>
+#include <QByteArray>
+#include "flightplancontrol.h"
+#include "flightplanimage.h"
+#include "flightplanstatus.h"
+
+class Ui_FlightPlan;
+
+class FlightPlanGadgetWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    FlightPlanGadgetWidget(QWidget *parent = 0);
+    ~FlightPlanGadgetWidget();
+
+private slots:
+    void browse();
+    void upload();
+    void useBuiltIn();
+    void start();
+    void stop();
+    void kill();
+    void imageTransactionCompleted(UAVObject *obj, bool success);
+    void statusUpdated(UAVObject *obj);
+
+private:
+    static const int MAX_RETRIES = 3;
+
+    Ui_FlightPlan *m_flightplan;
+    FlightPlanControl *m_control;
+    FlightPlanImage *m_image;
+    FlightPlanStatus *m_status;
+
+    // Upload in progress, blocks are sent one at a time as they are acked
+    QByteArray m_data;
+    quint32 m_crc;
+    int m_offset;
+    int m_length;
+    int m_retries;
+    bool m_uploading;
+
+    void sendBlock();
+    void sendCommand(quint8 command);
+    void finishUpload(const QString &message);
+    static quint32 crc32(const QByteArray &data);
+};
+
+#endif /* FLIGHTPLANGADGETWIDGET_H_ */
@@ -0,0 +1,47 @@
+/**
+ ******************************************************************************
+ *
+ * @file       flightplanplugin.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup FlightPlanGadgetPlugin Flight Plan Gadget Plugin
+ * @{
+ * @brief Uploads precompiled flight plan images and runs the script
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef FLIGHTPLANPLUGIN_H_
+#define FLIGHTPLANPLUGIN_H_
+
+#include <extensionsystem/iplugin.h>
+
+class FlightPlanGadgetFactory;
+
+class FlightPlanPlugin : public ExtensionSystem::IPlugin
+{
+public:
+    FlightPlanPlugin();
+   ~FlightPlanPlugin();
+
+   void extensionsInitialized();
+   bool initialize(const QStringList & arguments, QString * errorString);
+   void shutdown();
+private:
+   FlightPlanGadgetFactory *mf;
+};
+#endif /* FLIGHTPLANPLUGIN_H_ */
@@ -16,6 +16,7 @@ HEADERS += joystickcontrol.h
 HEADERS += gcscontrolgadgetwidget.h
 HEADERS += gcscontrolgadgetfactory.h
 HEADERS += gcscontrolplugin.h
+HEADERS += gcscontrolpath.h
 
 SOURCES += gcscontrolgadget.cpp \
     gcscontrolgadgetconfiguration.cpp \
@@ -24,6 +25,7 @@ SOURCES += gcscontrolgadgetwidget.cpp
 SOURCES += gcscontrolgadgetfactory.cpp
 SOURCES += gcscontrolplugin.cpp
 SOURCES += joystickcontrol.cpp
+SOURCES += gcscontrolpath.cpp
 
 OTHER_FILES += GCSControl.pluginspec
 
@@ -36,7 +36,8 @@
 
 GCSControlGadget::GCSControlGadget(QString classId, GCSControlGadgetWidget *widget, QWidget *parent, QObject *plugin) :
         IUAVGadget(classId, parent),
-        m_widget(widget)
+        m_widget(widget),
+        gcsReceiver(false)
 {
     connect(getManualControlCommand(),SIGNAL(objectUpdated(UAVObject*)),this,SLOT(manualControlCommandUpdated(UAVObject*)));
     connect(widget,SIGNAL(sticksChanged(double,double,double,double)),this,SLOT(sticksChangedLocally(double,double,double,double)));
@@ -54,6 +55,9 @@ GCSControlGadget::GCSControlGadget(QString classId, GCSControlGadgetWidget *widg
     connect(pl->sdlGamepad,SIGNAL(buttonState(ButtonNumber,bool)),this,SLOT(buttonState(ButtonNumber,bool)));
     connect(pl->sdlGamepad,SIGNAL(axesValues(QListInt16)),this,SLOT(axesValues(QListInt16)));
 
+    controlPath = new GCSControlPath(pl->sdlGamepad, this);
+    connect(controlPath,SIGNAL(latencyMeasured(int,int)),widget,SLOT(showLatency(int,int)));
+    connect(widget,SIGNAL(controlChanged(bool)),this,SLOT(controlChanged(bool)));
 }
 
 GCSControlGadget::~GCSControlGadget()
@@ -89,6 +93,18 @@ void GCSControlGadget::loadConfiguration(IUAVGadgetConfiguration* config)
         channelReverse[i]=GCSControlConfig->getChannelsReverse().at(i);
     }
 
+    gcsReceiver = GCSControlConfig->getGCSReceiver();
+    ((GCSControlGadgetWidget *)m_widget)->setGCSReceiverMode(gcsReceiver);
+    controlPath->setChannelsReverse(GCSControlConfig->getChannelsReverse());
+    controlPath->setEnabled(gcsReceiver && ((GCSControlGadgetWidget *)m_widget)->getGCSControl());
+}
+
+/**
+  Sticks go to the control path while GCS control is on in GCS receiver mode
+  */
+void GCSControlGadget::controlChanged(bool enabled)
+{
+    controlPath->setEnabled(gcsReceiver && enabled);
 }
 
 ManualControlCommand* GCSControlGadget::getManualControlCommand() {
@@ -184,7 +200,7 @@ void GCSControlGadget::sticksChangedLocally(double leftX, double leftY, double r
     }
 
     //if we are not in local gcs control mode, ignore the joystick input
-    if (((GCSControlGadgetWidget *)m_widget)->getGCSControl()==false || ((GCSControlGadgetWidget *)m_widget)->getUDPControl())
+    if (((GCSControlGadgetWidget *)m_widget)->getGCSControl()==false || ((GCSControlGadgetWidget *)m_widget)->getUDPControl() || gcsReceiver)
         return;
 
     if((newThrottle != oldThrottle) || (newPitch != oldPitch) || (newYaw != oldYaw) || (newRoll != oldRoll)) {
@@ -387,6 +403,10 @@ void GCSControlGadget::buttonState(ButtonNumber number, bool pressed)
 
 void GCSControlGadget::axesValues(QListInt16 values)
 {
+    // Sent by the control path from the gamepad thread
+    if (gcsReceiver)
+        return;
+
     int chMax = values.length();
     if (rollChannel >= chMax || pitchChannel >= chMax ||
             yawChannel >= chMax || throttleChannel >= chMax ) {
@@ -34,6 +34,7 @@
 #include "sdlgamepad/sdlgamepad.h"
 #include <QTime>
 #include "gcscontrolplugin.h"
+#include "gcscontrolpath.h"
 #include <QUdpSocket>
 #include <QHostAddress>
 
@@ -77,6 +78,8 @@ private:
     double wrap(double input);
     bool channelReverse[8];
     QUdpSocket *control_sock;
+    GCSControlPath *controlPath;
+    bool gcsReceiver;
 
 
 signals:
@@ -86,6 +89,7 @@ protected slots:
     void manualControlCommandUpdated(UAVObject *);
     void sticksChangedLocally(double leftX, double leftY, double rightX, double rightY);
     void readUDPCommand();
+    void controlChanged(bool enabled);
 
     // signals from joystick
     void gamepads(quint8 count);
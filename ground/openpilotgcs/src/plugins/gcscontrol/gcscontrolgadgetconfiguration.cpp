@@ -36,7 +36,8 @@ GCSControlGadgetConfiguration::GCSControlGadgetConfiguration(QString classId, QS
     rollChannel(-1),
     pitchChannel(-1),
     yawChannel(-1),
-    throttleChannel(-1)
+    throttleChannel(-1),
+    gcsReceiver(false)
 {
     int i;
     for (i=0;i<8;i++)
@@ -56,6 +57,7 @@ GCSControlGadgetConfiguration::GCSControlGadgetConfiguration(QString classId, QS
 
         udp_port = qSettings->value("controlPortUDP").toUInt();
         udp_host = QHostAddress(qSettings->value("controlHostUDP").toString());
+        gcsReceiver = qSettings->value("gcsReceiver", false).toBool();
 
         int i;
         for (i=0;i<8;i++)
@@ -122,6 +124,7 @@ IUAVGadgetConfiguration *GCSControlGadgetConfiguration::clone()
 
     m->udp_host = udp_host;
     m->udp_port = udp_port;
+    m->gcsReceiver = gcsReceiver;
 
     int i;
     for (i=0;i<8;i++)
@@ -149,6 +152,7 @@ void GCSControlGadgetConfiguration::saveConfig(QSettings* settings) const {
 
     settings->setValue("controlPortUDP",QString::number(udp_port));
     settings->setValue("controlHostUDP",udp_host.toString());
+    settings->setValue("gcsReceiver", gcsReceiver);
 
     int i;
     for (i=0;i<8;i++)
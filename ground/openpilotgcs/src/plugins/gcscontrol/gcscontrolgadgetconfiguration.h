@@ -61,6 +61,8 @@ class GCSControlGadgetConfiguration : public IUAVGadgetConfiguration
     int getControlsMode() { return controlsMode; }
     QList<int>  getChannelsMapping();
     QList<bool>  getChannelsReverse();
+    void setGCSReceiver(bool enable) { gcsReceiver = enable; }
+    bool getGCSReceiver() { return gcsReceiver; }
 
     buttonSettingsStruct getbuttonSettings(int i){return buttonSettings[i];}
     void setbuttonSettingsAction(int i, int ActionID ){buttonSettings[i].ActionID=ActionID;return;}
@@ -83,6 +85,8 @@ class GCSControlGadgetConfiguration : public IUAVGadgetConfiguration
         bool channelReverse[8];
         int udp_port;
         QHostAddress udp_host;
+        // Send the axes as GCSReceiver channels instead of ManualControlCommand
+        bool gcsReceiver;
 
 
 };
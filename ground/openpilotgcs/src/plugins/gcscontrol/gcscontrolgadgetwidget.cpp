@@ -44,6 +44,7 @@ GCSControlGadgetWidget::GCSControlGadgetWidget(QWidget *parent) : QLabel(parent)
 {
     m_gcscontrol = new Ui_GCSControl();
     m_gcscontrol->setupUi(this);
+    m_gcscontrol->labelLatency->setVisible(false);
 
 
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
@@ -77,6 +78,7 @@ GCSControlGadgetWidget::GCSControlGadgetWidget(QWidget *parent) : QLabel(parent)
     leftY = 0;
     rightX = 0;
     rightY = 0;
+    gcsReceiverMode = false;
 
     // No point enabling OpenGL for the joysticks, and causes
     // issues on some computers:
@@ -110,11 +112,22 @@ void GCSControlGadgetWidget::rightStickClicked(double X, double Y) {
     emit sticksChanged(leftX,leftY,rightX,rightY);
 }
 
+void GCSControlGadgetWidget::showLatency(int meanMs, int maxMs)
+{
+    m_gcscontrol->labelLatency->setText(QString("%1/%2 ms").arg(meanMs).arg(maxMs));
+}
+
 /*!
   \brief Called when the gcs control is toggled and enabled or disables flight write access to manual control command
   */
 void GCSControlGadgetWidget::toggleControl(int state)
 {
+    emit controlChanged(state);
+
+    // The flight side keeps computing ManualControlCommand from the GCSReceiver channels
+    if (gcsReceiverMode)
+        return;
+
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
     UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
     UAVDataObject* obj = dynamic_cast<UAVDataObject*>( objManager->getObject(QString("ManualControlCommand")) );
@@ -205,6 +218,19 @@ bool GCSControlGadgetWidget::getUDPControl(void)
     return m_gcscontrol->checkBoxUDPControl->isChecked();
 }
 
+/*!
+  \brief Selects between sending the sticks as ManualControlCommand and as GCSReceiver channels,
+  GCS control is released first so the ManualControlCommand metadata is restored
+  */
+void GCSControlGadgetWidget::setGCSReceiverMode(bool enable)
+{
+    if (enable == gcsReceiverMode)
+        return;
+    setGCSControl(false);
+    gcsReceiverMode = enable;
+    m_gcscontrol->labelLatency->setVisible(enable);
+}
+
 
 /**
   * @}
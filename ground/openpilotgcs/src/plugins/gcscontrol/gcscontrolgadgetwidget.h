@@ -46,9 +46,11 @@ public:
     bool getGCSControl(void);
     void setUDPControl(bool newState);
     bool getUDPControl(void);
+    void setGCSReceiverMode(bool enable);
 
 signals:
     void sticksChanged(double leftX, double leftY, double rightX, double rightY);
+    void controlChanged(bool enabled);
 
 public slots:
     // signals from parent gadget indicating change from flight
@@ -58,6 +60,8 @@ public slots:
     void leftStickClicked(double X, double Y);
     void rightStickClicked(double X, double Y);
 
+    void showLatency(int meanMs, int maxMs);
+
 protected slots:
     void toggleControl(int state);
     void toggleArmed(int state);
@@ -69,6 +73,7 @@ private:
     Ui_GCSControl *m_gcscontrol;
     UAVObject::Metadata mccInitialData;
     double leftX,leftY,rightX,rightY;
+    bool gcsReceiverMode;
 };
 
 #endif /* GCSControlGADGETWIDGET_H_ */
@@ -0,0 +1,135 @@
+/**
+ ******************************************************************************
+ *
+ * @file       gcscontrolpath.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup GCSControlGadgetPlugin GCSControl Gadget Plugin
+ * @{
+ * @brief Sends the joystick axes as GCSReceiver channels from the gamepad thread
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "gcscontrolpath.h"
+#include "extensionsystem/pluginmanager.h"
+#include "uavobjectmanager.h"
+
+// Sample period, the flight side drops GCSReceiver channels not updated
+// for 100ms (PIOS_GCSRCVR_TIMEOUT_MS)
+#define CONTROL_PERIOD_MS 20
+#define LATENCY_REPORT_MS 1000
+#define CHANNEL_NEUTRAL 1500
+#define CHANNEL_RANGE 500
+
+GCSControlPath::GCSControlPath(SDLGamepad *gamepad, QObject *parent) :
+        QObject(parent),
+        enabled(false),
+        sampleTime(-1),
+        reportTime(0),
+        latencySum(0),
+        latencyMax(0),
+        latencyCount(0)
+{
+    for (int i = 0; i < GCSReceiver::CHANNEL_NUMELEM; ++i)
+        channelReverse[i] = false;
+
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
+    gcsReceiver = GCSReceiver::GetInstance(objManager);
+    connect(gcsReceiver, SIGNAL(transactionCompleted(UAVObject*,bool)), this, SLOT(transactionCompleted(UAVObject*,bool)));
+
+    // Handled in the polling thread, right after the axes are read
+    connect(gamepad, SIGNAL(axesValues(QListInt16)), this, SLOT(axesValues(QListInt16)), Qt::DirectConnection);
+    gamepad->setTickRate(CONTROL_PERIOD_MS);
+    clock.start();
+}
+
+void GCSControlPath::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&mutex);
+    this->enabled = enabled;
+    sampleTime = -1;
+}
+
+void GCSControlPath::setChannelsReverse(const QList<bool> &reverse)
+{
+    QMutexLocker locker(&mutex);
+    for (int i = 0; i < GCSReceiver::CHANNEL_NUMELEM && i < reverse.length(); ++i)
+        channelReverse[i] = reverse.at(i);
+}
+
+/**
+ * Called from the gamepad thread with every sample, axis n is sent as
+ * channel n. The channels are sent on every sample even when the sticks
+ * do not move, the flight side needs them to keep the receiver alive.
+ */
+void GCSControlPath::axesValues(QListInt16 values)
+{
+    QMutexLocker locker(&mutex);
+    if (!enabled)
+        return;
+
+    GCSReceiver::DataFields data = gcsReceiver->getData();
+    for (int i = 0; i < GCSReceiver::CHANNEL_NUMELEM && i < values.length(); ++i)
+    {
+        int value = values.at(i) * CHANNEL_RANGE / 32767;
+        data.Channel[i] = CHANNEL_NEUTRAL + (channelReverse[i] ? -value : value);
+    }
+    if (sampleTime < 0)
+        sampleTime = clock.elapsed();
+    locker.unlock();
+
+    gcsReceiver->setData(data);
+}
+
+/**
+ * Called from the telemetry when an update was sent, the sample it carried
+ * is the newest one so the oldest pending sample gives the latency.
+ */
+void GCSControlPath::transactionCompleted(UAVObject *obj, bool success)
+{
+    Q_UNUSED(obj);
+
+    QMutexLocker locker(&mutex);
+    if (!success || sampleTime < 0)
+        return;
+
+    qint64 now = clock.elapsed();
+    int latency = now - sampleTime;
+    sampleTime = -1;
+    latencySum += latency;
+    latencyMax = qMax(latencyMax, latency);
+    ++latencyCount;
+    if (now - reportTime < LATENCY_REPORT_MS)
+        return;
+
+    int mean = latencySum / latencyCount;
+    int max = latencyMax;
+    reportTime = now;
+    latencySum = 0;
+    latencyMax = 0;
+    latencyCount = 0;
+    locker.unlock();
+
+    emit latencyMeasured(mean, max);
+}
+
+/**
+  * @}
+  * @}
+  */
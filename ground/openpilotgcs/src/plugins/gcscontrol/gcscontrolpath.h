@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ *
+ * @file       gcscontrolpath.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup GCSControlGadgetPlugin GCSControl Gadget Plugin
+ * @{
+ * @brief Sends the joystick axes as GCSReceiver channels from the gamepad thread
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef GCSCONTROLPATH_H
+#define GCSCONTROLPATH_H
+
+#include <QObject>
+#include <QMutex>
+#include <QElapsedTimer>
+#include "sdlgamepad/sdlgamepad.h"
+#include "gcsreceiver.h"
+
+/**
+ * The joystick to flight path when the GCS acts as the receiver. The axes are
+ * handled in the SDL polling thread as they are read, at a fixed rate, and
+ * written to GCSReceiver without going through the GUI thread. GCSReceiver is
+ * unacked and its pending updates are coalesced by the telemetry, so the flight
+ * side always gets the latest sample. The time from a sample to its transmission
+ * is measured and reported with latencyMeasured().
+ */
+class GCSControlPath : public QObject
+{
+    Q_OBJECT
+public:
+    GCSControlPath(SDLGamepad *gamepad, QObject *parent = 0);
+
+    void setEnabled(bool enabled);
+    void setChannelsReverse(const QList<bool> &reverse);
+
+signals:
+    void latencyMeasured(int meanMs, int maxMs);
+
+private slots:
+    void axesValues(QListInt16 values);
+    void transactionCompleted(UAVObject *obj, bool success);
+
+private:
+    GCSReceiver *gcsReceiver;
+    QMutex mutex;
+    QElapsedTimer clock;
+    bool enabled;
+    bool channelReverse[GCSReceiver::CHANNEL_NUMELEM];
+    // Time of the oldest sample not sent yet, -1 if none
+    qint64 sampleTime;
+    qint64 reportTime;
+    qint64 latencySum;
+    int latencyMax;
+    int latencyCount;
+};
+
+#endif // GCSCONTROLPATH_H
@@ -30,6 +30,8 @@
 #include <QtGui>
 #include <QDebug>
 
+#define DRAW_INTERVAL_MS 100
+
 /*
  * Initialize the widget
  */
@@ -63,8 +65,13 @@ GpsConstellationWidget::GpsConstellationWidget(QWidget *parent) : QGraphicsView(
     scene->setSceneRect(world->boundingRect());
     setScene(scene);
 
+    drawTimer.setSingleShot(true);
+    drawTimer.setInterval(DRAW_INTERVAL_MS);
+    connect(&drawTimer, SIGNAL(timeout()), this, SLOT(drawSats()));
+
     // Now create 'maxSatellites' satellite icons which we will move around on the map:
     for (int i=0; i < MAX_SATTELITES;i++) {
+        satDirty[i] = false;
         satellites[i][0] = 0;
         satellites[i][1] = 0;
         satellites[i][2] = 0;
@@ -123,6 +130,28 @@ void GpsConstellationWidget::updateSat(int index, int prn, int elevation, int az
     satellites[index][2] = azimuth;
     satellites[index][3] = snr;
 
+    // A GSV burst updates every satellite, they are drawn together
+    satDirty[index] = true;
+    if (!drawTimer.isActive())
+        drawTimer.start();
+}
+
+void GpsConstellationWidget::drawSats()
+{
+    for (int index = 0; index < MAX_SATTELITES; index++) {
+        if (satDirty[index])
+            drawSat(index);
+        satDirty[index] = false;
+    }
+}
+
+void GpsConstellationWidget::drawSat(int index)
+{
+    const int prn = satellites[index][0];
+    const int elevation = satellites[index][1];
+    const int azimuth = satellites[index][2];
+    const int snr = satellites[index][3];
+
     if (prn && elevation >= 0) {
         QPointF opd = polarToCoord(elevation,azimuth);
         opd += QPointF(-satIcons[index]->boundingRect().center().x(),
@@ -152,7 +181,6 @@ void GpsConstellationWidget::updateSat(int index, int prn, int elevation, int az
     } else {
         satIcons[index]->hide();
     }
-
 }
 
 /**
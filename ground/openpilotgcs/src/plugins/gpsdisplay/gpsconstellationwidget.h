@@ -31,6 +31,7 @@
 #include <QGraphicsView>
 #include <QtSvg/QSvgRenderer>
 #include <QtSvg/QGraphicsSvgItem>
+#include <QTimer>
 
 
 class GpsConstellationWidget : public QGraphicsView
@@ -46,10 +47,13 @@ public slots:
 
 
 private slots:
+   void drawSats();
 
 private:
    static const int MAX_SATTELITES = 16;
    int satellites[MAX_SATTELITES][4];
+   bool satDirty[MAX_SATTELITES];
+   QTimer drawTimer;
    QGraphicsScene *scene;
    QSvgRenderer *renderer;
    QGraphicsSvgItem* world;
@@ -57,6 +61,7 @@ private:
    QGraphicsSimpleTextItem* satTexts[MAX_SATTELITES];
 
    QPointF polarToCoord(int elevation, int azimuth);
+   void drawSat(int index);
 
 protected:
     void showEvent(QShowEvent *event);
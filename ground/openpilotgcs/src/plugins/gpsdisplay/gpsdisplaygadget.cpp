@@ -163,10 +163,5 @@ void GpsDisplayGadget::onDataAvailable() {
 }
 
 void GpsDisplayGadget::processNewSerialData(QByteArray serialData) {
-    int dataLength = serialData.size();
-    const char* data = serialData.constData();
-
-    for(int pos = 0; pos < dataLength; pos++) {
-        parser->processInputStream(data[pos]);
-    }
+    parser->processInputStream(serialData);
 }
@@ -34,13 +34,21 @@
 #include <QtGui>
 #include <QDebug>
 
+#define DISPLAY_UPDATE_MS 100
+#define PACKET_LOG_LINES 200
+
 /*
  * Initialize the widget
  */
-GpsDisplayWidget::GpsDisplayWidget(QWidget *parent) : QWidget(parent)
+GpsDisplayWidget::GpsDisplayWidget(QWidget *parent) : QWidget(parent),
+    dirty(0)
 {
     setupUi(this);
 
+    refreshTimer.setSingleShot(true);
+    refreshTimer.setInterval(DISPLAY_UPDATE_MS);
+    connect(&refreshTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+
     //Not elegant, just load the image for now
     QGraphicsScene *fescene = new QGraphicsScene(this);
     QPixmap earthpix( ":/gpsgadget/images/flatEarth.png" );
@@ -59,100 +67,157 @@ GpsDisplayWidget::~GpsDisplayWidget()
 {
 }
 
+/**
+  * The parser reports every sentence, the display is only refreshed
+  * at DISPLAY_UPDATE_MS with the latest values
+  */
+void GpsDisplayWidget::scheduleRefresh(int what)
+{
+    dirty |= what;
+    if (!refreshTimer.isActive())
+        refreshTimer.start();
+}
+
 void GpsDisplayWidget::setSpeedHeading(double speed, double heading)
 {
-    QString str;
-    speed_value->setText(str.sprintf("%.02f m/s",speed));
-    bear_value->setText(str.sprintf("%.02f deg",heading));
+    this->speed = speed;
+    this->heading = heading;
+    scheduleRefresh(SpeedHeadingDirty);
 }
 
 void GpsDisplayWidget::setDateTime(double date, double time)
 {
-    QString dstring1,dstring2;
-    dstring1.sprintf("%06.0f",date);
-    dstring1.insert(dstring1.length()-2,".");
-    dstring1.insert(dstring1.length()-5,".");
-    dstring2.sprintf("%06.0f",time);
-    dstring2.insert(dstring2.length()-2,":");
-    dstring2.insert(dstring2.length()-5,":");
-    time_value->setText(dstring1 + "    " + dstring2 + " GMT");
+    this->date = date;
+    this->time = time;
+    scheduleRefresh(DateTimeDirty);
 }
 
 void GpsDisplayWidget::setFixType(const QString &fixtype)
 {
-    if(fixtype =="NoGPS") {
-        fix_value->setText("No GPS");
-    } else if (fixtype == "NoFix") {
-        fix_value->setText("Fix not available");
-    } else if (fixtype == "Fix2D") {
-        fix_value->setText("2D");
-    } else if (fixtype =="Fix3D") {
-        fix_value->setText("3D");
-    } else {
-        fix_value->setText("Unknown");
-    }
+    this->fixtype = fixtype;
+    scheduleRefresh(FixTypeDirty);
 }
 
 void GpsDisplayWidget::dumpPacket(const QString &packet)
 {
-    textBrowser->append(packet);
-    if(textBrowser->document()->lineCount() > 200) {
-        QTextCursor tc = textBrowser->textCursor();
-        tc.movePosition(QTextCursor::Start);
-        tc.movePosition(QTextCursor::Down, QTextCursor::KeepAnchor);
-        tc.movePosition(QTextCursor::StartOfLine, QTextCursor::KeepAnchor);
-        tc.removeSelectedText();
-    }
+    // Only the lines the log shows are kept
+    pendingPackets.append(packet);
+    if (pendingPackets.count() > PACKET_LOG_LINES)
+        pendingPackets.removeFirst();
+    scheduleRefresh(PacketsDirty);
 }
 
 void GpsDisplayWidget::setSVs(int sv)
 {
-    QString temp;
-    temp.append(QString::number(sv));
-    status_value->setText(temp);
-    status_value->adjustSize();
+    this->sv = sv;
+    scheduleRefresh(SVsDirty);
 }
 
 void GpsDisplayWidget::setDOP(double hdop, double vdop, double pdop)
 {
-
-    QString str;
-    str.sprintf("%.2f / %.2f / %.2f", hdop, vdop, pdop);
-    dop_value->setText(str);
-
+    this->hdop = hdop;
+    this->vdop = vdop;
+    this->pdop = pdop;
+    scheduleRefresh(DOPDirty);
 }
 
 void GpsDisplayWidget::setPosition(double lat, double lon, double alt)
 {
-    //lat *= 1E-7;
-    //lon *= 1E-7;
-    double deg = floor(fabs(lat));
-    double min = (fabs(lat)-deg)*60;
-    QString str1;
-    str1.sprintf("%.0f%c%.3f' ", deg,0x00b0, min);
-    if (lat>0)
-        str1.append("N");
-    else
-        str1.append("S");
-    coord_value->setText(str1);
-    deg = floor(fabs(lon));
-    min = (fabs(lon)-deg)*60;
-    QString str2;
-    str2.sprintf("%.0f%c%.3f' ", deg,0x00b0, min);
-    if (lon>0)
-        str2.append("E");
-    else
-        str2.append("W");
-    coord_value_2->setText(str2);
-    QString str3;
-    str3.sprintf("%.2f m", alt);
-    coord_value_3->setText(str3);
-
-    // Now place the marker:
-    double wscale = flatEarth->sceneRect().width()/360;
-    double hscale = flatEarth->sceneRect().height()/180;
-    QPointF opd = QPointF((lon+180)*wscale-marker->boundingRect().width()*marker->scale()/2,
-                          (90-lat)*hscale-marker->boundingRect().height()*marker->scale()/2);
-    marker->setTransform(QTransform::fromTranslate( opd.x(), opd.y()) , false);
+    this->lat = lat;
+    this->lon = lon;
+    this->alt = alt;
+    scheduleRefresh(PositionDirty);
+}
+
+void GpsDisplayWidget::refresh()
+{
+    if (dirty & SpeedHeadingDirty) {
+        QString str;
+        speed_value->setText(str.sprintf("%.02f m/s",speed));
+        bear_value->setText(str.sprintf("%.02f deg",heading));
+    }
+
+    if (dirty & DateTimeDirty) {
+        QString dstring1,dstring2;
+        dstring1.sprintf("%06.0f",date);
+        dstring1.insert(dstring1.length()-2,".");
+        dstring1.insert(dstring1.length()-5,".");
+        dstring2.sprintf("%06.0f",time);
+        dstring2.insert(dstring2.length()-2,":");
+        dstring2.insert(dstring2.length()-5,":");
+        time_value->setText(dstring1 + "    " + dstring2 + " GMT");
+    }
+
+    if (dirty & FixTypeDirty) {
+        if(fixtype =="NoGPS") {
+            fix_value->setText("No GPS");
+        } else if (fixtype == "NoFix") {
+            fix_value->setText("Fix not available");
+        } else if (fixtype == "Fix2D") {
+            fix_value->setText("2D");
+        } else if (fixtype =="Fix3D") {
+            fix_value->setText("3D");
+        } else {
+            fix_value->setText("Unknown");
+        }
+    }
+
+    if (dirty & PacketsDirty) {
+        textBrowser->append(pendingPackets.join("\n"));
+        pendingPackets.clear();
+        int extra = textBrowser->document()->lineCount() - PACKET_LOG_LINES;
+        if (extra > 0) {
+            QTextCursor tc = textBrowser->textCursor();
+            tc.movePosition(QTextCursor::Start);
+            tc.movePosition(QTextCursor::Down, QTextCursor::KeepAnchor, extra);
+            tc.movePosition(QTextCursor::StartOfLine, QTextCursor::KeepAnchor);
+            tc.removeSelectedText();
+        }
+    }
+
+    if (dirty & SVsDirty) {
+        QString temp;
+        temp.append(QString::number(sv));
+        status_value->setText(temp);
+        status_value->adjustSize();
+    }
+
+    if (dirty & DOPDirty) {
+        QString str;
+        str.sprintf("%.2f / %.2f / %.2f", hdop, vdop, pdop);
+        dop_value->setText(str);
+    }
+
+    if (dirty & PositionDirty) {
+        double deg = floor(fabs(lat));
+        double min = (fabs(lat)-deg)*60;
+        QString str1;
+        str1.sprintf("%.0f%c%.3f' ", deg,0x00b0, min);
+        if (lat>0)
+            str1.append("N");
+        else
+            str1.append("S");
+        coord_value->setText(str1);
+        deg = floor(fabs(lon));
+        min = (fabs(lon)-deg)*60;
+        QString str2;
+        str2.sprintf("%.0f%c%.3f' ", deg,0x00b0, min);
+        if (lon>0)
+            str2.append("E");
+        else
+            str2.append("W");
+        coord_value_2->setText(str2);
+        QString str3;
+        str3.sprintf("%.2f m", alt);
+        coord_value_3->setText(str3);
+
+        // Now place the marker:
+        double wscale = flatEarth->sceneRect().width()/360;
+        double hscale = flatEarth->sceneRect().height()/180;
+        QPointF opd = QPointF((lon+180)*wscale-marker->boundingRect().width()*marker->scale()/2,
+                              (90-lat)*hscale-marker->boundingRect().height()*marker->scale()/2);
+        marker->setTransform(QTransform::fromTranslate( opd.x(), opd.y()) , false);
+    }
 
+    dirty = 0;
 }
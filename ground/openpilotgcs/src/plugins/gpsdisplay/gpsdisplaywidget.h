@@ -35,6 +35,7 @@
 #include <QGraphicsView>
 #include <QtSvg/QSvgRenderer>
 #include <QtSvg/QGraphicsSvgItem>
+#include <QTimer>
 
 class Ui_GpsDisplayWidget;
 
@@ -54,9 +55,33 @@ private slots:
    void dumpPacket(const QString &packet);
    void setFixType(const QString &fixtype);
    void setDOP(double hdop, double vdop, double pdop);
+   void refresh();
 
 private:
+   enum {
+       SVsDirty = 0x01,
+       PositionDirty = 0x02,
+       DateTimeDirty = 0x04,
+       SpeedHeadingDirty = 0x08,
+       PacketsDirty = 0x10,
+       FixTypeDirty = 0x20,
+       DOPDirty = 0x40
+   };
+
+   void scheduleRefresh(int what);
+
    GpsConstellationWidget * gpsConstellation;
    QGraphicsSvgItem * marker;
+
+   // Latest values, shown on the next refresh
+   QTimer refreshTimer;
+   int dirty;
+   int sv;
+   double lat, lon, alt;
+   double date, time;
+   double speed, heading;
+   QString fixtype;
+   double hdop, vdop, pdop;
+   QStringList pendingPackets;
 };
 #endif /* GPSDISPLAYWIDGET_H_ */
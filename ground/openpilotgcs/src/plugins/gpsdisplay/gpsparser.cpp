@@ -37,6 +37,16 @@ GPSParser::~GPSParser()
 
 }
 
+/**
+ * Called with each block read from the port, parsers that can scan a whole
+ * block override this, the others get the block a character at a time
+ */
+void GPSParser::processInputStream(const QByteArray &data)
+{
+    for (int pos = 0; pos < data.size(); pos++)
+        processInputStream(data[pos]);
+}
+
 void GPSParser::processInputStream(char c) {
 {
     Q_UNUSED(c)}
@@ -38,6 +38,7 @@ class GPSParser: public QObject
 public:
     ~GPSParser();
     virtual void processInputStream(char c);
+    virtual void processInputStream(const QByteArray &data);
 
 protected:
     GPSParser(QObject *parent = 0);
@@ -1,13 +1,20 @@
 #include "gpssnrwidget.h"
 
+#define DRAW_INTERVAL_MS 100
+
 GpsSnrWidget::GpsSnrWidget(QWidget *parent) :
         QGraphicsView(parent) {
 
     scene = new QGraphicsScene(this);
     setScene(scene);
 
+    drawTimer.setSingleShot(true);
+    drawTimer.setInterval(DRAW_INTERVAL_MS);
+    connect(&drawTimer, SIGNAL(timeout()), this, SLOT(drawSats()));
+
     // Now create 'maxSatellites' satellite icons which we will move around on the map:
     for (int i=0; i < MAX_SATTELITES;i++) {
+        satDirty[i] = false;
         satellites[i][0] = 0;
         satellites[i][1] = 0;
         satellites[i][2] = 0;
@@ -63,7 +70,18 @@ void GpsSnrWidget::updateSat(int index, int prn, int elevation, int azimuth, int
     satellites[index][2] = azimuth;
     satellites[index][3] = snr;
 
-    drawSat(index);
+    // A GSV burst updates every satellite, they are drawn together
+    satDirty[index] = true;
+    if (!drawTimer.isActive())
+        drawTimer.start();
+}
+
+void GpsSnrWidget::drawSats() {
+    for(int index = 0 ;index < MAX_SATTELITES ; index++) {
+        if (satDirty[index])
+            drawSat(index);
+        satDirty[index] = false;
+    }
 }
 
 void GpsSnrWidget::drawSat(int index) {
@@ -3,6 +3,7 @@
 
 #include <QGraphicsView>
 #include <QtGui/QGraphicsRectItem>
+#include <QTimer>
 
 class GpsSnrWidget : public QGraphicsView
 {
@@ -16,9 +17,14 @@ signals:
 public slots:
     void updateSat(int index, int prn, int elevation, int azimuth, int snr);
 
+private slots:
+    void drawSats();
+
 private:
     static const int MAX_SATTELITES = 16;
     int satellites[MAX_SATTELITES][4];
+    bool satDirty[MAX_SATTELITES];
+    QTimer drawTimer;
     QGraphicsScene *scene;
     QGraphicsRectItem *boxes[MAX_SATTELITES];
     QGraphicsSimpleTextItem* satTexts[MAX_SATTELITES];
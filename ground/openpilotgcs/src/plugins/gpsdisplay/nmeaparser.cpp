@@ -67,7 +67,7 @@
  */
 NMEAParser::NMEAParser(QObject *parent):GPSParser(parent)
 {
-    bufferInit(&gpsRxBuffer, (unsigned char *)gpsRxData, 512);
+    gpsRxBuffer.reserve(NMEA_RXBUFFERSIZE);
     gpsRxOverflow=0;
 }
 
@@ -76,19 +76,58 @@ NMEAParser::~NMEAParser()
 
 }
 
+void NMEAParser::processInputStream(char c)
+{
+        processInputStream(QByteArray(1, c));
+}
+
 /**
- * Called each time there are data in the input buffer
+ * Called each time there are data in the input buffer, every complete
+ * sentence of the block is processed and the unfinished one is kept
  */
-void NMEAParser::processInputStream(char c)
+void NMEAParser::processInputStream(const QByteArray &data)
 {
-        if( !bufferAddToEnd(&gpsRxBuffer, c) )
+        gpsRxBuffer.append(data);
+
+        int pos = 0;
+        forever
+        {
+                // look for a start of NMEA packet
+                int start = gpsRxBuffer.indexOf('$', pos);
+                if(start < 0)
+                {
+                        pos = gpsRxBuffer.size();
+                        break;
+                }
+                // then for its <CR><LF> end
+                int end = gpsRxBuffer.indexOf("\r\n", start + 1);
+                if(end < 0)
+                {
+                        pos = start;
+                        break;
+                }
+                // although NMEA strings should be 80 characters or less,
+                // receive buffer errors can generate erroneous packets.
+                // Protect against packet buffer overflow
+                int length = qMin(end - start - 1, NMEA_BUFFERSIZE - 1);
+                memcpy(NmeaPacket, gpsRxBuffer.constData() + start + 1, length);
+                NmeaPacket[length] = 0;
+                #ifdef NMEA_DEBUG_PKT
+                    qDebug() << NmeaPacket;
+                #endif
+                emit packet(QString(NmeaPacket));
+                nmeaProcess(NmeaPacket);
+                pos = end + 2;
+        }
+        gpsRxBuffer.remove(0, pos);
+
+        if(gpsRxBuffer.size() >= NMEA_RXBUFFERSIZE)
         {
-                // no space in buffer
-                // count overflow
+                // no sentence end in a full buffer, we're logjammed,
+                // flush entire buffer
                 gpsRxOverflow++;
-                return;
+                gpsRxBuffer.clear();
         }
-        nmeaProcess(&gpsRxBuffer);
 }
 
 
@@ -144,132 +183,56 @@ void NMEAParser::nmeaTerminateAtChecksum(char* gps_buffer)
 
 /**
  * Prosesses NMEA sentences
- * \param[in] cBuffer for prosessed nmea sentences
+ * \param[in] Received nmea sentence, without the '$' and <CR><LF>
  * \return Message code for found packet
- * \return 0xFF NO packet found
+ * \return 0xFF packet not known
  */
-uint8_t NMEAParser::nmeaProcess(cBuffer* rxBuffer)
+uint8_t NMEAParser::nmeaProcess(char* packet)
 {
-        uint8_t foundpacket = NMEA_NODATA;
-        uint8_t startFlag = FALSE;
-        //u08 data;
-        uint16_t i,j;
-
-        // process the receive buffer
-        // go through buffer looking for packets
-        while(rxBuffer->datalength)
-        {
-                // look for a start of NMEA packet
-                if(bufferGetAtIndex(rxBuffer,0) == '$')
-                {
-                        // found start
-                        startFlag = TRUE;
-                        // when start is found, we leave it intact in the receive buffer
-                        // in case the full NMEA string is not completely received.  The
-                        // start will be detected in the next nmeaProcess iteration.
+        uint8_t foundpacket = NMEA_UNKNOWN;
 
-                        // done looking for start
-                        break;
-                }
-                else
-                        bufferGetFromFront(rxBuffer);
+        // check message type and process appropriately
+        if(!strncmp(packet, "GPGGA", 5))
+        {
+                // process packet of this type
+                nmeaProcessGPGGA(packet);
+                // report packet type
+                foundpacket = NMEA_GPGGA;
         }
-
-        // if we detected a start, look for end of packet
-        if(startFlag)
+        else if(!strncmp(packet, "GPVTG", 5))
         {
-                for(i=1; i<(rxBuffer->datalength)-1; i++)
-                {
-                        // check for end of NMEA packet <CR><LF>
-                        if((bufferGetAtIndex(rxBuffer,i) == '\r') && (bufferGetAtIndex(rxBuffer,i+1) == '\n'))
-                        {
-                                // have a packet end
-                                // dump initial '$'
-                                bufferGetFromFront(rxBuffer);
-                                // copy packet to NmeaPacket
-                                for(j=0; j<(i-1); j++)
-                                {
-                                        // although NMEA strings should be 80 characters or less,
-                                        // receive buffer errors can generate erroneous packets.
-                                        // Protect against packet buffer overflow
-                                        if(j<(NMEA_BUFFERSIZE-1))
-                                                NmeaPacket[j] = bufferGetFromFront(rxBuffer);
-                                        else
-                                                bufferGetFromFront(rxBuffer);
-                                }
-                                // null terminate it
-                                if (j<(NMEA_BUFFERSIZE-1)) {
-                                        NmeaPacket[j] = 0;
-                                } else {
-                                        NmeaPacket[NMEA_BUFFERSIZE-1] = 0;
-                                }
-                                // dump <CR><LF> from rxBuffer
-                                bufferGetFromFront(rxBuffer);
-                                bufferGetFromFront(rxBuffer);
-                                //DEBUG
-                                #ifdef NMEA_DEBUG_PKT
-                                    qDebug() << NmeaPacket;
-                                #endif
-                                    emit packet(QString(NmeaPacket));
-                                // found a packet
-                                // done with this processing session
-                                foundpacket = NMEA_UNKNOWN;
-                                break;
-                        }
-                }
+                // process packet of this type
+                nmeaProcessGPVTG(packet);
+                // report packet type
+                foundpacket = NMEA_GPVTG;
         }
-
-        if(foundpacket)
+        else if(!strncmp(packet, "GPGSA", 5))
         {
-                // check message type and process appropriately
-                if(!strncmp(NmeaPacket, "GPGGA", 5))
-                {
-                        // process packet of this type
-                        nmeaProcessGPGGA(NmeaPacket);
-                        // report packet type
-                        foundpacket = NMEA_GPGGA;
-                }
-                else if(!strncmp(NmeaPacket, "GPVTG", 5))
-                {
-                        // process packet of this type
-                        nmeaProcessGPVTG(NmeaPacket);
-                        // report packet type
-                        foundpacket = NMEA_GPVTG;
-                }
-                else if(!strncmp(NmeaPacket, "GPGSA", 5))
-                {
-                        // process packet of this type
-                        nmeaProcessGPGSA(NmeaPacket);
-                        // report packet type
-                        foundpacket = NMEA_GPGSA;
-                }
-                else if(!strncmp(NmeaPacket, "GPRMC", 5))
-                {
-                        // process packet of this type
-                        nmeaProcessGPRMC(NmeaPacket);
-                        // report packet type
-                        foundpacket = NMEA_GPRMC;
-                }
-                else if(!strncmp(NmeaPacket, "GPGSV", 5))
-                {
-                        // Process packet of this type
-                        nmeaProcessGPGSV(NmeaPacket);
-                        // rerpot packet type
-                        foundpacket = NMEA_GPGSV;
-                }
-                else if(!strncmp(NmeaPacket, "GPZDA", 5))
-                {
-                        // Process packet of this type
-                        nmeaProcessGPZDA(NmeaPacket);
-                        // rerpot packet type
-                        foundpacket = NMEA_GPZDA;
-                }
+                // process packet of this type
+                nmeaProcessGPGSA(packet);
+                // report packet type
+                foundpacket = NMEA_GPGSA;
+        }
+        else if(!strncmp(packet, "GPRMC", 5))
+        {
+                // process packet of this type
+                nmeaProcessGPRMC(packet);
+                // report packet type
+                foundpacket = NMEA_GPRMC;
+        }
+        else if(!strncmp(packet, "GPGSV", 5))
+        {
+                // Process packet of this type
+                nmeaProcessGPGSV(packet);
+                // rerpot packet type
+                foundpacket = NMEA_GPGSV;
         }
-        else if(rxBuffer->datalength >= rxBuffer->size)
+        else if(!strncmp(packet, "GPZDA", 5))
         {
-                // if we found no packet, and the buffer is full
-                // we're logjammed, flush entire buffer
-                bufferFlush(rxBuffer);
+                // Process packet of this type
+                nmeaProcessGPZDA(packet);
+                // rerpot packet type
+                foundpacket = NMEA_GPZDA;
         }
         return foundpacket;
 }
@@ -31,11 +31,12 @@
 #include <QObject>
 #include <QtCore>
 #include <stdint.h>
-#include "buffer.h"
 #include "gpsparser.h"
 
 // constants/macros/typdefs
 #define NMEA_BUFFERSIZE		128
+// Received bytes kept while waiting for the end of a sentence
+#define NMEA_RXBUFFERSIZE	512
 
 typedef struct struct_GpsData
 {
@@ -63,10 +64,11 @@ public:
    NMEAParser(QObject *parent = 0);
    ~NMEAParser();
    void processInputStream(char c);
+   void processInputStream(const QByteArray &data);
    char* nmeaGetPacketBuffer(void);
    char nmeaChecksum(char* gps_buffer);
    void nmeaTerminateAtChecksum(char* gps_buffer);
-   uint8_t nmeaProcess(cBuffer* rxBuffer);
+   uint8_t nmeaProcess(char* packet);
    void nmeaProcessGPGGA(char* packet);
    void nmeaProcessGPRMC(char* packet);
    void nmeaProcessGPVTG(char* packet);
@@ -74,8 +76,7 @@ public:
    void nmeaProcessGPGSV(char* packet);
    void nmeaProcessGPZDA(char* packet);
    GpsData_t GpsData;
-   cBuffer gpsRxBuffer;
-   char gpsRxData[512];
+   QByteArray gpsRxBuffer;
    char NmeaPacket[NMEA_BUFFERSIZE];
    uint32_t numUpdates;
    uint32_t numErrors;
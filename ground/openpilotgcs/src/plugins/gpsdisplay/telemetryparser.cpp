@@ -42,6 +42,8 @@ TelemetryParser::TelemetryParser(QObject *parent) : GPSParser(parent)
     UAVDataObject *gpsObj = dynamic_cast<UAVDataObject*>(objManager->getObject("GPSPosition"));
     if (gpsObj != NULL) {
         connect(gpsObj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateGPS(UAVObject*)));
+        gpsObj->addInterest();
+        shownObjects.append(gpsObj);
     } else {
         qDebug() << "Error: Object is unknown (GPSPosition).";
     }
@@ -49,6 +51,8 @@ TelemetryParser::TelemetryParser(QObject *parent) : GPSParser(parent)
     gpsObj = dynamic_cast<UAVDataObject*>(objManager->getObject("GPSTime"));
     if (gpsObj != NULL) {
         connect(gpsObj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateTime(UAVObject*)));
+        gpsObj->addInterest();
+        shownObjects.append(gpsObj);
     } else {
         qDebug() << "Error: Object is unknown (GPSTime).";
     }
@@ -56,13 +60,16 @@ TelemetryParser::TelemetryParser(QObject *parent) : GPSParser(parent)
     gpsObj = dynamic_cast<UAVDataObject*>(objManager->getObject("GPSSatellites"));
     if (gpsObj != NULL) {
         connect(gpsObj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateSats(UAVObject*)));
+        gpsObj->addInterest();
+        shownObjects.append(gpsObj);
     }
 
 }
 
 TelemetryParser::~TelemetryParser()
 {
-
+    foreach (UAVObject* obj, shownObjects)
+        obj->removeInterest();
 }
 
 
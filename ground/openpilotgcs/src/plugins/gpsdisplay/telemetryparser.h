@@ -50,6 +50,9 @@ public slots:
    void updateTime(UAVObject* object1);
    void updateSats(UAVObject* object1);
 
+private:
+   // Held as shown while the parser runs
+   QList<UAVObject*> shownObjects;
 };
 
 #endif // TELEMETRYPARSER_H
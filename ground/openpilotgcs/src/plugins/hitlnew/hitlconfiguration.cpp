@@ -41,6 +41,9 @@ HITLConfiguration::HITLConfiguration(QString classId, QSettings* qSettings, QObj
         settings.inPort = 0;
         settings.latitude = "";
         settings.longitude = "";
+        settings.lockstep = false;
+        settings.firmwarePath = "";
+        settings.lockstepTicks = 50;
 
         //if a saved configuration exists load it
         if(qSettings != 0) {
@@ -55,6 +58,9 @@ HITLConfiguration::HITLConfiguration(QString classId, QSettings* qSettings, QObj
                 settings.inPort = qSettings->value("inPort").toInt();
                 settings.latitude = qSettings->value("latitude").toString();
                 settings.longitude = qSettings->value("longitude").toString();                
+                settings.lockstep = qSettings->value("lockstep").toBool();
+                settings.firmwarePath = qSettings->value("firmwarePath").toString();
+                settings.lockstepTicks = qSettings->value("lockstepTicks", 50).toInt();
         }
 }
 
@@ -82,5 +88,8 @@ void HITLConfiguration::saveConfig(QSettings* qSettings) const {
     qSettings->setValue("inPort", settings.inPort);
     qSettings->setValue("latitude", settings.latitude);
     qSettings->setValue("longitude", settings.longitude);
+    qSettings->setValue("lockstep", settings.lockstep);
+    qSettings->setValue("firmwarePath", settings.firmwarePath);
+    qSettings->setValue("lockstepTicks", settings.lockstepTicks);
 }
 
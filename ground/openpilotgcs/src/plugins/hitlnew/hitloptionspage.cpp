@@ -65,6 +65,8 @@ QWidget *HITLOptionsPage::createPage(QWidget *parent)
 	m_optionsPage->executablePath->setPromptDialogTitle(tr("Choose flight simulator executable"));
 	m_optionsPage->dataPath->setExpectedKind(Utils::PathChooser::Directory);
 	m_optionsPage->dataPath->setPromptDialogTitle(tr("Choose flight simulator data directory"));
+	m_optionsPage->firmwarePath->setExpectedKind(Utils::PathChooser::File);
+	m_optionsPage->firmwarePath->setPromptDialogTitle(tr("Choose SimPosix executable"));
 
     // Restore the contents from the settings:
 	foreach(SimulatorCreator* creator, HITLPlugin::typeSimulators)
@@ -85,6 +87,9 @@ QWidget *HITLOptionsPage::createPage(QWidget *parent)
 	m_optionsPage->inputPort->setText(QString::number(config->Settings().inPort));
 	m_optionsPage->latitude->setText(config->Settings().latitude);
 	m_optionsPage->longitude->setText(config->Settings().longitude);
+	m_optionsPage->lockstep->setChecked(config->Settings().lockstep);
+	m_optionsPage->firmwarePath->setPath(config->Settings().firmwarePath);
+	m_optionsPage->lockstepTicks->setValue(config->Settings().lockstepTicks);
 
     return optionsPageWidget;
 }
@@ -106,6 +111,9 @@ void HITLOptionsPage::apply()
 	settings.outPort = m_optionsPage->outputPort->text().toInt();
 	settings.longitude = m_optionsPage->longitude->text();
 	settings.latitude = m_optionsPage->latitude->text();
+	settings.lockstep = m_optionsPage->lockstep->isChecked();
+	settings.firmwarePath = m_optionsPage->firmwarePath->path();
+	settings.lockstepTicks = m_optionsPage->lockstepTicks->value();
 
 	config->setSimulatorSettings(settings);
 }
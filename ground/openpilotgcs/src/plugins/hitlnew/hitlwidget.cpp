@@ -139,6 +139,7 @@ void HITLWidget::startButtonClicked()
 		connect(simulator, SIGNAL(autopilotDisconnected()), this, SLOT(onAutopilotDisconnect()),Qt::QueuedConnection);
 		connect(simulator, SIGNAL(simulatorConnected()), this, SLOT(onSimulatorConnect()),Qt::QueuedConnection);
 		connect(simulator, SIGNAL(simulatorDisconnected()), this, SLOT(onSimulatorDisconnect()),Qt::QueuedConnection);
+		connect(simulator, SIGNAL(loopStatistics(double,int,double)), this, SLOT(onLoopStatistics(double,int,double)),Qt::QueuedConnection);
 
 		// Initialize connection status
 		if ( simulator->isAutopilotConnected() )
@@ -173,6 +174,7 @@ void HITLWidget::stopButtonClicked()
 	widget->simLabel->setStyleSheet(QString::fromUtf8("QFrame{\n""background-color: transparent; color: white}"));
 	widget->apLabel->setText(strAutopilotDisconnected);
 	widget->simLabel->setText(strSimulatorDisconnected);
+	widget->loopLabel->clear();
 	if(simulator)
 	{
 		QMetaObject::invokeMethod(simulator, "onDeleteSimulator",Qt::QueuedConnection);
@@ -213,3 +215,8 @@ void HITLWidget::onSimulatorDisconnect()
 	widget->simLabel->setText(" " + simulator->Name() +" disconnected ");
 	qxtLog->info(QString("HITL: %1 disconnected").arg(simulator->Name()));
 }
+
+void HITLWidget::onLoopStatistics(double latency, int maxLatency, double jitter)
+{
+	widget->loopLabel->setText(QString(" Loop %1 ms (max %2), jitter %3 ms ").arg(latency, 0, 'f', 1).arg(maxLatency).arg(jitter, 0, 'f', 1));
+}
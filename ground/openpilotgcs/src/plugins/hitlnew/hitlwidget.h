@@ -54,6 +54,7 @@ private slots:
     void onAutopilotDisconnect();
 	void onSimulatorConnect();
 	void onSimulatorDisconnect();
+	void onLoopStatistics(double latency, int maxLatency, double jitter);
 
 private:
     Ui_HITLWidget* widget;
@@ -54,6 +54,19 @@ Simulator::Simulator(const SimulatorSettings& params) :
 	simConnectionStatus(false),
 	txTimer(NULL),
 	simTimer(NULL),
+	statsTimer(NULL),
+	telMngr(NULL),
+	frameSentTime(-1),
+	lastPacketTime(-1),
+	lastPacketInterval(-1),
+	latencySum(0),
+	latencyMax(0),
+	latencyCount(0),
+	jitterSum(0),
+	jitterCount(0),
+	stepState(STEP_IDLE),
+	firmwareProcess(NULL),
+	stepTimer(NULL),
 	name("")
 {
 	// move to thread
@@ -87,6 +100,29 @@ Simulator::~Simulator()
 		delete simTimer;
 		simTimer = NULL;
 	}
+
+	if(statsTimer)
+	{
+		delete statsTimer;
+		statsTimer = NULL;
+	}
+
+	if(stepTimer)
+	{
+		delete stepTimer;
+		stepTimer = NULL;
+	}
+
+	if(firmwareProcess)
+	{
+		firmwareProcess->disconnect();
+		// Closing its stdin ends the lockstep firmware
+		firmwareProcess->closeWriteChannel();
+		if(!firmwareProcess->waitForFinished(1000))
+			firmwareProcess->kill();
+		delete firmwareProcess;
+		firmwareProcess = NULL;
+	}
 	// NOTE: Does not currently work, may need to send control+c to through the terminal
 	if (simProcess != NULL)
 	{
@@ -108,6 +144,9 @@ void Simulator::onDeleteSimulator(void)
 	Simulator::setStarted(false);
 	// [2]
 	Simulator::Instances().removeOne(simulatorId);
+	// [3]
+	foreach (UAVObject* obj, shownObjects)
+		obj->removeInterest();
 
 	disconnect(this);
 	delete this;
@@ -137,7 +176,7 @@ void Simulator::onStart()
 	telStats = GCSTelemetryStats::GetInstance(objManager);
 
 	// Listen to autopilot connection events
-	TelemetryManager* telMngr = pm->getObject<TelemetryManager>();
+	telMngr = pm->getObject<TelemetryManager>();
 	connect(telMngr, SIGNAL(connected()), this, SLOT(onAutopilotConnect()));
 	connect(telMngr, SIGNAL(disconnected()), this, SLOT(onAutopilotDisconnect()));
 	//connect(telStats, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(telStatsUpdated(UAVObject*)));
@@ -170,9 +209,15 @@ void Simulator::onStart()
 
 	connect(inSocket, SIGNAL(readyRead()), this, SLOT(receiveUpdate()),Qt::DirectConnection);
 
-	// Setup transmit timer
+	// The simulator gets the actuators as soon as they come from the autopilot,
+	// both run in the telemetry thread so there is no hop in between
+	connect(actDesired, SIGNAL(objectUnpacked(UAVObject*)), this, SLOT(actuatorsUpdated(UAVObject*)));
+	actDesired->addInterest();
+	shownObjects.append(actDesired);
+
+	// Setup transmit timer, only fires while no actuators come in
 	txTimer = new QTimer();
-	connect(txTimer, SIGNAL(timeout()), this, SLOT(transmitUpdate()),Qt::DirectConnection);
+	connect(txTimer, SIGNAL(timeout()), this, SLOT(onTxTimeout()),Qt::DirectConnection);
 	txTimer->setInterval(updatePeriod);
 	txTimer->start();
 	// Setup simulator connection timer
@@ -180,8 +225,15 @@ void Simulator::onStart()
 	connect(simTimer, SIGNAL(timeout()), this, SLOT(onSimulatorConnectionTimeout()),Qt::DirectConnection);
 	simTimer->setInterval(simTimeout);
 	simTimer->start();
+	statsTimer = new QTimer();
+	connect(statsTimer, SIGNAL(timeout()), this, SLOT(publishStatistics()),Qt::DirectConnection);
+	statsTimer->start(1000);
+
+	if (settings.lockstep)
+		startLockstep();
 
 	// setup time
+	loopTime.start();
 	time = new QTime();
 	time->start();
 	current.T=0;
@@ -214,20 +266,221 @@ void Simulator::receiveUpdate()
 		// Process incomming data
 		processUpdate(datagram);
 	 }
+
+	// Jitter of the simulator packets
+	int now = loopTime.elapsed();
+	if (lastPacketTime >= 0)
+	{
+		int interval = now - lastPacketTime;
+		if (lastPacketInterval >= 0)
+		{
+			jitterSum += qAbs(interval - lastPacketInterval);
+			++jitterCount;
+		}
+		lastPacketInterval = interval;
+	}
+	lastPacketTime = now;
+
+	// Pass the new state on to the autopilot right away
+	if (!autopilotConnectionStatus)
+		return;
+	if (settings.lockstep)
+	{
+		// Packets that come in during a step only update the sensors, the
+		// next step sends the latest values
+		if (stepState == STEP_IDLE)
+			beginStep();
+		return;
+	}
+	sendFrame();
+}
+
+/**
+ * Sends the sensor objects due, together and unacknowledged, instead of each
+ * one on its own telemetry period
+ */
+void Simulator::sendFrame()
+{
+	int now = loopTime.elapsed();
+	QList<UAVObject*> objs;
+	for (int i = 0; i < frameObjects.count(); ++i)
+	{
+		FrameObject& fo = frameObjects[i];
+		// Every step has all the sensors, so a run does not depend on timing
+		if (settings.lockstep || fo.lastSent < 0 || now - fo.lastSent >= fo.period)
+		{
+			objs.append(fo.obj);
+			fo.lastSent = now;
+		}
+	}
+	if (objs.isEmpty())
+		return;
+	telMngr->sendObjects(objs);
+	// The latency is counted from the oldest frame not answered yet
+	if (frameSentTime < 0)
+		frameSentTime = now;
+}
+
+void Simulator::actuatorsUpdated(UAVObject* obj)
+{
+	Q_UNUSED(obj);
+	// In lockstep the actuators are requested once the step is done
+	if (settings.lockstep)
+		return;
+	if (frameSentTime >= 0)
+	{
+		int latency = loopTime.elapsed() - frameSentTime;
+		latencySum += latency;
+		latencyMax = qMax(latencyMax, latency);
+		++latencyCount;
+		frameSentTime = -1;
+	}
+	transmitUpdate();
+	// Only keep the timer going for when the autopilot goes quiet
+	txTimer->start();
+}
+
+void Simulator::onTxTimeout()
+{
+	// Keeps the simulator fed while the autopilot is quiet, but a lockstep
+	// step has to finish first
+	if (stepState == STEP_IDLE)
+		transmitUpdate();
+}
+
+/**
+ * Lockstep runs the simulation firmware (SimPosix -l) on a simulated clock
+ * that only moves when ticks are written to its stdin. Each simulator packet
+ * is then one step:
+ *  - the sensor frame is sent, followed by a request for FlightStatus; its
+ *    answer means the firmware has taken in the frame
+ *  - the firmware runs exactly lockstepTicks ticks and prints its time
+ *  - ActuatorDesired is requested and passed on to the simulator
+ * The telemetry link to SimPosix is set up as usual, over UDP.
+ */
+void Simulator::startLockstep()
+{
+	firmwareProcess = new QProcess();
+	firmwareProcess->setReadChannel(QProcess::StandardOutput);
+	connect(firmwareProcess, SIGNAL(readyReadStandardOutput()), this, SLOT(lockstepStepped()),Qt::DirectConnection);
+	firmwareProcess->start(settings.firmwarePath, QStringList() << "-l");
+	if (!firmwareProcess->waitForStarted())
+	{
+		emit processOutput("Error starting SimPosix: " + firmwareProcess->errorString() + "\n");
+		return;
+	}
+	emit processOutput(QString("Lockstep with %1, %2 ticks per step\n").arg(settings.firmwarePath).arg(settings.lockstepTicks));
+
+	connect(flightStatus, SIGNAL(transactionCompleted(UAVObject*,bool)), this, SLOT(lockstepSynced(UAVObject*,bool)),Qt::DirectConnection);
+	connect(actDesired, SIGNAL(transactionCompleted(UAVObject*,bool)), this, SLOT(lockstepActuators(UAVObject*,bool)),Qt::DirectConnection);
+	stepTimer = new QTimer();
+	stepTimer->setSingleShot(true);
+	connect(stepTimer, SIGNAL(timeout()), this, SLOT(lockstepTimeout()),Qt::DirectConnection);
+}
+
+void Simulator::beginStep()
+{
+	if (!firmwareProcess || firmwareProcess->state() != QProcess::Running)
+		return;
+	stepState = STEP_SYNC;
+	stepTimer->start(2000);
+	sendFrame();
+	flightStatus->requestUpdate();
+}
+
+void Simulator::lockstepSynced(UAVObject* obj, bool success)
+{
+	Q_UNUSED(obj);
+	if (stepState != STEP_SYNC)
+		return;
+	if (!success)
+	{
+		lockstepTimeout();
+		return;
+	}
+	stepState = STEP_RUNNING;
+	firmwareProcess->write(QString("%1\n").arg(settings.lockstepTicks).toAscii());
+}
+
+void Simulator::lockstepStepped()
+{
+	while (firmwareProcess->canReadLine())
+	{
+		QString line = QString(firmwareProcess->readLine()).trimmed();
+		bool ok;
+		line.toULongLong(&ok);
+		// Anything but the simulated time is output of the firmware
+		if (!ok)
+		{
+			emit processOutput(line);
+			continue;
+		}
+		if (stepState == STEP_RUNNING)
+		{
+			stepState = STEP_ACTUATORS;
+			actDesired->requestUpdate();
+		}
+	}
+}
+
+void Simulator::lockstepActuators(UAVObject* obj, bool success)
+{
+	Q_UNUSED(obj);
+	if (stepState != STEP_ACTUATORS)
+		return;
+	stepTimer->stop();
+	stepState = STEP_IDLE;
+	if (!success)
+		return;
+	if (frameSentTime >= 0)
+	{
+		int latency = loopTime.elapsed() - frameSentTime;
+		latencySum += latency;
+		latencyMax = qMax(latencyMax, latency);
+		++latencyCount;
+		frameSentTime = -1;
+	}
+	transmitUpdate();
+	txTimer->start();
+}
+
+void Simulator::lockstepTimeout()
+{
+	if (stepState == STEP_IDLE)
+		return;
+	emit processOutput("Lockstep step did not complete, starting over\n");
+	stepTimer->stop();
+	stepState = STEP_IDLE;
+	frameSentTime = -1;
+}
+
+void Simulator::publishStatistics()
+{
+	if (latencyCount == 0 && jitterCount == 0)
+		return;
+	emit loopStatistics(latencyCount ? (double)latencySum / latencyCount : 0, latencyMax,
+						jitterCount ? (double)jitterSum / jitterCount : 0);
+	latencySum = 0;
+	latencyMax = 0;
+	latencyCount = 0;
+	jitterSum = 0;
+	jitterCount = 0;
 }
 
 void Simulator::setupObjects()
 {
-	setupInputObject(actDesired, 100);
+	// In lockstep the actuators are only sent when asked for, after a step
+	setupInputObject(actDesired, settings.lockstep ? 0 : updatePeriod);
+	frameObjects.clear();
 	setupOutputObject(altActual, 250);
-        setupOutputObject(attActual, 10);
+        setupOutputObject(attActual, 0);
         //setupOutputObject(attActual, 100);
         setupOutputObject(gpsPos, 250);
         setupOutputObject(posActual, 250);
         setupOutputObject(velActual, 250);
         setupOutputObject(posHome, 1000);
-        setupOutputObject(accels, 10);
-        setupOutputObject(gyros, 10);
+        setupOutputObject(accels, 0);
+        setupOutputObject(gyros, 0);
         //setupOutputObject(attRaw, 100);
 
 
@@ -241,12 +494,16 @@ void Simulator::setupInputObject(UAVObject* obj, int updatePeriod)
 	UAVObject::SetFlightAccess(mdata, UAVObject::ACCESS_READWRITE);
 	UAVObject::SetGcsAccess(mdata, UAVObject::ACCESS_READWRITE);
 	UAVObject::SetFlightTelemetryAcked(mdata, false);
-	UAVObject::SetFlightTelemetryUpdateMode(mdata, UAVObject::UPDATEMODE_PERIODIC);
+	UAVObject::SetFlightTelemetryUpdateMode(mdata, updatePeriod > 0 ? UAVObject::UPDATEMODE_PERIODIC : UAVObject::UPDATEMODE_MANUAL);
 	mdata.flightTelemetryUpdatePeriod = updatePeriod;
 	UAVObject::SetGcsTelemetryUpdateMode(mdata, UAVObject::UPDATEMODE_MANUAL);
 	obj->setMetadata(mdata);
 }
 
+/**
+ * Output objects are sent by sendFrame(), in the frame after each simulator
+ * packet but at most every updatePeriod ms, 0 for every frame
+ */
 void Simulator::setupOutputObject(UAVObject* obj, int updatePeriod)
 {
 	UAVObject::Metadata mdata;
@@ -255,9 +512,14 @@ void Simulator::setupOutputObject(UAVObject* obj, int updatePeriod)
 	UAVObject::SetGcsAccess(mdata, UAVObject::ACCESS_READWRITE);
 	UAVObject::SetFlightTelemetryUpdateMode(mdata,UAVObject::UPDATEMODE_MANUAL);
 	UAVObject::SetGcsTelemetryAcked(mdata, false);
-	UAVObject::SetGcsTelemetryUpdateMode(mdata, UAVObject::UPDATEMODE_PERIODIC);
-	mdata.gcsTelemetryUpdatePeriod = updatePeriod;
+	UAVObject::SetGcsTelemetryUpdateMode(mdata, UAVObject::UPDATEMODE_MANUAL);
 	obj->setMetadata(mdata);
+
+	FrameObject fo;
+	fo.obj = obj;
+	fo.period = updatePeriod;
+	fo.lastSent = -1;
+	frameObjects.append(fo);
 }
 
 void Simulator::onAutopilotConnect()
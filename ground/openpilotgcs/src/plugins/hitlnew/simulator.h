@@ -31,6 +31,7 @@
 #include <QObject>
 #include <QUdpSocket>
 #include <QTimer>
+#include <QTime>
 #include <QProcess>
 #include "qscopedpointer.h"
 #include "uavtalk/telemetrymanager.h"
@@ -106,6 +107,9 @@ typedef struct _CONNECTION
         bool startSim;
 	QString latitude;
 	QString longitude;
+	bool lockstep;
+	QString firmwarePath;
+	int lockstepTicks;
 } SimulatorSettings;
 
 class Simulator : public QObject
@@ -142,6 +146,7 @@ signals:
 	void processOutput(QString str);
 	void deleteSimProcess();
 	void myStart();
+	void loopStatistics(double latency, int maxLatency, double jitter);
 public slots:
 	Q_INVOKABLE virtual bool setupProcess() { return true;}
 private slots:
@@ -152,6 +157,13 @@ private slots:
 	void onAutopilotDisconnect();
 	void onSimulatorConnectionTimeout();
 	void telStatsUpdated(UAVObject* obj);
+	void actuatorsUpdated(UAVObject* obj);
+	void publishStatistics();
+	void onTxTimeout();
+	void lockstepSynced(UAVObject* obj, bool success);
+	void lockstepStepped();
+	void lockstepActuators(UAVObject* obj, bool success);
+	void lockstepTimeout();
 	Q_INVOKABLE void onDeleteSimulator(void);
 
 	virtual void transmitUpdate() = 0;
@@ -171,6 +183,8 @@ protected:
 	QUdpSocket* outSocket;
 
 	ActuatorDesired* actDesired;
+	// Held as shown while the simulator runs
+	QList<UAVObject*> shownObjects;
         ManualControlCommand* manCtrlCommand;
         FlightStatus* flightStatus;
         BaroAltitude* altActual;
@@ -190,6 +204,13 @@ protected:
 	QMutex lock;
 
 private:
+	// An object sent to the autopilot in the frame following each simulator
+	// packet, at most every period ms
+	typedef struct {
+		UAVObject* obj;
+		int period;
+		int lastSent;
+	} FrameObject;
 
 	int updatePeriod;
 	int simTimeout;
@@ -197,6 +218,23 @@ private:
 	volatile bool simConnectionStatus;
 	QTimer* txTimer;
 	QTimer* simTimer;
+	QTimer* statsTimer;
+	TelemetryManager* telMngr;
+	QList<FrameObject> frameObjects;
+	// Loop statistics, times from loopTime in ms, -1 when not set
+	QTime loopTime;
+	int frameSentTime;
+	int lastPacketTime;
+	int lastPacketInterval;
+	int latencySum;
+	int latencyMax;
+	int latencyCount;
+	int jitterSum;
+	int jitterCount;
+	// Lockstep with SimPosix: sensors, sync, firmware ticks, actuators
+	enum { STEP_IDLE, STEP_SYNC, STEP_RUNNING, STEP_ACTUATORS } stepState;
+	QProcess* firmwareProcess;
+	QTimer* stepTimer;
 	QString name;
 	QString simulatorId;
 	volatile static bool isStarted;
@@ -205,6 +243,9 @@ private:
 	void setupOutputObject(UAVObject* obj, int updatePeriod);
 	void setupInputObject(UAVObject* obj, int updatePeriod);
 	void setupObjects();
+	void sendFrame();
+	void startLockstep();
+	void beginStep();
 };
 
 
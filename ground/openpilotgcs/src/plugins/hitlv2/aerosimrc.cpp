@@ -34,10 +34,18 @@ AeroSimRCSimulator::AeroSimRCSimulator(const SimulatorSettings &params)
     : Simulator(params)
 {
     udpCounterASrecv = 0;
+    link = NULL;
+    linkReader = NULL;
 }
 
 AeroSimRCSimulator::~AeroSimRCSimulator()
 {
+    if (linkReader) {
+        linkReader->stop();
+        linkReader->wait(500);
+        delete linkReader;
+    }
+    delete link;
 }
 
 bool AeroSimRCSimulator::setupProcess()
@@ -49,6 +57,19 @@ bool AeroSimRCSimulator::setupProcess()
 void AeroSimRCSimulator::setupUdpPorts(const QString &host, int inPort, int outPort)
 {
     Q_UNUSED(outPort)
+    if (settings.sharedMemory) {
+        link = new ShmLink();
+        if (link->attach()) {
+            linkReader = new AeroSimRCLinkReader(link);
+            connect(linkReader, SIGNAL(packetReceived(QByteArray)), this, SLOT(receivePacket(QByteArray)));
+            linkReader->start(QThread::TimeCriticalPriority);
+            emit processOutput("Using shared memory link\n");
+            return;
+        }
+        emit processOutput("Shared memory link unavailable, using UDP\n");
+        delete link;
+        link = NULL;
+    }
     if (inSocket->bind(QHostAddress(host), inPort))
         emit processOutput("Successfully bound to address " + host + ", port " + QString::number(inPort) + "\n");
     else
@@ -90,7 +111,9 @@ void AeroSimRCSimulator::transmitUpdate()
     stream << armed << mode;            // flight status
     stream << udpCounterASrecv;         // packet counter
 
-    if (outSocket->writeDatagram(data, QHostAddress(settings.remoteAddress), settings.outPort) == -1) {
+    if (link) {
+        link->publish(ShmLink::GcsToSim, data);
+    } else if (outSocket->writeDatagram(data, QHostAddress(settings.remoteAddress), settings.outPort) == -1) {
         qDebug() << "write failed: " << outSocket->errorString();
     }
 
@@ -493,3 +516,31 @@ void AeroSimRCSimulator::asMatrix2RPY(const QMatrix4x4 &m, QVector3D &rpy)
     rpy.setY(pitch * RAD2DEG);
     rpy.setZ(yaw   * RAD2DEG);
 }
+
+//-----------------------------------------------------------------------------
+
+AeroSimRCLinkReader::AeroSimRCLinkReader(ShmLink *link, QObject *parent)
+    : QThread(parent),
+      link(link),
+      stopped(false)
+{
+}
+
+void AeroSimRCLinkReader::run()
+{
+    quint32 sequence = 0;
+    QByteArray packet;
+    while (!stopped) {
+        link->wait();
+        // the semaphore may count several packets, only the latest is kept
+        if (!stopped && link->read(ShmLink::SimToGcs, packet, sequence))
+            emit packetReceived(packet);
+    }
+}
+
+void AeroSimRCLinkReader::stop()
+{
+    stopped = true;
+    // wake the thread up
+    link->signal();
+}
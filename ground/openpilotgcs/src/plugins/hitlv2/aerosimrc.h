@@ -32,7 +32,30 @@
 #include <QVector3D>
 #include <QQuaternion>
 #include <QMatrix4x4>
+#include <QThread>
 #include "simulatorv2.h"
+#include "aerosimrc/src/shmlink.h"
+
+/**
+ * Waits on the shared memory link for packets from the AeroSimRC plugin,
+ * used instead of the UDP socket when both run on this computer.
+ */
+class AeroSimRCLinkReader : public QThread
+{
+    Q_OBJECT
+
+public:
+    AeroSimRCLinkReader(ShmLink *link, QObject *parent = 0);
+    void run();
+    void stop();
+
+signals:
+    void packetReceived(const QByteArray &data);
+
+private:
+    ShmLink *link;
+    volatile bool stopped;
+};
 
 class AeroSimRCSimulator: public Simulator
 {
@@ -50,6 +73,8 @@ private slots:
 
 private:
     quint32 udpCounterASrecv;   //keeps track of udp packets received by ASim
+    ShmLink *link;
+    AeroSimRCLinkReader *linkReader;
 
     void processUpdate(const QByteArray &data);
 
@@ -41,6 +41,7 @@ QTime ledTimer;
 
 UdpSender *sndr;
 UdpReceiver *rcvr;
+ShmLink *link = NULL;
 
 const float RAD2DEG = (float)(180.0 / M_PI);
 const float DEG2RAD = (float)(M_PI / 180.0);
@@ -56,6 +57,7 @@ extern "C" int __stdcall DllMain(void*, quint32 fdwReason, void*)
         rcvr->wait(500);
         delete rcvr;
         delete sndr;
+        delete link;
         qDebug("------");
         break;
     case 1:
@@ -107,8 +109,21 @@ SIM_DLL_EXPORT void AeroSIMRC_Plugin_Init(pluginInit *p)
     rcvr = new UdpReceiver(ini->getInputMap(), ini->isToRX());
     rcvr->init(ini->localHost(), ini->localPort());
 
+    if (ini->isSharedMemory()) {
+        link = new ShmLink();
+        if (link->attach()) {
+            sndr->setLink(link);
+            rcvr->setLink(link);
+        } else {
+            qDebug() << "shared memory unavailable, using UDP";
+            delete link;
+            link = NULL;
+        }
+    }
+
     // run thread
-    rcvr->start();
+    if (!link)
+        rcvr->start();
 
     delete ini;
 
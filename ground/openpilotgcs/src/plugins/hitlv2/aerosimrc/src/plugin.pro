@@ -21,12 +21,14 @@ HEADERS = \
     plugin.h \
     qdebughandler.h \
     udpconnect.h \
+    shmlink.h \
     settings.h
 
 SOURCES = \
     qdebughandler.cpp \
     plugin.cpp \
     udpconnect.cpp \
+    shmlink.cpp \
     settings.cpp
 
 # Resemble the AeroSimRC directory structure and copy plugin files and resources
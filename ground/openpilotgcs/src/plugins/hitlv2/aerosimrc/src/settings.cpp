@@ -36,6 +36,7 @@ Settings::Settings(QString settingsPath, QObject *parent) :
    sendToPort = 40100;
    listenOnHost = "127.0.0.1";
    listenOnPort = 40200;
+   sharedMemory = false;
    channels.reserve(60);
    for (quint8 i = 0; i < 10; ++i)
        inputMap << 255;
@@ -53,6 +54,7 @@ void Settings::read()
     listenOnPort = settings->value("listen_on_port", listenOnPort).toInt();
     sendToHost = settings->value("send_to_host", sendToHost).toString();
     sendToPort = settings->value("send_to_port", sendToPort).toInt();
+    sharedMemory = settings->value("shared_memory", sharedMemory).toBool();
 
     QString allChannels = settings->value("all_channels").toString();
     QString chan;
@@ -44,6 +44,7 @@ public:
     quint16 remotePort() { return sendToPort; }
     QString localHost() { return listenOnHost; }
     quint16 localPort() { return listenOnPort; }
+    bool isSharedMemory() { return sharedMemory; }
     QList<quint8> getInputMap() { return inputMap; }
     QList<quint8> getOutputMap() { return outputMap; }
     bool isToRX() { return sendToRX; }
@@ -57,6 +58,7 @@ private:
     quint16 sendToPort;
     QString listenOnHost;
     quint16 listenOnPort;
+    bool sharedMemory;
     QList<quint8> inputMap;
     QList<quint8> outputMap;
     bool sendToRX;
@@ -0,0 +1,121 @@
+/**
+ ******************************************************************************
+ *
+ * @file       shmlink.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup 3rdParty Third-party integration
+ * @{
+ * @addtogroup AeroSimRC AeroSimRC proxy plugin
+ * @{
+ * @brief AeroSimRC simulator to HITL proxy plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "shmlink.h"
+#include <QDebug>
+#include <string.h>
+
+ShmLink::ShmLink(const QString &key)
+    : memory(key),
+      ready(key + ".ready", 0, QSystemSemaphore::Open)
+{
+}
+
+ShmLink::~ShmLink()
+{
+    detach();
+}
+
+bool ShmLink::attach()
+{
+    if (memory.isAttached())
+        return true;
+
+    if (memory.create(sizeof(Layout))) {
+        // first side up initialises the slots
+        memory.lock();
+        memset(memory.data(), 0, sizeof(Layout));
+        layout()->magic = MAGIC;
+        memory.unlock();
+    } else if (memory.error() != QSharedMemory::AlreadyExists || !memory.attach()) {
+        qDebug() << "ShmLink::attach" << memory.errorString();
+        return false;
+    }
+
+    if (memory.size() < (int)sizeof(Layout)) {
+        qDebug() << "ShmLink::attach segment too small" << memory.size();
+        memory.detach();
+        return false;
+    }
+
+    // the creator may still be initialising the segment
+    memory.lock();
+    bool valid = (layout()->magic == MAGIC);
+    memory.unlock();
+    if (!valid) {
+        qDebug() << "ShmLink::attach unknown segment";
+        memory.detach();
+    }
+    return valid;
+}
+
+void ShmLink::detach()
+{
+    if (memory.isAttached())
+        memory.detach();
+}
+
+void ShmLink::publish(Direction dir, const QByteArray &packet)
+{
+    if (!memory.isAttached())
+        return;
+
+    Slot &slot = layout()->slot[dir];
+    quint32 length = qMin(packet.size(), (int)SLOT_SIZE);
+
+    slot.sequence.fetchAndAddOrdered(1);
+    slot.length = length;
+    memcpy(slot.data, packet.constData(), length);
+    slot.sequence.fetchAndAddOrdered(1);
+}
+
+bool ShmLink::read(Direction dir, QByteArray &packet, quint32 &lastSequence)
+{
+    if (!memory.isAttached())
+        return false;
+
+    Slot &slot = layout()->slot[dir];
+
+    // a writer holds the slot for a memcpy only, a few retries are enough
+    for (int retry = 0; retry < 100; ++retry) {
+        quint32 before = slot.sequence.fetchAndAddOrdered(0);
+        if (before & 1)
+            continue;
+        if (before == lastSequence)
+            return false;
+
+        quint32 length = qMin(slot.length, (quint32)SLOT_SIZE);
+        packet.resize(length);
+        memcpy(packet.data(), slot.data, length);
+
+        if (slot.sequence.fetchAndAddOrdered(0) == (int)before) {
+            lastSequence = before;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,90 @@
+/**
+ ******************************************************************************
+ *
+ * @file       shmlink.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup 3rdParty Third-party integration
+ * @{
+ * @addtogroup AeroSimRC AeroSimRC proxy plugin
+ * @{
+ * @brief AeroSimRC simulator to HITL proxy plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef SHMLINK_H
+#define SHMLINK_H
+
+#include <QSharedMemory>
+#include <QSystemSemaphore>
+#include <QByteArray>
+#include <QAtomicInt>
+
+/**
+ * Single host transport between the AeroSimRC plugin and the HITLv2 gadget.
+ *
+ * One shared memory segment holds a slot per direction carrying the same
+ * "AERO"/"RCMD" packets as the UDP transport. Each slot has one writer and is
+ * guarded by a sequence counter (odd while a packet is being written), so
+ * neither side ever blocks the other. The simulator side also releases a
+ * system semaphore after each packet, the gadget waits on it instead of
+ * polling.
+ */
+class ShmLink
+{
+public:
+    enum Direction {
+        SimToGcs = 0,
+        GcsToSim = 1
+    };
+
+    explicit ShmLink(const QString &key = "OpenPilot.AeroSimRC");
+    ~ShmLink();
+
+    bool attach();
+    void detach();
+    bool isAttached() const { return memory.isAttached(); }
+
+    // writer side, one writer per direction
+    void publish(Direction dir, const QByteArray &packet);
+    // false if nothing newer than lastSequence was published
+    bool read(Direction dir, QByteArray &packet, quint32 &lastSequence);
+
+    void signal() { ready.release(); }
+    void wait() { ready.acquire(); }
+
+private:
+    static const quint32 MAGIC = 0x4F50534D; // "OPSM"
+    enum { SLOT_SIZE = 256 };
+
+    struct Slot {
+        QBasicAtomicInt sequence;
+        quint32 length;
+        char data[SLOT_SIZE];
+    };
+
+    struct Layout {
+        quint32 magic;
+        Slot slot[2];
+    };
+
+    Layout *layout() { return static_cast<Layout *>(memory.data()); }
+
+    QSharedMemory memory;
+    QSystemSemaphore ready;
+};
+
+#endif // SHMLINK_H
@@ -35,6 +35,7 @@ UdpSender::UdpSender(const QList<quint8> map,
 {
     qDebug() << this << "UdpSender::UdpSender thread:" << thread();
     outSocket = NULL;
+    link = NULL;
     for (int i = 0; i < 8; ++i)
         channels << 0.0;
     channelsMap = map;
@@ -106,7 +107,12 @@ void UdpSender::sendDatagram(const simToPlugin *stp)
     // packet counter
     out << packetsSended;
 
-    outSocket->writeDatagram(data, outHost, outPort);
+    if (link) {
+        link->publish(ShmLink::SimToGcs, data);
+        link->signal();
+    } else {
+        outSocket->writeDatagram(data, outHost, outPort);
+    }
     ++packetsSended;
 }
 
@@ -121,6 +127,8 @@ UdpReceiver::UdpReceiver(const QList<quint8> map,
 
     stopped = false;
     inSocket = NULL;
+    link = NULL;
+    linkSequence = 0;
     for (int i = 0; i < 10; ++i)
         channels << -1.0;
     channelsMap = map;
@@ -166,6 +174,12 @@ void UdpReceiver::setChannels(pluginToSim *pts)
 {
     QMutexLocker locker(&mutex);
 
+    if (link) {
+        QByteArray packet;
+        if (link->read(ShmLink::GcsToSim, packet, linkSequence))
+            processDatagram(packet);
+    }
+
     for (int i = 0; i < 10; ++i) {
         quint8 mapTo = channelsMap.at(i);
         if (mapTo != 255) {
@@ -35,6 +35,7 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include "aerosimrcdatastruct.h"
+#include "shmlink.h"
 
 class UdpSender : public QObject
 {
@@ -43,11 +44,13 @@ public:
     explicit UdpSender(const QList<quint8> map, bool isTX, QObject *parent = 0);
     ~UdpSender();
     void init(const QString &remoteHost, quint16 remotePort);
+    void setLink(ShmLink *shm) { link = shm; }
     void sendDatagram(const simToPlugin *stp);
     quint32 pcks() { return packetsSended; }
 
 private:
     QUdpSocket *outSocket;
+    ShmLink *link;
     QHostAddress outHost;
     quint16 outPort;
     QList<float> channels;
@@ -64,6 +67,8 @@ public:
     explicit UdpReceiver(const QList<quint8> map, bool isRX, QObject *parent = 0);
     ~UdpReceiver();
     void init(const QString &localHost, quint16 localPort);
+    // with a link the commands are read on setChannels, the thread is not started
+    void setLink(ShmLink *shm) { link = shm; }
     void run();
     void stop();
     // function getChannels for other threads
@@ -77,6 +82,8 @@ private:
     volatile bool stopped;
     QMutex mutex;
     QUdpSocket *inSocket;
+    ShmLink *link;
+    quint32 linkSequence;
     QList<float> channels;
     QList<quint8> channelsMap;
     bool sendToRX;
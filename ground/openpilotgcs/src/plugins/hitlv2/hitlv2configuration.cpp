@@ -39,6 +39,7 @@ HITLConfiguration::HITLConfiguration(QString classId,
     int inPort              = 40100;
     QString remoteAddress   = "127.0.0.1";
     int outPort             = 40200;
+    bool sharedMemory       = false;
     QString binPath         = "";
     QString dataPath        = "";
 
@@ -74,6 +75,7 @@ HITLConfiguration::HITLConfiguration(QString classId,
         settings.inPort             = qSettings->value("inPort", inPort).toInt();
         settings.remoteAddress      = qSettings->value("remoteAddress", remoteAddress).toString();
         settings.outPort            = qSettings->value("outPort", outPort).toInt();
+        settings.sharedMemory       = qSettings->value("sharedMemory", sharedMemory).toBool();
         settings.binPath            = qSettings->value("binPath", binPath).toString();
         settings.dataPath           = qSettings->value("dataPath", dataPath).toString();
 
@@ -106,6 +108,7 @@ HITLConfiguration::HITLConfiguration(QString classId,
         settings.inPort             = inPort;
         settings.remoteAddress      = remoteAddress;
         settings.outPort            = outPort;
+        settings.sharedMemory       = sharedMemory;
         settings.binPath            = binPath;
         settings.dataPath           = dataPath;
 
@@ -149,6 +152,7 @@ void HITLConfiguration::saveConfig(QSettings* qSettings) const
     qSettings->setValue("inPort", settings.inPort);
     qSettings->setValue("remoteAddress", settings.remoteAddress);
     qSettings->setValue("outPort", settings.outPort);
+    qSettings->setValue("sharedMemory", settings.sharedMemory);
     qSettings->setValue("binPath", settings.binPath);
     qSettings->setValue("dataPath", settings.dataPath);
 
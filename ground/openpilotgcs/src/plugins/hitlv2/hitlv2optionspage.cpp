@@ -68,6 +68,7 @@ QWidget *HITLOptionsPage::createPage(QWidget *parent)
     m_optionsPage->inputPort->setText(QString::number(config->Settings().inPort));
     m_optionsPage->remoteAddress->setText(config->Settings().remoteAddress);
     m_optionsPage->outputPort->setText(QString::number(config->Settings().outPort));
+    m_optionsPage->sharedMemory->setChecked(config->Settings().sharedMemory);
     m_optionsPage->executablePath->setPath(config->Settings().binPath);
     m_optionsPage->dataPath->setPath(config->Settings().dataPath);
 
@@ -109,6 +110,7 @@ void HITLOptionsPage::apply()
     settings.inPort         = m_optionsPage->inputPort->text().toInt();
     settings.remoteAddress  = m_optionsPage->remoteAddress->text();
     settings.outPort        = m_optionsPage->outputPort->text().toInt();
+    settings.sharedMemory   = m_optionsPage->sharedMemory->isChecked();
     settings.binPath        = m_optionsPage->executablePath->path();
     settings.dataPath       = m_optionsPage->dataPath->path();
 
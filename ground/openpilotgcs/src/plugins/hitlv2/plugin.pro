@@ -13,7 +13,8 @@ HEADERS += \
     hitlv2optionspage.h \
     hitlv2plugin.h \
     hitlv2widget.h \
-    simulatorv2.h
+    simulatorv2.h \
+    aerosimrc/src/shmlink.h
 
 SOURCES += \
     aerosimrc.cpp \
@@ -23,7 +24,8 @@ SOURCES += \
     hitlv2optionspage.cpp \
     hitlv2plugin.cpp \
     hitlv2widget.cpp \
-    simulatorv2.cpp
+    simulatorv2.cpp \
+    aerosimrc/src/shmlink.cpp
 
 FORMS += \
     hitlv2optionspage.ui \
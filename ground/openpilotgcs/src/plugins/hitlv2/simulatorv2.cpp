@@ -87,6 +87,8 @@ void Simulator::onDeleteSimulator(void)
 
     Simulator::setStarted(false);
     Simulator::Instances().removeOne(simulatorId);
+    foreach (UAVObject* obj, shownObjects)
+        obj->removeInterest();
 
     disconnect(this);
     delete this;
@@ -190,10 +192,25 @@ void Simulator::receiveUpdate()
         transmitUpdate();
 }
 
+void Simulator::receivePacket(const QByteArray& data)
+{
+    simTimer->start();
+    if (!simConnectionStatus) {
+        simConnectionStatus = true;
+        emit simulatorConnected();
+    }
+
+    processUpdate(data);
+    if (!settings.manualOutput)
+        transmitUpdate();
+}
+
 void Simulator::setupObjects()
 {
     if (settings.gcsReciever) {
         setupInputObject(actCommand, settings.outputRate);
+        actCommand->addInterest();
+        shownObjects.append(actCommand);
         setupOutputObject(gcsReceiver);
     } else if (settings.manualControl) {
 //        setupInputObject(actDesired);
@@ -62,6 +62,7 @@ typedef struct _CONNECTION
     int inPort;
     QString remoteAddress;
     int outPort;
+    bool sharedMemory;
     QString binPath;
     QString dataPath;
 
@@ -128,6 +129,10 @@ signals:
 public slots:
     Q_INVOKABLE virtual bool setupProcess() { return true; }
 
+protected slots:
+    // packets from transports other than the UDP sockets
+    void receivePacket(const QByteArray& data);
+
 private slots:
     void onStart();
     void receiveUpdate();
@@ -172,6 +177,8 @@ protected:
     GPSPosition *gpsPosition;
     GCSReceiver *gcsReceiver;
     ActuatorCommand *actCommand;
+    // Held as shown while the simulator runs
+    QList<UAVObject*> shownObjects;
     AttitudeSettings *attSettings;
     SonarAltitude *sonarAlt;
 
@@ -2,6 +2,8 @@
 #define IPCONNECTION_INTERNAL_H
 
 #include "ipconnectionplugin.h"
+#include <QtCore/QMutex>
+#include <QtNetwork/QUdpSocket>
 
 //Simple class for creating & destroying a socket in the real-time thread
 //Needed because sockets need to be created in the same thread that they're used
@@ -17,7 +19,44 @@ public:
 public slots:
 
     void onOpenDevice(QString HostName, int Port, bool UseTCP);
-    void onCloseDevice(QAbstractSocket *ipSocket);
+    void onCloseDevice(QIODevice *ipDevice);
+};
+
+//Stream device over a connected UDP socket. The small frames written during one
+//event loop pass go out as one datagram, received datagrams are appended to a
+//single buffer the reader takes its bytes from. Writes may come from any thread,
+//the datagrams are always sent from the thread of the device.
+class UdpDatagramDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+
+    UdpDatagramDevice(QUdpSocket *socket, QObject *parent = 0);
+
+    bool isSequential() const { return true; }
+    qint64 bytesAvailable() const;
+    qint64 bytesToWrite() const;
+    void close();
+
+protected:
+
+    qint64 readData(char *data, qint64 maxSize);
+    qint64 writeData(const char *data, qint64 maxSize);
+
+private slots:
+
+    void onReadyRead();
+    void flush();
+
+private:
+
+    QUdpSocket *m_socket;
+    QByteArray m_readBuffer;
+    int m_readPos;
+    QByteArray m_writeBuffer;
+    mutable QMutex m_writeMutex;
+    bool m_flushPending;
 };
 
 #endif // IPCONNECTION_INTERNAL_H
@@ -42,6 +42,7 @@
 #include <QtNetwork/QUdpSocket>
 #include <QWaitCondition>
 #include <QMutex>
+#include <QThread>
 #include <coreplugin/threadmanager.h>
 
 #include <QDebug>
@@ -52,7 +53,10 @@ QWaitCondition openDeviceWait;
 QWaitCondition closeDeviceWait;
 //QReadWriteLock dummyLock;
 QMutex ipConMutex;
-QAbstractSocket *ret;
+QIODevice *ret;
+
+//Largest datagram sent, small enough not to be fragmented on the usual links
+static const int MAX_DATAGRAM_SIZE = 1400;
 
 IPConnection::IPConnection(IPconnectionConnection *connection) : QObject()
 {
@@ -60,8 +64,8 @@ IPConnection::IPConnection(IPconnectionConnection *connection) : QObject()
 
     QObject::connect(connection, SIGNAL(CreateSocket(QString,int,bool)),
                      this, SLOT(onOpenDevice(QString,int,bool)));
-    QObject::connect(connection, SIGNAL(CloseSocket(QAbstractSocket*)),
-                     this, SLOT(onCloseDevice(QAbstractSocket*)));
+    QObject::connect(connection, SIGNAL(CloseSocket(QIODevice*)),
+                     this, SLOT(onCloseDevice(QIODevice*)));
 }
 
 /*IPConnection::~IPConnection()
@@ -92,7 +96,16 @@ void IPConnection::onOpenDevice(QString HostName, int Port, bool UseTCP)
 
         //in blocking mode so we wait for the connection to succeed
         if (ipSocket->waitForConnected(Timeout)) {
-            ret = ipSocket;
+            if (UseTCP) {
+                //telemetry frames are small, don't let Nagle hold them back
+                ipSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+                ipSocket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+                ret = ipSocket;
+            } else {
+                UdpDatagramDevice *device = new UdpDatagramDevice(static_cast<QUdpSocket*>(ipSocket), this);
+                device->open(QIODevice::ReadWrite | QIODevice::Unbuffered);
+                ret = device;
+            }
             openDeviceWait.wakeAll();
             ipConMutex.unlock();
             return;
@@ -107,16 +120,116 @@ void IPConnection::onOpenDevice(QString HostName, int Port, bool UseTCP)
     ipConMutex.unlock();
 }
 
-void IPConnection::onCloseDevice(QAbstractSocket *ipSocket)
+void IPConnection::onCloseDevice(QIODevice *ipDevice)
 {
     ipConMutex.lock();
-    ipSocket->close ();
-    delete(ipSocket);
+    ipDevice->close ();
+    delete(ipDevice);
     closeDeviceWait.wakeAll();
     ipConMutex.unlock();
 }
 
 
+UdpDatagramDevice::UdpDatagramDevice(QUdpSocket *socket, QObject *parent) :
+    QIODevice(parent),
+    m_socket(socket),
+    m_readPos(0),
+    m_flushPending(false)
+{
+    m_socket->setParent(this);
+    connect(m_socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+}
+
+qint64 UdpDatagramDevice::bytesAvailable() const
+{
+    return m_readBuffer.size() - m_readPos + QIODevice::bytesAvailable();
+}
+
+qint64 UdpDatagramDevice::bytesToWrite() const
+{
+    QMutexLocker locker(&m_writeMutex);
+    return m_writeBuffer.size() + QIODevice::bytesToWrite();
+}
+
+void UdpDatagramDevice::close()
+{
+    flush();
+    m_socket->close();
+    QIODevice::close();
+}
+
+qint64 UdpDatagramDevice::readData(char *data, qint64 maxSize)
+{
+    int size = qMin((qint64)(m_readBuffer.size() - m_readPos), maxSize);
+    memcpy(data, m_readBuffer.constData() + m_readPos, size);
+    m_readPos += size;
+    if (m_readPos == m_readBuffer.size()) {
+        m_readBuffer.clear();
+        m_readPos = 0;
+    }
+    return size;
+}
+
+qint64 UdpDatagramDevice::writeData(const char *data, qint64 maxSize)
+{
+    bool flushNow;
+    {
+        QMutexLocker locker(&m_writeMutex);
+        m_writeBuffer.append(data, maxSize);
+        //the socket may only be used from the thread of the device
+        flushNow = m_writeBuffer.size() >= MAX_DATAGRAM_SIZE && QThread::currentThread() == thread();
+        if (!flushNow && !m_flushPending) {
+            //sent once the event loop of that thread runs, with whatever else was written until then
+            m_flushPending = true;
+            QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+        }
+    }
+    if (flushNow)
+        flush();
+    return maxSize;
+}
+
+void UdpDatagramDevice::onReadyRead()
+{
+    //drop what was read already only when it is most of the buffer
+    if (m_readPos > m_readBuffer.size() / 2) {
+        m_readBuffer.remove(0, m_readPos);
+        m_readPos = 0;
+    }
+    bool received = false;
+    while (m_socket->hasPendingDatagrams()) {
+        int size = m_socket->pendingDatagramSize();
+        int end = m_readBuffer.size();
+        m_readBuffer.resize(end + size);
+        size = m_socket->readDatagram(m_readBuffer.data() + end, size);
+        m_readBuffer.resize(end + qMax(size, 0));
+        received |= size > 0;
+    }
+    if (received)
+        emit readyRead();
+}
+
+void UdpDatagramDevice::flush()
+{
+    QByteArray buffer;
+    {
+        QMutexLocker locker(&m_writeMutex);
+        m_flushPending = false;
+        buffer = m_writeBuffer;
+        m_writeBuffer.clear();
+    }
+    int pos = 0;
+    while (pos < buffer.size()) {
+        int size = qMin(buffer.size() - pos, MAX_DATAGRAM_SIZE);
+        if (m_socket->write(buffer.constData() + pos, size) < 0)
+            break;
+        pos += size;
+    }
+    if (pos > 0)
+        emit bytesWritten(pos);
+}
+
+
 IPConnection * connection = 0;
 
 IPconnectionConnection::IPconnectionConnection()
@@ -71,10 +71,10 @@ protected slots:
 
 signals: //For the benefit of IPConnection
     void CreateSocket(QString HostName, int Port, bool UseTCP);
-    void CloseSocket(QAbstractSocket *socket);
+    void CloseSocket(QIODevice *socket);
 
 private:
-       QAbstractSocket *ipSocket;
+       QIODevice *ipSocket;
        IPconnectionConfiguration *m_config;
        IPconnectionOptionsPage *m_optionspage;
        //QSettings* settings;
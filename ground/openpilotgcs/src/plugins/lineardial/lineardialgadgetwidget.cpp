@@ -31,6 +31,9 @@
 #include <QtOpenGL/QGLWidget>
 #include <QDebug>
 
+// Offset of the text of the QGraphicsTextItems the dials were designed with
+#define TEXT_MARGIN 4
+
 LineardialGadgetWidget::LineardialGadgetWidget(QWidget *parent) : QGraphicsView(parent)
 {
     setMinimumSize(32,32);
@@ -43,6 +46,7 @@ LineardialGadgetWidget::LineardialGadgetWidget(QWidget *parent) : QGraphicsView(
     paint();
 
     obj1 = NULL;
+    interest = new UAVObjectInterest(this);
     fieldName = NULL;
     fieldValue = NULL;
     indexTarget = 0;
@@ -50,9 +54,10 @@ LineardialGadgetWidget::LineardialGadgetWidget(QWidget *parent) : QGraphicsView(
     places = 0;
     factor = 1;
 
-    // This timer mechanism makes the index rotate smoothly
+    // This timer mechanism makes the index rotate smoothly,
+    // it ticks on the frame clock shared by all instruments
     connect(&dialTimer, SIGNAL(timeout()), this, SLOT(moveIndex()));
-    dialTimer.start(30);
+    dialTimer.start();
 
 }
 
@@ -79,6 +84,7 @@ void LineardialGadgetWidget::connectInput(QString object1, QString nfield1) {
 
     if (obj1 != NULL)
         disconnect(obj1,SIGNAL(objectUpdated(UAVObject*)),this,SLOT(updateIndex(UAVObject*)));
+    interest->clear();
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
     UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
 
@@ -89,6 +95,7 @@ void LineardialGadgetWidget::connectInput(QString object1, QString nfield1) {
         obj1 = dynamic_cast<UAVDataObject*>( objManager->getObject(object1) );
         if (obj1 != NULL ) {
             connect(obj1, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateIndex(UAVObject*)));
+            interest->addObject(obj1);
             if(nfield1.contains("-"))
             {
                 QStringList fieldSubfield = nfield1.split("-", QString::SkipEmptyParts);
@@ -102,7 +109,7 @@ void LineardialGadgetWidget::connectInput(QString object1, QString nfield1) {
                 haveSubField1 = false;
             }
             if (fieldName)
-                fieldName->setPlainText(nfield1);
+                fieldName->setText(nfield1);
             updateIndex(obj1);
 
         } else {
@@ -136,18 +143,17 @@ void LineardialGadgetWidget::updateIndex(UAVObject *object1) {
             if (fieldSymbol) {
                 // If we defined a symbol, we will look for a matching
                 // SVG element to display:
-                if (m_renderer->elementExists("symbol-" + s)) {
-                    fieldSymbol->setElementId("symbol-" + s);
-                } else {
-                    fieldSymbol->setElementId("symbol");
-                }
+                QString symbol = m_renderer->elementExists("symbol-" + s) ? "symbol-" + s : "symbol";
+                if (fieldSymbol->elementId() != symbol)
+                    fieldSymbol->setElementId(symbol);
             }
         }
 
-        if (fieldValue)
-            fieldValue->setPlainText(s);
+        // Only relayout the text when it changed
+        if (fieldValue && fieldValue->text() != s)
+            fieldValue->setText(s);
 
-        if (index && !dialTimer.isActive())
+        if (index && indexTarget != indexValue && !dialTimer.isActive())
             dialTimer.start();
     } else {
         qDebug() << "Wrong field, maybe an issue with object disconnection ?";
@@ -173,6 +179,9 @@ void LineardialGadgetWidget::setDialFile(QString dfn)
           background->setElementId("background");
           background->setFlags(QGraphicsItem::ItemClipsChildrenToShape|
                                  QGraphicsItem::ItemClipsToShape);
+          // Static parts are rasterized once per size, only the
+          // index and the value are drawn again when they change
+          background->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
           l_scene->addItem(background);
 
           // The red/yellow/green zones are optional, we just
@@ -184,14 +193,17 @@ void LineardialGadgetWidget::setDialFile(QString dfn)
               red->setSharedRenderer(m_renderer);
               red->setElementId("red");
               red->setParentItem(background);
+              red->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
               yellow = new QGraphicsSvgItem();
               yellow->setSharedRenderer(m_renderer);
               yellow->setElementId("yellow");
               yellow->setParentItem(background);
+              yellow->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
               green = new QGraphicsSvgItem();
               green->setSharedRenderer(m_renderer);
               green->setElementId("green");
               green->setParentItem(background);
+              green->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
               // In order to properly render the Green/Yellow/Red graphs, we need to find out
               // the starting location of the bargraph rendering area:
               QMatrix textMatrix = m_renderer->matrixForElement("bargraph");
@@ -271,6 +283,7 @@ void LineardialGadgetWidget::setDialFile(QString dfn)
               index->setElementId("needle");
               index->setTransform(matrix,false);
               index->setParentItem(background);
+              index->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
           } else {
               index = NULL;
           }
@@ -283,12 +296,13 @@ void LineardialGadgetWidget::setDialFile(QString dfn)
               qreal startY = rect.y();
               qreal elHeight = rect.height();
               QTransform matrix;
-              matrix.translate(startX,startY-elHeight/2);
-              fieldName = new QGraphicsTextItem("field");
+              matrix.translate(startX+TEXT_MARGIN,startY-elHeight/2+TEXT_MARGIN);
+              fieldName = new QGraphicsSimpleTextItem("field");
               fieldName->setFont(QFont("Arial",(int)elHeight));
-              fieldName->setDefaultTextColor(QColor("White"));
+              fieldName->setBrush(QColor("White"));
               fieldName->setTransform(matrix,false);
               fieldName->setParentItem(background);
+              fieldName->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
           } else {
               fieldName = NULL;
           }
@@ -301,12 +315,13 @@ void LineardialGadgetWidget::setDialFile(QString dfn)
               qreal startY = nRect.y();
               qreal elHeight = nRect.height();
               QTransform matrix;
-              matrix.translate(startX,startY-elHeight/2);
-              fieldValue = new QGraphicsTextItem("0.00");
+              matrix.translate(startX+TEXT_MARGIN,startY-elHeight/2+TEXT_MARGIN);
+              fieldValue = new QGraphicsSimpleTextItem("0.00");
               fieldValue->setFont(QFont("Arial",(int)elHeight));
-              fieldValue->setDefaultTextColor(QColor("White"));
+              fieldValue->setBrush(QColor("White"));
               fieldValue->setTransform(matrix,false);
               fieldValue->setParentItem(background);
+              fieldValue->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
           } else {
               fieldValue = NULL;
           }
@@ -324,6 +339,7 @@ void LineardialGadgetWidget::setDialFile(QString dfn)
               fieldSymbol->setSharedRenderer(m_renderer);
               fieldSymbol->setTransform(matrix,false);
               fieldSymbol->setParentItem(background);
+              fieldSymbol->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
           } else {
               fieldSymbol = NULL;
           }
@@ -333,6 +349,7 @@ void LineardialGadgetWidget::setDialFile(QString dfn)
             foreground->setSharedRenderer(m_renderer);
             foreground->setElementId("foreground");
             foreground->setParentItem(background);
+            foreground->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
             fgenabled = true;
         } else {
             fgenabled = false;
@@ -429,8 +446,9 @@ void LineardialGadgetWidget::moveIndex()
         indexValue = indexTarget;
         dialTimer.stop();
     }
+    // Moving the index only repaints the area it left and the one it
+    // covers, the cached index pixmap is blitted there
     QTransform matrix;
-    index->resetTransform();
     qreal trans = indexValue*bargraphSize/100;
     if (verticalDial) {
         matrix.translate(startX,trans+startY);
@@ -438,6 +456,4 @@ void LineardialGadgetWidget::moveIndex()
         matrix.translate(trans+startX,startY);
     }
     index->setTransform(matrix,false);
-    
-    update();
 }
@@ -32,12 +32,13 @@
 #include "extensionsystem/pluginmanager.h"
 #include "uavobjectmanager.h"
 #include "uavobject.h"
+#include "uavobjectinterest.h"
 #include <QGraphicsView>
 #include <QtSvg/QSvgRenderer>
 #include <QtSvg/QGraphicsSvgItem>
 
 #include <QFile>
-#include <QTimer>
+#include <utils/instrumentclock.h>
 
 class LineardialGadgetWidget : public QGraphicsView
 {
@@ -82,8 +83,9 @@ private:
    QGraphicsSvgItem *red;
    QGraphicsSvgItem *fieldSymbol;
 
-   QGraphicsTextItem *fieldName;
-   QGraphicsTextItem *fieldValue;
+   // Simple text items, laid out only when their text changes
+   QGraphicsSimpleTextItem *fieldName;
+   QGraphicsSimpleTextItem *fieldValue;
 
                    // Simple flag to skip rendering if the
    bool fgenabled; // layer does not exist.
@@ -112,10 +114,12 @@ private:
    double indexValue;
 
    // Rotation timer
-   QTimer dialTimer;
+   Utils::InstrumentTimer dialTimer;
 
    // Name of the fields to read when an update is received:
    UAVDataObject* obj1;
+   // The object above, shown while the dial is visible
+   UAVObjectInterest* interest;
    QString field1;
    QString subfield1;
    bool haveSubField1;
@@ -0,0 +1,19 @@
+TEMPLATE = lib
+TARGET = LinkUsageGadget
+
+include(../../openpilotgcsplugin.pri)
+include(../../plugins/coreplugin/coreplugin.pri)
+include(../../plugins/uavobjects/uavobjects.pri)
+include(../../plugins/uavtalk/uavtalk.pri)
+
+HEADERS += linkusagegadget.h
+HEADERS += linkusagegadgetwidget.h
+HEADERS += linkusagegadgetfactory.h
+HEADERS += linkusageplugin.h
+
+SOURCES += linkusagegadget.cpp
+SOURCES += linkusagegadgetwidget.cpp
+SOURCES += linkusagegadgetfactory.cpp
+SOURCES += linkusageplugin.cpp
+
+OTHER_FILES += LinkUsageGadget.pluginspec
@@ -0,0 +1,47 @@
+/**
+ ******************************************************************************
+ *
+ * @file       linkusagegadgetfactory.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup LinkUsageGadgetPlugin Link Usage Gadget Plugin
+ * @{
+ * @brief Firmware linkusage results, compared against a saved run
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "linkusagegadgetfactory.h"
+#include "linkusagegadgetwidget.h"
+#include "linkusagegadget.h"
+#include <coreplugin/iuavgadget.h>
+
+LinkUsageGadgetFactory::LinkUsageGadgetFactory(QObject *parent) :
+        IUAVGadgetFactory(QString("LinkUsageGadget"),
+                          tr("Link Usage"),
+                          parent)
+{
+}
+
+LinkUsageGadgetFactory::~LinkUsageGadgetFactory()
+{
+
+}
+
+IUAVGadget* LinkUsageGadgetFactory::createGadget(QWidget *parent) {
+    LinkUsageGadgetWidget* gadgetWidget = new LinkUsageGadgetWidget(parent);
+    return new LinkUsageGadget(QString("LinkUsageGadget"), gadgetWidget, parent);
+}
@@ -0,0 +1,211 @@
+/**
+ ******************************************************************************
+ *
+ * @file       linkusagegadgetwidget.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup LinkUsageGadgetPlugin Link Usage Gadget Plugin
+ * @{
+ * @brief Firmware linkusage results, compared against a saved run
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "linkusagegadgetwidget.h"
+
+#include <QtGui/QLabel>
+#include <QtGui/QTableWidget>
+#include <QtGui/QHeaderView>
+#include <QtGui/QVBoxLayout>
+#include <QTimer>
+#include <QMultiMap>
+
+#include "uavobjectmanager.h"
+#include "extensionsystem/pluginmanager.h"
+
+LinkUsageGadgetWidget::LinkUsageGadgetWidget(QWidget *parent) : QWidget(parent)
+{
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    m_objManager = pm->getObject<UAVObjectManager>();
+    m_telemetry = pm->getObject<TelemetryManager>();
+
+    m_status = new QLabel(tr("Not connected"), this);
+    m_status->setWordWrap(true);
+
+    m_table = new QTableWidget(0, COLUMN_NUMELEM, this);
+    m_table->setHorizontalHeaderLabels(QStringList() << tr("Object") << tr("Tx packets/s") << tr("Tx bytes/s")
+                                       << tr("Rx packets/s") << tr("Rx bytes/s") << tr("Retries") << tr("NACKs")
+                                       << tr("Projected bytes/s") << tr("Share"));
+    m_table->horizontalHeaderItem(COLUMN_PROJECTED)->setToolTip(
+            tr("Both ways, from the periodic update rates in the metadata. Delta and multi-object "
+               "packets make the measured rate lower."));
+    m_table->verticalHeader()->hide();
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(m_status);
+    layout->addWidget(m_table);
+
+    m_timer = new QTimer(this);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(refresh()));
+    m_timer->start(REFRESH_PERIOD_MS);
+}
+
+LinkUsageGadgetWidget::~LinkUsageGadgetWidget()
+{
+   // Do nothing
+}
+
+/**
+  * Bytes per second each object should take from its metadata, both ways.
+  * Only periodic and throttled updates have a rate, every instance is sent.
+  */
+QHash<quint32, double> LinkUsageGadgetWidget::projectedRates()
+{
+    QHash<quint32, double> rates;
+    foreach (QList<UAVDataObject*> list, m_objManager->getDataObjects()) {
+        if (list.isEmpty())
+            continue;
+        UAVDataObject *obj = list.first();
+        UAVObject::Metadata mdata = obj->getMetadata();
+        // sync(1), type(1), size(2), object ID(4), instance ID(2), data, checksum(1)
+        double packet = list.count() * ((obj->isSingleInstance() ? 8 : 10) + obj->getNumBytes() + 1);
+        double rate = 0;
+
+        UAVObject::UpdateMode flightMode = UAVObject::GetFlightTelemetryUpdateMode(mdata);
+        if ((flightMode == UAVObject::UPDATEMODE_PERIODIC || flightMode == UAVObject::UPDATEMODE_THROTTLED) &&
+                mdata.flightTelemetryUpdatePeriod > 0)
+            rate += packet * 1000 / mdata.flightTelemetryUpdatePeriod;
+        if (UAVObject::GetGcsTelemetryUpdateMode(mdata) == UAVObject::UPDATEMODE_PERIODIC &&
+                mdata.gcsTelemetryUpdatePeriod > 0)
+            rate += packet * 1000 / mdata.gcsTelemetryUpdatePeriod;
+
+        if (rate > 0)
+            rates.insert(obj->getObjID(), rate);
+    }
+    return rates;
+}
+
+/**
+  * Speed of the telemetry port from HwSettings, 0 if not known
+  */
+quint32 LinkUsageGadgetWidget::telemetryBaud()
+{
+    UAVObject *hwSettings = m_objManager->getObject(QString("HwSettings"));
+    UAVObjectField *field = hwSettings ? hwSettings->getField(QString("TelemetrySpeed")) : NULL;
+    if (!field)
+        return 0;
+    return field->getValue().toString().toUInt();
+}
+
+void LinkUsageGadgetWidget::refresh()
+{
+    QHash<quint32, UAVTalk::ObjectStats> stats = m_telemetry->getObjectStats();
+    if (stats.isEmpty() || !m_telemetry->isConnected()) {
+        m_lastStats.clear();
+        m_status->setText(tr("Not connected"));
+        m_table->setRowCount(0);
+        return;
+    }
+
+    // The counters start over with every link
+    double seconds = m_lastTime.isValid() ? m_lastTime.restart() / 1000.0 : 0;
+    if (!m_lastTime.isValid())
+        m_lastTime.start();
+    foreach (quint32 objId, m_lastStats.keys()) {
+        if (!stats.contains(objId) || stats[objId].txBytes < m_lastStats[objId].txBytes ||
+                stats[objId].rxBytes < m_lastStats[objId].rxBytes) {
+            m_lastStats.clear();
+            break;
+        }
+    }
+    if (seconds <= 0 || m_lastStats.isEmpty()) {
+        m_lastStats = stats;
+        m_status->setText(tr("Measuring..."));
+        return;
+    }
+
+    QHash<quint32, double> projected = projectedRates();
+    QList<quint32> objIds = stats.keys();
+    foreach (quint32 objId, projected.keys()) {
+        if (!stats.contains(objId))
+            objIds.append(objId);
+    }
+
+    // Busiest first
+    double totalTx = 0;
+    double totalRx = 0;
+    double totalProjected = 0;
+    QMultiMap<double, quint32> order;
+    foreach (quint32 objId, objIds) {
+        UAVTalk::ObjectStats now = stats.value(objId);
+        UAVTalk::ObjectStats last = m_lastStats.value(objId);
+        double bytes = (now.txBytes - last.txBytes) + (now.rxBytes - last.rxBytes);
+        totalTx += (now.txBytes - last.txBytes) / seconds;
+        totalRx += (now.rxBytes - last.rxBytes) / seconds;
+        totalProjected += projected.value(objId);
+        order.insert(bytes / seconds, objId);
+    }
+
+    m_table->setRowCount(order.count());
+    int row = 0;
+    QMapIterator<double, quint32> i(order);
+    i.toBack();
+    while (i.hasPrevious()) {
+        quint32 objId = i.previous().value();
+        UAVTalk::ObjectStats now = stats.value(objId);
+        UAVTalk::ObjectStats last = m_lastStats.value(objId);
+        UAVObject *obj = m_objManager->getObject(objId);
+        double bytes = ((now.txBytes - last.txBytes) + (now.rxBytes - last.rxBytes)) / seconds;
+
+        QStringList text;
+        text << (obj ? obj->getName() : QString("0x%1").arg(objId, 8, 16, QChar('0')))
+             << QString::number((now.txPackets - last.txPackets) / seconds, 'f', 1)
+             << QString::number((now.txBytes - last.txBytes) / seconds, 'f', 0)
+             << QString::number((now.rxPackets - last.rxPackets) / seconds, 'f', 1)
+             << QString::number((now.rxBytes - last.rxBytes) / seconds, 'f', 0)
+             << QString::number(now.retries)
+             << QString::number(now.nacks)
+             << (projected.contains(objId) ? QString::number(projected.value(objId), 'f', 0) : QString())
+             << QString("%1%").arg(totalTx + totalRx > 0 ? bytes * 100 / (totalTx + totalRx) : 0, 0, 'f', 1);
+        for (int column = 0; column < COLUMN_NUMELEM; ++column) {
+            QTableWidgetItem *item = m_table->item(row, column);
+            if (!item) {
+                item = new QTableWidgetItem();
+                if (column != COLUMN_OBJECT)
+                    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+                m_table->setItem(row, column, item);
+            }
+            item->setText(text[column]);
+        }
+        ++row;
+    }
+
+    QString status = tr("Measured %1 bytes/s sent and %2 bytes/s received, projected %3 bytes/s")
+                     .arg(totalTx, 0, 'f', 0).arg(totalRx, 0, 'f', 0).arg(totalProjected, 0, 'f', 0);
+    quint32 baud = telemetryBaud();
+    if (baud > 0) {
+        // 8N1, ten bits on the wire per byte
+        status += tr(", %1% of the telemetry port at %2 baud").arg(totalProjected * 1000 / baud, 0, 'f', 0).arg(baud);
+    }
+    m_status->setText(status);
+    m_lastStats = stats;
+}
+
+/**
+  * @}
+  * @}
+  */
@@ -0,0 +1,77 @@
+/**
+ ******************************************************************************
+ *
+ * @file       linkusagegadgetwidget.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup LinkUsageGadgetPlugin Link Usage Gadget Plugin
+ * @{
+ * @brief Firmware linkusage results, compared against a saved run
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef LINKUSAGEGADGETWIDGET_H_
+#define LINKUSAGEGADGETWIDGET_H_
+
+#include <QtGui/QWidget>
+#include <QHash>
+#include <QElapsedTimer>
+#include "uavtalk/telemetrymanager.h"
+
+class QLabel;
+class QTableWidget;
+class QTimer;
+
+/**
+ * Table of the telemetry link usage of each object. The packets and bytes
+ * UAVTalk counted on the link are shown as rates, next to the rate the
+ * metadata of the object asks for, so update rates can be tuned against
+ * what the link really carries.
+ */
+class LinkUsageGadgetWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    LinkUsageGadgetWidget(QWidget *parent = 0);
+    ~LinkUsageGadgetWidget();
+
+private slots:
+    void refresh();
+
+private:
+    typedef enum { COLUMN_OBJECT, COLUMN_TX_PACKETS, COLUMN_TX_BYTES, COLUMN_RX_PACKETS, COLUMN_RX_BYTES,
+                   COLUMN_RETRIES, COLUMN_NACKS, COLUMN_PROJECTED, COLUMN_SHARE, COLUMN_NUMELEM } Column;
+
+    static const int REFRESH_PERIOD_MS = 2000;
+
+    UAVObjectManager *m_objManager;
+    TelemetryManager *m_telemetry;
+    // Counters of the last refresh and the time since
+    QHash<quint32, UAVTalk::ObjectStats> m_lastStats;
+    QElapsedTimer m_lastTime;
+
+    QTimer *m_timer;
+    QLabel *m_status;
+    QTableWidget *m_table;
+
+    QHash<quint32, double> projectedRates();
+    quint32 telemetryBaud();
+};
+
+#endif /* LINKUSAGEGADGETWIDGET_H_ */
@@ -0,0 +1,242 @@
+/**
+ ******************************************************************************
+ * @file       loganalysis.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @brief      Field history queries on indexed logs
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup loggingplugin
+ * @{
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "loganalysis.h"
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+#include <QThread>
+#include <math.h>
+
+// Runs of slices handed to each worker, per core, to balance the load
+#define JOBS_PER_THREAD 4
+
+namespace {
+
+/**
+ * A run of consecutive slices of one field, analysed by one worker
+ */
+struct Job {
+    QString fileName;
+    QString objectName;
+    QString fieldName;
+    quint16 instId;
+    quint32 startTime;
+    quint32 sliceLength;
+    int numSlices;
+    LogAnalysis::SliceFunction function;
+};
+
+LogSeries analyseJob(const Job& job)
+{
+    LogSeries result;
+    LogQuery query;
+    LogSeries rows;
+    if (!query.open(job.fileName) ||
+            !query.query(job.objectName, job.fieldName, job.startTime,
+                         job.startTime + job.numSlices * job.sliceLength - 1, rows, job.instId))
+        return result;
+    result.numElements = rows.numElements;
+    result.elementNames = rows.elementNames;
+
+    const int numElements = rows.numElements;
+    QVector<double> values(numElements);
+    LogSeries slice;
+    slice.numElements = rows.numElements;
+    slice.elementNames = rows.elementNames;
+    int row = 0;
+    for (int n = 0; n < job.numSlices; ++n) {
+        quint32 sliceStart = job.startTime + n * job.sliceLength;
+        quint32 sliceEnd = sliceStart + job.sliceLength;
+        slice.timeStamps.clear();
+        slice.values.clear();
+        while (row < rows.timeStamps.size() && rows.timeStamps[row] < sliceEnd) {
+            slice.timeStamps.append(rows.timeStamps[row]);
+            for (int e = 0; e < numElements; ++e)
+                slice.values.append(rows.values[row * numElements + e]);
+            ++row;
+        }
+        if (!job.function(slice, job.sliceLength, values.data()))
+            continue;
+        result.timeStamps.append(sliceStart);
+        for (int e = 0; e < numElements; ++e)
+            result.values.append(values[e]);
+    }
+    return result;
+}
+
+void appendSeries(LogSeries& result, const LogSeries& part)
+{
+    if (part.numElements == 0)
+        return;
+    result.numElements = part.numElements;
+    result.elementNames = part.elementNames;
+    result.timeStamps += part.timeStamps;
+    result.values += part.values;
+}
+
+LogSeries emptySeries()
+{
+    return LogSeries();
+}
+
+}
+
+QFuture<LogSeries> LogAnalysis::sliced(const QString& fileName, const QString& objectName, const QString& fieldName,
+                                       quint32 sliceLength, SliceFunction function, quint16 instId)
+{
+    LogQuery query;
+    if (sliceLength == 0 || !query.open(fileName))
+        return QtConcurrent::run(emptySeries);
+    quint32 duration = query.getDuration();
+    query.close();
+
+    const int numSlices = duration / sliceLength + 1;
+    const int numJobs = qMax(1, QThread::idealThreadCount() * JOBS_PER_THREAD);
+    const int slicesPerJob = (numSlices + numJobs - 1) / numJobs;
+    QList<Job> jobs;
+    for (int first = 0; first < numSlices; first += slicesPerJob) {
+        Job job;
+        job.fileName = fileName;
+        job.objectName = objectName;
+        job.fieldName = fieldName;
+        job.instId = instId;
+        job.startTime = first * sliceLength;
+        job.sliceLength = sliceLength;
+        job.numSlices = qMin(slicesPerJob, numSlices - first);
+        job.function = function;
+        jobs.append(job);
+    }
+    return QtConcurrent::mappedReduced(jobs, analyseJob, appendSeries, QtConcurrent::OrderedReduce);
+}
+
+QFuture<LogSeries> LogAnalysis::summarized(const QString& fileName, const QStringList& fields, SliceFunction function)
+{
+    LogQuery query;
+    quint32 duration = 0;
+    if (query.open(fileName))
+        duration = query.getDuration();
+    query.close();
+
+    QList<Job> jobs;
+    foreach (const QString& field, fields) {
+        Job job;
+        job.fileName = fileName;
+        job.objectName = field.section('.', 0, 0);
+        job.fieldName = field.section('.', 1);
+        job.instId = 0;
+        job.startTime = 0;
+        job.sliceLength = duration + 1;
+        job.numSlices = 1;
+        job.function = function;
+        jobs.append(job);
+    }
+    return QtConcurrent::mapped(jobs, analyseJob);
+}
+
+bool LogAnalysis::mean(const LogSeries& slice, quint32 sliceLength, double* result)
+{
+    Q_UNUSED(sliceLength);
+    const int rows = slice.timeStamps.size();
+    if (rows == 0)
+        return false;
+    for (quint32 e = 0; e < slice.numElements; ++e) {
+        double sum = 0;
+        for (int n = 0; n < rows; ++n)
+            sum += slice.values[n * slice.numElements + e];
+        result[e] = sum / rows;
+    }
+    return true;
+}
+
+bool LogAnalysis::rms(const LogSeries& slice, quint32 sliceLength, double* result)
+{
+    Q_UNUSED(sliceLength);
+    const int rows = slice.timeStamps.size();
+    if (rows == 0)
+        return false;
+    for (quint32 e = 0; e < slice.numElements; ++e) {
+        double sum = 0;
+        for (int n = 0; n < rows; ++n) {
+            double value = slice.values[n * slice.numElements + e];
+            sum += value * value;
+        }
+        result[e] = sqrt(sum / rows);
+    }
+    return true;
+}
+
+bool LogAnalysis::minimum(const LogSeries& slice, quint32 sliceLength, double* result)
+{
+    Q_UNUSED(sliceLength);
+    const int rows = slice.timeStamps.size();
+    if (rows == 0)
+        return false;
+    for (quint32 e = 0; e < slice.numElements; ++e) {
+        result[e] = slice.values[e];
+        for (int n = 1; n < rows; ++n)
+            result[e] = qMin(result[e], slice.values[n * slice.numElements + e]);
+    }
+    return true;
+}
+
+bool LogAnalysis::maximum(const LogSeries& slice, quint32 sliceLength, double* result)
+{
+    Q_UNUSED(sliceLength);
+    const int rows = slice.timeStamps.size();
+    if (rows == 0)
+        return false;
+    for (quint32 e = 0; e < slice.numElements; ++e) {
+        result[e] = slice.values[e];
+        for (int n = 1; n < rows; ++n)
+            result[e] = qMax(result[e], slice.values[n * slice.numElements + e]);
+    }
+    return true;
+}
+
+bool LogAnalysis::rate(const LogSeries& slice, quint32 sliceLength, double* result)
+{
+    Q_UNUSED(sliceLength);
+    const int rows = slice.timeStamps.size();
+    if (rows < 2 || slice.timeStamps[rows - 1] == slice.timeStamps[0])
+        return false;
+    double seconds = (slice.timeStamps[rows - 1] - slice.timeStamps[0]) / 1000.0;
+    for (quint32 e = 0; e < slice.numElements; ++e)
+        result[e] = (slice.values[(rows - 1) * slice.numElements + e] - slice.values[e]) / seconds;
+    return true;
+}
+
+bool LogAnalysis::updateRate(const LogSeries& slice, quint32 sliceLength, double* result)
+{
+    for (quint32 e = 0; e < slice.numElements; ++e)
+        result[e] = slice.timeStamps.size() * 1000.0 / sliceLength;
+    return true;
+}
+
+/**
+ * @}
+ * @}
+ */
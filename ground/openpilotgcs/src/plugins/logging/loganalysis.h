@@ -0,0 +1,85 @@
+/**
+ ******************************************************************************
+ * @file       loganalysis.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup loggingplugin
+ * @{
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef LOGANALYSIS_H
+#define LOGANALYSIS_H
+
+#include "logging_global.h"
+#include "logquery.h"
+#include <QFuture>
+
+/**
+ * Whole flight statistics computed from indexed logs on all cores. A field
+ * history is cut into time slices which are mapped in parallel, each worker
+ * reading its run of slices with its own LogQuery, and the per slice results
+ * are reduced in time order into one series:
+ *
+ *   QFuture<LogSeries> vibration = LogAnalysis::sliced(fileName,
+ *           "Accels", "x", 1000, LogAnalysis::rms);
+ *
+ * The futures can be watched with a QFutureWatcher to keep the GUI live.
+ */
+class LOGGING_EXPORT LogAnalysis
+{
+public:
+    /**
+     * Reduces the rows of one slice (slice.numElements values each) to
+     * numElements values in result. Called for empty slices too, returns
+     * false to leave the slice out of the series.
+     */
+    typedef bool (*SliceFunction)(const LogSeries& slice, quint32 sliceLength, double* result);
+
+    /**
+     * One row per slice of sliceLength ms, stamped with the slice start.
+     * The series is empty if the log or the field can not be queried.
+     */
+    static QFuture<LogSeries> sliced(const QString& fileName, const QString& objectName, const QString& fieldName,
+                                     quint32 sliceLength, SliceFunction function, quint16 instId = 0);
+
+    /**
+     * One single row series for each "Object.Field" of fields, over the
+     * whole log, in the order of fields
+     */
+    static QFuture<LogSeries> summarized(const QString& fileName, const QStringList& fields, SliceFunction function);
+
+    // Slice functions
+    static bool mean(const LogSeries& slice, quint32 sliceLength, double* result);
+    static bool rms(const LogSeries& slice, quint32 sliceLength, double* result);
+    static bool minimum(const LogSeries& slice, quint32 sliceLength, double* result);
+    static bool maximum(const LogSeries& slice, quint32 sliceLength, double* result);
+    /** Change per second from the first to the last row, e.g. climb rate from an altitude */
+    static bool rate(const LogSeries& slice, quint32 sliceLength, double* result);
+    /** Updates per second, e.g. link quality from a status object */
+    static bool updateRate(const LogSeries& slice, quint32 sliceLength, double* result);
+};
+
+#endif // LOGANALYSIS_H
+
+/**
+ * @}
+ * @}
+ */
@@ -0,0 +1,115 @@
+/**
+ ******************************************************************************
+ * @file       logdecoder.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @brief      Headless decoding of logs as fast as possible
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup loggingplugin
+ * @{
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "logdecoder.h"
+#include "logfile.h"
+#include "uavobjectmanager.h"
+#include "uavobjectsinit.h"
+#include <uavtalk/uavtalk.h>
+#include <QDebug>
+
+LogDecoder::LogDecoder(QObject *parent) :
+    QObject(parent),
+    sink(NULL),
+    timeStamp(0)
+{
+}
+
+/**
+ * Decode a whole log into sink
+ * @return true if the log was read to its end
+ */
+bool LogDecoder::decode(const QString& fileName, LogDecoderSink* sink)
+{
+    UAVObjectManager* objMngr = new UAVObjectManager();
+    UAVObjectsInitialize(objMngr);
+
+    LogFile logFile;
+    logFile.setFileName(fileName);
+    logFile.setObjectManager(objMngr);
+    bool success = logFile.open(QIODevice::ReadOnly);
+    if (success) {
+        this->sink = sink;
+        timeStamp = 0;
+        foreach (QList<UAVObject*> instances, objMngr->getObjects()) {
+            foreach (UAVObject* obj, instances)
+                connect(obj, SIGNAL(objectUnpacked(UAVObject*)), this, SLOT(objectUnpacked(UAVObject*)));
+        }
+        connect(objMngr, SIGNAL(newInstances(QList<UAVObject*>)), this, SLOT(newInstances(QList<UAVObject*>)));
+
+        UAVTalk* utalk = new UAVTalk(&logFile, objMngr);
+        sink->logStarted(fileName, objMngr);
+        // UAVTalk reads every record from within decodeNextRecord()
+        while (logFile.decodeNextRecord(timeStamp))
+            ;
+        success = logFile.recordsAtEnd();
+        if (!success)
+            qDebug() << "LogDecoder: stopped at a corrupted record in" << fileName;
+        delete utalk;
+        logFile.close();
+        this->sink = NULL;
+    } else {
+        qDebug() << "LogDecoder: unable to open" << fileName;
+    }
+    sink->logFinished(fileName, success);
+
+    // The manager does not own the objects
+    foreach (QList<UAVObject*> instances, objMngr->getObjects())
+        qDeleteAll(instances);
+    delete objMngr;
+    return success;
+}
+
+/**
+ * Decode several logs into sink, one after the other
+ * @return the number of logs read to their end
+ */
+int LogDecoder::decode(const QStringList& fileNames, LogDecoderSink* sink)
+{
+    int decoded = 0;
+    foreach (QString fileName, fileNames) {
+        if (decode(fileName, sink))
+            ++decoded;
+    }
+    return decoded;
+}
+
+void LogDecoder::objectUnpacked(UAVObject* obj)
+{
+    sink->objectUpdated(timeStamp, obj);
+}
+
+void LogDecoder::newInstances(QList<UAVObject*> objs)
+{
+    foreach (UAVObject* obj, objs)
+        connect(obj, SIGNAL(objectUnpacked(UAVObject*)), this, SLOT(objectUnpacked(UAVObject*)));
+}
+
+/**
+ * @}
+ * @}
+ */
@@ -0,0 +1,83 @@
+/**
+ ******************************************************************************
+ * @file       logdecoder.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup loggingplugin
+ * @{
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef LOGDECODER_H
+#define LOGDECODER_H
+
+#include "logging_global.h"
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class UAVObject;
+class UAVObjectManager;
+
+/**
+ * Receives the results of a bulk log decode. All calls are made from the
+ * thread running LogDecoder::decode(), object updates in log order.
+ */
+class LOGGING_EXPORT LogDecoderSink
+{
+public:
+    virtual ~LogDecoderSink() {}
+
+    /** fileName is about to be decoded into objMngr, which is private to the decoder */
+    virtual void logStarted(const QString& fileName, UAVObjectManager* objMngr) { Q_UNUSED(fileName); Q_UNUSED(objMngr); }
+    /** obj was updated by the record logged at timeStamp (ms into the log) */
+    virtual void objectUpdated(quint32 timeStamp, UAVObject* obj) = 0;
+    /** Decoding ended, success is false if the log could not be read to its end */
+    virtual void logFinished(const QString& fileName, bool success) { Q_UNUSED(fileName); Q_UNUSED(success); }
+};
+
+/**
+ * Decodes logs as fast as possible, without the replay clock, the connection
+ * manager or the GUI. Every log is decoded by its own UAVTalk instance into a
+ * fresh UAVObjectManager, so decoders can run in parallel threads.
+ */
+class LOGGING_EXPORT LogDecoder : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogDecoder(QObject *parent = 0);
+
+    bool decode(const QString& fileName, LogDecoderSink* sink);
+    int decode(const QStringList& fileNames, LogDecoderSink* sink);
+
+private slots:
+    void objectUnpacked(UAVObject* obj);
+    void newInstances(QList<UAVObject*> objs);
+
+private:
+    LogDecoderSink* sink;
+    quint32 timeStamp;
+};
+
+#endif // LOGDECODER_H
+
+/**
+ * @}
+ * @}
+ */
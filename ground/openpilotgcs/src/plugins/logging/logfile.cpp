@@ -1,13 +1,169 @@
 #include "logfile.h"
+#include "logprefetcher.h"
 #include <QDebug>
 #include <QtGlobal>
+#include <QtEndian>
+#include <QDataStream>
+#include <QtAlgorithms>
+
+/*
+ * Log file layout (version 2, version 3 is the same with compressed records)
+ *
+ * Header:  "OPLOGHDR", quint32 version, quint32 length, then length bytes
+ *          holding a hash of the object set and the definition of every
+ *          object (ID, name, flags, size and fields) known when recording.
+ * Records: quint32 timestamp (ms), qint64 size, size bytes of UAVTalk data,
+ *          exactly as in version 1 logs.
+ * Index:   written on close. A time index with one entry per
+ *          INDEX_INTERVAL_MS and, per object ID, the offsets of all its
+ *          records. The file ends with the qint64 index offset and "OPLOGIDX".
+ * Blocks:  version 3 only, the records are stored in blocks of a quint32
+ *          length followed by that many bytes of qCompress() output. Every
+ *          block holds whole records and decompresses on its own, index
+ *          offsets are positions in the uncompressed record stream.
+ *
+ * Header and index integers are little endian, strings are a quint16 length
+ * followed by UTF-8. Version 1 logs (records only) and version 2 logs without
+ * an index (e.g. after a crash) are still read.
+ *
+ * Compact logs (LOG_VERSION_COMPACT, .oplc) are the format of shared/oplog,
+ * written by the onboard logger too as .OPC, since the card takes 8.3 names. They carry no object definitions, only
+ * the hash of the object set.
+ */
+static const char LOG_HEADER_MAGIC[8] = { 'O', 'P', 'L', 'O', 'G', 'H', 'D', 'R' };
+static const char LOG_INDEX_MAGIC[8] = { 'O', 'P', 'L', 'O', 'G', 'I', 'D', 'X' };
+static const qint64 LOG_FOOTER_LENGTH = sizeof(qint64) + sizeof(LOG_INDEX_MAGIC);
+static const quint8 UAVTALK_SYNC_VAL = 0x3C;
+
+static void writeString(QDataStream& stream, const QString& str)
+{
+    QByteArray utf8 = str.toUtf8();
+    stream << (quint16)utf8.size();
+    stream.writeRawData(utf8.constData(), utf8.size());
+}
+
+static QString readString(QDataStream& stream)
+{
+    quint16 length;
+    stream >> length;
+    QByteArray utf8(length, 0);
+    stream.readRawData(utf8.data(), length);
+    return QString::fromUtf8(utf8.constData(), utf8.size());
+}
+
+static void writeStringList(QDataStream& stream, const QStringList& list)
+{
+    stream << (quint16)list.size();
+    foreach (QString str, list)
+        writeString(stream, str);
+}
+
+static QStringList readStringList(QDataStream& stream)
+{
+    quint16 count;
+    stream >> count;
+    QStringList list;
+    for (int n = 0; n < count && stream.status() == QDataStream::Ok; ++n)
+        list << readString(stream);
+    return list;
+}
+
+/**
+ * UAVTalk packet CRC, CRC-8 with polynomial 0x07
+ */
+static quint8 updateCRC(quint8 crc, const quint8* data, int length)
+{
+    while (length--) {
+        crc ^= *data++;
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+    }
+    return crc;
+}
+
+/**
+ * Check if a logged object has the same data layout as the current one
+ */
+static bool layoutMatches(const LogFile::ObjectDefinition& def, UAVObject* obj)
+{
+    QList<UAVObjectField*> fields = obj->getFields();
+    if (def.numBytes != obj->getNumBytes() || def.fields.size() != fields.size())
+        return false;
+    for (int n = 0; n < fields.size(); ++n) {
+        if (def.fields[n].type != fields[n]->getType() || def.fields[n].numElements != fields[n]->getNumElements())
+            return false;
+    }
+    return true;
+}
 
 LogFile::LogFile(QObject *parent) :
-    QIODevice(parent)
+    QIODevice(parent),
+    pendingHead(0),
+    pendingBytes(0),
+    objMngr(NULL),
+    version(LOG_VERSION),
+    objectsHash(0),
+    indexed(false),
+    dataStart(0),
+    dataEnd(0),
+    duration(0),
+    mapped(NULL),
+    readPos(0),
+    compressed(false),
+    currentBlock(-1),
+    compact(false),
+    writer(this),
+    writeInFlight(0),
+    writeOffset(0),
+    writerStop(false),
+    droppedPackets(0)
 {
     connect(&timer, SIGNAL(timeout()), this, SLOT(timerFired()));
 }
 
+LogFile::~LogFile()
+{
+    if (file.isOpen())
+        close();
+}
+
+void LogFileWriter::run()
+{
+    QByteArray chunk;
+    quint32 reportedDrops = 0;
+    QMutexLocker locker(&logFile->writeMutex);
+    forever {
+        if (logFile->writeBuffer.size() < LogFile::WRITE_CHUNK_SIZE && !logFile->writerStop)
+            logFile->writeReady.wait(&logFile->writeMutex, logFile->compressed ? LogFile::COMPRESSED_FLUSH_MS : LogFile::WRITE_FLUSH_MS);
+        qSwap(chunk, logFile->writeBuffer);
+        logFile->writeInFlight = chunk.size();
+        quint32 dropped = logFile->droppedPackets;
+        bool stop = logFile->writerStop;
+        locker.unlock();
+
+        if (logFile->compressed && !chunk.isEmpty()) {
+            QByteArray block = qCompress(chunk, LogFile::COMPRESSION_LEVEL);
+            quint32 length = block.size();
+            chunk.resize(sizeof(length));
+            memcpy(chunk.data(), &length, sizeof(length));
+            chunk.append(block);
+        }
+
+        if (!chunk.isEmpty() && logFile->file.write(chunk) != chunk.size())
+            qDebug() << "Logfile: error writing" << logFile->file.fileName();
+        chunk.clear();
+        if (dropped != reportedDrops) {
+            reportedDrops = dropped;
+            emit logFile->droppedPacketsChanged(dropped);
+        }
+
+        locker.relock();
+        logFile->writeInFlight = 0;
+        if (stop && logFile->writeBuffer.isEmpty())
+            break;
+    }
+}
+
 /**
  * Opens the logfile QIODevice and the underlying logfile. In case
  * we want to save the logfile, we open in WriteOnly. In case we
@@ -31,13 +187,47 @@ bool LogFile::open(OpenMode mode) {
         return false;
     }
 
-    // TODO: Write a header at the beginng describing objects so that in future
-    // they can be read back if ID's change
+    definitions.clear();
+    timeIndex.clear();
+    objectOffsets.clear();
+    idMap.clear();
+    keyframes.clear();
+    duration = 0;
+    indexed = false;
+    if (file.isWritable()) {
+        // Describe the objects so the log can be read back if the IDs change
+        writeHeader();
+        writeBuffer.clear();
+        writeInFlight = 0;
+        writeOffset = compressed ? 0 : file.pos();
+        writerStop = false;
+        droppedPackets = 0;
+        writer.start();
+    } else if (readCompact()) {
+        compressed = true;
+        buildKeyframes();
+        seekRecord(dataStart);
+    } else {
+        readHeader();
+        readIndex();
+        // Replay straight from the page cache, fall back to reads if the
+        // log does not fit in the address space
+        mapped = file.size() > 0 ? file.map(0, file.size()) : NULL;
+        if (!mapped)
+            qDebug() << "Logfile: unable to map" << file.fileName() << ", reading it instead";
+        compressed = (version == LOG_VERSION_COMPRESSED);
+        if (compressed)
+            scanBlocks();
+        buildIdMap();
+        buildKeyframes();
+        seekRecord(dataStart);
+    }
 
     // Must call parent function for QIODevice to pass calls to writeData
     // We always open ReadWrite, because otherwise we will get tons of warnings
     // during a logfile replay. Read nature is checked upon write ops below.
-    QIODevice::open(QIODevice::ReadWrite);
+    // Unbuffered, pending packets are copied straight into the reader's buffer.
+    QIODevice::open(QIODevice::ReadWrite | QIODevice::Unbuffered);
 
     return true;
 }
@@ -48,6 +238,30 @@ void LogFile::close()
 
     if (timer.isActive())
         timer.stop();
+    if (writer.isRunning()) {
+        writeMutex.lock();
+        writerStop = true;
+        writeReady.wakeOne();
+        writeMutex.unlock();
+        writer.wait();
+    }
+    if (file.isOpen() && file.isWritable())
+        writeIndex();
+    // The pending packets may point into the mapping
+    mutex.lock();
+    pending.clear();
+    pendingHead = 0;
+    pendingBytes = 0;
+    mutex.unlock();
+    qDeleteAll(merged);
+    merged.clear();
+    if (mapped) {
+        file.unmap(mapped);
+        mapped = NULL;
+    }
+    blocks.clear();
+    blockData.clear();
+    currentBlock = -1;
     file.close();
     QIODevice::close();
 }
@@ -57,35 +271,154 @@ qint64 LogFile::writeData(const char * data, qint64 dataSize) {
         return dataSize;
 
     quint32 timeStamp = myTime.elapsed();
+    qint64 recordSize = compact ? OPLOG_RECORD_MAX_OVERHEAD + dataSize : sizeof(timeStamp) + sizeof(dataSize) + dataSize;
 
-    file.write((char *) &timeStamp,sizeof(timeStamp));
-    file.write((char *) &dataSize, sizeof(dataSize));
+    QMutexLocker locker(&writeMutex);
+    if (writeBuffer.size() + writeInFlight + recordSize > WRITE_BUFFER_LIMIT || (compact && dataSize > 0xFFFF)) {
+        // The disk cannot keep up, rather lose the record than block the link
+        ++droppedPackets;
+        return dataSize;
+    }
 
-    qint64 written = file.write(data, dataSize);
-    if(written != -1)
-        emit bytesWritten(written);
+    if (compact) {
+        // UAVTalk writes whole packets, each one is a record. The index of a
+        // compact log points at its sync frames, one per INDEX_INTERVAL_MS.
+        uint8_t frame[OPLOG_RECORD_MAX_OVERHEAD];
+        quint32 sequence = compactWriter.sequence;
+        uint32_t length = OPLogWriteRecordHeader(&compactWriter, frame, timeStamp, dataSize);
+        if (compactWriter.sequence != sequence &&
+                (timeIndex.isEmpty() || timeStamp >= timeIndex.last().timeStamp + INDEX_INTERVAL_MS)) {
+            TimeIndexEntry entry;
+            entry.timeStamp = timeStamp;
+            entry.offset = compactWriter.sync_offset;
+            timeIndex.append(entry);
+        }
+        writeBuffer.append((const char *) frame, length);
+        writeBuffer.append(data, dataSize);
+    } else {
+        indexRecord(timeStamp, writeOffset, data, dataSize);
+        writeBuffer.append((const char *) &timeStamp, sizeof(timeStamp));
+        writeBuffer.append((const char *) &dataSize, sizeof(dataSize));
+        writeBuffer.append(data, dataSize);
+        writeOffset += recordSize;
+    }
+    if (writeBuffer.size() >= WRITE_CHUNK_SIZE)
+        writeReady.wakeOne();
+    locker.unlock();
 
+    emit bytesWritten(dataSize);
     return dataSize;
 }
 
+/**
+ * Index a version 1 record by time and by object ID
+ */
+void LogFile::indexRecord(quint32 timeStamp, qint64 offset, const char* data, qint64 dataSize)
+{
+    if (timeIndex.isEmpty() || timeStamp >= timeIndex.last().timeStamp + INDEX_INTERVAL_MS) {
+        TimeIndexEntry entry;
+        entry.timeStamp = timeStamp;
+        entry.offset = offset;
+        timeIndex.append(entry);
+    }
+    if (dataSize >= 8 && (quint8)data[0] == UAVTALK_SYNC_VAL)
+        objectOffsets[qFromLittleEndian<quint32>((const uchar*)&data[4])].append(offset);
+}
+
 qint64 LogFile::readData(char * data, qint64 maxSize) {
     QMutexLocker locker(&mutex);
-    qint64 toRead = qMin(maxSize,(qint64)dataBuffer.size());
-    memcpy(data,dataBuffer.data(),toRead);
-    dataBuffer.remove(0,toRead);
+    qint64 toRead = 0;
+    while (toRead < maxSize && !pending.isEmpty()) {
+        const QByteArray& packet = pending.first();
+        qint64 n = qMin(maxSize - toRead, packet.size() - pendingHead);
+        memcpy(data + toRead, packet.constData() + pendingHead, n);
+        toRead += n;
+        pendingHead += n;
+        if (pendingHead == packet.size()) {
+            pending.removeFirst();
+            pendingHead = 0;
+        }
+    }
+    pendingBytes -= toRead;
     return toRead;
 }
 
 qint64 LogFile::bytesAvailable() const
 {
-    return dataBuffer.size();
+    return pendingBytes;
+}
+
+/**
+ * Queue a packet for readData
+ */
+void LogFile::queuePacket(const QByteArray& packet)
+{
+    if (packet.isEmpty())
+        return;
+    QMutexLocker locker(&mutex);
+    pending.append(packet);
+    pendingBytes += packet.size();
+}
+
+bool LogFile::seekRecord(qint64 pos)
+{
+    if (!mapped && !compressed)
+        return file.seek(pos);
+    if (pos < 0 || pos > dataEnd)
+        return false;
+    readPos = pos;
+    return true;
+}
+
+qint64 LogFile::readRecordBytes(void* data, qint64 size)
+{
+    if (compressed) {
+        qint64 done = 0;
+        while (done < size && loadBlock(readPos)) {
+            const Block& block = blocks[currentBlock];
+            qint64 n = qMin(size - done, block.rawOffset + blockData.size() - readPos);
+            memcpy((char *) data + done, blockData.constData() + (readPos - block.rawOffset), n);
+            done += n;
+            readPos += n;
+        }
+        return done;
+    }
+    if (!mapped)
+        return file.read((char *) data, size);
+    size = qMin(size, dataEnd - readPos);
+    memcpy(data, mapped + readPos, size);
+    readPos += size;
+    return size;
+}
+
+/**
+ * Read size bytes of record data, a view into the mapping when mapped
+ */
+QByteArray LogFile::readRecordData(qint64 size)
+{
+    if (compressed) {
+        if (loadBlock(readPos) && readPos + size <= blocks[currentBlock].rawOffset + blockData.size()) {
+            QByteArray data = blockData.mid(readPos - blocks[currentBlock].rawOffset, size);
+            readPos += size;
+            return data;
+        }
+        QByteArray data(size, 0);
+        data.resize(readRecordBytes(data.data(), size));
+        return data;
+    }
+    if (!mapped)
+        return file.read(size);
+    size = qMin(size, dataEnd - readPos);
+    QByteArray data = QByteArray::fromRawData((const char *) mapped + readPos, size);
+    readPos += size;
+    return data;
 }
 
 void LogFile::timerFired()
 {
     qint64 dataSize;
 
-    if(file.bytesAvailable() > 4)
+    if(recordBytesAvailable() > 4)
     {
 
 	int time;
@@ -94,35 +427,38 @@ void LogFile::timerFired()
         // TODO: going back in time will be a problem
         while ((lastPlayed + ((time - timeOffset)* playbackSpeed) > lastTimeStamp)) {
 	    lastPlayed += ((time - timeOffset)* playbackSpeed);
-            if(file.bytesAvailable() < 4) {
+            if(recordBytesAvailable() < 4) {
                 stopReplay();
                 return;
             }
 
-            file.read((char *) &dataSize, sizeof(dataSize));
+            readRecordBytes(&dataSize, sizeof(dataSize));
 
 	    if (dataSize<1 || dataSize>(1024*1024)) {
 	        qDebug() << "Error: Logfile corrupted! Unlikely packet size: " << dataSize << "\n";
 		stopReplay();
 		return;
 	    }
-            if(file.bytesAvailable() < dataSize) {
+            if(recordBytesAvailable() < dataSize) {
                 stopReplay();
                 return;
             }
 
-            mutex.lock();
-            dataBuffer.append(file.read(dataSize));
-            mutex.unlock();
+            QByteArray packet = readRecordData(dataSize);
+            if (!idMap.isEmpty())
+                remapPacket(packet);
+            // Merged logs first where they are not ahead of this record
+            pullMerged(lastTimeStamp);
+            queuePacket(packet);
             emit readyRead();
 
-            if(file.bytesAvailable() < 4) {
+            if(recordBytesAvailable() < 4) {
                 stopReplay();
                 return;
             }
 
             int save=lastTimeStamp;
-            file.read((char *) &lastTimeStamp,sizeof(lastTimeStamp));
+            readRecordBytes(&lastTimeStamp, sizeof(lastTimeStamp));
 	    // some validity checks
 	    if (lastTimeStamp<save // logfile goies back in time
 		    || (lastTimeStamp-save) > (60*60*1000)) { // gap of more than 60 minutes)
@@ -135,6 +471,8 @@ void LogFile::timerFired()
             time = myTime.elapsed();
 
         }
+        pullMerged(lastPlayed);
+        emit replayPositionChanged(lastPlayed);
     } else {
         stopReplay();
     }
@@ -142,18 +480,106 @@ void LogFile::timerFired()
 }
 
 bool LogFile::startReplay() {
-    dataBuffer.clear();
+    mutex.lock();
+    pending.clear();
+    pendingHead = 0;
+    pendingBytes = 0;
+    mutex.unlock();
     myTime.restart();
     timeOffset = 0;
     lastPlayed = 0;
     playbackSpeed = 1;
-    file.read((char *) &lastTimeStamp,sizeof(lastTimeStamp));
+    readRecordBytes(&lastTimeStamp, sizeof(lastTimeStamp));
+    foreach (LogPrefetcher* prefetcher, merged)
+        prefetcher->restart(0);
     timer.setInterval(10);
     timer.start();
     emit replayStarted();
     return true;
 }
 
+/**
+ * Replay another log, e.g. the onboard log of the same flight, merged with
+ * this one. Its timestamps are shifted by timeOffset (ms) onto this log's
+ * timeline. Call after open() and before startReplay().
+ */
+bool LogFile::addMergedLog(const QString& fileName, qint32 timeOffset)
+{
+    LogPrefetcher* prefetcher = new LogPrefetcher(fileName, timeOffset, objMngr);
+    if (!prefetcher->isValid()) {
+        delete prefetcher;
+        return false;
+    }
+    merged.append(prefetcher);
+    duration = qMax(duration, prefetcher->getDuration());
+    return true;
+}
+
+/**
+ * Queue the packets of the merged logs up to timeStamp
+ */
+void LogFile::pullMerged(quint32 timeStamp)
+{
+    if (merged.isEmpty())
+        return;
+    QList<QByteArray> packets;
+    foreach (LogPrefetcher* prefetcher, merged)
+        prefetcher->takeUntil(timeStamp, packets);
+    if (packets.isEmpty())
+        return;
+    foreach (const QByteArray& packet, packets)
+        queuePacket(packet);
+    emit readyRead();
+}
+
+/**
+ * Hand the next record to the reader at once, ignoring the replay clock.
+ * timeStamp is set before readyRead is emitted.
+ * @return false at the end of the records or on a corrupted record
+ */
+bool LogFile::decodeNextRecord(quint32& timeStamp)
+{
+    QByteArray packet;
+    if (!nextRecord(timeStamp, packet))
+        return false;
+    queuePacket(packet);
+    emit readyRead();
+    return true;
+}
+
+/**
+ * Read the record at the current position, with its object ID remapped
+ * @return false at the end of the records or on a corrupted record
+ */
+bool LogFile::nextRecord(quint32& timeStamp, QByteArray& packet)
+{
+    qint64 dataSize;
+    if (recordBytesAvailable() < (qint64)(sizeof(timeStamp) + sizeof(dataSize)))
+        return false;
+    readRecordBytes(&timeStamp, sizeof(timeStamp));
+    readRecordBytes(&dataSize, sizeof(dataSize));
+    if (dataSize < 1 || dataSize > recordBytesAvailable())
+        return false;
+
+    packet = readRecordData(dataSize);
+    if (!idMap.isEmpty())
+        remapPacket(packet);
+    return true;
+}
+
+/**
+ * Position the records at the keyframe at or before timeStamp
+ */
+bool LogFile::rewindRecords(quint32 timeStamp)
+{
+    if (keyframes.isEmpty())
+        return seekRecord(dataStart);
+    int n = keyframes.size() - 1;
+    while (n > 0 && keyframes[n].timeStamp > timeStamp)
+        --n;
+    return seekRecord(keyframes[n].offset);
+}
+
 bool LogFile::stopReplay() {
     close();
     emit replayFinished();
@@ -171,3 +597,514 @@ void LogFile::resumeReplay()
     timer.start();
 }
 
+/**
+ * Jump to timeStamp (ms) in the log. The state of all objects is restored
+ * from the nearest keyframe before it and the records between the keyframe
+ * and timeStamp are replayed at once.
+ */
+bool LogFile::seekReplay(int timeStamp)
+{
+    if (!file.isOpen() || file.isWritable() || keyframes.isEmpty())
+        return false;
+    quint32 target = qMax(timeStamp, 0);
+
+    int n = keyframes.size() - 1;
+    while (n > 0 && keyframes[n].timeStamp > target)
+        --n;
+    const Keyframe& keyframe = keyframes[n];
+
+    QList<QByteArray> packets;
+    foreach (qint64 offset, keyframe.records)
+        packets.append(readRecord(offset));
+
+    seekRecord(keyframe.offset);
+    lastTimeStamp = target;
+    while (recordBytesAvailable() >= (qint64)(sizeof(quint32) + sizeof(qint64))) {
+        quint32 recordTime;
+        qint64 dataSize;
+        readRecordBytes(&recordTime, sizeof(recordTime));
+        if (recordTime >= target) {
+            // Leave the file where timerFired expects it, after the timestamp
+            lastTimeStamp = recordTime;
+            break;
+        }
+        readRecordBytes(&dataSize, sizeof(dataSize));
+        if (dataSize < 1 || dataSize > recordBytesAvailable())
+            break;
+        QByteArray packet = readRecordData(dataSize);
+        if (!idMap.isEmpty())
+            remapPacket(packet);
+        packets.append(packet);
+    }
+
+    mutex.lock();
+    pending.clear();
+    pendingHead = 0;
+    pendingBytes = 0;
+    mutex.unlock();
+    foreach (const QByteArray& packet, packets)
+        queuePacket(packet);
+    lastPlayed = target;
+    timeOffset = myTime.elapsed();
+    foreach (LogPrefetcher* prefetcher, merged)
+        prefetcher->restart(target);
+    pullMerged(target);
+    emit readyRead();
+    emit replayPositionChanged(lastPlayed);
+    return true;
+}
+
+
+/**
+ * Write the version 2 header with the definitions of all known objects
+ */
+bool LogFile::writeHeader()
+{
+    QList< QList<UAVObject*> > objs;
+    if (objMngr)
+        objs = objMngr->getObjects();
+
+    QByteArray header;
+    QDataStream stream(&header, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    // Hash of the object IDs so tools can quickly check they know this object set
+    QList<quint32> ids;
+    for (int n = 0; n < objs.length(); ++n)
+        ids << objs[n][0]->getObjID();
+    qSort(ids);
+    objectsHash = 0;
+    foreach (quint32 id, ids)
+        objectsHash ^= id + 0x9e3779b9 + (objectsHash << 6) + (objectsHash >> 2);
+
+    if (compact) {
+        uint8_t compactHeader[OPLOG_HEADER_LENGTH];
+        OPLogWriterInit(&compactWriter, OPLOG_DEFAULT_SYNC_INTERVAL);
+        OPLogWriteHeader(&compactWriter, compactHeader, OPLOG_SOURCE_GCS, objectsHash);
+        version = LOG_VERSION_COMPACT;
+        dataStart = OPLOG_HEADER_LENGTH;
+        return file.write((const char *) compactHeader, sizeof(compactHeader)) == sizeof(compactHeader);
+    }
+    stream << objectsHash;
+
+    stream << (quint32)objs.length();
+    for (int n = 0; n < objs.length(); ++n) {
+        UAVObject* obj = objs[n][0];
+        UAVDataObject* dobj = dynamic_cast<UAVDataObject*>(obj);
+        quint8 flags = (obj->isSingleInstance() ? 0x01 : 0) |
+                       ((dobj && dobj->isSettings()) ? 0x02 : 0) |
+                       (dynamic_cast<UAVMetaObject*>(obj) ? 0x04 : 0);
+        stream << obj->getObjID() << flags << obj->getNumBytes();
+        writeString(stream, obj->getName());
+        QList<UAVObjectField*> fields = obj->getFields();
+        stream << (quint16)fields.size();
+        foreach (UAVObjectField* field, fields) {
+            writeString(stream, field->getName());
+            writeString(stream, field->getUnits());
+            stream << (quint8)field->getType() << field->getNumElements();
+            writeStringList(stream, field->getElementNames());
+            writeStringList(stream, field->getOptions());
+        }
+    }
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.writeRawData(LOG_HEADER_MAGIC, sizeof(LOG_HEADER_MAGIC));
+    version = compressed ? LOG_VERSION_COMPRESSED : LOG_VERSION;
+    out << version << (quint32)header.size();
+    out.writeRawData(header.constData(), header.size());
+
+    dataStart = file.pos();
+    return out.status() == QDataStream::Ok;
+}
+
+/**
+ * Read the header, logs without one are version 1 and start with records
+ */
+bool LogFile::readHeader()
+{
+    char magic[sizeof(LOG_HEADER_MAGIC)];
+    version = 1;
+    objectsHash = 0;
+    dataStart = 0;
+    dataEnd = file.size();
+
+    file.seek(0);
+    if (file.read(magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, LOG_HEADER_MAGIC, sizeof(magic)) != 0) {
+        file.seek(0);
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setByteOrder(QDataStream::LittleEndian);
+    quint32 headerLength;
+    in >> version >> headerLength;
+    QByteArray header = file.read(headerLength);
+    dataStart = file.pos();
+    if (in.status() != QDataStream::Ok || (quint32)header.size() != headerLength) {
+        qDebug() << "Error: Logfile header truncated";
+        dataStart = dataEnd;
+        return false;
+    }
+
+    QDataStream stream(header);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    quint32 objectCount;
+    stream >> objectsHash >> objectCount;
+    for (quint32 n = 0; n < objectCount && stream.status() == QDataStream::Ok; ++n) {
+        ObjectDefinition def;
+        quint8 flags;
+        quint16 fieldCount;
+        stream >> def.objId >> flags >> def.numBytes;
+        def.singleInstance = flags & 0x01;
+        def.settings = flags & 0x02;
+        def.metaObject = flags & 0x04;
+        def.name = readString(stream);
+        stream >> fieldCount;
+        for (int f = 0; f < fieldCount && stream.status() == QDataStream::Ok; ++f) {
+            FieldDefinition field;
+            field.name = readString(stream);
+            field.units = readString(stream);
+            stream >> field.type >> field.numElements;
+            field.elementNames = readStringList(stream);
+            field.options = readStringList(stream);
+            def.fields.append(field);
+        }
+        definitions.append(def);
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+/**
+ * Append the time and object indices and the footer pointing to them
+ */
+bool LogFile::writeIndex()
+{
+    if (compact) {
+        QVector<struct oplog_index_entry> entries(timeIndex.size());
+        for (int n = 0; n < timeIndex.size(); ++n) {
+            entries[n].time = timeIndex[n].timeStamp;
+            entries[n].offset = timeIndex[n].offset;
+        }
+        QByteArray index(OPLogIndexLength(entries.size()), 0);
+        OPLogWriteIndex(&compactWriter, (uint8_t *) index.data(), entries.constData(), entries.size());
+        return file.write(index) == index.size();
+    }
+
+    qint64 indexOffset = file.pos();
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << (quint32)timeIndex.size();
+    foreach (TimeIndexEntry entry, timeIndex)
+        out << entry.timeStamp << entry.offset;
+    out << (quint32)objectOffsets.size();
+    for (QHash<quint32, QVector<qint64> >::const_iterator itr = objectOffsets.constBegin(); itr != objectOffsets.constEnd(); ++itr) {
+        out << itr.key() << (quint32)itr.value().size();
+        foreach (qint64 offset, itr.value())
+            out << offset;
+    }
+    out << indexOffset;
+    out.writeRawData(LOG_INDEX_MAGIC, sizeof(LOG_INDEX_MAGIC));
+
+    return out.status() == QDataStream::Ok;
+}
+
+/**
+ * Read the indices if the log was closed properly, records end where they start
+ */
+bool LogFile::readIndex()
+{
+    qint64 size = file.size();
+    if (version < 2 || size - dataStart < LOG_FOOTER_LENGTH)
+        return false;
+
+    QDataStream in(&file);
+    in.setByteOrder(QDataStream::LittleEndian);
+    char magic[sizeof(LOG_INDEX_MAGIC)];
+    qint64 indexOffset;
+    file.seek(size - LOG_FOOTER_LENGTH);
+    in >> indexOffset;
+    if (in.readRawData(magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, LOG_INDEX_MAGIC, sizeof(magic)) != 0 ||
+        indexOffset < dataStart || indexOffset > size - LOG_FOOTER_LENGTH) {
+        qDebug() << "Logfile has no index, it was probably not closed properly";
+        return false;
+    }
+
+    file.seek(indexOffset);
+    quint32 count;
+    in >> count;
+    if ((qint64)count * (qint64)(sizeof(quint32) + sizeof(qint64)) > size - file.pos())
+        in.setStatus(QDataStream::ReadCorruptData);
+    for (quint32 n = 0; n < count && in.status() == QDataStream::Ok; ++n) {
+        TimeIndexEntry entry;
+        in >> entry.timeStamp >> entry.offset;
+        timeIndex.append(entry);
+    }
+    in >> count;
+    for (quint32 n = 0; n < count && in.status() == QDataStream::Ok; ++n) {
+        quint32 objId;
+        quint32 offsets;
+        in >> objId >> offsets;
+        if ((qint64)offsets * (qint64)sizeof(qint64) > size - file.pos()) {
+            in.setStatus(QDataStream::ReadCorruptData);
+            break;
+        }
+        QVector<qint64>& table = objectOffsets[objId];
+        table.resize(offsets);
+        for (quint32 i = 0; i < offsets; ++i)
+            in >> table[i];
+    }
+    if (in.status() != QDataStream::Ok) {
+        qDebug() << "Error: Logfile index corrupted, ignoring it";
+        timeIndex.clear();
+        objectOffsets.clear();
+        return false;
+    }
+
+    dataEnd = indexOffset;
+    indexed = true;
+    return true;
+}
+
+/**
+ * Decode a compact log into version 1 records in blockData, indexed as they
+ * are decoded. Corrupted spans are skipped up to the next sync frame.
+ * @return false if the file is not a compact log
+ */
+bool LogFile::readCompact()
+{
+    QByteArray header = file.peek(OPLOG_HEADER_LENGTH);
+    if (!OPLogIsCompact((const uint8_t *) header.constData(), header.size()) || file.size() > 0xFFFFFFFFLL)
+        return false;
+
+    QByteArray data = file.readAll();
+    struct oplog_reader reader;
+    if (!OPLogReaderInit(&reader, (const uint8_t *) data.constData(), data.size())) {
+        file.seek(0);
+        return false;
+    }
+
+    struct oplog_record record;
+    blockData.clear();
+    while (OPLogReadRecord(&reader, &record)) {
+        quint32 timeStamp = record.time;
+        qint64 dataSize = record.length;
+        indexRecord(timeStamp, blockData.size(), (const char *) record.packet, dataSize);
+        blockData.append((const char *) &timeStamp, sizeof(timeStamp));
+        blockData.append((const char *) &dataSize, sizeof(dataSize));
+        blockData.append((const char *) record.packet, dataSize);
+    }
+    if (reader.resyncs)
+        qDebug() << "Logfile:" << reader.resyncs << "corrupted spans skipped in" << file.fileName();
+
+    version = LOG_VERSION_COMPACT;
+    objectsHash = reader.objects_hash;
+    Block block;
+    block.fileOffset = 0;
+    block.rawOffset = 0;
+    block.rawSize = blockData.size();
+    blocks.clear();
+    blocks.append(block);
+    currentBlock = 0;
+    dataStart = 0;
+    dataEnd = blockData.size();
+    readPos = 0;
+    indexed = true;
+    return true;
+}
+
+/**
+ * Map logged object IDs to the current ones for objects whose ID changed
+ * but whose data layout did not (e.g. only enum options were added).
+ */
+void LogFile::buildIdMap()
+{
+    idMap.clear();
+    if (!objMngr)
+        return;
+    foreach (ObjectDefinition def, definitions) {
+        UAVObject* obj = objMngr->getObject(def.name);
+        if (obj == NULL) {
+            qDebug() << "Logfile: object" << def.name << "is unknown, its updates will be ignored";
+        } else if (obj->getObjID() != def.objId) {
+            if (layoutMatches(def, obj))
+                idMap.insert(def.objId, obj->getObjID());
+            else
+                qDebug() << "Logfile: object" << def.name << "changed layout, its updates will be ignored";
+        }
+    }
+}
+
+/**
+ * Scan the records once and store a keyframe every KEYFRAME_INTERVAL_MS
+ * with the offsets of the latest update of every object instance.
+ */
+void LogFile::buildKeyframes()
+{
+    const qint64 recordHeader = sizeof(quint32) + sizeof(qint64);
+    QHash<quint64, qint64> latest;
+    quint32 nextKeyframe = 0;
+
+    seekRecord(dataStart);
+    while (recordBytesAvailable() >= recordHeader) {
+        qint64 offset = recordPos();
+        quint32 timeStamp;
+        qint64 dataSize;
+        readRecordBytes(&timeStamp, sizeof(timeStamp));
+        readRecordBytes(&dataSize, sizeof(dataSize));
+        if (dataSize < 1 || dataSize > recordBytesAvailable())
+            break;
+
+        if (keyframes.isEmpty() || timeStamp >= nextKeyframe) {
+            Keyframe keyframe;
+            keyframe.timeStamp = timeStamp;
+            keyframe.offset = offset;
+            keyframe.records = latest.values().toVector();
+            qSort(keyframe.records);
+            keyframes.append(keyframe);
+            nextKeyframe = timeStamp + KEYFRAME_INTERVAL_MS;
+        }
+        duration = timeStamp;
+
+        // Only object updates carry state, requests and acks are not kept
+        quint8 header[10];
+        qint64 headerLength = readRecordBytes(header, qMin(dataSize, (qint64)sizeof(header)));
+        if (headerLength >= 8 && header[0] == UAVTALK_SYNC_VAL && (header[1] == 0x20 || header[1] == 0x22)) {
+            quint32 objId = qFromLittleEndian<quint32>(&header[4]);
+            quint16 instId = 0;
+            UAVObject* obj = objMngr ? objMngr->getObject(idMap.value(objId, objId)) : NULL;
+            if (obj != NULL && !obj->isSingleInstance() && headerLength >= 10)
+                instId = qFromLittleEndian<quint16>(&header[8]);
+            latest.insert(((quint64)objId << 16) | instId, offset);
+        }
+        seekRecord(offset + recordHeader + dataSize);
+    }
+    seekRecord(dataStart);
+}
+
+/**
+ * Random access to the record at offset (e.g. taken from the index)
+ */
+bool LogFile::readRecordAt(qint64 offset, quint32& timeStamp, QByteArray& packet)
+{
+    if (!file.isOpen() || !seekRecord(offset) || readRecordBytes(&timeStamp, sizeof(timeStamp)) != sizeof(timeStamp))
+        return false;
+    packet = readRecord(offset);
+    return !packet.isEmpty();
+}
+
+/**
+ * Read the packet of the record at offset, with its object ID remapped
+ */
+QByteArray LogFile::readRecord(qint64 offset)
+{
+    qint64 dataSize;
+    if (!seekRecord(offset + sizeof(quint32)) || readRecordBytes(&dataSize, sizeof(dataSize)) != sizeof(dataSize)
+            || dataSize < 1 || dataSize > recordBytesAvailable())
+        return QByteArray();
+    QByteArray packet = readRecordData(dataSize);
+    if (!idMap.isEmpty())
+        remapPacket(packet);
+    return packet;
+}
+
+/**
+ * Find the blocks of a compressed log, afterwards dataStart and dataEnd
+ * refer to the uncompressed record stream
+ */
+bool LogFile::scanBlocks()
+{
+    qint64 fileOffset = dataStart;
+    qint64 rawOffset = 0;
+    bool ok = true;
+    blocks.clear();
+    currentBlock = -1;
+    while (dataEnd - fileOffset >= 2 * (qint64)sizeof(quint32)) {
+        uchar header[2 * sizeof(quint32)];
+        if (!file.seek(fileOffset) || file.read((char *) header, sizeof(header)) != sizeof(header)) {
+            ok = false;
+            break;
+        }
+        // The length, then the big endian size qCompress puts in front of its data
+        quint32 length = qFromLittleEndian<quint32>(header);
+        qint64 rawSize = qFromBigEndian<quint32>(header + sizeof(quint32));
+        if (length < sizeof(quint32) || (qint64)length > dataEnd - fileOffset - (qint64)sizeof(quint32)) {
+            qDebug() << "Error: Logfile block at" << fileOffset << "truncated";
+            ok = false;
+            break;
+        }
+        Block block;
+        block.fileOffset = fileOffset;
+        block.rawOffset = rawOffset;
+        block.rawSize = rawSize;
+        blocks.append(block);
+        fileOffset += sizeof(quint32) + length;
+        rawOffset += rawSize;
+    }
+    dataStart = 0;
+    dataEnd = rawOffset;
+    readPos = 0;
+    return ok;
+}
+
+/**
+ * Make the block holding the uncompressed position pos current
+ */
+bool LogFile::loadBlock(qint64 pos)
+{
+    if (currentBlock >= 0 && pos >= blocks[currentBlock].rawOffset &&
+            pos < blocks[currentBlock].rawOffset + blockData.size())
+        return true;
+    if (pos < 0 || pos >= dataEnd)
+        return false;
+
+    int first = 0;
+    int last = blocks.size() - 1;
+    while (first < last) {
+        int middle = (first + last + 1) / 2;
+        if (blocks[middle].rawOffset <= pos)
+            first = middle;
+        else
+            last = middle - 1;
+    }
+    const Block& block = blocks[first];
+    quint32 length;
+    QByteArray data;
+    if (mapped) {
+        memcpy(&length, mapped + block.fileOffset, sizeof(length));
+        data = QByteArray::fromRawData((const char *) mapped + block.fileOffset + sizeof(length), length);
+    } else {
+        file.seek(block.fileOffset);
+        file.read((char *) &length, sizeof(length));
+        data = file.read(length);
+    }
+    blockData = qUncompress(data);
+    if (blockData.size() != block.rawSize) {
+        qDebug() << "Error: Logfile block at" << block.fileOffset << "corrupted";
+        blockData.clear();
+        currentBlock = -1;
+        return false;
+    }
+    currentBlock = first;
+    return true;
+}
+
+/**
+ * Rewrite the object ID of a logged packet according to idMap
+ */
+void LogFile::remapPacket(QByteArray& packet)
+{
+    if (packet.size() < 9 || (quint8)packet[0] != UAVTALK_SYNC_VAL)
+        return;
+    const quint8* header = (const quint8*)packet.constData();
+    if (qFromLittleEndian<quint16>(&header[2]) + 1 != packet.size())
+        return;
+    QHash<quint32, quint32>::const_iterator itr = idMap.constFind(qFromLittleEndian<quint32>(&header[4]));
+    if (itr == idMap.constEnd())
+        return;
+    // Only now detach, replayed packets may be views into the mapped log
+    quint8* data = (quint8*)packet.data();
+    qToLittleEndian<quint32>(itr.value(), &data[4]);
+    data[packet.size() - 1] = updateCRC(0, data, packet.size() - 1);
+}
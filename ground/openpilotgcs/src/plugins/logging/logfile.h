@@ -5,31 +5,116 @@
 #include <QTime>
 #include <QTimer>
 #include <QMutexLocker>
+#include <QThread>
+#include <QWaitCondition>
 #include <QDebug>
 #include <QBuffer>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
 #include "uavobjectmanager.h"
+#include "oplog.h"
 #include <math.h>
 
+class LogFile;
+class LogPrefetcher;
+
+/** Drains the recording buffer of a LogFile to disk in large sequential writes */
+class LogFileWriter : public QThread
+{
+public:
+    LogFileWriter(LogFile* logFile) : logFile(logFile) {};
+protected:
+    void run();
+    LogFile* logFile;
+};
+
 class LogFile : public QIODevice
 {
     Q_OBJECT
 public:
+    /** Description of a logged object field, taken from the log header */
+    typedef struct {
+        QString name;
+        QString units;
+        quint8 type; /** UAVObjectField::FieldType */
+        quint32 numElements;
+        QStringList elementNames;
+        QStringList options;
+    } FieldDefinition;
+
+    /** Description of a logged object, taken from the log header */
+    typedef struct {
+        quint32 objId;
+        QString name;
+        bool singleInstance;
+        bool settings;
+        bool metaObject;
+        quint32 numBytes;
+        QList<FieldDefinition> fields;
+    } ObjectDefinition;
+
+    /** Entry of the time index, offset of the first record at or after timeStamp */
+    typedef struct {
+        quint32 timeStamp;
+        qint64 offset;
+    } TimeIndexEntry;
+
+    /** Replay keyframe, the records holding the latest state of every object at timeStamp */
+    typedef struct {
+        quint32 timeStamp;
+        qint64 offset;
+        QVector<qint64> records;
+    } Keyframe;
+
+    static const quint32 LOG_VERSION = 2;
+    static const quint32 LOG_VERSION_COMPRESSED = 3;
+    static const quint32 LOG_VERSION_COMPACT = 4; // shared/oplog format, as the onboard logger writes it
+    static const int INDEX_INTERVAL_MS = 1000;
+    static const int KEYFRAME_INTERVAL_MS = 10000;
+    static const int WRITE_CHUNK_SIZE = 256 * 1024;
+    static const int WRITE_BUFFER_LIMIT = 8 * 1024 * 1024; // records are dropped beyond this
+    static const int WRITE_FLUSH_MS = 500;
+    static const int COMPRESSED_FLUSH_MS = 5000;
+    static const int COMPRESSION_LEVEL = 1;
+
     explicit LogFile(QObject *parent = 0);
+    ~LogFile();
     qint64 bytesAvailable() const;
     qint64 bytesToWrite() { return file.bytesToWrite(); };
     bool open(OpenMode mode);
     void setFileName(QString name) { file.setFileName(name); };
+    void setObjectManager(UAVObjectManager* objMngr) { this->objMngr = objMngr; };
+    void setCompressed(bool compressed) { this->compressed = compressed; };
+    bool isCompressed() const { return compressed; };
+    void setCompact(bool compact) { this->compact = compact; };
     void close();
     qint64 writeData(const char * data, qint64 dataSize);
     qint64 readData(char * data, qint64 maxlen);
 
+    quint32 getVersion() const { return version; };
+    quint32 getObjectsHash() const { return objectsHash; };
+    const QList<ObjectDefinition>& getObjectDefinitions() const { return definitions; };
+    const QVector<TimeIndexEntry>& getTimeIndex() const { return timeIndex; };
+    QVector<qint64> getObjectOffsets(quint32 objId) const { return objectOffsets.value(objId); };
+    bool hasIndex() const { return indexed; };
+    quint32 getDuration() const { return duration; };
+    quint32 getDroppedPackets() const { return droppedPackets; };
+
+    bool addMergedLog(const QString& fileName, qint32 timeOffset = 0);
     bool startReplay();
     bool stopReplay();
+    bool decodeNextRecord(quint32& timeStamp);
+    bool nextRecord(quint32& timeStamp, QByteArray& packet);
+    bool rewindRecords(quint32 timeStamp);
+    bool readRecordAt(qint64 offset, quint32& timeStamp, QByteArray& packet);
+    bool recordsAtEnd() { return recordBytesAvailable() <= 0; };
 
 public slots:
     void setReplaySpeed(double val) { playbackSpeed = val; qDebug() << playbackSpeed; };
     void pauseReplay();
     void resumeReplay();
+    bool seekReplay(int timeStamp);
 
 protected slots:
     void timerFired();
@@ -38,9 +123,15 @@ signals:
     void readReady();
     void replayStarted();
     void replayFinished();
+    void replayPositionChanged(int timeStamp);
+    void droppedPacketsChanged(int dropped);
 
 protected:
-    QByteArray dataBuffer;
+    // Packets waiting to be read. While replaying from the mapped file these
+    // are views into the mapping, only remapped packets are copies.
+    QList<QByteArray> pending;
+    qint64 pendingHead;
+    qint64 pendingBytes;
     QTimer timer;
     QTime myTime;
     QFile file;
@@ -51,6 +142,73 @@ protected:
 
     int timeOffset;
     double playbackSpeed;
+
+    // Container state
+    UAVObjectManager* objMngr;
+    quint32 version;
+    quint32 objectsHash;
+    bool indexed;
+    qint64 dataStart;
+    qint64 dataEnd;
+    QList<ObjectDefinition> definitions;
+    QVector<TimeIndexEntry> timeIndex;
+    QHash<quint32, QVector<qint64> > objectOffsets;
+    QHash<quint32, quint32> idMap;
+    QVector<Keyframe> keyframes;
+    quint32 duration;
+    uchar* mapped;
+    qint64 readPos;
+
+    // Logs replayed together with this one, read ahead on worker threads
+    QList<LogPrefetcher*> merged;
+
+    // Compressed logs, record offsets are positions in the uncompressed stream
+    typedef struct {
+        qint64 fileOffset;
+        qint64 rawOffset;
+        qint64 rawSize;
+    } Block;
+    bool compressed;
+    QVector<Block> blocks;
+    int currentBlock;
+    QByteArray blockData;
+
+    // Compact logs are written in that format and read by decoding them at
+    // once into version 1 records, held as the only block of a compressed log
+    bool compact;
+    struct oplog_writer compactWriter;
+
+    // Recording, writeData only appends to writeBuffer and the writer
+    // thread swaps it out and writes it, so slow disks do not stall telemetry
+    friend class LogFileWriter;
+    LogFileWriter writer;
+    QMutex writeMutex;
+    QWaitCondition writeReady;
+    QByteArray writeBuffer;
+    qint64 writeInFlight;
+    qint64 writeOffset;
+    bool writerStop;
+    quint32 droppedPackets;
+
+    qint64 recordPos() { return (mapped || compressed) ? readPos : file.pos(); };
+    qint64 recordBytesAvailable() { return dataEnd - recordPos(); };
+    bool seekRecord(qint64 pos);
+    qint64 readRecordBytes(void* data, qint64 size);
+    QByteArray readRecordData(qint64 size);
+    void queuePacket(const QByteArray& packet);
+    bool scanBlocks();
+    void pullMerged(quint32 timeStamp);
+    bool loadBlock(qint64 pos);
+    bool writeHeader();
+    bool readHeader();
+    bool writeIndex();
+    bool readIndex();
+    bool readCompact();
+    void indexRecord(quint32 timeStamp, qint64 offset, const char* data, qint64 dataSize);
+    void buildIdMap();
+    void remapPacket(QByteArray& packet);
+    void buildKeyframes();
+    QByteArray readRecord(qint64 offset);
 };
 
 #endif // LOGFILE_H
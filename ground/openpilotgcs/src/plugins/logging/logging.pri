@@ -0,0 +1,3 @@
+include(logging_dependencies.pri)
+
+LIBS *= -l$$qtLibraryName(LoggingGadget)
@@ -4,8 +4,17 @@ DEFINES += LOGGING_LIBRARY
 QT += svg
 include(../../openpilotgcsplugin.pri)
 include(logging_dependencies.pri)
+# The compact log format is shared with the onboard logger
+INCLUDEPATH += $$GCS_SOURCE_TREE/../../shared/oplog
+QMAKE_CFLAGS += -std=gnu99
 HEADERS += loggingplugin.h \
+    logging_global.h \
     logfile.h \
+    logdecoder.h \
+    loggingprofile.h \
+    logquery.h \
+    loganalysis.h \
+    logprefetcher.h \
     logginggadgetwidget.h \
     logginggadget.h \
     logginggadgetfactory.h
@@ -14,9 +23,15 @@ HEADERS += loggingplugin.h \
 
 SOURCES += loggingplugin.cpp \
     logfile.cpp \
+    logdecoder.cpp \
+    loggingprofile.cpp \
+    logquery.cpp \
+    loganalysis.cpp \
+    logprefetcher.cpp \
     logginggadgetwidget.cpp \
     logginggadget.cpp \
-    logginggadgetfactory.cpp
+    logginggadgetfactory.cpp \
+    $$GCS_SOURCE_TREE/../../shared/oplog/oplog.c
 #    logginggadgetconfiguration.cpp \
 #    logginggadgetoptionspage.cpp
 OTHER_FILES += LoggingGadget.pluginspec
@@ -59,6 +59,16 @@ void LoggingGadgetWidget::setPlugin(LoggingPlugin * p)
     connect(m_logging->pauseButton,SIGNAL(clicked()),p->getLogfile(),SLOT(pauseReplay()));
     connect(m_logging->pauseButton, SIGNAL(clicked()), scpPlugin, SLOT(stopPlotting()));
     connect(m_logging->playbackSpeed,SIGNAL(valueChanged(double)),p->getLogfile(),SLOT(setReplaySpeed(double)));
+    connect(p->getLogfile(), SIGNAL(replayPositionChanged(int)), this, SLOT(replayPositionChanged(int)));
+    connect(p, SIGNAL(droppedPacketsChanged(int)), this, SLOT(droppedPacketsChanged(int)));
+
+    m_logging->profileBox->addItem(tr("All objects"), QString());
+    foreach (QString name, p->getProfiles())
+        m_logging->profileBox->addItem(name, name);
+    m_logging->profileBox->setCurrentIndex(qMax(0, m_logging->profileBox->findData(p->getProfile())));
+    connect(m_logging->profileBox, SIGNAL(currentIndexChanged(int)), this, SLOT(profileChanged(int)));
+    connect(m_logging->positionSlider, SIGNAL(valueChanged(int)), this, SLOT(positionSliderChanged(int)));
+    connect(m_logging->positionSlider, SIGNAL(sliderReleased()), this, SLOT(positionSliderReleased()));
     void pauseReplay();
     void resumeReplay();
 }
@@ -67,6 +77,67 @@ void LoggingGadgetWidget::setPlugin(LoggingPlugin * p)
 void LoggingGadgetWidget::stateChanged(QString status)
 {
     m_logging->statusLabel->setText(status);
+    if (status == "LOGGING")
+        m_logging->droppedLabel->clear();
+
+    // The scrub bar is only usable while replaying, one step per second
+    bool replaying = (status == "REPLAY");
+    m_logging->positionSlider->blockSignals(true);
+    m_logging->positionSlider->setRange(0, replaying ? loggingPlugin->getLogfile()->getDuration() / 1000 : 0);
+    m_logging->positionSlider->setValue(0);
+    m_logging->positionSlider->blockSignals(false);
+    m_logging->positionSlider->setEnabled(replaying);
+    updatePositionLabel(0);
+}
+
+void LoggingGadgetWidget::profileChanged(int index)
+{
+    loggingPlugin->setProfile(m_logging->profileBox->itemData(index).toString());
+}
+
+/**
+ * Recording could not keep up with the link
+ */
+void LoggingGadgetWidget::droppedPacketsChanged(int dropped)
+{
+    m_logging->droppedLabel->setText(tr("Dropped packets: %1").arg(dropped));
+}
+
+/**
+ * Follow the replay unless the user is dragging the slider
+ */
+void LoggingGadgetWidget::replayPositionChanged(int timeStamp)
+{
+    int seconds = timeStamp / 1000;
+    if (m_logging->positionSlider->isSliderDown() || m_logging->positionSlider->value() == seconds)
+        return;
+    m_logging->positionSlider->blockSignals(true);
+    m_logging->positionSlider->setValue(seconds);
+    m_logging->positionSlider->blockSignals(false);
+    updatePositionLabel(seconds);
+}
+
+/**
+ * Seek right away on clicks and keys, while dragging only once released
+ */
+void LoggingGadgetWidget::positionSliderChanged(int value)
+{
+    updatePositionLabel(value);
+    if (!m_logging->positionSlider->isSliderDown())
+        loggingPlugin->getLogfile()->seekReplay(value * 1000);
+}
+
+void LoggingGadgetWidget::positionSliderReleased()
+{
+    loggingPlugin->getLogfile()->seekReplay(m_logging->positionSlider->value() * 1000);
+}
+
+void LoggingGadgetWidget::updatePositionLabel(int seconds)
+{
+    int total = m_logging->positionSlider->maximum();
+    m_logging->positionLabel->setText(QString("%1:%2 / %3:%4")
+                                      .arg(seconds / 60).arg(seconds % 60, 2, 10, QChar('0'))
+                                      .arg(total / 60).arg(total % 60, 2, 10, QChar('0')));
 }
 
 /**
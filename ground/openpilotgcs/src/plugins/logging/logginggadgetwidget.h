@@ -48,6 +48,11 @@ public:
 
 protected slots:
     void stateChanged(QString status);
+    void replayPositionChanged(int timeStamp);
+    void droppedPacketsChanged(int dropped);
+    void profileChanged(int index);
+    void positionSliderChanged(int value);
+    void positionSliderReleased();
 
 signals:
     void pause();
@@ -58,6 +63,8 @@ private:
     LoggingPlugin * loggingPlugin;
     ScopeGadgetFactory * scpPlugin;
 
+    void updatePositionLabel(int seconds);
+
 
 };
 
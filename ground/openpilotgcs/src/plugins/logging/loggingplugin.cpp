@@ -38,6 +38,7 @@
 #include <QList>
 #include <QErrorMessage>
 #include <QWriteLocker>
+#include <QSettings>
 
 #include <extensionsystem/pluginmanager.h>
 #include <QKeySequence>
@@ -76,18 +77,25 @@ QIODevice* LoggingConnection::openDevice(const QString &deviceName)
     if (logFile.isOpen()){
         logFile.close();
     }
-    QString fileName = QFileDialog::getOpenFileName(NULL, tr("Open file"), QString(""), tr("OpenPilot Log (*.opl)"));
-    if (!fileName.isNull()) {
-        startReplay(fileName);
+    // Several logs of the same flight (e.g. GCS and onboard) are replayed merged
+    QStringList fileNames = QFileDialog::getOpenFileNames(NULL, tr("Open file"), QString(""), tr("OpenPilot Log (*.opl *.oplz *.oplc *.opc)"));
+    if (!fileNames.isEmpty()) {
+        startReplay(fileNames);
     }
     return &logFile;
 }
 
-void LoggingConnection::startReplay(QString file)
+void LoggingConnection::startReplay(QStringList files)
 {
-    logFile.setFileName(file);
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    logFile.setFileName(files.first());
+    logFile.setObjectManager(pm->getObject<UAVObjectManager>());
     if(logFile.open(QIODevice::ReadOnly)) {
-        qDebug() << "Replaying " << file;
+        for (int n = 1; n < files.size(); ++n) {
+            if (!logFile.addMergedLog(files[n]))
+                qDebug() << "Unable to merge " << files[n];
+        }
+        qDebug() << "Replaying " << files;
         // state = REPLAY;
         logFile.startReplay();
     }
@@ -127,12 +135,15 @@ QString LoggingConnection::shortName()
   */
 bool LoggingThread::openFile(QString file, LoggingPlugin * parent)
 {
-    logFile.setFileName(file);
-    logFile.open(QIODevice::WriteOnly);
-
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
     UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
 
+    logFile.setFileName(file);
+    logFile.setObjectManager(objManager);
+    logFile.setCompressed(file.endsWith(".oplz", Qt::CaseInsensitive));
+    logFile.setCompact(file.endsWith(".oplc", Qt::CaseInsensitive) || file.endsWith(".opc", Qt::CaseInsensitive));
+    logFile.open(QIODevice::WriteOnly);
+
     uavTalk = new UAVTalk(&logFile, objManager);
     connect(parent,SIGNAL(stopLoggingSignal()),this,SLOT(stopLogging()));
 
@@ -148,6 +159,18 @@ bool LoggingThread::openFile(QString file, LoggingPlugin * parent)
 void LoggingThread::objectUpdated(UAVObject * obj)
 {
     QWriteLocker locker(&lock);
+    QHash<UAVObject*, ObjectFilter>::iterator filter = filters.find(obj);
+    if (filter != filters.end()) {
+        if (filter->rule.type == LoggingProfile::LOG_RATE_LIMIT) {
+            int now = clock.elapsed();
+            if (filter->count > 0 && now - filter->lastLogged < (int)filter->rule.value)
+                return;
+            filter->lastLogged = now;
+            filter->count = 1;
+        } else if (filter->count++ % filter->rule.value != 0) {
+            return;
+        }
+    }
     if(!uavTalk->sendObject(obj,false,false) )
         qDebug() << "Error logging " << obj->getName();
 };
@@ -167,10 +190,28 @@ void LoggingThread::run()
     QList<UAVObject*>::const_iterator j;
     int objects = 0;
 
+    filters.clear();
+    clock.start();
     for (i = list.constBegin(); i != list.constEnd(); ++i)
     {
         for (j = (*i).constBegin(); j != (*i).constEnd(); ++j)
         {
+            // Settings and meta objects are always logged in full
+            UAVDataObject* dobj = dynamic_cast<UAVDataObject*>(*j);
+            if (dobj && !dobj->isSettings()) {
+                LoggingProfile::Rule rule = profile.getRule((*j)->getName());
+                if (rule.type == LoggingProfile::LOG_NONE)
+                    continue;
+                dobj->addInterest();
+                loggedObjects.append(dobj);
+                if (rule.type != LoggingProfile::LOG_ALL) {
+                    ObjectFilter filter;
+                    filter.rule = rule;
+                    filter.lastLogged = 0;
+                    filter.count = 0;
+                    filters.insert(*j, filter);
+                }
+            }
             connect(*j, SIGNAL(objectUpdated(UAVObject*)), (LoggingThread*) this, SLOT(objectUpdated(UAVObject*)));
             objects++;
             //qDebug() << "Detected " << j[0];
@@ -215,6 +256,9 @@ void LoggingThread::stopLogging()
             disconnect(*j, SIGNAL(objectUpdated(UAVObject*)), (LoggingThread*) this, SLOT(objectUpdated(UAVObject*)));
         }
     }
+    foreach (UAVObject* obj, loggedObjects)
+        obj->removeInterest();
+    loggedObjects.clear();
 
     logFile.close();
     qDebug() << "File closed";
@@ -323,6 +367,23 @@ bool LoggingPlugin::initialize(const QStringList& args, QString *errMsg)
 
     loggingThread = NULL;
 
+    // Offer an example profile the first time, navigation state at 10 Hz
+    QSettings* settings = Core::ICore::instance()->settings();
+    if (LoggingProfile::profileNames(settings).isEmpty()) {
+        LoggingProfile navigation("Navigation");
+        LoggingProfile::Rule rule;
+        rule.type = LoggingProfile::LOG_RATE_LIMIT;
+        rule.value = 100;
+        navigation.setDefaultRule(rule);
+        rule.type = LoggingProfile::LOG_NONE;
+        rule.value = 0;
+        navigation.setRule("Gyros", rule);
+        navigation.setRule("Accels", rule);
+        navigation.setRule("AttitudeRaw", rule);
+        navigation.save(settings);
+    }
+    profileName = settings->value("Logging/Profile").toString();
+
 
     // Add Menu entry
     Core::ActionManager* am = Core::ICore::instance()->actionManager();
@@ -362,11 +423,22 @@ void LoggingPlugin::toggleLogging()
     if(state == IDLE)
     {
 
+        QString compressedFilter = tr("Compressed OpenPilot Log (*.oplz)");
+        QString compactFilter = tr("Compact OpenPilot Log (*.oplc *.opc)");
+        QString selectedFilter;
         QString fileName = QFileDialog::getSaveFileName(NULL, tr("Start Log"),
                                     tr("OP-%0.opl").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss")),
-                                    tr("OpenPilot Log (*.opl)"));
+                                    tr("OpenPilot Log (*.opl)") + ";;" + compressedFilter + ";;" + compactFilter, &selectedFilter);
         if (fileName.isEmpty())
             return;
+        // Compression and the compact format are chosen by the extension
+        QString extension = selectedFilter == compressedFilter ? ".oplz" : selectedFilter == compactFilter ? ".oplc" : "";
+        if (!extension.isEmpty() && !fileName.endsWith(extension, Qt::CaseInsensitive) &&
+            !(selectedFilter == compactFilter && fileName.endsWith(".opc", Qt::CaseInsensitive))) {
+            if (fileName.endsWith(".opl", Qt::CaseInsensitive))
+                fileName.chop(4);
+            fileName += extension;
+        }
 
         startLogging(fileName);
         cmd->action()->setText(tr("Stop logging"));
@@ -390,9 +462,12 @@ void LoggingPlugin::startLogging(QString file)
     if (loggingThread)
         delete loggingThread;
     loggingThread = new LoggingThread();
+    if (!profileName.isEmpty())
+        loggingThread->setProfile(LoggingProfile::load(Core::ICore::instance()->settings(), profileName));
     if(loggingThread->openFile(file,this))
     {
         connect(loggingThread,SIGNAL(finished()),this,SLOT(loggingStopped()));
+        connect(loggingThread->getLogfile(), SIGNAL(droppedPacketsChanged(int)), this, SIGNAL(droppedPacketsChanged(int)));
         state = LOGGING;
         loggingThread->start();
         emit stateChanged("LOGGING");
@@ -450,6 +525,23 @@ void LoggingPlugin::replayStarted()
 
 
 
+/**
+  * Names of the recording profiles, an empty name logs everything
+  */
+QStringList LoggingPlugin::getProfiles()
+{
+    return LoggingProfile::profileNames(Core::ICore::instance()->settings());
+}
+
+/**
+  * Select the recording profile used by the next logging session
+  */
+void LoggingPlugin::setProfile(const QString& name)
+{
+    profileName = name;
+    Core::ICore::instance()->settings()->setValue("Logging/Profile", name);
+}
+
 void LoggingPlugin::extensionsInitialized()
 {
     addAutoReleasedObject(logConnection);
@@ -36,10 +36,13 @@
 #include "gcstelemetrystats.h"
 #include <uavtalk/uavtalk.h>
 #include <logfile.h>
+#include "loggingprofile.h"
 
 #include <QThread>
 #include <QQueue>
 #include <QReadWriteLock>
+#include <QHash>
+#include <QTime>
 
 class LoggingPlugin;
 class LoggingGadgetFactory;
@@ -74,7 +77,7 @@ private:
 
 protected slots:
     void onEnumerationChanged();
-    void startReplay(QString file);
+    void startReplay(QStringList files);
 
 protected:
     bool m_deviceOpened;
@@ -87,6 +90,8 @@ class LoggingThread : public QThread
 Q_OBJECT
 public:
     bool openFile(QString file, LoggingPlugin * parent);
+    LogFile* getLogfile() { return &logFile; }
+    void setProfile(const LoggingProfile& profile) { this->profile = profile; }
 
 private slots:
     void objectUpdated(UAVObject * obj);
@@ -104,6 +109,18 @@ protected:
 private:
     QQueue<UAVDataObject*> queue;
 
+    // Decimation state of the objects the profile does not log in full
+    typedef struct {
+        LoggingProfile::Rule rule;
+        int lastLogged;
+        quint32 count;
+    } ObjectFilter;
+    LoggingProfile profile;
+    QHash<UAVObject*, ObjectFilter> filters;
+    // Data objects logged, held as shown so the telemetry keeps their rates up
+    QList<UAVObject*> loggedObjects;
+    QTime clock;
+
     void retrieveSettings();
     void retrieveNextObject();
 
@@ -125,11 +142,16 @@ public:
     LogFile* getLogfile() { return logConnection->getLogfile();}
     void setLogMenuTitle(QString str);
 
+    QStringList getProfiles();
+    QString getProfile() { return profileName; }
+    void setProfile(const QString& name);
+
 
 signals:
     void stopLoggingSignal(void);
     void stopReplaySignal(void);
     void stateChanged(QString);
+    void droppedPacketsChanged(int);
 
 
 protected:
@@ -150,6 +172,7 @@ private slots:
 private:
     LoggingGadgetFactory *mf;
     Core::Command* cmd;
+    QString profileName;
 
 };
 #endif /* LoggingPLUGIN_H_ */
@@ -0,0 +1,122 @@
+/**
+ ******************************************************************************
+ * @file       loggingprofile.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @brief      Recording profiles of the logging plugin
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup loggingplugin
+ * @{
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "loggingprofile.h"
+#include <QSettings>
+#include <QDebug>
+
+static const QString PROFILES_GROUP = "LoggingProfiles";
+static const QString DEFAULT_KEY = "Default";
+
+LoggingProfile::LoggingProfile(const QString& name) :
+    name(name)
+{
+    defaultRule.type = LOG_ALL;
+    defaultRule.value = 0;
+}
+
+void LoggingProfile::save(QSettings* settings) const
+{
+    settings->beginGroup(PROFILES_GROUP);
+    settings->remove(name);
+    settings->beginGroup(name);
+    settings->setValue(DEFAULT_KEY, ruleToString(defaultRule));
+    for (QHash<QString, Rule>::const_iterator itr = rules.constBegin(); itr != rules.constEnd(); ++itr)
+        settings->setValue(itr.key(), ruleToString(itr.value()));
+    settings->endGroup();
+    settings->endGroup();
+}
+
+LoggingProfile LoggingProfile::load(QSettings* settings, const QString& name)
+{
+    LoggingProfile profile(name);
+    settings->beginGroup(PROFILES_GROUP);
+    settings->beginGroup(name);
+    foreach (QString key, settings->childKeys()) {
+        Rule rule;
+        if (!parseRule(settings->value(key).toString(), rule)) {
+            qDebug() << "Logging profile" << name << ": invalid rule for" << key;
+            continue;
+        }
+        if (key == DEFAULT_KEY)
+            profile.defaultRule = rule;
+        else
+            profile.rules.insert(key, rule);
+    }
+    settings->endGroup();
+    settings->endGroup();
+    return profile;
+}
+
+QStringList LoggingProfile::profileNames(QSettings* settings)
+{
+    settings->beginGroup(PROFILES_GROUP);
+    QStringList names = settings->childGroups();
+    settings->endGroup();
+    return names;
+}
+
+bool LoggingProfile::parseRule(const QString& str, Rule& rule)
+{
+    QString text = str.trimmed().toLower();
+    bool ok = true;
+    rule.value = 0;
+    if (text == "all") {
+        rule.type = LOG_ALL;
+    } else if (text == "none") {
+        rule.type = LOG_NONE;
+    } else if (text.endsWith("ms")) {
+        rule.type = LOG_RATE_LIMIT;
+        rule.value = text.left(text.length() - 2).toUInt(&ok);
+    } else if (text.startsWith("1/")) {
+        rule.type = LOG_EVERY_NTH;
+        rule.value = text.mid(2).toUInt(&ok);
+        ok = ok && rule.value > 0;
+    } else {
+        ok = false;
+    }
+    return ok;
+}
+
+QString LoggingProfile::ruleToString(const Rule& rule)
+{
+    switch (rule.type) {
+    case LOG_NONE:
+        return "none";
+    case LOG_RATE_LIMIT:
+        return QString("%1ms").arg(rule.value);
+    case LOG_EVERY_NTH:
+        return QString("1/%1").arg(rule.value);
+    default:
+        return "all";
+    }
+}
+
+/**
+ * @}
+ * @}
+ */
@@ -0,0 +1,80 @@
+/**
+ ******************************************************************************
+ * @file       loggingprofile.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup loggingplugin
+ * @{
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef LOGGINGPROFILE_H
+#define LOGGINGPROFILE_H
+
+#include "logging_global.h"
+#include <QString>
+#include <QStringList>
+#include <QHash>
+
+class QSettings;
+
+/**
+ * Recording profile, which objects are logged and how much each one is
+ * decimated. Profiles are stored in the GCS settings under
+ * LoggingProfiles/<name>, one key per object name plus "Default" for the
+ * objects not listed. A rule is "all", "none", "<n>ms" (at most one update
+ * every n ms) or "1/<n>" (every nth update).
+ * Settings and meta objects are always logged in full.
+ */
+class LOGGING_EXPORT LoggingProfile
+{
+public:
+    typedef enum { LOG_ALL, LOG_NONE, LOG_RATE_LIMIT, LOG_EVERY_NTH } RuleType;
+
+    typedef struct {
+        RuleType type;
+        quint32 value; /** Interval in ms or N */
+    } Rule;
+
+    LoggingProfile(const QString& name = QString());
+
+    QString getName() const { return name; }
+    Rule getRule(const QString& objectName) const { return rules.value(objectName, defaultRule); }
+    void setRule(const QString& objectName, const Rule& rule) { rules.insert(objectName, rule); }
+    void setDefaultRule(const Rule& rule) { defaultRule = rule; }
+
+    void save(QSettings* settings) const;
+    static LoggingProfile load(QSettings* settings, const QString& name);
+    static QStringList profileNames(QSettings* settings);
+
+    static bool parseRule(const QString& str, Rule& rule);
+    static QString ruleToString(const Rule& rule);
+
+private:
+    QString name;
+    Rule defaultRule;
+    QHash<QString, Rule> rules;
+};
+
+#endif // LOGGINGPROFILE_H
+
+/**
+ * @}
+ * @}
+ */
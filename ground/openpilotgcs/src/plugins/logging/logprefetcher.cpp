@@ -0,0 +1,123 @@
+/**
+ ******************************************************************************
+ * @file       logprefetcher.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @brief      Worker thread reading ahead in logs merged into a replay
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup loggingplugin
+ * @{
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "logprefetcher.h"
+#include <QDebug>
+
+LogPrefetcher::LogPrefetcher(const QString& fileName, qint32 timeOffset, UAVObjectManager* objMngr) :
+    fileName(fileName),
+    timeOffset(timeOffset),
+    queuedBytes(0),
+    finished(false),
+    stopping(false)
+{
+    logFile.setFileName(fileName);
+    logFile.setObjectManager(objMngr);
+    valid = logFile.open(QIODevice::ReadOnly);
+    if (!valid)
+        qDebug() << "LogPrefetcher: unable to open" << fileName;
+}
+
+LogPrefetcher::~LogPrefetcher()
+{
+    stop();
+    logFile.close();
+}
+
+/**
+ * (Re)start reading at the keyframe before timeStamp, on the merged timeline
+ */
+void LogPrefetcher::restart(quint32 timeStamp)
+{
+    stop();
+    if (!valid)
+        return;
+    queue.clear();
+    queuedBytes = 0;
+    finished = false;
+    stopping = false;
+    logFile.rewindRecords(qMax((qint64)timeStamp - timeOffset, (qint64)0));
+    start();
+}
+
+void LogPrefetcher::stop()
+{
+    mutex.lock();
+    stopping = true;
+    notFull.wakeAll();
+    mutex.unlock();
+    wait();
+}
+
+/**
+ * Move the prefetched packets up to timeStamp to packets. Waits only if
+ * the worker has fallen behind, so the merge order is always kept.
+ */
+void LogPrefetcher::takeUntil(quint32 timeStamp, QList<QByteArray>& packets)
+{
+    QMutexLocker locker(&mutex);
+    forever {
+        while (!queue.isEmpty() && queue.head().timeStamp <= timeStamp) {
+            Record record = queue.dequeue();
+            queuedBytes -= record.packet.size();
+            packets.append(record.packet);
+        }
+        if (!queue.isEmpty() || finished || !isRunning())
+            break;
+        notEmpty.wait(&mutex);
+    }
+    notFull.wakeAll();
+}
+
+void LogPrefetcher::run()
+{
+    quint32 timeStamp;
+    QByteArray packet;
+    while (logFile.nextRecord(timeStamp, packet)) {
+        Record record;
+        record.timeStamp = qMax((qint64)timeStamp + timeOffset, (qint64)0);
+        // Copy out of the mapping, the packet outlives the read position
+        record.packet = QByteArray(packet.constData(), packet.size());
+
+        QMutexLocker locker(&mutex);
+        while (queuedBytes >= QUEUE_LIMIT && !stopping)
+            notFull.wait(&mutex);
+        if (stopping)
+            return;
+        queuedBytes += record.packet.size();
+        queue.enqueue(record);
+        notEmpty.wakeAll();
+    }
+    QMutexLocker locker(&mutex);
+    finished = true;
+    notEmpty.wakeAll();
+}
+
+/**
+ * @}
+ * @}
+ */
@@ -0,0 +1,84 @@
+/**
+ ******************************************************************************
+ * @file       logprefetcher.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup loggingplugin
+ * @{
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef LOGPREFETCHER_H
+#define LOGPREFETCHER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include "logfile.h"
+
+/**
+ * Reads the records of a log merged into a replay on a worker thread,
+ * keeping a bounded queue ahead of the replay position. Timestamps are
+ * shifted by timeOffset onto the timeline of the main log.
+ */
+class LogPrefetcher : public QThread
+{
+public:
+    static const int QUEUE_LIMIT = 4 * 1024 * 1024; // bytes prefetched at most
+
+    LogPrefetcher(const QString& fileName, qint32 timeOffset, UAVObjectManager* objMngr);
+    ~LogPrefetcher();
+
+    bool isValid() const { return valid; }
+    QString getFileName() const { return fileName; }
+    quint32 getDuration() const { return qMax((qint64)logFile.getDuration() + timeOffset, (qint64)0); }
+    void restart(quint32 timeStamp);
+    void stop();
+    void takeUntil(quint32 timeStamp, QList<QByteArray>& packets);
+
+protected:
+    void run();
+
+private:
+    typedef struct {
+        quint32 timeStamp;
+        QByteArray packet;
+    } Record;
+
+    QString fileName;
+    qint32 timeOffset;
+    LogFile logFile;
+    bool valid;
+
+    QMutex mutex;
+    QWaitCondition notEmpty;
+    QWaitCondition notFull;
+    QQueue<Record> queue;
+    qint64 queuedBytes;
+    bool finished;
+    bool stopping;
+};
+
+#endif // LOGPREFETCHER_H
+
+/**
+ * @}
+ * @}
+ */
@@ -0,0 +1,209 @@
+/**
+ ******************************************************************************
+ * @file       logquery.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @brief      Field history queries on indexed logs
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup loggingplugin
+ * @{
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "logquery.h"
+#include "logfile.h"
+#include "uavobjectfield.h"
+#include <QtEndian>
+#include <QDebug>
+
+static const quint8 UAVTALK_SYNC_VAL = 0x3C;
+static const quint8 UAVTALK_TYPE_OBJ = 0x20;
+static const quint8 UAVTALK_TYPE_OBJ_ACK = 0x22;
+
+static quint32 fieldElementBytes(quint8 type)
+{
+    switch (type) {
+    case UAVObjectField::INT16:
+    case UAVObjectField::UINT16:
+        return 2;
+    case UAVObjectField::INT32:
+    case UAVObjectField::UINT32:
+    case UAVObjectField::FLOAT32:
+        return 4;
+    default:
+        return 1;
+    }
+}
+
+static quint32 fieldBytes(const LogFile::FieldDefinition& field)
+{
+    if (field.type == UAVObjectField::BITFIELD)
+        return (field.numElements + 7) / 8;
+    return fieldElementBytes(field.type) * field.numElements;
+}
+
+static double fieldValue(quint8 type, const uchar* data, quint32 index)
+{
+    const uchar* p = data + index * fieldElementBytes(type);
+    switch (type) {
+    case UAVObjectField::INT8:
+        return (qint8)*p;
+    case UAVObjectField::INT16:
+        return qFromLittleEndian<qint16>(p);
+    case UAVObjectField::INT32:
+        return qFromLittleEndian<qint32>(p);
+    case UAVObjectField::UINT16:
+        return qFromLittleEndian<quint16>(p);
+    case UAVObjectField::UINT32:
+        return qFromLittleEndian<quint32>(p);
+    case UAVObjectField::FLOAT32: {
+        quint32 bits = qFromLittleEndian<quint32>(p);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    case UAVObjectField::BITFIELD:
+        return (data[index / 8] >> (index % 8)) & 1;
+    default:
+        return *p;
+    }
+}
+
+LogQuery::LogQuery() :
+    logFile(NULL)
+{
+}
+
+LogQuery::~LogQuery()
+{
+    close();
+}
+
+bool LogQuery::open(const QString& fileName)
+{
+    close();
+    logFile = new LogFile();
+    logFile->setFileName(fileName);
+    if (!logFile->open(QIODevice::ReadOnly)) {
+        close();
+        return false;
+    }
+    if (!logFile->hasIndex() || logFile->getObjectDefinitions().isEmpty()) {
+        qDebug() << "LogQuery:" << fileName << "has no index, queries need a version 2 log";
+        close();
+        return false;
+    }
+    return true;
+}
+
+void LogQuery::close()
+{
+    if (logFile) {
+        logFile->close();
+        delete logFile;
+        logFile = NULL;
+    }
+}
+
+bool LogQuery::isOpen() const
+{
+    return logFile != NULL;
+}
+
+quint32 LogQuery::getDuration() const
+{
+    return logFile ? logFile->getDuration() : 0;
+}
+
+/**
+ * Fill series with the values of objectName.fieldName logged between
+ * startTime and endTime (ms, inclusive)
+ */
+bool LogQuery::query(const QString& objectName, const QString& fieldName, quint32 startTime, quint32 endTime,
+                     LogSeries& series, quint16 instId)
+{
+    series.timeStamps.clear();
+    series.values.clear();
+    series.numElements = 0;
+    series.elementNames.clear();
+    if (!logFile)
+        return false;
+
+    // Locate the field in the logged layout of the object
+    const QList<LogFile::ObjectDefinition>& definitions = logFile->getObjectDefinitions();
+    const LogFile::ObjectDefinition* object = NULL;
+    for (int n = 0; n < definitions.size() && object == NULL; ++n) {
+        if (definitions[n].name == objectName)
+            object = &definitions[n];
+    }
+    if (object == NULL)
+        return false;
+    const LogFile::FieldDefinition* field = NULL;
+    quint32 fieldOffset = 0;
+    for (int n = 0; n < object->fields.size(); ++n) {
+        if (object->fields[n].name == fieldName) {
+            field = &object->fields[n];
+            break;
+        }
+        fieldOffset += fieldBytes(object->fields[n]);
+    }
+    if (field == NULL)
+        return false;
+    series.numElements = field->numElements;
+    series.elementNames = field->elementNames;
+
+    // Offsets are in log order, skip to the first record of the range
+    QVector<qint64> offsets = logFile->getObjectOffsets(object->objId);
+    int first = 0;
+    int last = offsets.size();
+    while (first < last) {
+        int middle = (first + last) / 2;
+        quint32 timeStamp;
+        QByteArray packet;
+        if (logFile->readRecordAt(offsets[middle], timeStamp, packet) && timeStamp < startTime)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    const int headerLength = object->singleInstance ? 8 : 10;
+    const int dataEnd = headerLength + fieldOffset + fieldBytes(*field);
+    for (int n = first; n < offsets.size(); ++n) {
+        quint32 timeStamp;
+        QByteArray packet;
+        if (!logFile->readRecordAt(offsets[n], timeStamp, packet))
+            continue;
+        if (timeStamp > endTime)
+            break;
+        const uchar* data = (const uchar*)packet.constData();
+        if (packet.size() < dataEnd + 1 || data[0] != UAVTALK_SYNC_VAL ||
+                (data[1] != UAVTALK_TYPE_OBJ && data[1] != UAVTALK_TYPE_OBJ_ACK))
+            continue;
+        if (!object->singleInstance && qFromLittleEndian<quint16>(&data[8]) != instId)
+            continue;
+        series.timeStamps.append(timeStamp);
+        for (quint32 e = 0; e < field->numElements; ++e)
+            series.values.append(fieldValue(field->type, data + headerLength + fieldOffset, e));
+    }
+    return true;
+}
+
+/**
+ * @}
+ * @}
+ */
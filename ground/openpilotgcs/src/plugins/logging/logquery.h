@@ -0,0 +1,78 @@
+/**
+ ******************************************************************************
+ * @file       logquery.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup loggingplugin
+ * @{
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef LOGQUERY_H
+#define LOGQUERY_H
+
+#include "logging_global.h"
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class LogFile;
+
+/**
+ * Time series of one field, numElements values per row
+ */
+struct LogSeries {
+    LogSeries() : numElements(0) {}
+    QVector<quint32> timeStamps;
+    QVector<double> values;
+    quint32 numElements;
+    QStringList elementNames;
+};
+
+/**
+ * Reads the history of object fields from an indexed (version 2 or later)
+ * log. Only the records of the queried object are read, found through the
+ * per object offset index, and the field is decoded with the definitions
+ * stored in the log header, so it also works for object IDs that changed
+ * since the log was written.
+ */
+class LOGGING_EXPORT LogQuery
+{
+public:
+    LogQuery();
+    ~LogQuery();
+
+    bool open(const QString& fileName);
+    void close();
+    bool isOpen() const;
+    quint32 getDuration() const;
+
+    bool query(const QString& objectName, const QString& fieldName, quint32 startTime, quint32 endTime,
+               LogSeries& series, quint16 instId = 0);
+
+private:
+    LogFile* logFile;
+};
+
+#endif // LOGQUERY_H
+
+/**
+ * @}
+ * @}
+ */
@@ -32,17 +32,39 @@
 #include "glc_exception.h"
 #include "glc_openglexception.h"
 #include "viewport/glc_userinput.h"
+#include "io/glc_fileloader.h"
+#include "geometry/glc_bsrep.h"
+#include "sceneGraph/glc_octree.h"
+#include "glc_renderstatistics.h"
+#include "utils/pathutils.h"
+
+#include <QtConcurrentRun>
+#include <QCryptographicHash>
 
 #include <iostream>
 
+// Frame period while the model is moving, one frame per refresh of a 60Hz display
+#define FRAME_PERIOD_MS 16
+#define MIN_SAMPLE_INTERVAL_MS 10.0
+#define MAX_SAMPLE_INTERVAL_MS 500.0
+
+// Swaps wait for the vertical retrace, so frames are not drawn faster than shown
+static QGLFormat vsyncFormat()
+{
+    QGLFormat format(QGL::SampleBuffers);
+    format.setSwapInterval(1);
+    return format;
+}
+
 ModelViewGadgetWidget::ModelViewGadgetWidget(QWidget *parent) 
-: QGLWidget(new GLC_Context(QGLFormat(QGL::SampleBuffers)),parent)
+: QGLWidget(new GLC_Context(vsyncFormat()),parent)
 , m_Light()
 , m_World()
 , m_GlView(this)
 , m_MoverController()
 , m_ModelBoundingBox()
-, m_MotionTimer()
+, m_FrameTimer()
+, m_SampleIntervalMs(100.0)
 , acFilename()
 , bgFilename()
 , vboEnable(false)
@@ -59,8 +81,14 @@ ModelViewGadgetWidget::ModelViewGadgetWidget(QWidget *parent)
     ExtensionSystem::PluginManager* pm = ExtensionSystem::PluginManager::instance();
     UAVObjectManager* objManager = pm->getObject<UAVObjectManager>();
     attActual = AttitudeActual::GetInstance(objManager);
-
-    connect(&m_MotionTimer, SIGNAL(timeout()), this, SLOT(updateAttitude()));
+    m_Interest = new UAVObjectInterest(this);
+    m_Interest->addObject(attActual);
+
+    // Draw on attitude changes only, interpolating between samples
+    m_FrameTimer.setInterval(FRAME_PERIOD_MS);
+    connect(&m_FrameTimer, SIGNAL(timeout()), this, SLOT(renderFrame()));
+    connect(attActual, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(attitudeUpdated()));
+    connect(&m_ModelWatcher, SIGNAL(finished()), this, SLOT(modelLoaded()));
 }
 
 ModelViewGadgetWidget::~ModelViewGadgetWidget()
@@ -102,6 +130,8 @@ void ModelViewGadgetWidget::setVboEnable(bool eVbo)
 void ModelViewGadgetWidget::reloadScene()
 {
     CreateScene();
+    setModelAttitude(m_ShownAttitude);
+    updateGL();
 }
 
 //// Private functions ////
@@ -121,7 +151,10 @@ void ModelViewGadgetWidget::initializeGL()
     // Enable antialiasing
     glEnable(GL_MULTISAMPLE);
 
-    m_MotionTimer.start(100);
+    // Bodies smaller than a few pixels are not drawn
+    GLC_State::setPixelCullingUsage(true);
+    GLC_RenderStatistics::setActivationFlag(true);
+
     setFocusPolicy(Qt::StrongFocus); // keyboard capture for camera switching
 }
 
@@ -155,6 +188,10 @@ void ModelViewGadgetWidget::paintGL()
     	m_Light.glExecute();
         m_GlView.glExecuteCam();
 
+        // Only the instances in the view frustum are drawn
+        m_World.collection()->updateInstanceViewableState();
+        GLC_RenderStatistics::reset();
+
         // Display the collection of GLC_Object
         m_World.render(0, glc::ShadingFlag);
         m_World.render(0, glc::TransparentRenderFlag);
@@ -202,21 +239,119 @@ void ModelViewGadgetWidget::CreateScene()
         qDebug("ModelView: background image file loading failed.");
     }
 
+    if(QFile::exists(acFilename))
+    {
+        // A box stands in for the aircraft until it is loaded
+        GLC_World placeholder;
+        placeholder.rootOccurence()->addChild(new GLC_StructOccurence(new GLC_3DRep(GLC_Factory::instance()->createBox(1.0, 1.0, 1.0))));
+        showWorld(placeholder);
+        QString cacheDir = Utils::PathUtils().GetStoragePath() + "modelcache" + QDir::separator();
+        // A load still running for a previous file is no longer reported
+        m_ModelWatcher.setFuture(QtConcurrent::run(&ModelViewGadgetWidget::loadWorld, acFilename, cacheDir));
+    } else {
+        qDebug("ModelView: aircraft file not found.");
+    }
+}
+
+void ModelViewGadgetWidget::showWorld(const GLC_World &world)
+{
+    m_World= world;
+    GLC_3DViewCollection* collection = m_World.collection();
+    collection->setVboUsage(vboEnable);
+    // Cull against an octree of the instances, pick the LOD of each body from its size on screen
+    collection->bindSpacePartitioning(new GLC_Octree(collection));
+    collection->setSpacePartitionningUsage(true);
+    collection->setAttachedViewport(&m_GlView);
+    collection->setLodUsage(true, &m_GlView);
+    m_ModelBoundingBox= m_World.boundingBox();
+    m_GlView.reframe(m_ModelBoundingBox); // center 3D model in the scene
+    setModelAttitude(m_ShownAttitude);
+}
+
+void ModelViewGadgetWidget::modelLoaded()
+{
+    GLC_World world = m_ModelWatcher.result();
+    if (world.isEmpty())
+    {
+        qDebug("ModelView: aircraft file loading failed.");
+        return;
+    }
+    showWorld(world);
+    updateGL();
+}
+
+/**
+ * Loads the aircraft file. The geometry is cached as one binary representation
+ * (BSRep) named after the hash of the file, so a later start loads the cache
+ * instead of parsing the model again; an edited file gets a new hash.
+ */
+GLC_World ModelViewGadgetWidget::loadWorld(const QString &filename, const QString &cacheDir)
+{
     try
     {
-        if(QFile::exists(acFilename))
+        QFile aircraft(filename);
+        QString cacheFile;
+        if (aircraft.open(QIODevice::ReadOnly))
+        {
+            QByteArray hash = QCryptographicHash::hash(aircraft.readAll(), QCryptographicHash::Sha1).toHex();
+            aircraft.close();
+            cacheFile = cacheDir + hash + '.' + GLC_BSRep::suffix();
+        }
+        if (!cacheFile.isEmpty() && QFile::exists(cacheFile))
+        {
+            GLC_BSRep bsRep(cacheFile);
+            if (bsRep.isUsable(QDateTime()))
+            {
+                GLC_World world;
+                world.rootOccurence()->addChild(new GLC_StructOccurence(new GLC_3DRep(bsRep.loadRep())));
+                return world;
+            }
+        }
+        GLC_FileLoader loader;
+        GLC_World world = loader.createWorldFromFile(aircraft);
+        if (!cacheFile.isEmpty())
         {
-            QFile aircraft(acFilename);
-            m_World= GLC_Factory::instance()->createWorldFromFile(aircraft);
-            m_ModelBoundingBox= m_World.boundingBox();
-            m_GlView.reframe(m_ModelBoundingBox); // center 3D model in the scene
-        } else {
-        	qDebug("ModelView: aircraft file not found.");
+            cacheWorld(world, cacheFile);
         }
+        return world;
     }
-    catch(GLC_Exception e)
+    catch(GLC_Exception &e)
     {
-        qDebug("ModelView: aircraft file loading failed.");
+        qDebug() << "ModelView:" << e.what();
+    }
+    return GLC_World();
+}
+
+/**
+ * A BSRep holds a single representation, so the world is flattened: every body is
+ * copied with its occurrence's placement applied. Only the whole model is moved
+ * by the view, the structure is not needed.
+ */
+void ModelViewGadgetWidget::cacheWorld(const GLC_World &world, const QString &cacheFile)
+{
+    GLC_3DRep merged;
+    foreach (GLC_StructOccurence* occurence, world.listOfOccurence())
+    {
+        if (!occurence->hasRepresentation())
+            continue;
+        GLC_3DRep* rep = dynamic_cast<GLC_3DRep*>(occurence->structReference()->representationHandle());
+        if (rep == NULL)
+            continue;
+        GLC_3DRep* placed = dynamic_cast<GLC_3DRep*>(rep->deepCopy());
+        placed->transformSubGeometries(occurence->absoluteMatrix());
+        for (int i = 0; i < placed->numberOfBody(); ++i)
+        {
+            merged.addGeom(placed->geomAt(i)->clone());
+        }
+        delete placed;
+    }
+    if (merged.isEmpty())
+        return;
+    QDir().mkpath(QFileInfo(cacheFile).absolutePath());
+    GLC_BSRep bsRep(cacheFile);
+    if (!bsRep.save(merged))
+    {
+        qDebug() << "ModelView: could not cache" << cacheFile;
     }
 }
 
@@ -235,7 +370,7 @@ void ModelViewGadgetWidget::mousePressEvent(QMouseEvent *e)
         switch (e->button())
         {
         case (Qt::LeftButton):
-                m_MotionTimer.stop();
+                m_FrameTimer.stop();
                 m_MoverController.setActiveMover(GLC_MoverController::TurnTable, userInput);
                 updateGL();
                 break;
@@ -244,6 +379,9 @@ void ModelViewGadgetWidget::mousePressEvent(QMouseEvent *e)
 			vboEnable ? "yes" : "no",
 			GLC_State::vboSupported() ? "yes" : "no",
 			GLC_State::vboUsed() ? "yes" : "no");
+		printf("Last frame: %u bodies, %lu triangles\n",
+			GLC_RenderStatistics::bodyCount(),
+			GLC_RenderStatistics::triangleCount());
 		printf("Renderer - %s \n", (char*)glGetString(GL_RENDERER));
 		printf("Extensions - %s\n", (char*)glGetString(GL_EXTENSIONS));
                 break;
@@ -265,8 +403,7 @@ void ModelViewGadgetWidget::mouseReleaseEvent(QMouseEvent*)
 {
         if (not m_MoverController.hasActiveMover()) return;
         m_MoverController.setNoMover();
-        m_MotionTimer.start();
-        updateGL();
+        renderFrame();
 }
 
 void ModelViewGadgetWidget::keyPressEvent(QKeyEvent * e) // switch between camera
@@ -331,16 +468,64 @@ void ModelViewGadgetWidget::keyPressEvent(QKeyEvent * e) // switch between camer
 //////////////////////////////////////////////////////////////////////
 // Private slots Functions
 //////////////////////////////////////////////////////////////////////
-void ModelViewGadgetWidget::updateAttitude()
+/**
+ * A new attitude sample: the model moves from the attitude drawn now to the
+ * sample over one sample interval, so motion stays smooth between samples
+ */
+void ModelViewGadgetWidget::attitudeUpdated()
 {
     AttitudeActual::DataFields data = attActual->getData(); // get attitude data
-    GLC_StructOccurence* rootObject= m_World.rootOccurence(); // get the full 3D model
-    double x= data.q3;
-    double y= data.q2;
-    double z= data.q4;
     double w= data.q1;
     if (w == 0.0)
         w = 1.0;
+    QQuaternion sample(w, data.q3, data.q2, data.q4);
+    if (sample == m_ToAttitude)
+        return;
+    if (m_SampleClock.isValid())
+    {
+        double elapsed = qBound(MIN_SAMPLE_INTERVAL_MS, (double)m_SampleClock.elapsed(), MAX_SAMPLE_INTERVAL_MS);
+        m_SampleIntervalMs = 0.8 * m_SampleIntervalMs + 0.2 * elapsed;
+    }
+    m_SampleClock.start();
+    m_FromAttitude = m_ShownAttitude;
+    m_ToAttitude = sample;
+    if (!m_FrameTimer.isActive() && !m_MoverController.hasActiveMover())
+    {
+        m_FrameTimer.start();
+    }
+}
+
+/**
+ * Draws one frame of the interpolation, the timer stops once the model reached the
+ * last sample so nothing is redrawn until the attitude changes again
+ */
+void ModelViewGadgetWidget::renderFrame()
+{
+    if (m_MoverController.hasActiveMover())
+    {
+        m_FrameTimer.stop();
+        return;
+    }
+    double t = m_SampleClock.isValid() ? m_SampleClock.elapsed() / m_SampleIntervalMs : 1.0;
+    if (t >= 1.0)
+    {
+        t = 1.0;
+        m_FrameTimer.stop();
+    }
+    setModelAttitude(QQuaternion::slerp(m_FromAttitude, m_ToAttitude, t));
+    // A hidden view picks the attitude up when it is painted again
+    if (isVisible())
+        updateGL();
+}
+
+void ModelViewGadgetWidget::setModelAttitude(const QQuaternion &q)
+{
+    m_ShownAttitude = q;
+    GLC_StructOccurence* rootObject= m_World.rootOccurence(); // get the full 3D model
+    double x= q.x();
+    double y= q.y();
+    double z= q.z();
+    double w= q.scalar();
     // create and gives the product of 2 4x4 matrices to get the rotation of the 3D model's matrix
     QMatrix4x4 m1;
     m1.setRow(0, QVector4D(w,z,-y,x));
@@ -365,5 +550,6 @@ void ModelViewGadgetWidget::updateAttitude()
     // sets and updates the 3D model's matrix
     rootObject->structInstance()->setMatrix(rootObjectRotation);
     rootObject->updateChildrenAbsoluteMatrix();
-    updateGL();
+    // The instances moved, their octree cells are recomputed before the next frame
+    m_World.collection()->invalidateSpacePartitioning();
 }
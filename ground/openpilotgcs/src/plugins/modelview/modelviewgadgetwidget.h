@@ -30,6 +30,9 @@
 
 #include <QtOpenGL/QGLWidget>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QQuaternion>
+#include <QFutureWatcher>
 
 #include "glc_factory.h"
 #include "viewport/glc_viewport.h"
@@ -40,6 +43,7 @@
 
 #include "uavobjectmanager.h"
 #include "attitudeactual.h"
+#include "uavobjectinterest.h"
 
 
 
@@ -63,6 +67,9 @@ private:
    void resizeGL(int width, int height);
    // Create GLC_Object to display
    void CreateScene();
+   // Loads the aircraft, from the binary cache when possible (runs on a worker thread)
+   static GLC_World loadWorld(const QString &filename, const QString &cacheDir);
+   static void cacheWorld(const GLC_World &world, const QString &cacheFile);
 
    //Mouse events
    void mousePressEvent(QMouseEvent * e);
@@ -75,7 +82,9 @@ private:
 // Private slots Functions
 //////////////////////////////////////////////////////////////////////
 private slots:
-    void updateAttitude();
+    void attitudeUpdated();
+    void renderFrame();
+    void modelLoaded();
 
 private:
     GLC_Factory* m_pFactory;
@@ -84,14 +93,30 @@ private:
     GLC_Viewport m_GlView;
     GLC_MoverController m_MoverController;
     GLC_BoundingBox m_ModelBoundingBox;
-    //! The timer used for motion
-    QTimer m_MotionTimer;
+    //! Paces frames while the model moves towards the last attitude sample
+    QTimer m_FrameTimer;
+    //! Time since the last attitude sample
+    QElapsedTimer m_SampleClock;
+    //! Average time between attitude samples, in ms
+    double m_SampleIntervalMs;
+    //! Attitude drawn when the last sample came in, and that sample
+    QQuaternion m_FromAttitude;
+    QQuaternion m_ToAttitude;
+    QQuaternion m_ShownAttitude;
+
+    void setModelAttitude(const QQuaternion &q);
+    void showWorld(const GLC_World &world);
+
+    //! Aircraft being loaded in the background, a placeholder is shown meanwhile
+    QFutureWatcher<GLC_World> m_ModelWatcher;
 
     QString acFilename;
     QString bgFilename;
     bool vboEnable;
 
     AttitudeActual* attActual;
+    // The attitude above, shown while the model is visible
+    UAVObjectInterest* m_Interest;
 };
 
 #endif /* MODELVIEWGADGETWIDGET_H_ */
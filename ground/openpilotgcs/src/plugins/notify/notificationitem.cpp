@@ -38,6 +38,7 @@
 // Notify plugin headers
 #include "notificationitem.h"
 #include "notifylogging.h"
+#include "notifypluginoptionspage.h"
 
 
 
@@ -50,6 +51,10 @@ QStringList NotificationItem::retryValues;
 NotificationItem::NotificationItem(QObject *parent)
     : QObject(parent)
     , _currentUpdatePlayed(false)
+    , _boundField(NULL)
+    , _enumRule(false)
+    , _enumValue(-1)
+    , _value1(0)
     , isNowPlaying(0)
     , _isPlayed(false)
     , _timer(NULL)
@@ -426,6 +431,56 @@ QString NotificationItem::getSoundCaption(QString fileName)
     return fileName;
 }
 
+UAVObjectField* NotificationItem::compile()
+{
+    _boundField = NULL;
+    UAVDataObject* obj = getUAVObject();
+    if (!obj)
+        return NULL;
+    UAVObjectField* field = obj->getField(getObjectField());
+    if (!field || field->getName().isEmpty())
+        return NULL;
+
+    _enumRule = (UAVObjectField::ENUM == field->getType());
+    _enumValue = -1;
+    if (_enumRule) {
+        QStringList options = field->getOptions();
+        for (int i = 0; i < options.size(); ++i) {
+            if (!QString::compare(options.at(i), singleValue().toString(), Qt::CaseInsensitive)) {
+                _enumValue = i;
+                break;
+            }
+        }
+    }
+    _value1 = singleValue().toDouble();
+    _boundField = field;
+    return field;
+}
+
+bool NotificationItem::check() const
+{
+    Q_ASSERT(_boundField);
+    if (_enumRule) {
+        // Only equality is defined for enums, any other condition always holds
+        if (_condition != NotifyPluginOptionsPage::equal)
+            return true;
+        // Enums are stored as one byte option index
+        return *_boundField->getRawPointer() == _enumValue;
+    }
+
+    double value = _boundField->getDouble();
+    switch (_condition) {
+    case NotifyPluginOptionsPage::equal:
+        return value == _value1;
+    case NotifyPluginOptionsPage::bigger:
+        return value > _value1;
+    case NotifyPluginOptionsPage::smaller:
+        return value < _value1;
+    default:
+        return (value > _value1) && (value < _valueRange2);
+    }
+}
+
 UAVObjectField* NotificationItem::getUAVObjectField() {
     return getUAVObject()->getField(getObjectField());
 }
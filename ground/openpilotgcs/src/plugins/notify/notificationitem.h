@@ -107,6 +107,21 @@ public:
     UAVDataObject* getUAVObject(void);
     UAVObjectField* getUAVObjectField(void);
 
+    /**
+    * Bind the rule to its object field and convert the rule value to the
+    * field type once, so an update is checked without name lookups or
+    * QVariant conversions
+    *
+    * @return the bound field, NULL if the object or the field is unknown
+    */
+    UAVObjectField* compile();
+
+    /**
+    * Check the rule against the current value of the bound field,
+    * compile() must have succeeded
+    */
+    bool check() const;
+
     void serialize(QDataStream& stream);
     void deserialize(QDataStream& stream);
 
@@ -161,6 +176,12 @@ private:
 
     bool _currentUpdatePlayed;
 
+    //! compiled rule, see compile()
+    UAVObjectField* _boundField;
+    bool _enumRule;
+    int _enumValue;
+    double _value1;
+
     QTimer* _timer;
 
     //! time from putting notification in queue till moment when notification became out-of-date
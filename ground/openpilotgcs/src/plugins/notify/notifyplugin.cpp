@@ -187,6 +187,8 @@ void SoundNotifyPlugin::connectNotifications()
     UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
 
     lstNotifiedUAVObjects.clear();
+    _objectNotifications.clear();
+    _notificationSounds.clear();
     _pendingNotifications.clear();
     _notificationList.append(_toRemoveNotifications);
     _toRemoveNotifications.clear();
@@ -199,10 +201,21 @@ void SoundNotifyPlugin::connectNotifications()
         if(notify->mute()) continue;
         // check is all sounds presented for notification,
         // if not - we must not subscribe to it at all
-        if(notify->toSoundList().isEmpty()) continue;
+        QStringList sounds = notify->toSoundList();
+        if(sounds.isEmpty()) continue;
 
         UAVDataObject* obj = dynamic_cast<UAVDataObject*>( objManager->getObject(notify->getDataObject()) );
         if (obj != NULL ) {
+            if (!notify->compile()) {
+                qNotifyDebug() << "Error: Field is unknown (" << notify->getObjectField() << ").";
+                continue;
+            }
+            _objectNotifications.insert(obj, notify);
+            QList<Phonon::MediaSource> sources;
+            foreach(QString sound, sounds)
+                sources.append(Phonon::MediaSource(sound));
+            _notificationSounds.insert(notify, sources);
+
             if (!lstNotifiedUAVObjects.contains(obj)) {
                 lstNotifiedUAVObjects.append(obj);
 
@@ -231,10 +244,7 @@ void SoundNotifyPlugin::connectNotifications()
 
 void SoundNotifyPlugin::on_arrived_Notification(UAVObject *object)
 {
-    foreach(NotificationItem* ntf, _notificationList) {
-        if (object->getName() != ntf->getDataObject())
-            continue;
-
+    foreach(NotificationItem* ntf, _objectNotifications.values(object)) {
 
         // skip duplicate notifications
         if (_nowPlayingNotification == ntf)
@@ -349,89 +359,15 @@ void SoundNotifyPlugin::stateChanged(Phonon::State newstate, Phonon::State oldst
     }
 }
 
-bool checkRange(QString fieldValue, QString enumValue, QStringList /* values */, int direction)
-{
-
-    bool ret = false;
-    switch(direction)
-    {
-    case NotifyPluginOptionsPage::equal:
-        ret = !QString::compare(enumValue, fieldValue, Qt::CaseInsensitive) ? true : false;
-        break;
-
-    default:
-        ret = true;
-        break;
-    };
-    return ret;
-}
-
-bool checkRange(double fieldValue, double min, double max, int direction)
-{
-    bool ret = false;
-    //Q_ASSERT(min < max);
-    switch(direction)
-    {
-    case NotifyPluginOptionsPage::equal:
-        ret = (fieldValue == min);
-        break;
-
-    case NotifyPluginOptionsPage::bigger:
-        ret = (fieldValue > min);
-        break;
-
-    case NotifyPluginOptionsPage::smaller:
-        ret = (fieldValue < min);
-        break;
-
-    default:
-        ret = (fieldValue > min) && (fieldValue < max);
-        break;
-    };
-
-    return ret;
-}
-
 void SoundNotifyPlugin::checkNotificationRule(NotificationItem* notification, UAVObject* object)
 {
-    if(notification->getDataObject()!=object->getName() || object->getField(notification->getObjectField())==NULL)
-        return;
-    bool condition=false;
+    // Only the notifications of the object get here, see on_arrived_Notification()
+    Q_UNUSED(object);
 
-    if (notification->mute())
+    if (notification->mute() || !_notificationSounds.contains(notification))
         return;
 
-    int direction = notification->getCondition();
-    QString fieldName = notification->getObjectField();
-    UAVObjectField* field = object->getField(fieldName);
-
-    if (field->getName().isEmpty())
-        return;
-
-    QVariant value = field->getValue();
-    if(UAVObjectField::ENUM == field->getType()) {
-        qNotifyDebug()<<"Check range ENUM"<<value.toString()<<"|"<<notification->singleValue().toString()<<"|"<<field->getOptions()<<"|"<<
-                  direction<<checkRange(value.toString(),
-                                        notification->singleValue().toString(),
-                                        field->getOptions(),
-                                        direction);;
-        condition = checkRange(value.toString(),
-                               notification->singleValue().toString(),
-                               field->getOptions(),
-                               direction);
-    } else {
-        qNotifyDebug()<<"Check range VAL"<<value.toString()<<"|"<<notification->singleValue().toString()<<"|"<<field->getOptions()<<"|"<<
-                  direction<<checkRange(value.toDouble(),
-                                        notification->singleValue().toDouble(),
-                                        notification->valueRange2(),
-                                        direction);
-        condition = checkRange(value.toDouble(),
-                               notification->singleValue().toDouble(),
-                               notification->valueRange2(),
-                               direction);
-    }
-
-    notification->_isPlayed = condition;
+    notification->_isPlayed = notification->check();
     // if condition has been changed, and already in false state
     // we should reset _isPlayed flag and stop repeat timer
     if (!notification->_isPlayed) {
@@ -479,6 +415,7 @@ bool SoundNotifyPlugin::playNotification(NotificationItem* notification)
 
         if (notification->retryValue() == NotificationItem::repeatOnce) {
             _toRemoveNotifications.append(_notificationList.takeAt(_notificationList.indexOf(notification)));
+            _objectNotifications.remove(notification->getUAVObject(), notification);
         }
         else if(notification->retryValue() == NotificationItem::repeatOncePerUpdate)
             notification->setCurrentUpdatePlayed(true);
@@ -509,11 +446,7 @@ bool SoundNotifyPlugin::playNotification(NotificationItem* notification)
         }
         phonon.mo->clear();
         qNotifyDebug() << "play: " << notification->toString();
-        foreach (QString item, notification->toSoundList()) {
-            Phonon::MediaSource *ms = new Phonon::MediaSource(item);
-            ms->setAutoDelete(true);
-            phonon.mo->enqueue(*ms);
-        }
+        phonon.mo->enqueue(_notificationSounds.value(notification));
         qNotifyDebug()<<"begin play";
         phonon.mo->play();
         qNotifyDebug()<<"end play";
@@ -35,6 +35,7 @@
 #include "notificationitem.h"
 
 #include <QSettings>
+#include <QMultiHash>
 #include <phonon/MediaObject>
 #include <phonon/Path>
 #include <phonon/AudioOutput>
@@ -91,6 +92,10 @@ private:
     bool enableSound;
 
     QList<UAVDataObject*> lstNotifiedUAVObjects;
+    //! compiled notifications of each watched object
+    QMultiHash<UAVObject*, NotificationItem*> _objectNotifications;
+    //! sound sequence of each notification, resolved once when connected
+    QHash<NotificationItem*, QList<Phonon::MediaSource> > _notificationSounds;
     QList<NotificationItem*> _notificationList;
     QList<NotificationItem*> _pendingNotifications;
     QList<NotificationItem*> _toRemoveNotifications;
@@ -343,8 +343,11 @@ bool flightDataModel::setData(const QModelIndex &index, const QVariant &value, i
         if(rowIndex>dataStorage.length()-1)
             return false;
         pathPlanData * myRow=dataStorage.at(rowIndex);
+        QVariant previous=getColumnByIndex(myRow,columnIndex);
         setColumnByIndex(myRow,columnIndex,value);
-        emit dataChanged(index,index);
+        // Views and proxies only hear about cells which really changed
+        if(getColumnByIndex(myRow,columnIndex)!=previous)
+            emit dataChanged(index,index);
     }
     return true;
 }
@@ -27,7 +27,8 @@
 
 #include "modelmapproxy.h"
 
-modelMapProxy::modelMapProxy(QObject *parent,OPMapWidget *map,flightDataModel * model,QItemSelectionModel * selectionModel):QObject(parent),myMap(map),model(model),selection(selectionModel)
+modelMapProxy::modelMapProxy(QObject *parent,OPMapWidget *map,flightDataModel * model,QItemSelectionModel * selectionModel):QObject(parent),myMap(map),model(model),selection(selectionModel),
+    overlaysDirty(false),routeDirty(false),refreshPending(false)
 {
     connect(model,SIGNAL(rowsInserted(const QModelIndex&,int,int)),this,SLOT(rowsInserted(const QModelIndex&,int,int)));
     connect(model,SIGNAL(rowsRemoved(const QModelIndex&,int,int)),this,SLOT(rowsRemoved(const QModelIndex&,int,int)));
@@ -143,11 +144,41 @@ void modelMapProxy::createOverlay(WayPointItem *from, HomeItem *to, modelMapProx
 
     }
 }
+/**
+ * Marks the overlays (and with them the prefetch route) or only the route as out
+ * of date. They are rebuilt once when control returns to the event loop, so a
+ * mission loaded or edited row by row costs one rebuild instead of one per change.
+ */
+void modelMapProxy::scheduleRefresh(bool overlays)
+{
+    if(overlays)
+        overlaysDirty=true;
+    else
+        routeDirty=true;
+    if(refreshPending)
+        return;
+    refreshPending=true;
+    QTimer::singleShot(0,this,SLOT(refreshScheduled()));
+}
+
+void modelMapProxy::refreshScheduled()
+{
+    refreshPending=false;
+    if(overlaysDirty)
+        refreshOverlays();
+    else if(routeDirty)
+        refreshPrefetchRoute();
+    overlaysDirty=false;
+    routeDirty=false;
+}
+
 void modelMapProxy::refreshOverlays()
 {
     myMap->deleteAllOverlays();
+    refreshPrefetchRoute();
     if(model->rowCount()<1)
         return;
+    waypoints=myMap->WPAll();
     WayPointItem * wp_current=NULL;
     WayPointItem * wp_next=NULL;
     int wp_jump;
@@ -193,12 +224,26 @@ void modelMapProxy::refreshOverlays()
             break;
         }
     }
+    waypoints.clear();
+}
+
+void modelMapProxy::refreshPrefetchRoute()
+{
+    QList<internals::PointLatLng> route;
+    for(int x=0;x<model->rowCount();++x)
+    {
+        route.append(internals::PointLatLng(model->data(model->index(x,flightDataModel::LATPOSITION)).toDouble(),
+                                            model->data(model->index(x,flightDataModel::LNGPOSITION)).toDouble()));
+    }
+    myMap->SetPrefetchRoute(route);
 }
 
 WayPointItem * modelMapProxy::findWayPointNumber(int number)
 {
     if(number<0)
         return NULL;
+    if(!waypoints.isEmpty())
+        return waypoints.value(number,NULL);
     return myMap->WPFind(number);
 }
 
@@ -210,7 +255,7 @@ void modelMapProxy::rowsRemoved(const QModelIndex &parent, int first, int last)
     {
         myMap->WPDelete(x);
     }
-    refreshOverlays();
+    scheduleRefresh(true);
 }
 
 void modelMapProxy::dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
@@ -234,7 +279,7 @@ void modelMapProxy::dataChanged(const QModelIndex &topLeft, const QModelIndex &b
     case flightDataModel::JUMPDESTINATION:
     case flightDataModel::ERRORDESTINATION:
     case flightDataModel::MODE:
-        refreshOverlays();
+        scheduleRefresh(true);
     break;
     case flightDataModel::WPDESCRITPTION:
         index=model->index(x,flightDataModel::WPDESCRITPTION);
@@ -246,12 +291,14 @@ void modelMapProxy::dataChanged(const QModelIndex &topLeft, const QModelIndex &b
         index=model->index(x,flightDataModel::LATPOSITION);
         latlng.SetLat(index.data(Qt::DisplayRole).toDouble());
         item->SetCoord(latlng);
+        scheduleRefresh(false);
         break;
     case flightDataModel::LNGPOSITION:
         latlng=item->Coord();
         index=model->index(x,flightDataModel::LNGPOSITION);
         latlng.SetLng(index.data(Qt::DisplayRole).toDouble());
         item->SetCoord(latlng);
+        scheduleRefresh(false);
         break;
     case flightDataModel::BEARELATIVE:
         distBearing=item->getRelativeCoord();
@@ -323,7 +370,7 @@ void modelMapProxy::rowsInserted(const QModelIndex &parent, int first, int last)
         else
             item=myMap->WPInsert(latlng,altitude,desc,x);
     }
-    refreshOverlays();
+    scheduleRefresh(true);
 }
 void modelMapProxy::deleteWayPoint(int number)
 {
@@ -34,6 +34,8 @@
 #include "QPointer"
 #include "flightdatamodel.h"
 #include <QItemSelectionModel>
+#include <QHash>
+#include <QTimer>
 #include <widgetdelegates.h>
 
 
@@ -55,6 +57,7 @@ private slots:
     void WPValuesChanged(WayPointItem *wp);
     void currentRowChanged(QModelIndex,QModelIndex);
     void selectedWPChanged(QList<WayPointItem*>);
+    void refreshScheduled();
 private:
     overlayType overlayTranslate(int type);
     void createOverlay(WayPointItem * from,WayPointItem * to,overlayType type,QColor color);
@@ -62,7 +65,14 @@ private:
     OPMapWidget * myMap;
     flightDataModel * model;
     void refreshOverlays();
+    void refreshPrefetchRoute();
+    void scheduleRefresh(bool overlays);
     QItemSelectionModel * selection;
+    // Waypoints by number while the overlays are rebuilt
+    QHash<int,WayPointItem*> waypoints;
+    bool overlaysDirty;
+    bool routeDirty;
+    bool refreshPending;
 };
 
 #endif // MODELMAPPROXY_H
@@ -27,7 +27,14 @@
 #include "modeluavoproxy.h"
 #include "extensionsystem/pluginmanager.h"
 #include <math.h>
-modelUavoProxy::modelUavoProxy(QObject *parent,flightDataModel * model):QObject(parent),myModel(model)
+#include <string.h>
+#include <QHash>
+
+// Waypoint positions closer than this, in m, are the same position
+#define POSITION_TOLERANCE 0.001
+
+modelUavoProxy::modelUavoProxy(QObject *parent,flightDataModel * model):QObject(parent),myModel(model),
+    uploadsInFlight(0),uploadErrors(0),uploading(false),sending(false)
 {
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
     Q_ASSERT(pm != NULL);
@@ -40,31 +47,25 @@ modelUavoProxy::modelUavoProxy(QObject *parent,flightDataModel * model):QObject(
 }
 void modelUavoProxy::modelToObjects()
 {
-    PathAction * act=NULL;
-    Waypoint * wp=NULL;
     QModelIndex index;
     double distance;
     double bearing;
     double altitude;
+    // Rows with the same action share one PathAction instance
+    QHash<QByteArray,int> actions;
     int lastaction=-1;
     for(int x=0;x<myModel->rowCount();++x)
     {
-        int instances=objManager->getNumInstances(waypointObj->getObjID());
-        if(x>instances-1)
-        {
-            wp=new Waypoint;
-            wp->initialize(x,wp->getMetaObject());
-            objManager->registerObject(wp);
-        }
-        else
-        {
+        Waypoint * wp=NULL;
+        if(x<objManager->getNumInstances(waypointObj->getObjID()))
             wp=Waypoint::GetInstance(objManager,x);
-        }
-        act=new PathAction;
-        Q_ASSERT(act);
-        Q_ASSERT(wp);
-        Waypoint::DataFields waypoint = wp->getData();
-        PathAction::DataFields action = act->getData();
+        Waypoint::DataFields waypoint;
+        if(wp)
+            waypoint=wp->getData();
+        else
+            memset(&waypoint,0,sizeof(waypoint));
+        PathAction::DataFields action;
+        memset(&action,0,sizeof(action));
 
         ///Waypoint object data
         index=myModel->index(x,flightDataModel::DISRELATIVE);
@@ -76,9 +77,21 @@ void modelUavoProxy::modelToObjects()
         index=myModel->index(x,flightDataModel::VELOCITY);
         waypoint.Velocity=myModel->data(index).toFloat();
 
-        waypoint.Position[Waypoint::POSITION_NORTH]=distance*cos(bearing/180*M_PI);
-        waypoint.Position[Waypoint::POSITION_EAST]=distance*sin(bearing/180*M_PI);
-        waypoint.Position[Waypoint::POSITION_DOWN]=(-1.0f)*altitude;
+        float position[3];
+        position[Waypoint::POSITION_NORTH]=distance*cos(bearing/180*M_PI);
+        position[Waypoint::POSITION_EAST]=distance*sin(bearing/180*M_PI);
+        position[Waypoint::POSITION_DOWN]=(-1.0f)*altitude;
+        // The model keeps distance and bearing, a row read back from the UAV
+        // only gets the same position within rounding. Keep the position the
+        // UAV has then so that the row is not sent again.
+        for(int i=0;i<3;++i)
+        {
+            if(fabs(position[i]-waypoint.Position[i])>POSITION_TOLERANCE)
+            {
+                memcpy(waypoint.Position,position,sizeof(position));
+                break;
+            }
+        }
 
         ///PathAction object data
         index=myModel->index(x,flightDataModel::MODE);
@@ -110,13 +123,33 @@ void modelUavoProxy::modelToObjects()
         index=myModel->index(x,flightDataModel::ERRORDESTINATION);
         action.ErrorDestination=myModel->data(index).toInt()-1;
 
-        int actionNumber=addAction(act,action,lastaction);
-        if(actionNumber>lastaction)
-            lastaction=actionNumber;
+        QByteArray key((const char*)&action,sizeof(action));
+        int actionNumber=actions.value(key,-1);
+        if(actionNumber<0)
+        {
+            actionNumber=++lastaction;
+            actions.insert(key,actionNumber);
+            setAction(actionNumber,action);
+        }
         waypoint.Action=actionNumber;
+
+        if(!wp)
+        {
+            wp=new Waypoint;
+            wp->initialize(x,wp->getMetaObject());
+            objManager->registerObject(wp);
+        }
+        else
+        {
+            // Rows which did not change are not sent again
+            Waypoint::DataFields current=wp->getData();
+            if(memcmp(&current,&waypoint,sizeof(waypoint))==0)
+                continue;
+        }
         wp->setData(waypoint);
-        wp->updated();
+        queueUpload(wp);
     }
+    sendQueued();
 }
 
 void modelUavoProxy::objectsToModel()
@@ -143,9 +176,9 @@ void modelUavoProxy::objectsToModel()
         myModel->setData(index,wpfields.Velocity);
         distance=sqrt(wpfields.Position[Waypoint::POSITION_NORTH]*wpfields.Position[Waypoint::POSITION_NORTH]+
                       wpfields.Position[Waypoint::POSITION_EAST]*wpfields.Position[Waypoint::POSITION_EAST]);
-        bearing=acos(wpfields.Position[Waypoint::POSITION_NORTH]/wpfields.Position[Waypoint::POSITION_EAST])*180/M_PI;
-        if(bearing!=bearing)
-            bearing=0;
+        bearing=atan2(wpfields.Position[Waypoint::POSITION_EAST],wpfields.Position[Waypoint::POSITION_NORTH])*180/M_PI;
+        if(bearing<0)
+            bearing+=360;
         index=myModel->index(x,flightDataModel::DISRELATIVE);
         myModel->setData(index,distance);
         index=myModel->index(x,flightDataModel::BEARELATIVE);
@@ -196,53 +229,84 @@ void modelUavoProxy::objectsToModel()
         myModel->setData(index,actionfields.ModeParameters[3]);
     }
 }
-int modelUavoProxy::addAction(PathAction * actionObj,PathAction::DataFields actionFields,int lastaction)
+/**
+ * Stores the action as PathAction instance number, creating the instance if needed.
+ * The instance is only queued for upload when its data changed.
+ */
+void modelUavoProxy::setAction(int number,const PathAction::DataFields &actionFields)
 {
-    //check if a similar action already exhists
-    int instances=objManager->getNumInstances(pathactionObj->getObjID());
-    for(int x=0;x<lastaction+1;++x)
+    PathAction * action=NULL;
+    if(number<objManager->getNumInstances(pathactionObj->getObjID()))
     {
-        PathAction * action=PathAction::GetInstance(objManager,x);
+        action=PathAction::GetInstance(objManager,number);
         Q_ASSERT(action);
-        if(!action)
-            continue;
-        PathAction::DataFields fields=action->getData();
-        if(fields.Command==actionFields.Command
-                && fields.ConditionParameters[0]==actionFields.ConditionParameters[0]
-                && fields.ConditionParameters[1]==actionFields.ConditionParameters[1]
-                && fields.ConditionParameters[2]==actionFields.ConditionParameters[2]
-                &&fields.EndCondition==actionFields.EndCondition
-                &&fields.ErrorDestination==actionFields.ErrorDestination
-                &&fields.JumpDestination==actionFields.JumpDestination
-                &&fields.Mode==actionFields.Mode
-                &&fields.ModeParameters[0]==actionFields.ModeParameters[0]
-                &&fields.ModeParameters[1]==actionFields.ModeParameters[1]
-                &&fields.ModeParameters[2]==actionFields.ModeParameters[2])
-        {
-            qDebug()<<"ModelUAVProxy:"<<"found similar action instance:"<<x;
-            actionObj->deleteLater();
-            return x;
-        }
+        PathAction::DataFields current=action->getData();
+        if(memcmp(&current,&actionFields,sizeof(actionFields))==0)
+            return;
     }
-    //if we get here it means no similar action was found, we have to create it
-    if(instances<lastaction+2)
+    else
     {
-        actionObj->initialize(instances,actionObj->getMetaObject());
-        objManager->registerObject(actionObj);
-        actionObj->setData(actionFields);
-        actionObj->updated();
-        qDebug()<<"ModelUAVProxy:"<<"created new action instance:"<<instances;
-        return lastaction+1;
+        action=new PathAction;
+        action->initialize(number,action->getMetaObject());
+        objManager->registerObject(action);
+        qDebug()<<"ModelUAVProxy:"<<"created new action instance:"<<number;
     }
-    else
+    action->setData(actionFields);
+    queueUpload(action);
+}
+
+void modelUavoProxy::queueUpload(UAVObject *obj)
+{
+    if(!uploadQueue.contains(obj))
+        uploadQueue.enqueue(obj);
+}
+
+/**
+ * Keeps up to UPLOAD_WINDOW objects in flight. The objects are sent acked for the
+ * upload so each completion frees a slot and the telemetry transaction engine can
+ * pipeline the instances instead of sending the whole mission in one burst.
+ */
+void modelUavoProxy::sendQueued()
+{
+    if(sending)
+        return;
+    sending=true;
+    while(uploadsInFlight<UPLOAD_WINDOW && !uploadQueue.isEmpty())
     {
-        PathAction * action=PathAction::GetInstance(objManager,lastaction+1);
-        Q_ASSERT(action);
-        action->setData(actionFields);
-        action->updated();
-        actionObj->deleteLater();
-        qDebug()<<"ModelUAVProxy:"<<"reused action instance:"<<lastaction+1;
-        return lastaction+1;
+        if(!uploading)
+        {
+            uploading=true;
+            uploadErrors=0;
+            waypointMeta=waypointObj->getMetadata();
+            pathactionMeta=pathactionObj->getMetadata();
+            UAVObject::Metadata mdata=waypointMeta;
+            UAVObject::SetGcsTelemetryAcked(mdata,true);
+            waypointObj->setMetadata(mdata);
+            mdata=pathactionMeta;
+            UAVObject::SetGcsTelemetryAcked(mdata,true);
+            pathactionObj->setMetadata(mdata);
+        }
+        UAVObject * obj=uploadQueue.dequeue();
+        connect(obj,SIGNAL(transactionCompleted(UAVObject*,bool)),this,SLOT(uploadCompleted(UAVObject*,bool)),Qt::UniqueConnection);
+        ++uploadsInFlight;
+        obj->updated();
+    }
+    sending=false;
+    if(uploading&&uploadsInFlight==0&&uploadQueue.isEmpty())
+    {
+        uploading=false;
+        waypointObj->setMetadata(waypointMeta);
+        pathactionObj->setMetadata(pathactionMeta);
+        if(uploadErrors)
+            qDebug()<<"ModelUAVProxy:"<<uploadErrors<<"objects failed to upload";
     }
-    return -1;//error we should never get here
+}
+
+void modelUavoProxy::uploadCompleted(UAVObject *obj, bool success)
+{
+    disconnect(obj,SIGNAL(transactionCompleted(UAVObject*,bool)),this,SLOT(uploadCompleted(UAVObject*,bool)));
+    --uploadsInFlight;
+    if(!success)
+        ++uploadErrors;
+    sendQueued();
 }
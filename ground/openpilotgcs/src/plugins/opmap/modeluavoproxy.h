@@ -28,6 +28,7 @@
 #define MODELUAVOPROXY_H
 
 #include <QObject>
+#include <QQueue>
 #include "flightdatamodel.h"
 #include "pathaction.h"
 #include "waypoint.h"
@@ -37,15 +38,28 @@ class modelUavoProxy:public QObject
     Q_OBJECT
 public:
     explicit modelUavoProxy(QObject *parent, flightDataModel *model);
-    int addAction(PathAction *actionObj, PathAction::DataFields actionFields,int lastaction);
 public slots:
     void modelToObjects();
     void objectsToModel();
+private slots:
+    void uploadCompleted(UAVObject *obj, bool success);
 private:
+    /** Number of objects sent to the UAV and not acked yet during an upload */
+    static const int UPLOAD_WINDOW = 8;
+    void setAction(int number, const PathAction::DataFields &actionFields);
+    void queueUpload(UAVObject *obj);
+    void sendQueued();
     UAVObjectManager *objManager;
     Waypoint * waypointObj;
     PathAction * pathactionObj;
     flightDataModel * myModel;
+    QQueue<UAVObject*> uploadQueue;
+    int uploadsInFlight;
+    int uploadErrors;
+    bool uploading;
+    bool sending;
+    UAVObject::Metadata waypointMeta;
+    UAVObject::Metadata pathactionMeta;
 };
 
 #endif // MODELUAVOPROXY_H
@@ -23,7 +23,8 @@ HEADERS += opmapplugin.h \
     widgetdelegates.h \
     pathplanner.h \
     modeluavoproxy.h \
-    homeeditor.h
+    homeeditor.h \
+    opmapmemoryreporter.h
 
 SOURCES += opmapplugin.cpp \
     opmapgadgetwidget.cpp \
@@ -39,7 +40,8 @@ SOURCES += opmapplugin.cpp \
     widgetdelegates.cpp \
     pathplanner.cpp \
     modeluavoproxy.cpp \
-    homeeditor.cpp
+    homeeditor.cpp \
+    opmapmemoryreporter.cpp
 
 OTHER_FILES += OPMapGadget.pluginspec
 
@@ -45,6 +45,7 @@
 #include "utils/worldmagmodel.h"
 
 #include "uavtalk/telemetrymanager.h"
+#include "opmapmemoryreporter.h"
 #include "uavobject.h"
 
 #include "positionactual.h"
@@ -96,6 +97,7 @@ OPMapGadgetWidget::OPMapGadgetWidget(QWidget *parent) : QWidget(parent)
 	pm = NULL;
 	obm = NULL;
 	obum = NULL;
+	m_interest = NULL;
 
 	m_prev_tile_number = 0;
 
@@ -153,6 +155,10 @@ OPMapGadgetWidget::OPMapGadgetWidget(QWidget *parent) : QWidget(parent)
 
     m_map->configuration->DragButton = Qt::LeftButton;  // use the left mouse button for map dragging
 
+    OPMapMemoryReporter *memoryReporter = pm->getObject<OPMapMemoryReporter>();
+    if (memoryReporter)
+        memoryReporter->addMap(m_map);
+
     m_widget->horizontalSliderZoom->setMinimum(m_map->MinZoom());			//
     m_widget->horizontalSliderZoom->setMaximum(m_map->MaxZoom() + max_digital_zoom);	//
 
@@ -249,6 +255,13 @@ OPMapGadgetWidget::OPMapGadgetWidget(QWidget *parent) : QWidget(parent)
             {
 				connect(obj, SIGNAL(objectUpdated(UAVObject *)), this , SLOT(homePositionUpdated(UAVObject *)));
             }
+
+			m_interest = new UAVObjectInterest(this);
+			m_interest->addObject(GPSPosition::GetInstance(obm));
+			m_interest->addObject(AttitudeActual::GetInstance(obm));
+			m_interest->addObject(PositionActual::GetInstance(obm));
+			m_interest->addObject(VelocityActual::GetInstance(obm));
+			m_interest->addObject(Gyros::GetInstance(obm));
         }
 
         // Listen to telemetry connection events
@@ -289,6 +302,9 @@ OPMapGadgetWidget::~OPMapGadgetWidget()
 
 	if (m_map)
 	{
+		OPMapMemoryReporter *memoryReporter = pm->getObject<OPMapMemoryReporter>();
+		if (memoryReporter)
+			memoryReporter->removeMap(m_map);
 		delete m_map;
 		m_map = NULL;
 	}
@@ -1147,6 +1163,9 @@ void OPMapGadgetWidget::setCacheLocation(QString cacheLocation)
         if (!dir.mkpath(cacheLocation))
             return;
     m_map->configuration->SetCacheLocation(cacheLocation);
+
+    // An offline archive copied next to the cache is used before the cache itself
+    m_map->configuration->SetTileArchive(QFile::exists(cacheLocation + "offline.opta") ? cacheLocation + "offline.opta" : QString());
 }
 
 void OPMapGadgetWidget::setMapMode(opMapModeType mode)
@@ -56,6 +56,7 @@
 #include "uavobjectutilmanager.h"
 #include "uavobjectmanager.h"
 #include "uavobject.h"
+#include "uavobjectinterest.h"
 #include "objectpersistence.h"
 #include <QItemSelectionModel>
 #include "opmap_edit_waypoint_dialog.h"
@@ -233,6 +234,8 @@ private:
 	ExtensionSystem::PluginManager *pm;
 	UAVObjectManager *obm;
 	UAVObjectUtilManager *obum;
+	// The objects read by updatePosition(), shown while the map is visible
+	UAVObjectInterest *m_interest;
     QPointer<opmap_edit_waypoint_dialog> waypoint_edit_dialog;
     QStandardItemModel wayPoint_treeView_model;
     mapcontrol::WayPointItem *m_mouse_waypoint;
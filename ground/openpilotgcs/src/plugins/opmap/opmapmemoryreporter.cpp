@@ -0,0 +1,51 @@
+/**
+ ******************************************************************************
+ *
+ * @file       opmapmemoryreporter.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup OPMapPlugin OpenPilot Map Plugin
+ * @{
+ * @brief The OpenPilot Map plugin 
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "opmapmemoryreporter.h"
+
+QString OPMapMemoryReporter::memoryGroup() const
+{
+    return tr("Map");
+}
+
+QList<Core::IMemoryReporter::Usage> OPMapMemoryReporter::memoryUsage() const
+{
+    core::KiberTileCache &tiles = core::OPMaps::Instance()->TilesInMemory;
+    qint64 points = 0;
+    qint64 bytes = 0;
+    foreach (mapcontrol::OPMapWidget *map, maps) {
+        if (map->UAV) {
+            points += map->UAV->TrailPoints();
+            bytes += map->UAV->TrailMemoryBytes();
+        }
+        if (map->GPS) {
+            points += map->GPS->TrailPoints();
+            bytes += map->GPS->TrailMemoryBytes();
+        }
+    }
+    return QList<Usage>() << Usage(tr("Tile memory cache"), tiles.TilesCount(), tiles.MemoryCacheBytes())
+                          << Usage(tr("Trails"), points, bytes);
+}
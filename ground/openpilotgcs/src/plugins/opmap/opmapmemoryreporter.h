@@ -0,0 +1,54 @@
+/**
+ ******************************************************************************
+ *
+ * @file       opmapmemoryreporter.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup OPMapPlugin OpenPilot Map Plugin
+ * @{
+ * @brief The OpenPilot Map plugin 
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef OPMAPMEMORYREPORTER_H
+#define OPMAPMEMORYREPORTER_H
+
+#include <coreplugin/imemoryreporter.h>
+#include "opmapcontrol/opmapcontrol.h"
+
+/**
+ * Reports the tile memory cache, shared by all maps, and the trails of the
+ * maps registered by the map gadgets to the Memory Usage page.
+ */
+class OPMapMemoryReporter : public Core::IMemoryReporter
+{
+    Q_OBJECT
+public:
+    OPMapMemoryReporter(QObject *parent = 0) : Core::IMemoryReporter(parent) {}
+
+    void addMap(mapcontrol::OPMapWidget *map) { maps.append(map); }
+    void removeMap(mapcontrol::OPMapWidget *map) { maps.removeAll(map); }
+
+    QString memoryGroup() const;
+    QList<Usage> memoryUsage() const;
+
+private:
+    QList<mapcontrol::OPMapWidget *> maps;
+};
+
+#endif // OPMAPMEMORYREPORTER_H
@@ -26,6 +26,7 @@
  */
 #include "opmapplugin.h"
 #include "opmapgadgetfactory.h"
+#include "opmapmemoryreporter.h"
 #include <QtPlugin>
 #include <QStringList>
 #include <extensionsystem/pluginmanager.h>
@@ -47,6 +48,7 @@ bool OPMapPlugin::initialize(const QStringList& args, QString *errMsg)
 
    mf = new OPMapGadgetFactory(this);
    addAutoReleasedObject(mf);
+   addAutoReleasedObject(new OPMapMemoryReporter(this));
 
    return true;
 }
@@ -53,6 +53,7 @@ PFDGadgetWidget::PFDGadgetWidget(QWidget *parent) : QGraphicsView(parent)
     headingObj = NULL;
     gcsBatteryObj = NULL;
     gpsObj = NULL;
+    interest = new UAVObjectInterest(this);
     compassBandWidth = 0;
     pfdError = true;
     hqFonts = false;
@@ -67,12 +68,11 @@ PFDGadgetWidget::PFDGadgetWidget(QWidget *parent) : QGraphicsView(parent)
     altitudeTarget = 0;
     altitudeValue = 0;
 
-    // This timer mechanism makes needles rotate smoothly
+    // This timer mechanism makes needles rotate smoothly. The timers stop
+    // once the needles reach their targets and are rearmed by the updates,
+    // they tick on the frame clock shared by all instruments.
     connect(&dialTimer, SIGNAL(timeout()), this, SLOT(moveNeedles()));
-    dialTimer.start(30);
-
     connect(&skyDialTimer, SIGNAL(timeout()), this, SLOT(moveSky()));
-    skyDialTimer.start(30);
 
 
 }
@@ -122,6 +122,8 @@ void PFDGadgetWidget::connectNeedles() {
     if (gpsObj != NULL)
         disconnect(gpsObj,SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateGPS(UAVObject*)));
 
+    interest->clear();
+
     // Safeguard: if artwork did not load properly, don't go further
     if (pfdError)
     	return;
@@ -131,6 +133,7 @@ void PFDGadgetWidget::connectNeedles() {
     airspeedObj = dynamic_cast<UAVDataObject*>(objManager->getObject("VelocityActual"));
     if (airspeedObj != NULL ) {
         connect(airspeedObj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateAirspeed(UAVObject*)));
+        interest->addObject(airspeedObj);
     } else {
          qDebug() << "Error: Object is unknown (VelocityActual).";
     }
@@ -138,6 +141,7 @@ void PFDGadgetWidget::connectNeedles() {
     altitudeObj = dynamic_cast<UAVDataObject*>(objManager->getObject("PositionActual"));
     if (altitudeObj != NULL ) {
         connect(altitudeObj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateAltitude(UAVObject*)));
+        interest->addObject(altitudeObj);
     } else {
          qDebug() << "Error: Object is unknown (PositionActual).";
     }
@@ -145,6 +149,7 @@ void PFDGadgetWidget::connectNeedles() {
    attitudeObj = dynamic_cast<UAVDataObject*>(objManager->getObject("AttitudeActual"));
    if (attitudeObj != NULL ) {
        connect(attitudeObj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateAttitude(UAVObject*)));
+       interest->addObject(attitudeObj);
    } else {
         qDebug() << "Error: Object is unknown (AttitudeActual).";
    }
@@ -152,6 +157,7 @@ void PFDGadgetWidget::connectNeedles() {
    headingObj = dynamic_cast<UAVDataObject*>(objManager->getObject("PositionActual"));
    if (headingObj != NULL ) {
        connect(headingObj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateHeading(UAVObject*)));
+       interest->addObject(headingObj);
    } else {
         qDebug() << "Error: Object is unknown (PositionActual).";
    }
@@ -160,6 +166,7 @@ void PFDGadgetWidget::connectNeedles() {
        gpsObj = dynamic_cast<UAVDataObject*>(objManager->getObject("GPSPosition"));
        if (gpsObj != NULL) {
            connect(gpsObj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateGPS(UAVObject*)));
+           interest->addObject(gpsObj);
        } else {
            qDebug() << "Error: Object is unknown (GPSPosition).";
        }
@@ -179,6 +186,7 @@ void PFDGadgetWidget::connectNeedles() {
        gcsBatteryObj = dynamic_cast<UAVDataObject*>(objManager->getObject("FlightBatteryState"));
        if (gcsBatteryObj != NULL ) {
            connect(gcsBatteryObj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateBattery(UAVObject*)));
+           interest->addObject(gcsBatteryObj);
        } else {
             qDebug() << "Error: Object is unknown (FlightBatteryState).";
        }
@@ -275,8 +283,10 @@ void PFDGadgetWidget::updateAttitude(UAVObject *object1) {
         }
         headingTarget = floor(headingTarget*10)/10; // Avoid stupid redraws
 
-        if (!dialTimer.isActive())
+        if (headingTarget != headingValue && !dialTimer.isActive())
             dialTimer.start(); // Rearm the dial Timer which might be stopped.
+        if ((rollTarget != rollValue || pitchTarget != pitchValue) && !skyDialTimer.isActive())
+            skyDialTimer.start(); // Same for the sky
 
     } else {
         qDebug() << "Unable to get one of the fields for attitude update";
@@ -306,7 +316,7 @@ void PFDGadgetWidget::updateAirspeed(UAVObject *object) {
         double val = floor(sqrt(pow(northField->getDouble(),2) + pow(eastField->getDouble(),2))*10)/10;
         groundspeedTarget = 3.6*val*speedScaleHeight/30;
 
-        if (!dialTimer.isActive())
+        if (groundspeedTarget != groundspeedValue && !dialTimer.isActive())
             dialTimer.start(); // Rearm the dial Timer which might be stopped.
 
     } else {
@@ -322,7 +332,7 @@ void PFDGadgetWidget::updateAltitude(UAVObject *object) {
     if (downField) {
         // The altitude scale represents 30 meters
         altitudeTarget = -floor(downField->getDouble()*10)/10*altitudeScaleHeight/30;
-        if (!dialTimer.isActive())
+        if (altitudeTarget != altitudeValue && !dialTimer.isActive())
             dialTimer.start(); // Rearm the dial Timer which might be stopped.
 
     } else {
@@ -776,6 +786,8 @@ void PFDGadgetWidget::setDialFile(QString dfn)
         pfdError = false;
         if (!dialTimer.isActive())
             dialTimer.start(); // Rearm the dial Timer which might be stopped.
+        if (!skyDialTimer.isActive())
+            skyDialTimer.start();
    }
    else
    { qDebug()<<"Error on PFD artwork file.";
@@ -826,7 +838,7 @@ void PFDGadgetWidget::moveSky() {
 //    qDebug() << "MoveSky";
     /// TODO: optimize!!!
     if (pfdError) {
-        //skyDialTimer.stop();
+        skyDialTimer.stop();
         return;
     }
 
@@ -835,8 +847,10 @@ void PFDGadgetWidget::moveSky() {
     // the PFD and the whole GCS: for this reason, we check this here.
     // The strange check below works, it is a workaround because "isnan(double)"
     // is not supported on every compiler.
-    if (rollTarget != rollTarget || pitchTarget != pitchTarget)
+    if (rollTarget != rollTarget || pitchTarget != pitchTarget) {
+        skyDialTimer.stop();
         return;
+    }
     //////
     // Roll
     //////
@@ -878,8 +892,8 @@ void PFDGadgetWidget::moveSky() {
 
     if (dialCount)
         scene()->update(sceneRect());
-  //  if (!dialCount)
-  //      skyDialTimer.stop();
+    else
+        skyDialTimer.stop();
 
 }
 
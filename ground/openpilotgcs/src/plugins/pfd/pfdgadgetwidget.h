@@ -32,12 +32,13 @@
 #include "extensionsystem/pluginmanager.h"
 #include "uavobjectmanager.h"
 #include "uavobject.h"
+#include "uavobjectinterest.h"
 #include <QGraphicsView>
 #include <QtSvg/QSvgRenderer>
 #include <QtSvg/QGraphicsSvgItem>
 
 #include <QFile>
-#include <QTimer>
+#include <utils/instrumentclock.h>
 
 class PFDGadgetWidget : public QGraphicsView
 {
@@ -134,10 +135,12 @@ private:
    UAVDataObject* gpsObj;
    UAVDataObject* gcsTelemetryObj;
    UAVDataObject* gcsBatteryObj;
+   // The flight objects above, shown while the PFD is visible
+   UAVObjectInterest* interest;
 
    // Rotation timer
-   QTimer dialTimer;
-   QTimer skyDialTimer;
+   Utils::InstrumentTimer dialTimer;
+   Utils::InstrumentTimer skyDialTimer;
 
    QString satString;
    QString batString;
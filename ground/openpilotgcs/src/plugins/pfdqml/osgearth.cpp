@@ -41,6 +41,11 @@
 
 #include "utils/pathutils.h"
 
+// While the pager still has tiles in flight, frames are stepped at this
+// period so the tiles are compiled and shown without waiting for the
+// attitude to change
+#define PAGING_FRAME_MS 50
+
 OsgEarthItem::OsgEarthItem(QDeclarativeItem *parent):
     QDeclarativeItem(parent),
     m_renderer(0),
@@ -53,7 +58,10 @@ OsgEarthItem::OsgEarthItem(QDeclarativeItem *parent):
     m_longitude(153.0),
     m_altitude(400.0),
     m_fieldOfView(90.0),
-    m_sceneFile(QLatin1String("/usr/share/osgearth/maps/srtm.earth"))
+    m_sceneFile(QLatin1String("/usr/share/osgearth/maps/srtm.earth")),
+    m_lodScale(1.0),
+    m_maxPagedTiles(300),
+    m_pagerThreads(2)
 {
     setSize(m_currentSize);
     setFlag(ItemHasNoContents, false);
@@ -232,12 +240,42 @@ void OsgEarthItem::setSceneFile(QString arg)
     }
 }
 
+//! Scale of the terrain tile ranges, above 1 coarser tiles are paged in
+void OsgEarthItem::setLodScale(qreal arg)
+{
+    if (!qFuzzyCompare(m_lodScale, arg)) {
+        m_lodScale = arg;
+        emit lodScaleChanged(arg);
+        updateFrame();
+    }
+}
+
+//! Number of terrain tiles the pager keeps resident
+void OsgEarthItem::setMaxPagedTiles(int arg)
+{
+    if (m_maxPagedTiles != arg) {
+        m_maxPagedTiles = arg;
+        emit maxPagedTilesChanged(arg);
+        updateFrame();
+    }
+}
+
+//! Tile loading threads, only used when the scene is loaded
+void OsgEarthItem::setPagerThreads(int arg)
+{
+    if (m_pagerThreads != arg) {
+        m_pagerThreads = arg;
+        emit pagerThreadsChanged(arg);
+    }
+}
+
 OsgEarthItemRenderer::OsgEarthItemRenderer(OsgEarthItem *item, QGLWidget *glWidget) :
     QObject(0),
     m_item(item),
     m_lastFboNumber(0),
     m_currentSize(640, 480),
-    m_cameraDirty(false)
+    m_cameraDirty(false),
+    m_pagingFramePending(false)
 {
     //make a shared gl widget to avoid
     //osg rendering to mess with qpainter state
@@ -290,7 +328,11 @@ void OsgEarthItemRenderer::initScene()
     m_viewer = new osgViewer::Viewer();
     m_viewer->setThreadingModel(osgViewer::Viewer::SingleThreaded);
     m_viewer->setSceneData(m_model);
-    m_viewer->getDatabasePager()->setDoPreCompile(true);
+
+    osgDB::DatabasePager *pager = m_viewer->getDatabasePager();
+    pager->setDoPreCompile(true);
+    //one of the threads fetches remote tiles, the rest read local ones
+    pager->setUpThreads(qMax(2, m_item->pagerThreads()), 1);
 
     osg::Camera *camera = m_viewer->getCamera();
     camera->setViewport(new osg::Viewport(0,0,w,h));
@@ -355,6 +397,9 @@ void OsgEarthItemRenderer::updateFrame()
 //    qDebug() << "c " << center.x() << center.y() << center.z();
 //    qDebug() << "up" << upVector.x() << upVector.y() << upVector.z();
 
+    m_viewer->getCamera()->setLODScale(m_item->lodScale());
+    m_viewer->getDatabasePager()->setTargetMaximumNumberOfPageLOD(m_item->maxPagedTiles());
+
     m_viewer->getCamera()->setViewMatrixAsLookAt(osg::Vec3d(eye.x(), eye.y(), eye.z()),
                                                  osg::Vec3d(center.x(), center.y(), center.z()),
                                                  osg::Vec3d(upVector.x(), upVector.y(), upVector.z()));
@@ -371,4 +416,16 @@ void OsgEarthItemRenderer::updateFrame()
     m_lastFboNumber = (m_lastFboNumber + 1) % FboCount;
 
     emit frameReady();
+
+    if (m_viewer->getDatabasePager()->getRequestsInProgress() && !m_pagingFramePending) {
+        m_pagingFramePending = true;
+        QTimer::singleShot(PAGING_FRAME_MS, this, SLOT(pageFrame()));
+    }
+}
+
+void OsgEarthItemRenderer::pageFrame()
+{
+    m_pagingFramePending = false;
+    m_cameraDirty = true;
+    updateFrame();
 }
@@ -19,6 +19,8 @@
 
 #include <osgViewer/Viewer>
 
+#include <QtCore/qatomic.h>
+
 #include <QtDeclarative/QDeclarativeItem>
 #include <osgQt/GraphicsWindowQt>
 
@@ -34,6 +36,10 @@ class OsgEarthItem : public QDeclarativeItem
     Q_PROPERTY(QString sceneFile READ sceneFile WRITE setSceneFile NOTIFY sceneFileChanged)
     Q_PROPERTY(qreal fieldOfView READ fieldOfView WRITE setFieldOfView NOTIFY fieldOfViewChanged)
 
+    Q_PROPERTY(qreal lodScale READ lodScale WRITE setLodScale NOTIFY lodScaleChanged)
+    Q_PROPERTY(int maxPagedTiles READ maxPagedTiles WRITE setMaxPagedTiles NOTIFY maxPagedTilesChanged)
+    Q_PROPERTY(int pagerThreads READ pagerThreads WRITE setPagerThreads NOTIFY pagerThreadsChanged)
+
     Q_PROPERTY(qreal roll READ roll WRITE setRoll NOTIFY rollChanged)
     Q_PROPERTY(qreal pitch READ pitch WRITE setPitch NOTIFY pitchChanged)
     Q_PROPERTY(qreal yaw READ yaw WRITE setYaw NOTIFY yawChanged)
@@ -50,6 +56,10 @@ public:
     QString resolvedSceneFile() const;
     qreal fieldOfView() const { return m_fieldOfView; }
 
+    qreal lodScale() const { return m_lodScale; }
+    int maxPagedTiles() const { return m_maxPagedTiles; }
+    int pagerThreads() const { return m_pagerThreads; }
+
     qreal roll() const { return m_roll; }
     qreal pitch() const { return m_pitch; }
     qreal yaw() const { return m_yaw; }
@@ -67,6 +77,10 @@ public slots:
     void setSceneFile(QString arg);
     void setFieldOfView(qreal arg);
 
+    void setLodScale(qreal arg);
+    void setMaxPagedTiles(int arg);
+    void setPagerThreads(int arg);
+
     void setRoll(qreal arg);
     void setPitch(qreal arg);
     void setYaw(qreal arg);
@@ -87,6 +101,10 @@ signals:
     void sceneFileChanged(QString arg);
     void fieldOfViewChanged(qreal arg);
 
+    void lodScaleChanged(qreal arg);
+    void maxPagedTilesChanged(int arg);
+    void pagerThreadsChanged(int arg);
+
 private slots:
     void updateFrame();
 
@@ -107,6 +125,10 @@ private:
     qreal m_fieldOfView;
     QString m_sceneFile;
 
+    qreal m_lodScale;
+    int m_maxPagedTiles;
+    int m_pagerThreads;
+
 };
 
 class OsgEarthItemRenderer : public QObject
@@ -123,6 +145,9 @@ public slots:
     void initScene();
     void updateFrame();
 
+private slots:
+    void pageFrame();
+
 signals:
     void frameReady();
 
@@ -136,11 +161,12 @@ private:
     QWeakPointer<QGLWidget> m_glWidget;
 
     QGLFramebufferObject* m_fbo[FboCount];
-    int m_lastFboNumber;
+    QAtomicInt m_lastFboNumber;
 
     QSize m_currentSize;
 
     bool m_cameraDirty;
+    bool m_pagingFramePending;
 };
 
 QML_DECLARE_TYPE(OsgEarthItem)
@@ -46,6 +46,9 @@ void PfdQmlGadget::loadConfiguration(IUAVGadgetConfiguration* config)
     m_widget->setLatitude(m->latitude());
     m_widget->setLongitude(m->longitude());
     m_widget->setAltitude(m->altitude());
+    m_widget->setTerrainLodScale(m->terrainLodScale());
+    m_widget->setTerrainTileBudget(m->terrainTileBudget());
+    m_widget->setTerrainPagerThreads(m->terrainPagerThreads());
 
     //setting OSGEARTH_CACHE_ONLY seems to work the most reliably
     //between osgEarth versions I tried
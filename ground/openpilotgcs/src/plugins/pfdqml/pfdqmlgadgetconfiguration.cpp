@@ -31,7 +31,10 @@ PfdQmlGadgetConfiguration::PfdQmlGadgetConfiguration(QString classId, QSettings
     m_latitude(0),
     m_longitude(0),
     m_altitude(0),
-    m_cacheOnly(false)
+    m_cacheOnly(false),
+    m_terrainLodScale(1.0),
+    m_terrainTileBudget(300),
+    m_terrainPagerThreads(2)
 {
     //if a saved configuration exists load it
     if(qSettings != 0) {
@@ -48,6 +51,9 @@ PfdQmlGadgetConfiguration::PfdQmlGadgetConfiguration(QString classId, QSettings
         m_longitude = qSettings->value("longitude").toDouble();
         m_altitude = qSettings->value("altitude").toDouble();
         m_cacheOnly = qSettings->value("cacheOnly").toBool();
+        m_terrainLodScale = qSettings->value("terrainLodScale", 1.0).toDouble();
+        m_terrainTileBudget = qSettings->value("terrainTileBudget", 300).toInt();
+        m_terrainPagerThreads = qSettings->value("terrainPagerThreads", 2).toInt();
     }
 }
 
@@ -67,6 +73,9 @@ IUAVGadgetConfiguration *PfdQmlGadgetConfiguration::clone()
     m->m_longitude = m_longitude;
     m->m_altitude = m_altitude;
     m->m_cacheOnly = m_cacheOnly;
+    m->m_terrainLodScale = m_terrainLodScale;
+    m->m_terrainTileBudget = m_terrainTileBudget;
+    m->m_terrainPagerThreads = m_terrainPagerThreads;
 
     return m;
 }
@@ -88,4 +97,7 @@ void PfdQmlGadgetConfiguration::saveConfig(QSettings* qSettings) const {
     qSettings->setValue("longitude", m_longitude);
     qSettings->setValue("altitude", m_altitude);
     qSettings->setValue("cacheOnly", m_cacheOnly);
+    qSettings->setValue("terrainLodScale", m_terrainLodScale);
+    qSettings->setValue("terrainTileBudget", m_terrainTileBudget);
+    qSettings->setValue("terrainPagerThreads", m_terrainPagerThreads);
 }
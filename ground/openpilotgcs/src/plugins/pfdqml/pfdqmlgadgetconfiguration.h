@@ -36,6 +36,9 @@ public:
     void setLongitude(double value) { m_longitude = value; }
     void setAltitude(double value) { m_altitude = value; }
     void setCacheOnly(bool flag) { m_cacheOnly = flag; }
+    void setTerrainLodScale(double value) { m_terrainLodScale = value; }
+    void setTerrainTileBudget(int value) { m_terrainTileBudget = value; }
+    void setTerrainPagerThreads(int value) { m_terrainPagerThreads = value; }
 
     QString qmlFile() const { return m_qmlFile; }
     QString earthFile() const { return m_earthFile; }
@@ -46,6 +49,9 @@ public:
     double longitude() const { return m_longitude; }
     double altitude() const { return m_altitude; }
     bool cacheOnly() const { return m_cacheOnly; }
+    double terrainLodScale() const { return m_terrainLodScale; }
+    int terrainTileBudget() const { return m_terrainTileBudget; }
+    int terrainPagerThreads() const { return m_terrainPagerThreads; }
 
     void saveConfig(QSettings* settings) const;
     IUAVGadgetConfiguration *clone();
@@ -60,6 +66,9 @@ private:
     double m_longitude;
     double m_altitude;
     bool m_cacheOnly;
+    double m_terrainLodScale; // >1 pages coarser terrain tiles
+    int m_terrainTileBudget; // terrain tiles kept paged in
+    int m_terrainPagerThreads;
 };
 
 #endif // PfdQmlGADGETCONFIGURATION_H
@@ -62,6 +62,9 @@ QWidget *PfdQmlGadgetOptionsPage::createPage(QWidget *parent)
     options_page->longitude->setText(QString::number(m_config->longitude()));
     options_page->altitude->setText(QString::number(m_config->altitude()));
     options_page->useOnlyCache->setChecked(m_config->cacheOnly());
+    options_page->lodScale->setValue(m_config->terrainLodScale());
+    options_page->tileBudget->setValue(m_config->terrainTileBudget());
+    options_page->pagerThreads->setValue(m_config->terrainPagerThreads());
 
 #ifndef USE_OSG
     options_page->showTerrain->setChecked(false);
@@ -94,6 +97,9 @@ void PfdQmlGadgetOptionsPage::apply()
     m_config->setLongitude(options_page->longitude->text().toDouble());
     m_config->setAltitude(options_page->altitude->text().toDouble());
     m_config->setCacheOnly(options_page->useOnlyCache->isChecked());
+    m_config->setTerrainLodScale(options_page->lodScale->value());
+    m_config->setTerrainTileBudget(options_page->tileBudget->value());
+    m_config->setTerrainPagerThreads(options_page->pagerThreads->value());
 }
 
 void PfdQmlGadgetOptionsPage::finish()
@@ -18,6 +18,7 @@
 #include "extensionsystem/pluginmanager.h"
 #include "uavobjectmanager.h"
 #include "uavobject.h"
+#include "uavobjectinterest.h"
 #include "utils/svgimageprovider.h"
 #ifdef USE_OSG
 #include "osgearth.h"
@@ -36,10 +37,14 @@ PfdQmlGadgetWidget::PfdQmlGadgetWidget(QWidget *parent) :
     QDeclarativeView(parent),
     m_openGLEnabled(false),
     m_terrainEnabled(false),
+    m_terrainLodScale(1.0),
+    m_terrainTileBudget(300),
+    m_terrainPagerThreads(2),
     m_actualPositionUsed(false),
     m_latitude(46.671478),
     m_longitude(10.158932),
-    m_altitude(2000)
+    m_altitude(2000),
+    m_interest(new UAVObjectInterest(this))
 {
     setMinimumSize(64,64);
     setSizePolicy(QSizePolicy::MinimumExpanding, QSizePolicy::MinimumExpanding);
@@ -64,9 +69,10 @@ PfdQmlGadgetWidget::PfdQmlGadgetWidget(QWidget *parent) :
 
     foreach (const QString &objectName, objectsToExport) {
         UAVObject* object = objManager->getObject(objectName);
-        if (object)
+        if (object) {
             engine()->rootContext()->setContextProperty(objectName, object);
-        else
+            m_interest->addObject(object);
+        } else
             qWarning() << "Failed to load object" << objectName;
     }
 
@@ -134,6 +140,30 @@ void PfdQmlGadgetWidget::setOpenGLEnabled(bool arg)
     }
 }
 
+void PfdQmlGadgetWidget::setTerrainLodScale(double arg)
+{
+    if (!qFuzzyCompare(m_terrainLodScale, arg)) {
+        m_terrainLodScale = arg;
+        emit terrainLodScaleChanged(arg);
+    }
+}
+
+void PfdQmlGadgetWidget::setTerrainTileBudget(int arg)
+{
+    if (m_terrainTileBudget != arg) {
+        m_terrainTileBudget = arg;
+        emit terrainTileBudgetChanged(arg);
+    }
+}
+
+void PfdQmlGadgetWidget::setTerrainPagerThreads(int arg)
+{
+    if (m_terrainPagerThreads != arg) {
+        m_terrainPagerThreads = arg;
+        emit terrainPagerThreadsChanged(arg);
+    }
+}
+
 //Switch between PositionActual UAVObject position
 //and pre-defined latitude/longitude/altitude properties
 void PfdQmlGadgetWidget::setActualPositionUsed(bool arg)
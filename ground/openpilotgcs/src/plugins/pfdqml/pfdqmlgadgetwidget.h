@@ -20,11 +20,16 @@
 #include "pfdqmlgadgetconfiguration.h"
 #include <QtDeclarative/qdeclarativeview.h>
 
+class UAVObjectInterest;
+
 class PfdQmlGadgetWidget : public QDeclarativeView
 {
     Q_OBJECT
     Q_PROPERTY(QString earthFile READ earthFile WRITE setEarthFile NOTIFY earthFileChanged)
     Q_PROPERTY(bool terrainEnabled READ terrainEnabled WRITE setTerrainEnabled NOTIFY terrainEnabledChanged)
+    Q_PROPERTY(double terrainLodScale READ terrainLodScale WRITE setTerrainLodScale NOTIFY terrainLodScaleChanged)
+    Q_PROPERTY(int terrainTileBudget READ terrainTileBudget WRITE setTerrainTileBudget NOTIFY terrainTileBudgetChanged)
+    Q_PROPERTY(int terrainPagerThreads READ terrainPagerThreads WRITE setTerrainPagerThreads NOTIFY terrainPagerThreadsChanged)
 
     Q_PROPERTY(bool actualPositionUsed READ actualPositionUsed WRITE setActualPositionUsed NOTIFY actualPositionUsedChanged)
 
@@ -40,6 +45,9 @@ public:
 
     QString earthFile() const { return m_earthFile; }
     bool terrainEnabled() const { return m_terrainEnabled && m_openGLEnabled; }
+    double terrainLodScale() const { return m_terrainLodScale; }
+    int terrainTileBudget() const { return m_terrainTileBudget; }
+    int terrainPagerThreads() const { return m_terrainPagerThreads; }
 
     bool actualPositionUsed() const { return m_actualPositionUsed; }
     double latitude() const { return m_latitude; }
@@ -50,6 +58,9 @@ public slots:
     void setEarthFile(QString arg);
     void setTerrainEnabled(bool arg);
     void setOpenGLEnabled(bool arg);
+    void setTerrainLodScale(double arg);
+    void setTerrainTileBudget(int arg);
+    void setTerrainPagerThreads(int arg);
 
     void setLatitude(double arg);
     void setLongitude(double arg);
@@ -60,6 +71,9 @@ public slots:
 signals:
     void earthFileChanged(QString arg);
     void terrainEnabledChanged(bool arg);
+    void terrainLodScaleChanged(double arg);
+    void terrainTileBudgetChanged(int arg);
+    void terrainPagerThreadsChanged(int arg);
 
     void actualPositionUsedChanged(bool arg);
     void latitudeChanged(double arg);
@@ -71,11 +85,17 @@ private:
     QString m_earthFile;
     bool m_openGLEnabled;
     bool m_terrainEnabled;
+    double m_terrainLodScale;
+    int m_terrainTileBudget;
+    int m_terrainPagerThreads;
 
     bool m_actualPositionUsed;
     double m_latitude;
     double m_longitude;
     double m_altitude;
+
+    // The objects exported to QML, shown while the PFD is visible
+    UAVObjectInterest *m_interest;
 };
 
 #endif /* PFDQMLGADGETWIDGET_H_ */
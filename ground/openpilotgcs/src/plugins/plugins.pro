@@ -37,6 +37,7 @@ plugin_rawhid.depends = plugin_coreplugin
 SUBDIRS += plugin_serial
 plugin_serial.subdir = serialconnection
 plugin_serial.depends = plugin_coreplugin
+plugin_serial.depends += plugin_rawhid
 
 # UAVObjects plugin
 SUBDIRS += plugin_uavobjects
@@ -212,6 +213,32 @@ plugin_magicwaypoint.depends = plugin_coreplugin
 plugin_magicwaypoint.depends = plugin_uavobjects
 SUBDIRS += plugin_magicwaypoint
 
+# Event trace gadget
+plugin_eventtrace.subdir = eventtrace
+plugin_eventtrace.depends = plugin_coreplugin
+plugin_eventtrace.depends += plugin_uavobjects
+SUBDIRS += plugin_eventtrace
+
+# Firmware benchmark gadget
+plugin_benchmark.subdir = benchmark
+plugin_benchmark.depends = plugin_coreplugin
+plugin_benchmark.depends += plugin_uavobjects
+plugin_benchmark.depends += plugin_uavobjectutil
+SUBDIRS += plugin_benchmark
+
+# Telemetry link usage gadget
+plugin_linkusage.subdir = linkusage
+plugin_linkusage.depends = plugin_coreplugin
+plugin_linkusage.depends += plugin_uavobjects
+plugin_linkusage.depends += plugin_uavtalk
+SUBDIRS += plugin_linkusage
+
+# Flight plan gadget
+plugin_flightplan.subdir = flightplan
+plugin_flightplan.depends = plugin_coreplugin
+plugin_flightplan.depends += plugin_uavobjects
+SUBDIRS += plugin_flightplan
+
 # UAV Settings Import/Export plugin
 plugin_uavsettingsimportexport.subdir = uavsettingsimportexport
 plugin_uavsettingsimportexport.depends = plugin_coreplugin
@@ -37,14 +37,34 @@
 #include <QFileDialog>
 #include <QList>
 #include <QErrorMessage>
-#include <QWriteLocker>
 #include <QDateTime>
+#include <QTime>
+#include <QtEndian>
 
 #include <extensionsystem/pluginmanager.h>
 #include <QKeySequence>
 
 
 
+// Reports kept in the ring before they are written out, and the longest
+// they wait there
+#define RING_REPORTS 256
+#define FLUSH_MS 1000
+// Bound on the rate of the progress updates to the GUI
+#define PROGRESS_MS 500
+// The transfer is over when no report arrives for this long
+#define RECEIVE_TIMEOUT_MS 3500
+// Receive timeout of one poll, so a stop request is seen quickly
+#define RECEIVE_POLL_MS 250
+// Length of the data reports
+#define DATA_REPORT_LEN 0x29
+
+PowerlogThread::PowerlogThread() :
+    stopRequested(0),
+    binary(false)
+{
+}
+
 /**
   * Sets the file to use for logging and takes the parent plugin
   * to connect to stop logging signal
@@ -54,8 +74,9 @@
 bool PowerlogThread::openFile(QString file, PowerlogPlugin * parent)
 {
     logFile.setFileName(file);
-    logFile.open(QIODevice::WriteOnly);
-    fileStream.setDevice(&logFile);
+    if (!logFile.open(QIODevice::WriteOnly))
+        return false;
+    binary = file.endsWith(".bin", Qt::CaseInsensitive);
 
     connect(parent,SIGNAL(stopLoggingSignal()),this,SLOT(stopLogging()));
 
@@ -78,152 +99,125 @@ void PowerlogThread::run()
         numDevices = hidHandle.open(1,0x0483,0,0,0);
 
     qDebug() << numDevices << " device(s) opened";
-    if (numDevices == 0)
+    if (numDevices == 0) {
+        logFile.close();
         return;
-
-    //hidHandle.mytest(0);
-
-    char buf[BUF_LEN];
-    buf[0] = 2;
-    buf[1] = 0;
-
-    fileStream << "Interval,Current,Volt,Cap,Cell1,Cell2,Cell3,Cell4,Cell5,Cell6,RPM,Temp0,Temp1,Temp2,Temp3,Period,Pulse\n";
-
-    while (int received = hidHandle.receive(0, buf, BUF_LEN, 3500) ) {
-        ShowInf(buf);
-        fileStream.flush(); // Just to be sure...
     }
 
-    stopLogging();
+    if (!binary)
+        logFile.write("Interval,Current,Volt,Cap,Cell1,Cell2,Cell3,Cell4,Cell5,Cell6,RPM,Temp0,Temp1,Temp2,Temp3,Period,Pulse\n");
+
+    char ring[RING_REPORTS * BUF_LEN];
+    int count = 0;
+    int records = 0;
+    int idle = 0;
+    QTime flushTime;
+    QTime progressTime;
+    flushTime.start();
+    progressTime.start();
+    while (!stopRequested) {
+        int received = hidHandle.receive(0, &ring[count * BUF_LEN], BUF_LEN, RECEIVE_POLL_MS);
+        if (received < 0)
+            break;
+        if (received == 0) {
+            idle += RECEIVE_POLL_MS;
+            if (idle >= RECEIVE_TIMEOUT_MS)
+                break;
+        } else {
+            idle = 0;
+            ++count;
+            ++records;
+        }
+        if (count == RING_REPORTS || (count > 0 && flushTime.elapsed() >= FLUSH_MS)) {
+            writeReports(ring, count);
+            count = 0;
+            flushTime.restart();
+        }
+        if (progressTime.elapsed() >= PROGRESS_MS) {
+            emit progress(records);
+            progressTime.restart();
+        }
+    }
 
+    writeReports(ring, count);
+    logFile.close();
+    emit progress(records);
 }
 
 /**
-  * Pass this command to the correct thread then close the file
+  * Ask the thread to stop, it writes what it received and closes the file
   */
 void PowerlogThread::stopLogging()
 {
-    QWriteLocker locker(&lock);
-    fileStream.flush();
-    logFile.close();
-    quit();
+    stopRequested = 1;
 }
 
 /**
-  * Formats the content of the buffer we just read and write
-  * to the logfile
+  * Write a block of reports with a single write
   */
-void PowerlogThread::ShowInf(char *pBuf)
+void PowerlogThread::writeReports(const char *reports, int count)
 {
-    POWERLOG_HID_PACK Inf;
-    int i;
-    int Count;
-
-    Count=0;
-    Inf.Len = pBuf[Count];
-    Count += sizeof(Inf.Len);
-
-    Inf.Type = pBuf[Count];
-    Count += sizeof(Inf.Type);
-
-    Inf.Interval = *((DWORD *)&pBuf[Count]);
-    fileStream << QString::number(Inf.Interval) << ",";
-
-    Count += sizeof(Inf.Interval);
-
-    Inf.LogState = pBuf[Count];
-    Count += sizeof(Inf.LogState);
-
-    if(((Inf.Type == TYPE_DATA_ONLINE)||(Inf.Type == TYPE_DATA_OFFLINE)) && (Inf.Len == 0x29))//0x27
-    {
-        Inf.Current = *((SHORT *)&pBuf[Count]);
-        Count += sizeof(Inf.Current);
-        GetShowValue(QString("Current"),Inf.Current,5,2);
-
-        Inf.Volt = *((USHORT *)&pBuf[Count]);
-        Count += sizeof(Inf.Volt);
-        GetShowValue(QString("Voltage"),Inf.Volt,5,2);
-
-        Inf.Cap = *((DWORD *)&pBuf[Count]);
-        Count += sizeof(Inf.Cap);
-        GetShowValue(QString("Cap"),Inf.Cap,6,0);
-
-        for(i=0;i<6;i++)
-        {
-                Inf.Cell[i] = *((SHORT *)&pBuf[Count]);
-                Count += sizeof(Inf.Cell[i]);
-        }
-        GetShowValue(QString("Cell 1"),Inf.Cell[0],5,3);
-        GetShowValue(QString("Cell 2"),Inf.Cell[1],5,3);
-        GetShowValue(QString("Cell 3"),Inf.Cell[2],5,3);
-        GetShowValue(QString("Cell 4"),Inf.Cell[3],5,3);
-        GetShowValue(QString("Cell 5"),Inf.Cell[4],5,3);
-        GetShowValue(QString("Cell 6"),Inf.Cell[5],5,3);
-
-        Inf.RPM = *((USHORT *)&pBuf[Count]);
-        Count += sizeof(Inf.RPM);
-        GetShowValue(QString("RPM"),Inf.RPM,6,0);
-
-        for(i=0;i<4;i++)
-        {
-                Inf.Temp[i] = *((SHORT *)&pBuf[Count]);
-                Count += sizeof(Inf.Temp[i]);
-
-        }
-        GetShowValue(QString("Int Temp0"),Inf.Temp[0],4,1);
-
-        if (Inf.Temp[1]==0x7fff)
-                fileStream << "0.0,";
-        else
-                GetShowValue(QString("Ext temp1"),Inf.Temp[1],4,1);
-
-        if (Inf.Temp[2]==0x7fff)
-            fileStream << "0.0,";
-        else
-            GetShowValue(QString("Ext temp2"),Inf.Temp[2],4,1);
-
-        if (Inf.Temp[3]==0x7fff)
-            fileStream << "0.0,";
-        else
-            GetShowValue(QString("Ext temp3"),Inf.Temp[3],4,1);
-
-        Inf.Period = *((USHORT *)&pBuf[Count]);
-        Count += sizeof(Inf.Period);
-        GetShowValue(QString("Period:"),Inf.Period,6,0);
-
-        Inf.Pulse = *((USHORT *)&pBuf[Count]);
-        Count += sizeof(Inf.Pulse);
-        GetShowValue(QString("Pulse:"),Inf.Pulse,6,0);
-
-        fileStream << "\n";
+    if (count == 0)
+        return;
+    if (binary) {
+        logFile.write(reports, count * BUF_LEN);
+        return;
     }
+    QByteArray out;
+    out.reserve(count * 128);
+    for (int n = 0; n < count; ++n)
+        formatRecord((const uchar *)&reports[n * BUF_LEN], out);
+    logFile.write(out);
 }
 
 /**
-  * Formats a numeric value
+  * Formats a data report as a CSV line, other reports are skipped
+  *
+  * Layout, little endian: Len, Type, Interval (32 bit), LogState, Current,
+  * Volt, Cap (32 bit), Cell[6], RPM, Temp[4], Period, Pulse (16 bit)
   */
-void PowerlogThread::GetShowValue(QString label, DWORD Value, WORD Len, WORD Dot)
+void PowerlogThread::formatRecord(const uchar *report, QByteArray &out)
 {
-    QString out;
+    if (((report[1] != TYPE_DATA_ONLINE) && (report[1] != TYPE_DATA_OFFLINE)) || (report[0] != DATA_REPORT_LEN))
+        return;
 
-    if (Value < 0) {
-        fileStream << "-";
-        Value = -Value;
+    appendValue(out, qFromLittleEndian<quint32>(&report[2]), 0);
+    appendValue(out, qFromLittleEndian<qint16>(&report[7]), 2);    // Current
+    appendValue(out, qFromLittleEndian<quint16>(&report[9]), 2);   // Volt
+    appendValue(out, qFromLittleEndian<quint32>(&report[11]), 0);  // Cap
+    for (int i = 0; i < 6; i++)
+        appendValue(out, qFromLittleEndian<qint16>(&report[15 + 2*i]), 3);
+    appendValue(out, qFromLittleEndian<quint16>(&report[27]), 0);  // RPM
+    for (int i = 0; i < 4; i++) {
+        qint16 temp = qFromLittleEndian<qint16>(&report[29 + 2*i]);
+        // External sensors not fitted read 0x7fff
+        appendValue(out, (i > 0 && temp == 0x7fff) ? 0 : temp, 1);
     }
+    appendValue(out, qFromLittleEndian<quint16>(&report[37]), 0); // Period
+    appendValue(out, qFromLittleEndian<quint16>(&report[39]), 0); // Pulse
 
-    if(Dot==1)
-            fileStream << Value/10 << "." << Value%10;   // printf("%ld.%01lu",Value/10,Value%10);
-    else if(Dot==2)
-            fileStream << Value/100 << "." << Value%100; // printf("%ld.%02lu",Value/100,Value%100);
-    else if(Dot==3)
-            fileStream << Value/1000 << "." << Value%1000; // printf("%ld.%03lu",Value/1000,Value%1000);
-    else if(Dot==4)
-            fileStream << Value/10000 << "." << Value%10000; // printf("%ld.%04lu",Value/10000,Value%10000);
-    else
-            fileStream << Value; // printf("%ld",Value);
+    out[out.size() - 1] = '\n';
+}
 
-    fileStream << out << ",";
+/**
+  * Appends a fixed point value with dot decimals and a separator
+  */
+void PowerlogThread::appendValue(QByteArray &out, qint32 value, int dot)
+{
+    static const qint32 scale[] = { 1, 10, 100, 1000 };
 
+    if (value < 0) {
+        out += '-';
+        value = -value;
+    }
+    out += QByteArray::number(value / scale[dot]);
+    if (dot > 0) {
+        QByteArray fraction = QByteArray::number(value % scale[dot]);
+        out += '.';
+        out += QByteArray(dot - fraction.size(), '0');
+        out += fraction;
+    }
+    out += ',';
 }
 
 
@@ -294,20 +288,45 @@ void PowerlogPlugin::receiveLog()
     } else {
         QString fileName = QFileDialog::getSaveFileName(NULL, tr("Log filename"),
                                     tr("PowerLog-%0.csv").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss")),
-                                    tr("Comma Separated Values (*.csv)"));
+                                    tr("Comma Separated Values (*.csv);;Raw PowerLog reports (*.bin)"));
         if (fileName.isEmpty())
             return;
 
         loggingThread = new PowerlogThread();
         if (loggingThread->openFile(fileName,this)) {
+            connect(loggingThread, SIGNAL(progress(int)), this, SLOT(logProgress(int)));
+            connect(loggingThread, SIGNAL(finished()), this, SLOT(logFinished()));
             loggingThread->start();
             cmd->action()->setText("Stop PowerLog6S reception");
             logging = true;
+        } else {
+            delete loggingThread;
+            loggingThread = NULL;
         }
     }
 
 }
 
+/**
+  * Progress from the logging thread, at most a few times a second
+  */
+void PowerlogPlugin::logProgress(int records)
+{
+    if (logging)
+        cmd->action()->setText(tr("Stop PowerLog6S reception (%1 records)").arg(records));
+}
+
+void PowerlogPlugin::logFinished()
+{
+    PowerlogThread *thread = qobject_cast<PowerlogThread *>(sender());
+    thread->deleteLater();
+    if (thread != loggingThread)
+        return;
+    loggingThread = NULL;
+    logging = false;
+    cmd->action()->setText("Receive from PowerLog6S...");
+}
+
 /**
   Device connected, check whether it is a powerlog & act accordingly
   */
@@ -36,7 +36,7 @@
 #include "rawhid/pjrc_rawhid.h"
 
 #include <QThread>
-#include <QReadWriteLock>
+#include <QAtomicInt>
 #include <QFile>
 
 using namespace std;
@@ -79,27 +79,35 @@ enum
 
 class PowerlogPlugin;
 
+/**
+  * Receives the reports of the PowerLog into a ring and writes them out in
+  * blocks, as CSV or, for .bin files, as the raw reports. The file is only
+  * touched by this thread.
+  */
 class PowerlogThread : public QThread
 {
     Q_OBJECT
 
 public:
+    PowerlogThread();
     bool openFile(QString file, PowerlogPlugin * parent);
 
-private slots:
+signals:
+    void progress(int records);
 
 public slots:
     void stopLogging();
 
 protected:
     void run();
-    QReadWriteLock lock;
     QFile logFile;
-    QTextStream fileStream;
 
 private:
-    void ShowInf(char *pBuf);
-    void GetShowValue(QString label,DWORD Value,WORD Len,WORD Dot);
+    void writeReports(const char *reports, int count);
+    void formatRecord(const uchar *report, QByteArray &out);
+    void appendValue(QByteArray &out, qint32 value, int dot);
+    QAtomicInt stopRequested;
+    bool binary;
 };
 
 
@@ -128,6 +136,8 @@ private slots:
     void receiveLog();
     void devConnected(USBPortInfo);
     void devRemoved(USBPortInfo);
+    void logProgress(int records);
+    void logFinished();
 
 private:
     Core::Command* cmd;
@@ -30,6 +30,7 @@
 #include "extensionsystem/pluginmanager.h"
 #include "uavobjectmanager.h"
 #include "uavobject.h"
+#include "uavobjectinterest.h"
 #include "utils/svgimageprovider.h"
 
 #include <QDebug>
@@ -42,7 +43,8 @@
 #include <QtDeclarative/qdeclarativecontext.h>
 
 QmlViewGadgetWidget::QmlViewGadgetWidget(QWidget *parent) :
-    QDeclarativeView(parent)
+    QDeclarativeView(parent),
+    m_interest(new UAVObjectInterest(this))
 {
     setMinimumSize(64,64);
     setSizePolicy(QSizePolicy::MinimumExpanding, QSizePolicy::MinimumExpanding);
@@ -61,9 +63,10 @@ QmlViewGadgetWidget::QmlViewGadgetWidget(QWidget *parent) :
 
     foreach (const QString &objectName, objectsToExport) {
         UAVObject* object = objManager->getObject(objectName);
-        if (object)
+        if (object) {
             engine()->rootContext()->setContextProperty(objectName, object);
-        else
+            m_interest->addObject(object);
+        } else
             qWarning() << "Failed to load object" << objectName;
     }
 
@@ -39,6 +39,7 @@
 #include <QTimer>
 
 class UAVObject;
+class UAVObjectInterest;
 
 class QmlViewGadgetWidget : public QDeclarativeView
 {
@@ -56,5 +57,8 @@ private:
    // Flag to enable better rendering of fonts in OpenGL
    bool beSmooth;
    QString m_fn;
+
+   // The objects exported to QML, shown while the view is visible
+   UAVObjectInterest *m_interest;
 };
 #endif /* QmlViewGADGETWIDGET_H_ */
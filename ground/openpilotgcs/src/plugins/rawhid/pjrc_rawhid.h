@@ -99,7 +99,7 @@ class RAWHID_EXPORT pjrc_rawhid: public QObject
 public:
     pjrc_rawhid();
     ~pjrc_rawhid();
-    int open(int max, int vid, int pid, int usage_page, int usage);
+    int open(int max, int vid, int pid, int usage_page, int usage, const QString &serial = QString());
     int receive(int, void *buf, int len, int timeout);
     void close(int num);
     int send(int num, void *buf, int len, int timeout);
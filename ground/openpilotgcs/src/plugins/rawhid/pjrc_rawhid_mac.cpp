@@ -81,9 +81,10 @@ pjrc_rawhid::~pjrc_rawhid()
   * @param[in] pid Product ID, or -1 if any
   * @param[in] usage_page top level usage page, or -1 if any
   * @param[in] usage top level usage number, or -1 if any
+  * @param[in] serial USB serial number, or empty if any
   * @returns actual number of devices opened
   */
-int pjrc_rawhid::open(int max, int vid, int pid, int usage_page, int usage)
+int pjrc_rawhid::open(int max, int vid, int pid, int usage_page, int usage, const QString &serial)
 {
     CFMutableDictionaryRef dict;
     CFNumberRef num;
@@ -101,7 +102,7 @@ int pjrc_rawhid::open(int max, int vid, int pid, int usage_page, int usage)
         return 0;
     }
 
-    if (vid > 0 || pid > 0 || usage_page > 0 || usage > 0) {
+    if (vid > 0 || pid > 0 || usage_page > 0 || usage > 0 || !serial.isEmpty()) {
         // Tell the HID Manager what type of devices we want
         dict = CFDictionaryCreateMutable(kCFAllocatorDefault, 0,
                                          &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
@@ -126,6 +127,12 @@ int pjrc_rawhid::open(int max, int vid, int pid, int usage_page, int usage)
             CFDictionarySetValue(dict, CFSTR(kIOHIDPrimaryUsageKey), num);
             CFRelease(num);
         }
+        if (!serial.isEmpty()) {
+            // Only the board asked for when several are plugged in
+            CFStringRef sn = CFStringCreateWithCString(kCFAllocatorDefault, serial.toUtf8().constData(), kCFStringEncodingUTF8);
+            CFDictionarySetValue(dict, CFSTR(kIOHIDSerialNumberKey), sn);
+            CFRelease(sn);
+        }
         IOHIDManagerSetDeviceMatching(hid_manager, dict);
         CFRelease(dict);
     } else {
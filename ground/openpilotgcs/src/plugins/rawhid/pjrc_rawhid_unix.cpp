@@ -58,10 +58,11 @@ pjrc_rawhid::~pjrc_rawhid()
 //	pid = Product ID, or -1 if any
 //	usage_page = top level usage page, or -1 if any
 //	usage = top level usage number, or -1 if any
+//	serial = USB serial number, or empty if any
 //    Output:
 //	actual number of devices opened
 //
-int pjrc_rawhid::open(int max, int vid, int pid, int usage_page, int usage)
+int pjrc_rawhid::open(int max, int vid, int pid, int usage_page, int usage, const QString &serial)
 {
 	struct usb_bus *bus;
 	struct usb_device *dev;
@@ -98,6 +99,19 @@ int pjrc_rawhid::open(int max, int vid, int pid, int usage_page, int usage)
 			iface = dev->config->interface;
 			u = NULL;
 			claimed = 0;
+			if (!serial.isEmpty())
+			{
+				// Only the board asked for when several are plugged in
+				u = usb_open(dev);
+				if (!u) continue;
+				if (!dev->descriptor.iSerialNumber ||
+					usb_get_string_simple(u, dev->descriptor.iSerialNumber, (char *)buf, sizeof(buf)) < 0 ||
+					serial != QString::fromAscii((char *)buf))
+				{
+					usb_close(u);
+					continue;
+				}
+			}
 			for (i=0; i<dev->config->bNumInterfaces && iface; i++, iface++)
 			{
 				desc = iface->altsetting;
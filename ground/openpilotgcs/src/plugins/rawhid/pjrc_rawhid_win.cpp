@@ -63,10 +63,11 @@ pjrc_rawhid::~pjrc_rawhid()
 //      pid = Product ID, or -1 if any
 //      usage_page = top level usage page, or -1 if any
 //      usage = top level usage number, or -1 if any
+//      serial = USB serial number, or empty if any
 //    Output:
 //      actual number of devices opened
 //
-int pjrc_rawhid::open(int max, int vid, int pid, int usage_page, int usage)
+int pjrc_rawhid::open(int max, int vid, int pid, int usage_page, int usage, const QString &serial)
 {
         GUID guid;
         HDEVINFO info;
@@ -163,6 +164,18 @@ int pjrc_rawhid::open(int max, int vid, int pid, int usage_page, int usage)
 
                 HidD_FreePreparsedData(hid_data);
 
+                if (!serial.isEmpty())
+                {
+                        // Only the board asked for when several are plugged in
+                        wchar_t sn[128];
+                        if (!HidD_GetSerialNumberString(h, sn, sizeof(sn)) ||
+                            serial != QString::fromWCharArray(sn))
+                        {
+                                CloseHandle(h);
+                                continue;
+                        }
+                }
+
                 hid = (struct hid_struct *)malloc(sizeof(struct hid_struct));
                 if (!hid)
                 {
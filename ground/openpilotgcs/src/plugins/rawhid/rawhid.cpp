@@ -34,6 +34,7 @@
 #include <QList>
 #include <QMutexLocker>
 #include <QWaitCondition>
+#include <QAtomicInt>
 
 class IConnection;
 
@@ -46,6 +47,62 @@ static const int WRITE_SIZE = 64;
 
 
 
+// *********************************************************************************
+
+/**
+*   Lock free ring between the read thread, its only writer, and the
+*   thread reading the device, its only reader. Each side only moves
+*   its own index and publishes it once the bytes are copied.
+*/
+class RawHIDReadRing
+{
+public:
+    RawHIDReadRing() : m_head(0), m_tail(0) {}
+
+    /** Number of bytes that can be read */
+    int available()
+    {
+        return (unsigned)m_tail.fetchAndAddAcquire(0) - (unsigned)m_head.fetchAndAddAcquire(0);
+    }
+
+    /** Append a whole report, false if it does not fit */
+    bool write(const char *data, int size)
+    {
+        unsigned head = m_head.fetchAndAddAcquire(0);
+        unsigned tail = m_tail;
+        if (tail - head + size > (unsigned)Capacity)
+            return false;
+
+        int pos = tail & Mask;
+        int first = qMin(size, Capacity - pos);
+        memcpy(m_data + pos, data, first);
+        memcpy(m_data, data + first, size - first);
+        m_tail.fetchAndStoreRelease(tail + size);
+        return true;
+    }
+
+    /** Take up to size bytes from the front */
+    int read(char *data, int size)
+    {
+        unsigned tail = m_tail.fetchAndAddAcquire(0);
+        unsigned head = m_head;
+        size = qMin(size, (int)(tail - head));
+
+        int pos = head & Mask;
+        int first = qMin(size, Capacity - pos);
+        memcpy(data, m_data + pos, first);
+        memcpy(data + first, m_data, size - first);
+        m_head.fetchAndStoreRelease(head + size);
+        return size;
+    }
+
+private:
+    enum { Capacity = 32768, Mask = Capacity - 1 };
+    char m_data[Capacity];
+    QAtomicInt m_head;
+    QAtomicInt m_tail;
+};
+
 // *********************************************************************************
 
 /**
@@ -63,6 +120,9 @@ public:
     /** return the bytes buffered */
     qint64 getBytesAvailable();
 
+    /** Allow the next report to post another readyRead notification */
+    void rearmReadyRead();
+
 public slots:
     void terminate() {
         m_running = false;
@@ -71,12 +131,15 @@ public slots:
 protected:
     void run();
 
-    /** QByteArray might not be the most efficient way to implement
-    a circular buffer but it's good enough and very simple */
-    QByteArray m_readBuffer;
+    /** Reports received and not read yet */
+    RawHIDReadRing m_readRing;
 
-    /** A mutex to protect read buffer */
-    QMutex m_readBufMtx;
+    /** Set while a readyRead notification is queued to the device's thread,
+    so there is one signal per event loop pass rather than one per report */
+    QAtomicInt m_readyReadPending;
+
+    /** Reports dropped because the reader fell behind */
+    int m_overflows;
 
     RawHID *m_hid;
 
@@ -136,7 +199,9 @@ RawHIDReadThread::RawHIDReadThread(RawHID *hid)
     : m_hid(hid),
     hiddev(&hid->dev),
     hidno(hid->m_deviceNo),
-    m_running(true)
+    m_running(true),
+    m_readyReadPending(0),
+    m_overflows(0)
 {
     hid->m_startedMutex->lock();
 }
@@ -167,12 +232,14 @@ void RawHIDReadThread::run()
 
         if(ret > 0) //read some data
         {
-            QMutexLocker lock(&m_readBufMtx);
             // Note: Preprocess the USB packets in this OS independent code
             // First byte is report ID, second byte is the number of valid bytes
-            m_readBuffer.append(&buffer[2], buffer[1]);
+            int size = qMin((int)(unsigned char)buffer[1], READ_SIZE - 2);
+            if (!m_readRing.write(&buffer[2], size) && (m_overflows++ % 100) == 0)
+                qDebug() << "RawHID read buffer full, reports dropped:" << m_overflows;
 
-            emit m_hid->readyRead();
+            if (m_readyReadPending.testAndSetOrdered(0, 1))
+                QMetaObject::invokeMethod(m_hid, "notifyReadyRead", Qt::QueuedConnection);
         }
         else if(ret == 0) //nothing read
         {
@@ -188,20 +255,17 @@ void RawHIDReadThread::run()
 
 int RawHIDReadThread::getReadData(char *data, int size)
 {
-    QMutexLocker lock(&m_readBufMtx);
-
-    size = qMin(size, m_readBuffer.size());
-
-    memcpy(data, m_readBuffer.constData(), size);
-    m_readBuffer.remove(0, size);
+    return m_readRing.read(data, size);
+}
 
-    return size;
+void RawHIDReadThread::rearmReadyRead()
+{
+    m_readyReadPending.fetchAndStoreOrdered(0);
 }
 
 qint64 RawHIDReadThread::getBytesAvailable()
 {
-    QMutexLocker lock(&m_readBufMtx);
-    return m_readBuffer.size();
+    return m_readRing.available();
 }
 
 RawHIDWriteThread::RawHIDWriteThread(RawHID *hid)
@@ -432,6 +496,25 @@ qint64 RawHID::bytesAvailable() const
 	return m_readThread->getBytesAvailable() + QIODevice::bytesAvailable();
 }
 
+/**
+ * @brief RawHID::notifyReadyRead Queued from the read thread when reports
+ * arrive. The notification is rearmed before checking for data so that a
+ * report arriving meanwhile queues another one, whether or not the consumer
+ * reads everything in its readyRead handler.
+ */
+void RawHID::notifyReadyRead()
+{
+    {
+        QMutexLocker locker(m_mutex);
+        if (!m_readThread)
+            return;
+        m_readThread->rearmReadyRead();
+    }
+
+    if (bytesAvailable() > 0)
+        emit readyRead();
+}
+
 qint64 RawHID::bytesToWrite() const
 {
 	QMutexLocker locker(m_mutex);
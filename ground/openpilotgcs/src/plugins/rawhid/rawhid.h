@@ -68,6 +68,9 @@ signals:
 public slots:
 	void onDeviceUnplugged(int num);
 
+private slots:
+	void notifyReadyRead();
+
 protected:
     virtual qint64 readData(char *data, qint64 maxSize);
     virtual qint64 writeData(const char *data, qint64 maxSize);
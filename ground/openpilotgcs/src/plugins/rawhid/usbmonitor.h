@@ -148,6 +148,12 @@ signals:
       \param info The device that was disconnected.
     */
     void deviceRemoved( const USBPortInfo & info );
+    /*!
+      Something was plugged in or removed, including the serial ports that are
+      not reported by deviceDiscovered() and deviceRemoved(). Emitted once per
+      event the OS sends, so a single plug can emit it several times.
+    */
+    void devicesChanged();
 
 private slots:
     /**
@@ -172,9 +178,11 @@ private:
 #if defined( Q_OS_MAC)
     static void attach_callback(void *context, IOReturn r, void *hid_mgr, IOHIDDeviceRef dev);
     static void detach_callback(void *context, IOReturn r, void *hid_mgr, IOHIDDeviceRef dev);
+    static void serial_callback(void *context, io_iterator_t iterator);
     void addDevice(USBPortInfo info);
     void removeDevice(IOHIDDeviceRef dev);
     IOHIDManagerRef hid_manager;
+    IONotificationPortRef serial_notify;
 #elif defined(Q_OS_UNIX)
     struct udev *context;
     struct udev_monitor *monitor;
@@ -72,6 +72,8 @@ void USBMonitor::deviceEventReceived() {
         printf("------- Got Device Event");
         QString action = QString(udev_device_get_action(dev));
         QString devtype = QString(udev_device_get_devtype(dev));
+        if (action == "add" || action == "remove")
+            emit devicesChanged();
         if (action == "add" && devtype == "usb_device") {
             printPortInfo(dev);
             emit deviceDiscovered(makePortInfo(dev));
@@ -108,6 +110,9 @@ USBMonitor::USBMonitor(QObject *parent): QThread(parent) {
     this->monitor = udev_monitor_new_from_netlink(this->context, "udev");
     udev_monitor_filter_add_match_subsystem_devtype(
         this->monitor, "usb", NULL);
+    // Serial ports, the tty node shows up after the usb device it belongs to
+    udev_monitor_filter_add_match_subsystem_devtype(
+        this->monitor, "tty", NULL);
     udev_monitor_enable_receiving(this->monitor);
     this->monitorNotifier = new QSocketNotifier(
         udev_monitor_get_fd(this->monitor), QSocketNotifier::Read, this);
@@ -29,6 +29,7 @@
 #include "usbmonitor.h"
 #include <IOKit/IOKitLib.h>
 #include <IOKit/hid/IOHIDLib.h>
+#include <IOKit/serial/IOSerialKeys.h>
 #include <CoreFoundation/CFString.h>
 #include <CoreFoundation/CFArray.h>
 #include <QMutexLocker>
@@ -45,6 +46,7 @@ static bool HID_GetStrProperty(IOHIDDeviceRef dev, CFStringRef property, QString
   */
 USBMonitor::USBMonitor(QObject *parent): QThread(parent) {
     hid_manager=NULL;
+    serial_notify=NULL;
     IOReturn ret;
 
     m_instance = this;
@@ -65,6 +67,18 @@ USBMonitor::USBMonitor(QObject *parent): QThread(parent) {
     IOHIDManagerScheduleWithRunLoop(hid_manager, CFRunLoopGetCurrent(), kCFRunLoopDefaultMode);
     IOHIDManagerRegisterDeviceMatchingCallback(hid_manager, attach_callback, NULL);
     IOHIDManagerRegisterDeviceRemovalCallback(hid_manager, detach_callback, NULL);
+
+    // The HID manager does not see serial adapters, watch the serial ports too
+    serial_notify = IONotificationPortCreate(kIOMasterPortDefault);
+    CFRunLoopAddSource(CFRunLoopGetCurrent(), IONotificationPortGetRunLoopSource(serial_notify), kCFRunLoopDefaultMode);
+    io_iterator_t serial_iterator;
+    if (IOServiceAddMatchingNotification(serial_notify, kIOFirstMatchNotification, IOServiceMatching(kIOSerialBSDServiceValue),
+                                         serial_callback, this, &serial_iterator) == KERN_SUCCESS)
+        serial_callback(NULL, serial_iterator); // arms the notification
+    if (IOServiceAddMatchingNotification(serial_notify, kIOTerminatedNotification, IOServiceMatching(kIOSerialBSDServiceValue),
+                                         serial_callback, this, &serial_iterator) == KERN_SUCCESS)
+        serial_callback(NULL, serial_iterator);
+
     ret = IOHIDManagerOpen(hid_manager, kIOHIDOptionsTypeNone);
     if (ret != kIOReturnSuccess) {
         IOHIDManagerUnscheduleFromRunLoop(hid_manager,
@@ -80,6 +94,8 @@ USBMonitor::~USBMonitor()
 {
     //if(hid_manager != NULL)
     //    IOHIDManagerUnscheduleFromRunLoop(hid_manager, CFRunLoopGetCurrent(), kCFRunLoopDefaultMode);
+    if (serial_notify != NULL)
+        IONotificationPortDestroy(serial_notify);
     quit();
 }
 
@@ -103,6 +119,7 @@ void USBMonitor::removeDevice(IOHIDDeviceRef dev) {
             QMutexLocker locker(listMutex);
             knowndevices.removeAt(i);
             emit deviceRemoved(port);
+            emit devicesChanged();
             return;
         }
     }
@@ -127,6 +144,21 @@ void USBMonitor::addDevice(USBPortInfo info) {
     QMutexLocker locker(listMutex);
     knowndevices.append(info);
     emit deviceDiscovered(info);
+    emit devicesChanged();
+}
+
+/**
+  * @brief Static callback for a serial port added or removed, the iterator
+  * must be drained for the notification to fire again
+  */
+void USBMonitor::serial_callback(void *context, io_iterator_t iterator)
+{
+    io_object_t service;
+    while ((service = IOIteratorNext(iterator)))
+        IOObjectRelease(service);
+    // No context while arming the notifications at start
+    if (context != NULL)
+        emit static_cast<USBMonitor*>(context)->devicesChanged();
 }
 
 void USBMonitor::attach_callback(void *context, IOReturn r, void *hid_mgr, IOHIDDeviceRef dev)
@@ -154,6 +154,8 @@ LRESULT USBMonitor::onDeviceChangeWin( WPARAM wParam, LPARAM lParam )
 {
     if ( DBT_DEVICEARRIVAL == wParam || DBT_DEVICEREMOVECOMPLETE == wParam )
     {
+        // COM port arrivals are broadcast to all top level windows as DBT_DEVTYP_PORT
+        emit devicesChanged();
         PDEV_BROADCAST_HDR pHdr = (PDEV_BROADCAST_HDR)lParam;
         if( pHdr->dbch_devicetype == DBT_DEVTYP_DEVICEINTERFACE )
         {
@@ -0,0 +1,190 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotcsvwriter.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief Background CSV export of the scope curves
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "plotcsvwriter.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <qnumeric.h>
+
+PlotCsvWriter::PlotCsvWriter() :
+    columns(0),
+    startTime(0),
+    stopping(false),
+    droppedRows(0)
+{
+}
+
+PlotCsvWriter::~PlotCsvWriter()
+{
+    close();
+}
+
+bool PlotCsvWriter::open(const QString& fileName, const QByteArray& header, int columns, qint64 startTime)
+{
+    close();
+
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qDebug() << "Unable to open " << fileName << " for csv logging";
+        return false;
+    }
+    file.write(header);
+
+    this->columns = columns;
+    this->startTime = startTime;
+    rows.clear();
+    values.clear();
+    stopping = false;
+    droppedRows = 0;
+    start(QThread::LowPriority);
+    return true;
+}
+
+/*!
+  \brief Write what is still queued and close the file
+  */
+void PlotCsvWriter::close()
+{
+    if (!isRunning())
+        return;
+
+    mutex.lock();
+    stopping = true;
+    ready.wakeOne();
+    mutex.unlock();
+    wait();
+    file.close();
+}
+
+void PlotCsvWriter::append(qint64 time, bool connected, bool updated, const QVector<double>& values)
+{
+    QMutexLocker locker(&mutex);
+    if (rows.size() >= QUEUE_LIMIT || values.size() != columns) {
+        ++droppedRows;
+        return;
+    }
+    Row row;
+    row.time = time;
+    row.connected = connected;
+    row.updated = updated;
+    rows.append(row);
+    this->values += values;
+}
+
+/*!
+  \brief Have the queued rows written now instead of at the next FLUSH_MS
+  */
+void PlotCsvWriter::flush()
+{
+    QMutexLocker locker(&mutex);
+    ready.wakeOne();
+}
+
+void PlotCsvWriter::run()
+{
+    QVector<Row> batchRows;
+    QVector<double> batchValues;
+    QByteArray out;
+    bool done = false;
+    while (!done) {
+        mutex.lock();
+        if (!stopping && rows.isEmpty())
+            ready.wait(&mutex, FLUSH_MS);
+        done = stopping;
+        batchRows.swap(rows);
+        batchValues.swap(values);
+        mutex.unlock();
+
+        if (batchRows.isEmpty())
+            continue;
+        format(batchRows, batchValues, out);
+        if (file.write(out) != out.size())
+            qDebug() << "Unable to write " << file.fileName() << " for csv logging";
+        file.flush();
+        batchRows.resize(0);
+        batchValues.resize(0);
+    }
+}
+
+static inline void appendDigits(QByteArray& out, int value, int digits)
+{
+    char buffer[8];
+    for (int i = digits - 1; i >= 0; --i) {
+        buffer[i] = '0' + value % 10;
+        value /= 10;
+    }
+    out.append(buffer, digits);
+}
+
+/*!
+  \brief Same columns as the scope always wrote: date, time, seconds since start,
+  connected, data changed and the last value of each curve
+  */
+void PlotCsvWriter::format(const QVector<Row>& rows, const QVector<double>& values, QByteArray& out)
+{
+    out.resize(0);
+    out.reserve(rows.size() * (48 + columns * 18));
+
+    // The date only changes at midnight, convert it once per batch and day
+    qint64 dayStart = 0;
+    qint64 dayEnd = 0;
+    QByteArray date;
+    for (int r = 0; r < rows.size(); ++r) {
+        const Row& row = rows.at(r);
+        if (row.time < dayStart || row.time >= dayEnd) {
+            QDateTime now = QDateTime::fromMSecsSinceEpoch(row.time);
+            date = now.date().toString("yyyy-MM-dd").toLatin1();
+            QDateTime midnight(now.date());
+            dayStart = midnight.toMSecsSinceEpoch();
+            dayEnd = midnight.addDays(1).toMSecsSinceEpoch();
+        }
+        qint64 ms = row.time - dayStart;
+
+        out += date;
+        out += ", ";
+        appendDigits(out, ms / 3600000, 2);
+        out += ':';
+        appendDigits(out, ms / 60000 % 60, 2);
+        out += ':';
+        appendDigits(out, ms / 1000 % 60, 2);
+        out += '.';
+        out += QByteArray::number(ms % 1000);
+        out += ", ";
+        out += QByteArray::number((row.time - startTime) / 1000.0, 'g', 10);
+        out += row.connected ? ", 1" : ", 0";
+        out += row.updated ? ", 1" : ", 0";
+
+        const double* value = values.constData() + r * columns;
+        for (int c = 0; c < columns; ++c) {
+            out += ", ";
+            if (!qIsNaN(value[c]))
+                out += QByteArray::number(value[c], 'g', 10);
+        }
+        out += '\n';
+    }
+}
@@ -0,0 +1,87 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotcsvwriter.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief Background CSV export of the scope curves
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef PLOTCSVWRITER_H
+#define PLOTCSVWRITER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QFile>
+#include <QVector>
+#include <QByteArray>
+
+/*!
+  \brief Formats and writes the CSV log of a scope on its own thread.
+  append() only copies the row into a bounded queue, so the scope never waits for
+  the disk. Rows are formatted without QString or the locale and written in batches.
+  */
+class PlotCsvWriter : public QThread
+{
+public:
+    static const int QUEUE_LIMIT = 65536; // Rows, newer rows are dropped beyond this
+    static const int FLUSH_MS = 1000;
+
+    PlotCsvWriter();
+    ~PlotCsvWriter();
+
+    bool open(const QString& fileName, const QByteArray& header, int columns, qint64 startTime);
+    void close();
+    bool isOpen() const { return isRunning(); }
+
+    /*!
+      \brief Queue a row, values has one entry per column, NaN for a curve without samples
+      */
+    void append(qint64 time, bool connected, bool updated, const QVector<double>& values);
+    void flush();
+    quint32 getDroppedRows() const { return droppedRows; }
+
+protected:
+    void run();
+
+private:
+    typedef struct {
+        qint64 time;
+        bool connected;
+        bool updated;
+    } Row;
+
+    QFile file;
+    int columns;
+    qint64 startTime;
+
+    QMutex mutex;
+    QWaitCondition ready;
+    QVector<Row> rows;
+    QVector<double> values;
+    bool stopping;
+    quint32 droppedRows;
+
+    void format(const QVector<Row>& rows, const QVector<double>& values, QByteArray& out);
+};
+
+#endif // PLOTCSVWRITER_H
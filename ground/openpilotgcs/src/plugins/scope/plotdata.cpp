@@ -47,101 +47,92 @@ PlotData::PlotData(QString p_uavObject, QString p_uavField)
         haveSubField = false;
     }
 
-    xData = new QVector<double>();
-    yData = new QVector<double>();
-    yDataHistory = new QVector<double>();
-
-    curve = 0;
+    xData = new PlotRingBuffer<double>();
+    yData = new PlotRingBuffer<double>();
+    envelope = new PlotEnvelope(yData);
+
+    object = 0;
+    field = 0;
+    elementIndex = 0;
+    scale = 1;
     scalePower = 0;
     meanSamples = 1;
-    meanSum = 0.0f;
-//    mathFunction=0;
-    correctionSum = 0.0f;
-    correctionCount = 0;
+    math = 0;
     yMinimum = 0;
     yMaximum = 0;
 
     m_xWindowSize = 0;
+    revision = 0;
 }
 
-double PlotData::valueAsDouble(UAVObject* obj, UAVObjectField* field)
+/*!
+  \brief Resolve the plotted element once, append() then reads it without any lookup
+  */
+bool PlotData::bindField(UAVObject* obj, UAVObjectField* field)
 {
-    Q_UNUSED(obj);
-    QVariant value;
-
-    if(haveSubField){
-        int indexOfSubField = field->getElementNames().indexOf(QRegExp(uavSubField, Qt::CaseSensitive, QRegExp::FixedString));
-        value = field->getValue(indexOfSubField);
-    }else
-        value = field->getValue();
-
-    // qDebug() << "Data  (" << value.typeName() << ") " <<  value.toString();
+    int index = haveSubField ? field->getElementIndex(uavSubField) : 0;
+    if (index < 0) {
+        qDebug() << "Element " << uavSubField << " of field " << uavField << " is missing";
+        return false;
+    }
+    object = obj;
+    this->field = field;
+    elementIndex = index;
+    scale = pow(10, scalePower);
+    return true;
+}
 
-    return value.toDouble();
+double PlotData::fieldValue()
+{
+    return field->getDouble(elementIndex) * scale;
 }
 
 PlotData::~PlotData()
 {
     delete xData;
     delete yData;
-    delete yDataHistory;
+    delete math;
+    delete envelope;
+}
+
+/*!
+  \brief Bytes held by the sample buffers, they keep the capacity they grew to
+  */
+qint64 PlotData::memoryBytes() const
+{
+    qint64 bytes = sizeof(*this);
+    if (xData)
+        bytes += xData->capacity() * sizeof(double);
+    if (yData)
+        bytes += yData->capacity() * sizeof(double);
+    if (envelope)
+        bytes += envelope->memoryBytes();
+    return bytes;
 }
 
 
 bool SequentialPlotData::append(UAVObject* obj)
 {
-    if (uavObject == obj->getName()) {
-
-        //Get the field of interest
-        UAVObjectField* field =  obj->getField(uavField);
+    if (obj == object) {
 
+        //The field of interest was resolved when the curve was added
         if (field) {
 
-            double currentValue = valueAsDouble(obj, field) * pow(10, scalePower);
+            double currentValue = fieldValue();
 
             //Perform scope math, if necessary
-            if (mathFunction  == "Boxcar average" || mathFunction  == "Standard deviation"){
-                //Put the new value at the front
-                yDataHistory->append( currentValue );
-
-                // calculate average value
-                meanSum += currentValue;
-                if(yDataHistory->size() > meanSamples) {
-                    meanSum -= yDataHistory->first();
-                    yDataHistory->pop_front();
-                }
-
-                // make sure to correct the sum every meanSamples steps to prevent it
-                // from running away due to floating point rounding errors
-                correctionSum+=currentValue;
-                if (++correctionCount >= meanSamples) {
-                    meanSum = correctionSum;
-                    correctionSum = 0.0f;
-                    correctionCount = 0;
-                }
-
-                double boxcarAvg=meanSum/yDataHistory->size();
-
-                if ( mathFunction  == "Standard deviation" ){
-                    //Calculate square of sample standard deviation, with Bessel's correction
-                    double stdSum=0;
-                    for (int i=0; i < yDataHistory->size(); i++){
-                        stdSum+= pow(yDataHistory->at(i)- boxcarAvg,2)/(meanSamples-1);
-                    }
-                    yData->append(sqrt(stdSum));
-                }
-                else  {
-                    yData->append(boxcarAvg);
-                }
-            }
-            else{
-                yData->append( currentValue );
-            }
+            if (math)
+                currentValue = math->process(sampleCount, currentValue);
+            ++sampleCount;
+            yData->append(currentValue);
+            envelope->appended();
 
             if (yData->size() > m_xWindowSize) { //If new data overflows the window, remove old data...
-                yData->pop_front();
+                yData->removeFirst();
+                envelope->removed();
             } else //...otherwise, add a new y point at position xData
-                xData->insert(xData->size(), xData->size());
+                xData->append(xData->size());
+            ++revision;
 
             //notify the gui of changes in the data
             //dataChanged();
@@ -154,55 +145,43 @@ bool SequentialPlotData::append(UAVObject* obj)
 
 bool ChronoPlotData::append(UAVObject* obj)
 {
-    if (uavObject == obj->getName()) {
-        //Get the field of interest
-        UAVObjectField* field =  obj->getField(uavField);
-        //qDebug() << "uavObject: " << uavObject << ", uavField: " << uavField;
-
+    if (obj == object) {
+        //The field of interest was resolved when the curve was added
         if (field) {
-            QDateTime NOW = QDateTime::currentDateTime(); //THINK ABOUT REIMPLEMENTING THIS TO SHOW UAVO TIME, NOT SYSTEM TIME
-            double currentValue = valueAsDouble(obj, field) * pow(10, scalePower);
+            //Plot the samples at the time they came off the link, GUI stalls and queued
+            //signals would otherwise bunch them up. Objects set locally fall back to now.
+            qint64 updateTime = obj->getUpdateTime();
+            double valueX;
+            if (updateTime <= 0) {
+                valueX = QDateTime::currentMSecsSinceEpoch() / 1000.0;
+            } else if (updateTime != lastUpdateTime) {
+                prevUpdateTime = lastUpdateTime;
+                prevUpdateSamples = lastUpdateSamples;
+                lastUpdateTime = updateTime;
+                lastUpdateSamples = 1;
+                valueX = updateTime / 1000.0;
+            } else {
+                //Several updates came in the same read. Space them out as the samples of the
+                //previous read were, so the plot stays in link time, but never ahead of now.
+                double step = 0;
+                if (prevUpdateTime > 0)
+                    step = (lastUpdateTime - prevUpdateTime) / (1000.0 * prevUpdateSamples);
+                valueX = qMin(lastUpdateTime / 1000.0 + step * lastUpdateSamples,
+                              QDateTime::currentMSecsSinceEpoch() / 1000.0);
+                ++lastUpdateSamples;
+            }
+            double currentValue = fieldValue();
 
+            if (!xData->isEmpty() && valueX < xData->last())
+                valueX = xData->last();
             //Perform scope math, if necessary
-            if (mathFunction  == "Boxcar average" || mathFunction  == "Standard deviation"){
-                //Put the new value at the back
-                yDataHistory->append( currentValue );
-
-                // calculate average value
-                meanSum += currentValue;
-                if(yDataHistory->size() > meanSamples) {
-                    meanSum -= yDataHistory->first();
-                    yDataHistory->pop_front();
-                }
-                // make sure to correct the sum every meanSamples steps to prevent it
-                // from running away due to floating point rounding errors
-                correctionSum+=currentValue;
-                if (++correctionCount >= meanSamples) {
-                    meanSum = correctionSum;
-                    correctionSum = 0.0f;
-                    correctionCount = 0;
-                }
-
-                double boxcarAvg=meanSum/yDataHistory->size();
-//qDebug()<<mathFunction;
-                if ( mathFunction  == "Standard deviation" ){
-                    //Calculate square of sample standard deviation, with Bessel's correction
-                    double stdSum=0;
-                    for (int i=0; i < yDataHistory->size(); i++){
-                        stdSum+= pow(yDataHistory->at(i)- boxcarAvg,2)/(meanSamples-1);
-                    }
-                    yData->append(sqrt(stdSum));
-                }
-                else  {
-                    yData->append(boxcarAvg);
-                }
-            }
-            else{
-                yData->append( currentValue );
-            }
+            if (math)
+                currentValue = math->process(valueX, currentValue);
+            yData->append(currentValue);
+            envelope->appended();
 
-            double valueX = NOW.toTime_t() + NOW.time().msec() / 1000.0;
             xData->append(valueX);
+            ++revision;
 
             //qDebug() << "Data  " << uavObject << "." << field->getName() << " X,Y:" << valueX << "," <<  valueY;
 
@@ -231,8 +210,10 @@ void ChronoPlotData::removeStaleData()
         oldestValue = xData->first();
 
         if (newestValue - oldestValue > m_xWindowSize) {
-            yData->pop_front();
-            xData->pop_front();
+            yData->removeFirst();
+            envelope->removed();
+            xData->removeFirst();
+            ++revision;
         } else
             break;
     }
@@ -247,6 +228,89 @@ void ChronoPlotData::removeStaleDataTimeout()
     //qDebug() << "removeStaleDataTimeout";
 }
 
+SpectrumPlotData::SpectrumPlotData(QString uavObject, QString uavField, int size, PlotSpectrum::Window window) :
+    PlotData(uavObject, uavField),
+    spectrum(size, window),
+    lastUpdateTime(0),
+    newSamples(0),
+    segments(0),
+    segment(spectrum.size()),
+    power(spectrum.bins()),
+    average(spectrum.bins())
+{
+}
+
+qint64 SpectrumPlotData::memoryBytes() const
+{
+    return PlotData::memoryBytes() + spectrum.memoryBytes() + samples.capacity() * sizeof(double)
+            + sampleTimes.capacity() * sizeof(qint64)
+            + (segment.size() + power.size() + average.size()) * sizeof(double);
+}
+
+bool SpectrumPlotData::append(UAVObject* obj)
+{
+    if (obj == object) {
+        //The field of interest was resolved when the curve was added
+        if (field) {
+            qint64 updateTime = obj->getUpdateTime();
+            if (updateTime > 0 && updateTime != lastUpdateTime)
+                lastUpdateTime = updateTime;
+            else
+                updateTime = QDateTime::currentMSecsSinceEpoch();
+            double currentValue = fieldValue();
+
+            //Perform scope math, if necessary
+            if (math)
+                currentValue = math->process(updateTime / 1000.0, currentValue);
+
+            samples.append(currentValue);
+            sampleTimes.append(updateTime);
+            if (samples.size() > spectrum.size()) {
+                samples.removeFirst();
+                sampleTimes.removeFirst();
+            }
+
+            if (samples.size() == spectrum.size() && ++newSamples >= spectrum.size() / 2) {
+                newSamples = 0;
+                updateSpectrum();
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!
+  \brief Transform the current window and replace the curve with the averaged spectrum
+  */
+void SpectrumPlotData::updateSpectrum()
+{
+    qint64 span = sampleTimes.last() - sampleTimes.first();
+    if (span <= 0)
+        return;
+    double sampleRate = (samples.size() - 1) * 1000.0 / span;
+
+    for (int i = 0; i < samples.size(); ++i)
+        segment[i] = samples.at(i);
+    spectrum.power(segment.constData(), sampleRate, power.data());
+
+    if (segments < AVERAGED_SEGMENTS)
+        ++segments;
+    for (int k = 0; k < power.size(); ++k)
+        average[k] += (power[k] - average[k]) / segments;
+
+    xData->clear();
+    yData->clear();
+    envelope->clear();
+    for (int k = 0; k < average.size(); ++k) {
+        xData->append(k * sampleRate / spectrum.size());
+        yData->append(10 * log10(average[k] + 1e-20));
+        envelope->appended();
+    }
+    ++revision;
+}
+
 bool UAVObjectPlotData::append(UAVObject* obj)
 {
     Q_UNUSED(obj);
@@ -29,6 +29,9 @@
 #define PLOTDATA_H
 
 #include "uavobject.h"
+#include "plotenvelope.h"
+#include "plotmath.h"
+#include "plotspectrum.h"
 
 #include "qwt/src/qwt.h"
 #include "qwt/src/qwt_plot.h"
@@ -47,6 +50,7 @@ enum PlotType {
     SequentialPlot,
     ChronoPlot,
     UAVObjectPlot,
+    SpectrumPlot,
 
     NPlotTypes
 };
@@ -68,26 +72,32 @@ public:
     bool haveSubField;
     int scalePower; //This is the power to which each value must be raised
     int meanSamples;
-    double meanSum;
     QString mathFunction;
-    double correctionSum;
-    int correctionCount;
+    PlotMath* math; // Resolved from mathFunction when the curve is set up
     double yMinimum;
     double yMaximum;
     double m_xWindowSize;
-    QwtPlotCurve* curve;
-    QVector<double>* xData;
-    QVector<double>* yData;
-    QVector<double>* yDataHistory;
+    PlotRingBuffer<double>* xData;
+    PlotRingBuffer<double>* yData;
+    PlotEnvelope* envelope;
+
+    quint32 revision; // Changes whenever xData or yData change
 
     virtual bool append(UAVObject* obj) = 0;
     virtual PlotType plotType() = 0;
     virtual void removeStaleData() = 0;
+    virtual qint64 memoryBytes() const;
 
-    void updatePlotCurveData();
+    bool bindField(UAVObject* obj, UAVObjectField* field);
+    UAVObject* getObject() const { return object; }
 
 protected:
-    double valueAsDouble(UAVObject* obj, UAVObjectField* field);
+    UAVObject* object;
+    UAVObjectField* field;
+    quint32 elementIndex;
+    double scale;
+
+    double fieldValue();
 
 signals:
     void dataChanged();
@@ -102,7 +112,7 @@ class SequentialPlotData : public PlotData
     Q_OBJECT
 public:
     SequentialPlotData(QString uavObject, QString uavField)
-            : PlotData(uavObject, uavField) {}
+            : PlotData(uavObject, uavField), sampleCount(0) {}
     ~SequentialPlotData() {}
 
     /*!
@@ -121,6 +131,9 @@ public:
       \brief Removes the old data from the buffer
       */
     virtual void removeStaleData(){}
+
+private:
+    quint64 sampleCount; // x of the scope math, the plot x wraps at the window size
 };
 
 /*!
@@ -131,7 +144,8 @@ class ChronoPlotData : public PlotData
     Q_OBJECT
 public:
     ChronoPlotData(QString uavObject, QString uavField)
-            : PlotData(uavObject, uavField) {
+            : PlotData(uavObject, uavField), lastUpdateTime(0), lastUpdateSamples(0),
+              prevUpdateTime(0), prevUpdateSamples(0) {
         scalePower = 1;
     }
     ~ChronoPlotData() {
@@ -146,6 +160,10 @@ public:
     virtual void removeStaleData();
 
 private:
+    qint64 lastUpdateTime; // Link time of the last sample
+    int lastUpdateSamples; // Samples received with lastUpdateTime
+    qint64 prevUpdateTime; // Link time before that, to space out samples that share a time
+    int prevUpdateSamples;
 
 private slots:
     void removeStaleDataTimeout();
@@ -172,4 +190,41 @@ public:
     virtual void removeStaleData(){}
 };
 
+/*!
+  \brief The spectrum plot shows the power spectral density of the last samples, the x axis is
+  the frequency in Hz. A new spectrum is computed every half window (50% overlapping segments)
+  and averaged with the previous ones, so the cost per sample stays O(log n).
+  */
+class SpectrumPlotData : public PlotData
+{
+    Q_OBJECT
+public:
+    static const int AVERAGED_SEGMENTS = 4;
+
+    SpectrumPlotData(QString uavObject, QString uavField, int size, PlotSpectrum::Window window);
+    ~SpectrumPlotData() {}
+
+    bool append(UAVObject* obj);
+
+    virtual PlotType plotType() {
+        return SpectrumPlot;
+    }
+
+    virtual void removeStaleData(){}
+    virtual qint64 memoryBytes() const;
+
+private:
+    PlotSpectrum spectrum;
+    PlotRingBuffer<double> samples;
+    PlotRingBuffer<qint64> sampleTimes;
+    qint64 lastUpdateTime;
+    int newSamples;
+    int segments;
+    QVector<double> segment;
+    QVector<double> power;
+    QVector<double> average;
+
+    void updateSpectrum();
+};
+
 #endif // PLOTDATA_H
@@ -0,0 +1,123 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotdatastore.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief Curve data shared by all scope gadgets
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "plotdatastore.h"
+
+PlotDataStore* PlotDataStore::instance()
+{
+    static PlotDataStore store;
+    return &store;
+}
+
+/*!
+  \brief The curve data for this element and settings, created on first use
+  */
+PlotData* PlotDataStore::acquire(PlotType plotType, UAVObject* obj, UAVObjectField* field, QString uavFieldSubField,
+                                 int scalePower, int meanSamples, QString mathFunction, double xWindowSize,
+                                 int spectrumWindow)
+{
+    if (plotType != SpectrumPlot)
+        spectrumWindow = 0;
+    QString key = QString("%1:%2:%3:%4:%5:%6:%7:%8:%9").arg(plotType).arg(obj->getName()).arg(obj->getInstID())
+                  .arg(uavFieldSubField).arg(scalePower).arg(meanSamples).arg(mathFunction).arg(xWindowSize)
+                  .arg(spectrumWindow);
+    PlotData* plotData = plots.value(key);
+    if (plotData) {
+        ++refCounts[plotData];
+        return plotData;
+    }
+
+    if (plotType == SequentialPlot)
+        plotData = new SequentialPlotData(obj->getName(), uavFieldSubField);
+    else if (plotType == ChronoPlot)
+        plotData = new ChronoPlotData(obj->getName(), uavFieldSubField);
+    else if (plotType == SpectrumPlot)
+        plotData = new SpectrumPlotData(obj->getName(), uavFieldSubField, (int)xWindowSize,
+                                        (PlotSpectrum::Window)spectrumWindow);
+    else
+        return 0;
+
+    plotData->m_xWindowSize = xWindowSize;
+    plotData->scalePower = scalePower;
+    plotData->meanSamples = meanSamples;
+    plotData->mathFunction = mathFunction;
+    plotData->math = PlotMath::create(mathFunction, meanSamples);
+    if (!plotData->bindField(obj, field)) {
+        delete plotData;
+        return 0;
+    }
+
+    plots.insert(key, plotData);
+    keys.insert(plotData, key);
+    refCounts.insert(plotData, 1);
+    if (!objectPlots.contains(obj)) {
+        connect(obj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(objectUpdated(UAVObject*)));
+        // Curves keep recording while their scope is hidden, so they count as shown
+        obj->addInterest();
+    }
+    objectPlots.insert(obj, plotData);
+    return plotData;
+}
+
+/*!
+  \brief A curve does not show plotData any more, deleted with its last curve
+  */
+void PlotDataStore::release(PlotData* plotData)
+{
+    if (!refCounts.contains(plotData) || --refCounts[plotData] > 0)
+        return;
+
+    refCounts.remove(plotData);
+    plots.remove(keys.take(plotData));
+    UAVObject* obj = plotData->getObject();
+    objectPlots.remove(obj, plotData);
+    if (!objectPlots.contains(obj)) {
+        disconnect(obj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(objectUpdated(UAVObject*)));
+        obj->removeInterest();
+    }
+    delete plotData;
+}
+
+QString PlotDataStore::memoryGroup() const
+{
+    return tr("Scope");
+}
+
+QList<Core::IMemoryReporter::Usage> PlotDataStore::memoryUsage() const
+{
+    qint64 bytes = 0;
+    foreach (PlotData* plotData, plots)
+        bytes += plotData->memoryBytes();
+    return QList<Usage>() << Usage(tr("Curve data"), plots.size(), bytes);
+}
+
+void PlotDataStore::objectUpdated(UAVObject* obj)
+{
+    QMultiHash<UAVObject*, PlotData*>::const_iterator itr = objectPlots.constFind(obj);
+    for (; itr != objectPlots.constEnd() && itr.key() == obj; ++itr)
+        itr.value()->append(obj);
+}
@@ -0,0 +1,71 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotdatastore.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief Curve data shared by all scope gadgets
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef PLOTDATASTORE_H
+#define PLOTDATASTORE_H
+
+#include "plotdata.h"
+#include <coreplugin/imemoryreporter.h>
+
+#include <QObject>
+#include <QHash>
+#include <QMultiHash>
+
+/*!
+  \brief Reference counted store of the curve data of all scope gadgets.
+  Curves plotting the same element the same way share one PlotData, so its samples
+  are kept, decoded and run through the scope math once however many scopes show it.
+  The store reports its curves to the Memory Usage page.
+  */
+class PlotDataStore : public Core::IMemoryReporter
+{
+    Q_OBJECT
+
+public:
+    static PlotDataStore* instance();
+
+    PlotData* acquire(PlotType plotType, UAVObject* obj, UAVObjectField* field, QString uavFieldSubField,
+                      int scalePower, int meanSamples, QString mathFunction, double xWindowSize,
+                      int spectrumWindow = PlotSpectrum::HannWindow);
+    void release(PlotData* plotData);
+
+    QString memoryGroup() const;
+    QList<Usage> memoryUsage() const;
+
+private slots:
+    void objectUpdated(UAVObject* obj);
+
+private:
+    PlotDataStore() {}
+
+    QHash<QString, PlotData*> plots;
+    QHash<PlotData*, QString> keys;
+    QHash<PlotData*, int> refCounts;
+    QMultiHash<UAVObject*, PlotData*> objectPlots;
+};
+
+#endif // PLOTDATASTORE_H
@@ -0,0 +1,183 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotenvelope.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief Level of detail reduction of the scope curves
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "plotenvelope.h"
+
+PlotEnvelope::PlotEnvelope(const PlotRingBuffer<double>* yData) :
+    yData(yData),
+    firstIndex(0),
+    clearCount(0)
+{
+}
+
+/*!
+  \brief yData got a new last sample
+  */
+void PlotEnvelope::appended()
+{
+    qint64 index = firstIndex + yData->size() - 1;
+    double y = yData->last();
+    for (int level = 0; level < LEVELS; ++level) {
+        PlotRingBuffer<Bucket>& buckets = levels[level];
+        qint64 start = index - index % bucketSize(level);
+        if (buckets.isEmpty() || buckets.last().start != start) {
+            Bucket bucket;
+            bucket.start = start;
+            bucket.minIndex = bucket.maxIndex = index;
+            bucket.minY = bucket.maxY = y;
+            buckets.append(bucket);
+        } else {
+            Bucket& bucket = buckets.last();
+            if (y < bucket.minY) {
+                bucket.minY = y;
+                bucket.minIndex = index;
+            }
+            if (y > bucket.maxY) {
+                bucket.maxY = y;
+                bucket.maxIndex = index;
+            }
+        }
+    }
+}
+
+/*!
+  \brief yData lost its first sample
+  */
+void PlotEnvelope::removed()
+{
+    ++firstIndex;
+    for (int level = 0; level < LEVELS; ++level) {
+        PlotRingBuffer<Bucket>& buckets = levels[level];
+        while (!buckets.isEmpty() && buckets.first().start + bucketSize(level) <= firstIndex)
+            buckets.removeFirst();
+    }
+}
+
+/*!
+  \brief Bytes held by the buckets of all levels
+  */
+qint64 PlotEnvelope::memoryBytes() const
+{
+    qint64 bytes = 0;
+    for (int level = 0; level < LEVELS; ++level)
+        bytes += levels[level].capacity() * sizeof(Bucket);
+    return bytes;
+}
+
+/*!
+  \brief yData was cleared
+  */
+void PlotEnvelope::clear()
+{
+    firstIndex = 0;
+    ++clearCount;
+    for (int level = 0; level < LEVELS; ++level)
+        levels[level].clear();
+}
+
+/*!
+  \brief Minimum and maximum of the whole series, false if it is empty.
+  The samples before the first bucket boundary are looked at one by one, then
+  whole buckets are taken, switching to the next level as soon as the position
+  is aligned to it. That is at most a few samples and buckets per level plus the
+  buckets of the last level.
+  */
+bool PlotEnvelope::yRange(double& minY, double& maxY) const
+{
+    int count = yData->size();
+    if (count == 0)
+        return false;
+
+    qint64 end = firstIndex + count;
+    qint64 pos = firstIndex;
+    minY = maxY = yData->at(0);
+    for (; pos < end && pos % bucketSize(0) != 0; ++pos) {
+        double y = yData->at(pos - firstIndex);
+        minY = qMin(minY, y);
+        maxY = qMax(maxY, y);
+    }
+    for (int level = 0; level < LEVELS && pos < end; ++level) {
+        const PlotRingBuffer<Bucket>& buckets = levels[level];
+        qint64 size = bucketSize(level);
+        int b = (pos - buckets.first().start) / size;
+        while (b < buckets.size() && (level == LEVELS - 1 || pos % bucketSize(level + 1) != 0)) {
+            const Bucket& bucket = buckets.at(b++);
+            minY = qMin(minY, bucket.minY);
+            maxY = qMax(maxY, bucket.maxY);
+            pos += size;
+        }
+    }
+    return true;
+}
+
+/*!
+  \brief Reduce the series to about maxPoints points, min and max of every bucket in sample order
+  */
+void PlotEnvelope::decimate(const PlotRingBuffer<double>* xData, int maxPoints, QVector<QPointF>& points) const
+{
+    int count = qMin(xData->size(), yData->size());
+    points.resize(0);
+    if (count <= maxPoints) {
+        points.reserve(count);
+        for (int i = 0; i < count; ++i)
+            points.append(QPointF(xData->at(i), yData->at(i)));
+        return;
+    }
+
+    int level = 0;
+    while (level < LEVELS - 1 && 2 * (count / bucketSize(level)) > maxPoints)
+        ++level;
+    const PlotRingBuffer<Bucket>& buckets = levels[level];
+    points.reserve(2 * buckets.size());
+    for (int b = 0; b < buckets.size(); ++b) {
+        Bucket bucket = buckets.at(b);
+        if (bucket.start < firstIndex) {
+            // Partly removed, look at the samples that are left
+            qint64 end = qMin(bucket.start + bucketSize(level), firstIndex + count);
+            bucket.minIndex = bucket.maxIndex = firstIndex;
+            bucket.minY = bucket.maxY = yData->at(0);
+            for (qint64 index = firstIndex + 1; index < end; ++index) {
+                double y = yData->at(index - firstIndex);
+                if (y < bucket.minY) {
+                    bucket.minY = y;
+                    bucket.minIndex = index;
+                }
+                if (y > bucket.maxY) {
+                    bucket.maxY = y;
+                    bucket.maxIndex = index;
+                }
+            }
+        }
+        qint64 first = qMin(bucket.minIndex, bucket.maxIndex) - firstIndex;
+        qint64 last = qMax(bucket.minIndex, bucket.maxIndex) - firstIndex;
+        if (first >= count)
+            break;
+        points.append(QPointF(xData->at(first), yData->at(first)));
+        if (last != first && last < count)
+            points.append(QPointF(xData->at(last), yData->at(last)));
+    }
+}
@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotenvelope.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief Level of detail reduction of the scope curves
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef PLOTENVELOPE_H
+#define PLOTENVELOPE_H
+
+#include "plotringbuffer.h"
+
+#include <QVector>
+#include <QPointF>
+
+/*!
+  \brief Incrementally maintained min/max envelope of a sample series.
+  Buckets of 4, 16, 64, ... samples keep the minimum and maximum they saw, so a
+  series of any length reduces to a few points per pixel column without losing spikes.
+  Appending and removing samples is O(LEVELS).
+  */
+class PlotEnvelope
+{
+public:
+    static const int LEVELS = 6; // bucket sizes 4^1 .. 4^6 samples
+
+    PlotEnvelope(const PlotRingBuffer<double>* yData);
+
+    void appended();
+    void removed();
+    void clear();
+    qint64 memoryBytes() const;
+    qint64 firstSample() const { return firstIndex; }
+    quint32 clears() const { return clearCount; }
+    bool yRange(double& minY, double& maxY) const;
+    void decimate(const PlotRingBuffer<double>* xData, int maxPoints, QVector<QPointF>& points) const;
+
+private:
+    struct Bucket {
+        qint64 start;
+        qint64 minIndex;
+        qint64 maxIndex;
+        double minY;
+        double maxY;
+    };
+
+    const PlotRingBuffer<double>* yData;
+    qint64 firstIndex; // Absolute index of yData->first()
+    quint32 clearCount;
+    PlotRingBuffer<Bucket> levels[LEVELS];
+
+    static qint64 bucketSize(int level) { return (qint64)4 << (2 * level); }
+};
+
+#endif // PLOTENVELOPE_H
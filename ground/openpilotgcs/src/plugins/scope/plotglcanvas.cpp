@@ -0,0 +1,186 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotglcanvas.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief OpenGL rendering of the scope curves
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "plotglcanvas.h"
+#include "plotseriesdata.h"
+
+#include "qwt/src/qwt_plot_canvas.h"
+#include "qwt/src/qwt_scale_div.h"
+
+#include <QEvent>
+#include <QSet>
+
+void PlotCurve::drawSeries(QPainter* painter, const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+                           const QRectF& canvasRect, int from, int to) const
+{
+    if (!drawnByGL)
+        QwtPlotCurve::drawSeries(painter, xMap, yMap, canvasRect, from, to);
+}
+
+PlotGLCanvas::PlotGLCanvas(QwtPlot* plot) :
+    QGLWidget(QGLFormat(QGL::SampleBuffers), plot->canvas()),
+    plot(plot)
+{
+    // Zooming and the legend still see the mouse on the canvas
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    plot->canvas()->installEventFilter(this);
+    setGeometry(plot->canvas()->contentsRect());
+    show();
+}
+
+PlotGLCanvas::~PlotGLCanvas()
+{
+    makeCurrent();
+    qDeleteAll(buffers);
+}
+
+void PlotGLCanvas::initializeGL()
+{
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_LINE_SMOOTH);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+/*!
+  \brief Follow the size of the canvas and repaint with it
+  */
+bool PlotGLCanvas::eventFilter(QObject* obj, QEvent* event)
+{
+    if (obj == plot->canvas()) {
+        if (event->type() == QEvent::Resize)
+            setGeometry(plot->canvas()->contentsRect());
+        else if (event->type() == QEvent::Paint)
+            update();
+    }
+    return QGLWidget::eventFilter(obj, event);
+}
+
+void PlotGLCanvas::paintGL()
+{
+    QColor background = plot->canvasBackground().color();
+    glClearColor(background.redF(), background.greenF(), background.blueF(), 1);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    QwtScaleMap xMap = plot->canvasMap(QwtPlot::xBottom);
+    QwtScaleMap yMap = plot->canvasMap(QwtPlot::yLeft);
+    xMap.setPaintInterval(0, width());
+    yMap.setPaintInterval(height(), 0);
+
+    glViewport(0, 0, width(), height());
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0, width(), height(), 0, -1, 1);
+    drawGrid(xMap, yMap);
+
+    // The curves are drawn in plot coordinates relative to the left edge, so
+    // seconds since the epoch keep their precision as floats
+    double xOrigin = xMap.s1();
+    glLoadIdentity();
+    glOrtho(0, xMap.s2() - xOrigin, yMap.s1(), yMap.s2(), -1, 1);
+    QSet<const QwtPlotCurve*> curves;
+    foreach (QwtPlotItem* item, plot->itemList()) {
+        if (item->rtti() != QwtPlotItem::Rtti_PlotCurve)
+            continue;
+        curves.insert(static_cast<QwtPlotCurve*>(item));
+        if (item->isVisible())
+            drawCurve(static_cast<QwtPlotCurve*>(item), xOrigin);
+    }
+
+    // Drop the buffers of curves that were removed from the plot
+    QHash<const QwtPlotCurve*, QGLBuffer*>::iterator itr = buffers.begin();
+    while (itr != buffers.end()) {
+        if (curves.contains(itr.key())) {
+            ++itr;
+        } else {
+            delete itr.value();
+            itr = buffers.erase(itr);
+        }
+    }
+}
+
+void PlotGLCanvas::drawGrid(const QwtScaleMap& xMap, const QwtScaleMap& yMap)
+{
+    const QwtScaleDiv* xDiv = plot->axisScaleDiv(QwtPlot::xBottom);
+    const QwtScaleDiv* yDiv = plot->axisScaleDiv(QwtPlot::yLeft);
+
+    glLineWidth(1);
+    glEnable(GL_LINE_STIPPLE);
+    glLineStipple(1, 0x0F0F);
+    glColor4f(0.5f, 0.5f, 0.5f, 1);
+    glBegin(GL_LINES);
+    foreach (double x, xDiv->ticks(QwtScaleDiv::MajorTick)) {
+        glVertex2d(xMap.transform(x), 0);
+        glVertex2d(xMap.transform(x), height());
+    }
+    foreach (double y, yDiv->ticks(QwtScaleDiv::MajorTick)) {
+        glVertex2d(0, yMap.transform(y));
+        glVertex2d(width(), yMap.transform(y));
+    }
+    glEnd();
+    glDisable(GL_LINE_STIPPLE);
+}
+
+void PlotGLCanvas::drawCurve(const QwtPlotCurve* curve, double xOrigin)
+{
+    const PlotCurveData* data = dynamic_cast<const PlotCurveData*>(curve->data());
+    if (data == NULL || data->size() < 2)
+        return;
+
+    // Only the points already reduced to the canvas width are uploaded
+    int count = data->size();
+    vertices.resize(count * 2);
+    for (int i = 0; i < count; ++i) {
+        QPointF point = data->sample(i);
+        vertices[2 * i] = point.x() - xOrigin;
+        vertices[2 * i + 1] = point.y();
+    }
+
+    QGLBuffer* buffer = buffers.value(curve);
+    if (buffer == NULL) {
+        buffer = new QGLBuffer(QGLBuffer::VertexBuffer);
+        buffer->setUsagePattern(QGLBuffer::StreamDraw);
+        buffer->create();
+        buffers.insert(curve, buffer);
+    }
+    int bytes = vertices.size() * sizeof(float);
+    buffer->bind();
+    if (buffer->size() < bytes)
+        buffer->allocate(2 * bytes);
+    buffer->write(0, vertices.constData(), bytes);
+
+    QPen pen = curve->pen();
+    glLineWidth(qMax<qreal>(1, pen.widthF()));
+    glColor4f(pen.color().redF(), pen.color().greenF(), pen.color().blueF(), pen.color().alphaF());
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, 0);
+    glDrawArrays(GL_LINE_STRIP, 0, count);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    buffer->release();
+}
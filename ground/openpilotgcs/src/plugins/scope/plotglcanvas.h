@@ -0,0 +1,85 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotglcanvas.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief OpenGL rendering of the scope curves
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef PLOTGLCANVAS_H
+#define PLOTGLCANVAS_H
+
+#include "qwt/src/qwt_plot.h"
+#include "qwt/src/qwt_plot_curve.h"
+
+#include <QtOpenGL/QGLWidget>
+#include <QtOpenGL/QGLBuffer>
+#include <QHash>
+#include <QVector>
+
+/*!
+  \brief Scope curve that leaves the drawing to the PlotGLCanvas while it is enabled.
+  Legend, bounding rect and visibility work as for any QwtPlotCurve.
+  */
+class PlotCurve : public QwtPlotCurve
+{
+public:
+    PlotCurve(const QString& title) : QwtPlotCurve(title), drawnByGL(false) {}
+
+    void setDrawnByGL(bool flag) { drawnByGL = flag; }
+
+protected:
+    virtual void drawSeries(QPainter* painter, const QwtScaleMap& xMap, const QwtScaleMap& yMap,
+                            const QRectF& canvasRect, int from, int to) const;
+
+private:
+    bool drawnByGL;
+};
+
+/*!
+  \brief Draws the background, the grid and the curves of a QwtPlot with OpenGL.
+  It covers the plot canvas, repaints whenever the canvas does and draws the curve
+  points as line strips from vertex buffers. The axes and the legend stay Qwt's own.
+  */
+class PlotGLCanvas : public QGLWidget
+{
+    Q_OBJECT
+
+public:
+    PlotGLCanvas(QwtPlot* plot);
+    ~PlotGLCanvas();
+
+protected:
+    void initializeGL();
+    void paintGL();
+    bool eventFilter(QObject* obj, QEvent* event);
+
+private:
+    QwtPlot* plot;
+    QHash<const QwtPlotCurve*, QGLBuffer*> buffers;
+    QVector<float> vertices;
+
+    void drawGrid(const QwtScaleMap& xMap, const QwtScaleMap& yMap);
+    void drawCurve(const QwtPlotCurve* curve, double xOrigin);
+};
+
+#endif // PLOTGLCANVAS_H
@@ -0,0 +1,196 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotmath.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief Streaming math functions of the scope curves
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "plotmath.h"
+
+#include <math.h>
+
+PlotMath* PlotMath::create(const QString& name, int samples)
+{
+    samples = qMax(1, samples);
+    if (name == "Boxcar average")
+        return new BoxcarAverage(samples);
+    if (name == "Standard deviation")
+        return new StandardDeviation(samples);
+    if (name == "Exponential average")
+        return new ExponentialAverage(samples);
+    if (name == "RMS")
+        return new RootMeanSquare(samples);
+    if (name == "Derivative")
+        return new Derivative();
+    if (name == "Integral")
+        return new Integral();
+    return 0;
+}
+
+BoxcarAverage::BoxcarAverage(int samples) :
+    samples(samples),
+    sum(0),
+    correctionSum(0),
+    correctionCount(0)
+{
+}
+
+double BoxcarAverage::process(double x, double value)
+{
+    Q_UNUSED(x);
+
+    history.append(value);
+    sum += value;
+    if (history.size() > samples) {
+        sum -= history.first();
+        history.removeFirst();
+    }
+
+    // Restart the sum every samples steps to prevent it
+    // from running away due to floating point rounding errors
+    correctionSum += value;
+    if (++correctionCount >= samples) {
+        sum = correctionSum;
+        correctionSum = 0;
+        correctionCount = 0;
+    }
+    return sum / history.size();
+}
+
+StandardDeviation::StandardDeviation(int samples) :
+    samples(samples),
+    mean(0),
+    m2(0)
+{
+}
+
+double StandardDeviation::process(double x, double value)
+{
+    Q_UNUSED(x);
+
+    history.append(value);
+    double delta = value - mean;
+    mean += delta / history.size();
+    m2 += delta * (value - mean);
+
+    if (history.size() > samples) {
+        double oldest = history.first();
+        history.removeFirst();
+        delta = oldest - mean;
+        mean -= delta / history.size();
+        m2 -= delta * (oldest - mean);
+    }
+
+    // With Bessel's correction
+    if (history.size() < 2 || m2 <= 0)
+        return 0;
+    return sqrt(m2 / (history.size() - 1));
+}
+
+ExponentialAverage::ExponentialAverage(int samples) :
+    alpha(2.0 / (samples + 1)),
+    average(0),
+    first(true)
+{
+}
+
+double ExponentialAverage::process(double x, double value)
+{
+    Q_UNUSED(x);
+
+    if (first) {
+        average = value;
+        first = false;
+    } else {
+        average += alpha * (value - average);
+    }
+    return average;
+}
+
+RootMeanSquare::RootMeanSquare(int samples) :
+    samples(samples),
+    sum(0),
+    correctionSum(0),
+    correctionCount(0)
+{
+}
+
+double RootMeanSquare::process(double x, double value)
+{
+    Q_UNUSED(x);
+
+    double square = value * value;
+    history.append(square);
+    sum += square;
+    if (history.size() > samples) {
+        sum -= history.first();
+        history.removeFirst();
+    }
+
+    correctionSum += square;
+    if (++correctionCount >= samples) {
+        sum = correctionSum;
+        correctionSum = 0;
+        correctionCount = 0;
+    }
+    return sum > 0 ? sqrt(sum / history.size()) : 0;
+}
+
+Derivative::Derivative() :
+    lastX(0),
+    lastValue(0),
+    derivative(0),
+    first(true)
+{
+}
+
+double Derivative::process(double x, double value)
+{
+    // Samples arriving within the same x keep the last rate
+    if (!first && x > lastX)
+        derivative = (value - lastValue) / (x - lastX);
+    if (first || x > lastX) {
+        lastX = x;
+        lastValue = value;
+        first = false;
+    }
+    return derivative;
+}
+
+Integral::Integral() :
+    lastX(0),
+    lastValue(0),
+    integral(0),
+    first(true)
+{
+}
+
+double Integral::process(double x, double value)
+{
+    if (!first && x > lastX)
+        integral += (value + lastValue) / 2 * (x - lastX);
+    lastX = x;
+    lastValue = value;
+    first = false;
+    return integral;
+}
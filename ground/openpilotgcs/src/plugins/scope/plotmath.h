@@ -0,0 +1,152 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotmath.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief Streaming math functions of the scope curves
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef PLOTMATH_H
+#define PLOTMATH_H
+
+#include "plotringbuffer.h"
+
+#include <QString>
+
+/*!
+  \brief Math function applied to the samples of a curve before they are plotted.
+  The function is resolved once when the curve is set up, every sample then costs O(1).
+  */
+class PlotMath
+{
+public:
+    virtual ~PlotMath() {}
+
+    /*!
+      \brief Feed the sample value at x, returns the value to plot
+      */
+    virtual double process(double x, double value) = 0;
+
+    /*!
+      \brief The function called name over a window of samples, 0 for "None"
+      */
+    static PlotMath* create(const QString& name, int samples);
+};
+
+/*!
+  \brief Mean of the last samples
+  */
+class BoxcarAverage : public PlotMath
+{
+public:
+    BoxcarAverage(int samples);
+    double process(double x, double value);
+
+private:
+    int samples;
+    PlotRingBuffer<double> history;
+    double sum;
+    double correctionSum;
+    int correctionCount;
+};
+
+/*!
+  \brief Sample standard deviation of the last samples, Welford's update over a sliding window
+  */
+class StandardDeviation : public PlotMath
+{
+public:
+    StandardDeviation(int samples);
+    double process(double x, double value);
+
+private:
+    int samples;
+    PlotRingBuffer<double> history;
+    double mean;
+    double m2;
+};
+
+/*!
+  \brief Exponential moving average, weighted like a boxcar average of the given samples
+  */
+class ExponentialAverage : public PlotMath
+{
+public:
+    ExponentialAverage(int samples);
+    double process(double x, double value);
+
+private:
+    double alpha;
+    double average;
+    bool first;
+};
+
+/*!
+  \brief Root mean square of the last samples
+  */
+class RootMeanSquare : public PlotMath
+{
+public:
+    RootMeanSquare(int samples);
+    double process(double x, double value);
+
+private:
+    int samples;
+    PlotRingBuffer<double> history;
+    double sum;
+    double correctionSum;
+    int correctionCount;
+};
+
+/*!
+  \brief Rate of change per unit of x
+  */
+class Derivative : public PlotMath
+{
+public:
+    Derivative();
+    double process(double x, double value);
+
+private:
+    double lastX;
+    double lastValue;
+    double derivative;
+    bool first;
+};
+
+/*!
+  \brief Trapezoidal integral over x since the curve was set up
+  */
+class Integral : public PlotMath
+{
+public:
+    Integral();
+    double process(double x, double value);
+
+private:
+    double lastX;
+    double lastValue;
+    double integral;
+    bool first;
+};
+
+#endif // PLOTMATH_H
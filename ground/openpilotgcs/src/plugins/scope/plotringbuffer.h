@@ -0,0 +1,88 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotringbuffer.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief Sample storage of the scope curves
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef PLOTRINGBUFFER_H
+#define PLOTRINGBUFFER_H
+
+#include <QVector>
+
+/*!
+  \brief Ring buffer of samples, appending and removing the oldest sample are O(1).
+  The capacity is a power of two and only grows (by doubling) while the window fills up.
+  */
+template <typename T>
+class PlotRingBuffer
+{
+public:
+    PlotRingBuffer() : buffer(16), head(0), count(0), mask(15) {}
+
+    int size() const { return count; }
+    int capacity() const { return buffer.size(); }
+    bool isEmpty() const { return count == 0; }
+    const T& at(int i) const { return buffer.at((head + i) & mask); }
+    const T& first() const { return at(0); }
+    const T& last() const { return at(count - 1); }
+    T& last() { return buffer[(head + count - 1) & mask]; }
+
+    void append(const T& value)
+    {
+        if (count == buffer.size())
+            grow();
+        buffer[(head + count) & mask] = value;
+        ++count;
+    }
+
+    void removeFirst()
+    {
+        head = (head + 1) & mask;
+        --count;
+    }
+
+    void clear()
+    {
+        head = 0;
+        count = 0;
+    }
+
+private:
+    QVector<T> buffer;
+    int head;
+    int count;
+    int mask;
+
+    void grow()
+    {
+        QVector<T> bigger(buffer.size() * 2);
+        for (int i = 0; i < count; ++i)
+            bigger[i] = at(i);
+        buffer = bigger;
+        head = 0;
+        mask = buffer.size() - 1;
+    }
+};
+
+#endif // PLOTRINGBUFFER_H
@@ -0,0 +1,103 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotseriesdata.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief Qwt views of the scope sample buffers
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "plotseriesdata.h"
+
+PlotSeriesData::PlotSeriesData(const PlotRingBuffer<double>* xData, const PlotRingBuffer<double>* yData,
+                               const PlotEnvelope* envelope) :
+    xData(xData),
+    yData(yData),
+    envelope(envelope),
+    rectClears(0),
+    rectFirst(-1),
+    rectCount(0)
+{
+}
+
+size_t PlotSeriesData::size() const
+{
+    return qMin(xData->size(), yData->size());
+}
+
+QPointF PlotSeriesData::sample(size_t i) const
+{
+    return QPointF(xData->at(i), yData->at(i));
+}
+
+QRectF PlotSeriesData::boundingRect() const
+{
+    int count = PlotSeriesData::size();
+    if (count == 0)
+        return QRectF(0.0, 0.0, -1.0, -1.0);
+    if (envelope->clears() != rectClears || envelope->firstSample() != rectFirst || count != rectCount) {
+        rectClears = envelope->clears();
+        rectFirst = envelope->firstSample();
+        rectCount = count;
+        double minY, maxY;
+        envelope->yRange(minY, maxY);
+        d_boundingRect.setCoords(xData->first(), minY, xData->at(count - 1), maxY);
+    }
+    return d_boundingRect;
+}
+
+PlotCurveData::PlotCurveData(const PlotRingBuffer<double>* xData, const PlotRingBuffer<double>* yData,
+                             const PlotEnvelope* envelope) :
+    PlotSeriesData(xData, yData, envelope),
+    revision(0),
+    maxPoints(0),
+    decimated(false)
+{
+}
+
+/*!
+  \brief Decide again between the samples and their envelope if the data or the width
+  changed since the last call, returns false if nothing changed
+  */
+bool PlotCurveData::update(int maxPoints, quint32 revision)
+{
+    if (revision == this->revision && maxPoints == this->maxPoints)
+        return false;
+    this->revision = revision;
+    this->maxPoints = maxPoints;
+    decimated = (int)PlotSeriesData::size() > maxPoints;
+    if (decimated)
+        envelope->decimate(xData, maxPoints, points);
+    else
+        points.clear();
+    return true;
+}
+
+size_t PlotCurveData::size() const
+{
+    return decimated ? points.size() : PlotSeriesData::size();
+}
+
+QPointF PlotCurveData::sample(size_t i) const
+{
+    return decimated ? points.at(i) : PlotSeriesData::sample(i);
+}
@@ -0,0 +1,89 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotseriesdata.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief Qwt views of the scope sample buffers
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef PLOTSERIESDATA_H
+#define PLOTSERIESDATA_H
+
+#include "plotringbuffer.h"
+#include "plotenvelope.h"
+#include "qwt/src/qwt_series_data.h"
+
+#include <QVector>
+#include <QPointF>
+
+/*!
+  \brief Hands the samples of a pair of ring buffers to Qwt where they are, nothing is
+  copied on a replot. The bounding rect comes from the envelope of y and is only
+  recomputed after samples were appended or removed. x must not decrease, which
+  holds for the samples of every PlotData.
+  */
+class PlotSeriesData : public QwtSeriesData<QPointF>
+{
+public:
+    PlotSeriesData(const PlotRingBuffer<double>* xData, const PlotRingBuffer<double>* yData,
+                   const PlotEnvelope* envelope);
+
+    virtual size_t size() const;
+    virtual QPointF sample(size_t i) const;
+    virtual QRectF boundingRect() const;
+
+protected:
+    const PlotRingBuffer<double>* xData;
+    const PlotRingBuffer<double>* yData;
+    const PlotEnvelope* envelope;
+
+private:
+    // Samples d_boundingRect was computed for
+    mutable quint32 rectClears;
+    mutable qint64 rectFirst;
+    mutable int rectCount;
+};
+
+/*!
+  \brief The samples of a scope curve. Up to maxPoints samples are passed through
+  as they are, longer series as their min/max envelope.
+  */
+class PlotCurveData : public PlotSeriesData
+{
+public:
+    PlotCurveData(const PlotRingBuffer<double>* xData, const PlotRingBuffer<double>* yData,
+                  const PlotEnvelope* envelope);
+
+    bool update(int maxPoints, quint32 revision);
+
+    virtual size_t size() const;
+    virtual QPointF sample(size_t i) const;
+
+private:
+    quint32 revision;
+    int maxPoints;
+    bool decimated;
+    QVector<QPointF> points;
+};
+
+#endif // PLOTSERIESDATA_H
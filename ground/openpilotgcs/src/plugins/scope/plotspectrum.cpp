@@ -0,0 +1,150 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotspectrum.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief Power spectrum of the scope curves
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "plotspectrum.h"
+
+#include <math.h>
+
+PlotSpectrum::PlotSpectrum(int size, Window type)
+{
+    n = MIN_SIZE;
+    while (n * 2 <= qMin(size, (int)MAX_SIZE))
+        n *= 2;
+    half = n / 2;
+
+    window.resize(n);
+    windowPower = 0;
+    for (int i = 0; i < n; ++i) {
+        double phase = 2 * M_PI * i / (n - 1);
+        if (type == HannWindow)
+            window[i] = 0.5 - 0.5 * cos(phase);
+        else if (type == HammingWindow)
+            window[i] = 0.54 - 0.46 * cos(phase);
+        else if (type == BlackmanWindow)
+            window[i] = 0.42 - 0.5 * cos(phase) + 0.08 * cos(2 * phase);
+        else
+            window[i] = 1;
+        windowPower += window[i] * window[i];
+    }
+
+    int bits = 0;
+    while ((1 << bits) < half)
+        ++bits;
+    bitReverse.resize(half);
+    for (int i = 0; i < half; ++i) {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b)
+            if (i & (1 << b))
+                reversed |= 1 << (bits - 1 - b);
+        bitReverse[i] = reversed;
+    }
+
+    fftCos.resize(half / 2);
+    fftSin.resize(half / 2);
+    for (int k = 0; k < half / 2; ++k) {
+        fftCos[k] = cos(2 * M_PI * k / half);
+        fftSin[k] = -sin(2 * M_PI * k / half);
+    }
+    splitCos.resize(half + 1);
+    splitSin.resize(half + 1);
+    for (int k = 0; k <= half; ++k) {
+        splitCos[k] = cos(2 * M_PI * k / n);
+        splitSin[k] = -sin(2 * M_PI * k / n);
+    }
+
+    re.resize(half);
+    im.resize(half);
+}
+
+QString PlotSpectrum::windowName(Window window)
+{
+    switch (window) {
+    case RectangularWindow:
+        return "Rectangular";
+    case HannWindow:
+        return "Hann";
+    case HammingWindow:
+        return "Hamming";
+    case BlackmanWindow:
+        return "Blackman";
+    default:
+        return QString();
+    }
+}
+
+void PlotSpectrum::power(const double* samples, double sampleRate, double* power)
+{
+    // Even samples as the real, odd samples as the imaginary part
+    for (int i = 0; i < half; ++i) {
+        int j = bitReverse[i];
+        re[j] = samples[2 * i] * window[2 * i];
+        im[j] = samples[2 * i + 1] * window[2 * i + 1];
+    }
+    fft();
+
+    double scale = 1.0 / (sampleRate * windowPower);
+    for (int k = 0; k <= half; ++k) {
+        int i = k % half;
+        int j = (half - k) % half;
+        double evenRe = (re[i] + re[j]) / 2;
+        double evenIm = (im[i] - im[j]) / 2;
+        double oddRe = (im[i] + im[j]) / 2;
+        double oddIm = (re[j] - re[i]) / 2;
+        double xRe = evenRe + splitCos[k] * oddRe - splitSin[k] * oddIm;
+        double xIm = evenIm + splitCos[k] * oddIm + splitSin[k] * oddRe;
+        double p = (xRe * xRe + xIm * xIm) * scale;
+        // One sided, the negative frequencies fold onto all bins but DC and Nyquist
+        power[k] = (k == 0 || k == half) ? p : 2 * p;
+    }
+}
+
+/*!
+  \brief Iterative radix 2 FFT of re/im in place, the input is in bit reversed order
+  */
+void PlotSpectrum::fft()
+{
+    double* r = re.data();
+    double* m = im.data();
+    for (int length = 2; length <= half; length *= 2) {
+        int step = half / length;
+        int span = length / 2;
+        for (int start = 0; start < half; start += length) {
+            for (int k = 0; k < span; ++k) {
+                double wr = fftCos[k * step];
+                double wi = fftSin[k * step];
+                int a = start + k;
+                int b = a + span;
+                double tr = r[b] * wr - m[b] * wi;
+                double ti = r[b] * wi + m[b] * wr;
+                r[b] = r[a] - tr;
+                m[b] = m[a] - ti;
+                r[a] += tr;
+                m[a] += ti;
+            }
+        }
+    }
+}
@@ -0,0 +1,91 @@
+/**
+ ******************************************************************************
+ *
+ * @file       plotspectrum.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup ScopePlugin Scope Gadget Plugin
+ * @{
+ * @brief Power spectrum of the scope curves
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef PLOTSPECTRUM_H
+#define PLOTSPECTRUM_H
+
+#include <QVector>
+#include <QString>
+
+/*!
+  \brief Windowed power spectral density of a block of real samples.
+  The real FFT of n samples is done as a complex FFT of n/2 points, with all twiddles,
+  the window and the bit reversal precomputed, so a transform allocates nothing.
+  */
+class PlotSpectrum
+{
+public:
+    enum Window {
+        RectangularWindow,
+        HannWindow,
+        HammingWindow,
+        BlackmanWindow,
+
+        NWindows
+    };
+
+    static const int MIN_SIZE = 16;
+    static const int MAX_SIZE = 65536;
+
+    PlotSpectrum(int size, Window window);
+
+    /*!
+      \brief The transform length, size rounded down to a power of two
+      */
+    int size() const { return n; }
+    int bins() const { return n / 2 + 1; }
+    static QString windowName(Window window);
+
+    /*!
+      \brief One sided power spectral density of size() samples taken at sampleRate,
+      power gets bins() values, bin k is at k * sampleRate / size()
+      */
+    void power(const double* samples, double sampleRate, double* power);
+
+    qint64 memoryBytes() const
+    {
+        return (window.size() + fftCos.size() + fftSin.size() + splitCos.size() + splitSin.size()
+                + re.size() + im.size()) * sizeof(double) + bitReverse.size() * sizeof(int);
+    }
+
+private:
+    int n;
+    int half;
+    QVector<double> window;
+    double windowPower; // Sum of the squared window, normalizes the density
+    QVector<int> bitReverse;
+    QVector<double> fftCos; // exp(-2 pi i k / half)
+    QVector<double> fftSin;
+    QVector<double> splitCos; // exp(-2 pi i k / n), separates the even and odd samples
+    QVector<double> splitSin;
+    QVector<double> re;
+    QVector<double> im;
+
+    void fft();
+};
+
+#endif // PLOTSPECTRUM_H
@@ -1,10 +1,19 @@
 TEMPLATE = lib
+QT += opengl
 TARGET = ScopeGadget
 DEFINES += SCOPE_LIBRARY
 include(../../openpilotgcsplugin.pri)
 include (scope_dependencies.pri)
 HEADERS += scopeplugin.h \
     plotdata.h \
+    plotringbuffer.h \
+    plotenvelope.h \
+    plotseriesdata.h \
+    plotmath.h \
+    plotdatastore.h \
+    plotspectrum.h \
+    plotcsvwriter.h \
+    plotglcanvas.h \
     scope_global.h
 HEADERS += scopegadgetoptionspage.h
 HEADERS += scopegadgetconfiguration.h
@@ -12,7 +21,14 @@ HEADERS += scopegadget.h
 HEADERS += scopegadgetwidget.h
 HEADERS += scopegadgetfactory.h
 SOURCES += scopeplugin.cpp \
-    plotdata.cpp
+    plotdata.cpp \
+    plotenvelope.cpp \
+    plotseriesdata.cpp \
+    plotmath.cpp \
+    plotdatastore.cpp \
+    plotspectrum.cpp \
+    plotcsvwriter.cpp \
+    plotglcanvas.cpp
 SOURCES += scopegadgetoptionspage.cpp
 SOURCES += scopegadgetconfiguration.cpp
 SOURCES += scopegadget.cpp
@@ -48,11 +48,15 @@ void ScopeGadget::loadConfiguration(IUAVGadgetConfiguration* config)
 
     widget->setXWindowSize(sgConfig->dataSize());
     widget->setRefreshInterval(sgConfig->refreshInterval());
+    widget->setSpectrumWindow(sgConfig->spectrumWindow());
+    widget->enableOpenGL(sgConfig->useOpenGL());
 
     if(sgConfig->plotType() == SequentialPlot )
         widget->setupSequentialPlot();
     else if(sgConfig->plotType() == ChronoPlot)
         widget->setupChronoPlot();
+    else if(sgConfig->plotType() == SpectrumPlot)
+        widget->setupSpectrumPlot();
     //    else if(sgConfig->plotType() == UAVObjectPlot)
     //        widget->setupUAVObjectPlot();
 
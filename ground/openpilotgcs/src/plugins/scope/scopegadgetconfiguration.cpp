@@ -32,7 +32,9 @@ ScopeGadgetConfiguration::ScopeGadgetConfiguration(QString classId, QSettings* q
         m_plotType((int)ChronoPlot),
         m_dataSize(60),
         m_refreshInterval(1000),
-        m_mathFunctionType(0)
+        m_mathFunctionType(0),
+        m_spectrumWindow((int)PlotSpectrum::HannWindow),
+        m_useOpenGL(false)
 {
     uint currentStreamVersion = 0;
     int plotCurveCount = 0;
@@ -48,6 +50,8 @@ ScopeGadgetConfiguration::ScopeGadgetConfiguration(QString classId, QSettings* q
         m_plotType = qSettings->value("plotType").toInt();
         m_dataSize = qSettings->value("dataSize").toInt();
         m_refreshInterval = qSettings->value("refreshInterval").toInt();
+        m_spectrumWindow = qSettings->value("spectrumWindow", m_spectrumWindow).toInt();
+        m_useOpenGL = qSettings->value("useOpenGL").toBool();
         plotCurveCount = qSettings->value("plotCurveCount").toInt();
 
         for(int plotDatasLoadIndex = 0; plotDatasLoadIndex < plotCurveCount; plotDatasLoadIndex++)
@@ -113,6 +117,8 @@ IUAVGadgetConfiguration *ScopeGadgetConfiguration::clone()
     m->setDataSize( m_dataSize);
     m->setMathFunctionType( m_mathFunctionType);
     m->setRefreashInterval( m_refreshInterval);
+    m->setSpectrumWindow( m_spectrumWindow);
+    m->setUseOpenGL( m_useOpenGL);
 
     plotCurveCount = m_PlotCurveConfigs.size();
 
@@ -157,6 +163,8 @@ void ScopeGadgetConfiguration::saveConfig(QSettings* qSettings) const {
     qSettings->setValue("plotType", m_plotType);
     qSettings->setValue("dataSize", m_dataSize);
     qSettings->setValue("refreshInterval", m_refreshInterval);
+    qSettings->setValue("spectrumWindow", m_spectrumWindow);
+    qSettings->setValue("useOpenGL", m_useOpenGL);
     qSettings->setValue("plotCurveCount", plotCurveCount);
 
     for(plotDatasLoadIndex = 0; plotDatasLoadIndex < plotCurveCount; plotDatasLoadIndex++)
@@ -60,6 +60,8 @@ public:
     void setMathFunctionType(int value){m_mathFunctionType = value;}
     void setDataSize(int value){m_dataSize = value;}
     void setRefreashInterval(int value){m_refreshInterval = value;}
+    void setSpectrumWindow(int value){m_spectrumWindow = value;}
+    void setUseOpenGL(bool value){m_useOpenGL = value;}
     void addPlotCurveConfig(PlotCurveConfiguration* value){m_PlotCurveConfigs.append(value);}
     void replacePlotCurveConfig(QList<PlotCurveConfiguration*> m_PlotCurveConfigs);
 
@@ -69,6 +71,8 @@ public:
     int mathFunctionType(){return m_mathFunctionType;}
     int dataSize(){return m_dataSize;}
     int refreshInterval(){return m_refreshInterval;}
+    int spectrumWindow(){return m_spectrumWindow;}
+    bool useOpenGL(){return m_useOpenGL;}
     QList<PlotCurveConfiguration*> plotCurveConfigs(){return m_PlotCurveConfigs;}
 
     void saveConfig(QSettings* settings) const; //THIS SEEMS TO BE UNUSED
@@ -88,6 +92,8 @@ private:
     int m_dataSize; //The size of the data buffer to render in the curve plot
     int m_refreshInterval; //The interval to replot the curve widget. The data buffer is refresh as the data comes in.
     int m_mathFunctionType; //The type of math function to be used in the scope analysis
+    int m_spectrumWindow; //The window function of the spectrum plot, a PlotSpectrum::Window
+    bool m_useOpenGL; //Draw the curves with OpenGL
     QList<PlotCurveConfiguration*> m_PlotCurveConfigs;
 
     void clearPlotData();
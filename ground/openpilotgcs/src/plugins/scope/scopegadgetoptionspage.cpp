@@ -53,8 +53,12 @@ QWidget* ScopeGadgetOptionsPage::createPage(QWidget *parent)
     //main layout
     options_page->setupUi(optionsPageWidget);
 
-    options_page->cmbPlotType->addItem("Sequential Plot","");
-    options_page->cmbPlotType->addItem("Chronological Plot","");
+    options_page->cmbPlotType->addItem("Sequential Plot", (int)SequentialPlot);
+    options_page->cmbPlotType->addItem("Chronological Plot", (int)ChronoPlot);
+    options_page->cmbPlotType->addItem("Spectrum Plot", (int)SpectrumPlot);
+
+    for (int window = 0; window < PlotSpectrum::NWindows; ++window)
+        options_page->cmbSpectrumWindow->addItem(PlotSpectrum::windowName((PlotSpectrum::Window)window), window);
 
     // Fills the combo boxes for the UAVObjects
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
@@ -72,6 +76,10 @@ QWidget* ScopeGadgetOptionsPage::createPage(QWidget *parent)
     options_page->mathFunctionComboBox->addItem("None");
     options_page->mathFunctionComboBox->addItem("Boxcar average");
     options_page->mathFunctionComboBox->addItem("Standard deviation");
+    options_page->mathFunctionComboBox->addItem("Exponential average");
+    options_page->mathFunctionComboBox->addItem("RMS");
+    options_page->mathFunctionComboBox->addItem("Derivative");
+    options_page->mathFunctionComboBox->addItem("Integral");
 
     if(options_page->cmbUAVObjects->currentIndex() >= 0)
         on_cmbUAVObjects_currentIndexChanged(options_page->cmbUAVObjects->currentText());
@@ -95,10 +103,13 @@ QWidget* ScopeGadgetOptionsPage::createPage(QWidget *parent)
     options_page->cmbScale->setCurrentIndex(7);
 
     //Set widget values from settings
-    options_page->cmbPlotType->setCurrentIndex(m_config->plotType());
+    options_page->cmbPlotType->setCurrentIndex(options_page->cmbPlotType->findData(m_config->plotType()));
+    options_page->cmbSpectrumWindow->setCurrentIndex(options_page->cmbSpectrumWindow->findData(m_config->spectrumWindow()));
+    on_cmbPlotType_currentIndexChanged(options_page->cmbPlotType->currentIndex());
     options_page->mathFunctionComboBox->setCurrentIndex(m_config->mathFunctionType());
     options_page->spnDataSize->setValue(m_config->dataSize());
     options_page->spnRefreshInterval->setValue(m_config->refreshInterval());
+    options_page->useOpenGL->setChecked(m_config->useOpenGL());
 
     //add the configured curves
     foreach (PlotCurveConfiguration* plotData,  m_config->plotCurveConfigs()) {
@@ -122,6 +133,7 @@ QWidget* ScopeGadgetOptionsPage::createPage(QWidget *parent)
     connect(options_page->btnColor, SIGNAL(clicked()), this, SLOT(on_btnColor_clicked()));
     connect(options_page->mathFunctionComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(on_mathFunctionComboBox_currentIndexChanged(int)));
     connect(options_page->spnRefreshInterval, SIGNAL(valueChanged(int )), this, SLOT(on_spnRefreshInterval_valueChanged(int)));
+    connect(options_page->cmbPlotType, SIGNAL(currentIndexChanged(int)), this, SLOT(on_cmbPlotType_currentIndexChanged(int)));
 
     setYAxisWidgetFromPlotCurve();
 
@@ -166,7 +178,9 @@ bool ScopeGadgetOptionsPage::eventFilter( QObject * obj, QEvent * evt ) {
 }
 
 void ScopeGadgetOptionsPage::on_mathFunctionComboBox_currentIndexChanged(int currentIndex){
-    if (currentIndex > 0){
+    // Derivative and integral do not use a window of samples
+    QString function = options_page->mathFunctionComboBox->itemText(currentIndex);
+    if (currentIndex > 0 && function != "Derivative" && function != "Integral"){
         options_page->spnMeanSamples->setEnabled(true);
     }
     else{
@@ -175,6 +189,13 @@ void ScopeGadgetOptionsPage::on_mathFunctionComboBox_currentIndexChanged(int cur
 
 }
 
+void ScopeGadgetOptionsPage::on_cmbPlotType_currentIndexChanged(int currentIndex){
+    // The data size of a spectrum is the transform length
+    bool spectrum = options_page->cmbPlotType->itemData(currentIndex).toInt() == SpectrumPlot;
+    options_page->spnDataSize->setSuffix(spectrum ? " samples" : " seconds");
+    options_page->cmbSpectrumWindow->setEnabled(spectrum);
+}
+
 void ScopeGadgetOptionsPage::on_btnColor_clicked()
  {
      QColor color = QColorDialog::getColor( QColor(options_page->btnColor->text()));
@@ -268,10 +289,12 @@ void ScopeGadgetOptionsPage::apply()
     bool parseOK = false;
 
     //Apply configuration changes
-    m_config->setPlotType(options_page->cmbPlotType->currentIndex());
+    m_config->setPlotType(options_page->cmbPlotType->itemData(options_page->cmbPlotType->currentIndex()).toInt());
+    m_config->setSpectrumWindow(options_page->cmbSpectrumWindow->itemData(options_page->cmbSpectrumWindow->currentIndex()).toInt());
     m_config->setMathFunctionType(options_page->mathFunctionComboBox->currentIndex());
     m_config->setDataSize(options_page->spnDataSize->value());
     m_config->setRefreashInterval(options_page->spnRefreshInterval->value());
+    m_config->setUseOpenGL(options_page->useOpenGL->isChecked());
 
     QList<PlotCurveConfiguration*> plotCurveConfigs;
     for(int iIndex = 0; iIndex < options_page->lstCurves->count();iIndex++) {
@@ -81,6 +81,7 @@ private slots:
     void on_cmbUAVObjects_currentIndexChanged(QString val);    
     void on_btnColor_clicked();
     void on_mathFunctionComboBox_currentIndexChanged(int currentIndex);
+    void on_cmbPlotType_currentIndexChanged(int currentIndex);
     void on_loggingEnable_clicked();
 
 };
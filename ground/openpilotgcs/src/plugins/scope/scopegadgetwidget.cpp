@@ -28,6 +28,8 @@
 
 #include <QDir>
 #include "scopegadgetwidget.h"
+#include "plotdatastore.h"
+#include "plotseriesdata.h"
 #include "utils/stylehelper.h"
 
 #include "uavtalk/telemetrymanager.h"
@@ -52,6 +54,7 @@
 #include <QtGui/QPushButton>
 #include <QMutexLocker>
 #include <QWheelEvent>
+#include <qnumeric.h>
 
 //using namespace Core;
 
@@ -62,6 +65,10 @@ ScopeGadgetWidget::ScopeGadgetWidget(QWidget *parent) : QwtPlot(parent)
 	setMouseTracking(true);
 //	canvas()->setMouseTracking(true);
 
+    m_spectrumWindow = PlotSpectrum::HannWindow;
+    m_glCanvas = 0;
+    m_lastScrollTime = 0;
+
     //Setup the timer that replots data
     replotTimer = new QTimer(this);
     connect(replotTimer, SIGNAL(timeout()), this, SLOT(replotNewData()));
@@ -290,6 +297,32 @@ void ScopeGadgetWidget::preparePlot(PlotType plotType)
     }
 }
 
+/*!
+  \brief Draw the curves with OpenGL instead of Qwt's raster painter
+  */
+void ScopeGadgetWidget::enableOpenGL(bool flag)
+{
+    if (flag == (m_glCanvas != 0))
+        return;
+    if (flag && !QGLFormat::hasOpenGL()) {
+        qDebug() << "OpenGL is not available, the scope keeps drawing without it";
+        return;
+    }
+
+    if (flag) {
+        m_glCanvas = new PlotGLCanvas(this);
+    } else {
+        delete m_glCanvas;
+        m_glCanvas = 0;
+    }
+    foreach(PlotCurve* curve, m_curves.values()) {
+        curve->setDrawnByGL(flag);
+    }
+	mutex.lock();
+		replot();
+	mutex.unlock();
+}
+
 void ScopeGadgetWidget::showCurve(QwtPlotItem *item, bool on)
 {
     item->setVisible(!on);
@@ -385,46 +418,63 @@ void ScopeGadgetWidget::setupChronoPlot()
 //	scaleWidget->setMinBorderDist(0, fmw);
 }
 
-void ScopeGadgetWidget::addCurvePlot(QString uavObject, QString uavFieldSubField, int scaleOrderFactor, int meanSamples, QString mathFunction, QPen pen)
+void ScopeGadgetWidget::setupSpectrumPlot()
 {
-    PlotData* plotData;
+    preparePlot(SpectrumPlot);
 
-    if (m_plotType == SequentialPlot)
-        plotData = new SequentialPlotData(uavObject, uavFieldSubField);
-    else if (m_plotType == ChronoPlot)
-        plotData = new ChronoPlotData(uavObject, uavFieldSubField);
-    //else if (m_plotType == UAVObjectPlot)
-    //    plotData = new UAVObjectPlotData(uavObject, uavField);
+    // The x axis is the frequency in Hz, its range follows the sample rate
+    setAxisScaleDraw(QwtPlot::xBottom, new QwtScaleDraw());
+    setAxisAutoScale(QwtPlot::xBottom);
+    setAxisLabelRotation(QwtPlot::xBottom, 0.0);
+    setAxisLabelAlignment(QwtPlot::xBottom, Qt::AlignLeft | Qt::AlignBottom);
 
-    plotData->m_xWindowSize = m_xWindowSize;
-    plotData->scalePower = scaleOrderFactor;
-    plotData->meanSamples = meanSamples;
-    plotData->mathFunction = mathFunction;
+	QwtScaleWidget *scaleWidget = axisWidget(QwtPlot::xBottom);
 
-    //If the y-bounds are supplied, set them
-    if (plotData->yMinimum != plotData->yMaximum)
-	{
-		setAxisScale(QwtPlot::yLeft, plotData->yMinimum, plotData->yMaximum);
-	}
+	// reduce the gap between the scope canvas and the axis scale
+	scaleWidget->setMargin(0);
 
-    //Create the curve    
-    QString curveName = (plotData->uavObject) + "." + (plotData->uavField);
-    if(plotData->haveSubField)
-        curveName = curveName.append("." + plotData->uavSubField);
+	// reduce the axis font size
+	QFont fnt(axisFont(QwtPlot::xBottom));
+	fnt.setPointSize(7);
+	setAxisFont(QwtPlot::xBottom, fnt);	// x-axis
+	setAxisFont(QwtPlot::yLeft, fnt);	// y-axis
+}
+
+void ScopeGadgetWidget::addCurvePlot(QString uavObject, QString uavFieldSubField, int scaleOrderFactor, int meanSamples, QString mathFunction, QPen pen)
+{
+    QString uavField = uavFieldSubField.split("-", QString::SkipEmptyParts).value(0);
 
     //Get the uav object
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
     UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
-    UAVDataObject* obj = dynamic_cast<UAVDataObject*>(objManager->getObject((plotData->uavObject)));
+    UAVDataObject* obj = dynamic_cast<UAVDataObject*>(objManager->getObject(uavObject));
     if(!obj) {
-        qDebug() << "Object " << plotData->uavObject << " is missing";
+        qDebug() << "Object " << uavObject << " is missing";
         return;
     }
-    UAVObjectField* field = obj->getField(plotData->uavField);
+    UAVObjectField* field = obj->getField(uavField);
     if(!field) {
-        qDebug() << "Field " << plotData->uavField << " of object " << plotData->uavObject << " is missing";
+        qDebug() << "Field " << uavField << " of object " << uavObject << " is missing";
         return;
     }
+
+    //Curves plotting the same element the same way share their data, also across gadgets
+    PlotData* plotData = PlotDataStore::instance()->acquire(m_plotType, obj, field, uavFieldSubField,
+                                                            scaleOrderFactor, meanSamples, mathFunction, m_xWindowSize,
+                                                            m_spectrumWindow);
+    if (!plotData)
+        return;
+
+    //If the y-bounds are supplied, set them
+    if (plotData->yMinimum != plotData->yMaximum)
+	{
+		setAxisScale(QwtPlot::yLeft, plotData->yMinimum, plotData->yMaximum);
+	}
+
+    //Create the curve    
+    QString curveName = (plotData->uavObject) + "." + (plotData->uavField);
+    if(plotData->haveSubField)
+        curveName = curveName.append("." + plotData->uavSubField);
     QString units = field->getUnits();
 
     if(units == 0)
@@ -436,14 +486,16 @@ void ScopeGadgetWidget::addCurvePlot(QString uavObject, QString uavFieldSubField
     else
         curveNameScaled = curveName + "(x10^" + QString::number(scaleOrderFactor) + " " + units + ")";
 
-    QwtPlotCurve* plotCurve = new QwtPlotCurve(curveNameScaled);
+    PlotCurve* plotCurve = new PlotCurve(curveNameScaled);
+    plotCurve->setDrawnByGL(m_glCanvas != 0);
     plotCurve->setPen(pen);
-    plotCurve->setSamples(*plotData->xData, *plotData->yData);
+    // The curve reads the samples straight from the plot data on every replot
+    plotCurve->setData(new PlotCurveData(plotData->xData, plotData->yData, plotData->envelope));
     plotCurve->attach(this);
-    plotData->curve = plotCurve;
 
     //Keep the curve details for later
     m_curvesData.insert(curveNameScaled, plotData);
+    m_curves.insert(curveNameScaled, plotCurve);
 
     //Link to the new signal data only if this UAVObject has not been connected yet
     if (!m_connectedUAVObjects.contains(obj->getName())) {
@@ -474,8 +526,9 @@ void ScopeGadgetWidget::addCurvePlot(QString uavObject, QString uavFieldSubField
 
 void ScopeGadgetWidget::uavObjectReceived(UAVObject* obj)
 {
+    //The samples were already appended by the PlotDataStore
     foreach(PlotData* plotData, m_curvesData.values()) {
-        if (plotData->append(obj)) m_csvLoggingDataUpdated=1;
+        if (plotData->getObject() == obj) m_csvLoggingDataUpdated=1;
     }
     csvLoggingAddData();
 }
@@ -487,20 +540,38 @@ void ScopeGadgetWidget::replotNewData()
 	foreach(PlotData* plotData, m_curvesData.values())
 	{
         plotData->removeStaleData();
-        plotData->curve->setSamples(*plotData->xData, *plotData->yData);
+    }
+    // A min and a max point per pixel column is all the canvas can show,
+    // curves whose data did not change since the last tick keep their points
+    bool dirty = false;
+    for (QMap<QString, PlotCurve*>::const_iterator itr = m_curves.constBegin(); itr != m_curves.constEnd(); ++itr)
+    {
+        PlotData* plotData = m_curvesData.value(itr.key());
+        if (static_cast<PlotCurveData*>(itr.value()->data())->update(2 * canvas()->width(), plotData->revision))
+            dirty = true;
     }
 
     QDateTime NOW = QDateTime::currentDateTime();
     double toTime = NOW.toTime_t();
     toTime += NOW.time().msec() / 1000.0;
 	if (m_plotType == ChronoPlot)
-        setAxisScale(QwtPlot::xBottom, toTime - m_xWindowSize, toTime);
+    {
+        // Scroll only once the axis moved by at least a pixel
+        if (m_xWindowSize > 0 && (toTime - m_lastScrollTime) * canvas()->width() >= m_xWindowSize)
+        {
+            setAxisScale(QwtPlot::xBottom, toTime - m_xWindowSize, toTime);
+            m_lastScrollTime = toTime;
+            dirty = true;
+        }
+    }
 
 //	qDebug() << "replotNewData from " << NOW.addSecs(- m_xWindowSize) << " to " << NOW;
 
     csvLoggingInsertData();
 
-	replot();
+    // Ticks without new data and without scrolling leave the canvas as it is
+    if (dirty)
+        replot();
 }
 
 /*
@@ -552,13 +623,16 @@ void ScopeGadgetWidget::setupExamplePlot()
 
 void ScopeGadgetWidget::clearCurvePlots()
 {
-    foreach(PlotData* plotData, m_curvesData.values()) {
-        plotData->curve->detach();
+    foreach(QwtPlotCurve* curve, m_curves.values()) {
+        curve->detach();
 
-        delete plotData->curve;
-        delete plotData;
+        delete curve;
+    }
+    foreach(PlotData* plotData, m_curvesData.values()) {
+        PlotDataStore::instance()->release(plotData);
     }
 
+    m_curves.clear();
     m_curvesData.clear();
 }
 
@@ -580,7 +654,6 @@ int ScopeGadgetWidget::csvLoggingStart()
         m_csvLoggingStartTime = NOW;
         m_csvLoggingHeaderSaved=0;
         m_csvLoggingDataSaved=0;
-        m_csvLoggingBuffer.clear();
         QDir PathCheck(m_csvLoggingPath);
         if (!PathCheck.exists())
         {
@@ -590,16 +663,16 @@ int ScopeGadgetWidget::csvLoggingStart()
 
         if (m_csvLoggingNameSet)
         {
-            m_csvLoggingFile.setFileName(QString("%1/%2_%3_%4.csv").arg(m_csvLoggingPath).arg(m_csvLoggingName).arg(NOW.toString("yyyy-MM-dd")).arg(NOW.toString("hh-mm-ss")));
+            m_csvLoggingFileName = QString("%1/%2_%3_%4.csv").arg(m_csvLoggingPath).arg(m_csvLoggingName).arg(NOW.toString("yyyy-MM-dd")).arg(NOW.toString("hh-mm-ss"));
         }
         else
         {
-            m_csvLoggingFile.setFileName(QString("%1/Log_%2_%3.csv").arg(m_csvLoggingPath).arg(NOW.toString("yyyy-MM-dd")).arg(NOW.toString("hh-mm-ss")));
+            m_csvLoggingFileName = QString("%1/Log_%2_%3.csv").arg(m_csvLoggingPath).arg(NOW.toString("yyyy-MM-dd")).arg(NOW.toString("hh-mm-ss"));
         }
-        QDir FileCheck(m_csvLoggingFile.fileName());
+        QDir FileCheck(m_csvLoggingFileName);
         if (FileCheck.exists())
         {
-            m_csvLoggingFile.setFileName("");
+            m_csvLoggingFileName = QString();
         }
         else
         {
@@ -615,6 +688,7 @@ int ScopeGadgetWidget::csvLoggingStart()
 int ScopeGadgetWidget::csvLoggingStop()
 {
     m_csvLoggingStarted=0;
+    m_csvLoggingWriter.close();
 
     return 0;
 }
@@ -626,25 +700,23 @@ int ScopeGadgetWidget::csvLoggingInsertHeader()
     if (m_csvLoggingDataSaved) return -3;
 
     m_csvLoggingHeaderSaved=1;
-    if(m_csvLoggingFile.open(QIODevice::WriteOnly | QIODevice::Append)== FALSE)
+    QString header;
+    QTextStream ts( &header );
+    ts << "date" << ", " << "Time"<< ", " << "Sec since start"<< ", " << "Connected" << ", " << "Data changed";
+
+    foreach(PlotData* plotData2, m_curvesData.values())
     {
-        qDebug() << "Unable to open " << m_csvLoggingFile.fileName() << " for csv logging Header";
+        ts  << ", ";
+        ts  << plotData2->uavObject;
+        ts  << "." << plotData2->uavField;
+        if (plotData2->haveSubField) ts  << "." << plotData2->uavSubField;
     }
-    else
-    {
-        QTextStream ts( &m_csvLoggingFile );
-        ts << "date" << ", " << "Time"<< ", " << "Sec since start"<< ", " << "Connected" << ", " << "Data changed";
+    ts << endl;
 
-        foreach(PlotData* plotData2, m_curvesData.values())
-        {
-            ts  << ", ";
-            ts  << plotData2->uavObject;
-            ts  << "." << plotData2->uavField;
-            if (plotData2->haveSubField) ts  << "." << plotData2->uavSubField;
-        }
-        ts << endl;
-        m_csvLoggingFile.close();
-    }
+    // The rows are formatted and written by the writer thread from now on
+    if (!m_csvLoggingWriter.open(m_csvLoggingFileName, header.toLatin1(), m_curvesData.size(),
+                                 m_csvLoggingStartTime.toMSecsSinceEpoch()))
+        m_csvLoggingStarted=0;
     return 0;
 }
 
@@ -652,47 +724,27 @@ int ScopeGadgetWidget::csvLoggingAddData()
 {
     if (!m_csvLoggingStarted) return -1;
     m_csvLoggingDataValid=0;
-    QDateTime NOW = QDateTime::currentDateTime();
-    QString tempString;
-
-    QTextStream ss( &tempString );
-    ss << NOW.toString("yyyy-MM-dd") << ", " << NOW.toString("hh:mm:ss.z") << ", " ;
-
-#if QT_VERSION >= 0x040700
-    ss <<(NOW.toMSecsSinceEpoch() - m_csvLoggingStartTime.toMSecsSinceEpoch())/1000.00;
-#else
-    ss <<(NOW.toTime_t() - m_csvLoggingStartTime.toTime_t());
-#endif
-    ss << ", " << m_csvLoggingConnected << ", " << m_csvLoggingDataUpdated;
-    m_csvLoggingDataUpdated=0;
 
+    // Only the values are taken here, the writer thread formats the row
+    QVector<double> values;
+    values.reserve(m_curvesData.size());
     foreach(PlotData* plotData2, m_curvesData.values())
     {
-        ss  << ", ";
-        if (plotData2->xData->isEmpty ())
+        if (plotData2->yData->isEmpty())
         {
-            ss  << ", ";
-            if (plotData2->xData->isEmpty ())
-            {
-            }
-            else
-            {
-                ss  << QString().sprintf("%3.10g",plotData2->yData->last());
-                m_csvLoggingDataValid=1;
-            }
+            values.append(qQNaN());
         }
         else
         {
-            ss  << QString().sprintf("%3.10g",plotData2->yData->last());
+            values.append(plotData2->yData->last());
             m_csvLoggingDataValid=1;
         }
     }
-    ss << endl;
     if (m_csvLoggingDataValid)
     {
-        QTextStream ts( &m_csvLoggingBuffer );
-        ts << tempString;
+        m_csvLoggingWriter.append(QDateTime::currentMSecsSinceEpoch(), m_csvLoggingConnected, m_csvLoggingDataUpdated, values);
     }
+    m_csvLoggingDataUpdated=0;
 
     return 0;
 }
@@ -702,17 +754,7 @@ int ScopeGadgetWidget::csvLoggingInsertData()
     if (!m_csvLoggingStarted) return -1;
     m_csvLoggingDataSaved=1;
 
-    if(m_csvLoggingFile.open(QIODevice::WriteOnly | QIODevice::Append)== FALSE)
-    {
-        qDebug() << "Unable to open " << m_csvLoggingFile.fileName() << " for csv logging Data";
-    }
-    else
-    {
-        QTextStream ts( &m_csvLoggingFile );
-        ts << m_csvLoggingBuffer;
-        m_csvLoggingFile.close();
-    }
-    m_csvLoggingBuffer.clear();
+    m_csvLoggingWriter.flush();
 
     return 0;
 }
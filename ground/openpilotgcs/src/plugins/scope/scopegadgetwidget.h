@@ -29,6 +29,8 @@
 #define SCOPEGADGETWIDGET_H_
 
 #include "plotdata.h"
+#include "plotcsvwriter.h"
+#include "plotglcanvas.h"
 
 #include "qwt/src/qwt.h"
 #include "qwt/src/qwt_plot.h"
@@ -73,12 +75,15 @@ public:
     void setupSequentialPlot();
     void setupChronoPlot();
     void setupUAVObjectPlot();
+    void setupSpectrumPlot();
     PlotType plotType(){return m_plotType;}
 
     void setXWindowSize(double xWindowSize){m_xWindowSize = xWindowSize;}
     double xWindowSize(){return m_xWindowSize;}
     void setRefreshInterval(double refreshInterval){m_refreshInterval = refreshInterval;}
     int refreshInterval(){return m_refreshInterval;}
+    void setSpectrumWindow(int spectrumWindow){m_spectrumWindow = spectrumWindow;}
+    void enableOpenGL(bool flag);
 
 
     void addCurvePlot(QString uavObject, QString uavFieldSubField, int scaleOrderFactor = 0, int meanSamples = 1, QString mathFunction= "None", QPen pen = QPen(Qt::black));
@@ -116,8 +121,12 @@ private:
 
     double m_xWindowSize;
     int m_refreshInterval;
+    int m_spectrumWindow;
     QList<QString> m_connectedUAVObjects;
     QMap<QString, PlotData*> m_curvesData;
+    QMap<QString, PlotCurve*> m_curves;
+    PlotGLCanvas* m_glCanvas;
+    double m_lastScrollTime;
 
     QTimer *replotTimer;
 
@@ -135,8 +144,8 @@ private:
 
     QString m_csvLoggingName;
     QString m_csvLoggingPath;
-    QString m_csvLoggingBuffer;
-    QFile m_csvLoggingFile;
+    QString m_csvLoggingFileName;
+    PlotCsvWriter m_csvLoggingWriter;
 
 	QMutex mutex;
 
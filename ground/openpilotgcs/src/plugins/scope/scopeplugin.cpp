@@ -27,6 +27,7 @@
 
 #include "scopeplugin.h"
 #include "scopegadgetfactory.h"
+#include "plotdatastore.h"
 #include <QDebug>
 #include <QtPlugin>
 #include <QStringList>
@@ -50,6 +51,8 @@ bool ScopePlugin::initialize(const QStringList& args, QString *errMsg)
     Q_UNUSED(errMsg);
     mf = new ScopeGadgetFactory(this);
     addAutoReleasedObject(mf);
+    // The store is static, it is only listed in the pool
+    addObject(PlotDataStore::instance());
 
     return true;
 }
@@ -61,7 +64,7 @@ void ScopePlugin::extensionsInitialized()
 
 void ScopePlugin::shutdown()
 {
-    // Do nothing
+    removeObject(PlotDataStore::instance());
 }
 Q_EXPORT_PLUGIN(ScopePlugin)
 
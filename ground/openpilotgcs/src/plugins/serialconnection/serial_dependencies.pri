@@ -1 +1,2 @@
-include(../../plugins/coreplugin/coreplugin.pri)
\ No newline at end of file
+include(../../plugins/coreplugin/coreplugin.pri)
+include(../../plugins/rawhid/rawhid.pri)
\ No newline at end of file
@@ -29,51 +29,22 @@
 
 #include <extensionsystem/pluginmanager.h>
 #include <coreplugin/icore.h>
+#include <rawhid/usbmonitor.h>
 
 #include <QtCore/QtPlugin>
 #include <QtGui/QMainWindow>
+#include <QFile>
+#include <QFileInfo>
 
 #include <QDebug>
 
 
 
-SerialEnumerationThread::SerialEnumerationThread(SerialConnection *serial)
-    : m_serial(serial),
-    m_running(true)
-{
-}
-
-SerialEnumerationThread::~SerialEnumerationThread()
-{
-    m_running = false;
-    //wait for the thread to terminate
-    if(wait(2100) == false)
-        qDebug() << "Cannot terminate SerialEnumerationThread";
-}
-
-void SerialEnumerationThread::run()
-{
-    QList <Core::IConnection::device> devices = m_serial->availableDevices();
-
-    while(m_running)
-    {
-        if(!m_serial->deviceOpened())
-        {
-            QList <Core::IConnection::device> newDev = m_serial->availableDevices();
-            if(devices != newDev)
-            {
-                devices = newDev;
-                emit enumerationChanged();
-            }
-        }
-
-        msleep(2000); //update available devices every two seconds (doesn't need more)
-    }
-}
-
+// One plug sends a burst of events and the port node shows up after the USB device
+#define ENUMERATE_DELAY_MS 500
 
 SerialConnection::SerialConnection()
-    : enablePolling(true), m_enumerateThread(this)
+    : enablePolling(true), m_deviceOpened(false)
 {
     serialHandle = NULL;
     m_config = new SerialPluginConfiguration("Serial Telemetry", NULL, this);
@@ -81,34 +52,56 @@ SerialConnection::SerialConnection()
 
     m_optionspage = new SerialPluginOptionsPage(m_config,this);
 
-
-    // Experimental: enable polling on all OS'es since there
-    // were reports that autodetect does not work on XP amongst
-    // others.
-
-    //#ifdef Q_OS_WIN
-//    //I'm cheating a little bit here:
-//    //Knowing if the device enumeration really changed is a bit complicated
-//    //so I just signal it whenever we have a device event...
-//    QMainWindow *mw = Core::ICore::instance()->mainWindow();
-//    QObject::connect(mw, SIGNAL(deviceChange()),
-//                     this, SLOT(onEnumerationChanged()));
-//#else
-    // Other OSes do not send such signals:
-    QObject::connect(&m_enumerateThread, SIGNAL(enumerationChanged()),
+    m_devices = availableDevices();
+    m_enumerateTimer.setSingleShot(true);
+    m_enumerateTimer.setInterval(ENUMERATE_DELAY_MS);
+    QObject::connect(&m_enumerateTimer, SIGNAL(timeout()),
                      this, SLOT(onEnumerationChanged()));
-    m_enumerateThread.start();
-//#endif
+    QObject::connect(USBMonitor::instance(), SIGNAL(devicesChanged()),
+                     this, SLOT(onDevicesChanged()));
 }
 
 SerialConnection::~SerialConnection()
 {
 }
 
+/**
+ The USB monitor saw a device come or go, enumerate once the burst of events is over
+ */
+void SerialConnection::onDevicesChanged()
+{
+    m_enumerateTimer.start();
+}
+
 void SerialConnection::onEnumerationChanged()
 {
-    if (enablePolling)
+    if (!enablePolling)
+        return;
+    QList <Core::IConnection::device> devices = availableDevices();
+    if (devices != m_devices) {
+        m_devices = devices;
         emit availableDevChanged(this);
+    }
+}
+
+/**
+ Sets the latency timer of an FTDI style adapter, the time it waits for more
+ bytes before handing a partial packet to the host. Only the Linux usb-serial
+ drivers expose it to users, elsewhere it is left to the driver settings.
+ */
+static void setLatencyTimer(const QString &physName, int latency)
+{
+    if (latency <= 0)
+        return;
+#ifdef Q_OS_LINUX
+    QFile timer(QString("/sys/class/tty/%1/device/latency_timer").arg(QFileInfo(physName).fileName()));
+    if (!timer.exists())
+        return;
+    if (!timer.open(QIODevice::WriteOnly) || timer.write(QByteArray::number(latency)) < 0)
+        qDebug() << "Cannot set the latency timer of" << physName << timer.errorString();
+#else
+    Q_UNUSED(physName);
+#endif
 }
 
 bool sortPorts(const QextPortInfo &s1,const QextPortInfo &s2)
@@ -153,11 +146,14 @@ QIODevice *SerialConnection::openDevice(const QString &deviceName)
             set.Parity = PAR_NONE;
             set.StopBits = STOP_1;
             set.FlowControl = FLOW_OFF;
-            set.Timeout_Millisec = 500;
+            // Reads only happen once the port signalled data, so they must not
+            // wait for more, writes still block
+            set.Timeout_Millisec = 0;
+            setLatencyTimer(port.physName, m_config->latency());
 #ifdef Q_OS_WIN
-            serialHandle = new QextSerialPort(port.portName, set);
+            serialHandle = new QextSerialPort(port.portName, set, QextSerialPort::EventDriven);
 #else
-            serialHandle = new QextSerialPort(port.physName, set);
+            serialHandle = new QextSerialPort(port.physName, set, QextSerialPort::EventDriven);
 #endif
             m_deviceOpened = true;
             return serialHandle;
@@ -202,6 +198,7 @@ void SerialConnection::suspendPolling()
 void SerialConnection::resumePolling()
 {
     enablePolling = true;
+    m_enumerateTimer.start();
 }
 
 BaudRateType SerialConnection::stringToBaud(QString str)
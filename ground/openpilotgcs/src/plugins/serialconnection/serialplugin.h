@@ -35,40 +35,17 @@
 #include <extensionsystem/iplugin.h>
 #include "serialpluginconfiguration.h"
 #include "serialpluginoptionspage.h"
-#include <QThread>
+#include <QTimer>
 
 class IConnection;
 class QextSerialEnumerator;
-class SerialConnection;
-
-/**
-*   Helper thread to check on new serial port connection/disconnection
-*   Some operating systems do not send device insertion events so
-*   for those we have to poll
-*/
-//class SERIAL_EXPORT SerialEnumerationThread : public QThread
-class SerialEnumerationThread : public QThread
-{
-    Q_OBJECT
-public:
-    SerialEnumerationThread(SerialConnection *serial);
-    virtual ~SerialEnumerationThread();
-
-    virtual void run();
-
-signals:
-    void enumerationChanged();
-
-protected:
-    SerialConnection *m_serial;
-    bool m_running;
-};
-
 
 /**
 *   Define a connection via the IConnection interface
 *   Plugin will add a instance of this class to the pool,
 *   so the connection manager can use it.
+*   The ports are only enumerated again when the USB monitor reports that
+*   something was plugged or unplugged.
 */
 //class SERIAL_EXPORT SerialConnection
 class SerialConnection
@@ -100,11 +77,14 @@ private:
     SerialPluginOptionsPage *m_optionspage;
     BaudRateType stringToBaud(QString str);
 
+    QList <Core::IConnection::device> m_devices;
+
 protected slots:
+    void onDevicesChanged();
     void onEnumerationChanged();
 
 protected:
-    SerialEnumerationThread m_enumerateThread;
+    QTimer m_enumerateTimer;
     bool m_deviceOpened;
 };
 
@@ -36,7 +36,8 @@
  */
 SerialPluginConfiguration::SerialPluginConfiguration(QString classId, QSettings* qSettings, QObject *parent) :
     IUAVGadgetConfiguration(classId, parent),
-    m_speed("57600")
+    m_speed("57600"),
+    m_latency(0)
 {
     Q_UNUSED(qSettings);
 
@@ -51,6 +52,7 @@ IUAVGadgetConfiguration *SerialPluginConfiguration::clone()
 {
     SerialPluginConfiguration *m = new SerialPluginConfiguration(this->classId());
         m->m_speed=m_speed;
+        m->m_latency=m_latency;
     return m;
 }
 
@@ -60,6 +62,7 @@ IUAVGadgetConfiguration *SerialPluginConfiguration::clone()
  */
 void SerialPluginConfiguration::saveConfig(QSettings* settings) const {
    settings->setValue("speed", m_speed);
+   settings->setValue("latency", m_latency);
 }
 void SerialPluginConfiguration::restoresettings()
 {
@@ -69,6 +72,7 @@ void SerialPluginConfiguration::restoresettings()
         m_speed="57600";
     else
         m_speed=str;
+    m_latency=settings->value(QLatin1String("latency"), 0).toInt();
     settings->endGroup();
 
 }
@@ -76,6 +80,7 @@ void SerialPluginConfiguration::savesettings() const
 {
     settings->beginGroup(QLatin1String("SerialConnection"));
     settings->setValue(QLatin1String("speed"), m_speed);
+    settings->setValue(QLatin1String("latency"), m_latency);
     settings->endGroup();
 }
 SerialPluginConfiguration::~SerialPluginConfiguration()
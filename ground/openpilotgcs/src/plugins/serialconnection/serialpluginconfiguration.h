@@ -42,6 +42,7 @@ Q_OBJECT
 public:
     explicit SerialPluginConfiguration(QString classId, QSettings* qSettings = 0, QObject *parent = 0);
     QString speed() {return m_speed;}
+    int latency() {return m_latency;}
     void saveConfig(QSettings* settings) const;
     IUAVGadgetConfiguration *clone();
     void savesettings() const;
@@ -49,9 +50,11 @@ public:
     virtual ~SerialPluginConfiguration();
 private:
     QString m_speed;
+    int m_latency;
     QSettings* settings;
 public slots:
     void setSpeed(QString speed) { m_speed = speed; }
+    void setLatency(int latency) { m_latency = latency; }
 
 };
 
@@ -40,7 +40,7 @@ const qint16 VehicleConfigurationHelper::RAPID_ESC_FREQUENCE = 400;
 
 VehicleConfigurationHelper::VehicleConfigurationHelper(VehicleConfigurationSource *configSource)
     : m_configSource(configSource), m_uavoManager(0),
-      m_transactionOK(false), m_transactionTimeout(false), m_currentTransactionObjectID(-1),
+      m_transactionOK(false), m_transactionTimeout(false),
       m_progress(0)
 {
     Q_ASSERT(m_configSource);
@@ -53,13 +53,12 @@ bool VehicleConfigurationHelper::setupVehicle(bool save)
 {
     m_progress = 0;
     clearModifiedObjects();
+    snapshotSettings();
+
+    // The reset and the new configuration go up as one batch, settings
+    // the reset and apply leave as they were are not sent at all
     resetVehicleConfig();
     resetGUIData();
-    if(!saveChangesToController(save)) {
-        return false;
-    }
-
-    m_progress = 0;
     applyHardwareConfiguration();
     applyVehicleConfiguration();
     applyActuatorConfiguration();
@@ -69,7 +68,7 @@ bool VehicleConfigurationHelper::setupVehicle(bool save)
     applyManualControlDefaults();
 
     bool result = saveChangesToController(save);
-    emit saveProgress(m_modifiedObjects.count() + 1, ++m_progress, result ? tr("Done!") : tr("Failed!"));
+    emit saveProgress(PROGRESS_STEPS, ++m_progress, result ? tr("Done!") : tr("Failed!"));
     return result;
 }
 
@@ -77,14 +76,38 @@ bool VehicleConfigurationHelper::setupHardwareSettings(bool save)
 {
     m_progress = 0;
     clearModifiedObjects();
+    snapshotSettings();
     applyHardwareConfiguration();
     applyManualControlDefaults();
 
     bool result = saveChangesToController(save);
-    emit saveProgress(m_modifiedObjects.count() + 1, ++m_progress, result ? tr("Done!") : tr("Failed!"));
+    emit saveProgress(PROGRESS_STEPS, ++m_progress, result ? tr("Done!") : tr("Failed!"));
     return result;
 }
 
+/**
+ * Keeps the packed data of all settings as the board has them, before the
+ * wizard changes anything, so only the settings that really changed are sent.
+ */
+void VehicleConfigurationHelper::snapshotSettings()
+{
+    m_settingsSnapshot.clear();
+    foreach(QList<UAVDataObject*> instances, m_uavoManager->getDataObjects()) {
+        foreach(UAVDataObject *obj, instances) {
+            if(obj->isSettings()) {
+                m_settingsSnapshot.insert(obj, packedData(obj));
+            }
+        }
+    }
+}
+
+QByteArray VehicleConfigurationHelper::packedData(UAVDataObject *object)
+{
+    QByteArray data(object->getNumBytes(), 0);
+    object->pack((quint8*)data.data());
+    return data;
+}
+
 void VehicleConfigurationHelper::addModifiedObject(UAVDataObject *object, QString description)
 {
     m_modifiedObjects << new QPair<UAVDataObject*, QString>(object, description);
@@ -411,91 +434,81 @@ void VehicleConfigurationHelper::applyManualControlDefaults()
 
 bool VehicleConfigurationHelper::saveChangesToController(bool save)
 {
-    qDebug() << "Saving modified objects to controller. " << m_modifiedObjects.count() << " objects in found.";
-    const int OUTER_TIMEOUT = 3000 * 20; // 10 seconds timeout for saving all objects
-    const int INNER_TIMEOUT = 2000; // 1 second timeout on every save attempt
+    const int TIMEOUT = 3000 * 20; // Timeout for sending and saving the whole batch
+
+    // Only the writable settings that differ from what the board has, once each
+    QList<UAVObject*> changedObjects;
+    for(int i = 0; i < m_modifiedObjects.count(); i++) {
+        UAVDataObject* obj = m_modifiedObjects.at(i)->first;
+        if(UAVObject::GetGcsAccess(obj->getMetadata()) == UAVObject::ACCESS_READONLY || !obj->isSettings()) {
+            qDebug() << "Trying to save a UAVDataObject that is read only or is not a settings object.";
+            continue;
+        }
+        if(!changedObjects.contains(obj) && m_settingsSnapshot.value(obj) != packedData(obj)) {
+            changedObjects << obj;
+        }
+    }
+    qDebug() << "Saving modified objects to controller. " << changedObjects.count() << " of "
+             << m_modifiedObjects.count() << " objects changed.";
+
+    emit saveProgress(PROGRESS_STEPS, ++m_progress, tr("Writing %1 changed settings").arg(changedObjects.count()));
+    if(changedObjects.isEmpty()) {
+        return true;
+    }
 
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
     Q_ASSERT(pm);
     UAVObjectUtilManager* utilMngr = pm->getObject<UAVObjectUtilManager>();
     Q_ASSERT(utilMngr);
 
-    QTimer outerTimeoutTimer;
-    outerTimeoutTimer.setSingleShot(true);
-
-    QTimer innerTimeoutTimer;
-    innerTimeoutTimer.setSingleShot(true);
-
-    connect(utilMngr, SIGNAL(saveCompleted(int ,bool)), this, SLOT(uAVOTransactionCompleted(int, bool)));
-    connect(&innerTimeoutTimer, SIGNAL(timeout()), &m_eventLoop, SLOT(quit()));
-    connect(&outerTimeoutTimer, SIGNAL(timeout()), this, SLOT(saveChangesTimeout()));
+    QTimer timeoutTimer;
+    timeoutTimer.setSingleShot(true);
+    connect(&timeoutTimer, SIGNAL(timeout()), this, SLOT(saveChangesTimeout()));
 
-    outerTimeoutTimer.start(OUTER_TIMEOUT);
-    for(int i = 0; i < m_modifiedObjects.count(); i++) {
-        QPair<UAVDataObject*, QString> *objPair = m_modifiedObjects.at(i);
-        m_transactionOK = false;
-        UAVDataObject* obj = objPair->first;
-        QString objDescription = objPair->second;
-        if(UAVObject::GetGcsAccess(obj->getMetadata()) != UAVObject::ACCESS_READONLY && obj->isSettings()) {
-
-            emit saveProgress(m_modifiedObjects.count() + 1, ++m_progress, objDescription);
-
-            m_currentTransactionObjectID = obj->getObjID();
+    m_transactionOK = true;
+    m_transactionTimeout = false;
+    m_pendingObjects.clear();
+    foreach(UAVObject *obj, changedObjects) {
+        m_pendingObjects.insert(obj->getObjID());
+    }
 
+    // The whole batch is in flight at once, the settings are persisted with
+    // a single save once they are all acknowledged
+    if(save) {
+        connect(utilMngr, SIGNAL(saveCompleted(int ,bool)), this, SLOT(uAVOTransactionCompleted(int, bool)));
+        utilMngr->saveObjectsToSD(changedObjects);
+    }
+    else {
+        foreach(UAVObject *obj, changedObjects) {
             connect(obj, SIGNAL(transactionCompleted(UAVObject* ,bool)), this, SLOT(uAVOTransactionCompleted(UAVObject*, bool)));
-            while(!m_transactionOK && !m_transactionTimeout) {
-                // Allow the transaction to take some time
-                innerTimeoutTimer.start(INNER_TIMEOUT);
-
-                // Set object updated
-                obj->updated();
-                if(!m_transactionOK) {
-                    m_eventLoop.exec();
-                }
-                innerTimeoutTimer.stop();
-            }
-            disconnect(obj, SIGNAL(transactionCompleted(UAVObject* ,bool)), this, SLOT(uAVOTransactionCompleted(UAVObject*, bool)));
-            if(m_transactionOK) {
-                qDebug() << "Object " << obj->getName() << " was successfully updated.";
-                if(save) {
-                    m_transactionOK = false;
-                    m_currentTransactionObjectID = obj->getObjID();
-                    // Try to save until success or timeout
-                    while(!m_transactionOK && !m_transactionTimeout) {
-                        // Allow the transaction to take some time
-                        innerTimeoutTimer.start(INNER_TIMEOUT);
-
-                        // Persist object in controller
-                        utilMngr->saveObjectToSD(obj);
-                        if(!m_transactionOK) {
-                            m_eventLoop.exec();
-                        }
-                        innerTimeoutTimer.stop();
-                    }
-                    m_currentTransactionObjectID = -1;
-                }
-            }
-
-            if(!m_transactionOK) {
-                qDebug() << "Transaction timed out when trying to save: " << obj->getName();
-            }
-            else {
-                qDebug() << "Object " << obj->getName() << " was successfully saved.";
-            }
-        }
-        else {
-            qDebug() << "Trying to save a UAVDataObject that is read only or is not a settings object.";
+            obj->updated();
         }
-        if(m_transactionTimeout) {
-            qDebug() << "Transaction timed out when trying to save " << m_modifiedObjects.count() << " objects.";
-            break;
+    }
+    timeoutTimer.start(TIMEOUT);
+    if(!m_pendingObjects.isEmpty()) {
+        m_eventLoop.exec();
+    }
+    timeoutTimer.stop();
+
+    if(save) {
+        disconnect(utilMngr, SIGNAL(saveCompleted(int, bool)), this, SLOT(uAVOTransactionCompleted(int, bool)));
+    }
+    else {
+        foreach(UAVObject *obj, changedObjects) {
+            disconnect(obj, SIGNAL(transactionCompleted(UAVObject* ,bool)), this, SLOT(uAVOTransactionCompleted(UAVObject*, bool)));
         }
     }
 
-    outerTimeoutTimer.stop();
-    disconnect(&outerTimeoutTimer, SIGNAL(timeout()), this, SLOT(saveChangesTimeout()));
-    disconnect(&innerTimeoutTimer, SIGNAL(timeout()), &m_eventLoop, SLOT(quit()));
-    disconnect(utilMngr, SIGNAL(saveCompleted(int, bool)), this, SLOT(uAVOTransactionCompleted(int, bool)));
+    if(m_transactionTimeout) {
+        qDebug() << "Transaction timed out when trying to save " << changedObjects.count() << " objects.";
+    }
+    else if(m_transactionOK) {
+        // The board has them now, a later batch does not send them again
+        foreach(UAVObject *obj, changedObjects) {
+            UAVDataObject *dataObj = static_cast<UAVDataObject*>(obj);
+            m_settingsSnapshot.insert(dataObj, packedData(dataObj));
+        }
+    }
 
     qDebug() << "Finished saving modified objects to controller. Success = " << m_transactionOK;
 
@@ -504,10 +517,15 @@ bool VehicleConfigurationHelper::saveChangesToController(bool save)
 
 void VehicleConfigurationHelper::uAVOTransactionCompleted(int oid, bool success)
 {
-    if(oid == m_currentTransactionObjectID)
+    if(m_pendingObjects.remove(oid))
     {
-        m_transactionOK = success;
-        m_eventLoop.quit();
+        if(!success) {
+            qDebug() << "Failed to save object " << oid;
+            m_transactionOK = false;
+        }
+        if(m_pendingObjects.isEmpty()) {
+            m_eventLoop.quit();
+        }
     }
 }
 
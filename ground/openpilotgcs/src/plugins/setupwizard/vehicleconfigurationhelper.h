@@ -30,6 +30,9 @@
 
 #include <QList>
 #include <QPair>
+#include <QHash>
+#include <QSet>
+#include <QByteArray>
 #include "vehicleconfigurationsource.h"
 #include "uavobjectmanager.h"
 #include "systemsettings.h"
@@ -69,6 +72,8 @@ private:
     static const int MIXER_TYPE_MOTOR = 1;
     static const int MIXER_TYPE_SERVO = 2;
     static const float DEFAULT_ENABLED_ACCEL_TAU = 0.1;
+    // One step for the batch of changed settings, one for the result
+    static const int PROGRESS_STEPS = 2;
 
     VehicleConfigurationSource *m_configSource;
     UAVObjectManager *m_uavoManager;
@@ -77,6 +82,11 @@ private:
     void addModifiedObject(UAVDataObject* object, QString description);
     void clearModifiedObjects();
 
+    // Settings as they were before the wizard changed them
+    QHash<UAVDataObject*, QByteArray> m_settingsSnapshot;
+    void snapshotSettings();
+    static QByteArray packedData(UAVDataObject *object);
+
     void applyHardwareConfiguration();
     void applyVehicleConfiguration();
     void applyActuatorConfiguration();
@@ -94,7 +104,7 @@ private:
     QEventLoop m_eventLoop;
     bool m_transactionOK;
     bool m_transactionTimeout;
-    int m_currentTransactionObjectID;
+    QSet<int> m_pendingObjects;
     int m_progress;
 
     void resetVehicleConfig();
@@ -30,8 +30,11 @@
 #include "extensionsystem/pluginmanager.h"
 #include "uavobjectmanager.h"
 #include "systemalarms.h"
+#include "cpuprofile.h"
+#include "telemetrylatency.h"
 
 #include <QDebug>
+#include <QMap>
 #include <QWhatsThis>
 
 /*
@@ -56,7 +59,8 @@ SystemHealthGadgetWidget::SystemHealthGadgetWidget(QWidget *parent) : QGraphicsV
     UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
 
     SystemAlarms* obj = dynamic_cast<SystemAlarms*>(objManager->getObject(QString("SystemAlarms")));
-    connect(obj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(updateAlarms(UAVObject*)));
+    // The alarms are sent periodically but seldom change, only redraw when they do
+    connect(obj, SIGNAL(objectContentChanged(UAVObject*)), this, SLOT(updateAlarms(UAVObject*)));
 
     // Listen to autopilot connection events
     TelemetryManager* telMngr = pm->getObject<TelemetryManager>();
@@ -82,41 +86,58 @@ void SystemHealthGadgetWidget::onAutopilotDisconnect()
     nolink->setVisible(true);
 }
 
-void SystemHealthGadgetWidget::updateAlarms(UAVObject* systemAlarm)
+/**
+  * Place one hidden item on each alarm block of the diagram, the
+  * element positions are only looked up here when a file is loaded
+  */
+void SystemHealthGadgetWidget::createAlarmItems()
 {
-    // This code does not know anything about alarms beforehand, and
-    // I found no efficient way to locate items inside the scene by
-    // name, so it's just as simple to reset the scene:
-    // And add the one with the right name.
-    QGraphicsScene *m_scene = scene();
-    foreach ( QGraphicsItem* item ,background->childItems()){
-        m_scene->removeItem(item);
-        delete item; // removeItem does _not_ delete the item.
+    qDeleteAll(alarmItems);
+    alarmItems.clear();
+
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
+    SystemAlarms* obj = dynamic_cast<SystemAlarms*>(objManager->getObject(QString("SystemAlarms")));
+
+    foreach (UAVObjectField *field, obj->getFields()) {
+        foreach (QString element, field->getElementNames()) {
+            if (m_renderer->elementExists(element)) {
+                QMatrix blockMatrix = m_renderer->matrixForElement(element);
+                QPointF start = blockMatrix.mapRect(m_renderer->boundsOnElement(element)).topLeft();
+                QGraphicsSvgItem *ind = new QGraphicsSvgItem();
+                ind->setSharedRenderer(m_renderer);
+                ind->setParentItem(background);
+                ind->setVisible(false);
+                // The state is only rasterized again when it changes
+                ind->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+                QTransform matrix;
+                matrix.translate(start.x(), start.y());
+                ind->setTransform(matrix,false);
+                alarmItems.insert(element, ind);
+            } else {
+                qDebug() << "Warning: Element " << element << " not found in SVG.";
+            }
+        }
     }
+}
 
-    QString alarm = systemAlarm->getName();
+void SystemHealthGadgetWidget::updateAlarms(UAVObject* systemAlarm)
+{
     foreach (UAVObjectField *field, systemAlarm->getFields()) {
         for (uint i = 0; i < field->getNumElements(); ++i) {
-            QString element = field->getElementNames()[i];
+            QGraphicsSvgItem *ind = alarmItems.value(field->getElementNames()[i]);
+            if (!ind)
+                continue;
             QString value = field->getValue(i).toString();
-            if (m_renderer->elementExists(element)) {
-                QMatrix blockMatrix = m_renderer->matrixForElement(element);
-                qreal startX = blockMatrix.mapRect(m_renderer->boundsOnElement(element)).x();
-                qreal startY = blockMatrix.mapRect(m_renderer->boundsOnElement(element)).y();
-                QString element2 = element + "-" + value;
-                if (m_renderer->elementExists(element2)) {
-                    QGraphicsSvgItem *ind = new QGraphicsSvgItem();
-                    ind->setSharedRenderer(m_renderer);
-                    ind->setElementId(element2);
-                    ind->setParentItem(background);
-                    QTransform matrix;
-                    matrix.translate(startX,startY);
-                    ind->setTransform(matrix,false);
-                } else {
-                    if (value.compare("Uninitialised")!=0)qDebug() << "Warning: element " << element2 << " not found in SVG.";
-                }
+            QString element2 = field->getElementNames()[i] + "-" + value;
+            if (ind->isVisible() && ind->elementId() == element2)
+                continue;
+            if (m_renderer->elementExists(element2)) {
+                ind->setElementId(element2);
+                ind->setVisible(true);
             } else {
-                qDebug() << "Warning: Element " << element << " not found in SVG.";
+                ind->setVisible(false);
+                if (value.compare("Uninitialised")!=0)qDebug() << "Warning: element " << element2 << " not found in SVG.";
             }
         }
     }
@@ -137,11 +158,13 @@ void SystemHealthGadgetWidget::setSystemFile(QString dfn)
            fgenabled = false;
            background->setSharedRenderer(m_renderer);
            background->setElementId("background");
+           background->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 
            if (m_renderer->elementExists("foreground")) {
                foreground->setSharedRenderer(m_renderer);
                foreground->setElementId("foreground");
                foreground->setZValue(99);
+               foreground->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
                fgenabled = true;
            }
            if (m_renderer->elementExists("nolink")) {
@@ -150,6 +173,8 @@ void SystemHealthGadgetWidget::setSystemFile(QString dfn)
                nolink->setZValue(100);
            }
 
+         createAlarmItems();
+
          QGraphicsScene *l_scene = scene();
          l_scene->setSceneRect(background->boundingRect());
          fitInView(background, Qt::KeepAspectRatio );
@@ -215,12 +240,18 @@ void SystemHealthGadgetWidget::mousePressEvent ( QMouseEvent * event )
                     // would always call showAllAlarmDescriptions...
                     haveAlarmItem = true;
                     QString itemId = clickedItem->elementId();
+                    // Profiling firmware tells where the CPU time goes, the telemetry how long it takes
+                    QString extraText;
+                    if (itemId.startsWith("CPU-"))
+                        extraText = cpuProfileText();
+                    else if (itemId.startsWith("Telemetry-"))
+                        extraText = latencyText();
                     if(itemId.contains("OK")){
                         // No alarm set for this item
-                        showAlarmDescriptionForItemId("AlarmOK", event->globalPos());
+                        showAlarmDescriptionForItemId("AlarmOK", event->globalPos(), extraText);
                     }else{
                         // Warning, error or critical alarm
-                        showAlarmDescriptionForItemId(itemId, event->globalPos());
+                        showAlarmDescriptionForItemId(itemId, event->globalPos(), extraText);
                     }
                 }else if(!haveAlarmItem){
                     // Clicked foreground or background
@@ -231,14 +262,106 @@ void SystemHealthGadgetWidget::mousePressEvent ( QMouseEvent * event )
     }
 }
 
-void SystemHealthGadgetWidget::showAlarmDescriptionForItemId(const QString itemId, const QPoint& location){
+void SystemHealthGadgetWidget::showAlarmDescriptionForItemId(const QString itemId, const QPoint& location, const QString& extraText){
     QFile alarmDescription(":/systemhealth/html/" + itemId + ".html");
     if(alarmDescription.open(QIODevice::ReadOnly | QIODevice::Text)){
         QTextStream textStream(&alarmDescription);
-        QWhatsThis::showText(location, textStream.readAll());
+        QWhatsThis::showText(location, textStream.readAll() + extraText);
     }
 }
 
+/**
+  * Table of the tasks and interrupt handlers using the CPU, empty unless
+  * the firmware was built with DIAG_PROFILE and has sent CPUProfile
+  */
+QString SystemHealthGadgetWidget::cpuProfileText()
+{
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
+    CPUProfile* obj = dynamic_cast<CPUProfile*>(objManager->getObject(QString("CPUProfile")));
+    if (!obj)
+        return QString();
+
+    CPUProfile::DataFields data = obj->getData();
+    UAVObjectField *taskField = obj->getField("TaskLoad");
+    UAVObjectField *irqField = obj->getField("IRQLoad");
+
+    // Heaviest first
+    QMultiMap<float, int> tasks;
+    for (int i = 0; i < CPUProfile::TASKLOAD_NUMELEM; ++i) {
+        if (data.TaskLoad[i] > 0)
+            tasks.insert(data.TaskLoad[i], i);
+    }
+    if (tasks.isEmpty())
+        return QString();
+
+    QString text = "<p><b>" + tr("CPU profile") + "</b></p><table>";
+    text += "<tr><th align=\"left\">" + tr("Task") + "</th><th>" + tr("Load") + "</th><th>" +
+            tr("Longest run") + "</th><th>" + tr("Switches") + "</th></tr>";
+    QMapIterator<float, int> i(tasks);
+    i.toBack();
+    while (i.hasPrevious()) {
+        int n = i.previous().value();
+        text += QString("<tr><td>%1</td><td align=\"right\">%2%</td><td align=\"right\">%3 us</td><td align=\"right\">%4</td></tr>")
+                .arg(taskField->getElementNames()[n])
+                .arg(data.TaskLoad[n], 0, 'f', 1)
+                .arg(data.TaskMaxSlice[n])
+                .arg(data.TaskSwitches[n]);
+    }
+
+    text += "<tr><th align=\"left\">" + tr("Interrupt") + "</th><th>" + tr("Load") + "</th><th>" +
+            tr("Longest run") + "</th><th>" + tr("Calls") + "</th></tr>";
+    for (int n = 0; n < CPUProfile::IRQLOAD_NUMELEM; ++n) {
+        if (data.IRQCount[n] == 0)
+            continue;
+        text += QString("<tr><td>%1</td><td align=\"right\">%2%</td><td align=\"right\">%3 us</td><td align=\"right\">%4</td></tr>")
+                .arg(irqField->getElementNames()[n])
+                .arg(data.IRQLoad[n], 0, 'f', 1)
+                .arg(data.IRQMaxTime[n])
+                .arg(data.IRQCount[n]);
+    }
+    text += "</table><p>" + tr("%1 context switches").arg(data.ContextSwitches) + "</p>";
+
+    return text;
+}
+
+/**
+  * Table of the telemetry latencies measured with pings over the last
+  * minute, empty unless the firmware sends the pings back
+  */
+QString SystemHealthGadgetWidget::latencyText()
+{
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
+    TelemetryLatency* obj = TelemetryLatency::GetInstance(objManager);
+    if (!obj)
+        return QString();
+
+    TelemetryLatency::DataFields data = obj->getData();
+    if (data.RoundTripTime[TelemetryLatency::ROUNDTRIPTIME_MAX] == 0)
+        return QString();
+
+    QString text = "<p><b>" + tr("Telemetry latency") + "</b></p><table>";
+    text += "<tr><th align=\"left\"></th><th>" + tr("Median") + "</th><th>" + tr("95%") + "</th><th>" +
+            tr("Max") + "</th></tr>";
+    QString row("<tr><td>%1</td><td align=\"right\">%2 ms</td><td align=\"right\">%3 ms</td><td align=\"right\">%4 ms</td></tr>");
+    text += row.arg(tr("Round trip"))
+            .arg(data.RoundTripTime[TelemetryLatency::ROUNDTRIPTIME_MEDIAN])
+            .arg(data.RoundTripTime[TelemetryLatency::ROUNDTRIPTIME_P95])
+            .arg(data.RoundTripTime[TelemetryLatency::ROUNDTRIPTIME_MAX]);
+    text += row.arg(tr("To the autopilot"))
+            .arg(data.UplinkLatency[TelemetryLatency::UPLINKLATENCY_MEDIAN])
+            .arg(data.UplinkLatency[TelemetryLatency::UPLINKLATENCY_P95])
+            .arg(data.UplinkLatency[TelemetryLatency::UPLINKLATENCY_MAX]);
+    text += row.arg(tr("From the autopilot"))
+            .arg(data.DownlinkLatency[TelemetryLatency::DOWNLINKLATENCY_MEDIAN])
+            .arg(data.DownlinkLatency[TelemetryLatency::DOWNLINKLATENCY_P95])
+            .arg(data.DownlinkLatency[TelemetryLatency::DOWNLINKLATENCY_MAX]);
+    text += "</table><p>" + tr("One way times assume the fastest ping took as long both ways.") + "</p>";
+
+    return text;
+}
+
 void SystemHealthGadgetWidget::showAllAlarmDescriptions(const QPoint& location){
     QGraphicsScene *graphicsScene = scene();
     if(graphicsScene){
@@ -247,7 +370,7 @@ void SystemHealthGadgetWidget::showAllAlarmDescriptions(const QPoint& location){
         // Loop through all items in the scene looking for svg items that represent alarms
         foreach(QGraphicsItem* curItem, graphicsScene->items()){
             QGraphicsSvgItem* curSvgItem = dynamic_cast<QGraphicsSvgItem*>(curItem);
-            if(curSvgItem && (curSvgItem != foreground) && (curSvgItem != background)){
+            if(curSvgItem && curSvgItem->isVisible() && (curSvgItem != foreground) && (curSvgItem != background)){
                 QString elementId = curSvgItem->elementId();
                 if(!elementId.contains("OK")){
                     // Found an alarm, get its corresponding alarm html file contents
@@ -37,6 +37,7 @@
 #include <QMouseEvent>
 
 #include <QFile>
+#include <QMap>
 #include <QTimer>
 
 class SystemHealthGadgetWidget : public QGraphicsView
@@ -69,7 +70,14 @@ private:
                    // Simple flag to skip rendering if the
    bool fgenabled; // layer does not exist.
 
-   void showAlarmDescriptionForItemId(const QString itemId, const QPoint& location);
+   // One item per alarm, by alarm name, switched between the
+   // "<alarm>-<state>" elements when the alarm changes state
+   QMap<QString, QGraphicsSvgItem*> alarmItems;
+
+   void createAlarmItems();
+   void showAlarmDescriptionForItemId(const QString itemId, const QPoint& location, const QString& extraText = QString());
+   QString cpuProfileText();
+   QString latencyText();
    void showAllAlarmDescriptions(const QPoint &location);
 
 };
@@ -0,0 +1,53 @@
+/**
+ ******************************************************************************
+ *
+ * @file       browsermemoryreporter.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectBrowserPlugin UAVObject Browser Plugin
+ * @{
+ * @brief The UAVObject Browser gadget plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef BROWSERMEMORYREPORTER_H
+#define BROWSERMEMORYREPORTER_H
+
+#include <coreplugin/imemoryreporter.h>
+
+class UAVObjectBrowserWidget;
+
+/**
+ * Reports the tree of one browser to the Memory Usage page, the field items
+ * only exist while their object is expanded.
+ */
+class BrowserMemoryReporter : public Core::IMemoryReporter
+{
+    Q_OBJECT
+public:
+    BrowserMemoryReporter(UAVObjectBrowserWidget *widget) : m_widget(widget) {}
+
+    QString memoryGroup() const;
+    QList<Usage> memoryUsage() const;
+
+private:
+    UAVObjectBrowserWidget *m_widget;
+};
+
+#endif // BROWSERMEMORYREPORTER_H
@@ -105,7 +105,8 @@ TreeItem::TreeItem(const QList<QVariant> &data, TreeItem *parent) :
         m_data(data),
         m_parent(parent),
         m_highlight(false),
-        m_changed(false)
+        m_changed(false),
+        m_highlightManager(0)
 {
 }
 
@@ -113,13 +114,17 @@ TreeItem::TreeItem(const QVariant &data, TreeItem *parent) :
         QObject(0),
         m_parent(parent),
         m_highlight(false),
-        m_changed(false)
+        m_changed(false),
+        m_highlightManager(0)
 {
     m_data << data << "" << "";
 }
 
 TreeItem::~TreeItem()
 {
+    // Items are deleted when collapsed, do not leave them to the highlight manager
+    if (m_highlightManager)
+        m_highlightManager->remove(this);
     qDeleteAll(m_children);
 }
 
@@ -136,6 +141,12 @@ void TreeItem::insertChild(TreeItem *child)
     child->setParentTree(this);
 }
 
+void TreeItem::removeChildren(int row, int count)
+{
+    for (int i = 0; i < count; ++i)
+        delete m_children.takeAt(row);
+}
+
 TreeItem *TreeItem::getChild(int index)
 {
     return m_children.value(index);
@@ -146,6 +157,16 @@ int TreeItem::childCount() const
     return m_children.count();
 }
 
+qint64 TreeItem::memoryBytes(qint64 *items) const
+{
+    qint64 bytes = sizeof(*this) + m_data.size() * sizeof(QVariant)
+            + m_description.capacity() * sizeof(QChar) + m_children.size() * sizeof(TreeItem*);
+    ++*items;
+    foreach (TreeItem *child, m_children)
+        bytes += child->memoryBytes(items);
+    return bytes;
+}
+
 int TreeItem::row() const
 {
     if (m_parent)
@@ -96,10 +96,13 @@ public:
 
     void appendChild(TreeItem *child);
     void insertChild(TreeItem *child);
+    void removeChildren(int row, int count);
 
     TreeItem *getChild(int index);
     inline QList<TreeItem*> treeChildren() const { return m_children; }
     int childCount() const;
+    // Estimate of the bytes held by the item and its children, items counts them
+    qint64 memoryBytes(qint64 *items) const;
     int columnCount() const;
     QVariant data(int column = 1) const;
     QString description() { return m_description; }
@@ -208,13 +211,17 @@ class ObjectTreeItem : public TreeItem
 Q_OBJECT
 public:
     ObjectTreeItem(const QList<QVariant> &data, TreeItem *parent = 0) :
-            TreeItem(data, parent), m_obj(0) { }
+            TreeItem(data, parent), m_obj(0), m_populated(false) { }
     ObjectTreeItem(const QVariant &data, TreeItem *parent = 0) :
-            TreeItem(data, parent), m_obj(0) { }
+            TreeItem(data, parent), m_obj(0), m_populated(false) { }
     void setObject(UAVObject *obj) { m_obj = obj; setDescription(obj->getDescription()); }
     inline UAVObject *object() { return m_obj; }
+    // Field items are only created while the object is expanded
+    inline bool populated() { return m_populated; }
+    inline void setPopulated(bool populated) { m_populated = populated; }
 private:
     UAVObject *m_obj;
+    bool m_populated;
 };
 
 class MetaObjectTreeItem : public ObjectTreeItem
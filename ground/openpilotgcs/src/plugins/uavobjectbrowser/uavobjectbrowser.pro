@@ -11,7 +11,8 @@ HEADERS += browserplugin.h \
     uavobjecttreemodel.h \
     treeitem.h \
     browseritemdelegate.h \
-    fieldtreeitem.h
+    fieldtreeitem.h \
+    browsermemoryreporter.h
 SOURCES += browserplugin.cpp \
     uavobjectbrowserconfiguration.cpp \
     uavobjectbrowser.cpp \
@@ -21,7 +22,8 @@ SOURCES += browserplugin.cpp \
     uavobjecttreemodel.cpp \
     treeitem.cpp \
     browseritemdelegate.cpp \
-    fieldtreeitem.cpp
+    fieldtreeitem.cpp \
+    browsermemoryreporter.cpp
 OTHER_FILES += UAVObjectBrowser.pluginspec
 FORMS += uavobjectbrowser.ui \
     uavobjectbrowseroptionspage.ui \
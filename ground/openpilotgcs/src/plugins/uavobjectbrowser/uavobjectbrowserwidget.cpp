@@ -39,6 +39,7 @@
 #include <QtCore/QDebug>
 #include <QtGui/QItemEditorFactory>
 #include "extensionsystem/pluginmanager.h"
+#include "browsermemoryreporter.h"
 
 UAVObjectBrowserWidget::UAVObjectBrowserWidget(QWidget *parent) : QWidget(parent)
 {
@@ -57,6 +58,8 @@ UAVObjectBrowserWidget::UAVObjectBrowserWidget(QWidget *parent) : QWidget(parent
     m_browser->treeView->setSelectionBehavior(QAbstractItemView::SelectItems);
     showMetaData(m_viewoptions->cbMetaData->isChecked());
     connect(m_browser->treeView->selectionModel(), SIGNAL(currentChanged(QModelIndex,QModelIndex)), this, SLOT(currentChanged(QModelIndex,QModelIndex)));
+    connect(m_browser->treeView, SIGNAL(expanded(QModelIndex)), this, SLOT(itemExpanded(QModelIndex)));
+    connect(m_browser->treeView, SIGNAL(collapsed(QModelIndex)), this, SLOT(itemCollapsed(QModelIndex)));
     connect(m_viewoptions->cbMetaData, SIGNAL(toggled(bool)), this, SLOT(showMetaData(bool)));
     connect(m_viewoptions->cbCategorized, SIGNAL(toggled(bool)), this, SLOT(categorize(bool)));
     connect(m_browser->saveSDButton, SIGNAL(clicked()), this, SLOT(saveObject()));
@@ -70,10 +73,15 @@ UAVObjectBrowserWidget::UAVObjectBrowserWidget(QWidget *parent) : QWidget(parent
     connect(m_viewoptions->cbMetaData, SIGNAL(toggled(bool)), this, SLOT(viewOptionsChangedSlot()));
     connect(m_viewoptions->cbCategorized, SIGNAL(toggled(bool)), this, SLOT(viewOptionsChangedSlot()));
     enableSendRequest(false);
+
+    m_memoryReporter = new BrowserMemoryReporter(this);
+    ExtensionSystem::PluginManager::instance()->addObject(m_memoryReporter);
 }
 
 UAVObjectBrowserWidget::~UAVObjectBrowserWidget()
 {
+    ExtensionSystem::PluginManager::instance()->removeObject(m_memoryReporter);
+    delete m_memoryReporter;
     delete m_browser;
 }
 
@@ -248,6 +256,16 @@ void UAVObjectBrowserWidget::viewOptionsChangedSlot()
     emit viewOptionsChanged(m_viewoptions->cbCategorized->isChecked(),m_viewoptions->cbScientific->isChecked(),m_viewoptions->cbMetaData->isChecked());
 }
 
+void UAVObjectBrowserWidget::itemExpanded(const QModelIndex &index)
+{
+    m_model->setExpanded(index, true);
+}
+
+void UAVObjectBrowserWidget::itemCollapsed(const QModelIndex &index)
+{
+    m_model->setExpanded(index, false);
+}
+
 void UAVObjectBrowserWidget::enableSendRequest(bool enable)
 {
     m_browser->sendButton->setEnabled(enable);
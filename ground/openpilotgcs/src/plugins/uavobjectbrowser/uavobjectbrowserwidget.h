@@ -37,6 +37,7 @@ class QPushButton;
 class ObjectTreeItem;
 class Ui_UAVObjectBrowser;
 class Ui_viewoptions;
+class BrowserMemoryReporter;
 
 class UAVObjectBrowserWidget : public QWidget
 {
@@ -50,6 +51,7 @@ public:
     void setRecentlyUpdatedTimeout(int timeout) { m_recentlyUpdatedTimeout = timeout; m_model->setRecentlyUpdatedTimeout(timeout); }
     void setOnlyHilightChangedValues(bool hilight) { m_onlyHilightChangedValues = hilight; m_model->setOnlyHilightChangedValues(hilight); }
     void setViewOptions(bool categorized,bool scientific,bool metadata);
+    const UAVObjectTreeModel *model() const { return m_model; }
 public slots:
     void showMetaData(bool show);
     void categorize(bool categorize);
@@ -64,6 +66,8 @@ private slots:
     void currentChanged(const QModelIndex &current, const QModelIndex &previous);
     void viewSlot();
     void viewOptionsChangedSlot();
+    void itemExpanded(const QModelIndex &index);
+    void itemCollapsed(const QModelIndex &index);
 signals:
     void viewOptionsChanged(bool categorized,bool scientific,bool metadata);
 private:
@@ -73,6 +77,7 @@ private:
     Ui_viewoptions *m_viewoptions;
     QDialog *m_viewoptionsDialog;
     UAVObjectTreeModel *m_model;
+    BrowserMemoryReporter *m_memoryReporter;
 
     int m_recentlyUpdatedTimeout;
     QColor m_recentlyUpdatedColor;
@@ -50,8 +50,11 @@ UAVObjectTreeModel::UAVObjectTreeModel(QObject *parent, bool categorize, bool us
 
     // Create highlight manager, let it run every 300 ms.
     m_highlightManager = new HighLightManager(300);
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(REFRESH_INTERVAL_MS);
+    connect(&m_refreshTimer, SIGNAL(timeout()), this, SLOT(refreshUpdatedObjects()));
     connect(objManager, SIGNAL(newObject(UAVObject*)), this, SLOT(newObject(UAVObject*)));
-    connect(objManager, SIGNAL(newInstance(UAVObject*)), this, SLOT(newObject(UAVObject*)));
+    connect(objManager, SIGNAL(newInstances(QList<UAVObject*>)), this, SLOT(newInstances(QList<UAVObject*>)));
 
     TreeItem::setHighlightTime(m_recentlyUpdatedTimeout);
     setupModelData(objManager, categorize);
@@ -59,8 +62,19 @@ UAVObjectTreeModel::UAVObjectTreeModel(QObject *parent, bool categorize, bool us
 
 UAVObjectTreeModel::~UAVObjectTreeModel()
 {
-    delete m_highlightManager;
+    foreach (UAVObject *obj, m_shownObjects)
+        obj->removeInterest();
     delete m_rootItem;
+    delete m_highlightManager;
+}
+
+qint64 UAVObjectTreeModel::memoryBytes(qint64 *items) const
+{
+    *items = 0;
+    qint64 bytes = m_rootItem->memoryBytes(items);
+    bytes += m_objectTreeItems.size() * (2 * sizeof(void*) + sizeof(uint));
+    bytes += (m_pendingObjects.size() + m_expandedItems.size() + m_staleItems.size()) * (sizeof(void*) + sizeof(uint));
+    return bytes;
 }
 
 void UAVObjectTreeModel::setupModelData(UAVObjectManager *objManager, bool categorize)
@@ -96,6 +110,13 @@ void UAVObjectTreeModel::newObject(UAVObject *obj)
     }
 }
 
+void UAVObjectTreeModel::newInstances(QList<UAVObject*> objs)
+{
+    foreach (UAVObject* obj, objs) {
+        newObject(obj);
+    }
+}
+
 void UAVObjectTreeModel::addDataObject(UAVDataObject *obj, bool categorize)
 {
     TopTreeItem *root = obj->isSettings() ? m_settingsTree : m_nonSettingsTree;
@@ -149,25 +170,18 @@ MetaObjectTreeItem* UAVObjectTreeModel::addMetaObject(UAVMetaObject *obj, TreeIt
 
     meta->setHighlightManager(m_highlightManager);
     connect(meta, SIGNAL(updateHighlight(TreeItem*)), this, SLOT(updateHighlight(TreeItem*)));
-    foreach (UAVObjectField *field, obj->getFields()) {
-        if (field->getNumElements() > 1) {
-            addArrayField(field, meta);
-        } else {
-            addSingleField(0, field, meta);
-        }
-    }
     parent->appendChild(meta);
+    m_objectTreeItems[obj] = meta;
     return meta;
 }
 
 void UAVObjectTreeModel::addInstance(UAVObject *obj, TreeItem *parent)
 {
     connect(obj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(highlightUpdatedObject(UAVObject*)));
-    TreeItem *item;
+    ObjectTreeItem *item;
     if (obj->isSingleInstance()) {
-        item = parent;
-        DataObjectTreeItem *p = static_cast<DataObjectTreeItem*>(parent);
-        p->setObject(obj);
+        item = static_cast<DataObjectTreeItem*>(parent);
+        item->setObject(obj);
     } else {
         QString name = tr("Instance") +  " " + QString::number(obj->getInstID());
         item = new InstanceTreeItem(obj, name);
@@ -175,13 +189,58 @@ void UAVObjectTreeModel::addInstance(UAVObject *obj, TreeItem *parent)
         connect(item, SIGNAL(updateHighlight(TreeItem*)), this, SLOT(updateHighlight(TreeItem*)));
         parent->appendChild(item);
     }
-    foreach (UAVObjectField *field, obj->getFields()) {
+    m_objectTreeItems[obj] = item;
+}
+
+/*
+ * Field items are created in fetchMore() when the object is expanded.
+ * They are appended after the meta data and instance items.
+ */
+void UAVObjectTreeModel::addFields(ObjectTreeItem *item)
+{
+    foreach (UAVObjectField *field, item->object()->getFields()) {
         if (field->getNumElements() > 1) {
             addArrayField(field, item);
         } else {
             addSingleField(0, field, item);
         }
     }
+    item->setPopulated(true);
+}
+
+/*
+ * Delete the field items of a collapsed object, unless they hold edits
+ * that have not been sent yet.
+ */
+void UAVObjectTreeModel::trimFields(ObjectTreeItem *item)
+{
+    int first = item->childCount();
+    while (first > 0 && !dynamic_cast<ObjectTreeItem*>(item->getChild(first - 1)))
+        --first;
+    for (int i = first; i < item->childCount(); ++i) {
+        TreeItem *field = item->getChild(i);
+        if (field->changed())
+            return;
+        foreach (TreeItem *element, field->treeChildren()) {
+            if (element->changed())
+                return;
+        }
+    }
+    if (first < item->childCount()) {
+        beginRemoveRows(index(item), first, item->childCount() - 1);
+        for (int i = first; i < item->childCount(); ++i)
+            forgetExpanded(item->getChild(i));
+        item->removeChildren(first, item->childCount() - first);
+        endRemoveRows();
+    }
+    item->setPopulated(false);
+}
+
+void UAVObjectTreeModel::forgetExpanded(TreeItem *item)
+{
+    m_expandedItems.remove(item);
+    foreach (TreeItem *child, item->treeChildren())
+        forgetExpanded(child);
 }
 
 void UAVObjectTreeModel::addArrayField(UAVObjectField *field, TreeItem *parent)
@@ -263,16 +322,7 @@ QModelIndex UAVObjectTreeModel::index(TreeItem *item)
     if (item->parent() == 0)
         return QModelIndex();
 
-    QModelIndex root = index(item->parent());
-
-    for (int i = 0; i < rowCount(root); ++i) {
-        QModelIndex childIndex = index(i, 0, root);
-        TreeItem *child = static_cast<TreeItem*>(childIndex.internalPointer());
-        if (child == item)
-            return childIndex;
-    }
-    Q_ASSERT(false);
-    return QModelIndex();
+    return createIndex(item->row(), 0, item);
 }
 
 QModelIndex UAVObjectTreeModel::parent(const QModelIndex &index) const
@@ -311,6 +361,35 @@ int UAVObjectTreeModel::columnCount(const QModelIndex &parent) const
         return m_rootItem->columnCount();
 }
 
+bool UAVObjectTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    if (canFetchMore(parent))
+        return true;
+    return QAbstractItemModel::hasChildren(parent);
+}
+
+bool UAVObjectTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (!parent.isValid() || parent.column() > 0)
+        return false;
+    ObjectTreeItem *item = dynamic_cast<ObjectTreeItem*>(static_cast<TreeItem*>(parent.internalPointer()));
+    return item && item->object() && !item->populated();
+}
+
+void UAVObjectTreeModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+    ObjectTreeItem *item = static_cast<ObjectTreeItem*>(static_cast<TreeItem*>(parent.internalPointer()));
+    int first = item->childCount();
+    int count = item->object()->getFields().count();
+    if (count > 0)
+        beginInsertRows(parent, first, first + count - 1);
+    addFields(item);
+    if (count > 0)
+        endInsertRows();
+}
+
 QList<QModelIndex> UAVObjectTreeModel::getMetaDataIndexes()
 {
     QList<QModelIndex> metaIndexes;
@@ -406,14 +485,42 @@ QVariant UAVObjectTreeModel::headerData(int section, Qt::Orientation orientation
     return QVariant();
 }
 
+/*
+ * Objects can update hundreds of times per second, only note the object
+ * here and refresh all updated objects together once per frame.
+ */
 void UAVObjectTreeModel::highlightUpdatedObject(UAVObject *obj)
 {
     Q_ASSERT(obj);
-    ObjectTreeItem *item = findObjectTreeItem(obj);
-    Q_ASSERT(item);
-    if(!m_onlyHilightChangedValues){
-        item->setHighlight(true);
+    m_pendingObjects.insert(obj);
+    if (!m_refreshTimer.isActive())
+        m_refreshTimer.start();
+}
+
+void UAVObjectTreeModel::refreshUpdatedObjects()
+{
+    QSet<UAVObject*> pending;
+    pending.swap(m_pendingObjects);
+    foreach (UAVObject *obj, pending) {
+        ObjectTreeItem *item = findObjectTreeItem(obj);
+        Q_ASSERT(item);
+        if (!item)
+            continue;
+        if(!m_onlyHilightChangedValues){
+            item->setHighlight(true);
+        }
+        // Field items of collapsed objects are refreshed when they are shown
+        if (isVisible(item)) {
+            refreshObjectItem(item);
+        } else {
+            m_staleItems.insert(item);
+        }
     }
+}
+
+void UAVObjectTreeModel::refreshObjectItem(ObjectTreeItem *item)
+{
+    m_staleItems.remove(item);
     item->update();
     if(!m_onlyHilightChangedValues){
         QModelIndex itemIndex = index(item);
@@ -422,31 +529,62 @@ void UAVObjectTreeModel::highlightUpdatedObject(UAVObject *obj)
     }
 }
 
-ObjectTreeItem *UAVObjectTreeModel::findObjectTreeItem(UAVObject *object)
+/*
+ * The children of an item are shown when the item and all its parents are expanded.
+ */
+bool UAVObjectTreeModel::isVisible(TreeItem *item)
 {
-    UAVDataObject *dataObject = qobject_cast<UAVDataObject*>(object);
-    UAVMetaObject *metaObject = qobject_cast<UAVMetaObject*>(object);
-    Q_ASSERT(dataObject || metaObject);
-    if (dataObject) {
-        return findDataObjectTreeItem(dataObject);
-    } else {
-        return findMetaObjectTreeItem(metaObject);
+    for (; item && item != m_rootItem; item = item->parent()) {
+        if (!m_expandedItems.contains(item))
+            return false;
     }
-    return 0;
+    return true;
 }
 
-DataObjectTreeItem* UAVObjectTreeModel::findDataObjectTreeItem(UAVDataObject *obj)
+void UAVObjectTreeModel::setExpanded(const QModelIndex &index, bool expanded)
 {
-    TopTreeItem *root = obj->isSettings() ? m_settingsTree : m_nonSettingsTree;
-    return root->findDataObjectTreeItemByObjectId(obj->getObjID());
+    if (!index.isValid())
+        return;
+    TreeItem *item = static_cast<TreeItem*>(index.internalPointer());
+    if (!expanded) {
+        m_expandedItems.remove(item);
+        ObjectTreeItem *objItem = dynamic_cast<ObjectTreeItem*>(item);
+        if (objItem && objItem->populated())
+            trimFields(objItem);
+        updateInterest();
+        return;
+    }
+    m_expandedItems.insert(item);
+    updateInterest();
+
+    // Catch up on the objects that were updated while hidden
+    foreach (ObjectTreeItem *stale, m_staleItems) {
+        if (isVisible(stale))
+            refreshObjectItem(stale);
+    }
+}
+
+/*
+ * A data object is shown while its fields are visible.
+ */
+void UAVObjectTreeModel::updateInterest()
+{
+    QSet<UAVObject*> shown;
+    foreach (TreeItem *item, m_expandedItems) {
+        ObjectTreeItem *objItem = dynamic_cast<ObjectTreeItem*>(item);
+        if (objItem && dynamic_cast<UAVDataObject*>(objItem->object()) && isVisible(objItem))
+            shown.insert(objItem->object());
+    }
+    foreach (UAVObject *obj, shown - m_shownObjects)
+        obj->addInterest();
+    foreach (UAVObject *obj, m_shownObjects - shown)
+        obj->removeInterest();
+    m_shownObjects = shown;
 }
 
-MetaObjectTreeItem* UAVObjectTreeModel::findMetaObjectTreeItem(UAVMetaObject *obj)
+ObjectTreeItem *UAVObjectTreeModel::findObjectTreeItem(UAVObject *object)
 {
-    UAVDataObject *dataObject = qobject_cast<UAVDataObject*>(obj->getParentObject());
-    Q_ASSERT(dataObject);
-    TopTreeItem *root = dataObject->isSettings() ? m_settingsTree : m_nonSettingsTree;
-    return root->findMetaObjectTreeItemByObjectId(obj->getObjID());
+    return m_objectTreeItems.value(object);
 }
 
 void UAVObjectTreeModel::updateHighlight(TreeItem *item)
@@ -32,6 +32,9 @@
 #include <QAbstractItemModel>
 #include <QtCore/QMap>
 #include <QtCore/QList>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
 #include <QtGui/QColor>
 
 class TopTreeItem;
@@ -43,7 +46,6 @@ class UAVMetaObject;
 class UAVObjectField;
 class UAVObjectManager;
 class QSignalMapper;
-class QTimer;
 
 class UAVObjectTreeModel : public QAbstractItemModel
 {
@@ -62,6 +64,9 @@ public:
     QModelIndex parent(const QModelIndex &index) const;
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const;
+    bool canFetchMore(const QModelIndex &parent) const;
+    void fetchMore(const QModelIndex &parent);
 
     void setRecentlyUpdatedColor(QColor color) { m_recentlyUpdatedColor = color; }
     void setManuallyChangedColor(QColor color) { m_manuallyChangedColor = color; }
@@ -73,14 +78,25 @@ public:
 
     QList<QModelIndex> getMetaDataIndexes();
 
+    // Called by the view when a row is expanded or collapsed, field items
+    // are only refreshed while all their parents are expanded and are
+    // deleted again when their object is collapsed.
+    void setExpanded(const QModelIndex &index, bool expanded);
+
+    // Estimate of the bytes held by the tree and its indexes, items gets the
+    // number of tree items
+    qint64 memoryBytes(qint64 *items) const;
+
 signals:
 
 public slots:
     void newObject(UAVObject *obj);
+    void newInstances(QList<UAVObject*> objs);
 
 private slots:
     void highlightUpdatedObject(UAVObject *obj);
     void updateHighlight(TreeItem*);
+    void refreshUpdatedObjects();
 
 private:
     void setupModelData(UAVObjectManager *objManager, bool categorize = true);
@@ -90,13 +106,17 @@ private:
     void addArrayField(UAVObjectField *field, TreeItem *parent);
     void addSingleField(int index, UAVObjectField *field, TreeItem *parent);
     void addInstance(UAVObject *obj, TreeItem *parent);
+    void addFields(ObjectTreeItem *item);
+    void trimFields(ObjectTreeItem *item);
+    void forgetExpanded(TreeItem *item);
 
     TreeItem *createCategoryItems(QStringList categoryPath, TreeItem *root);
 
     QString updateMode(quint8 updateMode);
     ObjectTreeItem *findObjectTreeItem(UAVObject *obj);
-    DataObjectTreeItem *findDataObjectTreeItem(UAVDataObject *obj);
-    MetaObjectTreeItem *findMetaObjectTreeItem(UAVMetaObject *obj);
+    bool isVisible(TreeItem *item);
+    void updateInterest();
+    void refreshObjectItem(ObjectTreeItem *item);
 
     TreeItem *m_rootItem;
     TopTreeItem *m_settingsTree;
@@ -109,6 +129,19 @@ private:
 
     // Highlight manager to handle highlighting of tree items.
     HighLightManager *m_highlightManager;
+
+    // Object and instance items by object, updates are collected in
+    // m_pendingObjects and refreshed together once per frame.
+    static const int REFRESH_INTERVAL_MS = 40;
+    QHash<UAVObject*, ObjectTreeItem*> m_objectTreeItems;
+    QSet<UAVObject*> m_pendingObjects;
+    QTimer m_refreshTimer;
+
+    // Expanded rows, and items updated while they were hidden
+    QSet<TreeItem*> m_expandedItems;
+    QSet<ObjectTreeItem*> m_staleItems;
+    // Data objects whose fields are shown, see UAVObject::addInterest()
+    QSet<UAVObject*> m_shownObjects;
 };
 
 #endif // UAVOBJECTTREEMODEL_H
@@ -0,0 +1,82 @@
+#!/usr/bin/env python
+##
+##############################################################################
+#
+# @file       comparebenchmarks.py
+# @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+# @brief      Compares two QTestLib XML benchmark results
+#
+#             uavobjectsbenchmark -xml -o baseline.xml
+#             ... change things, rebuild ...
+#             uavobjectsbenchmark -xml -o current.xml
+#             comparebenchmarks.py baseline.xml current.xml
+#
+#             Exits with 1 when a benchmark got slower than the threshold.
+#
+# @see        The GNU Public License (GPL) Version 3
+#
+#############################################################################/
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+# for more details.
+#
+# You should have received a copy of the GNU General Public License along
+# with this program; if not, write to the Free Software Foundation, Inc.,
+# 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+#
+
+import sys
+import optparse
+import xml.etree.ElementTree as ElementTree
+
+def load(path):
+    """Returns {(function, tag): (metric, value per iteration)}"""
+    results = {}
+    for function in ElementTree.parse(path).getroot().iter("TestFunction"):
+        for result in function.iter("BenchmarkResult"):
+            iterations = max(1, int(result.get("iterations", "1")))
+            value = float(result.get("value")) / iterations
+            key = (function.get("name"), result.get("tag", ""))
+            results[key] = (result.get("metric"), value)
+    return results
+
+def main():
+    parser = optparse.OptionParser(usage="%prog [-t percent] baseline.xml current.xml")
+    parser.add_option("-t", "--threshold", type="float", default=10.0,
+                      help="slowdown in percent reported as a regression (default 10)")
+    options, args = parser.parse_args()
+    if len(args) != 2:
+        parser.error("two result files are needed")
+
+    baseline = load(args[0])
+    current = load(args[1])
+    regressions = 0
+    print ("%-40s %-10s %12s %12s %8s" % ("benchmark", "metric", "baseline", "current", "change"))
+    for key in sorted(set(baseline) | set(current)):
+        name = "%s(%s)" % key if key[1] else key[0]
+        if key not in baseline or key not in current:
+            print ("%-40s %s" % (name, "only in " + (args[1] if key in current else args[0])))
+            continue
+        metric, before = baseline[key]
+        after = current[key][1]
+        change = (after - before) * 100.0 / before if before > 0 else 0.0
+        flag = ""
+        if change > options.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print ("%-40s %-10s %12.6g %12.6g %+7.1f%%%s" % (name, metric, before, after, change, flag))
+
+    if regressions:
+        print ("%d regression(s) over %.0f%%" % (regressions, options.threshold))
+        return 1
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
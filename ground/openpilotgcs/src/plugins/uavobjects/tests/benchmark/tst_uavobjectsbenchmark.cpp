@@ -0,0 +1,431 @@
+/**
+ ******************************************************************************
+ *
+ * @file       tst_uavobjectsbenchmark.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      QTestLib micro-benchmarks of the GCS object paths: packing,
+ *             field access, object lookups, UAVTalk decode, scope data and
+ *             the object browser model. Run with -xml -o <file> to keep the
+ *             results, comparebenchmarks.py compares two such files.
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <extensionsystem/pluginmanager.h>
+#include "uavobjectmanager.h"
+#include "uavobjectsinit.h"
+#include "uavdataobject.h"
+#include "uavobjectfield.h"
+#include "uavtalk/uavtalk.h"
+#include "plotdata.h"
+#include "uavobjecttreemodel.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QIODevice>
+#include <QtTest/QtTest>
+#include <string.h>
+
+/**
+ * Unbuffered sequential device, feed() hands a block to UAVTalk synchronously
+ * through readyRead() so no event loop is involved. What UAVTalk writes is
+ * kept, that is how the frames to decode are made.
+ */
+class LinkDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    LinkDevice() : chunk(0), chunkSize(0), pos(0)
+    {
+        open(QIODevice::ReadWrite | QIODevice::Unbuffered);
+    }
+
+    void feed(const QByteArray &data)
+    {
+        chunk = data.constData();
+        chunkSize = data.size();
+        pos = 0;
+        emit readyRead();
+    }
+
+    bool isSequential() const { return true; }
+    qint64 bytesAvailable() const { return chunkSize - pos; }
+
+    QByteArray written;
+
+protected:
+    qint64 readData(char *data, qint64 maxlen)
+    {
+        qint64 count = qMin(maxlen, chunkSize - pos);
+        memcpy(data, chunk + pos, count);
+        pos += count;
+        return count;
+    }
+
+    qint64 writeData(const char *data, qint64 len)
+    {
+        written.append(data, len);
+        return len;
+    }
+
+private:
+    const char *chunk;
+    qint64 chunkSize;
+    qint64 pos;
+};
+
+class tst_UAVObjectsBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void pack_data();
+    void pack();
+    void unpack_data();
+    void unpack();
+    void fieldGetDouble_data();
+    void fieldGetDouble();
+    void fieldSetDouble_data();
+    void fieldSetDouble();
+    void fieldGetValue_data();
+    void fieldGetValue();
+    void managerLookup_data();
+    void managerLookup();
+    void saveState();
+    void restoreState();
+    void uavTalkDecode_data();
+    void uavTalkDecode();
+    void plotDataAppend_data();
+    void plotDataAppend();
+    void treeModelUpdate_data();
+    void treeModelUpdate();
+
+private:
+    void objectData();
+    void fieldTypeData();
+    UAVObjectField *findField(UAVObjectField::FieldType type);
+    QModelIndex findRow(QAbstractItemModel *model, const QModelIndex &parent, const QString &name);
+
+    ExtensionSystem::PluginManager *pluginManager;
+    UAVObjectManager *objMngr;
+};
+
+void tst_UAVObjectsBenchmark::initTestCase()
+{
+    // The browser model finds the object manager through the plugin manager
+    pluginManager = new ExtensionSystem::PluginManager();
+    objMngr = new UAVObjectManager();
+    UAVObjectsInitialize(objMngr);
+    pluginManager->addObject(objMngr);
+}
+
+void tst_UAVObjectsBenchmark::cleanupTestCase()
+{
+    pluginManager->removeObject(objMngr);
+    delete objMngr;
+    delete pluginManager;
+}
+
+/**
+ * A small and a large telemetry object, an enum array and two large settings
+ */
+void tst_UAVObjectsBenchmark::objectData()
+{
+    QTest::addColumn<QString>("name");
+    QTest::newRow("Gyros") << "Gyros";
+    QTest::newRow("AttitudeActual") << "AttitudeActual";
+    QTest::newRow("SystemAlarms") << "SystemAlarms";
+    QTest::newRow("ActuatorSettings") << "ActuatorSettings";
+    QTest::newRow("StabilizationSettings") << "StabilizationSettings";
+}
+
+void tst_UAVObjectsBenchmark::pack_data()
+{
+    objectData();
+}
+
+void tst_UAVObjectsBenchmark::pack()
+{
+    QFETCH(QString, name);
+    UAVObject *obj = objMngr->getObject(name);
+    QVERIFY(obj);
+    QByteArray buffer(obj->getNumBytes(), 0);
+    QBENCHMARK {
+        obj->pack((quint8*)buffer.data());
+    }
+}
+
+void tst_UAVObjectsBenchmark::unpack_data()
+{
+    objectData();
+}
+
+void tst_UAVObjectsBenchmark::unpack()
+{
+    QFETCH(QString, name);
+    UAVObject *obj = objMngr->getObject(name);
+    QVERIFY(obj);
+    QByteArray buffer(obj->getNumBytes(), 0);
+    obj->pack((quint8*)buffer.data());
+    QBENCHMARK {
+        obj->unpack((const quint8*)buffer.constData());
+    }
+}
+
+void tst_UAVObjectsBenchmark::fieldTypeData()
+{
+    QTest::addColumn<int>("type");
+    QTest::newRow("int8") << (int)UAVObjectField::INT8;
+    QTest::newRow("int16") << (int)UAVObjectField::INT16;
+    QTest::newRow("int32") << (int)UAVObjectField::INT32;
+    QTest::newRow("uint8") << (int)UAVObjectField::UINT8;
+    QTest::newRow("uint16") << (int)UAVObjectField::UINT16;
+    QTest::newRow("uint32") << (int)UAVObjectField::UINT32;
+    QTest::newRow("float32") << (int)UAVObjectField::FLOAT32;
+    QTest::newRow("enum") << (int)UAVObjectField::ENUM;
+}
+
+/**
+ * First field of the type in any of the registered objects
+ */
+UAVObjectField *tst_UAVObjectsBenchmark::findField(UAVObjectField::FieldType type)
+{
+    foreach (QList<UAVObject*> instances, objMngr->getObjects()) {
+        foreach (UAVObjectField *field, instances.first()->getFields()) {
+            if (field->getType() == type)
+                return field;
+        }
+    }
+    return 0;
+}
+
+void tst_UAVObjectsBenchmark::fieldGetDouble_data()
+{
+    fieldTypeData();
+}
+
+void tst_UAVObjectsBenchmark::fieldGetDouble()
+{
+    QFETCH(int, type);
+    UAVObjectField *field = findField((UAVObjectField::FieldType)type);
+    if (!field)
+        QSKIP("No field of this type", SkipSingle);
+    double sum = 0;
+    QBENCHMARK {
+        sum += field->getDouble(0);
+    }
+    Q_UNUSED(sum);
+}
+
+void tst_UAVObjectsBenchmark::fieldSetDouble_data()
+{
+    fieldTypeData();
+}
+
+void tst_UAVObjectsBenchmark::fieldSetDouble()
+{
+    QFETCH(int, type);
+    UAVObjectField *field = findField((UAVObjectField::FieldType)type);
+    if (!field)
+        QSKIP("No field of this type", SkipSingle);
+    double value = field->getDouble(0);
+    QBENCHMARK {
+        field->setDouble(value, 0);
+    }
+}
+
+void tst_UAVObjectsBenchmark::fieldGetValue_data()
+{
+    fieldTypeData();
+}
+
+void tst_UAVObjectsBenchmark::fieldGetValue()
+{
+    QFETCH(int, type);
+    UAVObjectField *field = findField((UAVObjectField::FieldType)type);
+    if (!field)
+        QSKIP("No field of this type", SkipSingle);
+    QVariant value;
+    QBENCHMARK {
+        value = field->getValue(0);
+    }
+}
+
+void tst_UAVObjectsBenchmark::managerLookup_data()
+{
+    QTest::addColumn<bool>("byName");
+    QTest::newRow("name") << true;
+    QTest::newRow("id") << false;
+}
+
+void tst_UAVObjectsBenchmark::managerLookup()
+{
+    QFETCH(bool, byName);
+    UAVObject *gyros = objMngr->getObject(QString("Gyros"));
+    QVERIFY(gyros);
+    const QString name = gyros->getName();
+    const quint32 objId = gyros->getObjID();
+    UAVObject *found = 0;
+    if (byName) {
+        QBENCHMARK {
+            found = objMngr->getObject(name);
+        }
+    } else {
+        QBENCHMARK {
+            found = objMngr->getObject(objId);
+        }
+    }
+    QCOMPARE(found, gyros);
+}
+
+void tst_UAVObjectsBenchmark::saveState()
+{
+    QByteArray state;
+    QBENCHMARK {
+        state = objMngr->saveState();
+    }
+    QVERIFY(!state.isEmpty());
+}
+
+void tst_UAVObjectsBenchmark::restoreState()
+{
+    QByteArray state = objMngr->saveState();
+    int restored = 0;
+    QBENCHMARK {
+        restored = objMngr->restoreState(state);
+    }
+    QVERIFY(restored > 0);
+}
+
+void tst_UAVObjectsBenchmark::uavTalkDecode_data()
+{
+    QTest::addColumn<QStringList>("names");
+    QTest::newRow("telemetry") << (QStringList() << "Gyros" << "Accels" << "AttitudeActual"
+                                   << "ActuatorCommand" << "ManualControlCommand" << "SystemStats");
+    QTest::newRow("settings") << (QStringList() << "SystemSettings" << "ActuatorSettings"
+                                  << "StabilizationSettings" << "ManualControlSettings");
+}
+
+/**
+ * The frames are what UAVTalk sends for the objects, repeated to make a
+ * stream of a few kilobytes, decoded in one block
+ */
+void tst_UAVObjectsBenchmark::uavTalkDecode()
+{
+    QFETCH(QStringList, names);
+    LinkDevice device;
+    UAVTalk utalk(&device, objMngr);
+    foreach (QString name, names) {
+        UAVObject *obj = objMngr->getObject(name);
+        QVERIFY(obj);
+        utalk.sendObject(obj, false, false);
+    }
+    QVERIFY(!device.written.isEmpty());
+    QByteArray stream;
+    while (stream.size() < 4096)
+        stream.append(device.written);
+
+    utalk.resetStats();
+    device.feed(stream);
+    UAVTalk::ComStats stats = utalk.getStats();
+    QCOMPARE(stats.rxErrors, (quint32)0);
+    QVERIFY(stats.rxObjects > 0);
+
+    QBENCHMARK {
+        device.feed(stream);
+    }
+}
+
+void tst_UAVObjectsBenchmark::plotDataAppend_data()
+{
+    QTest::addColumn<bool>("chrono");
+    QTest::newRow("sequential") << false;
+    QTest::newRow("chrono") << true;
+}
+
+void tst_UAVObjectsBenchmark::plotDataAppend()
+{
+    QFETCH(bool, chrono);
+    UAVObject *gyros = objMngr->getObject(QString("Gyros"));
+    QVERIFY(gyros);
+    PlotData *plotData;
+    if (chrono)
+        plotData = new ChronoPlotData("Gyros", "x");
+    else
+        plotData = new SequentialPlotData("Gyros", "x");
+    plotData->m_xWindowSize = 1000;
+    QVERIFY(plotData->bindField(gyros, gyros->getField("x")));
+    QBENCHMARK {
+        plotData->append(gyros);
+    }
+    delete plotData;
+}
+
+void tst_UAVObjectsBenchmark::treeModelUpdate_data()
+{
+    QTest::addColumn<bool>("expanded");
+    QTest::newRow("collapsed") << false;
+    QTest::newRow("expanded") << true;
+}
+
+QModelIndex tst_UAVObjectsBenchmark::findRow(QAbstractItemModel *model, const QModelIndex &parent, const QString &name)
+{
+    for (int row = 0; row < model->rowCount(parent); ++row) {
+        QModelIndex index = model->index(row, 0, parent);
+        if (model->data(index, Qt::DisplayRole).toString() == name)
+            return index;
+    }
+    return QModelIndex();
+}
+
+/**
+ * An object update as the model handles it, the refresh normally runs from
+ * its timer after the updates are collected
+ */
+void tst_UAVObjectsBenchmark::treeModelUpdate()
+{
+    QFETCH(bool, expanded);
+    UAVDataObject *gyros = dynamic_cast<UAVDataObject*>(objMngr->getObject(QString("Gyros")));
+    QVERIFY(gyros);
+    UAVObjectTreeModel model(0, false);
+    if (expanded) {
+        QModelIndex dataObjects = findRow(&model, QModelIndex(), model.tr("Data Objects"));
+        QVERIFY(dataObjects.isValid());
+        QModelIndex item = findRow(&model, dataObjects, gyros->getName());
+        QVERIFY(item.isValid());
+        model.setExpanded(dataObjects, true);
+        model.setExpanded(item, true);
+        model.fetchMore(item);
+    }
+    UAVObjectField *field = gyros->getField("x");
+    QVERIFY(field);
+    double value = 0;
+    QBENCHMARK {
+        field->setDouble(value);
+        value += 1;
+        gyros->updated();
+        QMetaObject::invokeMethod(&model, "refreshUpdatedObjects", Qt::DirectConnection);
+    }
+}
+
+QTEST_MAIN(tst_UAVObjectsBenchmark)
+
+#include "tst_uavobjectsbenchmark.moc"
@@ -0,0 +1,56 @@
+#-------------------------------------------------
+#
+# QTestLib micro-benchmarks of the GCS object paths.
+# Build it from a GCS build tree after the plugins are built, e.g.
+#   qmake ../../src/plugins/uavobjects/tests/benchmark GCS_BUILD_TREE=<build>/ground/openpilotgcs
+# and record a baseline with
+#   uavobjectsbenchmark -xml -o baseline.xml
+# then compare a later run against it with comparebenchmarks.py.
+#
+#-------------------------------------------------
+
+QT       += core gui network
+CONFIG   += qtestlib console
+CONFIG   -= app_bundle
+
+TARGET = uavobjectsbenchmark
+TEMPLATE = app
+
+include(../../../../../openpilotgcs.pri)
+
+DESTDIR = $$GCS_APP_PATH
+LIBS += -L$$GCS_PLUGIN_PATH/OpenPilot
+INCLUDEPATH += $$GCS_SOURCE_TREE/src/plugins
+
+include(../../../uavtalk/uavtalk.pri)
+include(../../../../libs/qwt/qwt.pri)
+include(../../../../libs/qscispinbox/qscispinbox.pri)
+
+linux-* {
+    QMAKE_LFLAGS += \'-Wl,-rpath,$$GCS_PLUGIN_PATH/OpenPilot:$$GCS_PLUGIN_PATH/OpenPilot/..:$$GCS_LIBRARY_PATH\'
+}
+
+# The scope and browser classes are not exported by their plugins,
+# the ones benchmarked are built in
+SCOPE = ../../../scope
+BROWSER = ../../../uavobjectbrowser
+INCLUDEPATH += $$SCOPE $$BROWSER
+
+HEADERS += $$SCOPE/plotdata.h \
+    $$SCOPE/plotenvelope.h \
+    $$SCOPE/plotmath.h \
+    $$SCOPE/plotspectrum.h \
+    $$BROWSER/uavobjecttreemodel.h \
+    $$BROWSER/treeitem.h \
+    $$BROWSER/fieldtreeitem.h
+
+SOURCES += tst_uavobjectsbenchmark.cpp \
+    $$SCOPE/plotdata.cpp \
+    $$SCOPE/plotenvelope.cpp \
+    $$SCOPE/plotmath.cpp \
+    $$SCOPE/plotspectrum.cpp \
+    $$BROWSER/uavobjecttreemodel.cpp \
+    $$BROWSER/treeitem.cpp \
+    $$BROWSER/fieldtreeitem.cpp
+
+OTHER_FILES += comparebenchmarks.py
@@ -92,7 +92,9 @@ UAVObject::Metadata UAVMetaObject::getDefaultMetadata()
 void UAVMetaObject::setData(const Metadata& mdata)
 {
     QMutexLocker locker(mutex);
+    beginWrite();
     parentMetadata = mdata;
+    endWrite();
     emit objectUpdatedAuto(this); // trigger object updated event
     emit objectUpdated(this);
 }
@@ -102,8 +104,9 @@ void UAVMetaObject::setData(const Metadata& mdata)
  */
 UAVObject::Metadata UAVMetaObject::getData()
 {
-    QMutexLocker locker(mutex);
-    return parentMetadata;
+    Metadata mdata;
+    readData((quint8*)&mdata, 0, sizeof(Metadata));
+    return mdata;
 }
 
 
@@ -28,6 +28,8 @@
 #include "uavobject.h"
 #include <QtEndian>
 #include <QDebug>
+#include <QVarLengthArray>
+#include <string.h>
 
 // Constants
 #define UAVOBJ_ACCESS_SHIFT 0
@@ -53,7 +55,19 @@ UAVObject::UAVObject(quint32 objID, bool isSingleInst, const QString& name)
     this->instID = 0;
     this->isSingleInst = isSingleInst;
     this->name = name;
+    this->updateTime = 0;
     this->mutex = new QMutex(QMutex::Recursive);
+    this->data = NULL;
+    this->writeDepth = 0;
+}
+
+/**
+ * Destructor, the fields belong to the object
+ */
+UAVObject::~UAVObject()
+{
+    qDeleteAll(fields);
+    delete mutex;
 }
 
 /**
@@ -83,7 +97,6 @@ void UAVObject::initializeFields(QList<UAVObjectField*>& fields, quint8* data, q
     {
         fields[n]->initialize(data, offset, this);
         offset += fields[n]->getNumBytes();
-        connect(fields[n], SIGNAL(fieldUpdated(UAVObjectField*)), this, SLOT(fieldUpdated(UAVObjectField*)));
     }
 }
 
@@ -113,6 +126,26 @@ quint32 UAVObject::getInstID()
     return instID;
 }
 
+/**
+ * Get the time the last update was received from the link, in ms since the epoch.
+ * Zero if the object was never received.
+ */
+qint64 UAVObject::getUpdateTime()
+{
+    QMutexLocker locker(mutex);
+    return updateTime;
+}
+
+/**
+ * Set the time the data about to be unpacked was received, called by the telemetry
+ * before unpack() so the update signals already see it
+ */
+void UAVObject::setUpdateTime(qint64 msecsSinceEpoch)
+{
+    QMutexLocker locker(mutex);
+    updateTime = msecsSinceEpoch;
+}
+
 /**
  * Returns true if this is a single instance object
  */
@@ -219,6 +252,63 @@ QMutex* UAVObject::getMutex()
     return mutex;
 }
 
+/**
+ * Mark the start of a change to the object data. Writers must hold the object
+ * mutex, calls can be nested and only the outermost pair is seen by readers.
+ */
+void UAVObject::beginWrite()
+{
+    if (writeDepth++ == 0)
+    {
+        dataSeq.fetchAndAddOrdered(1);
+    }
+}
+
+/**
+ * Mark the end of a change to the object data, see beginWrite()
+ */
+void UAVObject::endWrite()
+{
+    if (--writeDepth == 0)
+    {
+        dataSeq.fetchAndAddOrdered(1);
+    }
+}
+
+/**
+ * Copy part of the object data without taking the mutex. The copy is retried
+ * until no write overlapped it, so readers get a consistent snapshot and never
+ * make the telemetry wait for them.
+ * @param dataOut Buffer of at least length bytes
+ * @param offset Offset of the first byte in the object data
+ * @param length Number of bytes to copy
+ */
+void UAVObject::readData(quint8* dataOut, quint32 offset, quint32 length) const
+{
+    int seq;
+    do
+    {
+        seq = readBegin();
+        memcpy(dataOut, &data[offset], length);
+    } while (readRetry(seq));
+}
+
+/**
+ * Overwrite part of the object data as it is held in memory, without any
+ * conversion and without emitting objectUpdated(). The caller reports the
+ * change, see UAVObjectManager::restoreState().
+ * @param dataIn Buffer of at least length bytes
+ * @param offset Offset of the first byte in the object data
+ * @param length Number of bytes to copy
+ */
+void UAVObject::writeData(const quint8* dataIn, quint32 offset, quint32 length)
+{
+    QMutexLocker locker(mutex);
+    beginWrite();
+    memcpy(&data[offset], dataIn, length);
+    endWrite();
+}
+
 /**
  * Get the number of fields held by this object
  */
@@ -274,24 +364,86 @@ qint32 UAVObject::pack(quint8* dataOut)
 }
 
 /**
- * Unpack the object data from a byte array
+ * Unpack the object data from a byte array. objectContentChanged() is emitted
+ * as well if the data differs from what it was, the data is only compared
+ * while something is connected to that signal.
  * @returns The number of bytes copied
  */
 qint32 UAVObject::unpack(const quint8* dataIn)
 {
     QMutexLocker locker(mutex);
+    QVarLengthArray<quint8, 256> previous;
+    bool compare = receivers(SIGNAL(objectContentChanged(UAVObject*))) > 0;
+    if (compare)
+    {
+        previous.append(data, numBytes);
+    }
     qint32 offset = 0;
+    beginWrite();
     for (int n = 0; n < fields.length(); ++n)
     {
         fields[n]->unpack(&dataIn[offset]);
         offset += fields[n]->getNumBytes();
     }
+    endWrite();
     emit objectUnpacked(this); // trigger object updated event
     emit objectUpdated(this);
+    if (compare && memcmp(previous.constData(), data, numBytes) != 0)
+    {
+        emit objectContentChanged(this);
+    }
 
     return numBytes;
 }
 
+/**
+ * Unpack only some of the fields from a byte array holding their data back to
+ * back in field order. Bit n of the mask selects field n, the last bit selects
+ * all fields from the 32nd on, as produced by the flight side delta updates.
+ * Nothing is changed if the length does not match the selected fields.
+ * @returns The number of bytes copied or -1 on a length mismatch
+ */
+qint32 UAVObject::unpackFields(const quint8* dataIn, quint32 length, quint32 fieldMask)
+{
+    QMutexLocker locker(mutex);
+    quint32 size = 0;
+    for (int n = 0; n < fields.length(); ++n)
+    {
+        if (fieldMask & (1UL << qMin(n, 31)))
+            size += fields[n]->getNumBytes();
+    }
+    if (size != length)
+    {
+        return -1;
+    }
+
+    QVarLengthArray<quint8, 256> previous;
+    bool compare = receivers(SIGNAL(objectContentChanged(UAVObject*))) > 0;
+    if (compare)
+    {
+        previous.append(data, numBytes);
+    }
+    qint32 offset = 0;
+    beginWrite();
+    for (int n = 0; n < fields.length(); ++n)
+    {
+        if (fieldMask & (1UL << qMin(n, 31)))
+        {
+            fields[n]->unpack(&dataIn[offset]);
+            offset += fields[n]->getNumBytes();
+        }
+    }
+    endWrite();
+    emit objectUnpacked(this); // trigger object updated event
+    emit objectUpdated(this);
+    if (compare && memcmp(previous.constData(), data, numBytes) != 0)
+    {
+        emit objectContentChanged(this);
+    }
+
+    return offset;
+}
+
 /**
  * Save the object data to the file.
  * The file will be created in the current directory
@@ -493,6 +645,28 @@ void UAVObject::emitNewInstance(UAVObject * obj)
     emit newInstance(obj);
 }
 
+/**
+ * Mark the object as shown by a visible view, it is then retrieved
+ * first when the telemetry connects. Calls must be balanced by removeInterest().
+ * interestChanged() is emitted when the first view comes or the last one goes.
+ */
+void UAVObject::addInterest()
+{
+    if (interest.fetchAndAddOrdered(1) == 0)
+        emit interestChanged(this, true);
+}
+
+void UAVObject::removeInterest()
+{
+    if (!interest.deref())
+        emit interestChanged(this, false);
+}
+
+bool UAVObject::hasInterest()
+{
+    return interest.fetchAndAddOrdered(0) > 0;
+}
+
 /**
  * Initialize a UAVObjMetadata object.
  * \param[in] metadata The metadata object
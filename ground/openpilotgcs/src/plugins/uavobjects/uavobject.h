@@ -33,6 +33,8 @@
 #include <QObject>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QAtomicInt>
+#include <QThread>
 #include <QString>
 #include <QList>
 #include <QFile>
@@ -98,9 +100,12 @@ public:
 
 
     UAVObject(quint32 objID, bool isSingleInst, const QString& name);
+    virtual ~UAVObject();
     void initialize(quint32 instID);
     quint32 getObjID();
     quint32 getInstID();
+    qint64 getUpdateTime();
+    void setUpdateTime(qint64 msecsSinceEpoch);
     bool isSingleInstance();
     QString getName();
     QString getCategory();
@@ -108,6 +113,7 @@ public:
     quint32 getNumBytes(); 
     qint32 pack(quint8* dataOut);
     qint32 unpack(const quint8* dataIn);
+    qint32 unpackFields(const quint8* dataIn, quint32 length, quint32 fieldMask);
     bool save();
     bool save(QFile& file);
     bool load();
@@ -119,6 +125,34 @@ public:
     void lock(int timeoutMs);
     void unlock();
     QMutex* getMutex();
+    void beginWrite();
+    void endWrite();
+    void readData(quint8* dataOut, quint32 offset, quint32 length) const;
+    void writeData(const quint8* dataIn, quint32 offset, quint32 length);
+
+    /**
+     * Start a lock free read of the object data, see readData(). Returns the
+     * sequence to pass to readRetry() once the data was copied.
+     */
+    int readBegin() const
+    {
+        int seq;
+        while ((seq = dataSeq.fetchAndAddOrdered(0)) & 1)
+        {
+            // A write is in progress, let the writer run instead of spinning on
+            // its time slice (it may be preempted while holding the object)
+            QThread::yieldCurrentThread();
+        }
+        return seq;
+    }
+
+    /**
+     * True if the data was written since readBegin() and the copy must be redone
+     */
+    bool readRetry(int seq) const
+    {
+        return dataSeq.fetchAndAddOrdered(0) != seq;
+    }
     qint32 getNumFields();
     QList<UAVObjectField*> getFields();
     UAVObjectField* getField(const QString& name);
@@ -127,6 +161,9 @@ public:
     QString toStringData();
     void emitTransactionCompleted(bool success);
     void emitNewInstance(UAVObject *);
+    void addInterest();
+    void removeInterest();
+    bool hasInterest();
 
     // Metadata accessors
     static void MetadataInitialize(Metadata& meta);
@@ -153,9 +190,13 @@ signals:
     void objectUpdatedManual(UAVObject* obj);
     void objectUpdatedPeriodic(UAVObject* obj);
     void objectUnpacked(UAVObject* obj);
+    // Emitted by unpack() only if the data received differs from the data held
+    void objectContentChanged(UAVObject* obj);
     void updateRequested(UAVObject* obj);
     void transactionCompleted(UAVObject* obj, bool success);
     void newInstance(UAVObject* obj);
+    // Emitted when the object gets its first view or loses its last one
+    void interestChanged(UAVObject* obj, bool interested);
 
 private slots:
     void fieldUpdated(UAVObjectField* field);
@@ -168,8 +209,14 @@ protected:
     QString description;
     QString category;
     quint32 numBytes;
+    qint64 updateTime;
     QMutex* mutex;
     quint8* data;
+    // Sequence of the data, odd while a write is in progress
+    mutable QAtomicInt dataSeq;
+    int writeDepth;
+    // Number of visible views showing this object
+    QAtomicInt interest;
     QList<UAVObjectField*> fields;
 
     void initializeFields(QList<UAVObjectField*>& fields, quint8* data, quint32 numBytes);
@@ -28,78 +28,254 @@
 #include "uavobjectfield.h"
 #include <QtEndian>
 #include <QDebug>
+#include <limits>
 
-UAVObjectField::UAVObjectField(const QString& name, const QString& units, FieldType type, quint32 numElements, const QStringList& options, const QString &limits)
+// Interned field descriptions, never freed since they describe object types
+typedef QHash<QString, UAVObjectField::Info*> FieldInfoTable;
+Q_GLOBAL_STATIC(FieldInfoTable, fieldInfoTable)
+Q_GLOBAL_STATIC(QMutex, fieldInfoMutex)
+
+// Pool the fields are allocated from, every object instance creates one per field
+// so they are carved out of larger blocks. Freed slots are kept for later fields.
+static const int FIELD_POOL_BLOCK = 256;
+typedef struct FieldPoolSlot {
+    struct FieldPoolSlot* next;
+} FieldPoolSlot;
+struct FieldPool {
+    FieldPool() : free(NULL), blocks(0) {}
+    QMutex mutex;
+    FieldPoolSlot* free;
+    int blocks;
+};
+Q_GLOBAL_STATIC(FieldPool, fieldPool)
+
+/**
+ * Locks the object for a change of its data and marks the change for the
+ * lock free readers, see UAVObject::beginWrite()
+ */
+class FieldWriteLocker
 {
-    QStringList elementNames;
-    // Set element names
-    for (quint32 n = 0; n < numElements; ++n)
+public:
+    FieldWriteLocker(UAVObject* obj) : locker(obj->getMutex()), obj(obj) { obj->beginWrite(); }
+    ~FieldWriteLocker() { obj->endWrite(); }
+private:
+    QMutexLocker locker;
+    UAVObject* obj;
+};
+
+/**
+ * Allocate a field from the pool, classes derived from UAVObjectField are
+ * allocated from the heap as usual.
+ */
+void* UAVObjectField::operator new(size_t size)
+{
+    if (size != sizeof(UAVObjectField))
     {
-        elementNames.append(QString("%1").arg(n));
+        return ::operator new(size);
     }
-    // Initialize
-    constructorInitialize(name, units, type, elementNames, options,limits);
-
+    FieldPool* pool = fieldPool();
+    QMutexLocker locker(&pool->mutex);
+    if (pool->free == NULL)
+    {
+        // Blocks are never returned to the heap
+        char* block = static_cast<char*>(::operator new(sizeof(UAVObjectField) * FIELD_POOL_BLOCK));
+        for (int n = 0; n < FIELD_POOL_BLOCK; ++n)
+        {
+            FieldPoolSlot* slot = reinterpret_cast<FieldPoolSlot*>(block + n * sizeof(UAVObjectField));
+            slot->next = pool->free;
+            pool->free = slot;
+        }
+        ++pool->blocks;
+    }
+    FieldPoolSlot* slot = pool->free;
+    pool->free = slot->next;
+    return slot;
 }
 
-UAVObjectField::UAVObjectField(const QString& name, const QString& units, FieldType type, const QStringList& elementNames, const QStringList& options, const QString &limits)
+/**
+ * Return a field to the pool
+ */
+void UAVObjectField::operator delete(void* ptr, size_t size)
 {
-    constructorInitialize(name, units, type, elementNames, options,limits);
+    if (ptr == NULL)
+    {
+        return;
+    }
+    if (size != sizeof(UAVObjectField))
+    {
+        ::operator delete(ptr);
+        return;
+    }
+    FieldPool* pool = fieldPool();
+    QMutexLocker locker(&pool->mutex);
+    FieldPoolSlot* slot = static_cast<FieldPoolSlot*>(ptr);
+    slot->next = pool->free;
+    pool->free = slot;
 }
 
-void UAVObjectField::constructorInitialize(const QString& name, const QString& units, FieldType type, const QStringList& elementNames, const QStringList& options,const QString &limits)
+/**
+ * Get the shared description of a field, it is created and its limits
+ * parsed the first time a field with these parameters is seen.
+ */
+const UAVObjectField::Info* UAVObjectField::intern(const QString& name, const QString& units, FieldType type, const QStringList& elementNames, const QStringList& options, const QString &limits)
 {
-    // Copy params
-    this->name = name;
-    this->units = units;
-    this->type = type;
-    this->options = options;
-    this->numElements = elementNames.length();
-    this->offset = 0;
-    this->data = NULL;
-    this->obj = NULL;
-    this->elementNames = elementNames;
+    QString key = QString("%1\n%2\n%3\n%4\n%5\n%6").arg(name).arg(units).arg(type)
+            .arg(elementNames.join(",")).arg(options.join(",")).arg(limits);
+    QMutexLocker locker(fieldInfoMutex());
+    Info* info = fieldInfoTable()->value(key);
+    if (info)
+        return info;
+
+    info = new Info;
+    info->name = name;
+    info->units = units;
+    info->type = type;
+    info->options = options;
+    info->numElements = elementNames.length();
+    info->elementNames = elementNames;
+    for (int n = 0; n < elementNames.length(); ++n)
+    {
+        info->elementIndices.insert(elementNames[n], n);
+    }
     // Set field size
     switch (type)
     {
     case INT8:
-        numBytesPerElement = sizeof(qint8);
+        info->numBytesPerElement = sizeof(qint8);
         break;
     case INT16:
-        numBytesPerElement = sizeof(qint16);
+        info->numBytesPerElement = sizeof(qint16);
         break;
     case INT32:
-        numBytesPerElement = sizeof(qint32);
+        info->numBytesPerElement = sizeof(qint32);
         break;
     case UINT8:
-        numBytesPerElement = sizeof(quint8);
+        info->numBytesPerElement = sizeof(quint8);
         break;
     case UINT16:
-        numBytesPerElement = sizeof(quint16);
+        info->numBytesPerElement = sizeof(quint16);
         break;
     case UINT32:
-        numBytesPerElement = sizeof(quint32);
+        info->numBytesPerElement = sizeof(quint32);
         break;
     case FLOAT32:
-        numBytesPerElement = sizeof(quint32);
+        info->numBytesPerElement = sizeof(quint32);
         break;
     case ENUM:
-        numBytesPerElement = sizeof(quint8);
+        info->numBytesPerElement = sizeof(quint8);
         break;
     case BITFIELD:
-        numBytesPerElement = sizeof(quint8);
-        this->options = QStringList()<<tr("0")<<tr("1");
+        info->numBytesPerElement = sizeof(quint8);
+        info->options = QStringList()<<tr("0")<<tr("1");
         break;
     case STRING:
-        numBytesPerElement = sizeof(quint8);
+        info->numBytesPerElement = sizeof(quint8);
         break;
     default:
-        numBytesPerElement = 0;
+        info->numBytesPerElement = 0;
+    }
+    limitsInitialize(info, limits);
+    fieldInfoTable()->insert(key, info);
+    return info;
+}
+
+static qint64 stringBytes(const QString& str)
+{
+    return sizeof(QString) + str.capacity() * sizeof(QChar);
+}
+
+static qint64 stringListBytes(const QStringList& list)
+{
+    qint64 bytes = sizeof(QStringList);
+    foreach (const QString& str, list)
+        bytes += stringBytes(str);
+    return bytes;
+}
+
+/**
+ * Estimate of the memory held by the interned field descriptions, the
+ * number of descriptions is returned in count.
+ */
+qint64 UAVObjectField::getDescriptionsMemory(qint64* count)
+{
+    QMutexLocker locker(fieldInfoMutex());
+    qint64 bytes = 0;
+    QHashIterator<QString, Info*> it(*fieldInfoTable());
+    while (it.hasNext())
+    {
+        it.next();
+        const Info* info = it.value();
+        bytes += stringBytes(it.key()) + sizeof(Info);
+        bytes += stringBytes(info->name) + stringBytes(info->units);
+        bytes += stringListBytes(info->elementNames) + stringListBytes(info->options);
+        bytes += info->elementIndices.size() * (sizeof(QString) + sizeof(int) + sizeof(void*));
+        bytes += info->elementLimits.size() * (sizeof(quint32) + sizeof(QList<LimitStruct>) + sizeof(LimitStruct));
+    }
+    *count = fieldInfoTable()->size();
+    return bytes;
+}
+
+/**
+ * Memory taken by the field pool blocks, used or free, the number of slots
+ * is returned in slots.
+ */
+qint64 UAVObjectField::getPoolMemory(qint64* slots)
+{
+    FieldPool* pool = fieldPool();
+    QMutexLocker locker(&pool->mutex);
+    *slots = (qint64)pool->blocks * FIELD_POOL_BLOCK;
+    return *slots * sizeof(UAVObjectField);
+}
+
+const UAVObjectField::Info* UAVObjectField::intern(const QString& name, const QString& units, FieldType type, quint32 numElements, const QStringList& options, const QString &limits)
+{
+    QStringList elementNames;
+    // Set element names
+    for (quint32 n = 0; n < numElements; ++n)
+    {
+        elementNames.append(QString("%1").arg(n));
+    }
+    return intern(name, units, type, elementNames, options, limits);
+}
+
+/**
+ * Get the shared description of a field from the static tables emitted by the
+ * UAVObjectGenerator, the string lists are sized once instead of grown per entry.
+ */
+const UAVObjectField::Info* UAVObjectField::intern(const char* name, const char* units, FieldType type, const char* const* elementNames, int numElementNames,
+                                                   const char* const* options, int numOptions, const char* limits)
+{
+    QStringList elementList;
+    elementList.reserve(numElementNames);
+    for (int n = 0; n < numElementNames; ++n)
+    {
+        elementList.append(QLatin1String(elementNames[n]));
+    }
+    QStringList optionList;
+    optionList.reserve(numOptions);
+    for (int n = 0; n < numOptions; ++n)
+    {
+        optionList.append(QLatin1String(options[n]));
     }
-    limitsInitialize(limits);
+    return intern(QLatin1String(name), QLatin1String(units), type, elementList, optionList, QLatin1String(limits));
+}
+
+UAVObjectField::UAVObjectField(const Info* info) :
+    info(info), offset(0), data(NULL), obj(NULL)
+{
 }
 
-void UAVObjectField::limitsInitialize(const QString &limits)
+UAVObjectField::UAVObjectField(const QString& name, const QString& units, FieldType type, quint32 numElements, const QStringList& options, const QString &limits) :
+    info(intern(name, units, type, numElements, options, limits)), offset(0), data(NULL), obj(NULL)
+{
+}
+
+UAVObjectField::UAVObjectField(const QString& name, const QString& units, FieldType type, const QStringList& elementNames, const QStringList& options, const QString &limits) :
+    info(intern(name, units, type, elementNames, options, limits)), offset(0), data(NULL), obj(NULL)
+{
+}
+
+void UAVObjectField::limitsInitialize(Info* info, const QString &limits)
 {
     /// format
     /// (TY)->type (EQ-equal;NE-not equal;BE-between;BI-bigger;SM-smaller)
@@ -122,7 +298,7 @@ void UAVObjectField::limitsInitialize(const QString &limits)
             QStringList valuesPerElement=_str.split(":");
             LimitStruct lstruc;
             bool startFlag=valuesPerElement.at(0).startsWith("%");
-            bool maxIndexFlag=(int)(index)<(int)numElements;
+            bool maxIndexFlag=(int)(index)<(int)info->numElements;
             bool elemNumberSizeFlag=valuesPerElement.at(0).size()==3;
             bool aux;
             valuesPerElement.at(0).mid(1,4).toInt(&aux,16);
@@ -144,12 +320,12 @@ void UAVObjectField::limitsInitialize(const QString &limits)
                 else if(valuesPerElement.at(0).right(2)=="SM")
                     lstruc.type=SMALLER;
                 else
-                    qDebug()<<"limits parsing failed (invalid property) on UAVObjectField"<<name;
+                    qDebug()<<"limits parsing failed (invalid property) on UAVObjectField"<<info->name;
                 valuesPerElement.removeAt(0);
                 foreach(QString _value,valuesPerElement)
                 {
                     QString value=_value.trimmed();
-                    switch (type)
+                    switch (info->type)
                     {
                     case UINT8:
                     case UINT16:
@@ -180,22 +356,22 @@ void UAVObjectField::limitsInitialize(const QString &limits)
             else
             {
                 if(!valuesPerElement.at(0).isEmpty() && !startFlag)
-                    qDebug()<<"limits parsing failed (property doesn't start with %) on UAVObjectField"<<name;
+                    qDebug()<<"limits parsing failed (property doesn't start with %) on UAVObjectField"<<info->name;
                 else if(!maxIndexFlag)
-                    qDebug()<<"limits parsing failed (index>numelements) on UAVObjectField"<<name<<"index"<<index<<"numElements"<<numElements;
+                    qDebug()<<"limits parsing failed (index>numelements) on UAVObjectField"<<info->name<<"index"<<index<<"numElements"<<info->numElements;
                 else if(!elemNumberSizeFlag || !b4 )
-                    qDebug()<<"limits parsing failed limit not starting with %XX or %YYYYXX where XX is the limit type and YYYY is the board type on UAVObjectField"<<name;
+                    qDebug()<<"limits parsing failed limit not starting with %XX or %YYYYXX where XX is the limit type and YYYY is the board type on UAVObjectField"<<info->name;
             }
         }
-        elementLimits.insert(index,limitList);
+        info->elementLimits.insert(index,limitList);
         ++index;
 
     }
-    foreach(QList<LimitStruct> limitList,elementLimits)
+    foreach(QList<LimitStruct> limitList,info->elementLimits)
     {
         foreach(LimitStruct limit,limitList)
         {
-            qDebug()<<"Limit type"<<limit.type<<"for board"<<limit.board<<"for field"<<getName();
+            qDebug()<<"Limit type"<<limit.type<<"for board"<<limit.board<<"for field"<<info->name;
             foreach(QVariant var,limit.values)
             {
                 qDebug()<<"value"<<var;
@@ -205,17 +381,17 @@ void UAVObjectField::limitsInitialize(const QString &limits)
 }
 bool UAVObjectField::isWithinLimits(QVariant var,quint32 index, int board)
 {
-    if(!elementLimits.keys().contains(index))
+    if(!info->elementLimits.keys().contains(index))
         return true;
 
-    foreach(LimitStruct struc,elementLimits.value(index))
+    foreach(LimitStruct struc,info->elementLimits.value(index))
     {
         if((struc.board!=board) && board!=0 && struc.board!=0)
             continue;
         switch(struc.type)
         {
         case EQUAL:
-            switch (type)
+            switch (info->type)
             {
             case INT8:
             case INT16:
@@ -256,7 +432,7 @@ bool UAVObjectField::isWithinLimits(QVariant var,quint32 index, int board)
             }
             break;
         case NOT_EQUAL:
-            switch (type)
+            switch (info->type)
             {
             case INT8:
             case INT16:
@@ -299,12 +475,12 @@ bool UAVObjectField::isWithinLimits(QVariant var,quint32 index, int board)
         case BETWEEN:
             if(struc.values.length()<2)
             {
-                qDebug()<<__FUNCTION__<<"between limit with less than 1 pair, aborting; field:"<<name;
+                qDebug()<<__FUNCTION__<<"between limit with less than 1 pair, aborting; field:"<<info->name;
                 return true;
             }
             if(struc.values.length()>2)
-                qDebug()<<__FUNCTION__<<"between limit with more than 1 pair, using first; field"<<name;
-            switch (type)
+                qDebug()<<__FUNCTION__<<"between limit with more than 1 pair, using first; field"<<info->name;
+            switch (info->type)
             {
             case INT8:
             case INT16:
@@ -322,7 +498,7 @@ bool UAVObjectField::isWithinLimits(QVariant var,quint32 index, int board)
                 return true;
                 break;
             case ENUM:
-                    if(!(options.indexOf(var.toString())>=options.indexOf(struc.values.at(0).toString()) && options.indexOf(var.toString())<=options.indexOf(struc.values.at(1).toString())))
+                    if(!(info->options.indexOf(var.toString())>=info->options.indexOf(struc.values.at(0).toString()) && info->options.indexOf(var.toString())<=info->options.indexOf(struc.values.at(1).toString())))
                         return false;
                 return true;
                 break;
@@ -341,12 +517,12 @@ bool UAVObjectField::isWithinLimits(QVariant var,quint32 index, int board)
         case BIGGER:
             if(struc.values.length()<1)
             {
-                qDebug()<<__FUNCTION__<<"BIGGER limit with less than 1 value, aborting; field:"<<name;
+                qDebug()<<__FUNCTION__<<"BIGGER limit with less than 1 value, aborting; field:"<<info->name;
                 return true;
             }
             if(struc.values.length()>1)
-                qDebug()<<__FUNCTION__<<"BIGGER limit with more than 1 value, using first; field"<<name;
-            switch (type)
+                qDebug()<<__FUNCTION__<<"BIGGER limit with more than 1 value, using first; field"<<info->name;
+            switch (info->type)
             {
             case INT8:
             case INT16:
@@ -364,7 +540,7 @@ bool UAVObjectField::isWithinLimits(QVariant var,quint32 index, int board)
                 return true;
                 break;
             case ENUM:
-                    if(!(options.indexOf(var.toString())>=options.indexOf(struc.values.at(0).toString())))
+                    if(!(info->options.indexOf(var.toString())>=info->options.indexOf(struc.values.at(0).toString())))
                         return false;
                 return true;
                 break;
@@ -381,7 +557,7 @@ bool UAVObjectField::isWithinLimits(QVariant var,quint32 index, int board)
             }
             break;
         case SMALLER:
-            switch (type)
+            switch (info->type)
             {
             case INT8:
             case INT16:
@@ -399,7 +575,7 @@ bool UAVObjectField::isWithinLimits(QVariant var,quint32 index, int board)
                 return true;
                 break;
             case ENUM:
-                    if(!(options.indexOf(var.toString())<=options.indexOf(struc.values.at(0).toString())))
+                    if(!(info->options.indexOf(var.toString())<=info->options.indexOf(struc.values.at(0).toString())))
                         return false;
                 return true;
                 break;
@@ -421,9 +597,9 @@ bool UAVObjectField::isWithinLimits(QVariant var,quint32 index, int board)
 
 QVariant UAVObjectField::getMaxLimit(quint32 index,int board)
 {
-    if(!elementLimits.keys().contains(index))
+    if(!info->elementLimits.keys().contains(index))
         return QVariant();
-    foreach(LimitStruct struc,elementLimits.value(index))
+    foreach(LimitStruct struc,info->elementLimits.value(index))
     {
         if((struc.board!=board) && board!=0 && struc.board!=0)
             continue;
@@ -450,9 +626,9 @@ QVariant UAVObjectField::getMaxLimit(quint32 index,int board)
 }
 QVariant UAVObjectField::getMinLimit(quint32 index, int board)
 {
-    if(!elementLimits.keys().contains(index))
+    if(!info->elementLimits.keys().contains(index))
         return QVariant();
-    foreach(LimitStruct struc,elementLimits.value(index))
+    foreach(LimitStruct struc,info->elementLimits.value(index))
     {
         if((struc.board!=board) && board!=0 && struc.board!=0)
             return QVariant();
@@ -487,12 +663,12 @@ void UAVObjectField::initialize(quint8* data, quint32 dataOffset, UAVObject* obj
 
 UAVObjectField::FieldType UAVObjectField::getType()
 {
-    return type;
+    return info->type;
 }
 
 QString UAVObjectField::getTypeAsString()
 {
-    switch (type)
+    switch (info->type)
     {
     case UAVObjectField::INT8:
         return "int8";
@@ -521,7 +697,16 @@ QString UAVObjectField::getTypeAsString()
 
 QStringList UAVObjectField::getElementNames()
 {
-    return elementNames;
+    return info->elementNames;
+}
+
+/**
+ * Get the index of an element from its name
+ * \return The element index or -1 if there is no such element
+ */
+int UAVObjectField::getElementIndex(const QString& elementName)
+{
+    return info->elementIndices.value(elementName, -1);
 }
 
 UAVObject* UAVObjectField::getObject()
@@ -531,36 +716,36 @@ UAVObject* UAVObjectField::getObject()
 
 void UAVObjectField::clear()
 {
-    QMutexLocker locker(obj->getMutex());
-    switch (type)
+    FieldWriteLocker locker(obj);
+    switch (info->type)
     {
     case BITFIELD:
-        memset(&data[offset], 0, numBytesPerElement*((quint32)(1+(numElements-1)/8)));
+        memset(&data[offset], 0, info->numBytesPerElement*((quint32)(1+(info->numElements-1)/8)));
         break;
     default:
-        memset(&data[offset], 0, numBytesPerElement*numElements);
+        memset(&data[offset], 0, info->numBytesPerElement*info->numElements);
         break;
     }
 }
 
 QString UAVObjectField::getName()
 {
-    return name;
+    return info->name;
 }
 
 QString UAVObjectField::getUnits()
 {
-    return units;
+    return info->units;
 }
 
 QStringList UAVObjectField::getOptions()
 {
-    return options;
+    return info->options;
 }
 
 quint32 UAVObjectField::getNumElements()
 {
-    return numElements;
+    return info->numElements;
 }
 
 quint32 UAVObjectField::getDataOffset()
@@ -570,13 +755,13 @@ quint32 UAVObjectField::getDataOffset()
 
 quint32 UAVObjectField::getNumBytes()
 {
-    switch (type)
+    switch (info->type)
     {
     case BITFIELD:
-        return numBytesPerElement * ((quint32) (1+(numElements-1)/8));
+        return info->numBytesPerElement * ((quint32) (1+(info->numElements-1)/8));
         break;
     default:
-        return numBytesPerElement * numElements;
+        return info->numBytesPerElement * info->numElements;
         break;
     }
 }
@@ -584,12 +769,12 @@ quint32 UAVObjectField::getNumBytes()
 QString UAVObjectField::toString()
 {
     QString sout;
-    sout.append ( QString("%1: [ ").arg(name) );
-    for (unsigned int n = 0; n < numElements; ++n)
+    sout.append ( QString("%1: [ ").arg(info->name) );
+    for (unsigned int n = 0; n < info->numElements; ++n)
     {
         sout.append( QString("%1 ").arg(getDouble(n)) );
     }
-    sout.append( QString("] %1\n").arg(units) );
+    sout.append( QString("] %1\n").arg(info->units) );
     return sout;
 }
 
@@ -598,71 +783,71 @@ qint32 UAVObjectField::pack(quint8* dataOut)
 {
     QMutexLocker locker(obj->getMutex());
     // Pack each element in output buffer
-    switch (type)
+    switch (info->type)
     {
     case INT8:
-        memcpy(dataOut, &data[offset], numElements);
+        memcpy(dataOut, &data[offset], info->numElements);
         break;
     case INT16:
-        for (quint32 index = 0; index < numElements; ++index)
+        for (quint32 index = 0; index < info->numElements; ++index)
         {
             qint16 value;
-            memcpy(&value, &data[offset + numBytesPerElement*index], numBytesPerElement);
-            qToLittleEndian<qint16>(value, &dataOut[numBytesPerElement*index]);
+            memcpy(&value, &data[offset + info->numBytesPerElement*index], info->numBytesPerElement);
+            qToLittleEndian<qint16>(value, &dataOut[info->numBytesPerElement*index]);
         }
         break;
     case INT32:
-        for (quint32 index = 0; index < numElements; ++index)
+        for (quint32 index = 0; index < info->numElements; ++index)
         {
             qint32 value;
-            memcpy(&value, &data[offset + numBytesPerElement*index], numBytesPerElement);
-            qToLittleEndian<qint32>(value, &dataOut[numBytesPerElement*index]);
+            memcpy(&value, &data[offset + info->numBytesPerElement*index], info->numBytesPerElement);
+            qToLittleEndian<qint32>(value, &dataOut[info->numBytesPerElement*index]);
         }
         break;
     case UINT8:
-        for (quint32 index = 0; index < numElements; ++index)
+        for (quint32 index = 0; index < info->numElements; ++index)
         {
-            dataOut[numBytesPerElement*index] = data[offset + numBytesPerElement*index];
+            dataOut[info->numBytesPerElement*index] = data[offset + info->numBytesPerElement*index];
         }
         break;
     case UINT16:
-        for (quint32 index = 0; index < numElements; ++index)
+        for (quint32 index = 0; index < info->numElements; ++index)
         {
             quint16 value;
-            memcpy(&value, &data[offset + numBytesPerElement*index], numBytesPerElement);
-            qToLittleEndian<quint16>(value, &dataOut[numBytesPerElement*index]);
+            memcpy(&value, &data[offset + info->numBytesPerElement*index], info->numBytesPerElement);
+            qToLittleEndian<quint16>(value, &dataOut[info->numBytesPerElement*index]);
         }
         break;
     case UINT32:
-        for (quint32 index = 0; index < numElements; ++index)
+        for (quint32 index = 0; index < info->numElements; ++index)
         {
             quint32 value;
-            memcpy(&value, &data[offset + numBytesPerElement*index], numBytesPerElement);
-            qToLittleEndian<quint32>(value, &dataOut[numBytesPerElement*index]);
+            memcpy(&value, &data[offset + info->numBytesPerElement*index], info->numBytesPerElement);
+            qToLittleEndian<quint32>(value, &dataOut[info->numBytesPerElement*index]);
         }
         break;
     case FLOAT32:
-        for (quint32 index = 0; index < numElements; ++index)
+        for (quint32 index = 0; index < info->numElements; ++index)
         {
             quint32 value;
-            memcpy(&value, &data[offset + numBytesPerElement*index], numBytesPerElement);
-            qToLittleEndian<quint32>(value, &dataOut[numBytesPerElement*index]);
+            memcpy(&value, &data[offset + info->numBytesPerElement*index], info->numBytesPerElement);
+            qToLittleEndian<quint32>(value, &dataOut[info->numBytesPerElement*index]);
         }
         break;
     case ENUM:
-        for (quint32 index = 0; index < numElements; ++index)
+        for (quint32 index = 0; index < info->numElements; ++index)
         {
-            dataOut[numBytesPerElement*index] = data[offset + numBytesPerElement*index];
+            dataOut[info->numBytesPerElement*index] = data[offset + info->numBytesPerElement*index];
         }
         break;
     case BITFIELD:
-        for (quint32 index = 0; index < (quint32)(1+(numElements-1)/8); ++index)
+        for (quint32 index = 0; index < (quint32)(1+(info->numElements-1)/8); ++index)
         {
-            dataOut[numBytesPerElement*index] = data[offset + numBytesPerElement*index];
+            dataOut[info->numBytesPerElement*index] = data[offset + info->numBytesPerElement*index];
         }
         break;
     case STRING:
-        memcpy(dataOut, &data[offset], numElements);
+        memcpy(dataOut, &data[offset], info->numElements);
         break;
     }
     // Done
@@ -671,73 +856,73 @@ qint32 UAVObjectField::pack(quint8* dataOut)
 
 qint32 UAVObjectField::unpack(const quint8* dataIn)
 {
-    QMutexLocker locker(obj->getMutex());
+    FieldWriteLocker locker(obj);
     // Unpack each element from input buffer
-    switch (type)
+    switch (info->type)
     {
     case INT8:
-        memcpy(&data[offset], dataIn, numElements);
+        memcpy(&data[offset], dataIn, info->numElements);
         break;
     case INT16:
-        for (quint32 index = 0; index < numElements; ++index)
+        for (quint32 index = 0; index < info->numElements; ++index)
         {
             qint16 value;
-            value = qFromLittleEndian<qint16>(&dataIn[numBytesPerElement*index]);
-            memcpy(&data[offset + numBytesPerElement*index], &value, numBytesPerElement);
+            value = qFromLittleEndian<qint16>(&dataIn[info->numBytesPerElement*index]);
+            memcpy(&data[offset + info->numBytesPerElement*index], &value, info->numBytesPerElement);
         }
         break;
     case INT32:
-        for (quint32 index = 0; index < numElements; ++index)
+        for (quint32 index = 0; index < info->numElements; ++index)
         {
             qint32 value;
-            value = qFromLittleEndian<qint32>(&dataIn[numBytesPerElement*index]);
-            memcpy(&data[offset + numBytesPerElement*index], &value, numBytesPerElement);
+            value = qFromLittleEndian<qint32>(&dataIn[info->numBytesPerElement*index]);
+            memcpy(&data[offset + info->numBytesPerElement*index], &value, info->numBytesPerElement);
         }
         break;
     case UINT8:
-        for (quint32 index = 0; index < numElements; ++index)
+        for (quint32 index = 0; index < info->numElements; ++index)
         {
-            data[offset + numBytesPerElement*index] = dataIn[numBytesPerElement*index];
+            data[offset + info->numBytesPerElement*index] = dataIn[info->numBytesPerElement*index];
         }
         break;
     case UINT16:
-        for (quint32 index = 0; index < numElements; ++index)
+        for (quint32 index = 0; index < info->numElements; ++index)
         {
             quint16 value;
-            value = qFromLittleEndian<quint16>(&dataIn[numBytesPerElement*index]);
-            memcpy(&data[offset + numBytesPerElement*index], &value, numBytesPerElement);
+            value = qFromLittleEndian<quint16>(&dataIn[info->numBytesPerElement*index]);
+            memcpy(&data[offset + info->numBytesPerElement*index], &value, info->numBytesPerElement);
         }
         break;
     case UINT32:
-        for (quint32 index = 0; index < numElements; ++index)
+        for (quint32 index = 0; index < info->numElements; ++index)
         {
             quint32 value;
-            value = qFromLittleEndian<quint32>(&dataIn[numBytesPerElement*index]);
-            memcpy(&data[offset + numBytesPerElement*index], &value, numBytesPerElement);
+            value = qFromLittleEndian<quint32>(&dataIn[info->numBytesPerElement*index]);
+            memcpy(&data[offset + info->numBytesPerElement*index], &value, info->numBytesPerElement);
         }
         break;
     case FLOAT32:
-        for (quint32 index = 0; index < numElements; ++index)
+        for (quint32 index = 0; index < info->numElements; ++index)
         {
             quint32 value;
-            value = qFromLittleEndian<quint32>(&dataIn[numBytesPerElement*index]);
-            memcpy(&data[offset + numBytesPerElement*index], &value, numBytesPerElement);
+            value = qFromLittleEndian<quint32>(&dataIn[info->numBytesPerElement*index]);
+            memcpy(&data[offset + info->numBytesPerElement*index], &value, info->numBytesPerElement);
         }
         break;
     case ENUM:
-        for (quint32 index = 0; index < numElements; ++index)
+        for (quint32 index = 0; index < info->numElements; ++index)
         {
-            data[offset + numBytesPerElement*index] = dataIn[numBytesPerElement*index];
+            data[offset + info->numBytesPerElement*index] = dataIn[info->numBytesPerElement*index];
         }
         break;
     case BITFIELD:
-        for (quint32 index = 0; index < (quint32)(1+(numElements-1)/8); ++index)
+        for (quint32 index = 0; index < (quint32)(1+(info->numElements-1)/8); ++index)
         {
-            data[offset + numBytesPerElement*index] = dataIn[numBytesPerElement*index];
+            data[offset + info->numBytesPerElement*index] = dataIn[info->numBytesPerElement*index];
         }
         break;
     case STRING:
-        memcpy(&data[offset], dataIn, numElements);
+        memcpy(&data[offset], dataIn, info->numElements);
         break;
     }
     // Done
@@ -746,7 +931,7 @@ qint32 UAVObjectField::unpack(const quint8* dataIn)
 
 bool UAVObjectField::isNumeric()
 {
-    switch (type)
+    switch (info->type)
     {
     case INT8:
         return true;
@@ -785,7 +970,7 @@ bool UAVObjectField::isNumeric()
 
 bool UAVObjectField::isText()
 {
-    switch (type)
+    switch (info->type)
     {
     case INT8:
         return false;
@@ -826,85 +1011,85 @@ QVariant UAVObjectField::getValue(quint32 index)
 {
     QMutexLocker locker(obj->getMutex());
     // Check that index is not out of bounds
-    if ( index >= numElements )
+    if ( index >= info->numElements )
     {
         return QVariant();
     }
     // Get value
-    switch (type)
+    switch (info->type)
     {
     case INT8:
     {
         qint8 tmpint8;
-        memcpy(&tmpint8, &data[offset + numBytesPerElement*index], numBytesPerElement);
+        memcpy(&tmpint8, &data[offset + info->numBytesPerElement*index], info->numBytesPerElement);
         return QVariant(tmpint8);
         break;
     }
     case INT16:
     {
         qint16 tmpint16;
-        memcpy(&tmpint16, &data[offset + numBytesPerElement*index], numBytesPerElement);
+        memcpy(&tmpint16, &data[offset + info->numBytesPerElement*index], info->numBytesPerElement);
         return QVariant(tmpint16);
         break;
     }
     case INT32:
     {
         qint32 tmpint32;
-        memcpy(&tmpint32, &data[offset + numBytesPerElement*index], numBytesPerElement);
+        memcpy(&tmpint32, &data[offset + info->numBytesPerElement*index], info->numBytesPerElement);
         return QVariant(tmpint32);
         break;
     }
     case UINT8:
     {
         quint8 tmpuint8;
-        memcpy(&tmpuint8, &data[offset + numBytesPerElement*index], numBytesPerElement);
+        memcpy(&tmpuint8, &data[offset + info->numBytesPerElement*index], info->numBytesPerElement);
         return QVariant(tmpuint8);
         break;
     }
     case UINT16:
     {
         quint16 tmpuint16;
-        memcpy(&tmpuint16, &data[offset + numBytesPerElement*index], numBytesPerElement);
+        memcpy(&tmpuint16, &data[offset + info->numBytesPerElement*index], info->numBytesPerElement);
         return QVariant(tmpuint16);
         break;
     }
     case UINT32:
     {
         quint32 tmpuint32;
-        memcpy(&tmpuint32, &data[offset + numBytesPerElement*index], numBytesPerElement);
+        memcpy(&tmpuint32, &data[offset + info->numBytesPerElement*index], info->numBytesPerElement);
         return QVariant(tmpuint32);
         break;
     }
     case FLOAT32:
     {
         float tmpfloat;
-        memcpy(&tmpfloat, &data[offset + numBytesPerElement*index], numBytesPerElement);
+        memcpy(&tmpfloat, &data[offset + info->numBytesPerElement*index], info->numBytesPerElement);
         return QVariant(tmpfloat);
         break;
     }
     case ENUM:
     {
         quint8 tmpenum;
-        memcpy(&tmpenum, &data[offset + numBytesPerElement*index], numBytesPerElement);
-        //            Q_ASSERT((tmpenum < options.length()) && (tmpenum >= 0)); // catch bad enum settings
-        if(tmpenum >= options.length()) {
-            qDebug() << "Invalid value for" << name;
+        memcpy(&tmpenum, &data[offset + info->numBytesPerElement*index], info->numBytesPerElement);
+        //            Q_ASSERT((tmpenum < info->options.length()) && (tmpenum >= 0)); // catch bad enum settings
+        if(tmpenum >= info->options.length()) {
+            qDebug() << "Invalid value for" << info->name;
             return QVariant( QString("Bad Value") );
         }
-        return QVariant( options[tmpenum] );
+        return QVariant( info->options[tmpenum] );
         break;
     }
     case BITFIELD:
     {
         quint8 tmpbitfield;
-        memcpy(&tmpbitfield, &data[offset + numBytesPerElement*((quint32)(index/8))], numBytesPerElement);
+        memcpy(&tmpbitfield, &data[offset + info->numBytesPerElement*((quint32)(index/8))], info->numBytesPerElement);
         tmpbitfield = (tmpbitfield >> (index % 8)) & 1;
         return QVariant( tmpbitfield );
         break;
     }
     case STRING:
     {
-        data[offset + numElements - 1] = '\0';
+        data[offset + info->numElements - 1] = '\0';
         QString str((char*)&data[offset]);
         return QVariant( str );
         break;
@@ -918,7 +1103,7 @@ bool UAVObjectField::checkValue(const QVariant& value, quint32 index)
 {
     QMutexLocker locker(obj->getMutex());
     // Check that index is not out of bounds
-    if ( index >= numElements )
+    if ( index >= info->numElements )
     {
         return false;
     }
@@ -927,7 +1112,7 @@ bool UAVObjectField::checkValue(const QVariant& value, quint32 index)
     // Update value if the access mode permits
     if ( UAVObject::GetFlightAccess(mdata) == UAVObject::ACCESS_READWRITE )
     {
-        switch (type)
+        switch (info->type)
         {
         case INT8:
         case INT16:
@@ -942,12 +1127,12 @@ bool UAVObjectField::checkValue(const QVariant& value, quint32 index)
             break;
         case ENUM:
         {
-            qint8 tmpenum = options.indexOf( value.toString() );
+            qint8 tmpenum = info->options.indexOf( value.toString() );
             return ((tmpenum < 0) ? false : true);
             break;
         }
         default:
-            qDebug() << "checkValue: other types" << type;
+            qDebug() << "checkValue: other types" << info->type;
             Q_ASSERT(0); // To catch any programming errors where we tried to test invalid values
             break;
         }
@@ -957,9 +1142,9 @@ bool UAVObjectField::checkValue(const QVariant& value, quint32 index)
 
 void UAVObjectField::setValue(const QVariant& value, quint32 index)
 {
-    QMutexLocker locker(obj->getMutex());
+    FieldWriteLocker locker(obj);
     // Check that index is not out of bounds
-    if ( index >= numElements )
+    if ( index >= info->numElements )
     {
         return;
     }
@@ -968,63 +1153,63 @@ void UAVObjectField::setValue(const QVariant& value, quint32 index)
     // Update value if the access mode permits
     if ( UAVObject::GetGcsAccess(mdata) == UAVObject::ACCESS_READWRITE )
     {
-        switch (type)
+        switch (info->type)
         {
         case INT8:
         {
             qint8 tmpint8 = value.toInt();
-            memcpy(&data[offset + numBytesPerElement*index], &tmpint8, numBytesPerElement);
+            memcpy(&data[offset + info->numBytesPerElement*index], &tmpint8, info->numBytesPerElement);
             break;
         }
         case INT16:
         {
             qint16 tmpint16 = value.toInt();
-            memcpy(&data[offset + numBytesPerElement*index], &tmpint16, numBytesPerElement);
+            memcpy(&data[offset + info->numBytesPerElement*index], &tmpint16, info->numBytesPerElement);
             break;
         }
         case INT32:
         {
             qint32 tmpint32 = value.toInt();
-            memcpy(&data[offset + numBytesPerElement*index], &tmpint32, numBytesPerElement);
+            memcpy(&data[offset + info->numBytesPerElement*index], &tmpint32, info->numBytesPerElement);
             break;
         }
         case UINT8:
         {
             quint8 tmpuint8 = value.toUInt();
-            memcpy(&data[offset + numBytesPerElement*index], &tmpuint8, numBytesPerElement);
+            memcpy(&data[offset + info->numBytesPerElement*index], &tmpuint8, info->numBytesPerElement);
             break;
         }
         case UINT16:
         {
             quint16 tmpuint16 = value.toUInt();
-            memcpy(&data[offset + numBytesPerElement*index], &tmpuint16, numBytesPerElement);
+            memcpy(&data[offset + info->numBytesPerElement*index], &tmpuint16, info->numBytesPerElement);
             break;
         }
         case UINT32:
         {
             quint32 tmpuint32 = value.toUInt();
-            memcpy(&data[offset + numBytesPerElement*index], &tmpuint32, numBytesPerElement);
+            memcpy(&data[offset + info->numBytesPerElement*index], &tmpuint32, info->numBytesPerElement);
             break;
         }
         case FLOAT32:
         {
             float tmpfloat = value.toFloat();
-            memcpy(&data[offset + numBytesPerElement*index], &tmpfloat, numBytesPerElement);
+            memcpy(&data[offset + info->numBytesPerElement*index], &tmpfloat, info->numBytesPerElement);
             break;
         }
         case ENUM:
         {
-            qint8 tmpenum = options.indexOf( value.toString() );
+            qint8 tmpenum = info->options.indexOf( value.toString() );
             Q_ASSERT(tmpenum >= 0); // To catch any programming errors where we set invalid values
-            memcpy(&data[offset + numBytesPerElement*index], &tmpenum, numBytesPerElement);
+            memcpy(&data[offset + info->numBytesPerElement*index], &tmpenum, info->numBytesPerElement);
             break;
         }
         case BITFIELD:
         {
             quint8 tmpbitfield;
-            memcpy(&tmpbitfield, &data[offset + numBytesPerElement*((quint32)(index/8))], numBytesPerElement);
+            memcpy(&tmpbitfield, &data[offset + info->numBytesPerElement*((quint32)(index/8))], info->numBytesPerElement);
             tmpbitfield = (tmpbitfield & ~(1 << (index % 8))) | ( (value.toUInt()!=0?1:0) << (index % 8) );
-            memcpy(&data[offset + numBytesPerElement*((quint32)(index/8))], &tmpbitfield, numBytesPerElement);
+            memcpy(&data[offset + info->numBytesPerElement*((quint32)(index/8))], &tmpbitfield, info->numBytesPerElement);
             break;
         }
         case STRING:
@@ -1032,7 +1217,7 @@ void UAVObjectField::setValue(const QVariant& value, quint32 index)
             QString str = value.toString();
             QByteArray barray = str.toAscii();
             quint32 index;
-            for (index = 0; index < (quint32)barray.length() && index < (numElements-1); ++index)
+            for (index = 0; index < (quint32)barray.length() && index < (info->numElements-1); ++index)
             {
                 data[offset+index] = barray[index];
             }
@@ -1043,13 +1228,147 @@ void UAVObjectField::setValue(const QVariant& value, quint32 index)
     }
 }
 
+/**
+ * Read a field element of type T from the object data
+ */
+template <typename T> static inline T readElement(const quint8* ptr)
+{
+    T value;
+    memcpy(&value, ptr, sizeof(T));
+    return value;
+}
+
+/**
+ * Write a field element of type T to the object data
+ */
+template <typename T> static inline void writeElement(quint8* ptr, T value)
+{
+    memcpy(ptr, &value, sizeof(T));
+}
+
+/**
+ * Round a double to the nearest value of the integer element type T,
+ * saturating at the limits of the type. NaN is written as zero.
+ */
+template <typename T> static inline T roundElement(double value)
+{
+    if ( value != value )
+    {
+        return 0;
+    }
+    if ( value <= (double)std::numeric_limits<T>::min() )
+    {
+        return std::numeric_limits<T>::min();
+    }
+    if ( value >= (double)std::numeric_limits<T>::max() )
+    {
+        return std::numeric_limits<T>::max();
+    }
+    return (T)qRound64(value);
+}
+
+/**
+ * Get a numeric element as a double. Unlike getValue() this reads the
+ * element directly without going through a QVariant or locking the object,
+ * enum and string fields are still converted through getValue().
+ */
 double UAVObjectField::getDouble(quint32 index)
 {
-    return getValue(index).toDouble();
+    // Check that index is not out of bounds
+    if ( index >= info->numElements )
+    {
+        return 0.0;
+    }
+    quint8 ptr[4];
+    switch (info->type)
+    {
+    case ENUM:
+    case STRING:
+        return getValue(index).toDouble();
+    case BITFIELD:
+        obj->readData(ptr, offset + info->numBytesPerElement*((quint32)(index/8)), 1);
+        return (ptr[0] >> (index % 8)) & 1;
+    default:
+        obj->readData(ptr, offset + info->numBytesPerElement*index, info->numBytesPerElement);
+        break;
+    }
+    switch (info->type)
+    {
+    case INT8:
+        return readElement<qint8>(ptr);
+    case INT16:
+        return readElement<qint16>(ptr);
+    case INT32:
+        return readElement<qint32>(ptr);
+    case UINT8:
+        return readElement<quint8>(ptr);
+    case UINT16:
+        return readElement<quint16>(ptr);
+    case UINT32:
+        return readElement<quint32>(ptr);
+    case FLOAT32:
+        return readElement<float>(ptr);
+    default:
+        return 0.0;
+    }
 }
 
+/**
+ * Set a numeric element from a double, see getDouble(). Integer elements are
+ * rounded to the nearest value and saturate at the limits of their type.
+ */
 void UAVObjectField::setDouble(double value, quint32 index)
 {
-    setValue(QVariant(value), index);
+    FieldWriteLocker locker(obj);
+    // Check that index is not out of bounds
+    if ( index >= info->numElements )
+    {
+        return;
+    }
+    // Update value if the access mode permits
+    UAVObject::Metadata mdata = obj->getMetadata();
+    if ( UAVObject::GetGcsAccess(mdata) != UAVObject::ACCESS_READWRITE )
+    {
+        return;
+    }
+    quint8* ptr = &data[offset + info->numBytesPerElement*index];
+    switch (info->type)
+    {
+    case INT8:
+        writeElement<qint8>(ptr, roundElement<qint8>(value));
+        break;
+    case INT16:
+        writeElement<qint16>(ptr, roundElement<qint16>(value));
+        break;
+    case INT32:
+        writeElement<qint32>(ptr, roundElement<qint32>(value));
+        break;
+    case UINT8:
+        writeElement<quint8>(ptr, roundElement<quint8>(value));
+        break;
+    case UINT16:
+        writeElement<quint16>(ptr, roundElement<quint16>(value));
+        break;
+    case UINT32:
+        writeElement<quint32>(ptr, roundElement<quint32>(value));
+        break;
+    case FLOAT32:
+        writeElement<float>(ptr, (float)value);
+        break;
+    default:
+        setValue(QVariant(value), index);
+        break;
+    }
+}
+
+/**
+ * Get a pointer to the start of the field in the object data. The object must be
+ * locked while the data is accessed and changes wrapped in UAVObject::beginWrite()
+ * and endWrite(), elements are stored in host byte order and are getNumBytes()
+ * long in total.
+ */
+quint8* UAVObjectField::getRawPointer()
+{
+    return &data[offset];
 }
 
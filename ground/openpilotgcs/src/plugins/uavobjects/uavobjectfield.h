@@ -34,6 +34,7 @@
 #include <QVariant>
 #include <QList>
 #include <QMap>
+#include <QHash>
 
 class UAVObject;
 
@@ -51,6 +52,30 @@ public:
         int board;
     } LimitStruct;
 
+    // Description of a field, interned and shared by every instance of the object
+    typedef struct
+    {
+        QString name;
+        QString units;
+        FieldType type;
+        QStringList elementNames;
+        QHash<QString, int> elementIndices;
+        QStringList options;
+        quint32 numElements;
+        quint32 numBytesPerElement;
+        QMap<quint32, QList<LimitStruct> > elementLimits;
+    } Info;
+
+    static const Info* intern(const QString& name, const QString& units, FieldType type, const QStringList& elementNames, const QStringList& options, const QString& limits=QString());
+    static const Info* intern(const QString& name, const QString& units, FieldType type, quint32 numElements, const QStringList& options, const QString& limits=QString());
+    static const Info* intern(const char* name, const char* units, FieldType type, const char* const* elementNames, int numElementNames,
+                              const char* const* options, int numOptions, const char* limits);
+    static qint64 getDescriptionsMemory(qint64* count);
+    static qint64 getPoolMemory(qint64* slots);
+
+    UAVObjectField(const Info* info);
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
     UAVObjectField(const QString& name, const QString& units, FieldType type, quint32 numElements, const QStringList& options,const QString& limits=QString());
     UAVObjectField(const QString& name, const QString& units, FieldType type, const QStringList& elementNames, const QStringList& options,const QString& limits=QString());
     void initialize(quint8* data, quint32 dataOffset, UAVObject* obj);
@@ -61,6 +86,7 @@ public:
     QString getUnits();
     quint32 getNumElements();
     QStringList getElementNames();
+    int getElementIndex(const QString& elementName);
     QStringList getOptions();
     qint32 pack(quint8* dataOut);
     qint32 unpack(const quint8* dataIn);
@@ -69,6 +95,7 @@ public:
     void setValue(const QVariant& data, quint32 index = 0);
     double getDouble(quint32 index = 0);
     void setDouble(double value, quint32 index = 0);
+    quint8* getRawPointer();
     quint32 getDataOffset();
     quint32 getNumBytes();
     bool isNumeric();
@@ -82,20 +109,12 @@ signals:
     void fieldUpdated(UAVObjectField* field);
 
 protected:
-    QString name;
-    QString units;
-    FieldType type;
-    QStringList elementNames;
-    QStringList options;
-    quint32 numElements;
-    quint32 numBytesPerElement;
+    const Info* info;
     quint32 offset;
     quint8* data;
     UAVObject* obj;
-    QMap<quint32, QList<LimitStruct> > elementLimits;
     void clear();
-    void constructorInitialize(const QString& name, const QString& units, FieldType type, const QStringList& elementNames, const QStringList& options, const QString &limits);
-    void limitsInitialize(const QString &limits);
+    static void limitsInitialize(Info* info, const QString &limits);
 
 
 };
@@ -0,0 +1,91 @@
+/**
+ ******************************************************************************
+ *
+ * @file       uavobjectinterest.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief The UAVUObjects GCS plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify 
+ * it under the terms of the GNU General Public License as published by 
+ * the Free Software Foundation; either version 3 of the License, or 
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License 
+ * for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along 
+ * with this program; if not, write to the Free Software Foundation, Inc., 
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "uavobjectinterest.h"
+#include "uavobject.h"
+#include <QWidget>
+#include <QEvent>
+
+UAVObjectInterest::UAVObjectInterest(QWidget* view) :
+    QObject(view),
+    shown(view->isVisible())
+{
+    view->installEventFilter(this);
+}
+
+UAVObjectInterest::~UAVObjectInterest()
+{
+    clear();
+}
+
+/**
+ * Add an object shown by the view, an object added twice is counted once
+ */
+void UAVObjectInterest::addObject(UAVObject* obj)
+{
+    if (!obj || objects.contains(obj))
+        return;
+    objects.append(obj);
+    if (shown)
+        obj->addInterest();
+}
+
+/**
+ * Release all the objects, to be called when the view connects to others
+ */
+void UAVObjectInterest::clear()
+{
+    if (shown)
+    {
+        foreach (UAVObject* obj, objects)
+            obj->removeInterest();
+    }
+    objects.clear();
+}
+
+bool UAVObjectInterest::eventFilter(QObject* obj, QEvent* event)
+{
+    if (event->type() == QEvent::Show)
+        setShown(true);
+    else if (event->type() == QEvent::Hide)
+        setShown(false);
+    return QObject::eventFilter(obj, event);
+}
+
+void UAVObjectInterest::setShown(bool shown)
+{
+    if (shown == this->shown)
+        return;
+    this->shown = shown;
+    foreach (UAVObject* obj, objects)
+    {
+        if (shown)
+            obj->addInterest();
+        else
+            obj->removeInterest();
+    }
+}
@@ -0,0 +1,64 @@
+/**
+ ******************************************************************************
+ *
+ * @file       uavobjectinterest.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief The UAVUObjects GCS plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify 
+ * it under the terms of the GNU General Public License as published by 
+ * the Free Software Foundation; either version 3 of the License, or 
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License 
+ * for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along 
+ * with this program; if not, write to the Free Software Foundation, Inc., 
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef UAVOBJECTINTEREST_H
+#define UAVOBJECTINTEREST_H
+
+#include "uavobjects_global.h"
+#include <QObject>
+#include <QList>
+
+class QWidget;
+class UAVObject;
+
+/**
+ * Holds the interest of a view in its objects, see UAVObject::addInterest().
+ * The objects are marked as shown while the view is visible and released
+ * when it is hidden or deleted. The helper is a child of the view.
+ */
+class UAVOBJECTS_EXPORT UAVObjectInterest: public QObject
+{
+    Q_OBJECT
+
+public:
+    UAVObjectInterest(QWidget* view);
+    ~UAVObjectInterest();
+
+    void addObject(UAVObject* obj);
+    void clear();
+
+protected:
+    bool eventFilter(QObject* obj, QEvent* event);
+
+private:
+    QList<UAVObject*> objects;
+    bool shown;
+
+    void setShown(bool shown);
+};
+
+#endif // UAVOBJECTINTEREST_H
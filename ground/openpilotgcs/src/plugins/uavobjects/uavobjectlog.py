@@ -0,0 +1,153 @@
+__all__ = ("load", "scan", "read_records")
+
+##
+##############################################################################
+#
+# @file       uavobjectlog.py
+# @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+# @brief      Bulk decoding of GCS .opl logs into NumPy arrays
+#
+#             The records are scanned once into per object offset arrays,
+#             then every object type is decoded with a single frombuffer
+#             over its gathered payloads, using the structured dtypes the
+#             uavobjectgenerator writes to python/uavobjectdtypes.py.
+#
+#               import uavobjectlog
+#               log = uavobjectlog.load("flight.opl")
+#               gyros = log["Gyros"]
+#               plot(gyros.time, gyros.data["x"])
+#
+# @see        The GNU Public License (GPL) Version 3
+#
+#############################################################################/
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+# for more details.
+#
+# You should have received a copy of the GNU General Public License along
+# with this program; if not, write to the Free Software Foundation, Inc.,
+# 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+#
+
+import struct
+import zlib
+from collections import namedtuple
+
+import numpy as np
+
+from uavobjectdtypes import DTYPES
+
+# See logfile.cpp for the layout
+LOG_HEADER_MAGIC = b"OPLOGHDR"
+LOG_INDEX_MAGIC = b"OPLOGIDX"
+LOG_FOOTER_LENGTH = 16
+RECORD_HEADER = struct.Struct("<Iq")    # timestamp (ms), size
+PACKET_HEADER = struct.Struct("<BBHI")  # sync, type, length, object ID
+
+UAVTALK_SYNC_VAL = 0x3C
+UAVTALK_TYPE_MASK = 0xF8
+UAVTALK_TYPE_OBJ = 0x20
+UAVTALK_TYPE_OBJ_ACK = 0x22
+UAVTALK_HEADER_LENGTH = 8
+UAVTALK_INSTID_LENGTH = 2
+
+# time: record timestamps (ms), instance: instance IDs (None for single
+# instance objects), data: structured array with one row per update
+LogObject = namedtuple("LogObject", "time instance data")
+
+def read_records(path):
+    """Returns the record stream of a log as bytes, uncompressed."""
+    with open(path, "rb") as f:
+        raw = f.read()
+
+    if raw[:8] != LOG_HEADER_MAGIC:
+        # Version 1, records only
+        return raw
+    version, length = struct.unpack_from("<II", raw, 8)
+    start = 16 + length
+    end = len(raw)
+    if end >= start + LOG_FOOTER_LENGTH and raw[-8:] == LOG_INDEX_MAGIC:
+        end = struct.unpack_from("<q", raw, end - LOG_FOOTER_LENGTH)[0]
+    if version < 3:
+        return raw[start:end]
+
+    # Blocks of a length then qCompress() output, which is a big endian
+    # size in front of the zlib data
+    blocks = []
+    pos = start
+    while pos + 4 <= end:
+        length = struct.unpack_from("<I", raw, pos)[0]
+        pos += 4
+        if length < 4 or pos + length > end:
+            break
+        blocks.append(zlib.decompress(raw[pos + 4:pos + length]))
+        pos += length
+    return b"".join(blocks)
+
+def scan(records):
+    """Walks the records once, returns {objid: (times, payload offsets)}
+    for every object update whose packet is whole and has the current
+    layout of its object."""
+    found = {}
+    pos = 0
+    end = len(records)
+    while pos + RECORD_HEADER.size <= end:
+        timestamp, size = RECORD_HEADER.unpack_from(records, pos)
+        packet = pos + RECORD_HEADER.size
+        pos = packet + size
+        if size < UAVTALK_HEADER_LENGTH or pos > end:
+            break
+        sync, type, length, objid = PACKET_HEADER.unpack_from(records, packet)
+        if sync != UAVTALK_SYNC_VAL or (type & UAVTALK_TYPE_MASK) != UAVTALK_TYPE_OBJ:
+            continue
+        if type != UAVTALK_TYPE_OBJ and type != UAVTALK_TYPE_OBJ_ACK:
+            continue
+        obj = DTYPES.get(objid)
+        if obj is None:
+            continue
+        header = UAVTALK_HEADER_LENGTH
+        if not obj[1]:
+            header += UAVTALK_INSTID_LENGTH
+        if length != header + obj[2].itemsize or size < length:
+            continue
+        entry = found.get(objid)
+        if entry is None:
+            entry = found[objid] = ([], [])
+        entry[0].append(timestamp)
+        entry[1].append(packet + header)
+    return found
+
+def load(path, names=None):
+    """Decodes a log, returns {object name: LogObject}. Only the objects
+    in names are decoded if it is given."""
+    records = read_records(path)
+    buf = np.frombuffer(records, dtype=np.uint8)
+    decoded = {}
+    for objid, (times, offsets) in scan(records).items():
+        name, single, dtype = DTYPES[objid]
+        if names is not None and name not in names:
+            continue
+        offsets = np.asarray(offsets, dtype=np.int64)
+        # Gather all payloads into one contiguous block and view it whole
+        payloads = buf[offsets[:, np.newaxis] + np.arange(dtype.itemsize)]
+        data = np.frombuffer(payloads.tobytes(), dtype=dtype)
+        instance = None
+        if not single:
+            instance = buf[offsets - 2].astype(np.uint16) | (buf[offsets - 1].astype(np.uint16) << 8)
+        decoded[name] = LogObject(np.asarray(times, dtype=np.uint32), instance, data)
+    return decoded
+
+def main():
+    import sys
+    for name, obj in sorted(load(sys.argv[1]).items()):
+        print ("%-30s %8u updates" % (name, len(obj.data)))
+
+if __name__ == "__main__":
+    main()
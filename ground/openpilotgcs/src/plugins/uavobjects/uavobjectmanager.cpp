@@ -27,16 +27,74 @@
  */
 #include "uavobjectmanager.h"
 
+/**
+ * Index entry for one object type. Entries are created once per type and are
+ * never moved or deleted while the manager exists, so a pointer to one can be
+ * kept as an ObjectHandle.
+ */
+struct UAVObjectManager::TypeEntry
+{
+    int listIdx;        ///< Position of the instance list in objects
+    UAVObject* first;   ///< Instance 0, fixed once the type is registered
+};
+
+/**
+ * Immutable copy of the registry for one objectsVersion, with the data and meta
+ * object views already filtered. A snapshot is never changed, and a replaced one
+ * is only deleted once no reader holds a snapshot, so readers can use it without
+ * taking the mutex.
+ */
+struct UAVObjectManager::Snapshot
+{
+    int version;
+    QList< QList<UAVObject*> > objects;
+    QList< QList<UAVDataObject*> > dataObjects;
+    QList< QList<UAVMetaObject*> > metaObjects;
+};
+
+/**
+ * Layout of a saveState() blob: the header, count entries, then the data of
+ * all instances back to back. Everything is in host byte order.
+ */
+struct StateHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 count;
+};
+
+struct StateEntry
+{
+    quint32 objId;
+    quint32 instId;
+    quint32 offset;     ///< From the start of the blob
+    quint32 length;
+};
+
 /**
  * Constructor
  */
 UAVObjectManager::UAVObjectManager()
 {
     mutex = new QMutex(QMutex::Recursive);
+    qRegisterMetaType< QList<UAVObject*> >("QList<UAVObject*>");
+    // Setup the timer used to deliver coalesced change notifications, it only
+    // runs while something is connected to objectsChanged()
+    changeTimer = new QTimer(this);
+    changeTimer->setInterval(DEFAULT_CHANGE_PERIOD_MS);
+    connect(changeTimer, SIGNAL(timeout()), this, SLOT(emitObjectsChanged()));
 }
 
 UAVObjectManager::~UAVObjectManager()
 {
+    // The manager owns every instance registered with it
+    for (int objidx = 0; objidx < objects.length(); ++objidx)
+    {
+        qDeleteAll(objects[objidx]);
+    }
+    qDeleteAll(idIndex);
+    qDeleteAll(retiredSnapshots);
+    delete snapshot.fetchAndStoreOrdered(NULL);
     delete mutex;
 }
 
@@ -44,76 +102,115 @@ UAVObjectManager::~UAVObjectManager()
  * Register an object with the manager. This function must be called for all newly created instances.
  * A new instance can be created directly by instantiating a new object or by calling clone() of
  * an existing object. The object will be registered and will be properly initialized so that it can accept
- * updates.
+ * updates. Instances missing below its instance ID are created and reported in the same newInstances().
  */
 bool UAVObjectManager::registerObject(UAVDataObject* obj)
 {
     QMutexLocker locker(mutex);
     // Check if this object type is already in the list
-    for (int objidx = 0; objidx < objects.length(); ++objidx)
+    TypeEntry* entry = idIndex.value(obj->getObjID(), NULL);
+    if (entry != NULL)
     {
-        // Check if the object ID is in the list
-        if (objects[objidx].length() > 0 && objects[objidx][0]->getObjID() == obj->getObjID())
+        int objidx = entry->listIdx;
+        // Check if this is a single instance object, if yes we can not add a new instance
+        if (obj->isSingleInstance())
         {
-            // Check if this is a single instance object, if yes we can not add a new instance
-            if (obj->isSingleInstance())
-            {
-                return false;
-            }
-            // The object type has alredy been added, so now we need to initialize the new instance with the appropriate id
-            // There is a single metaobject for all object instances of this type, so no need to create a new one
-            // Get object type metaobject from existing instance
-            UAVDataObject* refObj = dynamic_cast<UAVDataObject*>(objects[objidx][0]);
-            if (refObj == NULL)
-            {
-                return false;
-            }
-            UAVMetaObject* mobj = refObj->getMetaObject();
-            // If the instance ID is specified and not at the default value (0) then we need to make sure
-            // that there are no gaps in the instance list. If gaps are found then then additional instances
-            // will be created.
-            if ( (obj->getInstID() > 0) && (obj->getInstID() < MAX_INSTANCES) )
+            return false;
+        }
+        // The object type has alredy been added, so now we need to initialize the new instance with the appropriate id
+        // There is a single metaobject for all object instances of this type, so no need to create a new one
+        // Get object type metaobject from existing instance
+        UAVDataObject* refObj = dynamic_cast<UAVDataObject*>(objects[objidx][0]);
+        if (refObj == NULL)
+        {
+            return false;
+        }
+        UAVMetaObject* mobj = refObj->getMetaObject();
+        QList<UAVObject*> created;
+        // If the instance ID is specified and not at the default value (0) then we need to make sure
+        // that there are no gaps in the instance list. If gaps are found then then additional instances
+        // will be created.
+        if ( (obj->getInstID() > 0) && (obj->getInstID() < MAX_INSTANCES) )
+        {
+            for (int instidx = 0; instidx < objects[objidx].length(); ++instidx)
             {
-                for (int instidx = 0; instidx < objects[objidx].length(); ++instidx)
-                {
-                    if ( objects[objidx][instidx]->getInstID() == obj->getInstID() )
-                    {
-                        // Instance conflict, do not add
-                        return false;
-                    }
-                }
-                // Check if there are any gaps between the requested instance ID and the ones in the list,
-                // if any then create the missing instances.
-                for (quint32 instidx = objects[objidx].length(); instidx < obj->getInstID(); ++instidx)
+                if ( objects[objidx][instidx]->getInstID() == obj->getInstID() )
                 {
-                    UAVDataObject* cobj = obj->clone(instidx);
-                    cobj->initialize(mobj);
-                    objects[objidx].append(cobj);
-                    getObject(cobj->getObjID())->emitNewInstance(cobj);
-                    emit newInstance(cobj);
+                    // Instance conflict, do not add
+                    return false;
                 }
-                // Finally, initialize the actual object instance
-                obj->initialize(mobj);
-            }
-            else if (obj->getInstID() == 0)
-            {
-                // Assign the next available ID and initialize the object instance
-                obj->initialize(objects[objidx].length(), mobj);
             }
-            else
+            // Check if there are any gaps between the requested instance ID and the ones in the list,
+            // if any then create the missing instances.
+            cloneInstances(objidx, obj, obj->getInstID(), created);
+            // Finally, initialize the actual object instance
+            obj->initialize(mobj);
+        }
+        else if (obj->getInstID() == 0)
+        {
+            // Assign the next available ID and initialize the object instance
+            obj->initialize(objects[objidx].length(), mobj);
+        }
+        else
+        {
+            return false;
+        }
+        // Add the actual object instance in the list
+        objects[objidx].append(obj);
+        objectsVersion.ref();
+        trackChanges(obj);
+        created.append(obj);
+        notifyNewInstances(created);
+        return true;
+    }
+    // If this point is reached then this is the first time this object type (ID) is added in the list
+    addType(obj);
+    return true;
+}
+
+/**
+ * Register the first instance of many object types at once, as UAVObjectsInitialize()
+ * does at start-up. The containers are sized for the whole batch and the lock is
+ * taken once. Objects that are not the first of their type go through registerObject().
+ * @returns The number of objects registered
+ */
+int UAVObjectManager::registerObjects(const QList<UAVDataObject*>& objs)
+{
+    QList<UAVDataObject*> instances;
+    int registered = 0;
+    {
+        QMutexLocker locker(mutex);
+        // Every new type also brings its metaobject
+        objects.reserve(objects.length() + 2 * objs.length());
+        idIndex.reserve(idIndex.size() + 2 * objs.length());
+        nameIndex.reserve(nameIndex.size() + 2 * objs.length());
+        foreach (UAVDataObject* obj, objs)
+        {
+            if (idIndex.contains(obj->getObjID()) || obj->getInstID() != 0)
             {
-                return false;
+                instances.append(obj);
+                continue;
             }
-            // Add the actual object instance in the list
-            objects[objidx].append(obj);
-            getObject(obj->getObjID())->emitNewInstance(obj);
-            emit newInstance(obj);
-            return true;
+            addType(obj);
+            ++registered;
         }
     }
-    // If this point is reached then this is the first time this object type (ID) is added in the list
-    // create a new list of the instances, add in the object collection and create the object's metaobject
-    // Create metaobject
+    foreach (UAVDataObject* obj, instances)
+    {
+        if (registerObject(obj))
+        {
+            ++registered;
+        }
+    }
+    return registered;
+}
+
+/**
+ * Add a new object type with its metaobject, must be called with the mutex held
+ */
+void UAVObjectManager::addType(UAVDataObject* obj)
+{
+    // Create a new list of the instances, add in the object collection and create the object's metaobject
     QString mname = obj->getName();
     mname.append("Meta");
     UAVMetaObject* mobj = new UAVMetaObject(obj->getObjID()+1, mname, obj);
@@ -122,7 +219,83 @@ bool UAVObjectManager::registerObject(UAVDataObject* obj)
     // Add to list
     addObject(obj);
     addObject(mobj);
-    return true;
+}
+
+/**
+ * Create count new instances of an object type at once, they get the next free
+ * instance IDs. Listeners get a single newInstances() for all of them, which is
+ * much cheaper than registering the clones one by one when loading a large mission.
+ * @param obj Any instance of the object type
+ * @param count Number of instances to add, limited to MAX_INSTANCES in total
+ * @returns The new instances, empty if the type is not registered or single instance
+ */
+QList<UAVObject*> UAVObjectManager::createInstances(UAVDataObject* obj, quint32 count)
+{
+    QMutexLocker locker(mutex);
+    QList<UAVObject*> created;
+    TypeEntry* entry = idIndex.value(obj->getObjID(), NULL);
+    if (entry == NULL || obj->isSingleInstance())
+    {
+        return created;
+    }
+    UAVDataObject* refObj = dynamic_cast<UAVDataObject*>(entry->first);
+    if (refObj == NULL)
+    {
+        return created;
+    }
+    quint32 endInstId = objects[entry->listIdx].length();
+    endInstId = (count < MAX_INSTANCES - endInstId) ? endInstId + count : MAX_INSTANCES;
+    cloneInstances(entry->listIdx, refObj, endInstId, created);
+    notifyNewInstances(created);
+    return created;
+}
+
+/**
+ * Append clones of refObj to an instance list until it reaches endInstId, must be
+ * called with the mutex held. The registry version changes once for the whole batch.
+ */
+void UAVObjectManager::cloneInstances(int objidx, UAVDataObject* refObj, quint32 endInstId, QList<UAVObject*>& created)
+{
+    UAVMetaObject* mobj = static_cast<UAVDataObject*>(objects[objidx][0])->getMetaObject();
+    quint32 instidx = objects[objidx].length();
+    if (instidx >= endInstId)
+    {
+        return;
+    }
+    objects[objidx].reserve(endInstId);
+    for (; instidx < endInstId; ++instidx)
+    {
+        UAVDataObject* cobj = refObj->clone(instidx);
+        cobj->initialize(mobj);
+        objects[objidx].append(cobj);
+        trackChanges(cobj);
+        created.append(cobj);
+    }
+    objectsVersion.ref();
+}
+
+/**
+ * Announce instances added by registerObject() or createInstances(). newInstance()
+ * is only emitted per instance when something listens to it, newInstances() carries
+ * the whole batch.
+ */
+void UAVObjectManager::notifyNewInstances(const QList<UAVObject*>& objs)
+{
+    if (objs.isEmpty())
+    {
+        return;
+    }
+    UAVObject* typeObj = getObject(objs[0]->getObjID());
+    bool perInstance = receivers(SIGNAL(newInstance(UAVObject*))) > 0;
+    foreach (UAVObject* obj, objs)
+    {
+        typeObj->emitNewInstance(obj);
+        if (perInstance)
+        {
+            emit newInstance(obj);
+        }
+    }
+    emit newInstances(objs);
 }
 
 void UAVObjectManager::addObject(UAVObject* obj)
@@ -131,91 +304,397 @@ void UAVObjectManager::addObject(UAVObject* obj)
     QList<UAVObject*> list;
     list.append(obj);
     objects.append(list);
+    objectsVersion.ref();
+    // Add to the lookup indices
+    TypeEntry* entry = new TypeEntry;
+    entry->listIdx = objects.length() - 1;
+    entry->first = obj;
+    idIndex.insert(obj->getObjID(), entry);
+    nameIndex.insert(obj->getName(), entry);
+    trackChanges(obj);
     emit newObject(obj);
 }
 
 /**
- * Get all objects. A two dimentional QList is returned. Objects are grouped by
- * instances of the same object type.
+ * Listen to updates of an object so they can be reported through objectsChanged().
+ * The connection is direct since updates may be unpacked on the telemetry thread.
  */
-QList< QList<UAVObject*> > UAVObjectManager::getObjects()
+void UAVObjectManager::trackChanges(UAVObject* obj)
 {
-    QMutexLocker locker(mutex);
-    return objects;
+    connect(obj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(objectChanged(UAVObject*)), Qt::DirectConnection);
 }
 
 /**
- * Same as getObjects() but will only return DataObjects.
+ * Set how often objectsChanged() is emitted, typically once per display frame.
  */
-QList< QList<UAVDataObject*> > UAVObjectManager::getDataObjects()
+void UAVObjectManager::setChangeNotificationPeriod(int periodMs)
 {
-    QMutexLocker locker(mutex);
-    QList< QList<UAVDataObject*> > dObjects;
+    QMetaObject::invokeMethod(changeTimer, "setInterval", Qt::QueuedConnection, Q_ARG(int, periodMs));
+}
 
-    // Go through objects and copy to new list when types match
-    for (int objidx = 0; objidx < objects.length(); ++objidx)
+/**
+ * Start delivering change notifications when the first receiver connects to objectsChanged().
+ * Gadgets that only display the latest value of an object can connect to it instead of
+ * objectUpdated() and do their work once per period rather than once per packet.
+ */
+void UAVObjectManager::connectNotify(const char* signal)
+{
+    if (QMetaObject::normalizedSignature(signal) == QMetaObject::normalizedSignature(SIGNAL(objectsChanged(QList<UAVObject*>))))
     {
-        if (objects[objidx].length() > 0)
+        if (changeListeners.fetchAndAddOrdered(1) == 0)
         {
-            // Check type
-            UAVDataObject* obj = dynamic_cast<UAVDataObject*>(objects[objidx][0]);
-            if (obj != NULL)
-            {
-                // Create instance list
-                QList<UAVDataObject*> list;
-                // Go through instances and cast them to UAVDataObject, then add to list
-                for (int instidx = 0; instidx < objects[objidx].length(); ++instidx)
-                {
-                   obj = dynamic_cast<UAVDataObject*>(objects[objidx][instidx]);
-                   if (obj != NULL)
-                   {
-                       list.append(obj);
-                   }
-                }
-                // Append to object list
-                dObjects.append(list);
-            }
+            QMetaObject::invokeMethod(changeTimer, "start", Qt::QueuedConnection);
         }
     }
-    // Done
-    return dObjects;
 }
 
 /**
- * Same as getObjects() but will only return MetaObjects.
+ * Stop delivering change notifications once the last receiver has disconnected.
  */
-QList <QList<UAVMetaObject*> > UAVObjectManager::getMetaObjects()
+void UAVObjectManager::disconnectNotify(const char* signal)
+{
+    if (QMetaObject::normalizedSignature(signal) == QMetaObject::normalizedSignature(SIGNAL(objectsChanged(QList<UAVObject*>))))
+    {
+        if (changeListeners.fetchAndAddOrdered(-1) == 1)
+        {
+            QMetaObject::invokeMethod(changeTimer, "stop", Qt::QueuedConnection);
+        }
+    }
+}
+
+/**
+ * Called each time an object is updated, records it for the next objectsChanged()
+ */
+void UAVObjectManager::objectChanged(UAVObject* obj)
+{
+    if (changeListeners == 0)
+    {
+        return;
+    }
+    QMutexLocker locker(&changedMutex);
+    changedObjects.insert(obj);
+}
+
+/**
+ * Emit the list of objects which changed since the previous notification
+ */
+void UAVObjectManager::emitObjectsChanged()
+{
+    QList<UAVObject*> objs;
+    {
+        QMutexLocker locker(&changedMutex);
+        if (changedObjects.isEmpty())
+        {
+            return;
+        }
+        objs = changedObjects.toList();
+        changedObjects.clear();
+    }
+    emit objectsChanged(objs);
+}
+
+/**
+ * Copy the data of every instance, meta objects included, into one blob with a
+ * table of the object and instance IDs. Each instance is copied consistently
+ * with readData(), no signals are emitted and the telemetry is not blocked.
+ * The data is kept as held in memory, the blob is meant for restoreState() in
+ * a GCS of the same build and byte order.
+ */
+QByteArray UAVObjectManager::saveState()
+{
+    const Snapshot* registry = acquireSnapshot();
+    quint32 count = 0;
+    quint32 dataBytes = 0;
+    foreach (const QList<UAVObject*>& list, registry->objects)
+    {
+        foreach (UAVObject* obj, list)
+        {
+            ++count;
+            dataBytes += obj->getNumBytes();
+        }
+    }
+
+    quint32 offset = sizeof(StateHeader) + count * sizeof(StateEntry);
+    QByteArray state(offset + dataBytes, 0);
+    quint8* base = reinterpret_cast<quint8*>(state.data());
+    StateHeader* header = reinterpret_cast<StateHeader*>(base);
+    header->magic = STATE_MAGIC;
+    header->version = STATE_VERSION;
+    header->count = count;
+    StateEntry* entry = reinterpret_cast<StateEntry*>(base + sizeof(StateHeader));
+    foreach (const QList<UAVObject*>& list, registry->objects)
+    {
+        foreach (UAVObject* obj, list)
+        {
+            entry->objId = obj->getObjID();
+            entry->instId = obj->getInstID();
+            entry->offset = offset;
+            entry->length = obj->getNumBytes();
+            obj->readData(base + offset, 0, entry->length);
+            offset += entry->length;
+            ++entry;
+        }
+    }
+    releaseSnapshot();
+    return state;
+}
+
+/**
+ * Copy the data of a saveState() blob back into the objects. Instances which
+ * do not exist or whose size changed are skipped, missing instances are not
+ * created. objectUpdated() is not emitted per object, the restored objects are
+ * reported at once with objectsChanged().
+ * @return The number of instances restored or -1 if the blob is not valid
+ */
+int UAVObjectManager::restoreState(const QByteArray& state)
+{
+    const quint8* base = reinterpret_cast<const quint8*>(state.constData());
+    quint32 size = state.size();
+    if (size < sizeof(StateHeader))
+    {
+        return -1;
+    }
+    const StateHeader* header = reinterpret_cast<const StateHeader*>(base);
+    if (header->magic != STATE_MAGIC || header->version != STATE_VERSION ||
+        header->count > (size - sizeof(StateHeader)) / sizeof(StateEntry))
+    {
+        return -1;
+    }
+
+    const StateEntry* entries = reinterpret_cast<const StateEntry*>(base + sizeof(StateHeader));
+    for (quint32 n = 0; n < header->count; ++n)
+    {
+        if (entries[n].offset > size || entries[n].length > size - entries[n].offset)
+        {
+            return -1;
+        }
+    }
+
+    QList<UAVObject*> restored;
+    const StateEntry* entry = entries;
+    for (quint32 n = 0; n < header->count; ++n, ++entry)
+    {
+        UAVObject* obj = getObject(entry->objId, entry->instId);
+        if (obj == NULL || obj->getNumBytes() != entry->length)
+        {
+            continue;
+        }
+        obj->writeData(base + entry->offset, 0, entry->length);
+        restored.append(obj);
+    }
+
+    // One notification for the lot, along with the changes already pending
+    {
+        QMutexLocker locker(&changedMutex);
+        foreach (UAVObject* obj, restored)
+        {
+            changedObjects.insert(obj);
+        }
+    }
+    emitObjectsChanged();
+    return restored.length();
+}
+
+/**
+ * Find the index entry of an object type by name or ID, must be called with the mutex held.
+ */
+UAVObjectManager::TypeEntry* UAVObjectManager::findType(const QString* name, quint32 objId)
+{
+    if (name != NULL)
+    {
+        return nameIndex.value(*name, NULL);
+    }
+    return idIndex.value(objId, NULL);
+}
+
+/**
+ * Find an instance of an object type, must be called with the mutex held.
+ */
+UAVObject* UAVObjectManager::findInstance(const TypeEntry* entry, quint32 instId)
+{
+    const QList<UAVObject*>& list = objects[entry->listIdx];
+    // Instances are registered without gaps so the ID is normally also the position
+    if (instId < (quint32)list.length() && list[instId]->getInstID() == instId)
+    {
+        return list[instId];
+    }
+    for (int instidx = 0; instidx < list.length(); ++instidx)
+    {
+        if (list[instidx]->getInstID() == instId)
+        {
+            return list[instidx];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Get a handle to an object type given its name. The handle remains valid for the
+ * lifetime of the manager and can be used with getObject(ObjectHandle, quint32).
+ * @returns The handle or NULL if the object is not registered
+ */
+UAVObjectManager::ObjectHandle UAVObjectManager::getObjectHandle(const QString& name)
 {
     QMutexLocker locker(mutex);
-    QList< QList<UAVMetaObject*> > mObjects;
+    return findType(&name, 0);
+}
+
+/**
+ * Get a handle to an object type given its object ID.
+ * @returns The handle or NULL if the object is not registered
+ */
+UAVObjectManager::ObjectHandle UAVObjectManager::getObjectHandle(quint32 objId)
+{
+    QMutexLocker locker(mutex);
+    return findType(NULL, objId);
+}
+
+/**
+ * Get a specific object given a handle obtained from getObjectHandle().
+ * Instance 0 never changes once registered, so it is returned without taking the mutex.
+ * @returns The object is found or NULL if not
+ */
+UAVObject* UAVObjectManager::getObject(ObjectHandle handle, quint32 instId)
+{
+    if (handle == NULL)
+    {
+        return NULL;
+    }
+    if (instId == 0)
+    {
+        return handle->first;
+    }
+    QMutexLocker locker(mutex);
+    return findInstance(handle, instId);
+}
+
+/**
+ * Get the snapshot of the registry for the current objectsVersion and hold it
+ * until releaseSnapshot(). The snapshot is rebuilt by the first reader after
+ * objects or instances were added, all other reads only load the pointer.
+ */
+const UAVObjectManager::Snapshot* UAVObjectManager::acquireSnapshot()
+{
+    Snapshot* current = snapshot.fetchAndAddAcquire(0);
+    if (current == NULL || current->version != objectsVersion)
+    {
+        rebuildSnapshot();
+    }
+    // Count the reader before loading the pointer, so a rebuild that sees no
+    // readers knows nobody can still hold a retired snapshot
+    snapshotReaders.ref();
+    return snapshot.fetchAndAddAcquire(0);
+}
 
-    // Go through objects and copy to new list when types match
+/**
+ * Release the snapshot returned by acquireSnapshot()
+ */
+void UAVObjectManager::releaseSnapshot()
+{
+    snapshotReaders.deref();
+}
+
+/**
+ * Build the snapshot for the current objectsVersion and publish it
+ */
+void UAVObjectManager::rebuildSnapshot()
+{
+    QMutexLocker locker(mutex);
+    Snapshot* current = snapshot.fetchAndAddAcquire(0);
+    if (current != NULL && current->version == objectsVersion)
+    {
+        return;
+    }
+    Snapshot* next = new Snapshot;
+    next->version = objectsVersion;
+    next->objects = objects;
+    // Filter the data and meta objects once per version instead of per call
     for (int objidx = 0; objidx < objects.length(); ++objidx)
     {
-        if (objects[objidx].length() > 0)
+        if (objects[objidx].length() == 0)
         {
-            // Check type
-            UAVMetaObject* obj = dynamic_cast<UAVMetaObject*>(objects[objidx][0]);
-            if (obj != NULL)
+            continue;
+        }
+        if (dynamic_cast<UAVDataObject*>(objects[objidx][0]) != NULL)
+        {
+            QList<UAVDataObject*> list;
+            for (int instidx = 0; instidx < objects[objidx].length(); ++instidx)
             {
-                // Create instance list
-                QList<UAVMetaObject*> list;
-                // Go through instances and cast them to UAVMetaObject, then add to list
-                for (int instidx = 0; instidx < objects[objidx].length(); ++instidx)
+                UAVDataObject* obj = dynamic_cast<UAVDataObject*>(objects[objidx][instidx]);
+                if (obj != NULL)
                 {
-                   obj = dynamic_cast<UAVMetaObject*>(objects[objidx][instidx]);
-                   if (obj != NULL)
-                   {
-                       list.append(obj);
-                   }
+                    list.append(obj);
                 }
-                // Append to object list
-                mObjects.append(list);
             }
+            next->dataObjects.append(list);
         }
+        else if (dynamic_cast<UAVMetaObject*>(objects[objidx][0]) != NULL)
+        {
+            QList<UAVMetaObject*> list;
+            for (int instidx = 0; instidx < objects[objidx].length(); ++instidx)
+            {
+                UAVMetaObject* obj = dynamic_cast<UAVMetaObject*>(objects[objidx][instidx]);
+                if (obj != NULL)
+                {
+                    list.append(obj);
+                }
+            }
+            next->metaObjects.append(list);
+        }
+    }
+    // Readers may still be copying from the previous snapshot, keep it
+    if (current != NULL)
+    {
+        retiredSnapshots.append(current);
+    }
+    snapshot.fetchAndStoreOrdered(next);
+    // Readers arriving from now on load the new snapshot. If none is in
+    // flight the retired ones are unused and the list does not grow.
+    if (snapshotReaders.fetchAndAddOrdered(0) == 0)
+    {
+        qDeleteAll(retiredSnapshots);
+        retiredSnapshots.clear();
     }
-    // Done
-    return mObjects;
+}
+
+/**
+ * Get the version of the registry, it changes each time an object or instance
+ * is added. Callers can compare it to skip rebuilding views of the objects.
+ */
+int UAVObjectManager::getObjectsVersion()
+{
+    return objectsVersion;
+}
+
+/**
+ * Get all objects. A two dimentional QList is returned. Objects are grouped by
+ * instances of the same object type.
+ */
+QList< QList<UAVObject*> > UAVObjectManager::getObjects()
+{
+    QList< QList<UAVObject*> > list = acquireSnapshot()->objects;
+    releaseSnapshot();
+    return list;
+}
+
+/**
+ * Same as getObjects() but will only return DataObjects.
+ */
+QList< QList<UAVDataObject*> > UAVObjectManager::getDataObjects()
+{
+    QList< QList<UAVDataObject*> > list = acquireSnapshot()->dataObjects;
+    releaseSnapshot();
+    return list;
+}
+
+/**
+ * Same as getObjects() but will only return MetaObjects.
+ */
+QList <QList<UAVMetaObject*> > UAVObjectManager::getMetaObjects()
+{
+    QList< QList<UAVMetaObject*> > list = acquireSnapshot()->metaObjects;
+    releaseSnapshot();
+    return list;
 }
 
 /**
@@ -242,24 +721,10 @@ UAVObject* UAVObjectManager::getObject(quint32 objId, quint32 instId)
 UAVObject* UAVObjectManager::getObject(const QString* name, quint32 objId, quint32 instId)
 {
     QMutexLocker locker(mutex);
-    // Check if this object type is already in the list
-    for (int objidx = 0; objidx < objects.length(); ++objidx)
+    TypeEntry* entry = findType(name, objId);
+    if (entry != NULL)
     {
-        // Check if the object ID is in the list
-        if (objects[objidx].length() > 0)
-        {
-            if ( (name != NULL && objects[objidx][0]->getName().compare(name) == 0) || (name == NULL && objects[objidx][0]->getObjID() == objId) )
-            {
-                // Look for the requested instance ID
-                for (int instidx = 0; instidx < objects[objidx].length(); ++instidx)
-                {
-                    if (objects[objidx][instidx]->getInstID() == instId)
-                    {
-                        return objects[objidx][instidx];
-                    }
-                }
-            }
-        }
+        return findInstance(entry, instId);
     }
     //qWarning("UAVObjectManager::getObject: Object not found.  Probably a bug or mismatched GCS/flight versions.");
     // If this point is reached then the requested object could not be found
@@ -288,17 +753,10 @@ QList<UAVObject*> UAVObjectManager::getObjectInstances(quint32 objId)
 QList<UAVObject*> UAVObjectManager::getObjectInstances(const QString* name, quint32 objId)
 {
     QMutexLocker locker(mutex);
-    // Check if this object type is already in the list
-    for (int objidx = 0; objidx < objects.length(); ++objidx)
+    TypeEntry* entry = findType(name, objId);
+    if (entry != NULL)
     {
-        // Check if the object ID is in the list
-        if (objects[objidx].length() > 0)
-        {
-            if ( (name != NULL && objects[objidx][0]->getName().compare(name) == 0) || (name == NULL && objects[objidx][0]->getObjID() == objId) )
-            {
-                return objects[objidx];
-            }
-        }
+        return objects[entry->listIdx];
     }
     // If this point is reached then the requested object could not be found
     return QList<UAVObject*>();
@@ -326,17 +784,10 @@ qint32 UAVObjectManager::getNumInstances(quint32 objId)
 qint32 UAVObjectManager::getNumInstances(const QString* name, quint32 objId)
 {
     QMutexLocker locker(mutex);
-    // Check if this object type is already in the list
-    for (int objidx = 0; objidx < objects.length(); ++objidx)
+    TypeEntry* entry = findType(name, objId);
+    if (entry != NULL)
     {
-        // Check if the object ID is in the list
-        if (objects[objidx].length() > 0)
-        {
-            if ( (name != NULL && objects[objidx][0]->getName().compare(name) == 0) || (name == NULL && objects[objidx][0]->getObjID() == objId) )
-            {
-                return objects[objidx].length();
-            }
-        }
+        return objects[entry->listIdx].length();
     }
     // If this point is reached then the requested object could not be found
     return -1;
@@ -33,43 +33,99 @@
 #include "uavdataobject.h"
 #include "uavmetaobject.h"
 #include <QList>
+#include <QHash>
+#include <QSet>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QTimer>
+#include <QByteArray>
+#include <QMetaType>
 
 class UAVOBJECTS_EXPORT UAVObjectManager: public QObject
 {
     Q_OBJECT
 
 public:
+    struct TypeEntry;
+    typedef const TypeEntry* ObjectHandle;
+
     UAVObjectManager();
     ~UAVObjectManager();
 
     bool registerObject(UAVDataObject* obj);
+    int registerObjects(const QList<UAVDataObject*>& objs);
+    QList<UAVObject*> createInstances(UAVDataObject* obj, quint32 count);
     QList< QList<UAVObject*> > getObjects();
     QList< QList<UAVDataObject*> > getDataObjects();
     QList< QList<UAVMetaObject*> > getMetaObjects();
+    int getObjectsVersion();
     UAVObject* getObject(const QString& name, quint32 instId = 0);
     UAVObject* getObject(quint32 objId, quint32 instId = 0);
     QList<UAVObject*> getObjectInstances(const QString& name);
     QList<UAVObject*> getObjectInstances(quint32 objId);
     qint32 getNumInstances(const QString& name);
     qint32 getNumInstances(quint32 objId);
+    ObjectHandle getObjectHandle(const QString& name);
+    ObjectHandle getObjectHandle(quint32 objId);
+    UAVObject* getObject(ObjectHandle handle, quint32 instId = 0);
+    void setChangeNotificationPeriod(int periodMs);
+    QByteArray saveState();
+    int restoreState(const QByteArray& state);
 
 signals:
     void newObject(UAVObject* obj);
     void newInstance(UAVObject* obj);
+    void newInstances(QList<UAVObject*> objs);
+    void objectsChanged(QList<UAVObject*> objs);
+
+protected:
+    void connectNotify(const char* signal);
+    void disconnectNotify(const char* signal);
+
+private slots:
+    void objectChanged(UAVObject* obj);
+    void emitObjectsChanged();
 
 private:
     static const quint32 MAX_INSTANCES = 1000;
+    static const int DEFAULT_CHANGE_PERIOD_MS = 33;
+    static const quint32 STATE_MAGIC = 0x55415653; // "UAVS"
+    static const quint32 STATE_VERSION = 1;
 
     QList< QList<UAVObject*> > objects;
+    // Read only copies of the registry handed out without locking
+    struct Snapshot;
+    QAtomicInt objectsVersion;
+    QAtomicPointer<Snapshot> snapshot;
+    QList<Snapshot*> retiredSnapshots;
+    QAtomicInt snapshotReaders;
+    QHash<quint32, TypeEntry*> idIndex;
+    QHash<QString, TypeEntry*> nameIndex;
     QMutex* mutex;
+    // Coalesced change notifications
+    QSet<UAVObject*> changedObjects;
+    QMutex changedMutex;
+    QTimer* changeTimer;
+    QAtomicInt changeListeners;
 
     void addObject(UAVObject* obj);
+    void addType(UAVDataObject* obj);
+    void cloneInstances(int objidx, UAVDataObject* refObj, quint32 endInstId, QList<UAVObject*>& created);
+    void notifyNewInstances(const QList<UAVObject*>& objs);
+    const Snapshot* acquireSnapshot();
+    void releaseSnapshot();
+    void rebuildSnapshot();
+    void trackChanges(UAVObject* obj);
+    TypeEntry* findType(const QString* name, quint32 objId);
+    UAVObject* findInstance(const TypeEntry* entry, quint32 instId);
     UAVObject* getObject(const QString* name, quint32 objId, quint32 instId);
     QList<UAVObject*> getObjectInstances(const QString* name, quint32 objId);
     qint32 getNumInstances(const QString* name, quint32 objId);
 };
 
+// newInstances() and objectsChanged() may be delivered to other threads
+Q_DECLARE_METATYPE(QList<UAVObject*>)
 
 #endif // UAVOBJECTMANAGER_H
@@ -11,14 +11,20 @@ HEADERS += uavobjects_global.h \
     uavdataobject.h \
     uavobjectfield.h \
     uavobjectsinit.h \
-    uavobjectsplugin.h
+    uavobjectsplugin.h \
+    vehiclemanager.h \
+    uavobjectsmemoryreporter.h \
+    uavobjectinterest.h
 
 SOURCES += uavobject.cpp \
     uavmetaobject.cpp \
     uavobjectmanager.cpp \
     uavdataobject.cpp \
     uavobjectfield.cpp \
-    uavobjectsplugin.cpp
+    uavobjectsplugin.cpp \
+    vehiclemanager.cpp \
+    uavobjectsmemoryreporter.cpp \
+    uavobjectinterest.cpp
 
 OTHER_FILES += UAVObjects.pluginspec
 
@@ -31,12 +37,17 @@ HEADERS += $$UAVOBJECT_SYNTHETICS/accessorydesired.h \
     $$UAVOBJECT_SYNTHETICS/altitudeholdsettings.h \
     $$UAVOBJECT_SYNTHETICS/revocalibration.h \
     $$UAVOBJECT_SYNTHETICS/gcstelemetrystats.h \
+    $$UAVOBJECT_SYNTHETICS/gcstelemetrycapabilities.h \
+    $$UAVOBJECT_SYNTHETICS/flighttelemetrycapabilities.h \
+    $$UAVOBJECT_SYNTHETICS/flighttelemetrybudget.h \
     $$UAVOBJECT_SYNTHETICS/gyros.h \
     $$UAVOBJECT_SYNTHETICS/gyrosbias.h \
     $$UAVOBJECT_SYNTHETICS/accels.h \
     $$UAVOBJECT_SYNTHETICS/magnetometer.h \
     $$UAVOBJECT_SYNTHETICS/camerastabsettings.h \
     $$UAVOBJECT_SYNTHETICS/flighttelemetrystats.h \
+    $$UAVOBJECT_SYNTHETICS/telemetryping.h \
+    $$UAVOBJECT_SYNTHETICS/telemetrylatency.h \
     $$UAVOBJECT_SYNTHETICS/systemstats.h \
     $$UAVOBJECT_SYNTHETICS/systemalarms.h \
     $$UAVOBJECT_SYNTHETICS/objectpersistence.h \
@@ -64,15 +75,24 @@ HEADERS += $$UAVOBJECT_SYNTHETICS/accessorydesired.h \
     $$UAVOBJECT_SYNTHETICS/guidancesettings.h \
     $$UAVOBJECT_SYNTHETICS/positiondesired.h \
     $$UAVOBJECT_SYNTHETICS/relaytuning.h \
+    $$UAVOBJECT_SYNTHETICS/relaytuningsegment.h \
     $$UAVOBJECT_SYNTHETICS/relaytuningsettings.h \
     $$UAVOBJECT_SYNTHETICS/ratedesired.h \
     $$UAVOBJECT_SYNTHETICS/firmwareiapobj.h \
     $$UAVOBJECT_SYNTHETICS/i2cstats.h \
+    $$UAVOBJECT_SYNTHETICS/uavobjectstats.h \
+    $$UAVOBJECT_SYNTHETICS/fastloopstatus.h \
     $$UAVOBJECT_SYNTHETICS/flightbatterysettings.h \
     $$UAVOBJECT_SYNTHETICS/taskinfo.h \
+    $$UAVOBJECT_SYNTHETICS/loggingsettings.h \
+    $$UAVOBJECT_SYNTHETICS/loggingstats.h \
+    $$UAVOBJECT_SYNTHETICS/cpuprofile.h \
+    $$UAVOBJECT_SYNTHETICS/tracerecords.h \
+    $$UAVOBJECT_SYNTHETICS/benchmarkresults.h \
     $$UAVOBJECT_SYNTHETICS/flightplanstatus.h \
     $$UAVOBJECT_SYNTHETICS/flightplansettings.h \
     $$UAVOBJECT_SYNTHETICS/flightplancontrol.h \
+    $$UAVOBJECT_SYNTHETICS/flightplanimage.h \
     $$UAVOBJECT_SYNTHETICS/watchdogstatus.h \
     $$UAVOBJECT_SYNTHETICS/nedaccel.h \
     $$UAVOBJECT_SYNTHETICS/sonaraltitude.h \
@@ -98,12 +118,17 @@ SOURCES += $$UAVOBJECT_SYNTHETICS/accessorydesired.cpp \
     $$UAVOBJECT_SYNTHETICS/altitudeholdsettings.cpp \
     $$UAVOBJECT_SYNTHETICS/revocalibration.cpp \
     $$UAVOBJECT_SYNTHETICS/gcstelemetrystats.cpp \
+    $$UAVOBJECT_SYNTHETICS/gcstelemetrycapabilities.cpp \
+    $$UAVOBJECT_SYNTHETICS/flighttelemetrycapabilities.cpp \
+    $$UAVOBJECT_SYNTHETICS/flighttelemetrybudget.cpp \
     $$UAVOBJECT_SYNTHETICS/accels.cpp \
     $$UAVOBJECT_SYNTHETICS/gyros.cpp \
     $$UAVOBJECT_SYNTHETICS/gyrosbias.cpp \
     $$UAVOBJECT_SYNTHETICS/magnetometer.cpp \
     $$UAVOBJECT_SYNTHETICS/camerastabsettings.cpp \
     $$UAVOBJECT_SYNTHETICS/flighttelemetrystats.cpp \
+    $$UAVOBJECT_SYNTHETICS/telemetryping.cpp \
+    $$UAVOBJECT_SYNTHETICS/telemetrylatency.cpp \
     $$UAVOBJECT_SYNTHETICS/systemstats.cpp \
     $$UAVOBJECT_SYNTHETICS/systemalarms.cpp \
     $$UAVOBJECT_SYNTHETICS/objectpersistence.cpp \
@@ -132,14 +157,23 @@ SOURCES += $$UAVOBJECT_SYNTHETICS/accessorydesired.cpp \
     $$UAVOBJECT_SYNTHETICS/positiondesired.cpp \
     $$UAVOBJECT_SYNTHETICS/relaytuningsettings.cpp \
     $$UAVOBJECT_SYNTHETICS/relaytuning.cpp \
+    $$UAVOBJECT_SYNTHETICS/relaytuningsegment.cpp \
     $$UAVOBJECT_SYNTHETICS/ratedesired.cpp \
     $$UAVOBJECT_SYNTHETICS/firmwareiapobj.cpp \
     $$UAVOBJECT_SYNTHETICS/i2cstats.cpp \
+    $$UAVOBJECT_SYNTHETICS/uavobjectstats.cpp \
+    $$UAVOBJECT_SYNTHETICS/fastloopstatus.cpp \
     $$UAVOBJECT_SYNTHETICS/flightbatterysettings.cpp \
     $$UAVOBJECT_SYNTHETICS/taskinfo.cpp \
+    $$UAVOBJECT_SYNTHETICS/loggingsettings.cpp \
+    $$UAVOBJECT_SYNTHETICS/loggingstats.cpp \
+    $$UAVOBJECT_SYNTHETICS/cpuprofile.cpp \
+    $$UAVOBJECT_SYNTHETICS/tracerecords.cpp \
+    $$UAVOBJECT_SYNTHETICS/benchmarkresults.cpp \
     $$UAVOBJECT_SYNTHETICS/flightplanstatus.cpp \
     $$UAVOBJECT_SYNTHETICS/flightplansettings.cpp \
     $$UAVOBJECT_SYNTHETICS/flightplancontrol.cpp \
+    $$UAVOBJECT_SYNTHETICS/flightplanimage.cpp \
     $$UAVOBJECT_SYNTHETICS/watchdogstatus.cpp \
     $$UAVOBJECT_SYNTHETICS/nedaccel.cpp \
     $$UAVOBJECT_SYNTHETICS/sonaraltitude.cpp \
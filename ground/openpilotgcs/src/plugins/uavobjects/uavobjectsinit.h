@@ -30,6 +30,6 @@
 
 #include "uavobjectmanager.h"
 
-void UAVObjectsInitialize(UAVObjectManager* objMngr);
+UAVOBJECTS_EXPORT void UAVObjectsInitialize(UAVObjectManager* objMngr);
 
 #endif // UAVOBJECTSINIT_H
@@ -0,0 +1,71 @@
+/**
+ ******************************************************************************
+ *
+ * @file       uavobjectsmemoryreporter.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief The UAVUObjects GCS plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify 
+ * it under the terms of the GNU General Public License as published by 
+ * the Free Software Foundation; either version 3 of the License, or 
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License 
+ * for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along 
+ * with this program; if not, write to the Free Software Foundation, Inc., 
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "uavobjectsmemoryreporter.h"
+#include "vehiclemanager.h"
+#include "uavobjectfield.h"
+
+UAVObjectsMemoryReporter::UAVObjectsMemoryReporter(VehicleManager* vehicles):
+    vehicles(vehicles)
+{
+}
+
+QString UAVObjectsMemoryReporter::memoryGroup() const
+{
+    return tr("UAVObjects");
+}
+
+/**
+ * An instance is counted as the object, its data, its mutex and its list
+ * of fields, the fields themselves are in the field pool.
+ */
+QList<Core::IMemoryReporter::Usage> UAVObjectsMemoryReporter::memoryUsage() const
+{
+    QList<Usage> usage;
+    foreach (int vehicle, vehicles->getVehicles())
+    {
+        qint64 instances = 0;
+        qint64 bytes = 0;
+        foreach (const QList<UAVObject*>& list, vehicles->getObjectManager(vehicle)->getObjects())
+        {
+            foreach (UAVObject* obj, list)
+            {
+                ++instances;
+                bytes += sizeof(UAVDataObject) + sizeof(QMutex) + obj->getNumBytes();
+                bytes += sizeof(QList<UAVObjectField*>) + obj->getFields().size() * sizeof(UAVObjectField*);
+            }
+        }
+        usage << Usage(tr("Object instances of %1").arg(vehicles->getVehicleName(vehicle)), instances, bytes);
+    }
+
+    qint64 count;
+    qint64 bytes = UAVObjectField::getPoolMemory(&count);
+    usage << Usage(tr("Field pool"), count, bytes);
+    bytes = UAVObjectField::getDescriptionsMemory(&count);
+    usage << Usage(tr("Field descriptions"), count, bytes);
+    return usage;
+}
@@ -0,0 +1,53 @@
+/**
+ ******************************************************************************
+ *
+ * @file       uavobjectsmemoryreporter.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief The UAVUObjects GCS plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify 
+ * it under the terms of the GNU General Public License as published by 
+ * the Free Software Foundation; either version 3 of the License, or 
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License 
+ * for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along 
+ * with this program; if not, write to the Free Software Foundation, Inc., 
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef UAVOBJECTSMEMORYREPORTER_H
+#define UAVOBJECTSMEMORYREPORTER_H
+
+#include <coreplugin/imemoryreporter.h>
+
+class VehicleManager;
+
+/**
+ * Reports the object instances of every vehicle and the field descriptions
+ * and field pool they share to the Memory Usage page.
+ */
+class UAVObjectsMemoryReporter: public Core::IMemoryReporter
+{
+    Q_OBJECT
+
+public:
+    UAVObjectsMemoryReporter(VehicleManager* vehicles);
+
+    QString memoryGroup() const;
+    QList<Usage> memoryUsage() const;
+
+private:
+    VehicleManager* vehicles;
+};
+
+#endif // UAVOBJECTSMEMORYREPORTER_H
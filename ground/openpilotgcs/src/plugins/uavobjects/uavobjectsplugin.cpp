@@ -27,6 +27,8 @@
  */
 #include "uavobjectsplugin.h"
 #include "uavobjectsinit.h"
+#include "vehiclemanager.h"
+#include "uavobjectsmemoryreporter.h"
 
 UAVObjectsPlugin::UAVObjectsPlugin()
 {
@@ -50,6 +52,10 @@ bool UAVObjectsPlugin::initialize(const QStringList & arguments, QString * error
     addAutoReleasedObject(objMngr);
     // Initialize UAVObjects
     UAVObjectsInitialize(objMngr);
+    // Further vehicles get object managers of their own
+    VehicleManager* vehicles = new VehicleManager(objMngr);
+    addAutoReleasedObject(vehicles);
+    addAutoReleasedObject(new UAVObjectsMemoryReporter(vehicles));
     // Done
     Q_UNUSED(arguments);
     Q_UNUSED(errorString);
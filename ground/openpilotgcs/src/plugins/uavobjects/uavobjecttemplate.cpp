@@ -32,19 +32,35 @@
  */
 #include "$(NAMELC).h"
 #include "uavobjectfield.h"
+#include <QMutex>
+#include <QMutexLocker>
 
 const QString $(NAME)::NAME = QString("$(NAME)");
 const QString $(NAME)::DESCRIPTION = QString("$(DESCRIPTION)");
 const QString $(NAME)::CATEGORY = QString("$(CATEGORY)");
 
+// Field descriptions, built by the first instance created from any thread
+typedef QList<const UAVObjectField::Info*> FieldInfoList;
+Q_GLOBAL_STATIC(FieldInfoList, fieldInfo)
+Q_GLOBAL_STATIC(QMutex, fieldInfoMutex)
+
 /**
  * Constructor
  */
 $(NAME)::$(NAME)(): UAVDataObject(OBJID, ISSINGLEINST, ISSETTINGS, NAME)
 {
-    // Create fields
+    // Create fields, their descriptions are built once and shared by all instances
+    QMutexLocker locker(fieldInfoMutex());
+    if (fieldInfo()->isEmpty())
+    {
+        FieldInfoList newFieldInfo;
+$(FIELDSINIT)        *fieldInfo() = newFieldInfo;
+    }
     QList<UAVObjectField*> fields;
-$(FIELDSINIT)
+    foreach (const UAVObjectField::Info* info, *fieldInfo())
+        fields.append( new UAVObjectField(info) );
+    locker.unlock();
+
     // Initialize object
     initializeFields(fields, (quint8*)&data, NUMBYTES);
     // Set the default field values
@@ -89,12 +105,13 @@ $(INITFIELDS)
 }
 
 /**
- * Get the object data fields
+ * Get the object data fields, a consistent copy is taken without locking
  */
 $(NAME)::DataFields $(NAME)::getData()
 {
-    QMutexLocker locker(mutex);
-    return data;
+    DataFields dataOut;
+    readData((quint8*)&dataOut, 0, NUMBYTES);
+    return dataOut;
 }
 
 /**
@@ -108,7 +125,9 @@ void $(NAME)::setData(const DataFields& data)
     // Update object if the access mode permits
     if ( UAVObject::GetGcsAccess(mdata) == ACCESS_READWRITE )
     {
+        beginWrite();
         this->data = data;
+        endWrite();
         emit objectUpdatedAuto(this); // trigger object updated event
         emit objectUpdated(this);
     }
@@ -147,5 +166,3 @@ $(NAME)* $(NAME)::GetInstance(UAVObjectManager* objMngr, quint32 instID)
 {
     return dynamic_cast<$(NAME)*>(objMngr->getObject($(NAME)::OBJID, instID));
 }
-
-$(PROPERTIES_IMPL)
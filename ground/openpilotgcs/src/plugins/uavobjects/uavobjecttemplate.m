@@ -7,12 +7,10 @@ checkCRC = false;
 wrongSyncByte=0;
 wrongMessageByte=0;
 lastWrongSyncByte=0;
-lastWrongMessageByte=0;
 str1=[];
 str2=[];
 str3=[];
 str4=[];
-str5=[];
 
 fprintf('\n\n***OpenPilot log parser***\n\n');
 global crc_table;
@@ -58,130 +56,86 @@ end
 $(INSTANTIATIONCODE)
 
 
-fid = fopen(logfile);
-buffer=fread(fid,Inf,'uchar=>uchar');
-fseek(fid, 0, 'bof');
+startTime=clock;
 
-bufferIdx=1;
+%% Read the record stream, the header, index and compression of newer logs are taken off
+buffer=OPLogRecords(logfile);
 
 correctMsgByte=hex2dec('20');
 correctSyncByte=hex2dec('3C');
-unknownObjIDList=zeros(1,2);
-
-% Parse log file, entry by entry
-% prebuf = buffer(1:12);
+maxPacketLength=255+10+1; % payload, header with instance ID and CRC
 
+%% First pass, find the offset of every record
+% A record is a timestamp (4 bytes), a size (8 bytes) and the UAVTalk packet,
+% so it is never shorter than 12 + 8 + 1 bytes
+recordIdx=zeros(floor(length(buffer)/21),1);
+numRecords=0;
+bufferIdx=1;
 last_print = -1e10;
 
-startTime=clock;
-
-while (1)
-	%% Read message header
-	% get sync field (0x3C, 1 byte)
-	sync = buffer(bufferIdx+12);
-	
-	
-	if buffer(bufferIdx+12) ~= correctSyncByte
+while bufferIdx+20-1 <= length(buffer)
+	% Resynchronise byte by byte if the packet does not start where expected
+	if buffer(bufferIdx+12) ~= correctSyncByte || any(buffer(bufferIdx+6:bufferIdx+11))
 		bufferIdx=bufferIdx+1;
 		wrongSyncByte = wrongSyncByte + 1;
 		continue
 	end
-	
-  	%% Process header, if we are aligned
-% 	timestamp = typecast(buffer(bufferIdx:bufferIdx + 4-1), 'uint32'); %We do this one later
-	datasizeBufferIdx = bufferIdx; %Just grab the index. We'll do a typecast later, if necessary
-% 	sync = buffer(bufferIdx+12); %This one has already been done
-	msgType = buffer(bufferIdx+13); % get msg type (quint8 1 byte ) should be 0x20, ignore the rest?
-% 	msgSize = typecast(buffer(bufferIdx+14:bufferIdx+ 14+2-1), 'uint16'); % NOT USED: get msg size (quint16 2 bytes) excludes crc, include msg header and data payload
-	objID = typecast(buffer(bufferIdx+16:bufferIdx+ 16+4-1), 'uint32'); % get obj id (quint32 4 bytes)
-
-	%Advance buffer past header
-	bufferIdx=bufferIdx+20;
-
-	%Check that message type is correct
-	if msgType ~= correctMsgByte
-		wrongMessageByte = wrongMessageByte + 1;	
+	datasize = double(buffer(bufferIdx+4)) + 256*double(buffer(bufferIdx+5));
+	if datasize < 9 || datasize > maxPacketLength
+		bufferIdx=bufferIdx+1;
+		wrongSyncByte = wrongSyncByte + 1;
 		continue
 	end
-	
-	if (isempty(objID)) 	%End of file
-		break;
-	end
-	
-	%% Read object
-	try
-	switch objID
-$(SWITCHCODE)
-		otherwise
-			unknownObjIDListIdx=find(unknownObjIDList(:,1)==objID, 1, 'first');
-			if isempty(unknownObjIDListIdx)
-				unknownObjIDList=[unknownObjIDList; uint32(objID) 1]; %#ok<AGROW>
-			else
-				unknownObjIDList(unknownObjIDListIdx,2)=unknownObjIDList(unknownObjIDListIdx,2)+1; 
-			end
-			
-			datasize = typecast(buffer(datasizeBufferIdx + 4:datasizeBufferIdx + 12-1), 'uint64');
-
-			msgBytesLeft = datasize - 1 - 1 - 2 - 4;
-			if msgBytesLeft > 255
-				msgBytesLeft = 0;
-			end
-			bufferIdx=bufferIdx+double(msgBytesLeft);
-	end
-	catch
-		% One of the reads failed - indicates EOF
+	if bufferIdx+12+datasize-1 > length(buffer) %Truncated last record
 		break;
 	end
 
-	if (wrongSyncByte ~= lastWrongSyncByte || wrongMessageByte~=lastWrongMessageByte ) ||...
-			bufferIdx - last_print > 5e4 %Every 50,000 bytes show the status update
+	numRecords=numRecords+1;
+	recordIdx(numRecords)=bufferIdx;
+	bufferIdx=bufferIdx+12+datasize;
 
+	if wrongSyncByte ~= lastWrongSyncByte || bufferIdx - last_print > 1e6 %Every 1,000,000 bytes show the status update
 		lastWrongSyncByte=wrongSyncByte;
-		lastWrongMessageByte=wrongMessageByte;
 
 		str1=[];
-		for i=1:length([str2 str3 str4 str5]);
+		for i=1:length([str2 str3 str4]);
 			str1=[str1 sprintf('\b')]; %#ok<AGROW>
 		end
-		str2=sprintf('wrongSyncByte instances:    % 10d\n', wrongSyncByte );
-		str3=sprintf('wrongMessageByte instances: % 10d\n\n', wrongMessageByte );
-		
-		str4=sprintf('Completed bytes: % 9d of % 9d\n', bufferIdx, length(buffer));
-		
-	        % Arbitrary times two so that it is at least as long	
-		estTimeRemaining=(length(buffer)-bufferIdx)/(bufferIdx/etime(clock,startTime)) * 2;
+		str2=sprintf('wrongSyncByte instances:    % 10d\n\n', wrongSyncByte );
+		str3=sprintf('Completed bytes: % 9d of % 9d\n', bufferIdx, length(buffer));
+
+		estTimeRemaining=(length(buffer)-bufferIdx)/(bufferIdx/max(etime(clock,startTime),1e-3));
 		h=floor(estTimeRemaining/3600);
 		m=floor((estTimeRemaining-h*3600)/60);
 		s=ceil(estTimeRemaining-h*3600-m*60);
-		
-		str5=sprintf('Est. time remaining, %02dh:%02dm:%02ds \n', h,m,s);
+		str4=sprintf('Est. time remaining, %02dh:%02dm:%02ds \n', h,m,s);
 
 		last_print = bufferIdx;
-		
-		fprintf([str1 str2 str3 str4 str5]);
-	end
 
-	%Check if at end of file. If not, load next prebuffer
-	if bufferIdx+12-1 > length(buffer)
-		break;
+		fprintf([str1 str2 str3 str4]);
 	end
-% 	bufferIdx=bufferIdx+12;
-
 end
-
-
-for i=2:size(unknownObjIDList,1) %Don't show the first one, as it was simply a dummy placeholder
-   disp(['Unknown object ID: 0x' dec2hex(unknownObjIDList(i,1),8) ' appeared ' int2str(unknownObjIDList(i,2)) ' times.']);
+recordIdx=recordIdx(1:numRecords);
+
+%% Packet headers of all records at once
+msgType = buffer(recordIdx+13);
+msgSize = double(buffer(recordIdx+14)) + 256*double(buffer(recordIdx+15)); % excludes crc, includes msg header and data payload
+objID = typecast(OPLogGather(buffer, recordIdx, 16, 4), 'uint32');
+isObject = (msgType == correctMsgByte);
+wrongMessageByte = sum(~isObject);
+knownObjID = false(numRecords,1);
+
+%% Offsets of the updates of each object, the first byte after the header
+$(INDEXCODE)
+
+unknownObjIDList=unique(objID(isObject & ~knownObjID));
+for i=1:length(unknownObjIDList)
+   disp(['Unknown object ID: 0x' dec2hex(unknownObjIDList(i),8) ' appeared ' int2str(sum(objID==unknownObjIDList(i))) ' times.']);
 end
+fprintf('wrongSyncByte instances:    % 10d\n', wrongSyncByte );
+fprintf('wrongMessageByte instances: % 10d\n\n', wrongMessageByte );
 
-%% Clean Up and Save mat file
-fclose(fid);
-
-%% Prune vectors
-$(CLEANUPCODE)
-
-
-%% Perform typecasting on vectors
+%% Second pass, extract every field of every object with one typecast
 $(ALLOCATIONCODE)
 
 %% Save data to file
@@ -193,7 +147,7 @@ else
 $(EXPORTCSVCODE)
 end
 
-fprintf('%d records in %0.2f seconds.\n', length(buffer), etime(clock,startTime));
+fprintf('%d records in %0.2f seconds.\n', numRecords, etime(clock,startTime));
 
 
 
@@ -233,28 +187,57 @@ function crc = compute_crc(data)
         crc = crc_table(1+bitxor(data(i),crc));
     end
 
-function out=mcolon(inStart, inFinish)
-%% This function was inspired by Bruno Luong's 'mcolon'. The name is kept the same as his 'mcolon'
-% function, found on Matlab's file exchange. The two functions return identical
-% results, although his is much faster. Unfortunately, C-compiled mex
-% code would make this function non-cross-platform, so a Matlab scripted
-% version is provided here.
-	if size(inStart,1) > 1 || size(inFinish,1) > 1
-		if size(inStart,2) > 1 || size(inFinish,2) > 1
-			error('Inputs must be vectors, i.e just one column wide.')		
-		else
-			inStart=inStart';
-			inFinish=inFinish';
+function out=OPLogGather(buffer, idx, first, count)
+%% Bytes first to first+count-1 after each of the offsets in idx, the bytes of
+% one offset after the other, as one column ready for typecast
+	out=reshape(buffer(bsxfun(@plus, reshape(idx, 1, []) + first, (0:count-1)')), [], 1);
+
+function buffer=OPLogRecords(logfile)
+%% Record stream of a log. Version 2 and 3 logs start with a header and end
+% with an index (see logfile.cpp in the logging plugin), version 3 logs store
+% the records in blocks of a length and qCompress() output.
+	fid = fopen(logfile);
+	if fid < 0
+		error(['Could not open ' logfile]);
+	end
+	buffer=fread(fid,Inf,'uchar=>uchar');
+	fclose(fid);
+
+	if length(buffer) < 16 || ~strcmp(char(buffer(1:8))', 'OPLOGHDR')
+		return; % Version 1, records only
+	end
+	version = double(typecast(buffer(9:12), 'uint32'));
+	dataStart = 17 + double(typecast(buffer(13:16), 'uint32'));
+	dataEnd = length(buffer);
+	if dataEnd >= dataStart + 16 && strcmp(char(buffer(end-7:end))', 'OPLOGIDX')
+		dataEnd = double(typecast(buffer(end-15:end-8), 'int64'));
+	end
+	if version < 3
+		buffer = buffer(dataStart:dataEnd);
+		return;
+	end
+
+	% qCompress() puts a big endian size in front of the zlib data, which
+	% the Java inflater takes as is
+	if ~usejava('jvm')
+		error('Compressed (version 3) logs need Java to decompress.');
+	end
+	blocks = {};
+	idx = dataStart;
+	while idx+4-1 <= dataEnd
+		len = double(typecast(buffer(idx:idx+3), 'uint32'));
+		idx = idx + 4;
+		if len < 4 || idx+len-1 > dataEnd
+			break;
 		end
+		out = java.io.ByteArrayOutputStream();
+		inflater = java.util.zip.InflaterOutputStream(out);
+		inflater.write(typecast(buffer(idx+4:idx+len-1), 'int8'));
+		inflater.close();
+		blocks{end+1} = typecast(out.toByteArray(), 'uint8'); %#ok<AGROW>
+		idx = idx + len;
 	end
-	
-	diffIn=diff([inStart; inFinish]);
-	numElements=sum(diffIn)+length(inStart);
-	
-	out=zeros(1,numElements);
-	
-	idx=1;
-	for i=1:length(inStart)
-		out(idx:idx+diffIn(i))=inStart(i):inFinish(i);
-		idx=idx+diffIn(i)+1;
+	buffer = vertcat(blocks{:});
+	if isempty(buffer)
+		buffer = zeros(0,1,'uint8');
 	end
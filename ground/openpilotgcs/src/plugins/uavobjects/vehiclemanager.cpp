@@ -0,0 +1,100 @@
+/**
+ ******************************************************************************
+ *
+ * @file       vehiclemanager.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief The UAVUObjects GCS plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify 
+ * it under the terms of the GNU General Public License as published by 
+ * the Free Software Foundation; either version 3 of the License, or 
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License 
+ * for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along 
+ * with this program; if not, write to the Free Software Foundation, Inc., 
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "vehiclemanager.h"
+#include "uavobjectsinit.h"
+
+VehicleManager::VehicleManager(UAVObjectManager* primary):
+    nextVehicle(PRIMARY_VEHICLE + 1)
+{
+    Vehicle vehicle;
+    vehicle.name = tr("Vehicle");
+    vehicle.objMngr = primary;
+    vehicles.insert(PRIMARY_VEHICLE, vehicle);
+}
+
+VehicleManager::~VehicleManager()
+{
+    // The primary manager belongs to the plugin pool
+    foreach (int id, vehicles.keys())
+    {
+        if (id != PRIMARY_VEHICLE)
+            delete vehicles[id].objMngr;
+    }
+}
+
+/**
+ * Add a vehicle with a fresh set of UAVObjects
+ * \return the vehicle id, ids are never reused
+ */
+int VehicleManager::addVehicle(const QString& name)
+{
+    Vehicle vehicle;
+    vehicle.name = name;
+    vehicle.objMngr = new UAVObjectManager();
+    UAVObjectsInitialize(vehicle.objMngr);
+    int id = nextVehicle++;
+    vehicles.insert(id, vehicle);
+    emit vehicleAdded(id);
+    return id;
+}
+
+/**
+ * Remove a vehicle, users of its object manager are told first so they can
+ * let go of its objects. A user that keeps working on the objects in another
+ * thread, like the vehicle's telemetry, takes the manager over by making it a
+ * child of that QThread; it is then deleted with the thread once finished.
+ * The primary vehicle cannot be removed.
+ */
+void VehicleManager::removeVehicle(int vehicle)
+{
+    if (vehicle == PRIMARY_VEHICLE || !vehicles.contains(vehicle))
+        return;
+    emit vehicleAboutToBeRemoved(vehicle);
+    UAVObjectManager* objMngr = vehicles.take(vehicle).objMngr;
+    if (!objMngr->parent())
+        delete objMngr;
+}
+
+QList<int> VehicleManager::getVehicles() const
+{
+    return vehicles.keys();
+}
+
+QString VehicleManager::getVehicleName(int vehicle) const
+{
+    return vehicles.value(vehicle).name;
+}
+
+/**
+ * Get the objects of a vehicle, NULL if there is no such vehicle
+ */
+UAVObjectManager* VehicleManager::getObjectManager(int vehicle) const
+{
+    QMap<int, Vehicle>::const_iterator it = vehicles.constFind(vehicle);
+    return it == vehicles.constEnd() ? NULL : it.value().objMngr;
+}
@@ -0,0 +1,72 @@
+/**
+ ******************************************************************************
+ *
+ * @file       vehiclemanager.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @see        The GNU Public License (GPL) Version 3
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVObjectsPlugin UAVObjects Plugin
+ * @{
+ * @brief The UAVUObjects GCS plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify 
+ * it under the terms of the GNU General Public License as published by 
+ * the Free Software Foundation; either version 3 of the License, or 
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License 
+ * for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along 
+ * with this program; if not, write to the Free Software Foundation, Inc., 
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef VEHICLEMANAGER_H
+#define VEHICLEMANAGER_H
+
+#include "uavobjects_global.h"
+#include "uavobjectmanager.h"
+#include <QMap>
+#include <QStringList>
+
+/**
+ * The vehicles one GCS talks to, each with its own set of UAVObjects.
+ * Vehicle 0 is the object manager in the plugin pool, which the gadgets and
+ * the connection manager use unless told otherwise. Further vehicles get an
+ * object manager of their own; the field descriptions of the generated
+ * objects are shared by all of them, only the object data is per vehicle.
+ */
+class UAVOBJECTS_EXPORT VehicleManager: public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int PRIMARY_VEHICLE = 0;
+
+    VehicleManager(UAVObjectManager* primary);
+    ~VehicleManager();
+
+    int addVehicle(const QString& name);
+    void removeVehicle(int vehicle);
+    QList<int> getVehicles() const;
+    QString getVehicleName(int vehicle) const;
+    UAVObjectManager* getObjectManager(int vehicle = PRIMARY_VEHICLE) const;
+
+signals:
+    void vehicleAdded(int vehicle);
+    void vehicleAboutToBeRemoved(int vehicle);
+
+private:
+    struct Vehicle {
+        QString name;
+        UAVObjectManager* objMngr;
+    };
+    QMap<int, Vehicle> vehicles;
+    int nextVehicle;
+};
+
+#endif // VEHICLEMANAGER_H
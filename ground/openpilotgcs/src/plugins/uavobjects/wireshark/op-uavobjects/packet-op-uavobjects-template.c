@@ -1,5 +1,5 @@
 /*
-  * !!! Autogenerated from $(XMLFILE) Do NOT Edit !!!
+  * !!! Autogenerated from the UAVObject definitions Do NOT Edit !!!
   *
   * Routines for OpenPilot UAVObject dissection
   * Copyright 2012 Stacey Sheldon <stac@solidgoldbomb.org>
@@ -31,82 +31,147 @@
 #endif
 
 #include <epan/packet.h>
-#include <epan/ptvcursor.h>	/* ptvcursor_* */
 
 #include <glib.h>
 #include <string.h>
 
 static int proto_uavo = -1;
 
-/* Subtree expansion tracking */
-$(SUBTREESTATICS)
+/*
+ * All objects are dissected by the one table driven dissector below. Every
+ * object keeps its own protocol (uavo-<name>) and field names for filters,
+ * its layout is precomputed in the tables and objects are found by ID in a
+ * hash table.
+ */
 
-/* Field handles */
-$(FIELDHANDLES)
+/* Layout of a field, array elements use the handles following hf */
+typedef struct {
+  int hf;
+  int ett;                /* subtree of an array field, -1 for single values */
+  guint size;             /* bytes per element */
+  guint num_elements;
+} uavo_field_t;
+
+typedef struct {
+  guint32 objid;
+  const char *name;
+  const char *proto_name;
+  const char *abbrev;
+  const uavo_field_t *fields;
+  guint num_fields;
+  guint first_hf;         /* the hf entries registered to this object */
+  guint num_hf;
+} uavo_object_t;
+
+/* Per object protocols and top level subtrees, indexed like uavo_objects */
+static int proto_uavo_object[$(OBJECTCOUNT)];
+static gint ett_uavo_object[$(OBJECTCOUNT)];
+
+/* Field handles and array subtrees */
+static int hf_uavo[$(FIELDHANDLECOUNT)];
+static gint ett_uavo_array[$(SUBTREECOUNT) + 1];
 
 /* Enum string mappings */
 $(ENUMFIELDNAMES)
 
-void proto_reg_handoff_op_uavobjects_$(NAMELC)(void);
+/* Field layouts */
+$(FIELDLAYOUTS)
 
-static int dissect_uavo(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree)
-{
-  int offset = 0;
-
-  col_append_str(pinfo->cinfo, COL_INFO, "($(NAME))");
-		  
-  if (tree) { /* we are being asked for details */
-    proto_tree *uavo_tree = NULL;
-    ptvcursor_t * cursor;
-    proto_item *ti = NULL;
+static const uavo_object_t uavo_objects[] = {
+$(OBJECTTABLE)
+};
 
-    /* Add a top-level entry to the dissector tree for this protocol */
-    ti = proto_tree_add_item(tree, proto_uavo, tvb, 0, -1, ENC_NA);
+/* Object ID to entry of uavo_objects */
+static GHashTable *uavo_objects_by_id = NULL;
 
-    /* Create a subtree to contain the dissection of this protocol */
-    uavo_tree = proto_item_add_subtree(ti, ett_uavo);
+void proto_reg_handoff_op_uavobjects(void);
 
-    /* Dissect the packet and populate the subtree */
-    cursor = ptvcursor_new(uavo_tree, tvb, 0);
+static int dissect_uavo(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree)
+{
+  const uavo_object_t *obj;
+  int offset = 0;
+  guint n;
+  guint m;
 
-    /* Populate the fields in this protocol */
-$(POPULATETREE)
+  /* The UAVTalk dissector dispatched on the object ID */
+  obj = (const uavo_object_t *) g_hash_table_lookup(uavo_objects_by_id, GUINT_TO_POINTER(pinfo->match_uint));
+  if (obj == NULL)
+    return 0;
 
-    offset += ptvcursor_current_offset(cursor);
+  col_append_fstr(pinfo->cinfo, COL_INFO, "(%s)", obj->name);
 
-    ptvcursor_free(cursor);
+  if (tree) { /* we are being asked for details */
+    int index = (int) (obj - uavo_objects);
+    proto_tree *uavo_tree;
+    proto_item *ti;
+
+    /* Add a top-level entry to the dissector tree for this object */
+    ti = proto_tree_add_item(tree, proto_uavo_object[index], tvb, 0, -1, ENC_NA);
+    uavo_tree = proto_item_add_subtree(ti, ett_uavo_object[index]);
+
+    for (n = 0; n < obj->num_fields; ++n) {
+      const uavo_field_t *field = &obj->fields[n];
+      if (field->ett < 0) {
+	proto_tree_add_item(uavo_tree, hf_uavo[field->hf], tvb, offset, field->size, ENC_LITTLE_ENDIAN);
+	offset += field->size;
+      } else {
+	proto_item *it = proto_tree_add_item(uavo_tree, hf_uavo[field->hf], tvb, offset, field->size * field->num_elements, ENC_NA);
+	proto_tree *array_tree = proto_item_add_subtree(it, ett_uavo_array[field->ett]);
+	for (m = 0; m < field->num_elements; ++m) {
+	  proto_tree_add_item(array_tree, hf_uavo[field->hf + 1 + m], tvb, offset, field->size, ENC_LITTLE_ENDIAN);
+	  offset += field->size;
+	}
+      }
+    }
   } else {
-    offset = 0;
+    for (n = 0; n < obj->num_fields; ++n)
+      offset += obj->fields[n].size * obj->fields[n].num_elements;
   }
 
   return offset;
 }
 
-void proto_register_op_objects_$(NAMELC)(void)
+void proto_register_op_uavobjects(void)
 {
 $(HEADERFIELDS)
 
-   /* Setup protocol subtree array */
+   static gint *ett[$(OBJECTCOUNT) + $(SUBTREECOUNT)];
+   guint n;
+
+   for (n = 0; n < array_length(hf_uavo); ++n)
+     hf_uavo[n] = -1;
+   for (n = 0; n < array_length(uavo_objects); ++n) {
+     ett_uavo_object[n] = -1;
+     ett[n] = &ett_uavo_object[n];
+   }
+   for (n = 0; n < $(SUBTREECOUNT); ++n) {
+     ett_uavo_array[n] = -1;
+     ett[array_length(uavo_objects) + n] = &ett_uavo_array[n];
+   }
+
+   /* The protocol the dissector handle belongs to */
+   proto_uavo = proto_register_protocol("UAVObjects", "UAVObjects", "uavo");
+
+   /* Register every object as a protocol with its own fields */
+   uavo_objects_by_id = g_hash_table_new(g_direct_hash, g_direct_equal);
+   for (n = 0; n < array_length(uavo_objects); ++n) {
+     const uavo_object_t *obj = &uavo_objects[n];
+     proto_uavo_object[n] = proto_register_protocol(obj->proto_name, obj->proto_name, obj->abbrev);
+     proto_register_field_array(proto_uavo_object[n], &hf[obj->first_hf], obj->num_hf);
+     g_hash_table_insert(uavo_objects_by_id, GUINT_TO_POINTER(obj->objid), (gpointer) obj);
+   }
 
-   static gint *ett[] = {
-	$(SUBTREES)
-   };
-
-   /* Register this protocol */
-   proto_uavo = proto_register_protocol("UAVO $(NAME)", 
-				   "UAVO $(NAME)", 
-				   "uavo-$(NAMELC)");
-
-   /* Register the field definitions for this protocol */
    proto_register_subtree_array(ett, array_length(ett));
-   proto_register_field_array(proto_uavo, hf, array_length(hf));
 }
 
-void proto_reg_handoff_op_uavobjects_$(NAMELC)(void)
+void proto_reg_handoff_op_uavobjects(void)
 {
    dissector_handle_t uavo_handle;
+   guint n;
+
    uavo_handle = new_create_dissector_handle(dissect_uavo, proto_uavo);
 
-   /* Bind this protocol to its UAV ObjID in UAVTalk */
-   dissector_add("uavtalk.objid", $(OBJIDHEX), uavo_handle);
+   /* Bind the one dissector to every UAV ObjID in UAVTalk */
+   for (n = 0; n < array_length(uavo_objects); ++n)
+     dissector_add_uint("uavtalk.objid", uavo_objects[n].objid, uavo_handle);
 }
@@ -109,6 +109,37 @@ void UAVObjectUtilManager::saveObjectToSD(UAVObject *obj)
 
 }
 
+/**
+  * @brief Sends the objects and saves each of them to the board as soon as its
+  * upload is acknowledged. Telemetry keeps several transactions in flight, so
+  * the uploads overlap with each other and with the saves of the objects sent
+  * before. Each object is saved on its own with a SingleObject request, so
+  * settings changed elsewhere and not saved are left alone.
+  * saveCompleted() is emitted for every object.
+  */
+void UAVObjectUtilManager::saveObjectsToSD(QList<UAVObject *> objects)
+{
+    foreach (UAVObject *obj, objects) {
+        if (batchUploads.contains(obj))
+            continue;
+        batchUploads.append(obj);
+        connect(obj, SIGNAL(transactionCompleted(UAVObject*,bool)), this, SLOT(batchTransactionCompleted(UAVObject*,bool)));
+    }
+    foreach (UAVObject *obj, objects)
+        obj->updated();
+}
+
+void UAVObjectUtilManager::batchTransactionCompleted(UAVObject *obj, bool success)
+{
+    if (!batchUploads.removeOne(obj))
+        return;
+    disconnect(obj, SIGNAL(transactionCompleted(UAVObject*,bool)), this, SLOT(batchTransactionCompleted(UAVObject*,bool)));
+    if (success)
+        saveObjectToSD(obj);
+    else
+        emit saveCompleted(obj->getObjID(), false);
+}
+
 void UAVObjectUtilManager::saveNextObject()
 {
     if ( queue.isEmpty() )
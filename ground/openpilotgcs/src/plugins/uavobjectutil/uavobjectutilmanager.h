@@ -66,6 +66,7 @@ public:
         static bool descriptionToStructure(QByteArray desc,deviceDescriptorStruct & struc);
         UAVObjectManager* getObjectManager();
         void saveObjectToSD(UAVObject *obj);
+        void saveObjectsToSD(QList<UAVObject *> objects);
 protected:
         FirmwareIAPObj::DataFields getFirmwareIap();
 
@@ -75,6 +76,7 @@ signals:
 private:
     QMutex *mutex;
     QQueue<UAVObject *> queue;
+    QList<UAVObject *> batchUploads;
     enum {IDLE, AWAITING_ACK, AWAITING_COMPLETED} saveState;
     void saveNextObject();
     QTimer failureTimer;
@@ -88,6 +90,7 @@ private slots:
         void objectPersistenceTransactionCompleted(UAVObject* obj, bool success);
         void objectPersistenceUpdated(UAVObject * obj);
         void objectPersistenceOperationFailed();
+        void batchTransactionCompleted(UAVObject *obj, bool success);
 
 
 };
@@ -32,8 +32,10 @@
 /**
  * Constructor
  */
-ConfigTaskWidget::ConfigTaskWidget(QWidget *parent) : QWidget(parent),isConnected(false),allowWidgetUpdates(true),smartsave(NULL),dirty(false),outOfLimitsStyle("background-color: rgb(255, 0, 0);"),timeOut(NULL)
+ConfigTaskWidget::ConfigTaskWidget(QWidget *parent) : QWidget(parent),isConnected(false),allowWidgetUpdates(true),smartsave(NULL),dirty(false),interestShown(false),outOfLimitsStyle("background-color: rgb(255, 0, 0);"),timeOut(NULL)
 {
+    // Watch our own visibility so the telemetry fetches the shown objects first
+    installEventFilter(this);
     pm = ExtensionSystem::PluginManager::instance();
     objManager = pm->getObject<UAVObjectManager>();
     TelemetryManager* telMngr = pm->getObject<TelemetryManager>();
@@ -168,6 +170,8 @@ void ConfigTaskWidget::addUAVObjectToWidgetRelation(QString object, QString fiel
     {
         obj = objManager->getObject(QString(object),instID);
         Q_ASSERT(obj);
+        if(interestShown && !objectUpdates.contains(obj))
+            obj->addInterest();
         objectUpdates.insert(obj,true);
         connect(obj, SIGNAL(objectUpdated(UAVObject*)),this, SLOT(objectUpdated(UAVObject*)));
         connect(obj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(refreshWidgetsValues(UAVObject*)), Qt::UniqueConnection);
@@ -221,6 +225,7 @@ void ConfigTaskWidget::addUAVObjectToWidgetRelation(QString object, QString fiel
  */
 ConfigTaskWidget::~ConfigTaskWidget()
 {
+    setInterest(false);
     if(smartsave)
         delete smartsave;
     foreach(QList<objectToWidget*>* pointer,defaultReloadGroups.values())
@@ -1275,7 +1280,32 @@ void ConfigTaskWidget::disableMouseWheelEvents()
     }
 }
 
+/**
+ * Marks the objects of this widget as shown or not, see UAVObject::addInterest()
+ */
+void ConfigTaskWidget::setInterest(bool shown)
+{
+    if(shown==interestShown)
+        return;
+    interestShown=shown;
+    foreach(UAVObject * obj,objectUpdates.keys())
+    {
+        if(shown)
+            obj->addInterest();
+        else
+            obj->removeInterest();
+    }
+}
+
 bool ConfigTaskWidget::eventFilter( QObject * obj, QEvent * evt ) {
+    if ( obj == this )
+    {
+        if ( evt->type() == QEvent::Show )
+            setInterest(true);
+        else if ( evt->type() == QEvent::Hide )
+            setInterest(false);
+        return QWidget::eventFilter( obj, evt );
+    }
     //Filter all wheel events, and ignore them
     if ( evt->type() == QEvent::Wheel &&
          (qobject_cast<QAbstractSpinBox*>( obj ) ||
@@ -178,6 +178,9 @@ private:
     QMap<QPushButton *,QString> helpButtonList;
     QList<QPushButton *> reloadButtonList;
     bool dirty;
+    // objects marked as shown while the widget is visible
+    bool interestShown;
+    void setInterest(bool shown);
     bool setFieldFromWidget(QWidget *widget, UAVObjectField *field, int index, double scale);
     bool setWidgetFromField(QWidget *widget, UAVObjectField *field, int index, double scale, bool hasLimits);
     QVariant getVariantFromWidget(QWidget *widget, double scale);
@@ -69,76 +69,34 @@ void smartSaveButton::processOperation(QPushButton * button,bool save)
         button->setEnabled(false);
         button->setIcon(QIcon(":/uploader/images/system-run.svg"));
     }
-    QTimer timer;
-    timer.setSingleShot(true);
-    bool error=false;
-    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
-    UAVObjectUtilManager* utilMngr = pm->getObject<UAVObjectUtilManager>();
+    QList<UAVDataObject *> uploads;
+    QList<UAVDataObject *> saves;
     foreach(UAVDataObject * obj,objects)
     {
         UAVObject::Metadata mdata= obj->getMetadata();
         if(UAVObject::GetGcsAccess(mdata)==UAVObject::ACCESS_READONLY)
             continue;
-        up_result=false;
-        current_object=obj;
-        for(int i=0;i<3;++i)
-        {
-            qDebug()<<"SMARTSAVEBUTTON"<<"Upload try number"<<i<<"Object"<<obj->getName();
-            connect(obj,SIGNAL(transactionCompleted(UAVObject*,bool)),this,SLOT(transaction_finished(UAVObject*, bool)));
-            connect(&timer,SIGNAL(timeout()),&loop,SLOT(quit()));
-            obj->updated();
-            timer.start(3000);
-            //qDebug()<<"begin loop";
-            loop.exec();
-            if(timer.isActive())
-            {
-                qDebug()<<"SMARTSAVEBUTTON"<<"Upload did not timeout"<<i<<"Object"<<obj->getName();
-            }
-            else
-                qDebug()<<"SMARTSAVEBUTTON"<<"Upload TIMEOUT"<<i<<"Object"<<obj->getName();
-            timer.stop();
-            disconnect(obj,SIGNAL(transactionCompleted(UAVObject*,bool)),this,SLOT(transaction_finished(UAVObject*, bool)));
-            disconnect(&timer,SIGNAL(timeout()),&loop,SLOT(quit()));
-            if(up_result)
-                break;
-        }
-        if(up_result==false)
-        {
-            qDebug()<<"SMARTSAVEBUTTON"<<"Object upload error:"<<obj->getName();
-            error=true;
-            continue;
-        }
-        sv_result=false;
-        current_objectID=obj->getObjID();
-        if(save && (obj->isSettings()))
-        {
-            for(int i=0;i<3;++i)
-            {
-                qDebug()<<"SMARTSAVEBUTTON"<<"Save try number"<<i<<"Object"<<obj->getName();
-                connect(utilMngr,SIGNAL(saveCompleted(int,bool)),this,SLOT(saving_finished(int,bool)));
-                connect(&timer,SIGNAL(timeout()),&loop,SLOT(quit()));
-                utilMngr->saveObjectToSD(obj);
-                timer.start(3000);
-                loop.exec();
-                if(timer.isActive())
-                {
-                    qDebug()<<"SMARTSAVEBUTTON"<<"Saving did not timeout"<<i<<"Object"<<obj->getName();
-                }
-                else
-                    qDebug()<<"SMARTSAVEBUTTON"<<"Saving TIMEOUT"<<i<<"Object"<<obj->getName();
-                timer.stop();
-                disconnect(utilMngr,SIGNAL(saveCompleted(int,bool)),this,SLOT(saving_finished(int,bool)));
-                disconnect(&timer,SIGNAL(timeout()),&loop,SLOT(quit()));
-                if(sv_result)
-                    break;
-            }
-            if(sv_result==false)
-            {
-                qDebug()<<"SMARTSAVEBUTTON"<<"failed to save:"<<obj->getName();
-                error=true;
-            }
-        }
+        // Saving the settings uploads them too
+        if(save && obj->isSettings())
+            saves.append(obj);
+        else
+            uploads.append(obj);
+    }
+    for(int i=0;i<3&&!uploads.isEmpty();++i)
+    {
+        qDebug()<<"SMARTSAVEBUTTON"<<"Upload try number"<<i<<"Objects"<<uploads.count();
+        uploads=sendObjects(uploads,false);
     }
+    for(int i=0;i<3&&!saves.isEmpty();++i)
+    {
+        qDebug()<<"SMARTSAVEBUTTON"<<"Save try number"<<i<<"Objects"<<saves.count();
+        saves=sendObjects(saves,true);
+    }
+    foreach(UAVDataObject * obj,uploads)
+        qDebug()<<"SMARTSAVEBUTTON"<<"Object upload error:"<<obj->getName();
+    foreach(UAVDataObject * obj,saves)
+        qDebug()<<"SMARTSAVEBUTTON"<<"failed to save:"<<obj->getName();
+    bool error=!uploads.isEmpty()||!saves.isEmpty();
     if(button)
         button->setEnabled(true);
     if(!error)
@@ -155,6 +113,58 @@ void smartSaveButton::processOperation(QPushButton * button,bool save)
     emit endOp();
 }
 
+/**
+  * Sends all the objects at once and waits for them, telemetry keeps several
+  * transactions in flight so this is not a round trip per object. When saving,
+  * the settings are saved together by UAVObjectUtilManager::saveObjectsToSD.
+  * Returns the objects that failed or got no answer.
+  */
+QList<UAVDataObject *> smartSaveButton::sendObjects(QList<UAVDataObject *> list, bool save)
+{
+    ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
+    UAVObjectUtilManager* utilMngr = pm->getObject<UAVObjectUtilManager>();
+    pending.clear();
+    failed.clear();
+    QList<UAVObject *> sent;
+    foreach(UAVDataObject * obj,list)
+    {
+        pending.insert(obj->getObjID(),obj);
+        sent.append(obj);
+        if(!save)
+            connect(obj,SIGNAL(transactionCompleted(UAVObject*,bool)),this,SLOT(transaction_finished(UAVObject*, bool)));
+    }
+    if(save)
+        connect(utilMngr,SIGNAL(saveCompleted(int,bool)),this,SLOT(saving_finished(int,bool)));
+    connect(&timer,SIGNAL(timeout()),&loop,SLOT(quit()));
+    timer.setSingleShot(true);
+    // Restarted on every answer, a set save takes longer than an upload
+    timer.setInterval(save?6000:3000);
+    timer.start();
+    if(save)
+        utilMngr->saveObjectsToSD(sent);
+    else
+    {
+        foreach(UAVObject * obj,sent)
+            obj->updated();
+    }
+    if(!pending.isEmpty())
+        loop.exec();
+    if(!timer.isActive())
+        qDebug()<<"SMARTSAVEBUTTON"<<"TIMEOUT"<<pending.count()<<"objects not answered";
+    timer.stop();
+    disconnect(&timer,SIGNAL(timeout()),&loop,SLOT(quit()));
+    if(save)
+        disconnect(utilMngr,SIGNAL(saveCompleted(int,bool)),this,SLOT(saving_finished(int,bool)));
+    else
+    {
+        foreach(UAVObject * obj,sent)
+            disconnect(obj,SIGNAL(transactionCompleted(UAVObject*,bool)),this,SLOT(transaction_finished(UAVObject*, bool)));
+    }
+    failed.append(pending.values());
+    pending.clear();
+    return failed;
+}
+
 void smartSaveButton::setObjects(QList<UAVDataObject *> list)
 {
     objects=list;
@@ -181,21 +191,20 @@ void smartSaveButton::clearObjects()
 }
 void smartSaveButton::transaction_finished(UAVObject* obj, bool result)
 {
-    if(current_object==obj)
-    {
-        up_result=result;
-        loop.quit();
-    }
+    saving_finished(obj->getObjID(),result);
 }
 
 void smartSaveButton::saving_finished(int id, bool result)
 {
-    if(id==current_objectID)
-    {
-        sv_result=result;
-        //qDebug()<<"saving_finished result="<<result;
+    UAVDataObject * obj=pending.take(id);
+    if(!obj)
+        return;
+    if(!result)
+        failed.append(obj);
+    if(pending.isEmpty())
         loop.quit();
-    }
+    else
+        timer.start();
 }
 
 void smartSaveButton::enableControls(bool value)
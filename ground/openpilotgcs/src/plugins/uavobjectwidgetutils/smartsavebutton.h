@@ -34,6 +34,8 @@
 #include <QPushButton>
 #include <QList>
 #include <QEventLoop>
+#include <QMap>
+#include <QTimer>
 #include "uavobjectutilmanager.h"
 #include <QObject>
 #include <QDebug>
@@ -68,10 +70,10 @@ private slots:
     void saving_finished(int,bool);
 
 private:
-    quint32 current_objectID;
-    UAVDataObject * current_object;
-    bool up_result;
-    bool sv_result;
+    QList<UAVDataObject *> sendObjects(QList<UAVDataObject *> list, bool save);
+    QMap<quint32,UAVDataObject *> pending;
+    QList<UAVDataObject *> failed;
+    QTimer timer;
     QEventLoop loop;
     QList<UAVDataObject *> objects;
     QMap<QPushButton *,buttonTypeEnum> buttonList;
@@ -67,7 +67,7 @@ void ImportSummaryDialog::openHelp()
   Adds a new line about a UAVObject along with its status
   (whether it got saved OK or not)
   */
-void ImportSummaryDialog::addLine(QString uavObjectName, QString text, bool status)
+void ImportSummaryDialog::addLine(QString uavObjectName, QString text, bool status, bool selected)
 {
     ui->importSummaryList->setRowCount(ui->importSummaryList->rowCount()+1);
     int row = ui->importSummaryList->rowCount()-1;
@@ -82,7 +82,7 @@ void ImportSummaryDialog::addLine(QString uavObjectName, QString text, bool stat
     ui->importSummaryList->item(row,2)->setFlags(!Qt::ItemIsEditable);
 
     if (status) {
-        box->setChecked(true);
+        box->setChecked(selected);
     } else {
         box->setChecked(false);
         box->setEnabled(false);
@@ -93,7 +93,8 @@ void ImportSummaryDialog::addLine(QString uavObjectName, QString text, bool stat
 }
 
 /*
-  Saves every checked UAVObjet in the list to Flash
+  Saves every checked UAVObjet in the list to Flash, the settings
+  together in one save
   */
 void ImportSummaryDialog::doTheSaving()
 {
@@ -113,15 +114,16 @@ void ImportSummaryDialog::doTheSaving()
         return;
     ui->progressBar->setMaximum(itemCount+1);
     ui->progressBar->setValue(1);
+    QList<UAVObject *> objects;
     for(int i=0; i < ui->importSummaryList->rowCount(); i++) {
         QString uavObjectName = ui->importSummaryList->item(i,1)->text();
         QCheckBox *box = dynamic_cast<QCheckBox*>(ui->importSummaryList->cellWidget(i,0));
         if (box->isChecked()) {
-            UAVObject* obj = objManager->getObject(uavObjectName);
-            utilManager->saveObjectToSD(obj);
-            this->repaint();
+            objects.append(objManager->getObject(uavObjectName));
         }
     }
+    utilManager->saveObjectsToSD(objects);
+    this->repaint();
 
     ui->saveToFlash->setEnabled(false);
     ui->closeButton->setEnabled(false);
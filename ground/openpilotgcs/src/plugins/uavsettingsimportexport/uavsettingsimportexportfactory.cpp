@@ -45,6 +45,7 @@
 
 // for XML object
 #include <QDomDocument>
+#include <QXmlStreamWriter>
 
 // for file dialog and error messages
 #include <QFileDialog>
@@ -139,6 +140,9 @@ void UAVSettingsImportExportFactory::importUAVSettings()
     UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
     swui.show();
 
+    // Only the objects the file changes are sent, all in one go at the end
+    QList<UAVObject *> changed;
+
     QDomNode node = root.firstChild();
     while (!node.isNull()) {
         QDomElement e = node.toElement();
@@ -159,6 +163,8 @@ void UAVSettingsImportExportFactory::importUAVSettings()
                 //  - Issue and "updated" command
                 bool error = false;
                 bool setError = false;
+                QByteArray before(obj->getNumBytes(), 0);
+                obj->pack((quint8*)before.data());
                 QDomNode field = node.firstChild();
                 while(!field.isNull()) {
                     QDomElement f = field.toElement();
@@ -193,7 +199,11 @@ void UAVSettingsImportExportFactory::importUAVSettings()
                     }
                     field = field.nextSibling();
                 }
-                obj->updated();
+                QByteArray after(obj->getNumBytes(), 0);
+                obj->pack((quint8*)after.data());
+                bool unchanged = (after == before);
+                if (!unchanged)
+                    changed.append(obj);
 
                 if (error) {
                     swui.addLine(uavObjectName, "Warning (Object field unknown)", true);
@@ -202,6 +212,9 @@ void UAVSettingsImportExportFactory::importUAVSettings()
                     swui.addLine(uavObjectName, "Warning (ObjectID mismatch)", true);
                 } else if (setError) {
                     swui.addLine(uavObjectName, "Warning (Objects field value(s) invalid)", false);
+                } else if (unchanged) {
+                    // Already what the board has, not worth saving again
+                    swui.addLine(uavObjectName, "OK (unchanged)", true, false);
                 } else {
                     swui.addLine(uavObjectName, "OK", true);
                 }
@@ -209,94 +222,80 @@ void UAVSettingsImportExportFactory::importUAVSettings()
         }
         node = node.nextSibling();
     }
+    qDebug() << "Import changed" << changed.count() << "objects";
+    foreach (UAVObject *obj, changed)
+        obj->updated();
     qDebug() << "End import";
     swui.exec();
 }
 
-// Create an XML document from UAVObject database
-QString UAVSettingsImportExportFactory::createXMLDocument(const enum storedData what, const bool fullExport)
+// Write an XML document from UAVObject database, streamed to the device
+bool UAVSettingsImportExportFactory::writeXMLDocument(QIODevice *device, const enum storedData what, const bool fullExport)
 {
-    // generate an XML first (used for all export formats as a formatted data source)
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
     UAVObjectManager *objManager = pm->getObject<UAVObjectManager>();
 
+    QXmlStreamWriter xml(device);
+    xml.setAutoFormatting(true);
+    xml.setAutoFormattingIndent(4);
+
     // create an XML root
-    QDomDocument doc("UAVObjects");
-    QDomElement root = doc.createElement("uavobjects");
-    doc.appendChild(root);
+    xml.writeDTD("<!DOCTYPE UAVObjects>");
+    xml.writeStartElement("uavobjects");
 
     // add hardware, firmware and GCS version info
-    QDomElement versionInfo = doc.createElement("version");
-    root.appendChild(versionInfo);
+    xml.writeStartElement("version");
 
     UAVObjectUtilManager *utilMngr = pm->getObject<UAVObjectUtilManager>();
     deviceDescriptorStruct board = utilMngr->getBoardDescriptionStruct();
 
-    QDomElement hw = doc.createElement("hardware");
-    hw.setAttribute("type", QString().setNum(board.boardType, 16));
-    hw.setAttribute("revision", QString().setNum(board.boardRevision, 16));
-    hw.setAttribute("serial", QString(utilMngr->getBoardCPUSerial().toHex()));
-    versionInfo.appendChild(hw);
+    xml.writeEmptyElement("hardware");
+    xml.writeAttribute("type", QString().setNum(board.boardType, 16));
+    xml.writeAttribute("revision", QString().setNum(board.boardRevision, 16));
+    xml.writeAttribute("serial", QString(utilMngr->getBoardCPUSerial().toHex()));
 
-    QDomElement fw = doc.createElement("firmware");
-    fw.setAttribute("date", board.gitDate);
-    fw.setAttribute("hash", board.gitHash);
-    fw.setAttribute("tag", board.gitTag);
-    versionInfo.appendChild(fw);
+    xml.writeEmptyElement("firmware");
+    xml.writeAttribute("date", board.gitDate);
+    xml.writeAttribute("hash", board.gitHash);
+    xml.writeAttribute("tag", board.gitTag);
 
     QString gcsRevision = QString::fromLatin1(Core::Constants::GCS_REVISION_STR);
     QString gcsGitDate = gcsRevision.mid(gcsRevision.indexOf(" ") + 1, 14);
     QString gcsGitHash = gcsRevision.mid(gcsRevision.indexOf(":") + 1, 8);
     QString gcsGitTag = gcsRevision.left(gcsRevision.indexOf(":"));
 
-    QDomElement gcs = doc.createElement("gcs");
-    gcs.setAttribute("date", gcsGitDate);
-    gcs.setAttribute("hash", gcsGitHash);
-    gcs.setAttribute("tag", gcsGitTag);
-    versionInfo.appendChild(gcs);
-
-    // create settings and/or data elements
-    QDomElement settings = doc.createElement("settings");
-    QDomElement data = doc.createElement("data");
-
-    switch (what)
-    {
-    case Settings:
-        root.appendChild(settings);
-        break;
-    case Data:
-        root.appendChild(data);
-        break;
-    case Both:
-        root.appendChild(data);
-        root.appendChild(settings);
-        break;
-    }
+    xml.writeEmptyElement("gcs");
+    xml.writeAttribute("date", gcsGitDate);
+    xml.writeAttribute("hash", gcsGitHash);
+    xml.writeAttribute("tag", gcsGitTag);
+    xml.writeEndElement(); // version
 
-    // iterate over settings objects
+    // data element first, then settings
     QList< QList<UAVDataObject*> > objList = objManager->getDataObjects();
-    foreach (QList<UAVDataObject*> list, objList) {
-        foreach (UAVDataObject *obj, list) {
-            if (((what == Settings) && obj->isSettings()) ||
-                ((what == Data) && !obj->isSettings()) ||
-                 (what == Both)) {
+    for (int pass = 0; pass < 2; ++pass) {
+        bool settings = (pass == 1);
+        if ((settings && what == Data) || (!settings && what == Settings))
+            continue;
+        xml.writeStartElement(settings ? "settings" : "data");
+
+        foreach (QList<UAVDataObject*> list, objList) {
+            foreach (UAVDataObject *obj, list) {
+                if (obj->isSettings() != settings)
+                    continue;
 
                 // add each object to the XML
-                QDomElement o = doc.createElement("object");
-                o.setAttribute("name", obj->getName());
-                o.setAttribute("id", QString("0x")+ QString().setNum(obj->getObjID(),16).toUpper());
+                xml.writeStartElement("object");
+                xml.writeAttribute("name", obj->getName());
+                xml.writeAttribute("id", QString("0x")+ QString().setNum(obj->getObjID(),16).toUpper());
                 if (fullExport) {
-                    QDomElement d = doc.createElement("description");
-                    QDomText t = doc.createTextNode(obj->getDescription().remove("@Ref ", Qt::CaseInsensitive));
-                    d.appendChild(t);
-                    o.appendChild(d);
+                    xml.writeTextElement("description", obj->getDescription().remove("@Ref ", Qt::CaseInsensitive));
                 }
 
                 // iterate over fields
                 QList<UAVObjectField*> fieldList = obj->getFields();
 
                 foreach (UAVObjectField* field, fieldList) {
-                    QDomElement f = doc.createElement("field");
+                    xml.writeEmptyElement("field");
 
                     // iterate over values
                     QString vals;
@@ -306,29 +305,25 @@ QString UAVSettingsImportExportFactory::createXMLDocument(const enum storedData
                     }
                     vals.chop(1);
 
-                    f.setAttribute("name", field->getName());
-                    f.setAttribute("values", vals);
+                    xml.writeAttribute("name", field->getName());
+                    xml.writeAttribute("values", vals);
                     if (fullExport) {
-                        f.setAttribute("type", field->getTypeAsString());
-                        f.setAttribute("units", field->getUnits());
-                        f.setAttribute("elements", nelem);
+                        xml.writeAttribute("type", field->getTypeAsString());
+                        xml.writeAttribute("units", field->getUnits());
+                        xml.writeAttribute("elements", QString::number(nelem));
                         if (field->getType() == UAVObjectField::ENUM) {
-                            f.setAttribute("options", field->getOptions().join(","));
+                            xml.writeAttribute("options", field->getOptions().join(","));
                         }
                     }
-                    o.appendChild(f);
                 }
-
-                // append to the settings or data element
-                if (obj->isSettings())
-                    settings.appendChild(o);
-                else
-                    data.appendChild(o);
+                xml.writeEndElement(); // object
             }
         }
+        xml.writeEndElement(); // settings or data
     }
 
-    return doc.toString(4);
+    xml.writeEndElement(); // uavobjects
+    return !xml.hasError();
 }
 
 // Slot called by the menu manager on user action
@@ -351,13 +346,10 @@ void UAVSettingsImportExportFactory::exportUAVSettings()
         fileName.append(".uav");
     }
 
-    // generate an XML first (used for all export formats as a formatted data source)
-    QString xml = createXMLDocument(Settings, fullExport);
-
     // save file
     QFile file(fileName);
     if (file.open(QIODevice::WriteOnly) &&
-            (file.write(xml.toAscii()) != -1)) {
+            writeXMLDocument(&file, Settings, fullExport)) {
         file.close();
     } else {
         QMessageBox::critical(0,
@@ -402,13 +394,10 @@ void UAVSettingsImportExportFactory::exportUAVData()
         fileName.append(".uav");
     }
 
-    // generate an XML first (used for all export formats as a formatted data source)
-    QString xml = createXMLDocument(Both, fullExport);
-
     // save file
     QFile file(fileName);
     if (file.open(QIODevice::WriteOnly) &&
-            (file.write(xml.toAscii()) != -1)) {
+            writeXMLDocument(&file, Both, fullExport)) {
         file.close();
     } else {
         QMessageBox::critical(0,
@@ -28,6 +28,7 @@
 #define UAVSETTINGSIMPORTEXPORTFACTORY_H
 #include "uavsettingsimportexport_global.h"
 #include "uavobjectutil/uavobjectutilmanager.h"
+#include <QIODevice>
 #include "../../../../../build/ground/openpilotgcs/gcsversioninfo.h"
 class UAVSETTINGSIMPORTEXPORT_EXPORT UAVSettingsImportExportFactory : public QObject
 {
@@ -39,7 +40,7 @@ public:
 
 private:
    enum storedData { Settings, Data, Both };
-   QString createXMLDocument(const enum storedData, const bool fullExport);
+   bool writeXMLDocument(QIODevice *device, const enum storedData, const bool fullExport);
 
 private slots:
    void importUAVSettings();
@@ -32,6 +32,7 @@
 #include <QTime>
 #include <QtGlobal>
 #include <stdlib.h>
+#include <algorithm>
 #include <QDebug>
 
 /**
@@ -42,6 +43,11 @@ Telemetry::Telemetry(UAVTalk* utalk, UAVObjectManager* objMngr)
     this->utalk = utalk;
     this->objMngr = objMngr;
     mutex = new QMutex(QMutex::Recursive);
+    // Setup the periodic timer, it is armed as objects get registered
+    schedTimer.start();
+    updateTimer = new QTimer(this);
+    updateTimer->setSingleShot(true);
+    connect(updateTimer, SIGNAL(timeout()), this, SLOT(processPeriodicUpdates()));
     // Process all objects in the list
     QList< QList<UAVObject*> > objs = objMngr->getObjects();
     for (int objidx = 0; objidx < objs.length(); ++objidx)
@@ -50,16 +56,13 @@ Telemetry::Telemetry(UAVTalk* utalk, UAVObjectManager* objMngr)
     }
     // Listen to new object creations
     connect(objMngr, SIGNAL(newObject(UAVObject*)), this, SLOT(newObject(UAVObject*)));
-    connect(objMngr, SIGNAL(newInstance(UAVObject*)), this, SLOT(newInstance(UAVObject*)));
+    connect(objMngr, SIGNAL(newInstances(QList<UAVObject*>)), this, SLOT(newInstances(QList<UAVObject*>)));
     // Listen to transaction completions
     connect(utalk, SIGNAL(transactionCompleted(UAVObject*,bool)), this, SLOT(transactionCompleted(UAVObject*,bool)));
     // Get GCS stats object
     gcsStatsObj = GCSTelemetryStats::GetInstance(objMngr);
-    // Setup and start the periodic timer
-    timeToNextUpdateMs = 0;
-    updateTimer = new QTimer(this);
-    connect(updateTimer, SIGNAL(timeout()), this, SLOT(processPeriodicUpdates()));
-    updateTimer->start(1000);
+    // Start the periodic timer
+    restartUpdateTimer();
     // Setup and start the stats timer
     txErrors = 0;
     txRetries = 0;
@@ -67,7 +70,7 @@ Telemetry::Telemetry(UAVTalk* utalk, UAVObjectManager* objMngr)
 
 Telemetry::~Telemetry()
 {
-    for (QMap<quint32, ObjectTransactionInfo*>::iterator itr = transMap.begin(); itr != transMap.end(); ++itr)
+    for (QMap<quint64, ObjectTransactionInfo*>::iterator itr = transMap.begin(); itr != transMap.end(); ++itr)
         delete itr.value();
 }
 
@@ -89,21 +92,22 @@ void Telemetry::registerObject(UAVObject* obj)
 void Telemetry::addObject(UAVObject* obj)
 {
     // Check if object type is already in the list
-    for (int n = 0; n < objList.length(); ++n)
+    if ( objListIndex.contains(obj->getObjID()) )
     {
-        if ( objList[n].obj->getObjID() == obj->getObjID() )
-        {
-            // Object type (not instance!) is already in the list, do nothing
-            return;
-        }
+        // Object type (not instance!) is already in the list, do nothing
+        return;
     }
 
     // If this point is reached, then the object type is new, let's add it
     ObjectTimeInfo timeInfo;
     timeInfo.obj = obj;
-    timeInfo.timeToNextUpdateMs = 0;
     timeInfo.updatePeriodMs = 0;
+    timeInfo.generation = 0;
+    timeInfo.updates = 0;
+    timeInfo.maxLatenessMs = 0;
+    timeInfo.totalLatenessMs = 0;
     objList.append(timeInfo);
+    objListIndex.insert(obj->getObjID(), objList.length() - 1);
 }
 
 /**
@@ -112,14 +116,60 @@ void Telemetry::addObject(UAVObject* obj)
 void Telemetry::setUpdatePeriod(UAVObject* obj, qint32 periodMs)
 {
     // Find object type (not instance!) and update its period
-    for (int n = 0; n < objList.length(); ++n)
+    QHash<quint32, int>::const_iterator itr = objListIndex.constFind(obj->getObjID());
+    if ( itr == objListIndex.constEnd() )
     {
-        if ( objList[n].obj->getObjID() == obj->getObjID() )
-        {
-            objList[n].updatePeriodMs = periodMs;
-            objList[n].timeToNextUpdateMs = quint32((float)periodMs * (float)qrand() / (float)RAND_MAX); // avoid bunching of updates
-        }
+        return;
+    }
+    int objIdx = itr.value();
+    ObjectTimeInfo& timeInfo = objList[objIdx];
+    if ( timeInfo.updatePeriodMs == periodMs )
+    {
+        return;
     }
+    // Any update already in the heap is now stale
+    timeInfo.updatePeriodMs = periodMs;
+    ++timeInfo.generation;
+    if ( periodMs > 0 )
+    {
+        qint64 offset = qint64((float)periodMs * (float)qrand() / (float)RAND_MAX); // avoid bunching of updates
+        scheduleUpdate(objIdx, schedTimer.elapsed() + offset);
+        restartUpdateTimer();
+    }
+}
+
+/**
+ * Heap ordering for the periodic updates, earliest due time at the front
+ */
+bool Telemetry::updateDueLater(const ScheduledUpdate& a, const ScheduledUpdate& b)
+{
+    return a.dueMs > b.dueMs;
+}
+
+/**
+ * Queue the next periodic update of an object
+ */
+void Telemetry::scheduleUpdate(int objIdx, qint64 dueMs)
+{
+    ScheduledUpdate update;
+    update.dueMs = dueMs;
+    update.objIdx = objIdx;
+    update.generation = objList[objIdx].generation;
+    updateHeap.append(update);
+    std::push_heap(updateHeap.begin(), updateHeap.end(), updateDueLater);
+}
+
+/**
+ * Arm the update timer for the earliest pending periodic update
+ */
+void Telemetry::restartUpdateTimer()
+{
+    qint64 delay = MAX_UPDATE_PERIOD_MS;
+    if ( !updateHeap.isEmpty() )
+    {
+        delay = updateHeap.first().dueMs - schedTimer.elapsed();
+    }
+    updateTimer->start(qBound<qint64>(MIN_UPDATE_PERIOD_MS, delay, MAX_UPDATE_PERIOD_MS));
 }
 
 /**
@@ -232,15 +282,18 @@ void Telemetry::updateObject(UAVObject* obj, quint32 eventType)
  */
 void Telemetry::transactionCompleted(UAVObject* obj, bool success)
 {
-    // Lookup the transaction in the transaction map.
-    quint32 objId = obj->getObjID();
-    QMap<quint32, ObjectTransactionInfo*>::iterator itr = transMap.find(objId);
+    // Lookup the transaction in the transaction map, on this instance or on all instances.
+    QMap<quint64, ObjectTransactionInfo*>::iterator itr = transMap.find(UAVTalk::transactionKey(obj, false));
+    if ( itr == transMap.end() )
+    {
+        itr = transMap.find(UAVTalk::transactionKey(obj, true));
+    }
     if ( itr != transMap.end() )
     {
 	ObjectTransactionInfo *transInfo = itr.value();
         // Remove this transaction as it's complete.
 	transInfo->timer->stop();
-	transMap.remove(objId);
+	transMap.erase(itr);
 	delete transInfo;
         // Send signal
         obj->emitTransactionCompleted(success);
@@ -258,6 +311,15 @@ void Telemetry::transactionCompleted(UAVObject* obj, bool success)
 void Telemetry::transactionTimeout(ObjectTransactionInfo *transInfo)
 {
     transInfo->timer->stop();
+    // Fail the events which waited a full retry cycle for a free transaction
+    QList<UAVObject*> expired;
+    expireHeldObjects(objPriorityQueue, expired);
+    expireHeldObjects(objQueue, expired);
+    txErrors += expired.length();
+    foreach (UAVObject* obj, expired)
+    {
+        obj->emitTransactionCompleted(false);
+    }
     // Check if more retries are pending
     if (transInfo->retriesRemaining > 0)
     {
@@ -270,11 +332,11 @@ void Telemetry::transactionTimeout(ObjectTransactionInfo *transInfo)
 	// Stop the timer.
 	transInfo->timer->stop();
         // Terminate transaction
-        utalk->cancelTransaction(transInfo->obj);
+        utalk->cancelTransaction(transInfo->obj, transInfo->allInstances);
         // Send signal
         transInfo->obj->emitTransactionCompleted(false);
         // Remove this transaction as it's complete.
-	transMap.remove(transInfo->obj->getObjID());
+	transMap.remove(UAVTalk::transactionKey(transInfo->obj, transInfo->allInstances));
 	delete transInfo;
 	// Process new object updates from queue
         processObjectQueue();
@@ -305,8 +367,11 @@ void Telemetry::processObjectTransaction(ObjectTransactionInfo *transInfo)
     else
     {
         // Otherwise, remove this transaction as it's complete.
-	transMap.remove(transInfo->obj->getObjID());
+        UAVObject* obj = transInfo->obj;
+	transMap.remove(UAVTalk::transactionKey(transInfo->obj, transInfo->allInstances));
 	delete transInfo;
+        // Unacked updates complete once sent
+        obj->emitTransactionCompleted(true);
     }
 }
 
@@ -320,6 +385,13 @@ void Telemetry::processObjectUpdates(UAVObject* obj, EventMask event, bool allIn
     objInfo.obj = obj;
     objInfo.event = event;
     objInfo.allInstances = allInstances;
+    objInfo.queuedMs = schedTimer.elapsed();
+    // Unacked updates are packed when sent, so one still queued for the same
+    // instance already carries the new data (e.g. streamed GCSReceiver channels)
+    if ( !UAVObject::GetGcsTelemetryAcked(obj->getMetadata()) && isQueued(priority ? objPriorityQueue : objQueue, objInfo) )
+    {
+        return;
+    }
     if (priority)
     {
         if ( objPriorityQueue.length() < MAX_QUEUE_SIZE )
@@ -351,25 +423,116 @@ void Telemetry::processObjectUpdates(UAVObject* obj, EventMask event, bool allIn
 }
 
 /**
- * Process events from the object queue
+ * Check if the same event for the same object instance is waiting in the queue
+ */
+bool Telemetry::isQueued(const QQueue<ObjectQueueInfo>& queue, const ObjectQueueInfo& objInfo)
+{
+    for (int n = 0; n < queue.length(); ++n)
+    {
+        const ObjectQueueInfo& queued = queue[n];
+        if ( queued.obj == objInfo.obj && queued.event == objInfo.event && queued.allInstances == objInfo.allInstances )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Process events from the object queue. Up to MAX_PENDING_TRANSACTIONS acked or
+ * requested transactions are kept in flight, each for a different object instance,
+ * so bulk operations (e.g. many Waypoint instances) are not bound by the link round
+ * trip time. Events which expect no response do not take a slot and are sent even
+ * when the window is full.
  */
 void Telemetry::processObjectQueue()
 {
-    // Get object information from queue (first the priority and then the regular queue)
-    ObjectQueueInfo objInfo;
-    if ( !objPriorityQueue.isEmpty() )
+    forever
     {
-        objInfo = objPriorityQueue.dequeue();
+        // Get object information from queue (first the priority and then the regular queue)
+        bool windowFull = transMap.size() >= MAX_PENDING_TRANSACTIONS;
+        ObjectQueueInfo objInfo;
+        if ( !dequeueReadyObject(objPriorityQueue, objInfo, windowFull) && !dequeueReadyObject(objQueue, objInfo, windowFull) )
+        {
+            return;
+        }
+        processQueuedObject(objInfo);
     }
-    else if ( !objQueue.isEmpty() )
+}
+
+/**
+ * Take the first event from the queue which does not belong to an object instance
+ * with a transaction in progress. Events for a busy instance stay queued, in order,
+ * until its transaction completes or they expire (see expireHeldObjects()).
+ * \param[in] windowFull Only take events which do not wait for a response
+ * \return True if an event was dequeued
+ */
+bool Telemetry::dequeueReadyObject(QQueue<ObjectQueueInfo>& queue, ObjectQueueInfo& objInfo, bool windowFull)
+{
+    for (int n = 0; n < queue.length(); ++n)
     {
-        objInfo = objQueue.dequeue();
+        if ( !transactionPending(queue[n].obj, queue[n].allInstances) && ( !windowFull || !needsResponse(queue[n]) ) )
+        {
+            objInfo = queue.takeAt(n);
+            return true;
+        }
     }
-    else
+    return false;
+}
+
+/**
+ * Check if the event starts a transaction which stays in flight until an ack or
+ * the requested object is received
+ */
+bool Telemetry::needsResponse(const ObjectQueueInfo& objInfo)
+{
+    if ( objInfo.event == EV_UPDATE_REQ )
     {
-        return;
+        return true;
+    }
+    return objInfo.event != EV_UNPACKED && UAVObject::GetGcsTelemetryAcked(objInfo.obj->getMetadata());
+}
+
+/**
+ * Remove the events which have been held back for longer than MAX_HOLD_MS,
+ * the caller reports them as failed transactions
+ */
+void Telemetry::expireHeldObjects(QQueue<ObjectQueueInfo>& queue, QList<UAVObject*>& expired)
+{
+    qint64 now = schedTimer.elapsed();
+    for (int n = 0; n < queue.length(); )
+    {
+        if ( now - queue[n].queuedMs > MAX_HOLD_MS )
+        {
+            expired.append(queue.takeAt(n).obj);
+        }
+        else
+        {
+            ++n;
+        }
     }
+}
 
+/**
+ * Check if a transaction in progress covers the instance, or any instance of the
+ * object for an all instances event.
+ */
+bool Telemetry::transactionPending(UAVObject* obj, bool allInstances)
+{
+    if ( allInstances )
+    {
+        // Keys of one object are adjacent, starting at instance 0
+        QMap<quint64, ObjectTransactionInfo*>::const_iterator itr = transMap.lowerBound((quint64)obj->getObjID() << 16);
+        return itr != transMap.constEnd() && (itr.key() >> 16) == obj->getObjID();
+    }
+    return transMap.contains(UAVTalk::transactionKey(obj, false)) || transMap.contains(UAVTalk::transactionKey(obj, true));
+}
+
+/**
+ * Start the transaction for a dequeued event
+ */
+void Telemetry::processQueuedObject(const ObjectQueueInfo& objInfo)
+{
     // Check if a connection has been established, only process GCSTelemetryStats updates
     // (used to establish the connection)
     GCSTelemetryStats::DataFields gcsStats = gcsStatsObj->getData();
@@ -388,10 +551,6 @@ void Telemetry::processObjectQueue()
     UAVObject::UpdateMode updateMode = UAVObject::GetGcsTelemetryUpdateMode(metadata);
     if ( ( objInfo.event != EV_UNPACKED ) && ( ( objInfo.event != EV_UPDATED_PERIODIC ) || ( updateMode != UAVObject::UPDATEMODE_THROTTLED ) ) )
     {
-        QMap<quint32, ObjectTransactionInfo*>::iterator itr = transMap.find(objInfo.obj->getObjID());
-        if ( itr != transMap.end() ) {
-            qDebug() << "!!!!!! Making request for an object: " << objInfo.obj->getName() << " for which a request is already in progress!!!!!!";
-        }
         UAVObject::Metadata metadata = objInfo.obj->getMetadata();
         ObjectTransactionInfo *transInfo = new ObjectTransactionInfo(this);
         transInfo->obj = objInfo.obj;
@@ -408,7 +567,7 @@ void Telemetry::processObjectQueue()
         }
         transInfo->telem = this;
         // Insert the transaction into the transaction map.
-        transMap.insert(objInfo.obj->getObjID(), transInfo);
+        transMap.insert(UAVTalk::transactionKey(objInfo.obj, objInfo.allInstances), transInfo);
         processObjectTransaction(transInfo);
     }
 
@@ -422,18 +581,11 @@ void Telemetry::processObjectQueue()
     {
         updateObject( objInfo.obj, objInfo.event );
     }
-
-    // The fact we received an unpacked event does not mean that
-    // we do not have additional objects still in the queue,
-    // so we have to reschedule queue processing to make sure they are not
-    // stuck:
-    if ( objInfo.event == EV_UNPACKED )
-        processObjectQueue();
 }
 
 /**
- * Check is any objects are pending for periodic updates
- * TODO: Clean-up
+ * Send the periodic updates which are due. Updates are kept in a heap ordered by
+ * due time so only the objects which need to be sent are visited.
  */
 void Telemetry::processPeriodicUpdates()
 {
@@ -442,52 +594,67 @@ void Telemetry::processPeriodicUpdates()
     // Stop timer
     updateTimer->stop();
 
-    // Iterate through each object and update its timer, if zero then transmit object.
-    // Also calculate smallest delay to next update (will be used for setting timeToNextUpdateMs)
-    qint32 minDelay = MAX_UPDATE_PERIOD_MS;
-    ObjectTimeInfo *objinfo;
-    qint32 elapsedMs = 0;
-    QTime time;
-    qint32 offset;
-    for (int n = 0; n < objList.length(); ++n)
+    qint64 now = schedTimer.elapsed();
+    while ( !updateHeap.isEmpty() && updateHeap.first().dueMs <= now )
     {
-        objinfo = &objList[n];
-        // If object is configured for periodic updates
-        if (objinfo->updatePeriodMs > 0)
+        ScheduledUpdate update = updateHeap.first();
+        std::pop_heap(updateHeap.begin(), updateHeap.end(), updateDueLater);
+        updateHeap.pop_back();
+
+        // Skip updates scheduled before the period was changed or disabled
+        ObjectTimeInfo& timeInfo = objList[update.objIdx];
+        if ( update.generation != timeInfo.generation || timeInfo.updatePeriodMs <= 0 )
         {
-            objinfo->timeToNextUpdateMs -= timeToNextUpdateMs;
-            // Check if time for the next update
-            if (objinfo->timeToNextUpdateMs <= 0)
-            {
-                // Reset timer
-                offset = (-objinfo->timeToNextUpdateMs) % objinfo->updatePeriodMs;
-                objinfo->timeToNextUpdateMs = objinfo->updatePeriodMs - offset;
-                // Send object
-                time.start();
-                processObjectUpdates(objinfo->obj, EV_UPDATED_PERIODIC, true, false);
-                elapsedMs = time.elapsed();
-                // Update timeToNextUpdateMs with the elapsed delay of sending the object;
-                timeToNextUpdateMs += elapsedMs;
-            }
-            // Update minimum delay
-            if (objinfo->timeToNextUpdateMs < minDelay)
-            {
-                minDelay = objinfo->timeToNextUpdateMs;
-            }
+            continue;
         }
-    }
 
-    // Check if delay for the next update is too short
-    if (minDelay < MIN_UPDATE_PERIOD_MS)
-    {
-        minDelay = MIN_UPDATE_PERIOD_MS;
-    }
+        // Track how late the update is
+        qint32 latenessMs = (qint32)(now - update.dueMs);
+        ++timeInfo.updates;
+        timeInfo.totalLatenessMs += latenessMs;
+        if ( latenessMs > timeInfo.maxLatenessMs )
+        {
+            timeInfo.maxLatenessMs = latenessMs;
+        }
 
-    // Done
-    timeToNextUpdateMs = minDelay;
+        // Schedule the next update, skipping any periods which were missed entirely
+        qint64 nextDueMs = update.dueMs + timeInfo.updatePeriodMs;
+        if ( nextDueMs <= now )
+        {
+            nextDueMs = now + timeInfo.updatePeriodMs - (latenessMs % timeInfo.updatePeriodMs);
+        }
+        scheduleUpdate(update.objIdx, nextDueMs);
+
+        // Send object
+        processObjectUpdates(timeInfo.obj, EV_UPDATED_PERIODIC, true, false);
+        now = schedTimer.elapsed();
+    }
 
     // Restart timer
-    updateTimer->start(timeToNextUpdateMs);
+    restartUpdateTimer();
+}
+
+/**
+ * Get the scheduling statistics of all the objects with periodic updates
+ */
+QList<Telemetry::PeriodicUpdateStats> Telemetry::getPeriodicUpdateStats()
+{
+    QMutexLocker locker(mutex);
+    QList<PeriodicUpdateStats> statsList;
+    for (int n = 0; n < objList.length(); ++n)
+    {
+        if ( objList[n].updatePeriodMs > 0 || objList[n].updates > 0 )
+        {
+            PeriodicUpdateStats stats;
+            stats.obj = objList[n].obj;
+            stats.updatePeriodMs = objList[n].updatePeriodMs;
+            stats.updates = objList[n].updates;
+            stats.maxLatenessMs = objList[n].maxLatenessMs;
+            stats.totalLatenessMs = objList[n].totalLatenessMs;
+            statsList.append(stats);
+        }
+    }
+    return statsList;
 }
 
 Telemetry::TelemetryStats Telemetry::getStats()
@@ -557,10 +724,13 @@ void Telemetry::newObject(UAVObject* obj)
     registerObject(obj);
 }
 
-void Telemetry::newInstance(UAVObject* obj)
+void Telemetry::newInstances(QList<UAVObject*> objs)
 {
     QMutexLocker locker(mutex);
-    registerObject(obj);
+    foreach (UAVObject* obj, objs)
+    {
+        registerObject(obj);
+    }
 }
 
 ObjectTransactionInfo::ObjectTransactionInfo(QObject* parent):QObject(parent)
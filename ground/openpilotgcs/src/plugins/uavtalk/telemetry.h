@@ -36,6 +36,9 @@
 #include <QTimer>
 #include <QQueue>
 #include <QMap>
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
 
 class ObjectTransactionInfo: public QObject {
     Q_OBJECT
@@ -71,10 +74,22 @@ public:
         quint32 txRetries;
     } TelemetryStats;
 
+    typedef struct {
+        UAVObject* obj;
+        qint32 updatePeriodMs; /** Configured update period */
+        quint32 updates; /** Number of periodic updates sent */
+        qint32 maxLatenessMs; /** Largest delay between the scheduled and the actual update time */
+        qint64 totalLatenessMs; /** Sum of all delays, divide by updates for the average */
+    } PeriodicUpdateStats;
+
+    /** Number of acked or requested transactions kept in flight at once */
+    static const int MAX_PENDING_TRANSACTIONS = 8;
+
     Telemetry(UAVTalk* utalk, UAVObjectManager* objMngr);
     ~Telemetry();
     TelemetryStats getStats();
     void resetStats();
+    QList<PeriodicUpdateStats> getPeriodicUpdateStats();
     void transactionTimeout(ObjectTransactionInfo *info);
 
 signals:
@@ -86,6 +101,8 @@ private:
     static const int MAX_UPDATE_PERIOD_MS = 1000;
     static const int MIN_UPDATE_PERIOD_MS = 1;
     static const int MAX_QUEUE_SIZE = 20;
+    /** Longest an event may wait behind the transaction window, a full retry cycle */
+    static const int MAX_HOLD_MS = REQ_TIMEOUT_MS * (MAX_RETRIES + 1);
 
     // Types
     /**
@@ -103,13 +120,26 @@ private:
     typedef struct {
         UAVObject* obj;
         qint32 updatePeriodMs; /** Update period in ms or 0 if no periodic updates are needed */
-        qint32 timeToNextUpdateMs; /** Time delay to the next update */
+        quint32 generation; /** Incremented each time the period changes, invalidates queued updates */
+        quint32 updates; /** Number of periodic updates sent */
+        qint32 maxLatenessMs; /** Largest scheduling delay */
+        qint64 totalLatenessMs; /** Sum of all scheduling delays */
     } ObjectTimeInfo;
 
+    /**
+     * Entry of the periodic update heap, ordered by due time
+     */
+    typedef struct {
+        qint64 dueMs; /** Time of the update relative to schedTimer */
+        int objIdx; /** Index in objList */
+        quint32 generation; /** Generation of objList[objIdx] when scheduled */
+    } ScheduledUpdate;
+
     typedef struct {
         UAVObject* obj;
         EventMask event;
         bool allInstances;
+        qint64 queuedMs; /** Time the event was queued relative to schedTimer */
     } ObjectQueueInfo;
 
     // Variables
@@ -117,13 +147,15 @@ private:
     UAVTalk* utalk;
     GCSTelemetryStats* gcsStatsObj;
     QList<ObjectTimeInfo> objList;
+    QHash<quint32, int> objListIndex;
+    QVector<ScheduledUpdate> updateHeap;
+    QElapsedTimer schedTimer;
     QQueue<ObjectQueueInfo> objQueue;
     QQueue<ObjectQueueInfo> objPriorityQueue;
-    QMap<quint32, ObjectTransactionInfo*>transMap;
+    QMap<quint64, ObjectTransactionInfo*>transMap; // keyed by UAVTalk::transactionKey()
     QMutex* mutex;
     QTimer* updateTimer;
     QTimer* statsTimer;
-    qint32 timeToNextUpdateMs;
     quint32 txErrors;
     quint32 txRetries;
 
@@ -131,11 +163,20 @@ private:
     void registerObject(UAVObject* obj);
     void addObject(UAVObject* obj);
     void setUpdatePeriod(UAVObject* obj, qint32 periodMs);
+    void scheduleUpdate(int objIdx, qint64 dueMs);
+    void restartUpdateTimer();
+    static bool updateDueLater(const ScheduledUpdate& a, const ScheduledUpdate& b);
     void connectToObjectInstances(UAVObject* obj, quint32 eventMask);
     void updateObject(UAVObject* obj, quint32 eventMask);
     void processObjectUpdates(UAVObject* obj, EventMask event, bool allInstances, bool priority);
+    bool isQueued(const QQueue<ObjectQueueInfo>& queue, const ObjectQueueInfo& objInfo);
     void processObjectTransaction(ObjectTransactionInfo *transInfo);
     void processObjectQueue();
+    bool dequeueReadyObject(QQueue<ObjectQueueInfo>& queue, ObjectQueueInfo& objInfo, bool windowFull);
+    static bool needsResponse(const ObjectQueueInfo& objInfo);
+    void expireHeldObjects(QQueue<ObjectQueueInfo>& queue, QList<UAVObject*>& expired);
+    bool transactionPending(UAVObject* obj, bool allInstances);
+    void processQueuedObject(const ObjectQueueInfo& objInfo);
 
 private slots:
     void objectUpdatedAuto(UAVObject* obj);
@@ -144,7 +185,7 @@ private slots:
     void objectUnpacked(UAVObject* obj);
     void updateRequested(UAVObject* obj);
     void newObject(UAVObject* obj);
-    void newInstance(UAVObject* obj);
+    void newInstances(QList<UAVObject*> objs);
     void processPeriodicUpdates();
     void transactionCompleted(UAVObject* obj, bool success);
 
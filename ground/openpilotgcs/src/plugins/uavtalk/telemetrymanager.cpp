@@ -29,14 +29,36 @@
 #include <extensionsystem/pluginmanager.h>
 #include <coreplugin/icore.h>
 #include <coreplugin/threadmanager.h>
+#include <coreplugin/generalsettings.h>
 
-TelemetryManager::TelemetryManager() :
-    autopilotConnected(false)
+/**
+ * With no object manager given this drives the primary vehicle, whose objects
+ * are in the plugin pool. Any other vehicle gets a telemetry thread of its own.
+ */
+TelemetryManager::TelemetryManager(UAVObjectManager* vehicleObjMngr) :
+    utalk(0),
+    vehicleThread(0),
+    rateMngr(0),
+    adaptRates(false),
+    autopilotConnected(false),
+    threadChosen(false)
 {
-    moveToThread(Core::ICore::instance()->threadManager()->getRealTimeThread());
-    // Get UAVObjectManager instance
     ExtensionSystem::PluginManager* pm = ExtensionSystem::PluginManager::instance();
-    objMngr = pm->getObject<UAVObjectManager>();
+    if (vehicleObjMngr)
+    {
+        objMngr = vehicleObjMngr;
+        vehicleThread = new QThread();
+        // onStop() ends the thread, which then takes this manager with it
+        connect(vehicleThread, SIGNAL(finished()), this, SLOT(deleteLater()));
+        connect(vehicleThread, SIGNAL(finished()), vehicleThread, SLOT(deleteLater()));
+        vehicleThread->start();
+        moveToThread(vehicleThread);
+    }
+    else
+    {
+        // Get UAVObjectManager instance
+        objMngr = pm->getObject<UAVObjectManager>();
+    }
 
     // connect to start stop signals
     connect(this, SIGNAL(myStart()), this, SLOT(onStart()),Qt::QueuedConnection);
@@ -52,44 +74,120 @@ bool TelemetryManager::isConnected()
     return autopilotConnected;
 }
 
+/**
+ * Sends the objects right away and together, in multi-object frames when the
+ * board takes them. Meant for objects in manual update mode that are sent as
+ * a set, called from the telemetry thread. Otherwise, or if the board does not
+ * take multi-object frames, each object is updated as usual.
+ */
+void TelemetryManager::sendObjects(const QList<UAVObject*>& objs)
+{
+    FlightTelemetryCapabilities* flightCaps = FlightTelemetryCapabilities::GetInstance(objMngr);
+    if (autopilotConnected && QThread::currentThread() == thread() &&
+        (flightCaps->getData().Capabilities & UAVTalk::CAPABILITY_MULTIOBJECT))
+    {
+        utalk->sendObjects(objs);
+        return;
+    }
+    foreach (UAVObject* obj, objs)
+        obj->updated();
+}
+
+/**
+ * Per object counters of the current link, empty while there is none.
+ * May be called from any thread.
+ */
+QHash<quint32, UAVTalk::ObjectStats> TelemetryManager::getObjectStats()
+{
+    QMutexLocker locker(&utalkMutex);
+    if (!utalk)
+        return QHash<quint32, UAVTalk::ObjectStats>();
+    return utalk->getObjectStats();
+}
+
+/**
+ * The general settings are only loaded once the main window is up, after this
+ * manager was created, so they are read here.
+ */
 void TelemetryManager::start(QIODevice *dev)
 {
+    ExtensionSystem::PluginManager* pm = ExtensionSystem::PluginManager::instance();
+    Core::Internal::GeneralSettings* settings = pm->getObject<Core::Internal::GeneralSettings>();
+    adaptRates = settings && settings->adaptTelemetryRates();
+    // Link decoding, transaction timers and periodic updates all live in the objects
+    // created by onStart(), so running this manager on the real time thread moves
+    // the whole telemetry stack off the GUI thread. Decided on the first start,
+    // changing it takes a restart.
+    if (!vehicleThread && !threadChosen)
+    {
+        threadChosen = true;
+        if (!settings || settings->useTelemetryThread())
+            moveToThread(Core::ICore::instance()->threadManager()->getRealTimeThread());
+    }
     device=dev;
     emit myStart();
 }
 
 void TelemetryManager::onStart()
 {
+    utalkMutex.lock();
     utalk = new UAVTalk(device, objMngr);
+    utalkMutex.unlock();
     telemetry = new Telemetry(utalk, objMngr);
-    telemetryMon = new TelemetryMonitor(objMngr, telemetry);
+    telemetryMon = new TelemetryMonitor(objMngr, telemetry, vehicleThread == 0);
     connect(telemetryMon, SIGNAL(connected()), this, SLOT(onConnect()));
     connect(telemetryMon, SIGNAL(disconnected()), this, SLOT(onDisconnect()));
 }
 
 
+/**
+ * The default rates are put back first, on the telemetry thread, while the
+ * link is still open.
+ */
 void TelemetryManager::stop()
 {
+    QMetaObject::invokeMethod(this, "restoreRates",
+                              QThread::currentThread() == thread() ? Qt::DirectConnection : Qt::BlockingQueuedConnection);
     emit myStop();
 }
 
+void TelemetryManager::restoreRates()
+{
+    if (rateMngr)
+        rateMngr->restoreRates();
+}
+
 void TelemetryManager::onStop()
 {
     telemetryMon->disconnect(this);
     delete telemetryMon;
     delete telemetry;
+    utalkMutex.lock();
     delete utalk;
+    utalk = 0;
+    utalkMutex.unlock();
     onDisconnect();
+    if (vehicleThread)
+        vehicleThread->quit();
 }
 
 void TelemetryManager::onConnect()
 {
     autopilotConnected = true;
+    if (adaptRates)
+        rateMngr = new TelemetryRateManager(objMngr);
     emit connected();
 }
 
 void TelemetryManager::onDisconnect()
 {
     autopilotConnected = false;
+    if (rateMngr)
+    {
+        // The link is gone, this only puts the default periods back in the metadata held here
+        rateMngr->restoreRates();
+        delete rateMngr;
+        rateMngr = 0;
+    }
     emit disconnected();
 }
@@ -30,23 +30,28 @@
 
 #include "uavtalk_global.h"
 #include "telemetrymonitor.h"
+#include "telemetryratemanager.h"
 #include "telemetry.h"
 #include "uavtalk.h"
 #include "uavobjectmanager.h"
 #include <QIODevice>
 #include <QObject>
+#include <QThread>
+#include <QMutex>
 
 class UAVTALK_EXPORT TelemetryManager: public QObject
 {
     Q_OBJECT
 
 public:
-    TelemetryManager();
+    TelemetryManager(UAVObjectManager* vehicleObjMngr = 0);
     ~TelemetryManager();
 
     void start(QIODevice *dev);
-    void stop();
+    Q_INVOKABLE void stop();
     bool isConnected();
+    void sendObjects(const QList<UAVObject*>& objs);
+    QHash<quint32, UAVTalk::ObjectStats> getObjectStats();
 
 signals:
     void connected();
@@ -59,14 +64,20 @@ private slots:
     void onDisconnect();
     void onStart();
     void onStop();
+    void restoreRates();
 
 private:
     UAVObjectManager* objMngr;
     UAVTalk* utalk;
+    QMutex utalkMutex; // utalk is replaced in the telemetry thread, read from others
     Telemetry* telemetry;
     TelemetryMonitor* telemetryMon;
+    TelemetryRateManager* rateMngr; // Only while connected and enabled in the general settings
+    bool adaptRates;
     QIODevice *device;
+    QThread *vehicleThread; // Telemetry thread of a vehicle other than the primary one
     bool autopilotConnected;
+    bool threadChosen; // The primary manager picks its thread on the first start()
 };
 
 #endif // TELEMETRYMANAGER_H
@@ -29,15 +29,19 @@
 #include "qxtlogger.h"
 #include "coreplugin/connectionmanager.h"
 #include "coreplugin/icore.h"
+#include <QDateTime>
+#include <QVector>
+#include <QtAlgorithms>
 
 /**
  * Constructor
  */
-TelemetryMonitor::TelemetryMonitor(UAVObjectManager* objMngr, Telemetry* tel)
+TelemetryMonitor::TelemetryMonitor(UAVObjectManager* objMngr, Telemetry* tel, bool primaryVehicle) :
+    objectsReady(false),
+    cache(NULL)
 {
     this->objMngr = objMngr;
     this->tel = tel;
-    this->objPending = NULL;
     this->connectionTimer = new QTime();
 
     // Create mutex
@@ -47,18 +51,40 @@ TelemetryMonitor::TelemetryMonitor(UAVObjectManager* objMngr, Telemetry* tel)
     gcsStatsObj = GCSTelemetryStats::GetInstance(objMngr);
     flightStatsObj = FlightTelemetryStats::GetInstance(objMngr);
 
+    // Advertise the UAVTalk extensions we decode
+    gcsCapsObj = GCSTelemetryCapabilities::GetInstance(objMngr);
+    flightCapsObj = FlightTelemetryCapabilities::GetInstance(objMngr);
+    GCSTelemetryCapabilities::DataFields gcsCaps = gcsCapsObj->getData();
+    gcsCaps.Capabilities = UAVTalk::CAPABILITIES;
+    gcsCapsObj->setData(gcsCaps);
+
     // Listen for flight stats updates
     connect(flightStatsObj, SIGNAL(objectUpdated(UAVObject*)), this, SLOT(flightStatsUpdated(UAVObject*)));
 
+    // Latency pings, only sent once connected to firmware which sends them back
+    pingObj = TelemetryPing::GetInstance(objMngr);
+    latencyObj = TelemetryLatency::GetInstance(objMngr);
+    pingSequence = 0;
+    connect(pingObj, SIGNAL(objectUnpacked(UAVObject*)), this, SLOT(pingReceived(UAVObject*)));
+    pingTimer = new QTimer(this);
+    connect(pingTimer, SIGNAL(timeout()), this, SLOT(sendPing()));
+
     // Start update timer
     statsTimer = new QTimer(this);
     connect(statsTimer, SIGNAL(timeout()), this, SLOT(processStatsUpdates()));
     statsTimer->start(STATS_CONNECT_PERIOD_MS);
 
-    Core::ConnectionManager *cm = Core::ICore::instance()->connectionManager();
-    connect(this,SIGNAL(connected()),cm,SLOT(telemetryConnected()));
-    connect(this,SIGNAL(disconnected()),cm,SLOT(telemetryDisconnected()));
-    connect(this,SIGNAL(telemetryUpdated(double,double)),cm,SLOT(telemetryUpdated(double,double)));
+    // There is no connection manager to report to when running headless,
+    // and it only shows the link of the primary vehicle
+    Core::ICore *core = Core::ICore::instance();
+    if (core && primaryVehicle)
+    {
+        Core::ConnectionManager *cm = core->connectionManager();
+        connect(this,SIGNAL(connected()),cm,SLOT(telemetryConnected()));
+        connect(this,SIGNAL(disconnected()),cm,SLOT(telemetryDisconnected()));
+        connect(this,SIGNAL(telemetryUpdated(double,double)),cm,SLOT(telemetryUpdated(double,double)));
+        connect(this,SIGNAL(latencyUpdated(int,int,int)),cm,SLOT(telemetryLatencyUpdated(int,int,int)));
+    }
 }
 
 TelemetryMonitor::~TelemetryMonitor() {
@@ -67,16 +93,38 @@ TelemetryMonitor::~TelemetryMonitor() {
     gcsStats.Status = GCSTelemetryStats::STATUS_DISCONNECTED;
     // Set data
     gcsStatsObj->setData(gcsStats);
+    delete cache;
 }
 
 /**
  * Initiate object retrieval, initialize queue with objects to be retrieved.
+ * The board identity goes first so the settings cache can be used, then the
+ * metaobjects, the settings shown by open views, the other settings and the
+ * data objects with OnChange update mode.
  */
 void TelemetryMonitor::startRetrievingObjects()
 {
     // Clear object queue
     queue.clear();
-    // Get all objects, add metaobjects, settings and data objects with OnChange update mode to the queue
+    backgroundQueue.clear();
+    objRequired.clear();
+    objectsReady = false;
+    cacheKey.clear();
+    cacheHashes.clear();
+    if ( cache == NULL )
+    {
+        // Own settings file, the GCS settings belong to the GUI thread
+        cache = new QSettings(QSettings::IniFormat, QSettings::UserScope,
+                              QLatin1String("OpenPilot"), QLatin1String("TelemetrySettingsCache"));
+    }
+    UAVObject* iapObj = objMngr->getObject(QString("FirmwareIAPObj"));
+    if ( iapObj != NULL )
+    {
+        queue.enqueue(iapObj);
+    }
+    QList<UAVObject*> shownSettings;
+    QList<UAVObject*> settings;
+    QList<UAVObject*> data;
     QList< QList<UAVObject*> > objs = objMngr->getObjects();
     for (int n = 0; n < objs.length(); ++n)
     {
@@ -88,21 +136,29 @@ void TelemetryMonitor::startRetrievingObjects()
         {
             queue.enqueue(obj);
         }
-        else if ( dobj != NULL )
+        else if ( dobj != NULL && obj != iapObj )
         {
             if ( dobj->isSettings() )
             {
-                queue.enqueue(obj);
+                if ( obj->hasInterest() )
+                {
+                    shownSettings.append(obj);
+                }
+                else
+                {
+                    settings.append(obj);
+                }
             }
             else
             {
                 if ( UAVObject::GetFlightTelemetryUpdateMode(mdata) == UAVObject::UPDATEMODE_ONCHANGE )
                 {
-                    queue.enqueue(obj);
+                    data.append(obj);
                 }
             }
         }
     }
+    queue << shownSettings << settings << data;
     // Start retrieving
     qxtLog->debug(tr("Starting to retrieve meta and settings objects from the autopilot (%1 objects)")
                   .arg( queue.length()) );
@@ -116,28 +172,119 @@ void TelemetryMonitor::stopRetrievingObjects()
 {
     qxtLog->debug("Object retrieval has been cancelled");
     queue.clear();
+    backgroundQueue.clear();
+    objRequired.clear();
 }
 
 /**
- * Retrieve the next object in the queue
+ * Retrieve the next objects in the queue, keeping up to
+ * Telemetry::MAX_PENDING_TRANSACTIONS requests in flight. Settings that are
+ * not shown and were cached in the last session are filled from the cache
+ * and only requested once everything else was retrieved.
  */
 void TelemetryMonitor::retrieveNextObject()
 {
-    // If queue is empty return
-    if ( queue.isEmpty() )
+    while ( !queue.isEmpty() && objPending.size() < Telemetry::MAX_PENDING_TRANSACTIONS )
     {
-        qxtLog->debug("Object retrieval completed");
+        // Get next object from the queue
+        UAVObject* obj = queue.dequeue();
+        UAVDataObject* dobj = dynamic_cast<UAVDataObject*>(obj);
+        if ( dobj != NULL && dobj->isSettings() && !obj->hasInterest() && loadCachedSettings(obj) )
+        {
+            backgroundQueue.enqueue(obj);
+            continue;
+        }
+        requestObject(obj, true);
+    }
+    // The GCS is usable once the required objects are in
+    if ( !objectsReady && queue.isEmpty() && objRequired.isEmpty() )
+    {
+        objectsReady = true;
+        qxtLog->debug(tr("Object retrieval completed, %1 cached settings are refreshed in the background")
+                      .arg(backgroundQueue.length()));
         emit connected();
-        return;
     }
-    // Get next object from the queue
-    UAVObject* obj = queue.dequeue();
+    while ( queue.isEmpty() && !backgroundQueue.isEmpty() && objPending.size() < Telemetry::MAX_PENDING_TRANSACTIONS )
+    {
+        requestObject(backgroundQueue.dequeue(), false);
+    }
+}
+
+void TelemetryMonitor::requestObject(UAVObject* obj, bool required)
+{
     //qxtLog->trace( tr("Retrieving object: %1").arg(obj->getName()) );
     // Connect to object
     connect(obj, SIGNAL(transactionCompleted(UAVObject*,bool)), this, SLOT(transactionCompleted(UAVObject*,bool)));
     // Request update
+    objPending.insert(obj);
+    if ( required )
+    {
+        objRequired.insert(obj);
+    }
     obj->requestUpdate();
-    objPending = obj;
+}
+
+/**
+ * The cache of a board is keyed by the serial number of its CPU, the object
+ * IDs change with the layout of the objects so old entries are never used.
+ */
+void TelemetryMonitor::setCacheKey(UAVObject* iapObj)
+{
+    UAVObjectField* serial = iapObj->getField(QString("CPUSerial"));
+    if ( serial == NULL )
+    {
+        return;
+    }
+    QByteArray bytes;
+    for (quint32 n = 0; n < serial->getNumElements(); ++n)
+    {
+        bytes.append((char)serial->getValue(n).toUInt());
+    }
+    if ( bytes.count('\0') != bytes.length() )
+    {
+        cacheKey = QString(bytes.toHex());
+    }
+}
+
+/**
+ * Fill a settings object with its data from the last session
+ * @returns false if there is no cache for the object
+ */
+bool TelemetryMonitor::loadCachedSettings(UAVObject* obj)
+{
+    if ( cacheKey.isEmpty() )
+    {
+        return false;
+    }
+    QByteArray data = cache->value(QString("%1/%2").arg(cacheKey).arg(obj->getObjID(), 8, 16, QChar('0'))).toByteArray();
+    if ( (quint32)data.size() != obj->getNumBytes() )
+    {
+        return false;
+    }
+    obj->unpack((const quint8*)data.constData());
+    cacheHashes.insert(obj->getObjID(), qHash(data));
+    return true;
+}
+
+/**
+ * Keep the settings received from the board for the next session, the
+ * settings file is only written for the objects that changed.
+ */
+void TelemetryMonitor::storeCachedSettings(UAVObject* obj)
+{
+    if ( cacheKey.isEmpty() )
+    {
+        return;
+    }
+    QByteArray data(obj->getNumBytes(), 0);
+    obj->pack((quint8*)data.data());
+    uint hash = qHash(data);
+    if ( cacheHashes.contains(obj->getObjID()) && cacheHashes.value(obj->getObjID()) == hash )
+    {
+        return;
+    }
+    cacheHashes.insert(obj->getObjID(), hash);
+    cache->setValue(QString("%1/%2").arg(cacheKey).arg(obj->getObjID(), 8, 16, QChar('0')), data);
 }
 
 /**
@@ -145,11 +292,23 @@ void TelemetryMonitor::retrieveNextObject()
  */
 void TelemetryMonitor::transactionCompleted(UAVObject* obj, bool success)
 {
-    Q_UNUSED(success);
     QMutexLocker locker(mutex);
     // Disconnect from sending object
     obj->disconnect(this);
-    objPending = NULL;
+    objPending.remove(obj);
+    objRequired.remove(obj);
+    if ( success )
+    {
+        UAVDataObject* dobj = dynamic_cast<UAVDataObject*>(obj);
+        if ( obj->getName() == "FirmwareIAPObj" )
+        {
+            setCacheKey(obj);
+        }
+        else if ( dobj != NULL && dobj->isSettings() )
+        {
+            storeCachedSettings(obj);
+        }
+    }
     // Process next object if telemetry is still available
     GCSTelemetryStats::DataFields gcsStats = gcsStatsObj->getData();
     if ( gcsStats.Status == GCSTelemetryStats::STATUS_CONNECTED )
@@ -180,6 +339,112 @@ void TelemetryMonitor::flightStatsUpdated(UAVObject* obj)
     }
 }
 
+/**
+ * Send the next ping, the autopilot sends it back with the times it
+ * received and sent it
+ */
+void TelemetryMonitor::sendPing()
+{
+    QMutexLocker locker(mutex);
+
+    TelemetryPing::DataFields ping = pingObj->getData();
+    ping.Sequence = ++pingSequence;
+    ping.GCSTxTime = (quint32)QDateTime::currentMSecsSinceEpoch();
+    ping.FlightRxTime = 0;
+    ping.FlightTxTime = 0;
+    pingObj->setData(ping);
+    pingObj->updated();
+}
+
+/**
+ * Called when the autopilot sent a ping back, the time it arrived is the
+ * time its packet was read off the link. A ping overtaken by the next one
+ * is dropped.
+ */
+void TelemetryMonitor::pingReceived(UAVObject* obj)
+{
+    QMutexLocker locker(mutex);
+
+    TelemetryPing::DataFields ping = pingObj->getData();
+    if ( ping.Sequence != pingSequence )
+    {
+        return;
+    }
+    quint32 rxTime = (quint32)obj->getUpdateTime();
+    LatencySample sample;
+    sample.uplink = ping.FlightRxTime - ping.GCSTxTime;
+    sample.downlink = rxTime - ping.FlightTxTime;
+    sample.roundTrip = (qint32)(rxTime - ping.GCSTxTime);
+    sample.delay = sample.roundTrip - (qint32)(ping.FlightTxTime - ping.FlightRxTime);
+    if ( sample.roundTrip < 0 || sample.delay < 0 )
+    {
+        return;
+    }
+    latencySamples.append(sample);
+    while ( latencySamples.length() > LATENCY_WINDOW )
+    {
+        latencySamples.removeFirst();
+    }
+}
+
+/**
+ * Median, 95th percentile and maximum of a set of latencies, clamped to the
+ * range of the stats fields
+ */
+static void latencyPercentiles(QVector<int> values, quint16* out)
+{
+    qSort(values);
+    int count = values.size();
+    int at[3] = { count / 2, qMin(count - 1, count * 95 / 100), count - 1 };
+    for (int n = 0; n < 3; ++n)
+    {
+        out[n] = (quint16)qBound(0, values[at[n]], 0xFFFF);
+    }
+}
+
+/**
+ * Latency of the pings in the window. The offset between the clocks of the
+ * GCS and the autopilot is estimated from the ping with the shortest delay,
+ * its two ways were the most even: ((t1 - t0) + (t2 - t3)) / 2. The one way
+ * latencies are only as good as that estimate, the round trip is not.
+ */
+void TelemetryMonitor::updateLatencyStats(TelemetryLatency::DataFields& latency)
+{
+    for (quint32 n = 0; n < TelemetryLatency::ROUNDTRIPTIME_NUMELEM; ++n)
+    {
+        latency.RoundTripTime[n] = 0;
+        latency.UplinkLatency[n] = 0;
+        latency.DownlinkLatency[n] = 0;
+    }
+    if ( latencySamples.isEmpty() )
+    {
+        return;
+    }
+
+    const LatencySample* best = &latencySamples.first();
+    foreach (const LatencySample& sample, latencySamples)
+    {
+        if ( sample.delay < best->delay )
+        {
+            best = &sample;
+        }
+    }
+    quint32 offset = best->uplink - (quint32)(best->delay / 2);
+
+    QVector<int> roundTrip;
+    QVector<int> uplink;
+    QVector<int> downlink;
+    foreach (const LatencySample& sample, latencySamples)
+    {
+        roundTrip.append(sample.roundTrip);
+        uplink.append((qint32)(sample.uplink - offset));
+        downlink.append((qint32)(sample.downlink + offset));
+    }
+    latencyPercentiles(roundTrip, latency.RoundTripTime);
+    latencyPercentiles(uplink, latency.UplinkLatency);
+    latencyPercentiles(downlink, latency.DownlinkLatency);
+}
+
 /**
  * Called periodically to update the statistics and connection status.
  */
@@ -199,6 +464,8 @@ void TelemetryMonitor::processStatsUpdates()
     gcsStats.RxFailures += telStats.rxErrors;
     gcsStats.TxFailures += telStats.txErrors;
     gcsStats.TxRetries += telStats.txRetries;
+    TelemetryLatency::DataFields latency = latencyObj->getData();
+    updateLatencyStats(latency);
 
     // Check for a connection timeout
     bool connectionTimeout;
@@ -240,14 +507,19 @@ void TelemetryMonitor::processStatsUpdates()
     }
 
     emit telemetryUpdated((double)gcsStats.TxDataRate, (double)gcsStats.RxDataRate);
+    emit latencyUpdated(latency.RoundTripTime[TelemetryLatency::ROUNDTRIPTIME_MEDIAN],
+                        latency.RoundTripTime[TelemetryLatency::ROUNDTRIPTIME_P95],
+                        latency.RoundTripTime[TelemetryLatency::ROUNDTRIPTIME_MAX]);
 
     // Set data
     gcsStatsObj->setData(gcsStats);
+    latencyObj->setData(latency);
 
     // Force telemetry update if not yet connected
     if ( gcsStats.Status != GCSTelemetryStats::STATUS_CONNECTED ||
          flightStats.Status != FlightTelemetryStats::STATUS_CONNECTED )
     {
+        gcsCapsObj->updated();
         gcsStatsObj->updated();
     }
 
@@ -257,11 +529,21 @@ void TelemetryMonitor::processStatsUpdates()
         statsTimer->setInterval(STATS_UPDATE_PERIOD_MS);
         qxtLog->info("Connection with the autopilot established");
         startRetrievingObjects();
+        if ( flightCapsObj->getData().Capabilities & UAVTalk::CAPABILITY_PING )
+        {
+            pingTimer->start(PING_PERIOD_MS);
+        }
     }
     if (gcsStats.Status == GCSTelemetryStats::STATUS_DISCONNECTED && gcsStats.Status != oldStatus)
     {
         statsTimer->setInterval(STATS_CONNECT_PERIOD_MS);
         qxtLog->info("Connection with the autopilot lost");
+        pingTimer->stop();
+        latencySamples.clear();
+        // The next autopilot may run older firmware which never sends its extensions
+        FlightTelemetryCapabilities::DataFields flightCaps = flightCapsObj->getData();
+        flightCaps.Capabilities = 0;
+        flightCapsObj->setData(flightCaps);
         qxtLog->info("Trying to connect to the autopilot");
         emit disconnected();
     }
@@ -30,14 +30,21 @@
 
 #include <QObject>
 #include <QQueue>
+#include <QSet>
 #include <QTimer>
 #include <QTime>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QHash>
+#include <QSettings>
 #include "uavobjectmanager.h"
 #include "gcstelemetrystats.h"
 #include "flighttelemetrystats.h"
+#include "gcstelemetrycapabilities.h"
+#include "flighttelemetrycapabilities.h"
 #include "systemstats.h"
+#include "telemetryping.h"
+#include "telemetrylatency.h"
 #include "telemetry.h"
 
 class TelemetryMonitor : public QObject
@@ -45,37 +52,71 @@ class TelemetryMonitor : public QObject
     Q_OBJECT
 
 public:
-    TelemetryMonitor(UAVObjectManager* objMngr, Telemetry* tel);
+    TelemetryMonitor(UAVObjectManager* objMngr, Telemetry* tel, bool primaryVehicle = true);
     ~TelemetryMonitor();
 
 signals:
     void connected();
     void disconnected();
     void telemetryUpdated(double txRate, double rxRate);
+    void latencyUpdated(int medianMs, int p95Ms, int maxMs);
 
 public slots:
     void transactionCompleted(UAVObject* obj, bool success);
     void processStatsUpdates();
     void flightStatsUpdated(UAVObject* obj);
+    void sendPing();
+    void pingReceived(UAVObject* obj);
 
 private:
     static const int STATS_UPDATE_PERIOD_MS = 4000;
     static const int STATS_CONNECT_PERIOD_MS = 2000;
     static const int CONNECTION_TIMEOUT_MS = 8000;
+    static const int PING_PERIOD_MS = 1000;
+    static const int LATENCY_WINDOW = 60;
+
+    // Times of one ping, t0 and t3 on the GCS clock, t1 and t2 on the flight clock
+    typedef struct {
+        quint32 uplink;     // t1 - t0
+        quint32 downlink;   // t3 - t2
+        qint32 roundTrip;   // t3 - t0
+        qint32 delay;       // roundTrip less the time spent on the flight side
+    } LatencySample;
 
     UAVObjectManager* objMngr;
     Telemetry* tel;
     QQueue<UAVObject*> queue;
+    // Settings shown from the cache of the last session, refreshed after connected()
+    QQueue<UAVObject*> backgroundQueue;
+    // Requests that must complete before connected()
+    QSet<UAVObject*> objRequired;
+    bool objectsReady;
+    // Board the settings cache belongs to and the hash of each cached object
+    QString cacheKey;
+    QHash<quint32, uint> cacheHashes;
+    QSettings* cache;
     GCSTelemetryStats* gcsStatsObj;
     FlightTelemetryStats* flightStatsObj;
+    GCSTelemetryCapabilities* gcsCapsObj;
+    FlightTelemetryCapabilities* flightCapsObj;
     QTimer* statsTimer;
-    UAVObject* objPending;
+    QSet<UAVObject*> objPending;
+    TelemetryPing* pingObj;
+    TelemetryLatency* latencyObj;
+    QTimer* pingTimer;
+    quint16 pingSequence;
+    QList<LatencySample> latencySamples;
     QMutex* mutex;
     QTime* connectionTimer;
 
     void startRetrievingObjects();
     void retrieveNextObject();
+    void requestObject(UAVObject* obj, bool required);
     void stopRetrievingObjects();
+    void setCacheKey(UAVObject* iapObj);
+    bool loadCachedSettings(UAVObject* obj);
+    void storeCachedSettings(UAVObject* obj);
+    void updateLatencyStats(TelemetryLatency::DataFields& latency);
 };
 
 #endif // TELEMETRYMONITOR_H
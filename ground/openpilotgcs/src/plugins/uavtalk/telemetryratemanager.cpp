@@ -0,0 +1,172 @@
+/**
+ ******************************************************************************
+ *
+ * @file       telemetryratemanager.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVTalkPlugin UAVTalk Plugin
+ * @{
+ * @brief The UAVTalk protocol plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "telemetryratemanager.h"
+
+TelemetryRateManager::TelemetryRateManager(UAVObjectManager* objMngr) :
+    objMngr(objMngr)
+{
+    QList< QList<UAVDataObject*> > objs = objMngr->getDataObjects();
+    for (int n = 0; n < objs.length(); ++n)
+    {
+        UAVDataObject* obj = objs[n][0];
+        if ( obj->isSettings() )
+        {
+            continue;
+        }
+        UAVObject::Metadata defaultMdata = obj->getDefaultMetadata();
+        UAVObject::UpdateMode mode = UAVObject::GetFlightTelemetryUpdateMode(defaultMdata);
+        if ( mode != UAVObject::UPDATEMODE_PERIODIC && mode != UAVObject::UPDATEMODE_THROTTLED )
+        {
+            continue;
+        }
+        quint16 defaultPeriod = defaultMdata.flightTelemetryUpdatePeriod;
+        if ( defaultPeriod == 0 || defaultPeriod > IDLE_PERIOD_MS )
+        {
+            continue;
+        }
+        defaultPeriods.insert(obj, defaultPeriod);
+        foreach (UAVDataObject* inst, objs[n])
+        {
+            connect(inst, SIGNAL(interestChanged(UAVObject*,bool)), this, SLOT(interestChanged(UAVObject*)));
+        }
+        connect(obj->getMetaObject(), SIGNAL(objectUpdated(UAVObject*)), this, SLOT(metadataUpdated(UAVObject*)));
+        updateRate(obj);
+    }
+    connect(objMngr, SIGNAL(newInstances(QList<UAVObject*>)), this, SLOT(newInstances(QList<UAVObject*>)));
+}
+
+/**
+ * Send the default period of every object whose period was changed here
+ */
+void TelemetryRateManager::restoreRates()
+{
+    QHash<UAVDataObject*, quint16>::const_iterator itr;
+    for (itr = defaultPeriods.constBegin(); itr != defaultPeriods.constEnd(); ++itr)
+    {
+        UAVObject::Metadata mdata = itr.key()->getMetadata();
+        if ( isOwnPeriod(itr.value(), mdata) && mdata.flightTelemetryUpdatePeriod != itr.value() )
+        {
+            sendPeriod(itr.key(), itr.value());
+        }
+    }
+}
+
+void TelemetryRateManager::interestChanged(UAVObject* obj)
+{
+    UAVDataObject* first = dynamic_cast<UAVDataObject*>(objMngr->getObject(obj->getObjID()));
+    if ( first != NULL && defaultPeriods.contains(first) )
+    {
+        updateRate(first);
+    }
+}
+
+void TelemetryRateManager::newInstances(QList<UAVObject*> objs)
+{
+    foreach (UAVObject* obj, objs)
+    {
+        UAVDataObject* first = dynamic_cast<UAVDataObject*>(objMngr->getObject(obj->getObjID()));
+        if ( first != NULL && defaultPeriods.contains(first) )
+        {
+            connect(obj, SIGNAL(interestChanged(UAVObject*,bool)), this, SLOT(interestChanged(UAVObject*)));
+        }
+    }
+}
+
+/**
+ * The metadata was changed, by the manager or by someone else. An object
+ * given back a period of the manager is managed again.
+ */
+void TelemetryRateManager::metadataUpdated(UAVObject* mobj)
+{
+    UAVMetaObject* meta = dynamic_cast<UAVMetaObject*>(mobj);
+    UAVDataObject* obj = meta ? dynamic_cast<UAVDataObject*>(meta->getParentObject()) : NULL;
+    if ( obj != NULL && defaultPeriods.contains(obj) )
+    {
+        updateRate(obj);
+    }
+}
+
+quint16 TelemetryRateManager::shownPeriod(quint16 defaultPeriod)
+{
+    return defaultPeriod < SHOWN_PERIOD_MS ? defaultPeriod : SHOWN_PERIOD_MS;
+}
+
+quint16 TelemetryRateManager::idlePeriod(quint16 defaultPeriod)
+{
+    return defaultPeriod > IDLE_PERIOD_MS ? defaultPeriod : IDLE_PERIOD_MS;
+}
+
+/**
+ * True if the metadata holds a period the manager sets. A period set by a
+ * previous session whose link was lost is still one of them.
+ */
+bool TelemetryRateManager::isOwnPeriod(quint16 defaultPeriod, const UAVObject::Metadata& mdata)
+{
+    UAVObject::UpdateMode mode = UAVObject::GetFlightTelemetryUpdateMode(mdata);
+    if ( mode != UAVObject::UPDATEMODE_PERIODIC && mode != UAVObject::UPDATEMODE_THROTTLED )
+    {
+        return false;
+    }
+    quint16 period = mdata.flightTelemetryUpdatePeriod;
+    return period == defaultPeriod || period == shownPeriod(defaultPeriod) || period == idlePeriod(defaultPeriod);
+}
+
+/**
+ * Send the shown or idle period of an object, the metadata is shared by all
+ * its instances so any shown instance counts. A period set by someone else
+ * is kept.
+ */
+void TelemetryRateManager::updateRate(UAVDataObject* obj)
+{
+    quint16 defaultPeriod = defaultPeriods.value(obj);
+    UAVObject::Metadata mdata = obj->getMetadata();
+    if ( !isOwnPeriod(defaultPeriod, mdata) )
+    {
+        return;
+    }
+    bool shown = false;
+    foreach (UAVObject* inst, objMngr->getObjectInstances(obj->getObjID()))
+    {
+        shown = shown || inst->hasInterest();
+    }
+    quint16 period = shown ? shownPeriod(defaultPeriod) : idlePeriod(defaultPeriod);
+    if ( period != mdata.flightTelemetryUpdatePeriod )
+    {
+        sendPeriod(obj, period);
+    }
+}
+
+/**
+ * Update the metadata, which sends it to the flight side
+ */
+void TelemetryRateManager::sendPeriod(UAVDataObject* obj, quint16 period)
+{
+    UAVObject::Metadata mdata = obj->getMetadata();
+    mdata.flightTelemetryUpdatePeriod = period;
+    obj->setMetadata(mdata);
+}
@@ -0,0 +1,77 @@
+/**
+ ******************************************************************************
+ *
+ * @file       telemetryratemanager.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVTalkPlugin UAVTalk Plugin
+ * @{
+ * @brief The UAVTalk protocol plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef TELEMETRYRATEMANAGER_H
+#define TELEMETRYRATEMANAGER_H
+
+#include "uavobjectmanager.h"
+#include <QObject>
+#include <QHash>
+
+/**
+ * Adapts the flight telemetry periods to the objects shown in the GCS, see
+ * UAVObject::addInterest(). Periodic data objects sent faster than once a
+ * second go at SHOWN_PERIOD_MS while a view shows them and at IDLE_PERIOD_MS
+ * otherwise, by updating their metadata. Only objects with a faster default
+ * than IDLE_PERIOD_MS are ever slowed down, views that read them must hold
+ * their interest. An object whose period was set by someone else, such as a
+ * calibration or the HITL simulator, is left alone until a period of the
+ * manager is put back.
+ *
+ * Created when the telemetry connects and lives in the telemetry thread,
+ * restoreRates() puts the default periods back before the link goes.
+ */
+class TelemetryRateManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    TelemetryRateManager(UAVObjectManager* objMngr);
+
+    void restoreRates();
+
+private slots:
+    void interestChanged(UAVObject* obj);
+    void newInstances(QList<UAVObject*> objs);
+    void metadataUpdated(UAVObject* mobj);
+
+private:
+    static const quint16 SHOWN_PERIOD_MS = 200;
+    static const quint16 IDLE_PERIOD_MS = 1000;
+
+    UAVObjectManager* objMngr;
+    // Default period of the managed objects, by their first instance
+    QHash<UAVDataObject*, quint16> defaultPeriods;
+
+    quint16 shownPeriod(quint16 defaultPeriod);
+    quint16 idlePeriod(quint16 defaultPeriod);
+    bool isOwnPeriod(quint16 defaultPeriod, const UAVObject::Metadata& mdata);
+    void updateRate(UAVDataObject* obj);
+    void sendPeriod(UAVDataObject* obj, quint16 period);
+};
+
+#endif // TELEMETRYRATEMANAGER_H
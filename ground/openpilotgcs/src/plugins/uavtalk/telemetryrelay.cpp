@@ -0,0 +1,175 @@
+/**
+ ******************************************************************************
+ *
+ * @file       telemetryrelay.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVTalkPlugin UAVTalk Plugin
+ * @{
+ * @brief The UAVTalk protocol plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "telemetryrelay.h"
+#include <QtEndian>
+#include <QDebug>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+#include <QtNetwork/QUdpSocket>
+
+// Bytes a TCP client may have queued before blocks are dropped for it
+#define CLIENT_QUEUE_LIMIT (64*1024)
+// Oldest UDP client is forgotten past this many
+#define MAX_UDP_CLIENTS 8
+
+#define SYNC_VAL 0x3C
+#define TYPE_MASK 0xF8
+#define TYPE_VER 0x20
+#define MIN_HEADER_LENGTH 8
+#define MAX_PACKET_LENGTH (10 + 256 + 1)
+
+TelemetryRelay::TelemetryRelay(quint16 port, QObject *parent) : QObject(parent)
+{
+    server = new QTcpServer(this);
+    if (!server->listen(QHostAddress::Any, port))
+        qDebug() << "TelemetryRelay: cannot listen on TCP port" << port << server->errorString();
+    connect(server, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+
+    udpSocket = new QUdpSocket(this);
+    if (!udpSocket->bind(port))
+        qDebug() << "TelemetryRelay: cannot bind UDP port" << port << udpSocket->errorString();
+    connect(udpSocket, SIGNAL(readyRead()), this, SLOT(onDatagram()));
+}
+
+TelemetryRelay::~TelemetryRelay()
+{
+}
+
+bool TelemetryRelay::hasClients() const
+{
+    return !tcpClients.isEmpty() || !udpClients.isEmpty();
+}
+
+/**
+ * Send a block read from the vehicle to every client. The block is shared,
+ * not copied, until a socket buffers it.
+ */
+void TelemetryRelay::downlink(const QByteArray &block)
+{
+    for (int i = 0; i < tcpClients.count(); ++i) {
+        TcpClient &client = tcpClients[i];
+        if (client.socket->bytesToWrite() + block.size() > CLIENT_QUEUE_LIMIT) {
+            // UAVTalk resyncs on the next frame, a slow client just loses some
+            if ((client.dropped++ % 100) == 0)
+                qDebug() << "TelemetryRelay: client" << client.socket->peerAddress().toString()
+                         << "too slow, blocks dropped:" << client.dropped;
+            continue;
+        }
+        client.socket->write(block);
+    }
+    foreach (const UdpClient &client, udpClients)
+        udpSocket->writeDatagram(block, client.address, client.port);
+}
+
+void TelemetryRelay::onNewConnection()
+{
+    while (server->hasPendingConnections()) {
+        TcpClient client;
+        client.socket = server->nextPendingConnection();
+        client.socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        client.dropped = 0;
+        connect(client.socket, SIGNAL(readyRead()), this, SLOT(onClientReadyRead()));
+        connect(client.socket, SIGNAL(disconnected()), this, SLOT(onClientDisconnected()));
+        tcpClients.append(client);
+        qDebug() << "TelemetryRelay: client connected" << client.socket->peerAddress().toString();
+    }
+}
+
+void TelemetryRelay::onClientReadyRead()
+{
+    for (int i = 0; i < tcpClients.count(); ++i) {
+        if (tcpClients[i].socket == sender()) {
+            tcpClients[i].uplink.append(tcpClients[i].socket->readAll());
+            extractFrames(tcpClients[i].uplink);
+            return;
+        }
+    }
+}
+
+void TelemetryRelay::onClientDisconnected()
+{
+    for (int i = 0; i < tcpClients.count(); ++i) {
+        if (tcpClients[i].socket == sender()) {
+            tcpClients[i].socket->deleteLater();
+            tcpClients.removeAt(i);
+            return;
+        }
+    }
+}
+
+/**
+ * Any datagram, even an empty one, subscribes its sender to the stream
+ */
+void TelemetryRelay::onDatagram()
+{
+    while (udpSocket->hasPendingDatagrams()) {
+        QByteArray datagram;
+        QHostAddress address;
+        quint16 port;
+        datagram.resize(udpSocket->pendingDatagramSize());
+        udpSocket->readDatagram(datagram.data(), datagram.size(), &address, &port);
+
+        int i = 0;
+        while (i < udpClients.count() && !(udpClients[i].address == address && udpClients[i].port == port))
+            ++i;
+        if (i == udpClients.count()) {
+            if (udpClients.count() >= MAX_UDP_CLIENTS)
+                udpClients.removeFirst();
+            UdpClient client;
+            client.address = address;
+            client.port = port;
+            udpClients.append(client);
+            i = udpClients.count() - 1;
+        }
+        udpClients[i].uplink.append(datagram);
+        extractFrames(udpClients[i].uplink);
+    }
+}
+
+/**
+ * Take the complete frames off the front of a client's uplink data, bytes
+ * that cannot start a frame are skipped
+ */
+void TelemetryRelay::extractFrames(QByteArray &uplink)
+{
+    int pos = 0;
+    while (uplink.size() - pos >= 4) {
+        const uchar *data = (const uchar *)uplink.constData() + pos;
+        int length = qFromLittleEndian<quint16>(data + 2) + 1; // checksum
+        if (data[0] != SYNC_VAL || (data[1] & TYPE_MASK) != TYPE_VER ||
+            length <= MIN_HEADER_LENGTH || length > MAX_PACKET_LENGTH) {
+            ++pos;
+            continue;
+        }
+        if (uplink.size() - pos < length)
+            break;
+        emit uplinkFrame(uplink.mid(pos, length));
+        pos += length;
+    }
+    uplink.remove(0, pos);
+}
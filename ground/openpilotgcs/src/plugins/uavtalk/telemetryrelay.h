@@ -0,0 +1,90 @@
+/**
+ ******************************************************************************
+ *
+ * @file       telemetryrelay.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVTalkPlugin UAVTalk Plugin
+ * @{
+ * @brief The UAVTalk protocol plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef TELEMETRYRELAY_H
+#define TELEMETRYRELAY_H
+
+#include <QObject>
+#include <QList>
+#include <QByteArray>
+#include <QtNetwork/QHostAddress>
+
+class QTcpServer;
+class QTcpSocket;
+class QUdpSocket;
+
+/**
+ * Shares the telemetry link with other programs (GCS instances, loggers).
+ * Every block read from the vehicle is handed to all clients, TCP clients
+ * connecting to the relay port and UDP clients that sent a datagram to it.
+ * A client that cannot keep up loses blocks instead of queueing without
+ * bound. What clients send is cut into whole UAVTalk frames and passed to
+ * uplinkFrame(), so their frames never interleave with the GCS's own.
+ */
+class TelemetryRelay: public QObject
+{
+    Q_OBJECT
+
+public:
+    static const quint16 DEFAULT_PORT = 9000;
+
+    TelemetryRelay(quint16 port = DEFAULT_PORT, QObject *parent = 0);
+    ~TelemetryRelay();
+
+    bool hasClients() const;
+    void downlink(const QByteArray &block);
+
+signals:
+    void uplinkFrame(const QByteArray &frame);
+
+private slots:
+    void onNewConnection();
+    void onClientReadyRead();
+    void onClientDisconnected();
+    void onDatagram();
+
+private:
+    struct TcpClient {
+        QTcpSocket *socket;
+        QByteArray uplink;
+        quint32 dropped;
+    };
+    struct UdpClient {
+        QHostAddress address;
+        quint16 port;
+        QByteArray uplink;
+    };
+
+    void extractFrames(QByteArray &uplink);
+
+    QTcpServer *server;
+    QUdpSocket *udpSocket;
+    QList<TcpClient> tcpClients;
+    QList<UdpClient> udpClients;
+};
+
+#endif // TELEMETRYRELAY_H
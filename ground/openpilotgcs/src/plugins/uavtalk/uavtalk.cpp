@@ -25,6 +25,7 @@
  * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
 #include "uavtalk.h"
+#include "telemetryrelay.h"
 #include <QtEndian>
 #include <QDebug>
 #include <extensionsystem/pluginmanager.h>
@@ -58,6 +59,136 @@ const quint8 UAVTalk::crc_table[256] = {
     0xde, 0xd9, 0xd0, 0xd7, 0xc2, 0xc5, 0xcc, 0xcb, 0xe6, 0xe1, 0xe8, 0xef, 0xfa, 0xfd, 0xf4, 0xf3
 };
 
+// Slice-by-8 tables, crc_table_slice[k-1][x] is the CRC of x followed by k zero bytes
+const quint8 UAVTalk::crc_table_slice[7][256] = {
+    {
+        0x00, 0x15, 0x2a, 0x3f, 0x54, 0x41, 0x7e, 0x6b, 0xa8, 0xbd, 0x82, 0x97, 0xfc, 0xe9, 0xd6, 0xc3,
+        0x57, 0x42, 0x7d, 0x68, 0x03, 0x16, 0x29, 0x3c, 0xff, 0xea, 0xd5, 0xc0, 0xab, 0xbe, 0x81, 0x94,
+        0xae, 0xbb, 0x84, 0x91, 0xfa, 0xef, 0xd0, 0xc5, 0x06, 0x13, 0x2c, 0x39, 0x52, 0x47, 0x78, 0x6d,
+        0xf9, 0xec, 0xd3, 0xc6, 0xad, 0xb8, 0x87, 0x92, 0x51, 0x44, 0x7b, 0x6e, 0x05, 0x10, 0x2f, 0x3a,
+        0x5b, 0x4e, 0x71, 0x64, 0x0f, 0x1a, 0x25, 0x30, 0xf3, 0xe6, 0xd9, 0xcc, 0xa7, 0xb2, 0x8d, 0x98,
+        0x0c, 0x19, 0x26, 0x33, 0x58, 0x4d, 0x72, 0x67, 0xa4, 0xb1, 0x8e, 0x9b, 0xf0, 0xe5, 0xda, 0xcf,
+        0xf5, 0xe0, 0xdf, 0xca, 0xa1, 0xb4, 0x8b, 0x9e, 0x5d, 0x48, 0x77, 0x62, 0x09, 0x1c, 0x23, 0x36,
+        0xa2, 0xb7, 0x88, 0x9d, 0xf6, 0xe3, 0xdc, 0xc9, 0x0a, 0x1f, 0x20, 0x35, 0x5e, 0x4b, 0x74, 0x61,
+        0xb6, 0xa3, 0x9c, 0x89, 0xe2, 0xf7, 0xc8, 0xdd, 0x1e, 0x0b, 0x34, 0x21, 0x4a, 0x5f, 0x60, 0x75,
+        0xe1, 0xf4, 0xcb, 0xde, 0xb5, 0xa0, 0x9f, 0x8a, 0x49, 0x5c, 0x63, 0x76, 0x1d, 0x08, 0x37, 0x22,
+        0x18, 0x0d, 0x32, 0x27, 0x4c, 0x59, 0x66, 0x73, 0xb0, 0xa5, 0x9a, 0x8f, 0xe4, 0xf1, 0xce, 0xdb,
+        0x4f, 0x5a, 0x65, 0x70, 0x1b, 0x0e, 0x31, 0x24, 0xe7, 0xf2, 0xcd, 0xd8, 0xb3, 0xa6, 0x99, 0x8c,
+        0xed, 0xf8, 0xc7, 0xd2, 0xb9, 0xac, 0x93, 0x86, 0x45, 0x50, 0x6f, 0x7a, 0x11, 0x04, 0x3b, 0x2e,
+        0xba, 0xaf, 0x90, 0x85, 0xee, 0xfb, 0xc4, 0xd1, 0x12, 0x07, 0x38, 0x2d, 0x46, 0x53, 0x6c, 0x79,
+        0x43, 0x56, 0x69, 0x7c, 0x17, 0x02, 0x3d, 0x28, 0xeb, 0xfe, 0xc1, 0xd4, 0xbf, 0xaa, 0x95, 0x80,
+        0x14, 0x01, 0x3e, 0x2b, 0x40, 0x55, 0x6a, 0x7f, 0xbc, 0xa9, 0x96, 0x83, 0xe8, 0xfd, 0xc2, 0xd7
+    },
+    {
+        0x00, 0x6b, 0xd6, 0xbd, 0xab, 0xc0, 0x7d, 0x16, 0x51, 0x3a, 0x87, 0xec, 0xfa, 0x91, 0x2c, 0x47,
+        0xa2, 0xc9, 0x74, 0x1f, 0x09, 0x62, 0xdf, 0xb4, 0xf3, 0x98, 0x25, 0x4e, 0x58, 0x33, 0x8e, 0xe5,
+        0x43, 0x28, 0x95, 0xfe, 0xe8, 0x83, 0x3e, 0x55, 0x12, 0x79, 0xc4, 0xaf, 0xb9, 0xd2, 0x6f, 0x04,
+        0xe1, 0x8a, 0x37, 0x5c, 0x4a, 0x21, 0x9c, 0xf7, 0xb0, 0xdb, 0x66, 0x0d, 0x1b, 0x70, 0xcd, 0xa6,
+        0x86, 0xed, 0x50, 0x3b, 0x2d, 0x46, 0xfb, 0x90, 0xd7, 0xbc, 0x01, 0x6a, 0x7c, 0x17, 0xaa, 0xc1,
+        0x24, 0x4f, 0xf2, 0x99, 0x8f, 0xe4, 0x59, 0x32, 0x75, 0x1e, 0xa3, 0xc8, 0xde, 0xb5, 0x08, 0x63,
+        0xc5, 0xae, 0x13, 0x78, 0x6e, 0x05, 0xb8, 0xd3, 0x94, 0xff, 0x42, 0x29, 0x3f, 0x54, 0xe9, 0x82,
+        0x67, 0x0c, 0xb1, 0xda, 0xcc, 0xa7, 0x1a, 0x71, 0x36, 0x5d, 0xe0, 0x8b, 0x9d, 0xf6, 0x4b, 0x20,
+        0x0b, 0x60, 0xdd, 0xb6, 0xa0, 0xcb, 0x76, 0x1d, 0x5a, 0x31, 0x8c, 0xe7, 0xf1, 0x9a, 0x27, 0x4c,
+        0xa9, 0xc2, 0x7f, 0x14, 0x02, 0x69, 0xd4, 0xbf, 0xf8, 0x93, 0x2e, 0x45, 0x53, 0x38, 0x85, 0xee,
+        0x48, 0x23, 0x9e, 0xf5, 0xe3, 0x88, 0x35, 0x5e, 0x19, 0x72, 0xcf, 0xa4, 0xb2, 0xd9, 0x64, 0x0f,
+        0xea, 0x81, 0x3c, 0x57, 0x41, 0x2a, 0x97, 0xfc, 0xbb, 0xd0, 0x6d, 0x06, 0x10, 0x7b, 0xc6, 0xad,
+        0x8d, 0xe6, 0x5b, 0x30, 0x26, 0x4d, 0xf0, 0x9b, 0xdc, 0xb7, 0x0a, 0x61, 0x77, 0x1c, 0xa1, 0xca,
+        0x2f, 0x44, 0xf9, 0x92, 0x84, 0xef, 0x52, 0x39, 0x7e, 0x15, 0xa8, 0xc3, 0xd5, 0xbe, 0x03, 0x68,
+        0xce, 0xa5, 0x18, 0x73, 0x65, 0x0e, 0xb3, 0xd8, 0x9f, 0xf4, 0x49, 0x22, 0x34, 0x5f, 0xe2, 0x89,
+        0x6c, 0x07, 0xba, 0xd1, 0xc7, 0xac, 0x11, 0x7a, 0x3d, 0x56, 0xeb, 0x80, 0x96, 0xfd, 0x40, 0x2b
+    },
+    {
+        0x00, 0x16, 0x2c, 0x3a, 0x58, 0x4e, 0x74, 0x62, 0xb0, 0xa6, 0x9c, 0x8a, 0xe8, 0xfe, 0xc4, 0xd2,
+        0x67, 0x71, 0x4b, 0x5d, 0x3f, 0x29, 0x13, 0x05, 0xd7, 0xc1, 0xfb, 0xed, 0x8f, 0x99, 0xa3, 0xb5,
+        0xce, 0xd8, 0xe2, 0xf4, 0x96, 0x80, 0xba, 0xac, 0x7e, 0x68, 0x52, 0x44, 0x26, 0x30, 0x0a, 0x1c,
+        0xa9, 0xbf, 0x85, 0x93, 0xf1, 0xe7, 0xdd, 0xcb, 0x19, 0x0f, 0x35, 0x23, 0x41, 0x57, 0x6d, 0x7b,
+        0x9b, 0x8d, 0xb7, 0xa1, 0xc3, 0xd5, 0xef, 0xf9, 0x2b, 0x3d, 0x07, 0x11, 0x73, 0x65, 0x5f, 0x49,
+        0xfc, 0xea, 0xd0, 0xc6, 0xa4, 0xb2, 0x88, 0x9e, 0x4c, 0x5a, 0x60, 0x76, 0x14, 0x02, 0x38, 0x2e,
+        0x55, 0x43, 0x79, 0x6f, 0x0d, 0x1b, 0x21, 0x37, 0xe5, 0xf3, 0xc9, 0xdf, 0xbd, 0xab, 0x91, 0x87,
+        0x32, 0x24, 0x1e, 0x08, 0x6a, 0x7c, 0x46, 0x50, 0x82, 0x94, 0xae, 0xb8, 0xda, 0xcc, 0xf6, 0xe0,
+        0x31, 0x27, 0x1d, 0x0b, 0x69, 0x7f, 0x45, 0x53, 0x81, 0x97, 0xad, 0xbb, 0xd9, 0xcf, 0xf5, 0xe3,
+        0x56, 0x40, 0x7a, 0x6c, 0x0e, 0x18, 0x22, 0x34, 0xe6, 0xf0, 0xca, 0xdc, 0xbe, 0xa8, 0x92, 0x84,
+        0xff, 0xe9, 0xd3, 0xc5, 0xa7, 0xb1, 0x8b, 0x9d, 0x4f, 0x59, 0x63, 0x75, 0x17, 0x01, 0x3b, 0x2d,
+        0x98, 0x8e, 0xb4, 0xa2, 0xc0, 0xd6, 0xec, 0xfa, 0x28, 0x3e, 0x04, 0x12, 0x70, 0x66, 0x5c, 0x4a,
+        0xaa, 0xbc, 0x86, 0x90, 0xf2, 0xe4, 0xde, 0xc8, 0x1a, 0x0c, 0x36, 0x20, 0x42, 0x54, 0x6e, 0x78,
+        0xcd, 0xdb, 0xe1, 0xf7, 0x95, 0x83, 0xb9, 0xaf, 0x7d, 0x6b, 0x51, 0x47, 0x25, 0x33, 0x09, 0x1f,
+        0x64, 0x72, 0x48, 0x5e, 0x3c, 0x2a, 0x10, 0x06, 0xd4, 0xc2, 0xf8, 0xee, 0x8c, 0x9a, 0xa0, 0xb6,
+        0x03, 0x15, 0x2f, 0x39, 0x5b, 0x4d, 0x77, 0x61, 0xb3, 0xa5, 0x9f, 0x89, 0xeb, 0xfd, 0xc7, 0xd1
+    },
+    {
+        0x00, 0x62, 0xc4, 0xa6, 0x8f, 0xed, 0x4b, 0x29, 0x19, 0x7b, 0xdd, 0xbf, 0x96, 0xf4, 0x52, 0x30,
+        0x32, 0x50, 0xf6, 0x94, 0xbd, 0xdf, 0x79, 0x1b, 0x2b, 0x49, 0xef, 0x8d, 0xa4, 0xc6, 0x60, 0x02,
+        0x64, 0x06, 0xa0, 0xc2, 0xeb, 0x89, 0x2f, 0x4d, 0x7d, 0x1f, 0xb9, 0xdb, 0xf2, 0x90, 0x36, 0x54,
+        0x56, 0x34, 0x92, 0xf0, 0xd9, 0xbb, 0x1d, 0x7f, 0x4f, 0x2d, 0x8b, 0xe9, 0xc0, 0xa2, 0x04, 0x66,
+        0xc8, 0xaa, 0x0c, 0x6e, 0x47, 0x25, 0x83, 0xe1, 0xd1, 0xb3, 0x15, 0x77, 0x5e, 0x3c, 0x9a, 0xf8,
+        0xfa, 0x98, 0x3e, 0x5c, 0x75, 0x17, 0xb1, 0xd3, 0xe3, 0x81, 0x27, 0x45, 0x6c, 0x0e, 0xa8, 0xca,
+        0xac, 0xce, 0x68, 0x0a, 0x23, 0x41, 0xe7, 0x85, 0xb5, 0xd7, 0x71, 0x13, 0x3a, 0x58, 0xfe, 0x9c,
+        0x9e, 0xfc, 0x5a, 0x38, 0x11, 0x73, 0xd5, 0xb7, 0x87, 0xe5, 0x43, 0x21, 0x08, 0x6a, 0xcc, 0xae,
+        0x97, 0xf5, 0x53, 0x31, 0x18, 0x7a, 0xdc, 0xbe, 0x8e, 0xec, 0x4a, 0x28, 0x01, 0x63, 0xc5, 0xa7,
+        0xa5, 0xc7, 0x61, 0x03, 0x2a, 0x48, 0xee, 0x8c, 0xbc, 0xde, 0x78, 0x1a, 0x33, 0x51, 0xf7, 0x95,
+        0xf3, 0x91, 0x37, 0x55, 0x7c, 0x1e, 0xb8, 0xda, 0xea, 0x88, 0x2e, 0x4c, 0x65, 0x07, 0xa1, 0xc3,
+        0xc1, 0xa3, 0x05, 0x67, 0x4e, 0x2c, 0x8a, 0xe8, 0xd8, 0xba, 0x1c, 0x7e, 0x57, 0x35, 0x93, 0xf1,
+        0x5f, 0x3d, 0x9b, 0xf9, 0xd0, 0xb2, 0x14, 0x76, 0x46, 0x24, 0x82, 0xe0, 0xc9, 0xab, 0x0d, 0x6f,
+        0x6d, 0x0f, 0xa9, 0xcb, 0xe2, 0x80, 0x26, 0x44, 0x74, 0x16, 0xb0, 0xd2, 0xfb, 0x99, 0x3f, 0x5d,
+        0x3b, 0x59, 0xff, 0x9d, 0xb4, 0xd6, 0x70, 0x12, 0x22, 0x40, 0xe6, 0x84, 0xad, 0xcf, 0x69, 0x0b,
+        0x09, 0x6b, 0xcd, 0xaf, 0x86, 0xe4, 0x42, 0x20, 0x10, 0x72, 0xd4, 0xb6, 0x9f, 0xfd, 0x5b, 0x39
+    },
+    {
+        0x00, 0x29, 0x52, 0x7b, 0xa4, 0x8d, 0xf6, 0xdf, 0x4f, 0x66, 0x1d, 0x34, 0xeb, 0xc2, 0xb9, 0x90,
+        0x9e, 0xb7, 0xcc, 0xe5, 0x3a, 0x13, 0x68, 0x41, 0xd1, 0xf8, 0x83, 0xaa, 0x75, 0x5c, 0x27, 0x0e,
+        0x3b, 0x12, 0x69, 0x40, 0x9f, 0xb6, 0xcd, 0xe4, 0x74, 0x5d, 0x26, 0x0f, 0xd0, 0xf9, 0x82, 0xab,
+        0xa5, 0x8c, 0xf7, 0xde, 0x01, 0x28, 0x53, 0x7a, 0xea, 0xc3, 0xb8, 0x91, 0x4e, 0x67, 0x1c, 0x35,
+        0x76, 0x5f, 0x24, 0x0d, 0xd2, 0xfb, 0x80, 0xa9, 0x39, 0x10, 0x6b, 0x42, 0x9d, 0xb4, 0xcf, 0xe6,
+        0xe8, 0xc1, 0xba, 0x93, 0x4c, 0x65, 0x1e, 0x37, 0xa7, 0x8e, 0xf5, 0xdc, 0x03, 0x2a, 0x51, 0x78,
+        0x4d, 0x64, 0x1f, 0x36, 0xe9, 0xc0, 0xbb, 0x92, 0x02, 0x2b, 0x50, 0x79, 0xa6, 0x8f, 0xf4, 0xdd,
+        0xd3, 0xfa, 0x81, 0xa8, 0x77, 0x5e, 0x25, 0x0c, 0x9c, 0xb5, 0xce, 0xe7, 0x38, 0x11, 0x6a, 0x43,
+        0xec, 0xc5, 0xbe, 0x97, 0x48, 0x61, 0x1a, 0x33, 0xa3, 0x8a, 0xf1, 0xd8, 0x07, 0x2e, 0x55, 0x7c,
+        0x72, 0x5b, 0x20, 0x09, 0xd6, 0xff, 0x84, 0xad, 0x3d, 0x14, 0x6f, 0x46, 0x99, 0xb0, 0xcb, 0xe2,
+        0xd7, 0xfe, 0x85, 0xac, 0x73, 0x5a, 0x21, 0x08, 0x98, 0xb1, 0xca, 0xe3, 0x3c, 0x15, 0x6e, 0x47,
+        0x49, 0x60, 0x1b, 0x32, 0xed, 0xc4, 0xbf, 0x96, 0x06, 0x2f, 0x54, 0x7d, 0xa2, 0x8b, 0xf0, 0xd9,
+        0x9a, 0xb3, 0xc8, 0xe1, 0x3e, 0x17, 0x6c, 0x45, 0xd5, 0xfc, 0x87, 0xae, 0x71, 0x58, 0x23, 0x0a,
+        0x04, 0x2d, 0x56, 0x7f, 0xa0, 0x89, 0xf2, 0xdb, 0x4b, 0x62, 0x19, 0x30, 0xef, 0xc6, 0xbd, 0x94,
+        0xa1, 0x88, 0xf3, 0xda, 0x05, 0x2c, 0x57, 0x7e, 0xee, 0xc7, 0xbc, 0x95, 0x4a, 0x63, 0x18, 0x31,
+        0x3f, 0x16, 0x6d, 0x44, 0x9b, 0xb2, 0xc9, 0xe0, 0x70, 0x59, 0x22, 0x0b, 0xd4, 0xfd, 0x86, 0xaf
+    },
+    {
+        0x00, 0xdf, 0xb9, 0x66, 0x75, 0xaa, 0xcc, 0x13, 0xea, 0x35, 0x53, 0x8c, 0x9f, 0x40, 0x26, 0xf9,
+        0xd3, 0x0c, 0x6a, 0xb5, 0xa6, 0x79, 0x1f, 0xc0, 0x39, 0xe6, 0x80, 0x5f, 0x4c, 0x93, 0xf5, 0x2a,
+        0xa1, 0x7e, 0x18, 0xc7, 0xd4, 0x0b, 0x6d, 0xb2, 0x4b, 0x94, 0xf2, 0x2d, 0x3e, 0xe1, 0x87, 0x58,
+        0x72, 0xad, 0xcb, 0x14, 0x07, 0xd8, 0xbe, 0x61, 0x98, 0x47, 0x21, 0xfe, 0xed, 0x32, 0x54, 0x8b,
+        0x45, 0x9a, 0xfc, 0x23, 0x30, 0xef, 0x89, 0x56, 0xaf, 0x70, 0x16, 0xc9, 0xda, 0x05, 0x63, 0xbc,
+        0x96, 0x49, 0x2f, 0xf0, 0xe3, 0x3c, 0x5a, 0x85, 0x7c, 0xa3, 0xc5, 0x1a, 0x09, 0xd6, 0xb0, 0x6f,
+        0xe4, 0x3b, 0x5d, 0x82, 0x91, 0x4e, 0x28, 0xf7, 0x0e, 0xd1, 0xb7, 0x68, 0x7b, 0xa4, 0xc2, 0x1d,
+        0x37, 0xe8, 0x8e, 0x51, 0x42, 0x9d, 0xfb, 0x24, 0xdd, 0x02, 0x64, 0xbb, 0xa8, 0x77, 0x11, 0xce,
+        0x8a, 0x55, 0x33, 0xec, 0xff, 0x20, 0x46, 0x99, 0x60, 0xbf, 0xd9, 0x06, 0x15, 0xca, 0xac, 0x73,
+        0x59, 0x86, 0xe0, 0x3f, 0x2c, 0xf3, 0x95, 0x4a, 0xb3, 0x6c, 0x0a, 0xd5, 0xc6, 0x19, 0x7f, 0xa0,
+        0x2b, 0xf4, 0x92, 0x4d, 0x5e, 0x81, 0xe7, 0x38, 0xc1, 0x1e, 0x78, 0xa7, 0xb4, 0x6b, 0x0d, 0xd2,
+        0xf8, 0x27, 0x41, 0x9e, 0x8d, 0x52, 0x34, 0xeb, 0x12, 0xcd, 0xab, 0x74, 0x67, 0xb8, 0xde, 0x01,
+        0xcf, 0x10, 0x76, 0xa9, 0xba, 0x65, 0x03, 0xdc, 0x25, 0xfa, 0x9c, 0x43, 0x50, 0x8f, 0xe9, 0x36,
+        0x1c, 0xc3, 0xa5, 0x7a, 0x69, 0xb6, 0xd0, 0x0f, 0xf6, 0x29, 0x4f, 0x90, 0x83, 0x5c, 0x3a, 0xe5,
+        0x6e, 0xb1, 0xd7, 0x08, 0x1b, 0xc4, 0xa2, 0x7d, 0x84, 0x5b, 0x3d, 0xe2, 0xf1, 0x2e, 0x48, 0x97,
+        0xbd, 0x62, 0x04, 0xdb, 0xc8, 0x17, 0x71, 0xae, 0x57, 0x88, 0xee, 0x31, 0x22, 0xfd, 0x9b, 0x44
+    },
+    {
+        0x00, 0x13, 0x26, 0x35, 0x4c, 0x5f, 0x6a, 0x79, 0x98, 0x8b, 0xbe, 0xad, 0xd4, 0xc7, 0xf2, 0xe1,
+        0x37, 0x24, 0x11, 0x02, 0x7b, 0x68, 0x5d, 0x4e, 0xaf, 0xbc, 0x89, 0x9a, 0xe3, 0xf0, 0xc5, 0xd6,
+        0x6e, 0x7d, 0x48, 0x5b, 0x22, 0x31, 0x04, 0x17, 0xf6, 0xe5, 0xd0, 0xc3, 0xba, 0xa9, 0x9c, 0x8f,
+        0x59, 0x4a, 0x7f, 0x6c, 0x15, 0x06, 0x33, 0x20, 0xc1, 0xd2, 0xe7, 0xf4, 0x8d, 0x9e, 0xab, 0xb8,
+        0xdc, 0xcf, 0xfa, 0xe9, 0x90, 0x83, 0xb6, 0xa5, 0x44, 0x57, 0x62, 0x71, 0x08, 0x1b, 0x2e, 0x3d,
+        0xeb, 0xf8, 0xcd, 0xde, 0xa7, 0xb4, 0x81, 0x92, 0x73, 0x60, 0x55, 0x46, 0x3f, 0x2c, 0x19, 0x0a,
+        0xb2, 0xa1, 0x94, 0x87, 0xfe, 0xed, 0xd8, 0xcb, 0x2a, 0x39, 0x0c, 0x1f, 0x66, 0x75, 0x40, 0x53,
+        0x85, 0x96, 0xa3, 0xb0, 0xc9, 0xda, 0xef, 0xfc, 0x1d, 0x0e, 0x3b, 0x28, 0x51, 0x42, 0x77, 0x64,
+        0xbf, 0xac, 0x99, 0x8a, 0xf3, 0xe0, 0xd5, 0xc6, 0x27, 0x34, 0x01, 0x12, 0x6b, 0x78, 0x4d, 0x5e,
+        0x88, 0x9b, 0xae, 0xbd, 0xc4, 0xd7, 0xe2, 0xf1, 0x10, 0x03, 0x36, 0x25, 0x5c, 0x4f, 0x7a, 0x69,
+        0xd1, 0xc2, 0xf7, 0xe4, 0x9d, 0x8e, 0xbb, 0xa8, 0x49, 0x5a, 0x6f, 0x7c, 0x05, 0x16, 0x23, 0x30,
+        0xe6, 0xf5, 0xc0, 0xd3, 0xaa, 0xb9, 0x8c, 0x9f, 0x7e, 0x6d, 0x58, 0x4b, 0x32, 0x21, 0x14, 0x07,
+        0x63, 0x70, 0x45, 0x56, 0x2f, 0x3c, 0x09, 0x1a, 0xfb, 0xe8, 0xdd, 0xce, 0xb7, 0xa4, 0x91, 0x82,
+        0x54, 0x47, 0x72, 0x61, 0x18, 0x0b, 0x3e, 0x2d, 0xcc, 0xdf, 0xea, 0xf9, 0x80, 0x93, 0xa6, 0xb5,
+        0x0d, 0x1e, 0x2b, 0x38, 0x41, 0x52, 0x67, 0x74, 0x95, 0x86, 0xb3, 0xa0, 0xd9, 0xca, 0xff, 0xec,
+        0x3a, 0x29, 0x1c, 0x0f, 0x76, 0x65, 0x50, 0x43, 0xa2, 0xb1, 0x84, 0x97, 0xee, 0xfd, 0xc8, 0xdb
+    }
+};
+
 
 /**
  * Constructor
@@ -70,25 +201,20 @@ UAVTalk::UAVTalk(QIODevice* iodev, UAVObjectManager* objMngr)
 
     rxState = STATE_SYNC;
     rxPacketLength = 0;
+    rxTime = 0;
+    maxMultiLength = 0;
 
     mutex = new QMutex(QMutex::Recursive);
 
     memset(&stats, 0, sizeof(ComStats));
 
     connect(io, SIGNAL(readyRead()), this, SLOT(processInputStream()));
+    // There are no general settings when running headless (e.g. benchmarks)
     ExtensionSystem::PluginManager *pm = ExtensionSystem::PluginManager::instance();
-    Core::Internal::GeneralSettings * settings=pm->getObject<Core::Internal::GeneralSettings>();
-    useUDPMirror=settings->useUDPMirror();
-    qDebug()<<"USE UDP:::::::::::."<<useUDPMirror;
-    if(useUDPMirror)
-    {
-        udpSocketTx=new QUdpSocket(this);
-        udpSocketRx=new QUdpSocket(this);
-        udpSocketTx->bind(9000);
-        udpSocketRx->connectToHost(QHostAddress::LocalHost,9000);
-        connect(udpSocketTx,SIGNAL(readyRead()),this,SLOT(dummyUDPRead()));
-        connect(udpSocketRx,SIGNAL(readyRead()),this,SLOT(dummyUDPRead()));
-    }
+    Core::Internal::GeneralSettings * settings = pm ? pm->getObject<Core::Internal::GeneralSettings>() : 0;
+    relay = 0;
+    if (settings && settings->useUDPMirror())
+        startRelay(TelemetryRelay::DEFAULT_PORT);
 }
 
 UAVTalk::~UAVTalk()
@@ -99,6 +225,17 @@ UAVTalk::~UAVTalk()
 }
 
 
+/**
+ * Share the link with programs connecting to \a port, see TelemetryRelay
+ */
+void UAVTalk::startRelay(quint16 port)
+{
+    if (relay)
+        return;
+    relay = new TelemetryRelay(port, this);
+    connect(relay, SIGNAL(uplinkFrame(QByteArray)), this, SLOT(relayUplink(QByteArray)));
+}
+
 /**
  * Reset the statistics counters
  */
@@ -117,30 +254,64 @@ UAVTalk::ComStats UAVTalk::getStats()
     return stats;
 }
 
+/**
+ * Get the counters of every object which was sent or received on the link.
+ * They are never reset, rates are taken from the difference of two calls.
+ */
+QHash<quint32, UAVTalk::ObjectStats> UAVTalk::getObjectStats()
+{
+    QMutexLocker locker(mutex);
+    return objStats;
+}
+
 /**
  * Called each time there are data in the input buffer
  */
 void UAVTalk::processInputStream()
 {
-    quint8 tmp;
-
     if (io && io->isReadable()) {
         while (io->bytesAvailable() > 0)
         {
-            io->read((char*)&tmp, 1);
-            processInputByte(tmp);
+            // Drain the device in blocks rather than one virtual read() per byte
+            qint64 toRead = qMin<qint64>(io->bytesAvailable(), RX_BLOCK_SIZE);
+            if (relay && relay->hasClients())
+            {
+                // A block of its own, so the relay clients share it instead of copying
+                QByteArray block = io->read(toRead);
+                if (block.isEmpty())
+                    break;
+                rxTime = QDateTime::currentMSecsSinceEpoch();
+                processInputBlock((const quint8*)block.constData(), block.size());
+                relay->downlink(block);
+                continue;
+            }
+            if (rxInputBuffer.size() < toRead)
+                rxInputBuffer.resize(RX_BLOCK_SIZE);
+            qint64 bytesRead = io->read(rxInputBuffer.data(), toRead);
+            if (bytesRead <= 0)
+                break;
+            // Stamp the objects with the read time, not the time their signals reach the GUI
+            rxTime = QDateTime::currentMSecsSinceEpoch();
+            processInputBlock((const quint8*)rxInputBuffer.constData(), bytesRead);
         }
     }
 }
 
-void UAVTalk::dummyUDPRead()
+/**
+ * Send a frame from a relay client to the vehicle. Frames are written whole
+ * and under the mutex, so they never split one of ours.
+ */
+void UAVTalk::relayUplink(const QByteArray &frame)
 {
-    QUdpSocket *socket=qobject_cast<QUdpSocket*>(sender());
-    QByteArray junk;
-    while(socket->hasPendingDatagrams())
+    QMutexLocker locker(mutex);
+    if (io && io->isWritable() && io->bytesToWrite() < TX_BUFFER_SIZE)
+    {
+        io->write(frame);
+        stats.txBytes += frame.size();
+    }
+    else
     {
-        junk.resize(socket->pendingDatagramSize());
-        socket->readDatagram(junk.data(),junk.size());
+        ++stats.txErrors;
     }
 }
 
@@ -177,21 +348,119 @@ bool UAVTalk::sendObject(UAVObject* obj, bool acked, bool allInstances)
     }
 }
 
+/**
+ * Send several objects unacknowledged, packed into as few multi-object frames
+ * as they fit in. Only for boards that advertise CAPABILITY_MULTIOBJECT.
+ * \param[in] objs Objects to send, each one as its current instance
+ * \return Success (true), Failure (false)
+ */
+bool UAVTalk::sendObjects(const QList<UAVObject*>& objs)
+{
+    QMutexLocker locker(mutex);
+    if (io.isNull())
+        return false;
+
+    // The board takes packets up to its largest object, which is the largest
+    // of the definitions both sides are built from
+    if (maxMultiLength == 0)
+    {
+        qint32 largest = 0;
+        foreach (QList<UAVDataObject*> list, objMngr->getDataObjects())
+        {
+            if (!list.isEmpty())
+                largest = qMax(largest, (qint32)list.first()->getNumBytes());
+        }
+        maxMultiLength = qMin(MAX_HEADER_LENGTH + largest + 1, MAX_HEADER_LENGTH + MAX_PAYLOAD_LENGTH);
+    }
+
+    bool success = true;
+    qint32 length = 4; // sync(1), type (1), size(2)
+    quint32 objects = 0;
+    quint32 objectBytes = 0;
+    foreach (UAVObject* obj, objs)
+    {
+        qint32 dataLength = obj->getNumBytes();
+        qint32 recordLength = (obj->isSingleInstance() ? 4 : 6) + dataLength;
+        // Flush the frame when the record does not fit, or before an object
+        // too large for a frame is sent on its own
+        if (objects > 0 && (length + recordLength > maxMultiLength || 4 + recordLength > maxMultiLength))
+        {
+            success &= transmitMultiObject(length, objects, objectBytes);
+            length = 4;
+            objects = 0;
+            objectBytes = 0;
+        }
+        if (4 + recordLength > maxMultiLength)
+        {
+            success &= transmitSingleObject(obj, TYPE_OBJ, false);
+            continue;
+        }
+
+        qToLittleEndian<quint32>(obj->getObjID(), &txBuffer[length]);
+        length += 4;
+        if (!obj->isSingleInstance())
+        {
+            qToLittleEndian<quint16>(obj->getInstID(), &txBuffer[length]);
+            length += 2;
+        }
+        if (dataLength > 0 && !obj->pack(&txBuffer[length]))
+        {
+            success = false;
+            length -= recordLength - dataLength;
+            continue;
+        }
+        length += dataLength;
+        ++objects;
+        objectBytes += dataLength;
+        ObjectStats& objStat = objStats[obj->getObjID()];
+        ++objStat.txPackets;
+        objStat.txBytes += recordLength;
+    }
+    if (objects > 0)
+        success &= transmitMultiObject(length, objects, objectBytes);
+    return success;
+}
+
 /**
  * Cancel a pending transaction
  */
-void UAVTalk::cancelTransaction(UAVObject* obj)
+void UAVTalk::cancelTransaction(UAVObject* obj, bool allInstances)
 {
     QMutexLocker locker(mutex);
-    quint32 objId = obj->getObjID();
     if(io.isNull())
         return;
-    QMap<quint32, Transaction*>::iterator itr = transMap.find(objId);
-    if ( itr != transMap.end() )
+    delete transMap.take(transactionKey(obj, allInstances));
+}
+
+/**
+ * Key of a transaction, the object ID followed by the instance ID. Transactions on
+ * different instances of one object are independent, an all instances transaction
+ * uses ALL_INSTANCES and sorts after every instance of its object.
+ */
+quint64 UAVTalk::transactionKey(UAVObject* obj, bool allInstances)
+{
+    return ((quint64)obj->getObjID() << 16) | (allInstances ? ALL_INSTANCES : obj->getInstID());
+}
+
+/**
+ * Remove the transaction an ack or nack for obj answers, either the one on that
+ * instance or an all instances transaction on the object.
+ * eturn The transaction or NULL if none is pending
+ */
+UAVTalk::Transaction* UAVTalk::takeTransaction(UAVObject* obj)
+{
+    QMap<quint64, Transaction*>::iterator itr = transMap.find(transactionKey(obj, false));
+    if ( itr == transMap.end() )
+    {
+        itr = transMap.find(transactionKey(obj, true));
+    }
+    if ( itr == transMap.end() )
     {
-        transMap.remove(objId);
-	delete itr.value();
+        return NULL;
     }
+    Transaction* trans = itr.value();
+    transMap.erase(itr);
+    return trans;
 }
 
 /**
@@ -211,10 +480,20 @@ bool UAVTalk::objectTransaction(UAVObject* obj, quint8 type, bool allInstances)
     {
         if ( transmitObject(obj, type, allInstances) )
         {
-	    Transaction *trans = new Transaction();
-	    trans->obj = obj;
-	    trans->allInstances = allInstances;
-            transMap.insert(obj->getObjID(), trans);
+            // A transaction still open for the object is being retried
+            quint64 key = transactionKey(obj, allInstances);
+            Transaction *trans = transMap.value(key);
+            if ( trans != NULL )
+            {
+                ++objStats[obj->getObjID()].retries;
+            }
+            else
+            {
+                trans = new Transaction();
+                trans->obj = obj;
+                trans->allInstances = allInstances;
+                transMap.insert(key, trans);
+            }
             return true;
         }
         else
@@ -244,9 +523,6 @@ bool UAVTalk::processInputByte(quint8 rxbyte)
 
     rxPacketLength++;   // update packet byte count
 
-    if(useUDPMirror)
-        rxDataArray.append(rxbyte);
-
     // Receive state machine
     switch (rxState)
     {
@@ -263,12 +539,6 @@ bool UAVTalk::processInputByte(quint8 rxbyte)
 
             rxPacketLength = 1;
 
-            if(useUDPMirror)
-            {
-                rxDataArray.clear();
-                rxDataArray.append(rxbyte);
-            }
-
             rxState = STATE_TYPE;
             UAVTALK_QXTLOG_DEBUG("UAVTalk: Sync->Type");
             break;
@@ -317,6 +587,18 @@ bool UAVTalk::processInputByte(quint8 rxbyte)
             }
 
             rxCount = 0;
+
+            // Multi-object frames carry their object IDs inside the payload
+            if (rxType == TYPE_OBJ_MULTI)
+            {
+                rxObjId = 0;
+                rxInstId = 0;
+                rxLength = packetSize - rxPacketLength;
+                rxState = STATE_DATA;
+                UAVTALK_QXTLOG_DEBUG("UAVTalk: Size->Data (multi)");
+                break;
+            }
+
             rxState = STATE_OBJID;
             UAVTALK_QXTLOG_DEBUG("UAVTalk: Size->ObjID");
             break;
@@ -351,6 +633,20 @@ bool UAVTalk::processInputByte(quint8 rxbyte)
                     rxLength = 0;
                     rxInstanceLength = 0;
                 }
+                else if (rxType == TYPE_OBJ_DELTA)
+                {
+                    // Only the changed fields are sent, the size tells how many
+                    rxInstanceLength = (rxObj->isSingleInstance() ? 0 : 2);
+                    qint32 deltaLength = (qint32)packetSize - rxPacketLength - rxInstanceLength;
+                    if (deltaLength < DELTA_MASK_LENGTH || deltaLength > (qint32)rxObj->getNumBytes() + DELTA_MASK_LENGTH)
+                    {
+                        stats.rxErrors++;
+                        rxState = STATE_SYNC;
+                        UAVTALK_QXTLOG_DEBUG("UAVTalk: ObjID->Sync (delta length)");
+                        break;
+                    }
+                    rxLength = deltaLength;
+                }
                 else
                 {
                     rxLength = rxObj->getNumBytes();
@@ -479,13 +775,19 @@ bool UAVTalk::processInputByte(quint8 rxbyte)
             }
 
             mutex->lock();
-                receiveObject(rxType, rxObjId, rxInstId, rxBuffer, rxLength);
-                if(useUDPMirror)
+                if (rxType == TYPE_OBJ_MULTI)
+                {
+                    receiveMultiObject(rxBuffer, rxLength);
+                }
+                else
                 {
-                    udpSocketTx->writeDatagram(rxDataArray,QHostAddress::LocalHost,udpSocketRx->localPort());
+                    receiveObject(rxType, rxObjId, rxInstId, rxBuffer, rxLength);
+                    stats.rxObjectBytes += rxLength;
+                    stats.rxObjects++;
+                    ObjectStats& objStat = objStats[rxObjId];
+                    ++objStat.rxPackets;
+                    objStat.rxBytes += rxPacketLength;
                 }
-                stats.rxObjectBytes += rxLength;
-                stats.rxObjects++;
             mutex->unlock();
 
             rxState = STATE_SYNC;
@@ -502,6 +804,59 @@ bool UAVTalk::processInputByte(quint8 rxbyte)
     return true;
 }
 
+/**
+ * Process a block of bytes from the telemetry stream.
+ * The states which only consume bytes (hunting for sync and collecting the
+ * payload) are handled a run at a time, everything else goes through the
+ * byte-wise state machine so stats and error handling stay identical.
+ * \param[in] data Received bytes
+ * \param[in] length Number of bytes in \a data
+ */
+void UAVTalk::processInputBlock(const quint8* data, qint64 length)
+{
+    const quint8* end = data + length;
+
+    while (data < end)
+    {
+        if (rxState == STATE_SYNC)
+        {
+            // Skip everything up to the next sync byte in one go
+            const quint8* sync = (const quint8*)memchr(data, SYNC_VAL, end - data);
+            qint32 skip = (sync ? sync : end) - data;
+            if (skip > 0)
+            {
+                stats.rxBytes += skip;
+                rxPacketLength += skip;
+                data += skip;
+                continue;
+            }
+        }
+        else if (rxState == STATE_DATA)
+        {
+            // Copy as much of the payload as is available
+            qint32 count = qMin<qint64>(rxLength - rxCount, end - data);
+            if (count > 0)
+            {
+                stats.rxBytes += count;
+                rxPacketLength += count;
+                rxCS = updateCRC(rxCS, data, count);
+                memcpy(&rxBuffer[rxCount], data, count);
+                rxCount += count;
+                data += count;
+                if (rxCount >= rxLength)
+                {
+                    rxState = STATE_CS;
+                    UAVTALK_QXTLOG_DEBUG("UAVTalk: Data->CSum");
+                    rxCount = 0;
+                }
+                continue;
+            }
+        }
+
+        processInputByte(*data++);
+    }
+}
+
 /**
  * Receive an object. This function process objects received through the telemetry stream.
  * \param[in] type Type of received message (TYPE_OBJ, TYPE_OBJ_REQ, TYPE_OBJ_ACK, TYPE_ACK, TYPE_NACK)
@@ -541,6 +896,17 @@ bool UAVTalk::receiveObject(quint8 type, quint32 objId, quint16 instId, quint8*
             error = true;
         }
         break;
+    case TYPE_OBJ_DELTA:
+        // All instances, not allowed for OBJ_DELTA messages
+        if (!allInstances)
+        {
+            error = !receiveDeltaObject(objId, instId, data, length);
+        }
+        else
+        {
+            error = true;
+        }
+        break;
     case TYPE_OBJ_ACK:
         // All instances, not allowed for OBJ_ACK messages
         if (!allInstances)
@@ -594,6 +960,7 @@ bool UAVTalk::receiveObject(quint8 type, quint32 objId, quint16 instId, quint8*
             // Check if object exists:
             if (obj != NULL)
             {
+                ++objStats[objId].nacks;
                 updateNack(obj);
             }
             else
@@ -626,6 +993,89 @@ bool UAVTalk::receiveObject(quint8 type, quint32 objId, quint16 instId, quint8*
     return !error;
 }
 
+/**
+ * Receive a multi-object frame. The payload is a sequence of records, each one
+ * an object ID, an instance ID (multi instance objects only) and the object data.
+ * Records are applied as TYPE_OBJ updates. Parsing stops at the first unknown
+ * object since its length, and so the start of the next record, is unknown.
+ * \param[in] data Frame payload
+ * \param[in] length Payload length
+ * \return Success (true), Failure (false)
+ */
+bool UAVTalk::receiveMultiObject(quint8* data, qint32 length)
+{
+    qint32 offset = 0;
+
+    while (offset < length)
+    {
+        if (length - offset < 4)
+        {
+            stats.rxErrors++;
+            return false;
+        }
+        quint32 objId = qFromLittleEndian<quint32>(&data[offset]);
+        UAVObject* tobj = objMngr->getObject(objId);
+        if (tobj == NULL)
+        {
+            stats.rxErrors++;
+            return false;
+        }
+        qint32 instLength = (tobj->isSingleInstance() ? 0 : 2);
+        qint32 dataLength = tobj->getNumBytes();
+        if (length - offset - 4 < instLength + dataLength)
+        {
+            stats.rxErrors++;
+            return false;
+        }
+        offset += 4;
+        quint16 instId = 0;
+        if (instLength > 0)
+        {
+            instId = qFromLittleEndian<quint16>(&data[offset]);
+            offset += instLength;
+        }
+
+        receiveObject(TYPE_OBJ, objId, instId, &data[offset], dataLength);
+        offset += dataLength;
+
+        stats.rxObjectBytes += dataLength;
+        stats.rxObjects++;
+        ObjectStats& objStat = objStats[objId];
+        ++objStat.rxPackets;
+        objStat.rxBytes += 4 + instLength + dataLength;
+    }
+
+    return true;
+}
+
+/**
+ * Receive a delta update, the data of the changed fields followed by the
+ * mask of those fields. Deltas for instances not seen yet are dropped, the
+ * next full update of the object creates them.
+ * \param[in] objId Object ID
+ * \param[in] instId Instance ID
+ * \param[in] data Payload
+ * \param[in] length Payload length, including the mask
+ * \return Success (true), Failure (false)
+ */
+bool UAVTalk::receiveDeltaObject(quint32 objId, quint16 instId, quint8* data, qint32 length)
+{
+    UAVObject* obj = objMngr->getObject(objId, instId);
+    if (obj == NULL || length < DELTA_MASK_LENGTH)
+    {
+        return false;
+    }
+    qint32 dataLength = length - DELTA_MASK_LENGTH;
+    quint32 fieldMask = qFromLittleEndian<quint32>(&data[dataLength]);
+    obj->setUpdateTime(rxTime);
+    if (obj->unpackFields(data, dataLength, fieldMask) < 0)
+    {
+        return false;
+    }
+    updateAck(obj);
+    return true;
+}
+
 /**
  * Update the data of an object from a byte array (unpack).
  * If the object instance could not be found in the list, then a
@@ -656,12 +1106,14 @@ UAVObject* UAVTalk::updateObject(quint32 objId, quint16 instId, quint8* data)
         {
             return NULL;
         }
+        instobj->setUpdateTime(rxTime);
         instobj->unpack(data);
         return instobj;
     }
     else
     {
         // Unpack data into object instance
+        obj->setUpdateTime(rxTime);
         obj->unpack(data);
         return obj;
     }
@@ -675,12 +1127,10 @@ void UAVTalk::updateNack(UAVObject* obj)
     Q_ASSERT(obj);
     if ( ! obj )
         return;
-    quint32 objId = obj->getObjID();
-    QMap<quint32, Transaction*>::iterator itr = transMap.find(objId);
-    if ( itr != transMap.end() && (itr.value()->obj->getInstID() == obj->getInstID() || itr.value()->allInstances))
+    Transaction* trans = takeTransaction(obj);
+    if ( trans != NULL )
     {
-        transMap.remove(objId);
-	delete itr.value();
+        delete trans;
         emit transactionCompleted(obj, false);
     }
 }
@@ -691,12 +1141,10 @@ void UAVTalk::updateNack(UAVObject* obj)
  */
 void UAVTalk::updateAck(UAVObject* obj)
 {
-    quint32 objId = obj->getObjID();
-    QMap<quint32, Transaction*>::iterator itr = transMap.find(objId);
-    if ( itr != transMap.end() && (itr.value()->obj->getInstID() == obj->getInstID() || itr.value()->allInstances))
+    Transaction* trans = takeTransaction(obj);
+    if ( trans != NULL )
     {
-        transMap.remove(objId);
-	delete itr.value();
+        delete trans;
         emit transactionCompleted(obj, true);
     }
 }
@@ -779,10 +1227,6 @@ bool UAVTalk::transmitNack(quint32 objId)
     if (io && io->isWritable() && io->bytesToWrite() < TX_BUFFER_SIZE )
     {
         io->write((const char*)txBuffer, dataOffset+CHECKSUM_LENGTH);
-        if(useUDPMirror)
-        {
-            udpSocketRx->writeDatagram((const char*)txBuffer,dataOffset+CHECKSUM_LENGTH,QHostAddress::LocalHost,udpSocketTx->localPort());
-        }
     }
     else
     {
@@ -873,10 +1317,6 @@ bool UAVTalk::transmitSingleObject(UAVObject* obj, quint8 type, bool allInstance
     if (!io.isNull() && io->isWritable() && io->bytesToWrite() < TX_BUFFER_SIZE )
     {
         io->write((const char*)txBuffer, dataOffset+length+CHECKSUM_LENGTH);
-        if(useUDPMirror)
-        {
-            udpSocketRx->writeDatagram((const char*)txBuffer,dataOffset+length+CHECKSUM_LENGTH,QHostAddress::LocalHost,udpSocketTx->localPort());
-        }
     }
     else
     {
@@ -888,11 +1328,46 @@ bool UAVTalk::transmitSingleObject(UAVObject* obj, quint8 type, bool allInstance
     ++stats.txObjects;
     stats.txBytes += dataOffset+length+CHECKSUM_LENGTH;
     stats.txObjectBytes += length;
+    ObjectStats& objStat = objStats[objId];
+    ++objStat.txPackets;
+    objStat.txBytes += dataOffset+length+CHECKSUM_LENGTH;
 
     // Done
     return true;
 }
 
+/**
+ * Send the multi-object frame assembled in the transmit buffer.
+ * \param[in] length Frame length, header and records
+ * \param[in] objects Number of records
+ * \param[in] objectBytes Object data in the records
+ * \return Success (true), Failure (false)
+ */
+bool UAVTalk::transmitMultiObject(qint32 length, quint32 objects, quint32 objectBytes)
+{
+    txBuffer[0] = SYNC_VAL;
+    txBuffer[1] = TYPE_OBJ_MULTI;
+    qToLittleEndian<quint16>(length, &txBuffer[2]);
+    txBuffer[length] = updateCRC(0, txBuffer, length);
+
+    // Send buffer, check that the transmit backlog does not grow above limit
+    if (!io.isNull() && io->isWritable() && io->bytesToWrite() < TX_BUFFER_SIZE )
+    {
+        io->write((const char*)txBuffer, length+CHECKSUM_LENGTH);
+    }
+    else
+    {
+        ++stats.txErrors;
+        return false;
+    }
+
+    // Update stats
+    stats.txObjects += objects;
+    stats.txBytes += length+CHECKSUM_LENGTH;
+    stats.txObjectBytes += objectBytes;
+    return true;
+}
+
 /**
  * Update the crc value with new data.
  *
@@ -917,7 +1392,22 @@ quint8 UAVTalk::updateCRC(quint8 crc, const quint8 data)
 }
 quint8 UAVTalk::updateCRC(quint8 crc, const quint8* data, qint32 length)
 {
-    while (length--)
+    // Process 8 bytes per step, the CRC only ever depends on the first byte
+    // of each slice so the remaining bytes can be looked up independently
+    while (length >= 8)
+    {
+        crc = crc_table_slice[6][crc ^ data[0]] ^
+              crc_table_slice[5][data[1]] ^
+              crc_table_slice[4][data[2]] ^
+              crc_table_slice[3][data[3]] ^
+              crc_table_slice[2][data[4]] ^
+              crc_table_slice[1][data[5]] ^
+              crc_table_slice[0][data[6]] ^
+              crc_table[data[7]];
+        data += 8;
+        length -= 8;
+    }
+    while (length-- > 0)
         crc = crc_table[crc ^ *data++];
     return crc;
 }
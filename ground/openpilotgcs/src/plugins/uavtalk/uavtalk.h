@@ -32,10 +32,12 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <QMap>
+#include <QHash>
 #include <QSemaphore>
 #include "uavobjectmanager.h"
 #include "uavtalk_global.h"
-#include <QtNetwork/QUdpSocket>
+
+class TelemetryRelay;
 
 class UAVTALK_EXPORT UAVTalk: public QObject
 {
@@ -53,20 +55,40 @@ public:
         quint32 rxErrors;
     } ComStats;
 
+    /** Counters of one object ID since the link was opened */
+    typedef struct {
+        quint32 txPackets;
+        quint32 txBytes;
+        quint32 rxPackets;
+        quint32 rxBytes;
+        quint32 retries;
+        quint32 nacks;
+    } ObjectStats;
+
+    /** Capability bits advertised in GCSTelemetryCapabilities/FlightTelemetryCapabilities */
+    static const quint8 CAPABILITY_MULTIOBJECT = 0x01;
+    static const quint8 CAPABILITY_DELTA = 0x02;
+    static const quint8 CAPABILITY_PING = 0x04;
+    static const quint8 CAPABILITIES = CAPABILITY_MULTIOBJECT | CAPABILITY_DELTA | CAPABILITY_PING;
+
     UAVTalk(QIODevice* iodev, UAVObjectManager* objMngr);
     ~UAVTalk();
     bool sendObject(UAVObject* obj, bool acked, bool allInstances);
     bool sendObjectRequest(UAVObject* obj, bool allInstances);
-    void cancelTransaction(UAVObject* obj);
+    bool sendObjects(const QList<UAVObject*>& objs);
+    void cancelTransaction(UAVObject* obj, bool allInstances = false);
+    static quint64 transactionKey(UAVObject* obj, bool allInstances);
     ComStats getStats();
     void resetStats();
+    QHash<quint32, ObjectStats> getObjectStats();
+    void startRelay(quint16 port);
 
 signals:
     void transactionCompleted(UAVObject* obj, bool success);
 
 private slots:
     void processInputStream(void);
-    void dummyUDPRead();
+    void relayUplink(const QByteArray &frame);
 
 private:
 
@@ -83,6 +105,10 @@ private:
     static const int TYPE_OBJ_ACK = (TYPE_VER | 0x02);
     static const int TYPE_ACK = (TYPE_VER | 0x03);
     static const int TYPE_NACK = (TYPE_VER | 0x04);
+    static const int TYPE_OBJ_MULTI = (TYPE_VER | 0x05);
+    static const int TYPE_OBJ_DELTA = (TYPE_VER | 0x06);
+
+    static const int DELTA_MASK_LENGTH = 4; // changed field mask, after the field data
 
     static const int MIN_HEADER_LENGTH = 8; // sync(1), type (1), size(2), object ID(4)
     static const int MAX_HEADER_LENGTH = 10; // sync(1), type (1), size(2), object ID (4), instance ID(2, not used in single objects)
@@ -97,7 +123,9 @@ private:
     static const quint16 OBJID_NOTFOUND = 0x0000;
 
     static const int TX_BUFFER_SIZE = 2*1024;
+    static const int RX_BLOCK_SIZE = 16*1024;
     static const quint8 crc_table[256];
+    static const quint8 crc_table_slice[7][256];
 
     // Types
     typedef enum {STATE_SYNC, STATE_TYPE, STATE_SIZE, STATE_OBJID, STATE_INSTID, STATE_DATA, STATE_CS} RxStateType;
@@ -106,7 +134,7 @@ private:
     QPointer<QIODevice> io;
     UAVObjectManager* objMngr;
     QMutex* mutex;
-    QMap<quint32, Transaction*> transMap;
+    QMap<quint64, Transaction*> transMap; // keyed by transactionKey()
     quint8 rxBuffer[MAX_PACKET_LENGTH];
     quint8 txBuffer[MAX_PACKET_LENGTH];
     // Variables used by the receive state machine
@@ -122,23 +150,29 @@ private:
     qint32 rxCount;
     qint32 packetSize;
     RxStateType rxState;
+    qint64 rxTime; // When the block being decoded was read off the link
     ComStats stats;
+    QHash<quint32, ObjectStats> objStats; // Keyed by object ID, never reset
 
-    bool useUDPMirror;
-    QUdpSocket * udpSocketTx;
-    QUdpSocket * udpSocketRx;
-    QByteArray rxDataArray;
+    qint32 maxMultiLength; // Largest multi-object frame the board takes, 0 until known
+    TelemetryRelay* relay; // Shares the link with other programs, when enabled
+    QByteArray rxInputBuffer;
 
     // Methods
     bool objectTransaction(UAVObject* obj, quint8 type, bool allInstances);
+    Transaction* takeTransaction(UAVObject* obj);
     bool processInputByte(quint8 rxbyte);
+    void processInputBlock(const quint8* data, qint64 length);
     bool receiveObject(quint8 type, quint32 objId, quint16 instId, quint8* data, qint32 length);
+    bool receiveMultiObject(quint8* data, qint32 length);
+    bool receiveDeltaObject(quint32 objId, quint16 instId, quint8* data, qint32 length);
     UAVObject* updateObject(quint32 objId, quint16 instId, quint8* data);
     void updateAck(UAVObject* obj);
     void updateNack(UAVObject* obj);
     bool transmitNack(quint32 objId);
     bool transmitObject(UAVObject* obj, quint8 type, bool allInstances);
     bool transmitSingleObject(UAVObject* obj, quint8 type, bool allInstances);
+    bool transmitMultiObject(qint32 length, quint32 objects, quint32 objectBytes);
     quint8 updateCRC(quint8 crc, const quint8 data);
     quint8 updateCRC(quint8 crc, const quint8* data, qint32 length);
 };
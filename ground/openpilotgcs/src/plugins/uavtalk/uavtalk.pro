@@ -7,12 +7,18 @@ HEADERS += uavtalk.h \
     uavtalkplugin.h \
     telemetrymonitor.h \
     telemetrymanager.h \
+    telemetryratemanager.h \
     uavtalk_global.h \
-    telemetry.h
+    telemetry.h \
+    telemetryrelay.h \
+    vehiclelinkmanager.h
 SOURCES += uavtalk.cpp \
     uavtalkplugin.cpp \
     telemetrymonitor.cpp \
     telemetrymanager.cpp \
-    telemetry.cpp
+    telemetryratemanager.cpp \
+    telemetry.cpp \
+    telemetryrelay.cpp \
+    vehiclelinkmanager.cpp
 DEFINES += UAVTALK_LIBRARY
 OTHER_FILES += UAVTalk.pluginspec
@@ -60,6 +60,8 @@ bool UAVTalkPlugin::initialize(const QStringList & arguments, QString * errorStr
     // Create TelemetryManager
     telMngr = new TelemetryManager();
     addAutoReleasedObject(telMngr);
+    // Links of any further vehicles
+    addAutoReleasedObject(new VehicleLinkManager(telMngr));
 
     // Connect to connection manager so we get notified when the user connect to his device
     Core::ConnectionManager *cm = Core::ICore::instance()->connectionManager();
@@ -34,6 +34,7 @@
 #include "telemetry.h"
 #include "uavtalk.h"
 #include "telemetrymanager.h"
+#include "vehiclelinkmanager.h"
 #include "uavobjectmanager.h"
 
 class UAVTALK_EXPORT UAVTalkPlugin: public ExtensionSystem::IPlugin
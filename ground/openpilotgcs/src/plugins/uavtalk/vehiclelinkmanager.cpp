@@ -0,0 +1,97 @@
+/**
+ ******************************************************************************
+ *
+ * @file       vehiclelinkmanager.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVTalkPlugin UAVTalk Plugin
+ * @{
+ * @brief The UAVTalk protocol plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "vehiclelinkmanager.h"
+#include "vehiclemanager.h"
+#include <extensionsystem/pluginmanager.h>
+
+VehicleLinkManager::VehicleLinkManager(TelemetryManager* primary) :
+    primary(primary)
+{
+    ExtensionSystem::PluginManager* pm = ExtensionSystem::PluginManager::instance();
+    vehicleMngr = pm->getObject<VehicleManager>();
+    if (vehicleMngr)
+        connect(vehicleMngr, SIGNAL(vehicleAboutToBeRemoved(int)), this, SLOT(onVehicleAboutToBeRemoved(int)));
+}
+
+VehicleLinkManager::~VehicleLinkManager()
+{
+    foreach (int vehicle, links.keys())
+        disconnectVehicle(vehicle);
+}
+
+/**
+ * Start the telemetry of a vehicle on an open device, replacing the link it
+ * had. The primary vehicle is connected through the connection manager.
+ */
+bool VehicleLinkManager::connectVehicle(int vehicle, QIODevice* dev)
+{
+    if (!vehicleMngr || vehicle == VehicleManager::PRIMARY_VEHICLE)
+        return false;
+    UAVObjectManager* objMngr = vehicleMngr->getObjectManager(vehicle);
+    if (!objMngr)
+        return false;
+    disconnectVehicle(vehicle);
+    TelemetryManager* telMngr = new TelemetryManager(objMngr);
+    links.insert(vehicle, telMngr);
+    telMngr->start(dev);
+    return true;
+}
+
+void VehicleLinkManager::disconnectVehicle(int vehicle)
+{
+    TelemetryManager* telMngr = links.take(vehicle);
+    if (!telMngr)
+        return;
+    // Stopping runs in the vehicle's thread without waiting for it here, the
+    // manager is deleted when its thread finishes
+    QMetaObject::invokeMethod(telMngr, "stop", Qt::QueuedConnection);
+}
+
+/**
+ * Get the telemetry of a vehicle, NULL while it has no link
+ */
+TelemetryManager* VehicleLinkManager::getTelemetryManager(int vehicle)
+{
+    if (vehicle == VehicleManager::PRIMARY_VEHICLE)
+        return primary;
+    return links.value(vehicle, NULL);
+}
+
+/**
+ * The telemetry thread may still be unpacking into the objects while it
+ * stops, so the thread takes over the object manager and deletes it once
+ * finished.
+ */
+void VehicleLinkManager::onVehicleAboutToBeRemoved(int vehicle)
+{
+    TelemetryManager* telMngr = links.value(vehicle, NULL);
+    if (telMngr)
+        vehicleMngr->getObjectManager(vehicle)->setParent(telMngr->thread());
+    disconnectVehicle(vehicle);
+}
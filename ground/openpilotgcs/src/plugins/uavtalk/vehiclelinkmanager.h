@@ -0,0 +1,64 @@
+/**
+ ******************************************************************************
+ *
+ * @file       vehiclelinkmanager.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup UAVTalkPlugin UAVTalk Plugin
+ * @{
+ * @brief The UAVTalk protocol plugin
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef VEHICLELINKMANAGER_H
+#define VEHICLELINKMANAGER_H
+
+#include "uavtalk_global.h"
+#include "telemetrymanager.h"
+#include <QMap>
+
+class VehicleManager;
+
+/**
+ * Runs the telemetry of the vehicles added to the VehicleManager, one link,
+ * UAVTalk and telemetry thread per vehicle. The primary vehicle stays with the
+ * connection manager and the TelemetryManager in the plugin pool.
+ */
+class UAVTALK_EXPORT VehicleLinkManager: public QObject
+{
+    Q_OBJECT
+
+public:
+    VehicleLinkManager(TelemetryManager* primary);
+    ~VehicleLinkManager();
+
+    bool connectVehicle(int vehicle, QIODevice* dev);
+    void disconnectVehicle(int vehicle);
+    TelemetryManager* getTelemetryManager(int vehicle);
+
+private slots:
+    void onVehicleAboutToBeRemoved(int vehicle);
+
+private:
+    VehicleManager* vehicleMngr;
+    TelemetryManager* primary;
+    QMap<int, TelemetryManager*> links;
+};
+
+#endif // VEHICLELINKMANAGER_H
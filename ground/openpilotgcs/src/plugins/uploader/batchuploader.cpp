@@ -0,0 +1,151 @@
+/**
+ ******************************************************************************
+ *
+ * @file       batchuploader.cpp
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup YModemUploader YModem Serial Uploader Plugin
+ * @{
+ * @brief Flashes every board plugged in while a batch runs, in parallel
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "batchuploader.h"
+#include <coreplugin/icore.h>
+#include <coreplugin/connectionmanager.h>
+
+BatchUploader::BatchUploader(QObject *parent) : QObject(parent),
+    running(false), verify(true), count(0), flashed(0), failed(0)
+{
+}
+
+BatchUploader::~BatchUploader()
+{
+    stop();
+}
+
+/**
+  Loads the firmware and flashes every board that enters its bootloader
+  from now on, each one once.
+  */
+bool BatchUploader::start(QString const & firmware, bool _verify, int _count)
+{
+    if (running || !image.load(firmware))
+        return false;
+    verify = _verify;
+    count = _count;
+    flashed = 0;
+    failed = 0;
+    seen.clear();
+    running = true;
+
+    Core::ConnectionManager *cm = Core::ICore::instance()->connectionManager();
+    cm->disconnectDevice();
+    cm->suspendPolling();
+    connect(USBMonitor::instance(), SIGNAL(deviceDiscovered(USBPortInfo)), this, SLOT(devicesChanged()));
+    devicesChanged();
+    return true;
+}
+
+/**
+  Stops looking for boards and waits for the uploads in progress
+  */
+void BatchUploader::stop()
+{
+    if (!running)
+        return;
+    running = false;
+    disconnect(USBMonitor::instance(), SIGNAL(deviceDiscovered(USBPortInfo)), this, SLOT(devicesChanged()));
+    foreach (OP_DFU::DFUObject *dfu, boards.keys()) {
+        dfu->wait();
+        delete dfu;
+    }
+    boards.clear();
+    Core::ICore::instance()->connectionManager()->resumePolling();
+}
+
+void BatchUploader::devicesChanged()
+{
+    if (!running)
+        return;
+    foreach (USBPortInfo const & info, USBMonitor::instance()->availableDevices(0x20a0,-1,-1,USBMonitor::Bootloader)) {
+        if (info.serialNumber.isEmpty() || seen.contains(info.serialNumber))
+            continue;
+        // Before anything that runs an event loop, so the board is not
+        // started twice when another one shows up meanwhile
+        seen.insert(info.serialNumber);
+        startBoard(info.serialNumber);
+    }
+}
+
+void BatchUploader::startBoard(QString const & serial)
+{
+    emit boardStarted(serial);
+    OP_DFU::DFUObject *dfu = new OP_DFU::DFUObject(false, false, QString(), serial);
+    boards.insert(dfu, serial);
+    if (!dfu->ready()) {
+        finishBoard(dfu, false);
+        return;
+    }
+    dfu->AbortOperation();
+    if (!dfu->enterDFU(0) || !dfu->findDevices() || dfu->numberOfDevices < 1 || !dfu->enterDFU(0)) {
+        finishBoard(dfu, false);
+        return;
+    }
+    dfu->AbortOperation();
+    connect(dfu, SIGNAL(progressUpdated(int)), this, SLOT(progress(int)));
+    connect(dfu, SIGNAL(uploadFinished(OP_DFU::Status)), this, SLOT(uploadFinished(OP_DFU::Status)));
+    if (!dfu->UploadFirmware(&image, verify, 0))
+        finishBoard(dfu, false);
+}
+
+void BatchUploader::progress(int percent)
+{
+    OP_DFU::DFUObject *dfu = static_cast<OP_DFU::DFUObject *>(sender());
+    if (boards.contains(dfu))
+        emit boardProgress(boards.value(dfu), percent);
+}
+
+void BatchUploader::uploadFinished(OP_DFU::Status status)
+{
+    OP_DFU::DFUObject *dfu = static_cast<OP_DFU::DFUObject *>(sender());
+    if (!boards.contains(dfu))
+        return;
+    // The thread has emitted its last signal, wait for it to be done
+    dfu->wait();
+    bool success = (status == OP_DFU::Last_operation_Success) &&
+                   (dfu->UploadDescription(image.description()) == OP_DFU::Last_operation_Success);
+    if (success)
+        dfu->JumpToApp(false);
+    finishBoard(dfu, success);
+}
+
+void BatchUploader::finishBoard(OP_DFU::DFUObject *dfu, bool success)
+{
+    QString serial = boards.take(dfu);
+    dfu->deleteLater();
+    if (success)
+        ++flashed;
+    else
+        ++failed;
+    emit boardFinished(serial, success);
+    if (count > 0 && flashed + failed >= count) {
+        stop();
+        emit batchFinished(flashed, failed);
+    }
+}
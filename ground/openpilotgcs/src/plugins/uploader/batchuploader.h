@@ -0,0 +1,78 @@
+/**
+ ******************************************************************************
+ *
+ * @file       batchuploader.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @addtogroup GCSPlugins GCS Plugins
+ * @{
+ * @addtogroup YModemUploader YModem Serial Uploader Plugin
+ * @{
+ * @brief Flashes every board plugged in while a batch runs, in parallel
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef BATCHUPLOADER_H
+#define BATCHUPLOADER_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include "op_dfu.h"
+#include "uploader_global.h"
+
+/**
+  Production line flashing: each board showing up in its bootloader gets
+  its own DFUObject, so boards on different USB ports upload at the same
+  time. The firmware is loaded and its CRC computed once for all of them.
+  */
+class UPLOADER_EXPORT BatchUploader : public QObject
+{
+    Q_OBJECT
+public:
+    BatchUploader(QObject *parent = 0);
+    ~BatchUploader();
+    bool start(QString const & firmware, bool verify, int count = 0);
+    void stop();
+    bool isRunning() { return running; }
+
+signals:
+    void boardStarted(QString serial);
+    void boardProgress(QString serial, int percent);
+    void boardFinished(QString serial, bool success);
+    // Once count boards are done, never if count is 0
+    void batchFinished(int flashed, int failed);
+
+private slots:
+    void devicesChanged();
+    void progress(int percent);
+    void uploadFinished(OP_DFU::Status status);
+
+private:
+    void startBoard(QString const & serial);
+    void finishBoard(OP_DFU::DFUObject *dfu, bool success);
+
+    OP_DFU::FirmwareImage image;
+    bool running;
+    bool verify;
+    int count;
+    int flashed;
+    int failed;
+    QHash<OP_DFU::DFUObject *, QString> boards;
+    QSet<QString> seen;
+};
+
+#endif // BATCHUPLOADER_H
@@ -30,14 +30,21 @@
 #include <qwaitcondition.h>
 #include <QMetaType>
 #include <QApplication>
+#include <QVector>
 
 using namespace OP_DFU;
 
-DFUObject::DFUObject(bool _debug,bool _use_serial,QString portname):
+/**
+  Opens the bootloader on the given serial port, or over USB. A non empty
+  serial number picks one board when several are in their bootloader.
+  */
+DFUObject::DFUObject(bool _debug,bool _use_serial,QString portname,QString serial):
     debug(_debug),use_serial(_use_serial),mready(true)
 {
     info = NULL;
     numberOfDevices = 0;
+    uploadWindow = 0;
+    requestImage = NULL;
 
     qRegisterMetaType<OP_DFU::Status>("Status");
 
@@ -86,9 +93,9 @@ DFUObject::DFUObject(bool _debug,bool _use_serial,QString portname):
         QTimer::singleShot(200,&m_eventloop, SLOT(quit()));
         m_eventloop.exec();
         QList<USBPortInfo> devices;
-        devices = USBMonitor::instance()->availableDevices(0x20a0,-1,-1,USBMonitor::Bootloader);
+        devices = bootloaderDevices(serial);
         if (devices.length()==1) {
-            if (hidHandle.open(1,devices.first().vendorID,devices.first().productID,0,0)==1) {
+            if (hidHandle.open(1,devices.first().vendorID,devices.first().productID,0,0,serial)==1) {
                 mready=true;
                 QTimer::singleShot(200,&m_eventloop, SLOT(quit()));
                 m_eventloop.exec();
@@ -107,11 +114,11 @@ DFUObject::DFUObject(bool _debug,bool _use_serial,QString portname):
                 else
                     QTimer::singleShot(2000,&m_eventloop, SLOT(quit()));
                 m_eventloop.exec();
-                devices = USBMonitor::instance()->availableDevices(0x20a0,-1,-1,USBMonitor::Bootloader);
+                devices = bootloaderDevices(serial);
                 qDebug() << "Devices length: " << devices.length();
                 if (devices.length()==1) {
                     qDebug() << "Opening device";
-                    if(hidHandle.open(1,devices.first().vendorID,devices.first().productID,0,0)==1)
+                    if(hidHandle.open(1,devices.first().vendorID,devices.first().productID,0,0,serial)==1)
                     {
                         QTimer::singleShot(200,&m_eventloop, SLOT(quit()));
                         m_eventloop.exec();
@@ -131,6 +138,22 @@ DFUObject::DFUObject(bool _debug,bool _use_serial,QString portname):
     }
 }
 
+/**
+  Boards in their bootloader, only the one with this serial number
+  unless it is empty.
+  */
+QList<USBPortInfo> DFUObject::bootloaderDevices(QString const & serial)
+{
+    QList<USBPortInfo> devices = USBMonitor::instance()->availableDevices(0x20a0,-1,-1,USBMonitor::Bootloader);
+    if (!serial.isEmpty()) {
+        for (int i = devices.length()-1; i >= 0; --i) {
+            if (devices[i].serialNumber != serial)
+                devices.removeAt(i);
+        }
+    }
+    return devices;
+}
+
 DFUObject::~DFUObject()
 {
     if (use_serial) {
@@ -187,8 +210,13 @@ bool DFUObject::enterDFU(int const &devNumber)
   Tells the board to get ready for an upload. It will in particular
   erase the memory to make room for the data. You will have to query
   its status to wait until erase is done before doing the actual upload.
+
+  A non zero window asks a bootloader with DFU_CAP_WINDOWED_UPLOAD to
+  acknowledge every window of packets, see UploadData. Keep asks one with
+  DFU_CAP_DELTA_UPLOAD not to erase, the blocks to rewrite are erased
+  with EraseBlock.
   */
-bool DFUObject::StartUpload(qint32 const & numberOfBytes, TransferTypes const & type,quint32 crc)
+bool DFUObject::StartUpload(qint32 const & numberOfBytes, TransferTypes const & type,quint32 crc,int window,bool keep)
 {
     int lastPacketCount;
     qint32 numberOfPackets=numberOfBytes/4/14;
@@ -205,6 +233,9 @@ bool DFUObject::StartUpload(qint32 const & numberOfBytes, TransferTypes const &
     char buf[BUF_LEN];
     buf[0] =0x02;//reportID
     buf[1] = setStartBit(OP_DFU::Upload);//DFU Command
+    bool extended=(window>0 || keep);
+    if(extended)
+        buf[1] |= 0x40;//Answer flag, extended start
     buf[2] = numberOfPackets>>24;//DFU Count
     buf[3] = numberOfPackets>>16;//DFU Count
     buf[4] = numberOfPackets>>8;//DFU Count
@@ -215,11 +246,16 @@ bool DFUObject::StartUpload(qint32 const & numberOfBytes, TransferTypes const &
     buf[9] = crc>>16;
     buf[10] = crc>>8;
     buf[11] = crc;
+    buf[12] = window;
+    buf[13] = keep?DFU_UPLOAD_KEEP:0;
+    uploadWindow=window;
     if(debug)
         qDebug()<<"Number of packets:"<<numberOfPackets<<" Size of last packet:"<<lastPacketCount;
 
     int result = sendData(buf, BUF_LEN);
-    delay::msleep(1000);
+    // Newer bootloaders only answer the status request once erased
+    if(!extended)
+        delay::msleep(1000);
 
     if(debug)
         qDebug() << result << " bytes sent";
@@ -234,8 +270,12 @@ bool DFUObject::StartUpload(qint32 const & numberOfBytes, TransferTypes const &
 /**
   Does the actual data upload to the board. Needs to be called once the
   board is ready to accept data following a StartUpload command, and it is erased.
+
+  On a windowed upload the next window is sent while the bootloader programs
+  the one before, and the upload stops at the first failure it acknowledges.
+  A delta upload only sends the packets set in send, and always the last one.
   */
-bool DFUObject::UploadData(qint32 const & numberOfBytes, QByteArray  & data)
+bool DFUObject::UploadData(qint32 const & numberOfBytes, QByteArray const & data, QBitArray const & send)
 {
     int lastPacketCount;
     qint32 numberOfPackets=numberOfBytes/4/14;
@@ -254,6 +294,8 @@ bool DFUObject::UploadData(qint32 const & numberOfBytes, QByteArray  & data)
     char buf[BUF_LEN];
     buf[0] =0x02;//reportID
     buf[1] = OP_DFU::Upload;//DFU Command
+    int sent=0;
+    int acks=0;
     int packetsize;
     float percentage;
     int laspercentage;
@@ -263,7 +305,9 @@ bool DFUObject::UploadData(qint32 const & numberOfBytes, QByteArray  & data)
         if(laspercentage!=(int)percentage)
             printProgBar((int)percentage,"UPLOADING");
         laspercentage=(int)percentage;
-        if(packetcount==numberOfPackets)
+        if(!send.isEmpty() && !send.testBit(packetcount) && packetcount!=numberOfPackets-1)
+            continue;
+        if(packetcount==numberOfPackets-1)
             packetsize=lastPacketCount;
         else
             packetsize=14;
@@ -272,7 +316,7 @@ bool DFUObject::UploadData(qint32 const & numberOfBytes, QByteArray  & data)
         buf[3] = packetcount>>16;//DFU Count
         buf[4] = packetcount>>8;//DFU Count
         buf[5] = packetcount;//DFU Count
-        char *pointer=data.data();
+        const char *pointer=data.constData();
         pointer=pointer+4*14*packetcount;
         //  qDebug()<<"Packet Number="<<packetcount<<"Data0="<<(int)data[0]<<" Data1="<<(int)data[1]<<" Data0="<<(int)data[2]<<" Data0="<<(int)data[3]<<" buf6="<<(int)buf[6]<<" buf7="<<(int)buf[7]<<" buf8="<<(int)buf[8]<<" buf9="<<(int)buf[9];
         CopyWords(pointer,buf+6,packetsize*4);
@@ -296,12 +340,95 @@ bool DFUObject::UploadData(qint32 const & numberOfBytes, QByteArray  & data)
 
         //  qDebug() << "UPLOAD:"<<"Data="<<(int)buf[6]<<(int)buf[7]<<(int)buf[8]<<(int)buf[9]<<";"<<result << " bytes sent";
 
+        ++sent;
+        if(uploadWindow>0 && sent-acks*uploadWindow>=2*uploadWindow)
+        {
+            if(!WaitUploadAck(acks))
+                return false;
+        }
     }
+    // One more for the last packet when it did not end a window
+    while(uploadWindow>0 && acks<(sent+uploadWindow-1)/uploadWindow)
+    {
+        if(!WaitUploadAck(acks))
+            return false;
+    }
+    if(debug && !send.isEmpty())
+        qDebug()<<"Sent"<<sent<<"of"<<numberOfPackets<<"packets";
     cout<<"\n";
     // while(true){}
     return true;
 }
 
+/**
+  Reads an Upload_Ack of a windowed upload, one comes for every window of
+  packets sent and for the last packet.
+  */
+bool DFUObject::WaitUploadAck(int & acks)
+{
+    char buf[BUF_LEN];
+    int result = receiveData(buf,BUF_LEN);
+    if(result<1 || buf[1]!=OP_DFU::Upload_Ack)
+        return false;
+    quint32 aux;
+    aux=(quint8)buf[2];
+    aux=aux<<8 |(quint8)buf[3];
+    aux=aux<<8 |(quint8)buf[4];
+    aux=aux<<8 |(quint8)buf[5];
+    if(debug)
+        qDebug()<<"Upload acknowledged:"<<aux<<StatusToString((OP_DFU::Status)buf[6]);
+    if(buf[6]!=OP_DFU::uploading)
+        return false;
+    ++acks;
+    return true;
+}
+
+/**
+  Reads the CRC of every block of the code partition from a bootloader
+  with DFU_CAP_DELTA_UPLOAD, an empty list if that fails.
+  */
+QList<flashBlock> DFUObject::BlockCRCs()
+{
+    QList<flashBlock> blocks;
+    char buf[BUF_LEN];
+    for(quint32 index=0;;++index)
+    {
+        buf[0] =0x02;                   //reportID
+        buf[1] = OP_DFU::Req_BlockCRC;  //DFU Command
+        buf[2] = index>>24;
+        buf[3] = index>>16;
+        buf[4] = index>>8;
+        buf[5] = index;
+        if(sendData(buf, BUF_LEN)<1 || receiveData(buf,BUF_LEN)<1 || buf[1]!=OP_DFU::Rep_BlockCRC)
+            return QList<flashBlock>();
+        flashBlock block;
+        block.start=(quint8)buf[6]<<24 | (quint8)buf[7]<<16 | (quint8)buf[8]<<8 | (quint8)buf[9];
+        block.size=(quint8)buf[10]<<24 | (quint8)buf[11]<<16 | (quint8)buf[12]<<8 | (quint8)buf[13];
+        block.crc=(quint8)buf[14]<<24 | (quint8)buf[15]<<16 | (quint8)buf[16]<<8 | (quint8)buf[17];
+        if(block.size==0)
+            break;
+        blocks.append(block);
+    }
+    return blocks;
+}
+
+/**
+  Erases one block during a delta upload
+  */
+bool DFUObject::EraseBlock(int block)
+{
+    char buf[BUF_LEN];
+    buf[0] =0x02;                   //reportID
+    buf[1] = OP_DFU::Erase_Block;   //DFU Command
+    buf[2] = block>>24;
+    buf[3] = block>>16;
+    buf[4] = block>>8;
+    buf[5] = block;
+    if(sendData(buf, BUF_LEN)<1)
+        return false;
+    return StatusRequest()==OP_DFU::uploading;
+}
+
 /**
   Sends the firmware description to the device
   */
@@ -400,7 +527,11 @@ void DFUObject::run()
             emit(downloadFinished());
             break;
         case OP_DFU::Upload: {
-            OP_DFU::Status ret = UploadFirmwareT(requestFilename, requestVerify, requestDevice);
+            OP_DFU::Status ret;
+            if (requestImage)
+                ret = UploadImageT(*requestImage, requestVerify, requestDevice);
+            else
+                ret = UploadFirmwareT(requestFilename, requestVerify, requestDevice);
             emit(uploadFinished(ret));
             break;
         }
@@ -622,6 +753,7 @@ bool DFUObject::findDevices()
             devices[x].ID=devices[x].ID<<8 | (quint8)buf[15];
             devices[x].BL_Version=buf[7];
             devices[x].SizeOfDesc=buf[8];
+            devices[x].Capabilities=(quint8)buf[16];
 
             quint32 aux;
             aux=(quint8)buf[10];
@@ -650,6 +782,7 @@ bool DFUObject::findDevices()
                 qDebug()<<"Device SizeOfCode="<<devices[x].SizeOfCode;
                 qDebug()<<"Device SizeOfDesc="<<devices[x].SizeOfDesc;
                 qDebug()<<"BL Version="<<devices[x].BL_Version;
+                qDebug()<<"BL Capabilities="<<devices[x].Capabilities;
                 qDebug()<<"FW CRC="<<devices[x].FW_CRC;
             }
         }
@@ -692,52 +825,94 @@ bool DFUObject::UploadFirmware(const QString &sfile, const bool &verify,int devi
         return false;
     requestedOperation = OP_DFU::Upload;
     requestFilename = sfile;
+    requestImage = NULL;
     requestDevice = device;
     requestVerify = verify;
     start();
     return true;
 }
 
-OP_DFU::Status DFUObject::UploadFirmwareT(const QString &sfile, const bool &verify,int device)
+/**
+  Same as above with an image already loaded, which several DFUObjects
+  can upload at once.
+  */
+bool DFUObject::UploadFirmware(FirmwareImage *image, const bool &verify,int device)
 {
-    OP_DFU::Status ret;
 
+    if (isRunning())
+        return false;
+    requestedOperation = OP_DFU::Upload;
+    requestImage = image;
+    requestDevice = device;
+    requestVerify = verify;
+    start();
+    return true;
+}
+
+OP_DFU::Status DFUObject::UploadFirmwareT(const QString &sfile, const bool &verify,int device)
+{
     if (debug)
         qDebug() <<"Starting Firmware Uploading...";
 
-    QFile file(sfile);
-
-    if (!file.open(QIODevice::ReadOnly))
+    FirmwareImage image;
+    if (!image.load(sfile))
     {
         if(debug)
             qDebug()<<"Cant open file";
         return OP_DFU::abort;
     }
+    if(debug)
+        qDebug()<<"Bytes Loaded="<<image.data().length();
+    return UploadImageT(image, verify, device);
+}
 
-    QByteArray arr = file.readAll();
+OP_DFU::Status DFUObject::UploadImageT(FirmwareImage &image, const bool &verify,int device)
+{
+    OP_DFU::Status ret;
+    const QByteArray &arr = image.data();
 
-    if(debug)
-        qDebug()<<"Bytes Loaded="<<arr.length();
-    if(arr.length()%4!=0)
-    {
-        int pad=arr.length()/4;
-        ++pad;
-        pad=pad*4;
-        pad=pad-arr.length();
-        arr.append(QByteArray(pad,255));
-    }
-    if( devices[device].SizeOfCode < arr.length())
+    if( devices[device].SizeOfCode < (quint32)arr.length())
     {
         if (debug)
             qDebug() << "ERROR file to big for device";
         return OP_DFU::abort;;
     }
 
-    quint32 crc=DFUObject::CRCFromQBArray(arr,devices[device].SizeOfCode);
+    quint32 crc=image.crc(devices[device].SizeOfCode);
     if (debug)
         qDebug() << "NEW FIRMWARE CRC=" << crc;
 
-    if( !StartUpload(arr.length(), OP_DFU::FW, crc))
+    int window=(devices[device].Capabilities & DFU_CAP_WINDOWED_UPLOAD)?UPLOAD_WINDOW:0;
+
+    // A bootloader with DFU_CAP_DELTA_UPLOAD keeps the blocks that already
+    // hold the new firmware, only the others are erased and sent
+    QBitArray send;
+    QList<int> erase;
+    if(devices[device].Capabilities & DFU_CAP_DELTA_UPLOAD)
+    {
+        QList<flashBlock> blocks=BlockCRCs();
+        qint32 numberOfPackets=(arr.length()+14*4-1)/(14*4);
+        if(!blocks.isEmpty() && numberOfPackets>0)
+        {
+            send.resize(numberOfPackets);
+            for(int b=0;b<blocks.count();++b)
+            {
+                const flashBlock &block=blocks[b];
+                // The description is written after the firmware, so a
+                // block holding some of it is always erased
+                if(block.start+block.size<=devices[device].SizeOfCode &&
+                   block.crc==CRCFromBlock(arr,block.start,block.size))
+                    continue;
+                erase.append(b);
+                for(qint32 p=block.start/(14*4);p<numberOfPackets && (quint32)p*14*4<block.start+block.size;++p)
+                    send.setBit(p);
+            }
+            if(debug)
+                qDebug()<<"Delta upload of"<<blocks.count()<<"blocks, erasing"<<erase;
+        }
+    }
+
+    if( !StartUpload(arr.length(), OP_DFU::FW, crc, window, !send.isEmpty()))
     {
         ret = StatusRequest();
         if(debug)
@@ -763,9 +938,14 @@ OP_DFU::Status DFUObject::UploadFirmwareT(const QString &sfile, const bool &veri
         else
             return ret;
     }
+    foreach(int block,erase)
+    {
+        if(!EraseBlock(block))
+            return StatusRequest();
+    }
 
     emit operationProgress(QString("Uploading firmware"));
-    if( !UploadData(arr.length(),arr))
+    if( !UploadData(arr.length(),arr,send))
     {
         ret = StatusRequest();
         if(debug)
@@ -789,7 +969,9 @@ OP_DFU::Status DFUObject::UploadFirmwareT(const QString &sfile, const bool &veri
     if(ret != OP_DFU::Last_operation_Success)
         return ret;
 
-    if(verify) {
+    // Bootloaders with DFU_CAP_CRC_VERIFY checked the programmed image against
+    // the CRC on Op_END, only older ones need the firmware read back
+    if(verify && !(devices[device].Capabilities & DFU_CAP_CRC_VERIFY)) {
         emit operationProgress(QString("Verifying firmware"));
         cout<<"Starting code verification\n";
         QByteArray arr2;
@@ -859,7 +1041,7 @@ OP_DFU::Status DFUObject::CompareFirmware(const QString &sfile, const CompareTyp
     }
 }
 
-void DFUObject::CopyWords(char *source, char *destination, int count)
+void DFUObject::CopyWords(const char *source, char *destination, int count)
 {
     for (int x=0;x<count;x=x+4)
     {
@@ -969,6 +1151,21 @@ quint32 DFUObject::CRC32WideFast(quint32 Crc, quint32 Size, quint32 *Buffer)
 /**
   Utility function
   */
+/**
+  CRC of size bytes from start in an image, as the bootloader computes it
+  over a block of flash, the flash past the image being erased
+  */
+quint32 DFUObject::CRCFromBlock(QByteArray const & array, quint32 start, quint32 size)
+{
+    QVector<quint32> t(size/4,0xFFFFFFFF);
+    const uchar *data=(const uchar*)array.constData();
+    for(quint32 x=0;x<size/4 && start+x*4+4<=(quint32)array.length();++x)
+    {
+        const uchar *word=data+start+x*4;
+        t[x]=word[0] | word[1]<<8 | word[2]<<16 | (quint32)word[3]<<24;
+    }
+    return DFUObject::CRC32WideFast(0xFFFFFFFF,size/4,t.data());
+}
 quint32 DFUObject::CRCFromQBArray(QByteArray array, quint32 Size)
 {
     quint32 pad=Size-array.length();
@@ -1075,3 +1272,32 @@ OP_DFU::eBoardType DFUObject::GetBoardType(int boardNum)
 }
 
 
+
+/**
+  Loads a firmware file, padded to whole words for the upload
+  */
+bool FirmwareImage::load(QString const & file)
+{
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly))
+        return false;
+    QMutexLocker locker(&mutex);
+    image = f.readAll();
+    desc = image.right(100);
+    if(image.length()%4!=0)
+        image.append(QByteArray(4-image.length()%4,255));
+    crcs.clear();
+    return true;
+}
+
+/**
+  CRC of the image padded to the code partition of a device, computed on
+  the first board with that partition size only
+  */
+quint32 FirmwareImage::crc(quint32 sizeOfCode)
+{
+    QMutexLocker locker(&mutex);
+    if (!crcs.contains(sizeOfCode))
+        crcs.insert(sizeOfCode, DFUObject::CRCFromQBArray(image,sizeOfCode));
+    return crcs.value(sizeOfCode);
+}
@@ -13,6 +13,8 @@
 #include <QMetaType>
 #include <QCryptographicHash>
 #include <QList>
+#include <QHash>
+#include <QBitArray>
 #include <QVariant>
 #include <iostream>
 #include "delay.h"
@@ -29,6 +31,16 @@ using namespace std;
 #define MAX_PACKET_DATA_LEN	255
 #define MAX_PACKET_BUF_SIZE	(1+1+MAX_PACKET_DATA_LEN+2)
 
+// Extensions a bootloader reports in byte 16 of a device's Rep_Capabilities
+#define DFU_CAP_WINDOWED_UPLOAD 0x01
+#define DFU_CAP_CRC_VERIFY      0x02
+#define DFU_CAP_DELTA_UPLOAD    0x04
+// Flags of an extended Upload start packet
+#define DFU_UPLOAD_KEEP         0x01
+// Packets acknowledged at once on a windowed upload, at most two windows are
+// unacknowledged as that is all the bootloader can queue without stalling
+#define UPLOAD_WINDOW 32
+
 namespace OP_DFU {
 
     enum TransferTypes
@@ -90,6 +102,10 @@ namespace OP_DFU {
         Download,//10
         Status_Request,//11
         Status_Rep,//12
+        Upload_Ack,//13
+        Req_BlockCRC,//14
+        Rep_BlockCRC,//15
+        Erase_Block,//16
 
     };
 
@@ -112,6 +128,34 @@ namespace OP_DFU {
             quint32 SizeOfCode;
             bool Readable;
             bool Writable;
+            int Capabilities;
+    };
+
+    // A part of the code partition the bootloader erases on its own
+    struct flashBlock
+    {
+            quint32 start;
+            quint32 size;
+            quint32 crc;
+    };
+
+    /**
+      A firmware file loaded and padded once, for all the boards it is
+      flashed on. The CRC covers the whole code partition of a device,
+      so it is computed once per partition size.
+      */
+    class FirmwareImage
+    {
+        public:
+        bool load(QString const & file);
+        QByteArray const & data() const { return image; }
+        QByteArray const & description() const { return desc; }
+        quint32 crc(quint32 sizeOfCode);
+        private:
+        QByteArray image;
+        QByteArray desc;
+        QMutex mutex;
+        QHash<quint32,quint32> crcs;
     };
 
 
@@ -121,8 +165,9 @@ namespace OP_DFU {
 
         public:
         static quint32 CRCFromQBArray(QByteArray array, quint32 Size);
+        static quint32 CRCFromBlock(QByteArray const & array, quint32 start, quint32 size);
         //DFUObject(bool debug);
-        DFUObject(bool debug,bool use_serial,QString port);
+        DFUObject(bool debug,bool use_serial,QString port,QString serial=QString());
 
         ~DFUObject();
 
@@ -139,6 +184,7 @@ namespace OP_DFU {
         // Upload (send to device) commands
         OP_DFU::Status UploadDescription(QVariant description);
         bool UploadFirmware(const QString &sfile, const bool &verify,int device);
+        bool UploadFirmware(FirmwareImage *image, const bool &verify,int device);
 
         // Download (get from device) commands:
         // DownloadDescription is synchronous
@@ -193,21 +239,28 @@ namespace OP_DFU {
         pjrc_rawhid hidHandle;
         int setStartBit(int command){ return command|0x20; }
 
-        void CopyWords(char * source, char* destination, int count);
+        void CopyWords(const char * source, char* destination, int count);
         void printProgBar( int const & percent,QString const& label);
-        bool StartUpload(qint32  const &numberOfBytes, TransferTypes const & type,quint32 crc);
-        bool UploadData(qint32 const & numberOfPackets,QByteArray  & data);
+        bool StartUpload(qint32  const &numberOfBytes, TransferTypes const & type,quint32 crc,int window=0,bool keep=false);
+        bool UploadData(qint32 const & numberOfPackets,QByteArray const & data,QBitArray const & send=QBitArray());
+        bool WaitUploadAck(int & acks);
+        QList<flashBlock> BlockCRCs();
+        bool EraseBlock(int block);
+        int uploadWindow;
 
         // Thread management:
         // Same as startDownload except that we store in an external array:
         bool StartDownloadT(QByteArray *fw, qint32 const & numberOfBytes, TransferTypes const & type);
         OP_DFU::Status UploadFirmwareT(const QString &sfile, const bool &verify,int device);
+        OP_DFU::Status UploadImageT(FirmwareImage &image, const bool &verify,int device);
+        static QList<USBPortInfo> bootloaderDevices(QString const & serial);
         QMutex mutex;
         OP_DFU::Commands requestedOperation;
         qint32 requestSize;
         OP_DFU::TransferTypes requestTransferType;
         QByteArray *requestStorage;
         QString requestFilename;
+        FirmwareImage *requestImage;
         bool requestVerify;
         int requestDevice;
 
@@ -27,11 +27,15 @@
  */
 #include "uploaderplugin.h"
 #include "uploadergadgetfactory.h"
+#include "batchuploader.h"
 #include <QtPlugin>
 #include <QStringList>
+#include <QFileInfo>
+#include <QCoreApplication>
 #include <extensionsystem/pluginmanager.h>
+#include <iostream>
 
-UploaderPlugin::UploaderPlugin()
+UploaderPlugin::UploaderPlugin() : batch(0), batchCount(0)
 {
    // Do nothing
 }
@@ -43,8 +47,19 @@ UploaderPlugin::~UploaderPlugin()
 
 bool UploaderPlugin::initialize(const QStringList& args, QString *errMsg)
 {
-   Q_UNUSED(args);
-   Q_UNUSED(errMsg);
+   // -flash <firmware> [-flashcount <boards>] flashes every board plugged in,
+   // GCS quits with the result once that many boards are done
+   int index = args.indexOf("-flash");
+   if (index >= 0 && index + 1 < args.count()) {
+      batchFirmware = args.at(index + 1);
+      if (!QFileInfo(batchFirmware).isReadable()) {
+         *errMsg = tr("Cannot read firmware %1").arg(batchFirmware);
+         return false;
+      }
+   }
+   index = args.indexOf("-flashcount");
+   if (index >= 0 && index + 1 < args.count())
+      batchCount = args.at(index + 1).toInt();
    mf = new UploaderGadgetFactory(this);
    addAutoReleasedObject(mf);
    return true;
@@ -52,12 +67,43 @@ bool UploaderPlugin::initialize(const QStringList& args, QString *errMsg)
 
 void UploaderPlugin::extensionsInitialized()
 {
-   // Do nothing
+   if (batchFirmware.isEmpty())
+      return;
+   batch = new BatchUploader(this);
+   connect(batch, SIGNAL(boardStarted(QString)), this, SLOT(boardStarted(QString)));
+   connect(batch, SIGNAL(boardProgress(QString,int)), this, SLOT(boardProgress(QString,int)));
+   connect(batch, SIGNAL(boardFinished(QString,bool)), this, SLOT(boardFinished(QString,bool)));
+   connect(batch, SIGNAL(batchFinished(int,int)), this, SLOT(batchFinished(int,int)));
+   if (batch->start(batchFirmware, true, batchCount))
+      std::cout << "Flashing " << qPrintable(batchFirmware) << " on every board plugged in" << std::endl;
 }
 
 void UploaderPlugin::shutdown()
 {
-   // Do nothing
+   if (batch)
+      batch->stop();
+}
+
+void UploaderPlugin::boardStarted(QString serial)
+{
+   std::cout << qPrintable(serial) << ": started" << std::endl;
+}
+
+void UploaderPlugin::boardProgress(QString serial, int percent)
+{
+   if (percent % 10 == 0)
+      std::cout << qPrintable(serial) << ": " << percent << "%" << std::endl;
+}
+
+void UploaderPlugin::boardFinished(QString serial, bool success)
+{
+   std::cout << qPrintable(serial) << (success ? ": done" : ": FAILED") << std::endl;
+}
+
+void UploaderPlugin::batchFinished(int flashed, int failed)
+{
+   std::cout << flashed << " boards flashed, " << failed << " failed" << std::endl;
+   QCoreApplication::exit(failed ? 1 : 0);
 }
 Q_EXPORT_PLUGIN(UploaderPlugin)
 
@@ -32,9 +32,11 @@
 #include "uploader_global.h"
 
 class UploaderGadgetFactory;
+class BatchUploader;
 
 class UPLOADER_EXPORT UploaderPlugin : public ExtensionSystem::IPlugin
 {
+   Q_OBJECT
 public:
         UploaderPlugin();
    ~UploaderPlugin();
@@ -42,7 +44,15 @@ public:
    void extensionsInitialized();
    bool initialize(const QStringList & arguments, QString * errorString);
    void shutdown();
+private slots:
+   void boardStarted(QString serial);
+   void boardProgress(QString serial, int percent);
+   void boardFinished(QString serial, bool success);
+   void batchFinished(int flashed, int failed);
 private:
    UploaderGadgetFactory *mf;
+   BatchUploader *batch;
+   QString batchFirmware;
+   int batchCount;
 };
 #endif // UPLOADERPLUGIN_H
@@ -43,7 +43,7 @@ win32 {
 
     uavobjects.commands += pushd $$targetPath(../../uavobject-synthetics) &&
     uavobjects.commands += $$targetPath(../ground/uavobjgenerator/$${BUILD_CONFIG}/uavobjgenerator)
-    uavobjects.commands +=   -gcs -flight -python -matlab
+    uavobjects.commands +=   -gcs -flight -python -matlab -incremental
     uavobjects.commands +=   $$targetPath(../../shared/uavobjectdefinition)
     uavobjects.commands +=   $$targetPath(../..) &&
     uavobjects.commands += popd $$addNewline()
@@ -59,7 +59,7 @@ win32 {
 
     uavobjects.commands += cd ../../uavobject-synthetics &&
     uavobjects.commands += ../ground/uavobjgenerator/uavobjgenerator
-    uavobjects.commands += -gcs -flight -python -matlab ../../shared/uavobjectdefinition ../.. &&
+    uavobjects.commands += -gcs -flight -python -matlab -incremental ../../shared/uavobjectdefinition ../.. &&
 
     uavobjects.commands += cd ../ground/openpilotgcs &&
     uavobjects.commands += $(QMAKE) ../../../ground/openpilotgcs/openpilotgcs.pro
@@ -25,6 +25,7 @@
  */
 
 #include "uavobjectgeneratorflight.h"
+#include <QMap>
 
 using namespace std;
 
@@ -33,7 +34,11 @@ bool UAVObjectGeneratorFlight::generate(UAVObjectParser* parser,QString template
     fieldTypeStrC << "int8_t" << "int16_t" << "int32_t" <<"uint8_t"
             <<"uint16_t" << "uint32_t" << "float" << "uint8_t";
 
-    QString flightObjInit,objInc,objFileNames,objNames;
+    QString flightObjInit,objInc,objFileNames,objNames,objIds,objFieldSizes,objFieldIndex;
+    QString objDescriptors,objRam;
+    QList<quint32> ids;
+    QMap<quint32, ObjectInfo*> objById;
+    QMap<quint32, int> numBytesById;
     qint32 sizeCalc;
     flightCodePath = QDir( templatepath + QString("flight/UAVObjects"));
     flightOutputPath = QDir( outputpath + QString("flight") );
@@ -63,8 +68,74 @@ bool UAVObjectGeneratorFlight::generate(UAVObjectParser* parser,QString template
 	if (parser->getNumBytes(objidx)>sizeCalc) {
 		sizeCalc = parser->getNumBytes(objidx);
 	}
+        ids.append(info->id);
+        objById.insert(info->id, info);
+        numBytesById.insert(info->id, parser->getNumBytes(objidx));
     }
 
+    // Sorted ID table, lets the object manager binary search for received IDs
+    qSort(ids);
+    foreach (quint32 id, ids) {
+        objIds.append(QString("\t0x%1, \\\r\n").arg(QString::number(id, 16).toUpper().rightJustified(8, '0')));
+    }
+
+    // Field sizes in packing order, in the same order as the IDs, for delta updates
+    int numFieldSizes = 0;
+    foreach (quint32 id, ids) {
+        ObjectInfo* info = objById.value(id);
+        objFieldIndex.append(QString("\t%1, \\\r\n").arg(numFieldSizes));
+        objFieldSizes.append(QString("\t/* %1 */").arg(info->name));
+        for (int n = 0; n < info->fields.length(); ++n) {
+            objFieldSizes.append(QString(" %1,").arg(info->fields[n]->numBytes * info->fields[n]->numElements));
+        }
+        objFieldSizes.append(" \\\r\n");
+        numFieldSizes += info->fields.length();
+    }
+    objFieldIndex.append(QString("\t%1, \\\r\n").arg(numFieldSizes));
+
+    // Descriptors in flash, in the same order as the IDs
+    foreach (quint32 id, ids) {
+        ObjectInfo* info = objById.value(id);
+        QString desc("\t{ $(OBJIDHEX), %1, %2, { \\\r\n"
+                     "\t\t.flags = $(FLIGHTACCESS) << UAVOBJ_ACCESS_SHIFT | \\\r\n"
+                     "\t\t\t$(GCSACCESS) << UAVOBJ_GCS_ACCESS_SHIFT | \\\r\n"
+                     "\t\t\t$(FLIGHTTELEM_ACKED) << UAVOBJ_TELEMETRY_ACKED_SHIFT | \\\r\n"
+                     "\t\t\t$(GCSTELEM_ACKED) << UAVOBJ_GCS_TELEMETRY_ACKED_SHIFT | \\\r\n"
+                     "\t\t\t$(FLIGHTTELEM_UPDATEMODE) << UAVOBJ_TELEMETRY_UPDATE_MODE_SHIFT | \\\r\n"
+                     "\t\t\t$(GCSTELEM_UPDATEMODE) << UAVOBJ_GCS_TELEMETRY_UPDATE_MODE_SHIFT, \\\r\n"
+                     "\t\t.telemetryUpdatePeriod = $(FLIGHTTELEM_UPDATEPERIOD), \\\r\n"
+                     "\t\t.gcsTelemetryUpdatePeriod = $(GCSTELEM_UPDATEPERIOD), \\\r\n"
+                     "\t\t.loggingUpdatePeriod = $(LOGGING_UPDATEPERIOD) } }, /* $(NAME) */ \\\r\n");
+        replaceCommonTags(desc, info);
+        QString flags;
+        flags.append(info->isSingleInst ? "UAVOBJ_DESC_SINGLE" : "0");
+        if (info->isSettings)
+            flags.append(" | UAVOBJ_DESC_SETTINGS");
+        objDescriptors.append(desc.arg(numBytesById.value(id)).arg(flags));
+    }
+
+    // RAM taken by every object on a 32 bit target, mirroring the packed layouts in
+    // uavobjectmanager.c: struct UAVOSingle is 29 bytes before the data, struct UAVOMulti
+    // 35 bytes before the data of instance 0 and every further struct UAVOMultiInst 12,
+    // all rounded up to the pool alignment. The object handle adds 4 bytes.
+    int ramTotal = 0;
+    objRam.append("# RAM taken by every object (bytes, first instance, without UAVOBJ_DIAGNOSTICS)\n");
+    objRam.append("# name id data ram\n");
+    foreach (quint32 id, ids) {
+        ObjectInfo* info = objById.value(id);
+        int numBytes = numBytesById.value(id);
+        int ram = ((info->isSingleInst ? 29 : 35) + numBytes + 3) & ~3;
+        ram += 4;
+        ramTotal += ram;
+        objRam.append(QString("%1 0x%2 %3 %4%5\n")
+                      .arg(info->name)
+                      .arg(QString::number(id, 16).toUpper().rightJustified(8, '0'))
+                      .arg(numBytes)
+                      .arg(ram)
+                      .arg(info->isSingleInst ? "" : QString(" +%1 per instance").arg((12 + numBytes + 3) & ~3)));
+    }
+    objRam.append(QString("# total %1\n").arg(ramTotal));
+
     // Write the flight object inialization files
     flightInitTemplate.replace( QString("$(OBJINC)"), objInc);
     flightInitTemplate.replace( QString("$(OBJINIT)"), flightObjInit);
@@ -77,6 +148,11 @@ bool UAVObjectGeneratorFlight::generate(UAVObjectParser* parser,QString template
 
     // Write the flight object initialization header
     flightInitIncludeTemplate.replace( QString("$(SIZECALCULATION)"), QString().setNum(sizeCalc));
+    flightInitIncludeTemplate.replace( QString("$(NUMOBJECTS)"), QString().setNum(ids.size()));
+    flightInitIncludeTemplate.replace( QString("$(OBJIDS)"), objIds);
+    flightInitIncludeTemplate.replace( QString("$(OBJDESCRIPTORS)"), objDescriptors);
+    flightInitIncludeTemplate.replace( QString("$(OBJFIELDSIZES)"), objFieldSizes);
+    flightInitIncludeTemplate.replace( QString("$(OBJFIELDINDEX)"), objFieldIndex);
     res = writeFileIfDiffrent( flightOutputPath.absolutePath() + "/uavobjectsinit.h",
                      flightInitIncludeTemplate );
     if (!res) {
@@ -84,6 +160,13 @@ bool UAVObjectGeneratorFlight::generate(UAVObjectParser* parser,QString template
         return false;
     }
 
+    // Write the per object RAM report
+    res = writeFileIfDiffrent( flightOutputPath.absolutePath() + "/uavobjectsram.txt", objRam );
+    if (!res) {
+        cout << "Error: Could not write flight object RAM report" << endl;
+        return false;
+    }
+
     // Write the flight object Makefile
     flightMakeTemplate.replace( QString("$(UAVOBJFILENAMES)"), objFileNames);
     flightMakeTemplate.replace( QString("$(UAVOBJNAMES)"), objNames);
@@ -139,6 +222,11 @@ bool UAVObjectGeneratorFlight::process_object(ObjectInfo* info)
     for (int n = 0; n < info->fields.length(); ++n)
     {
         enums.append(QString("// Field %1 information\r\n").arg(info->fields[n]->name));
+        // Bit reported by UAVObjGetDirtyFields(), fields past the 32nd share the last bit
+        enums.append( QString("#define %1_%2_FIELDMASK (1UL << %3)\r\n")
+                      .arg( info->name.toUpper() )
+                      .arg( info->fields[n]->name.toUpper() )
+                      .arg( qMin(n, 31) ) );
         // Only for enum types
         if (info->fields[n]->type == FIELDTYPE_ENUM)
         {
@@ -268,10 +356,12 @@ bool UAVObjectGeneratorFlight::process_object(ObjectInfo* info)
 							.arg( info->name )
 							.arg( info->fields[n]->name ) );
 				setgetfields.append( QString("{\r\n") );
-				setgetfields.append( QString("\tUAVObjSetDataField(%1Handle(), (void*)New%2, offsetof( %1Data, %2), sizeof(%3));\r\n")
+				setgetfields.append( QString("\tUAVObjSetDataFieldMask(%1Handle(), (void*)New%2, offsetof( %1Data, %2), sizeof(%3), %4_%5_FIELDMASK);\r\n")
 							.arg( info->name )
 							.arg( info->fields[n]->name )
-							.arg( fieldTypeStrC[info->fields[n]->type] ) );
+							.arg( fieldTypeStrC[info->fields[n]->type] )
+							.arg( info->name.toUpper() )
+							.arg( info->fields[n]->name.toUpper() ) );
 				setgetfields.append( QString("}\r\n") );
 
 				/* GET */
@@ -296,11 +386,13 @@ bool UAVObjectGeneratorFlight::process_object(ObjectInfo* info)
 								.arg( info->name )
 								.arg( info->fields[n]->name ) );
 				setgetfields.append( QString("{\r\n") );
-				setgetfields.append( QString("\tUAVObjSetDataField(%1Handle(), (void*)New%2, offsetof( %1Data, %2), %3*sizeof(%4));\r\n")
+				setgetfields.append( QString("\tUAVObjSetDataFieldMask(%1Handle(), (void*)New%2, offsetof( %1Data, %2), %3*sizeof(%4), %5_%6_FIELDMASK);\r\n")
 								.arg( info->name )
 								.arg( info->fields[n]->name )
 								.arg( info->fields[n]->numElements )
-								.arg( fieldTypeStrC[info->fields[n]->type] ) );
+								.arg( fieldTypeStrC[info->fields[n]->type] )
+								.arg( info->name.toUpper() )
+								.arg( info->fields[n]->name.toUpper() ) );
 				setgetfields.append( QString("}\r\n") );
 
 				/* GET */
@@ -51,13 +51,17 @@ bool UAVObjectGeneratorGCS::generate(UAVObjectParser* parser,QString templatepat
     QString objInc;
     QString gcsObjInit;
 
+    // All the objects are handed to the manager in one batch
+    gcsObjInit.append("    QList<UAVDataObject*> objs;\n");
+    gcsObjInit.append(QString("    objs.reserve(%1);\n").arg(parser->getNumObjects()));
     for (int objidx = 0; objidx < parser->getNumObjects(); ++objidx) {
         ObjectInfo* info=parser->getObjectByIndex(objidx);
         process_object(info);
 
-        gcsObjInit.append("    objMngr->registerObject( new " + info->name + "() );\n");
+        gcsObjInit.append("    objs.append( new " + info->name + "() );\n");
         objInc.append("#include \"" + info->namelc + ".h\"\n");
     }
+    gcsObjInit.append("    objMngr->registerObjects(objs);\n");
 
     // Write the gcs object inialization files
     gcsInitTemplate.replace( QString("$(OBJINC)"), objInc);
@@ -109,7 +113,6 @@ bool UAVObjectGeneratorGCS::process_object(ObjectInfo* info)
 
     // Replace $(PROPERTIES) and related tags
     QString properties;
-    QString propertiesImpl;
     QString propertyGetters;
     QString propertySetters;
     QString propertyNotifications;
@@ -128,31 +131,33 @@ bool UAVObjectGeneratorGCS::process_object(ObjectInfo* info)
 
         // Determine type
         type = fieldTypeStrCPP[field->type];
-        // Append field
+        // Append field, the accessors are defined inline so that they compile
+        // down to a lock free read or a locked write of the data structure
         if ( field->numElements > 1 ) {
             propertyGetters +=
-                    QString("    Q_INVOKABLE %1 get%2(quint32 index) const;\n")
+                    QString("    Q_INVOKABLE %1 get%2(quint32 index) const\n"
+                            "    {\n"
+                            "        %1 value;\n"
+                            "        int seq;\n"
+                            "        do {\n"
+                            "            seq = readBegin();\n"
+                            "            value = data.%2[index];\n"
+                            "        } while (readRetry(seq));\n"
+                            "        return value;\n"
+                            "    }\n")
                     .arg(type).arg(field->name);
-            propertiesImpl +=
-                    QString("%1 %2::get%3(quint32 index) const\n"
-                            "{\n"
-                            "   QMutexLocker locker(mutex);\n"
-                            "   return data.%3[index];\n"
-                            "}\n")
-                    .arg(type).arg(info->name).arg(field->name);
             propertySetters +=
-                    QString("    void set%1(quint32 index, %2 value);\n")
+                    QString("    void set%1(quint32 index, %2 value)\n"
+                            "    {\n"
+                            "        mutex->lock();\n"
+                            "        bool changed = data.%1[index] != value;\n"
+                            "        beginWrite();\n"
+                            "        data.%1[index] = value;\n"
+                            "        endWrite();\n"
+                            "        mutex->unlock();\n"
+                            "        if (changed) emit %1Changed(index,value);\n"
+                            "    }\n")
                     .arg(field->name).arg(type);
-            propertiesImpl +=
-                    QString("void %1::set%2(quint32 index, %3 value)\n"
-                            "{\n"
-                            "   mutex->lock();\n"
-                            "   bool changed = data.%2[index] != value;\n"
-                            "   data.%2[index] = value;\n"
-                            "   mutex->unlock();\n"
-                            "   if (changed) emit %2Changed(index,value);\n"
-                            "}\n\n")
-                    .arg(info->name).arg(field->name).arg(type);
             propertyNotifications +=
                     QString("    void %1Changed(quint32 index, %2 value);\n")
                     .arg(field->name).arg(type);
@@ -160,28 +165,29 @@ bool UAVObjectGeneratorGCS::process_object(ObjectInfo* info)
             properties += QString("    Q_PROPERTY(%1 %2 READ get%2 WRITE set%2 NOTIFY %2Changed);\n")
                     .arg(type).arg(field->name);
             propertyGetters +=
-                    QString("    Q_INVOKABLE %1 get%2() const;\n")
+                    QString("    Q_INVOKABLE %1 get%2() const\n"
+                            "    {\n"
+                            "        %1 value;\n"
+                            "        int seq;\n"
+                            "        do {\n"
+                            "            seq = readBegin();\n"
+                            "            value = data.%2;\n"
+                            "        } while (readRetry(seq));\n"
+                            "        return value;\n"
+                            "    }\n")
                     .arg(type).arg(field->name);
-            propertiesImpl +=
-                    QString("%1 %2::get%3() const\n"
-                            "{\n"
-                            "   QMutexLocker locker(mutex);\n"
-                            "   return data.%3;\n"
-                            "}\n")
-                    .arg(type).arg(info->name).arg(field->name);
             propertySetters +=
-                    QString("    void set%1(%2 value);\n")
+                    QString("    void set%1(%2 value)\n"
+                            "    {\n"
+                            "        mutex->lock();\n"
+                            "        bool changed = data.%1 != value;\n"
+                            "        beginWrite();\n"
+                            "        data.%1 = value;\n"
+                            "        endWrite();\n"
+                            "        mutex->unlock();\n"
+                            "        if (changed) emit %1Changed(value);\n"
+                            "    }\n")
                     .arg(field->name).arg(type);
-            propertiesImpl +=
-                    QString("void %1::set%2(%3 value)\n"
-                            "{\n"
-                            "   mutex->lock();\n"
-                            "   bool changed = data.%2 != value;\n"
-                            "   data.%2 = value;\n"
-                            "   mutex->unlock();\n"
-                            "   if (changed) emit %2Changed(value);\n"
-                            "}\n\n")
-                    .arg(info->name).arg(field->name).arg(type);
             propertyNotifications +=
                     QString("    void %1Changed(%2 value);\n")
                     .arg(field->name).arg(type);
@@ -197,47 +203,44 @@ bool UAVObjectGeneratorGCS::process_object(ObjectInfo* info)
     outInclude.replace(QString("$(PROPERTY_SETTERS)"), propertySetters);
     outInclude.replace(QString("$(PROPERTY_NOTIFICATIONS)"), propertyNotifications);
 
-    outCode.replace(QString("$(PROPERTIES_IMPL)"), propertiesImpl);
     outCode.replace(QString("$(NOTIFY_PROPERTIES_CHANGED)"), propertyNotificationsImpl);
 
-    // Replace the $(FIELDSINIT) tag
+    // Replace the $(FIELDSINIT) tag, the names and options are emitted as static tables
     QString finit;
+    finit.append( QString("        newFieldInfo.reserve(%1);\n").arg(info->fields.length()) );
     for (int n = 0; n < info->fields.length(); ++n)
     {
         // Setup element names
         QString varElemName = info->fields[n]->name + "ElemNames";
-        finit.append( QString("    QStringList %1;\n").arg(varElemName) );
         QStringList elemNames = info->fields[n]->elementNames;
-        for (int m = 0; m < elemNames.length(); ++m)
-            finit.append( QString("    %1.append(\"%2\");\n")
-                          .arg(varElemName)
-                          .arg(elemNames[m]) );
+        finit.append( QString("        static const char* const %1[] = { \"%2\" };\n")
+                      .arg(varElemName)
+                      .arg(elemNames.join("\", \"")) );
 
         // Only for enum types
         if (info->fields[n]->type == FIELDTYPE_ENUM) {
             QString varOptionName = info->fields[n]->name + "EnumOptions";
-            finit.append( QString("    QStringList %1;\n").arg(varOptionName) );
             QStringList options = info->fields[n]->options;
-            for (int m = 0; m < options.length(); ++m)
-            {
-                finit.append( QString("    %1.append(\"%2\");\n")
-                              .arg(varOptionName)
-                              .arg(options[m]) );
-            }
-            finit.append( QString("    fields.append( new UAVObjectField(QString(\"%1\"), QString(\"%2\"), UAVObjectField::ENUM, %3, %4, QString(\"%5\")));\n")
+            finit.append( QString("        static const char* const %1[] = { \"%2\" };\n")
+                          .arg(varOptionName)
+                          .arg(options.join("\", \"")) );
+            finit.append( QString("        newFieldInfo.append( UAVObjectField::intern(\"%1\", \"%2\", UAVObjectField::ENUM, %3, %4, %5, %6, \"%7\"));\n")
                           .arg(info->fields[n]->name)
                           .arg(info->fields[n]->units)
                           .arg(varElemName)
+                          .arg(elemNames.length())
                           .arg(varOptionName)
+                          .arg(options.length())
                           .arg(info->fields[n]->limitValues));
         }
         // For all other types
         else {
-            finit.append( QString("    fields.append( new UAVObjectField(QString(\"%1\"), QString(\"%2\"), UAVObjectField::%3, %4, QStringList(), QString(\"%5\")));\n")
+            finit.append( QString("        newFieldInfo.append( UAVObjectField::intern(\"%1\", \"%2\", UAVObjectField::%3, %4, %5, NULL, 0, \"%6\"));\n")
                           .arg(info->fields[n]->name)
                           .arg(info->fields[n]->units)
                           .arg(fieldTypeStrCPPClass[info->fields[n]->type])
                           .arg(varElemName)
+                          .arg(elemNames.length())
                           .arg(info->fields[n]->limitValues));
         }
     }
@@ -246,9 +249,16 @@ bool UAVObjectGeneratorGCS::process_object(ObjectInfo* info)
     // Replace the $(DATAFIELDINFO) tag
     QString name;
     QString enums;
+    int offset = 0;
     for (int n = 0; n < info->fields.length(); ++n)
     {
         enums.append(QString("    // Field %1 information\n").arg(info->fields[n]->name));
+        // Generate the position of the field in the packed data
+        enums.append(QString("    /* Byte offset of field %1 in DataFields */\n").arg(info->fields[n]->name));
+        enums.append( QString("    static const quint32 %1_OFFSET = %2;\n")
+                      .arg( info->fields[n]->name.toUpper() )
+                      .arg( offset ) );
+        offset += info->fields[n]->numBytes * info->fields[n]->numElements;
         // Only for enum types
         if (info->fields[n]->type == FIELDTYPE_ENUM)
         {
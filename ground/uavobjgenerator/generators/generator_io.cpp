@@ -25,9 +25,14 @@
  */
 
 #include "generator_io.h"
+#include <QThreadStorage>
 
 using namespace std;
 
+// Files read through readFile(name) by the current thread, used by the
+// incremental mode to find the templates a generator depends on
+static QThreadStorage<QStringList*> inputs;
+
 /**
  * Read a file and return its contents as a string
  */
@@ -51,9 +56,33 @@ QString readFile(QString name,bool do_warn)
  */
 QString readFile(QString name)
 {
+    if (inputs.hasLocalData())
+        inputs.localData()->append(QFileInfo(name).absoluteFilePath());
     return readFile(name,true);
 }
 
+/**
+ * Start recording the input files read on the calling thread
+ */
+void startInputRecording()
+{
+    if (!inputs.hasLocalData())
+        inputs.setLocalData(new QStringList());
+    inputs.localData()->clear();
+}
+
+/**
+ * Return the input files read on the calling thread since startInputRecording()
+ */
+QStringList recordedInputs()
+{
+    if (!inputs.hasLocalData())
+        return QStringList();
+    QStringList files = *inputs.localData();
+    files.removeDuplicates();
+    return files;
+}
+
 /**
  * Write contents of string to file
  */
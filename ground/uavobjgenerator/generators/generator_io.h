@@ -32,10 +32,13 @@
 #include <QFile>
 #include <QTextStream>
 #include <QDir>
+#include <QStringList>
 #include <iostream>
 
 QString readFile(QString name);
 QString readFile(QString name);
+void startInputRecording();
+QStringList recordedInputs();
 bool writeFile(QString name, QString& str);
 bool writeFileIfDiffrent(QString name, QString& str);
 
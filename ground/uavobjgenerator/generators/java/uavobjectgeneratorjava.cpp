@@ -257,6 +257,29 @@ bool UAVObjectGeneratorJava::process_object(ObjectInfo* info)
 
     outCode.replace(QString("$(INITFIELDS)"), initfields);
 
+    // Replace the $(FIELDACCESSORS) tag, typed access by field index so
+    // that reading telemetry neither looks fields up by name nor boxes
+    QString accessors;
+    for (int n = 0; n < info->fields.length(); ++n)
+    {
+        bool isFloat = (info->fields[n]->type == FIELDTYPE_FLOAT32);
+        QString javaType = isFloat ? "float" : "long";
+        QString accessor = isFloat ? "Float" : "Long";
+        accessors.append( QString("	public %1 get%2(int index) { return fields.get(%3).get%4(index); }
+")
+                          .arg( javaType )
+                          .arg( info->fields[n]->name )
+                          .arg( n )
+                          .arg( accessor ) );
+        accessors.append( QString("	public void set%2(int index, %1 value) { fields.get(%3).set%4(value, index); }
+")
+                          .arg( javaType )
+                          .arg( info->fields[n]->name )
+                          .arg( n )
+                          .arg( accessor ) );
+    }
+    outCode.replace(QString("$(FIELDACCESSORS)"), accessors);
+
     // Write the java code
     bool res = writeFileIfDiffrent( javaOutputPath.absolutePath() + "/" + info->name + ".java", outCode );
     if (!res) {
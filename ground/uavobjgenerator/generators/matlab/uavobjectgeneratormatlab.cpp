@@ -53,13 +53,12 @@ bool UAVObjectGeneratorMatlab::generate(UAVObjectParser* parser,QString template
     }
 
     matlabCodeTemplate.replace( QString("$(INSTANTIATIONCODE)"), matlabInstantiationCode);
-    matlabCodeTemplate.replace( QString("$(SWITCHCODE)"), matlabSwitchCode);
-    matlabCodeTemplate.replace( QString("$(CLEANUPCODE)"), matlabCleanupCode);
+    matlabCodeTemplate.replace( QString("$(INDEXCODE)"), matlabIndexCode);
     matlabCodeTemplate.replace( QString("$(SAVEOBJECTSCODE)"), matlabSaveObjectsCode);
     matlabCodeTemplate.replace( QString("$(ALLOCATIONCODE)"), matlabAllocationCode);
     matlabCodeTemplate.replace( QString("$(EXPORTCSVCODE)"), matlabExportCsvCode);
 
-    bool res = writeFile( matlabOutputPath.absolutePath() + "/OPLogConvert.m", matlabCodeTemplate );
+    bool res = writeFileIfDiffrent( matlabOutputPath.absolutePath() + "/OPLogConvert.m", matlabCodeTemplate );
     if (!res) {
         cout << "Error: Could not write output files" << endl;
         return false;
@@ -80,7 +79,6 @@ bool UAVObjectGeneratorMatlab::process_object(ObjectInfo* info, int numBytes)
     QString objectName(info->name);
     // QString objectTableName(objectName + "Objects");
     QString objectTableName(objectName);
-    QString tableIdxName(objectName.toLower() + "Idx");
     QString objectID(QString().setNum(info->id));
     QString numBytesString=QString("%1").arg(numBytes);
 
@@ -91,8 +89,7 @@ bool UAVObjectGeneratorMatlab::process_object(ObjectInfo* info, int numBytes)
     QString type;
     QString instantiationFields;
 
-    matlabInstantiationCode.append("\n\t" + tableIdxName + " = 0;\n");
-    matlabInstantiationCode.append("\t" + objectTableName + "=struct('timestamp', 0");
+    matlabInstantiationCode.append("\n\t" + objectTableName + "=struct('timestamp', 0");
     if (!info->isSingleInst) {
         instantiationFields.append(",...\n\t\t 'instanceID', 0");
     }
@@ -110,28 +107,18 @@ bool UAVObjectGeneratorMatlab::process_object(ObjectInfo* info, int numBytes)
     matlabInstantiationCode.append(instantiationFields);
     matlabInstantiationCode.append("\t" + objectTableName.toUpper() + "_OBJID=" + objectID + ";\n");
     matlabInstantiationCode.append("\t" + objectTableName.toUpper() + "_NUMBYTES=" + numBytesString + ";\n");
-    matlabInstantiationCode.append("\t" + objectName + "FidIdx = [];\n");
 
 
-    //==============================================================//
-    // Generate 'Switch:' code (will replace the $(SWITCHCODE) tag) //
-    //==============================================================//
-    matlabSwitchCode.append("\t\tcase " + objectTableName.toUpper() + "_OBJID\n");
-    matlabSwitchCode.append("\t\t\t" + tableIdxName + " = " + tableIdxName +" + 1;\n");
-    matlabSwitchCode.append("\t\t\t" + objectTableName + "FidIdx(" + tableIdxName + ") = bufferIdx; %#ok<*AGROW>\n");
-    matlabSwitchCode.append("\t\t\tbufferIdx=bufferIdx + " +  objectTableName.toUpper() + "_NUMBYTES+1; %+1 is for CRC\n");
-    if(!info->isSingleInst){
-        matlabSwitchCode.append("\t\t\tbufferIdx = bufferIdx + 2; %An extra two bytes for the instance ID\n");
-    }
-    matlabSwitchCode.append("\t\t\tif " + tableIdxName + " >= length(" + objectTableName +"FidIdx) %Check to see if pre-allocated memory is exhausted\n");
-    matlabSwitchCode.append("\t\t\t\t" + objectTableName + "FidIdx(" + tableIdxName + "*2) = 0;\n");
-    matlabSwitchCode.append("\t\t\tend\n");
+    //==========================================================//
+    // Generate index code (will replace the $(INDEXCODE) tag)  //
+    //==========================================================//
+    // Only updates with the current size, the header is 8 bytes plus 2 for the instance ID
+    QString headerLength(info->isSingleInst ? "8" : "10");
+    matlabIndexCode.append("isUpdate = isObject & objID == " + objectTableName.toUpper() + "_OBJID;\n");
+    matlabIndexCode.append("knownObjID = knownObjID | isUpdate;\n");
+    matlabIndexCode.append(objectTableName + "FidIdx = recordIdx(isUpdate & msgSize == " + headerLength + " + " +
+                           objectTableName.toUpper() + "_NUMBYTES) + 20;\n");
 
-	
-    //============================================================//
-    // Generate 'Cleanup:' code (will replace the $(CLEANUP) tag) //
-    //============================================================//
-    matlabCleanupCode.append(objectTableName + "FidIdx =" + objectTableName + "FidIdx(1:" + tableIdxName +");\n" );
 
     //=================================================================//
     // Generate functions code (will replace the $(ALLOCATIONCODE) tag) //
@@ -142,16 +129,14 @@ bool UAVObjectGeneratorMatlab::process_object(ObjectInfo* info, int numBytes)
 
     //Add timestamp
     allocationFields.append("\t" + objectName + ".timestamp = " +
-                      "double(typecast(buffer(mcolon(" + objectName + "FidIdx "
-                      "- 20, " + objectName + "FidIdx + 4-1 -20)), 'uint32'))';\n");
+                      "double(typecast(OPLogGather(buffer, " + objectName + "FidIdx, -20, 4), 'uint32'))';\n");
 
     int currentIdx=0;
 
     //Add Instance ID, if necessary
     if(!info->isSingleInst){
         allocationFields.append("\t" + objectName + ".instanceID = " +
-                          "double(typecast(buffer(mcolon(" + objectName + "FidIdx "
-                          ", " + objectName + "FidIdx + 2-1)), 'uint16'))';\n");
+                          "double(typecast(OPLogGather(buffer, " + objectName + "FidIdx, 0, 2), 'uint16'))';\n");
         currentIdx+=2;
     }
 
@@ -164,13 +149,13 @@ bool UAVObjectGeneratorMatlab::process_object(ObjectInfo* info, int numBytes)
         // Append field
         if ( info->fields[n]->numElements > 1 ){
             allocationFields.append("\t" + objectName + "." + info->fields[n]->name + " = " +
-                              "reshape(double(typecast(buffer(mcolon(" + objectName + "FidIdx + " + QString("%1").arg(currentIdx) +
-                              ", " + objectName + "FidIdx + " + QString("%1").arg(currentIdx + size.toInt()*info->fields[n]->numElements - 1) + ")), '" + type + "')), "+ QString::number(info->fields[n]->numElements, 10) + ", [] );\n");
+                              "reshape(double(typecast(OPLogGather(buffer, " + objectName + "FidIdx, " + QString("%1").arg(currentIdx) +
+                              ", " + QString("%1").arg(size.toInt()*info->fields[n]->numElements) + "), '" + type + "')), "+ QString::number(info->fields[n]->numElements, 10) + ", [] );\n");
         }
         else{
             allocationFields.append("\t" + objectName + "." + info->fields[n]->name + " = " +
-                              "double(typecast(buffer(mcolon(" + objectName + "FidIdx + " + QString("%1").arg(currentIdx) +
-                              ", " + objectName + "FidIdx + " + QString("%1").arg(currentIdx + size.toInt() - 1) + ")), '" + type + "'))';\n");
+                              "double(typecast(OPLogGather(buffer, " + objectName + "FidIdx, " + QString("%1").arg(currentIdx) +
+                              ", " + size + "), '" + type + "'))';\n");
         }
         currentIdx+=size.toInt()*info->fields[n]->numElements;
     }
@@ -37,8 +37,7 @@ public:
 private:
     bool process_object(ObjectInfo* info, int numBytes);
     QString matlabInstantiationCode;
-    QString matlabSwitchCode;
-    QString matlabCleanupCode;
+    QString matlabIndexCode;
     QString matlabAllocationCode;
     QString matlabSaveObjectsCode;
     QString matlabExportCsvCode;
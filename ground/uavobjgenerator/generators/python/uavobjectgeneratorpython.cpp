@@ -44,7 +44,47 @@ bool UAVObjectGeneratorPython::generate(UAVObjectParser* parser,QString template
         process_object(info);
     }
 
-    return true; // if we come here everything should be fine
+    return process_dtypes(parser);
+}
+
+/**
+ * Generate the NumPy dtypes of all objects, used to decode logs in bulk.
+ * The field order is the packed order the parser sorted the fields into.
+ */
+bool UAVObjectGeneratorPython::process_dtypes(UAVObjectParser* parser)
+{
+    QStringList fieldTypes;
+    fieldTypes << "<i1" << "<i2" << "<i4" << "<u1" << "<u2" << "<u4" << "<f4" << "<u1";
+
+    QString outCode;
+    outCode.append("# Generated by uavobjectgenerator, do not edit.\n");
+    outCode.append("# NumPy structured dtype of every object, keyed by object ID.\n\n");
+    outCode.append("import numpy as np\n\n");
+    outCode.append("# objid: (name, single instance, dtype)\n");
+    outCode.append("DTYPES = {\n");
+    for (int objidx = 0; objidx < parser->getNumObjects(); ++objidx) {
+        ObjectInfo* info = parser->getObjectByIndex(objidx);
+        QStringList fields;
+        for (int n = 0; n < info->fields.length(); ++n) {
+            FieldInfo* field = info->fields[n];
+            if (field->numElements > 1)
+                fields.append(QString("('%1', '%2', (%3,))").arg(field->name).arg(fieldTypes[field->type]).arg(field->numElements));
+            else
+                fields.append(QString("('%1', '%2')").arg(field->name).arg(fieldTypes[field->type]));
+        }
+        outCode.append(QString("    0x%1: ('%2', %3, np.dtype([%4])),\n")
+                       .arg(info->id, 8, 16, QChar('0')).arg(info->name)
+                       .arg(info->isSingleInst ? "True" : "False").arg(fields.join(", ")));
+    }
+    outCode.append("}\n");
+
+    bool res = writeFileIfDiffrent( pythonOutputPath.absolutePath() + "/uavobjectdtypes.py", outCode );
+    if (!res) {
+        cout << "Error: Could not write Python output files" << endl;
+        return false;
+    }
+
+    return true;
 }
 
 /**
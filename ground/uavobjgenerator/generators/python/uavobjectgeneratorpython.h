@@ -36,6 +36,7 @@ public:
 
 private:
     bool process_object(ObjectInfo* info);
+    bool process_dtypes(UAVObjectParser* parser);
 
     QString pythonCodeTemplate;
     QDir pythonCodePath;
@@ -83,17 +83,32 @@ bool UAVObjectGeneratorWireshark::generate(UAVObjectParser* parser,QString templ
 		  uavobjectsOutputPath.absoluteFilePath(uavostaticfiles[i]));
     }
 
-    /* Generate the per-object files from the templates, and keep track of the list of generated filenames */
-    QString objFileNames;
+    /* Collect the tables of all objects into the one dissector */
+    numHandles = 0;
+    numSubtrees = 0;
     for (int objidx = 0; objidx < parser->getNumObjects(); ++objidx) {
       ObjectInfo* info = parser->getObjectByIndex(objidx);
-      process_object(info, uavobjectsOutputPath);
-      objFileNames.append(" packet-op-uavobjects-" + info->namelc + ".c");
+      process_object(info);
+    }
+
+    QString outCode = wiresharkCodeTemplate;
+    outCode.replace(QString("$(OBJECTCOUNT)"), QString::number(parser->getNumObjects()));
+    outCode.replace(QString("$(FIELDHANDLECOUNT)"), QString::number(numHandles));
+    outCode.replace(QString("$(SUBTREECOUNT)"), QString::number(numSubtrees));
+    outCode.replace(QString("$(ENUMFIELDNAMES)"), enums);
+    outCode.replace(QString("$(FIELDLAYOUTS)"), layouts);
+    outCode.replace(QString("$(OBJECTTABLE)"), objectTable);
+    outCode.replace(QString("$(HEADERFIELDS)"), QString("   static hf_register_info hf[] = {\r\n") + headerFields + QString("   };\r\n"));
+
+    bool res = writeFileIfDiffrent( uavobjectsOutputPath.absolutePath() + "/packet-op-uavobjects.c", outCode );
+    if (!res) {
+      cout << "Error: Could not write wireshark code files" << endl;
+      return false;
     }
 
     /* Write the uavobject dissector's Makefile.common */
-    wiresharkMakeTemplate.replace( QString("$(UAVOBJFILENAMES)"), objFileNames);
-    bool res = writeFileIfDiffrent( uavobjectsOutputPath.absolutePath() + "/Makefile.common",
+    wiresharkMakeTemplate.replace( QString("$(UAVOBJFILENAMES)"), " packet-op-uavobjects.c");
+    res = writeFileIfDiffrent( uavobjectsOutputPath.absolutePath() + "/Makefile.common",
                      wiresharkMakeTemplate );
     if (!res) {
       cout << "Error: Could not write wireshark Makefile" << endl;
@@ -105,64 +120,20 @@ bool UAVObjectGeneratorWireshark::generate(UAVObjectParser* parser,QString templ
 
 
 /**
- * Generate the Flight object files
+ * Add an object to the dissector tables
 **/
-bool UAVObjectGeneratorWireshark::process_object(ObjectInfo* info, QDir outputpath)
+bool UAVObjectGeneratorWireshark::process_object(ObjectInfo* info)
 {
     if (info == NULL)
         return false;
 
-    // Prepare output strings
-    QString outCode = wiresharkCodeTemplate;
-
-    // Replace common tags
-    replaceCommonTags(outCode, info);
-
-    // Replace the $(SUBTREES) and $(SUBTREESTATICS) tags
-    QString subtrees;
-    QString subtreestatics;
-    subtreestatics.append( QString("static gint ett_uavo = -1;\r\n") );
-    subtrees.append( QString("&ett_uavo,\r\n") );
-    for (int n = 0; n < info->fields.length(); ++n) {
-      if (info->fields[n]->numElements > 1) {
-	/* Reserve a subtree for each array */
-	subtreestatics.append( QString("static gint ett_%1_%2 = -1;\r\n")
-			       .arg(info->namelc)
-			       .arg(info->fields[n]->name) );
-	subtrees.append( QString("&ett_%1_%2,\r\n")
-			 .arg(info->namelc)
-			 .arg(info->fields[n]->name) );
-      }
-    }
-    outCode.replace(QString("$(SUBTREES)"), subtrees);
-    outCode.replace(QString("$(SUBTREESTATICS)"), subtreestatics);
-
-    // Replace the $(FIELDHANDLES) tag
-    QString type;
-    QString fields;
-    for (int n = 0; n < info->fields.length(); ++n) {
-      fields.append( QString("static int hf_op_uavobjects_%1_%2 = -1;\r\n")
-		     .arg(info->namelc)
-		     .arg(info->fields[n]->name));
-      if (info->fields[n]->numElements > 1) {
-	QStringList elemNames = info->fields[n]->elementNames;
-	for (int m = 0; m < elemNames.length(); ++m) {
-	  fields.append( QString("static int hf_op_uavobjects_%1_%2_%3 = -1;\r\n")
-			 .arg(info->namelc)
-			 .arg(info->fields[n]->name)
-			 .arg(elemNames[m]) );
-	}
-      }
-    }
-    outCode.replace(QString("$(FIELDHANDLES)"), fields);
+    int firstHandle = numHandles;
 
-    // Replace the $(ENUMFIELDNAMES) tag
-    QString enums;
+    // Enum string mappings
     for (int n = 0; n < info->fields.length(); ++n) {
       // Only for enum types
       if (info->fields[n]->type == FIELDTYPE_ENUM) {
-	enums.append(QString("/* Field %1 information */\r\n").arg(info->fields[n]->name) );
-	enums.append(QString("/* Enumeration options for field %1 */\r\n").arg(info->fields[n]->name));
+	enums.append(QString("/* Field %1.%2 information */\r\n").arg(info->name).arg(info->fields[n]->name) );
 	enums.append( QString("static const value_string uavobjects_%1_%2[]= {\r\n")
 		      .arg(info->namelc)
 		      .arg(info->fields[n]->name) );
@@ -177,114 +148,73 @@ bool UAVObjectGeneratorWireshark::process_object(ObjectInfo* info, QDir outputpa
 	enums.append( QString("};\r\n") );
       }
     }
-    outCode.replace(QString("$(ENUMFIELDNAMES)"), enums);
 
-    // Replace the $(POPULATETREE) tag
-    QString treefields;
+    // Field layouts and header fields, an array field is one handle for the
+    // array followed by one per element
+    layouts.append( QString("static const uavo_field_t uavo_%1_fields[] = {\r\n").arg(info->namelc) );
     for (int n = 0; n < info->fields.length(); ++n) {
-      if ( info->fields[n]->numElements == 1 ) {
-	treefields.append( QString("    ptvcursor_add(cursor, hf_op_uavobjects_%1_%2, sizeof(%3), ENC_LITTLE_ENDIAN);\r\n")
-			   .arg(info->namelc)
-			   .arg(info->fields[n]->name)
-			   .arg(fieldTypeStrGlib[info->fields[n]->type]) );
-      } else {
-	treefields.append( QString("    {\r\n") );
-	treefields.append( QString("      proto_item * it = NULL;\r\n") );
-	treefields.append( QString("      it = ptvcursor_add_no_advance(cursor, hf_op_uavobjects_%1_%2, 1, ENC_NA);\r\n")
-			   .arg(info->namelc)
-			   .arg(info->fields[n]->name) );
-	treefields.append( QString("      ptvcursor_push_subtree(cursor, it, ett_%1_%2);\r\n")
-			   .arg(info->namelc)
-			   .arg(info->fields[n]->name) );
-	/* Populate each array element into the table */
-	QStringList elemNames = info->fields[n]->elementNames;
-	for (int m = 0; m < elemNames.length(); ++m) {
-	  treefields.append( QString("    ptvcursor_add(cursor, hf_op_uavobjects_%1_%2_%3, sizeof(%4), ENC_LITTLE_ENDIAN);\r\n")
-			     .arg(info->namelc)
-			     .arg(info->fields[n]->name)
-			     .arg(elemNames[m])
-			     .arg(fieldTypeStrGlib[info->fields[n]->type]) );
-	}
-	treefields.append( QString("      ptvcursor_pop_subtree(cursor);\r\n") );
-	treefields.append( QString("    }\r\n") );
-      }
-    }
-    outCode.replace(QString("$(POPULATETREE)"), treefields);
+      int ett = -1;
+      if (info->fields[n]->numElements > 1)
+	ett = numSubtrees++;
+      layouts.append( QString("\t{ %1, %2, sizeof(%3), %4 },\r\n")
+		      .arg(numHandles)
+		      .arg(ett)
+		      .arg(fieldTypeStrGlib[info->fields[n]->type])
+		      .arg(info->fields[n]->numElements) );
 
-    // Replace the $(HEADERFIELDS) tag
-    QString headerfields;
-    headerfields.append( QString("   static hf_register_info hf[] = {\r\n") );
-    for (int n = 0; n < info->fields.length(); ++n) {
-      // For non-array fields
       if ( info->fields[n]->numElements == 1) {
-	  headerfields.append( QString("\t { &hf_op_uavobjects_%1_%2,\r\n")
-			       .arg( info->namelc )
-			       .arg( info->fields[n]->name ) );
-	  headerfields.append( QString("\t   { \"%1\", \"%2.%3\", %4,\r\n")
-			       .arg( info->fields[n]->name )
-			       .arg( info->namelc )
-			       .arg( info->fields[n]->name )
-			       .arg( fieldTypeStrHf[info->fields[n]->type] ) );
-	  if ( info->fields[n]->type == FIELDTYPE_ENUM ) {
-	    headerfields.append( QString("\t     BASE_DEC, VALS(uavobjects_%1_%2), 0x0, NULL, HFILL \r\n")
-				 .arg( info->namelc )
-				 .arg( info->fields[n]->name ) );
-	  } else if ( info->fields[n]->type == FIELDTYPE_FLOAT32 ) {
-	    headerfields.append( QString("\t     BASE_NONE, NULL, 0x0, NULL, HFILL \r\n") );
-	  } else {
-	    headerfields.append( QString("\t     BASE_DEC_HEX, NULL, 0x0, NULL, HFILL\r\n") );
-	  }
-	  headerfields.append( QString("\t   },\r\n") );
-	  headerfields.append( QString("\t },\r\n") );
+	headerfields_append(info->fields[n]->name,
+			    QString("%1.%2").arg(info->namelc).arg(info->fields[n]->name),
+			    info, info->fields[n]);
       } else {
-	headerfields.append( QString("\t { &hf_op_uavobjects_%1_%2,\r\n")
-			     .arg( info->namelc )
-			     .arg( info->fields[n]->name ) );
-	headerfields.append( QString("\t   { \"%1\", \"%2.%3\", FT_NONE,\r\n")
+	headerFields.append( QString("\t { &hf_uavo[%1],\r\n").arg(numHandles++) );
+	headerFields.append( QString("\t   { \"%1\", \"%2.%3\", FT_NONE,\r\n")
 			     .arg( info->fields[n]->name )
 			     .arg( info->namelc )
 			     .arg( info->fields[n]->name ) );
-	headerfields.append( QString("\t     BASE_NONE, NULL, 0x0, NULL, HFILL\r\n") );
-	headerfields.append( QString("\t   },\r\n") );
-	headerfields.append( QString("\t },\r\n") );
+	headerFields.append( QString("\t     BASE_NONE, NULL, 0x0, NULL, HFILL\r\n") );
+	headerFields.append( QString("\t   },\r\n") );
+	headerFields.append( QString("\t },\r\n") );
 
 	QStringList elemNames = info->fields[n]->elementNames;
 	for (int m = 0; m < elemNames.length(); ++m) {
-	  headerfields.append( QString("\t { &hf_op_uavobjects_%1_%2_%3,\r\n")
-			       .arg( info->namelc )
-			       .arg( info->fields[n]->name )
-			       .arg( elemNames[m]) );
-	  headerfields.append( QString("\t   { \"%1\", \"%2.%3.%4\", %5,\r\n")
-			       .arg( elemNames[m] )
-			       .arg( info->namelc )
-			       .arg( info->fields[n]->name )
-			       .arg( elemNames[m] )
-			       .arg( fieldTypeStrHf[info->fields[n]->type] ) );
-	  if ( info->fields[n]->type == FIELDTYPE_ENUM ) {
-	    headerfields.append( QString("\t     BASE_DEC, VALS(uavobjects_%1_%2), 0x0, NULL, HFILL \r\n")
-				 .arg( info->namelc )
-				 .arg( info->fields[n]->name ) );
-	  } else if ( info->fields[n]->type == FIELDTYPE_FLOAT32 ) {
-	    headerfields.append( QString("\t     BASE_NONE, NULL, 0x0, NULL, HFILL \r\n") );
-	  } else {
-	    headerfields.append( QString("\t     BASE_DEC_HEX, NULL, 0x0, NULL, HFILL\r\n") );
-	  }
-	  headerfields.append( QString("\t   },\r\n") );
-	  headerfields.append( QString("\t },\r\n") );
+	  headerfields_append(elemNames[m],
+			      QString("%1.%2.%3").arg(info->namelc).arg(info->fields[n]->name).arg(elemNames[m]),
+			      info, info->fields[n]);
 	}
       }
     }
-    headerfields.append( QString("   };\r\n") );
-    outCode.replace(QString("$(HEADERFIELDS)"), headerfields);
+    layouts.append( QString("};\r\n") );
 
-    // Write the flight code
-    bool res = writeFileIfDiffrent( outputpath.absolutePath() + "/packet-op-uavobjects-" + info->namelc + ".c", outCode );
-    if (!res) {
-        cout << "Error: Could not write wireshark code files" << endl;
-        return false;
-    }
+    objectTable.append( QString("\t{ %1, \"%2\", \"UAVO %2\", \"uavo-%3\", uavo_%3_fields, array_length(uavo_%3_fields), %4, %5 },\r\n")
+			.arg(QString("0x") + QString().setNum(info->id, 16).toUpper())
+			.arg(info->name)
+			.arg(info->namelc)
+			.arg(firstHandle)
+			.arg(numHandles - firstHandle) );
 
     return true;
 }
 
-
+/**
+ * Add the header field of one value, a single value field or an element
+**/
+void UAVObjectGeneratorWireshark::headerfields_append(const QString& name, const QString& abbrev, ObjectInfo* info, FieldInfo* field)
+{
+    headerFields.append( QString("\t { &hf_uavo[%1],\r\n").arg(numHandles++) );
+    headerFields.append( QString("\t   { \"%1\", \"%2\", %3,\r\n")
+			 .arg( name )
+			 .arg( abbrev )
+			 .arg( fieldTypeStrHf[field->type] ) );
+    if ( field->type == FIELDTYPE_ENUM ) {
+      headerFields.append( QString("\t     BASE_DEC, VALS(uavobjects_%1_%2), 0x0, NULL, HFILL \r\n")
+			   .arg( info->namelc )
+			   .arg( field->name ) );
+    } else if ( field->type == FIELDTYPE_FLOAT32 ) {
+      headerFields.append( QString("\t     BASE_NONE, NULL, 0x0, NULL, HFILL \r\n") );
+    } else {
+      headerFields.append( QString("\t     BASE_DEC_HEX, NULL, 0x0, NULL, HFILL\r\n") );
+    }
+    headerFields.append( QString("\t   },\r\n") );
+    headerFields.append( QString("\t },\r\n") );
+}
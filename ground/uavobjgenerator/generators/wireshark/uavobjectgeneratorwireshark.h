@@ -40,7 +40,15 @@ public:
     QDir wiresharkOutputPath;
 
 private:
-    bool process_object(ObjectInfo* info, QDir outputpath);
+    bool process_object(ObjectInfo* info);
+    void headerfields_append(const QString& name, const QString& abbrev, ObjectInfo* info, FieldInfo* field);
+
+    QString enums;
+    QString layouts;
+    QString objectTable;
+    QString headerFields;
+    int numHandles;
+    int numSubtrees;
 
 };
 
@@ -27,6 +27,9 @@
 #include <QFile>
 #include <QString>
 #include <QStringList>
+#include <QCryptographicHash>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
 #include <iostream>
 
 #include "generators/java/uavobjectgeneratorjava.h"
@@ -42,6 +45,110 @@
 
 using namespace std;
 
+/**
+ * Result of parsing one XML file on a worker thread
+ */
+typedef struct {
+    UAVObjectParser* parser;
+    QString error;
+} ParseResult;
+
+/**
+ * Result of running one language generator on a worker thread
+ */
+typedef struct {
+    QString language;
+    bool ok;
+    QStringList inputs;
+} GenerateResult;
+
+static ParseResult parseXMLFile(const QFileInfo& fileinfo)
+{
+    ParseResult result;
+    result.parser = new UAVObjectParser();
+    QString filename = fileinfo.fileName();
+    QString xmlstr = readFile(fileinfo.absoluteFilePath());
+    result.error = result.parser->parseXML(xmlstr, filename);
+    return result;
+}
+
+static GenerateResult runGenerator(QString language, UAVObjectParser* parser, QString templatepath, QString outputpath)
+{
+    GenerateResult result;
+    result.language = language;
+    startInputRecording();
+    if (language == "flight") {
+        UAVObjectGeneratorFlight flightgen;
+        result.ok = flightgen.generate(parser,templatepath,outputpath);
+    } else if (language == "gcs") {
+        UAVObjectGeneratorGCS gcsgen;
+        result.ok = gcsgen.generate(parser,templatepath,outputpath);
+    } else if (language == "java") {
+        UAVObjectGeneratorJava javagen;
+        result.ok = javagen.generate(parser,templatepath,outputpath);
+    } else if (language == "python") {
+        UAVObjectGeneratorPython pygen;
+        result.ok = pygen.generate(parser,templatepath,outputpath);
+    } else if (language == "matlab") {
+        UAVObjectGeneratorMatlab matlabgen;
+        result.ok = matlabgen.generate(parser,templatepath,outputpath);
+    } else {
+        UAVObjectGeneratorWireshark wiresharkgen;
+        result.ok = wiresharkgen.generate(parser,templatepath,outputpath);
+    }
+    result.inputs = recordedInputs();
+    return result;
+}
+
+/**
+ * Hash of everything a language output depends on: the generator itself,
+ * the XML files, the object selection and the templates it read last time
+ */
+static QByteArray inputsHash(const QStringList& files, const QString& selection)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(selection.toUtf8());
+    foreach (QString name, files) {
+        QFile file(name);
+        hash.addData(name.toUtf8());
+        hash.addData("\0", 1);
+        if (file.open(QFile::ReadOnly))
+            hash.addData(file.readAll());
+    }
+    return hash.result().toHex();
+}
+
+static QString manifestName(const QString& outputpath, const QString& language)
+{
+    return outputpath + "." + language + ".inputs";
+}
+
+/**
+ * The outputs of a language are up to date if the inputs listed in its
+ * manifest, written by the last run, still hash to the same value
+ */
+static bool isUpToDate(const QString& outputpath, const QString& language, const QStringList& common, const QString& selection)
+{
+    QFile file(manifestName(outputpath, language));
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+        return false;
+    QStringList lines = QString::fromUtf8(file.readAll()).split('\n', QString::SkipEmptyParts);
+    if (lines.isEmpty())
+        return false;
+    QByteArray stored = lines.takeFirst().toAscii();
+    return stored == inputsHash(common + lines, selection);
+}
+
+static void writeManifest(const QString& outputpath, const QString& language, const QStringList& common, const QString& selection, const QStringList& inputs)
+{
+    QFile file(manifestName(outputpath, language));
+    if (!file.open(QFile::WriteOnly | QFile::Text | QFile::Truncate))
+        return;
+    QStringList lines;
+    lines << inputsHash(common + inputs, selection) << inputs;
+    file.write(lines.join("\n").toUtf8() + "\n");
+}
+
 /**
  * print usage info
  */
@@ -59,6 +166,7 @@ void usage() {
     cout << "\t-none          build no language - just parse xml's" << endl;
     cout << "\t-h             this help" << endl;
     cout << "\t-v             verbose" << endl;
+    cout << "\t-incremental   skip languages whose inputs did not change since the last run" << endl;
     cout << "\tinput_path     path to UAVObject definition (.xml) files." << endl;
     cout << "\ttemplate_path  path to the root of the OpenPilot source tree." << endl;
     cout << "\tUAVObjXY       name of a specific UAVObject to be built." << endl;
@@ -107,6 +215,7 @@ int main(int argc, char *argv[])
     bool do_matlab=(arguments_stringlist.removeAll("-matlab")>0);
     bool do_wireshark=(arguments_stringlist.removeAll("-wireshark")>0);
     bool do_none=(arguments_stringlist.removeAll("-none")>0); //
+    bool do_incremental=(arguments_stringlist.removeAll("-incremental")>0);
 
     bool do_all=((do_gcs||do_flight||do_java||do_python||do_matlab)==false);
     bool do_allObjects=true;
@@ -142,8 +251,9 @@ int main(int argc, char *argv[])
     xmlPath.setNameFilters(filters);
     QFileInfoList xmlList = xmlPath.entryInfoList();
 
-    // Read in each XML file and parse object(s) in them
-    
+    // Select the XML files to parse
+    QString selection = objects_stringlist.join(",");
+    QFileInfoList parseList;
     for (int n = 0; n < xmlList.length(); ++n) {
         QFileInfo fileinfo = xmlList[n];
         if (!do_allObjects) {
@@ -155,18 +265,54 @@ int main(int argc, char *argv[])
         }
         if (verbose)
           cout << "Parsing XML file: " << fileinfo.fileName().toStdString() << endl;
-        QString filename = fileinfo.fileName();
-        QString xmlstr = readFile(fileinfo.absoluteFilePath());
+        parseList << fileinfo;
+    }
 
-        QString res = parser->parseXML(xmlstr, filename);
+    // Languages to generate
+    QStringList languages;
+    if (do_flight|do_all)
+        languages << "flight";
+    if (do_gcs|do_all)
+        languages << "gcs";
+    if (do_java|do_all)
+        languages << "java";
+    if (do_python|do_all)
+        languages << "python";
+    if (do_matlab|do_all)
+        languages << "matlab";
+    if (do_wireshark|do_all)
+        languages << "wireshark";
+    if (do_none)
+        languages.clear();
+
+    // In incremental mode, drop the languages whose outputs are up to date
+    QStringList commonInputs;
+    commonInputs << QCoreApplication::applicationFilePath();
+    foreach (QFileInfo fileinfo, parseList)
+        commonInputs << fileinfo.absoluteFilePath();
+    if (do_incremental && objects_stringlist.isEmpty()) {
+        foreach (QString language, languages) {
+            if (isUpToDate(outputpath, language, commonInputs, selection)) {
+                cout << language.toStdString() << " code is up to date" << endl;
+                languages.removeAll(language);
+            }
+        }
+        if (languages.isEmpty() && !do_none)
+            return RETURN_OK;
+    }
 
-        if (!res.isNull()) {
+    // Read in each XML file and parse object(s) in them, in parallel
+    QList<ParseResult> parsed = QtConcurrent::blockingMapped< QList<ParseResult> >(parseList, parseXMLFile);
+    for (int n = 0; n < parsed.length(); ++n) {
+        if (!parsed[n].error.isNull()) {
 	    if (!verbose) {
-               cout << "Error in XML file: " << fileinfo.fileName().toStdString() << endl;
+               cout << "Error in XML file: " << parseList[n].fileName().toStdString() << endl;
             }
-            cout << "Error parsing " << res.toStdString() << endl;
+            cout << "Error parsing " << parsed[n].error.toStdString() << endl;
             return RETURN_ERR_XML;
         }
+        parser->takeObjects(parsed[n].parser);
+        delete parsed[n].parser;
     }
 
     if (objects_stringlist.length() > 0) {
@@ -201,46 +347,18 @@ int main(int argc, char *argv[])
     if (do_none)
       return RETURN_OK;     
 
-    // generate flight code if wanted
-    if (do_flight|do_all) {
-        cout << "generating flight code" << endl ;
-        UAVObjectGeneratorFlight flightgen;
-        flightgen.generate(parser,templatepath,outputpath);
+    // generate the languages in parallel, each one writes to its own directory
+    QList< QFuture<GenerateResult> > futures;
+    foreach (QString language, languages) {
+        cout << "generating " << language.toStdString() << " code" << endl ;
+        futures << QtConcurrent::run(runGenerator, language, parser, templatepath, outputpath);
     }
-
-    // generate gcs code if wanted
-    if (do_gcs|do_all) {
-        cout << "generating gcs code" << endl ;
-        UAVObjectGeneratorGCS gcsgen;
-        gcsgen.generate(parser,templatepath,outputpath);
-    }
-
-    // generate java code if wanted
-    if (do_java|do_all) {
-        cout << "generating java code" << endl ;
-        UAVObjectGeneratorJava javagen;
-        javagen.generate(parser,templatepath,outputpath);
-    }
-
-    // generate python code if wanted
-    if (do_python|do_all) {
-        cout << "generating python code" << endl ;
-        UAVObjectGeneratorPython pygen;
-        pygen.generate(parser,templatepath,outputpath);
-    }
-
-    // generate matlab code if wanted
-    if (do_matlab|do_all) {
-        cout << "generating matlab code" << endl ;
-        UAVObjectGeneratorMatlab matlabgen;
-        matlabgen.generate(parser,templatepath,outputpath);
-    }
-
-    // generate wireshark plugin if wanted
-    if (do_wireshark|do_all) {
-        cout << "generating wireshark code" << endl ;
-        UAVObjectGeneratorWireshark wiresharkgen;
-        wiresharkgen.generate(parser,templatepath,outputpath);
+    foreach (QFuture<GenerateResult> future, futures) {
+        GenerateResult result = future.result();
+        if (result.ok)
+            writeManifest(outputpath, result.language, commonInputs, selection, result.inputs);
+        else
+            QFile::remove(manifestName(outputpath, result.language));
     }
 
     return RETURN_OK;
@@ -67,6 +67,18 @@ ObjectInfo* UAVObjectParser::getObjectByIndex(int objIndex)
     return objInfo[objIndex];
 }
 
+/**
+ * Move the objects parsed by another parser to the end of this one,
+ * used to merge XML files that were parsed in parallel
+ */
+void UAVObjectParser::takeObjects(UAVObjectParser* other)
+{
+    objInfo.append(other->objInfo);
+    other->objInfo.clear();
+    all_units.append(other->all_units);
+    all_units.removeDuplicates();
+}
+
 /**
  * Get the name of the object
  */
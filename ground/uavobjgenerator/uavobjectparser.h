@@ -113,6 +113,7 @@ public:
 
     ObjectInfo* getObjectByIndex(int objIndex);
     int getNumBytes(int objIndex);
+    void takeObjects(UAVObjectParser* other);
     QStringList all_units;
 
 private:
@@ -0,0 +1,435 @@
+/**
+ ******************************************************************************
+ *
+ * @file       oplog.c
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Reader and writer of the compact binary log, see oplog.h
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "oplog.h"
+#include <string.h>
+
+#define TAG_DELTA_MAX		0x7F
+#define TAG_RECORD_LONG		0x80
+#define TAG_SYNC		0x81
+#define TAG_INDEX		0x82
+#define UAVTALK_SYNC_VAL	0x3C
+#define UAVTALK_MIN_LENGTH	8	// header of a single instance object
+#define VARINT_MAX_LENGTH	5
+
+static const uint8_t headerMagic[4] = { 'O', 'P', 'L', 'C' };
+static const uint8_t syncMagic[7] = { 'O', 'P', 'L', 'S', 'Y', 'N', 'C' };
+static const uint8_t footerMagic[4] = { 'O', 'P', 'L', 'X' };
+
+// CRC-8 with polynomial 0x07 as used by UAVTalk
+static const uint8_t crcTable[256] = {
+	0x00, 0x07, 0x0e, 0x09, 0x1c, 0x1b, 0x12, 0x15,
+	0x38, 0x3f, 0x36, 0x31, 0x24, 0x23, 0x2a, 0x2d,
+	0x70, 0x77, 0x7e, 0x79, 0x6c, 0x6b, 0x62, 0x65,
+	0x48, 0x4f, 0x46, 0x41, 0x54, 0x53, 0x5a, 0x5d,
+	0xe0, 0xe7, 0xee, 0xe9, 0xfc, 0xfb, 0xf2, 0xf5,
+	0xd8, 0xdf, 0xd6, 0xd1, 0xc4, 0xc3, 0xca, 0xcd,
+	0x90, 0x97, 0x9e, 0x99, 0x8c, 0x8b, 0x82, 0x85,
+	0xa8, 0xaf, 0xa6, 0xa1, 0xb4, 0xb3, 0xba, 0xbd,
+	0xc7, 0xc0, 0xc9, 0xce, 0xdb, 0xdc, 0xd5, 0xd2,
+	0xff, 0xf8, 0xf1, 0xf6, 0xe3, 0xe4, 0xed, 0xea,
+	0xb7, 0xb0, 0xb9, 0xbe, 0xab, 0xac, 0xa5, 0xa2,
+	0x8f, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9d, 0x9a,
+	0x27, 0x20, 0x29, 0x2e, 0x3b, 0x3c, 0x35, 0x32,
+	0x1f, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0d, 0x0a,
+	0x57, 0x50, 0x59, 0x5e, 0x4b, 0x4c, 0x45, 0x42,
+	0x6f, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7d, 0x7a,
+	0x89, 0x8e, 0x87, 0x80, 0x95, 0x92, 0x9b, 0x9c,
+	0xb1, 0xb6, 0xbf, 0xb8, 0xad, 0xaa, 0xa3, 0xa4,
+	0xf9, 0xfe, 0xf7, 0xf0, 0xe5, 0xe2, 0xeb, 0xec,
+	0xc1, 0xc6, 0xcf, 0xc8, 0xdd, 0xda, 0xd3, 0xd4,
+	0x69, 0x6e, 0x67, 0x60, 0x75, 0x72, 0x7b, 0x7c,
+	0x51, 0x56, 0x5f, 0x58, 0x4d, 0x4a, 0x43, 0x44,
+	0x19, 0x1e, 0x17, 0x10, 0x05, 0x02, 0x0b, 0x0c,
+	0x21, 0x26, 0x2f, 0x28, 0x3d, 0x3a, 0x33, 0x34,
+	0x4e, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5c, 0x5b,
+	0x76, 0x71, 0x78, 0x7f, 0x6a, 0x6d, 0x64, 0x63,
+	0x3e, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2c, 0x2b,
+	0x06, 0x01, 0x08, 0x0f, 0x1a, 0x1d, 0x14, 0x13,
+	0xae, 0xa9, 0xa0, 0xa7, 0xb2, 0xb5, 0xbc, 0xbb,
+	0x96, 0x91, 0x98, 0x9f, 0x8a, 0x8d, 0x84, 0x83,
+	0xde, 0xd9, 0xd0, 0xd7, 0xc2, 0xc5, 0xcc, 0xcb,
+	0xe6, 0xe1, 0xe8, 0xef, 0xfa, 0xfd, 0xf4, 0xf3,
+};
+
+static void put16(uint8_t *out, uint16_t value)
+{
+	out[0] = value & 0xFF;
+	out[1] = value >> 8;
+}
+
+static void put32(uint8_t *out, uint32_t value)
+{
+	out[0] = value & 0xFF;
+	out[1] = (value >> 8) & 0xFF;
+	out[2] = (value >> 16) & 0xFF;
+	out[3] = value >> 24;
+}
+
+static uint16_t get16(const uint8_t *in)
+{
+	return in[0] | (in[1] << 8);
+}
+
+static uint32_t get32(const uint8_t *in)
+{
+	return in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+/**
+ * Update a UAVTalk CRC-8 with a block of data
+ */
+uint8_t OPLogCRC(uint8_t crc, const uint8_t *data, uint32_t length)
+{
+	while (length--) {
+		crc = crcTable[crc ^ *data++];
+	}
+	return crc;
+}
+
+/**
+ * Start a new log
+ * \param[in] sync_interval Bytes between sync frames, 0 for OPLOG_DEFAULT_SYNC_INTERVAL
+ */
+void OPLogWriterInit(struct oplog_writer *writer, uint16_t sync_interval)
+{
+	writer->offset = 0;
+	writer->time = 0;
+	writer->sync_offset = 0;
+	writer->sequence = 0;
+	writer->sync_interval = sync_interval ? sync_interval : OPLOG_DEFAULT_SYNC_INTERVAL;
+}
+
+/**
+ * Write the file header, the first frame of the log
+ * \param[out] out OPLOG_HEADER_LENGTH bytes
+ * \return Bytes written
+ */
+uint32_t OPLogWriteHeader(struct oplog_writer *writer, uint8_t *out, uint8_t source, uint32_t objects_hash)
+{
+	memcpy(out, headerMagic, sizeof(headerMagic));
+	out[4] = OPLOG_VERSION;
+	out[5] = source;
+	put16(&out[6], writer->sync_interval);
+	put32(&out[8], objects_hash);
+	put32(&out[12], 0);
+
+	writer->offset += OPLOG_HEADER_LENGTH;
+	return OPLOG_HEADER_LENGTH;
+}
+
+/**
+ * Write a sync frame, the following deltas are relative to time.
+ * OPLogWriteRecordHeader() writes them as needed, this forces one.
+ * \param[out] out OPLOG_SYNC_LENGTH bytes
+ * \return Bytes written
+ */
+uint32_t OPLogWriteSync(struct oplog_writer *writer, uint8_t *out, uint32_t time)
+{
+	out[0] = TAG_SYNC;
+	memcpy(&out[1], syncMagic, sizeof(syncMagic));
+	put32(&out[8], time);
+	put32(&out[12], writer->sequence);
+	out[16] = OPLogCRC(0, out, OPLOG_SYNC_LENGTH - 1);
+
+	writer->sync_offset = writer->offset;
+	writer->time = time;
+	writer->offset += OPLOG_SYNC_LENGTH;
+	++writer->sequence;
+	return OPLOG_SYNC_LENGTH;
+}
+
+/**
+ * Write what goes in front of a packet, a sync frame when one is due and the
+ * record tag. The caller writes the length bytes of the packet right after.
+ * \param[out] out OPLOG_RECORD_MAX_OVERHEAD bytes
+ * \param[in] time Time of the record in ms since the start of the log
+ * \param[in] length Packet length, CRC included
+ * \return Bytes written
+ */
+uint32_t OPLogWriteRecordHeader(struct oplog_writer *writer, uint8_t *out, uint32_t time, uint16_t length)
+{
+	uint32_t n = 0;
+
+	if (writer->sequence == 0 || time < writer->time ||
+		writer->offset - writer->sync_offset >= writer->sync_interval) {
+		n = OPLogWriteSync(writer, out, time);
+	}
+
+	uint32_t delta = time - writer->time;
+	uint32_t start = n;
+	if (delta <= TAG_DELTA_MAX) {
+		out[n++] = delta;
+	} else {
+		out[n++] = TAG_RECORD_LONG;
+		while (delta > 0x7F) {
+			out[n++] = (delta & 0x7F) | 0x80;
+			delta >>= 7;
+		}
+		out[n++] = delta;
+	}
+
+	writer->time = time;
+	writer->offset += (n - start) + length;
+	return n;
+}
+
+/**
+ * Write a record, see OPLogWriteRecordHeader()
+ * \param[out] out OPLOG_RECORD_MAX_OVERHEAD + length bytes
+ * \return Bytes written
+ */
+uint32_t OPLogWriteRecord(struct oplog_writer *writer, uint8_t *out, uint32_t time, const uint8_t *packet, uint16_t length)
+{
+	uint32_t n = OPLogWriteRecordHeader(writer, out, time, length);
+	memcpy(&out[n], packet, length);
+	return n + length;
+}
+
+/**
+ * Length of the index frame and footer for count entries
+ */
+uint32_t OPLogIndexLength(uint32_t count)
+{
+	return 1 + sizeof(uint32_t) + count * OPLOG_INDEX_ENTRY_LENGTH + OPLOG_FOOTER_LENGTH;
+}
+
+/**
+ * Write the index and footer, the log is complete afterwards
+ * \param[out] out OPLogIndexLength(count) bytes
+ * \return Bytes written
+ */
+uint32_t OPLogWriteIndex(struct oplog_writer *writer, uint8_t *out, const struct oplog_index_entry *entries, uint32_t count)
+{
+	uint32_t n = 0;
+
+	out[n++] = TAG_INDEX;
+	put32(&out[n], count);
+	n += sizeof(uint32_t);
+	for (uint32_t i = 0; i < count; ++i) {
+		put32(&out[n], entries[i].time);
+		put32(&out[n + 4], entries[i].offset);
+		n += OPLOG_INDEX_ENTRY_LENGTH;
+	}
+	put32(&out[n], writer->offset);
+	memcpy(&out[n + 4], footerMagic, sizeof(footerMagic));
+	n += OPLOG_FOOTER_LENGTH;
+
+	writer->offset += n;
+	return n;
+}
+
+/**
+ * Whether data starts with the header of a compact log this code reads
+ */
+bool OPLogIsCompact(const uint8_t *data, uint32_t size)
+{
+	return size >= OPLOG_HEADER_LENGTH && memcmp(data, headerMagic, sizeof(headerMagic)) == 0 &&
+		data[4] == OPLOG_VERSION;
+}
+
+/**
+ * Read a log held in memory, e.g. a mapped file
+ * \return false if data is not a compact log
+ */
+bool OPLogReaderInit(struct oplog_reader *reader, const uint8_t *data, uint32_t size)
+{
+	if (!OPLogIsCompact(data, size)) {
+		return false;
+	}
+
+	reader->data = data;
+	reader->end = size;
+	reader->pos = OPLOG_HEADER_LENGTH;
+	reader->time = 0;
+	reader->synced = false;
+	reader->resyncs = 0;
+	reader->source = data[5];
+	reader->sync_interval = get16(&data[6]);
+	reader->objects_hash = get32(&data[8]);
+	reader->index_offset = 0;
+	reader->index_count = 0;
+
+	// The index is only trusted if the footer, the frame and its size agree
+	if (size >= OPLOG_HEADER_LENGTH + OPLogIndexLength(0) &&
+		memcmp(&data[size - sizeof(footerMagic)], footerMagic, sizeof(footerMagic)) == 0) {
+		uint32_t index = get32(&data[size - OPLOG_FOOTER_LENGTH]);
+		if (index >= OPLOG_HEADER_LENGTH && index <= size - OPLogIndexLength(0) && data[index] == TAG_INDEX) {
+			uint32_t count = get32(&data[index + 1]);
+			if (count <= (size - index) / OPLOG_INDEX_ENTRY_LENGTH &&
+				index + OPLogIndexLength(count) == size) {
+				reader->index_offset = index;
+				reader->index_count = count;
+				reader->end = index;
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Check for a valid sync frame at pos
+ */
+static bool isSync(const struct oplog_reader *reader, uint32_t pos)
+{
+	const uint8_t *frame = &reader->data[pos];
+	return pos + OPLOG_SYNC_LENGTH <= reader->end && frame[0] == TAG_SYNC &&
+		memcmp(&frame[1], syncMagic, sizeof(syncMagic)) == 0 &&
+		OPLogCRC(0, frame, OPLOG_SYNC_LENGTH - 1) == frame[OPLOG_SYNC_LENGTH - 1];
+}
+
+/**
+ * Move to just after the next valid sync frame, counting skipped data
+ */
+static bool findSync(struct oplog_reader *reader)
+{
+	uint32_t start = reader->pos;
+
+	while (reader->pos + OPLOG_SYNC_LENGTH <= reader->end) {
+		const uint8_t *next = (const uint8_t *) memchr(&reader->data[reader->pos], TAG_SYNC, reader->end - reader->pos);
+		if (next == NULL) {
+			break;
+		}
+		reader->pos = next - reader->data;
+		if (isSync(reader, reader->pos)) {
+			if (reader->pos != start) {
+				++reader->resyncs;
+			}
+			reader->time = get32(&next[8]);
+			reader->pos += OPLOG_SYNC_LENGTH;
+			reader->synced = true;
+			return true;
+		}
+		++reader->pos;
+	}
+
+	if (start < reader->end) {
+		++reader->resyncs;
+	}
+	reader->pos = reader->end;
+	return false;
+}
+
+/**
+ * Parse the record frame at the reader position
+ * \return false if it is corrupted
+ */
+static bool parseRecord(struct oplog_reader *reader, struct oplog_record *record)
+{
+	const uint8_t *data = reader->data;
+	uint32_t pos = reader->pos;
+	uint8_t tag = data[pos++];
+	uint32_t delta = 0;
+
+	if (tag <= TAG_DELTA_MAX) {
+		delta = tag;
+	} else if (tag == TAG_RECORD_LONG) {
+		uint32_t shift = 0;
+		uint8_t byte;
+		do {
+			if (pos >= reader->end || shift >= 7 * VARINT_MAX_LENGTH) {
+				return false;
+			}
+			byte = data[pos++];
+			delta |= (uint32_t)(byte & 0x7F) << shift;
+			shift += 7;
+		} while (byte & 0x80);
+	} else {
+		return false;
+	}
+
+	if (pos + UAVTALK_MIN_LENGTH + 1 > reader->end || data[pos] != UAVTALK_SYNC_VAL) {
+		return false;
+	}
+	uint16_t length = get16(&data[pos + 2]);
+	if (length < UAVTALK_MIN_LENGTH || (uint32_t)length + 1 > reader->end - pos ||
+		OPLogCRC(0, &data[pos], length) != data[pos + length]) {
+		return false;
+	}
+
+	reader->time += delta;
+	record->time = reader->time;
+	record->offset = reader->pos;
+	record->packet = &data[pos];
+	record->length = length + 1;
+	reader->pos = pos + length + 1;
+	return true;
+}
+
+/**
+ * Read the next record, skipping over corrupted data
+ * \param[out] record The record, its packet points into the reader data
+ * \return false at the end of the log
+ */
+bool OPLogReadRecord(struct oplog_reader *reader, struct oplog_record *record)
+{
+	while (1) {
+		if (!reader->synced && !findSync(reader)) {
+			return false;
+		}
+		if (reader->pos >= reader->end) {
+			return false;
+		}
+		if (isSync(reader, reader->pos)) {
+			reader->time = get32(&reader->data[reader->pos + 8]);
+			reader->pos += OPLOG_SYNC_LENGTH;
+			continue;
+		}
+		if (parseRecord(reader, record)) {
+			return true;
+		}
+		reader->synced = false;
+		++reader->pos;
+	}
+}
+
+/**
+ * Continue reading at a sync frame, e.g. one from the index
+ */
+bool OPLogReaderSeek(struct oplog_reader *reader, uint32_t offset)
+{
+	if (offset < OPLOG_HEADER_LENGTH || offset >= reader->end) {
+		return false;
+	}
+	reader->pos = offset;
+	reader->synced = false;
+	return true;
+}
+
+/**
+ * Get an entry of the index
+ * \return false if there is no such entry
+ */
+bool OPLogIndexEntry(const struct oplog_reader *reader, uint32_t n, struct oplog_index_entry *entry)
+{
+	if (n >= reader->index_count) {
+		return false;
+	}
+	const uint8_t *in = &reader->data[reader->index_offset + 1 + sizeof(uint32_t) + n * OPLOG_INDEX_ENTRY_LENGTH];
+	entry->time = get32(in);
+	entry->offset = get32(&in[4]);
+	return true;
+}
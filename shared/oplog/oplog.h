@@ -0,0 +1,133 @@
+/**
+ ******************************************************************************
+ *
+ * @file       oplog.h
+ * @author     The OpenPilot Team, http://www.openpilot.org Copyright (C) 2012.
+ * @brief      Compact binary log format shared by the flight logger and the GCS
+ * @see        The GNU Public License (GPL) Version 3
+ *
+ *****************************************************************************/
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef OPLOG_H
+#define OPLOG_H
+
+/*
+ * Compact log layout, version 1. All integers are little endian.
+ *
+ * Header:  16 bytes, "OPLC", uint8 version, uint8 source (OPLOG_SOURCE_*),
+ *          uint16 sync interval in bytes, uint32 hash of the object set
+ *          (0 if unknown), uint32 reserved (0).
+ * Frames:  follow the header, each starts with a tag byte.
+ *
+ *  0x00-0x7F  Record. The tag is the time in ms since the previous record or
+ *             sync frame, followed by one complete UAVTalk packet of any type
+ *             (sync byte, type, uint16 length of header and data, object ID,
+ *             [instance ID], data, CRC-8).
+ *  0x80       Record with a longer delta. The delta follows as an unsigned
+ *             LEB128 varint of up to 5 bytes, then the UAVTalk packet.
+ *  0x81       Sync. "OPLSYNC", uint32 absolute time in ms since the start of
+ *             the log, uint32 sequence number of the sync frame, CRC-8 of the
+ *             16 bytes before it. The next delta is relative to this time.
+ *             Written at the start and then at least every sync interval
+ *             bytes, and whenever the clock goes backwards.
+ *  0x82       Index, optional, after the last record. uint32 count, then count
+ *             entries of uint32 time and uint32 file offset of a sync frame.
+ *             The file then ends with the uint32 offset of the index frame
+ *             and "OPLX".
+ *
+ * A reader that meets an unknown tag, a bad UAVTalk sync byte, length or CRC,
+ * or a sync frame with a bad CRC, skips ahead to the next valid sync frame.
+ * At most one sync interval of records is lost per corruption. A log without
+ * an index (e.g. the board lost power) is read to the end of the file.
+ *
+ * Offsets are 32 bit, a log is at most 4 GB as on a FAT card.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OPLOG_VERSION			1
+#define OPLOG_HEADER_LENGTH		16
+#define OPLOG_SYNC_LENGTH		17
+#define OPLOG_DEFAULT_SYNC_INTERVAL	4096
+// Longest sync frame, tag and varint written in front of a packet
+#define OPLOG_RECORD_MAX_OVERHEAD	(OPLOG_SYNC_LENGTH + 6)
+#define OPLOG_FOOTER_LENGTH		8
+#define OPLOG_INDEX_ENTRY_LENGTH	8
+
+#define OPLOG_SOURCE_UNKNOWN		0
+#define OPLOG_SOURCE_FLIGHT		1
+#define OPLOG_SOURCE_GCS		2
+
+struct oplog_writer {
+	uint32_t offset;	// file offset of the next frame
+	uint32_t time;		// time the next delta is relative to
+	uint32_t sync_offset;	// file offset of the last sync frame
+	uint32_t sequence;	// sync frames written
+	uint16_t sync_interval;
+};
+
+struct oplog_index_entry {
+	uint32_t time;
+	uint32_t offset;	// file offset of a sync frame
+};
+
+struct oplog_reader {
+	const uint8_t *data;	// the whole file
+	uint32_t end;		// end of the frames, the index when there is one
+	uint32_t pos;
+	uint32_t time;
+	bool synced;		// false after a corruption until the next sync frame
+	uint32_t resyncs;	// corrupted spans skipped
+	uint8_t source;
+	uint16_t sync_interval;
+	uint32_t objects_hash;
+	uint32_t index_offset;	// 0 without an index
+	uint32_t index_count;
+};
+
+struct oplog_record {
+	uint32_t time;		// ms since the start of the log
+	uint32_t offset;	// file offset of the record frame
+	const uint8_t *packet;	// into the reader data
+	uint16_t length;
+};
+
+void OPLogWriterInit(struct oplog_writer *writer, uint16_t sync_interval);
+uint32_t OPLogWriteHeader(struct oplog_writer *writer, uint8_t *out, uint8_t source, uint32_t objects_hash);
+uint32_t OPLogWriteSync(struct oplog_writer *writer, uint8_t *out, uint32_t time);
+uint32_t OPLogWriteRecordHeader(struct oplog_writer *writer, uint8_t *out, uint32_t time, uint16_t length);
+uint32_t OPLogWriteRecord(struct oplog_writer *writer, uint8_t *out, uint32_t time, const uint8_t *packet, uint16_t length);
+uint32_t OPLogIndexLength(uint32_t count);
+uint32_t OPLogWriteIndex(struct oplog_writer *writer, uint8_t *out, const struct oplog_index_entry *entries, uint32_t count);
+
+bool OPLogIsCompact(const uint8_t *data, uint32_t size);
+bool OPLogReaderInit(struct oplog_reader *reader, const uint8_t *data, uint32_t size);
+bool OPLogReadRecord(struct oplog_reader *reader, struct oplog_record *record);
+bool OPLogReaderSeek(struct oplog_reader *reader, uint32_t offset);
+bool OPLogIndexEntry(const struct oplog_reader *reader, uint32_t n, struct oplog_index_entry *entry);
+uint8_t OPLogCRC(uint8_t crc, const uint8_t *data, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OPLOG_H